@@ -47,6 +47,12 @@
 #define BLADE_USB_CMD_SET_LOOPBACK            113
 #define BLADE_USB_CMD_GET_LOOPBACK            114
 #define BLADE_USB_CMD_READ_LOG_ENTRY          115
+#define BLADE_USB_CMD_FLASH_READ_PAGES        116
+#define BLADE_USB_CMD_FLASH_WRITE_PAGES       117
+#define BLADE_USB_CMD_FLASH_CRC32             118
+#define BLADE_USB_CMD_SET_RF_DMA_BUFFERS      119
+#define BLADE_USB_CMD_READ_LOG_ENTRIES        120
+#define BLADE_USB_CMD_SET_RF_DMA_CHANNEL      121
 
 /* String descriptor indices */
 #define BLADE_USB_STR_INDEX_MFR     1   /* Manufacturer */
@@ -60,6 +66,46 @@
 #define AUTOLOAD_BUFFER_SIZE 256
 #define AUTOLOAD_PAGE 1024
 
+/* BLADE_USB_CMD_FLASH_READ_PAGES and BLADE_USB_CMD_FLASH_WRITE_PAGES read or
+ * write wValue pages, starting at page wIndex, to or from the page buffer.
+ * This is filled and drained with BLADE_USB_CMD_{READ,WRITE}_PAGE_BUFFER, and
+ * holds up to FLASH_BUFFER_PAGES pages. */
+#define FLASH_BUFFER_PAGES 16
+
+/* BLADE_USB_CMD_FLASH_CRC32 computes the CRC-32 (see flash_crc32.h) of wValue
+ * pages, starting at page wIndex, and responds with a
+ * struct bladerf_fx3_flash_crc. At most FLASH_CRC32_MAX_PAGES pages may be
+ * requested at once, so that the request completes well within the host's
+ * control transfer timeout. */
+#define FLASH_CRC32_MAX_PAGES 256
+
+/* BLADE_USB_CMD_SET_RF_DMA_BUFFERS sets the number of DMA buffers in each RF
+ * sample channel to wValue, which must be between RF_DMA_BUFFERS_MIN and
+ * RF_DMA_BUFFERS_MAX. The new count takes effect the next time the RF link
+ * interface is selected. The response is the count used by the channels that
+ * are currently set up, or 0 if the RF link is not active.
+ *
+ * Each buffer holds one GPIF transfer from the FPGA (two max size USB
+ * packets), so the buffer size itself is fixed by the FPGA. */
+#define RF_DMA_BUFFERS_MIN      2
+#define RF_DMA_BUFFERS_DEFAULT  22
+#define RF_DMA_BUFFERS_MAX      32
+
+/* BLADE_USB_CMD_SET_RF_DMA_CHANNEL sets the number of DMA buffers in the
+ * sample channel of direction wIndex (BLADE_RF_DMA_RX or BLADE_RF_DMA_TX) to
+ * wValue. If the RF link is active, only that channel is rebuilt, right away,
+ * and the other direction keeps streaming. The response is the count in use
+ * by that channel, or 0 if it is not set up. The host must not have the
+ * direction enabled while its channel is rebuilt. */
+#define BLADE_RF_DMA_RX         0
+#define BLADE_RF_DMA_TX         1
+
+/* BLADE_USB_CMD_READ_LOG_ENTRIES reads and removes up to
+ * wLength / sizeof(logger_entry) entries from the firmware log, at most
+ * LOG_READ_MAX_ENTRIES at once. The response is always wLength bytes long;
+ * once the log has been drained, the remaining entries are LOG_EOF. */
+#define LOG_READ_MAX_ENTRIES    64
+
 #ifdef _MSC_VER
 #   define PACK(decl_to_pack_) \
             __pragma(pack(push,1)) \
@@ -78,6 +124,12 @@ struct bladerf_fx3_version {
     unsigned short minor;
 });
 
+PACK(
+struct bladerf_fx3_flash_crc {
+    int status;         /* 0 on success */
+    unsigned int crc;
+});
+
 struct bladeRF_firmware {
     unsigned int len;
     unsigned char *ptr;
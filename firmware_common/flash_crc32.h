@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2018 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef FLASH_CRC32_H_
+#define FLASH_CRC32_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* CRC-32 (as used by Ethernet and zlib), computed a nibble at a time. This is
+ * shared by the FX3 firmware and the host, which uses it to verify the flash
+ * contents reported by BLADE_USB_CMD_FLASH_CRC32. The small table keeps the
+ * firmware footprint down.
+ *
+ * Pass a `crc` of 0 for the first block of data, and the previous return value
+ * for subsequent blocks. */
+static inline uint32_t flash_crc32(uint32_t crc, const uint8_t *data,
+                                   size_t len)
+{
+    static const uint32_t lut[16] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
+        0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+        0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+    };
+
+    size_t i;
+
+    crc = ~crc;
+
+    for (i = 0; i < len; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ lut[crc & 0xf];
+        crc = (crc >> 4) ^ lut[crc & 0xf];
+    }
+
+    return ~crc;
+}
+
+#endif
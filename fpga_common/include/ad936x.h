@@ -55,6 +55,12 @@ struct clk_onecell_data {
  * From ad9361.h
  ******************************************************************************/
 
+#define AD936X_REG_CALIBRATION_CTRL 0x016
+#define AD936X_RX_BB_TUNE_CAL (1 << 7)
+#define AD936X_TX_BB_TUNE_CAL (1 << 6)
+#define AD936X_TX_QUAD_CAL (1 << 4)
+#define AD936X_RFDC_CAL (1 << 1)
+
 #define AD936X_REG_TX1_OUT_1_PHASE_CORR 0x08E
 #define AD936X_REG_TX1_OUT_1_GAIN_CORR 0x08F
 #define AD936X_REG_TX2_OUT_1_PHASE_CORR 0x090
@@ -72,6 +78,11 @@ struct clk_onecell_data {
 #define AD936X_REG_TX2_OUT_2_OFFSET_I 0x09C
 #define AD936X_REG_TX2_OUT_2_OFFSET_Q 0x09D
 #define AD936X_REG_TX_FORCE_BITS 0x09F
+#define AD936X_REG_QUAD_CAL_STATUS_TX1 0x0A7
+#define AD936X_REG_QUAD_CAL_STATUS_TX2 0x0A8
+
+#define AD936X_REG_RX1_MANUAL_LMT_FULL_GAIN 0x109
+#define AD936X_REG_RX2_MANUAL_LMT_FULL_GAIN 0x10C
 
 #define AD936X_REG_RX1_INPUT_A_PHASE_CORR 0x170
 #define AD936X_REG_RX1_INPUT_A_GAIN_CORR 0x171
@@ -93,6 +104,10 @@ struct clk_onecell_data {
 #define AD936X_REG_RX2_INPUT_BC_I_OFFSET 0x181
 #define AD936X_REG_FORCE_BITS 0x182
 
+#define AD936X_REG_RX_CP_OVERRANGE_VCO_LOCK 0x247
+#define AD936X_REG_TX_CP_OVERRANGE_VCO_LOCK 0x287
+#define AD936X_VCO_LOCK (1 << 1)
+
 #define AD936X_READ (0 << 15)
 #define AD936X_WRITE (1 << 15)
 #define AD936X_CNT(x) ((((x)-1) & 0x7) << 12)
@@ -849,10 +864,70 @@ int32_t ad9361_rx_fastlock_store(struct ad9361_rf_phy *phy, uint32_t profile);
 int32_t ad9361_rx_fastlock_save(struct ad9361_rf_phy *phy,
                                 uint32_t profile,
                                 uint8_t *values);
+int32_t ad9361_rx_fastlock_load(struct ad9361_rf_phy *phy,
+                                uint32_t profile,
+                                uint8_t *values);
 int32_t ad9361_tx_fastlock_store(struct ad9361_rf_phy *phy, uint32_t profile);
 int32_t ad9361_tx_fastlock_save(struct ad9361_rf_phy *phy,
                                 uint32_t profile,
                                 uint8_t *values);
+int32_t ad9361_tx_fastlock_load(struct ad9361_rf_phy *phy,
+                                uint32_t profile,
+                                uint8_t *values);
 int32_t ad9361_set_no_ch_mode(struct ad9361_rf_phy *phy, uint8_t no_ch_mode);
+int32_t ad9361_do_calib(struct ad9361_rf_phy *phy, uint32_t cal, int32_t arg);
+
+/******************************************************************************
+ * From platform.h
+ ******************************************************************************/
+
+struct bladerf;
+
+/**
+ * Queue the AD9361 SPI writes issued on this thread for `dev` until the
+ * matching platform_spi_batch_commit(), so the backend may coalesce them into
+ * fewer control requests. Queued writes are issued before any driver delay
+ * and before any SPI read. Calls may nest.
+ */
+int platform_spi_batch_begin(struct bladerf *dev);
+
+/**
+ * End a scope begun by platform_spi_batch_begin(), issuing any queued writes
+ * once the outermost scope is committed.
+ */
+int platform_spi_batch_commit(struct bladerf *dev);
+
+/** Maximum number of status registers in a ::platform_cal_skip */
+#define PLATFORM_CAL_SKIP_MAX_STATUS 4
+
+/**
+ * Calibrations to be skipped by platform_spi_cal_skip_begin()
+ */
+struct platform_cal_skip {
+    uint16_t ctrl_reg;  /**< Calibration control register */
+    uint8_t ctrl_mask;  /**< Bits of ctrl_reg that start skipped calibrations */
+
+    /** Status registers the driver checks after the skipped calibrations,
+     *  and the values to report for them */
+    unsigned int num_status;
+    uint16_t status_reg[PLATFORM_CAL_SKIP_MAX_STATUS];
+    uint8_t status_val[PLATFORM_CAL_SKIP_MAX_STATUS];
+};
+
+/**
+ * Skip calibrations the driver starts on this thread for `dev`, until
+ * platform_spi_cal_skip_end(). Single-register writes to the control register
+ * have the start bits in `skip` cleared, so the calibrations complete at once,
+ * and single-register reads of its status registers return the given values.
+ * The caller restores the calibration results itself. `skip` must remain valid
+ * until platform_spi_cal_skip_end().
+ */
+void platform_spi_cal_skip_begin(struct bladerf *dev,
+                                 const struct platform_cal_skip *skip);
+
+/**
+ * End a scope begun by platform_spi_cal_skip_begin()
+ */
+void platform_spi_cal_skip_end(struct bladerf *dev);
 
 #endif  // AD936X_H_
@@ -102,6 +102,9 @@ static bladerf_frequency const RESET_FREQUENCY = 70000000;
 /* Number of fast lock profiles that can be stored in the RFFE
  * Make sure this number matches that of the Nios' devices.h */
 #define NUM_RFFE_FASTLOCK_PROFILES  8
+
+/* Size of an AD9361 fast lock profile, in bytes */
+#define BLADERF_RFIC_FASTLOCK_PROFILE_LEN 16
 // clang-format on
 
 /**
@@ -273,6 +276,44 @@ typedef enum {
      */
     BLADERF_RFIC_COMMAND_FASTLOCK = 0x0B,
 
+    /** RF port for a channel. (Read/Write)
+     *
+     * Value is an AD9361 RF port ID, such as those in ::bladerf2_rx_port_map
+     * and ::bladerf2_tx_port_map. The port is selected by frequency again on
+     * the next retune.
+     */
+    BLADERF_RFIC_COMMAND_RFPORT = 0x0C,
+
+    /** RFIC temperature. (Read)
+     *
+     * Pass ::BLADERF_CHANNEL_INVALID as the `ch` parameter.
+     *
+     * Value in millidegrees Celsius, as a signed 32-bit integer.
+     */
+    BLADERF_RFIC_COMMAND_TEMPERATURE = 0x0D,
+
+    /** Save Fastlock profile. (Write)
+     *
+     * Reads the given fastlock profile out of the RFIC into the channel
+     * direction's profile buffer, and rewinds the buffer.
+     */
+    BLADERF_RFIC_COMMAND_FASTLOCK_SAVE = 0x0E,
+
+    /** Load Fastlock profile. (Write)
+     *
+     * Writes the channel direction's profile buffer into the given fastlock
+     * profile in the RFIC, and rewinds the buffer.
+     */
+    BLADERF_RFIC_COMMAND_FASTLOCK_LOAD = 0x0F,
+
+    /** Fastlock profile buffer. (Read/Write)
+     *
+     * Each access transfers the next 8 bytes of the channel direction's
+     * ::BLADERF_RFIC_FASTLOCK_PROFILE_LEN byte profile buffer, first byte in
+     * the least significant bits, wrapping around at its end.
+     */
+    BLADERF_RFIC_COMMAND_FASTLOCK_DATA = 0x10,
+
     /** User-defined functionality (placeholder 1) */
     BLADERF_RFIC_COMMAND_USER_001 = 0x80,
 
@@ -287,7 +328,13 @@ typedef enum {
  *  +===============+===================================================+
  *  |      Bit(s)   |         Value                                     |
  *  +===============+===================================================+
- *  |      63:16    | Reserved. Set to 0.                               |
+ *  |      63:25    | Reserved. Set to 0.                               |
+ *  +---------------+---------------------------------------------------+
+ *  |        24     | 1 if AD9361 SPI batch packets are accepted (see   |
+ *  |               | nios_pkt_ad9361_batch.h), 0 otherwise             |
+ *  +---------------+---------------------------------------------------+
+ *  |      23:16    | write queue capacity, or 0 if not reported (in    |
+ *  |               | which case it is 16)                              |
  *  +---------------+---------------------------------------------------+
  *  |      15:8     | count of items in write queue                     |
  *  +---------------+---------------------------------------------------+
@@ -304,6 +351,10 @@ typedef enum {
 #define BLADERF_RFIC_STATUS_WQSUCCESS_MASK   0x1
 #define BLADERF_RFIC_STATUS_WQLEN_SHIFT      8
 #define BLADERF_RFIC_STATUS_WQLEN_MASK       0xff
+#define BLADERF_RFIC_STATUS_WQMAX_SHIFT      16
+#define BLADERF_RFIC_STATUS_WQMAX_MASK       0xff
+#define BLADERF_RFIC_STATUS_SPIBATCH_SHIFT   24
+#define BLADERF_RFIC_STATUS_SPIBATCH_MASK    0x1
 
 #define BLADERF_RFIC_RSSI_MULT_SHIFT         32
 #define BLADERF_RFIC_RSSI_MULT_MASK          0xFFFF
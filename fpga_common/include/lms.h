@@ -60,6 +60,13 @@
  */
 #define LMS_FREQ_FLAGS_FORCE_VCOCAP   (1 << 1)
 
+/**
+ * The VCOCAP value comes from a characterization of this board. Use it as-is
+ * if VTUNE confirms it is within the NORM region, and otherwise fall back to
+ * using it as a hint to the tuning algorithm.
+ */
+#define LMS_FREQ_FLAGS_VERIFY_VCOCAP  (1 << 2)
+
 /**
  * This bit indicates whether the quicktune needs to set XB-200 parameters
  */
@@ -632,6 +639,19 @@ void lms_print_frequency(struct lms_freq *freq);
 int lms_get_frequency(struct bladerf *dev, bladerf_module mod,
                       struct lms_freq *freq);
 
+/**
+ * Check whether a module's PLL is locked, per the VCO tuning voltage
+ * comparators
+ *
+ * @param[in]   dev     Device handle
+ * @param[in]   mod     Module to query
+ * @param[out]  locked  Set to `true` if the tuning voltage is within its
+ *                      normal range
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int lms_get_pll_lock(struct bladerf *dev, bladerf_module mod, bool *locked);
+
 /**
  * Fetch "Quick tune" parameters
  *
@@ -655,6 +675,19 @@ int lms_get_quick_tune(struct bladerf *dev,
  */
 int lms_calculate_tuning_params(unsigned int freq, struct lms_freq *f);
 
+/**
+ * Get the range of frequencies tuned with the specified FREQSEL band by
+ * lms_calculate_tuning_params(). The bands are ordered by frequency, and
+ * their ranges do not overlap.
+ *
+ * @param[in]   band    Band index, from 0
+ * @param[out]  low     Lowest frequency of the band
+ * @param[out]  high    Highest frequency of the band
+ *
+ * @return 0 on success, BLADERF_ERR_RANGE if `band` is past the last band
+ */
+int lms_get_band(unsigned int band, uint32_t *low, uint32_t *high);
+
 /**
  * Set the frequency of a module, given the lms_freq structure
  *
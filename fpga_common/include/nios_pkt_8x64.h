@@ -102,6 +102,9 @@
 /* Target IDs */
 
 #define NIOS_PKT_8x64_TARGET_TIMESTAMP 0x00 /* Timestamp readback (read only) */
+#define NIOS_PKT_8x64_TARGET_CONFIG_ID 0x01 /* Host-defined configuration ID.
+                                             * Retained until the FPGA is
+                                             * reconfigured, and initially 0 */
 
 /* IDs 0x80 through 0xff will not be assigned by Nuand. These are reserved
  * for user customizations */
@@ -116,6 +119,17 @@
 #define NIOS_PKT_8x64_TIMESTAMP_RX  0x00
 #define NIOS_PKT_8x64_TIMESTAMP_TX  0x01
 
+/* Time at which the RX or TX trigger last fired, for FPGA images that latch
+ * it. Bits 62:0 hold the time in half-sample periods, i.e., twice the
+ * timestamp in effect, plus 1 if the trigger fired in the second half of that
+ * sample period. Bit 63 is set once the trigger has fired since the timestamp
+ * counter was last reset, and the time is otherwise 0. */
+#define NIOS_PKT_8x64_TIMESTAMP_RX_TRIGGER  0x02
+#define NIOS_PKT_8x64_TIMESTAMP_TX_TRIGGER  0x03
+
+#define NIOS_PKT_8x64_TRIGGER_FIRED     (((uint64_t) 1) << 63)
+#define NIOS_PKT_8x64_TRIGGER_TIME_MASK (NIOS_PKT_8x64_TRIGGER_FIRED - 1)
+
 /* Pack the request buffer */
 static inline void nios_pkt_8x64_pack(uint8_t *buf, uint8_t target, bool write,
                                       uint8_t addr, uint64_t data)
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BLADERF_NIOS_PKT_AD9361_BATCH_H_
+#define BLADERF_NIOS_PKT_AD9361_BATCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * This file defines the Host <-> FPGA (NIOS II) packet format for performing
+ * several AD9361 SPI writes (see NIOS_PKT_16x64_TARGET_AD9361) at once.
+ *
+ * Each write is a 16-bit AD9361 SPI command, sent most significant byte
+ * first, followed by the 1 to 8 data bytes its byte count field (bits 14:12)
+ * calls for. Writes are packed back-to-back, so that up to four single-byte
+ * writes, or one eight-byte write, fit in a packet.
+ *
+ *
+ * +================+=========================================================+
+ * |  Byte offset   |                       Description                       |
+ * +================+=========================================================+
+ * |        0       | Magic Value                                             |
+ * +----------------+---------------------------------------------------------+
+ * |        1       | Number of writes (Note 1)                               |
+ * +----------------+---------------------------------------------------------+
+ * |        2       | Flags. Set to 0x00. (Note 2)                            |
+ * +----------------+---------------------------------------------------------+
+ * |        3       | Number of bytes of writes at offsets 15:4               |
+ * +----------------+---------------------------------------------------------+
+ * |      15:4      | Writes, in the order in which they are to be performed  |
+ * +----------------+---------------------------------------------------------+
+ *
+ *
+ * The response packet contains the same information as the request, with
+ * the following fields updated.
+ *
+ * (Note 1) The number of writes performed.
+ *
+ * (Note 2) NIOS_PKT_AD9361_BATCH_FLAG_SUCCESS is set if all of the writes
+ *          were performed.
+ *
+ * As old FPGA images drop this packet without a response, support should be
+ * checked beforehand in the RFIC status register (see
+ * BLADERF_RFIC_STATUS_SPIBATCH_SHIFT).
+ */
+
+#define NIOS_PKT_AD9361_BATCH_MAGIC         ((uint8_t) 'S')
+
+/* Request packet indices */
+#define NIOS_PKT_AD9361_BATCH_IDX_MAGIC     0
+#define NIOS_PKT_AD9361_BATCH_IDX_COUNT     1
+#define NIOS_PKT_AD9361_BATCH_IDX_FLAGS     2
+#define NIOS_PKT_AD9361_BATCH_IDX_LEN       3
+#define NIOS_PKT_AD9361_BATCH_IDX_DATA      4
+
+#define NIOS_PKT_AD9361_BATCH_DATA_MAX      12
+
+/* Flag bits */
+#define NIOS_PKT_AD9361_BATCH_FLAG_SUCCESS  (1 << 1)
+
+/* Number of data bytes written by an AD9361 SPI command */
+static inline uint8_t nios_pkt_ad9361_batch_bytes(uint16_t cmd)
+{
+    return ((cmd >> 12) & 0x7) + 1;
+}
+
+/* Initialize a request buffer with no writes */
+static inline void nios_pkt_ad9361_batch_init(uint8_t *buf)
+{
+    uint8_t i;
+
+    buf[NIOS_PKT_AD9361_BATCH_IDX_MAGIC] = NIOS_PKT_AD9361_BATCH_MAGIC;
+    buf[NIOS_PKT_AD9361_BATCH_IDX_COUNT] = 0x00;
+    buf[NIOS_PKT_AD9361_BATCH_IDX_FLAGS] = 0x00;
+    buf[NIOS_PKT_AD9361_BATCH_IDX_LEN]   = 0x00;
+
+    for (i = 0; i < NIOS_PKT_AD9361_BATCH_DATA_MAX; i++) {
+        buf[NIOS_PKT_AD9361_BATCH_IDX_DATA + i] = 0x00;
+    }
+}
+
+/* Returns true if there is room in a request buffer for a write */
+static inline bool nios_pkt_ad9361_batch_fits(const uint8_t *buf,
+                                              uint16_t cmd)
+{
+    return buf[NIOS_PKT_AD9361_BATCH_IDX_LEN] + 2 +
+               nios_pkt_ad9361_batch_bytes(cmd) <=
+           NIOS_PKT_AD9361_BATCH_DATA_MAX;
+}
+
+/* Append a write to a request buffer. The caller is responsible for checking
+ * that nios_pkt_ad9361_batch_fits(). As with the 16x64 AD9361 target, the
+ * first data byte is in bits 63:56 of `data`. */
+static inline void nios_pkt_ad9361_batch_add(uint8_t *buf, uint16_t cmd,
+                                             uint64_t data)
+{
+    const uint8_t bytes = nios_pkt_ad9361_batch_bytes(cmd);
+    uint8_t *p = &buf[NIOS_PKT_AD9361_BATCH_IDX_DATA +
+                      buf[NIOS_PKT_AD9361_BATCH_IDX_LEN]];
+    uint8_t i;
+
+    p[0] = (cmd >> 8) & 0xff;
+    p[1] = cmd & 0xff;
+
+    for (i = 0; i < bytes; i++) {
+        p[2 + i] = (data >> (56 - 8 * i)) & 0xff;
+    }
+
+    buf[NIOS_PKT_AD9361_BATCH_IDX_LEN] += 2 + bytes;
+    buf[NIOS_PKT_AD9361_BATCH_IDX_COUNT]++;
+}
+
+/* Unpack the write at *offset within a request buffer's writes, advancing
+ * *offset past it. Returns false if the buffer does not hold a whole write
+ * there. */
+static inline bool nios_pkt_ad9361_batch_get(const uint8_t *buf,
+                                             uint8_t *offset,
+                                             uint16_t *cmd,
+                                             uint64_t *data)
+{
+    const uint8_t len = buf[NIOS_PKT_AD9361_BATCH_IDX_LEN];
+    const uint8_t *p  = &buf[NIOS_PKT_AD9361_BATCH_IDX_DATA + *offset];
+    uint8_t bytes;
+    uint8_t i;
+
+    if (len > NIOS_PKT_AD9361_BATCH_DATA_MAX || *offset + 2 > len) {
+        return false;
+    }
+
+    *cmd  = ((uint16_t) p[0] << 8) | p[1];
+    bytes = nios_pkt_ad9361_batch_bytes(*cmd);
+
+    if (*offset + 2 + bytes > len) {
+        return false;
+    }
+
+    *data = 0;
+    for (i = 0; i < bytes; i++) {
+        *data |= (uint64_t) p[2 + i] << (56 - 8 * i);
+    }
+
+    *offset += 2 + bytes;
+    return true;
+}
+
+/* Pack the response buffer, in place over the request */
+static inline void nios_pkt_ad9361_batch_resp_pack(uint8_t *buf,
+                                                   uint8_t written,
+                                                   bool success)
+{
+    buf[NIOS_PKT_AD9361_BATCH_IDX_COUNT] = written;
+    buf[NIOS_PKT_AD9361_BATCH_IDX_FLAGS] =
+        success ? NIOS_PKT_AD9361_BATCH_FLAG_SUCCESS : 0x00;
+}
+
+/* Unpack the response buffer */
+static inline void nios_pkt_ad9361_batch_resp_unpack(const uint8_t *buf,
+                                                     uint8_t *written,
+                                                     bool *success)
+{
+    if (written != NULL) {
+        *written = buf[NIOS_PKT_AD9361_BATCH_IDX_COUNT];
+    }
+
+    if (success != NULL) {
+        *success = (buf[NIOS_PKT_AD9361_BATCH_IDX_FLAGS] &
+                    NIOS_PKT_AD9361_BATCH_FLAG_SUCCESS) != 0;
+    }
+}
+
+#endif
@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BLADERF_NIOS_PKT_DC_CAL_H_
+#define BLADERF_NIOS_PKT_DC_CAL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * This file defines the Host <-> FPGA (NIOS II) packet format for the
+ * autonomous LMS6002D RX DC offset calibration on the bladeRF x40/x115.
+ *
+ * The host fills a table of frequencies with ADD requests, each carrying the
+ * precomputed LMS6002D tuning values, and then issues START. The NIOS II
+ * tunes to each frequency in turn and searches for the RX DC correction that
+ * zeroes the DC offset measured by the FPGA RX power meter, without any
+ * further host involvement. The host polls with STATUS and reads back each
+ * result with READ. All values are little-endian.
+ *
+ * The LMS command instead runs one of the LMS6002D's internal DC offset
+ * calibration procedures, as lms_calibrate_dc() does, entirely on the NIOS II.
+ * The response is sent once the calibration has completed.
+ *
+ *
+ * +================+=========================================================+
+ * |  Byte offset   |                       Description                       |
+ * +================+=========================================================+
+ * |        0       | Magic Value                                             |
+ * +----------------+---------------------------------------------------------+
+ * |        1       | Command. See the NIOS_PKT_DC_CAL_CMD_* values.          |
+ * +----------------+---------------------------------------------------------+
+ * |        2       | Table index (Note 1)                                    |
+ * +----------------+---------------------------------------------------------+
+ * |        3       | Flags. Set to 0x00. (Note 2)                            |
+ * +----------------+---------------------------------------------------------+
+ * |      15:4      | Command-specific payload (Note 3)                       |
+ * +----------------+---------------------------------------------------------+
+ *
+ *
+ * The response packet contains the same information as the request, with
+ * the following fields updated.
+ *
+ * (Note 1) READ: the index of the entry to read. ADD: set to the index the
+ *          entry was stored at. STATUS: set to the number of table entries.
+ *
+ * (Note 2) NIOS_PKT_DC_CAL_FLAG_SUCCESS is set if the command was carried
+ *          out. For READ, it is only set if the entry was calibrated. The
+ *          NIOS_PKT_DC_CAL_FLAG_BUSY flag is set while a calibration is in
+ *          progress.
+ *
+ * (Note 3) Payloads:
+ *
+ *   ADD request:
+ *      5:4     LMS6002D NINT
+ *      9:6     LMS6002D NFRAC
+ *      10      LMS6002D FREQSEL
+ *      11      LMS6002D VCOCAP hint
+ *      12      NIOS_PKT_DC_CAL_TUNE_* flags
+ *
+ *   START request:
+ *      7:4     Number of samples per measurement
+ *      9:8     Settling time after each correction change, in microseconds
+ *
+ *   STATUS response:
+ *      4       Number of entries calibrated so far
+ *
+ *   READ response:
+ *      5:4     DC offset correction for I, as with BLADERF_CORR_LMS_DCOFF_I
+ *      7:6     DC offset correction for Q, as with BLADERF_CORR_LMS_DCOFF_Q
+ *
+ *   LMS request:
+ *      4       Module to calibrate, as a bladerf_cal_module value
+ *
+ *   LMS response:
+ *      5       lms_calibrate_dc() return value, as a BLADERF_ERR_* code. The
+ *              success flag is set only if this is 0. LMS is refused while a
+ *              sweep is in progress.
+ *
+ * CLEAR empties the table, stopping any calibration in progress.
+ */
+
+#define NIOS_PKT_DC_CAL_MAGIC           ((uint8_t) 'L')
+
+/* Request packet indices */
+#define NIOS_PKT_DC_CAL_IDX_MAGIC       0
+#define NIOS_PKT_DC_CAL_IDX_CMD         1
+#define NIOS_PKT_DC_CAL_IDX_INDEX       2
+#define NIOS_PKT_DC_CAL_IDX_FLAGS       3
+#define NIOS_PKT_DC_CAL_IDX_NINT        4
+#define NIOS_PKT_DC_CAL_IDX_NFRAC       6
+#define NIOS_PKT_DC_CAL_IDX_FREQSEL     10
+#define NIOS_PKT_DC_CAL_IDX_VCOCAP      11
+#define NIOS_PKT_DC_CAL_IDX_TUNE_FLAGS  12
+#define NIOS_PKT_DC_CAL_IDX_WINDOW      4
+#define NIOS_PKT_DC_CAL_IDX_SETTLE      8
+#define NIOS_PKT_DC_CAL_IDX_DONE        4
+#define NIOS_PKT_DC_CAL_IDX_DC_I        4
+#define NIOS_PKT_DC_CAL_IDX_DC_Q        6
+#define NIOS_PKT_DC_CAL_IDX_LMS_MODULE  4
+#define NIOS_PKT_DC_CAL_IDX_LMS_STATUS  5
+
+/* Commands */
+#define NIOS_PKT_DC_CAL_CMD_CLEAR       0x00
+#define NIOS_PKT_DC_CAL_CMD_ADD         0x01
+#define NIOS_PKT_DC_CAL_CMD_START       0x02
+#define NIOS_PKT_DC_CAL_CMD_STATUS      0x03
+#define NIOS_PKT_DC_CAL_CMD_READ        0x04
+#define NIOS_PKT_DC_CAL_CMD_LMS         0x05
+
+/* Flag bits */
+#define NIOS_PKT_DC_CAL_FLAG_SUCCESS    (1 << 0)
+#define NIOS_PKT_DC_CAL_FLAG_BUSY       (1 << 1)
+
+/* ADD tuning flag bits */
+#define NIOS_PKT_DC_CAL_TUNE_LOW_BAND   (1 << 0)
+#define NIOS_PKT_DC_CAL_TUNE_QUICK      (1 << 1)
+
+/* Number of frequencies the NIOS II can hold at once */
+#define NIOS_PKT_DC_CAL_MAX_ENTRIES     64
+
+static inline void nios_pkt_dc_cal_put16(uint8_t *buf, uint16_t v)
+{
+    buf[0] = v & 0xff;
+    buf[1] = (v >> 8) & 0xff;
+}
+
+static inline void nios_pkt_dc_cal_put32(uint8_t *buf, uint32_t v)
+{
+    buf[0] = v & 0xff;
+    buf[1] = (v >> 8) & 0xff;
+    buf[2] = (v >> 16) & 0xff;
+    buf[3] = (v >> 24) & 0xff;
+}
+
+static inline uint16_t nios_pkt_dc_cal_get16(const uint8_t *buf)
+{
+    return (uint16_t) buf[0] | ((uint16_t) buf[1] << 8);
+}
+
+static inline uint32_t nios_pkt_dc_cal_get32(const uint8_t *buf)
+{
+    return (uint32_t) buf[0] | ((uint32_t) buf[1] << 8) |
+           ((uint32_t) buf[2] << 16) | ((uint32_t) buf[3] << 24);
+}
+
+/* Pack a request with no payload */
+static inline void nios_pkt_dc_cal_pack(uint8_t *buf, uint8_t cmd,
+                                        uint8_t index)
+{
+    uint8_t i;
+
+    buf[NIOS_PKT_DC_CAL_IDX_MAGIC] = NIOS_PKT_DC_CAL_MAGIC;
+    buf[NIOS_PKT_DC_CAL_IDX_CMD]   = cmd;
+    buf[NIOS_PKT_DC_CAL_IDX_INDEX] = index;
+    buf[NIOS_PKT_DC_CAL_IDX_FLAGS] = 0x00;
+
+    for (i = NIOS_PKT_DC_CAL_IDX_FLAGS + 1; i < 16; i++) {
+        buf[i] = 0x00;
+    }
+}
+
+/* Pack an ADD request */
+static inline void nios_pkt_dc_cal_add_pack(uint8_t *buf, uint16_t nint,
+                                            uint32_t nfrac, uint8_t freqsel,
+                                            uint8_t vcocap, bool low_band,
+                                            bool quick_tune)
+{
+    uint8_t flags = 0;
+
+    if (low_band) {
+        flags |= NIOS_PKT_DC_CAL_TUNE_LOW_BAND;
+    }
+
+    if (quick_tune) {
+        flags |= NIOS_PKT_DC_CAL_TUNE_QUICK;
+    }
+
+    nios_pkt_dc_cal_pack(buf, NIOS_PKT_DC_CAL_CMD_ADD, 0);
+    nios_pkt_dc_cal_put16(&buf[NIOS_PKT_DC_CAL_IDX_NINT], nint);
+    nios_pkt_dc_cal_put32(&buf[NIOS_PKT_DC_CAL_IDX_NFRAC], nfrac);
+    buf[NIOS_PKT_DC_CAL_IDX_FREQSEL]    = freqsel;
+    buf[NIOS_PKT_DC_CAL_IDX_VCOCAP]     = vcocap;
+    buf[NIOS_PKT_DC_CAL_IDX_TUNE_FLAGS] = flags;
+}
+
+/* Unpack an ADD request */
+static inline void nios_pkt_dc_cal_add_unpack(const uint8_t *buf,
+                                              uint16_t *nint, uint32_t *nfrac,
+                                              uint8_t *freqsel,
+                                              uint8_t *vcocap, bool *low_band,
+                                              bool *quick_tune)
+{
+    const uint8_t flags = buf[NIOS_PKT_DC_CAL_IDX_TUNE_FLAGS];
+
+    *nint       = nios_pkt_dc_cal_get16(&buf[NIOS_PKT_DC_CAL_IDX_NINT]);
+    *nfrac      = nios_pkt_dc_cal_get32(&buf[NIOS_PKT_DC_CAL_IDX_NFRAC]);
+    *freqsel    = buf[NIOS_PKT_DC_CAL_IDX_FREQSEL];
+    *vcocap     = buf[NIOS_PKT_DC_CAL_IDX_VCOCAP];
+    *low_band   = (flags & NIOS_PKT_DC_CAL_TUNE_LOW_BAND) != 0;
+    *quick_tune = (flags & NIOS_PKT_DC_CAL_TUNE_QUICK) != 0;
+}
+
+/* Pack a START request */
+static inline void nios_pkt_dc_cal_start_pack(uint8_t *buf,
+                                              uint32_t num_samples,
+                                              uint16_t settle_us)
+{
+    nios_pkt_dc_cal_pack(buf, NIOS_PKT_DC_CAL_CMD_START, 0);
+    nios_pkt_dc_cal_put32(&buf[NIOS_PKT_DC_CAL_IDX_WINDOW], num_samples);
+    nios_pkt_dc_cal_put16(&buf[NIOS_PKT_DC_CAL_IDX_SETTLE], settle_us);
+}
+
+/* Unpack a START request */
+static inline void nios_pkt_dc_cal_start_unpack(const uint8_t *buf,
+                                                uint32_t *num_samples,
+                                                uint16_t *settle_us)
+{
+    *num_samples = nios_pkt_dc_cal_get32(&buf[NIOS_PKT_DC_CAL_IDX_WINDOW]);
+    *settle_us   = nios_pkt_dc_cal_get16(&buf[NIOS_PKT_DC_CAL_IDX_SETTLE]);
+}
+
+/* Pack an LMS request */
+static inline void nios_pkt_dc_cal_lms_pack(uint8_t *buf, uint8_t module)
+{
+    nios_pkt_dc_cal_pack(buf, NIOS_PKT_DC_CAL_CMD_LMS, 0);
+    buf[NIOS_PKT_DC_CAL_IDX_LMS_MODULE] = module;
+}
+
+/* Unpack an LMS response */
+static inline void nios_pkt_dc_cal_lms_resp_unpack(const uint8_t *buf,
+                                                   int *lms_status)
+{
+    *lms_status = (int8_t) buf[NIOS_PKT_DC_CAL_IDX_LMS_STATUS];
+}
+
+/* Unpack the common fields of a response */
+static inline void nios_pkt_dc_cal_resp_unpack(const uint8_t *buf,
+                                               uint8_t *index, bool *success,
+                                               bool *busy)
+{
+    const uint8_t flags = buf[NIOS_PKT_DC_CAL_IDX_FLAGS];
+
+    if (index != NULL) {
+        *index = buf[NIOS_PKT_DC_CAL_IDX_INDEX];
+    }
+
+    if (success != NULL) {
+        *success = (flags & NIOS_PKT_DC_CAL_FLAG_SUCCESS) != 0;
+    }
+
+    if (busy != NULL) {
+        *busy = (flags & NIOS_PKT_DC_CAL_FLAG_BUSY) != 0;
+    }
+}
+
+#endif
@@ -31,6 +31,12 @@
 #include "nios_pkt_8x64.h"
 #include "nios_pkt_32x32.h"
 #include "nios_pkt_16x64.h"
+#include "nios_pkt_rfic_batch.h"
+#include "nios_pkt_ad9361_batch.h"
+#include "nios_pkt_dc_cal.h"
+#include "nios_pkt_retune_queue.h"
+#include "nios_pkt_timed_write.h"
+#include "nios_pkt_vctcxo_tamer.h"
 
 #define NIOS_PKT_LEN 16
 
@@ -58,7 +58,9 @@
  * |                | Bits [3:2]: External RX2 SPDT switch setting            |
  * |                | Bits [1:0]: External RX1 SPDT switch setting            |
  * +----------------+---------------------------------------------------------+
- * |       14-15    | 8-bit reserved words. Should be set to 0x00.            |
+ * |       14       | 8-bit command (Note 3)                                  |
+ * +----------------+---------------------------------------------------------+
+ * |       15       | 8-bit reserved word. Should be set to 0x00.             |
  * +----------------+---------------------------------------------------------+
  *
  * (Note 1) Special Timestamp Values:
@@ -67,7 +69,8 @@
  * Clear Retune Queue:  0xffffffffffffffff
  *
  * When the "Clear Retune Queue" value is used, all of the other tuning
- * parameters are ignored.
+ * parameters are ignored. Scheduled gain changes share the queue, and are
+ * cleared along with any retunes.
  *
  * (Note 2) Packed as follows:
  *
@@ -79,6 +82,26 @@
  * |       1        |  NIOS_PROFILE[15:8]   |
  * +----------------+-----------------------+
  *
+ * (Note 3) Commands:
+ *
+ * 0x00: Retune, as described above. FPGA versions prior to v0.17.1 treat all
+ *       requests as retunes.
+ *
+ * 0x01: Gain change (FPGA v0.17.1 and later). Only the timestamp and the RX
+ *       bit of byte 12 are used as above. The remaining bytes are:
+ *
+ *       +================+==================================================+
+ *       |  Byte offset   |                   Description                    |
+ *       +================+==================================================+
+ *       |        9       | 16-bit RFIC gain setting, little-endian. RX: full |
+ *       |                | gain table index. TX: attenuation, in 0.25 dB    |
+ *       |                | steps.                                           |
+ *       +----------------+--------------------------------------------------+
+ *       |       11       | 8-bit RFIC channel index (0 or 1)                |
+ *       +----------------+--------------------------------------------------+
+ *       |       13       | 8-bit reserved word. Should be set to 0x00.      |
+ *       +----------------+--------------------------------------------------+
+ *
  */
 
 #define NIOS_PKT_RETUNE2_IDX_MAGIC        0
@@ -87,7 +110,11 @@
 #define NIOS_PKT_RETUNE2_IDX_RFFE_PROFILE 11
 #define NIOS_PKT_RETUNE2_IDX_RFFE_PORT    12
 #define NIOS_PKT_RETUNE2_IDX_SPDT         13
-#define NIOS_PKT_RETUNE2_IDX_RESV         14
+#define NIOS_PKT_RETUNE2_IDX_CMD          14
+#define NIOS_PKT_RETUNE2_IDX_RESV         15
+
+#define NIOS_PKT_RETUNE2_IDX_GAIN_SETTING 9
+#define NIOS_PKT_RETUNE2_IDX_GAIN_CHAN    11
 
 #define NIOS_PKT_RETUNE2_MAGIC            'U'
 
@@ -100,6 +127,10 @@
 /* The IS_RX bit embedded in the 'port' parameter of the retune2 packet */
 #define NIOS_PKT_RETUNE2_PORT_IS_RX_MASK  (0x1 << 7)
 
+/* Request commands */
+#define NIOS_PKT_RETUNE2_CMD_RETUNE       0x00
+#define NIOS_PKT_RETUNE2_CMD_GAIN         0x01
+
 /* Pack the retune2 request buffer with the provided parameters */
 static inline void nios_pkt_retune2_pack(uint8_t *buf,
                                          bladerf_module module,
@@ -138,8 +169,25 @@ static inline void nios_pkt_retune2_pack(uint8_t *buf,
 
     buf[NIOS_PKT_RETUNE2_IDX_SPDT] = spdt & 0xff;
 
-    buf[NIOS_PKT_RETUNE2_IDX_RESV + 0] = 0x00;
-    buf[NIOS_PKT_RETUNE2_IDX_RESV + 1] = 0x00;
+    buf[NIOS_PKT_RETUNE2_IDX_CMD] = NIOS_PKT_RETUNE2_CMD_RETUNE;
+    buf[NIOS_PKT_RETUNE2_IDX_RESV] = 0x00;
+}
+
+/* Pack a retune2 request buffer with a gain change */
+static inline void nios_pkt_retune2_gain_pack(uint8_t *buf,
+                                              bladerf_module module,
+                                              uint64_t timestamp,
+                                              uint16_t setting)
+{
+    /* The gain change is otherwise a retune with no fast lock profile */
+    nios_pkt_retune2_pack(buf, module, timestamp, 0, 0, 0, 0);
+
+    buf[NIOS_PKT_RETUNE2_IDX_GAIN_SETTING + 0] = (setting >> 0) & 0xff;
+    buf[NIOS_PKT_RETUNE2_IDX_GAIN_SETTING + 1] = (setting >> 8) & 0xff;
+
+    buf[NIOS_PKT_RETUNE2_IDX_GAIN_CHAN] = (module >> 1) & 0xff;
+
+    buf[NIOS_PKT_RETUNE2_IDX_CMD] = NIOS_PKT_RETUNE2_CMD_GAIN;
 }
 
 /* Unpack a retune request */
@@ -177,6 +225,26 @@ static inline void nios_pkt_retune2_unpack(const uint8_t *buf,
 
 }
 
+/* Get the command of a retune2 request */
+static inline uint8_t nios_pkt_retune2_cmd(const uint8_t *buf)
+{
+    return buf[NIOS_PKT_RETUNE2_IDX_CMD];
+}
+
+/* Unpack the gain change parameters of a retune2 request. The module and
+ * timestamp are unpacked as for nios_pkt_retune2_unpack(). */
+static inline void nios_pkt_retune2_gain_unpack(const uint8_t *buf,
+                                                uint8_t *chan,
+                                                uint16_t *setting)
+{
+    *setting  = ( ((uint16_t)buf[NIOS_PKT_RETUNE2_IDX_GAIN_SETTING + 0])
+                  << 0 );
+    *setting |= ( ((uint16_t)buf[NIOS_PKT_RETUNE2_IDX_GAIN_SETTING + 1])
+                  << 8 );
+
+    *chan = buf[NIOS_PKT_RETUNE2_IDX_GAIN_CHAN];
+}
+
 
 /*
  *                             Response
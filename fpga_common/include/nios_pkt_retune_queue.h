@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef BLADERF_NIOS_PKT_RETUNE_QUEUE_H_
+#define BLADERF_NIOS_PKT_RETUNE_QUEUE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* This file defines the Host <-> FPGA (NIOS II) packet formats for querying
+ * and selectively canceling the entries of the scheduled retune queue used by
+ * retune and retune2 requests. All values are little-endian.
+ *
+ *                              Request
+ *                      ----------------------
+ *
+ * +================+=========================================================+
+ * |  Byte offset   |                       Description                       |
+ * +================+=========================================================+
+ * |        0       | Magic Value                                             |
+ * +----------------+---------------------------------------------------------+
+ * |        1       | Bit  7:     RX bit (set if this is the RX queue)        |
+ * |                | Bits [6:2]: Reserved. Set to 0.                         |
+ * |                | Bits [1:0]: Command (Note 1)                            |
+ * +----------------+---------------------------------------------------------+
+ * |        2       | 56-bit start timestamp (Note 2)                         |
+ * +----------------+---------------------------------------------------------+
+ * |        9       | 56-bit end timestamp, inclusive (Note 2)                |
+ * +----------------+---------------------------------------------------------+
+ *
+ * (Note 1) Commands:
+ *
+ *  0x0: Query the queue. The timestamps are ignored.
+ *  0x1: Cancel the pending entries with timestamps from start to end.
+ *
+ * (Note 2) Timestamps are truncated to 56 bits, which spans decades at any
+ *          supported sample rate. An end timestamp of 0xffffffffffffff
+ *          denotes no upper bound.
+ *
+ *
+ *                             Response
+ *                      ----------------------
+ *
+ * +================+=========================================================+
+ * |  Byte offset   |                       Description                       |
+ * +================+=========================================================+
+ * |        0       | Magic Value                                             |
+ * +----------------+---------------------------------------------------------+
+ * |        1       | Status Flags (Note 3)                                   |
+ * +----------------+---------------------------------------------------------+
+ * |        2       | Number of pending entries, after any cancellation       |
+ * +----------------+---------------------------------------------------------+
+ * |        3       | Capacity of the queue                                   |
+ * +----------------+---------------------------------------------------------+
+ * |        4       | Number of entries canceled                              |
+ * +----------------+---------------------------------------------------------+
+ * |        5       | 64-bit timestamp of the next pending entry              |
+ * +----------------+---------------------------------------------------------+
+ * |      13-15     | Reserved. All bits set to 0.                            |
+ * +----------------+---------------------------------------------------------+
+ *
+ * (Note 3) Description of Status Flags:
+ *
+ *      flags[0]: 1 = Operation completed successfully.
+ *                0 = Operation failed.
+ *
+ *      flags[1]: 1 = The next pending entry's timestamp is valid.
+ *                0 = The queue is empty.
+ *
+ *      flags[7:2]    Reserved. Set to 0.
+ */
+
+#define NIOS_PKT_RETUNE_QUEUE_MAGIC             'Q'
+
+#define NIOS_PKT_RETUNE_QUEUE_IDX_MAGIC         0
+#define NIOS_PKT_RETUNE_QUEUE_IDX_CMD           1
+#define NIOS_PKT_RETUNE_QUEUE_IDX_START         2
+#define NIOS_PKT_RETUNE_QUEUE_IDX_END           9
+
+#define NIOS_PKT_RETUNE_QUEUE_CMD_IS_RX_MASK    (0x1 << 7)
+#define NIOS_PKT_RETUNE_QUEUE_CMD_MASK          0x3
+
+#define NIOS_PKT_RETUNE_QUEUE_CMD_QUERY         0x0
+#define NIOS_PKT_RETUNE_QUEUE_CMD_CANCEL        0x1
+
+/* Largest timestamp that may be packed. As an end timestamp, this denotes
+ * no upper bound */
+#define NIOS_PKT_RETUNE_QUEUE_TIME_MAX          ((UINT64_C(1) << 56) - 1)
+
+#define NIOS_PKT_RETUNE_QUEUE_RESP_IDX_MAGIC    0
+#define NIOS_PKT_RETUNE_QUEUE_RESP_IDX_FLAGS    1
+#define NIOS_PKT_RETUNE_QUEUE_RESP_IDX_COUNT    2
+#define NIOS_PKT_RETUNE_QUEUE_RESP_IDX_CAPACITY 3
+#define NIOS_PKT_RETUNE_QUEUE_RESP_IDX_CANCELED 4
+#define NIOS_PKT_RETUNE_QUEUE_RESP_IDX_NEXT     5
+#define NIOS_PKT_RETUNE_QUEUE_RESP_IDX_RESV     13
+
+#define NIOS_PKT_RETUNE_QUEUE_RESP_FLAG_SUCCESS    (1 << 0)
+#define NIOS_PKT_RETUNE_QUEUE_RESP_FLAG_NEXT_VALID (1 << 1)
+
+static inline void _nios_pkt_retune_queue_pack_time(uint8_t *buf,
+                                                    uint64_t timestamp)
+{
+    uint8_t i;
+
+    if (timestamp > NIOS_PKT_RETUNE_QUEUE_TIME_MAX) {
+        timestamp = NIOS_PKT_RETUNE_QUEUE_TIME_MAX;
+    }
+
+    for (i = 0; i < 7; i++) {
+        buf[i] = (timestamp >> (8 * i)) & 0xff;
+    }
+}
+
+static inline uint64_t _nios_pkt_retune_queue_unpack_time(const uint8_t *buf)
+{
+    uint64_t timestamp = 0;
+    uint8_t i;
+
+    for (i = 0; i < 7; i++) {
+        timestamp |= ((uint64_t)buf[i]) << (8 * i);
+    }
+
+    return timestamp;
+}
+
+/* Pack a queue request */
+static inline void nios_pkt_retune_queue_pack(uint8_t *buf,
+                                              bool is_rx,
+                                              uint8_t cmd,
+                                              uint64_t start,
+                                              uint64_t end)
+{
+    buf[NIOS_PKT_RETUNE_QUEUE_IDX_MAGIC] = NIOS_PKT_RETUNE_QUEUE_MAGIC;
+
+    buf[NIOS_PKT_RETUNE_QUEUE_IDX_CMD] =
+        (cmd & NIOS_PKT_RETUNE_QUEUE_CMD_MASK) |
+        (is_rx ? NIOS_PKT_RETUNE_QUEUE_CMD_IS_RX_MASK : 0x0);
+
+    _nios_pkt_retune_queue_pack_time(&buf[NIOS_PKT_RETUNE_QUEUE_IDX_START],
+                                     start);
+    _nios_pkt_retune_queue_pack_time(&buf[NIOS_PKT_RETUNE_QUEUE_IDX_END], end);
+}
+
+/* Unpack a queue request. An unbounded end timestamp is unpacked as
+ * UINT64_MAX. */
+static inline void nios_pkt_retune_queue_unpack(const uint8_t *buf,
+                                                bool *is_rx,
+                                                uint8_t *cmd,
+                                                uint64_t *start,
+                                                uint64_t *end)
+{
+    *is_rx = (buf[NIOS_PKT_RETUNE_QUEUE_IDX_CMD] &
+              NIOS_PKT_RETUNE_QUEUE_CMD_IS_RX_MASK) != 0;
+
+    *cmd = buf[NIOS_PKT_RETUNE_QUEUE_IDX_CMD] & NIOS_PKT_RETUNE_QUEUE_CMD_MASK;
+
+    *start = _nios_pkt_retune_queue_unpack_time(
+        &buf[NIOS_PKT_RETUNE_QUEUE_IDX_START]);
+
+    *end = _nios_pkt_retune_queue_unpack_time(
+        &buf[NIOS_PKT_RETUNE_QUEUE_IDX_END]);
+
+    if (*end == NIOS_PKT_RETUNE_QUEUE_TIME_MAX) {
+        *end = UINT64_MAX;
+    }
+}
+
+/* Pack a queue response */
+static inline void nios_pkt_retune_queue_resp_pack(uint8_t *buf,
+                                                   bool success,
+                                                   uint8_t count,
+                                                   uint8_t capacity,
+                                                   uint8_t canceled,
+                                                   uint64_t next)
+{
+    uint8_t i;
+
+    buf[NIOS_PKT_RETUNE_QUEUE_RESP_IDX_MAGIC] = NIOS_PKT_RETUNE_QUEUE_MAGIC;
+
+    buf[NIOS_PKT_RETUNE_QUEUE_RESP_IDX_FLAGS] =
+        (success ? NIOS_PKT_RETUNE_QUEUE_RESP_FLAG_SUCCESS : 0) |
+        (count > 0 ? NIOS_PKT_RETUNE_QUEUE_RESP_FLAG_NEXT_VALID : 0);
+
+    buf[NIOS_PKT_RETUNE_QUEUE_RESP_IDX_COUNT]    = count;
+    buf[NIOS_PKT_RETUNE_QUEUE_RESP_IDX_CAPACITY] = capacity;
+    buf[NIOS_PKT_RETUNE_QUEUE_RESP_IDX_CANCELED] = canceled;
+
+    for (i = 0; i < 8; i++) {
+        buf[NIOS_PKT_RETUNE_QUEUE_RESP_IDX_NEXT + i] = (next >> (8 * i)) & 0xff;
+    }
+
+    buf[NIOS_PKT_RETUNE_QUEUE_RESP_IDX_RESV + 0] = 0x00;
+    buf[NIOS_PKT_RETUNE_QUEUE_RESP_IDX_RESV + 1] = 0x00;
+    buf[NIOS_PKT_RETUNE_QUEUE_RESP_IDX_RESV + 2] = 0x00;
+}
+
+/* Unpack a queue response */
+static inline void nios_pkt_retune_queue_resp_unpack(const uint8_t *buf,
+                                                     bool *success,
+                                                     uint8_t *count,
+                                                     uint8_t *capacity,
+                                                     uint8_t *canceled,
+                                                     bool *next_valid,
+                                                     uint64_t *next)
+{
+    uint8_t flags = buf[NIOS_PKT_RETUNE_QUEUE_RESP_IDX_FLAGS];
+    uint8_t i;
+
+    *success    = (flags & NIOS_PKT_RETUNE_QUEUE_RESP_FLAG_SUCCESS) != 0;
+    *next_valid = (flags & NIOS_PKT_RETUNE_QUEUE_RESP_FLAG_NEXT_VALID) != 0;
+
+    *count    = buf[NIOS_PKT_RETUNE_QUEUE_RESP_IDX_COUNT];
+    *capacity = buf[NIOS_PKT_RETUNE_QUEUE_RESP_IDX_CAPACITY];
+    *canceled = buf[NIOS_PKT_RETUNE_QUEUE_RESP_IDX_CANCELED];
+
+    *next = 0;
+    for (i = 0; i < 8; i++) {
+        *next |= ((uint64_t)buf[NIOS_PKT_RETUNE_QUEUE_RESP_IDX_NEXT + i])
+                 << (8 * i);
+    }
+}
+
+#endif
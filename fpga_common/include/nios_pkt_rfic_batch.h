@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BLADERF_NIOS_PKT_RFIC_BATCH_H_
+#define BLADERF_NIOS_PKT_RFIC_BATCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * This file defines the Host <-> FPGA (NIOS II) packet format for enqueuing
+ * multiple RFIC write commands (see NIOS_PKT_16x64_TARGET_RFIC) at once.
+ *
+ * Each entry packs the 12-bit RFIC address used by the 16x64 RFIC target
+ * (command in bits 7:0, channel in bits 11:8) with up to 36 bits of data.
+ *
+ *
+ * +================+=========================================================+
+ * |  Byte offset   |                       Description                       |
+ * +================+=========================================================+
+ * |        0       | Magic Value                                             |
+ * +----------------+---------------------------------------------------------+
+ * |        1       | Number of entries (1 to NIOS_PKT_RFIC_BATCH_MAX)        |
+ * +----------------+---------------------------------------------------------+
+ * |        2       | Flags. Set to 0x00. (Note 1)                            |
+ * +----------------+---------------------------------------------------------+
+ * |        3       | Reserved. Set to 0x00. (Note 2)                         |
+ * +----------------+---------------------------------------------------------+
+ * |       9:4      | Entry 0: 48-bit little-endian value, with the address   |
+ * |                | in bits 11:0 and data in bits 47:12                     |
+ * +----------------+---------------------------------------------------------+
+ * |      15:10     | Entry 1, in the same format as entry 0                  |
+ * +----------------+---------------------------------------------------------+
+ *
+ *
+ * The response packet contains the same information as the request, with
+ * the following fields updated.
+ *
+ * (Note 1) Bit n is set if entry n was enqueued. Entries are enqueued in
+ *          order, stopping at the first failure. If enqueuing stopped because
+ *          the RFIC write queue was full, NIOS_PKT_RFIC_BATCH_FLAG_QUEUE_FULL
+ *          is set, and the remaining entries may be resent later.
+ *
+ * (Note 2) The number of commands in the RFIC write queue after enqueuing.
+ */
+
+#define NIOS_PKT_RFIC_BATCH_MAGIC           ((uint8_t) 'R')
+
+/* Request packet indices */
+#define NIOS_PKT_RFIC_BATCH_IDX_MAGIC       0
+#define NIOS_PKT_RFIC_BATCH_IDX_COUNT       1
+#define NIOS_PKT_RFIC_BATCH_IDX_FLAGS       2
+#define NIOS_PKT_RFIC_BATCH_IDX_QUEUE_LEN   3
+#define NIOS_PKT_RFIC_BATCH_IDX_ENTRY       4
+
+#define NIOS_PKT_RFIC_BATCH_ENTRY_LEN       6
+#define NIOS_PKT_RFIC_BATCH_MAX             2
+
+#define NIOS_PKT_RFIC_BATCH_ADDR_BITS       12
+#define NIOS_PKT_RFIC_BATCH_ADDR_MASK       ((1 << NIOS_PKT_RFIC_BATCH_ADDR_BITS) - 1)
+#define NIOS_PKT_RFIC_BATCH_DATA_MAX        ((((uint64_t) 1) << 36) - 1)
+
+/* Flag bits */
+#define NIOS_PKT_RFIC_BATCH_FLAG_ENQUEUED(n)  (1 << (n))
+#define NIOS_PKT_RFIC_BATCH_FLAG_QUEUE_FULL   (1 << 7)
+
+/* Returns true if the address and data can be carried in a batch entry */
+static inline bool nios_pkt_rfic_batch_fits(uint16_t addr, uint64_t data)
+{
+    return (addr & ~NIOS_PKT_RFIC_BATCH_ADDR_MASK) == 0 &&
+           data <= NIOS_PKT_RFIC_BATCH_DATA_MAX;
+}
+
+/* Initialize a request buffer with no entries */
+static inline void nios_pkt_rfic_batch_init(uint8_t *buf)
+{
+    uint8_t i;
+
+    buf[NIOS_PKT_RFIC_BATCH_IDX_MAGIC]     = NIOS_PKT_RFIC_BATCH_MAGIC;
+    buf[NIOS_PKT_RFIC_BATCH_IDX_COUNT]     = 0x00;
+    buf[NIOS_PKT_RFIC_BATCH_IDX_FLAGS]     = 0x00;
+    buf[NIOS_PKT_RFIC_BATCH_IDX_QUEUE_LEN] = 0x00;
+
+    for (i = NIOS_PKT_RFIC_BATCH_IDX_ENTRY;
+         i < NIOS_PKT_RFIC_BATCH_IDX_ENTRY +
+                 NIOS_PKT_RFIC_BATCH_MAX * NIOS_PKT_RFIC_BATCH_ENTRY_LEN;
+         i++) {
+        buf[i] = 0x00;
+    }
+}
+
+/* Append an entry to a request buffer. The caller is responsible for
+ * checking that there is room, and that nios_pkt_rfic_batch_fits(). */
+static inline void nios_pkt_rfic_batch_add(uint8_t *buf, uint16_t addr,
+                                           uint64_t data)
+{
+    const uint8_t n   = buf[NIOS_PKT_RFIC_BATCH_IDX_COUNT];
+    uint8_t *entry    = &buf[NIOS_PKT_RFIC_BATCH_IDX_ENTRY +
+                             n * NIOS_PKT_RFIC_BATCH_ENTRY_LEN];
+    const uint64_t v  = (addr & NIOS_PKT_RFIC_BATCH_ADDR_MASK) |
+                        (data << NIOS_PKT_RFIC_BATCH_ADDR_BITS);
+
+    entry[0] = (v >> 0)  & 0xff;
+    entry[1] = (v >> 8)  & 0xff;
+    entry[2] = (v >> 16) & 0xff;
+    entry[3] = (v >> 24) & 0xff;
+    entry[4] = (v >> 32) & 0xff;
+    entry[5] = (v >> 40) & 0xff;
+
+    buf[NIOS_PKT_RFIC_BATCH_IDX_COUNT] = n + 1;
+}
+
+/* Unpack entry n of a request buffer */
+static inline void nios_pkt_rfic_batch_get(const uint8_t *buf, uint8_t n,
+                                           uint16_t *addr, uint64_t *data)
+{
+    const uint8_t *entry = &buf[NIOS_PKT_RFIC_BATCH_IDX_ENTRY +
+                                n * NIOS_PKT_RFIC_BATCH_ENTRY_LEN];
+    const uint64_t v     = ((uint64_t) entry[0] << 0)  |
+                           ((uint64_t) entry[1] << 8)  |
+                           ((uint64_t) entry[2] << 16) |
+                           ((uint64_t) entry[3] << 24) |
+                           ((uint64_t) entry[4] << 32) |
+                           ((uint64_t) entry[5] << 40);
+
+    *addr = v & NIOS_PKT_RFIC_BATCH_ADDR_MASK;
+    *data = v >> NIOS_PKT_RFIC_BATCH_ADDR_BITS;
+}
+
+/* Pack the response buffer, in place over the request */
+static inline void nios_pkt_rfic_batch_resp_pack(uint8_t *buf, uint8_t flags,
+                                                 uint8_t queue_len)
+{
+    buf[NIOS_PKT_RFIC_BATCH_IDX_FLAGS]     = flags;
+    buf[NIOS_PKT_RFIC_BATCH_IDX_QUEUE_LEN] = queue_len;
+}
+
+/* Unpack the response buffer. `enqueued` is set to the number of leading
+ * entries that were enqueued. */
+static inline void nios_pkt_rfic_batch_resp_unpack(const uint8_t *buf,
+                                                   uint8_t *enqueued,
+                                                   bool *queue_full,
+                                                   uint8_t *queue_len)
+{
+    const uint8_t flags = buf[NIOS_PKT_RFIC_BATCH_IDX_FLAGS];
+    const uint8_t count = buf[NIOS_PKT_RFIC_BATCH_IDX_COUNT];
+    uint8_t n = 0;
+
+    while (n < count && n < NIOS_PKT_RFIC_BATCH_MAX &&
+           (flags & NIOS_PKT_RFIC_BATCH_FLAG_ENQUEUED(n)) != 0) {
+        n++;
+    }
+
+    if (enqueued != NULL) {
+        *enqueued = n;
+    }
+
+    if (queue_full != NULL) {
+        *queue_full = (flags & NIOS_PKT_RFIC_BATCH_FLAG_QUEUE_FULL) != 0;
+    }
+
+    if (queue_len != NULL) {
+        *queue_len = buf[NIOS_PKT_RFIC_BATCH_IDX_QUEUE_LEN];
+    }
+}
+
+#endif
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef BLADERF_NIOS_PKT_TIMED_WRITE_H_
+#define BLADERF_NIOS_PKT_TIMED_WRITE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* This file defines the Host <-> FPGA (NIOS II) packet formats for
+ * scheduling a peripheral write at a timestamp. The write is described by
+ * the 8x8, 8x16, 8x32 or 32x32 request it is equivalent to, and is placed in
+ * the scheduled retune queue used by retune and retune2 requests. Querying,
+ * canceling and clearing that queue therefore applies to timed writes as
+ * well. All values are little-endian.
+ *
+ *                              Request
+ *                      ----------------------
+ *
+ * +================+=========================================================+
+ * |  Byte offset   |                       Description                       |
+ * +================+=========================================================+
+ * |        0       | Magic Value                                             |
+ * +----------------+---------------------------------------------------------+
+ * |        1       | Bit  7:     RX bit (set to use the RX timestamp and     |
+ * |                |             queue)                                      |
+ * |                | Bits [6:0]: Reserved. Set to 0.                         |
+ * +----------------+---------------------------------------------------------+
+ * |        2       | 56-bit timestamp denoting when to write (Note 1)        |
+ * +----------------+---------------------------------------------------------+
+ * |        9       | Magic value of the equivalent write request (Note 2)    |
+ * +----------------+---------------------------------------------------------+
+ * |       10       | Target ID of the equivalent write request               |
+ * +----------------+---------------------------------------------------------+
+ * |       11       | 8-bit address (Note 2)                                  |
+ * +----------------+---------------------------------------------------------+
+ * |       12       | 32-bit data, truncated to the width of the equivalent   |
+ * |                | write request                                           |
+ * +----------------+---------------------------------------------------------+
+ *
+ * (Note 1) Timestamps are truncated to 56 bits, as in retune queue requests.
+ *          A timestamp of 0 denotes that the write should occur "now".
+ *
+ * (Note 2) One of NIOS_PKT_8x8_MAGIC, NIOS_PKT_8x16_MAGIC, NIOS_PKT_8x32_MAGIC
+ *          or NIOS_PKT_32x32_MAGIC. For 32x32 writes, the address is sign
+ *          extended, so that 0xff denotes the unmasked writes of the
+ *          expansion I/O targets.
+ *
+ *
+ *                             Response
+ *                      ----------------------
+ *
+ * +================+=========================================================+
+ * |  Byte offset   |                       Description                       |
+ * +================+=========================================================+
+ * |        0       | Magic Value                                             |
+ * +----------------+---------------------------------------------------------+
+ * |        1       | Status Flags (Note 3)                                   |
+ * +----------------+---------------------------------------------------------+
+ * |        2       | Number of pending entries in the queue                  |
+ * +----------------+---------------------------------------------------------+
+ * |       3-15     | Reserved. All bits set to 0.                            |
+ * +----------------+---------------------------------------------------------+
+ *
+ * (Note 3) Description of Status Flags:
+ *
+ *      flags[0]: 1 = Operation completed successfully.
+ *                0 = Operation failed.
+ *
+ *      flags[1]: 1 = The write could not be scheduled because the queue is
+ *                    full.
+ *                0 = Otherwise.
+ *
+ *      flags[7:2]    Reserved. Set to 0.
+ *
+ * A write scheduled in the future is only checked when it comes due, so the
+ * success flag reports that it was enqueued.
+ */
+
+#define NIOS_PKT_TIMED_WRITE_MAGIC              'W'
+
+#define NIOS_PKT_TIMED_WRITE_IDX_MAGIC          0
+#define NIOS_PKT_TIMED_WRITE_IDX_FLAGS          1
+#define NIOS_PKT_TIMED_WRITE_IDX_TIME           2
+#define NIOS_PKT_TIMED_WRITE_IDX_TYPE           9
+#define NIOS_PKT_TIMED_WRITE_IDX_TARGET_ID      10
+#define NIOS_PKT_TIMED_WRITE_IDX_ADDR           11
+#define NIOS_PKT_TIMED_WRITE_IDX_DATA           12
+
+#define NIOS_PKT_TIMED_WRITE_FLAG_IS_RX         (1 << 7)
+
+/* Denotes that the write should not be scheduled - it should occur "now" */
+#define NIOS_PKT_TIMED_WRITE_NOW                ((uint64_t) 0x00)
+
+/* Largest timestamp that may be packed */
+#define NIOS_PKT_TIMED_WRITE_TIME_MAX           ((UINT64_C(1) << 56) - 1)
+
+#define NIOS_PKT_TIMED_WRITE_RESP_IDX_MAGIC     0
+#define NIOS_PKT_TIMED_WRITE_RESP_IDX_FLAGS     1
+#define NIOS_PKT_TIMED_WRITE_RESP_IDX_COUNT     2
+#define NIOS_PKT_TIMED_WRITE_RESP_IDX_RESV      3
+
+#define NIOS_PKT_TIMED_WRITE_RESP_FLAG_SUCCESS    (1 << 0)
+#define NIOS_PKT_TIMED_WRITE_RESP_FLAG_QUEUE_FULL (1 << 1)
+
+/* Pack a timed write request */
+static inline void nios_pkt_timed_write_pack(uint8_t *buf,
+                                             bool is_rx,
+                                             uint64_t timestamp,
+                                             uint8_t type,
+                                             uint8_t id,
+                                             uint8_t addr,
+                                             uint32_t data)
+{
+    uint8_t i;
+
+    if (timestamp > NIOS_PKT_TIMED_WRITE_TIME_MAX) {
+        timestamp = NIOS_PKT_TIMED_WRITE_TIME_MAX;
+    }
+
+    buf[NIOS_PKT_TIMED_WRITE_IDX_MAGIC] = NIOS_PKT_TIMED_WRITE_MAGIC;
+    buf[NIOS_PKT_TIMED_WRITE_IDX_FLAGS] =
+        is_rx ? NIOS_PKT_TIMED_WRITE_FLAG_IS_RX : 0x00;
+
+    for (i = 0; i < 7; i++) {
+        buf[NIOS_PKT_TIMED_WRITE_IDX_TIME + i] = (timestamp >> (8 * i)) & 0xff;
+    }
+
+    buf[NIOS_PKT_TIMED_WRITE_IDX_TYPE]      = type;
+    buf[NIOS_PKT_TIMED_WRITE_IDX_TARGET_ID] = id;
+    buf[NIOS_PKT_TIMED_WRITE_IDX_ADDR]      = addr;
+
+    for (i = 0; i < 4; i++) {
+        buf[NIOS_PKT_TIMED_WRITE_IDX_DATA + i] = (data >> (8 * i)) & 0xff;
+    }
+}
+
+/* Unpack a timed write request */
+static inline void nios_pkt_timed_write_unpack(const uint8_t *buf,
+                                               bool *is_rx,
+                                               uint64_t *timestamp,
+                                               uint8_t *type,
+                                               uint8_t *id,
+                                               uint8_t *addr,
+                                               uint32_t *data)
+{
+    uint8_t i;
+
+    *is_rx = (buf[NIOS_PKT_TIMED_WRITE_IDX_FLAGS] &
+              NIOS_PKT_TIMED_WRITE_FLAG_IS_RX) != 0;
+
+    *timestamp = 0;
+    for (i = 0; i < 7; i++) {
+        *timestamp |= ((uint64_t)buf[NIOS_PKT_TIMED_WRITE_IDX_TIME + i])
+                      << (8 * i);
+    }
+
+    *type = buf[NIOS_PKT_TIMED_WRITE_IDX_TYPE];
+    *id   = buf[NIOS_PKT_TIMED_WRITE_IDX_TARGET_ID];
+    *addr = buf[NIOS_PKT_TIMED_WRITE_IDX_ADDR];
+
+    *data = 0;
+    for (i = 0; i < 4; i++) {
+        *data |= ((uint32_t)buf[NIOS_PKT_TIMED_WRITE_IDX_DATA + i]) << (8 * i);
+    }
+}
+
+/* Pack a timed write response */
+static inline void nios_pkt_timed_write_resp_pack(uint8_t *buf,
+                                                  bool success,
+                                                  bool queue_full,
+                                                  uint8_t count)
+{
+    uint8_t i;
+
+    buf[NIOS_PKT_TIMED_WRITE_RESP_IDX_MAGIC] = NIOS_PKT_TIMED_WRITE_MAGIC;
+
+    buf[NIOS_PKT_TIMED_WRITE_RESP_IDX_FLAGS] =
+        (success ? NIOS_PKT_TIMED_WRITE_RESP_FLAG_SUCCESS : 0) |
+        (queue_full ? NIOS_PKT_TIMED_WRITE_RESP_FLAG_QUEUE_FULL : 0);
+
+    buf[NIOS_PKT_TIMED_WRITE_RESP_IDX_COUNT] = count;
+
+    for (i = NIOS_PKT_TIMED_WRITE_RESP_IDX_RESV; i < 16; i++) {
+        buf[i] = 0x00;
+    }
+}
+
+/* Unpack a timed write response */
+static inline void nios_pkt_timed_write_resp_unpack(const uint8_t *buf,
+                                                    bool *success,
+                                                    bool *queue_full,
+                                                    uint8_t *count)
+{
+    uint8_t flags = buf[NIOS_PKT_TIMED_WRITE_RESP_IDX_FLAGS];
+
+    *success    = (flags & NIOS_PKT_TIMED_WRITE_RESP_FLAG_SUCCESS) != 0;
+    *queue_full = (flags & NIOS_PKT_TIMED_WRITE_RESP_FLAG_QUEUE_FULL) != 0;
+    *count      = buf[NIOS_PKT_TIMED_WRITE_RESP_IDX_COUNT];
+}
+
+#endif
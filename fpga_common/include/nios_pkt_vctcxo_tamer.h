@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef BLADERF_NIOS_PKT_VCTCXO_TAMER_H_
+#define BLADERF_NIOS_PKT_VCTCXO_TAMER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* This file defines the Host <-> FPGA (NIOS II) packet formats for
+ * monitoring the VCTCXO tamer's trim DAC control loop, and for restarting
+ * its acquisition. All values are little-endian.
+ *
+ *                              Request
+ *                      ----------------------
+ *
+ * +================+=========================================================+
+ * |  Byte offset   |                       Description                       |
+ * +================+=========================================================+
+ * |        0       | Magic Value                                             |
+ * +----------------+---------------------------------------------------------+
+ * |        1       | Command (Note 1)                                        |
+ * +----------------+---------------------------------------------------------+
+ * |        2       | Bit  0:     Seed valid bit (Note 2)                     |
+ * |                | Bits [7:1]: Reserved. Set to 0.                         |
+ * +----------------+---------------------------------------------------------+
+ * |       3-4      | 16-bit seed trim DAC value (Note 2)                     |
+ * +----------------+---------------------------------------------------------+
+ * |      5-15      | Reserved. Set to 0.                                     |
+ * +----------------+---------------------------------------------------------+
+ *
+ * (Note 1) Commands:
+ *
+ *  0x0: Query the state of the control loop.
+ *  0x1: Restart acquisition, then query the state of the control loop.
+ *
+ * (Note 2) When restarting acquisition with a valid seed, the trim DAC is
+ *          set to the seed and the error measured there. If it is within
+ *          tolerance and the DAC's response is already known, the loop
+ *          proceeds straight to fine tuning. Otherwise, the response is
+ *          measured with a small step from the seed, and the DAC is set to
+ *          the value this predicts to be error-free.
+ *
+ *          Without a seed, the DAC's response is measured across its full
+ *          range, as is done when the tamer is first enabled.
+ *
+ *
+ *                             Response
+ *                      ----------------------
+ *
+ * +================+=========================================================+
+ * |  Byte offset   |                       Description                       |
+ * +================+=========================================================+
+ * |        0       | Magic Value                                             |
+ * +----------------+---------------------------------------------------------+
+ * |        1       | Status Flags (Note 3)                                   |
+ * +----------------+---------------------------------------------------------+
+ * |        2       | State (Note 4)                                          |
+ * +----------------+---------------------------------------------------------+
+ * |        3       | Number of measurements taken since acquisition started, |
+ * |                | saturating at 255                                       |
+ * +----------------+---------------------------------------------------------+
+ * |       4-5      | 16-bit current trim DAC value                           |
+ * +----------------+---------------------------------------------------------+
+ * |       6-9      | Signed 32-bit error over the last 1 s interval, in      |
+ * |                | reference clock cycles                                  |
+ * +----------------+---------------------------------------------------------+
+ * |      10-13     | Signed 32-bit error over the last 10 s interval, in     |
+ * |                | reference clock cycles                                  |
+ * +----------------+---------------------------------------------------------+
+ * |      14-15     | Reserved. All bits set to 0.                            |
+ * +----------------+---------------------------------------------------------+
+ *
+ * (Note 3) Description of Status Flags:
+ *
+ *      flags[0]: 1 = Operation completed successfully.
+ *                0 = Operation failed.
+ *
+ *      flags[1]: 1 = The errors are from a valid measurement.
+ *                0 = No measurement has been taken since acquisition started.
+ *
+ *      flags[2]: 1 = The last 1 s error exceeded its tolerance.
+ *      flags[3]: 1 = The last 10 s error exceeded its tolerance.
+ *      flags[4]: 1 = The last 100 s error exceeded its tolerance.
+ *
+ *      flags[7:5]    Reserved. Set to 0.
+ *
+ * (Note 4) States:
+ *
+ *  0x0: Coarse tuning, measuring the minimum DAC value
+ *  0x1: Coarse tuning, measuring the maximum DAC value
+ *  0x2: Coarse tuning, computing the error-free DAC value
+ *  0x3: Fine tuning
+ *  0x4: Seeded acquisition, measuring the seed
+ *  0x5: Seeded acquisition, measuring a step from the seed
+ */
+
+#define NIOS_PKT_VCTCXO_TAMER_MAGIC             'V'
+
+#define NIOS_PKT_VCTCXO_TAMER_IDX_MAGIC         0
+#define NIOS_PKT_VCTCXO_TAMER_IDX_CMD           1
+#define NIOS_PKT_VCTCXO_TAMER_IDX_FLAGS         2
+#define NIOS_PKT_VCTCXO_TAMER_IDX_SEED          3
+#define NIOS_PKT_VCTCXO_TAMER_IDX_RESV          5
+
+#define NIOS_PKT_VCTCXO_TAMER_CMD_QUERY         0x0
+#define NIOS_PKT_VCTCXO_TAMER_CMD_ACQUIRE       0x1
+
+#define NIOS_PKT_VCTCXO_TAMER_FLAG_SEED_VALID   (1 << 0)
+
+#define NIOS_PKT_VCTCXO_TAMER_RESP_IDX_MAGIC    0
+#define NIOS_PKT_VCTCXO_TAMER_RESP_IDX_FLAGS    1
+#define NIOS_PKT_VCTCXO_TAMER_RESP_IDX_STATE    2
+#define NIOS_PKT_VCTCXO_TAMER_RESP_IDX_COUNT    3
+#define NIOS_PKT_VCTCXO_TAMER_RESP_IDX_TRIM     4
+#define NIOS_PKT_VCTCXO_TAMER_RESP_IDX_ERR_1S   6
+#define NIOS_PKT_VCTCXO_TAMER_RESP_IDX_ERR_10S  10
+#define NIOS_PKT_VCTCXO_TAMER_RESP_IDX_RESV     14
+
+#define NIOS_PKT_VCTCXO_TAMER_RESP_FLAG_SUCCESS     (1 << 0)
+#define NIOS_PKT_VCTCXO_TAMER_RESP_FLAG_MEAS_VALID  (1 << 1)
+#define NIOS_PKT_VCTCXO_TAMER_RESP_FLAG_ERR_1S      (1 << 2)
+#define NIOS_PKT_VCTCXO_TAMER_RESP_FLAG_ERR_10S     (1 << 3)
+#define NIOS_PKT_VCTCXO_TAMER_RESP_FLAG_ERR_100S    (1 << 4)
+
+#define NIOS_PKT_VCTCXO_TAMER_STATE_COARSE_MIN  0x0
+#define NIOS_PKT_VCTCXO_TAMER_STATE_COARSE_MAX  0x1
+#define NIOS_PKT_VCTCXO_TAMER_STATE_COARSE_DONE 0x2
+#define NIOS_PKT_VCTCXO_TAMER_STATE_FINE        0x3
+#define NIOS_PKT_VCTCXO_TAMER_STATE_SEED_CHECK  0x4
+#define NIOS_PKT_VCTCXO_TAMER_STATE_SEED_STEP   0x5
+
+/* Pack a tamer request */
+static inline void nios_pkt_vctcxo_tamer_pack(uint8_t *buf,
+                                              uint8_t cmd,
+                                              bool seed_valid,
+                                              uint16_t seed)
+{
+    uint8_t i;
+
+    buf[NIOS_PKT_VCTCXO_TAMER_IDX_MAGIC] = NIOS_PKT_VCTCXO_TAMER_MAGIC;
+    buf[NIOS_PKT_VCTCXO_TAMER_IDX_CMD]   = cmd;
+    buf[NIOS_PKT_VCTCXO_TAMER_IDX_FLAGS] =
+        seed_valid ? NIOS_PKT_VCTCXO_TAMER_FLAG_SEED_VALID : 0x0;
+
+    buf[NIOS_PKT_VCTCXO_TAMER_IDX_SEED + 0] = seed & 0xff;
+    buf[NIOS_PKT_VCTCXO_TAMER_IDX_SEED + 1] = (seed >> 8) & 0xff;
+
+    for (i = NIOS_PKT_VCTCXO_TAMER_IDX_RESV; i < 16; i++) {
+        buf[i] = 0x00;
+    }
+}
+
+/* Unpack a tamer request */
+static inline void nios_pkt_vctcxo_tamer_unpack(const uint8_t *buf,
+                                                uint8_t *cmd,
+                                                bool *seed_valid,
+                                                uint16_t *seed)
+{
+    *cmd        = buf[NIOS_PKT_VCTCXO_TAMER_IDX_CMD];
+    *seed_valid = (buf[NIOS_PKT_VCTCXO_TAMER_IDX_FLAGS] &
+                   NIOS_PKT_VCTCXO_TAMER_FLAG_SEED_VALID) != 0;
+
+    *seed = ((uint16_t)buf[NIOS_PKT_VCTCXO_TAMER_IDX_SEED + 0]) |
+            ((uint16_t)buf[NIOS_PKT_VCTCXO_TAMER_IDX_SEED + 1] << 8);
+}
+
+static inline void _nios_pkt_vctcxo_tamer_pack_err(uint8_t *buf, int32_t err)
+{
+    uint32_t val = (uint32_t)err;
+    uint8_t i;
+
+    for (i = 0; i < 4; i++) {
+        buf[i] = (val >> (8 * i)) & 0xff;
+    }
+}
+
+static inline int32_t _nios_pkt_vctcxo_tamer_unpack_err(const uint8_t *buf)
+{
+    uint32_t val = 0;
+    uint8_t i;
+
+    for (i = 0; i < 4; i++) {
+        val |= ((uint32_t)buf[i]) << (8 * i);
+    }
+
+    return (int32_t)val;
+}
+
+/* Pack a tamer response. `flags` holds the NIOS_PKT_VCTCXO_TAMER_RESP_FLAG_*
+ * bits other than SUCCESS. */
+static inline void nios_pkt_vctcxo_tamer_resp_pack(uint8_t *buf,
+                                                   bool success,
+                                                   uint8_t flags,
+                                                   uint8_t state,
+                                                   uint8_t count,
+                                                   uint16_t trim,
+                                                   int32_t err_1s,
+                                                   int32_t err_10s)
+{
+    buf[NIOS_PKT_VCTCXO_TAMER_RESP_IDX_MAGIC] = NIOS_PKT_VCTCXO_TAMER_MAGIC;
+
+    buf[NIOS_PKT_VCTCXO_TAMER_RESP_IDX_FLAGS] =
+        (flags & ~NIOS_PKT_VCTCXO_TAMER_RESP_FLAG_SUCCESS) |
+        (success ? NIOS_PKT_VCTCXO_TAMER_RESP_FLAG_SUCCESS : 0);
+
+    buf[NIOS_PKT_VCTCXO_TAMER_RESP_IDX_STATE] = state;
+    buf[NIOS_PKT_VCTCXO_TAMER_RESP_IDX_COUNT] = count;
+
+    buf[NIOS_PKT_VCTCXO_TAMER_RESP_IDX_TRIM + 0] = trim & 0xff;
+    buf[NIOS_PKT_VCTCXO_TAMER_RESP_IDX_TRIM + 1] = (trim >> 8) & 0xff;
+
+    _nios_pkt_vctcxo_tamer_pack_err(
+        &buf[NIOS_PKT_VCTCXO_TAMER_RESP_IDX_ERR_1S], err_1s);
+    _nios_pkt_vctcxo_tamer_pack_err(
+        &buf[NIOS_PKT_VCTCXO_TAMER_RESP_IDX_ERR_10S], err_10s);
+
+    buf[NIOS_PKT_VCTCXO_TAMER_RESP_IDX_RESV + 0] = 0x00;
+    buf[NIOS_PKT_VCTCXO_TAMER_RESP_IDX_RESV + 1] = 0x00;
+}
+
+/* Unpack a tamer response */
+static inline void nios_pkt_vctcxo_tamer_resp_unpack(const uint8_t *buf,
+                                                     bool *success,
+                                                     uint8_t *flags,
+                                                     uint8_t *state,
+                                                     uint8_t *count,
+                                                     uint16_t *trim,
+                                                     int32_t *err_1s,
+                                                     int32_t *err_10s)
+{
+    *flags   = buf[NIOS_PKT_VCTCXO_TAMER_RESP_IDX_FLAGS];
+    *success = (*flags & NIOS_PKT_VCTCXO_TAMER_RESP_FLAG_SUCCESS) != 0;
+    *state   = buf[NIOS_PKT_VCTCXO_TAMER_RESP_IDX_STATE];
+    *count   = buf[NIOS_PKT_VCTCXO_TAMER_RESP_IDX_COUNT];
+
+    *trim = ((uint16_t)buf[NIOS_PKT_VCTCXO_TAMER_RESP_IDX_TRIM + 0]) |
+            ((uint16_t)buf[NIOS_PKT_VCTCXO_TAMER_RESP_IDX_TRIM + 1] << 8);
+
+    *err_1s = _nios_pkt_vctcxo_tamer_unpack_err(
+        &buf[NIOS_PKT_VCTCXO_TAMER_RESP_IDX_ERR_1S]);
+    *err_10s = _nios_pkt_vctcxo_tamer_unpack_err(
+        &buf[NIOS_PKT_VCTCXO_TAMER_RESP_IDX_ERR_10S]);
+}
+
+#endif
@@ -215,6 +215,8 @@ static const struct freq_range {
     FREQ_RANGE(VCO1_LOW/2,              BLADERF_FREQUENCY_MAX,  VCO1 | DIV2),
 };
 
+#endif
+
  /*
  * The LMS FAQ (Rev 1.0r10, Section 5.20) states that the RXVGA1 codes may be
  * converted to dB via:
@@ -241,6 +243,7 @@ static const uint8_t rxvga1_lut_val2code[] = {
     91, 95, 99, 102, 104, 107, 109, 111, 113, 114, 116, 117, 118, 119, 120,
 };
 
+#ifndef BLADERF_NIOS_BUILD
 static const uint8_t lms_reg_dumpset[] = {
     /* Top level configuration */
     0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B,
@@ -714,7 +717,6 @@ int lms_soft_reset(struct bladerf *dev)
 #endif
 
 /* Set the gain on the LNA */
-#ifndef BLADERF_NIOS_BUILD
 int lms_lna_set_gain(struct bladerf *dev, bladerf_lna_gain gain)
 {
     int status;
@@ -736,9 +738,7 @@ int lms_lna_set_gain(struct bladerf *dev, bladerf_lna_gain gain)
 
     return status;
 }
-#endif
 
-#ifndef BLADERF_NIOS_BUILD
 int lms_lna_get_gain(struct bladerf *dev, bladerf_lna_gain *gain)
 {
     int status;
@@ -757,7 +757,6 @@ int lms_lna_get_gain(struct bladerf *dev, bladerf_lna_gain *gain)
 
     return status;
 }
-#endif
 
 /* Select which LNA to enable */
 int lms_select_lna(struct bladerf *dev, lms_lna lna)
@@ -818,7 +817,6 @@ int lms_rxvga1_enable(struct bladerf *dev, bool enable)
 #endif
 
 /* Set the RFB_TIA_RXFE mixer gain */
-#ifndef BLADERF_NIOS_BUILD
 int lms_rxvga1_set_gain(struct bladerf *dev, int gain)
 {
     if (gain > BLADERF_RXVGA1_GAIN_MAX) {
@@ -831,10 +829,8 @@ int lms_rxvga1_set_gain(struct bladerf *dev, int gain)
 
     return LMS_WRITE(dev, 0x76, rxvga1_lut_val2code[gain]);
 }
-#endif
 
 /* Get the RFB_TIA_RXFE mixer gain */
-#ifndef BLADERF_NIOS_BUILD
 int lms_rxvga1_get_gain(struct bladerf *dev, int *gain)
 {
     uint8_t data;
@@ -851,7 +847,6 @@ int lms_rxvga1_get_gain(struct bladerf *dev, int *gain)
 
     return status;
 }
-#endif
 
 /* Enable RXVGA2 */
 #ifndef BLADERF_NIOS_BUILD
@@ -877,7 +872,6 @@ int lms_rxvga2_enable(struct bladerf *dev, bool enable)
 
 
 /* Set the gain on RXVGA2 */
-#ifndef BLADERF_NIOS_BUILD
 int lms_rxvga2_set_gain(struct bladerf *dev, int gain)
 {
     if (gain > BLADERF_RXVGA2_GAIN_MAX) {
@@ -891,9 +885,7 @@ int lms_rxvga2_set_gain(struct bladerf *dev, int gain)
     /* 3 dB per register code */
     return LMS_WRITE(dev, 0x65, gain / 3);
 }
-#endif
 
-#ifndef BLADERF_NIOS_BUILD
 int lms_rxvga2_get_gain(struct bladerf *dev, int *gain)
 {
 
@@ -908,7 +900,6 @@ int lms_rxvga2_get_gain(struct bladerf *dev, int *gain)
 
     return status;
 }
-#endif
 
 int lms_select_pa(struct bladerf *dev, lms_pa pa)
 {
@@ -1782,10 +1773,10 @@ int lms_get_quick_tune(struct bladerf *dev,
             } else {
                 /* BLADERF_XB_CONFIG_TX_BYPASS_MASK */
                 quick_tune->xb_gpio |= ( (val & 0x0C ) >> 2)
-                                            << LMS_FREQ_XB_200_FILTER_SW_SHIFT;
+                                            << LMS_FREQ_XB_200_PATH_SHIFT;
                 /* BLADERF_XB_TX_MASK */
                 quick_tune->xb_gpio |= ( (val & 0x0C000000 ) >> 26)
-                                            << LMS_FREQ_XB_200_PATH_SHIFT;
+                                            << LMS_FREQ_XB_200_FILTER_SW_SHIFT;
             }
         }
 
@@ -1841,6 +1832,22 @@ static inline int write_vcocap(struct bladerf *dev, uint8_t base,
 #define VCO_NORM 0x00
 #define VCO_LOW  0x01
 
+#ifndef BLADERF_NIOS_BUILD
+int lms_get_pll_lock(struct bladerf *dev, bladerf_module mod, bool *locked)
+{
+    const uint8_t base = (mod == BLADERF_MODULE_RX) ? 0x20 : 0x10;
+    uint8_t vtune;
+    int status;
+
+    status = get_vtune(dev, base, 0, &vtune);
+    if (status == 0) {
+        *locked = (vtune == VCO_NORM);
+    }
+
+    return status;
+}
+#endif
+
 #if defined(LOGGING_ENABLED) || defined(BLADERF_NIOS_DEBUG)
 static const char *vtune_str(uint8_t value) {
     switch (value) {
@@ -2217,6 +2224,32 @@ static int tune_vcocap(struct bladerf *dev, uint8_t vcocap_est,
     return status;
 }
 
+/* Check a VCOCAP value taken from a characterization of the board, which
+ * has already been written, with a single VTUNE read. The tuning algorithm
+ * is only run if this finds the VCO outside of its NORM region. */
+static int verify_vcocap(struct bladerf *dev, uint8_t vcocap,
+                         uint8_t base, uint8_t vcocap_reg_state,
+                         uint8_t *vcocap_result)
+{
+    int status;
+    uint8_t vtune;
+
+    status = get_vtune(dev, base, VTUNE_DELAY_LARGE, &vtune);
+    if (status != 0) {
+        return status;
+    }
+
+    if (vtune == VCO_NORM) {
+        *vcocap_result = vcocap;
+        return 0;
+    }
+
+    log_verbose("VTUNE %s at characterized VCOCAP=%u. Running search.\n",
+                vtune_str(vtune), vcocap);
+
+    return tune_vcocap(dev, vcocap, base, vcocap_reg_state, vcocap_result);
+}
+
 int lms_select_band(struct bladerf *dev, bladerf_module module, bool low_band)
 {
     int status;
@@ -2313,6 +2346,27 @@ int lms_calculate_tuning_params(uint32_t freq, struct lms_freq *f)
 }
 #endif
 
+#ifndef BLADERF_NIOS_BUILD
+int lms_get_band(unsigned int band, uint32_t *low, uint32_t *high)
+{
+    if (band >= ARRAY_SIZE(bands)) {
+        return BLADERF_ERR_RANGE;
+    }
+
+    /* lms_calculate_tuning_params() selects the first matching band, so
+     * each band starts where the previous one ends */
+    if (band == 0 || bands[band].low > bands[band - 1].high) {
+        *low = bands[band].low;
+    } else {
+        *low = bands[band - 1].high + 1;
+    }
+
+    *high = bands[band].high;
+
+    return 0;
+}
+#endif
+
 int lms_set_precalculated_frequency(struct bladerf *dev, bladerf_module mod,
                                     struct lms_freq *f)
 {
@@ -2397,6 +2451,9 @@ int lms_set_precalculated_frequency(struct bladerf *dev, bladerf_module mod,
      * the VCOCAP hint as-is. */
     if (f->flags & LMS_FREQ_FLAGS_FORCE_VCOCAP) {
         f->vcocap_result = f->vcocap;
+    } else if (f->flags & LMS_FREQ_FLAGS_VERIFY_VCOCAP) {
+        status = verify_vcocap(dev, f->vcocap, base, vcocap_reg_state,
+                               &f->vcocap_result);
     } else {
         /* Walk down VCOCAP values find an optimal values */
         status = tune_vcocap(dev, f->vcocap, base, vcocap_reg_state,
@@ -2436,7 +2493,6 @@ int lms_dump_registers(struct bladerf *dev)
 #endif
 
 /* Reference LMS6002D calibration guide, section 4.1 flow chart */
-#ifndef BLADERF_NIOS_BUILD
 static int lms_dc_cal_loop(struct bladerf *dev, uint8_t base,
                            uint8_t cal_address, uint8_t dc_cntval,
                            uint8_t *dc_regval)
@@ -2523,9 +2579,7 @@ static int lms_dc_cal_loop(struct bladerf *dev, uint8_t base,
 
     return status;
 }
-#endif
 
-#ifndef BLADERF_NIOS_BUILD
 static inline int dc_cal_backup(struct bladerf *dev,
                                 bladerf_cal_module module,
                                 struct dc_cal_state *state)
@@ -2563,9 +2617,7 @@ static inline int dc_cal_backup(struct bladerf *dev,
 
     return 0;
 }
-#endif
 
-#ifndef BLADERF_NIOS_BUILD
 static int dc_cal_module_init(struct bladerf *dev,
                                      bladerf_cal_module module,
                                      struct dc_cal_state *state)
@@ -2685,7 +2737,6 @@ static int dc_cal_module_init(struct bladerf *dev,
 
     return status;
 }
-#endif
 
 /* The RXVGA2 items here are based upon Lime Microsystems' recommendations
  * in their "Improving RxVGA2 DC Offset Calibration Stability" Document:
@@ -2694,7 +2745,6 @@ static int dc_cal_module_init(struct bladerf *dev,
  * This function assumes that the submodules are preformed in a consecutive
  * and increasing order, as outlined in the above document.
  */
-#ifndef BLADERF_NIOS_BUILD
 static int dc_cal_submodule(struct bladerf *dev,
                                    bladerf_cal_module module,
                                    unsigned int submodule,
@@ -2821,9 +2871,7 @@ static int dc_cal_submodule(struct bladerf *dev,
     *converged = true;
     return 0;
 }
-#endif
 
-#ifndef BLADERF_NIOS_BUILD
 static int dc_cal_retry_adjustment(struct bladerf *dev,
                                           bladerf_cal_module module,
                                           struct dc_cal_state *state,
@@ -2876,9 +2924,7 @@ static int dc_cal_retry_adjustment(struct bladerf *dev,
     }
     return status;
 }
-#endif
 
-#ifndef BLADERF_NIOS_BUILD
 static int dc_cal_module_deinit(struct bladerf *dev,
                                        bladerf_cal_module module,
                                        struct dc_cal_state *state)
@@ -2939,9 +2985,7 @@ static int dc_cal_module_deinit(struct bladerf *dev,
 
     return status;
 }
-#endif
 
-#ifndef BLADERF_NIOS_BUILD
 static inline int dc_cal_restore(struct bladerf *dev,
                                  bladerf_cal_module module,
                                  struct dc_cal_state *state)
@@ -2978,9 +3022,7 @@ static inline int dc_cal_restore(struct bladerf *dev,
 
     return ret;
 }
-#endif
 
-#ifndef BLADERF_NIOS_BUILD
 static inline int dc_cal_module(struct bladerf *dev,
                                 bladerf_cal_module module,
                                 struct dc_cal_state *state,
@@ -2997,9 +3039,7 @@ static inline int dc_cal_module(struct bladerf *dev,
 
     return status;
 }
-#endif
 
-#ifndef BLADERF_NIOS_BUILD
 int lms_calibrate_dc(struct bladerf *dev, bladerf_cal_module module)
 {
     int status, tmp_status;
@@ -3042,7 +3082,6 @@ error:
 
     return status;
 }
-#endif
 
 #ifndef BLADERF_NIOS_BUILD
 static inline int enable_lpf_cal_clock(struct bladerf *dev, bool enable)
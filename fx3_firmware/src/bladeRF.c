@@ -33,6 +33,7 @@
 #include "pib_regs.h"
 
 #include "flash.h"
+#include "flash_crc32.h"
 #include "spi_flash_lib.h"
 #include "rf.h"
 #include "fpga.h"
@@ -49,7 +50,7 @@ uint8_t glUsbAltInterface = 0;                 /* Active USB interface. */
 
 
 uint8_t glSelBuffer[32];
-uint8_t glPageBuffer[FLASH_PAGE_SIZE] __attribute__ ((aligned (32)));
+uint8_t glPageBuffer[FLASH_BUFFER_PAGES * FLASH_PAGE_SIZE] __attribute__ ((aligned (32)));
 
 CyBool_t glCalCacheValid = CyFalse;
 uint8_t glCal[CAL_BUFFER_SIZE] __attribute__ ((aligned (32)));
@@ -348,6 +349,33 @@ static CyU3PReturnStatus_t NuandReadCalTable(uint8_t *cal_buff) {
     return apiRetStatus;
 }
 
+/* Compute the CRC-32 of `count` flash pages, using the page buffer */
+static CyU3PReturnStatus_t NuandFlashCrc32(uint16_t page, uint16_t count,
+                                           uint32_t *crc)
+{
+    CyU3PReturnStatus_t apiRetStatus = CY_U3P_SUCCESS;
+    uint16_t n;
+
+    *crc = 0;
+
+    while (count != 0) {
+        n = count < FLASH_BUFFER_PAGES ? count : FLASH_BUFFER_PAGES;
+
+        apiRetStatus = CyFxSpiTransfer(page, n * FLASH_PAGE_SIZE,
+                                       glPageBuffer, CyTrue, CyFalse);
+        if (apiRetStatus != CY_U3P_SUCCESS) {
+            break;
+        }
+
+        *crc = flash_crc32(*crc, glPageBuffer, n * FLASH_PAGE_SIZE);
+
+        page += n;
+        count -= n;
+    }
+
+    return apiRetStatus;
+}
+
 static CyU3PReturnStatus_t NuandReadAutoLoad(uint8_t *cal_buff) {
     CyU3PReturnStatus_t apiRetStatus;
     apiRetStatus = CyFxSpiTransfer(AUTOLOAD_PAGE, AUTOLOAD_BUFFER_SIZE, cal_buff, CyTrue, CyFalse);
@@ -481,6 +509,32 @@ CyBool_t NuandHandleVendorRequest(
     }
     break;
 
+    case BLADE_USB_CMD_SET_RF_DMA_BUFFERS:
+    {
+        uint16_t in_use = 0;
+
+        if (!NuandRFLinkSetDmaBuffers(wValue, &in_use)) {
+            apiRetStatus = CyU3PUsbStall(0x80, CyTrue, CyFalse);
+            break;
+        }
+
+        CyU3PUsbSendRetCode(in_use);
+    }
+    break;
+
+    case BLADE_USB_CMD_SET_RF_DMA_CHANNEL:
+    {
+        uint16_t in_use = 0;
+
+        if (!NuandRFLinkSetDmaChannel(wIndex, wValue, &in_use)) {
+            apiRetStatus = CyU3PUsbStall(0x80, CyTrue, CyFalse);
+            break;
+        }
+
+        CyU3PUsbSendRetCode(in_use);
+    }
+    break;
+
     case BLADE_USB_CMD_READ_PAGE_BUFFER:
         if(wIndex + wLength > sizeof(glPageBuffer)) {
             apiRetStatus = CyU3PUsbStall(0x80, CyTrue, CyFalse);
@@ -557,6 +611,54 @@ CyBool_t NuandHandleVendorRequest(
         CyU3PUsbSendRetCode(apiRetStatus);
     break;
 
+    case BLADE_USB_CMD_FLASH_READ_PAGES:
+        if (glUsbAltInterface != USB_IF_SPI_FLASH ||
+            wValue > FLASH_BUFFER_PAGES) {
+            apiRetStatus = CyU3PUsbStall(0x80, CyTrue, CyFalse);
+            break;
+        }
+
+        apiRetStatus = CyFxSpiTransfer (
+                wIndex, wValue * FLASH_PAGE_SIZE,
+                glPageBuffer, CyTrue, CyFalse);
+        CyU3PUsbSendRetCode(apiRetStatus);
+    break;
+
+    case BLADE_USB_CMD_FLASH_WRITE_PAGES:
+        if (glUsbAltInterface != USB_IF_SPI_FLASH ||
+            wValue > FLASH_BUFFER_PAGES) {
+            apiRetStatus = CyU3PUsbStall(0x80, CyTrue, CyFalse);
+            break;
+        }
+
+        apiRetStatus = CyFxSpiTransfer (
+                wIndex, wValue * FLASH_PAGE_SIZE,
+                glPageBuffer, CyFalse, CyFalse);
+        CyU3PUsbSendRetCode(apiRetStatus);
+    break;
+
+    case BLADE_USB_CMD_FLASH_CRC32:
+    {
+        struct bladerf_fx3_flash_crc crc;
+        uint32_t value = 0;
+
+        if (glUsbAltInterface != USB_IF_SPI_FLASH ||
+            wValue > FLASH_CRC32_MAX_PAGES ||
+            wLength != sizeof(crc)) {
+            apiRetStatus = CyU3PUsbStall(0x80, CyTrue, CyFalse);
+            break;
+        }
+
+        crc.status = NuandFlashCrc32(wIndex, wValue, &value);
+        crc.crc    = value;
+
+        apiRetStatus = CyU3PUsbSendEP0Data(sizeof(crc), (void*)&crc);
+        if (apiRetStatus != CY_U3P_SUCCESS) {
+            LOG_ERROR(apiRetStatus);
+        }
+    }
+    break;
+
     case BLADE_USB_CMD_FLASH_ERASE:
         if (glUsbAltInterface != USB_IF_SPI_FLASH) {
            apiRetStatus = CyU3PUsbStall(0x80, CyTrue, CyFalse);
@@ -641,6 +743,26 @@ CyBool_t NuandHandleVendorRequest(
         CyU3PUsbSendRetCode(logger_read());
     break;
 
+    case BLADE_USB_CMD_READ_LOG_ENTRIES:
+    {
+        static logger_entry entries[LOG_READ_MAX_ENTRIES];
+        const uint16_t count = wLength / sizeof(entries[0]);
+
+        if (count == 0 || count > LOG_READ_MAX_ENTRIES ||
+            wLength != count * sizeof(entries[0])) {
+            apiRetStatus = CyU3PUsbStall(0x80, CyTrue, CyFalse);
+            break;
+        }
+
+        logger_read_entries(entries, count);
+
+        apiRetStatus = CyU3PUsbSendEP0Data(wLength, (void*)entries);
+        if (apiRetStatus != CY_U3P_SUCCESS) {
+            LOG_ERROR(apiRetStatus);
+        }
+    }
+    break;
+
     default:
         isHandled = CyFalse;
     }
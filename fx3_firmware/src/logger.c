@@ -136,6 +136,39 @@ out:
     return e;
 }
 
+int logger_read_entries(logger_entry *entries, uint16_t count)
+{
+    CyU3PReturnStatus_t status;
+    uint16_t i;
+    uint16_t n;
+
+    status = LOCK(log);
+    if (status != CY_U3P_SUCCESS) {
+        for (i = 0; i < count; i++) {
+            entries[i] = (i == 0) ? LOG_ERR : LOG_EOF;
+        }
+
+        return -1;
+    }
+
+    n = (count < log.size) ? count : log.size;
+
+    for (i = 0; i < n; i++) {
+        entries[i] = log.entries[log.remove];
+        log.remove = (log.remove + 1) % LOGGER_NUM_ENTRIES;
+    }
+
+    log.size -= n;
+
+    UNLOCK(log);
+
+    for (; i < count; i++) {
+        entries[i] = LOG_EOF;
+    }
+
+    return n;
+}
+
 
 
 
@@ -264,6 +297,39 @@ static bool remove_log_entries(uint16_t start, uint16_t end,
     return true;
 }
 
+static bool read_log_entries(uint16_t start, uint16_t count,
+                             uint16_t expected_count)
+{
+    logger_entry entries[32];
+    uint16_t i;
+    uint8_t exp_file_id;
+    uint16_t exp_line;
+    uint16_t exp_data;
+    int n;
+
+    n = logger_read_entries(entries, count);
+    if (n != expected_count) {
+        fprintf(stderr, "Read %d entries, expected %u\n", n, expected_count);
+        return false;
+    }
+
+    for (i = 0; i < count; i++) {
+        logger_entry exp = LOG_EOF;
+
+        if (i < expected_count) {
+            gen_test_values(&exp_file_id, &exp_line, &exp_data, start + i);
+            exp = logger_entry_pack(exp_file_id, exp_line, exp_data);
+        }
+
+        if (entries[i] != exp) {
+            fprintf(stderr, "Mismatch @ %u. Expected 0x%08x, got 0x%08x\n",
+                    start + i, exp, entries[i]);
+            return false;
+        }
+    }
+
+    return true;
+}
 
 static void print_status(const char *str, bool pass, int *retval) {
     const char *result_str = pass ? "Pass\n" : "Fail\n";
@@ -321,6 +387,18 @@ int main(void)
     status = remove_log_entries(21, 22, 21, NO_MISMATCH_EXPECTED);
     print_status("Got expected EOF", status, &retval);
 
+    status = add_log_entries(0, 20, NO_FAILURE_EXPECTED);
+    print_status("Add entries 0-19", status, &retval);
+
+    status = read_log_entries(0, 16, 16);
+    print_status("Read entries 0-15 at once", status, &retval);
+
+    status = read_log_entries(16, 16, 4);
+    print_status("Read entries 16-19 and EOF padding", status, &retval);
+
+    status = read_log_entries(20, 16, 0);
+    print_status("Read from empty log", status, &retval);
+
     return retval;
 }
 #endif
@@ -95,4 +95,16 @@ bool logger_record(uint8_t file_id, uint16_t line, uint16_t data);
  *         failure occurred while reading the log.
  */
 logger_entry logger_read();
+
+/**
+ * Read and remove up to `count` entries from the log
+ *
+ * @param[out]  entries     Entries read. Those beyond the last entry in the
+ *                          log are set to LOG_EOF.
+ * @param[in]   count       Number of entries to read
+ *
+ * @return number of entries read, or -1 if a failure occurred while reading
+ *         the log.
+ */
+int logger_read_entries(logger_entry *entries, uint16_t count);
 #endif
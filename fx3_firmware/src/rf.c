@@ -37,6 +37,12 @@ static CyU3PDmaChannel glChHandlePtoU;
 static int loopback = 0;
 static int loopback_when_created;
 
+/* DMA buffer counts of the sample channels, indexed by BLADE_RF_DMA_RX/TX */
+static uint16_t dma_buffers[2] = {
+    RF_DMA_BUFFERS_DEFAULT, RF_DMA_BUFFERS_DEFAULT
+};
+static uint16_t dma_buffers_when_created[2];
+
 void NuandRFLinkLoopBack(int lp) {
     loopback = lp;
 }
@@ -45,6 +51,136 @@ int NuandRFLinkGetLoopBack() {
     return loopback;
 }
 
+CyBool_t NuandRFLinkSetDmaBuffers(uint16_t count, uint16_t *in_use) {
+    if (count < RF_DMA_BUFFERS_MIN || count > RF_DMA_BUFFERS_MAX) {
+        return CyFalse;
+    }
+
+    dma_buffers[BLADE_RF_DMA_RX] = count;
+    dma_buffers[BLADE_RF_DMA_TX] = count;
+
+    /* Report 0 if the channels differ, so that the host restarts the RF link
+     * to apply the new count to both of them */
+    if (glAppMode == MODE_RF_CONFIG &&
+        dma_buffers_when_created[BLADE_RF_DMA_RX] ==
+            dma_buffers_when_created[BLADE_RF_DMA_TX]) {
+        *in_use = dma_buffers_when_created[BLADE_RF_DMA_RX];
+    } else {
+        *in_use = 0;
+    }
+
+    return CyTrue;
+}
+
+/* Create the sample DMA channel of one direction, using its current buffer
+ * count. In loopback mode, only the TX channel is created, and it connects
+ * the two USB sockets. */
+static CyU3PReturnStatus_t CreateSampleChannel(uint8_t dir, uint16_t size)
+{
+    CyU3PDmaChannelConfig_t dmaCfg;
+    CyU3PDmaChannel *handle;
+
+    CyU3PMemSet((uint8_t *)&dmaCfg, 0, sizeof(dmaCfg));
+    dmaCfg.size  = size * 2;
+    dmaCfg.count = dma_buffers[dir];
+    dmaCfg.dmaMode = CY_U3P_DMA_MODE_BYTE;
+    dmaCfg.notification = 0;
+    dmaCfg.cb = 0;
+    dmaCfg.prodHeader = 0;
+    dmaCfg.prodFooter = 0;
+    dmaCfg.consHeader = 0;
+    dmaCfg.prodAvailCount = 0;
+
+    if (dir == BLADE_RF_DMA_TX) {
+        handle = &glChHandleUtoP;
+        dmaCfg.prodSckId = BLADE_RF_SAMPLE_EP_PRODUCER_USB_SOCKET;
+        dmaCfg.consSckId = loopback_when_created ?
+                               BLADE_RF_SAMPLE_EP_CONSUMER_USB_SOCKET :
+                               CY_U3P_PIB_SOCKET_3;
+    } else {
+        handle = &glChHandlePtoU;
+        dmaCfg.prodSckId = CY_U3P_PIB_SOCKET_0;
+        dmaCfg.consSckId = BLADE_RF_SAMPLE_EP_CONSUMER_USB_SOCKET;
+    }
+
+    dma_buffers_when_created[dir] = dma_buffers[dir];
+
+    return CyU3PDmaChannelCreate(handle, CY_U3P_DMA_TYPE_AUTO, &dmaCfg);
+}
+
+static uint16_t SampleMaxPacketSize(void)
+{
+    switch (CyU3PUsbGetSpeed()) {
+        case CY_U3P_FULL_SPEED:
+            return 64;
+
+        case CY_U3P_HIGH_SPEED:
+            return 512;
+
+        default:
+            return 1024;
+    }
+}
+
+CyBool_t NuandRFLinkSetDmaChannel(uint16_t dir, uint16_t count,
+                                  uint16_t *in_use)
+{
+    CyU3PDmaChannel *handle;
+    CyU3PReturnStatus_t status;
+    uint8_t ep;
+    uint16_t prev;
+
+    if (count < RF_DMA_BUFFERS_MIN || count > RF_DMA_BUFFERS_MAX ||
+        (dir != BLADE_RF_DMA_RX && dir != BLADE_RF_DMA_TX)) {
+        return CyFalse;
+    }
+
+    dma_buffers[dir] = count;
+    *in_use = 0;
+
+    /* The single loopback channel is left for the next RF link start */
+    if (glAppMode != MODE_RF_CONFIG || loopback_when_created) {
+        return CyTrue;
+    }
+
+    if (dma_buffers_when_created[dir] != count) {
+        if (dir == BLADE_RF_DMA_TX) {
+            handle = &glChHandleUtoP;
+            ep = BLADE_RF_SAMPLE_EP_PRODUCER;
+        } else {
+            handle = &glChHandlePtoU;
+            ep = BLADE_RF_SAMPLE_EP_CONSUMER;
+        }
+
+        /* Only this direction's sockets are touched. The GPIF thread of the
+         * other direction, and the FPGA, keep running. */
+        prev = dma_buffers_when_created[dir];
+        CyU3PDmaChannelDestroy(handle);
+        CyU3PUsbFlushEp(ep);
+
+        status = CreateSampleChannel(dir, SampleMaxPacketSize());
+        if (status != CY_U3P_SUCCESS) {
+            /* Most likely out of buffer memory; fall back to the old count */
+            LOG_ERROR(status);
+            dma_buffers[dir] = prev;
+            status = CreateSampleChannel(dir, SampleMaxPacketSize());
+            if (status != CY_U3P_SUCCESS) {
+                LOG_ERROR(status);
+                CyFxAppErrorHandler(status);
+            }
+        }
+
+        status = CyU3PDmaChannelSetXfer(handle, BLADE_DMA_TX_SIZE);
+        if (status != CY_U3P_SUCCESS) {
+            LOG_ERROR(status);
+            CyFxAppErrorHandler(status);
+        }
+    }
+
+    *in_use = dma_buffers_when_created[dir];
+    return CyTrue;
+}
+
 static void UartBridgeStart(void)
 {
     uint16_t size = 0;
@@ -229,7 +365,6 @@ static void NuandRFLinkStart(void)
 {
     uint16_t size = 0;
     CyU3PEpConfig_t epCfg;
-    CyU3PDmaChannelConfig_t dmaCfg;
     CyU3PReturnStatus_t apiRetStatus = CY_U3P_SUCCESS;
     CyU3PUSBSpeed_t usbSpeed = CyU3PUsbGetSpeed();
 
@@ -271,7 +406,8 @@ static void NuandRFLinkStart(void)
     CyU3PMemSet ((uint8_t *)&epCfg, 0, sizeof (epCfg));
     epCfg.enable = CyTrue;
     epCfg.epType = CY_U3P_USB_EP_BULK;
-    epCfg.burstLen = (usbSpeed == CY_U3P_SUPER_SPEED ? 15 : 1);
+    /* Match the bMaxBurst of 16 packets in the SS companion descriptors */
+    epCfg.burstLen = (usbSpeed == CY_U3P_SUPER_SPEED ? 16 : 1);
     epCfg.streams = 0;
     epCfg.pcktSize = size;
 
@@ -289,37 +425,16 @@ static void NuandRFLinkStart(void)
         CyFxAppErrorHandler (apiRetStatus);
     }
 
-    CyU3PMemSet((uint8_t *)&dmaCfg, 0, sizeof(dmaCfg));
-    dmaCfg.size  = size * 2;
-    dmaCfg.count = 22;
-    dmaCfg.prodSckId = BLADE_RF_SAMPLE_EP_PRODUCER_USB_SOCKET;
-    dmaCfg.consSckId = CY_U3P_PIB_SOCKET_3;
-    dmaCfg.dmaMode = CY_U3P_DMA_MODE_BYTE;
-    dmaCfg.notification = 0;
-    dmaCfg.cb = 0;
-    dmaCfg.prodHeader = 0;
-    dmaCfg.prodFooter = 0;
-    dmaCfg.consHeader = 0;
-    dmaCfg.prodAvailCount = 0;
-
     loopback_when_created = loopback;
 
-    if (loopback) {
-        dmaCfg.prodSckId = BLADE_RF_SAMPLE_EP_PRODUCER_USB_SOCKET;
-        dmaCfg.consSckId = BLADE_RF_SAMPLE_EP_CONSUMER_USB_SOCKET;
-    }
-
-    apiRetStatus = CyU3PDmaChannelCreate(&glChHandleUtoP, CY_U3P_DMA_TYPE_AUTO, &dmaCfg);
-
+    apiRetStatus = CreateSampleChannel(BLADE_RF_DMA_TX, size);
     if (apiRetStatus != CY_U3P_SUCCESS) {
         LOG_ERROR(apiRetStatus);
         CyFxAppErrorHandler(apiRetStatus);
     }
 
     if (!loopback) {
-        dmaCfg.prodSckId = CY_U3P_PIB_SOCKET_0;
-        dmaCfg.consSckId = BLADE_RF_SAMPLE_EP_CONSUMER_USB_SOCKET;
-        apiRetStatus = CyU3PDmaChannelCreate(&glChHandlePtoU, CY_U3P_DMA_TYPE_AUTO, &dmaCfg);
+        apiRetStatus = CreateSampleChannel(BLADE_RF_DMA_RX, size);
         if (apiRetStatus != CY_U3P_SUCCESS) {
             LOG_ERROR(apiRetStatus);
             CyFxAppErrorHandler(apiRetStatus);
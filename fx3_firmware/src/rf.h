@@ -32,4 +32,17 @@ void NuandRFLinkLoopBack(int);
 /* Check if FW sample loopback is enabled */
 int NuandRFLinkGetLoopBack();
 
+/* Set the number of DMA buffers in each sample channel, which is applied when
+ * the RF link is next started. in_use is set to the count of the running
+ * channels, or 0 if the RF link is stopped. Returns CyFalse if the count is
+ * out of range. */
+CyBool_t NuandRFLinkSetDmaBuffers(uint16_t count, uint16_t *in_use);
+
+/* Set the number of DMA buffers in the BLADE_RF_DMA_RX or BLADE_RF_DMA_TX
+ * sample channel. If the RF link is running, that channel alone is rebuilt
+ * with the new count. in_use is set to the count of the running channel, or 0
+ * if it is not running. Returns CyFalse if an argument is out of range. */
+CyBool_t NuandRFLinkSetDmaChannel(uint16_t dir, uint16_t count,
+                                  uint16_t *in_use);
+
 #endif /* _RF_H_ */
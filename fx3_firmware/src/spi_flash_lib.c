@@ -125,6 +125,7 @@ CyU3PReturnStatus_t CyFxSpiTransfer(uint16_t pageAddress, uint16_t byteCount,
     uint8_t location[5];
     uint32_t byteAddress = 0;
     uint16_t pageCount = (byteCount / FLASH_PAGE_SIZE);
+    uint16_t xferCount;
     CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
 
     if (byteCount == 0) {
@@ -166,7 +167,11 @@ CyU3PReturnStatus_t CyFxSpiTransfer(uint16_t pageAddress, uint16_t byteCount,
                 return status;
             }
 
-            status = CyU3PSpiReceiveWords(buffer, FLASH_PAGE_SIZE);
+            /* Reads of the main array continue across page boundaries, so
+             * all of the pages are read with a single command */
+            xferCount = isOtp ? 1 : pageCount;
+
+            status = CyU3PSpiReceiveWords(buffer, xferCount * FLASH_PAGE_SIZE);
             if (status != CY_U3P_SUCCESS) {
                 CyU3PSpiSetSsnLine(CyTrue);
                 return status;
@@ -193,6 +198,11 @@ CyU3PReturnStatus_t CyFxSpiTransfer(uint16_t pageAddress, uint16_t byteCount,
                 return status;
             }
 
+            /* Completion of the page program is awaited by the next
+             * command's CyFxSpiWaitForStatus(), so the last page of a
+             * request is programmed while the host sends the next one. */
+            xferCount = 1;
+
             status = CyU3PSpiTransmitWords(buffer, FLASH_PAGE_SIZE);
             if (status != CY_U3P_SUCCESS) {
                 CyU3PSpiSetSsnLine(CyTrue);
@@ -202,9 +212,9 @@ CyU3PReturnStatus_t CyFxSpiTransfer(uint16_t pageAddress, uint16_t byteCount,
             CyU3PSpiSetSsnLine(CyTrue);
         }
 
-        byteAddress += FLASH_PAGE_SIZE;
-        buffer += FLASH_PAGE_SIZE;
-        pageCount--;
+        byteAddress += xferCount * FLASH_PAGE_SIZE;
+        buffer += xferCount * FLASH_PAGE_SIZE;
+        pageCount -= xferCount;
     }
 
     return CY_U3P_SUCCESS;
@@ -84,9 +84,15 @@ architecture arch of command_uart is
         std_logic_vector(to_unsigned(character'pos('D'),8)),    -- 8x64
         std_logic_vector(to_unsigned(character'pos('E'),8)),    -- 16x64
         std_logic_vector(to_unsigned(character'pos('K'),8)),    -- 32x32
+        std_logic_vector(to_unsigned(character'pos('L'),8)),    -- LMS DC calibration
         std_logic_vector(to_unsigned(character'pos('N'),8)),    -- Legacy
+        std_logic_vector(to_unsigned(character'pos('Q'),8)),    -- Retune queue
+        std_logic_vector(to_unsigned(character'pos('R'),8)),    -- RFIC batch
+        std_logic_vector(to_unsigned(character'pos('S'),8)),    -- AD9361 batch
         std_logic_vector(to_unsigned(character'pos('T'),8)),    -- Retune
-        std_logic_vector(to_unsigned(character'pos('U'),8))     -- Retune2
+        std_logic_vector(to_unsigned(character'pos('U'),8)),    -- Retune2
+        std_logic_vector(to_unsigned(character'pos('V'),8)),    -- VCTCXO tamer
+        std_logic_vector(to_unsigned(character'pos('W'),8))     -- Timed write
     ) ;
 
     signal command_in : std_logic ;
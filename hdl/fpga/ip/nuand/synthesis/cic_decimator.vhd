@@ -0,0 +1,155 @@
+-- Copyright (c) 2026 Nuand LLC
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+
+library ieee;
+    use ieee.std_logic_1164.all;
+    use ieee.numeric_std.all;
+
+-- Cascaded integrator-comb decimator
+--
+-- Decimates by 2**log2_rate with STAGES integrator and comb sections and a
+-- differential delay of one. The integrators run on every in_valid and the
+-- combs run once per output sample. Since the rate is a power of two, the
+-- CIC gain of rate**STAGES is removed exactly by shifting the comb output.
+--
+-- A log2_rate of 0 passes the input straight through. Changing log2_rate
+-- clears the filter state so a stale rate does not leak into the new one.
+entity cic_decimator is
+    generic (
+        DATA_WIDTH      : positive := 16;
+        STAGES          : positive := 4;
+        MAX_LOG2_RATE   : natural  := 6
+    );
+    port (
+        clock           : in    std_logic;
+        reset           : in    std_logic;
+
+        log2_rate       : in    natural range 0 to MAX_LOG2_RATE;
+
+        in_sample       : in    signed(DATA_WIDTH-1 downto 0);
+        in_valid        : in    std_logic;
+
+        out_sample      : out   signed(DATA_WIDTH-1 downto 0);
+        out_valid       : out   std_logic
+    );
+end entity;
+
+architecture arch of cic_decimator is
+
+    -- Worst case bit growth is STAGES*log2(R)
+    constant ACCUM_WIDTH : positive := DATA_WIDTH + STAGES*MAX_LOG2_RATE;
+
+    type accum_t is array(natural range <>) of signed(ACCUM_WIDTH-1 downto 0);
+
+    signal integrators  : accum_t(0 to STAGES-1) := (others => (others => '0'));
+    signal comb_in      : signed(ACCUM_WIDTH-1 downto 0) := (others => '0');
+    signal comb_in_v    : std_logic := '0';
+    signal comb_data    : accum_t(0 to STAGES-1) := (others => (others => '0'));
+    signal comb_delays  : accum_t(0 to STAGES-1) := (others => (others => '0'));
+    signal comb_valid   : std_logic_vector(0 to STAGES-1) := (others => '0');
+
+    signal count        : unsigned(MAX_LOG2_RATE-1 downto 0) := (others => '0');
+    signal last_rate    : natural range 0 to MAX_LOG2_RATE := 0;
+
+begin
+
+    integrate : process(clock, reset)
+    begin
+        if( reset = '1' ) then
+            integrators   <= (others => (others => '0'));
+            comb_in       <= (others => '0');
+            comb_in_v     <= '0';
+            count         <= (others => '0');
+            last_rate     <= 0;
+        elsif( rising_edge(clock) ) then
+            comb_in_v     <= '0';
+            last_rate     <= log2_rate;
+
+            if( log2_rate /= last_rate ) then
+                integrators <= (others => (others => '0'));
+                count       <= (others => '0');
+            elsif( in_valid = '1' ) then
+                integrators(0) <= integrators(0) + resize(in_sample, ACCUM_WIDTH);
+                for i in 1 to STAGES-1 loop
+                    integrators(i) <= integrators(i) + integrators(i-1);
+                end loop;
+
+                -- Hand every 2**log2_rate'th integrator output to the combs
+                if( count = 2**log2_rate - 1 ) then
+                    count         <= (others => '0');
+                    comb_in       <= integrators(STAGES-1);
+                    comb_in_v     <= '1';
+                else
+                    count         <= count + 1;
+                end if;
+            end if;
+        end if;
+    end process;
+
+    comb : process(clock, reset)
+        variable x   : signed(ACCUM_WIDTH-1 downto 0);
+        variable x_v : std_logic;
+    begin
+        if( reset = '1' ) then
+            comb_data   <= (others => (others => '0'));
+            comb_delays <= (others => (others => '0'));
+            comb_valid  <= (others => '0');
+        elsif( rising_edge(clock) ) then
+            if( log2_rate /= last_rate ) then
+                comb_delays <= (others => (others => '0'));
+                comb_valid  <= (others => '0');
+            else
+                -- One registered comb section per stage
+                for i in 0 to STAGES-1 loop
+                    if( i = 0 ) then
+                        x   := comb_in;
+                        x_v := comb_in_v;
+                    else
+                        x   := comb_data(i-1);
+                        x_v := comb_valid(i-1);
+                    end if;
+
+                    comb_valid(i) <= x_v;
+                    if( x_v = '1' ) then
+                        comb_data(i)   <= x - comb_delays(i);
+                        comb_delays(i) <= x;
+                    end if;
+                end loop;
+            end if;
+        end if;
+    end process;
+
+    drive_output : process(clock, reset)
+    begin
+        if( reset = '1' ) then
+            out_sample <= (others => '0');
+            out_valid  <= '0';
+        elsif( rising_edge(clock) ) then
+            if( log2_rate = 0 ) then
+                out_sample <= in_sample;
+                out_valid  <= in_valid;
+            else
+                out_sample <= resize(shift_right(comb_data(STAGES-1), STAGES*log2_rate), DATA_WIDTH);
+                out_valid  <= comb_valid(STAGES-1);
+            end if;
+        end if;
+    end process;
+
+end architecture;
@@ -43,6 +43,7 @@ entity fifo_reader is
         meta_en             :   in      std_logic;
         packet_en           :   in      std_logic;
         eight_bit_mode_en   :   in      std_logic;
+        packed_en           :   in      std_logic := '0';
         timestamp           :   in      unsigned(63 downto 0);
 
         fifo_usedw          :   in      std_logic_vector(FIFO_USEDW_WIDTH-1 downto 0);
@@ -65,6 +66,7 @@ entity fifo_reader is
 
         underflow_led       :   buffer  std_logic;
         underflow_count     :   buffer  unsigned(63 downto 0);
+        underflow_time      :   buffer  unsigned(63 downto 0);
         underflow_duration  :   in      unsigned(15 downto 0)
   );
 end entity;
@@ -75,6 +77,9 @@ architecture simple of fifo_reader is
     constant DMA_BUF_SIZE_HS    : natural   := 256;
 
     signal   dma_buf_size       : natural range DMA_BUF_SIZE_HS to DMA_BUF_SIZE_SS := DMA_BUF_SIZE_SS;
+
+    -- Samples per meta message, in 32-bit units after any unpacking
+    signal   msg_size           : natural range 0 to 2*DMA_BUF_SIZE_SS := DMA_BUF_SIZE_SS - 4;
     signal   underflow_detected : std_logic := '0';
 
     type meta_state_t is (
@@ -85,7 +90,7 @@ architecture simple of fifo_reader is
 
     type meta_fsm_t is record
         state           : meta_state_t;
-        dma_downcount   : natural range 0 to DMA_BUF_SIZE_SS;
+        dma_downcount   : natural range 0 to 2*DMA_BUF_SIZE_SS;
         meta_pkt_sop    : std_logic;
         meta_pkt_eop    : std_logic;
         skip_padding    : std_logic;
@@ -184,6 +189,21 @@ begin
         end if;
     end process;
 
+    -- With 12-bit packing, a message holds as many whole groups of eight
+    -- packed samples (six 32-bit words) as fit after the meta header
+    calc_msg_size : process( clock, reset )
+    begin
+        if( reset = '1' ) then
+            msg_size <= DMA_BUF_SIZE_SS - 4;
+        elsif( rising_edge(clock) ) then
+            if( packed_en = '1' ) then
+                msg_size <= ((dma_buf_size - 4) / 6) * 8;
+            else
+                msg_size <= dma_buf_size - 4;
+            end if;
+        end if;
+    end process;
+
 
     -- ------------------------------------------------------------------------
     -- META FIFO FSM
@@ -248,7 +268,7 @@ begin
                 if( packet_en = '1' ) then
                    meta_future.dma_downcount <= to_integer(unsigned(meta_current.meta_cache(15 downto 0)));
                 else
-                   meta_future.dma_downcount <= dma_buf_size - 4;
+                   meta_future.dma_downcount <= msg_size;
                 end if;
 
                 if( (timestamp >= meta_current.meta_p_time or meta_current.meta_p_time + 1 = 0)
@@ -648,15 +668,18 @@ begin
     -- meaning we have an underflow condition, a non-underflow condition, then
     -- another underflow condition counts as 2 underflows, but an underflow condition
     -- followed by N underflow conditions counts as a single underflow condition.
+    -- The timestamp at the start of the latest one is kept alongside.
     count_underflows : process( clock, reset )
         variable prev_underflow : std_logic := '0';
     begin
         if( reset = '1' ) then
             prev_underflow  := '0';
             underflow_count <= (others =>'0');
+            underflow_time  <= (others =>'0');
         elsif( rising_edge( clock ) ) then
             if( prev_underflow = '0' and underflow_detected = '1' ) then
                 underflow_count <= underflow_count + 1;
+                underflow_time  <= timestamp;
             end if;
             prev_underflow := underflow_detected;
         end if;
@@ -42,6 +42,10 @@ entity fifo_writer is
         meta_en             :   in      std_logic;
         packet_en           :   in      std_logic;
         eight_bit_mode_en   :   in      std_logic := '0';
+        packed_en           :   in      std_logic := '0';
+
+        -- Meta messages span 2**meta_msg_log2 DMA buffers
+        meta_msg_log2       :   in      unsigned(1 downto 0) := "00";
         timestamp           :   in      unsigned(63 downto 0);
         mini_exp            :   in      std_logic_vector(1 downto 0);
 
@@ -64,6 +68,7 @@ entity fifo_writer is
 
         overflow_led        :   buffer  std_logic;
         overflow_count      :   buffer  unsigned(63 downto 0);
+        overflow_time       :   buffer  unsigned(63 downto 0);
         overflow_duration   :   in      unsigned(15 downto 0)
     );
 end entity;
@@ -75,6 +80,12 @@ architecture simple of fifo_writer is
 
     signal dma_buf_size        : natural range DMA_BUF_SIZE_HS to DMA_BUF_SIZE_SS := DMA_BUF_SIZE_SS;
 
+    -- Samples per meta message, in 32-bit units ahead of any packing
+    signal msg_size            : natural range 0 to 16*DMA_BUF_SIZE_SS := DMA_BUF_SIZE_SS - 4;
+
+    -- Size of a meta message, header included, in 32-bit words
+    signal msg_words           : natural range DMA_BUF_SIZE_HS to 8*DMA_BUF_SIZE_SS := DMA_BUF_SIZE_SS;
+
     signal fifo_enough         : boolean   := false;
     signal overflow_detected   : std_logic := '0';
 
@@ -164,6 +175,36 @@ begin
         end if;
     end process;
 
+    -- Messages longer than a DMA buffer only carry a meta header in their
+    -- first buffer. Packets always fit within one buffer.
+    calc_msg_words : process( clock, reset )
+    begin
+        if( reset = '1' ) then
+            msg_words <= DMA_BUF_SIZE_SS;
+        elsif( rising_edge(clock) ) then
+            if( packet_en = '1' ) then
+                msg_words <= dma_buf_size;
+            else
+                msg_words <= dma_buf_size * 2**to_integer(meta_msg_log2);
+            end if;
+        end if;
+    end process;
+
+    -- With 12-bit packing, a message holds as many whole groups of eight
+    -- packed samples (six 32-bit words) as fit after the meta header
+    calc_msg_size : process( clock, reset )
+    begin
+        if( reset = '1' ) then
+            msg_size <= DMA_BUF_SIZE_SS - 4;
+        elsif( rising_edge(clock) ) then
+            if( packed_en = '1' ) then
+                msg_size <= ((msg_words - 4) / 6) * 8;
+            else
+                msg_size <= msg_words - 4;
+            end if;
+        end if;
+    end process;
+
     -- Calculate whether there's enough room in the destination FIFO
     calc_fifo_free : process( clock, reset )
         constant FIFO_MAX    : natural := 2**fifo_usedw'length;
@@ -251,7 +292,7 @@ begin
         case meta_current.state is
             when IDLE =>
 
-                meta_future.dma_downcount <= dma_buf_size - 4;
+                meta_future.dma_downcount <= msg_size;
 
                 if( fifo_enough ) then
                     if( packet_en = '1' ) then
@@ -637,15 +678,18 @@ begin
     -- meaning we have an overflow condition, a non-overflow condition, then
     -- another overflow condition counts as 2 overflows, but an overflow condition
     -- followed by N overflow conditions counts as a single overflow condition.
+    -- The timestamp at the start of the latest one is kept alongside.
     count_overflows : process( clock, reset )
         variable prev_overflow : std_logic := '0';
     begin
         if( reset = '1' ) then
             prev_overflow  := '0';
             overflow_count <= (others =>'0');
+            overflow_time  <= (others =>'0');
         elsif( rising_edge( clock ) ) then
             if( prev_overflow = '0' and overflow_detected = '1' ) then
                 overflow_count <= overflow_count + 1;
+                overflow_time  <= timestamp;
             end if;
             prev_overflow := overflow_detected;
         end if;
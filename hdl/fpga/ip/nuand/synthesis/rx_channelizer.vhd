@@ -0,0 +1,217 @@
+-- Copyright (c) 2026 Nuand LLC
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+
+library ieee;
+    use ieee.std_logic_1164.all;
+    use ieee.numeric_std.all;
+
+library work;
+    use work.fifo_readwrite_p.all;
+    use work.nco_p.all;
+    use work.constellation_mapper_p.all;
+
+-- RX channelizer
+--
+-- Mixes a sample stream down by the NCO frequency, then decimates it by
+-- 2**log2_rate using a CIC followed by a short droop compensation FIR.
+--
+-- nco_dphase is the per-sample phase step of the NCO, where 8192 is one full
+-- cycle. The signal at +nco_dphase/8192 of the input sample rate ends up at
+-- DC. With nco_dphase = 0 and log2_rate = 0 the stream passes through
+-- untouched, two clocks late.
+entity rx_channelizer is
+    generic (
+        STAGES          : positive := 4;
+        MAX_LOG2_RATE   : natural  := 6
+    );
+    port (
+        clock           : in    std_logic;
+        reset           : in    std_logic;
+
+        log2_rate       : in    natural range 0 to MAX_LOG2_RATE;
+        nco_dphase      : in    signed(15 downto 0);
+
+        in_sample       : in    sample_stream_t;
+        out_sample      : out   sample_stream_t
+    );
+end entity;
+
+architecture arch of rx_channelizer is
+
+    -- The NCO output amplitude is ~2032, so drop 11 bits after mixing
+    constant NCO_SHIFT      : natural := 11;
+
+    -- 3-tap inverse-sinc compensation for the CIC passband droop
+    constant COMP_TAPS      : real_array_t := (-0.25, 1.5, -0.25);
+
+    signal nco_in           : nco_input_t;
+    signal nco_out          : nco_output_t;
+    signal lo_re            : signed(15 downto 0) := (others => '0');
+    signal lo_im            : signed(15 downto 0) := (others => '0');
+
+    signal mixed            : sample_stream_t := ZERO_SAMPLE;
+
+    signal cic_i            : signed(15 downto 0);
+    signal cic_q            : signed(15 downto 0);
+    signal cic_v            : std_logic;
+
+    signal comp_i           : signed(15 downto 0);
+    signal comp_q           : signed(15 downto 0);
+    signal comp_v           : std_logic;
+
+begin
+
+    nco_in.dphase <= nco_dphase;
+    nco_in.valid  <= in_sample.data_v;
+
+    U_nco : entity work.nco
+        port map (
+            clock       =>  clock,
+            reset       =>  reset,
+            inputs      =>  nco_in,
+            outputs     =>  nco_out
+        );
+
+    -- The CORDIC pipeline delays the LO by a fixed number of samples, which
+    -- only amounts to a constant phase offset on the mixed output.
+    latch_lo : process(clock, reset)
+    begin
+        if( reset = '1' ) then
+            lo_re <= (others => '0');
+            lo_im <= (others => '0');
+        elsif( rising_edge(clock) ) then
+            if( nco_out.valid = '1' ) then
+                lo_re <= nco_out.re;
+                lo_im <= nco_out.im;
+            end if;
+        end if;
+    end process;
+
+    -- (i + jq) * conj(lo)
+    mix : process(clock, reset)
+        variable re : signed(32 downto 0);
+        variable im : signed(32 downto 0);
+    begin
+        if( reset = '1' ) then
+            mixed <= ZERO_SAMPLE;
+        elsif( rising_edge(clock) ) then
+            mixed.data_v <= in_sample.data_v;
+            if( in_sample.data_v = '1' ) then
+                if( nco_dphase = 0 ) then
+                    mixed.data_i <= in_sample.data_i;
+                    mixed.data_q <= in_sample.data_q;
+                else
+                    re := resize(in_sample.data_i * lo_re, re'length) +
+                          resize(in_sample.data_q * lo_im, re'length);
+                    im := resize(in_sample.data_q * lo_re, im'length) -
+                          resize(in_sample.data_i * lo_im, im'length);
+                    mixed.data_i <= resize(shift_right(re, NCO_SHIFT), mixed.data_i'length);
+                    mixed.data_q <= resize(shift_right(im, NCO_SHIFT), mixed.data_q'length);
+                end if;
+            end if;
+        end if;
+    end process;
+
+    U_cic_i : entity work.cic_decimator
+        generic map (
+            DATA_WIDTH      =>  16,
+            STAGES          =>  STAGES,
+            MAX_LOG2_RATE   =>  MAX_LOG2_RATE
+        )
+        port map (
+            clock           =>  clock,
+            reset           =>  reset,
+            log2_rate       =>  log2_rate,
+            in_sample       =>  mixed.data_i,
+            in_valid        =>  mixed.data_v,
+            out_sample      =>  cic_i,
+            out_valid       =>  cic_v
+        );
+
+    U_cic_q : entity work.cic_decimator
+        generic map (
+            DATA_WIDTH      =>  16,
+            STAGES          =>  STAGES,
+            MAX_LOG2_RATE   =>  MAX_LOG2_RATE
+        )
+        port map (
+            clock           =>  clock,
+            reset           =>  reset,
+            log2_rate       =>  log2_rate,
+            in_sample       =>  mixed.data_q,
+            in_valid        =>  mixed.data_v,
+            out_sample      =>  cic_q,
+            out_valid       =>  open
+        );
+
+    U_comp_i : entity work.fir_filter(systolic)
+        generic map (
+            INPUT_WIDTH     =>  16,
+            OUTPUT_WIDTH    =>  16,
+            CPS             =>  1,
+            Q               =>  12,
+            H               =>  COMP_TAPS,
+            ACCUM_SCALE     =>  32,
+            OUTPUT_SHIFT    =>  12
+        )
+        port map (
+            clock           =>  clock,
+            reset           =>  reset,
+            in_sample       =>  cic_i,
+            in_valid        =>  cic_v,
+            out_sample      =>  comp_i,
+            out_valid       =>  comp_v
+        );
+
+    U_comp_q : entity work.fir_filter(systolic)
+        generic map (
+            INPUT_WIDTH     =>  16,
+            OUTPUT_WIDTH    =>  16,
+            CPS             =>  1,
+            Q               =>  12,
+            H               =>  COMP_TAPS,
+            ACCUM_SCALE     =>  32,
+            OUTPUT_SHIFT    =>  12
+        )
+        port map (
+            clock           =>  clock,
+            reset           =>  reset,
+            in_sample       =>  cic_q,
+            in_valid        =>  cic_v,
+            out_sample      =>  comp_q,
+            out_valid       =>  open
+        );
+
+    drive_output : process(clock, reset)
+    begin
+        if( reset = '1' ) then
+            out_sample <= ZERO_SAMPLE;
+        elsif( rising_edge(clock) ) then
+            if( log2_rate = 0 ) then
+                out_sample <= mixed;
+            else
+                out_sample.data_i <= comp_i;
+                out_sample.data_q <= comp_q;
+                out_sample.data_v <= comp_v;
+            end if;
+        end if;
+    end process;
+
+end architecture;
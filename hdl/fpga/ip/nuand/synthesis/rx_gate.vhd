@@ -0,0 +1,234 @@
+-- Copyright (c) 2026 Nuand LLC
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+
+library ieee;
+    use ieee.std_logic_1164.all;
+    use ieee.numeric_std.all;
+
+library work;
+    use work.fifo_readwrite_p.all;
+
+-- RX gate
+--
+-- Holds back RX samples until the RX timestamp reaches a programmed start
+-- time, then passes a programmed number of samples and blocks the rest, so
+-- the host is not sent samples that it would only discard. With a period,
+-- it then reopens every period samples after the start, capturing a burst
+-- each time. Until it is first armed, and after it is cancelled, it passes
+-- every sample.
+--
+-- The Wishbone slave is clocked by the RX clock. Word addresses, ignoring
+-- the bits above 2 which the interconnect decodes:
+--
+--   0x0  Control  W: [0] arm, [1] cancel
+--                 R: [0] waiting, [1] open, [2] done, [3] opened late
+--   0x1  Start    Timestamp to open at, bits 31:0
+--   0x2           bits 63:32
+--   0x3  Count    Samples to pass once open, or 0 to pass until cancelled
+--   0x4  Period   Samples from the start of one burst to the next, or 0 for
+--                 a single burst
+--
+-- Start, count and period are latched when the gate is armed. A gate armed
+-- after its start time opens at once and reports that it opened late, as
+-- does a burst that is still open when the next one is due. The count is in
+-- sample times, so each enabled stream gets that many samples.
+entity rx_gate is
+    generic (
+        NUM_STREAMS         : natural := 2
+    );
+    port (
+        clock               : in    std_logic;
+        reset               : in    std_logic;
+
+        -- Wishbone slave
+        wb_adr_i            : in    std_logic_vector(31 downto 0) := (others => '0');
+        wb_dat_i            : in    std_logic_vector(31 downto 0) := (others => '0');
+        wb_dat_o            : out   std_logic_vector(31 downto 0) := (others => '0');
+        wb_we_i             : in    std_logic := '0';
+        wb_cyc_i            : in    std_logic := '0';
+        wb_ack_o            : out   std_logic := '0';
+
+        timestamp           : in    unsigned(63 downto 0);
+
+        in_samples          : in    sample_streams_t(0 to NUM_STREAMS-1) := (others => ZERO_SAMPLE);
+        out_samples         : out   sample_streams_t(0 to NUM_STREAMS-1) := (others => ZERO_SAMPLE)
+    );
+end entity;
+
+architecture arch of rx_gate is
+
+    type state_t is (BYPASS, WAITING, OPEN_GATE, DONE);
+
+    -- Bus registers
+    signal start_reg    : unsigned(63 downto 0) := (others => '0');
+    signal count_reg    : unsigned(31 downto 0) := (others => '0');
+    signal period_reg   : unsigned(31 downto 0) := (others => '0');
+    signal arm          : std_logic := '0';
+    signal cancel       : std_logic := '0';
+
+    -- Gate
+    signal state        : state_t := BYPASS;
+    signal start_time   : unsigned(63 downto 0) := (others => '0');
+    signal remaining    : unsigned(31 downto 0) := (others => '0');
+    signal burst_len    : unsigned(31 downto 0) := (others => '0');
+    signal period       : unsigned(31 downto 0) := (others => '0');
+    signal unlimited    : std_logic := '0';
+    signal late         : std_logic := '0';
+
+begin
+
+    wishbone_slave : process(clock, reset)
+    begin
+        if( reset = '1' ) then
+            wb_ack_o   <= '0';
+            wb_dat_o   <= (others => '0');
+            start_reg  <= (others => '0');
+            count_reg  <= (others => '0');
+            period_reg <= (others => '0');
+            arm        <= '0';
+            cancel     <= '0';
+        elsif( rising_edge(clock) ) then
+            wb_ack_o <= wb_cyc_i;
+            wb_dat_o <= (others => '0');
+            arm      <= '0';
+            cancel   <= '0';
+
+            if( wb_cyc_i = '1' ) then
+                case to_integer(unsigned(wb_adr_i(2 downto 0))) is
+                    when 0 =>
+                        if( wb_we_i = '1' ) then
+                            arm    <= wb_dat_i(0);
+                            cancel <= wb_dat_i(1);
+                        end if;
+                        if( state = WAITING ) then
+                            wb_dat_o(0) <= '1';
+                        end if;
+                        if( state = OPEN_GATE ) then
+                            wb_dat_o(1) <= '1';
+                        end if;
+                        if( state = DONE ) then
+                            wb_dat_o(2) <= '1';
+                        end if;
+                        wb_dat_o(3) <= late;
+                    when 1 =>
+                        if( wb_we_i = '1' ) then
+                            start_reg(31 downto 0) <= unsigned(wb_dat_i);
+                        end if;
+                        wb_dat_o <= std_logic_vector(start_reg(31 downto 0));
+                    when 2 =>
+                        if( wb_we_i = '1' ) then
+                            start_reg(63 downto 32) <= unsigned(wb_dat_i);
+                        end if;
+                        wb_dat_o <= std_logic_vector(start_reg(63 downto 32));
+                    when 3 =>
+                        if( wb_we_i = '1' ) then
+                            count_reg <= unsigned(wb_dat_i);
+                        end if;
+                        wb_dat_o <= std_logic_vector(count_reg);
+                    when 4 =>
+                        if( wb_we_i = '1' ) then
+                            period_reg <= unsigned(wb_dat_i);
+                        end if;
+                        wb_dat_o <= std_logic_vector(period_reg);
+                    when others =>
+                        null;
+                end case;
+            end if;
+        end if;
+    end process;
+
+    gate : process(clock, reset)
+        variable pass  : boolean;
+        variable valid : boolean;
+    begin
+        if( reset = '1' ) then
+            state       <= BYPASS;
+            start_time  <= (others => '0');
+            remaining   <= (others => '0');
+            burst_len   <= (others => '0');
+            period      <= (others => '0');
+            unlimited   <= '0';
+            late        <= '0';
+            out_samples <= (others => ZERO_SAMPLE);
+        elsif( rising_edge(clock) ) then
+            valid := false;
+            for i in in_samples'range loop
+                if( in_samples(i).data_v = '1' ) then
+                    valid := true;
+                end if;
+            end loop;
+
+            pass := false;
+            case state is
+                when BYPASS =>
+                    pass := true;
+
+                when WAITING =>
+                    -- Pass the sample taken at the start time itself, so
+                    -- the first message is stamped with it
+                    if( timestamp >= start_time ) then
+                        state <= OPEN_GATE;
+                        if( timestamp /= start_time ) then
+                            late <= '1';
+                        end if;
+                        pass  := true;
+                    end if;
+
+                when OPEN_GATE =>
+                    pass := true;
+
+                when DONE =>
+                    null;
+            end case;
+
+            if( pass and valid and state /= BYPASS and unlimited = '0' ) then
+                remaining <= remaining - 1;
+                if( remaining = 1 ) then
+                    if( period = 0 ) then
+                        state <= DONE;
+                    else
+                        state      <= WAITING;
+                        start_time <= start_time + period;
+                        remaining  <= burst_len;
+                    end if;
+                end if;
+            end if;
+
+            if( arm = '1' ) then
+                state      <= WAITING;
+                start_time <= start_reg;
+                remaining  <= count_reg;
+                burst_len  <= count_reg;
+                period     <= period_reg;
+                unlimited  <= '1' when count_reg = 0 else '0';
+                late       <= '0';
+                pass       := false;
+            elsif( cancel = '1' ) then
+                state <= BYPASS;
+            end if;
+
+            for i in in_samples'range loop
+                out_samples(i)        <= in_samples(i);
+                out_samples(i).data_v <= in_samples(i).data_v when pass else '0';
+            end loop;
+        end if;
+    end process;
+
+end architecture;
@@ -0,0 +1,345 @@
+-- Copyright (c) 2026 Nuand LLC
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+
+library ieee;
+    use ieee.std_logic_1164.all;
+    use ieee.numeric_std.all;
+
+library work;
+    use work.fifo_readwrite_p.all;
+
+-- RX power meter
+--
+-- Measures one RX stream over a programmable window without sending any
+-- samples to the host: the sum of i**2 + q**2, the sums of i and q for DC
+-- estimates, the sums of i**2, q**2 and i*q for IQ imbalance estimates, and
+-- the peak of |i| and |q|. It can also capture a snapshot of consecutive
+-- samples into block RAM for the host to read back and FFT.
+--
+-- The Wishbone slave is clocked by the RX clock. Word addresses, ignoring
+-- the bits above 12 which the interconnect decodes:
+--
+--   0x000  Control  W: [0] start measurement, [1] arm snapshot, [8] stream
+--                   R: [0] measurement busy, [1] snapshot busy, [8] stream
+--   0x001  Window   Samples per measurement, 1 to 2**24
+--   0x002  Power    sum(i**2 + q**2), bits 31:0
+--   0x003           bits 63:32
+--   0x004  Sum I    sum(i), sign extended, bits 31:0
+--   0x005           bits 63:32
+--   0x006  Sum Q    sum(q), sign extended, bits 31:0
+--   0x007           bits 63:32
+--   0x008  Peak     max(|i|, |q|) over the window
+--   0x009  Sum I^2  sum(i**2), bits 31:0
+--   0x00a           bits 63:32
+--   0x00b  Sum Q^2  sum(q**2), bits 31:0
+--   0x00c           bits 63:32
+--   0x00d  Sum IQ   sum(i*q), sign extended, bits 31:0
+--   0x00e           bits 63:32
+--   0x1000+ Snapshot RAM, 2**SNAP_ADDR_WIDTH samples: [31:16] Q, [15:0] I
+--
+-- Results hold their value until the next measurement completes.
+entity rx_power_meter is
+    generic (
+        NUM_STREAMS         : natural  := 2;
+        SNAP_ADDR_WIDTH     : positive := 10
+    );
+    port (
+        clock               : in    std_logic;
+        reset               : in    std_logic;
+
+        -- Wishbone slave
+        wb_adr_i            : in    std_logic_vector(31 downto 0) := (others => '0');
+        wb_dat_i            : in    std_logic_vector(31 downto 0) := (others => '0');
+        wb_dat_o            : out   std_logic_vector(31 downto 0) := (others => '0');
+        wb_we_i             : in    std_logic := '0';
+        wb_cyc_i            : in    std_logic := '0';
+        wb_ack_o            : out   std_logic := '0';
+
+        -- Samples to measure
+        in_sample_controls  : in    sample_controls_t(0 to NUM_STREAMS-1) := (others => SAMPLE_CONTROL_DISABLE);
+        in_samples          : in    sample_streams_t(0 to NUM_STREAMS-1)  := (others => ZERO_SAMPLE)
+    );
+end entity;
+
+architecture arch of rx_power_meter is
+
+    constant MAX_WINDOW     : natural  := 2**24;
+    constant SNAP_DEPTH     : positive := 2**SNAP_ADDR_WIDTH;
+    constant RAM_SELECT_BIT : natural  := 12;
+
+    -- 16-bit squares summed over 2**24 samples fit in 56 bits; sums in 41
+    constant POWER_WIDTH    : positive := 56;
+    constant SUM_WIDTH      : positive := 48;
+
+    type snap_ram_t is array(0 to SNAP_DEPTH-1) of std_logic_vector(31 downto 0);
+    signal snap_ram         : snap_ram_t;
+    signal snap_q           : std_logic_vector(31 downto 0) := (others => '0');
+
+    -- Bus registers
+    signal stream_sel       : natural range 0 to NUM_STREAMS-1 := 0;
+    signal window           : unsigned(24 downto 0) := to_unsigned(1, 25);
+    signal meas_start       : std_logic := '0';
+    signal snap_arm         : std_logic := '0';
+    signal reg_dat          : std_logic_vector(31 downto 0) := (others => '0');
+    signal ram_rd           : std_logic := '0';
+
+    -- Selected stream, squared
+    signal sample           : sample_stream_t := ZERO_SAMPLE;
+    signal sq_i             : unsigned(31 downto 0) := (others => '0');
+    signal sq_q             : unsigned(31 downto 0) := (others => '0');
+    signal mag_i            : unsigned(15 downto 0) := (others => '0');
+    signal mag_q            : unsigned(15 downto 0) := (others => '0');
+    signal prod_iq          : signed(31 downto 0) := (others => '0');
+    signal sq_i_d           : signed(15 downto 0) := (others => '0');
+    signal sq_q_d           : signed(15 downto 0) := (others => '0');
+    signal sq_v             : std_logic := '0';
+
+    -- Measurement
+    signal meas_busy        : std_logic := '0';
+    signal meas_count       : unsigned(window'range) := (others => '0');
+    signal power_acc        : unsigned(POWER_WIDTH-1 downto 0) := (others => '0');
+    signal sum_i_acc        : signed(SUM_WIDTH-1 downto 0) := (others => '0');
+    signal sum_q_acc        : signed(SUM_WIDTH-1 downto 0) := (others => '0');
+    signal peak_acc         : unsigned(15 downto 0) := (others => '0');
+    signal i2_acc           : unsigned(POWER_WIDTH-1 downto 0) := (others => '0');
+    signal q2_acc           : unsigned(POWER_WIDTH-1 downto 0) := (others => '0');
+    signal iq_acc           : signed(POWER_WIDTH-1 downto 0) := (others => '0');
+    signal power            : unsigned(63 downto 0) := (others => '0');
+    signal sum_i            : signed(63 downto 0) := (others => '0');
+    signal sum_q            : signed(63 downto 0) := (others => '0');
+    signal peak             : unsigned(15 downto 0) := (others => '0');
+    signal sum_i2           : unsigned(63 downto 0) := (others => '0');
+    signal sum_q2           : unsigned(63 downto 0) := (others => '0');
+    signal sum_iq           : signed(63 downto 0) := (others => '0');
+
+    -- Snapshot
+    signal snap_busy        : std_logic := '0';
+    signal snap_we          : std_logic := '0';
+    signal snap_wr_addr     : unsigned(SNAP_ADDR_WIDTH-1 downto 0) := (others => '0');
+    signal snap_wr_data     : std_logic_vector(31 downto 0) := (others => '0');
+
+begin
+
+    wishbone_slave : process(clock, reset)
+        variable addr : unsigned(RAM_SELECT_BIT downto 0);
+    begin
+        if( reset = '1' ) then
+            wb_ack_o   <= '0';
+            reg_dat    <= (others => '0');
+            ram_rd     <= '0';
+            stream_sel <= 0;
+            window     <= to_unsigned(1, window'length);
+            meas_start <= '0';
+            snap_arm   <= '0';
+        elsif( rising_edge(clock) ) then
+            addr       := unsigned(wb_adr_i(addr'range));
+            wb_ack_o   <= wb_cyc_i;
+            reg_dat    <= (others => '0');
+            ram_rd     <= '0';
+            meas_start <= '0';
+            snap_arm   <= '0';
+
+            if( wb_cyc_i = '1' ) then
+                if( addr(RAM_SELECT_BIT) = '1' ) then
+                    -- Snapshot RAM is read-only from the bus
+                    ram_rd <= '1';
+                else
+                    case to_integer(addr) is
+                        when 16#000# =>
+                            if( wb_we_i = '1' ) then
+                                meas_start <= wb_dat_i(0);
+                                snap_arm   <= wb_dat_i(1);
+                                if( to_integer(unsigned(wb_dat_i(8 downto 8))) < NUM_STREAMS ) then
+                                    stream_sel <= to_integer(unsigned(wb_dat_i(8 downto 8)));
+                                end if;
+                            end if;
+                            reg_dat(0) <= meas_busy;
+                            reg_dat(1) <= snap_busy;
+                            reg_dat(8 downto 8) <= std_logic_vector(to_unsigned(stream_sel, 1));
+                        when 16#001# =>
+                            if( wb_we_i = '1' ) then
+                                if( unsigned(wb_dat_i) = 0 ) then
+                                    window <= to_unsigned(1, window'length);
+                                elsif( unsigned(wb_dat_i) > MAX_WINDOW ) then
+                                    window <= to_unsigned(MAX_WINDOW, window'length);
+                                else
+                                    window <= resize(unsigned(wb_dat_i), window'length);
+                                end if;
+                            end if;
+                            reg_dat(window'range) <= std_logic_vector(window);
+                        when 16#002# => reg_dat <= std_logic_vector(power(31 downto 0));
+                        when 16#003# => reg_dat <= std_logic_vector(power(63 downto 32));
+                        when 16#004# => reg_dat <= std_logic_vector(sum_i(31 downto 0));
+                        when 16#005# => reg_dat <= std_logic_vector(sum_i(63 downto 32));
+                        when 16#006# => reg_dat <= std_logic_vector(sum_q(31 downto 0));
+                        when 16#007# => reg_dat <= std_logic_vector(sum_q(63 downto 32));
+                        when 16#008# => reg_dat(peak'range) <= std_logic_vector(peak);
+                        when 16#009# => reg_dat <= std_logic_vector(sum_i2(31 downto 0));
+                        when 16#00a# => reg_dat <= std_logic_vector(sum_i2(63 downto 32));
+                        when 16#00b# => reg_dat <= std_logic_vector(sum_q2(31 downto 0));
+                        when 16#00c# => reg_dat <= std_logic_vector(sum_q2(63 downto 32));
+                        when 16#00d# => reg_dat <= std_logic_vector(sum_iq(31 downto 0));
+                        when 16#00e# => reg_dat <= std_logic_vector(sum_iq(63 downto 32));
+                        when others  => null;
+                    end case;
+                end if;
+            end if;
+        end if;
+    end process;
+
+    wb_dat_o <= snap_q when ram_rd = '1' else reg_dat;
+
+    snapshot_ram : process(clock)
+    begin
+        if( rising_edge(clock) ) then
+            if( snap_we = '1' ) then
+                snap_ram(to_integer(snap_wr_addr)) <= snap_wr_data;
+            end if;
+            snap_q <= snap_ram(to_integer(unsigned(wb_adr_i(SNAP_ADDR_WIDTH-1 downto 0))));
+        end if;
+    end process;
+
+    select_stream : process(clock, reset)
+    begin
+        if( reset = '1' ) then
+            sample <= ZERO_SAMPLE;
+        elsif( rising_edge(clock) ) then
+            sample        <= in_samples(stream_sel);
+            sample.data_v <= in_samples(stream_sel).data_v and in_sample_controls(stream_sel).enable;
+        end if;
+    end process;
+
+    square : process(clock, reset)
+    begin
+        if( reset = '1' ) then
+            sq_i   <= (others => '0');
+            sq_q   <= (others => '0');
+            mag_i  <= (others => '0');
+            mag_q  <= (others => '0');
+            prod_iq <= (others => '0');
+            sq_i_d <= (others => '0');
+            sq_q_d <= (others => '0');
+            sq_v   <= '0';
+        elsif( rising_edge(clock) ) then
+            sq_v <= sample.data_v;
+            if( sample.data_v = '1' ) then
+                sq_i   <= unsigned(sample.data_i * sample.data_i);
+                sq_q   <= unsigned(sample.data_q * sample.data_q);
+                prod_iq <= sample.data_i * sample.data_q;
+                mag_i  <= resize(unsigned(abs(resize(sample.data_i, 17))), 16);
+                mag_q  <= resize(unsigned(abs(resize(sample.data_q, 17))), 16);
+                sq_i_d <= sample.data_i;
+                sq_q_d <= sample.data_q;
+            end if;
+        end if;
+    end process;
+
+    measure : process(clock, reset)
+        variable peak_next : unsigned(15 downto 0);
+    begin
+        if( reset = '1' ) then
+            meas_busy  <= '0';
+            meas_count <= (others => '0');
+            power_acc  <= (others => '0');
+            sum_i_acc  <= (others => '0');
+            sum_q_acc  <= (others => '0');
+            peak_acc   <= (others => '0');
+            i2_acc     <= (others => '0');
+            q2_acc     <= (others => '0');
+            iq_acc     <= (others => '0');
+            power      <= (others => '0');
+            sum_i      <= (others => '0');
+            sum_q      <= (others => '0');
+            peak       <= (others => '0');
+            sum_i2     <= (others => '0');
+            sum_q2     <= (others => '0');
+            sum_iq     <= (others => '0');
+        elsif( rising_edge(clock) ) then
+            if( meas_start = '1' ) then
+                meas_busy  <= '1';
+                meas_count <= (others => '0');
+                power_acc  <= (others => '0');
+                sum_i_acc  <= (others => '0');
+                sum_q_acc  <= (others => '0');
+                peak_acc   <= (others => '0');
+                i2_acc     <= (others => '0');
+                q2_acc     <= (others => '0');
+                iq_acc     <= (others => '0');
+            elsif( meas_busy = '1' and sq_v = '1' ) then
+                peak_next := peak_acc;
+                if( mag_i > peak_next ) then
+                    peak_next := mag_i;
+                end if;
+                if( mag_q > peak_next ) then
+                    peak_next := mag_q;
+                end if;
+
+                power_acc  <= power_acc + sq_i + sq_q;
+                sum_i_acc  <= sum_i_acc + sq_i_d;
+                sum_q_acc  <= sum_q_acc + sq_q_d;
+                peak_acc   <= peak_next;
+                i2_acc     <= i2_acc + sq_i;
+                q2_acc     <= q2_acc + sq_q;
+                iq_acc     <= iq_acc + prod_iq;
+                meas_count <= meas_count + 1;
+
+                if( meas_count = window - 1 ) then
+                    meas_busy <= '0';
+                    power     <= resize(power_acc + sq_i + sq_q, power'length);
+                    sum_i     <= resize(sum_i_acc + sq_i_d, sum_i'length);
+                    sum_q     <= resize(sum_q_acc + sq_q_d, sum_q'length);
+                    peak      <= peak_next;
+                    sum_i2    <= resize(i2_acc + sq_i, sum_i2'length);
+                    sum_q2    <= resize(q2_acc + sq_q, sum_q2'length);
+                    sum_iq    <= resize(iq_acc + prod_iq, sum_iq'length);
+                end if;
+            end if;
+        end if;
+    end process;
+
+    snapshot : process(clock, reset)
+    begin
+        if( reset = '1' ) then
+            snap_busy    <= '0';
+            snap_we      <= '0';
+            snap_wr_addr <= (others => '0');
+            snap_wr_data <= (others => '0');
+        elsif( rising_edge(clock) ) then
+            snap_we <= '0';
+
+            if( snap_we = '1' ) then
+                snap_wr_addr <= snap_wr_addr + 1;
+                if( snap_wr_addr = SNAP_DEPTH-1 ) then
+                    snap_busy <= '0';
+                end if;
+            end if;
+
+            if( snap_arm = '1' ) then
+                snap_busy    <= '1';
+                snap_wr_addr <= (others => '0');
+            elsif( snap_busy = '1' and sample.data_v = '1' and
+                   not (snap_we = '1' and snap_wr_addr = SNAP_DEPTH-1) ) then
+                snap_we      <= '1';
+                snap_wr_data <= std_logic_vector(sample.data_q) & std_logic_vector(sample.data_i);
+            end if;
+        end if;
+    end process;
+
+end architecture;
@@ -0,0 +1,171 @@
+-- Copyright (c) 2026 Nuand LLC
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+
+
+library ieee;
+    use ieee.std_logic_1164.all;
+    use ieee.numeric_std.all;
+
+-- RX 12-bit sample packer
+--
+-- Sits between fifo_writer and the RX sample FIFO. While packed_en is set,
+-- only the 12 significant bits of each I and Q value are kept, and the
+-- resulting 24-bit samples are packed back to back into FIFO words, LSB
+-- first. Every FIFO_DATA_WIDTH*3/4 bits written by fifo_writer therefore
+-- turn into FIFO_DATA_WIDTH*3/4 bits of FIFO data, and the FIFO sees a
+-- write on only three of every four fifo_writer writes.
+--
+-- With meta_en set, fifo_writer fills each message with a whole number of
+-- groups of 8 samples. The rest of the message, after the meta header, is
+-- padded with zero words here so the message keeps its usual size.
+--
+-- While packed_en is clear, data passes through untouched.
+entity rx_sample_packer is
+    generic (
+        FIFO_DATA_WIDTH     : natural := 64
+    );
+    port (
+        clock               : in    std_logic;
+        reset               : in    std_logic;
+        clear               : in    std_logic;
+
+        packed_en           : in    std_logic;
+        meta_en             : in    std_logic;
+        usb_speed           : in    std_logic;
+
+        -- From fifo_writer
+        in_data             : in    std_logic_vector(FIFO_DATA_WIDTH-1 downto 0);
+        in_write            : in    std_logic;
+
+        -- To the sample FIFO
+        out_data            : out   std_logic_vector(FIFO_DATA_WIDTH-1 downto 0);
+        out_write           : out   std_logic
+    );
+end entity;
+
+architecture arch of rx_sample_packer is
+
+    constant DMA_BUF_SIZE_SS    : natural := 512;
+    constant DMA_BUF_SIZE_HS    : natural := 256;
+
+    constant PACKED_WIDTH       : natural := FIFO_DATA_WIDTH*3/4;
+
+    -- Room for one pending output word, one packed input and the padding
+    constant ACC_WIDTH          : natural := 4*FIFO_DATA_WIDTH;
+
+    -- Input words per message and the padding that follows them, in bits
+    signal msg_words            : natural range 0 to DMA_BUF_SIZE_SS;
+    signal pad_bits             : natural range 0 to 2*FIFO_DATA_WIDTH;
+
+    signal acc                  : unsigned(ACC_WIDTH-1 downto 0) := (others => '0');
+    signal fill                 : natural range 0 to ACC_WIDTH := 0;
+    signal word_count           : natural range 0 to DMA_BUF_SIZE_SS := 0;
+
+    signal packed_data          : std_logic_vector(FIFO_DATA_WIDTH-1 downto 0) := (others => '0');
+    signal packed_write         : std_logic := '0';
+
+    -- Keep the 12 LSBs of I (bits 11:0) and Q (bits 27:16) of each 32 bits
+    function pack12( x : std_logic_vector ) return unsigned is
+        variable rv : unsigned(PACKED_WIDTH-1 downto 0);
+    begin
+        for i in 0 to FIFO_DATA_WIDTH/32-1 loop
+            rv(24*i+11 downto 24*i)    := unsigned(x(32*i+11 downto 32*i));
+            rv(24*i+23 downto 24*i+12) := unsigned(x(32*i+27 downto 32*i+16));
+        end loop;
+        return rv;
+    end function;
+
+begin
+
+    -- Each message carries ((dma_buf_size-4)/6)*8 samples of 32 bits ahead of
+    -- packing, matching fifo_writer, and 24 bits after it
+    calc_msg_size : process(clock, reset)
+        variable buf_words : natural range 0 to DMA_BUF_SIZE_SS;
+    begin
+        if( reset = '1' ) then
+            msg_words <= 0;
+            pad_bits  <= 0;
+        elsif( rising_edge(clock) ) then
+            if( usb_speed = '0' ) then
+                buf_words := DMA_BUF_SIZE_SS - 4;
+            else
+                buf_words := DMA_BUF_SIZE_HS - 4;
+            end if;
+
+            msg_words <= ((buf_words / 6) * 8) * 32 / FIFO_DATA_WIDTH;
+            if( meta_en = '1' ) then
+                pad_bits <= (buf_words mod 6) * 32;
+            else
+                pad_bits <= 0;
+            end if;
+        end if;
+    end process;
+
+    pack : process(clock, reset)
+        variable v_acc  : unsigned(ACC_WIDTH-1 downto 0);
+        variable v_fill : natural range 0 to ACC_WIDTH;
+    begin
+        if( reset = '1' ) then
+            acc          <= (others => '0');
+            fill         <= 0;
+            word_count   <= 0;
+            packed_data  <= (others => '0');
+            packed_write <= '0';
+        elsif( rising_edge(clock) ) then
+            v_acc        := acc;
+            v_fill       := fill;
+            packed_write <= '0';
+
+            if( clear = '1' or packed_en = '0' ) then
+                v_acc      := (others => '0');
+                v_fill     := 0;
+                word_count <= 0;
+            else
+                -- Bits above fill are always zero, so shifting the padding
+                -- in only requires advancing fill
+                if( v_fill >= FIFO_DATA_WIDTH ) then
+                    packed_data  <= std_logic_vector(v_acc(FIFO_DATA_WIDTH-1 downto 0));
+                    packed_write <= '1';
+                    v_acc        := shift_right(v_acc, FIFO_DATA_WIDTH);
+                    v_fill       := v_fill - FIFO_DATA_WIDTH;
+                end if;
+
+                if( in_write = '1' ) then
+                    v_acc  := v_acc or shift_left(resize(pack12(in_data), ACC_WIDTH), v_fill);
+                    v_fill := v_fill + PACKED_WIDTH;
+
+                    if( word_count = msg_words - 1 ) then
+                        word_count <= 0;
+                        v_fill     := v_fill + pad_bits;
+                    else
+                        word_count <= word_count + 1;
+                    end if;
+                end if;
+            end if;
+
+            acc  <= v_acc;
+            fill <= v_fill;
+        end if;
+    end process;
+
+    out_data  <= packed_data  when packed_en = '1' else in_data;
+    out_write <= packed_write when packed_en = '1' else in_write;
+
+end architecture;
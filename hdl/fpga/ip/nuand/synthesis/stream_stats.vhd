@@ -0,0 +1,118 @@
+-- Copyright (c) 2026 Nuand LLC
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+
+library ieee;
+    use ieee.std_logic_1164.all;
+    use ieee.numeric_std.all;
+
+-- Stream statistics
+--
+-- Makes the RX FIFO overflow and TX FIFO underflow counts of the sample
+-- bridges readable over Wishbone, each with the timestamp at which the
+-- latest event began, in that direction's own timebase. The counts run from
+-- FPGA reset and are never cleared, so the host works with differences.
+--
+-- The Wishbone slave and all of its inputs are in one clock domain. Word
+-- addresses, ignoring the bits above 2 which the interconnect decodes:
+--
+--   0x0  RX overflows, bits 31:0
+--   0x1                bits 63:32
+--   0x2  RX timestamp of the latest overflow, bits 31:0
+--   0x3                                       bits 63:32
+--   0x4  TX underflows, bits 31:0
+--   0x5                 bits 63:32
+--   0x6  TX timestamp of the latest underflow, bits 31:0
+--   0x7                                        bits 63:32
+--
+-- Reading the low word of a count captures that count and its timestamp,
+-- and the other three words of that direction read back the capture, so
+-- they always agree with each other.
+entity stream_stats is
+    port (
+        clock               : in    std_logic;
+        reset               : in    std_logic;
+
+        -- Wishbone slave
+        wb_adr_i            : in    std_logic_vector(31 downto 0) := (others => '0');
+        wb_dat_i            : in    std_logic_vector(31 downto 0) := (others => '0');
+        wb_dat_o            : out   std_logic_vector(31 downto 0) := (others => '0');
+        wb_we_i             : in    std_logic := '0';
+        wb_cyc_i            : in    std_logic := '0';
+        wb_ack_o            : out   std_logic := '0';
+
+        rx_overflow_count   : in    unsigned(63 downto 0) := (others => '0');
+        rx_overflow_time    : in    unsigned(63 downto 0) := (others => '0');
+        tx_underflow_count  : in    unsigned(63 downto 0) := (others => '0');
+        tx_underflow_time   : in    unsigned(63 downto 0) := (others => '0')
+    );
+end entity;
+
+architecture arch of stream_stats is
+
+    signal rx_count     : unsigned(63 downto 0) := (others => '0');
+    signal rx_time      : unsigned(63 downto 0) := (others => '0');
+    signal tx_count     : unsigned(63 downto 0) := (others => '0');
+    signal tx_time      : unsigned(63 downto 0) := (others => '0');
+
+begin
+
+    wishbone_slave : process(clock, reset)
+    begin
+        if( reset = '1' ) then
+            wb_ack_o <= '0';
+            wb_dat_o <= (others => '0');
+            rx_count <= (others => '0');
+            rx_time  <= (others => '0');
+            tx_count <= (others => '0');
+            tx_time  <= (others => '0');
+        elsif( rising_edge(clock) ) then
+            wb_ack_o <= wb_cyc_i;
+            wb_dat_o <= (others => '0');
+
+            if( wb_cyc_i = '1' and wb_we_i = '0' ) then
+                case to_integer(unsigned(wb_adr_i(2 downto 0))) is
+                    when 0 =>
+                        rx_count <= rx_overflow_count;
+                        rx_time  <= rx_overflow_time;
+                        wb_dat_o <= std_logic_vector(rx_overflow_count(31 downto 0));
+                    when 1 =>
+                        wb_dat_o <= std_logic_vector(rx_count(63 downto 32));
+                    when 2 =>
+                        wb_dat_o <= std_logic_vector(rx_time(31 downto 0));
+                    when 3 =>
+                        wb_dat_o <= std_logic_vector(rx_time(63 downto 32));
+                    when 4 =>
+                        tx_count <= tx_underflow_count;
+                        tx_time  <= tx_underflow_time;
+                        wb_dat_o <= std_logic_vector(tx_underflow_count(31 downto 0));
+                    when 5 =>
+                        wb_dat_o <= std_logic_vector(tx_count(63 downto 32));
+                    when 6 =>
+                        wb_dat_o <= std_logic_vector(tx_time(31 downto 0));
+                    when 7 =>
+                        wb_dat_o <= std_logic_vector(tx_time(63 downto 32));
+                    when others =>
+                        null;
+                end case;
+            end if;
+        end if;
+    end process;
+
+end architecture;
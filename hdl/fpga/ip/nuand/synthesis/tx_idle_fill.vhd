@@ -0,0 +1,98 @@
+-- Copyright (c) 2026 Nuand LLC
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+
+library ieee;
+    use ieee.std_logic_1164.all;
+    use ieee.numeric_std.all;
+
+library work;
+    use work.fifo_readwrite_p.all;
+
+-- TX idle fill
+--
+-- The DAC holds the last sample it was given, so a TX stream that stops,
+-- between timestamped bursts or on an underrun, would carry on transmitting
+-- it. When enabled, this sends the DAC a single zero sample once a stream
+-- has had no sample for IDLE_CLOCKS clocks, well beyond the normal spacing
+-- of samples, so the transmitter goes quiet without the host having to end
+-- every burst with zeros.
+entity tx_idle_fill is
+    generic (
+        NUM_STREAMS         : natural  := 2;
+        IDLE_CLOCKS         : positive := 32
+    );
+    port (
+        clock               : in    std_logic;
+        reset               : in    std_logic;
+        enable              : in    std_logic;
+
+        in_samples          : in    sample_streams_t(0 to NUM_STREAMS-1) := (others => ZERO_SAMPLE);
+        out_samples         : out   sample_streams_t(0 to NUM_STREAMS-1) := (others => ZERO_SAMPLE)
+    );
+end entity;
+
+architecture arch of tx_idle_fill is
+
+    type idle_counts_t is array(natural range <>) of natural range 0 to IDLE_CLOCKS-1;
+
+    signal idle_count : idle_counts_t(in_samples'range) := (others => 0);
+    signal zeroed     : std_logic_vector(in_samples'range) := (others => '0');
+    signal inject     : std_logic_vector(in_samples'range) := (others => '0');
+
+begin
+
+    -- Samples pass straight through, so TX timing is unchanged
+    count_idle : process(clock, reset)
+    begin
+        if( reset = '1' ) then
+            idle_count <= (others => 0);
+            zeroed     <= (others => '0');
+            inject     <= (others => '0');
+        elsif( rising_edge(clock) ) then
+            for i in in_samples'range loop
+                inject(i) <= '0';
+
+                if( in_samples(i).data_v = '1' ) then
+                    idle_count(i) <= 0;
+                    zeroed(i)     <= '0';
+                elsif( enable = '1' and zeroed(i) = '0' ) then
+                    if( idle_count(i) = IDLE_CLOCKS-1 ) then
+                        inject(i) <= '1';
+                        zeroed(i) <= '1';
+                    else
+                        idle_count(i) <= idle_count(i) + 1;
+                    end if;
+                end if;
+            end loop;
+        end if;
+    end process;
+
+    fill : process(all)
+    begin
+        for i in in_samples'range loop
+            out_samples(i) <= in_samples(i);
+            if( inject(i) = '1' and in_samples(i).data_v = '0' ) then
+                out_samples(i)        <= ZERO_SAMPLE;
+                out_samples(i).data_v <= '1';
+            end if;
+        end loop;
+    end process;
+
+end architecture;
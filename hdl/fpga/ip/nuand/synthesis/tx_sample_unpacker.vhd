@@ -0,0 +1,196 @@
+-- Copyright (c) 2026 Nuand LLC
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+
+
+library ieee;
+    use ieee.std_logic_1164.all;
+    use ieee.numeric_std.all;
+
+-- TX 12-bit sample unpacker
+--
+-- Sits between the TX sample FIFO and fifo_reader, and inverts
+-- rx_sample_packer. While packed_en is set, FIFO words hold 24-bit samples
+-- packed back to back, LSB first. They are presented to fifo_reader as a
+-- showahead FIFO of SC16 Q11 words, with each 12-bit value sign-extended
+-- into bits 15:0 (I) and 31:16 (Q) of every 32 bits.
+--
+-- With meta_en set, the padding words at the end of each message's samples
+-- are read and dropped.
+--
+-- While packed_en is clear, the FIFO passes through untouched.
+entity tx_sample_unpacker is
+    generic (
+        FIFO_DATA_WIDTH     : natural := 64
+    );
+    port (
+        clock               : in    std_logic;
+        reset               : in    std_logic;
+
+        packed_en           : in    std_logic;
+        meta_en             : in    std_logic;
+        usb_speed           : in    std_logic;
+
+        -- From the showahead sample FIFO
+        in_data             : in    std_logic_vector(FIFO_DATA_WIDTH-1 downto 0);
+        in_empty            : in    std_logic;
+        in_read             : out   std_logic;
+
+        -- Showahead interface to fifo_reader
+        out_data            : out   std_logic_vector(FIFO_DATA_WIDTH-1 downto 0);
+        out_empty           : out   std_logic;
+        out_read            : in    std_logic
+    );
+end entity;
+
+architecture arch of tx_sample_unpacker is
+
+    constant DMA_BUF_SIZE_SS    : natural := 512;
+    constant DMA_BUF_SIZE_HS    : natural := 256;
+
+    constant PACKED_WIDTH       : natural := FIFO_DATA_WIDTH*3/4;
+    constant ACC_WIDTH          : natural := 2*FIFO_DATA_WIDTH;
+
+    -- FIFO words per message and the padding words that follow them
+    signal msg_words            : natural range 0 to DMA_BUF_SIZE_SS;
+    signal pad_words            : natural range 0 to 4;
+
+    signal acc                  : unsigned(ACC_WIDTH-1 downto 0) := (others => '0');
+    signal fill                 : natural range 0 to ACC_WIDTH := 0;
+    signal word_count           : natural range 0 to DMA_BUF_SIZE_SS := 0;
+    signal pad_left             : natural range 0 to 4 := 0;
+
+    signal pop                  : std_logic;
+    signal push                 : std_logic;
+    signal packed_read          : std_logic;
+
+    -- Sign-extend the 12-bit I and Q values of each 24-bit sample
+    function unpack12( x : unsigned ) return std_logic_vector is
+        variable rv : std_logic_vector(FIFO_DATA_WIDTH-1 downto 0);
+    begin
+        for i in 0 to FIFO_DATA_WIDTH/32-1 loop
+            rv(32*i+15 downto 32*i)    := std_logic_vector(resize(signed(x(24*i+11 downto 24*i)), 16));
+            rv(32*i+31 downto 32*i+16) := std_logic_vector(resize(signed(x(24*i+23 downto 24*i+12)), 16));
+        end loop;
+        return rv;
+    end function;
+
+begin
+
+    -- Each message carries ((dma_buf_size-4)/6)*8 samples of 24 bits
+    calc_msg_size : process(clock, reset)
+        variable buf_words : natural range 0 to DMA_BUF_SIZE_SS;
+    begin
+        if( reset = '1' ) then
+            msg_words <= 0;
+            pad_words <= 0;
+        elsif( rising_edge(clock) ) then
+            if( usb_speed = '0' ) then
+                buf_words := DMA_BUF_SIZE_SS - 4;
+            else
+                buf_words := DMA_BUF_SIZE_HS - 4;
+            end if;
+
+            msg_words <= ((buf_words / 6) * 6) * 32 / FIFO_DATA_WIDTH;
+            if( meta_en = '1' ) then
+                pad_words <= (buf_words mod 6) * 32 / FIFO_DATA_WIDTH;
+            else
+                pad_words <= 0;
+            end if;
+        end if;
+    end process;
+
+    -- A sample is ready once a whole packed FIFO_DATA_WIDTH/32 samples are
+    -- buffered, and a FIFO word is taken whenever it fits after any pop
+    calc_handshake : process(all)
+        variable remaining : natural range 0 to ACC_WIDTH;
+    begin
+        pop <= '0';
+        if( fill >= PACKED_WIDTH and out_read = '1' ) then
+            pop <= '1';
+        end if;
+
+        if( fill >= PACKED_WIDTH and out_read = '1' ) then
+            remaining := fill - PACKED_WIDTH;
+        else
+            remaining := fill;
+        end if;
+
+        push <= '0';
+        if( in_empty = '0' and (pad_left /= 0 or remaining + FIFO_DATA_WIDTH <= ACC_WIDTH) ) then
+            push <= '1';
+        end if;
+    end process;
+
+    packed_read <= push;
+
+    unpack : process(clock, reset)
+        variable v_acc  : unsigned(ACC_WIDTH-1 downto 0);
+        variable v_fill : natural range 0 to ACC_WIDTH;
+    begin
+        if( reset = '1' ) then
+            acc        <= (others => '0');
+            fill       <= 0;
+            word_count <= 0;
+            pad_left   <= 0;
+        elsif( rising_edge(clock) ) then
+            v_acc  := acc;
+            v_fill := fill;
+
+            if( packed_en = '0' ) then
+                v_acc      := (others => '0');
+                v_fill     := 0;
+                word_count <= 0;
+                pad_left   <= 0;
+            else
+                if( pop = '1' ) then
+                    v_acc  := shift_right(v_acc, PACKED_WIDTH);
+                    v_fill := v_fill - PACKED_WIDTH;
+                end if;
+
+                if( push = '1' ) then
+                    if( pad_left /= 0 ) then
+                        -- Drop the message padding
+                        pad_left <= pad_left - 1;
+                    else
+                        v_acc  := v_acc or shift_left(resize(unsigned(in_data), ACC_WIDTH), v_fill);
+                        v_fill := v_fill + FIFO_DATA_WIDTH;
+
+                        if( word_count = msg_words - 1 ) then
+                            word_count <= 0;
+                            pad_left   <= pad_words;
+                        else
+                            word_count <= word_count + 1;
+                        end if;
+                    end if;
+                end if;
+            end if;
+
+            acc  <= v_acc;
+            fill <= v_fill;
+        end if;
+    end process;
+
+    out_data  <= unpack12(acc(PACKED_WIDTH-1 downto 0)) when packed_en = '1' else in_data;
+    out_empty <= '0' when packed_en = '1' and fill >= PACKED_WIDTH else
+                 '1' when packed_en = '1' else
+                 in_empty;
+    in_read   <= packed_read when packed_en = '1' else out_read;
+
+end architecture;
@@ -0,0 +1,244 @@
+-- Copyright (c) 2026 Nuand LLC
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+
+library ieee;
+    use ieee.std_logic_1164.all;
+    use ieee.numeric_std.all;
+
+library work;
+    use work.fifo_readwrite_p.all;
+
+-- TX waveform player
+--
+-- Holds a host-loaded waveform in block RAM and plays it back in a loop on
+-- every TX stream, without any samples coming from the host. Each stored
+-- sample is linearly interpolated up by 2**log2_interp output samples.
+--
+-- The Wishbone slave is clocked by the TX clock. Word addresses:
+--
+--   0x0000  Control  [0] loop enable, [10:8] log2 interpolation
+--   0x0001  Length   Number of samples to loop over, 1 to 2**ADDR_WIDTH
+--   0x4000+ Waveform RAM, one sample per word: [31:16] Q, [15:0] I
+--
+-- While the loop is enabled, active is asserted and out_samples should be
+-- sent to the DACs in place of the sample FIFO.
+entity tx_wave_player is
+    generic (
+        NUM_STREAMS         : natural  := 2;
+        ADDR_WIDTH          : positive := 12;
+        MAX_LOG2_INTERP     : natural  := 6
+    );
+    port (
+        clock               : in    std_logic;
+        reset               : in    std_logic;
+
+        -- Wishbone slave
+        wb_adr_i            : in    std_logic_vector(31 downto 0) := (others => '0');
+        wb_dat_i            : in    std_logic_vector(31 downto 0) := (others => '0');
+        wb_dat_o            : out   std_logic_vector(31 downto 0) := (others => '0');
+        wb_we_i             : in    std_logic := '0';
+        wb_cyc_i            : in    std_logic := '0';
+        wb_ack_o            : out   std_logic := '0';
+
+        -- Playback
+        active              : out   std_logic := '0';
+        in_sample_controls  : in    sample_controls_t(0 to NUM_STREAMS-1) := (others => SAMPLE_CONTROL_DISABLE);
+        out_samples         : out   sample_streams_t(0 to NUM_STREAMS-1)  := (others => ZERO_SAMPLE)
+    );
+end entity;
+
+architecture arch of tx_wave_player is
+
+    constant DEPTH          : positive := 2**ADDR_WIDTH;
+    constant REG_CONTROL    : natural  := 16#0000#;
+    constant REG_LENGTH     : natural  := 16#0001#;
+    constant RAM_SELECT_BIT : natural  := 14;
+
+    type ram_t is array(0 to DEPTH-1) of std_logic_vector(31 downto 0);
+    signal ram              : ram_t;
+    signal ram_q            : std_logic_vector(31 downto 0) := (others => '0');
+
+    signal loop_en          : std_logic := '0';
+    signal log2_interp      : natural range 0 to MAX_LOG2_INTERP := 0;
+    signal length           : unsigned(ADDR_WIDTH downto 0) := to_unsigned(1, ADDR_WIDTH+1);
+
+    signal step             : std_logic := '0';
+    signal segment_done     : std_logic := '0';
+    signal rd_addr          : unsigned(ADDR_WIDTH-1 downto 0) := (others => '0');
+    signal rd_addr_next     : unsigned(ADDR_WIDTH-1 downto 0) := (others => '0');
+    signal step_count       : unsigned(MAX_LOG2_INTERP-1 downto 0) := (others => '0');
+
+    -- Linear interpolation from the previous sample towards endpoint
+    constant ACCUM_WIDTH    : positive := 16 + MAX_LOG2_INTERP + 1;
+    signal accum_i          : signed(ACCUM_WIDTH-1 downto 0) := (others => '0');
+    signal accum_q          : signed(ACCUM_WIDTH-1 downto 0) := (others => '0');
+    signal delta_i          : signed(16 downto 0) := (others => '0');
+    signal delta_q          : signed(16 downto 0) := (others => '0');
+    signal endpoint_i       : signed(15 downto 0) := (others => '0');
+    signal endpoint_q       : signed(15 downto 0) := (others => '0');
+
+begin
+
+    active <= loop_en;
+
+    -- Registers are written from the bus; reads return their current value
+    wishbone_slave : process(clock, reset)
+        variable addr : unsigned(wb_adr_i'range);
+    begin
+        if( reset = '1' ) then
+            wb_ack_o    <= '0';
+            wb_dat_o    <= (others => '0');
+            loop_en     <= '0';
+            log2_interp <= 0;
+            length      <= to_unsigned(1, length'length);
+        elsif( rising_edge(clock) ) then
+            addr     := unsigned(wb_adr_i);
+            wb_ack_o <= wb_cyc_i;
+            wb_dat_o <= (others => '0');
+
+            if( wb_cyc_i = '1' ) then
+                if( addr(RAM_SELECT_BIT) = '1' ) then
+                    -- Waveform RAM is write-only from the bus
+                    null;
+                elsif( addr = REG_CONTROL ) then
+                    if( wb_we_i = '1' ) then
+                        loop_en <= wb_dat_i(0);
+                        if( to_integer(unsigned(wb_dat_i(10 downto 8))) > MAX_LOG2_INTERP ) then
+                            log2_interp <= MAX_LOG2_INTERP;
+                        else
+                            log2_interp <= to_integer(unsigned(wb_dat_i(10 downto 8)));
+                        end if;
+                    end if;
+                    wb_dat_o(0)          <= loop_en;
+                    wb_dat_o(10 downto 8) <= std_logic_vector(to_unsigned(log2_interp, 3));
+                elsif( addr = REG_LENGTH ) then
+                    if( wb_we_i = '1' ) then
+                        if( unsigned(wb_dat_i) = 0 ) then
+                            length <= to_unsigned(1, length'length);
+                        elsif( unsigned(wb_dat_i) > DEPTH ) then
+                            length <= to_unsigned(DEPTH, length'length);
+                        else
+                            length <= resize(unsigned(wb_dat_i), length'length);
+                        end if;
+                    end if;
+                    wb_dat_o(length'range) <= std_logic_vector(length);
+                end if;
+            end if;
+        end if;
+    end process;
+
+    -- Any enabled stream asking for a sample advances the waveform
+    calc_step : process(all)
+        variable req : std_logic;
+    begin
+        req := '0';
+        for i in in_sample_controls'range loop
+            req := req or (in_sample_controls(i).enable and in_sample_controls(i).data_req);
+        end loop;
+        step <= req and loop_en;
+
+        if( step_count = 2**log2_interp - 1 ) then
+            segment_done <= '1';
+        else
+            segment_done <= '0';
+        end if;
+    end process;
+
+    -- The read address for the next clock is computed combinationally so the
+    -- RAM output always holds the sample the next segment ends on, even when
+    -- a sample is requested on every clock.
+    calc_rd_addr : process(all)
+    begin
+        rd_addr_next <= rd_addr;
+        if( loop_en = '0' ) then
+            rd_addr_next <= (others => '0');
+        elsif( step = '1' and segment_done = '1' ) then
+            if( rd_addr = length - 1 ) then
+                rd_addr_next <= (others => '0');
+            else
+                rd_addr_next <= rd_addr + 1;
+            end if;
+        end if;
+    end process;
+
+    sample_ram : process(clock)
+    begin
+        if( rising_edge(clock) ) then
+            if( wb_cyc_i = '1' and wb_we_i = '1' and wb_adr_i(RAM_SELECT_BIT) = '1' ) then
+                ram(to_integer(unsigned(wb_adr_i(ADDR_WIDTH-1 downto 0)))) <= wb_dat_i;
+            end if;
+            ram_q <= ram(to_integer(rd_addr_next));
+        end if;
+    end process;
+
+    playback : process(clock, reset)
+        variable sample_i  : signed(15 downto 0);
+        variable sample_q  : signed(15 downto 0);
+    begin
+        if( reset = '1' ) then
+            rd_addr     <= (others => '0');
+            step_count  <= (others => '0');
+            accum_i     <= (others => '0');
+            accum_q     <= (others => '0');
+            delta_i     <= (others => '0');
+            delta_q     <= (others => '0');
+            endpoint_i  <= (others => '0');
+            endpoint_q  <= (others => '0');
+            out_samples <= (others => ZERO_SAMPLE);
+        elsif( rising_edge(clock) ) then
+            rd_addr <= rd_addr_next;
+
+            if( loop_en = '0' ) then
+                step_count <= (others => '0');
+                accum_i    <= (others => '0');
+                accum_q    <= (others => '0');
+                delta_i    <= (others => '0');
+                delta_q    <= (others => '0');
+                endpoint_i <= (others => '0');
+                endpoint_q <= (others => '0');
+            elsif( step = '1' ) then
+                accum_i <= accum_i + delta_i;
+                accum_q <= accum_q + delta_q;
+
+                if( segment_done = '1' ) then
+                    -- accum now reaches endpoint << log2_interp, so head for
+                    -- the next stored sample
+                    step_count <= (others => '0');
+
+                    sample_i   := signed(ram_q(15 downto 0));
+                    sample_q   := signed(ram_q(31 downto 16));
+                    delta_i    <= resize(sample_i, delta_i'length) - endpoint_i;
+                    delta_q    <= resize(sample_q, delta_q'length) - endpoint_q;
+                    endpoint_i <= sample_i;
+                    endpoint_q <= sample_q;
+                else
+                    step_count <= step_count + 1;
+                end if;
+            end if;
+
+            for i in out_samples'range loop
+                out_samples(i).data_i <= resize(shift_right(accum_i, log2_interp), 16);
+                out_samples(i).data_q <= resize(shift_right(accum_q, log2_interp), 16);
+                out_samples(i).data_v <= in_sample_controls(i).enable and in_sample_controls(i).data_req and loop_en;
+            end loop;
+        end if;
+    end process;
+
+end architecture;
@@ -76,6 +76,15 @@ architecture arch of time_tamer is
 
     signal mm_ts_reset          :   std_logic ;
 
+    -- Time of the last rising edge of ts_sync_in, and whether it fell in the
+    -- second ts_clock cycle of that sample
+    signal ts_sync              :   std_logic ;
+    signal ts_sync_prev         :   std_logic ;
+    signal sync_time            :   unsigned(63 downto 0) ;
+    signal sync_half            :   std_logic ;
+    signal ts_sync_latched      :   std_logic ;
+    signal mm_sync_latched      :   std_logic ;
+
 begin
 
     uaddr <= unsigned(addr) ;
@@ -85,7 +94,7 @@ begin
 
     ts_sync_out <= '0' ;
 
-    status <= (0 => status_past, others =>'0') ;
+    status <= (0 => status_past, 1 => mm_sync_latched, 2 => sync_half, others =>'0') ;
 
     U_sync_ts_reset : entity work.synchronizer
       generic map (
@@ -147,6 +156,26 @@ begin
         sync        =>  mm_time_trigger
       ) ;
 
+    U_sync_sync_in : entity work.synchronizer
+      generic map (
+        RESET_LEVEL =>  '0'
+      ) port map (
+        reset       =>  ts_reset,
+        clock       =>  ts_clock,
+        async       =>  ts_sync_in,
+        sync        =>  ts_sync
+      ) ;
+
+    U_sync_latched : entity work.synchronizer
+      generic map (
+        RESET_LEVEL =>  '0'
+      ) port map (
+        reset       =>  reset,
+        clock       =>  clock,
+        async       =>  ts_sync_latched,
+        sync        =>  mm_sync_latched
+      ) ;
+
     ts_time <= std_logic_vector(timestamp) ;
 
     increment_time : process(ts_clock, ts_reset)
@@ -155,7 +184,21 @@ begin
         if( ts_reset = '1' ) then
             tick := '1' ;
             timestamp <= (others =>'0') ;
+            ts_sync_prev <= '0' ;
+            ts_sync_latched <= '0' ;
+            sync_time <= (others =>'0') ;
+            sync_half <= '0' ;
         elsif( rising_edge(ts_clock) ) then
+            -- Latch the time of each rising edge of ts_sync_in. The delay
+            -- through the synchronizer is fixed, so it doesn't affect the
+            -- difference between two devices' latched times.
+            ts_sync_prev <= ts_sync ;
+            if( ts_sync = '1' and ts_sync_prev = '0' ) then
+                sync_time <= timestamp ;
+                sync_half <= not tick ;
+                ts_sync_latched <= '1' ;
+            end if ;
+
             if( tick = '0' ) then
                 timestamp <= timestamp + 1 ;
             end if ;
@@ -234,6 +277,17 @@ begin
 
                 when 9  => dout <= status ;
 
+                -- Latched when ts_sync_in rises, and held until it rises
+                -- again. Only valid once status bit 1 is set.
+                when 10 => dout <= std_logic_vector(sync_time(7 downto 0));
+                when 11 => dout <= std_logic_vector(sync_time(15 downto 8));
+                when 12 => dout <= std_logic_vector(sync_time(23 downto 16));
+                when 13 => dout <= std_logic_vector(sync_time(31 downto 24));
+                when 14 => dout <= std_logic_vector(sync_time(39 downto 32));
+                when 15 => dout <= std_logic_vector(sync_time(47 downto 40));
+                when 16 => dout <= std_logic_vector(sync_time(55 downto 48));
+                when 17 => dout <= std_logic_vector(sync_time(63 downto 56));
+
                 when others  => dout <= x"13";
             end case;
         end if ;
@@ -13,7 +13,10 @@ entity trigger is
     signal_in       :   in  std_logic;
 
     trigger_out     :   out std_logic;
-    signal_out      :   out std_logic
+    signal_out      :   out std_logic;
+
+    -- Asserted while armed and the trigger signal is asserted
+    tripped         :   out std_logic
   );
 end entity;
 
@@ -23,4 +26,5 @@ begin
     triggered <= not armed or not trigger_in;
     signal_out <= signal_in when triggered else DEFAULT_OUTPUT;
     trigger_out <= not fired when master else 'Z';
+    tripped <= armed and not trigger_in;
 end architecture;
@@ -374,6 +374,19 @@ set_instance_parameter_value xb_gpio_dir {simDoTestBenchWiring} {0}
 set_instance_parameter_value xb_gpio_dir {simDrivenValue} {0.0}
 set_instance_parameter_value xb_gpio_dir {width} {32}
 
+add_instance rx_decim_ctl altera_avalon_pio
+set_instance_parameter_value rx_decim_ctl {bitClearingEdgeCapReg} {0}
+set_instance_parameter_value rx_decim_ctl {bitModifyingOutReg} {0}
+set_instance_parameter_value rx_decim_ctl {captureEdge} {0}
+set_instance_parameter_value rx_decim_ctl {direction} {Output}
+set_instance_parameter_value rx_decim_ctl {edgeType} {RISING}
+set_instance_parameter_value rx_decim_ctl {generateIRQ} {0}
+set_instance_parameter_value rx_decim_ctl {irqType} {LEVEL}
+set_instance_parameter_value rx_decim_ctl {resetValue} {0.0}
+set_instance_parameter_value rx_decim_ctl {simDoTestBenchWiring} {0}
+set_instance_parameter_value rx_decim_ctl {simDrivenValue} {0.0}
+set_instance_parameter_value rx_decim_ctl {width} {32}
+
 add_instance arbiter_0 arbiter 1.0
 set_instance_parameter_value arbiter_0 {N} {2}
 
@@ -440,6 +453,8 @@ add_interface xb_gpio conduit end
 set_interface_property xb_gpio EXPORT_OF xb_gpio.external_connection
 add_interface xb_gpio_dir conduit end
 set_interface_property xb_gpio_dir EXPORT_OF xb_gpio_dir.external_connection
+add_interface rx_decim_ctl conduit end
+set_interface_property rx_decim_ctl EXPORT_OF rx_decim_ctl.external_connection
 add_interface arbiter conduit end
 set_interface_property arbiter EXPORT_OF arbiter_0.conduit_end
 add_interface wbm conduit end
@@ -544,6 +559,11 @@ set_connection_parameter_value nios2.data_master/xb_gpio_dir.s1 arbitrationPrior
 set_connection_parameter_value nios2.data_master/xb_gpio_dir.s1 baseAddress {0x90a0}
 set_connection_parameter_value nios2.data_master/xb_gpio_dir.s1 defaultConnection {0}
 
+add_connection nios2.data_master rx_decim_ctl.s1
+set_connection_parameter_value nios2.data_master/rx_decim_ctl.s1 arbitrationPriority {1}
+set_connection_parameter_value nios2.data_master/rx_decim_ctl.s1 baseAddress {0x9460}
+set_connection_parameter_value nios2.data_master/rx_decim_ctl.s1 defaultConnection {0}
+
 add_connection nios2.data_master arbiter_0.avalon_slave_0 avalon
 set_connection_parameter_value nios2.data_master/arbiter_0.avalon_slave_0 arbitrationPriority {1}
 set_connection_parameter_value nios2.data_master/arbiter_0.avalon_slave_0 baseAddress {0x9500}
@@ -625,6 +645,8 @@ add_connection system_clock.clk xb_gpio.clk
 
 add_connection system_clock.clk xb_gpio_dir.clk
 
+add_connection system_clock.clk rx_decim_ctl.clk
+
 add_connection system_clock.clk arbiter_0.clock_sink clock
 
 add_connection system_clock.clk wishbone_master_0.clock_sink clock
@@ -663,6 +685,8 @@ add_connection system_clock.clk_reset xb_gpio.reset
 
 add_connection system_clock.clk_reset xb_gpio_dir.reset
 
+add_connection system_clock.clk_reset rx_decim_ctl.reset
+
 add_connection system_clock.clk_reset arbiter_0.reset reset
 
 add_connection system_clock.clk_reset wishbone_master_0.reset reset
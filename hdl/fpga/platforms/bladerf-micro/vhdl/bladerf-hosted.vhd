@@ -89,9 +89,15 @@ architecture hosted_bladerf of bladerf is
     signal meta_en_tx             : std_logic;
     signal meta_en_rx             : std_logic;
 
+    signal rx_meta_msg_log2       : unsigned(1 downto 0);
+    signal rx_meta_msg_log2_pclk  : unsigned(1 downto 0);
+    signal rx_meta_msg_log2_rx    : unsigned(1 downto 0);
+
     signal eightbit_en_pclk       : std_logic;
     signal eightbit_en_tx         : std_logic;
     signal eightbit_en_rx         : std_logic;
+    signal sc12_packed_en_tx      : std_logic;
+    signal sc12_packed_en_rx      : std_logic;
 
     signal packet_en_pclk         : std_logic;
     signal packet_en_tx           : std_logic;
@@ -113,6 +119,10 @@ architecture hosted_bladerf of bladerf is
 
     signal tx_underflow_led       : std_logic := '1';
     signal rx_overflow_led        : std_logic := '1';
+    signal tx_underflow_count     : unsigned(63 downto 0);
+    signal tx_underflow_time      : unsigned(63 downto 0);
+    signal rx_overflow_count      : unsigned(63 downto 0);
+    signal rx_overflow_time       : unsigned(63 downto 0);
 
     signal led1_blink             : std_logic;
 
@@ -135,6 +145,13 @@ architecture hosted_bladerf of bladerf is
     signal rx_trigger_ctl         : trigger_t := TRIGGER_T_DEFAULT;
     alias  rx_trigger_line        : std_logic is mini_exp1;
 
+    -- RX decimation control: [18:16] log2 decimation, [15:0] NCO phase step
+    signal rx_decim_ctl_i         : std_logic_vector(31 downto 0);
+    signal rx_decim_ctl_hs        : std_logic_vector(31 downto 0);
+    signal rx_decim_ctl_rx        : std_logic_vector(31 downto 0) := (others => '0');
+    signal rx_decim_req           : std_logic;
+    signal rx_decim_ack           : std_logic;
+
     signal tx_trigger_ctl_i       : std_logic_vector(7 downto 0);
     signal tx_trigger_ctl         : trigger_t := TRIGGER_T_DEFAULT;
     alias  tx_trigger_line        : std_logic is mini_exp1;
@@ -179,6 +196,20 @@ architecture hosted_bladerf of bladerf is
     signal wbm_wb_stb_o           : std_logic;
     signal wbm_wb_ack_i           : std_logic;
     signal wbm_wb_cyc_o           : std_logic;
+
+    -- Wishbone slaves, selected by word address bits 15 to 13
+    signal wave_wb_cyc            : std_logic;
+    signal wave_wb_dat            : std_logic_vector(31 downto 0);
+    signal wave_wb_ack            : std_logic;
+    signal meter_wb_cyc           : std_logic;
+    signal meter_wb_dat           : std_logic_vector(31 downto 0);
+    signal meter_wb_ack           : std_logic;
+    signal gate_wb_cyc            : std_logic;
+    signal gate_wb_dat            : std_logic_vector(31 downto 0);
+    signal gate_wb_ack            : std_logic;
+    signal stats_wb_cyc           : std_logic;
+    signal stats_wb_dat           : std_logic_vector(31 downto 0);
+    signal stats_wb_ack           : std_logic;
 begin
 
     U_rx_pkt_gen : entity work.rx_packet_generator
@@ -289,6 +320,7 @@ begin
 
             meta_enable         =>  meta_en_pclk,
             packet_enable       =>  packet_en_pclk,
+            rx_meta_msg_log2    =>  rx_meta_msg_log2_pclk,
             rx_enable           =>  rx_enable_pclk,
             tx_enable           =>  tx_enable_pclk,
 
@@ -450,6 +482,7 @@ begin
             tx_tamer_ts_reset               => tx_ts_reset,
             unsigned(tx_tamer_ts_time)      => tx_timestamp,
             rx_trigger_ctl_out_port         => rx_trigger_ctl_i,
+            rx_decim_ctl_export             => rx_decim_ctl_i,
             tx_trigger_ctl_out_port         => tx_trigger_ctl_i,
             rx_trigger_ctl_in_port          => pack(rx_trigger_ctl),
             tx_trigger_ctl_in_port          => pack(tx_trigger_ctl),
@@ -543,6 +576,30 @@ begin
 
     tx_packet_ready <= '1';
 
+    -- The Nios Wishbone master reaches the TX waveform player, the RX
+    -- power meter, the RX gate and the stream statistics. All run from the
+    -- AD9361 clock, as does the bus.
+    wbm_wb_clk_i <= tx_clock;
+    wbm_wb_rst_i <= tx_reset;
+
+    wb_decode : process(all)
+    begin
+        wave_wb_cyc  <= wbm_wb_cyc_o and not wbm_wb_adr_o(15);
+        meter_wb_cyc <= wbm_wb_cyc_o and wbm_wb_adr_o(15) and not wbm_wb_adr_o(14);
+        gate_wb_cyc  <= wbm_wb_cyc_o and wbm_wb_adr_o(15) and wbm_wb_adr_o(14) and not wbm_wb_adr_o(13);
+        stats_wb_cyc <= wbm_wb_cyc_o and wbm_wb_adr_o(15) and wbm_wb_adr_o(14) and wbm_wb_adr_o(13);
+        wbm_wb_ack_i <= wave_wb_ack or meter_wb_ack or gate_wb_ack or stats_wb_ack;
+        if( meter_wb_ack = '1' ) then
+            wbm_wb_dat_i <= meter_wb_dat;
+        elsif( gate_wb_ack = '1' ) then
+            wbm_wb_dat_i <= gate_wb_dat;
+        elsif( stats_wb_ack = '1' ) then
+            wbm_wb_dat_i <= stats_wb_dat;
+        else
+            wbm_wb_dat_i <= wave_wb_dat;
+        end if;
+    end process;
+
     -- TX Submodule
     U_tx : entity work.tx
         generic map (
@@ -557,6 +614,8 @@ begin
             timestamp_reset      => tx_ts_reset,
             usb_speed            => usb_speed_tx,
             tx_underflow_led     => tx_underflow_led,
+            tx_underflow_count   => tx_underflow_count,
+            tx_underflow_time    => tx_underflow_time,
             tx_timestamp         => tx_timestamp,
 
             -- Triggering
@@ -567,6 +626,7 @@ begin
 
             -- Eightbit mode
             eight_bit_mode_en    => eightbit_en_tx,
+            packed_en            => sc12_packed_en_tx,
 
             -- Packet FIFO
             packet_en            => packet_en_tx,
@@ -598,6 +658,14 @@ begin
             loopback_fifo_wfull  => tx_loopback_fifo.wfull,
             loopback_fifo_wused  => tx_loopback_fifo.wused,
 
+            -- Waveform player
+            wave_wb_adr_i        => wbm_wb_adr_o,
+            wave_wb_dat_i        => wbm_wb_dat_o,
+            wave_wb_dat_o        => wave_wb_dat,
+            wave_wb_we_i         => wbm_wb_we_o,
+            wave_wb_cyc_i        => wave_wb_cyc,
+            wave_wb_ack_o        => wave_wb_ack,
+
             -- RFFE Interface
             dac_controls         => dac_controls,
             dac_streams          => dac_streams
@@ -629,10 +697,15 @@ begin
             rx_enable              => rx_enable,
 
             meta_en                => meta_en_rx,
+            meta_msg_log2          => rx_meta_msg_log2_rx,
             timestamp_reset        => rx_ts_reset,
             usb_speed              => usb_speed_rx,
             rx_mux_sel             => rx_mux_sel,
+            rx_decimation          => unsigned(rx_decim_ctl_rx(18 downto 16)),
+            rx_nco_dphase          => signed(rx_decim_ctl_rx(15 downto 0)),
             rx_overflow_led        => rx_overflow_led,
+            rx_overflow_count      => rx_overflow_count,
+            rx_overflow_time       => rx_overflow_time,
             rx_timestamp           => rx_timestamp,
 
             -- Triggering
@@ -641,8 +714,17 @@ begin
             trigger_master         => rx_trigger_ctl.master,
             trigger_line           => rx_trigger_line,
 
+            -- Timestamp gate
+            gate_wb_adr_i          => wbm_wb_adr_o,
+            gate_wb_dat_i          => wbm_wb_dat_o,
+            gate_wb_dat_o          => gate_wb_dat,
+            gate_wb_we_i           => wbm_wb_we_o,
+            gate_wb_cyc_i          => gate_wb_cyc,
+            gate_wb_ack_o          => gate_wb_ack,
+
             -- Eightbit mode
             eight_bit_mode_en      => eightbit_en_rx,
+            packed_en              => sc12_packed_en_rx,
 
             -- Packet FIFO
             packet_en              => packet_en_rx,
@@ -684,6 +766,45 @@ begin
             adc_streams            => adc_streams
         );
 
+    -- Power and sample snapshot measurements on the raw ADC samples
+    U_rx_power_meter : entity work.rx_power_meter
+        generic map (
+            NUM_STREAMS            => adc_controls'length
+        )
+        port map (
+            clock                  => rx_clock,
+            reset                  => rx_reset,
+
+            wb_adr_i               => wbm_wb_adr_o,
+            wb_dat_i               => wbm_wb_dat_o,
+            wb_dat_o               => meter_wb_dat,
+            wb_we_i                => wbm_wb_we_o,
+            wb_cyc_i               => meter_wb_cyc,
+            wb_ack_o               => meter_wb_ack,
+
+            in_sample_controls     => adc_controls,
+            in_samples             => adc_streams
+        );
+
+    -- FIFO overflow and underflow counts for the host
+    U_stream_stats : entity work.stream_stats
+        port map (
+            clock                  => tx_clock,
+            reset                  => tx_reset,
+
+            wb_adr_i               => wbm_wb_adr_o,
+            wb_dat_i               => wbm_wb_dat_o,
+            wb_dat_o               => stats_wb_dat,
+            wb_we_i                => wbm_wb_we_o,
+            wb_cyc_i               => stats_wb_cyc,
+            wb_ack_o               => stats_wb_ack,
+
+            rx_overflow_count      => rx_overflow_count,
+            rx_overflow_time       => rx_overflow_time,
+            tx_underflow_count     => tx_underflow_count,
+            tx_underflow_time      => tx_underflow_time
+        );
+
     adc_assignment_proc : process( all )
     begin
         for i in adc_controls'range loop
@@ -859,6 +980,28 @@ begin
             sync                =>  eightbit_en_tx
         );
 
+    U_sync_sc12_packed_en_rx : entity work.synchronizer
+        generic map (
+            RESET_LEVEL         =>  '0'
+        )
+        port map (
+            reset               =>  '0',
+            clock               =>  rx_clock,
+            async               =>  nios_gpio.o.sc12_packed_en,
+            sync                =>  sc12_packed_en_rx
+        );
+
+    U_sync_sc12_packed_en_tx : entity work.synchronizer
+        generic map (
+            RESET_LEVEL         =>  '0'
+        )
+        port map (
+            reset               =>  '0',
+            clock               =>  tx_clock,
+            async               =>  nios_gpio.o.sc12_packed_en,
+            sync                =>  sc12_packed_en_tx
+        );
+
     U_sync_packet_en_pclk : entity work.synchronizer
         generic map (
             RESET_LEVEL         =>  '0'
@@ -892,6 +1035,34 @@ begin
             sync                =>  packet_en_tx
         );
 
+    -- The 12-bit sample packer pads each DMA buffer, so packed messages are
+    -- always one buffer long
+    rx_meta_msg_log2 <= nios_gpio.o.rx_meta_msg_log2 when nios_gpio.o.sc12_packed_en = '0' else "00";
+
+    generate_sync_rx_meta_msg_log2 : for i in rx_meta_msg_log2'range generate
+        U_sync_rx_meta_msg_log2_pclk : entity work.synchronizer
+            generic map (
+                RESET_LEVEL         =>  '0'
+            )
+            port map (
+                reset               =>  '0',
+                clock               =>  fx3_pclk_pll,
+                async               =>  rx_meta_msg_log2(i),
+                sync                =>  rx_meta_msg_log2_pclk(i)
+            );
+
+        U_sync_rx_meta_msg_log2_rx : entity work.synchronizer
+            generic map (
+                RESET_LEVEL         =>  '0'
+            )
+            port map (
+                reset               =>  '0',
+                clock               =>  rx_clock,
+                async               =>  rx_meta_msg_log2(i),
+                sync                =>  rx_meta_msg_log2_rx(i)
+            );
+    end generate;
+
     generate_sync_rx_mux_sel : for i in rx_mux_sel'range generate
         U_sync_rx_mux_sel : entity work.synchronizer
             generic map (
@@ -1027,4 +1198,37 @@ begin
             dest_ack            =>  timestamp_ack
         );
 
+    -- Keep re-requesting the decimation control word so changes from the Nios
+    -- land in the RX clock domain as a whole
+    drive_handshake_rx_decim : process( rx_clock, rx_reset )
+    begin
+        if( rx_reset = '1' ) then
+            rx_decim_req    <= '0';
+            rx_decim_ctl_rx <= (others => '0');
+        elsif( rising_edge(rx_clock) ) then
+            if( rx_decim_ack = '0' ) then
+                rx_decim_req    <= '1';
+            elsif( rx_decim_ack = '1' ) then
+                rx_decim_req    <= '0';
+                rx_decim_ctl_rx <= rx_decim_ctl_hs;
+            end if;
+        end if;
+    end process;
+
+    U_handshake_rx_decim : entity work.handshake
+        generic map (
+            DATA_WIDTH          =>  rx_decim_ctl_i'length
+        )
+        port map (
+            source_clock        =>  sys_clock,
+            source_reset        =>  sys_reset,
+            source_data         =>  rx_decim_ctl_i,
+
+            dest_clock          =>  rx_clock,
+            dest_reset          =>  rx_reset,
+            dest_data           =>  rx_decim_ctl_hs,
+            dest_req            =>  rx_decim_req,
+            dest_ack            =>  rx_decim_ack
+        );
+
 end architecture;
@@ -146,6 +146,7 @@ package bladerf_p is
         tx_trigger_ctl_out_port         :   out std_logic_vector(7 downto 0);
         rx_trigger_ctl_in_port          :   in  std_logic_vector(7 downto 0);
         rx_trigger_ctl_out_port         :   out std_logic_vector(7 downto 0);
+        rx_decim_ctl_export             :   out std_logic_vector(31 downto 0);
         arbiter_request                 :   in  std_logic_vector(1 downto 0)  := (others => 'X');
         arbiter_granted                 :   out std_logic_vector(1 downto 0);
         arbiter_ack                     :   in  std_logic_vector(1 downto 0)  := (others => 'X');
@@ -306,6 +307,8 @@ package bladerf_p is
 
     type nios_gpo_t is record
         xb_mode         : std_logic_vector(1 downto 0);
+        rx_meta_msg_log2 : unsigned(1 downto 0);
+        sc12_packed_en  : std_logic;
         eightbit_en     : std_logic;
         packet_en       : std_logic;
         si_clock_sel    : std_logic;
@@ -518,6 +521,8 @@ package body bladerf_p is
         variable rv : std_logic_vector(31 downto 0) := (others => 'U');
     begin
         rv(31 downto 30) := x.xb_mode;
+        rv(23 downto 22) := std_logic_vector(x.rx_meta_msg_log2);
+        rv(21)           := x.sc12_packed_en;
         rv(20)           := x.eightbit_en;
         rv(19)           := x.packet_en;
         rv(18)           := x.si_clock_sel;
@@ -597,6 +602,8 @@ package body bladerf_p is
         variable rv : nios_gpo_t;
     begin
         rv.xb_mode         := x(31 downto 30);
+        rv.rx_meta_msg_log2 := unsigned(x(23 downto 22));
+        rv.sc12_packed_en  := x(21);
         rv.eightbit_en     := x(20);
         rv.packet_en       := x(19);
         rv.si_clock_sel    := x(18);
@@ -36,10 +36,15 @@ entity rx is
         rx_enable              : in    std_logic;
 
         meta_en                : in    std_logic := '0';
+        meta_msg_log2          : in    unsigned(1 downto 0) := "00";
         timestamp_reset        : out   std_logic := '1';
         usb_speed              : in    std_logic;
         rx_mux_sel             : in    unsigned;
+        rx_decimation          : in    unsigned(2 downto 0) := (others => '0');
+        rx_nco_dphase          : in    signed(15 downto 0)  := (others => '0');
         rx_overflow_led        : out   std_logic := '1';
+        rx_overflow_count      : out   unsigned(63 downto 0) := (others => '0');
+        rx_overflow_time       : out   unsigned(63 downto 0) := (others => '0');
         rx_timestamp           : in    unsigned(63 downto 0);
 
         -- Triggering
@@ -49,9 +54,20 @@ entity rx is
         trigger_line           : inout std_logic; -- this is not good, should be in/out/oe
         trigger_signal_sync_tb : out   std_logic;
 
+        -- Timestamp gate Wishbone slave
+        gate_wb_adr_i          : in    std_logic_vector(31 downto 0) := (others => '0');
+        gate_wb_dat_i          : in    std_logic_vector(31 downto 0) := (others => '0');
+        gate_wb_dat_o          : out   std_logic_vector(31 downto 0) := (others => '0');
+        gate_wb_we_i           : in    std_logic := '0';
+        gate_wb_cyc_i          : in    std_logic := '0';
+        gate_wb_ack_o          : out   std_logic := '0';
+
         -- 8-bit mode
         eight_bit_mode_en      : in std_logic := '0';
 
+        -- 12-bit packed samples
+        packed_en              : in    std_logic := '0';
+
         -- Packet to host via FX3
         packet_en              : in    std_logic;
         packet_control         : in    packet_control_t;
@@ -112,6 +128,9 @@ architecture arch of rx is
     signal loopback_fifo            : loopback_fifo_t     := LOOPBACK_FIFO_T_DEFAULT;
     signal meta_fifo                : meta_fifo_rx_t      := META_FIFO_RX_T_DEFAULT;
 
+    signal unpacked_wdata           : std_logic_vector(sample_fifo.wdata'range);
+    signal unpacked_wreq            : std_logic;
+
     signal loopback_streams         : sample_streams_t(adc_streams'range) := (others => ZERO_SAMPLE);
     signal loopback_enabled         : std_logic           := '0';
     signal loopback_fifo_wenabled_i : std_logic           := '0';
@@ -123,12 +142,22 @@ architecture arch of rx is
 
     signal mux_streams              : sample_streams_t(adc_streams'range) := (others => ZERO_SAMPLE);
 
+    -- Can be set from libbladeRF using bladerf_set_rx_decimation()
+    constant RX_DECIM_MAX_LOG2      : natural := 6;
+    signal rx_decim_log2            : natural range 0 to RX_DECIM_MAX_LOG2 := 0;
+    signal chan_streams             : sample_streams_t(adc_streams'range) := (others => ZERO_SAMPLE);
+
+    -- Can be set from libbladeRF using bladerf_schedule_rx()
+    signal gated_streams            : sample_streams_t(adc_streams'range) := (others => ZERO_SAMPLE);
+
     signal trigger_signal_out       : std_logic;
     signal trigger_signal_out_sync  : std_logic;
 
 begin
 
     rx_mux_mode            <= rx_mux_mode_t'val(to_integer(rx_mux_sel));
+    rx_decim_log2          <= RX_DECIM_MAX_LOG2 when to_integer(rx_decimation) > RX_DECIM_MAX_LOG2 else
+                              to_integer(rx_decimation);
     loopback_fifo_wenabled <= loopback_fifo_wenabled_i;
 
     set_timestamp_reset : process(rx_clock, rx_reset)
@@ -238,19 +267,21 @@ begin
 
             usb_speed           =>  usb_speed,
             meta_en             =>  meta_en,
+            meta_msg_log2       =>  meta_msg_log2,
             packet_en           =>  packet_en,
             timestamp           =>  rx_timestamp,
             mini_exp            =>  mini_exp,
 
             fifo_full           =>  sample_fifo.wfull,
             fifo_usedw          =>  sample_fifo.wused,
-            fifo_data           =>  sample_fifo.wdata,
-            fifo_write          =>  sample_fifo.wreq,
+            fifo_data           =>  unpacked_wdata,
+            fifo_write          =>  unpacked_wreq,
 
             packet_control      =>  packet_control,
             packet_ready        =>  packet_ready,
 
             eight_bit_mode_en   => eight_bit_mode_en,
+            packed_en           => packed_en,
 
             meta_fifo_full      =>  meta_fifo.wfull,
             meta_fifo_usedw     =>  meta_fifo.wused,
@@ -258,13 +289,35 @@ begin
             meta_fifo_write     =>  meta_fifo.wreq,
 
             in_sample_controls  =>  adc_controls,
-            in_samples          =>  mux_streams,
+            in_samples          =>  gated_streams,
 
             overflow_led        =>  rx_overflow_led,
-            overflow_count      =>  open,
+            overflow_count      =>  rx_overflow_count,
+            overflow_time       =>  rx_overflow_time,
             overflow_duration   =>  x"ffff"
         );
 
+    -- Pack to 12-bit samples on the way into the sample FIFO
+    U_rx_sample_packer : entity work.rx_sample_packer
+        generic map (
+            FIFO_DATA_WIDTH     =>  sample_fifo.wdata'length
+        )
+        port map (
+            clock               =>  rx_clock,
+            reset               =>  rx_reset,
+            clear               =>  not rx_enable,
+
+            packed_en           =>  packed_en,
+            meta_en             =>  meta_en,
+            usb_speed           =>  usb_speed,
+
+            in_data             =>  unpacked_wdata,
+            in_write            =>  unpacked_wreq,
+
+            out_data            =>  sample_fifo.wdata,
+            out_write           =>  sample_fifo.wreq
+        );
+
 
     loopback_fifo_control : process( rx_reset, loopback_fifo.rclock )
         variable offset     : natural range 0 to loopback_fifo.rdata'length;
@@ -399,6 +452,47 @@ begin
     end process;
 
 
+    -- Optional NCO mix and decimation ahead of the sample FIFO
+    generate_channelizers : for i in mux_streams'range generate
+        U_rx_channelizer : entity work.rx_channelizer
+            generic map (
+                STAGES          =>  4,
+                MAX_LOG2_RATE   =>  RX_DECIM_MAX_LOG2
+            )
+            port map (
+                clock           =>  rx_clock,
+                reset           =>  rx_reset,
+                log2_rate       =>  rx_decim_log2,
+                nco_dphase      =>  rx_nco_dphase,
+                in_sample       =>  mux_streams(i),
+                out_sample      =>  chan_streams(i)
+            );
+    end generate;
+
+
+    -- Hold samples back from the host until a scheduled timestamp
+    U_rx_gate : entity work.rx_gate
+        generic map (
+            NUM_STREAMS         =>  NUM_STREAMS
+        )
+        port map (
+            clock               =>  rx_clock,
+            reset               =>  rx_reset,
+
+            wb_adr_i            =>  gate_wb_adr_i,
+            wb_dat_i            =>  gate_wb_dat_i,
+            wb_dat_o            =>  gate_wb_dat_o,
+            wb_we_i             =>  gate_wb_we_i,
+            wb_cyc_i            =>  gate_wb_cyc_i,
+            wb_ack_o            =>  gate_wb_ack_o,
+
+            timestamp           =>  rx_timestamp,
+
+            in_samples          =>  chan_streams,
+            out_samples         =>  gated_streams
+        );
+
+
     -- RX Trigger
     rxtrig : entity work.trigger(async)
         generic map (
@@ -39,6 +39,8 @@ entity tx is
         timestamp_reset      : out   std_logic := '1';
         usb_speed            : in    std_logic;
         tx_underflow_led     : out   std_logic := '1';
+        tx_underflow_count   : out   unsigned(63 downto 0) := (others => '0');
+        tx_underflow_time    : out   unsigned(63 downto 0) := (others => '0');
         tx_timestamp         : in    unsigned(63 downto 0);
 
         -- Triggering
@@ -50,6 +52,9 @@ entity tx is
         -- 8-bit mode
         eight_bit_mode_en    : in std_logic := '0';
 
+        -- 12-bit packed samples
+        packed_en            : in    std_logic := '0';
+
         -- Packet from host via FX3
         packet_en            : in    std_logic;
         packet_empty         : out   std_logic;
@@ -80,6 +85,14 @@ entity tx is
         loopback_fifo_wfull  : in    std_logic;
         loopback_fifo_wused  : in    std_logic_vector(LOOPBACK_FIFO_T_DEFAULT.wused'range);
 
+        -- Waveform player Wishbone slave, clocked by tx_clock
+        wave_wb_adr_i        : in    std_logic_vector(31 downto 0) := (others => '0');
+        wave_wb_dat_i        : in    std_logic_vector(31 downto 0) := (others => '0');
+        wave_wb_dat_o        : out   std_logic_vector(31 downto 0) := (others => '0');
+        wave_wb_we_i         : in    std_logic := '0';
+        wave_wb_cyc_i        : in    std_logic := '0';
+        wave_wb_ack_o        : out   std_logic := '0';
+
         -- RFFE Interface
         dac_controls         : in    sample_controls_t(0 to NUM_STREAMS-1) := (others => SAMPLE_CONTROL_DISABLE);
         dac_streams          : out   sample_streams_t(0 to NUM_STREAMS-1)  := (others => ZERO_SAMPLE)
@@ -95,9 +108,18 @@ architecture arch of tx is
     signal trigger_line_sync              : std_logic;
     signal sample_fifo_rempty_untriggered : std_logic;
 
+    signal packed_fifo_rdata              : std_logic_vector(sample_fifo.rdata'range);
+    signal packed_fifo_rreq               : std_logic;
+    signal packed_fifo_rempty             : std_logic;
+
     signal sample_fifo_holdoff            : std_logic;
     signal sample_fifo_holdoff_i          : std_logic;
 
+    signal fifo_streams                   : sample_streams_t(dac_streams'range) := (others => ZERO_SAMPLE);
+    signal filled_streams                 : sample_streams_t(dac_streams'range) := (others => ZERO_SAMPLE);
+    signal wave_streams                   : sample_streams_t(dac_streams'range) := (others => ZERO_SAMPLE);
+    signal wave_active                    : std_logic;
+
 begin
 
     set_timestamp_reset : process(tx_clock, tx_reset)
@@ -130,13 +152,35 @@ begin
             wrusedw             => sample_fifo_wused,
 
             rdclk               => sample_fifo.rclock,
-            rdreq               => sample_fifo.rreq,
-            q                   => sample_fifo.rdata,
-            rdempty             => sample_fifo_rempty_untriggered,
+            rdreq               => packed_fifo_rreq,
+            q                   => packed_fifo_rdata,
+            rdempty             => packed_fifo_rempty,
             rdfull              => sample_fifo.rfull,
             rdusedw             => sample_fifo.rused
         );
 
+    -- Unpack 12-bit samples on the way out of the sample FIFO
+    U_tx_sample_unpacker : entity work.tx_sample_unpacker
+        generic map (
+            FIFO_DATA_WIDTH     =>  sample_fifo.rdata'length
+        )
+        port map (
+            clock               =>  tx_clock,
+            reset               =>  tx_reset,
+
+            packed_en           =>  packed_en,
+            meta_en             =>  meta_en,
+            usb_speed           =>  usb_speed,
+
+            in_data             =>  packed_fifo_rdata,
+            in_empty            =>  packed_fifo_rempty,
+            in_read             =>  packed_fifo_rreq,
+
+            out_data            =>  sample_fifo.rdata,
+            out_empty           =>  sample_fifo_rempty_untriggered,
+            out_read            =>  sample_fifo.rreq
+        );
+
     -- TX metadata fifo
     meta_fifo.aclr   <= tx_reset;
     meta_fifo.rclock <= tx_clock;
@@ -218,6 +262,7 @@ begin
             timestamp           =>  tx_timestamp,
 
             eight_bit_mode_en   =>  eight_bit_mode_en,
+            packed_en           =>  packed_en,
 
             fifo_empty          =>  sample_fifo.rempty,
             fifo_usedw          =>  sample_fifo.rused,
@@ -235,13 +280,51 @@ begin
             meta_fifo_read      =>  meta_fifo.rreq,
 
             in_sample_controls  =>  dac_controls,
-            out_samples         =>  dac_streams,
+            out_samples         =>  fifo_streams,
 
             underflow_led       =>  tx_underflow_led,
-            underflow_count     =>  open,
+            underflow_count     =>  tx_underflow_count,
+            underflow_time      =>  tx_underflow_time,
             underflow_duration  =>  x"ffff"
         );
 
+    -- Return the DAC to zero between timestamped bursts
+    U_tx_idle_fill : entity work.tx_idle_fill
+        generic map (
+            NUM_STREAMS         =>  NUM_STREAMS
+        )
+        port map (
+            clock               =>  tx_clock,
+            reset               =>  tx_reset,
+            enable              =>  meta_en and not packet_en,
+
+            in_samples          =>  fifo_streams,
+            out_samples         =>  filled_streams
+        );
+
+    -- Looped waveform playback from block RAM, loaded through Wishbone
+    U_tx_wave_player : entity work.tx_wave_player
+        generic map (
+            NUM_STREAMS         =>  NUM_STREAMS
+        )
+        port map (
+            clock               =>  tx_clock,
+            reset               =>  tx_reset,
+
+            wb_adr_i            =>  wave_wb_adr_i,
+            wb_dat_i            =>  wave_wb_dat_i,
+            wb_dat_o            =>  wave_wb_dat_o,
+            wb_we_i             =>  wave_wb_we_i,
+            wb_cyc_i            =>  wave_wb_cyc_i,
+            wb_ack_o            =>  wave_wb_ack_o,
+
+            active              =>  wave_active,
+            in_sample_controls  =>  dac_controls,
+            out_samples         =>  wave_streams
+        );
+
+    dac_streams <= wave_streams when wave_active = '1' else filled_streams;
+
     txtrig : entity work.trigger(async)
         generic map (
             DEFAULT_OUTPUT  => '1'
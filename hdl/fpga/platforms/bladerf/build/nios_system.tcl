@@ -386,6 +386,10 @@ set_instance_parameter_value tx_trigger_ctl {width} {8}
 
 add_instance vctcxo_tamer_0 vctcxo_tamer 1.0
 
+add_instance wishbone_master_0 wishbone_master 1.0
+set_instance_parameter_value wishbone_master_0 {ADDR_BITS} {32}
+set_instance_parameter_value wishbone_master_0 {DATA_BITS} {32}
+
 add_instance xb_gpio altera_avalon_pio
 set_instance_parameter_value xb_gpio {bitClearingEdgeCapReg} {0}
 set_instance_parameter_value xb_gpio {bitModifyingOutReg} {0}
@@ -455,6 +459,8 @@ add_interface tx_trigger_ctl conduit end
 set_interface_property tx_trigger_ctl EXPORT_OF tx_trigger_ctl.external_connection
 add_interface vctcxo_tamer conduit end
 set_interface_property vctcxo_tamer EXPORT_OF vctcxo_tamer_0.conduit_end
+add_interface wbm conduit end
+set_interface_property wbm EXPORT_OF wishbone_master_0.conduit_end
 add_interface xb_gpio conduit end
 set_interface_property xb_gpio EXPORT_OF xb_gpio.external_connection
 add_interface xb_gpio_dir conduit end
@@ -571,6 +577,11 @@ set_connection_parameter_value nios2.data_master/vctcxo_tamer_0.avalon_slave_0 a
 set_connection_parameter_value nios2.data_master/vctcxo_tamer_0.avalon_slave_0 baseAddress {0x9300}
 set_connection_parameter_value nios2.data_master/vctcxo_tamer_0.avalon_slave_0 defaultConnection {0}
 
+add_connection nios2.data_master wishbone_master_0.avalon_slave_0
+set_connection_parameter_value nios2.data_master/wishbone_master_0.avalon_slave_0 arbitrationPriority {1}
+set_connection_parameter_value nios2.data_master/wishbone_master_0.avalon_slave_0 baseAddress {0x10000000}
+set_connection_parameter_value nios2.data_master/wishbone_master_0.avalon_slave_0 defaultConnection {0}
+
 add_connection nios2.data_master xb_gpio.s1
 set_connection_parameter_value nios2.data_master/xb_gpio.s1 arbitrationPriority {1}
 set_connection_parameter_value nios2.data_master/xb_gpio.s1 baseAddress {0x90b0}
@@ -615,6 +626,9 @@ set_connection_parameter_value nios2.irq/tx_tamer.interrupt_sender irqNumber {2}
 add_connection nios2.irq vctcxo_tamer_0.interrupt_sender
 set_connection_parameter_value nios2.irq/vctcxo_tamer_0.interrupt_sender irqNumber {0}
 
+add_connection nios2.irq wishbone_master_0.interrupt_sender
+set_connection_parameter_value nios2.irq/wishbone_master_0.interrupt_sender irqNumber {8}
+
 add_connection system_clock.clk agc_dc_i_max.clk
 
 add_connection system_clock.clk agc_dc_i_mid.clk
@@ -659,6 +673,8 @@ add_connection system_clock.clk tx_trigger_ctl.clk
 
 add_connection system_clock.clk vctcxo_tamer_0.clock_sink
 
+add_connection system_clock.clk wishbone_master_0.clock_sink
+
 add_connection system_clock.clk xb_gpio.clk
 
 add_connection system_clock.clk xb_gpio_dir.clk
@@ -707,6 +723,8 @@ add_connection system_clock.clk_reset tx_trigger_ctl.reset
 
 add_connection system_clock.clk_reset vctcxo_tamer_0.reset_sink
 
+add_connection system_clock.clk_reset wishbone_master_0.reset
+
 add_connection system_clock.clk_reset xb_gpio.reset
 
 add_connection system_clock.clk_reset xb_gpio_dir.reset
@@ -7,8 +7,8 @@
 
 #define FPGA_VERSION_ID         0x7777
 #define FPGA_VERSION_MAJOR      0
-#define FPGA_VERSION_MINOR      14
-#define FPGA_VERSION_PATCH      0
+#define FPGA_VERSION_MINOR      16
+#define FPGA_VERSION_PATCH      9
 #define FPGA_VERSION ((uint32_t)( FPGA_VERSION_MAJOR        | \
                                  (FPGA_VERSION_MINOR << 8)  | \
                                  (FPGA_VERSION_PATCH << 16) ) )
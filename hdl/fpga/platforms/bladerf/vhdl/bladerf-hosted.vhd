@@ -105,6 +105,7 @@ architecture hosted_bladerf of bladerf is
     signal rx_sample_valid  : std_logic ;
 
     signal rx_samples       : sample_streams_t(0 to NUM_MIMO_STREAMS-1) := (others => ZERO_SAMPLE);
+    signal rx_gated_samples : sample_streams_t(0 to NUM_MIMO_STREAMS-1) := (others => ZERO_SAMPLE);
 
     signal rx_gen_mode      : std_logic ;
     signal rx_gen_i         : signed(15 downto 0) ;
@@ -126,6 +127,7 @@ architecture hosted_bladerf of bladerf is
     signal tx_sample_valid  : std_logic ;
 
     signal tx_samples       : sample_streams_t(0 to NUM_MIMO_STREAMS-1) := (others => ZERO_SAMPLE);
+    signal tx_filled_samples : sample_streams_t(0 to NUM_MIMO_STREAMS-1) := (others => ZERO_SAMPLE);
 
     signal fx3_gpif_in      : std_logic_vector(31 downto 0) ;
     signal fx3_gpif_out     : std_logic_vector(31 downto 0) ;
@@ -169,6 +171,32 @@ architecture hosted_bladerf of bladerf is
 
     constant FPGA_DC_CORRECTION :  signed(15 downto 0) := to_signed(integer(0), 16);
 
+    signal wbm_wb_adr_o     : std_logic_vector(31 downto 0);
+    signal wbm_wb_dat_o     : std_logic_vector(31 downto 0);
+    signal wbm_wb_dat_i     : std_logic_vector(31 downto 0);
+    signal wbm_wb_we_o      : std_logic;
+    signal wbm_wb_ack_i     : std_logic;
+    signal wbm_wb_cyc_o     : std_logic;
+
+    signal meter_wb_cyc     : std_logic;
+    signal meter_wb_dat     : std_logic_vector(31 downto 0);
+    signal meter_wb_ack     : std_logic;
+    signal gate_wb_cyc      : std_logic;
+    signal gate_wb_dat      : std_logic_vector(31 downto 0);
+    signal gate_wb_ack      : std_logic;
+    signal stats_wb_cyc     : std_logic;
+    signal stats_wb_dat     : std_logic_vector(31 downto 0);
+    signal stats_wb_ack     : std_logic;
+
+    signal rx_overflow_count    : unsigned(63 downto 0);
+    signal rx_overflow_time     : unsigned(63 downto 0);
+    signal tx_underflow_count   : unsigned(63 downto 0);
+    signal tx_underflow_time    : unsigned(63 downto 0);
+    signal tx_underflow_held    : std_logic_vector(127 downto 0);
+    signal tx_underflow_rx      : std_logic_vector(127 downto 0);
+    signal underflow_req        : std_logic;
+    signal underflow_ack        : std_logic;
+
     signal fx3_pclk_pll     :   std_logic ;
 
     signal timestamp_req    :   std_logic ;
@@ -195,6 +223,9 @@ architecture hosted_bladerf of bladerf is
 
     signal tx_trigger_arm_sync  :   std_logic ;
 
+    signal rx_trigger_tripped   :   std_logic ;
+    signal tx_trigger_tripped   :   std_logic ;
+
     -- Trigger Control readback interfaces
     signal rx_trigger_ctl_rb    : std_logic_vector(7 downto 0);
     signal tx_trigger_ctl_rb    : std_logic_vector(7 downto 0);
@@ -787,10 +818,11 @@ begin
         meta_fifo_write     =>  rx_meta_fifo.wreq,
 
         in_sample_controls  =>  (others => SAMPLE_CONTROL_ENABLE),
-        in_samples          =>  rx_samples,
+        in_samples          =>  rx_gated_samples,
 
         overflow_led        =>  rx_overflow_led,
-        overflow_count      =>  open,
+        overflow_count      =>  rx_overflow_count,
+        overflow_time       =>  rx_overflow_time,
         overflow_duration   =>  x"ffff"
       ) ;
 
@@ -815,6 +847,118 @@ begin
     rx_samples(0).data_q <= rx_sample_corrected_q;
     rx_samples(0).data_v <= rx_sample_corrected_valid;
 
+    -- The Nios Wishbone master reaches the RX power meter, the RX gate and
+    -- the stream statistics. Word address bits 14 and 13 select between
+    -- them and the rest of the address is not decoded, so the host uses the
+    -- same addresses as on the bladeRF 2.0 Micro.
+    wb_decode : process(all)
+    begin
+        meter_wb_cyc <= wbm_wb_cyc_o and not wbm_wb_adr_o(14);
+        gate_wb_cyc  <= wbm_wb_cyc_o and wbm_wb_adr_o(14) and not wbm_wb_adr_o(13);
+        stats_wb_cyc <= wbm_wb_cyc_o and wbm_wb_adr_o(14) and wbm_wb_adr_o(13);
+        wbm_wb_ack_i <= meter_wb_ack or gate_wb_ack or stats_wb_ack;
+        if( gate_wb_ack = '1' ) then
+            wbm_wb_dat_i <= gate_wb_dat;
+        elsif( stats_wb_ack = '1' ) then
+            wbm_wb_dat_i <= stats_wb_dat;
+        else
+            wbm_wb_dat_i <= meter_wb_dat;
+        end if;
+    end process;
+
+    -- DC, power and IQ imbalance measurements on the corrected RX samples
+    U_rx_power_meter : entity work.rx_power_meter
+      generic map (
+        NUM_STREAMS         => NUM_MIMO_STREAMS
+      ) port map (
+        clock               => rx_clock,
+        reset               => rx_reset,
+
+        wb_adr_i            => wbm_wb_adr_o,
+        wb_dat_i            => wbm_wb_dat_o,
+        wb_dat_o            => meter_wb_dat,
+        wb_we_i             => wbm_wb_we_o,
+        wb_cyc_i            => meter_wb_cyc,
+        wb_ack_o            => meter_wb_ack,
+
+        in_sample_controls  => (others => SAMPLE_CONTROL_ENABLE),
+        in_samples          => rx_samples
+      );
+
+    -- Hold samples back from the host until a scheduled timestamp
+    U_rx_gate : entity work.rx_gate
+      generic map (
+        NUM_STREAMS         => NUM_MIMO_STREAMS
+      ) port map (
+        clock               => rx_clock,
+        reset               => rx_reset,
+
+        wb_adr_i            => wbm_wb_adr_o,
+        wb_dat_i            => wbm_wb_dat_o,
+        wb_dat_o            => gate_wb_dat,
+        wb_we_i             => wbm_wb_we_o,
+        wb_cyc_i            => gate_wb_cyc,
+        wb_ack_o            => gate_wb_ack,
+
+        timestamp           => rx_timestamp,
+
+        in_samples          => rx_samples,
+        out_samples         => rx_gated_samples
+      );
+
+    -- Keep a copy of the TX underflow count and time in the RX clock
+    -- domain, taken while the handshake holds them steady
+    drive_underflow_handshake : process(rx_clock, rx_reset)
+    begin
+        if( rx_reset = '1' ) then
+            underflow_req   <= '0' ;
+            tx_underflow_rx <= (others => '0') ;
+        elsif( rising_edge(rx_clock) ) then
+            if( underflow_ack = '0' ) then
+                underflow_req <= '1' ;
+            else
+                if( underflow_req = '1' ) then
+                    tx_underflow_rx <= tx_underflow_held ;
+                end if ;
+                underflow_req <= '0' ;
+            end if ;
+        end if ;
+    end process ;
+
+    U_underflow_handshake : entity work.handshake
+      generic map (
+        DATA_WIDTH          =>  tx_underflow_rx'length
+      ) port map (
+        source_clock        =>  tx_clock,
+        source_reset        =>  tx_reset,
+        source_data         =>  std_logic_vector(tx_underflow_count & tx_underflow_time),
+
+        dest_clock          =>  rx_clock,
+        dest_reset          =>  rx_reset,
+        dest_data           =>  tx_underflow_held,
+        dest_req            =>  underflow_req,
+        dest_ack            =>  underflow_ack
+      ) ;
+
+    -- FIFO overflow and underflow counts for the host
+    U_stream_stats : entity work.stream_stats
+      port map (
+        clock               => rx_clock,
+        reset               => rx_reset,
+
+        wb_adr_i            => wbm_wb_adr_o,
+        wb_dat_i            => wbm_wb_dat_o,
+        wb_dat_o            => stats_wb_dat,
+        wb_we_i             => wbm_wb_we_o,
+        wb_cyc_i            => stats_wb_cyc,
+        wb_ack_o            => stats_wb_ack,
+
+        rx_overflow_count   => rx_overflow_count,
+        rx_overflow_time    => rx_overflow_time,
+        tx_underflow_count  => unsigned(tx_underflow_rx(127 downto 64)),
+        tx_underflow_time   => unsigned(tx_underflow_rx(63 downto 0))
+      );
+
     U_rx_iq_correction : entity work.iq_correction(rx)
       generic map(
         INPUT_WIDTH         => rx_sample_corrected_i'length
@@ -938,13 +1082,27 @@ begin
         out_samples         =>  tx_samples,
 
         underflow_led       =>  tx_underflow_led,
-        underflow_count     =>  open,
+        underflow_count     =>  tx_underflow_count,
+        underflow_time      =>  tx_underflow_time,
         underflow_duration  =>  x"ffff"
       ) ;
 
-    tx_sample_raw_i     <= tx_samples(0).data_i;
-    tx_sample_raw_q     <= tx_samples(0).data_q;
-    tx_sample_raw_valid <= tx_samples(0).data_v;
+    -- Return the DAC to zero between timestamped bursts
+    U_tx_idle_fill : entity work.tx_idle_fill
+      generic map (
+        NUM_STREAMS         => NUM_MIMO_STREAMS
+      ) port map (
+        clock               => tx_clock,
+        reset               => tx_reset,
+        enable              => meta_en_tx and not packet_en_tx,
+
+        in_samples          => tx_samples,
+        out_samples         => tx_filled_samples
+      );
+
+    tx_sample_raw_i     <= tx_filled_samples(0).data_i;
+    tx_sample_raw_q     <= tx_filled_samples(0).data_q;
+    tx_sample_raw_valid <= tx_filled_samples(0).data_v;
 
     U_tx_iq_correction : entity work.iq_correction(tx)
       generic map (
@@ -979,7 +1137,8 @@ begin
         trigger_in      => rx_trigger_line,
         trigger_out     => rx_trigger_line,
         signal_in       => lms_rx_enable_sig,
-        signal_out      => lms_rx_enable_qualified
+        signal_out      => lms_rx_enable_qualified,
+        tripped         => rx_trigger_tripped
       );
 
     rx_trigger_arm_rb             <= rx_trigger_arm;
@@ -1009,7 +1168,8 @@ begin
         trigger_in      => tx_trigger_line,
         trigger_out     => tx_trigger_line,
         signal_in       => tx_sample_fifo_rempty_untriggered,
-        signal_out      => tx_sample_fifo.rempty
+        signal_out      => tx_sample_fifo.rempty,
+        tripped         => tx_trigger_tripped
       );
 
     tx_trigger_arm_rb             <= tx_trigger_arm;
@@ -1183,13 +1343,13 @@ begin
         oc_i2c_sda_padoen_o             => i2c_sda_oen,
         oc_i2c_arst_i                   => '0',
         oc_i2c_scl_pad_i                => i2c_scl_in,
-        rx_tamer_ts_sync_in             => '0',
+        rx_tamer_ts_sync_in             => rx_trigger_tripped,
         rx_tamer_ts_sync_out            => open,
         rx_tamer_ts_pps                 => '0',
         rx_tamer_ts_clock               => rx_clock,
         rx_tamer_ts_reset               => rx_ts_reset,
         unsigned(rx_tamer_ts_time)      => rx_timestamp,
-        tx_tamer_ts_sync_in             => '0',
+        tx_tamer_ts_sync_in             => tx_trigger_tripped,
         tx_tamer_ts_sync_out            => open,
         tx_tamer_ts_pps                 => '0',
         tx_tamer_ts_clock               => tx_clock,
@@ -1209,7 +1369,17 @@ begin
         agc_dc_i_mid_export             => corr_dc_i_mid,
         agc_dc_q_mid_export             => corr_dc_q_mid,
         agc_dc_i_min_export             => corr_dc_i_min,
-        agc_dc_q_min_export             => corr_dc_q_min
+        agc_dc_q_min_export             => corr_dc_q_min,
+        wbm_wb_clk_i                    => rx_clock,
+        wbm_wb_rst_i                    => rx_reset,
+        wbm_wb_adr_o                    => wbm_wb_adr_o,
+        wbm_wb_dat_o                    => wbm_wb_dat_o,
+        wbm_wb_dat_i                    => wbm_wb_dat_i,
+        wbm_wb_we_o                     => wbm_wb_we_o,
+        wbm_wb_sel_o                    => open,
+        wbm_wb_stb_o                    => open,
+        wbm_wb_ack_i                    => wbm_wb_ack_i,
+        wbm_wb_cyc_o                    => wbm_wb_cyc_o
       ) ;
 
     -- Unpack the Nios general-purpose outputs into a record
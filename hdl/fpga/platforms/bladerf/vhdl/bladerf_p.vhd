@@ -104,7 +104,17 @@ package bladerf_p is
         agc_dc_i_min_export             :   out std_logic_vector(15 downto 0);
         agc_dc_q_max_export             :   out std_logic_vector(15 downto 0);
         agc_dc_q_mid_export             :   out std_logic_vector(15 downto 0);
-        agc_dc_q_min_export             :   out std_logic_vector(15 downto 0)
+        agc_dc_q_min_export             :   out std_logic_vector(15 downto 0);
+        wbm_wb_clk_i                    :   in  std_logic                     := '0';
+        wbm_wb_rst_i                    :   in  std_logic                     := '0';
+        wbm_wb_adr_o                    :   out std_logic_vector(31 downto 0);
+        wbm_wb_dat_o                    :   out std_logic_vector(31 downto 0);
+        wbm_wb_dat_i                    :   in  std_logic_vector(31 downto 0) := (others => '0');
+        wbm_wb_we_o                     :   out std_logic;
+        wbm_wb_sel_o                    :   out std_logic;
+        wbm_wb_stb_o                    :   out std_logic;
+        wbm_wb_ack_i                    :   in  std_logic                     := '0';
+        wbm_wb_cyc_o                    :   out std_logic
       );
     end component;
 
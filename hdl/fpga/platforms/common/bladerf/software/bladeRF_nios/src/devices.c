@@ -31,6 +31,7 @@
 #include <alt_types.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 /* Define a global variable containing the current VCTCXO DAC setting.
  * This is a 'cached' value of what is written to the DAC and is used
@@ -61,19 +62,54 @@ static void command_uart_enable_isr(bool enable)
     return;
 }
 
+/* Requests received by the command UART ISR that have yet to be handled by
+ * the main loop. This allows the next request to be accepted while the
+ * current one is being handled and its response drained. The ISR is the only
+ * writer of `tail`, and the main loop the only writer of `head`. */
+static struct {
+    uint8_t req[COMMAND_QUEUE_LEN][NIOS_PKT_LEN];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+} command_queue;
+
 static void command_uart_isr(void *context)
 {
-    struct pkt_buf *pkt = (struct pkt_buf *)context;
+    uint8_t discard[NIOS_PKT_LEN];
+    const uint8_t tail = command_queue.tail;
+
+    (void)context;
 
     /* Reading the request should clear the interrupt */
-    command_uart_read_request((uint8_t *)pkt->req);
+    if ((uint8_t)(tail - command_queue.head) == COMMAND_QUEUE_LEN) {
+        command_uart_read_request(discard);
+        DBG("Command queue full; dropping request 0x%x\n", discard[0]);
+    } else {
+        command_uart_read_request(
+            command_queue.req[tail % COMMAND_QUEUE_LEN]);
 
-    /* Tell the main loop that there is a request pending */
-    pkt->ready = true;
+        /* Tell the main loop that there is a request pending */
+        command_queue.tail = tail + 1;
+    }
 
     return;
 }
 
+bool command_uart_next_request(struct pkt_buf *pkt)
+{
+    const uint8_t head = command_queue.head;
+
+    if (head == command_queue.tail) {
+        return false;
+    }
+
+    memcpy((uint8_t *)pkt->req, command_queue.req[head % COMMAND_QUEUE_LEN],
+           NIOS_PKT_LEN);
+
+    command_queue.head = head + 1;
+
+    return true;
+}
+
 static void vctcxo_tamer_isr(void *context)
 {
     struct vctcxo_tamer_pkt_buf *pkt = (struct vctcxo_tamer_pkt_buf *)context;
@@ -261,7 +297,7 @@ void bladerf_nios_init(struct pkt_buf *pkt,
 
     /* Register Command UART ISR */
     alt_ic_isr_register(COMMAND_UART_IRQ_INTERRUPT_CONTROLLER_ID,
-                        COMMAND_UART_IRQ, command_uart_isr, pkt, NULL);
+                        COMMAND_UART_IRQ, command_uart_isr, NULL, NULL);
 
     /* Register the VCTCXO Tamer ISR */
     alt_ic_isr_register(VCTCXO_TAMER_0_IRQ_INTERRUPT_CONTROLLER_ID,
@@ -414,25 +450,21 @@ void adi_axi_write(uint16_t addr, uint32_t data)
 }
 #endif  // BOARD_BLADERF_MICRO
 
-#ifdef BOARD_BLADERF_MICRO
 uint32_t wishbone_master_read(uint32_t addr)
 {
     uint32_t data = 0;
-#ifdef WISHBONE_MASTER_0_BASE  // Temporary hack for bladeRF1 compat
+#ifdef WISHBONE_MASTER_0_BASE
     data = IORD_32DIRECT(WISHBONE_MASTER_0_BASE, addr);
 #endif
     return data;
 }
-#endif  // BOARD_BLADERF_MICRO
 
-#ifdef BOARD_BLADERF_MICRO
 void wishbone_master_write(uint32_t addr, uint32_t data)
 {
-#ifdef WISHBONE_MASTER_0_BASE  // Temporary hack for bladeRF1 compat
+#ifdef WISHBONE_MASTER_0_BASE
     IOWR_32DIRECT(WISHBONE_MASTER_0_BASE, addr, data);
 #endif
 }
-#endif  // BOARD_BLADERF_MICRO
 
 #ifdef BOARD_BLADERF_MICRO
 void adi_fastlock_save(bool is_tx, uint8_t rffe_profile, uint16_t nios_profile)
@@ -611,6 +643,46 @@ void adi_rfspdt_select(bladerf_module m, fastlock_profile *p)
 }
 #endif  // BOARD_BLADERF_MICRO
 
+#ifdef BOARD_BLADERF_MICRO
+void adi_gain_apply(bladerf_module m, uint8_t chan, uint16_t setting)
+{
+    static const uint16_t rx_full_gain_reg[2] = { 0x109, 0x10c };
+    static const uint16_t tx_atten_reg[2]     = { 0x074, 0x076 };
+    static const uint16_t tx_dig_atten_reg    = 0x07c;
+    static const uint8_t  immediate_update    = 0x40;
+    uint16_t addr;
+    uint64_t data;
+    uint8_t  dig_atten;
+
+    chan &= 0x1;
+
+    if (!BLADERF_CHANNEL_IS_TX(m)) {
+        /* Full gain table index, for manual gain control */
+        addr = (0x1 << 15) | (0x0 << 12) | (rx_full_gain_reg[chan] & 0x3ff);
+        data = (uint64_t)(setting & 0x7f) << 56;
+        adi_spi_write(addr, data);
+        return;
+    }
+
+    /* As the driver's ad9361_set_tx_atten(): hold off the attenuation update
+     * while both of its registers are written, then apply it immediately */
+    addr = (0x0 << 15) | (0x0 << 12) | (tx_dig_atten_reg & 0x3ff);
+    dig_atten = (adi_spi_read(addr) >> 56) & ~immediate_update;
+
+    addr = (0x1 << 15) | (0x0 << 12) | (tx_dig_atten_reg & 0x3ff);
+    adi_spi_write(addr, (uint64_t)dig_atten << 56);
+
+    /* Attenuation bit 8, then bits [7:0] in the register below it */
+    addr = (0x1 << 15) | (0x1 << 12) | (tx_atten_reg[chan] & 0x3ff);
+    data = ((uint64_t)((setting >> 8) & 0x1) << 56) |
+           ((uint64_t)(setting & 0xff) << 48);
+    adi_spi_write(addr, data);
+
+    addr = (0x1 << 15) | (0x0 << 12) | (tx_dig_atten_reg & 0x3ff);
+    adi_spi_write(addr, (uint64_t)(dig_atten | immediate_update) << 56);
+}
+#endif  // BOARD_BLADERF_MICRO
+
 uint8_t si5338_read(uint8_t addr)
 {
     uint8_t data;
@@ -917,6 +989,28 @@ void agc_dc_corr_write(uint16_t addr, uint16_t value)
 #endif  // AGC_DC_I_MIN_BASE
 }
 
+bool time_tamer_read_sync(bladerf_module m, uint64_t *time, bool *second_half)
+{
+    uint32_t base  = (m == BLADERF_MODULE_RX) ? RX_TAMER_BASE : TX_TAMER_BASE;
+    uint8_t offset = 10;
+    uint8_t status;
+    uint8_t i;
+
+    status = IORD_8DIRECT(base, 9);
+    if ((status & 0x2) == 0) {
+        return false;
+    }
+
+    *time = 0;
+    for (i = 0; i < 8; i++) {
+        *time |= ((uint64_t)IORD_8DIRECT(base, offset++)) << (8 * i);
+    }
+
+    *second_half = (status & 0x4) != 0;
+
+    return true;
+}
+
 uint64_t time_tamer_read(bladerf_module m)
 {
     uint32_t base  = (m == BLADERF_MODULE_RX) ? RX_TAMER_BASE : TX_TAMER_BASE;
@@ -268,6 +268,16 @@ void adi_rfport_select(fastlock_profile *p);
  */
 void adi_rfspdt_select(bladerf_module m, fastlock_profile *p);
 
+/**
+ * Set an AD9361 channel's gain.
+ *
+ * @param m        Which module's gain to set.
+ * @param chan     RFIC channel index (0 or 1)
+ * @param setting  RX: full gain table index, for manual gain control.
+ *                 TX: attenuation, in 0.25 dB steps.
+ */
+void adi_gain_apply(bladerf_module m, uint8_t chan, uint16_t setting);
+
 /**
  * Read from Si5338 clock generator register
  *
@@ -449,6 +459,18 @@ INLINE void expansion_port_set_direction(uint32_t dir);
  */
 uint64_t time_tamer_read(bladerf_module m);
 
+/**
+ * Read the time at which a time tamer's sync input last rose, which is
+ * connected to the trigger on FPGA images that support it
+ *
+ * @param[in]   m           Module
+ * @param[out]  time        Timestamp in effect when the input rose
+ * @param[out]  second_half Set if it rose in the second half of the sample
+ *
+ * @return true if the input has risen since the timestamp counter was reset
+ */
+bool time_tamer_read_sync(bladerf_module m, uint64_t *time, bool *second_half);
+
 /**
  * Reset one of the time tamer's timestamp counters to 0
  */
@@ -478,6 +500,21 @@ INLINE void command_uart_read_request(uint8_t *command);
  */
 INLINE void command_uart_write_response(uint8_t *command);
 
+/**
+ * Number of requests the command UART ISR may hold for the main loop. Must
+ * be a power of two.
+ */
+#define COMMAND_QUEUE_LEN 4
+
+/**
+ * Take the oldest request received by the command UART
+ *
+ * @param   pkt     Packet buffer to copy the request into
+ *
+ * @return true if a request was pending, false otherwise
+ */
+bool command_uart_next_request(struct pkt_buf *pkt);
+
 /**
  * Enable interrupts from the VCTCXO Tamer module
  *
@@ -617,6 +654,16 @@ bool rfic_command_write(uint16_t addr, uint64_t data);
  * @return bool (true = success)
  */
 bool rfic_command_read(uint16_t addr, uint64_t *data);
+
+/**
+ * Number of commands in the RFIC write queue
+ */
+uint8_t rfic_command_queue_length(void);
+
+/**
+ * Capacity of the RFIC write queue
+ */
+uint8_t rfic_command_queue_capacity(void);
 #endif  // BLADERF_NIOS_LIBAD936X
 
 /* A number of rountines define here are implemented as just a register
@@ -77,6 +77,22 @@ static inline void rffe_csr_write(uint32_t value)
     #endif
 }
 
+static inline uint32_t rx_decim_ctl_read(void)
+{
+    #ifdef RX_DECIM_CTL_BASE
+    return IORD_ALTERA_AVALON_PIO_DATA(RX_DECIM_CTL_BASE);
+    #else
+    return 0;
+    #endif
+}
+
+static inline void rx_decim_ctl_write(uint32_t value)
+{
+    #ifdef RX_DECIM_CTL_BASE
+    IOWR_ALTERA_AVALON_PIO_DATA(RX_DECIM_CTL_BASE, value);
+    #endif
+}
+
 static inline uint32_t expansion_port_read(void)
 {
     return IORD_ALTERA_AVALON_PIO_DATA(XB_GPIO_BASE);
@@ -144,6 +144,37 @@ struct rfic_command_fns const funcs[] = {
         FIELD_INIT(.bitmask,
             RFIC_CMD_INIT_REQD | RFIC_CMD_CHAN_TX | RFIC_CMD_CHAN_RX),
     },
+    {
+        FIELD_INIT(.command, BLADERF_RFIC_COMMAND_RFPORT),
+        FIELD_INIT(.write32, _rfic_cmd_wr_rfport),
+        FIELD_INIT(.read32, _rfic_cmd_rd_rfport),
+        FIELD_INIT(.bitmask,
+            RFIC_CMD_INIT_REQD | RFIC_CMD_CHAN_TX | RFIC_CMD_CHAN_RX),
+    },
+    {
+        FIELD_INIT(.command, BLADERF_RFIC_COMMAND_TEMPERATURE),
+        FIELD_INIT(.read32, _rfic_cmd_rd_temperature),
+        FIELD_INIT(.bitmask, RFIC_CMD_INIT_REQD | RFIC_CMD_CHAN_SYSTEM),
+    },
+    {
+        FIELD_INIT(.command, BLADERF_RFIC_COMMAND_FASTLOCK_SAVE),
+        FIELD_INIT(.write32, _rfic_cmd_wr_fastlock_save),
+        FIELD_INIT(.bitmask,
+            RFIC_CMD_INIT_REQD | RFIC_CMD_CHAN_TX | RFIC_CMD_CHAN_RX),
+    },
+    {
+        FIELD_INIT(.command, BLADERF_RFIC_COMMAND_FASTLOCK_LOAD),
+        FIELD_INIT(.write32, _rfic_cmd_wr_fastlock_load),
+        FIELD_INIT(.bitmask,
+            RFIC_CMD_INIT_REQD | RFIC_CMD_CHAN_TX | RFIC_CMD_CHAN_RX),
+    },
+    {
+        FIELD_INIT(.command, BLADERF_RFIC_COMMAND_FASTLOCK_DATA),
+        FIELD_INIT(.write64, _rfic_cmd_wr_fastlock_data),
+        FIELD_INIT(.read64, _rfic_cmd_rd_fastlock_data),
+        FIELD_INIT(.bitmask,
+            RFIC_CMD_INIT_REQD | RFIC_CMD_CHAN_TX | RFIC_CMD_CHAN_RX),
+    },
     // clang-format on
 };
 
@@ -319,6 +350,16 @@ bool rfic_command_write_immed(bladerf_rfic_command cmd,
     return rv;
 }
 
+uint8_t rfic_command_queue_length(void)
+{
+    return state.write_queue.count;
+}
+
+uint8_t rfic_command_queue_capacity(void)
+{
+    return COMMAND_QUEUE_MAX;
+}
+
 bool rfic_command_read(uint16_t addr, uint64_t *data)
 {
     return rfic_command_read_immed(_rfic_unpack_cmd(addr),
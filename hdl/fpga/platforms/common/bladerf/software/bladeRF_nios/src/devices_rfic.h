@@ -69,6 +69,11 @@ struct rfic_state {
 
     /* TX mute state at standby */
     bool tx_mute_state[2];
+
+    /* Fastlock profile buffers, and the next word to transfer, per direction
+     * (see BLADERF_RFIC_COMMAND_FASTLOCK_DATA) */
+    uint8_t fastlock_data[NUM_MODULES][BLADERF_RFIC_FASTLOCK_PROFILE_LEN];
+    uint8_t fastlock_index[NUM_MODULES];
 };
 
 
@@ -199,7 +204,7 @@ static inline uint8_t _rfic_unpack_chan(uint16_t addr)
 
 static inline uint8_t _rfic_unpack_cmd(uint16_t addr)
 {
-    return addr & 0xF;
+    return addr & 0xFF;
 }
 
 static inline char const *_rfic_cmdstr(uint8_t cmd)
@@ -241,6 +246,21 @@ static inline char const *_rfic_cmdstr(uint8_t cmd)
         case BLADERF_RFIC_COMMAND_FASTLOCK:
             return "FASTLOCK";
 
+        case BLADERF_RFIC_COMMAND_RFPORT:
+            return "RFPORT  ";
+
+        case BLADERF_RFIC_COMMAND_TEMPERATURE:
+            return "TEMP    ";
+
+        case BLADERF_RFIC_COMMAND_FASTLOCK_SAVE:
+            return "FLSAVE  ";
+
+        case BLADERF_RFIC_COMMAND_FASTLOCK_LOAD:
+            return "FLLOAD  ";
+
+        case BLADERF_RFIC_COMMAND_FASTLOCK_DATA:
+            return "FLDATA  ";
+
         default:
             return "        ";
     }
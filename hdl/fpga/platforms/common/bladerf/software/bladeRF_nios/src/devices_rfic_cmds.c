@@ -285,6 +285,13 @@ bool _rfic_cmd_rd_status(struct rfic_state *state,
               ((state->write_queue.count & BLADERF_RFIC_STATUS_WQLEN_MASK)
                << BLADERF_RFIC_STATUS_WQLEN_SHIFT) |
 
+              (((uint64_t)COMMAND_QUEUE_MAX & BLADERF_RFIC_STATUS_WQMAX_MASK)
+               << BLADERF_RFIC_STATUS_WQMAX_SHIFT) |
+
+              /* AD9361 batch packets are handled (see pkt_ad9361_batch.c) */
+              ((UINT64_C(1) & BLADERF_RFIC_STATUS_SPIBATCH_MASK)
+               << BLADERF_RFIC_STATUS_SPIBATCH_SHIFT) |
+
               ((state->write_queue.last_rv & BLADERF_RFIC_STATUS_WQSUCCESS_MASK)
                << BLADERF_RFIC_STATUS_WQSUCCESS_SHIFT);
 
@@ -1017,4 +1024,174 @@ bool _rfic_cmd_wr_fastlock(struct rfic_state *state,
     return true;
 }
 
+/**
+ * @brief       Select the RF port for a channel
+ *
+ * @param[in]   channel  The channel
+ * @param[in]   port     The AD9361 RF port ID
+ *
+ * @return      true if successful, false if not
+ */
+bool _rfic_cmd_wr_rfport(struct rfic_state *state,
+                         bladerf_channel channel,
+                         uint32_t port)
+{
+    if (BLADERF_CHANNEL_IS_TX(channel)) {
+        CHECK_BOOL(ad9361_set_tx_rf_port_output(state->phy, port));
+    } else {
+        CHECK_BOOL(ad9361_set_rx_rf_port_input(state->phy, port));
+    }
+
+    return true;
+}
+
+/**
+ * @brief       Get the RF port for a channel
+ *
+ * @param[in]   channel  The channel
+ * @param[out]  port     The AD9361 RF port ID
+ *
+ * @return      true if successful, false if not
+ */
+bool _rfic_cmd_rd_rfport(struct rfic_state *state,
+                         bladerf_channel channel,
+                         uint32_t *port)
+{
+    if (BLADERF_CHANNEL_IS_TX(channel)) {
+        CHECK_BOOL(ad9361_get_tx_rf_port_output(state->phy, port));
+    } else {
+        CHECK_BOOL(ad9361_get_rx_rf_port_input(state->phy, port));
+    }
+
+    return true;
+}
+
+/**
+ * @brief       Get the RFIC temperature
+ *
+ * @param[in]   channel      The channel (ignored)
+ * @param[out]  temperature  Temperature in millidegrees Celsius
+ *
+ * @return      true if successful, false if not
+ */
+bool _rfic_cmd_rd_temperature(struct rfic_state *state,
+                              bladerf_channel channel,
+                              uint32_t *temperature)
+{
+    *temperature = (uint32_t)ad9361_get_temp(state->phy);
+
+    return true;
+}
+
+/**
+ * @brief       Read a fastlock profile into the profile buffer
+ *
+ * @param[in]   channel  The channel
+ * @param[in]   profile  The profile number
+ *
+ * @return      true if successful, false if not
+ */
+bool _rfic_cmd_wr_fastlock_save(struct rfic_state *state,
+                                bladerf_channel channel,
+                                uint32_t profile)
+{
+    size_t const dir = BLADERF_CHANNEL_IS_TX(channel) ? BLADERF_TX : BLADERF_RX;
+
+    state->fastlock_index[dir] = 0;
+
+    if (BLADERF_CHANNEL_IS_TX(channel)) {
+        CHECK_BOOL(ad9361_tx_fastlock_save(state->phy, profile,
+                                           state->fastlock_data[dir]));
+    } else {
+        CHECK_BOOL(ad9361_rx_fastlock_save(state->phy, profile,
+                                           state->fastlock_data[dir]));
+    }
+
+    return true;
+}
+
+/**
+ * @brief       Write the profile buffer into a fastlock profile
+ *
+ * @param[in]   channel  The channel
+ * @param[in]   profile  The profile number
+ *
+ * @return      true if successful, false if not
+ */
+bool _rfic_cmd_wr_fastlock_load(struct rfic_state *state,
+                                bladerf_channel channel,
+                                uint32_t profile)
+{
+    size_t const dir = BLADERF_CHANNEL_IS_TX(channel) ? BLADERF_TX : BLADERF_RX;
+
+    state->fastlock_index[dir] = 0;
+
+    if (BLADERF_CHANNEL_IS_TX(channel)) {
+        CHECK_BOOL(ad9361_tx_fastlock_load(state->phy, profile,
+                                           state->fastlock_data[dir]));
+    } else {
+        CHECK_BOOL(ad9361_rx_fastlock_load(state->phy, profile,
+                                           state->fastlock_data[dir]));
+    }
+
+    return true;
+}
+
+/* Number of 8-byte words in a fastlock profile buffer */
+#define FASTLOCK_DATA_WORDS (BLADERF_RFIC_FASTLOCK_PROFILE_LEN / 8)
+
+/**
+ * @brief       Write the next word of the profile buffer
+ *
+ * @param[in]   channel  The channel
+ * @param[in]   data     8 bytes of profile data, first in the LSBs
+ *
+ * @return      true if successful, false if not
+ */
+bool _rfic_cmd_wr_fastlock_data(struct rfic_state *state,
+                                bladerf_channel channel,
+                                uint64_t data)
+{
+    size_t const dir = BLADERF_CHANNEL_IS_TX(channel) ? BLADERF_TX : BLADERF_RX;
+    uint8_t *buf = &state->fastlock_data[dir][state->fastlock_index[dir] * 8];
+    size_t i;
+
+    for (i = 0; i < 8; ++i) {
+        buf[i] = (uint8_t)(data >> (i * 8));
+    }
+
+    state->fastlock_index[dir] = (state->fastlock_index[dir] + 1) %
+                                 FASTLOCK_DATA_WORDS;
+
+    return true;
+}
+
+/**
+ * @brief       Read the next word of the profile buffer
+ *
+ * @param[in]   channel  The channel
+ * @param[out]  data     8 bytes of profile data, first in the LSBs
+ *
+ * @return      true if successful, false if not
+ */
+bool _rfic_cmd_rd_fastlock_data(struct rfic_state *state,
+                                bladerf_channel channel,
+                                uint64_t *data)
+{
+    size_t const dir = BLADERF_CHANNEL_IS_TX(channel) ? BLADERF_TX : BLADERF_RX;
+    uint8_t *buf = &state->fastlock_data[dir][state->fastlock_index[dir] * 8];
+    size_t i;
+
+    *data = 0;
+
+    for (i = 0; i < 8; ++i) {
+        *data |= (uint64_t)buf[i] << (i * 8);
+    }
+
+    state->fastlock_index[dir] = (state->fastlock_index[dir] + 1) %
+                                 FASTLOCK_DATA_WORDS;
+
+    return true;
+}
+
 #endif  // defined(BOARD_BLADERF_MICRO) && defined(BLADERF_NIOS_LIBAD936X)
@@ -74,4 +74,20 @@ bool _rfic_cmd_rd_txmute(struct rfic_state *, bladerf_channel, uint32_t *);
 
 bool _rfic_cmd_wr_fastlock(struct rfic_state *, bladerf_channel, uint32_t);
 
+bool _rfic_cmd_wr_rfport(struct rfic_state *, bladerf_channel, uint32_t);
+
+bool _rfic_cmd_rd_rfport(struct rfic_state *, bladerf_channel, uint32_t *);
+
+bool _rfic_cmd_rd_temperature(struct rfic_state *, bladerf_channel, uint32_t *);
+
+bool _rfic_cmd_wr_fastlock_save(struct rfic_state *, bladerf_channel, uint32_t);
+
+bool _rfic_cmd_wr_fastlock_load(struct rfic_state *, bladerf_channel, uint32_t);
+
+bool _rfic_cmd_wr_fastlock_data(struct rfic_state *, bladerf_channel, uint64_t);
+
+bool _rfic_cmd_rd_fastlock_data(struct rfic_state *,
+                                bladerf_channel,
+                                uint64_t *);
+
 #endif  // BLADERF_NIOS_DEVICES_RFIC_CMDS_H_
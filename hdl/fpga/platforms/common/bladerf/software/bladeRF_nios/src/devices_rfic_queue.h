@@ -25,7 +25,23 @@
 #ifndef BLADERF_NIOS_DEVICES_RFIC_QUEUE_H_
 #define BLADERF_NIOS_DEVICES_RFIC_QUEUE_H_
 
+/* Depth of the write queue. This may be overridden at build time (e.g.,
+ * -DCOMMAND_QUEUE_MAX=64), and is reported to the host via the RFIC status
+ * command. It must be a power of two, and small enough that the queue count
+ * fits in the status register's 8-bit field without colliding with the
+ * COMMAND_QUEUE_FULL/COMMAND_QUEUE_EMPTY return values. */
+#ifndef COMMAND_QUEUE_MAX
 #define COMMAND_QUEUE_MAX 16
+#endif
+
+#if (COMMAND_QUEUE_MAX & (COMMAND_QUEUE_MAX - 1)) != 0
+#error "COMMAND_QUEUE_MAX must be a power of two"
+#endif
+
+#if COMMAND_QUEUE_MAX < 1 || COMMAND_QUEUE_MAX > 128
+#error "COMMAND_QUEUE_MAX must be between 1 and 128"
+#endif
+
 #define COMMAND_QUEUE_FULL 0xff
 #define COMMAND_QUEUE_EMPTY 0xfe
 
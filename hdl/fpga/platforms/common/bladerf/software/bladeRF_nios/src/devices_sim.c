@@ -273,6 +273,16 @@ uint64_t time_tamer_read(bladerf_module m)
     return ret;
 }
 
+bool time_tamer_read_sync(bladerf_module m, uint64_t *time, bool *second_half)
+{
+    DBG("%s: module=%s\n", __FUNCTION__, module2str(m));
+
+    *time = time_tamer_read(m) - 0x1000;
+    *second_half = false;
+
+    return true;
+}
+
 void time_tamer_reset(bladerf_module m)
 {
     switch (m) {
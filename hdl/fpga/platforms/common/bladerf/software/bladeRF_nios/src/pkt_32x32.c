@@ -59,11 +59,11 @@ static inline bool perform_write(uint8_t id, uint32_t addr, uint32_t data)
         case NIOS_PKT_32x32_TARGET_ADI_AXI:
             adi_axi_write(addr, data);
             break;
+#endif  // BOARD_BLADERF_MICRO
 
         case NIOS_PKT_32x32_TARGET_WB_MSTR:
             wishbone_master_write(addr, data);
             break;
-#endif  // BOARD_BLADERF_MICRO
 
         /* Add user customizations here
 
@@ -97,11 +97,11 @@ static inline bool perform_read(uint8_t id, uint32_t addr, uint32_t *data)
         case NIOS_PKT_32x32_TARGET_ADI_AXI:
             *data = adi_axi_read(addr);
             break;
+#endif  // BOARD_BLADERF_MICRO
 
         case NIOS_PKT_32x32_TARGET_WB_MSTR:
             *data = wishbone_master_read(addr);
             break;
-#endif  // BOARD_BLADERF_MICRO
 
         /* Add user customizations here
 
@@ -28,6 +28,10 @@
 #include "devices.h"
 #include "debug.h"
 
+/* Identifies the configuration the host last applied. This is only ever set by
+ * the host, and is cleared when the FPGA is reconfigured. */
+static uint64_t config_id = 0;
+
 static inline bool perform_write(uint8_t id, uint8_t addr, uint64_t data)
 {
     switch (id) {
@@ -35,6 +39,10 @@ static inline bool perform_write(uint8_t id, uint8_t addr, uint64_t data)
             DBG("Invalid write access to timestamp: 0x%x\n", addr);
             return false;
 
+        case NIOS_PKT_8x64_TARGET_CONFIG_ID:
+            config_id = data;
+            return true;
+
         /* Add user customizations here
 
         case NIOS_PKT_8x64_TARGET_USR1:
@@ -49,6 +57,22 @@ static inline bool perform_write(uint8_t id, uint8_t addr, uint64_t data)
     }
 }
 
+/* Read the time at which a trigger last fired, per
+ * NIOS_PKT_8x64_TIMESTAMP_RX_TRIGGER */
+static inline uint64_t read_trigger_time(bladerf_module m)
+{
+    uint64_t time;
+    bool second_half;
+
+    if (!time_tamer_read_sync(m, &time, &second_half)) {
+        return 0;
+    }
+
+    return NIOS_PKT_8x64_TRIGGER_FIRED |
+           (((time << 1) | (second_half ? 1 : 0)) &
+            NIOS_PKT_8x64_TRIGGER_TIME_MASK);
+}
+
 static inline bool read_timestamp(uint8_t addr, uint64_t *data)
 {
     switch (addr) {
@@ -60,6 +84,14 @@ static inline bool read_timestamp(uint8_t addr, uint64_t *data)
             *data = time_tamer_read(BLADERF_MODULE_TX);
             break;
 
+        case NIOS_PKT_8x64_TIMESTAMP_RX_TRIGGER:
+            *data = read_trigger_time(BLADERF_MODULE_RX);
+            break;
+
+        case NIOS_PKT_8x64_TIMESTAMP_TX_TRIGGER:
+            *data = read_trigger_time(BLADERF_MODULE_TX);
+            break;
+
         default:
             DBG("Invalid addr: 0x%x\n", addr);
             return false;
@@ -77,6 +109,11 @@ static inline bool perform_read(uint8_t id, uint8_t addr, uint64_t *data)
             success = read_timestamp(addr, data);
             break;
 
+        case NIOS_PKT_8x64_TARGET_CONFIG_ID:
+            *data   = config_id;
+            success = true;
+            break;
+
         /* Add user customizations here
 
         case NIOS_PKT_8x64_TARGET_USR1:
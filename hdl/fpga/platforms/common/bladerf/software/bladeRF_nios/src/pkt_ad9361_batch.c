@@ -0,0 +1,59 @@
+/* This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "pkt_handler.h"
+#include "pkt_ad9361_batch.h"
+#include "devices.h"
+#include "debug.h"
+
+void pkt_ad9361_batch(struct pkt_buf *b)
+{
+    uint8_t  count   = b->req[NIOS_PKT_AD9361_BATCH_IDX_COUNT];
+    uint8_t  offset  = 0;
+    uint8_t  written = 0;
+    uint16_t cmd;
+    uint64_t data;
+
+    memcpy(b->resp, b->req, NIOS_PKT_LEN);
+
+#ifdef BOARD_BLADERF_MICRO
+    while (written < count &&
+           nios_pkt_ad9361_batch_get(b->req, &offset, &cmd, &data)) {
+        adi_spi_write(cmd, data);
+        written++;
+    }
+#else
+    (void) offset;
+    (void) cmd;
+    (void) data;
+#endif  // BOARD_BLADERF_MICRO
+
+    if (written != count) {
+        DBG("AD9361 batch stopped after %u of %u writes\n", written, count);
+    }
+
+    nios_pkt_ad9361_batch_resp_pack(b->resp, written, written == count);
+}
@@ -0,0 +1,364 @@
+/* This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include "pkt_handler.h"
+#include "pkt_dc_cal.h"
+#include "devices.h"
+#include "band_select.h"
+#include "lms.h"
+#include "debug.h"
+
+/* RX power meter registers, by byte address on the Wishbone master. See
+ * rx_power_meter.vhd */
+#define METER_CONTROL           0x20000
+#define METER_WINDOW            0x20004
+#define METER_I_SUM             0x20010
+#define METER_Q_SUM             0x20018
+#define METER_CONTROL_MEASURE   0x1
+
+/* LMS6002D RX DC offset correction registers. Bits 5:0 hold the magnitude,
+ * bit 6 the sign, and bit 7 is unrelated and must be preserved. */
+#define LMS_RX_DCOFF_I          0x71
+#define LMS_RX_DCOFF_Q          0x72
+#define DCOFF_MAX               63
+
+/* Correction values are reported normalized to 2048, as in libbladeRF */
+#define DCOFF_SCALE_SHIFT       5
+
+enum cal_state {
+    CAL_STATE_IDLE = 0,     /* Nothing to do */
+    CAL_STATE_TUNE,         /* Tune to the next entry and start searching */
+    CAL_STATE_MEASURE,      /* Waiting on a power meter measurement */
+};
+
+struct cal_entry {
+    struct lms_freq freq;
+    bool valid;             /* Calibration of this entry succeeded */
+    int8_t dc_i;
+    int8_t dc_q;
+};
+
+/* Bisection state for one of I or Q. The measured DC offset is monotonic in
+ * the correction value, so the search keeps a pair of correction values
+ * whose offsets differ in sign and halves the interval between them. */
+struct cal_axis {
+    int8_t lo, hi;
+    int64_t sum_lo, sum_hi;
+    int8_t trial;
+    bool done;
+};
+
+static struct {
+    struct cal_entry entries[NIOS_PKT_DC_CAL_MAX_ENTRIES];
+    uint8_t count;
+    uint8_t current;
+
+    enum cal_state state;
+    uint32_t num_samples;
+    uint16_t settle_us;
+
+    uint8_t step;           /* Measurements taken for the current entry */
+    struct cal_axis axes[2];
+} cal;
+
+static inline int64_t abs64(int64_t x)
+{
+    return x < 0 ? -x : x;
+}
+
+static inline bool same_sign(int64_t a, int64_t b)
+{
+    return (a < 0) == (b < 0);
+}
+
+static void write_dcoff(uint8_t addr, int8_t value)
+{
+    uint8_t regval = lms6_read(addr) & (1 << 7);
+
+    if (value < 0) {
+        regval |= (1 << 6) | ((-value) & 0x3f);
+    } else {
+        regval |= value & 0x3f;
+    }
+
+    lms6_write(addr, regval);
+}
+
+static int64_t read_sum(uint32_t addr)
+{
+    uint64_t lo = wishbone_master_read(addr);
+    uint64_t hi = wishbone_master_read(addr + 4);
+
+    return (int64_t) ((hi << 32) | lo);
+}
+
+/* Apply the trial correction values and start measuring the result */
+static void start_measurement(void)
+{
+    write_dcoff(LMS_RX_DCOFF_I, cal.axes[0].trial);
+    write_dcoff(LMS_RX_DCOFF_Q, cal.axes[1].trial);
+
+    if (cal.settle_us != 0) {
+        usleep(cal.settle_us);
+    }
+
+    wishbone_master_write(METER_WINDOW, cal.num_samples);
+    wishbone_master_write(METER_CONTROL, METER_CONTROL_MEASURE);
+
+    cal.state = CAL_STATE_MEASURE;
+}
+
+/* Pick the next trial value of an axis, given the offset measured at the
+ * current one. */
+static void update_axis(struct cal_axis *a, uint8_t step, int64_t sum)
+{
+    if (a->done) {
+        return;
+    }
+
+    switch (step) {
+        case 0:
+            a->sum_lo = sum;
+            a->trial  = a->hi;
+            return;
+
+        case 1:
+            a->sum_hi = sum;
+
+            /* The offset cannot be zeroed, so settle for the closest end */
+            if (same_sign(a->sum_lo, a->sum_hi)) {
+                if (abs64(a->sum_hi) < abs64(a->sum_lo)) {
+                    a->lo = a->hi;
+                } else {
+                    a->hi = a->lo;
+                }
+            }
+            break;
+
+        default:
+            if (same_sign(sum, a->sum_lo)) {
+                a->lo     = a->trial;
+                a->sum_lo = sum;
+            } else {
+                a->hi     = a->trial;
+                a->sum_hi = sum;
+            }
+            break;
+    }
+
+    if (a->hi - a->lo <= 1) {
+        a->done  = true;
+        a->trial = (abs64(a->sum_hi) < abs64(a->sum_lo)) ? a->hi : a->lo;
+    } else {
+        a->trial = a->lo + (a->hi - a->lo) / 2;
+    }
+}
+
+static void tune_entry(void)
+{
+    struct cal_entry *e = &cal.entries[cal.current];
+    bool low_band = (e->freq.flags & LMS_FREQ_FLAGS_LOW_BAND) != 0;
+    uint8_t i;
+
+    e->valid = false;
+
+    if (lms_set_precalculated_frequency(NULL, BLADERF_MODULE_RX, &e->freq) ||
+        band_select(NULL, BLADERF_MODULE_RX, low_band)) {
+        /* Leave this entry invalid and move on to the next */
+        cal.current++;
+        cal.state = (cal.current < cal.count) ? CAL_STATE_TUNE : CAL_STATE_IDLE;
+        return;
+    }
+
+    for (i = 0; i < ARRAY_SIZE(cal.axes); i++) {
+        cal.axes[i].lo    = -DCOFF_MAX;
+        cal.axes[i].hi    = DCOFF_MAX;
+        cal.axes[i].trial = -DCOFF_MAX;
+        cal.axes[i].done  = false;
+    }
+
+    cal.step = 0;
+    start_measurement();
+}
+
+static void finish_measurement(void)
+{
+    struct cal_entry *e = &cal.entries[cal.current];
+
+    if (wishbone_master_read(METER_CONTROL) & METER_CONTROL_MEASURE) {
+        return;
+    }
+
+    update_axis(&cal.axes[0], cal.step, read_sum(METER_I_SUM));
+    update_axis(&cal.axes[1], cal.step, read_sum(METER_Q_SUM));
+    cal.step++;
+
+    if (!cal.axes[0].done || !cal.axes[1].done) {
+        start_measurement();
+        return;
+    }
+
+    /* Leave the best correction applied for this entry */
+    write_dcoff(LMS_RX_DCOFF_I, cal.axes[0].trial);
+    write_dcoff(LMS_RX_DCOFF_Q, cal.axes[1].trial);
+
+    e->dc_i  = cal.axes[0].trial;
+    e->dc_q  = cal.axes[1].trial;
+    e->valid = true;
+
+    cal.current++;
+    cal.state = (cal.current < cal.count) ? CAL_STATE_TUNE : CAL_STATE_IDLE;
+}
+
+void pkt_dc_cal_init(void)
+{
+    memset(&cal, 0, sizeof(cal));
+}
+
+void pkt_dc_cal_work(void)
+{
+    switch (cal.state) {
+        case CAL_STATE_TUNE:
+            tune_entry();
+            break;
+
+        case CAL_STATE_MEASURE:
+            finish_measurement();
+            break;
+
+        default:
+            break;
+    }
+}
+
+void pkt_dc_cal(struct pkt_buf *b)
+{
+    const uint8_t cmd   = b->req[NIOS_PKT_DC_CAL_IDX_CMD];
+    uint8_t       index = b->req[NIOS_PKT_DC_CAL_IDX_INDEX];
+    uint8_t       flags = 0;
+    struct cal_entry *e;
+    bool low_band, quick_tune;
+    int status;
+
+    memcpy(b->resp, b->req, NIOS_PKT_LEN);
+
+    switch (cmd) {
+        case NIOS_PKT_DC_CAL_CMD_CLEAR:
+            cal.count   = 0;
+            cal.current = 0;
+            cal.state   = CAL_STATE_IDLE;
+            flags |= NIOS_PKT_DC_CAL_FLAG_SUCCESS;
+            break;
+
+        case NIOS_PKT_DC_CAL_CMD_ADD:
+            if (cal.state != CAL_STATE_IDLE ||
+                cal.count >= NIOS_PKT_DC_CAL_MAX_ENTRIES) {
+                break;
+            }
+
+            index = cal.count++;
+            e     = &cal.entries[index];
+
+            nios_pkt_dc_cal_add_unpack(b->req, &e->freq.nint, &e->freq.nfrac,
+                                       &e->freq.freqsel, &e->freq.vcocap,
+                                       &low_band, &quick_tune);
+
+            e->freq.vcocap_result = 0xff;
+            e->freq.flags = low_band ? LMS_FREQ_FLAGS_LOW_BAND : 0;
+            if (quick_tune) {
+                e->freq.flags |= LMS_FREQ_FLAGS_FORCE_VCOCAP;
+            }
+
+            e->valid = false;
+            flags |= NIOS_PKT_DC_CAL_FLAG_SUCCESS;
+            break;
+
+        case NIOS_PKT_DC_CAL_CMD_START:
+            if (cal.state != CAL_STATE_IDLE || cal.count == 0) {
+                break;
+            }
+
+            nios_pkt_dc_cal_start_unpack(b->req, &cal.num_samples,
+                                         &cal.settle_us);
+
+            if (cal.num_samples == 0) {
+                break;
+            }
+
+            cal.current = 0;
+            cal.state   = CAL_STATE_TUNE;
+            flags |= NIOS_PKT_DC_CAL_FLAG_SUCCESS;
+            break;
+
+        case NIOS_PKT_DC_CAL_CMD_STATUS:
+            index = cal.count;
+            b->resp[NIOS_PKT_DC_CAL_IDX_DONE] = cal.current;
+            flags |= NIOS_PKT_DC_CAL_FLAG_SUCCESS;
+            break;
+
+        case NIOS_PKT_DC_CAL_CMD_READ:
+            if (index >= cal.count || !cal.entries[index].valid ||
+                (cal.state != CAL_STATE_IDLE && index >= cal.current)) {
+                break;
+            }
+
+            e = &cal.entries[index];
+            nios_pkt_dc_cal_put16(&b->resp[NIOS_PKT_DC_CAL_IDX_DC_I],
+                                  (uint16_t) (e->dc_i * (1 << DCOFF_SCALE_SHIFT)));
+            nios_pkt_dc_cal_put16(&b->resp[NIOS_PKT_DC_CAL_IDX_DC_Q],
+                                  (uint16_t) (e->dc_q * (1 << DCOFF_SCALE_SHIFT)));
+            flags |= NIOS_PKT_DC_CAL_FLAG_SUCCESS;
+            break;
+
+        case NIOS_PKT_DC_CAL_CMD_LMS:
+            /* The sweep and the LMS6002D's own calibration both take over
+             * the RX path, so don't let them overlap */
+            if (cal.state != CAL_STATE_IDLE) {
+                break;
+            }
+
+            status = lms_calibrate_dc(NULL, (bladerf_cal_module)
+                                      b->req[NIOS_PKT_DC_CAL_IDX_LMS_MODULE]);
+
+            b->resp[NIOS_PKT_DC_CAL_IDX_LMS_STATUS] = (uint8_t) status;
+            if (status == 0) {
+                flags |= NIOS_PKT_DC_CAL_FLAG_SUCCESS;
+            }
+            break;
+
+        default:
+            DBG("Invalid DC calibration command: 0x%x\n", cmd);
+            break;
+    }
+
+    if (cal.state != CAL_STATE_IDLE) {
+        flags |= NIOS_PKT_DC_CAL_FLAG_BUSY;
+    }
+
+    b->resp[NIOS_PKT_DC_CAL_IDX_INDEX] = index;
+    b->resp[NIOS_PKT_DC_CAL_IDX_FLAGS] = flags;
+}
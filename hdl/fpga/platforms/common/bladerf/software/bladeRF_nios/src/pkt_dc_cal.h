@@ -0,0 +1,46 @@
+/* This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef PKT_DC_CAL_H_
+#define PKT_DC_CAL_H_
+
+#include <stdint.h>
+#include "pkt_handler.h"
+#include "nios_pkt_dc_cal.h"
+
+void pkt_dc_cal_init(void);
+
+void pkt_dc_cal(struct pkt_buf *b);
+
+void pkt_dc_cal_work(void);
+
+/* Measurements are polled from the background work, so a calibration sweep
+ * does not hold up other requests */
+#define PKT_DC_CAL { \
+    .magic          = NIOS_PKT_DC_CAL_MAGIC, \
+    .init           = pkt_dc_cal_init, \
+    .exec           = pkt_dc_cal, \
+    .do_work        = pkt_dc_cal_work, \
+}
+
+#endif
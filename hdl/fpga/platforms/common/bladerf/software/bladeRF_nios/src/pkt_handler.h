@@ -38,7 +38,6 @@
 struct pkt_buf {
     const uint8_t req[NIOS_PKT_LEN];      /* Request */
     uint8_t       resp[NIOS_PKT_LEN];     /* Response */
-    volatile bool ready;                  /* Ready flag */
 };
 
 // This is temporary until we figure out where to put it
@@ -26,6 +26,8 @@
 #include "pkt_handler.h"
 #include "pkt_retune.h"
 #include "nios_pkt_retune.h"    /* Packet format definition */
+#include "pkt_retune_queue.h"
+#include "pkt_timed_write.h"
 #include "devices.h"
 #include "band_select.h"
 #include "debug.h"
@@ -54,7 +56,12 @@ enum entry_state {
 
 struct queue_entry {
     volatile enum entry_state state;
-    struct lms_freq freq;
+    bool is_write;              /* Timed write, rather than a retune */
+    struct lms_freq freq;       /* Retunes only */
+    uint8_t write_type;         /* Timed writes only */
+    uint8_t write_id;           /* Timed writes only */
+    uint8_t write_addr;         /* Timed writes only */
+    uint32_t write_data;        /* Timed writes only */
     uint64_t timestamp;
 };
 
@@ -66,29 +73,128 @@ static struct queue {
     struct queue_entry entries[RETUNE_QUEUE_MAX];
 } rx_queue, tx_queue;
 
-/* Returns queue size after enqueue operation, or QUEUE_FULL if we could
- * not enqueue the requested item */
-static inline uint8_t enqueue_retune(struct queue *q,
-                                     const struct lms_freq *f,
-                                     uint64_t timestamp)
+/* Insert an entry in timestamp order, after any entries due at the same
+ * time. Returns queue size after enqueue operation, or QUEUE_FULL if we could
+ * not enqueue the requested item.
+ *
+ * The retune interrupt may mark the first entry ready while this occurs. An
+ * entry found to be ready stays first. Otherwise, a new first entry takes
+ * over the timer, and the one it displaces is rescheduled after it. */
+static uint8_t enqueue_entry(struct queue *q, const struct queue_entry *n)
 {
-    uint8_t ret;
+    uint8_t pos;
+    uint8_t i;
+    uint8_t idx;
 
     if (q->count >= RETUNE_QUEUE_MAX) {
         return QUEUE_FULL;
     }
 
-    memcpy(&q->entries[q->ins_idx].freq, f, sizeof(f[0]));
+    for (pos = 0; pos < q->count; pos++) {
+        idx = (q->rem_idx + pos) & (RETUNE_QUEUE_MAX - 1);
+        if (q->entries[idx].timestamp > n->timestamp &&
+            q->entries[idx].state != ENTRY_STATE_READY) {
+            break;
+        }
+    }
+
+    /* Move the later entries back to make room */
+    for (i = q->count; i > pos; i--) {
+        memcpy(&q->entries[(q->rem_idx + i) & (RETUNE_QUEUE_MAX - 1)],
+               &q->entries[(q->rem_idx + i - 1) & (RETUNE_QUEUE_MAX - 1)],
+               sizeof(q->entries[0]));
+    }
+
+    if (pos == 0 && q->count > 0) {
+        q->entries[(q->rem_idx + 1) & (RETUNE_QUEUE_MAX - 1)].state =
+            ENTRY_STATE_NEW;
+    }
 
-    q->entries[q->ins_idx].state = ENTRY_STATE_NEW;
-    q->entries[q->ins_idx].timestamp = timestamp;
+    idx = (q->rem_idx + pos) & (RETUNE_QUEUE_MAX - 1);
+
+    memcpy(&q->entries[idx], n, sizeof(q->entries[0]));
+    q->entries[idx].state = ENTRY_STATE_NEW;
 
     q->ins_idx = (q->ins_idx + 1) & (RETUNE_QUEUE_MAX - 1);
 
     q->count++;
-    ret = q->count;
 
-    return ret;
+    return q->count;
+}
+
+static inline uint8_t enqueue_retune(struct queue *q,
+                                     const struct lms_freq *f,
+                                     uint64_t timestamp)
+{
+    struct queue_entry e;
+
+    memset(&e, 0, sizeof(e));
+
+    memcpy(&e.freq, f, sizeof(f[0]));
+    e.timestamp = timestamp;
+
+    return enqueue_entry(q, &e);
+}
+
+static inline uint8_t enqueue_write(struct queue *q,
+                                    uint8_t type,
+                                    uint8_t id,
+                                    uint8_t addr,
+                                    uint32_t data,
+                                    uint64_t timestamp)
+{
+    struct queue_entry e;
+
+    memset(&e, 0, sizeof(e));
+
+    e.is_write = true;
+    e.write_type = type;
+    e.write_id = id;
+    e.write_addr = addr;
+    e.write_data = data;
+    e.timestamp = timestamp;
+
+    return enqueue_entry(q, &e);
+}
+
+/* Remove the retunes due from start to end, inclusive, other than one the
+ * retune interrupt has marked ready. Returns the number removed.
+ *
+ * The remaining entries keep their order. A canceled first entry is
+ * overwritten by its successor, which the next perform_work() schedules;
+ * this rearms the timer, so the canceled entry's interrupt has no effect. */
+static uint8_t cancel_range(struct queue *q, uint64_t start, uint64_t end)
+{
+    struct queue_entry *e;
+    uint8_t count = q->count;
+    uint8_t kept = 0;
+    uint8_t i;
+
+    for (i = 0; i < count; i++) {
+        e = &q->entries[(q->rem_idx + i) & (RETUNE_QUEUE_MAX - 1)];
+
+        if (e->state != ENTRY_STATE_READY &&
+            e->timestamp >= start && e->timestamp <= end) {
+            continue;
+        }
+
+        if (kept != i) {
+            memcpy(&q->entries[(q->rem_idx + kept) & (RETUNE_QUEUE_MAX - 1)],
+                   e, sizeof(q->entries[0]));
+        }
+
+        kept++;
+    }
+
+    for (i = kept; i < count; i++) {
+        q->entries[(q->rem_idx + i) & (RETUNE_QUEUE_MAX - 1)].state =
+            ENTRY_STATE_INVALID;
+    }
+
+    q->count = kept;
+    q->ins_idx = (q->rem_idx + kept) & (RETUNE_QUEUE_MAX - 1);
+
+    return count - kept;
 }
 
 /* Retune number of items left in the queue after the dequeue operation,
@@ -271,8 +377,15 @@ static inline void perform_work(struct queue *q, bladerf_module module)
 
         case ENTRY_STATE_READY:
 
-            /* Perform our retune */
-            if (lms_set_precalculated_frequency(NULL, module, &e->freq)) {
+            if (e->is_write) {
+                /* Carry out the peripheral write */
+                if (!timed_write_apply(e->write_type, e->write_id,
+                                       e->write_addr, e->write_data)) {
+                    INCREMENT_ERROR_COUNT();
+                }
+            } else if (lms_set_precalculated_frequency(NULL, module,
+                                                       &e->freq)) {
+                /* The retune failed */
                 INCREMENT_ERROR_COUNT();
             } else {
                 bool low_band = (e->freq.flags & LMS_FREQ_FLAGS_LOW_BAND) != 0;
@@ -411,3 +524,69 @@ out:
 
     nios_pkt_retune_resp_pack(b->resp, duration, f.vcocap_result, flags);
 }
+
+void pkt_retune_queue(struct pkt_buf *b)
+{
+    struct queue *q;
+    struct queue_entry *e;
+    bool is_rx;
+    bool success = true;
+    uint8_t cmd;
+    uint8_t canceled = 0;
+    uint64_t start;
+    uint64_t end;
+
+    nios_pkt_retune_queue_unpack(b->req, &is_rx, &cmd, &start, &end);
+
+    q = is_rx ? &rx_queue : &tx_queue;
+
+    switch (cmd) {
+        case NIOS_PKT_RETUNE_QUEUE_CMD_QUERY:
+            break;
+
+        case NIOS_PKT_RETUNE_QUEUE_CMD_CANCEL:
+            canceled = cancel_range(q, start, end);
+            break;
+
+        default:
+            INCREMENT_ERROR_COUNT();
+            success = false;
+    }
+
+    e = peek_next_retune(q);
+
+    nios_pkt_retune_queue_resp_pack(b->resp, success, q->count,
+                                    RETUNE_QUEUE_MAX, canceled,
+                                    e != NULL ? e->timestamp : 0);
+}
+
+void pkt_timed_write(struct pkt_buf *b)
+{
+    struct queue *q;
+    bool is_rx;
+    bool success;
+    bool queue_full = false;
+    uint64_t timestamp;
+    uint8_t type;
+    uint8_t id;
+    uint8_t addr;
+    uint32_t data;
+
+    nios_pkt_timed_write_unpack(b->req, &is_rx, &timestamp,
+                                &type, &id, &addr, &data);
+
+    q = is_rx ? &rx_queue : &tx_queue;
+
+    if (!timed_write_type_valid(type)) {
+        INCREMENT_ERROR_COUNT();
+        success = false;
+    } else if (timestamp == NIOS_PKT_TIMED_WRITE_NOW) {
+        success = timed_write_apply(type, id, addr, data);
+    } else {
+        queue_full = enqueue_write(q, type, id, addr, data, timestamp) ==
+                     QUEUE_FULL;
+        success = !queue_full;
+    }
+
+    nios_pkt_timed_write_resp_pack(b->resp, success, queue_full, q->count);
+}
@@ -26,6 +26,8 @@
 #include "pkt_handler.h"
 #include "pkt_retune2.h"
 #include "nios_pkt_retune2.h"    /* Packet format definition */
+#include "pkt_retune_queue.h"
+#include "pkt_timed_write.h"
 #include "devices.h"
 #include "debug.h"
 
@@ -45,6 +47,10 @@ void rfic_invalidate_frequency(bladerf_module module);
 #define QUEUE_FULL          0xff
 #define QUEUE_EMPTY         0xfe
 
+/* Entry command for timed writes, alongside the NIOS_PKT_RETUNE2_CMD_*
+ * values */
+#define ENTRY_CMD_WRITE     0x80
+
 /* State of items in the retune queue */
 enum entry_state {
     ENTRY_STATE_INVALID = 0,  /* Marks entry invalid and not in use */
@@ -58,7 +64,14 @@ enum entry_state {
 
 struct queue_entry {
     volatile enum entry_state state;
-    fastlock_profile *profile;
+    uint8_t cmd;                /* NIOS_PKT_RETUNE2_CMD_* or ENTRY_CMD_WRITE */
+    fastlock_profile *profile;  /* Retunes only */
+    uint8_t gain_chan;          /* Gain changes only */
+    uint16_t gain_setting;      /* Gain changes only */
+    uint8_t write_type;         /* Timed writes only */
+    uint8_t write_id;           /* Timed writes only */
+    uint8_t write_addr;         /* Timed writes only */
+    uint32_t write_data;        /* Timed writes only */
     uint64_t timestamp;
 };
 
@@ -70,28 +83,146 @@ static struct queue {
     struct queue_entry entries[RETUNE2_QUEUE_MAX];
 } rx_queue, tx_queue;
 
-/* Returns queue size after enqueue operation, or QUEUE_FULL if we could
- * not enqueue the requested item */
-static inline uint8_t enqueue_retune(struct queue *q,
-                                     fastlock_profile *p,
-                                     uint64_t timestamp)
+/* Insert an entry in timestamp order, after any entries due at the same
+ * time. Returns queue size after enqueue operation, or QUEUE_FULL if we could
+ * not enqueue the requested item.
+ *
+ * The retune interrupt may mark the first entry ready while this occurs. An
+ * entry found to be ready stays first. Otherwise, a new first entry takes
+ * over the timer, and the one it displaces is rescheduled after it. */
+static uint8_t enqueue_entry(struct queue *q, const struct queue_entry *n)
 {
-    uint8_t ret;
+    uint8_t pos;
+    uint8_t i;
+    uint8_t idx;
 
     if (q->count >= RETUNE2_QUEUE_MAX) {
         return QUEUE_FULL;
     }
 
-    q->entries[q->ins_idx].profile = p;
-    q->entries[q->ins_idx].state = ENTRY_STATE_NEW;
-    q->entries[q->ins_idx].timestamp = timestamp;
+    for (pos = 0; pos < q->count; pos++) {
+        idx = (q->rem_idx + pos) & (RETUNE2_QUEUE_MAX - 1);
+        if (q->entries[idx].timestamp > n->timestamp &&
+            q->entries[idx].state != ENTRY_STATE_READY) {
+            break;
+        }
+    }
+
+    /* Move the later entries back to make room */
+    for (i = q->count; i > pos; i--) {
+        memcpy(&q->entries[(q->rem_idx + i) & (RETUNE2_QUEUE_MAX - 1)],
+               &q->entries[(q->rem_idx + i - 1) & (RETUNE2_QUEUE_MAX - 1)],
+               sizeof(q->entries[0]));
+    }
+
+    if (pos == 0 && q->count > 0) {
+        q->entries[(q->rem_idx + 1) & (RETUNE2_QUEUE_MAX - 1)].state =
+            ENTRY_STATE_NEW;
+    }
+
+    idx = (q->rem_idx + pos) & (RETUNE2_QUEUE_MAX - 1);
+
+    memcpy(&q->entries[idx], n, sizeof(q->entries[0]));
+    q->entries[idx].state = ENTRY_STATE_NEW;
 
     q->ins_idx = (q->ins_idx + 1) & (RETUNE2_QUEUE_MAX - 1);
 
     q->count++;
-    ret = q->count;
 
-    return ret;
+    return q->count;
+}
+
+static inline uint8_t enqueue_retune(struct queue *q,
+                                     fastlock_profile *p,
+                                     uint64_t timestamp)
+{
+    struct queue_entry e;
+
+    memset(&e, 0, sizeof(e));
+
+    e.cmd = NIOS_PKT_RETUNE2_CMD_RETUNE;
+    e.profile = p;
+    e.timestamp = timestamp;
+
+    return enqueue_entry(q, &e);
+}
+
+static inline uint8_t enqueue_gain(struct queue *q,
+                                   uint8_t chan,
+                                   uint16_t setting,
+                                   uint64_t timestamp)
+{
+    struct queue_entry e;
+
+    memset(&e, 0, sizeof(e));
+
+    e.cmd = NIOS_PKT_RETUNE2_CMD_GAIN;
+    e.gain_chan = chan;
+    e.gain_setting = setting;
+    e.timestamp = timestamp;
+
+    return enqueue_entry(q, &e);
+}
+
+static inline uint8_t enqueue_write(struct queue *q,
+                                    uint8_t type,
+                                    uint8_t id,
+                                    uint8_t addr,
+                                    uint32_t data,
+                                    uint64_t timestamp)
+{
+    struct queue_entry e;
+
+    memset(&e, 0, sizeof(e));
+
+    e.cmd = ENTRY_CMD_WRITE;
+    e.write_type = type;
+    e.write_id = id;
+    e.write_addr = addr;
+    e.write_data = data;
+    e.timestamp = timestamp;
+
+    return enqueue_entry(q, &e);
+}
+
+/* Remove the entries due from start to end, inclusive, other than one the
+ * retune interrupt has marked ready. Returns the number removed.
+ *
+ * The remaining entries keep their order. A canceled first entry is
+ * overwritten by its successor, which the next perform_work() schedules;
+ * this rearms the timer, so the canceled entry's interrupt has no effect. */
+static uint8_t cancel_range(struct queue *q, uint64_t start, uint64_t end)
+{
+    struct queue_entry *e;
+    uint8_t count = q->count;
+    uint8_t kept = 0;
+    uint8_t i;
+
+    for (i = 0; i < count; i++) {
+        e = &q->entries[(q->rem_idx + i) & (RETUNE2_QUEUE_MAX - 1)];
+
+        if (e->state != ENTRY_STATE_READY &&
+            e->timestamp >= start && e->timestamp <= end) {
+            continue;
+        }
+
+        if (kept != i) {
+            memcpy(&q->entries[(q->rem_idx + kept) & (RETUNE2_QUEUE_MAX - 1)],
+                   e, sizeof(q->entries[0]));
+        }
+
+        kept++;
+    }
+
+    for (i = kept; i < count; i++) {
+        q->entries[(q->rem_idx + i) & (RETUNE2_QUEUE_MAX - 1)].state =
+            ENTRY_STATE_INVALID;
+    }
+
+    q->count = kept;
+    q->ins_idx = (q->rem_idx + kept) & (RETUNE2_QUEUE_MAX - 1);
+
+    return count - kept;
 }
 
 /* Retune number of items left in the queue after the dequeue operation,
@@ -186,7 +317,7 @@ static inline void profile_load_scheduled(struct queue *q,
     for (i = 0; i < q->count; i++) {
         e = peek_next_retune_offset(q, i);
         if( e != NULL ) {
-            if (e->state == ENTRY_STATE_NEW) {
+            if (e->state == ENTRY_STATE_NEW && e->profile != NULL) {
                 if ( !(used & (1 << e->profile->profile_num)) ) {
                     /* Profile slot is available in RFFE, fill it */
                     profile_load(module, e->profile);
@@ -308,8 +439,19 @@ static inline void perform_work(struct queue *q, bladerf_module module)
 
         case ENTRY_STATE_READY:
 
-            /* Activate the fast lock profile for this retune */
-            profile_activate(module, e->profile);
+            if (e->cmd == NIOS_PKT_RETUNE2_CMD_GAIN) {
+                /* Apply the gain change */
+                adi_gain_apply(module, e->gain_chan, e->gain_setting);
+            } else if (e->cmd == ENTRY_CMD_WRITE) {
+                /* Carry out the peripheral write */
+                if (!timed_write_apply(e->write_type, e->write_id,
+                                       e->write_addr, e->write_data)) {
+                    INCREMENT_ERROR_COUNT();
+                }
+            } else {
+                /* Activate the fast lock profile for this retune */
+                profile_activate(module, e->profile);
+            }
 
             /* Drop the item from the queue */
             dequeue_retune(q, NULL);
@@ -341,6 +483,9 @@ void pkt_retune2(struct pkt_buf *b)
     uint8_t rffe_profile;
     uint8_t port;
     uint8_t spdt;
+    uint8_t cmd;
+    uint8_t gain_chan = 0;
+    uint16_t gain_setting = 0;
     fastlock_profile *profile;
 
     flags = NIOS_PKT_RETUNE2_RESP_FLAG_SUCCESS;
@@ -348,6 +493,14 @@ void pkt_retune2(struct pkt_buf *b)
     nios_pkt_retune2_unpack(b->req, &module, &timestamp,
                             &nios_profile, &rffe_profile, &port, &spdt);
 
+    cmd = nios_pkt_retune2_cmd(b->req);
+
+    if (cmd == NIOS_PKT_RETUNE2_CMD_GAIN) {
+        /* The profile fields hold the gain change instead */
+        nios_pkt_retune2_gain_unpack(b->req, &gain_chan, &gain_setting);
+        nios_profile = 0;
+    }
+
     switch (module) {
         case BLADERF_MODULE_RX:
             profile = &fastlocks_rx[nios_profile];
@@ -362,6 +515,9 @@ void pkt_retune2(struct pkt_buf *b)
     if (profile == NULL) {
         INCREMENT_ERROR_COUNT();
         status = -1;
+    } else if (cmd == NIOS_PKT_RETUNE2_CMD_GAIN) {
+        /* Leave the fast lock profile data alone */
+        profile = NULL;
     } else {
         /* Update the fastlock profile data */
         profile->profile_num = rffe_profile;
@@ -377,11 +533,16 @@ void pkt_retune2(struct pkt_buf *b)
             case BLADERF_MODULE_RX:
             case BLADERF_MODULE_TX:
 
-                /* Load the profile data into RFFE memory */
-                profile_load(module, profile);
+                if (cmd == NIOS_PKT_RETUNE2_CMD_GAIN) {
+                    /* Apply the gain change */
+                    adi_gain_apply(module, gain_chan, gain_setting);
+                } else {
+                    /* Load the profile data into RFFE memory */
+                    profile_load(module, profile);
 
-                /* Activate the fast lock profile for this retune */
-                profile_activate(module, profile);
+                    /* Activate the fast lock profile for this retune */
+                    profile_activate(module, profile);
+                }
 
                 flags |= NIOS_PKT_RETUNE2_RESP_FLAG_TSVTUNE_VALID;
 
@@ -410,25 +571,33 @@ void pkt_retune2(struct pkt_buf *b)
                 status = -1;
         }
     } else {
+        struct queue *q;
         uint8_t queue_size;
 
         switch (module) {
             case BLADERF_MODULE_RX:
-                queue_size = enqueue_retune(&rx_queue, profile, timestamp);
-                profile_load_scheduled(&rx_queue, module);
+                q = &rx_queue;
                 break;
 
             case BLADERF_MODULE_TX:
-                queue_size = enqueue_retune(&tx_queue, profile, timestamp);
-                profile_load_scheduled(&tx_queue, module);
+                q = &tx_queue;
                 break;
 
             default:
                 INCREMENT_ERROR_COUNT();
-                queue_size = QUEUE_FULL;
+                q = NULL;
 
         }
 
+        if (q == NULL) {
+            queue_size = QUEUE_FULL;
+        } else if (cmd == NIOS_PKT_RETUNE2_CMD_GAIN) {
+            queue_size = enqueue_gain(q, gain_chan, gain_setting, timestamp);
+        } else {
+            queue_size = enqueue_retune(q, profile, timestamp);
+            profile_load_scheduled(q, module);
+        }
+
         if (queue_size == QUEUE_FULL) {
             status = -1;
         } else {
@@ -445,3 +614,69 @@ void pkt_retune2(struct pkt_buf *b)
 
     nios_pkt_retune2_resp_pack(b->resp, duration, flags);
 }
+
+void pkt_retune_queue(struct pkt_buf *b)
+{
+    struct queue *q;
+    struct queue_entry *e;
+    bool is_rx;
+    bool success = true;
+    uint8_t cmd;
+    uint8_t canceled = 0;
+    uint64_t start;
+    uint64_t end;
+
+    nios_pkt_retune_queue_unpack(b->req, &is_rx, &cmd, &start, &end);
+
+    q = is_rx ? &rx_queue : &tx_queue;
+
+    switch (cmd) {
+        case NIOS_PKT_RETUNE_QUEUE_CMD_QUERY:
+            break;
+
+        case NIOS_PKT_RETUNE_QUEUE_CMD_CANCEL:
+            canceled = cancel_range(q, start, end);
+            break;
+
+        default:
+            INCREMENT_ERROR_COUNT();
+            success = false;
+    }
+
+    e = peek_next_retune(q);
+
+    nios_pkt_retune_queue_resp_pack(b->resp, success, q->count,
+                                    RETUNE2_QUEUE_MAX, canceled,
+                                    e != NULL ? e->timestamp : 0);
+}
+
+void pkt_timed_write(struct pkt_buf *b)
+{
+    struct queue *q;
+    bool is_rx;
+    bool success;
+    bool queue_full = false;
+    uint64_t timestamp;
+    uint8_t type;
+    uint8_t id;
+    uint8_t addr;
+    uint32_t data;
+
+    nios_pkt_timed_write_unpack(b->req, &is_rx, &timestamp,
+                                &type, &id, &addr, &data);
+
+    q = is_rx ? &rx_queue : &tx_queue;
+
+    if (!timed_write_type_valid(type)) {
+        INCREMENT_ERROR_COUNT();
+        success = false;
+    } else if (timestamp == NIOS_PKT_TIMED_WRITE_NOW) {
+        success = timed_write_apply(type, id, addr, data);
+    } else {
+        queue_full = enqueue_write(q, type, id, addr, data, timestamp) ==
+                     QUEUE_FULL;
+        success = !queue_full;
+    }
+
+    nios_pkt_timed_write_resp_pack(b->resp, success, queue_full, q->count);
+}
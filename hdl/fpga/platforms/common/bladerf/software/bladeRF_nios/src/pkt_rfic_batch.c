@@ -0,0 +1,72 @@
+/* This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "pkt_handler.h"
+#include "pkt_rfic_batch.h"
+#include "devices.h"
+#include "debug.h"
+
+void pkt_rfic_batch(struct pkt_buf *b)
+{
+    uint8_t  count = b->req[NIOS_PKT_RFIC_BATCH_IDX_COUNT];
+    uint8_t  flags = 0;
+    uint8_t  queue_len = 0;
+    uint8_t  i;
+    uint16_t addr;
+    uint64_t data;
+
+    memcpy(b->resp, b->req, NIOS_PKT_LEN);
+
+    if (count > NIOS_PKT_RFIC_BATCH_MAX) {
+        DBG("Invalid RFIC batch count: %u\n", count);
+        count = 0;
+    }
+
+#ifdef BLADERF_NIOS_LIBAD936X
+    for (i = 0; i < count; i++) {
+        if (rfic_command_queue_length() >= rfic_command_queue_capacity()) {
+            flags |= NIOS_PKT_RFIC_BATCH_FLAG_QUEUE_FULL;
+            break;
+        }
+
+        nios_pkt_rfic_batch_get(b->req, i, &addr, &data);
+
+        if (!rfic_command_write(addr, data)) {
+            break;
+        }
+
+        flags |= NIOS_PKT_RFIC_BATCH_FLAG_ENQUEUED(i);
+    }
+
+    queue_len = rfic_command_queue_length();
+#else
+    (void) i;
+    (void) addr;
+    (void) data;
+#endif  // BLADERF_NIOS_LIBAD936X
+
+    nios_pkt_rfic_batch_resp_pack(b->resp, flags, queue_len);
+}
@@ -0,0 +1,115 @@
+/* This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef PKT_TIMED_WRITE_H_
+#define PKT_TIMED_WRITE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pkt_handler.h"
+#include "pkt_8x8.h"
+#include "pkt_8x16.h"
+#include "pkt_8x32.h"
+#include "pkt_32x32.h"
+#include "nios_pkt_timed_write.h"
+
+/* Implemented alongside the queue it uses, in pkt_retune.c or
+ * pkt_retune2.c */
+void pkt_timed_write(struct pkt_buf *b);
+
+#define PKT_TIMED_WRITE { \
+    .magic          = NIOS_PKT_TIMED_WRITE_MAGIC, \
+    .init           = NULL, \
+    .exec           = pkt_timed_write, \
+    .do_work        = NULL, \
+}
+
+/* Returns true if the write type is one a timed write may describe */
+static inline bool timed_write_type_valid(uint8_t type)
+{
+    switch (type) {
+        case NIOS_PKT_8x8_MAGIC:
+        case NIOS_PKT_8x16_MAGIC:
+        case NIOS_PKT_8x32_MAGIC:
+        case NIOS_PKT_32x32_MAGIC:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/* Carry out a timed write by passing the equivalent write request to its
+ * packet handler. Returns true if the handler reported success. */
+static inline bool timed_write_apply(uint8_t type, uint8_t id, uint8_t addr,
+                                     uint32_t data)
+{
+    /* Request and response, laid out as a struct pkt_buf */
+    uint8_t buf[2 * NIOS_PKT_LEN];
+    uint8_t *resp = &buf[NIOS_PKT_LEN];
+    struct pkt_buf *b = (struct pkt_buf *) buf;
+    bool write;
+    bool success = false;
+
+    switch (type) {
+        case NIOS_PKT_8x8_MAGIC: {
+            uint8_t d;
+            nios_pkt_8x8_pack(buf, id, true, addr, data);
+            pkt_8x8(b);
+            nios_pkt_8x8_resp_unpack(resp, &id, &write, &addr, &d, &success);
+            break;
+        }
+
+        case NIOS_PKT_8x16_MAGIC: {
+            uint16_t d;
+            nios_pkt_8x16_pack(buf, id, true, addr, data);
+            pkt_8x16(b);
+            nios_pkt_8x16_resp_unpack(resp, &id, &write, &addr, &d, &success);
+            break;
+        }
+
+        case NIOS_PKT_8x32_MAGIC: {
+            uint32_t d;
+            nios_pkt_8x32_pack(buf, id, true, addr, data);
+            pkt_8x32(b);
+            nios_pkt_8x32_resp_unpack(resp, &id, &write, &addr, &d, &success);
+            break;
+        }
+
+        case NIOS_PKT_32x32_MAGIC: {
+            uint32_t a = (uint32_t)(int32_t)(int8_t) addr;
+            uint32_t d;
+            nios_pkt_32x32_pack(buf, id, true, a, data);
+            pkt_32x32(b);
+            nios_pkt_32x32_resp_unpack(resp, &id, &write, &a, &d, &success);
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    return success;
+}
+
+#endif
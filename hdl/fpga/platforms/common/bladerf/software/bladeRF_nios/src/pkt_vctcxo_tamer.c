@@ -0,0 +1,311 @@
+/* This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "pkt_handler.h"
+#include "pkt_vctcxo_tamer.h"
+#include "devices.h"
+#include "debug.h"
+
+/* Trim DAC range used by the control loop */
+#define TRIMDAC_MIN     0x28F5
+#define TRIMDAC_MAX     0xF5C3
+
+/* Distance from the seed at which a seeded acquisition measures the DAC's
+ * response */
+#define TRIMDAC_STEP    0x2000
+
+/* A structure that represents a point on a line. Used for calibrating
+ * the VCTCXO */
+typedef struct point {
+    int32_t  x; // Error counts
+    uint16_t y; // DAC count
+} point_t;
+
+typedef struct line {
+    point_t  point[2];
+    int32_t  slope;
+    uint16_t y_intercept; // in DAC counts
+} line_t;
+
+struct vctcxo_tamer_pkt_buf vctcxo_tamer_pkt;
+
+static struct {
+    /* Trim DAC calibration line */
+    line_t cal_line;
+
+    /* NIOS_PKT_VCTCXO_TAMER_STATE_* */
+    uint8_t state;
+
+    /* The last measurement, and the number taken since acquisition
+     * started */
+    uint8_t count;
+    uint8_t flags;
+    int32_t err_1s;
+    int32_t err_10s;
+} tamer;
+
+static uint16_t clamp_trim(int32_t val)
+{
+    if (val < TRIMDAC_MIN) {
+        return TRIMDAC_MIN;
+    } else if (val > TRIMDAC_MAX) {
+        return TRIMDAC_MAX;
+    } else {
+        return (uint16_t) val;
+    }
+}
+
+/* Compute the slope and error-free DAC value from the two points of the
+ * calibration line, and tune to the latter. Returns false if the points
+ * don't describe a usable line. */
+static bool apply_cal_line(void)
+{
+    line_t *line = &tamer.cal_line;
+    int32_t dx = line->point[1].x - line->point[0].x;
+
+    if (dx == 0) {
+        return false;
+    }
+
+    /* We now have two points, so we can calculate the equation for a line
+     * plotted with DAC counts on the Y axis and error on the X axis. We want
+     * a PPM of zero, which ideally corresponds to the y-intercept of the
+     * line. */
+    line->slope = ((int32_t) line->point[1].y - line->point[0].y) / dx;
+    line->y_intercept =
+        clamp_trim(line->point[0].y - (line->slope * line->point[0].x));
+
+    /* Set the trim DAC count to the y-intercept */
+    vctcxo_trim_dac_write(0x08, line->y_intercept);
+
+    return true;
+}
+
+/* Restart acquisition. When seeded, the trim DAC is tuned to the seed
+ * straight away so that the next measurement is taken there. */
+static void acquire(bool seed_valid, uint16_t seed)
+{
+    tamer.count = 0;
+    tamer.flags = 0;
+    tamer.err_1s = 0;
+    tamer.err_10s = 0;
+
+    /* Discard any measurement in progress. The ISR disables itself when it
+     * fires, so re-enable it if a measurement was left pending. */
+    vctcxo_tamer_reset_counters(true);
+    if (vctcxo_tamer_pkt.ready) {
+        vctcxo_tamer_pkt.ready = false;
+        vctcxo_tamer_enable_isr(true);
+    }
+
+    if (seed_valid) {
+        tamer.cal_line.point[0].y = clamp_trim(seed);
+        vctcxo_trim_dac_write(0x08, tamer.cal_line.point[0].y);
+        tamer.state = NIOS_PKT_VCTCXO_TAMER_STATE_SEED_CHECK;
+    } else {
+        tamer.state = NIOS_PKT_VCTCXO_TAMER_STATE_COARSE_MIN;
+    }
+
+    vctcxo_tamer_reset_counters(false);
+}
+
+void pkt_vctcxo_tamer_init(void)
+{
+    memset(&tamer, 0, sizeof(tamer));
+
+    /* Set the known/default values of the trim DAC cal line */
+    tamer.cal_line.point[0].y = TRIMDAC_MIN;
+    tamer.cal_line.point[1].y = TRIMDAC_MAX;
+
+    tamer.state = NIOS_PKT_VCTCXO_TAMER_STATE_COARSE_MIN;
+}
+
+void pkt_vctcxo_tamer(struct pkt_buf *b)
+{
+    uint8_t cmd;
+    bool seed_valid;
+    uint16_t seed;
+    bool success = true;
+
+    nios_pkt_vctcxo_tamer_unpack(b->req, &cmd, &seed_valid, &seed);
+
+    switch (cmd) {
+        case NIOS_PKT_VCTCXO_TAMER_CMD_QUERY:
+            break;
+
+        case NIOS_PKT_VCTCXO_TAMER_CMD_ACQUIRE:
+            acquire(seed_valid, seed);
+            break;
+
+        default:
+            success = false;
+            break;
+    }
+
+    nios_pkt_vctcxo_tamer_resp_pack(b->resp, success, tamer.flags,
+                                    tamer.state, tamer.count,
+                                    vctcxo_trim_dac_value,
+                                    tamer.err_1s, tamer.err_10s);
+}
+
+void pkt_vctcxo_tamer_work(void)
+{
+    line_t *line = &tamer.cal_line;
+
+    if (!vctcxo_tamer_pkt.ready) {
+        return;
+    }
+
+    vctcxo_tamer_pkt.ready = false;
+
+    tamer.err_1s  = vctcxo_tamer_pkt.pps_1s_error;
+    tamer.err_10s = vctcxo_tamer_pkt.pps_10s_error;
+
+    tamer.flags = NIOS_PKT_VCTCXO_TAMER_RESP_FLAG_MEAS_VALID;
+    if (vctcxo_tamer_pkt.pps_1s_error_flag) {
+        tamer.flags |= NIOS_PKT_VCTCXO_TAMER_RESP_FLAG_ERR_1S;
+    }
+    if (vctcxo_tamer_pkt.pps_10s_error_flag) {
+        tamer.flags |= NIOS_PKT_VCTCXO_TAMER_RESP_FLAG_ERR_10S;
+    }
+    if (vctcxo_tamer_pkt.pps_100s_error_flag) {
+        tamer.flags |= NIOS_PKT_VCTCXO_TAMER_RESP_FLAG_ERR_100S;
+    }
+
+    if (tamer.count < UINT8_MAX) {
+        tamer.count++;
+    }
+
+    switch (tamer.state) {
+
+        case NIOS_PKT_VCTCXO_TAMER_STATE_COARSE_MIN:
+
+            /* Tune to the minimum DAC value */
+            line->point[0].y = TRIMDAC_MIN;
+            vctcxo_trim_dac_write(0x08, TRIMDAC_MIN);
+
+            /* State to enter upon the next interrupt */
+            tamer.state = NIOS_PKT_VCTCXO_TAMER_STATE_COARSE_MAX;
+            break;
+
+        case NIOS_PKT_VCTCXO_TAMER_STATE_COARSE_MAX:
+
+            /* We have the error from the minimum DAC setting, store it
+             * as the 'x' coordinate for the first point */
+            line->point[0].x = vctcxo_tamer_pkt.pps_1s_error;
+
+            /* Tune to the maximum DAC value */
+            line->point[1].y = TRIMDAC_MAX;
+            vctcxo_trim_dac_write(0x08, TRIMDAC_MAX);
+
+            /* State to enter upon the next interrupt */
+            tamer.state = NIOS_PKT_VCTCXO_TAMER_STATE_COARSE_DONE;
+            break;
+
+        case NIOS_PKT_VCTCXO_TAMER_STATE_COARSE_DONE:
+
+            /* We have the error from the maximum DAC setting, store it
+             * as the 'x' coordinate for the second point */
+            line->point[1].x = vctcxo_tamer_pkt.pps_1s_error;
+
+            if (apply_cal_line()) {
+                tamer.state = NIOS_PKT_VCTCXO_TAMER_STATE_FINE;
+            } else {
+                tamer.state = NIOS_PKT_VCTCXO_TAMER_STATE_COARSE_MIN;
+            }
+            break;
+
+        case NIOS_PKT_VCTCXO_TAMER_STATE_SEED_CHECK:
+
+            /* The seed is usually the value that was error-free when it was
+             * stored. If it still is, and the DAC's response is known from
+             * an earlier acquisition, fine tuning can take it from here. */
+            if (!vctcxo_tamer_pkt.pps_1s_error_flag && line->slope != 0) {
+                tamer.state = NIOS_PKT_VCTCXO_TAMER_STATE_FINE;
+                break;
+            }
+
+            /* Otherwise, take a second point a step away from the seed, in
+             * place of measuring the extremes of the DAC's range */
+            line->point[0].x = vctcxo_tamer_pkt.pps_1s_error;
+
+            if (line->point[0].y + TRIMDAC_STEP <= TRIMDAC_MAX) {
+                line->point[1].y = line->point[0].y + TRIMDAC_STEP;
+            } else {
+                line->point[1].y = line->point[0].y - TRIMDAC_STEP;
+            }
+
+            vctcxo_trim_dac_write(0x08, line->point[1].y);
+
+            tamer.state = NIOS_PKT_VCTCXO_TAMER_STATE_SEED_STEP;
+            break;
+
+        case NIOS_PKT_VCTCXO_TAMER_STATE_SEED_STEP:
+
+            line->point[1].x = vctcxo_tamer_pkt.pps_1s_error;
+
+            if (apply_cal_line()) {
+                tamer.state = NIOS_PKT_VCTCXO_TAMER_STATE_FINE;
+            } else {
+                /* The step didn't change the error measurably, so fall back
+                 * to measuring across the full range */
+                DBG("VCTCXO seed step made no difference, coarse tuning\n");
+                tamer.state = NIOS_PKT_VCTCXO_TAMER_STATE_COARSE_MIN;
+            }
+            break;
+
+        case NIOS_PKT_VCTCXO_TAMER_STATE_FINE:
+
+            /* We should be extremely close to a perfectly tuned
+             * VCTCXO, but some minor adjustments need to be made */
+
+            /* Check the magnitude of the errors starting with the
+             * one second count. If an error is greater than the maxium
+             * tolerated error, adjust the trim DAC by the error (Hz)
+             * multiplied by the slope (in counts/Hz) and scale the
+             * result by the precision interval (e.g. 1s, 10s, 100s). */
+            if (vctcxo_tamer_pkt.pps_1s_error_flag) {
+                vctcxo_trim_dac_write(0x08, (vctcxo_trim_dac_value -
+                    ((vctcxo_tamer_pkt.pps_1s_error * line->slope)/1)));
+            } else if (vctcxo_tamer_pkt.pps_10s_error_flag) {
+                vctcxo_trim_dac_write(0x08, (vctcxo_trim_dac_value -
+                    ((vctcxo_tamer_pkt.pps_10s_error * line->slope)/10)));
+            } else if (vctcxo_tamer_pkt.pps_100s_error_flag) {
+                vctcxo_trim_dac_write(0x08, (vctcxo_trim_dac_value -
+                    ((vctcxo_tamer_pkt.pps_100s_error * line->slope)/100)));
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    /* Take PPS counters out of reset */
+    vctcxo_tamer_reset_counters(false);
+
+    /* Enable interrupts */
+    vctcxo_tamer_enable_isr(true);
+}
@@ -45,6 +45,10 @@ entity fx3_gpif is
     meta_enable         :   in  std_logic;
     packet_enable       :   in  std_logic;
 
+    -- RX meta messages span 2**rx_meta_msg_log2 DMA buffers, of which only
+    -- the first begins with a meta header
+    rx_meta_msg_log2    :   in  unsigned(1 downto 0) := "00";
+
     -- TX FIFO
     tx_fifo_write       :   out std_logic;
     tx_fifo_full        :   in  std_logic;
@@ -134,6 +138,8 @@ architecture sample_shuffler of fx3_gpif is
         dma_idle        :   std_logic;
         rx_meta_en      :   std_logic;
         tx_meta_en      :   std_logic;
+        rx_meta_cont    :   std_logic;
+        rx_meta_bufs    :   integer range 0 to 7;
         rx_fifo_rd      :   std_logic;
         tx_fifo_wr      :   std_logic;
         rxm_fifo_rd     :   std_logic;
@@ -159,6 +165,8 @@ architecture sample_shuffler of fx3_gpif is
         dma_idle        =>  '0',
         rx_meta_en      =>  '0',
         tx_meta_en      =>  '0',
+        rx_meta_cont    =>  '0',
+        rx_meta_bufs    =>  0,
         rx_fifo_rd      =>  '0',
         tx_fifo_wr      =>  '0',
         rxm_fifo_rd     =>  '0',
@@ -189,6 +197,7 @@ architecture sample_shuffler of fx3_gpif is
     signal underrun             :   std_logic;
     signal dma_req              :   dma_handshake_t;
     signal gpif_buf_size        :   natural range GPIF_BUF_SIZE_HS to GPIF_BUF_SIZE_SS := GPIF_BUF_SIZE_SS;
+    signal rx_meta_msg_bufs     :   natural range 1 to 8 := 1;
 
     attribute preserve                  :   boolean;
     attribute preserve  of can_rx       :   signal is true;
@@ -255,12 +264,20 @@ begin
     begin
         if (reset = '1') then
             gpif_buf_size       <= GPIF_BUF_SIZE_SS;
+            rx_meta_msg_bufs    <= 1;
         elsif (rising_edge(pclk)) then
             if (usb_speed = '0') then
                 gpif_buf_size   <= GPIF_BUF_SIZE_SS;
             else
                 gpif_buf_size   <= GPIF_BUF_SIZE_HS;
             end if;
+
+            -- Packets carry their own lengths, and always have a header
+            if (packet_enable = '1') then
+                rx_meta_msg_bufs <= 1;
+            else
+                rx_meta_msg_bufs <= 2**to_integer(rx_meta_msg_log2);
+            end if;
         end if;
     end process calculate_conditionals;
 
@@ -409,8 +426,15 @@ begin
                 future.fini_downcount   <= FINI_DOWNCOUNT_RESET;
                 future.finishing_rx   <= '0';
 
+                -- A message in progress is abandoned when RX or meta is
+                -- disabled; the RX FIFOs are cleared along with it
+                if (current.rx_meta_en = '0' or dma_rx_enable = '0') then
+                    future.rx_meta_bufs <= 0;
+                end if;
+
                 if (current.dma_idle = '1') then
-                    if (should_rx and ( (rx_meta_fifo_empty = '0' and current.rx_meta_en = '1')
+                    if (should_rx and ( (current.rx_meta_en = '1' and
+                                         (current.rx_meta_bufs /= 0 or rx_meta_fifo_empty = '0'))
                                         or (current.rx_meta_en = '0') ) ) then
                         -- There is an RX to perform (sending data to FX3).
                         future.ack_downcount    <= ACK_DOWNCOUNT_READ;
@@ -418,6 +442,18 @@ begin
                         future.rx_current_dma   <= RX0;
                         future.state            <= SETUP_RD;
 
+                        -- Buffers after the first of a meta message carry
+                        -- samples only
+                        if (current.rx_meta_bufs /= 0) then
+                            future.rx_meta_cont <= '1';
+                            future.rx_meta_bufs <= current.rx_meta_bufs - 1;
+                        else
+                            future.rx_meta_cont <= '0';
+                            if (current.rx_meta_en = '1') then
+                                future.rx_meta_bufs <= rx_meta_msg_bufs - 1;
+                            end if;
+                        end if;
+
                     elsif (should_tx) then
                         -- There is a TX to perform (getting data from FX3).
                         future.ack_downcount    <= ACK_DOWNCOUNT_WRITE;
@@ -436,7 +472,7 @@ begin
                 -- clocks.
 
                 -- GPIF, FIFO, next state depend on rx_meta_en
-                if (current.rx_meta_en = '0') then
+                if (current.rx_meta_en = '0' or current.rx_meta_cont = '1') then
                     future.gpif_mode    <= RX;
                     future.rx_fifo_rd   <= '1';
                     next_state          := SAMPLE_READ;
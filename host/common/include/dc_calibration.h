@@ -34,6 +34,25 @@
 extern "C" {
 #endif
 
+/**
+ * Strategies for searching for the DC correction values at each frequency,
+ * once a coarse estimate has been made.
+ */
+enum dc_calibration_search {
+    /**
+     * Measure every correction value in a window around the coarse estimate.
+     * This is the default.
+     */
+    DC_CAL_SEARCH_SWEEP = 0,
+
+    /**
+     * Golden-section search of the same window. This requires far fewer
+     * measurements, but assumes the DC offset magnitude has a single minimum
+     * within the window.
+     */
+    DC_CAL_SEARCH_GOLDEN,
+};
+
 struct dc_calibration_params {
     uint64_t frequency;
     int16_t corr_i;
@@ -47,6 +66,9 @@ struct dc_calibration_params {
     int16_t mid_dc_q;
     int16_t min_dc_i;
     int16_t min_dc_q;
+
+    /* Input: Correction value search strategy */
+    enum dc_calibration_search search;
 };
 
 /**
@@ -144,6 +166,54 @@ int dc_calibration(struct bladerf *dev, bladerf_module module,
                    struct dc_calibration_params *params,
                    size_t num_params, bool show_status);
 
+/**
+ * Callback invoked by dc_calibration_table() as each point is completed.
+ *
+ * @param[in]   p       Results for the completed point
+ * @param[in]   index   Index of `p` in the `params` list
+ * @param[in]   arg     User data provided to dc_calibration_table()
+ *
+ * @return 0 to continue, or a libbladeRF error value to abort calibration.
+ *         This value is returned by dc_calibration_table().
+ */
+typedef int (*dc_calibration_table_cb)(const struct dc_calibration_params *p,
+                                       size_t index, void *arg);
+
+/**
+ * Calibrate a list of frequencies for generating a DC calibration table.
+ *
+ * This produces the same results as dc_calibration(), but is better suited
+ * to long lists of frequencies. Samples are streamed continuously across all
+ * points, their analysis is performed by worker threads while the next
+ * correction value is measured, and the retune to each point is overlapped
+ * with the analysis of the previous one.
+ *
+ * For RX, FPGAs that can run the DC offset search in the NIOS II search all
+ * points in one pass before the residual errors and AGC DC-LUT entries are
+ * measured, and the `search` field is not used.
+ *
+ * Points are completed, and `cb` is called, in the order they appear in
+ * `params`. This allows one to fill in a table as the calibration progresses.
+ *
+ * @pre dc_calibration_lms6() should have been called for all modules prior to
+ *      using this function.
+ *
+ * @param[in]       dev         Device handle
+ * @param[in]       module      BLADERF_MODULE_RX or BLADERF_MODULE_TX
+ * @param[inout]    params      DC calibration input and output parameters,
+ *                              as described for dc_calibration()
+ * @param[in]       num_params  Number of entries in the `params` list.
+ * @param[in]       cb          Called as each point is completed. May be NULL.
+ * @param[in]       cb_arg      User data passed to `cb`
+ * @param[in]       show_status Print status information to stdout
+ *
+ * @return 0 on success or libbladeRF return value on failure.
+ */
+int dc_calibration_table(struct bladerf *dev, bladerf_module module,
+                         struct dc_calibration_params *params,
+                         size_t num_params, dc_calibration_table_cb cb,
+                         void *cb_arg, bool show_status);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
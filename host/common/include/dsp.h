@@ -0,0 +1,136 @@
+/**
+ * @file dsp.h
+ *
+ * @brief Basic DSP primitives for SC16 Q11 and complex float samples
+ *
+ * These routines select an implementation suited to the host CPU (e.g., AVX2
+ * on x86) the first time any of them is called. Results may differ between
+ * implementations in the least significant bits of floating point values, as
+ * the order of accumulation is not guaranteed.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef DSP_H_
+#define DSP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Complex float sample. Arrays of these are laid out as interleaved I/Q
+ * floats.
+ */
+struct dsp_complexf {
+    float i;
+    float q;
+};
+
+/**
+ * @return Name of the implementation in use (e.g., "generic", "avx2")
+ */
+const char *dsp_impl_name(void);
+
+/**
+ * Compute the mean of each component of interleaved SC16 Q11 samples
+ *
+ * @param[in]   samples     Interleaved I/Q samples
+ * @param[in]   count       Number of samples (I/Q pairs). If 0, the outputs
+ *                          are set to 0.
+ * @param[out]  mean_i      Mean of the I components
+ * @param[out]  mean_q      Mean of the Q components
+ */
+void dsp_mean_sc16(const int16_t *samples, size_t count,
+                   float *mean_i, float *mean_q);
+
+/**
+ * Compute the peak instantaneous power of interleaved SC16 Q11 samples
+ *
+ * @param[in]   samples     Interleaved I/Q samples
+ * @param[in]   count       Number of samples (I/Q pairs)
+ *
+ * @return Max of I^2 + Q^2 over the samples, or 0 if count is 0
+ */
+uint32_t dsp_peak_power_sc16(const int16_t *samples, size_t count);
+
+/**
+ * Compute the peak instantaneous power of interleaved SC8 Q7 samples
+ *
+ * @param[in]   samples     Interleaved I/Q samples
+ * @param[in]   count       Number of samples (I/Q pairs)
+ *
+ * @return Max of I^2 + Q^2 over the samples, or 0 if count is 0
+ */
+uint32_t dsp_peak_power_sc8(const int8_t *samples, size_t count);
+
+/**
+ * Convert interleaved SC16 Q11 samples to complex float, mixing them with a
+ * Fs/4 tone. This is a quarter-rate NCO, which can be implemented exactly
+ * via the sign and I/Q swaps of e^(+/- j*pi*n/2). The phase starts at 0.
+ *
+ * @param[in]   samples     Interleaved I/Q samples
+ * @param[in]   count       Number of samples (I/Q pairs)
+ * @param[in]   negative    Mix with -Fs/4 if true, and +Fs/4 otherwise
+ * @param[in]   scale       Scale factor applied to each output value
+ * @param[out]  out         Output samples. Must have room for `count`
+ *                          entries.
+ */
+void dsp_mix_fs4_sc16(const int16_t *samples, size_t count, bool negative,
+                      float scale, struct dsp_complexf *out);
+
+/**
+ * Apply a real-valued FIR filter to complex float samples, assuming zero
+ * initial filter state:
+ *
+ *  out[n] = sum over m of taps[m] * in[n - m], with in[k < 0] = 0
+ *
+ * @param[in]   taps        Filter taps
+ * @param[in]   num_taps    Number of taps
+ * @param[in]   in          Input samples
+ * @param[out]  out         Output samples. Must not overlap `in`.
+ * @param[in]   count       Number of samples to filter
+ */
+void dsp_fir_complexf(const float *taps, size_t num_taps,
+                      const struct dsp_complexf *in,
+                      struct dsp_complexf *out, size_t count);
+
+/**
+ * Compute the mean magnitude of complex float samples
+ *
+ * @param[in]   in          Input samples
+ * @param[in]   count       Number of samples
+ *
+ * @return Mean of |in[n]|, or 0 if count is 0
+ */
+float dsp_mean_magnitude_complexf(const struct dsp_complexf *in, size_t count);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,210 @@
+/**
+ * @file iqz.h
+ *
+ * @brief Lossless compression of recorded SC16 Q11 and SC8 Q7 samples
+ *
+ * An IQZ file holds the interleaved I/Q samples of one or more channels, split
+ * into blocks of a fixed number of samples that are coded independently, so
+ * that they may be compressed and decompressed in parallel, and any block may
+ * be decoded on its own.
+ *
+ * Each block's I and Q values are coded in groups of 64. A group is stored
+ * either as-is or as the differences from the same component of the previous
+ * sample, whichever needs fewer bits, and its values are zigzag-coded and
+ * bit-packed at the width of the largest. Signals that use little of the
+ * ADC's range, or are oversampled, shrink the most. Full-scale noise does not
+ * shrink much beyond its 12 bits.
+ *
+ * All fields are little-endian. A file is laid out as:
+ *
+ *  - Header (16 bytes): "BRF-IQZ1", version (u8, 1), sample format (u8, an
+ *    iqz_format value), # of channels (u8), reserved (u8, 0), and # of
+ *    samples per block (u32)
+ *  - Blocks, each holding the # of bytes that follow its 8-byte header (u32)
+ *    and its # of samples (u32). Every block but the last is full. Its
+ *    header is followed by a width byte per group (bit 7 set for
+ *    differences, and bits 4:0 holding the width), and then the groups,
+ *    each taking 8 bytes per bit of width.
+ *  - Block index: the offset of each block in the file (u64)
+ *  - Footer (24 bytes): the offset of the block index (u64), the total # of
+ *    samples (u64), and "BRF-IQZX"
+ *
+ * A file whose index and footer were not written, e.g., as a capture was
+ * interrupted, is read by walking the block headers instead.
+ *
+ * Samples are always counted as I/Q pairs, across all channels.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef IQZ_H_
+#define IQZ_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Max # of interleaved channels in a file */
+#define IQZ_MAX_CHANNELS 8
+
+/** Default # of samples per block */
+#define IQZ_DEFAULT_BLOCK_SAMPLES (64 * 1024)
+
+/** Max # of compression threads of a writer */
+#define IQZ_MAX_THREADS 16
+
+/**
+ * Format of the coded samples
+ */
+enum iqz_format {
+    IQZ_FMT_SC16_Q11 = 0, /**< SC16 Q11, in host byte order */
+    IQZ_FMT_SC8_Q7   = 1, /**< SC8 Q7 */
+};
+
+/**
+ * Description of a file's samples
+ */
+struct iqz_info {
+    enum iqz_format format;
+    unsigned int num_channels;  /**< # of interleaved channels */
+    unsigned int block_samples; /**< # of samples per block. A multiple of
+                                 *   32 and of num_channels. */
+    uint64_t num_samples;       /**< Total # of samples */
+    uint64_t num_blocks;        /**< # of blocks */
+};
+
+struct iqz_writer;
+struct iqz_reader;
+
+/**
+ * Size of a sample of a format
+ *
+ * @param[in]   format      Sample format
+ *
+ * @return Size of an I/Q pair, in bytes
+ */
+size_t iqz_sample_size(enum iqz_format format);
+
+/**
+ * Begin compressing samples to a file, writing its header
+ *
+ * Blocks are compressed by a pool of threads as they fill, and written in
+ * order by whichever thread finishes one next. The file is only written by
+ * those threads until iqz_writer_close().
+ *
+ * @param[out]  writer          Writer handle
+ * @param[in]   f               Newly opened, empty file, opened in binary
+ *                              mode. It is not closed by the writer.
+ * @param[in]   format          Sample format
+ * @param[in]   num_channels    # of interleaved channels, up to
+ *                              IQZ_MAX_CHANNELS
+ * @param[in]   block_samples   # of samples per block, a multiple of 32 and
+ *                              of num_channels, or 0 for
+ *                              IQZ_DEFAULT_BLOCK_SAMPLES
+ * @param[in]   num_threads     # of compression threads, up to
+ *                              IQZ_MAX_THREADS, or 0 for one per online CPU
+ *
+ * @return 0 on success, or an errno value on failure
+ */
+int iqz_writer_open(struct iqz_writer **writer,
+                    FILE *f,
+                    enum iqz_format format,
+                    unsigned int num_channels,
+                    unsigned int block_samples,
+                    unsigned int num_threads);
+
+/**
+ * Compress samples. This only waits for the compression threads once they
+ * fall a few blocks behind.
+ *
+ * @param[in]   writer      Writer handle
+ * @param[in]   samples     Interleaved samples
+ * @param[in]   n           # of samples
+ *
+ * @return 0 on success, or an errno value if writing has failed
+ */
+int iqz_writer_write(struct iqz_writer *writer, const void *samples, size_t n);
+
+/**
+ * Compress any remaining samples, write the block index and footer, and free
+ * the writer. The file is flushed, but not closed.
+ *
+ * @param[in]   writer      Writer handle. Does nothing if NULL.
+ *
+ * @return 0 on success, or an errno value if writing has failed
+ */
+int iqz_writer_close(struct iqz_writer *writer);
+
+/**
+ * Open a file's contents for decompression
+ *
+ * @param[out]  reader      Reader handle
+ * @param[in]   data        File contents, e.g., as memory-mapped. These must
+ *                          remain valid until iqz_reader_close().
+ * @param[in]   len         Length of data, in bytes
+ *
+ * @return 0 on success, ENOMEM, or EINVAL if data does not begin with a
+ *         valid header
+ */
+int iqz_reader_open(struct iqz_reader **reader, const void *data, size_t len);
+
+/**
+ * @param[in]   reader      Reader handle
+ *
+ * @return Description of the file's samples
+ */
+const struct iqz_info *iqz_reader_info(const struct iqz_reader *reader);
+
+/**
+ * Decompress a block. Sample `i` of the file is in block
+ * `i / block_samples`. This may be called from several threads at once.
+ *
+ * @param[in]   reader      Reader handle
+ * @param[in]   block       Block to decode, from 0
+ * @param[out]  samples     Decoded samples, with room for block_samples
+ * @param[out]  n           # of samples decoded
+ *
+ * @return 0 on success, or EINVAL if the block is out of range or corrupt
+ */
+int iqz_reader_decode(const struct iqz_reader *reader,
+                      uint64_t block,
+                      void *samples,
+                      size_t *n);
+
+/**
+ * Free a reader
+ *
+ * @param[in]   reader      Reader handle. Does nothing if NULL.
+ */
+void iqz_reader_close(struct iqz_reader *reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -53,6 +53,15 @@ extern "C" {
 #define LOG_EXPAND__(x) #x
 #define LOG_EXPAND_(x) LOG_EXPAND__(x)
 
+/**
+ * Messages below this level are compiled out entirely, regardless of the
+ * runtime verbosity. This may be defined at build time to, e.g.,
+ * BLADERF_LOG_LEVEL_INFO to remove verbose and debug messages from hot paths.
+ */
+#ifndef LOG_MIN_LEVEL
+#   define LOG_MIN_LEVEL BLADERF_LOG_LEVEL_VERBOSE
+#endif
+
 /**
  * @defgroup LOG_MACROS Logging macros
  * @{
@@ -86,14 +95,19 @@ extern "C" {
 
 #ifdef LOG_INCLUDE_FILE_INFO
 #   define LOG_WRITE(LEVEL, LEVEL_STRING, ...) \
-    do { log_write(LEVEL, LEVEL_STRING  \
-                     " @ "  LOG_EXPAND_(THIS_FILE) \
-                     ":" LOG_STRINGIFY_(__LINE__) "] " \
-                     __VA_ARGS__); \
+    do { if ((LEVEL) >= LOG_MIN_LEVEL) { \
+            log_write(LEVEL, LEVEL_STRING  \
+                        " @ "  LOG_EXPAND_(THIS_FILE) \
+                        ":" LOG_STRINGIFY_(__LINE__) "] " \
+                        __VA_ARGS__); \
+        } \
     } while (0)
 #else
 #   define LOG_WRITE(LEVEL, LEVEL_STRING, ...) \
-    do { log_write(LEVEL, LEVEL_STRING "] " __VA_ARGS__); } while (0)
+    do { if ((LEVEL) >= LOG_MIN_LEVEL) { \
+            log_write(LEVEL, LEVEL_STRING "] " __VA_ARGS__); \
+        } \
+    } while (0)
 #endif
 
 /**
@@ -101,6 +115,11 @@ extern "C" {
  * should only be invoked indirectly through one of the log_*
  * convenience macros above to ensure consistent formatting of log messages.
  *
+ * With LOG_ASYNC_ENABLED, the message is formatted into a buffer owned by
+ * the calling thread, and written out by a background thread. The caller
+ * never blocks on the log output; if its buffer is full, the message is
+ * dropped and the number of dropped messages is logged later.
+ *
  * @param   level       The severity level of the message
  * @param   format      The printf-style format string
  * @param   ...         Optional values for format specifier substitution
@@ -126,6 +145,20 @@ void log_set_verbosity(bladerf_log_level level);
 #define log_set_verbosity(level) do {} while (0)
 #endif
 
+/**
+ * Write out any messages still queued by the asynchronous backend, and
+ * write all subsequent messages synchronously. This is called when the
+ * library is unloaded.
+ *
+ * Without LOG_ASYNC_ENABLED, messages are always written synchronously by
+ * log_write(), and this has no effect.
+ */
+#ifdef LOGGING_ENABLED
+void log_shutdown(void);
+#else
+#define log_shutdown() do {} while (0)
+#endif
+
 /**
  * @brief      Gets the current filter level for displayed log messages.
  *
@@ -71,4 +71,42 @@
 #   define MUTEX_DESTROY(m) pthread_mutex_destroy(m)
 #endif
 
+/* Atomic accessors for 32-bit integer (and enum) values that are shared
+ * between threads without a lock. All accesses are sequentially consistent.
+ *
+ * ATOMIC_CAS(p, o, n) sets *p to n if it is equal to o, and evaluates to
+ * true if it did so.
+ *
+ * CPU_RELAX() is a hint to the processor that the caller is busy-waiting.
+ */
+#if defined(_MSC_VER) && !defined(__clang__)
+#   include <intrin.h>
+#   define ATOMIC_LOAD(p)     _InterlockedOr((volatile long *)(p), 0)
+#   define ATOMIC_STORE(p, v) \
+        ((void)_InterlockedExchange((volatile long *)(p), (long)(v)))
+#   define ATOMIC_INC(p)      _InterlockedIncrement((volatile long *)(p))
+#   define ATOMIC_DEC(p)      _InterlockedDecrement((volatile long *)(p))
+#   define ATOMIC_CAS(p, o, n) \
+        (_InterlockedCompareExchange((volatile long *)(p), (long)(n), \
+                                     (long)(o)) == (long)(o))
+#   if defined(_M_IX86) || defined(_M_X64)
+#       define CPU_RELAX()    _mm_pause()
+#   else
+#       define CPU_RELAX()    __yield()
+#   endif
+#else
+#   define ATOMIC_LOAD(p)     __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#   define ATOMIC_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+#   define ATOMIC_INC(p)      __atomic_add_fetch((p), 1, __ATOMIC_SEQ_CST)
+#   define ATOMIC_DEC(p)      __atomic_sub_fetch((p), 1, __ATOMIC_SEQ_CST)
+#   define ATOMIC_CAS(p, o, n) __sync_bool_compare_and_swap((p), (o), (n))
+#   if defined(__i386__) || defined(__x86_64__)
+#       define CPU_RELAX()    __builtin_ia32_pause()
+#   elif defined(__aarch64__) || defined(__arm__)
+#       define CPU_RELAX()    __asm__ __volatile__("yield")
+#   else
+#       define CPU_RELAX()    do { } while (0)
+#   endif
+#endif
+
 #endif
@@ -406,6 +406,9 @@ const char *backend_description(bladerf_backend b)
         case BLADERF_BACKEND_DUMMY:
             return "Dummy";
 
+        case BLADERF_BACKEND_NET:
+            return "Network";
+
         default:
             return "Unknown";
     }
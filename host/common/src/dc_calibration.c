@@ -30,18 +30,33 @@
 
 #include <libbladeRF.h>
 
+#include "host_config.h"
 #include "dc_calibration.h"
 #include "conversions.h"
-
-struct complexf {
-    float i;
-    float q;
-};
+#include "dsp.h"
+#include "thread.h"
 
 struct gain_mode {
     bladerf_lna_gain lna_gain;
     int rxvga1, rxvga2;
 };
+
+/* Table mode analysis workers. See the "Table generation" section below.
+ *
+ * A capture buffer is taken with cal_pool_acquire(), filled by the caller,
+ * and handed to a worker with one of the cal_pool_submit_*() functions.
+ * Results are valid once cal_pool_wait() returns. */
+struct cal_pool;
+
+static int16_t *cal_pool_acquire(struct cal_pool *pool);
+static void cal_pool_release(struct cal_pool *pool, int16_t *samples);
+static void cal_pool_submit_rx(struct cal_pool *pool, int16_t *samples,
+                               float *mean_i, float *mean_q);
+static void cal_pool_submit_tx(struct cal_pool *pool, int16_t *samples,
+                               bool rx_low, float *mag);
+static void cal_pool_wait(struct cal_pool *pool);
+static int cal_pool_create(struct cal_pool **pool, unsigned int num_samples);
+static void cal_pool_free(struct cal_pool *pool);
 /*******************************************************************************
  * Debug items
  ******************************************************************************/
@@ -88,7 +103,7 @@ static void save_sc16q11(const char *name, int16_t *samples, unsigned int count)
 
 //#define ENABLE_SAVE_COMPLEXF
 #ifdef ENABLE_SAVE_COMPLEXF
-static void save_complexf(const char *name, struct complexf *samples,
+static void save_complexf(const char *name, struct dsp_complexf *samples,
                           unsigned int count)
 {
     unsigned int n;
@@ -308,6 +323,134 @@ static int rx_samples(struct bladerf *dev, int16_t *samples,
     return status;
 }
 
+/* Golden-section search for the correction value that minimizes a measured
+ * DC offset magnitude, over the grid min, min + step, ..., max.
+ *
+ * The search is driven by the caller: corr_search_next() provides the next
+ * correction value to measure, and corr_search_update() records the result.
+ * This allows two searches to share measurements. The magnitude is assumed
+ * to be unimodal over the grid. */
+
+#define CORR_SEARCH_MAX_LEN (4096 / 16 + 1) /* -2048:16:2048 */
+
+struct corr_search {
+    int16_t min;
+    int16_t step;
+    unsigned int len;
+    unsigned int lo, hi;    /* Indices of the current bracket, inclusive */
+    float mag[CORR_SEARCH_MAX_LEN];
+    bool valid[CORR_SEARCH_MAX_LEN];
+};
+
+static void corr_search_init(struct corr_search *s,
+                             int16_t min, int16_t max, int16_t step)
+{
+    s->min  = min;
+    s->step = step;
+    s->len  = (max >= min) ? (unsigned int) ((max - min) / step + 1) : 1;
+
+    if (s->len > CORR_SEARCH_MAX_LEN) {
+        s->len = CORR_SEARCH_MAX_LEN;
+    }
+
+    s->lo = 0;
+    s->hi = s->len - 1;
+
+    memset(s->valid, 0, sizeof(s->valid));
+}
+
+static inline int16_t corr_search_value(const struct corr_search *s,
+                                        unsigned int idx)
+{
+    return (int16_t) (s->min + (int) idx * s->step);
+}
+
+/* Record a measurement, if the correction value falls on the grid */
+static void corr_search_update(struct corr_search *s, int16_t value, float mag)
+{
+    unsigned int idx;
+
+    if (value < s->min || ((value - s->min) % s->step) != 0) {
+        return;
+    }
+
+    idx = (unsigned int) ((value - s->min) / s->step);
+    if (idx >= s->len) {
+        return;
+    }
+
+    /* Not using fabs() to avoid adding a -lm dependency */
+    s->mag[idx]   = (mag < 0) ? -mag : mag;
+    s->valid[idx] = true;
+}
+
+/* Returns true and sets `value` to the next correction value to measure, or
+ * returns false once the search is complete */
+static bool corr_search_next(struct corr_search *s, int16_t *value)
+{
+    const float golden_inv = 0.6180339887f;
+    unsigned int x1, x2, offset, n;
+
+    while ((s->hi - s->lo) > 2) {
+        offset = (unsigned int) ((s->hi - s->lo) * golden_inv + 0.5f);
+        x1 = s->hi - offset;
+        x2 = s->lo + offset;
+
+        if (x1 >= x2) {
+            x2 = x1 + 1;
+        }
+
+        if (!s->valid[x1]) {
+            *value = corr_search_value(s, x1);
+            return true;
+        }
+
+        if (!s->valid[x2]) {
+            *value = corr_search_value(s, x2);
+            return true;
+        }
+
+        if (s->mag[x1] <= s->mag[x2]) {
+            s->hi = x2;
+        } else {
+            s->lo = x1;
+        }
+    }
+
+    /* Measure whatever remains in the final bracket */
+    for (n = s->lo; n <= s->hi; n++) {
+        if (!s->valid[n]) {
+            *value = corr_search_value(s, n);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Get the best measurement recorded thus far */
+static void corr_search_best(const struct corr_search *s,
+                             int16_t *value, float *mag)
+{
+    unsigned int n;
+    unsigned int best = s->lo;
+    float best_mag = 0;
+    bool found = false;
+
+    for (n = 0; n < s->len; n++) {
+        if (s->valid[n] && (!found || s->mag[n] < best_mag)) {
+            best     = n;
+            best_mag = s->mag[n];
+            found    = true;
+        }
+    }
+
+    *value = corr_search_value(s, best);
+    if (mag != NULL) {
+        *mag = found ? best_mag : 2048;
+    }
+}
+
 
 
 /*******************************************************************************
@@ -316,7 +459,8 @@ static int rx_samples(struct bladerf *dev, int16_t *samples,
 
 #define RX_CAL_RATE             (3000000)
 #define RX_CAL_BW               (1500000)
-#define RX_CAL_TS_INC           (MS_TO_SAMPLES(15, RX_CAL_RATE))
+#define RX_CAL_SETTLE_MS        (15)
+#define RX_CAL_TS_INC           (MS_TO_SAMPLES(RX_CAL_SETTLE_MS, RX_CAL_RATE))
 #define RX_CAL_COUNT            (MS_TO_SAMPLES(5,  RX_CAL_RATE))
 
 #define RX_CAL_MAX_SWEEP_LEN    (2 * 2048 / 32) /* -2048 : 32 : 2048 */
@@ -332,6 +476,16 @@ struct rx_cal {
     uint64_t ts;
 
     uint64_t tx_freq;
+
+    uint64_t freq;          /* Current RX frequency */
+    uint64_t next_freq;     /* Table mode: frequency to tune to once the
+                             * current point's captures are complete */
+    struct cal_pool *pool;  /* Table mode: analysis workers, or NULL */
+
+    bool fpga_meter;        /* Means are measured by the FPGA power meter
+                             * instead of being computed from a capture */
+    bool presearched;       /* Table mode: corrections were already found by
+                             * the NIOS II, so only measure the residuals */
 };
 
 struct rx_cal_backup {
@@ -424,6 +578,7 @@ static int rx_cal_update_frequency(struct rx_cal *cal, uint64_t rx_freq)
         return status;
     }
 
+    cal->freq = rx_freq;
     cal->ts += RX_CAL_TS_INC;
 
     return status;
@@ -432,26 +587,11 @@ static int rx_cal_update_frequency(struct rx_cal *cal, uint64_t rx_freq)
 static inline void sample_mean(int16_t *samples, size_t count,
                                float *mean_i, float *mean_q)
 {
-    int64_t accum_i = 0;
-    int64_t accum_q = 0;
-
-    size_t n;
-
-
     if (count == 0) {
         assert(!"Invalid count (0) provided to sample_mean()");
-        *mean_i = 0;
-        *mean_q = 0;
-        return;
-    }
-
-    for (n = 0; n < (2 * count); n += 2) {
-        accum_i += samples[n];
-        accum_q += samples[n + 1];
     }
 
-    *mean_i = ((float) accum_i) / count;
-    *mean_q = ((float) accum_q) / count;
+    dsp_mean_sc16(samples, count, mean_i, mean_q);
 }
 
 static inline int set_rx_dc_corr(struct bladerf *dev, int16_t i, int16_t q)
@@ -469,6 +609,63 @@ static inline int set_rx_dc_corr(struct bladerf *dev, int16_t i, int16_t q)
     return status;
 }
 
+/* Measure the means at the current settings with the FPGA power meter, after
+ * the same settling time a capture would allow */
+static int rx_cal_meter_means(struct rx_cal *cal, float *mean_i, float *mean_q)
+{
+    int status;
+    struct bladerf_rx_power power;
+
+    usleep(RX_CAL_SETTLE_MS * 1000);
+
+    status = bladerf_measure_rx_power(cal->dev, BLADERF_CHANNEL_RX(0),
+                                      cal->num_samples, &power);
+    if (status != 0) {
+        return status;
+    }
+
+    *mean_i = (float) power.i_sum / power.num_samples;
+    *mean_q = (float) power.q_sum / power.num_samples;
+
+    return 0;
+}
+
+/* Capture samples at the current settings and compute their means. In table
+ * mode the means are computed by a worker, so they are not valid until
+ * cal_pool_wait() returns. */
+static int rx_cal_capture_means(struct rx_cal *cal,
+                                float *mean_i, float *mean_q)
+{
+    int status;
+    int16_t *samples;
+
+    if (cal->fpga_meter) {
+        return rx_cal_meter_means(cal, mean_i, mean_q);
+    }
+
+    if (cal->pool == NULL) {
+        status = rx_samples(cal->dev, cal->samples, cal->num_samples,
+                            &cal->ts, RX_CAL_TS_INC);
+        if (status == 0) {
+            sample_mean(cal->samples, cal->num_samples, mean_i, mean_q);
+        }
+
+        return status;
+    }
+
+    samples = cal_pool_acquire(cal->pool);
+
+    status = rx_samples(cal->dev, samples, cal->num_samples,
+                        &cal->ts, RX_CAL_TS_INC);
+    if (status != 0) {
+        cal_pool_release(cal->pool, samples);
+        return status;
+    }
+
+    cal_pool_submit_rx(cal->pool, samples, mean_i, mean_q);
+    return 0;
+}
+
 /* Get the mean for one of the coarse estimate points. If it seems that this
  * value might be (or close) causing us to clamp, adjust it and retry */
 static int rx_cal_coarse_means(struct rx_cal *cal, int16_t *corr_value,
@@ -486,13 +683,20 @@ static int rx_cal_coarse_means(struct rx_cal *cal, int16_t *corr_value,
             return status;
         }
 
-        status = rx_samples(cal->dev, cal->samples, cal->num_samples,
-                            &cal->ts, RX_CAL_TS_INC);
-        if (status != 0) {
-            return status;
-        }
+        if (cal->fpga_meter) {
+            status = rx_cal_meter_means(cal, mean_i, mean_q);
+            if (status != 0) {
+                return status;
+            }
+        } else {
+            status = rx_samples(cal->dev, cal->samples, cal->num_samples,
+                                &cal->ts, RX_CAL_TS_INC);
+            if (status != 0) {
+                return status;
+            }
 
-        sample_mean(cal->samples, cal->num_samples, mean_i, mean_q);
+            sample_mean(cal->samples, cal->num_samples, mean_i, mean_q);
+        }
 
         if (*mean_i > mean_limit_high || *mean_q > mean_limit_high ||
             *mean_i < mean_limit_low  || *mean_q < mean_limit_low    ) {
@@ -670,28 +874,16 @@ static int load_gains(struct rx_cal *cal, struct gain_mode *gain) {
 }
 
 static int rx_cal_dc_off(struct rx_cal *cal, struct gain_mode *gains,
-                        int16_t *dc_i, int16_t *dc_q)
+                         float *mean_i, float *mean_q)
 {
     int status = BLADERF_ERR_UNEXPECTED;
 
-    float mean_i, mean_q;
-
     status = load_gains(cal, gains);
     if (status != 0) {
         return status;
     }
 
-    status = rx_samples(cal->dev, cal->samples, cal->num_samples,
-                        &cal->ts, RX_CAL_TS_INC);
-    if (status != 0) {
-        return status;
-    }
-
-    sample_mean(cal->samples, cal->num_samples, &mean_i, &mean_q);
-    *dc_i = float_to_int16(mean_i);
-    *dc_q = float_to_int16(mean_q);
-
-    return 0;
+    return rx_cal_capture_means(cal, mean_i, mean_q);
 }
 
 static int rx_cal_sweep(struct rx_cal *cal,
@@ -705,24 +897,36 @@ static int rx_cal_sweep(struct rx_cal *cal,
     int16_t min_corr_i = 0;
     int16_t min_corr_q = 0;
 
+    float means_i[RX_CAL_MAX_SWEEP_LEN];
+    float means_q[RX_CAL_MAX_SWEEP_LEN];
     float mean_i, mean_q;
     float min_val_i, min_val_q;
 
     min_val_i = min_val_q = 2048;
 
-    for (n = 0; n < sweep_len; n++) {
+    assert(sweep_len <= RX_CAL_MAX_SWEEP_LEN);
+
+    status = 0;
+    for (n = 0; n < sweep_len && status == 0; n++) {
         status = set_rx_dc_corr(cal->dev, corr[n], corr[n]);
-        if (status != 0) {
-            return status;
+        if (status == 0) {
+            status = rx_cal_capture_means(cal, &means_i[n], &means_q[n]);
         }
+    }
 
-        status = rx_samples(cal->dev, cal->samples, cal->num_samples,
-                            &cal->ts, RX_CAL_TS_INC);
-        if (status != 0) {
-            return status;
-        }
+    /* Outstanding captures must be analyzed before means_i and means_q
+     * go out of scope, even on failure */
+    if (cal->pool != NULL) {
+        cal_pool_wait(cal->pool);
+    }
+
+    if (status != 0) {
+        return status;
+    }
 
-        sample_mean(cal->samples, cal->num_samples, &mean_i, &mean_q);
+    for (n = 0; n < sweep_len; n++) {
+        mean_i = means_i[n];
+        mean_q = means_q[n];
 
         PR_VERBOSE("  Corr=%4d, Mean_I=%4.2f, Mean_Q=%4.2f\n",
                    corr[n], mean_i, mean_q);
@@ -755,12 +959,166 @@ static int rx_cal_sweep(struct rx_cal *cal,
     return 0;
 }
 
+static void init_rx_cal_search(struct corr_search *s, int16_t est)
+{
+    /* Same window and granularity as init_rx_cal_sweep(), but for a
+     * single channel */
+    int16_t search_min = est - 12 * 32;
+    int16_t search_max = est + 12 * 32;
+
+    if (search_min < -2048) {
+        search_min = -2048;
+    }
+
+    if (search_max > 2048) {
+        search_max = 2048;
+    }
+
+    corr_search_init(s, (search_min / 32) * 32, (search_max / 32) * 32, 32);
+}
+
+/* Adaptive alternative to rx_cal_sweep(). Since the I and Q corrections may
+ * be set independently, both searches are performed at once. */
+static int rx_cal_search(struct rx_cal *cal, int16_t i_est, int16_t q_est,
+                         int16_t *result_i, int16_t *result_q,
+                         float *error_i, float *error_q)
+{
+    int status = 0;
+    struct corr_search search_i, search_q;
+    bool need_i, need_q;
+    int16_t corr_i, corr_q;
+    float mean_i, mean_q;
+
+    init_rx_cal_search(&search_i, i_est);
+    init_rx_cal_search(&search_q, q_est);
+
+    while (status == 0) {
+        need_i = corr_search_next(&search_i, &corr_i);
+        need_q = corr_search_next(&search_q, &corr_q);
+
+        if (!need_i && !need_q) {
+            break;
+        }
+
+        /* Hold a completed search at its result while the other finishes */
+        if (!need_i) {
+            corr_search_best(&search_i, &corr_i, NULL);
+        }
+
+        if (!need_q) {
+            corr_search_best(&search_q, &corr_q, NULL);
+        }
+
+        status = set_rx_dc_corr(cal->dev, corr_i, corr_q);
+        if (status == 0) {
+            status = rx_cal_capture_means(cal, &mean_i, &mean_q);
+        }
+
+        if (cal->pool != NULL) {
+            cal_pool_wait(cal->pool);
+        }
+
+        if (status == 0) {
+            PR_VERBOSE("  Corr=(%4d, %4d), Mean_I=%4.2f, Mean_Q=%4.2f\n",
+                       corr_i, corr_q, mean_i, mean_q);
+
+            corr_search_update(&search_i, corr_i, mean_i);
+            corr_search_update(&search_q, corr_q, mean_q);
+        }
+    }
+
+    if (status == 0) {
+        corr_search_best(&search_i, result_i, error_i);
+        corr_search_best(&search_q, result_q, error_q);
+    }
+
+    return status;
+}
+
+/* Apply corrections found by the NIOS II sweep and measure what is left */
+static int rx_cal_residual(struct rx_cal *cal, struct dc_calibration_params *p)
+{
+    int status;
+    float mean_i, mean_q;
+
+    status = set_rx_dc_corr(cal->dev, p->corr_i, p->corr_q);
+    if (status != 0) {
+        return status;
+    }
+
+    status = rx_cal_capture_means(cal, &mean_i, &mean_q);
+
+    if (cal->pool != NULL) {
+        cal_pool_wait(cal->pool);
+    }
+
+    if (status != 0) {
+        return status;
+    }
+
+    /* Not using fabs() to avoid adding a -lm dependency */
+    p->error_i = mean_i < 0 ? -mean_i : mean_i;
+    p->error_q = mean_q < 0 ? -mean_q : mean_q;
+
+    return 0;
+}
+
+/* Table mode on FPGAs that can run the RX DC search in the NIOS II: find the
+ * corrections for every point up front, leaving perform_rx_cal() to measure
+ * the residuals and the AGC DC-LUT entries. Returns BLADERF_ERR_UNSUPPORTED
+ * if the host has to search each point itself. */
+static int rx_cal_presearch(struct rx_cal *cal,
+                            struct dc_calibration_params *params,
+                            size_t params_count)
+{
+    int status;
+    size_t i;
+    bladerf_frequency *freqs;
+    int16_t *dc_i, *dc_q;
+
+    if (!cal->fpga_meter || params_count > UINT_MAX) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    freqs = calloc(params_count, sizeof(freqs[0]));
+    dc_i  = calloc(params_count, sizeof(dc_i[0]));
+    dc_q  = calloc(params_count, sizeof(dc_q[0]));
+    if (freqs == NULL || dc_i == NULL || dc_q == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto out;
+    }
+
+    for (i = 0; i < params_count; i++) {
+        freqs[i] = params[i].frequency;
+    }
+
+    status = bladerf_calibrate_rx_dc_sweep(cal->dev, freqs,
+                                           (unsigned int) params_count,
+                                           cal->num_samples, dc_i, dc_q);
+    if (status == 0) {
+        for (i = 0; i < params_count; i++) {
+            params[i].corr_i = dc_i[i];
+            params[i].corr_q = dc_q[i];
+        }
+
+        cal->presearched = true;
+    }
+
+out:
+    free(freqs);
+    free(dc_i);
+    free(dc_q);
+    return status;
+}
+
 static int perform_rx_cal(struct rx_cal *cal, struct dc_calibration_params *p)
 {
     int status;
     int16_t i_est, q_est;
     unsigned int sweep_len = RX_CAL_MAX_SWEEP_LEN;
     struct gain_mode saved_gains;
+    float agc_i[3], agc_q[3];
+    bladerf_fpga_size fpga_size;
 
     struct gain_mode agc_gains[] = {
         { .lna_gain = BLADERF_LNA_GAIN_MAX, .rxvga1 = 30, .rxvga2 = 15 },  /* AGC Max Gain */
@@ -768,9 +1126,25 @@ static int perform_rx_cal(struct rx_cal *cal, struct dc_calibration_params *p)
         { .lna_gain = BLADERF_LNA_GAIN_MID, .rxvga1 = 12, .rxvga2 = 0  }   /* AGC Min Gain */
     };
 
-    status = rx_cal_update_frequency(cal, p->frequency);
-    if (status != 0) {
-        return status;
+    if (p->search != DC_CAL_SEARCH_SWEEP && p->search != DC_CAL_SEARCH_GOLDEN) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* In table mode, the previous point may have already tuned to this one */
+    if (cal->freq != p->frequency) {
+        status = rx_cal_update_frequency(cal, p->frequency);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    if (cal->presearched) {
+        status = rx_cal_residual(cal, p);
+        if (status != 0) {
+            return status;
+        }
+
+        goto agc;
     }
 
     /* Get an initial guess at our correction values */
@@ -779,15 +1153,27 @@ static int perform_rx_cal(struct rx_cal *cal, struct dc_calibration_params *p)
         return status;
     }
 
-    /* Perform a finer sweep of correction values */
-    init_rx_cal_sweep(cal->corr_sweep, &sweep_len, i_est, q_est);
-
     /* Advance our timestmap just to account for any time we may have lost */
     cal->ts += RX_CAL_TS_INC;
 
-    status = rx_cal_sweep(cal, cal->corr_sweep, sweep_len,
-                          &p->corr_i, &p->corr_q,
-                          &p->error_i, &p->error_q);
+    /* Refine the correction values */
+    switch (p->search) {
+        case DC_CAL_SEARCH_SWEEP:
+            init_rx_cal_sweep(cal->corr_sweep, &sweep_len, i_est, q_est);
+            status = rx_cal_sweep(cal, cal->corr_sweep, sweep_len,
+                                  &p->corr_i, &p->corr_q,
+                                  &p->error_i, &p->error_q);
+            break;
+
+        case DC_CAL_SEARCH_GOLDEN:
+            status = rx_cal_search(cal, i_est, q_est,
+                                   &p->corr_i, &p->corr_q,
+                                   &p->error_i, &p->error_q);
+            break;
+
+        default:
+            status = BLADERF_ERR_INVAL;
+    }
 
     if (status != 0) {
         return status;
@@ -799,7 +1185,7 @@ static int perform_rx_cal(struct rx_cal *cal, struct dc_calibration_params *p)
         return status;
     }
 
-    bladerf_fpga_size fpga_size;
+agc:
     status = bladerf_get_fpga_size(cal->dev, &fpga_size);
     if (status != 0) {
         return status;
@@ -816,22 +1202,37 @@ static int perform_rx_cal(struct rx_cal *cal, struct dc_calibration_params *p)
         return status;
     }
 
-    status = rx_cal_dc_off(cal, &agc_gains[2], &p->min_dc_i, &p->min_dc_q);
-    if (status != 0) {
-        return status;
+    status = rx_cal_dc_off(cal, &agc_gains[2], &agc_i[2], &agc_q[2]);
+
+    if (status == 0) {
+        status = rx_cal_dc_off(cal, &agc_gains[1], &agc_i[1], &agc_q[1]);
     }
 
-    status = rx_cal_dc_off(cal, &agc_gains[1], &p->mid_dc_i, &p->mid_dc_q);
-    if (status != 0) {
-        return status;
+    if (status == 0) {
+        status = rx_cal_dc_off(cal, &agc_gains[0], &agc_i[0], &agc_q[0]);
     }
 
-    status = rx_cal_dc_off(cal, &agc_gains[0], &p->max_dc_i, &p->max_dc_q);
-    if (status != 0) {
-        return status;
+    if (status == 0) {
+        status = load_gains(cal, &saved_gains);
+    }
+
+    /* Tune to the next point while the workers finish with this one */
+    if (status == 0 && cal->next_freq != 0) {
+        status = rx_cal_update_frequency(cal, cal->next_freq);
+    }
+
+    if (cal->pool != NULL) {
+        cal_pool_wait(cal->pool);
     }
 
-    status = load_gains(cal, &saved_gains);
+    if (status == 0) {
+        p->max_dc_i = float_to_int16(agc_i[0]);
+        p->max_dc_q = float_to_int16(agc_q[0]);
+        p->mid_dc_i = float_to_int16(agc_i[1]);
+        p->mid_dc_q = float_to_int16(agc_q[1]);
+        p->min_dc_i = float_to_int16(agc_i[2]);
+        p->min_dc_q = float_to_int16(agc_q[2]);
+    }
 
     return status;
 }
@@ -841,6 +1242,7 @@ static int rx_cal_init_state(struct bladerf *dev,
                              struct rx_cal *state)
 {
     int status;
+    struct bladerf_rx_power power;
 
     state->dev = dev;
 
@@ -866,11 +1268,25 @@ static int rx_cal_init_state(struct bladerf *dev,
     /* Schedule first RX well into the future */
     state->ts += 20 * RX_CAL_TS_INC;
 
-    return status;
-}
-
-static int rx_cal_init(struct bladerf *dev)
-{
+    /* Older FPGAs have no power meter, so fall back to capturing samples */
+    status = bladerf_measure_rx_power(dev, BLADERF_CHANNEL_RX(0), 1, &power);
+    if (status == 0) {
+        state->fpga_meter = true;
+    } else if (status == BLADERF_ERR_UNSUPPORTED) {
+        state->fpga_meter = false;
+        status = 0;
+    } else {
+        return status;
+    }
+
+    PR_DBG("RX DC means from %s\n",
+           state->fpga_meter ? "FPGA power meter" : "sample captures");
+
+    return status;
+}
+
+static int rx_cal_init(struct bladerf *dev)
+{
     int status;
 
     status = bladerf_set_sample_rate(dev, BLADERF_MODULE_RX, RX_CAL_RATE, NULL);
@@ -898,9 +1314,14 @@ static int rx_cal_init(struct bladerf *dev)
     return status;
 }
 
-int dc_calibration_rx(struct bladerf *dev,
+/* Calibrate each of the specified points. In table mode, sweeps are analyzed
+ * by worker threads, each retune is overlapped with the analysis of the
+ * previous point, and `cb` is called as each point completes. */
+static int rx_cal_run(struct bladerf *dev,
                       struct dc_calibration_params *params,
-                      size_t params_count, bool print_status)
+                      size_t params_count, bool print_status,
+                      bool table_mode, dc_calibration_table_cb cb,
+                      void *cb_arg)
 {
     int status = 0;
     int retval = 0;
@@ -925,7 +1346,30 @@ int dc_calibration_rx(struct bladerf *dev,
         goto out;
     }
 
+    if (table_mode) {
+        status = rx_cal_presearch(&state, params, params_count);
+        if (status == BLADERF_ERR_UNSUPPORTED) {
+            status = 0;
+        } else if (status != 0) {
+            goto out;
+        }
+
+        PR_DBG("RX DC search on the %s\n",
+               state.presearched ? "NIOS II" : "host");
+
+        status = cal_pool_create(&state.pool, state.num_samples);
+        if (status != 0) {
+            goto out;
+        }
+    }
+
     for (i = 0; i < params_count && status == 0; i++) {
+        if (table_mode && (i + 1) < params_count) {
+            state.next_freq = params[i + 1].frequency;
+        } else {
+            state.next_freq = 0;
+        }
+
         status = perform_rx_cal(&state, &params[i]);
 
         if (status == 0 && print_status) {
@@ -948,6 +1392,10 @@ int dc_calibration_rx(struct bladerf *dev,
                        params[i].min_dc_i, params[i].min_dc_q, eol);
             fflush(stdout);
         }
+
+        if (status == 0 && cb != NULL) {
+            status = cb(&params[i], i, cb_arg);
+        }
     }
 
     if (print_status) {
@@ -955,6 +1403,7 @@ int dc_calibration_rx(struct bladerf *dev,
     }
 
 out:
+    cal_pool_free(state.pool);
     free(state.samples);
     free(state.corr_sweep);
 
@@ -973,6 +1422,14 @@ out:
     return retval;
 }
 
+int dc_calibration_rx(struct bladerf *dev,
+                      struct dc_calibration_params *params,
+                      size_t params_count, bool print_status)
+{
+    return rx_cal_run(dev, params, params_count, print_status,
+                      false, NULL, NULL);
+}
+
 
 
 /*******************************************************************************
@@ -1014,14 +1471,17 @@ struct tx_cal {
     struct bladerf *dev;
     int16_t *samples;           /* Raw samples */
     unsigned int num_samples;   /* Number of raw samples */
-    struct complexf *filt;      /* Filter state */
-    struct complexf *filt_out;  /* Filter output */
-    struct complexf *post_mix;  /* Post-filter, mixed to baseband */
+    struct dsp_complexf *filt_out;  /* Filter output */
+    struct dsp_complexf *post_mix;  /* Pre-filter, mixed to baseband */
     int16_t *sweep;             /* Correction sweep */
     float   *mag;               /* Magnitude results from sweep */
     uint64_t ts;                /* Timestamp */
     bladerf_loopback loopback;  /* Current loopback mode */
     bool rx_low;                /* RX tuned lower than TX */
+    uint64_t freq;              /* Current TX frequency */
+    uint64_t next_freq;         /* Table mode: frequency to tune to once the
+                                 * current point's captures are complete */
+    struct cal_pool *pool;      /* Table mode: analysis workers, or NULL */
 };
 
 /* Filter used to isolate contribution of TX LO leakage in received
@@ -1190,6 +1650,10 @@ static int tx_cal_update_frequency(struct tx_cal *state, uint64_t freq)
         }
     }
 
+    if (status == 0) {
+        state->freq = freq;
+    }
+
     return status;
 }
 
@@ -1286,7 +1750,6 @@ static void tx_cal_state_deinit(struct tx_cal *cal)
     free(cal->sweep);
     free(cal->mag);
     free(cal->samples);
-    free(cal->filt);
     free(cal->filt_out);
     free(cal->post_mix);
 }
@@ -1306,12 +1769,6 @@ static int tx_cal_state_init(struct bladerf *dev, struct tx_cal *cal)
         return BLADERF_ERR_MEM;
     }
 
-    /* Filter state */
-    cal->filt = malloc(2 * sizeof(cal->filt[0]) * tx_cal_filt_num_taps);
-    if (cal->filt == NULL) {
-        return BLADERF_ERR_MEM;
-    }
-
     /* Filter output */
     cal->filt_out = malloc(sizeof(cal->filt_out[0]) * cal->num_samples);
     if (cal->filt_out == NULL) {
@@ -1350,40 +1807,8 @@ static int tx_cal_state_init(struct bladerf *dev, struct tx_cal *cal)
  */
 static void tx_cal_filter(struct tx_cal *state)
 {
-    unsigned int n, m;
-    struct complexf *ins1, *ins2;
-    struct complexf *curr; /* Current filter state */
-    const struct complexf *filt_end = &state->filt[2 * tx_cal_filt_num_taps];
-
-    /* Reset filter state */
-    ins1 = &state->filt[0];
-    ins2 = &state->filt[tx_cal_filt_num_taps];
-    memset(state->filt, 0, 2 * sizeof(state->filt[0]) * tx_cal_filt_num_taps);
-
-    for (n = 0; n < state->num_samples; n++) {
-        /* Insert sample */
-        *ins1 = *ins2 = state->post_mix[n];
-
-        /* Convolve */
-        state->filt_out[n].i = 0;
-        state->filt_out[n].q = 0;
-        curr = ins2;
-
-        for (m = 0; m < tx_cal_filt_num_taps; m++, curr--) {
-            state->filt_out[n].i += tx_cal_filt[m] * curr->i;
-            state->filt_out[n].q += tx_cal_filt[m] * curr->q;
-        }
-
-        /* Update insertion points */
-        ins2++;
-        if (ins2 == filt_end) {
-            ins1 = &state->filt[0];
-            ins2 = &state->filt[tx_cal_filt_num_taps];
-        } else {
-            ins1++;
-        }
-
-    }
+    dsp_fir_complexf(tx_cal_filt, tx_cal_filt_num_taps,
+                     state->post_mix, state->filt_out, state->num_samples);
 }
 
 /* Deinterleave, scale, and mix with an -Fs/4 tone to shift TX DC offset out at
@@ -1393,110 +1818,191 @@ static void tx_cal_filter(struct tx_cal *state)
  */
 static void tx_cal_mix(struct tx_cal *state)
 {
-    unsigned int n, m;
-    int mix_state;
-    float scaled_i, scaled_q;
-
     /* Mix with -Fs/4 if RX is tuned "lower" than TX, and Fs/4 otherwise */
-    const int mix_state_inc = state->rx_low ? 1 : -1;
-    mix_state = 0;
+    dsp_mix_fs4_sc16(state->samples, state->num_samples, state->rx_low,
+                     1.0f / 2048.0f, state->post_mix);
+}
 
-    for (n = 0, m = 0; n < (2 * state->num_samples); n += 2, m++) {
-        scaled_i = state->samples[n]   / 2048.0f;
-        scaled_q = state->samples[n+1] / 2048.0f;
+/* Compute the average magnitude of the TX DC offset's contribution to
+ * state->samples */
+static void tx_cal_compute_magnitude(struct tx_cal *state, float *avg_mag)
+{
+    const unsigned int start = (tx_cal_filt_num_taps + 1) / 2;
 
-        switch (mix_state) {
-            case 0:
-                state->post_mix[m].i =  scaled_i;
-                state->post_mix[m].q =  scaled_q;
-                break;
+    /* Deinterleave & mix TX's DC offset contribution to baseband */
+    tx_cal_mix(state);
 
-            case 1:
-                state->post_mix[m].i =  scaled_q;
-                state->post_mix[m].q = -scaled_i;
-                break;
+    /* Filter out everything other than the TX DC offset's contribution */
+    tx_cal_filter(state);
 
-            case 2:
-                state->post_mix[m].i = -scaled_i;
-                state->post_mix[m].q = -scaled_q;
-                break;
+    /* Compute the average magnitude. We skip samples here to account for the
+     * group delay of the filter; the initial samples will be ramping up. */
+    *avg_mag = dsp_mean_magnitude_complexf(&state->filt_out[start],
+                                           state->num_samples - start);
 
-            case 3:
-                state->post_mix[m].i = -scaled_q;
-                state->post_mix[m].q =  scaled_i;
-                break;
+    /* Scale this back up to DAC/ADC counts, just for convenience */
+    *avg_mag *= 2048.0;
+}
+
+/* Fetch samples at the current settings and compute their average magnitude.
+ * In table mode the magnitude is computed by a worker, so it is not valid
+ * until cal_pool_wait() returns. */
+static int tx_cal_avg_magnitude(struct tx_cal *state, float *avg_mag)
+{
+    int status;
+    int16_t *samples;
+
+    if (state->pool == NULL) {
+        status = rx_samples(state->dev, state->samples, state->num_samples,
+                            &state->ts, TX_CAL_TS_INC);
+        if (status == 0) {
+            tx_cal_compute_magnitude(state, avg_mag);
         }
 
-        mix_state = (mix_state + mix_state_inc) & 0x3;
+        return status;
     }
+
+    samples = cal_pool_acquire(state->pool);
+
+    status = rx_samples(state->dev, samples, state->num_samples,
+                        &state->ts, TX_CAL_TS_INC);
+    if (status != 0) {
+        cal_pool_release(state->pool, samples);
+        return status;
+    }
+
+    cal_pool_submit_tx(state->pool, samples, state->rx_low, avg_mag);
+    return 0;
 }
 
-static int tx_cal_avg_magnitude(struct tx_cal *state, float *avg_mag)
+/* Apply the correction value and read the TX DC offset magnitude */
+static int tx_cal_measure_correction(struct tx_cal *state,
+                                     bladerf_correction c,
+                                     int16_t value, float *mag)
 {
     int status;
-    const unsigned int start = (tx_cal_filt_num_taps + 1) / 2;
-    unsigned int n;
-    float accum;
 
-    /* Fetch samples at the current settings */
-    status = rx_samples(state->dev, state->samples, state->num_samples,
-                        &state->ts, TX_CAL_TS_INC);
+    status = bladerf_set_correction(state->dev, BLADERF_MODULE_TX, c, value);
     if (status != 0) {
         return status;
     }
 
-    /* Deinterleave & mix TX's DC offset contribution to baseband */
-    tx_cal_mix(state);
+    state->ts += TX_CAL_TS_INC;
 
-    /* Filter out everything other than the TX DC offset's contribution */
-    tx_cal_filter(state);
+    return tx_cal_avg_magnitude(state, mag);
+}
 
-    /* Compute the power (magnitude^2 to alleviate need for square root).
-     * We skip samples here to account for the group delay of the filter;
-     * the initial samples will be ramping up. */
-    accum = 0;
-    for (n = start; n < state->num_samples; n++) {
-        const struct complexf *s = &state->filt_out[n];
-        const float m = (float) sqrt(s->i * s->i + s->q * s->q);
-        accum += m;
+/* Measure each of the specified correction values. If `last` is set, this
+ * is the final set of measurements for the current point, so in table mode
+ * the next point is tuned while the workers finish. */
+static int tx_cal_measure_corrections(struct tx_cal *state,
+                                      bladerf_correction c,
+                                      const int16_t *values,
+                                      unsigned int count,
+                                      float *mags, bool last)
+{
+    int status = 0;
+    unsigned int n;
+
+    for (n = 0; n < count && status == 0; n++) {
+        status = tx_cal_measure_correction(state, c, values[n], &mags[n]);
     }
 
-    *avg_mag = (accum / (state->num_samples - start));
+    if (state->pool != NULL) {
+        if (status == 0 && last && state->next_freq != 0) {
+            status = tx_cal_update_frequency(state, state->next_freq);
+        }
+
+        cal_pool_wait(state->pool);
+    }
 
-    /* Scale this back up to DAC/ADC counts, just for convenience */
-    *avg_mag *= 2048.0;
+    for (n = 0; n < count && status == 0; n++) {
+        PR_VERBOSE("  Corr=%5d, Avg_magnitude=%f\n", values[n], mags[n]);
+    }
 
     return status;
 }
 
-/* Apply the correction value and read the TX DC offset magnitude */
-static int tx_cal_measure_correction(struct tx_cal *state,
-                                     bladerf_correction c,
-                                     int16_t value, float *mag)
+/* Measure each correction value in [range_min : 16 : range_max]. See
+ * tx_cal_measure_corrections() regarding `last`. */
+static int tx_cal_sweep(struct tx_cal *state, bladerf_correction c,
+                        int16_t range_min, int16_t range_max, bool last,
+                        int16_t *min_corr, float *min_mag)
 {
     int status;
+    unsigned int n, sweep_len;
+    int16_t corr;
 
-    status = bladerf_set_correction(state->dev, BLADERF_MODULE_TX, c, value);
+    *min_corr = 0;
+    *min_mag  = 2048;
+
+    for (n = 0, corr = range_min;
+         corr <= range_max && n < TX_CAL_CORR_SWEEP_LEN;
+         n++, corr += 16) {
+        state->sweep[n] = corr;
+    }
+
+    sweep_len = n;
+
+    status = tx_cal_measure_corrections(state, c, state->sweep, sweep_len,
+                                        state->mag, last);
     if (status != 0) {
         return status;
     }
 
-    state->ts += TX_CAL_TS_INC;
+    for (n = 0; n < sweep_len; n++) {
+        float tmp = state->mag[n];
+
+        if (tmp < 0) {
+            tmp = -tmp;
+        }
+
+        if (tmp < *min_mag) {
+            *min_corr = state->sweep[n];
+            *min_mag  = tmp;
+        }
+    }
+
+    return 0;
+}
+
+/* Adaptive alternative to tx_cal_sweep() */
+static int tx_cal_search(struct tx_cal *state, bladerf_correction c,
+                         int16_t range_min, int16_t range_max,
+                         int16_t *min_corr, float *min_mag)
+{
+    int status = 0;
+    struct corr_search search;
+    int16_t corr;
+    float mag;
+
+    corr_search_init(&search, range_min, range_max, 16);
+
+    while (status == 0 && corr_search_next(&search, &corr)) {
+        status = tx_cal_measure_correction(state, c, corr, &mag);
+
+        if (state->pool != NULL) {
+            cal_pool_wait(state->pool);
+        }
+
+        if (status == 0) {
+            PR_VERBOSE("  Corr=%5d, Avg_magnitude=%f\n", corr, mag);
+            corr_search_update(&search, corr, mag);
+        }
+    }
 
-    status = tx_cal_avg_magnitude(state, mag);
     if (status == 0) {
-        PR_VERBOSE("  Corr=%5d, Avg_magnitude=%f\n", value, *mag);
+        corr_search_best(&search, min_corr, min_mag);
     }
 
     return status;
 }
 
-static int tx_cal_get_corr(struct tx_cal *state, bool i_ch,
+static int tx_cal_get_corr(struct tx_cal *state, bool i_ch, bool last,
+                           enum dc_calibration_search search,
                            int16_t *corr_value, float *error_value)
 {
     int status;
-    unsigned int n;
-    int16_t corr;
     float mag[4];
     float m1, m2, b1, b2;
     int16_t range_min, range_max;
@@ -1510,12 +2016,9 @@ static int tx_cal_get_corr(struct tx_cal *state, bool i_ch,
 
     PR_DBG("Getting coarse estimate for %c\n", i_ch ? 'I' : 'Q');
 
-    for (n = 0; n < 4; n++) {
-        status = tx_cal_measure_correction(state, corr_module, x[n], &mag[n]);
-        if (status != 0) {
-            return status;
-        }
-
+    status = tx_cal_measure_corrections(state, corr_module, x, 4, mag, false);
+    if (status != 0) {
+        return status;
     }
 
     m1 = (mag[1] - mag[0]) / (x[1] - x[0]);
@@ -1557,31 +2060,20 @@ static int tx_cal_get_corr(struct tx_cal *state, bool i_ch,
     }
 
 
-    PR_DBG("Performing correction value sweep: [%-5d : 16 :%5d]\n",
+    PR_DBG("Performing correction value %s: [%-5d : 16 :%5d]\n",
+           search == DC_CAL_SEARCH_GOLDEN ? "search" : "sweep",
            range_min, range_max);
 
-    min_corr = 0;
-    min_mag  = 2048;
-
-    for (n = 0, corr = range_min;
-         corr <= range_max && n < TX_CAL_CORR_SWEEP_LEN;
-         n++, corr += 16) {
-
-        float tmp;
-
-        status = tx_cal_measure_correction(state, corr_module, corr, &tmp);
-        if (status != 0) {
-            return status;
-        }
-
-        if (tmp < 0) {
-            tmp = -tmp;
-        }
+    if (search == DC_CAL_SEARCH_GOLDEN) {
+        status = tx_cal_search(state, corr_module, range_min, range_max,
+                               &min_corr, &min_mag);
+    } else {
+        status = tx_cal_sweep(state, corr_module, range_min, range_max, last,
+                              &min_corr, &min_mag);
+    }
 
-        if (tmp < min_mag) {
-            min_corr = corr;
-            min_mag  = tmp;
-        }
+    if (status != 0) {
+        return status;
     }
 
     /* Leave the device set to the minimum */
@@ -1599,27 +2091,37 @@ static int perform_tx_cal(struct tx_cal *state, struct dc_calibration_params *p)
 {
     int status = 0;
 
-    status = tx_cal_update_frequency(state, p->frequency);
-    if (status != 0) {
-        return status;
+    if (p->search != DC_CAL_SEARCH_SWEEP && p->search != DC_CAL_SEARCH_GOLDEN) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* In table mode, the previous point may have already tuned to this one */
+    if (state->freq != p->frequency) {
+        status = tx_cal_update_frequency(state, p->frequency);
+        if (status != 0) {
+            return status;
+        }
     }
 
     state->ts += TX_CAL_TS_INC;
 
     /* Perform I calibration */
-    status = tx_cal_get_corr(state, true, &p->corr_i, &p->error_i);
+    status = tx_cal_get_corr(state, true, false, p->search,
+                             &p->corr_i, &p->error_i);
     if (status != 0) {
         return status;
     }
 
     /* Perform Q calibration */
-    status = tx_cal_get_corr(state, false, &p->corr_q, &p->error_q);
+    status = tx_cal_get_corr(state, false, false, p->search,
+                             &p->corr_q, &p->error_q);
     if (status != 0) {
         return status;
     }
 
     /* Re-do I calibration to try to further fine-tune result */
-    status = tx_cal_get_corr(state, true, &p->corr_i, &p->error_i);
+    status = tx_cal_get_corr(state, true, true, p->search,
+                             &p->corr_i, &p->error_i);
     if (status != 0) {
         return status;
     }
@@ -1630,9 +2132,12 @@ static int perform_tx_cal(struct tx_cal *state, struct dc_calibration_params *p)
     return status;
 }
 
-int dc_calibration_tx(struct bladerf *dev,
+/* See rx_cal_run() */
+static int tx_cal_run(struct bladerf *dev,
                       struct dc_calibration_params *params,
-                      size_t num_params, bool print_status)
+                      size_t num_params, bool print_status,
+                      bool table_mode, dc_calibration_table_cb cb,
+                      void *cb_arg)
 {
     int status = 0;
     int retval = 0;
@@ -1672,7 +2177,20 @@ int dc_calibration_tx(struct bladerf *dev,
         goto out;
     }
 
+    if (table_mode) {
+        status = cal_pool_create(&state.pool, state.num_samples);
+        if (status != 0) {
+            goto out;
+        }
+    }
+
     for (i = 0; i < num_params && status == 0; i++) {
+        if (table_mode && (i + 1) < num_params) {
+            state.next_freq = params[i + 1].frequency;
+        } else {
+            state.next_freq = 0;
+        }
+
         status = perform_tx_cal(&state, &params[i]);
 
         if (status == 0 && print_status) {
@@ -1693,6 +2211,10 @@ int dc_calibration_tx(struct bladerf *dev,
                    eol);
             fflush(stdout);
         }
+
+        if (status == 0 && cb != NULL) {
+            status = cb(&params[i], i, cb_arg);
+        }
     }
 
     if (print_status) {
@@ -1700,6 +2222,8 @@ int dc_calibration_tx(struct bladerf *dev,
     }
 
 out:
+    cal_pool_free(state.pool);
+
     retval = status;
 
     status = bladerf_enable_module(dev, BLADERF_MODULE_RX, false);
@@ -1722,6 +2246,14 @@ out:
     return retval;
 }
 
+int dc_calibration_tx(struct bladerf *dev,
+                      struct dc_calibration_params *params,
+                      size_t num_params, bool print_status)
+{
+    return tx_cal_run(dev, params, num_params, print_status,
+                      false, NULL, NULL);
+}
+
 int dc_calibration(struct bladerf *dev, bladerf_module module,
                    struct dc_calibration_params *params,
                    size_t num_params, bool show_status)
@@ -1743,3 +2275,336 @@ int dc_calibration(struct bladerf *dev, bladerf_module module,
 
     return status;
 }
+
+
+
+/*******************************************************************************
+ * Table generation
+ ******************************************************************************/
+
+/* Number of analysis threads used in table mode */
+#ifndef DC_CAL_TABLE_WORKERS
+#   define DC_CAL_TABLE_WORKERS 2
+#endif
+
+/* Number of capture buffers. This bounds how far sample acquisition may run
+ * ahead of the analysis. */
+#define DC_CAL_TABLE_BUFFERS (4 * DC_CAL_TABLE_WORKERS)
+
+enum cal_job_state {
+    CAL_JOB_FREE,       /* Available to cal_pool_acquire() */
+    CAL_JOB_CAPTURING,  /* Owned by the caller, being filled */
+    CAL_JOB_PENDING,    /* Submitted, waiting for a worker */
+    CAL_JOB_ACTIVE,     /* Being analyzed by a worker */
+};
+
+struct cal_job {
+    enum cal_job_state state;
+    int16_t *samples;   /* Interleaved SC16 Q11 samples */
+    bool tx;            /* Compute TX DC magnitude rather than RX means */
+    bool rx_low;        /* TX only: RX tuned lower than TX */
+    float *result_i;    /* RX mean I, or TX magnitude */
+    float *result_q;    /* RX mean Q */
+};
+
+struct cal_worker {
+    struct cal_pool *pool;
+    pthread_t thread;
+    struct tx_cal scratch;  /* TX filter and mixer buffers */
+};
+
+struct cal_pool {
+    MUTEX lock;             /* Protects all job states and `pending` */
+    pthread_cond_t work;    /* Signaled on submission and shutdown */
+    pthread_cond_t done;    /* Signaled when a job returns to FREE */
+
+    struct cal_job jobs[DC_CAL_TABLE_BUFFERS];
+    unsigned int num_samples;
+    unsigned int pending;   /* Submitted jobs not yet completed */
+    bool stop;
+
+    struct cal_worker workers[DC_CAL_TABLE_WORKERS];
+    unsigned int num_workers;   /* Number of threads started */
+};
+
+static void *cal_pool_task(void *arg)
+{
+    struct cal_worker *w = (struct cal_worker *) arg;
+    struct cal_pool *pool = w->pool;
+    struct cal_job *job;
+    unsigned int i;
+
+    MUTEX_LOCK(&pool->lock);
+
+    while (true) {
+        job = NULL;
+        for (i = 0; i < DC_CAL_TABLE_BUFFERS && job == NULL; i++) {
+            if (pool->jobs[i].state == CAL_JOB_PENDING) {
+                job = &pool->jobs[i];
+            }
+        }
+
+        /* Submitted work is always drained before stopping */
+        if (job == NULL) {
+            if (pool->stop) {
+                break;
+            }
+
+            pthread_cond_wait(&pool->work, &pool->lock);
+            continue;
+        }
+
+        job->state = CAL_JOB_ACTIVE;
+        MUTEX_UNLOCK(&pool->lock);
+
+        if (job->tx) {
+            w->scratch.samples = job->samples;
+            w->scratch.rx_low  = job->rx_low;
+            tx_cal_compute_magnitude(&w->scratch, job->result_i);
+        } else {
+            sample_mean(job->samples, pool->num_samples,
+                        job->result_i, job->result_q);
+        }
+
+        MUTEX_LOCK(&pool->lock);
+        job->state = CAL_JOB_FREE;
+        pool->pending--;
+        pthread_cond_broadcast(&pool->done);
+    }
+
+    MUTEX_UNLOCK(&pool->lock);
+
+    return NULL;
+}
+
+static struct cal_job *cal_pool_find(struct cal_pool *pool, int16_t *samples)
+{
+    unsigned int i;
+
+    for (i = 0; i < DC_CAL_TABLE_BUFFERS; i++) {
+        if (pool->jobs[i].samples == samples) {
+            return &pool->jobs[i];
+        }
+    }
+
+    assert(!"Invalid capture buffer provided to cal_pool");
+    return NULL;
+}
+
+static int16_t *cal_pool_acquire(struct cal_pool *pool)
+{
+    struct cal_job *job = NULL;
+    unsigned int i;
+
+    MUTEX_LOCK(&pool->lock);
+
+    while (job == NULL) {
+        for (i = 0; i < DC_CAL_TABLE_BUFFERS && job == NULL; i++) {
+            if (pool->jobs[i].state == CAL_JOB_FREE) {
+                job = &pool->jobs[i];
+            }
+        }
+
+        if (job == NULL) {
+            pthread_cond_wait(&pool->done, &pool->lock);
+        }
+    }
+
+    job->state = CAL_JOB_CAPTURING;
+
+    MUTEX_UNLOCK(&pool->lock);
+
+    return job->samples;
+}
+
+static void cal_pool_release(struct cal_pool *pool, int16_t *samples)
+{
+    struct cal_job *job = cal_pool_find(pool, samples);
+
+    MUTEX_LOCK(&pool->lock);
+    job->state = CAL_JOB_FREE;
+    pthread_cond_broadcast(&pool->done);
+    MUTEX_UNLOCK(&pool->lock);
+}
+
+static void cal_pool_submit(struct cal_pool *pool, int16_t *samples,
+                            bool tx, bool rx_low,
+                            float *result_i, float *result_q)
+{
+    struct cal_job *job = cal_pool_find(pool, samples);
+
+    MUTEX_LOCK(&pool->lock);
+
+    assert(job->state == CAL_JOB_CAPTURING);
+
+    job->tx       = tx;
+    job->rx_low   = rx_low;
+    job->result_i = result_i;
+    job->result_q = result_q;
+    job->state    = CAL_JOB_PENDING;
+
+    pool->pending++;
+    pthread_cond_signal(&pool->work);
+
+    MUTEX_UNLOCK(&pool->lock);
+}
+
+static void cal_pool_submit_rx(struct cal_pool *pool, int16_t *samples,
+                               float *mean_i, float *mean_q)
+{
+    cal_pool_submit(pool, samples, false, false, mean_i, mean_q);
+}
+
+static void cal_pool_submit_tx(struct cal_pool *pool, int16_t *samples,
+                               bool rx_low, float *mag)
+{
+    cal_pool_submit(pool, samples, true, rx_low, mag, NULL);
+}
+
+static void cal_pool_wait(struct cal_pool *pool)
+{
+    MUTEX_LOCK(&pool->lock);
+
+    while (pool->pending != 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+
+    MUTEX_UNLOCK(&pool->lock);
+}
+
+static void cal_pool_free(struct cal_pool *pool)
+{
+    unsigned int i;
+
+    if (pool == NULL) {
+        return;
+    }
+
+    MUTEX_LOCK(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->work);
+    MUTEX_UNLOCK(&pool->lock);
+
+    for (i = 0; i < pool->num_workers; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+
+    for (i = 0; i < DC_CAL_TABLE_WORKERS; i++) {
+        /* The sample buffers belong to the jobs */
+        pool->workers[i].scratch.samples = NULL;
+        tx_cal_state_deinit(&pool->workers[i].scratch);
+    }
+
+    for (i = 0; i < DC_CAL_TABLE_BUFFERS; i++) {
+        free(pool->jobs[i].samples);
+    }
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->work);
+    MUTEX_DESTROY(&pool->lock);
+
+    free(pool);
+}
+
+static int cal_pool_create(struct cal_pool **pool_out,
+                           unsigned int num_samples)
+{
+    struct cal_pool *pool;
+    struct tx_cal *scratch;
+    unsigned int i;
+    int status = 0;
+
+    pool = calloc(1, sizeof(*pool));
+    if (pool == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    pool->num_samples = num_samples;
+
+    MUTEX_INIT(&pool->lock);
+
+    if (pthread_cond_init(&pool->work, NULL) != 0) {
+        MUTEX_DESTROY(&pool->lock);
+        free(pool);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    if (pthread_cond_init(&pool->done, NULL) != 0) {
+        pthread_cond_destroy(&pool->work);
+        MUTEX_DESTROY(&pool->lock);
+        free(pool);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    for (i = 0; i < DC_CAL_TABLE_BUFFERS; i++) {
+        pool->jobs[i].state   = CAL_JOB_FREE;
+        pool->jobs[i].samples =
+            malloc(2 * sizeof(pool->jobs[i].samples[0]) * num_samples);
+
+        if (pool->jobs[i].samples == NULL) {
+            status = BLADERF_ERR_MEM;
+            goto out;
+        }
+    }
+
+    for (i = 0; i < DC_CAL_TABLE_WORKERS; i++) {
+        scratch = &pool->workers[i].scratch;
+        scratch->num_samples = num_samples;
+
+        scratch->filt_out =
+            malloc(sizeof(scratch->filt_out[0]) * num_samples);
+        scratch->post_mix =
+            malloc(sizeof(scratch->post_mix[0]) * num_samples);
+
+        if (scratch->filt_out == NULL || scratch->post_mix == NULL) {
+            status = BLADERF_ERR_MEM;
+            goto out;
+        }
+    }
+
+    for (i = 0; i < DC_CAL_TABLE_WORKERS; i++) {
+        pool->workers[i].pool = pool;
+
+        if (pthread_create(&pool->workers[i].thread, NULL,
+                           cal_pool_task, &pool->workers[i]) != 0) {
+            status = BLADERF_ERR_UNEXPECTED;
+            goto out;
+        }
+
+        pool->num_workers++;
+    }
+
+out:
+    if (status != 0) {
+        cal_pool_free(pool);
+    } else {
+        *pool_out = pool;
+    }
+
+    return status;
+}
+
+int dc_calibration_table(struct bladerf *dev, bladerf_module module,
+                         struct dc_calibration_params *params,
+                         size_t num_params, dc_calibration_table_cb cb,
+                         void *cb_arg, bool show_status)
+{
+    int status;
+
+    switch (module) {
+        case BLADERF_MODULE_RX:
+            status = rx_cal_run(dev, params, num_params, show_status,
+                                true, cb, cb_arg);
+            break;
+
+        case BLADERF_MODULE_TX:
+            status = tx_cal_run(dev, params, num_params, show_status,
+                                true, cb, cb_arg);
+            break;
+
+        default:
+            status = BLADERF_ERR_INVAL;
+    }
+
+    return status;
+}
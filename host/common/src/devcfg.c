@@ -524,16 +524,12 @@ int devcfg_apply(struct bladerf *dev, const struct devcfg *c)
         }
     }
 
-    status = bladerf_set_frequency(dev, BLADERF_MODULE_RX, c->rx_frequency);
+    /* Queue up the remaining settings rather than waiting upon each. Sample
+     * rate and bandwidth are set first, so that each module is only tuned
+     * with its final filter configuration. */
+    status = bladerf_batch_begin(dev);
     if (status != 0) {
-        fprintf(stderr, "Failed to set RX frequency: %s\n",
-                bladerf_strerror(status));
-        return -1;
-    }
-
-    status = bladerf_set_frequency(dev, BLADERF_MODULE_TX, c->tx_frequency);
-    if (status != 0) {
-        fprintf(stderr, "Failed to set TX frequency: %s\n",
+        fprintf(stderr, "Failed to begin batch: %s\n",
                 bladerf_strerror(status));
         return -1;
     }
@@ -542,28 +538,42 @@ int devcfg_apply(struct bladerf *dev, const struct devcfg *c)
     if (status != 0) {
         fprintf(stderr, "Failed to set RX sample rate:%s\n",
                 bladerf_strerror(status));
-        return -1;
+        goto out_commit;
     }
 
     status = bladerf_set_sample_rate(dev, BLADERF_MODULE_TX, c->tx_samplerate, NULL);
     if (status != 0) {
         fprintf(stderr, "Failed to set TX sample rate: %s\n",
                 bladerf_strerror(status));
-        return -1;
+        goto out_commit;
     }
 
     status = bladerf_set_bandwidth(dev, BLADERF_MODULE_RX, c->rx_bandwidth, NULL);
     if (status != 0) {
         fprintf(stderr, "Failed to set RX bandwidth: %s\n",
                 bladerf_strerror(status));
-        return -1;
+        goto out_commit;
     }
 
     status = bladerf_set_bandwidth(dev, BLADERF_MODULE_TX, c->tx_bandwidth, NULL);
     if (status != 0) {
         fprintf(stderr, "Failed to set RX bandwidth: %s\n",
                 bladerf_strerror(status));
-        return -1;
+        goto out_commit;
+    }
+
+    status = bladerf_set_frequency(dev, BLADERF_MODULE_RX, c->rx_frequency);
+    if (status != 0) {
+        fprintf(stderr, "Failed to set RX frequency: %s\n",
+                bladerf_strerror(status));
+        goto out_commit;
+    }
+
+    status = bladerf_set_frequency(dev, BLADERF_MODULE_TX, c->tx_frequency);
+    if (status != 0) {
+        fprintf(stderr, "Failed to set TX frequency: %s\n",
+                bladerf_strerror(status));
+        goto out_commit;
     }
 
     if (strcasecmp(board_name, "bladerf1") == 0) {
@@ -571,39 +581,50 @@ int devcfg_apply(struct bladerf *dev, const struct devcfg *c)
         if (status != 0) {
             fprintf(stderr, "Failed to set RX LNA gain: %s\n",
                     bladerf_strerror(status));
-            return -1;
+            goto out_commit;
         }
 
         status = bladerf_set_rxvga1(dev, c->rxvga1);
         if (status != 0) {
             fprintf(stderr, "Failed to set RX VGA1 gain: %s\n",
                     bladerf_strerror(status));
-            return -1;
+            goto out_commit;
         }
 
         status = bladerf_set_rxvga2(dev, c->rxvga2);
         if (status != 0) {
             fprintf(stderr, "Failed to set RX VGA2 gain: %s\n",
                     bladerf_strerror(status));
-            return -1;
+            goto out_commit;
         }
 
         status = bladerf_set_txvga1(dev, c->txvga1);
         if (status != 0) {
             fprintf(stderr, "Failed to set TX VGA1 gain: %s\n",
                     bladerf_strerror(status));
-            return -1;
+            goto out_commit;
         }
 
         status = bladerf_set_txvga2(dev, c->txvga2);
         if (status != 0) {
             fprintf(stderr, "Failed to set TX VGA2 gain: %s\n",
                     bladerf_strerror(status));
-            return -1;
+            goto out_commit;
         }
     }
 
+    status = bladerf_batch_commit(dev);
+    if (status != 0) {
+        fprintf(stderr, "Failed to apply device configuration: %s\n",
+                bladerf_strerror(status));
+        return -1;
+    }
+
     return 0;
+
+out_commit:
+    bladerf_batch_commit(dev);
+    return -1;
 }
 
 int devcfg_perform_sync_config(struct bladerf *dev,
@@ -0,0 +1,433 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <math.h>
+#include <string.h>
+
+#include "dsp.h"
+#include "thread.h"
+
+/* AVX2 kernels are built with per-function target attributes, so that the
+ * rest of the program need not be compiled for AVX2, and selected at runtime
+ * if the CPU supports them. */
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#   define DSP_HAVE_AVX2 1
+#   include <immintrin.h>
+#   define DSP_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+struct dsp_impl {
+    const char *name;
+
+    void (*sum_sc16)(const int16_t *samples, size_t count,
+                     int64_t *sum_i, int64_t *sum_q);
+
+    uint32_t (*peak_power_sc16)(const int16_t *samples, size_t count);
+
+    void (*fir_complexf)(const float *taps, size_t num_taps,
+                         const float *in, float *out, size_t count);
+
+    float (*sum_magnitude_complexf)(const float *in, size_t count);
+};
+
+/*******************************************************************************
+ * Generic implementation
+ *
+ * These loops are kept free of branches and loop-carried dependencies (other
+ * than simple reductions) so that compilers may vectorize them for the
+ * baseline instruction set.
+ ******************************************************************************/
+
+static void sum_sc16_generic(const int16_t *samples, size_t count,
+                             int64_t *sum_i, int64_t *sum_q)
+{
+    int64_t accum_i = 0;
+    int64_t accum_q = 0;
+    size_t n;
+
+    for (n = 0; n < count; n++) {
+        accum_i += samples[2 * n];
+        accum_q += samples[2 * n + 1];
+    }
+
+    *sum_i = accum_i;
+    *sum_q = accum_q;
+}
+
+/* I^2 + Q^2 is at most 2^31, so it is accumulated unsigned */
+static uint32_t peak_power_sc16_generic(const int16_t *samples, size_t count)
+{
+    uint32_t peak = 0;
+    size_t n;
+
+    for (n = 0; n < count; n++) {
+        const int32_t i = samples[2 * n];
+        const int32_t q = samples[2 * n + 1];
+        const uint32_t p = (uint32_t)(i * i) + (uint32_t)(q * q);
+
+        peak = (p > peak) ? p : peak;
+    }
+
+    return peak;
+}
+
+/* The filter is applied one tap at a time over the entire (interleaved)
+ * buffer, which turns the convolution into `num_taps` contiguous
+ * multiply-accumulate passes. */
+static void fir_complexf_generic(const float *taps, size_t num_taps,
+                                 const float *in, float *out, size_t count)
+{
+    const size_t len = 2 * count;
+    size_t m, j;
+
+    memset(out, 0, len * sizeof(out[0]));
+
+    for (m = 0; m < num_taps && m < count; m++) {
+        const float t = taps[m];
+        float *o = &out[2 * m];
+        const size_t n = len - 2 * m;
+
+        for (j = 0; j < n; j++) {
+            o[j] += t * in[j];
+        }
+    }
+}
+
+static float sum_magnitude_complexf_generic(const float *in, size_t count)
+{
+    float accum = 0;
+    size_t n;
+
+    for (n = 0; n < count; n++) {
+        const float i = in[2 * n];
+        const float q = in[2 * n + 1];
+        accum += sqrtf(i * i + q * q);
+    }
+
+    return accum;
+}
+
+static const struct dsp_impl dsp_generic = {
+    "generic",
+    sum_sc16_generic,
+    peak_power_sc16_generic,
+    fir_complexf_generic,
+    sum_magnitude_complexf_generic,
+};
+
+/*******************************************************************************
+ * AVX2 implementation
+ ******************************************************************************/
+
+#ifdef DSP_HAVE_AVX2
+
+/* Number of 16-sample iterations after which the 32-bit accumulator lanes are
+ * flushed. Each lane gains at most 2^15 in magnitude per iteration. */
+#define SUM_SC16_AVX2_FLUSH 32768
+
+DSP_TARGET_AVX2
+static void sum_sc16_avx2(const int16_t *samples, size_t count,
+                          int64_t *sum_i, int64_t *sum_q)
+{
+    /* _mm256_madd_epi16() against these selects the I or Q value from
+     * each 32-bit I/Q pair */
+    const __m256i sel_i = _mm256_set1_epi32(0x00000001);
+    const __m256i sel_q = _mm256_set1_epi32(0x00010000);
+
+    int64_t accum_i = 0;
+    int64_t accum_q = 0;
+    int32_t lanes[8];
+    size_t n = 0;
+    size_t iter, k;
+
+    while (count - n >= 8) {
+        __m256i acc_i = _mm256_setzero_si256();
+        __m256i acc_q = _mm256_setzero_si256();
+
+        for (iter = 0; iter < SUM_SC16_AVX2_FLUSH && count - n >= 8;
+             iter++, n += 8) {
+            const __m256i v =
+                _mm256_loadu_si256((const __m256i *) &samples[2 * n]);
+
+            acc_i = _mm256_add_epi32(acc_i, _mm256_madd_epi16(v, sel_i));
+            acc_q = _mm256_add_epi32(acc_q, _mm256_madd_epi16(v, sel_q));
+        }
+
+        _mm256_storeu_si256((__m256i *) lanes, acc_i);
+        for (k = 0; k < 8; k++) {
+            accum_i += lanes[k];
+        }
+
+        _mm256_storeu_si256((__m256i *) lanes, acc_q);
+        for (k = 0; k < 8; k++) {
+            accum_q += lanes[k];
+        }
+    }
+
+    for (; n < count; n++) {
+        accum_i += samples[2 * n];
+        accum_q += samples[2 * n + 1];
+    }
+
+    *sum_i = accum_i;
+    *sum_q = accum_q;
+}
+
+DSP_TARGET_AVX2
+static uint32_t peak_power_sc16_avx2(const int16_t *samples, size_t count)
+{
+    __m256i peak = _mm256_setzero_si256();
+    uint32_t lanes[8];
+    uint32_t result = 0;
+    size_t n, k;
+
+    for (n = 0; n + 8 <= count; n += 8) {
+        const __m256i v = _mm256_loadu_si256((const __m256i *) &samples[2 * n]);
+
+        /* Each 32-bit lane of the product is I^2 + Q^2 for one sample, which
+         * may only be read correctly as unsigned */
+        peak = _mm256_max_epu32(peak, _mm256_madd_epi16(v, v));
+    }
+
+    _mm256_storeu_si256((__m256i *) lanes, peak);
+    for (k = 0; k < 8; k++) {
+        result = (lanes[k] > result) ? lanes[k] : result;
+    }
+
+    for (; n < count; n++) {
+        const int32_t i = samples[2 * n];
+        const int32_t q = samples[2 * n + 1];
+        const uint32_t p = (uint32_t)(i * i) + (uint32_t)(q * q);
+
+        result = (p > result) ? p : result;
+    }
+
+    return result;
+}
+
+DSP_TARGET_AVX2
+static void fir_complexf_avx2(const float *taps, size_t num_taps,
+                              const float *in, float *out, size_t count)
+{
+    const size_t len = 2 * count;
+    size_t m, j;
+
+    memset(out, 0, len * sizeof(out[0]));
+
+    for (m = 0; m < num_taps && m < count; m++) {
+        const __m256 t = _mm256_set1_ps(taps[m]);
+        float *o = &out[2 * m];
+        const size_t n = len - 2 * m;
+
+        for (j = 0; j + 8 <= n; j += 8) {
+            const __m256 x = _mm256_loadu_ps(&in[j]);
+            const __m256 y = _mm256_loadu_ps(&o[j]);
+            _mm256_storeu_ps(&o[j], _mm256_add_ps(y, _mm256_mul_ps(t, x)));
+        }
+
+        for (; j < n; j++) {
+            o[j] += taps[m] * in[j];
+        }
+    }
+}
+
+DSP_TARGET_AVX2
+static float sum_magnitude_complexf_avx2(const float *in, size_t count)
+{
+    __m256 acc = _mm256_setzero_ps();
+    float lanes[8];
+    float accum = 0;
+    size_t n, k;
+
+    for (n = 0; n + 8 <= count; n += 8) {
+        __m256 a = _mm256_loadu_ps(&in[2 * n]);
+        __m256 b = _mm256_loadu_ps(&in[2 * n + 8]);
+
+        a = _mm256_mul_ps(a, a);
+        b = _mm256_mul_ps(b, b);
+
+        /* Each element of the horizontal add is i^2 + q^2 for one sample.
+         * The samples are permuted across lanes, which is irrelevant here. */
+        acc = _mm256_add_ps(acc, _mm256_sqrt_ps(_mm256_hadd_ps(a, b)));
+    }
+
+    _mm256_storeu_ps(lanes, acc);
+    for (k = 0; k < 8; k++) {
+        accum += lanes[k];
+    }
+
+    for (; n < count; n++) {
+        const float i = in[2 * n];
+        const float q = in[2 * n + 1];
+        accum += sqrtf(i * i + q * q);
+    }
+
+    return accum;
+}
+
+static const struct dsp_impl dsp_avx2 = {
+    "avx2",
+    sum_sc16_avx2,
+    peak_power_sc16_avx2,
+    fir_complexf_avx2,
+    sum_magnitude_complexf_avx2,
+};
+
+#endif
+
+/*******************************************************************************
+ * Dispatch
+ ******************************************************************************/
+
+static const struct dsp_impl *dsp = &dsp_generic;
+static pthread_once_t dsp_once = PTHREAD_ONCE_INIT;
+
+static void dsp_select(void)
+{
+#ifdef DSP_HAVE_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        dsp = &dsp_avx2;
+    }
+#endif
+}
+
+static inline const struct dsp_impl *dsp_get(void)
+{
+    pthread_once(&dsp_once, dsp_select);
+    return dsp;
+}
+
+const char *dsp_impl_name(void)
+{
+    return dsp_get()->name;
+}
+
+void dsp_mean_sc16(const int16_t *samples, size_t count,
+                   float *mean_i, float *mean_q)
+{
+    int64_t sum_i, sum_q;
+
+    if (count == 0) {
+        *mean_i = 0;
+        *mean_q = 0;
+        return;
+    }
+
+    dsp_get()->sum_sc16(samples, count, &sum_i, &sum_q);
+
+    *mean_i = ((float) sum_i) / count;
+    *mean_q = ((float) sum_q) / count;
+}
+
+uint32_t dsp_peak_power_sc16(const int16_t *samples, size_t count)
+{
+    return dsp_get()->peak_power_sc16(samples, count);
+}
+
+uint32_t dsp_peak_power_sc8(const int8_t *samples, size_t count)
+{
+    uint32_t peak = 0;
+    size_t n;
+
+    for (n = 0; n < count; n++) {
+        const int32_t i = samples[2 * n];
+        const int32_t q = samples[2 * n + 1];
+        const uint32_t p = (uint32_t)(i * i + q * q);
+
+        peak = (p > peak) ? p : peak;
+    }
+
+    return peak;
+}
+
+void dsp_mix_fs4_sc16(const int16_t *samples, size_t count, bool negative,
+                      float scale, struct dsp_complexf *out)
+{
+    /* Multiplying by e^(-j*pi*n/2) cycles through (i, q), (q, -i),
+     * (-i, -q), and (-q, i). A +Fs/4 shift visits these in reverse order
+     * after the first. Unrolling by 4 leaves a branch-free loop body. */
+    const float s1 = negative ? scale : -scale;
+    size_t n;
+
+    for (n = 0; n + 4 <= count; n += 4) {
+        const int16_t *x = &samples[2 * n];
+        struct dsp_complexf *y = &out[n];
+
+        y[0].i =  scale * x[0];
+        y[0].q =  scale * x[1];
+        y[1].i =  s1    * x[3];
+        y[1].q = -s1    * x[2];
+        y[2].i = -scale * x[4];
+        y[2].q = -scale * x[5];
+        y[3].i = -s1    * x[7];
+        y[3].q =  s1    * x[6];
+    }
+
+    for (; n < count; n++) {
+        const float i = scale * samples[2 * n];
+        const float q = scale * samples[2 * n + 1];
+
+        switch (n & 0x3) {
+            case 0:
+                out[n].i =  i;
+                out[n].q =  q;
+                break;
+
+            case 1:
+                out[n].i =  negative ? q : -q;
+                out[n].q =  negative ? -i : i;
+                break;
+
+            case 2:
+                out[n].i = -i;
+                out[n].q = -q;
+                break;
+
+            case 3:
+                out[n].i = negative ? -q : q;
+                out[n].q = negative ? i : -i;
+                break;
+        }
+    }
+}
+
+void dsp_fir_complexf(const float *taps, size_t num_taps,
+                      const struct dsp_complexf *in,
+                      struct dsp_complexf *out, size_t count)
+{
+    dsp_get()->fir_complexf(taps, num_taps, (const float *) in,
+                            (float *) out, count);
+}
+
+float dsp_mean_magnitude_complexf(const struct dsp_complexf *in, size_t count)
+{
+    if (count == 0) {
+        return 0;
+    }
+
+    return dsp_get()->sum_magnitude_complexf((const float *) in, count) /
+           count;
+}
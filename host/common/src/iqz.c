@@ -0,0 +1,1085 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_config.h"
+#include "iqz.h"
+#include "thread.h"
+
+#if BLADERF_OS_WINDOWS
+#   include <windows.h>
+#else
+#   include <unistd.h>
+#endif
+
+/* The group analysis kernel is also built for AVX2, with a per-function
+ * target attribute, and selected at runtime if the CPU supports it, as in
+ * dsp.c */
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#   define IQZ_HAVE_AVX2 1
+#   define IQZ_TARGET_AVX2 __attribute__((target("avx2")))
+#   define IQZ_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#   define IQZ_ALWAYS_INLINE inline
+#endif
+
+#define IQZ_MAGIC           "BRF-IQZ1"
+#define IQZ_FOOTER_MAGIC    "BRF-IQZX"
+#define IQZ_VERSION         1
+
+#define IQZ_HEADER_LEN          16
+#define IQZ_BLOCK_HEADER_LEN    8
+#define IQZ_FOOTER_LEN          24
+
+/* # of values (I or Q) per group */
+#define IQZ_GROUP_LEN       64
+
+#define IQZ_WIDTH_DELTA     0x80
+#define IQZ_WIDTH_MASK      0x1f
+
+/* # of blocks buffered per compression thread */
+#define IQZ_SLOTS_PER_THREAD 2
+
+static inline void put_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline void put_le64(uint8_t *p, uint64_t v)
+{
+    put_le32(p, (uint32_t)v);
+    put_le32(p + 4, (uint32_t)(v >> 32));
+}
+
+static inline uint32_t get_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+static inline uint64_t get_le64(const uint8_t *p)
+{
+    return (uint64_t)get_le32(p) | ((uint64_t)get_le32(p + 4) << 32);
+}
+
+static inline unsigned int bit_width(uint32_t v)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (v == 0) ? 0 : 32 - (unsigned int)__builtin_clz(v);
+#else
+    unsigned int w = 0;
+    while (v != 0) {
+        w++;
+        v >>= 1;
+    }
+    return w;
+#endif
+}
+
+/* Widest value of each format: the difference of two int16_t values is 17
+ * bits, and that of two int8_t values is 9 */
+static inline unsigned int max_width(enum iqz_format format)
+{
+    return (format == IQZ_FMT_SC8_Q7) ? 9 : 17;
+}
+
+size_t iqz_sample_size(enum iqz_format format)
+{
+    return (format == IQZ_FMT_SC8_Q7) ? 2 * sizeof(int8_t)
+                                      : 2 * sizeof(int16_t);
+}
+
+/* Worst-case size of a coded block of `n` samples */
+static size_t max_block_len(enum iqz_format format, size_t n)
+{
+    const size_t groups = (2 * n + IQZ_GROUP_LEN - 1) / IQZ_GROUP_LEN;
+
+    return IQZ_BLOCK_HEADER_LEN +
+           groups * (1 + IQZ_GROUP_LEN / 8 * max_width(format));
+}
+
+/*******************************************************************************
+ * Group analysis
+ *
+ * Zigzag-code each value, and its difference from the value `stride` before
+ * it, and find the OR of each group's coded values, whose width is that of
+ * the group. This is kept free of branches so that it vectorizes.
+ ******************************************************************************/
+
+static inline uint32_t zigzag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t z)
+{
+    return (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+}
+
+static IQZ_ALWAYS_INLINE void analyze_body(const int32_t *v,
+                                           size_t stride,
+                                           size_t num_groups,
+                                           uint32_t *raw,
+                                           uint32_t *delta,
+                                           uint32_t *or_raw,
+                                           uint32_t *or_delta)
+{
+    size_t g, i;
+
+    for (g = 0; g < num_groups; g++) {
+        const size_t base = g * IQZ_GROUP_LEN;
+        uint32_t r = 0, d = 0;
+
+        for (i = 0; i < IQZ_GROUP_LEN; i++) {
+            const int32_t x = v[base + i];
+            const uint32_t zr = zigzag(x);
+            const uint32_t zd = zigzag(x - v[base + i - stride]);
+
+            raw[base + i]   = zr;
+            delta[base + i] = zd;
+            r |= zr;
+            d |= zd;
+        }
+
+        or_raw[g]   = r;
+        or_delta[g] = d;
+    }
+}
+
+typedef void (*analyze_fn)(const int32_t *v, size_t stride, size_t num_groups,
+                           uint32_t *raw, uint32_t *delta, uint32_t *or_raw,
+                           uint32_t *or_delta);
+
+static void analyze_generic(const int32_t *v, size_t stride,
+                            size_t num_groups, uint32_t *raw, uint32_t *delta,
+                            uint32_t *or_raw, uint32_t *or_delta)
+{
+    analyze_body(v, stride, num_groups, raw, delta, or_raw, or_delta);
+}
+
+#ifdef IQZ_HAVE_AVX2
+IQZ_TARGET_AVX2
+static void analyze_avx2(const int32_t *v, size_t stride,
+                         size_t num_groups, uint32_t *raw, uint32_t *delta,
+                         uint32_t *or_raw, uint32_t *or_delta)
+{
+    analyze_body(v, stride, num_groups, raw, delta, or_raw, or_delta);
+}
+#endif
+
+static analyze_fn analyze = analyze_generic;
+static pthread_once_t analyze_once = PTHREAD_ONCE_INIT;
+
+static void analyze_select(void)
+{
+#ifdef IQZ_HAVE_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        analyze = analyze_avx2;
+    }
+#endif
+}
+
+/*******************************************************************************
+ * Bit packing
+ *
+ * A group of 64 values at `width` bits fills exactly 2 * width 32-bit words,
+ * which are packed least significant bit first.
+ ******************************************************************************/
+
+static IQZ_ALWAYS_INLINE uint8_t *pack_body(const uint32_t *z, uint8_t *out,
+                                           unsigned int width)
+{
+    uint64_t acc      = 0;
+    unsigned int bits = 0;
+    size_t i;
+
+    for (i = 0; i < IQZ_GROUP_LEN; i++) {
+        acc |= (uint64_t)z[i] << bits;
+        bits += width;
+
+        if (bits >= 32) {
+            put_le32(out, (uint32_t)acc);
+            out  += 4;
+            acc >>= 32;
+            bits -= 32;
+        }
+    }
+
+    return out;
+}
+
+static IQZ_ALWAYS_INLINE const uint8_t *unpack_body(const uint8_t *in,
+                                                    uint32_t *z,
+                                                    unsigned int width)
+{
+    const uint64_t mask = ((uint64_t)1 << width) - 1;
+    uint64_t acc        = 0;
+    unsigned int bits   = 0;
+    size_t i;
+
+    for (i = 0; i < IQZ_GROUP_LEN; i++) {
+        if (bits < width) {
+            acc  |= (uint64_t)get_le32(in) << bits;
+            in   += 4;
+            bits += 32;
+        }
+
+        z[i]   = (uint32_t)(acc & mask);
+        acc  >>= width;
+        bits  -= width;
+    }
+
+    return in;
+}
+
+/* Each width is expanded separately, so that the loops above are unrolled
+ * with constant shifts */
+#define IQZ_WIDTH_CASES(f, ...) \
+    case 1: return f(__VA_ARGS__, 1); \
+    case 2: return f(__VA_ARGS__, 2); \
+    case 3: return f(__VA_ARGS__, 3); \
+    case 4: return f(__VA_ARGS__, 4); \
+    case 5: return f(__VA_ARGS__, 5); \
+    case 6: return f(__VA_ARGS__, 6); \
+    case 7: return f(__VA_ARGS__, 7); \
+    case 8: return f(__VA_ARGS__, 8); \
+    case 9: return f(__VA_ARGS__, 9); \
+    case 10: return f(__VA_ARGS__, 10); \
+    case 11: return f(__VA_ARGS__, 11); \
+    case 12: return f(__VA_ARGS__, 12); \
+    case 13: return f(__VA_ARGS__, 13); \
+    case 14: return f(__VA_ARGS__, 14); \
+    case 15: return f(__VA_ARGS__, 15); \
+    case 16: return f(__VA_ARGS__, 16); \
+    case 17: return f(__VA_ARGS__, 17);
+
+/* @pre width <= 17 */
+static uint8_t *pack_group(const uint32_t *z, unsigned int width, uint8_t *out)
+{
+    switch (width) {
+        IQZ_WIDTH_CASES(pack_body, z, out)
+        default:
+            return out;
+    }
+}
+
+/* @pre width <= 17 */
+static const uint8_t *unpack_group(const uint8_t *in, unsigned int width,
+                                   uint32_t *z)
+{
+    switch (width) {
+        IQZ_WIDTH_CASES(unpack_body, in, z)
+        default:
+            memset(z, 0, IQZ_GROUP_LEN * sizeof(z[0]));
+            return in;
+    }
+}
+
+/*******************************************************************************
+ * Block coding
+ ******************************************************************************/
+
+/* Per-thread working space for coding blocks of up to `block_samples` */
+struct iqz_scratch {
+    int32_t *values;    /* Preceded by `stride` zeros, the predictions of
+                         * the first sample's values */
+    uint32_t *raw;
+    uint32_t *delta;
+    uint32_t *or_raw;
+    uint32_t *or_delta;
+};
+
+static void scratch_free(struct iqz_scratch *s)
+{
+    free(s->values);
+    free(s->raw);
+    free(s->delta);
+    free(s->or_raw);
+    free(s->or_delta);
+    memset(s, 0, sizeof(*s));
+}
+
+static int scratch_alloc(struct iqz_scratch *s, size_t block_samples,
+                         size_t stride)
+{
+    const size_t groups = 2 * block_samples / IQZ_GROUP_LEN;
+    const size_t len    = groups * IQZ_GROUP_LEN;
+
+    s->values   = calloc(stride + len, sizeof(s->values[0]));
+    s->raw      = malloc(len * sizeof(s->raw[0]));
+    s->delta    = malloc(len * sizeof(s->delta[0]));
+    s->or_raw   = malloc(groups * sizeof(s->or_raw[0]));
+    s->or_delta = malloc(groups * sizeof(s->or_delta[0]));
+
+    if (s->values == NULL || s->raw == NULL || s->delta == NULL ||
+        s->or_raw == NULL || s->or_delta == NULL) {
+        scratch_free(s);
+        return ENOMEM;
+    }
+
+    return 0;
+}
+
+/* Code a block of `n` samples into `out`, returning its length */
+static size_t encode_block(enum iqz_format format,
+                           unsigned int num_channels,
+                           const void *samples,
+                           size_t n,
+                           struct iqz_scratch *s,
+                           uint8_t *out)
+{
+    const size_t stride     = 2 * (size_t)num_channels;
+    const size_t num_values = 2 * n;
+    const size_t groups     = (num_values + IQZ_GROUP_LEN - 1) / IQZ_GROUP_LEN;
+    int32_t *v              = s->values + stride;
+    uint8_t *widths         = out + IQZ_BLOCK_HEADER_LEN;
+    uint8_t *p              = widths + groups;
+    size_t i, g;
+
+    if (format == IQZ_FMT_SC8_Q7) {
+        const int8_t *in = samples;
+        for (i = 0; i < num_values; i++) {
+            v[i] = in[i];
+        }
+    } else {
+        const int16_t *in = samples;
+        for (i = 0; i < num_values; i++) {
+            v[i] = in[i];
+        }
+    }
+
+    /* Pad the last group by repeating the last sample, which adds nothing
+     * to its differences */
+    for (i = num_values; i < groups * IQZ_GROUP_LEN; i++) {
+        v[i] = v[i - stride];
+    }
+
+    analyze(v, stride, groups, s->raw, s->delta, s->or_raw, s->or_delta);
+
+    for (g = 0; g < groups; g++) {
+        const unsigned int wr = bit_width(s->or_raw[g]);
+        const unsigned int wd = bit_width(s->or_delta[g]);
+
+        if (wd < wr) {
+            widths[g] = (uint8_t)(IQZ_WIDTH_DELTA | wd);
+            p = pack_group(s->delta + g * IQZ_GROUP_LEN, wd, p);
+        } else {
+            widths[g] = (uint8_t)wr;
+            p = pack_group(s->raw + g * IQZ_GROUP_LEN, wr, p);
+        }
+    }
+
+    put_le32(out, (uint32_t)(p - widths));
+    put_le32(out + 4, (uint32_t)n);
+
+    return (size_t)(p - out);
+}
+
+/* Decode a block of `n` samples, whose contents after the header are `len`
+ * bytes, into `samples`
+ *
+ * returns 0 on success, EINVAL if it is corrupt */
+static int decode_block(enum iqz_format format,
+                        unsigned int num_channels,
+                        const uint8_t *block,
+                        size_t len,
+                        size_t n,
+                        void *samples)
+{
+    const size_t stride     = 2 * (size_t)num_channels;
+    const size_t num_values = 2 * n;
+    const size_t groups     = (num_values + IQZ_GROUP_LEN - 1) / IQZ_GROUP_LEN;
+    const uint8_t *widths   = block;
+    const uint8_t *p        = block + groups;
+    const uint8_t *end      = block + len;
+    int16_t *out16          = samples;
+    int8_t *out8            = samples;
+    uint32_t z[IQZ_GROUP_LEN];
+    size_t g, i, k, count;
+
+    if (len < groups) {
+        return EINVAL;
+    }
+
+    for (g = 0; g < groups; g++) {
+        const unsigned int width = widths[g] & IQZ_WIDTH_MASK;
+        const bool delta         = (widths[g] & IQZ_WIDTH_DELTA) != 0;
+
+        if (width > max_width(format) ||
+            (size_t)(end - p) < (size_t)IQZ_GROUP_LEN / 8 * width) {
+            return EINVAL;
+        }
+
+        p     = unpack_group(p, width, z);
+        k     = g * IQZ_GROUP_LEN;
+        count = num_values - k;
+        if (count > IQZ_GROUP_LEN) {
+            count = IQZ_GROUP_LEN;
+        }
+
+        /* Out-of-range values of a corrupt block are truncated */
+        if (format == IQZ_FMT_SC8_Q7) {
+            for (i = 0; i < count; i++, k++) {
+                int32_t x = unzigzag(z[i]);
+                if (delta && k >= stride) {
+                    x += out8[k - stride];
+                }
+                out8[k] = (int8_t)x;
+            }
+        } else {
+            for (i = 0; i < count; i++, k++) {
+                int32_t x = unzigzag(z[i]);
+                if (delta && k >= stride) {
+                    x += out16[k - stride];
+                }
+                out16[k] = (int16_t)x;
+            }
+        }
+    }
+
+    return (p == end) ? 0 : EINVAL;
+}
+
+/*******************************************************************************
+ * Writer
+ ******************************************************************************/
+
+enum slot_state {
+    SLOT_FREE,      /* Being filled by the caller, or awaiting it */
+    SLOT_FILLED,    /* Awaiting compression */
+    SLOT_BUSY,      /* Being compressed */
+    SLOT_DONE,      /* Awaiting writing */
+};
+
+struct iqz_slot {
+    enum slot_state state;
+    uint8_t *samples;
+    size_t n;           /* # of samples in `samples` */
+    uint8_t *coded;
+    size_t coded_len;
+};
+
+/* Blocks pass through a ring of slots in order. The caller fills them, the
+ * compression threads claim them in order, and whichever thread finishes a
+ * block when none is writing then writes every finished block that is next
+ * in order, so that writes need not wait on each other's compression. */
+struct iqz_writer {
+    FILE *f;
+    enum iqz_format format;
+    unsigned int num_channels;
+    size_t block_samples;
+    size_t sample_size;
+
+    MUTEX lock;
+    pthread_cond_t filled;      /* A slot was filled, or closing */
+    pthread_cond_t freed;       /* A slot was written, or writing failed */
+
+    struct iqz_slot *slots;
+    unsigned int num_slots;
+    uint64_t fill_seq;          /* Block being filled by the caller */
+    uint64_t encode_seq;        /* Next block to be compressed */
+    uint64_t write_seq;         /* Next block to be written */
+    size_t fill_n;              /* # of samples in the block being filled.
+                                 * Only accessed by the caller. */
+    bool writing;               /* A thread is writing blocks */
+    bool done;                  /* No more blocks will be filled */
+    int status;                 /* First write failure */
+
+    pthread_t *threads;
+    unsigned int num_threads;
+
+    uint64_t offset;            /* File offset of the next block */
+    uint64_t num_samples;       /* # of samples written */
+    uint64_t *index;            /* Offset of each block written */
+    size_t index_cap;
+};
+
+static unsigned int online_cpus(void)
+{
+#if BLADERF_OS_WINDOWS
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (unsigned int)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (unsigned int)n : 1;
+#endif
+}
+
+/* Write finished blocks in order, unless another thread already is
+ *
+ * @pre lock is held */
+static void writer_drain(struct iqz_writer *w)
+{
+    struct iqz_slot *slot;
+    uint64_t *index;
+    size_t written;
+
+    if (w->writing) {
+        return;
+    }
+
+    w->writing = true;
+
+    while (w->status == 0 && w->write_seq < w->encode_seq) {
+        slot = &w->slots[w->write_seq % w->num_slots];
+        if (slot->state != SLOT_DONE) {
+            break;
+        }
+
+        if (w->write_seq == w->index_cap) {
+            index = realloc(w->index, 2 * w->index_cap * sizeof(index[0]));
+            if (index == NULL) {
+                w->status = ENOMEM;
+                break;
+            }
+
+            w->index      = index;
+            w->index_cap *= 2;
+        }
+
+        /* Only this thread writes, and the slot is not touched again until
+         * it is freed */
+        MUTEX_UNLOCK(&w->lock);
+        written = fwrite(slot->coded, 1, slot->coded_len, w->f);
+        MUTEX_LOCK(&w->lock);
+
+        if (written != slot->coded_len) {
+            w->status = EIO;
+            break;
+        }
+
+        w->index[w->write_seq] = w->offset;
+        w->offset      += slot->coded_len;
+        w->num_samples += slot->n;
+        slot->state     = SLOT_FREE;
+        w->write_seq++;
+
+        pthread_cond_broadcast(&w->freed);
+    }
+
+    w->writing = false;
+
+    if (w->status != 0) {
+        pthread_cond_broadcast(&w->freed);
+        pthread_cond_broadcast(&w->filled);
+    }
+}
+
+static void *writer_task(void *arg)
+{
+    struct iqz_writer *w = arg;
+    struct iqz_scratch scratch;
+    struct iqz_slot *slot;
+    int status;
+
+    status = scratch_alloc(&scratch, w->block_samples,
+                           2 * (size_t)w->num_channels);
+
+    MUTEX_LOCK(&w->lock);
+
+    if (status != 0 && w->status == 0) {
+        w->status = status;
+        pthread_cond_broadcast(&w->freed);
+    }
+
+    while (w->status == 0) {
+        while (w->status == 0 && w->encode_seq == w->fill_seq && !w->done) {
+            pthread_cond_wait(&w->filled, &w->lock);
+        }
+
+        if (w->status != 0 || w->encode_seq == w->fill_seq) {
+            break;
+        }
+
+        slot        = &w->slots[w->encode_seq % w->num_slots];
+        slot->state = SLOT_BUSY;
+        w->encode_seq++;
+
+        MUTEX_UNLOCK(&w->lock);
+        slot->coded_len = encode_block(w->format, w->num_channels,
+                                       slot->samples, slot->n, &scratch,
+                                       slot->coded);
+        MUTEX_LOCK(&w->lock);
+
+        slot->state = SLOT_DONE;
+        writer_drain(w);
+    }
+
+    MUTEX_UNLOCK(&w->lock);
+
+    scratch_free(&scratch);
+
+    return NULL;
+}
+
+static void writer_free(struct iqz_writer *w)
+{
+    unsigned int i;
+
+    if (w->slots != NULL) {
+        for (i = 0; i < w->num_slots; i++) {
+            free(w->slots[i].samples);
+            free(w->slots[i].coded);
+        }
+    }
+
+    free(w->slots);
+    free(w->threads);
+    free(w->index);
+
+    MUTEX_DESTROY(&w->lock);
+    pthread_cond_destroy(&w->filled);
+    pthread_cond_destroy(&w->freed);
+
+    free(w);
+}
+
+/* Stop the compression threads once every filled block is written, or
+ * writing has failed */
+static void writer_join(struct iqz_writer *w, unsigned int num_threads)
+{
+    unsigned int i;
+
+    MUTEX_LOCK(&w->lock);
+    w->done = true;
+    pthread_cond_broadcast(&w->filled);
+    MUTEX_UNLOCK(&w->lock);
+
+    for (i = 0; i < num_threads; i++) {
+        pthread_join(w->threads[i], NULL);
+    }
+}
+
+int iqz_writer_open(struct iqz_writer **writer,
+                    FILE *f,
+                    enum iqz_format format,
+                    unsigned int num_channels,
+                    unsigned int block_samples,
+                    unsigned int num_threads)
+{
+    struct iqz_writer *w;
+    uint8_t header[IQZ_HEADER_LEN];
+    unsigned int i;
+    int status;
+
+    if (block_samples == 0) {
+        block_samples = IQZ_DEFAULT_BLOCK_SAMPLES;
+    }
+
+    if (num_threads == 0) {
+        num_threads = online_cpus();
+        if (num_threads > IQZ_MAX_THREADS) {
+            num_threads = IQZ_MAX_THREADS;
+        }
+    }
+
+    if ((format != IQZ_FMT_SC16_Q11 && format != IQZ_FMT_SC8_Q7) ||
+        num_channels == 0 || num_channels > IQZ_MAX_CHANNELS ||
+        block_samples % 32 != 0 || block_samples % num_channels != 0 ||
+        num_threads > IQZ_MAX_THREADS) {
+        return EINVAL;
+    }
+
+    w = calloc(1, sizeof(*w));
+    if (w == NULL) {
+        return ENOMEM;
+    }
+
+    w->f             = f;
+    w->format        = format;
+    w->num_channels  = num_channels;
+    w->block_samples = block_samples;
+    w->sample_size   = iqz_sample_size(format);
+    w->num_slots     = IQZ_SLOTS_PER_THREAD * num_threads;
+    w->offset        = IQZ_HEADER_LEN;
+    w->index_cap     = 64;
+
+    MUTEX_INIT(&w->lock);
+    pthread_cond_init(&w->filled, NULL);
+    pthread_cond_init(&w->freed, NULL);
+
+    pthread_once(&analyze_once, analyze_select);
+
+    w->slots   = calloc(w->num_slots, sizeof(w->slots[0]));
+    w->threads = calloc(num_threads, sizeof(w->threads[0]));
+    w->index   = malloc(w->index_cap * sizeof(w->index[0]));
+    if (w->slots == NULL || w->threads == NULL || w->index == NULL) {
+        writer_free(w);
+        return ENOMEM;
+    }
+
+    /* Allocate every buffer up front, so nothing is allocated while samples
+     * are flowing, but for the growth of the index */
+    for (i = 0; i < w->num_slots; i++) {
+        w->slots[i].samples = malloc(block_samples * w->sample_size);
+        w->slots[i].coded   = malloc(max_block_len(format, block_samples));
+        if (w->slots[i].samples == NULL || w->slots[i].coded == NULL) {
+            writer_free(w);
+            return ENOMEM;
+        }
+    }
+
+    memcpy(header, IQZ_MAGIC, 8);
+    header[8]  = IQZ_VERSION;
+    header[9]  = (uint8_t)format;
+    header[10] = (uint8_t)num_channels;
+    header[11] = 0;
+    put_le32(header + 12, block_samples);
+
+    if (fwrite(header, 1, sizeof(header), f) != sizeof(header)) {
+        writer_free(w);
+        return EIO;
+    }
+
+    for (i = 0; i < num_threads; i++) {
+        status = pthread_create(&w->threads[i], NULL, writer_task, w);
+        if (status != 0) {
+            writer_join(w, i);
+            writer_free(w);
+            return status;
+        }
+    }
+
+    w->num_threads = num_threads;
+    *writer        = w;
+
+    return 0;
+}
+
+/* Queue the block being filled for compression */
+static void writer_submit(struct iqz_writer *w)
+{
+    MUTEX_LOCK(&w->lock);
+
+    w->slots[w->fill_seq % w->num_slots].n     = w->fill_n;
+    w->slots[w->fill_seq % w->num_slots].state = SLOT_FILLED;
+    w->fill_seq++;
+    w->fill_n = 0;
+    pthread_cond_signal(&w->filled);
+
+    MUTEX_UNLOCK(&w->lock);
+}
+
+int iqz_writer_write(struct iqz_writer *w, const void *samples, size_t n)
+{
+    const uint8_t *in = samples;
+    struct iqz_slot *slot;
+    size_t k;
+    int status = 0;
+
+    while (n > 0) {
+        slot = &w->slots[w->fill_seq % w->num_slots];
+
+        /* Wait for the next slot to be written before filling it. Only the
+         * caller fills slots, so it need not hold the lock to do so. */
+        if (w->fill_n == 0) {
+            MUTEX_LOCK(&w->lock);
+            while (slot->state != SLOT_FREE && w->status == 0) {
+                pthread_cond_wait(&w->freed, &w->lock);
+            }
+            status = w->status;
+            MUTEX_UNLOCK(&w->lock);
+
+            if (status != 0) {
+                return status;
+            }
+        }
+
+        k = w->block_samples - w->fill_n;
+        if (k > n) {
+            k = n;
+        }
+
+        memcpy(slot->samples + w->fill_n * w->sample_size, in,
+               k * w->sample_size);
+
+        w->fill_n += k;
+        in        += k * w->sample_size;
+        n         -= k;
+
+        if (w->fill_n == w->block_samples) {
+            writer_submit(w);
+        }
+    }
+
+    return 0;
+}
+
+int iqz_writer_close(struct iqz_writer *w)
+{
+    uint8_t footer[IQZ_FOOTER_LEN];
+    uint8_t entry[8];
+    uint64_t i;
+    int status;
+
+    if (w == NULL) {
+        return 0;
+    }
+
+    if (w->fill_n > 0) {
+        writer_submit(w);
+    }
+
+    writer_join(w, w->num_threads);
+
+    /* The threads have stopped, so the lock is no longer needed */
+    status = w->status;
+
+    for (i = 0; status == 0 && i < w->write_seq; i++) {
+        put_le64(entry, w->index[i]);
+        if (fwrite(entry, 1, sizeof(entry), w->f) != sizeof(entry)) {
+            status = EIO;
+        }
+    }
+
+    if (status == 0) {
+        put_le64(footer, w->offset);
+        put_le64(footer + 8, w->num_samples);
+        memcpy(footer + 16, IQZ_FOOTER_MAGIC, 8);
+
+        if (fwrite(footer, 1, sizeof(footer), w->f) != sizeof(footer) ||
+            fflush(w->f) != 0) {
+            status = EIO;
+        }
+    }
+
+    writer_free(w);
+
+    return status;
+}
+
+/*******************************************************************************
+ * Reader
+ ******************************************************************************/
+
+struct iqz_reader {
+    struct iqz_info info;
+    const uint8_t *data;
+    size_t len;
+    uint64_t *index;
+};
+
+/* Read the block index from the footer
+ *
+ * returns true if the footer and index are valid */
+static bool reader_load_index(struct iqz_reader *r)
+{
+    const uint8_t *footer;
+    uint64_t index_offset, count, i, offset, prev = 0;
+
+    if (r->len < IQZ_HEADER_LEN + IQZ_FOOTER_LEN) {
+        return false;
+    }
+
+    footer = r->data + r->len - IQZ_FOOTER_LEN;
+    if (memcmp(footer + 16, IQZ_FOOTER_MAGIC, 8) != 0) {
+        return false;
+    }
+
+    index_offset = get_le64(footer);
+    r->info.num_samples = get_le64(footer + 8);
+
+    count = r->info.num_samples / r->info.block_samples +
+            (r->info.num_samples % r->info.block_samples != 0);
+
+    if (index_offset < IQZ_HEADER_LEN ||
+        index_offset > r->len - IQZ_FOOTER_LEN ||
+        count != (r->len - IQZ_FOOTER_LEN - index_offset) / 8 ||
+        (r->len - IQZ_FOOTER_LEN - index_offset) % 8 != 0) {
+        return false;
+    }
+
+    r->index = malloc((count > 0 ? count : 1) * sizeof(r->index[0]));
+    if (r->index == NULL) {
+        return false;
+    }
+
+    for (i = 0; i < count; i++) {
+        offset = get_le64(r->data + index_offset + 8 * i);
+        if (offset < IQZ_HEADER_LEN ||
+            offset > index_offset - IQZ_BLOCK_HEADER_LEN ||
+            (i > 0 && offset <= prev)) {
+            free(r->index);
+            r->index = NULL;
+            return false;
+        }
+
+        r->index[i] = prev = offset;
+    }
+
+    r->info.num_blocks = count;
+    return true;
+}
+
+/* Build the block index by walking the blocks, up to the first that is
+ * truncated or follows a partial block
+ *
+ * returns 0 on success, or ENOMEM */
+static int reader_scan(struct iqz_reader *r)
+{
+    size_t offset = IQZ_HEADER_LEN;
+    size_t cap    = 64;
+    size_t len, n;
+    uint64_t *index;
+
+    r->info.num_samples = 0;
+    r->info.num_blocks  = 0;
+
+    r->index = malloc(cap * sizeof(r->index[0]));
+    if (r->index == NULL) {
+        return ENOMEM;
+    }
+
+    while (r->len - offset >= IQZ_BLOCK_HEADER_LEN) {
+        len = get_le32(r->data + offset);
+        n   = get_le32(r->data + offset + 4);
+
+        if (n == 0 || n > r->info.block_samples ||
+            len > r->len - offset - IQZ_BLOCK_HEADER_LEN ||
+            r->info.num_samples % r->info.block_samples != 0) {
+            break;
+        }
+
+        if (r->info.num_blocks == cap) {
+            index = realloc(r->index, 2 * cap * sizeof(index[0]));
+            if (index == NULL) {
+                return ENOMEM;
+            }
+
+            r->index = index;
+            cap     *= 2;
+        }
+
+        r->index[r->info.num_blocks++] = offset;
+        r->info.num_samples += n;
+        offset += IQZ_BLOCK_HEADER_LEN + len;
+    }
+
+    return 0;
+}
+
+int iqz_reader_open(struct iqz_reader **reader, const void *data, size_t len)
+{
+    const uint8_t *header = data;
+    struct iqz_reader *r;
+    int status;
+
+    if (len < IQZ_HEADER_LEN || memcmp(header, IQZ_MAGIC, 8) != 0 ||
+        header[8] != IQZ_VERSION ||
+        (header[9] != IQZ_FMT_SC16_Q11 && header[9] != IQZ_FMT_SC8_Q7) ||
+        header[10] == 0 || header[10] > IQZ_MAX_CHANNELS) {
+        return EINVAL;
+    }
+
+    r = calloc(1, sizeof(*r));
+    if (r == NULL) {
+        return ENOMEM;
+    }
+
+    r->data                = data;
+    r->len                 = len;
+    r->info.format         = (enum iqz_format)header[9];
+    r->info.num_channels   = header[10];
+    r->info.block_samples  = get_le32(header + 12);
+
+    if (r->info.block_samples == 0 || r->info.block_samples % 32 != 0 ||
+        r->info.block_samples % r->info.num_channels != 0) {
+        free(r);
+        return EINVAL;
+    }
+
+    if (!reader_load_index(r)) {
+        status = reader_scan(r);
+        if (status != 0) {
+            iqz_reader_close(r);
+            return status;
+        }
+    }
+
+    *reader = r;
+    return 0;
+}
+
+const struct iqz_info *iqz_reader_info(const struct iqz_reader *r)
+{
+    return &r->info;
+}
+
+int iqz_reader_decode(const struct iqz_reader *r,
+                      uint64_t block,
+                      void *samples,
+                      size_t *n)
+{
+    const uint8_t *p;
+    uint64_t expected;
+    size_t offset, len;
+    int status;
+
+    if (block >= r->info.num_blocks) {
+        return EINVAL;
+    }
+
+    offset   = (size_t)r->index[block];
+    expected = r->info.num_samples - block * r->info.block_samples;
+    if (expected > r->info.block_samples) {
+        expected = r->info.block_samples;
+    }
+
+    if (r->len - offset < IQZ_BLOCK_HEADER_LEN) {
+        return EINVAL;
+    }
+
+    p   = r->data + offset;
+    len = get_le32(p);
+    if (get_le32(p + 4) != expected ||
+        len > r->len - offset - IQZ_BLOCK_HEADER_LEN) {
+        return EINVAL;
+    }
+
+    status = decode_block(r->info.format, r->info.num_channels,
+                          p + IQZ_BLOCK_HEADER_LEN, len, (size_t)expected,
+                          samples);
+    if (status == 0) {
+        *n = (size_t)expected;
+    }
+
+    return status;
+}
+
+void iqz_reader_close(struct iqz_reader *r)
+{
+    if (r != NULL) {
+        free(r->index);
+        free(r);
+    }
+}
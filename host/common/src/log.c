@@ -30,8 +30,315 @@
 #include <stdio.h>
 #include <stdarg.h>
 
+#if defined(LOG_ASYNC_ENABLED) && !defined(__GNUC__) && !defined(__clang__)
+#   warning "Asynchronous logging requires GCC-style atomics. Disabling it."
+#   undef LOG_ASYNC_ENABLED
+#endif
+
 static bladerf_log_level filter_level = BLADERF_LOG_LEVEL_INFO;
 
+#if !defined(WIN32) && !defined(__CYGWIN__) && defined(LOG_SYSLOG_ENABLED)
+static int syslog_level(bladerf_log_level level)
+{
+    switch (level) {
+        case BLADERF_LOG_LEVEL_VERBOSE:
+        case BLADERF_LOG_LEVEL_DEBUG:
+            return LOG_DEBUG;
+
+        case BLADERF_LOG_LEVEL_INFO:
+            return LOG_INFO;
+
+        case BLADERF_LOG_LEVEL_WARNING:
+            return LOG_WARNING;
+
+        case BLADERF_LOG_LEVEL_ERROR:
+            return LOG_ERR;
+
+        case BLADERF_LOG_LEVEL_CRITICAL:
+            return LOG_CRIT;
+
+        default:
+            /* Shouldn't be used, so just route it to a low level */
+            return LOG_DEBUG;
+    }
+}
+#endif
+
+static void log_output_va(bladerf_log_level level, const char *format,
+                          va_list args)
+{
+#if !defined(WIN32) && !defined(__CYGWIN__) && defined(LOG_SYSLOG_ENABLED)
+    vsyslog(syslog_level(level) | LOG_USER, format, args);
+#else
+    (void)level;
+    vfprintf(stderr, format, args);
+#endif
+}
+
+#ifdef LOG_ASYNC_ENABLED
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+/* Size of each thread's ring, in bytes. This must be a power of two. */
+#define LOG_RING_SIZE   (16 * 1024)
+
+/* Longest message stored; longer messages are truncated */
+#define LOG_MSG_MAX     512
+
+/* Interval at which the rings are drained, in ms */
+#define LOG_DRAIN_MS    10
+
+/* Record length denoting that the rest of the ring, up to its end, is
+ * unused */
+#define LOG_REC_WRAP    0xffff
+
+/* A record is a log_rec_hdr followed by `len` bytes of text, padded to a
+ * multiple of the header size so that headers never straddle the end of
+ * the ring. */
+struct log_rec_hdr {
+    uint16_t len;
+    uint8_t level;
+    uint8_t reserved;
+};
+
+#define LOG_REC_ALIGN   sizeof(struct log_rec_hdr)
+
+/* Single-producer, single-consumer ring of records. Only the owning thread
+ * advances `head`, and only the drain thread advances `tail`. Both are free
+ * running, and are masked to index the buffer. */
+struct log_ring {
+    struct log_ring *next;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t dropped;   /* Messages dropped since last reported */
+    bool orphaned;      /* Owning thread has exited */
+    char buf[LOG_RING_SIZE];
+};
+
+static pthread_once_t async_once      = PTHREAD_ONCE_INIT;
+static pthread_mutex_t rings_lock     = PTHREAD_MUTEX_INITIALIZER;
+static struct log_ring *rings         = NULL;
+static pthread_key_t ring_key;
+static pthread_t drain_thread;
+static bool async_running             = false;
+static bool async_stop                = false;
+
+static void log_output(bladerf_log_level level, const char *msg, size_t len)
+{
+#if !defined(WIN32) && !defined(__CYGWIN__) && defined(LOG_SYSLOG_ENABLED)
+    syslog(syslog_level(level) | LOG_USER, "%.*s", (int)len, msg);
+#else
+    (void)level;
+    fwrite(msg, 1, len, stderr);
+#endif
+}
+
+static inline size_t rec_size(size_t len)
+{
+    return sizeof(struct log_rec_hdr) +
+           (len + LOG_REC_ALIGN - 1) / LOG_REC_ALIGN * LOG_REC_ALIGN;
+}
+
+static void ring_release(void *arg)
+{
+    struct log_ring *ring = arg;
+
+    /* The drain thread frees the ring once the remaining records have been
+     * written out */
+    __atomic_store_n(&ring->orphaned, true, __ATOMIC_RELEASE);
+}
+
+/* Write out all complete records in the ring. Returns false if the ring is
+ * orphaned and fully drained, i.e., may be freed. */
+static bool ring_drain(struct log_ring *ring)
+{
+    const bool orphaned = __atomic_load_n(&ring->orphaned, __ATOMIC_ACQUIRE);
+    const uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint32_t tail       = ring->tail;
+    uint32_t dropped;
+
+    while (tail != head) {
+        const size_t off = tail & (LOG_RING_SIZE - 1);
+        struct log_rec_hdr hdr;
+
+        memcpy(&hdr, &ring->buf[off], sizeof(hdr));
+
+        if (hdr.len == LOG_REC_WRAP) {
+            tail += (uint32_t)(LOG_RING_SIZE - off);
+            continue;
+        }
+
+        log_output((bladerf_log_level)hdr.level,
+                   &ring->buf[off + sizeof(hdr)], hdr.len);
+
+        tail += (uint32_t)rec_size(hdr.len);
+    }
+
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+
+    dropped = __atomic_exchange_n(&ring->dropped, 0, __ATOMIC_RELAXED);
+    if (dropped != 0) {
+        char msg[64];
+        int len;
+
+        len = snprintf(msg, sizeof(msg),
+                       "[WARNING] %u log messages were dropped\n", dropped);
+        log_output(BLADERF_LOG_LEVEL_WARNING, msg, (size_t)len);
+    }
+
+    return !orphaned;
+}
+
+static void drain_all(void)
+{
+    struct log_ring **prev;
+    struct log_ring *ring;
+
+    pthread_mutex_lock(&rings_lock);
+
+    prev = &rings;
+    while ((ring = *prev) != NULL) {
+        if (ring_drain(ring)) {
+            prev = &ring->next;
+        } else {
+            *prev = ring->next;
+            free(ring);
+        }
+    }
+
+    pthread_mutex_unlock(&rings_lock);
+
+    fflush(stderr);
+}
+
+static void *drain_thread_fn(void *arg)
+{
+    const struct timespec interval = { 0, LOG_DRAIN_MS * 1000000L };
+
+    (void)arg;
+
+    while (!__atomic_load_n(&async_stop, __ATOMIC_ACQUIRE)) {
+        drain_all();
+        nanosleep(&interval, NULL);
+    }
+
+    return NULL;
+}
+
+static void async_init(void)
+{
+    if (pthread_key_create(&ring_key, ring_release) != 0) {
+        return;
+    }
+
+    if (pthread_create(&drain_thread, NULL, drain_thread_fn, NULL) == 0) {
+        __atomic_store_n(&async_running, true, __ATOMIC_RELEASE);
+    }
+}
+
+static struct log_ring *thread_ring(void)
+{
+    struct log_ring *ring = pthread_getspecific(ring_key);
+
+    if (ring == NULL) {
+        ring = calloc(1, sizeof(*ring));
+        if (ring == NULL) {
+            return NULL;
+        }
+
+        pthread_setspecific(ring_key, ring);
+
+        pthread_mutex_lock(&rings_lock);
+        ring->next = rings;
+        rings      = ring;
+        pthread_mutex_unlock(&rings_lock);
+    }
+
+    return ring;
+}
+
+/* Returns false if the message could not be queued and must be written out
+ * synchronously */
+static bool log_enqueue(bladerf_log_level level, const char *format,
+                        va_list args)
+{
+    struct log_ring *ring;
+    struct log_rec_hdr hdr;
+    char msg[LOG_MSG_MAX];
+    uint32_t head, tail;
+    size_t off, contig, need, size;
+    int len;
+
+    pthread_once(&async_once, async_init);
+
+    if (!__atomic_load_n(&async_running, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+
+    ring = thread_ring();
+    if (ring == NULL) {
+        return false;
+    }
+
+    len = vsnprintf(msg, sizeof(msg), format, args);
+    if (len < 0) {
+        return true;
+    } else if (len >= (int)sizeof(msg)) {
+        len = sizeof(msg) - 1;
+    }
+
+    size   = rec_size((size_t)len);
+    head   = ring->head;
+    tail   = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    off    = head & (LOG_RING_SIZE - 1);
+    contig = LOG_RING_SIZE - off;
+    need   = size + (contig < size ? contig : 0);
+
+    if (LOG_RING_SIZE - (head - tail) < need) {
+        __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+        return true;
+    }
+
+    if (contig < size) {
+        hdr.len = LOG_REC_WRAP;
+        memcpy(&ring->buf[off], &hdr, sizeof(hdr));
+        head += (uint32_t)contig;
+        off = 0;
+    }
+
+    hdr.len      = (uint16_t)len;
+    hdr.level    = (uint8_t)level;
+    hdr.reserved = 0;
+
+    memcpy(&ring->buf[off], &hdr, sizeof(hdr));
+    memcpy(&ring->buf[off + sizeof(hdr)], msg, (size_t)len);
+
+    __atomic_store_n(&ring->head, head + (uint32_t)size, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+void log_shutdown(void)
+{
+    if (!__atomic_exchange_n(&async_running, false, __ATOMIC_ACQ_REL)) {
+        return;
+    }
+
+    __atomic_store_n(&async_stop, true, __ATOMIC_RELEASE);
+    pthread_join(drain_thread, NULL);
+
+    drain_all();
+}
+#else
+void log_shutdown(void)
+{
+}
+#endif
+
 void log_write(bladerf_log_level level, const char *format, ...)
 {
     /* Only process this message if its level exceeds the current threshold */
@@ -41,46 +348,14 @@ void log_write(bladerf_log_level level, const char *format, ...)
 
         /* Write the log message */
         va_start(args, format);
-#if defined(WIN32) || defined(__CYGWIN__)
-        vfprintf(stderr, format, args);
-#else
-#  if defined (LOG_SYSLOG_ENABLED)
-        {
-            int syslog_level;
-
-            switch (level) {
-                case BLADERF_LOG_LEVEL_VERBOSE:
-                case BLADERF_LOG_LEVEL_DEBUG:
-                    syslog_level = LOG_DEBUG;
-                    break;
-
-                case BLADERF_LOG_LEVEL_INFO:
-                    syslog_level = LOG_INFO;
-                    break;
-
-                case BLADERF_LOG_LEVEL_WARNING:
-                    syslog_level = LOG_WARNING;
-                    break;
-
-                case BLADERF_LOG_LEVEL_ERROR:
-                    syslog_level = LOG_ERR;
-                    break;
-
-                case BLADERF_LOG_LEVEL_CRITICAL:
-                    syslog_level = LOG_CRIT;
-                    break;
-
-                default:
-                    /* Shouldn't be used, so just route it to a low level */
-                    syslog_level = LOG_DEBUG;
-                    break;
-            }
-
-            vsyslog(syslog_level | LOG_USER, format, args);
+#ifdef LOG_ASYNC_ENABLED
+        if (!log_enqueue(level, format, args)) {
+            va_end(args);
+            va_start(args, format);
+            log_output_va(level, format, args);
         }
-#  else
-        vfprintf(stderr, format, args);
-#  endif
+#else
+        log_output_va(level, format, args);
 #endif
         va_end(args);
     }
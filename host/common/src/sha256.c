@@ -29,6 +29,28 @@
 #include <string.h>
 
 #include "sha256.h"
+#include "thread.h"
+
+/*
+ * Blocks are compressed with the SHA extensions of x86 or ARMv8 processors
+ * where available, and with the portable implementation below otherwise.
+ *
+ * The x86 implementation is built with per-function target attributes and
+ * selected at runtime, as in dsp.c.  The ARMv8 implementation is used when
+ * the compiler targets the cryptography extension (e.g., -march=armv8-a+crypto
+ * or Apple arm64), in which case every processor that runs the code has it.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#   define SHA256_HAVE_SHANI 1
+#   include <cpuid.h>
+#   include <immintrin.h>
+#   define SHA256_TARGET_SHANI __attribute__((target("sha,sse4.1,ssse3")))
+#elif defined(__aarch64__) && \
+    (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#   define SHA256_HAVE_ARMV8 1
+#   include <arm_neon.h>
+#endif
 
 #if BLADERF_BIG_ENDIAN == 1
 
@@ -233,6 +255,181 @@ SHA256_Transform(uint32_t * state, const unsigned char block[64])
 		state[i] += S[i];
 }
 
+static void
+SHA256_Blocks_Generic(uint32_t * state, const unsigned char *data,
+    size_t blocks)
+{
+
+	for (; blocks > 0; blocks--, data += 64)
+		SHA256_Transform(state, data);
+}
+
+#if defined(SHA256_HAVE_SHANI) || defined(SHA256_HAVE_ARMV8)
+/* Round constants, as used in SHA256_Transform() */
+static const uint32_t K[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+#endif
+
+#ifdef SHA256_HAVE_SHANI
+/*
+ * The SHA-NI round instructions operate on the state as {A,B,E,F} and
+ * {C,D,G,H}, and perform two rounds per instruction.  The message schedule
+ * is kept as four vectors of four words, W[g % 4] holding words 4g..4g+3.
+ */
+SHA256_TARGET_SHANI static void
+SHA256_Blocks_SHANI(uint32_t * state, const unsigned char *data,
+    size_t blocks)
+{
+	const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+	    0x0405060700010203ULL);
+	__m128i abef, cdgh, abef_save, cdgh_save;
+	__m128i W[4];
+	__m128i msg, tmp;
+	int g;
+
+	/* Rearrange {A,B,C,D} {E,F,G,H} into {A,B,E,F} {C,D,G,H} */
+	tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]),
+	    0xb1);
+	cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]),
+	    0x1b);
+	abef = _mm_alignr_epi8(tmp, cdgh, 8);
+	cdgh = _mm_blend_epi16(cdgh, tmp, 0xf0);
+
+	for (; blocks > 0; blocks--, data += 64) {
+		abef_save = abef;
+		cdgh_save = cdgh;
+
+		for (g = 0; g < 16; g++) {
+			if (g < 4) {
+				W[g] = _mm_shuffle_epi8(_mm_loadu_si128(
+				    (const __m128i *)(data + 16 * g)), bswap);
+			} else {
+				tmp = _mm_sha256msg1_epu32(W[g % 4],
+				    W[(g + 1) % 4]);
+				tmp = _mm_add_epi32(tmp, _mm_alignr_epi8(
+				    W[(g + 3) % 4], W[(g + 2) % 4], 4));
+				W[g % 4] = _mm_sha256msg2_epu32(tmp,
+				    W[(g + 3) % 4]);
+			}
+
+			msg = _mm_add_epi32(W[g % 4],
+			    _mm_loadu_si128((const __m128i *)&K[4 * g]));
+			cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg);
+			msg = _mm_shuffle_epi32(msg, 0x0e);
+			abef = _mm_sha256rnds2_epu32(abef, cdgh, msg);
+		}
+
+		abef = _mm_add_epi32(abef, abef_save);
+		cdgh = _mm_add_epi32(cdgh, cdgh_save);
+	}
+
+	/* Restore {A,B,C,D} {E,F,G,H} */
+	tmp = _mm_shuffle_epi32(abef, 0x1b);
+	cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+	_mm_storeu_si128((__m128i *)&state[0], _mm_blend_epi16(tmp, cdgh, 0xf0));
+	_mm_storeu_si128((__m128i *)&state[4], _mm_alignr_epi8(cdgh, tmp, 8));
+}
+
+static int
+SHA256_Have_SHANI(void)
+{
+	unsigned int eax, ebx, ecx, edx;
+
+	/* __builtin_cpu_supports() only knows of the SHA extensions in recent
+	 * compilers, so CPUID is queried directly */
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) ||
+	    !(ecx & bit_SSSE3) || !(ecx & bit_SSE4_1))
+		return (0);
+
+	if (__get_cpuid_max(0, NULL) < 7)
+		return (0);
+
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+	return ((ebx & (1u << 29)) != 0);
+}
+#endif
+
+#ifdef SHA256_HAVE_ARMV8
+/*
+ * The ARMv8 round instructions perform four rounds per instruction pair, on
+ * the state as {A,B,C,D} and {E,F,G,H}.  W[g % 4] holds words 4g..4g+3 of the
+ * message schedule.
+ */
+static void
+SHA256_Blocks_ARMv8(uint32_t * state, const unsigned char *data,
+    size_t blocks)
+{
+	uint32x4_t abcd, efgh, abcd_save, efgh_save;
+	uint32x4_t W[4];
+	uint32x4_t msg, tmp;
+	int g;
+
+	abcd = vld1q_u32(&state[0]);
+	efgh = vld1q_u32(&state[4]);
+
+	for (; blocks > 0; blocks--, data += 64) {
+		abcd_save = abcd;
+		efgh_save = efgh;
+
+		for (g = 0; g < 16; g++) {
+			if (g < 4) {
+				W[g] = vreinterpretq_u32_u8(vrev32q_u8(
+				    vld1q_u8(data + 16 * g)));
+			} else {
+				tmp = vsha256su0q_u32(W[g % 4], W[(g + 1) % 4]);
+				W[g % 4] = vsha256su1q_u32(tmp, W[(g + 2) % 4],
+				    W[(g + 3) % 4]);
+			}
+
+			msg = vaddq_u32(W[g % 4], vld1q_u32(&K[4 * g]));
+			tmp = abcd;
+			abcd = vsha256hq_u32(abcd, efgh, msg);
+			efgh = vsha256h2q_u32(efgh, tmp, msg);
+		}
+
+		abcd = vaddq_u32(abcd, abcd_save);
+		efgh = vaddq_u32(efgh, efgh_save);
+	}
+
+	vst1q_u32(&state[0], abcd);
+	vst1q_u32(&state[4], efgh);
+}
+#endif
+
+/* Dispatch */
+static void (*SHA256_Blocks)(uint32_t *, const unsigned char *, size_t) =
+    SHA256_Blocks_Generic;
+static pthread_once_t SHA256_Once = PTHREAD_ONCE_INIT;
+
+static void
+SHA256_Select(void)
+{
+
+#if defined(SHA256_HAVE_SHANI)
+	if (SHA256_Have_SHANI())
+		SHA256_Blocks = SHA256_Blocks_SHANI;
+#elif defined(SHA256_HAVE_ARMV8)
+	SHA256_Blocks = SHA256_Blocks_ARMv8;
+#endif
+}
+
 static unsigned char PAD[64] = {
 	0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -267,6 +464,8 @@ void
 SHA256_Init(SHA256_CTX * ctx)
 {
 
+	pthread_once(&SHA256_Once, SHA256_Select);
+
 	/* Zero bits processed so far */
 	ctx->count[0] = ctx->count[1] = 0;
 
@@ -309,16 +508,14 @@ SHA256_Update(SHA256_CTX * ctx, const void *in, size_t len)
 
 	/* Finish the current block */
 	memcpy(&ctx->buf[r], src, 64 - r);
-	SHA256_Transform(ctx->state, ctx->buf);
+	SHA256_Blocks(ctx->state, ctx->buf, 1);
 	src += 64 - r;
 	len -= 64 - r;
 
 	/* Perform complete blocks */
-	while (len >= 64) {
-		SHA256_Transform(ctx->state, src);
-		src += 64;
-		len -= 64;
-	}
+	SHA256_Blocks(ctx->state, src, len / 64);
+	src += len & ~(size_t)0x3f;
+	len &= 0x3f;
 
 	/* Copy left over data into buffer */
 	memcpy(ctx->buf, src, len);
@@ -128,9 +128,8 @@ int main(int argc, char *argv[])
 
         if (argc == 3) {
             struct dc_calibration_params p;
+            memset(&p, 0, sizeof(p));
             p.frequency = f_start;
-            p.corr_i  = p.corr_q = 0;
-            p.error_i = p.error_q = 0;
 
             status = dc_calibration(dev, module, &p, 1, false);
             if (status == 0) {
@@ -0,0 +1,76 @@
+#include <libbladeRF.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FPGA_IMAGE_ENV "BLADERF_ADSB_FPGA"
+
+#define CHECK_STATUS(_fn) do {                                             \
+        status = _fn;                                                      \
+        if (status != 0) {                                                 \
+            fprintf(stderr, "[Error] %s:%d: %s\n", __FUNCTION__, __LINE__, \
+                    bladerf_strerror(status));                             \
+            goto error;                                                    \
+        }                                                                  \
+    } while (0)
+
+/* Print each message in the "AVR" text format, "*<hex>;", which other
+ * ADS-B decoders accept as raw input */
+static int print_msg(struct bladerf *dev,
+                     const struct bladerf_adsb_msg *msg,
+                     void *user_data)
+{
+    unsigned int i;
+
+    printf("*");
+    for (i = 0; i < msg->len; i++) {
+        printf("%02X", msg->data[i]);
+    }
+    printf(";\n");
+    fflush(stdout);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int status = -1;
+
+    struct bladerf *dev = NULL;
+    struct bladerf_devinfo dev_info;
+    const bladerf_channel ch = BLADERF_CHANNEL_RX(0);
+    const char *fpga = getenv(FPGA_IMAGE_ENV);
+    struct bladerf_adsb_config config;
+
+    bladerf_init_devinfo(&dev_info);
+
+    /* Request a device with the provided serial number.
+     * Invalid strings should simply fail to match a device. */
+    if (argc >= 2) {
+        strncpy(dev_info.serial, argv[1], sizeof(dev_info.serial) - 1);
+    }
+
+    CHECK_STATUS(bladerf_open_with_devinfo(&dev, &dev_info));
+
+    /* The ADS-B image replaces the standard one until the device is power
+     * cycled or another image is loaded */
+    if (fpga != NULL) {
+        CHECK_STATUS(bladerf_load_fpga(dev, fpga));
+    }
+
+    CHECK_STATUS(bladerf_set_sample_rate(dev, ch, BLADERF_ADSB_SAMPLE_RATE,
+                                         NULL));
+    CHECK_STATUS(bladerf_set_frequency(dev, ch, BLADERF_ADSB_FREQUENCY));
+
+    /* Only messages that the FPGA decoded, and whose parity checks out,
+     * cross USB and reach the callback */
+    memset(&config, 0, sizeof(config));
+    config.crc_ok_only = true;
+    config.callback    = print_msg;
+
+    CHECK_STATUS(bladerf_adsb_rx(dev, &config));
+
+error:
+    bladerf_close(dev);
+    return status;
+}
@@ -4,7 +4,8 @@
 #include <string.h>
 
 #define FREQ_HOP_SPACING (bladerf_frequency)40e6
-#define ITERATIONS 10000
+#define DWELL 32768
+#define PASSES 10
 
 #define CHECK_STATUS(_fn) do {                                             \
         status = _fn;                                                      \
@@ -23,25 +24,44 @@
         }                                                                     \
     } while (0)
 
-struct {
-    bladerf_channel ch;
-    bladerf_frequency frequency;
-} state;
+/* Print the mean power of each step's settled samples */
+static int print_power(struct bladerf *dev,
+                       const struct bladerf_sweep_block *block,
+                       void *user_data)
+{
+    double sum = 0.0;
+    unsigned int i;
+
+    for (i = block->settled; i < block->num_samples; i++) {
+        const double si = block->samples[2 * i] / 2048.0;
+        const double sq = block->samples[2 * i + 1] / 2048.0;
+        sum += si * si + sq * sq;
+    }
+
+    if (block->num_samples > block->settled) {
+        sum /= block->num_samples - block->settled;
+    }
+
+    printf("Pass %llu: %llu Hz: %g%s\n", (unsigned long long)block->pass,
+           (unsigned long long)block->frequency, sum,
+           (block->status & BLADERF_META_STATUS_OVERRUN) ? " (overrun)" : "");
+
+    return 0;
+}
 
 int main(int argc, char *argv[])
 {
     int status = -1;
-    unsigned int i, j;
+    unsigned int i;
 
     struct bladerf *dev = NULL;
     struct bladerf_devinfo dev_info;
 
     const struct bladerf_range *freq_range = NULL;
     bladerf_frequency freq_min, freq_max;
-    bladerf_timestamp timestamp;
     bladerf_frequency *frequencies = NULL;
     const bladerf_channel ch = BLADERF_CHANNEL_RX(0);
-    struct bladerf_quick_tune *quick_tunes = NULL;
+    struct bladerf_sweep_config config;
 
     bladerf_init_devinfo(&dev_info);
 
@@ -71,47 +91,21 @@ int main(int argc, char *argv[])
         }
     }
 
-    /* Get our quick tune parameters for each frequency we'll be using */
-    quick_tunes = malloc(num_frequencies * sizeof(struct bladerf_quick_tune));
-    CHECK_NULL(quick_tunes);
+    /* The sweep gathers the quick tune parameters of each frequency up
+     * front, and then retunes at each step's timestamp within a single RX
+     * stream */
+    memset(&config, 0, sizeof(config));
+    config.frequencies     = frequencies;
+    config.num_frequencies = num_frequencies;
+    config.dwell           = DWELL;
+    config.num_passes      = PASSES;
+    config.callback        = print_power;
 
-    for (i = 0; i < num_frequencies; i++) {
-        status = bladerf_set_frequency(dev, ch, frequencies[i]);
-        if (status != 0) {
-            fprintf(stderr, "Failed to set frequency to %lu Hz: %s\n",
-                    frequencies[i], bladerf_strerror(status));
-            return status;
-        }
-
-        bladerf_log_set_verbosity(BLADERF_LOG_LEVEL_VERBOSE);
-        printf("Frequency: %lu Hz\n", frequencies[i]);
-        status = bladerf_get_quick_tune(dev, ch, &quick_tunes[i]);
-        if (status != 0) {
-            fprintf(stderr, "Failed to get quick tune for %lu Hz: %s\n",
-                    frequencies[i], bladerf_strerror(status));
-            return status;
-        }
-        bladerf_log_set_verbosity(BLADERF_LOG_LEVEL_INFO);
-
-    }
-
-    CHECK_STATUS(bladerf_sync_config(dev, BLADERF_RX_X1, BLADERF_FORMAT_SC16_Q11_META, 1024, 8192, 16, 1000));
-
-    printf("Starting frequency hopping...\n");
-    CHECK_STATUS(bladerf_enable_module(dev, BLADERF_RX, true));
-    bladerf_get_timestamp(dev, BLADERF_RX, &timestamp);
-    timestamp += 1000;
-    for (i = j = 0; i < ITERATIONS; i++) {
-        CHECK_STATUS(bladerf_schedule_retune(dev, ch, timestamp, frequencies[i % num_frequencies], &quick_tunes[j]));
-
-        j = (j + 1) % num_frequencies;
-        timestamp += 256;
-    }
+    printf("Starting sweep...\n");
+    CHECK_STATUS(bladerf_sweep(dev, &config));
 
 error:
     free(frequencies);
-    free(quick_tunes);
-    bladerf_enable_module(dev, BLADERF_RX, false);
     bladerf_close(dev);
     return status;
 }
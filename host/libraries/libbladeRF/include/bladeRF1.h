@@ -1271,8 +1271,98 @@ API_EXPORT
 int CALL_CONV bladerf_calibrate_dc(struct bladerf *dev,
                                    bladerf_cal_module module);
 
+/**
+ * Find the RX LMS DC offset corrections for a list of frequencies
+ *
+ * The search runs in the FPGA's NIOS II, which tunes to each frequency and
+ * measures the DC offset of each trial correction with the FPGA RX power
+ * meter. The host only loads the frequencies and reads back the results, so
+ * a full sweep avoids a USB round trip per trial.
+ *
+ * The RX module must be enabled, with the sample rate, bandwidth and gains
+ * set up as they will be used. No stream needs to be running. The RX
+ * frequency and DC offset corrections in use are restored when this returns.
+ *
+ * The results are in the units of ::BLADERF_CORR_LMS_DCOFF_I and
+ * ::BLADERF_CORR_LMS_DCOFF_Q. TX DC offsets cannot be measured this way.
+ *
+ * @note This requires FPGA v0.16.0 or later, and is not supported with the
+ *       XB-200 attached.
+ *
+ * @param       dev         Device handle
+ * @param[in]   frequencies RX frequencies to calibrate at
+ * @param[in]   count       Number of frequencies
+ * @param[in]   num_samples Samples per DC offset measurement, from 1 to
+ *                          ::BLADERF_RX_POWER_MAX_SAMPLES
+ * @param[out]  dc_i        `count` I corrections, one per frequency
+ * @param[out]  dc_q        `count` Q corrections, one per frequency
+ *
+ * @return 0 on success, BLADERF_ERR_UNSUPPORTED if the FPGA does not support
+ *         this, BLADERF_ERR_TIMEOUT if the sweep did not complete, or another
+ *         value from \ref RETCODES on failure.
+ */
+API_EXPORT
+int CALL_CONV bladerf_calibrate_rx_dc_sweep(struct bladerf *dev,
+                                            const bladerf_frequency *frequencies,
+                                            unsigned int count,
+                                            unsigned int num_samples,
+                                            int16_t *dc_i,
+                                            int16_t *dc_q);
+
 /** @} (End of FN_BLADERF1_DC_CAL) */
 
+/**
+ * @defgroup FN_BLADERF1_VCOCAP VCOCAP characterization
+ *
+ * Each tuning of the LMS6002D PLLs normally searches for the VCO capacitor
+ * (VCOCAP) setting that centers the VCO, which costs a number of register
+ * accesses over USB. Since the result depends mostly on the board and the
+ * frequency, it can be characterized once per board and stored in flash,
+ * after the calibration data. When such a table is present, host-mode tuning
+ * checks the VCOCAP value interpolated from the table with a single VTUNE
+ * read, falling back to the search only if the VCO is out of range.
+ *
+ * In ::BLADERF_TUNING_MODE_FPGA and for scheduled retunes, the table only
+ * improves the starting point of the search run by the FPGA.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Characterize the VCOCAP settings of both LMS6002D PLLs across the tuning
+ * range, and use the result for subsequent tunings.
+ *
+ * This retunes the RX and TX modules many times, and takes a few seconds.
+ * Their frequencies are restored when this returns. The device should be at
+ * its normal operating temperature.
+ *
+ * @param       dev     Device handle
+ * @param[in]   store   Write the table to flash, so it is loaded whenever
+ *                      the device is opened. The calibration data sharing
+ *                      its flash erase block is preserved.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_characterize_vcocap(struct bladerf *dev, bool store);
+
+/**
+ * Stop using a VCOCAP table, returning to a full search on every tuning.
+ *
+ * @param       dev     Device handle
+ * @param[in]   erase   Also remove the table stored in flash. The
+ *                      calibration data sharing its flash erase block is
+ *                      preserved.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_clear_vcocap_table(struct bladerf *dev, bool erase);
+
+/** @} (End of FN_BLADERF1_VCOCAP) */
+
 /**
  * @defgroup FN_BLADERF1_LOW_LEVEL Low-level accessors
  *
@@ -1376,6 +1466,19 @@ int CALL_CONV bladerf_calibrate_dc(struct bladerf *dev,
  */
 #define BLADERF_GPIO_8BIT_MODE (1 << 20)
 
+/**
+ * Enable 12-bit packed sample mode (bladeRF 2.0 Micro only)
+ */
+#define BLADERF_GPIO_SC12_PACKED (1 << 21)
+
+/**
+ * log2 of the number of DMA buffers spanned by each RX metadata message
+ * (bladeRF 2.0 Micro only). Only the first buffer of a message carries a
+ * header. Ignored in packet and 12-bit packed modes.
+ */
+#define BLADERF_GPIO_RX_META_MSG_SHIFT 22
+#define BLADERF_GPIO_RX_META_MSG_MASK (0x3 << BLADERF_GPIO_RX_META_MSG_SHIFT)
+
 /**
  * AGC enable control bit
  *
@@ -66,6 +66,367 @@ int CALL_CONV bladerf_set_bias_tee(struct bladerf *dev,
 
 /** @} (End of FN_BLADERF2_BIAS_TEE) */
 
+/**
+ * @defgroup FN_BLADERF2_FASTLOCK Fast lock profile store
+ *
+ * The AD9361 holds only 8 fast lock profiles per direction, and the bladeRF
+ * 2.0 FPGA holds 256, some of which are handed out by
+ * bladerf_get_quick_tune(). Hopping schemes needing more frequencies than
+ * this may instead keep their profiles in a store on the host.
+ *
+ * Upon first use, a direction's store reserves up to 128 of the remaining
+ * FPGA-held profiles. Stored profiles are copied into these as needed, with
+ * the least recently used profile being replaced, and a retune scheduled from
+ * the store makes its profile resident first. The profiles of the 16 most
+ * recently scheduled retunes, which may yet be pending, are not replaced.
+ *
+ * Copying a profile into the FPGA requires a few control transfers, so
+ * a hop sequence should be prefetched via
+ * bladerf_prefetch_fastlock_profiles() when it fits in the reserved profiles.
+ *
+ * This requires the ::BLADERF_CAP_SCHEDULED_RETUNE capability, and, with FPGA
+ * control of the RFIC (::BLADERF_TUNING_MODE_FPGA), an FPGA supporting the
+ * fast lock profile transfer commands. The RFIC's last profile is used to
+ * transfer profiles, and so must not be in use by a
+ * pending retune from bladerf_get_quick_tune() when a profile is stored or
+ * copied.
+ *
+ * Stored profiles are kept when the FPGA is reinitialized, and are copied
+ * into a newly reserved set of FPGA-held profiles as they are next used.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Store the current fast lock profile of a channel's direction
+ *
+ * Tune the channel via bladerf_set_frequency() beforehand.
+ *
+ * @param       dev     Device handle
+ * @param[in]   ch      Channel
+ * @param[out]  index   Index of the stored profile
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_store_fastlock_profile(struct bladerf *dev,
+                                             bladerf_channel ch,
+                                             unsigned int *index);
+
+/**
+ * Copy stored profiles into the FPGA ahead of their retunes
+ *
+ * @param       dev     Device handle
+ * @param[in]   ch      Channel
+ * @param[in]   indices Profile indices from bladerf_store_fastlock_profile()
+ * @param[in]   count   Number of entries in `indices`
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_prefetch_fastlock_profiles(struct bladerf *dev,
+                                                 bladerf_channel ch,
+                                                 const unsigned int *indices,
+                                                 unsigned int count);
+
+/**
+ * Schedule a retune to a stored profile
+ *
+ * This behaves as bladerf_schedule_retune() does with a quick tune.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   timestamp   Channel timestamp at which to retune, or
+ *                          ::BLADERF_RETUNE_NOW
+ * @param[in]   index       Profile index from bladerf_store_fastlock_profile()
+ *
+ * @return 0 on success,
+ *         BLADERF_ERR_QUEUE_FULL if the retune queue is full,
+ *         value from \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_schedule_fastlock_retune(struct bladerf *dev,
+                                               bladerf_channel ch,
+                                               bladerf_timestamp timestamp,
+                                               unsigned int index);
+
+/**
+ * Discard all profiles stored for a channel's direction
+ *
+ * The store keeps its reserved FPGA-held profiles.
+ *
+ * @param       dev     Device handle
+ * @param[in]   ch      Channel
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_clear_fastlock_profiles(struct bladerf *dev,
+                                              bladerf_channel ch);
+
+/** @} (End of FN_BLADERF2_FASTLOCK) */
+
+/**
+ * @defgroup FN_BLADERF2_SCHEDULED_GAIN Scheduled gain changes
+ *
+ * Gain changes may be placed in the FPGA's retune queue, alongside scheduled
+ * retunes, to take effect at a channel timestamp. This lets an AGC running
+ * on the host change the gain on a sample buffer boundary without waiting on
+ * a control transfer at that moment.
+ *
+ * The FPGA applies a setting precomputed for the frequency the direction was
+ * last tuned to with bladerf_set_frequency(). A scheduled retune leaves
+ * gain changes unavailable until the next bladerf_set_frequency(). RX
+ * channels must be in manual gain mode (::BLADERF_GAIN_MGC).
+ *
+ * This requires host control of the RFIC (::BLADERF_TUNING_MODE_HOST) and
+ * the ::BLADERF_CAP_SCHEDULED_GAIN capability. Pending gain changes are
+ * discarded by bladerf_cancel_scheduled_retunes().
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Schedule a change to a channel's overall gain
+ *
+ * The gain is clamped to the channel's gain range, as bladerf_set_gain()
+ * does. While a TX channel is muted, the gain is instead set at once for when
+ * it is unmuted, as bladerf_set_gain() does.
+ *
+ * A later bladerf_get_gain() reports the gain once it has been applied.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   timestamp   Channel timestamp at which to change the gain, or
+ *                          ::BLADERF_RETUNE_NOW
+ * @param[in]   gain        Desired gain, in dB
+ *
+ * @return 0 on success,
+ *         BLADERF_ERR_QUEUE_FULL if the retune queue is full,
+ *         BLADERF_ERR_UNSUPPORTED if the conditions above are not met,
+ *         value from \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_schedule_gain(struct bladerf *dev,
+                                    bladerf_channel ch,
+                                    bladerf_timestamp timestamp,
+                                    int gain);
+
+/** @} (End of FN_BLADERF2_SCHEDULED_GAIN) */
+
+/**
+ * @defgroup FN_BLADERF2_LIVE_SAMPLE_RATE Sample rate changes on a live stream
+ *
+ * Changing the sample rate reconfigures the RFIC's clocks and filters, during
+ * which its samples are not usable. Rather than stopping the streams and
+ * configuring them again, bladerf_set_sample_rate_live() leaves them running
+ * and their buffers allocated:
+ *
+ *  - TX samples already submitted are sent before the rate is changed.
+ *  - RX transfers that may hold samples taken during the change are
+ *    discarded. The first samples received at the new rate are then reported
+ *    with ::BLADERF_META_STATUS_RATE_CHANGE, and start a new call to
+ *    bladerf_sync_rx() if a bladerf_metadata structure is provided.
+ *
+ * With the metadata formats, a call receiving samples at the new rate returns
+ * from the first of them, as with ::BLADERF_META_FLAG_RX_NOW, and reports
+ * its timestamp. Timestamps continue to count samples, at the new rate.
+ *
+ * This is not supported with the ::BLADERF_FEATURE_OVERSAMPLE feature.
+ *
+ * @{
+ */
+
+/**
+ * Change the sample rate of running streams
+ *
+ * This is otherwise as bladerf_set_sample_rate(), and may be called while
+ * another thread is receiving or transmitting.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   rate        Sample rate
+ * @param[out]  actual      If non-NULL, written with the actual sample rate
+ * @param[out]  timestamp   If non-NULL, written with the RX timestamp once the
+ *                          rate has changed. Samples received from then on
+ *                          are at the new rate.
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_TIMEOUT if submitted TX samples were not sent within
+ *         the TX stream timeout, in which case the rate is left unchanged,
+ *         value from \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_sample_rate_live(struct bladerf *dev,
+                                           bladerf_channel ch,
+                                           bladerf_sample_rate rate,
+                                           bladerf_sample_rate *actual,
+                                           bladerf_timestamp *timestamp);
+
+/** @} (End of FN_BLADERF2_LIVE_SAMPLE_RATE) */
+
+/**
+ * @defgroup FN_BLADERF2_TELEMETRY Background telemetry
+ *
+ * Reading the RFIC temperature, RSSI or power monitor takes control round
+ * trips to the device, which hold up other control operations meanwhile. An
+ * optional sampler thread reads them periodically instead. It steps aside
+ * between reads for latency-critical operations, such as scheduled retunes
+ * and timestamp reads.
+ *
+ * While the sampler runs, bladerf_get_rfic_temperature(),
+ * bladerf_get_rfic_rssi() for RX channels, and bladerf_get_pmic_register()
+ * for the voltage, current and power registers return its latest values,
+ * without accessing the device.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/** bladerf_telemetry::rfic_temperature is valid */
+#define BLADERF_TELEMETRY_TEMPERATURE (1 << 0)
+
+/** RSSI fields for RX channel `n` (0 or 1) are valid */
+#define BLADERF_TELEMETRY_RSSI(n) (1 << (1 + (n)))
+
+/** Power monitor fields are valid */
+#define BLADERF_TELEMETRY_PMIC (1 << 3)
+
+/**
+ * Telemetry sample
+ */
+struct bladerf_telemetry {
+    uint64_t host_ns; /**< bladerf_get_host_time_ns() when the sample was
+                           completed */
+    uint32_t valid;   /**< BLADERF_TELEMETRY_* flags of the fields read */
+    float rfic_temperature; /**< RFIC temperature, in degrees C */
+    int32_t pre_rssi[2];    /**< Preamble RSSI of each RX channel, in dB */
+    int32_t sym_rssi[2];    /**< Symbol RSSI of each RX channel, in dB */
+    float voltage_shunt;    /**< Power monitor shunt voltage */
+    float voltage_bus;      /**< Power monitor bus voltage */
+    float power;            /**< Load power */
+    float current;          /**< Load current */
+};
+
+/**
+ * Start, restart or stop the telemetry sampler
+ *
+ * @param       dev         Device handle
+ * @param[in]   interval_ms Sampling interval, or 0 to stop the sampler
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_enable_telemetry(struct bladerf *dev,
+                                       unsigned int interval_ms);
+
+/**
+ * Get the latest telemetry sample, without accessing the device
+ *
+ * @param       dev         Device handle
+ * @param[out]  sample      Latest sample
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_NOT_INIT if the sampler is not running,
+ *         ::BLADERF_ERR_WOULD_BLOCK if it has not completed a sample yet,
+ *         value from \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_telemetry(struct bladerf *dev,
+                                    struct bladerf_telemetry *sample);
+
+/**
+ * @defgroup FN_BLADERF2_RECAL Temperature-triggered recalibration
+ *
+ * Rather than re-running every calibration on a timer, the telemetry sampler
+ * can track the RFIC temperature change since each calibration was last run,
+ * and run only those whose threshold has been crossed.
+ *
+ * The AD9361 tracks its RX baseband DC offset and RX quadrature error
+ * continuously, so these are not covered.
+ *
+ * Calibrations disturb the signal while they run. A configuration may defer
+ * them, so that they only run when the application calls
+ * bladerf_run_recal() at a point where this is acceptable, such as between
+ * bursts.
+ *
+ * This requires host RFIC control.
+ *
+ * @{
+ */
+
+/** RX and TX synthesizer VCO calibrations */
+#define BLADERF_RECAL_SYNTH (1 << 0)
+
+/** RX RF DC offset calibration */
+#define BLADERF_RECAL_RX_DC (1 << 1)
+
+/** TX quadrature (LO leakage and IQ imbalance) calibration */
+#define BLADERF_RECAL_TX_QUAD (1 << 2)
+
+/**
+ * Recalibration thresholds. Each is the temperature change, in degrees C,
+ * since a calibration was last run that causes it to be run again, or 0 to
+ * never run it.
+ */
+struct bladerf_recal_config {
+    float synth_threshold;   /**< For ::BLADERF_RECAL_SYNTH */
+    float rx_dc_threshold;   /**< For ::BLADERF_RECAL_RX_DC */
+    float tx_quad_threshold; /**< For ::BLADERF_RECAL_TX_QUAD */
+    bool deferred;           /**< Only run calibrations from
+                                  bladerf_run_recal() */
+};
+
+/**
+ * Configure temperature-triggered recalibration
+ *
+ * Temperature changes are measured from the time of this call. They are only
+ * checked while the telemetry sampler runs.
+ *
+ * @param       dev         Device handle
+ * @param[in]   config      Configuration, or NULL to disable
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED without host RFIC control,
+ *         value from \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_recal_config(
+    struct bladerf *dev, const struct bladerf_recal_config *config);
+
+/**
+ * Get the calibrations whose thresholds have been crossed, but which have
+ * not been run yet
+ *
+ * @param       dev         Device handle
+ * @param[out]  pending     Mask of BLADERF_RECAL_* values
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_recal_pending(struct bladerf *dev,
+                                        uint32_t *pending);
+
+/**
+ * Run the pending calibrations now
+ *
+ * @param       dev         Device handle
+ * @param[out]  ran         If non-NULL, set to the mask of BLADERF_RECAL_*
+ *                          calibrations run
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_run_recal(struct bladerf *dev, uint32_t *ran);
+
+/** @} (End of FN_BLADERF2_RECAL) */
+
+/** @} (End of FN_BLADERF2_TELEMETRY) */
+
 /**
  * @defgroup FN_BLADERF2_LOW_LEVEL Low-level accessors
  *
@@ -25,11 +25,30 @@
 #include <stdint.h>
 #include "libbladeRF.h"
 
+/**
+ * Gain corrections resampled onto uniformly spaced frequency bins, such that
+ * looking up the correction for a frequency requires no search.
+ *
+ * corr[n] holds the correction at start_freq + n * resolution. Values between
+ * bin edges are linearly interpolated. A table may be shared by channels whose
+ * calibration was loaded from the same file, and is reference counted.
+ */
+struct gain_cal_lut {
+    unsigned int refcount;
+    bladerf_frequency start_freq;
+    bladerf_frequency stop_freq;
+    bladerf_frequency resolution;
+    float inv_resolution;
+    uint32_t n_bins;
+    float *corr;
+};
+
 /**
  * @brief Converts gain calibration CSV data to a binary format.
  *
- * This function reads frequency and gain data from a CSV file and writes it
- * to a binary file.
+ * This function reads frequency and gain data from a CSV file and writes the
+ * resulting calibration table entries to a binary file. This file is laid out
+ * such that load_gain_calibration() can map it and use the entries in place.
  *
  * @param csv_path     Path to the input CSV file.
  * @param binary_path  Path to the output binary file.
@@ -51,6 +70,18 @@ int gain_cal_csv_to_bin(struct bladerf *dev, const char *csv_path, const char *b
  */
 int load_gain_calibration(struct bladerf *dev, bladerf_channel ch, const char *binary_path);
 
+/**
+ * @brief Check whether a binary gain calibration file is up to date.
+ *
+ * @param csv_path     Path to the CSV file the binary file was converted from.
+ * @param binary_path  Path to the binary file.
+ * @param ch           bladeRF channel
+ *
+ * @return true if the binary file is a valid conversion for `ch` and is no
+ *         older than the CSV file, and false otherwise.
+ */
+bool gain_cal_bin_is_current(const char *csv_path, const char *binary_path, bladerf_channel ch);
+
 /**
  * @brief Retrieve the gain correction gain delta between the current frequency and the target frequency.
  *
@@ -101,6 +132,49 @@ int get_gain_cal_entry(const struct bladerf_gain_cal_tbl *tbl,
                        bladerf_frequency freq,
                        struct bladerf_gain_cal_entry *result);
 
+/**
+ * Look up the gain correction for a frequency on the specified channel.
+ *
+ * This uses the channel's lookup table if one has been built, and otherwise
+ * interpolates directly from the calibration table entries.
+ *
+ * @param[in]  dev        The bladeRF device structure pointer.
+ * @param[in]  ch         The bladeRF channel to use.
+ * @param[in]  freq       The frequency for which the correction is requested.
+ * @param[out] gain_corr  Gain correction at `freq`
+ *
+ * @return 0 on success, BLADERF_ERR_UNEXPECTED if `freq` is above the range
+ *         of the calibration table.
+ */
+int lookup_gain_correction(struct bladerf *dev,
+                           bladerf_channel ch,
+                           bladerf_frequency freq,
+                           double *gain_corr);
+
+/**
+ * (Re)build the gain correction lookup table for a channel with a loaded
+ * calibration table, using the device's current resolution setting.
+ *
+ * If another channel in the same direction was loaded from the same file,
+ * its lookup table is shared rather than building a new one. If the
+ * resolution setting is 0, the channel's lookup table is released.
+ *
+ * @param dev       The bladeRF device structure pointer.
+ * @param ch        The bladeRF channel to use.
+ *
+ * @return 0 on success, BLADERF_ERR_MEM on allocation failure. In case of
+ *         failure, the channel falls back to searching its calibration table.
+ */
+int gain_cal_lut_update(struct bladerf *dev, bladerf_channel ch);
+
+/**
+ * Release a channel's reference to its gain correction lookup table
+ *
+ * @param dev       The bladeRF device structure pointer.
+ * @param ch        The bladeRF channel to use.
+ */
+void gain_cal_lut_release(struct bladerf *dev, bladerf_channel ch);
+
 /**
  * Applies compensated gain given the current gain target and center frequency
  *
@@ -125,4 +199,13 @@ int apply_gain_correction(struct bladerf *dev, bladerf_channel ch, bladerf_frequ
  */
 void gain_cal_tbl_free(struct bladerf_gain_cal_tbl *tbl);
 
+/**
+ * Release a channel's gain calibration table, along with its lookup table and
+ * any file mapping backing its entries.
+ *
+ * @param dev       The bladeRF device structure pointer.
+ * @param ch        The bladeRF channel to use.
+ */
+void gain_cal_unload(struct bladerf *dev, bladerf_channel ch);
+
 #endif
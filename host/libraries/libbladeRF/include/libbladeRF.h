@@ -116,6 +116,8 @@ typedef enum {
     BLADERF_BACKEND_LIBUSB,      /**< libusb */
     BLADERF_BACKEND_CYPRESS,     /**< CyAPI */
     BLADERF_BACKEND_DUMMY = 100, /**< Dummy used for development purposes */
+    BLADERF_BACKEND_NET   = 101, /**< Device served over the network by
+                                  *   bladeRF-server */
 } bladerf_backend;
 
 /** Length of device description string, including NUL-terminator */
@@ -124,6 +126,12 @@ typedef enum {
 /** Length of device serial number string, including NUL-terminator */
 #define BLADERF_SERIAL_LENGTH 33
 
+/** Length of a network backend host name, including NUL-terminator */
+#define BLADERF_NET_HOST_LENGTH 64
+
+/** TCP port used by the network backend when none is specified */
+#define BLADERF_NET_DEFAULT_PORT 7550
+
 /**
  * Information about a bladeRF attached to the system
  */
@@ -138,6 +146,10 @@ struct bladerf_devinfo {
     /** Manufacturer description string */
     char manufacturer[BLADERF_DESCRIPTION_LENGTH];
     char product[BLADERF_DESCRIPTION_LENGTH]; /**< Product description string */
+
+    /** Host serving the device, for the network backend */
+    char net_host[BLADERF_NET_HOST_LENGTH];
+    uint16_t net_port; /**< Port of net_host, or 0 for the default */
 };
 
 /**
@@ -169,6 +181,11 @@ struct bladerf_backendinfo {
  *   - libusb:  libusb (See libusb changelog notes for required version, given
  *   your OS and controller)
  *   - cypress: Cypress CyUSB/CyAPI backend (Windows only)
+ *   - dummy:   Synthetic device for testing and benchmarking without hardware
+ *   (only available when libbladeRF is built with ENABLE_BACKEND_DUMMY)
+ *   - net:     Device served by bladeRF-server on another host (only
+ *   available when libbladeRF is built with ENABLE_BACKEND_NET). See
+ *   bladerf_net_serve().
  *
  * If no arguments are provided after the backend, the first encountered
  * device on the specified backend will be opened. Note that a backend is
@@ -187,6 +204,13 @@ struct bladerf_backendinfo {
  *      - Nth instance encountered, 0-indexed
  *   - serial=\<serial\>
  *      - Device's serial number.
+ *   - host=\<host\>
+ *      - Host name or address of a bladeRF-server (net backend only)
+ *   - port=\<port\>
+ *      - TCP port of the bladeRF-server. Defaults to
+ *        ::BLADERF_NET_DEFAULT_PORT. (net backend only)
+ *
+ * For example, `net:host=192.168.1.20 port=7550`.
  *
  * Below is an example of how to open a device with a specific serial
  * number, using any avaiable backend supported by libbladeRF:
@@ -260,6 +284,33 @@ int CALL_CONV bladerf_open_with_devinfo(struct bladerf **device,
 API_EXPORT
 int CALL_CONV bladerf_get_device_list(struct bladerf_devinfo **devices);
 
+/**
+ * Obtain a list of bladeRF devices attached to the system, without opening
+ * them
+ *
+ * Unlike bladerf_get_device_list(), this does not open each device to read
+ * its serial number, manufacturer, and product strings, which takes some time
+ * per device and may interfere with other processes using the devices. The
+ * `backend`, `usb_bus`, `usb_addr`, and `instance` fields of each entry are
+ * populated. The remaining fields are populated only if they were read by an
+ * earlier bladerf_get_device_list() or bladerf_open() call in this process,
+ * and the device has not since been unplugged or reset. Otherwise, `serial`
+ * is an empty string.
+ *
+ * Devices are matched by their USB vendor and product IDs, so all entries are
+ * bladeRF devices.
+ *
+ * @note The Cypress backend must open devices in order to enumerate them,
+ *       so this is equivalent to bladerf_get_device_list() with that backend.
+ *
+ * @param[out]  devices
+ *
+ * @return number of items in returned device list, or value from
+ *         \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_device_list_quick(struct bladerf_devinfo **devices);
+
 /**
  * Free device list returned by bladerf_get_device_list()
  *
@@ -268,6 +319,78 @@ int CALL_CONV bladerf_get_device_list(struct bladerf_devinfo **devices);
 API_EXPORT
 void CALL_CONV bladerf_free_device_list(struct bladerf_devinfo *devices);
 
+/**
+ * Device hotplug events
+ */
+typedef enum {
+    BLADERF_HOTPLUG_ARRIVED, /**< A device was attached */
+    BLADERF_HOTPLUG_LEFT,    /**< A device was detached or reset */
+} bladerf_hotplug_event;
+
+/**
+ * Hotplug event callback
+ *
+ * This is called from a thread internal to libbladeRF, and should return
+ * promptly, as events for other devices are not delivered until it does. It
+ * may call bladerf_get_device_list() and bladerf_open(), but must not call
+ * bladerf_register_hotplug_callback() or
+ * bladerf_deregister_hotplug_callback().
+ *
+ * @param[in]   event       Type of event
+ * @param[in]   info        Information about the device. For
+ *                          ::BLADERF_HOTPLUG_LEFT events, this is the
+ *                          information that was reported when the device
+ *                          arrived.
+ * @param[in]   user_data   User data provided when registering the callback
+ */
+typedef void (*bladerf_hotplug_cb)(bladerf_hotplug_event event,
+                                   const struct bladerf_devinfo *info,
+                                   void *user_data);
+
+/**
+ * Register a callback to be notified as bladeRF devices are attached and
+ * detached
+ *
+ * While any callback is registered, libbladeRF maintains a registry of the
+ * attached devices, updated as hotplug events occur. bladerf_get_device_list()
+ * returns the contents of this registry, rather than probing for devices.
+ *
+ * Upon registration, `cb` is called with ::BLADERF_HOTPLUG_ARRIVED for each
+ * device already attached, before this function returns.
+ *
+ * A device that is reset (e.g., by a firmware update, or by
+ * bladerf_set_usb_reset_on_open()) generates a ::BLADERF_HOTPLUG_LEFT event
+ * followed by a ::BLADERF_HOTPLUG_ARRIVED event, with a new USB address.
+ *
+ * @note This is currently only supported by the libusb backend, with a libusb
+ *       version and platform supporting hotplug notifications.
+ *
+ * @param[in]   cb          Callback function
+ * @param[in]   user_data   User data passed to `cb`
+ * @param[out]  handle      Handle used to deregister the callback
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if hotplug notifications
+ *         are unavailable, or value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_register_hotplug_callback(bladerf_hotplug_cb cb,
+                                                void *user_data,
+                                                int *handle);
+
+/**
+ * Deregister a hotplug callback
+ *
+ * Once this returns, the callback is no longer running, and will not be
+ * called again.
+ *
+ * @param[in]   handle      Handle provided by
+ *                          bladerf_register_hotplug_callback()
+ *
+ * @return 0 on success, ::BLADERF_ERR_INVAL if `handle` is invalid
+ */
+API_EXPORT
+int CALL_CONV bladerf_deregister_hotplug_callback(int handle);
+
 /**
  * Initialize a device identifier information structure to a "wildcard" state.
  *
@@ -374,6 +497,77 @@ const char *CALL_CONV bladerf_backend_str(bladerf_backend backend);
 API_EXPORT
 void CALL_CONV bladerf_set_usb_reset_on_open(bool enabled);
 
+/**
+ * Enable or disable "warm" opening of devices for future bladerf_open() and
+ * bladerf_open_with_devinfo() calls.
+ *
+ * When enabled, a device that was fully initialized by an earlier open (in
+ * this or another process of the same user, with warm opening enabled) is
+ * recognized via a configuration ID retained by its FPGA. Opening such a
+ * device skips re-reading its versions, capabilities, and calibration data
+ * from the firmware and SPI flash, as well as device initialization steps
+ * whose results persist across opens.
+ *
+ * The RF state of the device (frequency, gain, sample rate, etc.) is left as
+ * it was when last closed, as with a conventional open. A full initialization
+ * is performed if the device has been reset, its FPGA has been reconfigured,
+ * or its SPI flash has been written since it was last initialized.
+ *
+ * This is currently only supported by the bladeRF 2.0 with an FPGA capable of
+ * RFIC control, and has no effect otherwise. As the RFIC state must outlive
+ * the process that initialized it, enabling this makes
+ * ::BLADERF_TUNING_MODE_FPGA the default tuning mode where available. (The
+ * `BLADERF_DEFAULT_TUNING_MODE` environment variable still takes precedence.)
+ * It is disabled by default.
+ *
+ * @param[in]   enabled     Set true to enable warm opens, and false otherwise.
+ */
+API_EXPORT
+void CALL_CONV bladerf_set_warm_open(bool enabled);
+
+/**
+ * Serve a device to clients of the network (`net`) backend
+ *
+ * This listens for TCP connections on the specified address and port, and
+ * blocks until bladerf_net_serve_stop() is called. A single client may
+ * control the device at a time; each stream it configures is carried on a
+ * connection of its own. Upon the controlling client disconnecting, the
+ * device's RX and TX modules are disabled.
+ *
+ * Clients can read and write anything on the device, including its flash, so
+ * the server must only be reachable from trusted networks. No authentication
+ * or encryption is performed.
+ *
+ * The `BLADERF_NET_PACK` environment variable of the client, set to `sc12` or
+ * `sc8`, packs SC16 Q11 samples to 12 or 8 bits per component on the wire,
+ * to trade precision for bandwidth. Timestamps (metadata formats) are always
+ * passed through unpacked.
+ *
+ * @note This is only available when libbladeRF is built with
+ *       ENABLE_BACKEND_NET, and returns ::BLADERF_ERR_UNSUPPORTED otherwise.
+ *
+ * @param       dev         Device handle. It should not be used by the caller
+ *                          while it is being served.
+ * @param[in]   address     Address to listen on, or NULL for all interfaces
+ * @param[in]   port        TCP port, or 0 for ::BLADERF_NET_DEFAULT_PORT
+ *
+ * @return 0 once stopped, or value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_net_serve(struct bladerf *dev,
+                                const char *address,
+                                uint16_t port);
+
+/**
+ * Stop bladerf_net_serve(), which returns once its connections are closed
+ *
+ * This may be called from another thread or a signal handler.
+ *
+ * @param       dev         Device handle being served
+ */
+API_EXPORT
+void CALL_CONV bladerf_net_serve_stop(struct bladerf *dev);
+
 /** @} (End FN_INIT) */
 
 /**
@@ -1287,6 +1481,70 @@ API_EXPORT
 int CALL_CONV bladerf_set_frequency(struct bladerf *dev,
                                     bladerf_channel ch,
                                     bladerf_frequency frequency);
+
+/**
+ * Start retuning a channel, without waiting for its synthesizer to lock
+ *
+ * This does everything bladerf_set_frequency() does, but returns once the
+ * synthesizer has been programmed. Other configuration, such as gains or the
+ * other direction's frequency, may then be carried out while it settles.
+ * Use bladerf_wait_pll_lock() or bladerf_get_pll_lock() before relying on
+ * the new frequency.
+ *
+ * On the bladeRF2 with host RFIC control, the AD9361 VCO calibration is left
+ * running. Elsewhere, including the bladeRF1 with host tuning, the
+ * synthesizer tuning completes before this returns, as for
+ * bladerf_set_frequency().
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   frequency   Desired frequency
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_frequency_begin(struct bladerf *dev,
+                                          bladerf_channel ch,
+                                          bladerf_frequency frequency);
+
+/**
+ * Check whether a channel's synthesizer is locked
+ *
+ * On the bladeRF1, this reports whether the LMS6002D VCO tuning voltage is
+ * within its normal range. On the bladeRF2, it reports the AD9361 VCO lock
+ * detect of the channel's direction.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[out]  locked      Whether the synthesizer is locked
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_pll_lock(struct bladerf *dev,
+                                   bladerf_channel ch,
+                                   bool *locked);
+
+/**
+ * Wait for a channel's synthesizer to lock, following
+ * bladerf_set_frequency_begin()
+ *
+ * The device is not held locked between polls, so other threads may use it
+ * meanwhile.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   timeout_ms  Time to wait, in milliseconds
+ *
+ * @return 0 once locked, ::BLADERF_ERR_TIMEOUT if the synthesizer has not
+ *         locked within `timeout_ms`, value from \ref RETCODES list on
+ *         other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_wait_pll_lock(struct bladerf *dev,
+                                    bladerf_channel ch,
+                                    unsigned int timeout_ms);
+
 /**
  * Get channel's current frequency in Hz
  *
@@ -1725,6 +1983,42 @@ int CALL_CONV bladerf_trigger_state(struct bladerf *dev,
                                     uint64_t *resv1,
                                     uint64_t *resv2);
 
+/**
+ * Time at which a trigger fired, as reported by bladerf_get_trigger_time()
+ *
+ * The FPGA latches the channel's timestamp counter when it sees the trigger
+ * signal asserted, at twice the sample rate. Latching is delayed by a fixed
+ * number of clock cycles, which is the same on each device of a trigger
+ * chain, so the difference between two devices' trigger times is the offset
+ * between their timestamp counters.
+ */
+struct bladerf_trigger_time {
+    bool fired;                  /**< The trigger has fired since the
+                                      timestamp counter was last reset. If
+                                      not, the other fields are 0. */
+    uint64_t timestamp;          /**< Timestamp in effect when the trigger
+                                      fired */
+    bool second_half;            /**< The trigger fired in the second half
+                                      of that sample period */
+};
+
+/**
+ * Read the time at which a trigger last fired
+ *
+ * @note Requires FPGA v0.16.4 or later on the bladeRF 1. Not supported on the
+ *       bladeRF 2.0 Micro.
+ *
+ * @param       dev         Device handle
+ * @param[in]   trigger     Trigger to query
+ * @param[out]  time        Time at which the trigger fired
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_trigger_time(struct bladerf *dev,
+                                       const struct bladerf_trigger *trigger,
+                                       struct bladerf_trigger_time *time);
+
 /** @} (End of FN_TRIG) */
 
 /**
@@ -1795,8 +2089,226 @@ int CALL_CONV bladerf_set_rx_mux(struct bladerf *dev, bladerf_rx_mux mux);
 API_EXPORT
 int CALL_CONV bladerf_get_rx_mux(struct bladerf *dev, bladerf_rx_mux *mode);
 
+/**
+ * Configure the FPGA's RX NCO and decimation stage
+ *
+ * The FPGA can mix the RX samples down by `nco_offset` Hz and then decimate
+ * them with a CIC filter and a short droop compensation FIR before they are
+ * sent to the host. The signal at `frequency + nco_offset` ends up at DC, and
+ * the host receives `sample_rate / decimation` samples per second per
+ * channel, so narrowband captures use a fraction of the USB bandwidth.
+ *
+ * The setting applies to all RX channels. Timestamps are still counted in
+ * ADC samples, so consecutive decimated samples are `decimation` ticks apart.
+ *
+ * The NCO step is derived from the current sample rate, so call this after
+ * bladerf_set_sample_rate(). Its resolution is 1/8192 of the sample rate.
+ *
+ * A decimation of 1 with an nco_offset of 0 disables the stage.
+ *
+ * @note This requires FPGA v0.16.0 or later on the bladeRF 2.0 Micro.
+ *
+ * @param       dev         Device handle
+ * @param[in]   decimation  Decimation factor: 1, 2, 4, 8, 16, 32 or 64
+ * @param[in]   nco_offset  NCO offset in Hz, within +/- half the sample rate
+ *
+ * @return 0 on success, BLADERF_ERR_UNSUPPORTED if the device or FPGA does
+ *         not support decimation, or another value from \ref RETCODES on
+ *         failure.
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_rx_decimation(struct bladerf *dev,
+                                        unsigned int decimation,
+                                        int32_t nco_offset);
+
+/**
+ * Get the current FPGA RX NCO and decimation configuration
+ *
+ * @param       dev         Device handle
+ * @param[out]  decimation  Decimation factor
+ * @param[out]  nco_offset  NCO offset in Hz, at the current sample rate
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure.
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_rx_decimation(struct bladerf *dev,
+                                        unsigned int *decimation,
+                                        int32_t *nco_offset);
+
 /** @} (End of FN_RECEIVE_MUX) */
 
+/**
+ * @defgroup FN_TX_WAVEFORM Transmit Waveform Playback
+ *
+ * The bladeRF 2.0 Micro FPGA can hold a short waveform in on-chip RAM and
+ * transmit it in a continuous loop, optionally interpolating it up by a
+ * power of two. Once started, no samples need to be streamed from the host,
+ * which suits test tones, beacons and other repeating signals.
+ *
+ * Playback replaces the samples from the TX FIFO on every enabled TX
+ * channel. The channels must still be enabled with bladerf_enable_module()
+ * for the DAC to request samples.
+ *
+ * @note These functions require FPGA v0.17.0 or later.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Maximum number of samples in a TX playback waveform
+ */
+#define BLADERF_TX_WAVEFORM_MAX_SAMPLES 4096
+
+/**
+ * Load a waveform for TX playback
+ *
+ * Any playback in progress is stopped first.
+ *
+ * @param       dev         Device handle
+ * @param[in]   samples     Interleaved SC16 Q11 samples, as in
+ *                          ::BLADERF_FORMAT_SC16_Q11
+ * @param[in]   num_samples Number of samples, from 1 to
+ *                          ::BLADERF_TX_WAVEFORM_MAX_SAMPLES
+ *
+ * @return 0 on success, BLADERF_ERR_UNSUPPORTED if the device or FPGA does
+ *         not support playback, or another value from \ref RETCODES on
+ *         failure.
+ */
+API_EXPORT
+int CALL_CONV bladerf_tx_load_waveform(struct bladerf *dev,
+                                       const int16_t *samples,
+                                       unsigned int num_samples);
+
+/**
+ * Start looping the loaded TX waveform
+ *
+ * Each loaded sample is linearly interpolated to `interpolation` output
+ * samples, so the loop repeats every `num_samples * interpolation` samples
+ * at the current sample rate.
+ *
+ * @param       dev             Device handle
+ * @param[in]   interpolation   Interpolation factor: 1, 2, 4, 8, 16, 32 or 64
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure.
+ */
+API_EXPORT
+int CALL_CONV bladerf_tx_loop_start(struct bladerf *dev,
+                                    unsigned int interpolation);
+
+/**
+ * Stop TX waveform playback and return to samples from the host
+ *
+ * @param       dev         Device handle
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure.
+ */
+API_EXPORT
+int CALL_CONV bladerf_tx_loop_stop(struct bladerf *dev);
+
+/** @} (End of FN_TX_WAVEFORM) */
+
+/**
+ * @defgroup FN_RX_POWER_METER RX Power Measurement
+ *
+ * The FPGA can measure the power, DC offset and IQ imbalance of an RX
+ * channel over a window of samples, or capture a short run of samples, and
+ * hand back only the result. This avoids configuring and running an RX
+ * stream just to monitor a channel.
+ *
+ * Measurements are taken on the samples from the RFIC, ahead of the RX mux
+ * and the FPGA decimation stage. The channel must be enabled with
+ * bladerf_enable_module(), but no stream needs to be running.
+ *
+ * @note These functions require FPGA v0.16.0 or later on the bladeRF x40 and
+ *       x115, and FPGA v0.17.0 or later on the bladeRF 2.0 Micro.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Maximum number of samples in one RX power measurement
+ */
+#define BLADERF_RX_POWER_MAX_SAMPLES (1 << 24)
+
+/**
+ * Maximum number of samples in an RX snapshot
+ */
+#define BLADERF_RX_SNAPSHOT_MAX_SAMPLES 1024
+
+/**
+ * Result of an RX power measurement
+ *
+ * Sample values are in SC16 Q11 units, as in ::BLADERF_FORMAT_SC16_Q11. The
+ * mean power relative to full scale is
+ * `power_sum / (num_samples * 2048.0 * 2048.0)`, and the DC offset of I is
+ * `i_sum / num_samples`.
+ *
+ * The second-order sums give the IQ imbalance without capturing samples.
+ * With the DC offsets removed, the gain imbalance is the square root of
+ * `var(I) / var(Q)`, and the phase imbalance is
+ * `asin(cov(I,Q) / sqrt(var(I) * var(Q)))`, where e.g.
+ * `var(I) = i2_sum / num_samples - mean(I)^2`.
+ */
+struct bladerf_rx_power {
+    unsigned int num_samples; /**< Number of samples measured */
+    uint64_t power_sum;       /**< Sum of I^2 + Q^2 */
+    int64_t i_sum;            /**< Sum of I */
+    int64_t q_sum;            /**< Sum of Q */
+    uint16_t peak;            /**< Largest magnitude of I or Q */
+    uint64_t i2_sum;          /**< Sum of I^2 */
+    uint64_t q2_sum;          /**< Sum of Q^2 */
+    int64_t iq_sum;           /**< Sum of I*Q */
+};
+
+/**
+ * Measure the power of an RX channel in the FPGA
+ *
+ * Blocks until `num_samples` samples have been measured.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          RX channel
+ * @param[in]   num_samples Number of samples to measure, from 1 to
+ *                          ::BLADERF_RX_POWER_MAX_SAMPLES
+ * @param[out]  power       Measurement result
+ *
+ * @return 0 on success, BLADERF_ERR_UNSUPPORTED if the device or FPGA does
+ *         not support power measurement, BLADERF_ERR_TIMEOUT if the channel
+ *         did not deliver enough samples, or another value from
+ *         \ref RETCODES on failure.
+ */
+API_EXPORT
+int CALL_CONV bladerf_measure_rx_power(struct bladerf *dev,
+                                       bladerf_channel ch,
+                                       unsigned int num_samples,
+                                       struct bladerf_rx_power *power);
+
+/**
+ * Capture a snapshot of consecutive RX samples in the FPGA
+ *
+ * Blocks until the samples have been captured, then reads them back. This
+ * is meant for occasional spectrum checks with a host FFT, not streaming.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          RX channel
+ * @param[out]  samples     Buffer for `num_samples` interleaved SC16 Q11
+ *                          samples
+ * @param[in]   num_samples Number of samples, from 1 to
+ *                          ::BLADERF_RX_SNAPSHOT_MAX_SAMPLES
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure.
+ */
+API_EXPORT
+int CALL_CONV bladerf_rx_snapshot(struct bladerf *dev,
+                                  bladerf_channel ch,
+                                  int16_t *samples,
+                                  unsigned int num_samples);
+
+/** @} (End of FN_RX_POWER_METER) */
+
 /**
  * @defgroup FN_SCHEDULED_TUNING Scheduled Tuning
  *
@@ -1907,53 +2419,355 @@ int CALL_CONV bladerf_cancel_scheduled_retunes(struct bladerf *dev,
                                                bladerf_channel ch);
 
 /**
- * Fetch parameters used to tune the transceiver to the current frequency for
- * use with bladerf_schedule_retune() to perform a "quick retune."
+ * State of a channel's queue of scheduled retunes
  *
- * This allows for a faster retune, with a potential trade off of increased
- * phase noise.
+ * @see bladerf_get_retune_queue_status()
+ */
+struct bladerf_retune_queue_status {
+    unsigned int pending;  /**< Number of retunes yet to be performed */
+    unsigned int capacity; /**< Maximum number of pending retunes */
+
+    /** Timestamp of the next retune to be performed. Only valid if `pending`
+     *  is nonzero. */
+    bladerf_timestamp next_timestamp;
+};
+
+/**
+ * Get the number of pending scheduled retunes for the specified channel, and
+ * when the next is due.
  *
- * @note These parameters are sensitive to changes in the operating environment,
- *       and should be "refreshed" if planning to use the "quick retune"
- *       functionality over a long period of time.
+ * A streaming application may use this to keep the queue full without
+ * submitting requests that fail with ::BLADERF_ERR_QUEUE_FULL.
  *
- * @pre bladerf_set_frequency() or bladerf_schedule_retune() have previously
- *      been used to retune to the desired frequency.
+ * FPGA v0.16.1 on the bladeRF x40 and x115, and FPGA v0.17.2 on the bladeRF
+ * 2.0 Micro, are required. These also keep the queue in timestamp order
+ * regardless of the order in which retunes were scheduled, while older
+ * versions perform retunes in the order scheduled.
  *
- * @param       dev         Device handle
- * @param[in]   ch          Channel
- * @param[out]  quick_tune  Quick retune parameters
+ * @param       dev     Device handle
+ * @param[in]   ch      Channel
+ * @param[out]  status  Queue state
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the FPGA version is too
+ *         old, value from \ref RETCODES list on other failures
  */
 API_EXPORT
-int CALL_CONV bladerf_get_quick_tune(struct bladerf *dev,
-                                     bladerf_channel ch,
-                                     struct bladerf_quick_tune *quick_tune);
+int CALL_CONV bladerf_get_retune_queue_status(
+    struct bladerf *dev,
+    bladerf_channel ch,
+    struct bladerf_retune_queue_status *status);
 
 /**
- * @brief Prints the quick retune parameters for a bladeRF device.
+ * Cancel the pending scheduled retunes for the specified channel that are due
+ * within a range of timestamps.
  *
- * Outputs the current quick retune parameters of a bladeRF device
- * to standard output. It is useful for debugging and verifying the
- * configuration of quick tune settings.
- *
- * @note supported devices: bladeRF1, bladeRF2
+ * The remaining retunes are left scheduled. A retune that the FPGA has
+ * already begun performing is not canceled. The FPGA versions required are
+ * as for bladerf_get_retune_queue_status().
  *
- * @param[in]   dev         Device handle. Must not be NULL.
- * @param[in]   qt          Pointer to the `bladerf_quick_tune` structure containing
- *                          the quick retune parameters. Must not be NULL.
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   start       First timestamp of the range
+ * @param[in]   end         Last timestamp of the range, inclusive
+ * @param[out]  canceled    Number of retunes canceled. May be NULL.
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the FPGA version is too
+ *         old, value from \ref RETCODES list on other failures
  */
 API_EXPORT
-int bladerf_print_quick_tune(struct bladerf *dev,
-                             const struct bladerf_quick_tune *qt);
-
-/** @} (End of FN_SCHEDULED_TUNING) */
+int CALL_CONV bladerf_cancel_scheduled_retunes_range(struct bladerf *dev,
+                                                     bladerf_channel ch,
+                                                     bladerf_timestamp start,
+                                                     bladerf_timestamp end,
+                                                     unsigned int *canceled);
 
 /**
- * @defgroup FN_CORR    Correction
+ * Peripherals that bladerf_schedule_write() may write
+ */
+typedef enum {
+    /** FPGA configuration GPIO, as written by bladerf_config_gpio_write() */
+    BLADERF_TIMED_WRITE_CONFIG_GPIO,
+
+    /** Expansion GPIO outputs, as written by bladerf_expansion_gpio_write().
+     *  XB-200 filter bank and signal path selections are made through
+     *  these. */
+    BLADERF_TIMED_WRITE_EXPANSION_GPIO,
+
+    /** Expansion GPIO direction, as written by
+     *  bladerf_expansion_gpio_dir_write() */
+    BLADERF_TIMED_WRITE_EXPANSION_GPIO_DIR,
+
+    /** VCTCXO trim DAC, as written by bladerf_trim_dac_write() */
+    BLADERF_TIMED_WRITE_TRIM_DAC,
+
+    /** RF front end control register, which holds the RFIC enable, TXNRX
+     *  and RF switch controls (bladeRF 2.0 Micro only) */
+    BLADERF_TIMED_WRITE_RFFE_CONTROL,
+} bladerf_timed_write_target;
+
+/**
+ * Schedule a write to a peripheral register to occur at the specified
+ * timestamp, on the specified channel's timestamp counter.
+ *
+ * The FPGA performs the write when the counter reaches the timestamp, so that
+ * external switching, amplifier enables and filter changes may be aligned
+ * with the samples without a round trip to the host.
+ *
+ * Scheduled writes share the channel's queue of scheduled retunes (and gain
+ * changes, where supported). They are performed in timestamp order alongside
+ * retunes, count toward the queue's capacity, and are canceled by
+ * bladerf_cancel_scheduled_retunes() and
+ * bladerf_cancel_scheduled_retunes_range().
+ *
+ * The whole register is replaced by `value`. When only some of its bits
+ * should change, combine them with the value the register will hold at the
+ * scheduled time.
+ *
+ * FPGA v0.16.2 on the bladeRF x40 and x115, and FPGA v0.17.4 on the bladeRF
+ * 2.0 Micro, are required.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel whose timestamp counter and queue to use
+ * @param[in]   timestamp   Channel's sample timestamp at which to write, or
+ *                          ::BLADERF_RETUNE_NOW to write immediately
+ * @param[in]   target      Peripheral register to write
+ * @param[in]   value       Value to write. Only the low 16 bits are used for
+ *                          ::BLADERF_TIMED_WRITE_TRIM_DAC.
+ *
+ * @return 0 on success, ::BLADERF_ERR_QUEUE_FULL if the queue is full,
+ *         ::BLADERF_ERR_UNSUPPORTED if the FPGA version is too old or the
+ *         target is not present on this device, value from \ref RETCODES
+ *         list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_schedule_write(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     bladerf_timestamp timestamp,
+                                     bladerf_timed_write_target target,
+                                     uint32_t value);
+
+/**
+ * Fetch parameters used to tune the transceiver to the current frequency for
+ * use with bladerf_schedule_retune() to perform a "quick retune."
+ *
+ * This allows for a faster retune, with a potential trade off of increased
+ * phase noise.
+ *
+ * @note These parameters are sensitive to changes in the operating environment,
+ *       and should be "refreshed" if planning to use the "quick retune"
+ *       functionality over a long period of time.
+ *
+ * @pre bladerf_set_frequency() or bladerf_schedule_retune() have previously
+ *      been used to retune to the desired frequency.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[out]  quick_tune  Quick retune parameters
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_quick_tune(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     struct bladerf_quick_tune *quick_tune);
+
+/**
+ * @brief Prints the quick retune parameters for a bladeRF device.
+ *
+ * Outputs the current quick retune parameters of a bladeRF device
+ * to standard output. It is useful for debugging and verifying the
+ * configuration of quick tune settings.
+ *
+ * @note supported devices: bladeRF1, bladeRF2
+ *
+ * @param[in]   dev         Device handle. Must not be NULL.
+ * @param[in]   qt          Pointer to the `bladerf_quick_tune` structure containing
+ *                          the quick retune parameters. Must not be NULL.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int bladerf_print_quick_tune(struct bladerf *dev,
+                             const struct bladerf_quick_tune *qt);
+
+/**
+ * Maximum number of entries in a channel's quick tune cache
+ */
+#define BLADERF_QUICK_TUNE_CACHE_MAX 64
+
+/**
+ * Enable, resize, or disable a channel's quick tune cache
+ *
+ * With the cache enabled, bladerf_set_frequency() records the quick tune
+ * parameters of each frequency it tunes the channel to, as if by
+ * bladerf_get_quick_tune(). Subsequent bladerf_set_frequency() calls for a
+ * recorded frequency perform an immediate bladerf_schedule_retune() with
+ * those parameters instead of the full tuning procedure. Once `capacity`
+ * frequencies have been recorded, the least recently used one is replaced.
+ *
+ * The cache is emptied when the reference clock or expansion board RF path
+ * is changed through libbladeRF, when the FPGA is loaded, and on the
+ * bladeRF 2.0 micro, when the RFIC temperature drifts by more than 10 C.
+ * Use bladerf_invalidate_quick_tune_cache() after other changes to the
+ * operating environment.
+ *
+ * @note On the bladeRF 2.0 micro, each cache entry holds one of the quick
+ *       tune profiles noted in bladerf_load_hop_table(). These are kept by the
+ *       cache for the life of the device handle, and reused for its entries.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   capacity    Number of frequencies to cache, up to
+ *                          ::BLADERF_QUICK_TUNE_CACHE_MAX. 0 disables the
+ *                          cache, which is the default.
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the FPGA does not
+ *         support scheduled retunes, value from \ref RETCODES list on other
+ *         failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_quick_tune_cache(struct bladerf *dev,
+                                           bladerf_channel ch,
+                                           unsigned int capacity);
+
+/**
+ * Empty the quick tune caches of all channels
+ *
+ * Frequencies are recorded again as they are next tuned.
+ *
+ * @param       dev         Device handle
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_invalidate_quick_tune_cache(struct bladerf *dev);
+
+/**
+ * Build a frequency hop table for a channel
+ *
+ * The channel is tuned to each frequency in turn, and the quick tune
+ * parameters for it are retrieved via bladerf_get_quick_tune(). On the
+ * bladeRF 2.0 micro, this stores a fast lock profile for each entry in the
+ * FPGA, so that hopping only requires the device to be sent a profile
+ * number. The channel is returned to its original frequency afterwards.
+ *
+ * Any hop table previously loaded for the channel is freed, as if by
+ * bladerf_free_hop_table().
+ *
+ * @note This retunes the channel, and should not be done while it is in use.
+ *       As with bladerf_get_quick_tune(), the entries should be rebuilt if
+ *       the operating environment changes significantly.
+ *
+ * @note The bladeRF 2.0 micro supports a limited number of quick tune
+ *       profiles per direction over the life of a device handle.
+ *
+ * @param       dev             Device handle
+ * @param[in]   ch              Channel
+ * @param[in]   frequencies     Table entries, in Hz
+ * @param[in]   num_frequencies Number of table entries
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_load_hop_table(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     const bladerf_frequency *frequencies,
+                                     unsigned int num_frequencies);
+
+/**
+ * Stop hopping and free a channel's hop table
+ *
+ * Pending scheduled retunes on the channel are cancelled. This is done
+ * automatically during bladerf_close().
+ *
+ * @param       dev     Device handle
+ * @param[in]   ch      Channel
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_free_hop_table(struct bladerf *dev,
+                                     bladerf_channel ch);
+
+/**
+ * Start executing a hop schedule from a channel's hop table
+ *
+ * A background thread schedules a retune (see bladerf_schedule_retune()) for
+ * each index queued via bladerf_enqueue_hops(), in order, keeping the
+ * device's retune queue full. The first hop occurs at `start`, and each
+ * subsequent hop `dwell` ticks after the previous one.
+ *
+ * If the schedule runs dry, the next hop is still scheduled `dwell` ticks
+ * after the last one. Should the schedule fall behind the device's
+ * timestamp, as when indices are queued too late, it is restarted a few
+ * milliseconds ahead of the device's timestamp rather than issuing the late
+ * hops at once. A warning reports the number of dwell periods skipped.
+ *
+ * @pre A hop table has been loaded with bladerf_load_hop_table(), and
+ *      timestamps have been enabled, as required by
+ *      bladerf_schedule_retune().
+ *
+ * @param       dev     Device handle
+ * @param[in]   ch      Channel
+ * @param[in]   start   Timestamp of the first hop
+ * @param[in]   dwell   Ticks between hops
+ *
+ * @return 0 on success, ::BLADERF_ERR_NOT_INIT if no table is loaded,
+ *         ::BLADERF_ERR_INVAL if hopping has already been started, value from
+ *         \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_start_hopping(struct bladerf *dev,
+                                    bladerf_channel ch,
+                                    bladerf_timestamp start,
+                                    uint64_t dwell);
+
+/**
+ * Append hop table indices to a channel's hop schedule
+ *
+ * Indices may be queued before or after hopping is started. The host-side
+ * schedule holds 1024 entries; use bladerf_get_hop_status() to determine how
+ * many remain to be topped up.
+ *
+ * @param       dev     Device handle
+ * @param[in]   ch      Channel
+ * @param[in]   indices Indices into the array provided to
+ *                      bladerf_load_hop_table()
+ * @param[in]   count   Number of indices. Either all or none are queued.
+ *
+ * @return 0 on success, ::BLADERF_ERR_QUEUE_FULL if there is insufficient
+ *         space, ::BLADERF_ERR_NOT_INIT if no table is loaded, value from
+ *         \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_enqueue_hops(struct bladerf *dev,
+                                   bladerf_channel ch,
+                                   const unsigned int *indices,
+                                   unsigned int count);
+
+/**
+ * Query a channel's hop schedule
+ *
+ * @param       dev     Device handle
+ * @param[in]   ch      Channel
+ * @param[out]  pending Number of queued indices not yet handed to the device.
+ *                      May be NULL.
+ * @param[out]  next    Timestamp of the next hop to be handed to the device.
+ *                      May be NULL.
+ *
+ * @return 0 on success, ::BLADERF_ERR_NOT_INIT if no table is loaded, or the
+ *         error that caused hopping to stop
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_hop_status(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     unsigned int *pending,
+                                     bladerf_timestamp *next);
+
+/** @} (End of FN_SCHEDULED_TUNING) */
+
+/**
+ * @defgroup FN_CORR    Correction
  *
  * This group provides routines for applying manual offset, gain, and phase
  * corrections.
@@ -2050,6 +2864,100 @@ int CALL_CONV bladerf_get_correction(struct bladerf *dev,
                                      bladerf_correction corr,
                                      bladerf_correction_value *value);
 
+/**
+ * Corrections associated with a frequency, for
+ * bladerf_load_host_correction_table()
+ */
+struct bladerf_correction_entry {
+    bladerf_frequency frequency;      /**< Frequency (Hz) */
+    bladerf_correction_value dcoff_i; /**< ::BLADERF_CORR_DCOFF_I value */
+    bladerf_correction_value dcoff_q; /**< ::BLADERF_CORR_DCOFF_Q value */
+    bladerf_correction_value phase;   /**< ::BLADERF_CORR_PHASE value */
+    bladerf_correction_value gain;    /**< ::BLADERF_CORR_GAIN value */
+};
+
+/**
+ * Enable or disable host-side correction of an RX channel
+ *
+ * This applies the DC offset, IQ gain and phase corrections on the host, for
+ * FPGA images without correction blocks, or corrections that vary with
+ * frequency. While enabled, bladerf_set_correction() and
+ * bladerf_get_correction() operate on the host-side corrections of the
+ * channel, rather than those of the device, which are left as they are.
+ *
+ * The corrections use the same values as the device's, and follow the math
+ * of the FPGA's correction block: the DC offset is subtracted from the
+ * sample, in SC16 Q11 units; I is then scaled by `1 + gain / 4096`; and each
+ * of I and Q is offset by the other, scaled by the tangent of the phase
+ * correction. Results are saturated to 16 bits.
+ *
+ * Corrections are applied by bladerf_sync_rx() and bladerf_sync_rx_multi()
+ * as they copy samples out of the stream buffers, with SIMD instructions
+ * where available, to the formats carried over USB as SC16 Q11 (including
+ * ::BLADERF_FORMAT_CF32). Changes take effect from the next call, for all of
+ * its samples. Samples acquired via bladerf_sync_rx_acquire() or the
+ * \ref FN_STREAMING_ASYNC interface are not corrected.
+ *
+ * Enabling correction starts from zero-valued (identity) corrections.
+ * Disabling it discards the corrections and any loaded table.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          RX channel
+ * @param[in]   enable      Enable host-side correction
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED for a TX channel, value
+ *         from \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_enable_host_correction(struct bladerf *dev,
+                                             bladerf_channel ch,
+                                             bool enable);
+
+/**
+ * Check whether host-side correction of a channel is enabled
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[out]  enabled     Whether host-side correction is enabled
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_host_correction(struct bladerf *dev,
+                                          bladerf_channel ch,
+                                          bool *enabled);
+
+/**
+ * Load a table of per-frequency host-side corrections for an RX channel
+ *
+ * The corrections for the channel's current frequency are applied
+ * immediately, and again each time the channel is retuned via
+ * bladerf_set_frequency() or bladerf_set_frequency_async(). Corrections
+ * between entries are linearly interpolated, and those outside of the table
+ * take the values of the nearest entry. The update is atomic with respect to
+ * bladerf_sync_rx(), which applies either the previous or the new
+ * corrections to all of a call's samples.
+ *
+ * The values set via bladerf_set_correction() are replaced on each retune.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          RX channel
+ * @param[in]   entries     Entries, in increasing order of frequency. These
+ *                          are copied.
+ * @param[in]   num_entries Number of entries. 0 removes the table, leaving
+ *                          the current corrections in place.
+ *
+ * @return 0 on success, ::BLADERF_ERR_NOT_INIT if host-side correction is not
+ *         enabled, ::BLADERF_ERR_INVAL for unsorted entries or out-of-range
+ *         values, value from \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_load_host_correction_table(
+    struct bladerf *dev,
+    bladerf_channel ch,
+    const struct bladerf_correction_entry *entries,
+    unsigned int num_entries);
+
 /** @} (End of FN_CORR) */
 
 /** @} (End of FN_CHANNEL) */
@@ -2217,6 +3125,10 @@ typedef enum {
      * USB 2.0 Hi-Speed or USB 3.0 SuperSpeed for packets for this streaming
      * format.
      *
+     * bladerf_sync_rx_packets() and bladerf_sync_tx_packets() transfer
+     * multiple packets per call, each with its own core ID, flags, and
+     * timestamp.
+     *
      * @see STREAMING_FORMAT_METADATA
      * @see The `src/streaming/metadata.h` header in the libbladeRF codebase.
      */
@@ -2318,6 +3230,138 @@ typedef enum {
      * @see The `src/streaming/metadata.h` header in the libbladeRF codebase.
      */
     BLADERF_FORMAT_SC8_Q7_META,
+
+    /**
+     * Complex 32-bit floating point samples, with interleaved IQ value pairs
+     * (I first) of type `float`. Values are in the range [-1.0, 1.0), with
+     * 1.0 corresponding to the full-scale SC16 Q11 value of 2048.
+     *
+     * This format is only available via the \ref FN_STREAMING_SYNC
+     * interface. Samples are carried over USB in the ::BLADERF_FORMAT_SC16_Q11
+     * format, and are converted by bladerf_sync_rx() and bladerf_sync_tx()
+     * as they are copied from/to the underlying stream buffers. On TX, values
+     * outside of the above range are saturated.
+     *
+     * Multi-channel layouts are interleaved per channel, as described for
+     * ::BLADERF_FORMAT_SC16_Q11, with each sample occupying 8 bytes.
+     *
+     * The `num_samples` and `buffer_size` arguments of the synchronous
+     * interface are specified in samples, and are therefore unaffected by
+     * the larger sample size.
+     *
+     * bladerf_sync_rx_acquire() and bladerf_sync_tx_acquire() are not
+     * supported with this format.
+     */
+    BLADERF_FORMAT_CF32,
+
+    /**
+     * This format is the same as the ::BLADERF_FORMAT_CF32 format, except
+     * that metadata is conveyed through the ::bladerf_metadata structure, as
+     * with ::BLADERF_FORMAT_SC16_Q11_META, in which it is carried over USB.
+     */
+    BLADERF_FORMAT_CF32_META,
+
+    /**
+     * Signed, Complex 12-bit samples, packed into 3 bytes per IQ pair with
+     * no padding. This carries the same values as ::BLADERF_FORMAT_SC16_Q11
+     * with 25% less data over USB.
+     *
+     * Each sample is a 24-bit little-endian value with I in bits 11:0 and Q
+     * in bits 23:12:
+     *
+     * <pre>
+     *  .-------------.----------------------------------.
+     *  | Byte offset | Contents                         |
+     *  +-------------+----------------------------------+
+     *  |    0x00     | I[7:0]                           |
+     *  |    0x01     | Q[3:0] (bits 7:4), I[11:8] (3:0) |
+     *  |    0x02     | Q[11:4]                          |
+     *  `-------------`----------------------------------`
+     * </pre>
+     *
+     * Multi-channel layouts are interleaved per sample, as described for
+     * ::BLADERF_FORMAT_SC16_Q11.
+     *
+     * The \ref FN_STREAMING_SYNC interface packs and unpacks these samples
+     * as they are copied from/to the underlying stream buffers, so callers of
+     * bladerf_sync_rx() and bladerf_sync_tx() provide samples in the
+     * ::BLADERF_FORMAT_SC16_Q11 layout, 4 bytes per sample. On TX, values must
+     * stay within [-2048, 2047]. The \ref FN_STREAMING_ASYNC interface
+     * provides the packed samples, and its buffer sizes remain in samples.
+     * Sync buffer sizes must be a multiple of 4096 samples.
+     *
+     * bladerf_sync_rx_acquire(), bladerf_sync_tx_acquire() and the
+     * interleaving helpers are not supported with this format.
+     *
+     * This format is currently only available on the bladeRF 2.0 Micro.
+     */
+    BLADERF_FORMAT_SC12_PACKED,
+
+    /**
+     * This format is the same as the ::BLADERF_FORMAT_SC12_PACKED format,
+     * except that every <i>block</i> of samples starts with the metadata
+     * header of ::BLADERF_FORMAT_SC16_Q11_META.
+     *
+     * Blocks are the same size in bytes as with ::BLADERF_FORMAT_SC16_Q11_META
+     * (2048 bytes on USB 3.0 SuperSpeed and 1024 bytes on USB 2.0 Hi-Speed).
+     * The payload holds a whole number of groups of 8 samples, so a block
+     * carries 672 samples followed by 16 bytes of padding on SuperSpeed, and
+     * 336 samples without padding on Hi-Speed. The padding is ignored on TX
+     * and zero on RX.
+     *
+     * As with the other metadata formats, bladerf_sync_rx() and
+     * bladerf_sync_tx() handle these details and convey the metadata through
+     * the ::bladerf_metadata structure. When using the \ref FN_STREAMING_ASYNC
+     * interface, buffer sizes must be a multiple of 2048 samples.
+     */
+    BLADERF_FORMAT_SC12_PACKED_META,
+
+    /**
+     * Samples carried over USB in the ::BLADERF_FORMAT_SC8_Q7 format, and
+     * exchanged with the caller in the ::BLADERF_FORMAT_SC16_Q11 layout, 4
+     * bytes per sample. Values are scaled by 16, so that the SC8 Q7 range
+     * [-128, 127] maps to [-2048, 2032].
+     *
+     * This format is only available via the \ref FN_STREAMING_SYNC
+     * interface, which converts samples as they are copied from/to the
+     * underlying stream buffers. On TX, values are rounded to the nearest
+     * SC8 Q7 value and saturated.
+     *
+     * This allows code written for SC16 Q11 samples to use the halved USB
+     * bandwidth of 8-bit samples, as required by ::BLADERF_FEATURE_OVERSAMPLE.
+     * Channel layouts and buffer sizes are as described for
+     * ::BLADERF_FORMAT_SC16_Q11. bladerf_sync_rx_acquire() and
+     * bladerf_sync_tx_acquire() are not supported with this format.
+     */
+    BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11,
+
+    /**
+     * This format is the same as the ::BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11
+     * format, except that metadata is conveyed through the ::bladerf_metadata
+     * structure, as with ::BLADERF_FORMAT_SC8_Q7_META, in which it is carried
+     * over USB.
+     */
+    BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META,
+
+    /**
+     * Samples carried over USB in the ::BLADERF_FORMAT_SC8_Q7 format, and
+     * exchanged with the caller as ::BLADERF_FORMAT_CF32 samples. Values are
+     * in the range [-1.0, 1.0), with 1.0 corresponding to the full-scale SC8
+     * Q7 value of 128. On TX, values outside of this range are saturated.
+     *
+     * Otherwise, this format is the same as the
+     * ::BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11 format, with each sample occupying
+     * 8 bytes.
+     */
+    BLADERF_FORMAT_SC8_Q7_AS_CF32,
+
+    /**
+     * This format is the same as the ::BLADERF_FORMAT_SC8_Q7_AS_CF32 format,
+     * except that metadata is conveyed through the ::bladerf_metadata
+     * structure, as with ::BLADERF_FORMAT_SC8_Q7_META, in which it is carried
+     * over USB.
+     */
+    BLADERF_FORMAT_SC8_Q7_AS_CF32_META,
 } bladerf_format;
 
 /**
@@ -2338,6 +3382,11 @@ typedef enum {
  *
  * This indicates that either the host (more likely) or the FPGA is not keeping
  * up with the incoming samples.
+ *
+ * This is also reported by bladerf_sync_rx() for the non-metadata formats,
+ * if a bladerf_metadata structure is provided, when the returned samples
+ * follow samples the host had to drop. In this case, the location of the
+ * discontinuity is not reported, and `actual_count` is not affected.
  */
 #define BLADERF_META_STATUS_OVERRUN (1 << 0)
 
@@ -2351,6 +3400,36 @@ typedef enum {
  */
 #define BLADERF_META_STATUS_UNDERRUN (1 << 1)
 
+/**
+ * The sample rate was changed by bladerf_set_sample_rate_live() ahead of
+ * these samples.
+ *
+ * This is reported for the first samples received at the new rate. Samples
+ * received while the rate was being changed are discarded, so for the
+ * metadata formats, the timestamp of these samples does not follow on from
+ * that of the samples before them.
+ */
+#define BLADERF_META_STATUS_RATE_CHANGE (1 << 2)
+
+/**
+ * The stream was recovered from a USB failure (see
+ * bladerf_enable_stream_recovery()) during this call.
+ *
+ * Samples were lost while the device was reconnected. For the RX metadata
+ * formats, the timestamp shows how many.
+ */
+#define BLADERF_META_STATUS_RECOVERED (1 << 3)
+
+/**
+ * The synchronous RX interface's AGC (see bladerf_set_sync_rx_agc()) changed
+ * a channel's gain within, or just ahead of, these samples.
+ *
+ * With the RX metadata formats, this is reported by the call whose samples
+ * span the timestamp at which the change was scheduled. Otherwise, the gain
+ * is changed between calls, and this is reported by the following call.
+ */
+#define BLADERF_META_STATUS_GAIN_CHANGE (1 << 4)
+
 /*
  * Metadata flags
  *
@@ -2397,6 +3476,17 @@ typedef enum {
  * much time, consider using the ::BLADERF_META_FLAG_TX_UPDATE_TIMESTAMP
  * flag.
  *
+ * With FX3 firmware v2.4.0 or later, the working buffer is not flushed in its
+ * entirety. Only the messages holding the end of the burst are submitted,
+ * padded with zeros to a 4 KiB boundary, so short bursts incur
+ * correspondingly less USB transfer time and latency.
+ *
+ * With ::BLADERF_CAP_FPGA_TX_IDLE_ZERO, the FPGA returns the DAC to
+ * \f$0 + 0 j\f$ by itself shortly after the last sample of a burst. A burst
+ * that ends on a message boundary is then no longer followed by a further
+ * message of zeros, and the gaps left by ::BLADERF_META_FLAG_TX_UPDATE_TIMESTAMP
+ * need not be padded beyond the current message.
+ *
  * @note This is only used for the bladerf_sync_tx() call. It is ignored by the
  *       bladerf_sync_rx() call.
  */
@@ -2509,11 +3599,28 @@ struct bladerf_metadata {
      */
     unsigned int actual_count;
 
+    /**
+     * This output parameter is updated by bladerf_sync_rx() and
+     * bladerf_sync_rx_acquire() to reflect the host time, per
+     * bladerf_get_host_time_ns(), at which the USB transfer carrying the
+     * first returned sample completed. It is 0 if no samples were returned.
+     *
+     * Comparing this against the time the call returns, or against the
+     * #timestamp field via bladerf_timestamp_to_host_ns(), measures the
+     * latency through the USB and host layers.
+     *
+     * @note This parameter is not used by bladerf_sync_tx().
+     */
+    uint64_t host_timestamp;
+
     /**
      * Reserved for future use. This is not used by any functions. It is
      * recommended that users zero out this field.
+     *
+     * This field was shortened from 32 bytes when #host_timestamp was added,
+     * such that the size of the structure is unchanged.
      */
-    uint8_t reserved[32];
+    uint8_t reserved[24];
 };
 
 /** @} (End of STREAMING_FORMAT_METADATA) */
@@ -2596,20 +3703,86 @@ int CALL_CONV bladerf_deinterleave_stream_buffer(bladerf_channel_layout layout,
                                                  unsigned int buffer_size,
                                                  void *samples);
 
-/** @} (End of STREAMING_FORMAT) */
-
 /**
- * Enable or disable the RF front end of the specified direction.
+ * Deinterleaves samples directly into per-channel arrays after MIMO RX.
  *
- * RF front ends must always be enabled prior to streaming samples on the
- * associated interface.
+ * This is an out-of-place variant of bladerf_deinterleave_stream_buffer().
+ * Rather than rearranging `samples` in place, the samples for channel `n` are
+ * written directly to `dest[n]`. This avoids the copy-back that the in-place
+ * variant requires, and leaves the input buffer unmodified.
  *
- * When a synchronous stream is associated with the specified channel, this will
- * shut down the underlying asynchronous stream when `enable` = false.
+ * If the ::BLADERF_FORMAT_SC16_Q11_META or ::BLADERF_FORMAT_SC8_Q7_META
+ * format is specified, the first 16 bytes are skipped and are not copied to
+ * any of the destination arrays.
  *
- * When transmitting samples, be sure to provide ample time for TX samples reach
- * the RF front-end before calling this function with `enable` = false. (This
- * can be achieved easily when using metadata, as shown on
+ * @param[in]   layout          Stream direction and layout
+ * @param[in]   format          Data format to use
+ * @param[in]   buffer_size     The size of the input buffer, in samples. Note
+ *                              that this is the entire buffer, not just a
+ *                              single channel.
+ * @param[in]   samples         Interleaved buffer to process
+ * @param[out]  dest            Array of one destination pointer per channel in
+ *                              `layout`. Each destination must have room for
+ *                              `buffer_size` / num_channels samples, and must
+ *                              not overlap `samples`.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV
+    bladerf_deinterleave_stream_buffer_to(bladerf_channel_layout layout,
+                                          bladerf_format format,
+                                          unsigned int buffer_size,
+                                          const void *samples,
+                                          void *const *dest);
+
+/**
+ * Convert a buffer of samples from one sample format to another, using the
+ * same (SIMD, where available) conversions as the sync interface's
+ * host-side formats.
+ *
+ * This is intended for processing recorded samples offline. The following
+ * formats are supported, without metadata:
+ *
+ *  - ::BLADERF_FORMAT_SC16_Q11, to or from any of the formats below
+ *  - ::BLADERF_FORMAT_SC8_Q7, to or from ::BLADERF_FORMAT_CF32
+ *  - ::BLADERF_FORMAT_SC12_PACKED, to or from ::BLADERF_FORMAT_SC16_Q11 only
+ *
+ * Converting a format to itself copies the samples. Conversions to integer
+ * formats round and saturate, as described by those formats.
+ *
+ * @param[in]   in_format       Format of `in`
+ * @param[in]   in              Input samples
+ * @param[in]   out_format      Format of `out`
+ * @param[out]  out             Output samples. Must not overlap `in`.
+ * @param[in]   num_samples     Number of samples (I/Q pairs) to convert,
+ *                              counting each channel's samples of a
+ *                              multi-channel buffer
+ *
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the conversion is not
+ *         supported, or ::BLADERF_ERR_INVAL if a buffer is NULL
+ */
+API_EXPORT
+int CALL_CONV bladerf_convert_samples(bladerf_format in_format,
+                                      const void *in,
+                                      bladerf_format out_format,
+                                      void *out,
+                                      size_t num_samples);
+
+/** @} (End of STREAMING_FORMAT) */
+
+/**
+ * Enable or disable the RF front end of the specified direction.
+ *
+ * RF front ends must always be enabled prior to streaming samples on the
+ * associated interface.
+ *
+ * When a synchronous stream is associated with the specified channel, this will
+ * shut down the underlying asynchronous stream when `enable` = false.
+ *
+ * When transmitting samples, be sure to provide ample time for TX samples reach
+ * the RF front-end before calling this function with `enable` = false. (This
+ * can be achieved easily when using metadata, as shown on
  * \link sync_tx_meta_bursts.html this page\endlink.)
  *
  * @param       dev     Device handle
@@ -2669,6 +3842,90 @@ int CALL_CONV bladerf_get_timestamp(struct bladerf *dev,
                                     bladerf_direction dir,
                                     bladerf_timestamp *timestamp);
 
+/**
+ * Start or stop a background service that correlates the specified
+ * direction's timestamp counter with the host's monotonic clock.
+ *
+ * The service reads the timestamp every `interval_ms` milliseconds, noting
+ * the host clock before and after each read, and fits the counter's offset
+ * and rate relative to the host clock over a sliding window of these
+ * samples. Samples delayed by contention for the device are discarded, and
+ * the fit restarts if the counter is reset or its rate changes.
+ *
+ * Once fitted, bladerf_timestamp_to_host_ns() and
+ * bladerf_host_ns_to_timestamp() convert between the two clocks without
+ * communicating with the device. For example, a TX burst may be scheduled
+ * 10 ms from now via:
+ *
+ * @code{.c}
+ *  bladerf_host_ns_to_timestamp(dev, BLADERF_TX,
+ *                               bladerf_get_host_time_ns() + 10000000,
+ *                               &meta.timestamp);
+ * @endcode
+ *
+ * The model's accuracy is bounded by the USB round-trip time of each
+ * timestamp read, typically tens to hundreds of microseconds.
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Timestamp to correlate
+ * @param[in]   interval_ms Sampling interval, in milliseconds. 0 stops the
+ *                          service.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_timestamp_correlation(struct bladerf *dev,
+                                                bladerf_direction dir,
+                                                unsigned int interval_ms);
+
+/**
+ * Convert a timestamp to the host clock used by bladerf_get_host_time_ns(),
+ * per the model fitted by the bladerf_set_timestamp_correlation() service.
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Stream direction
+ * @param[in]   timestamp   Timestamp to convert
+ * @param[out]  host_ns     Corresponding host time, in nanoseconds
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_NOT_INIT if the service is not running,
+ *         ::BLADERF_ERR_WOULD_BLOCK if it has not yet collected enough
+ *         samples (at least two) to fit a model,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_timestamp_to_host_ns(struct bladerf *dev,
+                                           bladerf_direction dir,
+                                           bladerf_timestamp timestamp,
+                                           uint64_t *host_ns);
+
+/**
+ * Convert a host clock time to a timestamp. This is the inverse of
+ * bladerf_timestamp_to_host_ns().
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Stream direction
+ * @param[in]   host_ns     Host time, in nanoseconds
+ * @param[out]  timestamp   Corresponding timestamp
+ *
+ * @return 0 on success, or as with bladerf_timestamp_to_host_ns()
+ */
+API_EXPORT
+int CALL_CONV bladerf_host_ns_to_timestamp(struct bladerf *dev,
+                                           bladerf_direction dir,
+                                           uint64_t host_ns,
+                                           bladerf_timestamp *timestamp);
+
+/**
+ * Read the host clock used for timestamp correlation. This is
+ * CLOCK_MONOTONIC_RAW on Linux and CLOCK_MONOTONIC, where available,
+ * elsewhere.
+ *
+ * @return Current host time, in nanoseconds
+ */
+API_EXPORT
+uint64_t CALL_CONV bladerf_get_host_time_ns(void);
+
 /**
  * @defgroup FN_STREAMING_SYNC  Synchronous API
  *
@@ -2724,12 +3981,22 @@ int CALL_CONV bladerf_get_timestamp(struct bladerf *dev,
  *                              data stream. This must be greater than the
  *                              `num_xfers` parameter.
  * @param[in]   buffer_size     The size of the underlying stream buffers, in
- *                              samples. This value must be a multiple of 1024.
+ *                              samples. This value must be a multiple of 1024,
+ *                              or, for ::BLADERF_FORMAT_SC16_Q11 and
+ *                              ::BLADERF_FORMAT_SC8_Q7, of one 1 KiB USB
+ *                              packet (256 or 512 samples, respectively).
  *                              Note that samples are only transferred when a
  *                              buffer of this size is filled.
  * @param[in]   num_transfers   The number of active USB transfers that may be
  *                              in-flight at any given time. If unsure of what
  *                              to use here, try values of 4, 8, or 16.
+ *
+ * Any of `num_buffers`, `buffer_size`, and `num_transfers` may be set to 0 to
+ * have libbladeRF select a value based upon the currently configured sample
+ * rate and the USB bus speed. Therefore, the sample rate should be configured
+ * prior to calling this function. Specified values are taken into account
+ * when selecting the others. The selected values, along with the measured
+ * transfer latency, may be retrieved via bladerf_get_stream_stats().
  * @param[in]   stream_timeout  Timeout (milliseconds) for transfers in the
  *                              underlying data stream.
  *
@@ -2747,6 +4014,80 @@ int CALL_CONV bladerf_sync_config(struct bladerf *dev,
                                   unsigned int num_transfers,
                                   unsigned int stream_timeout);
 
+/**
+ * @defgroup BLADERF_LINK_ADAPT USB 2.0 link adaptation flags
+ *
+ * Narrower formats that bladerf_sync_config() may fall back to on a USB 2.0
+ * link. See bladerf_set_sync_link_adaptation().
+ *
+ * @{
+ */
+
+/** Allow 12-bit packed samples, for ::BLADERF_FORMAT_SC16_Q11 and
+ *  ::BLADERF_FORMAT_SC16_Q11_META. This requires a bladeRF 2.0 Micro with
+ *  FPGA v0.17.0 or later. */
+#define BLADERF_LINK_ADAPT_SC12 (1 << 0)
+
+/** Allow 8-bit samples, for the SC16 Q11 and CF32 formats. This requires a
+ *  bladeRF 2.0 Micro with FPGA v0.15.0 or later. */
+#define BLADERF_LINK_ADAPT_SC8 (1 << 1)
+
+/** @} */
+
+/**
+ * Allow the synchronous interface to fall back to a narrower format on a USB
+ * 2.0 link.
+ *
+ * A USB 2.0 (high speed) link sustains roughly a tenth of the throughput of a
+ * USB 3.0 one, and a stream configured for the latter overruns or underruns
+ * on it. With adaptation allowed, a bladerf_sync_config() call on such a link
+ * whose throughput, at the current sample rate, would exceed what the link
+ * sustains, carries the samples over USB in the widest allowed format that
+ * fits. If none fits, the narrowest allowed one is used.
+ *
+ * The caller's samples remain in the requested format, and are converted on
+ * the host, at the cost of precision. For example, ::BLADERF_FORMAT_SC16_Q11
+ * may be carried as ::BLADERF_FORMAT_SC12_PACKED, or as
+ * ::BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11. The format chosen is reported by
+ * bladerf_get_sync_format(), and the buffer and transfer counts by
+ * bladerf_get_stream_stats(). Passing 0 for any of those counts to
+ * bladerf_sync_config() also sizes them for the link speed.
+ *
+ * Fallback only considers the direction being configured, so the combined
+ * throughput of full-duplex streams may still exceed the link's.
+ *
+ * @param       dev         Device handle
+ * @param[in]   allowed     Bitmask of \ref BLADERF_LINK_ADAPT flags, or 0 to
+ *                          always use the requested format (the default)
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `allowed` contains unknown flags,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_sync_link_adaptation(struct bladerf *dev,
+                                               uint32_t allowed);
+
+/**
+ * Get the format that the synchronous interface was last configured with for
+ * the specified direction. This differs from the format passed to
+ * bladerf_sync_config() if it was adapted to a USB 2.0 link. See
+ * bladerf_set_sync_link_adaptation().
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Stream direction
+ * @param[out]  format      Configured format
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if bladerf_sync_config() has not succeeded for
+ *         the specified direction,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_sync_format(struct bladerf *dev,
+                                      bladerf_direction dir,
+                                      bladerf_format *format);
+
 /**
  * Transmit IQ samples.
  *
@@ -2827,767 +4168,4065 @@ int CALL_CONV bladerf_sync_rx(struct bladerf *dev,
                               struct bladerf_metadata *metadata,
                               unsigned int timeout_ms);
 
-
-/** @} (End of FN_STREAMING_SYNC) */
-
 /**
- * @defgroup FN_STREAMING_ASYNC    Asynchronous API
+ * Transmit IQ samples from one buffer per channel.
  *
- * This interface gives the API user full control over the stream and buffer
- * management, at the cost of added complexity.
+ * This behaves like bladerf_sync_tx(), except that the samples of each
+ * channel are provided in a separate, contiguous array. For multi-channel
+ * layouts (e.g., ::BLADERF_TX_X2), samples are interleaved as they are copied
+ * into the underlying stream buffers, so no separate call to
+ * bladerf_interleave_stream_buffer() is required.
  *
- * @note New users are recommended to first evaluate the \ref FN_STREAMING_SYNC
- *       interface, and to only use this interface if the former is found to not
- *       yield suitable performance.
+ * The ::BLADERF_FORMAT_PACKET_META format is not supported.
  *
- * These functions are either thread-safe or may be used in a thread-safe
- * manner (per the details noted in the function description).
+ * @pre A bladerf_sync_config() call has been to configure the device for
+ *      synchronous data transfer.
  *
- * @{
+ * @param       dev         Device handle
+ * @param[in]   bufs        Array with one sample buffer per channel in the
+ *                          configured layout, each containing `num_samples`
+ *                          samples
+ * @param[in]   num_samples Number of samples to write, per channel
+ * @param[in]   metadata    Sample metadata, as with bladerf_sync_tx()
+ * @param[in]   timeout_ms  Timeout (milliseconds) for this call to complete.
+ *                          Zero implies "infinite."
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if the configured format is not supported,
+ *         or a value from \ref RETCODES list on failures.
  */
+API_EXPORT
+int CALL_CONV bladerf_sync_tx_multi(struct bladerf *dev,
+                                    const void *const *bufs,
+                                    unsigned int num_samples,
+                                    struct bladerf_metadata *metadata,
+                                    unsigned int timeout_ms);
 
 /**
- * Use this as a return value in callbacks or as the buffer parameter to
- * bladerf_submit_stream_buffer() to shutdown a stream.
+ * Receive IQ samples into one buffer per channel.
+ *
+ * This behaves like bladerf_sync_rx(), except that the samples of each
+ * channel are written to a separate, contiguous array. For multi-channel
+ * layouts (e.g., ::BLADERF_RX_X2), samples are deinterleaved as they are
+ * copied out of the underlying stream buffers, so no separate call to
+ * bladerf_deinterleave_stream_buffer() is required. Metadata headers of the
+ * *_META formats are handled as with bladerf_sync_rx().
+ *
+ * The ::BLADERF_FORMAT_PACKET_META format is not supported.
+ *
+ * @pre A bladerf_sync_config() call has been to configure the device for
+ *      synchronous data transfer.
+ *
+ * @param       dev         Device handle
+ * @param[out]  bufs        Array with one sample buffer per channel in the
+ *                          configured layout, each large enough to hold
+ *                          `num_samples` samples
+ * @param[in]   num_samples Number of samples to read, per channel
+ * @param[out]  metadata    Sample metadata, as with bladerf_sync_rx(). The
+ *                          `actual_count` field is reported per channel.
+ * @param[in]   timeout_ms  Timeout (milliseconds) for this call to complete.
+ *                          Zero implies "infinite."
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if the configured format is not supported,
+ *         or a value from \ref RETCODES list on failures.
  */
-#define BLADERF_STREAM_SHUTDOWN (NULL)
+API_EXPORT
+int CALL_CONV bladerf_sync_rx_multi(struct bladerf *dev,
+                                    void *const *bufs,
+                                    unsigned int num_samples,
+                                    struct bladerf_metadata *metadata,
+                                    unsigned int timeout_ms);
 
 /**
- * Use this value in a stream callback to indicate that no buffer is being
- * provided. In this case, buffers are expected to be provided via
- * bladerf_submit_stream_buffer().
+ * Descriptor of a packet exchanged with an FPGA core in the
+ * ::BLADERF_FORMAT_PACKET_META format, via bladerf_sync_rx_packets() and
+ * bladerf_sync_tx_packets()
  */
-#define BLADERF_STREAM_NO_DATA ((void *)(-1))
+struct bladerf_packet {
+    /**
+     * Payload. For RX, this must hold at least `capacity` DWORDs.
+     */
+    void *data;
 
-/** This opaque structure is used to keep track of stream information */
-struct bladerf_stream;
+    /**
+     * RX only: size of `data`, in 32-bit DWORDs
+     */
+    unsigned int capacity;
+
+    /**
+     * Payload length, in 32-bit DWORDs. For RX, this is set to the length of
+     * the received packet. A packet longer than `capacity` is truncated,
+     * which is denoted by `len` exceeding `capacity`.
+     */
+    unsigned int len;
+
+    /**
+     * Core the packet is addressed to (TX) or was sent by (RX)
+     */
+    uint8_t core;
+
+    /**
+     * Core-specific packet flags
+     */
+    uint8_t flags;
+
+    /**
+     * Packet timestamp. For TX, 0 sends the packet as soon as possible.
+     */
+    bladerf_timestamp timestamp;
+
+    /**
+     * RX only: ::BLADERF_META_STATUS_OVERRUN if packets were dropped ahead
+     * of this one, 0 otherwise
+     */
+    unsigned int status;
+};
 
 /**
- * This typedef represents a callback function that is executed in response to
- * this interface's asynchronous events.
+ * Receive multiple packets in the ::BLADERF_FORMAT_PACKET_META format.
  *
- * Stream callbacks <b>must not</b> block or perform long-running operations.
- * Otherwise, timeouts may occur. If this cannot be guaranteed, consider
- * returning ::BLADERF_STREAM_NO_DATA in callbacks and later submit a buffer
- * using bladerf_submit_stream_buffer(). However, callbacks should always take
- * a single approach of returning buffers <b>or</b> returning
- * ::BLADERF_STREAM_NO_DATA and submitting buffers later -- <b>but not both</b>.
+ * This waits for the first packet only. It then returns it along with any
+ * others that have already arrived, up to `num_packets`, taking the stream's
+ * locks once rather than once per packet. This suits FPGA cores that
+ * exchange many small packets, where a bladerf_sync_rx() call per packet
+ * would dominate.
  *
- * When running in a full-duplex mode of operation with simultaneous TX and RX
- * stream threads, be aware that one stream's callback may occur in the context
- * of another stream's thread. The API user is responsible for ensuring their
- * callbacks are thread safe. For example, when managing access to sample
- * buffers, the caller must ensure that if one thread is processing samples in a
- * buffer, that this buffer is not returned via the callback's return value.
+ * Empty packets are skipped.
  *
- * As of libbladeRF v0.15.0, is guaranteed that only one callback from a stream
- * will occur at a time. (i.e., a second TX callback will not fire while one is
- * currently being handled.)  To achieve this, while a callback is executing, a
- * per-stream lock is held. It is important to consider this when thinking about
- * the order of lock acquisitions both in the callbacks, and the code
- * surrounding bladerf_submit_stream_buffer().
+ * @pre A bladerf_sync_config() call has been made to configure RX for the
+ *      ::BLADERF_FORMAT_PACKET_META format.
  *
- * @note Do not call bladerf_submit_stream_buffer() from a callback.
+ * @param       dev             Device handle
+ * @param[inout] packets        Packet descriptors, each with its `data` and
+ *                              `capacity` set. All other fields are filled
+ *                              in by this function.
+ * @param[in]   num_packets     Number of descriptors
+ * @param[out]  num_received    Number of packets received. This is only
+ *                              less than `num_packets` if no more had
+ *                              arrived, or if an error occurred.
+ * @param[in]   timeout_ms      Timeout (milliseconds) to wait for the first
+ *                              packet. Zero implies "infinite."
  *
- * For both RX and TX, the stream callback receives:
- *  - dev:          Device structure
- *  - stream:       The associated stream
- *  - metadata:     For future support - do not attempt to read/write this
- *                  in the current library implementation.
- *  - user_data:    User data provided when initializing stream
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if the stream is not configured for the
+ *         packet format,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_rx_packets(struct bladerf *dev,
+                                      struct bladerf_packet *packets,
+                                      unsigned int num_packets,
+                                      unsigned int *num_received,
+                                      unsigned int timeout_ms);
+
+/**
+ * Send multiple packets in the ::BLADERF_FORMAT_PACKET_META format.
  *
- * For TX callbacks:
- *  - samples:      Pointer to buffer of samples that was sent
- *  - num_samples:  Number of sent in last transfer and to send in next transfer
- *  - Return value: The user specifies the address of the next buffer to send,
- *                  ::BLADERF_STREAM_SHUTDOWN, or ::BLADERF_STREAM_NO_DATA.
+ * Each packet is formatted directly into a stream buffer, and buffers are
+ * filled and submitted back to back, taking the stream's locks once per
+ * wait for free buffers rather than once per packet. Unlike
+ * bladerf_sync_tx(), each packet is addressed to its descriptor's `core`,
+ * with its `flags` and `timestamp`.
  *
- * For RX callbacks:
- *  - samples:          Buffer filled with received data
- *  - num_samples:      Number of samples received and size of next buffers
- *  - Return value:     The user specifies the next buffer to fill with RX data,
- *                      which should be `num_samples` in size,
- *                      ::BLADERF_STREAM_SHUTDOWN, or ::BLADERF_STREAM_NO_DATA.
+ * Each packet still occupies a USB transfer of its own, as the FPGA accepts
+ * a single packet header per DMA transaction. A packet may be at most the
+ * stream buffer size, less 4 DWORDs for its header.
+ *
+ * All descriptors are validated before any packet is sent.
+ *
+ * @pre A bladerf_sync_config() call has been made to configure TX for the
+ *      ::BLADERF_FORMAT_PACKET_META format.
+ *
+ * @param       dev             Device handle
+ * @param[in]   packets         Packet descriptors. `capacity` and `status`
+ *                              are unused.
+ * @param[in]   num_packets     Number of descriptors
+ * @param[out]  num_sent        Number of packets submitted, which is less
+ *                              than `num_packets` only on failure. May be
+ *                              NULL.
+ * @param[in]   timeout_ms      Timeout (milliseconds) to wait for each free
+ *                              buffer. Zero implies "infinite."
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if a packet is empty or too long,
+ *         ::BLADERF_ERR_UNSUPPORTED if the stream is not configured for the
+ *         packet format,
+ *         or a value from \ref RETCODES list on failures.
  */
-typedef void *(*bladerf_stream_cb)(struct bladerf *dev,
-                                   struct bladerf_stream *stream,
-                                   struct bladerf_metadata *meta,
-                                   void *samples,
-                                   size_t num_samples,
-                                   void *user_data);
+API_EXPORT
+int CALL_CONV bladerf_sync_tx_packets(struct bladerf *dev,
+                                      const struct bladerf_packet *packets,
+                                      unsigned int num_packets,
+                                      unsigned int *num_sent,
+                                      unsigned int timeout_ms);
 
 /**
- * Initialize a stream for use with asynchronous routines.
+ * Opaque handle to a TX template, created via
+ * bladerf_sync_create_tx_template().
+ */
+struct bladerf_tx_template;
+
+/**
+ * Create a TX template: a burst of samples that is pre-formatted into stream
+ * buffers, metadata headers included, so that it may be transmitted
+ * repeatedly via bladerf_sync_tx_template() without being copied or
+ * reformatted. This is intended for workloads that retransmit the same
+ * waveform, such as a pulse train.
  *
- * This function will internally allocate data buffers, which will be provided
- * to the API user in callback functions.
+ * The template is zero-padded to a whole number of stream buffers. As with
+ * bursts sent via bladerf_sync_tx(), the samples should end with at least
+ * three zero-valued samples (see ::BLADERF_META_FLAG_TX_BURST_END).
  *
- * The `buffers` output parameter populates a pointer to the list of allocated
- * buffers. This allows the API user to implement a buffer management scheme to
- * best suit his or her specific use case.
+ * Only the ::BLADERF_FORMAT_SC16_Q11_META, ::BLADERF_FORMAT_SC8_Q7_META,
+ * ::BLADERF_FORMAT_CF32_META, ::BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META and
+ * ::BLADERF_FORMAT_SC8_Q7_AS_CF32_META formats are supported.
  *
- * Generally, one will want to set the `buffers` parameter to a value larger
- * than the `num_transfers` parameter, and keep track of which buffers are
- * currently "in-flight", versus those available for use.
+ * @pre A bladerf_sync_config() call has been made to configure the device
+ *      for synchronous TX.
  *
- * For example, for a transmit stream, modulated data can be actively written
- * into free buffers while transfers of other buffers are occurring. Once a
- * buffer has been filled with data, it can be marked 'in-flight' and be
- * returned in a successive callback to transmit.
+ * @note Templates are freed when the TX stream is reconfigured via
+ *       bladerf_sync_config() or the device is closed, after which the
+ *       handle must no longer be used.
  *
- * The choice of values for the `num_transfers` and `buffer_size` should be
- * made based upon the desired samplerate, and the stream timeout value
- * specified via bladerf_set_stream_timeout(), which defaults to 1 second.
+ * @param       dev         Device handle
+ * @param[in]   samples     Samples in the configured format, interleaved as
+ *                          with bladerf_sync_tx()
+ * @param[in]   num_samples Number of samples, as with bladerf_sync_tx()
+ * @param[out]  tmpl        Set to the created template on success
  *
- * For a given sample rate, the below relationship must be upheld to transmit or
- * receive data without timeouts or dropped data.
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if the configured format is not supported,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_create_tx_template(struct bladerf *dev,
+                                              const void *samples,
+                                              unsigned int num_samples,
+                                              struct bladerf_tx_template **tmpl);
+
+/**
+ * Schedule a TX template for transmission at the specified timestamp.
  *
- * @f[
- * Sample\ Rate > \frac{\#\ Transfers}{Timeout} \times Buffer\ Size
- * @f]
+ * Only the timestamps within the template's metadata headers are updated;
+ * its buffers are then submitted as-is, following any samples already
+ * buffered via bladerf_sync_tx(). If the previous transmission of the same
+ * template has not yet completed, this call first waits for it.
  *
- * ...where Sample Rate is in samples per second, and Timeout is in seconds.
+ * This may be interleaved with bursts sent via bladerf_sync_tx(), provided
+ * that such bursts are ended (::BLADERF_META_FLAG_TX_BURST_END) before this
+ * function is called. As with bursts, `timestamp` must not precede the end
+ * of the previously transmitted samples.
  *
- * To account for general system overhead, it is recommended to multiply the
- * righthand side by 1.1 to 1.25.
+ * @param       dev         Device handle
+ * @param[in]   tmpl        Template to transmit
+ * @param[in]   timestamp   Timestamp of the first sample of the template
+ * @param[in]   timeout_ms  Timeout (milliseconds) for this call to complete.
+ *                          Zero implies "infinite."
  *
- * While increasing the number of buffers available provides additional
- * elasticity, be aware that it also increases latency.
- *
- * @param[out]  stream          Upon success, this will be updated to contain
- *                              a stream handle (i.e., address)
- * @param       dev             Device to associate with the stream
- * @param[in]   callback        Callback routine to handle asynchronous events
- * @param[out]  buffers         This will be updated to point to a dynamically
- *                              allocated array of buffer pointers.
- * @param[in]   num_buffers     Number of buffers to allocate and return. This
- *                              value must >= the `num_transfers` parameter.
- * @param[in]   format          Sample data format
- * @param[in]   samples_per_buffer  Size of allocated buffers, in units of
- *                                  samples Note that the physical size of the
- *                                  buffer is a function of this and the format
- *                                  parameter.
- * @param[in]   num_transfers   Maximum number of transfers that may be
- *                              in-flight simultaneously. This must be <= the
- *                              `num_buffers` parameter.
- * @param[in]   user_data       Caller-provided data that will be provided
- *                              in stream callbacks
+ * @return 0 on success,
+ *         ::BLADERF_ERR_TIME_PAST if `timestamp` is in the past,
+ *         ::BLADERF_ERR_INVAL if a burst is in progress,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_tx_template(struct bladerf *dev,
+                                       struct bladerf_tx_template *tmpl,
+                                       bladerf_timestamp timestamp,
+                                       unsigned int timeout_ms);
+
+/**
+ * Free a TX template, first waiting for any pending transmission of it to
+ * complete.
  *
- * @note  This call should be later followed by a call to
- *        bladerf_deinit_stream() to avoid memory leaks.
+ * @param       dev         Device handle
+ * @param[in]   tmpl        Template to free. NULL is ignored.
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 on success,
+ *         ::BLADERF_ERR_TIMEOUT if the template's transmission did not
+ *         complete within the stream timeout, in which case it is not freed,
+ *         or a value from \ref RETCODES list on failures.
  */
 API_EXPORT
-int CALL_CONV bladerf_init_stream(struct bladerf_stream **stream,
-                                  struct bladerf *dev,
-                                  bladerf_stream_cb callback,
-                                  void ***buffers,
-                                  size_t num_buffers,
-                                  bladerf_format format,
-                                  size_t samples_per_buffer,
-                                  size_t num_transfers,
-                                  void *user_data);
+int CALL_CONV bladerf_sync_free_tx_template(struct bladerf *dev,
+                                            struct bladerf_tx_template *tmpl);
 
 /**
- * Begin running a stream. This call will block until the stream completes.
+ * Receive a buffer of IQ samples without copying it.
  *
- * Only 1 RX stream and 1 TX stream may be running at a time. Attempting to
- * call bladerf_stream() with more than one stream will yield unexpected (and
- * most likely undesirable) results.
+ * Rather than copying samples into a caller-supplied array, as
+ * bladerf_sync_rx() does, this call lends the caller the next full buffer of
+ * the underlying stream. The stream will not reuse the buffer until it is
+ * returned via bladerf_sync_rx_release(). Multiple buffers may be held at
+ * once, but holding buffers reduces the number available to the stream and
+ * makes overruns more likely.
  *
- * @note See the ::bladerf_stream_cb description for additional thread-safety
- *       caveats.
+ * This may be mixed with bladerf_sync_rx() calls, provided that the previous
+ * bladerf_sync_rx() call consumed a whole number of buffers.
  *
- * @pre This function should be preceded by a call to bladerf_enable_module()
- *      to enable the associated RX or TX directions before attempting to use
- *      it to stream data.
+ * For the ::BLADERF_FORMAT_SC16_Q11_META and ::BLADERF_FORMAT_SC8_Q7_META
+ * formats, the buffer contains the raw stream messages, metadata headers
+ * included. In this case `metadata` is populated with the timestamp of the
+ * first message and the status flags of all messages in the buffer. For
+ * other formats, the `timestamp` field is set to the position of the first
+ * sample in the buffer, counted from the start of the stream.
  *
- * @param      stream   A stream handle that has been successfully been
- *                      initialized via bladerf_init_stream()
- * @param[in]  layout   Stream direction and channel layout
+ * See bladerf_set_sync_rx_pool() for concurrent use by multiple threads.
  *
- * @return 0 on success, value from \ref RETCODES list on failure
- */
-API_EXPORT
-int CALL_CONV bladerf_stream(struct bladerf_stream *stream,
-                             bladerf_channel_layout layout);
-
-/**
- * Submit a buffer to a stream from outside of a stream callback function.
- * Use this only when returning BLADERF_STREAM_NO_DATA from callbacks. <b>Do
- * not</b> use this function if the associated callback functions will be
- * returning buffers for submission.
+ * The ::BLADERF_FORMAT_PACKET_META format is not supported.
  *
- * This call may block if the device is not ready to submit a buffer for
- * transfer. Use the `timeout_ms` to place an upper limit on the time this
- * function can block.
+ * @pre A bladerf_sync_config() call has been to configure the device for
+ *      synchronous data transfer.
  *
- * To safely submit buffers from outside the stream callback flow, this function
- * internally acquires a per-stream lock (the same one that is held during the
- * execution of a stream callback). Therefore, it is important to be aware of
- * locks that may be held while making this call, especially those acquired
- * during execution of the associated stream callback function. (i.e., be wary
- * of the order of lock acquisitions, including the internal per-stream lock.)
+ * @note Buffers that are still held when the stream is reconfigured or
+ *       errors out are invalidated and must not be accessed.
  *
- * @param           stream      Stream to submit buffer to
- * @param[inout]    buffer      Buffer to fill (RX) or containing data (TX).
- *                              This buffer is assumed to be the size specified
- *                              in the associated bladerf_init_stream() call.
- * @param[in]       timeout_ms  Milliseconds to timeout in, if this call blocks.
- *                              0 implies an "infinite" wait.
+ * @param       dev         Device handle
+ * @param[out]  buffer      Set to the address of the lent buffer
+ * @param[out]  num_samples Set to the number of samples in the buffer
+ * @param[out]  metadata    Sample metadata. May be NULL.
+ * @param[in]   timeout_ms  Timeout (milliseconds) for this call to complete.
+ *                          Zero implies "infinite."
  *
- * @return 0 on success, ::BLADERF_ERR_TIMEOUT upon a timeout, or a value from
- *         \ref RETCODES list on other failures
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if the configured format is not supported,
+ *         or a value from \ref RETCODES list on failures.
  */
 API_EXPORT
-int CALL_CONV bladerf_submit_stream_buffer(struct bladerf_stream *stream,
-                                           void *buffer,
-                                           unsigned int timeout_ms);
+int CALL_CONV bladerf_sync_rx_acquire(struct bladerf *dev,
+                                      void **buffer,
+                                      unsigned int *num_samples,
+                                      struct bladerf_metadata *metadata,
+                                      unsigned int timeout_ms);
 
 /**
- * This is a non-blocking variant of bladerf_submit_stream_buffer(). All of the
- * caveats and important notes from bladerf_submit_stream_buffer() apply.
- *
- * In the event that this call would need to block in order to submit a buffer,
- * it returns BLADERF_ERR_WOULD_BLOCK. In this case, the caller could either
- * wait and try again or defer buffer submission to the asynchronous callback.
+ * Return a buffer obtained with bladerf_sync_rx_acquire() to the stream.
  *
- * @param           stream      Stream to submit buffer to
- * @param[inout]    buffer      Buffer to fill (RX) or containing data (TX).
- *                              This buffer is assumed to be the size specified
- *                              in the associated bladerf_init_stream() call.
+ * @param       dev         Device handle
+ * @param[in]   buffer      Buffer to release
  *
- * @return  0 on success, ::BLADERF_ERR_WOULD_BLOCK if the call would have to
- *          block to succeed, or another value from \ref RETCODES upon other
- *          failure
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `buffer` is not currently held by the caller,
+ *         or a value from \ref RETCODES list on failures.
  */
 API_EXPORT
-int CALL_CONV bladerf_submit_stream_buffer_nb(struct bladerf_stream *stream,
-                                              void *buffer);
-
+int CALL_CONV bladerf_sync_rx_release(struct bladerf *dev, void *buffer);
 
 /**
- * Deinitialize and deallocate stream resources.
+ * Obtain a TX stream buffer to fill in place.
  *
- * @pre  Stream is no longer being used (via bladerf_submit_stream_buffer() or
- *       bladerf_stream() calls.)
+ * This lends the caller the next empty buffer of the underlying stream, such
+ * that samples may be written directly into it, rather than being copied in
+ * by bladerf_sync_tx(). The buffer must be handed back via
+ * bladerf_sync_tx_submit() before bladerf_sync_tx() or
+ * bladerf_sync_tx_acquire() may be called again, unless TX buffer pool mode
+ * is active (see bladerf_set_sync_tx_pool()).
  *
- * @post Stream is deallocated and may no longer be used.
+ * Only the ::BLADERF_FORMAT_SC16_Q11 and ::BLADERF_FORMAT_SC8_Q7 formats are
+ * supported.
  *
- * @param   stream  Stream to deinitialize. This function does nothing if
- *                  stream is `NULL`.
+ * @pre A bladerf_sync_config() call has been to configure the device for
+ *      synchronous data transfer.
+ *
+ * @param       dev         Device handle
+ * @param[out]  buffer      Set to the address of the lent buffer
+ * @param[out]  num_samples Set to the capacity of the buffer, in samples
+ * @param[in]   timeout_ms  Timeout (milliseconds) for this call to complete.
+ *                          Zero implies "infinite."
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if the configured format is not supported,
+ *         or a value from \ref RETCODES list on failures.
  */
 API_EXPORT
-void CALL_CONV bladerf_deinit_stream(struct bladerf_stream *stream);
+int CALL_CONV bladerf_sync_tx_acquire(struct bladerf *dev,
+                                      void **buffer,
+                                      unsigned int *num_samples,
+                                      unsigned int timeout_ms);
 
 /**
- * Set stream transfer timeout in milliseconds
+ * Submit a buffer obtained with bladerf_sync_tx_acquire() for transmission.
+ *
+ * If `num_samples` is less than the buffer's capacity, the remainder of the
+ * buffer is filled with (0 + 0j) samples.
  *
  * @param       dev         Device handle
- * @param[in]   dir         Stream direction
- * @param[in]   timeout     Timeout in milliseconds
+ * @param[in]   buffer      Buffer to submit
+ * @param[in]   num_samples Number of valid samples written to `buffer`
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `buffer` is not currently held by the caller,
+ *         or a value from \ref RETCODES list on failures.
  */
 API_EXPORT
-int CALL_CONV bladerf_set_stream_timeout(struct bladerf *dev,
-                                         bladerf_direction dir,
-                                         unsigned int timeout);
+int CALL_CONV bladerf_sync_tx_submit(struct bladerf *dev,
+                                     void *buffer,
+                                     unsigned int num_samples);
 
 /**
- * Get transfer timeout in milliseconds
+ * Reserve the next TX stream buffer to fill in place, in TX buffer pool
+ * mode. See bladerf_set_sync_tx_pool().
+ *
+ * This is bladerf_sync_tx_acquire(), additionally providing the position of
+ * the buffer within the stream. The buffer is handed back via
+ * bladerf_sync_tx_submit().
  *
  * @param       dev         Device handle
- * @param[in]   dir         Stream direction
- * @param[out]  timeout     On success, updated with current transfer
- *                          timeout value. Undefined on failure.
+ * @param[out]  buffer      Set to the address of the reserved buffer
+ * @param[out]  num_samples Set to the capacity of the buffer, in samples
+ * @param[out]  position    Set to the position of the buffer's first sample,
+ *                          in samples per channel since the stream was
+ *                          configured. May be NULL.
+ * @param[in]   timeout_ms  Timeout (milliseconds) for this call to complete.
+ *                          Zero implies "infinite."
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if pool mode is not active or the
+ *         configured format is not supported,
+ *         or a value from \ref RETCODES list on failures.
  */
 API_EXPORT
-int CALL_CONV bladerf_get_stream_timeout(struct bladerf *dev,
-                                         bladerf_direction dir,
-                                         unsigned int *timeout);
+int CALL_CONV bladerf_sync_tx_reserve(struct bladerf *dev,
+                                      void **buffer,
+                                      unsigned int *num_samples,
+                                      uint64_t *position,
+                                      unsigned int timeout_ms);
 
-/** @} (End of FN_STREAMING_ASYNC) */
+/**
+ * Policy used by bladerf_sync_rx() and bladerf_sync_tx() (and their
+ * zero-copy counterparts) when waiting on the underlying stream for a buffer
+ */
+typedef enum {
+    /**
+     * Block on a condition variable until the stream worker signals that a
+     * buffer is available. This is the default and uses the least CPU.
+     */
+    BLADERF_SYNC_WAIT_BLOCK = 0,
 
-/** @} (End of STREAMING) */
+    /**
+     * Busy-poll for up to a specified period before falling back to blocking.
+     * In this mode, the RX stream callback hands buffers off to the caller
+     * without taking the buffer management lock, and only wakes the caller
+     * when it has actually gone to sleep.
+     *
+     * This reduces wakeup latency and jitter at the expense of keeping a CPU
+     * core busy while waiting.
+     */
+    BLADERF_SYNC_WAIT_SPIN,
+} bladerf_sync_wait_policy;
 
 /**
- * @defgroup FN_PROG  Firmware and FPGA
+ * Select the policy used to wait for buffers in the synchronous interface.
  *
- * These functions provide the ability to load and program devices on the
- * bladeRF board.
- *
- * Care should be taken with bootloader recovery functions to ensure that
- * devices operated on are indeed a bladeRF, as opposed to another FX3-based
- * device running in bootloader mode.
+ * The selected policy is latched by the next bladerf_sync_config() call for
+ * the specified direction; it does not affect an already-configured stream.
  *
- * These functions are thread-safe.
+ * @param       dev         Device handle
+ * @param[in]   dir         Stream direction
+ * @param[in]   policy      Wait policy
+ * @param[in]   spin_us     For ::BLADERF_SYNC_WAIT_SPIN, the maximum amount of
+ *                          time to busy-poll, in microseconds, before blocking.
+ *                          Ignored for ::BLADERF_SYNC_WAIT_BLOCK.
  *
- * @{
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `policy` is invalid,
+ *         or a value from \ref RETCODES list on failures.
  */
+API_EXPORT
+int CALL_CONV bladerf_set_sync_wait_policy(struct bladerf *dev,
+                                           bladerf_direction dir,
+                                           bladerf_sync_wait_policy policy,
+                                           unsigned int spin_us);
 
 /**
- * Write FX3 firmware to the bladeRF's SPI flash
- *
- * @note This will require a power cycle to take effect
+ * Synchronous interface statistics
  *
- * @param       dev         Device handle
- * @param[in]   firmware    Full path to firmware file
- *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * These are accumulated from the time of the last bladerf_sync_config() call
+ * for the associated direction. For RX, the "producer" is the device and the
+ * "consumer" is the API caller; for TX, these roles are reversed.
  */
-API_EXPORT
-int CALL_CONV bladerf_flash_firmware(struct bladerf *dev, const char *firmware);
+struct bladerf_stream_stats {
+    /** Number of buffers filled with samples by the producer */
+    uint64_t buffers_produced;
+
+    /** Number of buffers emptied by the consumer */
+    uint64_t buffers_consumed;
+
+    /**
+     * Number of buffers whose samples were discarded.
+     *
+     * For RX, these are buffers received while no free buffer was available
+     * (i.e., during an overrun). For TX, these are buffers that were in
+     * flight when the stream was restarted after an error.
+     */
+    uint64_t buffers_dropped;
+
+    /**
+     * Number of RX overrun events. A single overrun may result in multiple
+     * dropped buffers.
+     */
+    uint64_t overruns;
+
+    /**
+     * Number of times the TX stream ran out of samples to send, i.e., all
+     * buffers submitted to the device had completed. Note that this also
+     * occurs when the caller simply stops transmitting.
+     */
+    uint64_t underruns;
+
+    /**
+     * High-water mark of the number of buffers that were produced but not
+     * yet consumed. Values approaching the `num_buffers` parameter provided to
+     * bladerf_sync_config() indicate that more buffers are needed.
+     */
+    unsigned int high_water;
+
+    /** Number of buffers in use by the stream */
+    unsigned int num_buffers;
+
+    /** Size of each stream buffer, in samples */
+    unsigned int buffer_size;
+
+    /** Maximum number of transfers in flight */
+    unsigned int num_transfers;
+
+    /** Number of USB transfers that completed successfully */
+    uint64_t transfers_completed;
+
+    /** Number of transfers that completed with fewer bytes than requested */
+    uint64_t short_transfers;
+
+    /**
+     * Average time from the submission of a transfer to its completion, in
+     * microseconds. This is 0 if the backend does not measure it.
+     */
+    unsigned int xfer_latency_avg_us;
+
+    /** Maximum time from submission of a transfer to its completion, in us */
+    unsigned int xfer_latency_max_us;
+
+    /**
+     * Number of times the FPGA's sample FIFO overflowed, dropping RX samples
+     * before they reached USB, or ran empty while TX samples were due. A run
+     * of consecutive dropped or missing samples counts once.
+     *
+     * Drops counted here happened because USB, or the host behind it, did
+     * not keep up; gaps that are not counted here happened on the host. The
+     * FIFO is shared by all channels of the stream. A TX stream with
+     * metadata is not counted while it waits for a burst's timestamp.
+     *
+     * This is 0 unless the FPGA is v0.16.9 (bladeRF x40/x115) or v0.17.8
+     * (bladeRF 2.0 Micro) or later.
+     */
+    uint64_t fpga_xruns;
+
+    /**
+     * Timestamp at which the latest event counted in `fpga_xruns` began, in
+     * the stream's timebase, or 0 if there has been none
+     */
+    bladerf_timestamp fpga_last_xrun;
+
+    /** Number of RX buffers recorded by the capture tap. See
+     *  bladerf_set_sync_rx_tap(). */
+    uint64_t tap_buffers_written;
+
+    /** Number of RX buffers the capture tap dropped, rather than hold up the
+     *  stream */
+    uint64_t tap_buffers_dropped;
+};
 
 /**
- * Load device's FPGA.
+ * Retrieve statistics for the synchronous interface.
  *
- * @note This FPGA configuration will be reset at the next power cycle.
+ * These are useful for tuning the `num_buffers` and `num_transfers` parameters
+ * passed to bladerf_sync_config().
  *
  * @param       dev         Device handle
- * @param[in]   fpga        Full path to FPGA bitstream
+ * @param[in]   dir         Stream direction
+ * @param[out]  stats       Populated with the current statistics
  *
- * @return 0 upon successfully, or a value from \ref RETCODES list on failure
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if bladerf_sync_config() has not been called
+ *         for the specified direction,
+ *         or a value from \ref RETCODES list on failures.
  */
 API_EXPORT
-int CALL_CONV bladerf_load_fpga(struct bladerf *dev, const char *fpga);
+int CALL_CONV bladerf_get_stream_stats(struct bladerf *dev,
+                                       bladerf_direction dir,
+                                       struct bladerf_stream_stats *stats);
 
 /**
- * Write the provided FPGA image to the bladeRF's SPI flash and enable FPGA
- * loading from SPI flash at power on (also referred to within this project as
- * FPGA "autoloading").
+ * Scheduling attributes for a thread that services a stream.
  *
- * @param       dev         Device handle
- * @param[in]   fpga_image  Full path to FPGA file
+ * libusb completion callbacks are executed on the thread that is handling
+ * USB events for the stream. For the synchronous interface, this is the
+ * stream's internal worker thread. For the asynchronous interface, this is the
+ * thread that calls bladerf_stream().
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * Pinning this thread to a core near the one that consumes the samples can
+ * noticeably reduce wakeup latency, particularly on NUMA systems.
  */
-API_EXPORT
-int CALL_CONV bladerf_flash_fpga(struct bladerf *dev, const char *fpga_image);
+struct bladerf_thread_attrs {
+    /**
+     * Index of the CPU core to pin the thread to, or -1 to leave the thread's
+     * affinity unchanged. Not supported on OSX.
+     */
+    int cpu;
+
+    /**
+     * Request real-time scheduling. On POSIX systems, this selects SCHED_FIFO,
+     * which typically requires elevated privileges (e.g., CAP_SYS_NICE on
+     * Linux). On Windows, the thread is registered with MMCSS as a
+     * "Pro Audio" task.
+     */
+    bool realtime;
+
+    /**
+     * SCHED_FIFO priority to use when `realtime` is set. 0 selects a
+     * moderate default. Values outside of the range supported by the
+     * system are clamped. Ignored on Windows.
+     */
+    int priority;
+};
 
 /**
- * Erase the FPGA region of SPI flash, effectively disabling FPGA autoloading
+ * Set the scheduling attributes of the worker thread backing the synchronous
+ * interface for the specified direction. This is the thread on which USB
+ * transfers for the stream are completed.
  *
- * @param   dev         Device handle
+ * The attributes are latched by the next bladerf_sync_config() call for the
+ * specified direction; they do not affect an already-configured stream.
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * On Linux systems with multiple NUMA nodes, the worker thread is by default
+ * restricted to the CPUs of the node hosting the device's USB controller,
+ * and stream buffers are allocated from that node's memory. An explicit `cpu`
+ * takes precedence. Setting the BLADERF_NUMA_DISABLE environment variable
+ * disables this placement.
+ *
+ * Failure to apply an attribute (e.g., due to insufficient privileges) is not
+ * fatal; a warning is logged and the stream proceeds without it.
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Stream direction
+ * @param[in]   attrs       Thread attributes. NULL restores the defaults.
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `attrs` contains invalid values,
+ *         or a value from \ref RETCODES list on failures.
  */
 API_EXPORT
-int CALL_CONV bladerf_erase_stored_fpga(struct bladerf *dev);
+int CALL_CONV bladerf_set_sync_thread_attrs(
+    struct bladerf *dev,
+    bladerf_direction dir,
+    const struct bladerf_thread_attrs *attrs);
 
 /**
- * Reset the device, causing it to reload its firmware from flash
+ * @defgroup BLADERF_STREAM_MEM Stream memory flags
  *
- * @param   dev         Device handle
+ * Flags for bladerf_set_stream_memory_flags()
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @{
  */
-API_EXPORT
-int CALL_CONV bladerf_device_reset(struct bladerf *dev);
+
+/** Fault in stream buffers when they are allocated, rather than on their
+ *  first transfer */
+#define BLADERF_STREAM_MEM_PREFAULT (1 << 0)
+
+/** Lock stream buffers into RAM, which also faults them in, such that they
+ *  are not paged out under memory pressure */
+#define BLADERF_STREAM_MEM_LOCK (1 << 1)
+
+/** Lock the stack of each thread that runs a stream, including the sync
+ *  worker, into RAM while the stream runs. Only supported on Linux. */
+#define BLADERF_STREAM_MEM_LOCK_STACKS (1 << 2)
+
+/** @} */
 
 /**
- * Read firmware log data and write it to the specified file
+ * Fault in, and optionally lock into RAM, the memory used by subsequently
+ * initialized streams, so that they do not take page faults once streaming
+ * has started. Without this, the kernel backs a stream's memory as it is
+ * first transferred to, and may page it out later, and both show up as
+ * overruns or underruns.
  *
- * @param       dev         Device to read firmware log from
- * @param[in]   filename    Filename to write log information to. If set to
- *                          `NULL`, log data will be printed to stdout.
+ * The flags are applied when the buffers of a stream are allocated, by
+ * bladerf_init_stream() or by a bladerf_sync_config() call that allocates new
+ * buffers. A sync reconfiguration that keeps its existing buffers keeps their
+ * current state.
  *
- * @return 0 upon success, or a value from \ref RETCODES list on failure
+ * Locking memory is limited by RLIMIT_MEMLOCK on POSIX systems, and by the
+ * process's working set size on Windows. Failure to lock memory is not fatal;
+ * a warning is logged, and the buffers are then only faulted in.
+ *
+ * @param       dev         Device handle
+ * @param[in]   flags       Bitmask of \ref BLADERF_STREAM_MEM flags, or 0 for
+ *                          the default behavior
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `flags` contains unknown flags,
+ *         or a value from \ref RETCODES list on failures.
  */
 API_EXPORT
-int CALL_CONV bladerf_get_fw_log(struct bladerf *dev, const char *filename);
+int CALL_CONV bladerf_set_stream_memory_flags(struct bladerf *dev,
+                                              uint32_t flags);
 
 /**
- * Clear out a firmware signature word in flash and jump to FX3 bootloader.
+ * Caller-provided allocator for stream buffers.
  *
- * The device will continue to boot into the FX3 bootloader across power cycles
- * until new firmware is written to the device.
+ * By default, stream buffers are allocated by libbladeRF, from memory that the
+ * backend can transfer to and from directly where possible. An allocator
+ * allows them to instead be placed in memory of the application's choosing,
+ * such as hugepages, NUMA-local memory, or host memory pinned for a GPU, such
+ * that samples are delivered where they are consumed without an extra copy.
  *
- * @param   dev         Device handle
+ * All of a stream's buffers are carved out of one allocation, of
+ * `num_buffers` times the size of a buffer in bytes. A preallocated region may
+ * be used by having `alloc` return it, provided it is large enough.
+ */
+struct bladerf_buffer_allocator {
+    /**
+     * Allocate `size` bytes. This should return memory aligned to at least a
+     * page, or NULL on failure. The memory is zeroed by libbladeRF
+     * afterwards, so it must be writable from the host.
+     */
+    void *(*alloc)(size_t size, void *user_data);
+
+    /**
+     * Release memory returned by `alloc`, once the stream has been
+     * deinitialized. `size` is the value passed to `alloc`. May be NULL if
+     * nothing needs to be done.
+     */
+    void (*free)(void *ptr, size_t size, void *user_data);
+
+    /** Passed to `alloc` and `free` */
+    void *user_data;
+};
+
+/**
+ * Set the allocator from which the buffers of the synchronous interface are
+ * obtained, for the specified direction. See ::bladerf_buffer_allocator.
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * With the zero-copy bladerf_sync_rx_acquire() and bladerf_sync_tx_acquire()
+ * functions, samples are then accessed directly in this memory.
+ *
+ * The allocator is latched by the next bladerf_sync_config() call for the
+ * specified direction; it does not affect an already-configured stream. Its
+ * `free` function is called when the stream is reconfigured, or the device is
+ * closed.
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Stream direction
+ * @param[in]   allocator   Buffer allocator, which is copied. NULL restores
+ *                          the default allocation.
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `allocator` lacks an `alloc` function,
+ *         or a value from \ref RETCODES list on failures.
  */
 API_EXPORT
-int CALL_CONV bladerf_jump_to_bootloader(struct bladerf *dev);
+int CALL_CONV bladerf_set_sync_buffer_allocator(
+    struct bladerf *dev,
+    bladerf_direction dir,
+    const struct bladerf_buffer_allocator *allocator);
 
 /**
- * Get a list of devices that are running the FX3 bootloader.
+ * Configuration of a stream memory pool, shared by the RX and TX buffers of
+ * the synchronous interface. See bladerf_set_stream_pool().
+ */
+struct bladerf_stream_pool_config {
+    /** Size of the pool in bytes, which bounds the memory taken by the
+     *  buffers of both directions together */
+    size_t size;
+
+    /** Bytes of the pool kept available to RX buffers, which TX buffers may
+     *  not draw upon. It is released as RX buffers are allocated. */
+    size_t rx_reserve;
+
+    /** Bytes of the pool kept available to TX buffers, as for `rx_reserve` */
+    size_t tx_reserve;
+};
+
+/**
+ * Stream memory pool usage. See bladerf_get_stream_pool_stats().
+ */
+struct bladerf_stream_pool_stats {
+    size_t size;            /**< Size of the pool in bytes */
+    size_t rx_used;         /**< Bytes held by RX buffers */
+    size_t tx_used;         /**< Bytes held by TX buffers */
+    size_t peak;            /**< Most bytes held at once, by both directions */
+    unsigned int failures;  /**< Allocations that did not fit */
+};
+
+/**
+ * Draw the buffers of both synchronous interface directions from one
+ * size-bounded memory pool.
  *
- * After obtaining this list, identify the device that you would like to load
- * firmware onto. Save the bus and address values so that you can provide them
- * to bladerf_load_fw_from_bootloader(), and then free this list via
- * bladerf_free_device_list().
+ * By default, each direction allocates its `num_buffers` buffers separately,
+ * such that full-duplex streaming takes the sum of both configurations. A
+ * pool instead bounds their total, which suits memory-constrained hosts. Each
+ * direction's buffers are still carved out of one contiguous block of the
+ * pool, at a page-aligned offset. The reserves are low watermarks that keep
+ * part of the pool available to each direction, so that, for example, a
+ * large RX configuration cannot leave no room for TX.
  *
- * @param[out]   list    Upon finding devices, this will be updated to point
- *                       to a list of bladerf_devinfo structures that
- *                       describe the identified devices.
+ * The pool takes the place of any allocator set by
+ * bladerf_set_sync_buffer_allocator(), and like it, is latched by the next
+ * bladerf_sync_config() call for each direction. A later call to
+ * bladerf_set_sync_buffer_allocator() replaces it for that direction. A
+ * bladerf_sync_config() call whose buffers do not fit in the pool fails with
+ * ::BLADERF_ERR_MEM.
  *
- * @return Number of items populated in `list`,
- *         or an error value from the \ref RETCODES list on failure
+ * Replacing or disabling a pool does not affect streams whose buffers are
+ * already allocated from it; its memory is released once they are.
+ *
+ * @param       dev         Device handle
+ * @param[in]   config      Pool configuration, which is copied. NULL disables
+ *                          the pool, and restores the default allocation for
+ *                          both directions.
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `size` is zero, or the reserves exceed it,
+ *         ::BLADERF_ERR_MEM if the pool cannot be allocated,
+ *         or a value from \ref RETCODES list on failures.
  */
 API_EXPORT
-int CALL_CONV bladerf_get_bootloader_list(struct bladerf_devinfo **list);
+int CALL_CONV bladerf_set_stream_pool(
+    struct bladerf *dev, const struct bladerf_stream_pool_config *config);
 
 /**
- * Download firmware to the specified device that is enumarating an FX3
- * bootloader, and begin executing the firmware from RAM.
- *
- * @note This function <b>does not</b> write the firmware to SPI flash. If this
- * is desired, open the newly enumerated device with bladerf_open() and use
- * bladerf_flash_firmware().
+ * Get the usage of the stream memory pool set by bladerf_set_stream_pool().
  *
- * @param[in]   device_identifier   Device identifier string describing the
- *                                  backend to use via the
- *                                  `<backend>:device=<bus>:<addr>` syntax.  If
- *                                  this is NULL, the backend, bus, and addr
- *                                  arguments will be used instead.
- * @param[in]   backend             Backend to use. This is only used if
- *                                  device_identifier is `NULL`.
- * @param[in]   bus                 Bus number the device is located on. This
- *                                  is only used if device_identifier is `NULL`.
- * @param[in]   addr                Bus address the device is located on. This
- *                                  is only used if device_identifier is `NULL`.
- * @param[in]   file                Filename of the firmware image to boot
+ * @param       dev         Device handle
+ * @param[out]  stats       Pool usage
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 on success,
+ *         ::BLADERF_ERR_NOT_INIT if no pool is set,
+ *         or a value from \ref RETCODES list on failures.
  */
 API_EXPORT
-int CALL_CONV bladerf_load_fw_from_bootloader(const char *device_identifier,
-                                              bladerf_backend backend,
-                                              uint8_t bus,
-                                              uint8_t addr,
-                                              const char *file);
+int CALL_CONV bladerf_get_stream_pool_stats(
+    struct bladerf *dev, struct bladerf_stream_pool_stats *stats);
 
-/** @} (End of FN_PROG) */
+/**
+ * Enable or disable RX buffer pool mode for the synchronous interface.
+ *
+ * By default, the zero-copy bladerf_sync_rx_acquire() interface lends out
+ * buffers strictly in ring order, and a buffer that is held by the caller
+ * blocks the worker from refilling any buffer behind it. In pool mode:
+ *
+ *  - Multiple threads may call bladerf_sync_rx_acquire() concurrently, each
+ *    holding its own buffer.
+ *  - Buffers may be returned via bladerf_sync_rx_release() in any order. The
+ *    worker refills whichever buffers are free, rather than stalling on the
+ *    oldest outstanding one.
+ *  - Buffers are handed out in the order in which they were filled. For
+ *    formats without metadata, the `timestamp` field of the metadata passed
+ *    to bladerf_sync_rx_acquire() is set to the sample position of the first
+ *    sample in the buffer, relative to the start of the stream, so that
+ *    consumers may reorder results.
+ *
+ * bladerf_sync_rx() and bladerf_sync_rx_multi() are not supported while pool
+ * mode is active and return ::BLADERF_ERR_UNSUPPORTED.
+ *
+ * This setting is latched by the next bladerf_sync_config() call for the RX
+ * direction; it does not affect an already-configured stream.
+ *
+ * @param       dev         Device handle
+ * @param[in]   enable      Set true to enable pool mode, false to disable it
+ *
+ * @return 0 on success, or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_sync_rx_pool(struct bladerf *dev, bool enable);
 
 /**
- * @defgroup FN_IMAGE Flash image format
+ * Enable or disable TX buffer pool mode for the synchronous interface.
  *
- * This section contains a file format and associated routines for storing
- * and loading flash contents with metadata.
+ * By default, only one TX buffer may be held via bladerf_sync_tx_acquire()
+ * at a time, so samples produced by several threads must be funneled through
+ * a single one. In pool mode:
  *
- * These functions are thread-safe.
+ *  - Multiple threads may call bladerf_sync_tx_acquire() or
+ *    bladerf_sync_tx_reserve() concurrently. Each reserves the next buffer of
+ *    the stream, i.e., the next slot of samples to be transmitted, and holds
+ *    it while filling it in place.
+ *  - Buffers may be submitted via bladerf_sync_tx_submit() in any order.
+ *    They are transmitted in the order in which they were reserved, each as
+ *    soon as every buffer reserved before it has been submitted.
+ *  - bladerf_sync_tx_reserve() provides the sample position of the first
+ *    sample in the buffer, relative to the start of the stream, so that
+ *    producers know which samples to generate.
  *
- * @{
+ * A buffer that is reserved but not submitted holds up the transmission of
+ * every buffer after it, so each reservation must be submitted promptly.
+ *
+ * Only the ::BLADERF_FORMAT_SC16_Q11 and ::BLADERF_FORMAT_SC8_Q7 formats are
+ * supported. bladerf_sync_tx() and bladerf_sync_tx_multi() are not supported
+ * while pool mode is active and return ::BLADERF_ERR_UNSUPPORTED.
+ *
+ * This setting is latched by the next bladerf_sync_config() call for the TX
+ * direction; it does not affect an already-configured stream.
+ *
+ * @param       dev         Device handle
+ * @param[in]   enable      Set true to enable pool mode, false to disable it
+ *
+ * @return 0 on success, or a value from \ref RETCODES list on failures.
  */
+API_EXPORT
+int CALL_CONV bladerf_set_sync_tx_pool(struct bladerf *dev, bool enable);
 
-/** Type of data stored in a flash image */
-typedef enum {
-    BLADERF_IMAGE_TYPE_INVALID = -1, /**< Used to denote invalid value */
-    BLADERF_IMAGE_TYPE_RAW,          /**< Misc. raw data */
-    BLADERF_IMAGE_TYPE_FIRMWARE,     /**< Firmware data */
-    BLADERF_IMAGE_TYPE_FPGA_40KLE,   /**< FPGA bitstream for 40 KLE device */
-    BLADERF_IMAGE_TYPE_FPGA_115KLE,  /**< FPGA bitstream for 115  KLE device */
-    BLADERF_IMAGE_TYPE_FPGA_A4,      /**< FPGA bitstream for A4 device */
-    BLADERF_IMAGE_TYPE_FPGA_A9,      /**< FPGA bitstream for A9 device */
-    BLADERF_IMAGE_TYPE_CALIBRATION,  /**< Board calibration */
-    BLADERF_IMAGE_TYPE_RX_DC_CAL,    /**< RX DC offset calibration table */
-    BLADERF_IMAGE_TYPE_TX_DC_CAL,    /**< TX DC offset calibration table */
-    BLADERF_IMAGE_TYPE_RX_IQ_CAL,    /**< RX IQ balance calibration table */
-    BLADERF_IMAGE_TYPE_TX_IQ_CAL,    /**< TX IQ balance calibration table */
-    BLADERF_IMAGE_TYPE_FPGA_A5,      /**< FPGA bitstream for A5 device */
-    BLADERF_IMAGE_TYPE_GAIN_CAL,     /**< Gain calibration */
-} bladerf_image_type;
+/**
+ * Statistics of one channel's samples, as computed by the synchronous
+ * interface while returning them. See bladerf_set_sync_rx_stats().
+ *
+ * Values are in units of the raw SC16 Q11 sample values, e.g., a full-scale
+ * sinusoid has a `mean_power` of roughly 2048^2.
+ */
+struct bladerf_rx_channel_stats {
+    /** Number of samples (I/Q pairs) covered */
+    uint64_t count;
 
-/** Size of the magic signature at the beginning of bladeRF image files */
-#define BLADERF_IMAGE_MAGIC_LEN 7
+    /** Number of samples whose |I| or |Q| reached the clip threshold */
+    uint64_t clipped;
 
-/** Size of bladeRF flash image checksum */
-#define BLADERF_IMAGE_CHECKSUM_LEN 32
+    /** Largest |I| or |Q| */
+    uint16_t peak;
 
-/** Size of reserved region of flash image */
-#define BLADERF_IMAGE_RESERVED_LEN 128
+    /** Mean I value, i.e., the DC offset of I */
+    double mean_i;
+
+    /** Mean Q value, i.e., the DC offset of Q */
+    double mean_q;
+
+    /** Mean of I^2 + Q^2 */
+    double mean_power;
+};
 
 /**
- * Image format for backing up and restoring bladeRF flash contents
+ * Sample statistics of an RX transfer, per channel
+ */
+struct bladerf_rx_stats {
+    /**
+     * Statistics of each channel of the stream's layout, in the order they
+     * appear in the stream. Only `channel[0]` is used by ::BLADERF_RX_X1.
+     */
+    struct bladerf_rx_channel_stats channel[2];
+};
+
+/**
+ * Enable or disable the computation of sample statistics by the
+ * synchronous RX interface.
  *
- * The on disk format generated by the bladerf_image_write function is a
- * serialized version of this structure and its contents. When written to disk,
- * values are converted to big-endian byte order, for ease of reading in a hex
- * editor.
+ * When enabled, bladerf_sync_rx(), bladerf_sync_rx_multi() and
+ * bladerf_sync_rx_nb() compute the statistics described by
+ * ::bladerf_rx_channel_stats while copying samples out of the stream
+ * buffers, rather than requiring a second pass over them. Those of the
+ * samples returned by the most recent such call may then be retrieved via
+ * bladerf_get_sync_rx_stats().
  *
- * When creating and using a bladerf_image of type ::BLADERF_IMAGE_TYPE_RAW,
- * the address and length fields must be erase-block aligned.
+ * Statistics are computed for the formats carried as SC16 Q11 samples:
+ * ::BLADERF_FORMAT_SC16_Q11, ::BLADERF_FORMAT_SC16_Q11_META and their
+ * host-converted floating point equivalents. They are not computed for
+ * buffers obtained via bladerf_sync_rx_acquire(), which are not copied.
+ *
+ * This setting is latched by the next bladerf_sync_config() call for the RX
+ * direction; it does not affect an already-configured stream.
+ *
+ * @param       dev             Device handle
+ * @param[in]   enable          Set true to compute statistics
+ * @param[in]   clip_threshold  |I| or |Q| at or above which a sample is
+ *                              considered clipped, between 1 and 32767. 0
+ *                              selects 2047, the positive full scale of a
+ *                              Q11 sample.
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL for an invalid `clip_threshold`,
+ *         or a value from \ref RETCODES list on failures.
  */
-struct bladerf_image {
+API_EXPORT
+int CALL_CONV bladerf_set_sync_rx_stats(struct bladerf *dev,
+                                        bool enable,
+                                        unsigned int clip_threshold);
+
+/**
+ * Retrieve the sample statistics of the most recent bladerf_sync_rx(),
+ * bladerf_sync_rx_multi() or bladerf_sync_rx_nb() call.
+ *
+ * @pre Statistics were enabled via bladerf_set_sync_rx_stats() prior to the
+ *      last bladerf_sync_config() call for the RX direction.
+ *
+ * @param       dev         Device handle
+ * @param[out]  stats       Updated with the statistics
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if the RX direction has not been configured,
+ *         ::BLADERF_ERR_UNSUPPORTED if statistics are not being computed for
+ *         the configured stream,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_sync_rx_stats(struct bladerf *dev,
+                                        struct bladerf_rx_stats *stats);
+
+/**
+ * Configuration of a capture tap on the synchronous RX interface. See
+ * bladerf_set_sync_rx_tap().
+ */
+struct bladerf_sync_rx_tap {
     /**
-     * Magic value used to identify image file format.
-     *
-     * Note that an extra character is added to store a `NUL`-terminator,
-     * to allow this field to be printed. This `NUL`-terminator is *NOT*
-     * written in the serialized image.
+     * Path of the recording. Samples are written to `<path>.sigmf-data`, and
+     * its SigMF metadata to `<path>.sigmf-meta`. A `.sigmf-data` extension is
+     * replaced. Existing files are overwritten.
      */
-    char magic[BLADERF_IMAGE_MAGIC_LEN + 1];
+    const char *path;
 
     /**
-     * SHA256 checksum of the flash image. This is computed over the entire
-     * image, with this field filled with 0's.
+     * Most buffers that may await the writer at once, beyond which received
+     * buffers are not recorded. 0 allows all of the stream's buffers.
      */
-    uint8_t checksum[BLADERF_IMAGE_CHECKSUM_LEN];
+    unsigned int queue_depth;
+};
+
+/**
+ * Record the samples received by the synchronous RX interface to a SigMF
+ * recording, from within the library, while the application streams as
+ * usual.
+ *
+ * Each buffer the stream receives is handed to a writer thread by reference,
+ * without being copied on the stream's path. The writer copies it out and
+ * writes it to disk, bypassing the page cache via O_DIRECT where the
+ * filesystem supports it. The tap never holds up the stream: a buffer that is
+ * needed back before the writer has copied it, or that arrives while
+ * `queue_depth` buffers are queued, is dropped from the recording instead.
+ * Buffers recorded and dropped are counted by bladerf_get_stream_stats(), and
+ * each gap in the recording starts a new SigMF capture segment.
+ *
+ * Stream samples are recorded as they are received, i.e., as `ci16_le` for
+ * ::BLADERF_FORMAT_SC16_Q11 and the formats converted from it on the host,
+ * or `ci8` for ::BLADERF_FORMAT_SC8_Q7, before any host-side corrections. The
+ * samples of the metadata formats are recorded without their headers, and
+ * their capture segments are located by timestamp. The packed and
+ * ::BLADERF_FORMAT_PACKET_META formats are not supported.
+ *
+ * The tap is latched by the next bladerf_sync_config() call for the RX
+ * direction, which starts a new recording. The recording, including its
+ * metadata file, is complete once the RX stream is reconfigured, the RX
+ * channel is disabled, or the device is closed.
+ *
+ * @param       dev         Device handle
+ * @param[in]   tap         Tap configuration, which is copied. NULL disables
+ *                          the tap.
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `path` is NULL, empty or too long,
+ *         or a value from \ref RETCODES list on failures. A subsequent
+ *         bladerf_sync_config() call fails with ::BLADERF_ERR_UNSUPPORTED
+ *         for an unsupported format, or ::BLADERF_ERR_IO if the recording
+ *         cannot be created.
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_sync_rx_tap(struct bladerf *dev,
+                                      const struct bladerf_sync_rx_tap *tap);
 
+/**
+ * Configuration of the synchronous RX interface's AGC for one channel. See
+ * bladerf_set_sync_rx_agc().
+ */
+struct bladerf_sync_rx_agc {
     /**
-     * Image format version. Only the major, minor, and patch fields are
-     * written to the disk; the describe field is not used. The version is
-     * serialized as: [major | minor | patch]
+     * Mean power to hold the samples at, in dB relative to a full-scale
+     * sinusoid (a `mean_power` of 2048^2 in ::bladerf_rx_channel_stats).
+     * For example, -20.
      */
-    struct bladerf_version version;
-
-    /** UTC image timestamp, in seconds since the Unix Epoch */
-    uint64_t timestamp;
+    float target_dbfs;
 
     /**
-     * Serial number of the device that the image was obtained from. This
-     * field should be all '\0' if irrelevant.
-     *
-     * The +1 here is actually extraneous; ::BLADERF_SERIAL_LENGTH already
-     * accounts for a `NUL` terminator. However, this is left here to avoid
-     * breaking backwards compatibility.
+     * The gain is left alone while the mean power is within this many dB of
+     * `target_dbfs`
      */
-    char serial[BLADERF_SERIAL_LENGTH + 1];
+    float hysteresis_db;
+
+    /** Largest gain change made at once, in dB. Must be at least 1. */
+    int max_step;
 
     /**
-     * Reserved for future metadata. Should be 0's.
+     * Fraction of clipped samples, from 0 to 1, above which the gain is
+     * reduced by `max_step` regardless of the mean power
      */
-    char reserved[BLADERF_IMAGE_RESERVED_LEN];
+    float clip_fraction;
 
     /**
-     * Type of data contained in the image. Serialized as a uint32_t.
+     * Number of samples per channel excluded from gain decisions once a
+     * change takes effect, while the gain settles
      */
-    bladerf_image_type type;
+    unsigned int settle_samples;
 
     /**
-     * Address of the flash data in this image. A value of `0xffffffff`
-     * implies that this field is left unspecified (i.e., "don't care").
+     * With the RX metadata formats, the number of samples per channel by
+     * which a gain change is scheduled after the last sample it was decided
+     * on. This must cover the time taken to hand the change to the device.
      */
-    uint32_t address;
+    unsigned int lead_samples;
+};
 
-    /** Length of the data contained in the image */
-    uint32_t length;
+/**
+ * Enable or disable the synchronous RX interface's AGC for a channel in
+ * manual gain mode.
+ *
+ * While enabled, each bladerf_sync_rx() or bladerf_sync_rx_multi() call that
+ * returns samples of the channel decides, from the statistics already
+ * gathered while copying them (see bladerf_set_sync_rx_stats()), whether to
+ * move its gain toward `target_dbfs`. The decision is made in the calling
+ * thread as the call returns, without another pass over the samples.
+ *
+ * With the RX metadata formats, a change is scheduled via
+ * bladerf_schedule_gain() at `lead_samples` past the returned samples, so
+ * that it applies at a known sample. Otherwise, or where scheduled gain
+ * changes are unsupported (e.g., on the bladeRF x40/x115), the gain is set
+ * before the call returns. Either way, the first call returning samples
+ * affected by a change reports ::BLADERF_META_STATUS_GAIN_CHANGE, if a
+ * bladerf_metadata structure is provided.
+ *
+ * The gain changed by the AGC is reported by bladerf_get_gain() once it has
+ * been applied. Setting the gain by other means while the AGC is enabled
+ * is not supported. The AGC is disabled by bladerf_close().
+ *
+ * @pre Statistics were enabled via bladerf_set_sync_rx_stats() prior to the
+ *      last bladerf_sync_config() call for the RX direction. Otherwise, no
+ *      decisions are made.
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          RX channel
+ * @param[in]   config      AGC configuration, or NULL to disable it
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL for an invalid channel or configuration, or if
+ *         the channel is not in manual gain mode (::BLADERF_GAIN_MGC),
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_sync_rx_agc(struct bladerf *dev,
+                                      bladerf_channel ch,
+                                      const struct bladerf_sync_rx_agc *config);
 
-    /** Image data */
-    uint8_t *data;
-};
+/**
+ * Start the synchronous interface's stream ahead of the first transfer.
+ *
+ * Otherwise, the first bladerf_sync_rx() or bladerf_sync_tx() call after
+ * bladerf_sync_config() (or after a stream error) starts a worker thread,
+ * waits for it to start the underlying stream, and, for RX, submits the
+ * initial transfers. Calling this function beforehand moves that work out of
+ * the first transfer, such that it returns with little added latency.
+ *
+ * For RX, the initial transfers are submitted immediately. If the RX
+ * channels are enabled later, via bladerf_enable_module(), those transfers
+ * wait for samples, and fail if none arrive within the transfer timeout.
+ * This is the `stream_timeout` passed to bladerf_sync_config(), or 1 second
+ * if that is shorter.
+ * Since enabling a channel requires several control transfers, applications
+ * that receive in short, precisely timed windows may prefer to leave the
+ * channels enabled and request samples by timestamp with a metadata format.
+ *
+ * This has no effect if the stream is already running.
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Direction configured via bladerf_sync_config()
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if the direction has not been configured,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_prearm(struct bladerf *dev, bladerf_direction dir);
+
+/**
+ * Readiness notification object of the synchronous interface.
+ *
+ * On Windows this is an event `HANDLE`, suitable for WaitForMultipleObjects().
+ * Elsewhere it is a file descriptor, suitable for poll(), epoll, kqueue and
+ * the like, which becomes readable.
+ */
+#ifdef _WIN32
+typedef void *bladerf_ready_fd;
+#else
+typedef int bladerf_ready_fd;
+#endif
+
+/**
+ * Get a notification object that is signalled when the synchronous interface
+ * may be able to make progress: when a buffer is filled (RX), a buffer is
+ * emptied (TX), or the underlying stream fails.
+ *
+ * This allows a single event loop to service several devices and directions
+ * via bladerf_sync_rx_nb() and bladerf_sync_tx_nb(). It is signalled when
+ * first created. Once signalled, it remains so until a non-blocking call for
+ * the same direction returns ::BLADERF_ERR_WOULD_BLOCK. Callers should
+ * therefore keep calling bladerf_sync_rx_nb() or bladerf_sync_tx_nb() until
+ * one does so before waiting on it again, and should not read from it
+ * themselves.
+ *
+ * It is owned by the library, and remains valid until the next
+ * bladerf_sync_config() call for the same direction, or bladerf_close().
+ * Subsequent calls return the same object.
+ *
+ * @pre A bladerf_sync_config() call has been made for the direction.
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Direction configured via bladerf_sync_config()
+ * @param[out]  fd          Notification object
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if the direction has not been configured,
+ *         ::BLADERF_ERR_IO if the object could not be created,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_get_ready_fd(struct bladerf *dev,
+                                        bladerf_direction dir,
+                                        bladerf_ready_fd *fd);
+
+/**
+ * Non-blocking variant of bladerf_sync_rx().
+ *
+ * For the formats without metadata, this returns ::BLADERF_ERR_WOULD_BLOCK,
+ * without consuming any samples, unless the entire request can be satisfied
+ * from buffers that have already been received. Requests should therefore
+ * not exceed the `num_buffers - num_transfers` buffers the stream can hold.
+ *
+ * For the metadata formats, the number of buffers needed depends upon the
+ * requested timestamp. Buffers preceding it are discarded as they arrive.
+ * Once samples have been copied, a request that would have to wait returns
+ * early, with the number of samples provided in
+ * bladerf_metadata::actual_count. If no samples could be provided,
+ * ::BLADERF_ERR_WOULD_BLOCK is returned.
+ *
+ * The first call after bladerf_sync_config() starts the underlying stream,
+ * which may take a few milliseconds. Use bladerf_sync_prearm() to do so
+ * ahead of time.
+ *
+ * @param       dev         Device handle
+ * @param[out]  samples     Buffer to store samples in, as with
+ *                          bladerf_sync_rx()
+ * @param[in]   num_samples Number of samples to read
+ * @param[out]  metadata    Sample metadata, as with bladerf_sync_rx()
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_WOULD_BLOCK if the call would have to wait to
+ *         receive samples,
+ *         ::BLADERF_ERR_UNSUPPORTED in RX buffer pool mode,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_rx_nb(struct bladerf *dev,
+                                 void *samples,
+                                 unsigned int num_samples,
+                                 struct bladerf_metadata *metadata);
+
+/**
+ * Non-blocking variant of bladerf_sync_tx().
+ *
+ * This returns ::BLADERF_ERR_WOULD_BLOCK, without buffering any samples or
+ * acting upon any metadata flags, unless there is enough free buffer space
+ * to accept the entire request. This includes any zero padding requested via
+ * ::BLADERF_META_FLAG_TX_UPDATE_TIMESTAMP, and, for
+ * ::BLADERF_META_FLAG_TX_BURST_END, an additional buffer to allow for the
+ * end of the burst being flushed. Requests should therefore not exceed the
+ * `num_buffers - 1` buffers the stream can hold.
+ *
+ * The first call after bladerf_sync_config() starts the underlying stream,
+ * which may take a few milliseconds. Use bladerf_sync_prearm() to do so
+ * ahead of time.
+ *
+ * @param       dev         Device handle
+ * @param[in]   samples     Array of samples
+ * @param[in]   num_samples Number of samples to write
+ * @param[in]   metadata    Sample metadata, as with bladerf_sync_tx()
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_WOULD_BLOCK if the call would have to wait for
+ *         buffer space,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sync_tx_nb(struct bladerf *dev,
+                                 const void *samples,
+                                 unsigned int num_samples,
+                                 struct bladerf_metadata *metadata);
+
+/**
+ * Request a size for the RX metadata messages used by the synchronous
+ * interface.
+ *
+ * By default, every DMA buffer (2048 bytes at SuperSpeed, 1024 bytes at
+ * HighSpeed) is a separate message beginning with a 16-byte metadata header.
+ * With ::BLADERF_CAP_FPGA_RX_META_MSG_SIZE, a message may instead span 2, 4,
+ * or 8 DMA buffers with a single header, reducing header overhead and the
+ * per-message work done by the host.
+ *
+ * bladerf_sync_config() for the RX direction uses the largest supported size
+ * that does not exceed `size` and evenly divides the stream buffers. Messages
+ * are kept to a single DMA buffer for ::BLADERF_FORMAT_PACKET_META, packed
+ * formats, and streams whose buffer size is selected automatically. Use
+ * bladerf_get_sync_rx_meta_msg_size() to query the size in use.
+ *
+ * Since timestamps are reported once per message, larger messages also
+ * coarsen the granularity at which discontinuities are detected.
+ *
+ * This setting is latched by the next bladerf_sync_config() call for the RX
+ * direction; it does not affect an already-configured stream.
+ *
+ * @param       dev         Device handle
+ * @param[in]   size        Requested message size in bytes, or 0 for the
+ *                          default of one DMA buffer
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if the device or FPGA cannot produce
+ *         messages larger than a DMA buffer,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_sync_rx_meta_msg_size(struct bladerf *dev,
+                                                unsigned int size);
+
+/**
+ * Get the size of the RX metadata messages used by the synchronous interface
+ *
+ * This is the size selected by the last successful bladerf_sync_config() call
+ * for the RX direction, or the default of one DMA buffer if RX has not been
+ * configured.
+ *
+ * @param       dev         Device handle
+ * @param[out]  size        Message size in bytes
+ *
+ * @return 0 on success, or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_sync_rx_meta_msg_size(struct bladerf *dev,
+                                                unsigned int *size);
+
+/**
+ * Schedule the FPGA to start delivering RX samples at a timestamp
+ *
+ * Normally, a bladerf_sync_rx() call for a future timestamp receives and
+ * discards every sample up to that timestamp. With ::BLADERF_CAP_FPGA_RX_GATE,
+ * the FPGA can instead hold samples back until the RX timestamp reaches
+ * `timestamp`, and optionally stop again after `num_samples`, so the USB link
+ * and host only carry the samples that are wanted.
+ *
+ * Call this before enabling the RX module, or while no samples are wanted,
+ * then call bladerf_sync_rx() with ::BLADERF_FORMAT_SC16_Q11_META and
+ * `timestamp` as the metadata timestamp. The gate opens a few samples early,
+ * so the first message starts at or just before `timestamp`. The stream
+ * timeout must cover the wait for `timestamp`.
+ *
+ * Samples reach the host in whole messages. A message that is only partly
+ * filled when the count runs out stays in the FPGA, and is dropped when the
+ * RX module is disabled, so request enough samples to fill the last message
+ * that is needed. Alternatively, use a count of 0 and cancel the schedule
+ * once done.
+ *
+ * Scheduling again replaces a pending schedule. The gate applies to all RX
+ * channels at once; with multiple channels, `num_samples` is per channel.
+ *
+ * @param       dev         Device handle
+ * @param[in]   timestamp   RX timestamp of the first sample wanted
+ * @param[in]   num_samples Number of samples to deliver per channel, or 0 to
+ *                          deliver samples until the schedule is cancelled
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if the FPGA does not have the RX gate,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_schedule_rx(struct bladerf *dev,
+                                  bladerf_timestamp timestamp,
+                                  unsigned int num_samples);
+
+/**
+ * Schedule the FPGA to deliver a burst of RX samples at a regular interval
+ *
+ * For monitoring that only needs short snapshots, e.g. 4096 samples every
+ * 10 ms, this avoids both streaming continuously and enabling and disabling
+ * RX for each snapshot. With ::BLADERF_CAP_FPGA_RX_BURSTS, the FPGA passes
+ * `burst_len` samples from `timestamp`, then again from each multiple of
+ * `period` samples after it, and holds back everything in between.
+ *
+ * Each burst reaches the host as one or more whole metadata messages, so
+ * `burst_len` must be a whole number of messages. Read a burst with
+ * bladerf_sync_rx() and ::BLADERF_META_FLAG_RX_NOW: the metadata timestamp
+ * is that of the burst's first sample. Configure the stream with
+ * ::BLADERF_FORMAT_SC16_Q11_META, a buffer size of whole bursts, and a
+ * timeout longer than `period`, before calling this function, so the burst
+ * length can be checked against the message size.
+ *
+ * Use bladerf_cancel_rx_schedule() to stop the bursts. Scheduling again
+ * replaces the current schedule.
+ *
+ * @param       dev         Device handle
+ * @param[in]   timestamp   RX timestamp of the first burst
+ * @param[in]   burst_len   Number of samples per channel in each burst
+ * @param[in]   period      Number of samples from the start of one burst to
+ *                          the start of the next. This must be at least
+ *                          `burst_len`.
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if the FPGA does not support RX bursts,
+ *         ::BLADERF_ERR_INVAL if `burst_len` is not a whole number of
+ *         messages or exceeds `period`,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_schedule_rx_bursts(struct bladerf *dev,
+                                         bladerf_timestamp timestamp,
+                                         unsigned int burst_len,
+                                         unsigned int period);
+
+/**
+ * Cancel an RX schedule and deliver all RX samples again
+ *
+ * @param       dev         Device handle
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if the FPGA does not have the RX gate,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_cancel_rx_schedule(struct bladerf *dev);
+
+
+/** @} (End of FN_STREAMING_SYNC) */
+
+/**
+ * @defgroup FN_STREAMING_ASYNC    Asynchronous API
+ *
+ * This interface gives the API user full control over the stream and buffer
+ * management, at the cost of added complexity.
+ *
+ * @note New users are recommended to first evaluate the \ref FN_STREAMING_SYNC
+ *       interface, and to only use this interface if the former is found to not
+ *       yield suitable performance.
+ *
+ * These functions are either thread-safe or may be used in a thread-safe
+ * manner (per the details noted in the function description).
+ *
+ * @{
+ */
+
+/**
+ * Use this as a return value in callbacks or as the buffer parameter to
+ * bladerf_submit_stream_buffer() to shutdown a stream.
+ */
+#define BLADERF_STREAM_SHUTDOWN (NULL)
+
+/**
+ * Use this value in a stream callback to indicate that no buffer is being
+ * provided. In this case, buffers are expected to be provided via
+ * bladerf_submit_stream_buffer().
+ */
+#define BLADERF_STREAM_NO_DATA ((void *)(-1))
+
+/** This opaque structure is used to keep track of stream information */
+struct bladerf_stream;
+
+/**
+ * This typedef represents a callback function that is executed in response to
+ * this interface's asynchronous events.
+ *
+ * Stream callbacks <b>must not</b> block or perform long-running operations.
+ * Otherwise, timeouts may occur. If this cannot be guaranteed, consider
+ * returning ::BLADERF_STREAM_NO_DATA in callbacks and later submit a buffer
+ * using bladerf_submit_stream_buffer(). However, callbacks should always take
+ * a single approach of returning buffers <b>or</b> returning
+ * ::BLADERF_STREAM_NO_DATA and submitting buffers later -- <b>but not both</b>.
+ *
+ * When running in a full-duplex mode of operation with simultaneous TX and RX
+ * stream threads, be aware that one stream's callback may occur in the context
+ * of another stream's thread. The API user is responsible for ensuring their
+ * callbacks are thread safe. For example, when managing access to sample
+ * buffers, the caller must ensure that if one thread is processing samples in a
+ * buffer, that this buffer is not returned via the callback's return value.
+ *
+ * As of libbladeRF v0.15.0, is guaranteed that only one callback from a stream
+ * will occur at a time. (i.e., a second TX callback will not fire while one is
+ * currently being handled.)
+ *
+ * Callbacks for completed buffers are invoked without the per-stream lock held,
+ * so other threads may call bladerf_submit_stream_buffer() or query the stream
+ * while a callback executes, rather than stalling until it returns. A buffer
+ * provided to a callback is not reused by the library until that callback
+ * returns. Callbacks made with a NULL `samples` pointer, to obtain the initial
+ * TX buffers, are still made with the per-stream lock held. It is important to
+ * consider this when thinking about the order of lock acquisitions both in the
+ * callbacks, and the code surrounding bladerf_submit_stream_buffer().
+ *
+ * @note Do not call bladerf_submit_stream_buffer() from a callback.
+ *
+ * For both RX and TX, the stream callback receives:
+ *  - dev:          Device structure
+ *  - stream:       The associated stream
+ *  - metadata:     For future support - do not attempt to read/write this
+ *                  in the current library implementation.
+ *  - user_data:    User data provided when initializing stream
+ *
+ * For TX callbacks:
+ *  - samples:      Pointer to buffer of samples that was sent
+ *  - num_samples:  Number of sent in last transfer and to send in next transfer
+ *  - Return value: The user specifies the address of the next buffer to send,
+ *                  ::BLADERF_STREAM_SHUTDOWN, or ::BLADERF_STREAM_NO_DATA.
+ *
+ * For RX callbacks:
+ *  - samples:          Buffer filled with received data
+ *  - num_samples:      Number of samples received and size of next buffers
+ *  - Return value:     The user specifies the next buffer to fill with RX data,
+ *                      which should be `num_samples` in size,
+ *                      ::BLADERF_STREAM_SHUTDOWN, or ::BLADERF_STREAM_NO_DATA.
+ */
+typedef void *(*bladerf_stream_cb)(struct bladerf *dev,
+                                   struct bladerf_stream *stream,
+                                   struct bladerf_metadata *meta,
+                                   void *samples,
+                                   size_t num_samples,
+                                   void *user_data);
+
+/**
+ * A completed buffer, as provided to a ::bladerf_stream_batch_cb
+ */
+struct bladerf_stream_buffer {
+    void *samples;      /**< Buffer that was sent (TX) or filled (RX) */
+    size_t num_samples; /**< Number of samples transferred */
+
+    /**
+     * Metadata associated with the transfer, as would have been provided
+     * to a ::bladerf_stream_cb
+     */
+    struct bladerf_metadata meta;
+};
+
+/**
+ * Callback for streams initialized via bladerf_init_stream_batch().
+ *
+ * Rather than being invoked for each completed transfer while the
+ * per-stream lock is held, this is invoked from the thread running
+ * bladerf_stream(), without the per-stream lock held, with all of the buffers
+ * completed since the previous invocation. Time-consuming processing may
+ * therefore be performed here without stalling the USB event handling, at
+ * the expense of fewer transfers being in flight while it runs.
+ *
+ * The callback provides the buffers to submit next by writing their
+ * addresses to `next`, in the order they are to be transferred, and returns
+ * how many it wrote. At most `max_next` may be provided, which is the number
+ * of transfers that have become available. ::BLADERF_STREAM_SHUTDOWN may be
+ * written to `next` to end the stream, after which no further entries are
+ * read.
+ *
+ * For a TX stream, the first invocation occurs with no completed buffers, in
+ * order to obtain the initial buffers to transmit.
+ *
+ * If no buffers are provided while none are in flight, the stream idles until
+ * a buffer is submitted via bladerf_submit_stream_buffer().
+ *
+ * @param       dev             Device structure
+ * @param       stream          The associated stream
+ * @param[in]   completed       Completed buffers, oldest first
+ * @param[in]   num_completed   Number of entries in `completed`
+ * @param[out]  next            Buffers to submit
+ * @param[in]   max_next        Capacity of `next`
+ * @param       user_data       User data provided when initializing stream
+ *
+ * @return Number of entries written to `next`
+ */
+typedef size_t (*bladerf_stream_batch_cb)(
+    struct bladerf *dev,
+    struct bladerf_stream *stream,
+    const struct bladerf_stream_buffer *completed,
+    size_t num_completed,
+    void **next,
+    size_t max_next,
+    void *user_data);
+
+/**
+ * Initialize a stream for use with asynchronous routines.
+ *
+ * This function will internally allocate data buffers, which will be provided
+ * to the API user in callback functions.
+ *
+ * The `buffers` output parameter populates a pointer to the list of allocated
+ * buffers. This allows the API user to implement a buffer management scheme to
+ * best suit his or her specific use case.
+ *
+ * Generally, one will want to set the `buffers` parameter to a value larger
+ * than the `num_transfers` parameter, and keep track of which buffers are
+ * currently "in-flight", versus those available for use.
+ *
+ * For example, for a transmit stream, modulated data can be actively written
+ * into free buffers while transfers of other buffers are occurring. Once a
+ * buffer has been filled with data, it can be marked 'in-flight' and be
+ * returned in a successive callback to transmit.
+ *
+ * The choice of values for the `num_transfers` and `buffer_size` should be
+ * made based upon the desired samplerate, and the stream timeout value
+ * specified via bladerf_set_stream_timeout(), which defaults to 1 second.
+ *
+ * For a given sample rate, the below relationship must be upheld to transmit or
+ * receive data without timeouts or dropped data.
+ *
+ * @f[
+ * Sample\ Rate > \frac{\#\ Transfers}{Timeout} \times Buffer\ Size
+ * @f]
+ *
+ * ...where Sample Rate is in samples per second, and Timeout is in seconds.
+ *
+ * To account for general system overhead, it is recommended to multiply the
+ * righthand side by 1.1 to 1.25.
+ *
+ * While increasing the number of buffers available provides additional
+ * elasticity, be aware that it also increases latency.
+ *
+ * For low-latency applications, such as control loops, the
+ * ::BLADERF_FORMAT_SC16_Q11 and ::BLADERF_FORMAT_SC8_Q7 formats permit
+ * buffers as short as a single 1 KiB USB packet: 256 and 512 samples,
+ * respectively. Other formats require multiples of 1024 samples. Short buffers
+ * should be paired with many transfers (e.g., 32 to 64) to keep the bus busy,
+ * per the relationship above. Note that the FX3 still moves samples in DMA
+ * blocks of two packets at SuperSpeed, which bounds the latency achievable
+ * with the shortest buffers.
+ *
+ * @param[out]  stream          Upon success, this will be updated to contain
+ *                              a stream handle (i.e., address)
+ * @param       dev             Device to associate with the stream
+ * @param[in]   callback        Callback routine to handle asynchronous events
+ * @param[out]  buffers         This will be updated to point to a dynamically
+ *                              allocated array of buffer pointers.
+ * @param[in]   num_buffers     Number of buffers to allocate and return. This
+ *                              value must >= the `num_transfers` parameter.
+ * @param[in]   format          Sample data format
+ * @param[in]   samples_per_buffer  Size of allocated buffers, in units of
+ *                                  samples Note that the physical size of the
+ *                                  buffer is a function of this and the format
+ *                                  parameter. See above for the permitted
+ *                                  sizes.
+ * @param[in]   num_transfers   Maximum number of transfers that may be
+ *                              in-flight simultaneously. This must be <= the
+ *                              `num_buffers` parameter.
+ * @param[in]   user_data       Caller-provided data that will be provided
+ *                              in stream callbacks
+ *
+ * @note  This call should be later followed by a call to
+ *        bladerf_deinit_stream() to avoid memory leaks.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_init_stream(struct bladerf_stream **stream,
+                                  struct bladerf *dev,
+                                  bladerf_stream_cb callback,
+                                  void ***buffers,
+                                  size_t num_buffers,
+                                  bladerf_format format,
+                                  size_t samples_per_buffer,
+                                  size_t num_transfers,
+                                  void *user_data);
+
+/**
+ * Initialize a stream whose completed buffers are delivered in batches to a
+ * ::bladerf_stream_batch_cb.
+ *
+ * All parameters are as described for bladerf_init_stream(), apart from
+ * `callback`. The stream is otherwise used in the same manner.
+ *
+ * The ::BLADERF_FORMAT_PACKET_META format is not supported by this mode.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_init_stream_batch(struct bladerf_stream **stream,
+                                        struct bladerf *dev,
+                                        bladerf_stream_batch_cb callback,
+                                        void ***buffers,
+                                        size_t num_buffers,
+                                        bladerf_format format,
+                                        size_t samples_per_buffer,
+                                        size_t num_transfers,
+                                        void *user_data);
+
+/**
+ * Initialize a stream whose buffers are obtained from a caller-provided
+ * allocator.
+ *
+ * All other parameters are as described for bladerf_init_stream().
+ *
+ * @param[in]   allocator   Buffer allocator, which is copied. NULL selects
+ *                          the default allocation, as with
+ *                          bladerf_init_stream().
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `allocator` lacks an `alloc` function,
+ *         ::BLADERF_ERR_MEM if the allocator fails,
+ *         or a value from \ref RETCODES list on other failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_init_stream_with_allocator(
+    struct bladerf_stream **stream,
+    struct bladerf *dev,
+    bladerf_stream_cb callback,
+    void ***buffers,
+    size_t num_buffers,
+    bladerf_format format,
+    size_t samples_per_buffer,
+    size_t num_transfers,
+    void *user_data,
+    const struct bladerf_buffer_allocator *allocator);
+
+/**
+ * Begin running a stream. This call will block until the stream completes.
+ *
+ * Only 1 RX stream and 1 TX stream may be running at a time. Attempting to
+ * call bladerf_stream() with more than one stream will yield unexpected (and
+ * most likely undesirable) results.
+ *
+ * @note See the ::bladerf_stream_cb description for additional thread-safety
+ *       caveats.
+ *
+ * @pre This function should be preceded by a call to bladerf_enable_module()
+ *      to enable the associated RX or TX directions before attempting to use
+ *      it to stream data.
+ *
+ * @param      stream   A stream handle that has been successfully been
+ *                      initialized via bladerf_init_stream()
+ * @param[in]  layout   Stream direction and channel layout
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_stream(struct bladerf_stream *stream,
+                             bladerf_channel_layout layout);
+
+/**
+ * Submit a buffer to a stream from outside of a stream callback function.
+ * Use this only when returning BLADERF_STREAM_NO_DATA from callbacks. <b>Do
+ * not</b> use this function if the associated callback functions will be
+ * returning buffers for submission.
+ *
+ * This call may block if the device is not ready to submit a buffer for
+ * transfer. Use the `timeout_ms` to place an upper limit on the time this
+ * function can block.
+ *
+ * To safely submit buffers from outside the stream callback flow, this function
+ * internally acquires a per-stream lock (the same one that is held during the
+ * execution of a stream callback). Therefore, it is important to be aware of
+ * locks that may be held while making this call, especially those acquired
+ * during execution of the associated stream callback function. (i.e., be wary
+ * of the order of lock acquisitions, including the internal per-stream lock.)
+ *
+ * @param           stream      Stream to submit buffer to
+ * @param[inout]    buffer      Buffer to fill (RX) or containing data (TX).
+ *                              This buffer is assumed to be the size specified
+ *                              in the associated bladerf_init_stream() call.
+ * @param[in]       timeout_ms  Milliseconds to timeout in, if this call blocks.
+ *                              0 implies an "infinite" wait.
+ *
+ * @return 0 on success, ::BLADERF_ERR_TIMEOUT upon a timeout, or a value from
+ *         \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_submit_stream_buffer(struct bladerf_stream *stream,
+                                           void *buffer,
+                                           unsigned int timeout_ms);
+
+/**
+ * This is a non-blocking variant of bladerf_submit_stream_buffer(). All of the
+ * caveats and important notes from bladerf_submit_stream_buffer() apply.
+ *
+ * In the event that this call would need to block in order to submit a buffer,
+ * it returns BLADERF_ERR_WOULD_BLOCK. In this case, the caller could either
+ * wait and try again or defer buffer submission to the asynchronous callback.
+ *
+ * @param           stream      Stream to submit buffer to
+ * @param[inout]    buffer      Buffer to fill (RX) or containing data (TX).
+ *                              This buffer is assumed to be the size specified
+ *                              in the associated bladerf_init_stream() call.
+ *
+ * @return  0 on success, ::BLADERF_ERR_WOULD_BLOCK if the call would have to
+ *          block to succeed, or another value from \ref RETCODES upon other
+ *          failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_submit_stream_buffer_nb(struct bladerf_stream *stream,
+                                              void *buffer);
+
+
+/**
+ * Deinitialize and deallocate stream resources.
+ *
+ * @pre  Stream is no longer being used (via bladerf_submit_stream_buffer() or
+ *       bladerf_stream() calls.)
+ *
+ * @post Stream is deallocated and may no longer be used.
+ *
+ * @param   stream  Stream to deinitialize. This function does nothing if
+ *                  stream is `NULL`.
+ */
+API_EXPORT
+void CALL_CONV bladerf_deinit_stream(struct bladerf_stream *stream);
+
+/**
+ * Set stream transfer timeout in milliseconds
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Stream direction
+ * @param[in]   timeout     Timeout in milliseconds
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_stream_timeout(struct bladerf *dev,
+                                         bladerf_direction dir,
+                                         unsigned int timeout);
+
+/**
+ * Get transfer timeout in milliseconds
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Stream direction
+ * @param[out]  timeout     On success, updated with current transfer
+ *                          timeout value. Undefined on failure.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_stream_timeout(struct bladerf *dev,
+                                         bladerf_direction dir,
+                                         unsigned int *timeout);
+
+/**
+ * Set the scheduling attributes to apply to the thread that calls
+ * bladerf_stream() for the provided stream. They are applied when
+ * bladerf_stream() is called, and remain in effect on that thread after it
+ * returns.
+ *
+ * Failure to apply an attribute (e.g., due to insufficient privileges) is not
+ * fatal; a warning is logged and the stream proceeds without it.
+ *
+ * @param       stream      Stream to configure
+ * @param[in]   attrs       Thread attributes. NULL clears any previously
+ *                          provided attributes.
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `attrs` contains invalid values,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_stream_set_thread_attrs(
+    struct bladerf_stream *stream,
+    const struct bladerf_thread_attrs *attrs);
+
+/** @} (End of FN_STREAMING_ASYNC) */
+
+/**
+ * @defgroup FN_RELAY    RX to TX relay
+ *
+ * A relay retransmits received samples with minimal, fixed latency, as
+ * required by repeaters and channel emulators. It runs an RX stream and a TX
+ * stream that share a single set of buffers: each buffer filled by the RX
+ * stream is submitted, as is, to the TX stream, and is returned to the RX
+ * stream once it has been sent. Samples are therefore neither copied nor
+ * handed between user threads.
+ *
+ * An optional processing callback may modify each buffer's samples in place
+ * before they are transmitted.
+ *
+ * With the ::BLADERF_FORMAT_SC16_Q11_META and ::BLADERF_FORMAT_SC8_Q7_META
+ * formats, each message is scheduled for transmission at its RX timestamp
+ * plus bladerf_relay_config::tx_delay, so the RX to TX latency is exactly
+ * that many samples regardless of host scheduling, provided it covers the
+ * time taken to fill, process, and send a buffer. This requires the RX and
+ * TX timestamp counters to be aligned, and RX metadata messages of one DMA
+ * buffer (see bladerf_set_sync_rx_meta_msg_size()). Without metadata,
+ * samples are transmitted as soon as they reach the device.
+ *
+ * The RX and TX channels must be enabled via bladerf_enable_module() before
+ * running the relay, and neither direction may be used otherwise while it
+ * runs.
+ *
+ * @{
+ */
+
+/** Relay handle */
+struct bladerf_relay;
+
+/**
+ * In-place processing callback for a relay
+ *
+ * This is invoked from the thread running bladerf_relay_run(), for each run
+ * of contiguous samples before it is retransmitted: once per buffer without
+ * metadata, or once per message with it. It should return promptly, as the
+ * next buffer is not received until it does.
+ *
+ * @param       dev         Device handle
+ * @param[inout] samples    Received samples, to be modified in place
+ * @param[in]   num_samples Number of samples
+ * @param[in]   timestamp   RX timestamp of the first sample, or 0 for
+ *                          formats without metadata
+ * @param       user_data   bladerf_relay_config::user_data
+ */
+typedef void (*bladerf_relay_cb)(struct bladerf *dev,
+                                 void *samples,
+                                 size_t num_samples,
+                                 bladerf_timestamp timestamp,
+                                 void *user_data);
+
+/**
+ * Relay configuration
+ */
+struct bladerf_relay_config {
+    /** ::BLADERF_FORMAT_SC16_Q11, ::BLADERF_FORMAT_SC8_Q7, or their _META
+     *  variants */
+    bladerf_format format;
+
+    /** Number of channels per direction: 1, or 2 on the bladeRF2 */
+    unsigned int num_channels;
+
+    /** Number of shared buffers. This must exceed twice `num_transfers`. */
+    size_t num_buffers;
+
+    /** Size of each buffer, in samples, as with bladerf_init_stream() */
+    size_t samples_per_buffer;
+
+    /** Number of transfers in flight in each direction */
+    size_t num_transfers;
+
+    /** Stream timeout, in milliseconds. A buffer that cannot be submitted
+     *  to TX within this time ends the relay. */
+    unsigned int timeout_ms;
+
+    /** With metadata, the delay between a sample's reception and its
+     *  transmission, in samples. 0 transmits each message as soon as it
+     *  reaches the device. Ignored without metadata. */
+    uint64_t tx_delay;
+
+    /** In-place processing callback. May be NULL. */
+    bladerf_relay_cb process;
+
+    /** User data passed to `process` */
+    void *user_data;
+};
+
+/**
+ * Create a relay
+ *
+ * @param[out]  relay       Set to the relay handle on success
+ * @param       dev         Device handle
+ * @param[in]   config      Relay configuration, which is copied
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL for an invalid configuration,
+ *         ::BLADERF_ERR_UNSUPPORTED if RX metadata messages span more than
+ *         one DMA buffer,
+ *         or a value from \ref RETCODES list on other failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_relay_init(struct bladerf_relay **relay,
+                                 struct bladerf *dev,
+                                 const struct bladerf_relay_config *config);
+
+/**
+ * Run a relay. This blocks until bladerf_relay_stop() is called or a stream
+ * fails.
+ *
+ * A relay may only be run once. Create another to resume relaying.
+ *
+ * @param       relay       Relay handle
+ *
+ * @return 0 if the relay was stopped via bladerf_relay_stop(),
+ *         ::BLADERF_ERR_INVAL if the relay has already been run,
+ *         ::BLADERF_ERR_TIMEOUT if TX did not accept a buffer within
+ *         bladerf_relay_config::timeout_ms,
+ *         or a value from \ref RETCODES list on other failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_relay_run(struct bladerf_relay *relay);
+
+/**
+ * Stop a running relay. bladerf_relay_run() returns after the buffer being
+ * received completes. This may be called from any thread, including from
+ * the processing callback.
+ *
+ * @param       relay       Relay handle
+ */
+API_EXPORT
+void CALL_CONV bladerf_relay_stop(struct bladerf_relay *relay);
+
+/**
+ * Free a relay that is not running
+ *
+ * @param       relay       Relay handle. This function does nothing if it is
+ *                          NULL.
+ */
+API_EXPORT
+void CALL_CONV bladerf_relay_deinit(struct bladerf_relay *relay);
+
+/** @} (End of FN_RELAY) */
+
+/**
+ * @defgroup FN_SWEEP    Spectrum sweeps
+ *
+ * A sweep steps RX channel 0 through a list of frequencies, capturing a
+ * fixed number of samples, the dwell, at each. Rather than retuning from the
+ * host and restarting RX for each step, it receives one continuous
+ * timestamped stream, and schedules a quick retune (see
+ * bladerf_schedule_retune()) at the first sample of each step via the
+ * channel's hop table. The device retunes on its own as the timestamps are
+ * reached, so the sweep rate is bounded by the PLL's settling time and the
+ * dwell, not by host round trips.
+ *
+ * The first samples of each step are received while the PLL settles. They
+ * are delivered along with the rest, and bladerf_sweep_block::settled marks
+ * the first sample that follows the configured settling time.
+ *
+ * The sweep configures the RX synchronous interface for
+ * ::BLADERF_FORMAT_SC16_Q11_META, enables RX channel 0 while it runs, and
+ * disables it afterwards. bladerf_sync_config() must be called again before
+ * receiving samples by other means, which must not be done while the sweep
+ * runs. The channel's hop table is replaced by one of the swept frequencies,
+ * and freed once the sweep ends.
+ *
+ * The FPGA must support scheduled retunes. On the bladeRF 2.0 Micro, each
+ * swept frequency takes one of the limited number of fast lock profiles
+ * noted in bladerf_load_hop_table().
+ *
+ * @{
+ */
+
+/**
+ * Default time allowed for the PLL to settle after each retune, in
+ * microseconds
+ */
+#define BLADERF_SWEEP_DEFAULT_SETTLE_US 200
+
+/**
+ * Samples captured at one step of a sweep
+ */
+struct bladerf_sweep_block {
+    unsigned int index;           /**< Index into
+                                   *   bladerf_sweep_config::frequencies */
+    uint64_t pass;                /**< Number of complete passes through the
+                                   *   list before this step */
+    bladerf_frequency frequency;  /**< Center frequency, in Hz */
+    bladerf_timestamp timestamp;  /**< RX timestamp of `samples[0]`, at which
+                                   *   the retune to `frequency` was
+                                   *   scheduled */
+    const int16_t *samples;       /**< SC16 Q11 samples */
+    unsigned int num_samples;     /**< Number of samples. This is less than
+                                   *   the dwell if an overrun cut the step
+                                   *   short. */
+    unsigned int settled;         /**< Index of the first sample received
+                                   *   after the settling time */
+    uint32_t status;              /**< Metadata status flags, e.g.,
+                                   *   ::BLADERF_META_STATUS_OVERRUN */
+};
+
+/**
+ * Sweep block callback
+ *
+ * This is invoked from the thread running bladerf_sweep(), once per step, in
+ * order. The block's samples are only valid until it returns. It should
+ * return promptly, as samples queue up in the stream's buffers meanwhile.
+ *
+ * @param       dev         Device handle
+ * @param[in]   block       Captured block
+ * @param       user_data   bladerf_sweep_config::user_data
+ *
+ * @return 0 to continue the sweep, or any other value to end it
+ */
+typedef int (*bladerf_sweep_cb)(struct bladerf *dev,
+                                const struct bladerf_sweep_block *block,
+                                void *user_data);
+
+/**
+ * Sweep configuration
+ */
+struct bladerf_sweep_config {
+    /** Frequencies to step through, in Hz, in order */
+    const bladerf_frequency *frequencies;
+
+    /** Number of frequencies */
+    unsigned int num_frequencies;
+
+    /** Number of samples captured at each frequency */
+    unsigned int dwell;
+
+    /** Time allowed for the PLL to settle after each retune, in
+     *  microseconds. 0 selects ::BLADERF_SWEEP_DEFAULT_SETTLE_US. This must
+     *  be shorter than the dwell. */
+    unsigned int settle_us;
+
+    /** Number of passes through the list of frequencies. 0 sweeps until the
+     *  callback ends the sweep. */
+    uint64_t num_passes;
+
+    /** RX timeout, in milliseconds. 0 selects a default of 1 second. */
+    unsigned int timeout_ms;
+
+    /** Block callback. Must not be NULL. */
+    bladerf_sweep_cb callback;
+
+    /** User data passed to `callback` */
+    void *user_data;
+};
+
+/**
+ * Run a sweep. This blocks until the configured number of passes have been
+ * captured, the callback ends the sweep, or RX fails.
+ *
+ * Set the sample rate, bandwidth and gain of RX channel 0 beforehand.
+ *
+ * @param       dev         Device handle
+ * @param[in]   config      Sweep configuration
+ *
+ * @return 0 if the sweep ran to completion or was ended by the callback,
+ *         ::BLADERF_ERR_INVAL for an invalid configuration,
+ *         ::BLADERF_ERR_TIME_PAST if the host fell too far behind the
+ *         stream to capture a step,
+ *         or a value from \ref RETCODES list on other failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_sweep(struct bladerf *dev,
+                            const struct bladerf_sweep_config *config);
+
+/** @} (End of FN_SWEEP) */
+
+/**
+ * @defgroup FN_ADSB    ADS-B message stream
+ *
+ * The ADS-B FPGA image (the `adsb` build revision, for both the bladeRF
+ * x40/x115 and the bladeRF 2.0 Micro) demodulates and decodes Mode S
+ * downlink messages on RX channel 0 itself. In place of samples, its RX stream carries one
+ * 128-bit word per decoded message, so that monitoring takes a tiny fraction
+ * of the USB bandwidth and host CPU that streaming raw samples would.
+ *
+ * The image's message aggregator flushes the stream at least every 10 ms,
+ * padding it with all-zero words, so messages are delivered promptly even in
+ * quiet airspace. bladerf_adsb_rx() skips the padding, checks each
+ * message's parity, and delivers messages one at a time.
+ *
+ * Each word holds a message in bits 111 to 0, with the first bit received
+ * in bit 111. A 56-bit message occupies bits 111 to 56. Bits 127 to 112 are
+ * not interpreted. Over USB, the least significant byte of each word is
+ * sent first.
+ *
+ * Load the ADS-B image with bladerf_load_fpga(), tune RX channel 0 to
+ * ::BLADERF_ADSB_FREQUENCY at ::BLADERF_ADSB_SAMPLE_RATE, and set its gain,
+ * before calling bladerf_adsb_rx(). The FPGA mixes the 1090 MHz channel down
+ * from a quarter of the sample rate.
+ *
+ * The image does not timestamp individual messages. Each is tagged with the
+ * host time at which its buffer arrived instead, which trails its reception
+ * by at most the flush interval plus USB latency.
+ *
+ * @{
+ */
+
+/** RX frequency to tune to for the ADS-B image, in Hz */
+#define BLADERF_ADSB_FREQUENCY 1086000000
+
+/** RX sample rate to use with the ADS-B image, in samples per second */
+#define BLADERF_ADSB_SAMPLE_RATE 16000000
+
+/** Length of a long (112-bit) Mode S message, in bytes */
+#define BLADERF_ADSB_LONG_LEN 14
+
+/** Length of a short (56-bit) Mode S message, in bytes */
+#define BLADERF_ADSB_SHORT_LEN 7
+
+/**
+ * Decoded Mode S message
+ */
+struct bladerf_adsb_msg {
+    uint8_t data[BLADERF_ADSB_LONG_LEN]; /**< Message, with its first bit in
+                                          *   the MSB of `data[0]` */
+    unsigned int len;       /**< Message length, in bytes:
+                             *   ::BLADERF_ADSB_SHORT_LEN or
+                             *   ::BLADERF_ADSB_LONG_LEN */
+    unsigned int df;        /**< Downlink format, from the first 5 bits */
+    uint32_t address;       /**< 24-bit aircraft address. For DF11, DF17 and
+                             *   DF18, this is the AA field. For other
+                             *   formats, whose parity is overlaid with the
+                             *   address, it is recovered from the parity,
+                             *   and is only as reliable as the message. */
+    bool crc_ok;            /**< The parity was checked and is correct. This
+                             *   is only set for DF11, DF17 and DF18, the
+                             *   formats whose parity can be checked without
+                             *   knowing the address. */
+    uint64_t time_us;       /**< Host time at which the message arrived, in
+                             *   microseconds since the Unix epoch */
+};
+
+/**
+ * ADS-B message callback
+ *
+ * This is invoked from the thread running bladerf_adsb_rx(), once per
+ * message, in the order the messages were received.
+ *
+ * @param       dev         Device handle
+ * @param[in]   msg         Message, valid only until the callback returns
+ * @param       user_data   bladerf_adsb_config::user_data
+ *
+ * @return 0 to continue receiving, or any other value to stop
+ */
+typedef int (*bladerf_adsb_cb)(struct bladerf *dev,
+                               const struct bladerf_adsb_msg *msg,
+                               void *user_data);
+
+/**
+ * ADS-B reception configuration
+ */
+struct bladerf_adsb_config {
+    /** Only deliver messages with bladerf_adsb_msg::crc_ok set, dropping
+     *  those whose parity is incorrect or cannot be checked */
+    bool crc_ok_only;
+
+    /** RX timeout, in milliseconds. 0 selects a default of 1 second. As the
+     *  stream is flushed every 10 ms, a timeout indicates a problem with the
+     *  device or FPGA image, rather than quiet airspace. */
+    unsigned int timeout_ms;
+
+    /** Message callback. Must not be NULL. */
+    bladerf_adsb_cb callback;
+
+    /** User data passed to `callback` */
+    void *user_data;
+};
+
+/**
+ * Receive messages from the ADS-B FPGA image. This blocks until the
+ * callback stops reception, or RX fails.
+ *
+ * This configures the RX synchronous interface for ::BLADERF_FORMAT_SC16_Q11,
+ * enables RX channel 0 while it runs, and disables it afterwards.
+ * bladerf_sync_config() must be called again before receiving by other
+ * means.
+ *
+ * @param       dev         Device handle
+ * @param[in]   config      Reception configuration
+ *
+ * @return 0 if the callback stopped reception, ::BLADERF_ERR_INVAL for an
+ *         invalid configuration, or a value from \ref RETCODES list on other
+ *         failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_adsb_rx(struct bladerf *dev,
+                              const struct bladerf_adsb_config *config);
+
+/**
+ * Check a Mode S message's parity and fill in its derived fields
+ *
+ * bladerf_adsb_rx() calls this for each message. It is provided for
+ * decoding messages recorded from the stream by other means.
+ *
+ * @param[inout]    msg     Message, with bladerf_adsb_msg::data set. Its
+ *                          `len`, `df`, `address` and `crc_ok` fields are
+ *                          filled in.
+ */
+API_EXPORT
+void CALL_CONV bladerf_adsb_parse(struct bladerf_adsb_msg *msg);
+
+/** @} (End of FN_ADSB) */
+
+/**
+ * @defgroup FN_DEVICE_GROUP    Multi-device streaming
+ *
+ * A device group receives from several devices whose streams are started
+ * simultaneously by a shared trigger, with each device's samples delivered
+ * into its own buffer by a single bladerf_group_rx() call.
+ *
+ * The devices' trigger signals must be wired together, as described in
+ * \ref FN_TRIGGER_CONTROL, and the devices should share a reference clock so
+ * that their sample clocks do not drift apart. Each device is serviced by a
+ * dedicated reception thread, as well as the worker thread of its
+ * synchronous interface.
+ *
+ * Example usage:
+ *
+ * @code{.c}
+ *  const char *ids[] = { "*:serial=f12ce1", "*:serial=a83b9d" };
+ *  const int cpus[]  = { 2, 3 };
+ *  void *bufs[2];
+ *
+ *  status = bladerf_group_open(&group, ids, 2);
+ *
+ *  // Configure each device via bladerf_group_get_device(group, i)...
+ *
+ *  status = bladerf_group_sync_config(group, BLADERF_RX_X1,
+ *                                     BLADERF_FORMAT_SC16_Q11_META,
+ *                                     16, 8192, 8, 3500, cpus);
+ *
+ *  status = bladerf_group_start(group, 0, BLADERF_TRIGGER_J51_1);
+ *
+ *  while (status == 0 && running) {
+ *      status = bladerf_group_rx(group, bufs, 8192, &meta, 3500);
+ *      // bufs[i] now holds samples from device i, received at the same
+ *      // instant, starting at meta.timestamp on the master's timebase
+ *  }
+ *
+ *  bladerf_group_stop(group);
+ *  bladerf_group_close(group);
+ * @endcode
+ *
+ * These functions may not be called concurrently on the same group. Devices
+ * in the group may otherwise be used as usual, apart from their RX streams
+ * while the group is started.
+ *
+ * @{
+ */
+
+/** Device group handle */
+struct bladerf_group;
+
+/**
+ * Open a group of devices
+ *
+ * @param[out]  group       Set to the group handle on success
+ * @param[in]   device_ids  Device identifier strings, as with bladerf_open().
+ *                          These should each identify a distinct device.
+ * @param[in]   num_devices Number of devices
+ *
+ * @return 0 on success, or the error from the first device that could not be
+ *         opened, in which case no devices are left open.
+ */
+API_EXPORT
+int CALL_CONV bladerf_group_open(struct bladerf_group **group,
+                                 const char *const *device_ids,
+                                 unsigned int num_devices);
+
+/**
+ * Stop the group, if it is started, and close its devices
+ *
+ * @param       group       Group handle
+ */
+API_EXPORT
+void CALL_CONV bladerf_group_close(struct bladerf_group *group);
+
+/**
+ * Get a device of the group, for its configuration. The handle remains
+ * owned by the group.
+ *
+ * @param       group       Group handle
+ * @param[in]   index       Index of the device, in the order it was provided
+ *                          to bladerf_group_open()
+ *
+ * @return Device handle, or NULL if `index` is out of range
+ */
+API_EXPORT
+struct bladerf *CALL_CONV bladerf_group_get_device(struct bladerf_group *group,
+                                                   unsigned int index);
+
+/**
+ * Configure the synchronous RX interface of all devices in the group.
+ *
+ * The parameters are the same as those of bladerf_sync_config(). Only the
+ * ::BLADERF_FORMAT_SC16_Q11_META, ::BLADERF_FORMAT_SC8_Q7_META,
+ * ::BLADERF_FORMAT_CF32_META, ::BLADERF_FORMAT_SC12_PACKED_META,
+ * ::BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META and
+ * ::BLADERF_FORMAT_SC8_Q7_AS_CF32_META formats are supported, as the
+ * timestamps are required to keep the devices aligned.
+ *
+ * @param       group       Group handle
+ * @param[in]   layout      ::BLADERF_RX_X1 or ::BLADERF_RX_X2
+ * @param[in]   format      Sample format
+ * @param[in]   num_buffers Number of buffers per device
+ * @param[in]   buffer_size Size of each buffer, in samples
+ * @param[in]   num_transfers   Number of transfers per device
+ * @param[in]   stream_timeout  Stream timeout, in milliseconds
+ * @param[in]   cpus        Array of one CPU core per device, to which that
+ *                          device's reception and synchronous interface worker
+ *                          threads are pinned, or NULL to leave them unpinned.
+ *                          An entry of -1 leaves that device's threads
+ *                          unpinned. See bladerf_thread_attrs::cpu.
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if the format is not supported,
+ *         ::BLADERF_ERR_INVAL if the group is started or `layout` is not an
+ *         RX layout,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_group_sync_config(struct bladerf_group *group,
+                                        bladerf_channel_layout layout,
+                                        bladerf_format format,
+                                        unsigned int num_buffers,
+                                        unsigned int buffer_size,
+                                        unsigned int num_transfers,
+                                        unsigned int stream_timeout,
+                                        const int *cpus);
+
+/**
+ * Start receiving on all devices of the group at the same instant.
+ *
+ * The RX trigger of device `master` is configured as the master, and the
+ * others as slaves. Each device's RX channels are enabled with its trigger
+ * armed, which holds off its stream, and then the master's trigger is fired.
+ * The first sample of each device's stream therefore coincides, and is used
+ * to align the devices' timestamps.
+ *
+ * @pre bladerf_group_sync_config() has been called.
+ *
+ * @param       group       Group handle
+ * @param[in]   master      Index of the trigger master device
+ * @param[in]   signal      Trigger signal that the devices are wired to
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `master` is out of range or the group is
+ *         already started,
+ *         ::BLADERF_ERR_NOT_INIT if the group has not been configured,
+ *         or a value from \ref RETCODES list on failures.
+ */
+API_EXPORT
+int CALL_CONV bladerf_group_start(struct bladerf_group *group,
+                                  unsigned int master,
+                                  bladerf_trigger_signal signal);
+
+/**
+ * Receive time-aligned samples from all devices in the group.
+ *
+ * Each device receives `num_samples` samples, as with bladerf_sync_rx(),
+ * into its respective buffer. The devices receive concurrently on their
+ * reception threads.
+ *
+ * The samples in each buffer were taken at the same instant. If any device
+ * drops samples, the samples of the others are discarded until all devices
+ * are realigned, and the ::BLADERF_META_STATUS_OVERRUN flag is set in
+ * `metadata->status`.
+ *
+ * @param       group       Group handle
+ * @param[out]  samples     Array of one buffer per device
+ * @param[in]   num_samples Number of samples per device. For ::BLADERF_RX_X2,
+ *                          this includes the samples of both channels.
+ * @param[out]  metadata    Set with the master's timestamp of the first
+ *                          sample, the status flags reported by all devices,
+ *                          and an `actual_count` of `num_samples`. May be
+ *                          NULL.
+ * @param[in]   timeout_ms  Timeout for each device's reception, in
+ *                          milliseconds. Zero implies "infinite."
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_NOT_INIT if the group is not started,
+ *         ::BLADERF_ERR_UNEXPECTED if the devices could not be realigned,
+ *         or the error of the first device to fail.
+ */
+API_EXPORT
+int CALL_CONV bladerf_group_rx(struct bladerf_group *group,
+                               void *const *samples,
+                               unsigned int num_samples,
+                               struct bladerf_metadata *metadata,
+                               unsigned int timeout_ms);
+
+/**
+ * Stop the group's streams. The triggers are disarmed and the devices' RX
+ * channels are disabled.
+ *
+ * @param       group       Group handle
+ *
+ * @return 0 on success, or the first error encountered, in which case the
+ *         remaining devices are still stopped.
+ */
+API_EXPORT
+int CALL_CONV bladerf_group_stop(struct bladerf_group *group);
+
+/**
+ * Read the time at which each device of the group saw the trigger that
+ * started it, per bladerf_get_trigger_time()
+ *
+ * As the devices saw the same trigger, the differences between these times
+ * are the offsets between the devices' timestamp counters.
+ *
+ * @param       group       Group handle
+ * @param[out]  times       Array of one trigger time per device
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_NOT_INIT if the group is not started,
+ *         or the error of the first device to fail.
+ */
+API_EXPORT
+int CALL_CONV bladerf_group_get_trigger_times(
+    struct bladerf_group *group, struct bladerf_trigger_time *times);
+
+/** @} (End of FN_DEVICE_GROUP) */
+
+/**
+ * @defgroup FN_BROKER  RX sample broker
+ *
+ * Only one process may open a device. The broker allows other processes to
+ * consume the RX stream of a device opened by another: the process owning
+ * the device publishes the stream into a POSIX shared memory ring, from
+ * which any number of reader processes (up to ::BLADERF_BROKER_MAX_READERS)
+ * take buffers without the samples being copied.
+ *
+ * The publisher never waits on readers. Each reader has its own cursor into
+ * the ring, and a reader that falls behind by the full ring skips ahead to
+ * the most recent buffer, with ::BLADERF_META_STATUS_OVERRUN reported in the
+ * buffer's metadata. The samples are mapped read-only in readers.
+ *
+ * In the process owning the device:
+ *
+ * @code{.c}
+ *  status = bladerf_sync_config(dev, BLADERF_RX_X1,
+ *                               BLADERF_FORMAT_SC16_Q11_META,
+ *                               16, 8192, 8, 3500);
+ *  status = bladerf_enable_module(dev, BLADERF_CHANNEL_RX(0), true);
+ *
+ *  status = bladerf_broker_start(dev, &broker, NULL, BLADERF_RX_X1,
+ *                                BLADERF_FORMAT_SC16_Q11_META,
+ *                                64, 8192, 3500);
+ * @endcode
+ *
+ * In each reader process:
+ *
+ * @code{.c}
+ *  status = bladerf_broker_attach(&reader, "f12ce1...");
+ *
+ *  while (status == 0 && running) {
+ *      status = bladerf_broker_acquire(reader, &samples, &n, &meta, 1000);
+ *      if (status == 0) {
+ *          process_samples(samples, n, &meta);
+ *          status = bladerf_broker_release(reader);
+ *      }
+ *  }
+ *
+ *  bladerf_broker_detach(reader);
+ * @endcode
+ *
+ * This functionality is not available on Windows.
+ *
+ * @{
+ */
+
+/**
+ * Maximum number of readers attached to one broker at a time
+ */
+#define BLADERF_BROKER_MAX_READERS 16
+
+/** Publishing side of a broker */
+struct bladerf_broker;
+
+/** Handle used by a reader process to consume a broker's stream */
+struct bladerf_broker_reader;
+
+/**
+ * Start publishing the device's RX stream.
+ *
+ * The synchronous interface must already be configured for RX, with the
+ * same `layout` and `format`, via bladerf_sync_config(), and the RX
+ * channels enabled. The broker then owns the RX side of the synchronous
+ * interface, which the caller must not use until bladerf_broker_stop().
+ *
+ * The stream is published under the shared memory object `/bladerf-<name>`.
+ *
+ * @param       dev             Device handle
+ * @param[out]  broker          Broker handle
+ * @param[in]   name            Name under which the stream is published. If
+ *                              NULL, the device's serial number is used.
+ * @param[in]   layout          ::BLADERF_RX_X1 or ::BLADERF_RX_X2
+ * @param[in]   format          Sample format
+ * @param[in]   num_buffers     Number of buffers in the ring. Must be at
+ *                              least 3.
+ * @param[in]   buffer_size     Samples per buffer, as passed to
+ *                              bladerf_sync_rx(). For ::BLADERF_RX_X2, this
+ *                              includes the samples of both channels.
+ * @param[in]   timeout_ms      Timeout of the broker's bladerf_sync_rx()
+ *                              calls, in milliseconds.
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL on invalid parameters,
+ *         ::BLADERF_ERR_IO if the shared memory could not be created (e.g.,
+ *         if a broker of that name already exists),
+ *         ::BLADERF_ERR_UNSUPPORTED on Windows,
+ *         or another value from \ref RETCODES on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_broker_start(struct bladerf *dev,
+                                   struct bladerf_broker **broker,
+                                   const char *name,
+                                   bladerf_channel_layout layout,
+                                   bladerf_format format,
+                                   unsigned int num_buffers,
+                                   unsigned int buffer_size,
+                                   unsigned int timeout_ms);
+
+/**
+ * Stop publishing and remove the shared memory object. Attached readers
+ * receive ::BLADERF_ERR_NODEV from their next bladerf_broker_acquire().
+ *
+ * @param       broker          Broker handle. This is freed.
+ *
+ * @return 0 on success, or the error that stopped the stream prematurely
+ */
+API_EXPORT
+int CALL_CONV bladerf_broker_stop(struct bladerf_broker *broker);
+
+/**
+ * Attach to a broker's stream. Only buffers published after this call are
+ * received.
+ *
+ * @param[out]  reader          Reader handle
+ * @param[in]   name            Name of the broker, as passed to
+ *                              bladerf_broker_start()
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_NODEV if no such broker is running,
+ *         ::BLADERF_ERR_QUEUE_FULL if ::BLADERF_BROKER_MAX_READERS readers
+ *         are already attached,
+ *         ::BLADERF_ERR_UNSUPPORTED on Windows,
+ *         or another value from \ref RETCODES on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_broker_attach(struct bladerf_broker_reader **reader,
+                                    const char *name);
+
+/**
+ * Detach from a broker's stream, releasing any held buffer.
+ *
+ * @param       reader          Reader handle. This is freed.
+ */
+API_EXPORT
+void CALL_CONV bladerf_broker_detach(struct bladerf_broker_reader *reader);
+
+/**
+ * Get the configuration of the stream a reader is attached to.
+ *
+ * @param       reader          Reader handle
+ * @param[out]  layout          Stream layout. May be NULL.
+ * @param[out]  format          Sample format. May be NULL.
+ * @param[out]  buffer_size     Samples per buffer. May be NULL.
+ *
+ * @return 0 on success, ::BLADERF_ERR_INVAL on a NULL reader
+ */
+API_EXPORT
+int CALL_CONV bladerf_broker_get_config(struct bladerf_broker_reader *reader,
+                                        bladerf_channel_layout *layout,
+                                        bladerf_format *format,
+                                        unsigned int *buffer_size);
+
+/**
+ * Take the reader's next buffer from the ring. The buffer must be returned
+ * via bladerf_broker_release() before the next buffer is acquired.
+ *
+ * The samples remain valid until the publisher wraps around the ring onto
+ * them, i.e., for roughly `num_buffers - 2` buffer periods.
+ *
+ * @param       reader          Reader handle
+ * @param[out]  samples         Set to the buffer's samples
+ * @param[out]  num_samples     Set to the number of samples in the buffer
+ * @param[out]  metadata        Set to the buffer's metadata, for metadata
+ *                              formats. May be NULL.
+ * @param[in]   timeout_ms      Time to wait for a buffer, in milliseconds.
+ *                              Zero implies "infinite."
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_TIMEOUT if no buffer was published in time,
+ *         ::BLADERF_ERR_NODEV if the broker has stopped,
+ *         ::BLADERF_ERR_INVAL if a buffer is already held,
+ *         or another value from \ref RETCODES on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_broker_acquire(struct bladerf_broker_reader *reader,
+                                     const void **samples,
+                                     unsigned int *num_samples,
+                                     struct bladerf_metadata *metadata,
+                                     unsigned int timeout_ms);
+
+/**
+ * Return the buffer taken by bladerf_broker_acquire().
+ *
+ * @param       reader          Reader handle
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_TIME_PAST if the publisher overwrote the buffer
+ *         before it was released, in which case the samples read from it
+ *         may be corrupt,
+ *         ::BLADERF_ERR_INVAL if no buffer is held
+ */
+API_EXPORT
+int CALL_CONV bladerf_broker_release(struct bladerf_broker_reader *reader);
+
+/** @} (End of FN_BROKER) */
+
+/** @} (End of STREAMING) */
+
+/**
+ * @defgroup FN_PROG  Firmware and FPGA
+ *
+ * These functions provide the ability to load and program devices on the
+ * bladeRF board.
+ *
+ * Care should be taken with bootloader recovery functions to ensure that
+ * devices operated on are indeed a bladeRF, as opposed to another FX3-based
+ * device running in bootloader mode.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Write FX3 firmware to the bladeRF's SPI flash
+ *
+ * Only the erase blocks of the firmware region whose contents differ from the
+ * new image are erased and rewritten.
+ *
+ * @note This will require a power cycle to take effect
+ *
+ * @param       dev         Device handle
+ * @param[in]   firmware    Full path to firmware file
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_flash_firmware(struct bladerf *dev, const char *firmware);
+
+/**
+ * Load device's FPGA.
+ *
+ * @note This FPGA configuration will be reset at the next power cycle.
+ *
+ * @param       dev         Device handle
+ * @param[in]   fpga        Full path to FPGA bitstream
+ *
+ * @return 0 upon successfully, or a value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_load_fpga(struct bladerf *dev, const char *fpga);
+
+/**
+ * Progress callback for long-running operations
+ *
+ * @param[in]   done        Amount of work completed (e.g., bytes)
+ * @param[in]   total       Total amount of work
+ * @param[in]   user_data   User data provided with the callback
+ */
+typedef void (*bladerf_progress_cb)(size_t done, size_t total,
+                                    void *user_data);
+
+/**
+ * Load device's FPGA, reporting progress.
+ *
+ * The bitstream is read from the file as it is sent to the device, with
+ * reads overlapping the USB transfers where the backend supports it.
+ *
+ * If the FPGA is configured, and libbladeRF recorded loading a bitstream
+ * identical to `fpga` (by SHA-256 digest) since the device was last reset or
+ * reconnected, the load is skipped and 0 is returned. This record is kept in
+ * a per-user temporary file. bladerf_load_fpga() behaves the same way.
+ *
+ * @note This FPGA configuration will be reset at the next power cycle.
+ *
+ * @param       dev         Device handle
+ * @param[in]   fpga        Full path to FPGA bitstream
+ * @param[in]   cb          Called periodically with the number of bytes sent
+ *                          so far, and the size of the bitstream. May be NULL.
+ *                          This is called from the caller's thread.
+ * @param[in]   user_data   User data passed to `cb`
+ *
+ * @return 0 upon successfully, or a value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_load_fpga_with_progress(struct bladerf *dev,
+                                              const char *fpga,
+                                              bladerf_progress_cb cb,
+                                              void *user_data);
+
+/**
+ * Write the provided FPGA image to the bladeRF's SPI flash and enable FPGA
+ * loading from SPI flash at power on (also referred to within this project as
+ * FPGA "autoloading").
+ *
+ * Only the erase blocks of the FPGA region whose contents differ from the new
+ * image are erased and rewritten, so reflashing an image that differs in part
+ * of the bitstream is much quicker than erasing the whole region.
+ *
+ * @param       dev         Device handle
+ * @param[in]   fpga_image  Full path to FPGA file
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_flash_fpga(struct bladerf *dev, const char *fpga_image);
+
+/**
+ * Erase the FPGA region of SPI flash, effectively disabling FPGA autoloading
+ *
+ * @param   dev         Device handle
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_erase_stored_fpga(struct bladerf *dev);
+
+/**
+ * Reset the device, causing it to reload its firmware from flash
+ *
+ * @param   dev         Device handle
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_device_reset(struct bladerf *dev);
+
+/**
+ * Read firmware log data and write it to the specified file
+ *
+ * @param       dev         Device to read firmware log from
+ * @param[in]   filename    Filename to write log information to. If set to
+ *                          `NULL`, log data will be printed to stdout.
+ *
+ * @return 0 upon success, or a value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_fw_log(struct bladerf *dev, const char *filename);
+
+/**
+ * Clear out a firmware signature word in flash and jump to FX3 bootloader.
+ *
+ * The device will continue to boot into the FX3 bootloader across power cycles
+ * until new firmware is written to the device.
+ *
+ * @param   dev         Device handle
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_jump_to_bootloader(struct bladerf *dev);
+
+/**
+ * Get a list of devices that are running the FX3 bootloader.
+ *
+ * After obtaining this list, identify the device that you would like to load
+ * firmware onto. Save the bus and address values so that you can provide them
+ * to bladerf_load_fw_from_bootloader(), and then free this list via
+ * bladerf_free_device_list().
+ *
+ * @param[out]   list    Upon finding devices, this will be updated to point
+ *                       to a list of bladerf_devinfo structures that
+ *                       describe the identified devices.
+ *
+ * @return Number of items populated in `list`,
+ *         or an error value from the \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_bootloader_list(struct bladerf_devinfo **list);
+
+/**
+ * Download firmware to the specified device that is enumarating an FX3
+ * bootloader, and begin executing the firmware from RAM.
+ *
+ * @note This function <b>does not</b> write the firmware to SPI flash. If this
+ * is desired, open the newly enumerated device with bladerf_open() and use
+ * bladerf_flash_firmware().
+ *
+ * @param[in]   device_identifier   Device identifier string describing the
+ *                                  backend to use via the
+ *                                  `<backend>:device=<bus>:<addr>` syntax.  If
+ *                                  this is NULL, the backend, bus, and addr
+ *                                  arguments will be used instead.
+ * @param[in]   backend             Backend to use. This is only used if
+ *                                  device_identifier is `NULL`.
+ * @param[in]   bus                 Bus number the device is located on. This
+ *                                  is only used if device_identifier is `NULL`.
+ * @param[in]   addr                Bus address the device is located on. This
+ *                                  is only used if device_identifier is `NULL`.
+ * @param[in]   file                Filename of the firmware image to boot
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_load_fw_from_bootloader(const char *device_identifier,
+                                              bladerf_backend backend,
+                                              uint8_t bus,
+                                              uint8_t addr,
+                                              const char *file);
+
+/** @} (End of FN_PROG) */
+
+/**
+ * @defgroup FN_IMAGE Flash image format
+ *
+ * This section contains a file format and associated routines for storing
+ * and loading flash contents with metadata.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/** Type of data stored in a flash image */
+typedef enum {
+    BLADERF_IMAGE_TYPE_INVALID = -1, /**< Used to denote invalid value */
+    BLADERF_IMAGE_TYPE_RAW,          /**< Misc. raw data */
+    BLADERF_IMAGE_TYPE_FIRMWARE,     /**< Firmware data */
+    BLADERF_IMAGE_TYPE_FPGA_40KLE,   /**< FPGA bitstream for 40 KLE device */
+    BLADERF_IMAGE_TYPE_FPGA_115KLE,  /**< FPGA bitstream for 115  KLE device */
+    BLADERF_IMAGE_TYPE_FPGA_A4,      /**< FPGA bitstream for A4 device */
+    BLADERF_IMAGE_TYPE_FPGA_A9,      /**< FPGA bitstream for A9 device */
+    BLADERF_IMAGE_TYPE_CALIBRATION,  /**< Board calibration */
+    BLADERF_IMAGE_TYPE_RX_DC_CAL,    /**< RX DC offset calibration table */
+    BLADERF_IMAGE_TYPE_TX_DC_CAL,    /**< TX DC offset calibration table */
+    BLADERF_IMAGE_TYPE_RX_IQ_CAL,    /**< RX IQ balance calibration table */
+    BLADERF_IMAGE_TYPE_TX_IQ_CAL,    /**< TX IQ balance calibration table */
+    BLADERF_IMAGE_TYPE_FPGA_A5,      /**< FPGA bitstream for A5 device */
+    BLADERF_IMAGE_TYPE_GAIN_CAL,     /**< Gain calibration */
+} bladerf_image_type;
+
+/** Size of the magic signature at the beginning of bladeRF image files */
+#define BLADERF_IMAGE_MAGIC_LEN 7
+
+/** Size of bladeRF flash image checksum */
+#define BLADERF_IMAGE_CHECKSUM_LEN 32
+
+/** Size of reserved region of flash image */
+#define BLADERF_IMAGE_RESERVED_LEN 128
+
+/**
+ * Image format for backing up and restoring bladeRF flash contents
+ *
+ * The on disk format generated by the bladerf_image_write function is a
+ * serialized version of this structure and its contents. When written to disk,
+ * values are converted to big-endian byte order, for ease of reading in a hex
+ * editor.
+ *
+ * When creating and using a bladerf_image of type ::BLADERF_IMAGE_TYPE_RAW,
+ * the address and length fields must be erase-block aligned.
+ */
+struct bladerf_image {
+    /**
+     * Magic value used to identify image file format.
+     *
+     * Note that an extra character is added to store a `NUL`-terminator,
+     * to allow this field to be printed. This `NUL`-terminator is *NOT*
+     * written in the serialized image.
+     */
+    char magic[BLADERF_IMAGE_MAGIC_LEN + 1];
+
+    /**
+     * SHA256 checksum of the flash image. This is computed over the entire
+     * image, with this field filled with 0's.
+     */
+    uint8_t checksum[BLADERF_IMAGE_CHECKSUM_LEN];
+
+    /**
+     * Image format version. Only the major, minor, and patch fields are
+     * written to the disk; the describe field is not used. The version is
+     * serialized as: [major | minor | patch]
+     */
+    struct bladerf_version version;
+
+    /** UTC image timestamp, in seconds since the Unix Epoch */
+    uint64_t timestamp;
+
+    /**
+     * Serial number of the device that the image was obtained from. This
+     * field should be all '\0' if irrelevant.
+     *
+     * The +1 here is actually extraneous; ::BLADERF_SERIAL_LENGTH already
+     * accounts for a `NUL` terminator. However, this is left here to avoid
+     * breaking backwards compatibility.
+     */
+    char serial[BLADERF_SERIAL_LENGTH + 1];
+
+    /**
+     * Reserved for future metadata. Should be 0's.
+     */
+    char reserved[BLADERF_IMAGE_RESERVED_LEN];
+
+    /**
+     * Type of data contained in the image. Serialized as a uint32_t.
+     */
+    bladerf_image_type type;
+
+    /**
+     * Address of the flash data in this image. A value of `0xffffffff`
+     * implies that this field is left unspecified (i.e., "don't care").
+     */
+    uint32_t address;
+
+    /** Length of the data contained in the image */
+    uint32_t length;
+
+    /** Image data */
+    uint8_t *data;
+};
+
+/**
+ * Allocate and initialize an image structure.
+ *
+ * This following bladerf_image fields are populated: `magic`, `version`,
+ * `timestamp`, `type`, `address`, and `length`
+ *
+ * The following bladerf_image fields are zeroed out: `checksum`, `serial`, and
+ * `reserved`
+ *
+ * If the `length` parameter is not 0, the ::bladerf_image `data` field will be
+ * dynamically allocated. Otherwise, `data` will be set to NULL.
+ *
+ * @note A non-zero `length` should be use only with bladerf_image_write();
+ *       bladerf_image_read() allocates and sets `data` based upon size of the
+ *       image contents, and does not attempt to free() the `data` field before
+ *       setting it.
+ *
+ * The `address` and `length` fields should be set 0 when reading an image from
+ * a file.
+ *
+ * @param[in] dev       Device handle
+ * @param[in] type      Image type to be created, represented by `bladerf_image_type`
+ * @param[in] address   Address in flash memory where the image is stored. Use 0xffffffff if not applicable.
+ * @param[in] length    Length of the image data in bytes
+ *
+ * @return Pointer to allocated and initialized structure on success,
+ *         `NULL` on memory allocation failure or invalid address/length.
+ */
+API_EXPORT
+struct bladerf_image *CALL_CONV bladerf_alloc_image(struct bladerf *dev,
+                                                    bladerf_image_type type,
+                                                    uint32_t address,
+                                                    uint32_t length);
+
+/**
+ * Create a flash image initialized to contain a calibration data region.
+ *
+ * This is intended to be used in conjunction with bladerf_image_write(), or a
+ * write of the image's `data` field to flash.
+ *
+ * @param[in]   dev          Device handle
+ * @param[in]   fpga_size    Target FPGA size
+ * @param[in]   vctcxo_trim  VCTCXO oscillator trim value.
+ *
+ * @return Pointer to allocated and initialized structure on success,
+ *         `NULL` on memory allocation failure
+ */
+API_EXPORT
+struct bladerf_image *CALL_CONV bladerf_alloc_cal_image(
+    struct bladerf *dev, bladerf_fpga_size fpga_size, uint16_t vctcxo_trim);
+
+/**
+ * Free a bladerf_image previously obtained via bladerf_alloc_image.
+ *
+ * If the bladerf_image's `data` field is non-`NULL`, it will be freed.
+ *
+ * @param[inout]    image   Flash image
+ */
+API_EXPORT
+void CALL_CONV bladerf_free_image(struct bladerf_image *image);
+
+/**
+ * @brief Prints the metadata of a bladeRF image structure.
+ *
+ * This function displays the metadata of a provided `bladerf_image` structure.
+ * It includes information such as the magic number, version, timestamp, serial number,
+ * address, and length of the image. The function will return an error code if the
+ * provided image pointer is `NULL`.
+ *
+ * @pre The image should have been allocated using bladerf_alloc_image().
+ *
+ * @note This function only prints the metadata of the image and does not
+ *       perform any operations on the image data itself.
+ *
+ * @param[in] image Pointer to the `bladerf_image` structure whose metadata is to be printed.
+ *                  It should not be `NULL`.
+ *
+ * @return 0 on success, BLADERF_ERR_MEM if the image pointer is `NULL`.
+ */
+API_EXPORT
+int CALL_CONV bladerf_image_print_metadata(const struct bladerf_image *image);
+
+/**
+ * @brief Converts a bladeRF image type to its corresponding string representation.
+ *
+ * This function maps a `bladerf_image_type` enumeration value to a human-readable
+ * string. It is useful for logging, debugging, or displaying the image type
+ * to an end user.
+ *
+ * @param[in] type The `bladerf_image_type` enumeration value to be converted.
+ *
+ * @return A pointer to a string representing the image type. Returns "Unknown Type"
+ *         for any unrecognized or out-of-range values.
+ */
+const char* bladerf_image_type_to_string(bladerf_image_type type);
+
+/**
+ * Write a flash image to a file.
+ *
+ * This function will fill in the checksum field before writing the contents to
+ * the specified file. The user-supplied contents of this field are ignored.
+ *
+ * @pre  `image` has been initialized using bladerf_alloc_image()
+ * @post `image->checksum` will be populated if this function succeeds
+ *
+ * @param[in]    dev         Device handle
+ * @param[in]    image       Flash image
+ * @param[in]    file        File to write the flash image to
+ *
+ * @return 0 upon success, or a value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_image_write(struct bladerf *dev,
+                                  struct bladerf_image *image,
+                                  const char *file);
+
+/**
+ * Read flash image from a file.
+ *
+ * @pre  The `image` parameter has been obtained via a call to
+ *       bladerf_alloc_image(), with a `length` of 0.
+ *
+ * @post The `image` fields will be populated upon success, overwriting any
+ *       previous values.
+ *
+ * @note The contents of the `image` parameter should not be used if this
+ *       function fails.
+ *
+ * @param[out]   image      Flash image structure to populate.
+ * @param[in]    file       File to read image from.
+ *
+ * @return 0 upon success,
+ *         ::BLADERF_ERR_CHECKSUM upon detecting a checksum mismatch,
+ *         ::BLADERF_ERR_INVAL if any image fields are invalid,
+ *         ::BLADERF_ERR_IO on a file I/O error,
+ *         or a value from \ref RETCODES list on any other failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_image_read(struct bladerf_image *image, const char *file);
+
+/** @} (End of FN_IMAGE) */
+
+/**
+ * @defgroup FN_LOW_LEVEL Low-level Functions
+ *
+ * This section defines low-level APIs.
+ *
+ * @{
+ */
+
+/**
+ * @defgroup FN_VCTCXO_TAMER VCTCXO Tamer Mode
+ *
+ * This group provides routines for controlling the VTCTXO tamer.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * VCTCXO Tamer mode selection
+ *
+ * These values control the use of header J71 pin 1 for taming the
+ * on-board VCTCXO to improve or sustain frequency accuracy.
+ *
+ * When supplying input into the VCTCXO tamer, a 1.8V signal must be provided.
+ *
+ * @warning IMPORTANT: Exceeding 1.8V on J71-1 can damage the associated FPGA
+ *          I/O bank. Ensure that you provide only a 1.8V signal!
+ */
+typedef enum {
+    /** Denotes an invalid selection or state */
+    BLADERF_VCTCXO_TAMER_INVALID = -1,
+
+    /** Do not attempt to tame the VCTCXO with an input source. */
+    BLADERF_VCTCXO_TAMER_DISABLED = 0,
+
+    /** Use a 1 pps input source to tame the VCTCXO. */
+    BLADERF_VCTCXO_TAMER_1_PPS = 1,
+
+    /** Use a 10 MHz input source to tame the VCTCXO. */
+    BLADERF_VCTCXO_TAMER_10_MHZ = 2
+} bladerf_vctcxo_tamer_mode;
+
+/**
+ * Set the VCTCXO tamer mode.
+ *
+ * @param       dev         Device handle
+ * @param[in]   mode        VCTCXO taming mode
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_vctcxo_tamer_mode(struct bladerf *dev,
+                                            bladerf_vctcxo_tamer_mode mode);
+
+/**
+ * Get the current VCTCXO tamer mode
+ *
+ * @param           dev         Device handle
+ * @param[out]      mode        Current VCTCXO taming mode or
+ *                              ::BLADERF_VCTCXO_TAMER_INVALID if a failure
+ *                              occurs.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_vctcxo_tamer_mode(struct bladerf *dev,
+                                            bladerf_vctcxo_tamer_mode *mode);
+
+/**
+ * VCTCXO tamer control loop state
+ */
+typedef enum {
+    /** The tamer is disabled, and the trim DAC is left as set */
+    BLADERF_VCTCXO_TAMER_STATE_DISABLED = 0,
+
+    /** The trim DAC's response is being measured to find the DAC value
+     *  with the least error */
+    BLADERF_VCTCXO_TAMER_STATE_ACQUIRING = 1,
+
+    /** The trim DAC is being adjusted to keep the error within tolerance */
+    BLADERF_VCTCXO_TAMER_STATE_TRACKING = 2
+} bladerf_vctcxo_tamer_state;
+
+/**
+ * VCTCXO tamer status, as reported by bladerf_get_vctcxo_tamer_status()
+ *
+ * The errors are the differences between the number of VCTCXO cycles counted
+ * over an interval of the input source and the number expected. A
+ * measurement is taken each second, starting when the tamer is enabled.
+ */
+struct bladerf_vctcxo_tamer_status {
+    bladerf_vctcxo_tamer_state state; /**< Control loop state */
+    bool locked;              /**< Tracking, and the last 1 s error was within
+                                   tolerance */
+    unsigned int measurements; /**< Measurements taken since acquisition
+                                    started, saturating at 255 */
+    uint16_t trim_dac;        /**< Current trim DAC value */
+    int32_t error_1s;         /**< Error over the last 1 s interval */
+    int32_t error_10s;        /**< Error over the last 10 s interval */
+};
+
+/**
+ * Get the state of the VCTCXO tamer's control loop
+ *
+ * When the tamer is enabled with bladerf_set_vctcxo_tamer_mode(), it starts
+ * at the trim stored in flash, and typically locks within a few seconds if
+ * that remains accurate. Otherwise it measures the trim DAC's response
+ * around the stored trim, or failing that, across the DAC's full range.
+ *
+ * @note Requires FPGA v0.16.3 or later on the bladeRF 1. Not supported on the
+ *       bladeRF 2.0 Micro.
+ *
+ * @param       dev         Device handle
+ * @param[out]  status      Tamer status
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_vctcxo_tamer_status(
+    struct bladerf *dev, struct bladerf_vctcxo_tamer_status *status);
+
+/**
+ * Wait for the VCTCXO tamer to lock
+ *
+ * This polls bladerf_get_vctcxo_tamer_status() until it reports lock. The
+ * device is not locked between polls, so other threads may use it meanwhile.
+ *
+ * @param       dev         Device handle
+ * @param[in]   timeout_ms  Time to wait, in milliseconds
+ *
+ * @return 0 on success, ::BLADERF_ERR_TIMEOUT if lock was not reported in
+ *         time, ::BLADERF_ERR_UNEXPECTED if the tamer is disabled, or a value
+ *         from \ref RETCODES list on other failures
+ */
+API_EXPORT
+int CALL_CONV bladerf_wait_vctcxo_tamer_lock(struct bladerf *dev,
+                                             unsigned int timeout_ms);
+
+/** @} (End of FN_VCTCXO_TAMER) */
+
+/**
+ * @defgroup FN_VCTCXO_TRIM_DAC VCTCXO Trim DAC
+ *
+ * These functions provide the ability to manipulate the VCTCXO Trim DAC.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Query a device's VCTCXO calibration trim
+ *
+ * @param       dev     Device handle
+ * @param[out]  trim    VCTCXO calibration trim
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_vctcxo_trim(struct bladerf *dev, uint16_t *trim);
+
+/**
+ * Write value to VCTCXO trim DAC.
+ *
+ * @note This should not be used when the VCTCXO tamer is enabled.
+ *
+ * @param       dev     Device handle
+ * @param[in]   val     Desired VCTCXO trim DAC value
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_trim_dac_write(struct bladerf *dev, uint16_t val);
+
+/**
+ * Read value from VCTCXO trim DAC.
+ *
+ * This is similar to bladerf_get_vctcxo_trim(), except that it returns the
+ * current trim DAC value, as opposed to the calibration value read from flash.
+ *
+ * Use this if you are trying to query the value after having previously made
+ * calls to bladerf_trim_dac_write().
+ *
+ * @param       dev     Device handle
+ * @param[out]  val     Current VCTCXO trim DAC value
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_trim_dac_read(struct bladerf *dev, uint16_t *val);
+
+/** @} (End of FN_VCTCXO_TRIM_DAC) */
+
+/**
+ * @defgroup FN_TUNING_MODE Tuning Mode
+ *
+ * These functions provide the ability to select the tuning mode.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Frequency tuning modes
+ *
+ * The default tuning mode, `BLADERF_TUNING_MODE_HOST`, can be overridden by
+ * setting a BLADERF_DEFAULT_TUNING_MODE environment variable to `host` or `fpga`.
+ *
+ * ::BLADERF_TUNING_MODE_HOST is the default tuning mode.
+ *
+ * ::BLADERF_TUNING_MODE_FPGA requirements:
+ *  - libbladeRF >= v1.3.0
+ *  - FPGA       >= v0.2.0
+ *
+ * @note Overriding this value with a mode not supported by the FPGA will result
+ *       in failures or unexpected behavior.
+ */
+typedef enum {
+    /** Indicates an invalid mode is set */
+    BLADERF_TUNING_MODE_INVALID = -1,
+
+    /**
+     * Perform tuning algorithm on the host. This is slower, but provides
+     * easier accessiblity to diagnostic information.
+     */
+    BLADERF_TUNING_MODE_HOST,
+
+    /** Perform tuning algorithm on the FPGA for faster tuning. */
+    BLADERF_TUNING_MODE_FPGA,
+} bladerf_tuning_mode;
+
+/**
+ * Set the device's tuning mode
+ *
+ * @param       dev         Device handle
+ * @param[in]   mode        Desired tuning mode. Note that the available modes
+ *                          depends on the FPGA version.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_tuning_mode(struct bladerf *dev,
+                                      bladerf_tuning_mode mode);
+
+/**
+ * Get the device's current tuning mode
+ *
+ * @param       dev         Device handle
+ * @param[in]   mode        Tuning mode
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_tuning_mode(struct bladerf *dev,
+                                      bladerf_tuning_mode *mode);
+
+/** @} (End of FN_TUNING_MODE) */
+
+/**
+ * @defgroup FN_TRIGGER_CONTROL Trigger Control
+ *
+ * These functions provide the ability to read and write the trigger control
+ * registers.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Trigger control register "Arm" bit
+ *
+ * This bit arms (i.e., enables) the trigger controller when set to 1. Samples
+ * will be gated until the "Fire" bit has been asserted.
+ *
+ * A 0 in this bit disables the trigger controller. Samples will continue to
+ * flow as they normally do in this state.
+ */
+#define BLADERF_TRIGGER_REG_ARM ((uint8_t)(1 << 0))
+
+/**
+ * Trigger control register "Fire" bit
+ *
+ * For a master, this bit causes a trigger to be sent to all slave devices. Once
+ * this trigger is received (the master "receives" it immediately as well),
+ * devices begin streaming samples.
+ *
+ * This bit has no effect on slave devices.
+ */
+#define BLADERF_TRIGGER_REG_FIRE ((uint8_t)(1 << 1))
+
+/**
+ * Trigger control register "Master" bit
+ *
+ * Selects whether the device is a trigger master (1) or trigger slave (0). The
+ * trigger master drives the trigger signal as an output.
+ *
+ * Slave devices configure the trigger signal as an input.
+ */
+#define BLADERF_TRIGGER_REG_MASTER ((uint8_t)(1 << 2))
+
+/**
+ * Trigger control registers "line" bit
+ *
+ * This is a read-only register bit that denotes the current state of the the
+ * trigger signal.
+ */
+#define BLADERF_TRIGGER_REG_LINE ((uint8_t)(1 << 3))
+
+/**
+ * Read trigger control register
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   signal      Trigger signal (control register) to read from
+ * @param[out]  val         Pointer to variable that register is read into See
+ *                          the BLADERF_TRIGGER_REG_* macros for the meaning of
+ *                          each bit.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_read_trigger(struct bladerf *dev,
+                                   bladerf_channel ch,
+                                   bladerf_trigger_signal signal,
+                                   uint8_t *val);
+
+/**
+ * Write trigger control register
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   signal      Trigger signal to configure
+ * @param[in]   val         Data to write into the trigger control register.
+ *                          See the BLADERF_TRIGGER_REG_* macros for options.
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_write_trigger(struct bladerf *dev,
+                                    bladerf_channel ch,
+                                    bladerf_trigger_signal signal,
+                                    uint8_t val);
+
+/** @} (End of FN_TRIGGER_CONTROL) */
+
+/**
+ * @defgroup FN_WISHBONE_MASTER Wishbone bus master
+ *
+ * These functions provide the ability to read and write to the wishbone peripheral bus,
+ * which is reserved for modem. In the hosted bladeRF 2.0 Micro FPGA it carries
+ * the TX waveform player and the RX power meter; see \ref FN_TX_WAVEFORM and
+ * \ref FN_RX_POWER_METER.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Read a specific Wishbone Master address
+ *
+ * @param       dev     Device handle
+ * @param       addr    Wishbone Master address
+ * @param[out]  data    Wishbone Master data
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_wishbone_master_read(struct bladerf *dev, uint32_t addr, uint32_t *data);
+
+/**
+ * Write value to a specific Wishbone Master address
+ *
+ *
+ * @param       dev     Device handle
+ * @param       addr    Wishbone Master address
+ * @param       data    Wishbone Master data
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_wishbone_master_write(struct bladerf *dev, uint32_t addr, uint32_t val);
+
+/** @} (End of FN_WISHBONE_MASTER) */
+
+
+/**
+ * @defgroup FN_CONFIG_GPIO Configuration GPIO
+ *
+ * These functions provide the ability to read and write the configuration
+ * GPIO.
+ *
+ * These functions are thread-safe.
+ *
+ * @{
+ */
+
+/**
+ * Read the configuration GPIO register.
+ *
+ * @param       dev     Device handle
+ * @param[out]  val     Current configuration GPIO value
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_config_gpio_read(struct bladerf *dev, uint32_t *val);
+
+/**
+ * Write the configuration GPIO register.
+ *
+ * @note Callers should be sure to perform a read-modify-write sequence to
+ *       avoid accidentally clearing other GPIO bits that may be set by the
+ *       library internally.
+ *
+ * @param       dev     Device handle
+ * @param[out]  val     Desired configuration GPIO value
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_config_gpio_write(struct bladerf *dev, uint32_t val);
+
+/** @} (End of FN_CONFIG_GPIO) */
 
 /**
- * Allocate and initialize an image structure.
+ * @defgroup FN_BATCH Control request batching
  *
- * This following bladerf_image fields are populated: `magic`, `version`,
- * `timestamp`, `type`, `address`, and `length`
+ * Most configuration operations (e.g., gain, frequency, and RFIC register
+ * accesses) are carried out via requests to the FPGA's control processor,
+ * each of which is acknowledged before the next is issued. When configuring
+ * many settings at once, the time spent waiting for each write to be
+ * acknowledged by the caller dominates.
  *
- * The following bladerf_image fields are zeroed out: `checksum`, `serial`, and
- * `reserved`
+ * Within a batch scope, write requests are queued and the corresponding
+ * functions return immediately. Queued requests are issued, in order, when
+ * the scope is committed, when the queue fills, or before any read or other
+ * device access that must observe their effects. The order of operations as
+ * seen by the device is therefore unchanged.
  *
- * If the `length` parameter is not 0, the ::bladerf_image `data` field will be
- * dynamically allocated. Otherwise, `data` will be set to NULL.
+ * Because queued writes report success immediately, any failure is reported
+ * by bladerf_batch_commit() instead.
  *
- * @note A non-zero `length` should be use only with bladerf_image_write();
- *       bladerf_image_read() allocates and sets `data` based upon size of the
- *       image contents, and does not attempt to free() the `data` field before
- *       setting it.
+ * On the bladeRF 2.0 micro with FPGA-based RFIC control, frequency, gain,
+ * gain mode, bandwidth, and filter changes made within a scope are not waited
+ * upon individually. Where the FPGA supports it, consecutive changes are sent
+ * together, and bladerf_batch_commit() waits for them to complete.
  *
- * The `address` and `length` fields should be set 0 when reading an image from
- * a file.
+ * @note A batch scope applies to the device handle, rather than the calling
+ *       thread. Writes issued by other threads during the scope are queued
+ *       as well, and their failures are reported by bladerf_batch_commit().
  *
- * @param[in] dev       Device handle
- * @param[in] type      Image type to be created, represented by `bladerf_image_type`
- * @param[in] address   Address in flash memory where the image is stored. Use 0xffffffff if not applicable.
- * @param[in] length    Length of the image data in bytes
+ * These functions are thread-safe.
  *
- * @return Pointer to allocated and initialized structure on success,
- *         `NULL` on memory allocation failure or invalid address/length.
+ * @{
  */
-API_EXPORT
-struct bladerf_image *CALL_CONV bladerf_alloc_image(struct bladerf *dev,
-                                                    bladerf_image_type type,
-                                                    uint32_t address,
-                                                    uint32_t length);
 
 /**
- * Create a flash image initialized to contain a calibration data region.
+ * Begin a batch scope. Scopes may be nested; queued requests are only
+ * required to be issued when the outermost scope is committed.
  *
- * This is intended to be used in conjunction with bladerf_image_write(), or a
- * write of the image's `data` field to flash.
+ * On devices whose FPGA does not support the required request formats, this
+ * has no effect and requests are issued immediately.
  *
- * @param[in]   dev          Device handle
- * @param[in]   fpga_size    Target FPGA size
- * @param[in]   vctcxo_trim  VCTCXO oscillator trim value.
+ * @param       dev     Device handle
  *
- * @return Pointer to allocated and initialized structure on success,
- *         `NULL` on memory allocation failure
+ * @return 0 on success, value from \ref RETCODES list on failure
  */
 API_EXPORT
-struct bladerf_image *CALL_CONV bladerf_alloc_cal_image(
-    struct bladerf *dev, bladerf_fpga_size fpga_size, uint16_t vctcxo_trim);
+int CALL_CONV bladerf_batch_begin(struct bladerf *dev);
 
 /**
- * Free a bladerf_image previously obtained via bladerf_alloc_image.
+ * End a batch scope. If this ends the outermost scope, all queued requests
+ * are issued before this function returns.
  *
- * If the bladerf_image's `data` field is non-`NULL`, it will be freed.
+ * @param       dev     Device handle
  *
- * @param[inout]    image   Flash image
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if no batch scope is active,
+ *         or, when ending the outermost scope, a value from \ref RETCODES
+ *         list if any request issued since the outermost
+ *         bladerf_batch_begin() failed. Requests queued after a failed
+ *         request are discarded.
  */
 API_EXPORT
-void CALL_CONV bladerf_free_image(struct bladerf_image *image);
+int CALL_CONV bladerf_batch_commit(struct bladerf *dev);
+
+/** @} (End of FN_BATCH) */
 
 /**
- * @brief Prints the metadata of a bladeRF image structure.
- *
- * This function displays the metadata of a provided `bladerf_image` structure.
- * It includes information such as the magic number, version, timestamp, serial number,
- * address, and length of the image. The function will return an error code if the
- * provided image pointer is `NULL`.
+ * @defgroup FN_PROFILE Device profiles
  *
- * @pre The image should have been allocated using bladerf_alloc_image().
+ * A profile is a snapshot of a device's operating point: each channel's
+ * frequency, sample rate, bandwidth, RF port, gain mode and stage gains, and
+ * IQ corrections, along with the VCTCXO trim DAC value. On the bladeRF1, the
+ * quick tune parameters of each frequency are included as well, so that
+ * loading a profile on the same device need not retune from scratch.
  *
- * @note This function only prints the metadata of the image and does not
- *       perform any operations on the image data itself.
+ * Profiles are opaque, host-independent byte strings that may be stored
+ * (e.g., to a file) and loaded later. They may only be loaded on the same
+ * kind of board as they were saved from. Settings that a device does not
+ * support at the time of saving are omitted from the profile.
  *
- * @param[in] image Pointer to the `bladerf_image` structure whose metadata is to be printed.
- *                  It should not be `NULL`.
+ * These functions are thread-safe.
  *
- * @return 0 on success, BLADERF_ERR_MEM if the image pointer is `NULL`.
+ * @{
  */
-API_EXPORT
-int CALL_CONV bladerf_image_print_metadata(const struct bladerf_image *image);
 
 /**
- * @brief Converts a bladeRF image type to its corresponding string representation.
- *
- * This function maps a `bladerf_image_type` enumeration value to a human-readable
- * string. It is useful for logging, debugging, or displaying the image type
- * to an end user.
+ * Maximum length of a saved profile, in bytes
+ */
+#define BLADERF_PROFILE_MAX_LEN 1024
+
+/**
+ * Save the device's current settings to a profile
  *
- * @param[in] type The `bladerf_image_type` enumeration value to be converted.
+ * @param       dev     Device handle
+ * @param[out]  buf     Buffer to write the profile to
+ * @param[inout] len    On input, the size of `buf`. On output, the length of
+ *                      the profile. A buffer of ::BLADERF_PROFILE_MAX_LEN
+ *                      bytes is always sufficient.
  *
- * @return A pointer to a string representing the image type. Returns "Unknown Type"
- *         for any unrecognized or out-of-range values.
+ * @return 0 on success, ::BLADERF_ERR_INVAL if `buf` is too small, or a value
+ *         from \ref RETCODES list on other failures
  */
-const char* bladerf_image_type_to_string(bladerf_image_type type);
+API_EXPORT
+int CALL_CONV bladerf_save_profile(struct bladerf *dev, void *buf, size_t *len);
 
 /**
- * Write a flash image to a file.
+ * Restore the settings held by a profile
  *
- * This function will fill in the checksum field before writing the contents to
- * the specified file. The user-supplied contents of this field are ignored.
- *
- * @pre  `image` has been initialized using bladerf_alloc_image()
- * @post `image->checksum` will be populated if this function succeeds
+ * The settings are applied within a batch scope (see bladerf_batch_begin()),
+ * with each channel's sample rate and bandwidth set before its frequency.
  *
- * @param[in]    dev         Device handle
- * @param[in]    image       Flash image
- * @param[in]    file        File to write the flash image to
+ * @param       dev     Device handle
+ * @param[in]   buf     Profile, as provided by bladerf_save_profile()
+ * @param[in]   len     Length of the profile
  *
- * @return 0 upon success, or a value from \ref RETCODES list on failure
+ * @return 0 on success, ::BLADERF_ERR_INVAL if the profile is malformed or
+ *         was saved from another kind of board, or a value from \ref
+ *         RETCODES list on other failures
  */
 API_EXPORT
-int CALL_CONV bladerf_image_write(struct bladerf *dev,
-                                  struct bladerf_image *image,
-                                  const char *file);
+int CALL_CONV bladerf_load_profile(struct bladerf *dev,
+                                   const void *buf,
+                                   size_t len);
+
+/** @} (End of FN_PROFILE) */
 
 /**
- * Read flash image from a file.
+ * @defgroup FN_STATE Device state snapshot
  *
- * @pre  The `image` parameter has been obtained via a call to
- *       bladerf_alloc_image(), with a `length` of 0.
+ * Reading back each setting of a device in turn takes a call, and the
+ * device's lock, per setting, and other threads may change settings between
+ * them. bladerf_get_device_state() instead gathers the settings reported by
+ * `bladeRF-cli`'s `print` command in a single pass, taking the device's lock
+ * once, so that they are consistent with one another. Register reads are
+ * served from the host's register shadow where the board has one.
  *
- * @post The `image` fields will be populated upon success, overwriting any
- *       previous values.
+ * These functions are thread-safe.
  *
- * @note The contents of the `image` parameter should not be used if this
- *       function fails.
+ * @{
+ */
+
+/** Maximum number of channels in a ::bladerf_device_state */
+#define BLADERF_STATE_MAX_CHANNELS 4
+
+/** Maximum number of gain stages in a ::bladerf_channel_state */
+#define BLADERF_STATE_MAX_STAGES 8
+
+/** bladerf_channel_state::frequency is valid */
+#define BLADERF_CHAN_STATE_FREQUENCY (1 << 0)
+
+/** bladerf_channel_state::samplerate is valid */
+#define BLADERF_CHAN_STATE_SAMPLERATE (1 << 1)
+
+/** bladerf_channel_state::bandwidth is valid */
+#define BLADERF_CHAN_STATE_BANDWIDTH (1 << 2)
+
+/** bladerf_channel_state::rf_port is valid */
+#define BLADERF_CHAN_STATE_RF_PORT (1 << 3)
+
+/** bladerf_channel_state::gain_mode is valid. Only RX channels have one. */
+#define BLADERF_CHAN_STATE_GAIN_MODE (1 << 4)
+
+/** bladerf_channel_state::gain is valid */
+#define BLADERF_CHAN_STATE_GAIN (1 << 5)
+
+/** bladerf_device_state::loopback is valid */
+#define BLADERF_DEV_STATE_LOOPBACK (1 << 0)
+
+/** bladerf_device_state::rx_mux is valid */
+#define BLADERF_DEV_STATE_RX_MUX (1 << 1)
+
+/** bladerf_device_state::tuning_mode is valid */
+#define BLADERF_DEV_STATE_TUNING_MODE (1 << 2)
+
+/** bladerf_device_state::trim_dac is valid */
+#define BLADERF_DEV_STATE_TRIM_DAC (1 << 3)
+
+/**
+ * Value of a gain stage
+ */
+struct bladerf_gain_stage_value {
+    const char *name; /**< Stage name, per bladerf_get_gain_stages() */
+    int gain;         /**< Gain, in dB */
+};
+
+/**
+ * Settings of a channel
+ */
+struct bladerf_channel_state {
+    /** Channel these settings are of */
+    bladerf_channel channel;
+
+    /** BLADERF_CHAN_STATE_* flags of the fields below that are valid */
+    uint32_t valid;
+
+    /** Frequency, in Hz */
+    bladerf_frequency frequency;
+
+    /** Sample rate */
+    struct bladerf_rational_rate samplerate;
+
+    /** Bandwidth, in Hz */
+    bladerf_bandwidth bandwidth;
+
+    /** RF port name. This string is owned by the library. */
+    const char *rf_port;
+
+    /** Gain mode */
+    bladerf_gain_mode gain_mode;
+
+    /** Overall gain, in dB */
+    int gain;
+
+    /** Number of gain stages that were read */
+    unsigned int num_stages;
+
+    /** Gains of the individual stages */
+    struct bladerf_gain_stage_value stages[BLADERF_STATE_MAX_STAGES];
+};
+
+/**
+ * Settings of a device
+ */
+struct bladerf_device_state {
+    /** BLADERF_DEV_STATE_* flags of the fields below that are valid */
+    uint32_t valid;
+
+    /** Loopback mode */
+    bladerf_loopback loopback;
+
+    /** RX FPGA mux mode */
+    bladerf_rx_mux rx_mux;
+
+    /** Tuning mode */
+    bladerf_tuning_mode tuning_mode;
+
+    /** Current VCTCXO trim DAC value */
+    uint16_t trim_dac;
+
+    /** Number of entries of `channels`: each RX channel, then each TX
+     *  channel */
+    unsigned int num_channels;
+
+    /** Settings of each channel */
+    struct bladerf_channel_state channels[BLADERF_STATE_MAX_CHANNELS];
+};
+
+/**
+ * Read back the device's current settings
  *
- * @param[out]   image      Flash image structure to populate.
- * @param[in]    file       File to read image from.
+ * A setting that cannot be read is left out, by clearing its flag in the
+ * corresponding `valid` field, rather than failing the whole snapshot.
  *
- * @return 0 upon success,
- *         ::BLADERF_ERR_CHECKSUM upon detecting a checksum mismatch,
- *         ::BLADERF_ERR_INVAL if any image fields are invalid,
- *         ::BLADERF_ERR_IO on a file I/O error,
- *         or a value from \ref RETCODES list on any other failure
+ * @param       dev     Device handle
+ * @param[out]  state   Device state
+ *
+ * @return 0 on success, or a value from \ref RETCODES list on failure
  */
 API_EXPORT
-int CALL_CONV bladerf_image_read(struct bladerf_image *image, const char *file);
+int CALL_CONV bladerf_get_device_state(struct bladerf *dev,
+                                       struct bladerf_device_state *state);
 
-/** @} (End of FN_IMAGE) */
+/** @} (End of FN_STATE) */
 
 /**
- * @defgroup FN_LOW_LEVEL Low-level Functions
+ * @defgroup FN_STREAM_RECOVERY Stream recovery
  *
- * This section defines low-level APIs.
+ * A USB transfer error normally ends the stream, and bladerf_sync_rx() or
+ * bladerf_sync_tx() returns ::BLADERF_ERR_IO or ::BLADERF_ERR_NODEV. The
+ * application must then close and reopen the device, configure it again and
+ * restart its streams.
+ *
+ * With stream recovery enabled, these calls instead reset the USB port,
+ * finding the device again if it re-enumerates, and restore its sample
+ * interface. The profile saved when recovery was enabled is loaded (see
+ * bladerf_load_profile()), the stream is restarted, and the call is retried.
+ * On success, ::BLADERF_META_STATUS_RECOVERED is reported in the metadata
+ * status, if a bladerf_metadata structure is provided. The other direction's
+ * stream restarts at its next call, which reports the same.
+ *
+ * A retried bladerf_sync_tx() call transmits all of its samples again. Bursts
+ * whose timestamps passed during the outage should be rescheduled.
+ *
+ * Recovery is only possible while the FPGA keeps its configuration. It is
+ * performed by bladerf_sync_rx() and bladerf_sync_tx(), and only for the
+ * libusb backend.
  *
  * @{
  */
 
 /**
- * @defgroup FN_VCTCXO_TAMER VCTCXO Tamer Mode
+ * Enable or disable stream recovery
  *
- * This group provides routines for controlling the VTCTXO tamer.
+ * Enabling saves a profile of the device's current settings, which is loaded
+ * after each recovery. Settings changed afterwards are therefore reverted by
+ * a recovery, unless this is called again to save them.
  *
- * These functions are thread-safe.
+ * @param       dev         Device handle
+ * @param[in]   enable      Enable recovery
  *
- * @{
+ * @return 0 on success, ::BLADERF_ERR_UNSUPPORTED if the backend cannot
+ *         reset the device, or a value from \ref RETCODES list on other
+ *         failures
  */
+API_EXPORT
+int CALL_CONV bladerf_enable_stream_recovery(struct bladerf *dev, bool enable);
 
 /**
- * VCTCXO Tamer mode selection
+ * Get the number of times the device's streams have been recovered
  *
- * These values control the use of header J71 pin 1 for taming the
- * on-board VCTCXO to improve or sustain frequency accuracy.
+ * @param       dev         Device handle
+ * @param[out]  count       Number of recoveries since the device was opened
  *
- * When supplying input into the VCTCXO tamer, a 1.8V signal must be provided.
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_stream_recoveries(struct bladerf *dev,
+                                            unsigned int *count);
+
+/** @} (End of FN_STREAM_RECOVERY) */
+
+/**
+ * @defgroup FN_LINK_TEST Link integrity test
  *
- * @warning IMPORTANT: Exceeding 1.8V on J71-1 can damage the associated FPGA
- *          I/O bank. Ensure that you provide only a 1.8V signal!
+ * The link test checks that samples reach the host intact and without gaps at
+ * the current sample rate. It switches the RX mux to
+ * ::BLADERF_RX_MUX_32BIT_COUNTER, streams RX channel 0 via the synchronous
+ * interface for the requested duration, and verifies that each received
+ * sample is exactly one more than the last. Each discontinuity is reported
+ * as a gap, along with the number of samples it skipped.
+ *
+ * Set the sample rate of interest before running the test. Afterwards, the
+ * RX mux is restored and RX channel 0 is disabled. The RX synchronous
+ * interface is left configured for the test, so bladerf_sync_config() must
+ * be called again before receiving samples. The test must not be run while
+ * RX samples are being received by other means.
+ *
+ * @{
  */
-typedef enum {
-    /** Denotes an invalid selection or state */
-    BLADERF_VCTCXO_TAMER_INVALID = -1,
 
-    /** Do not attempt to tame the VCTCXO with an input source. */
-    BLADERF_VCTCXO_TAMER_DISABLED = 0,
+/**
+ * Maximum number of gaps whose location is reported by bladerf_link_test()
+ */
+#define BLADERF_LINK_TEST_MAX_GAPS 16
 
-    /** Use a 1 pps input source to tame the VCTCXO. */
-    BLADERF_VCTCXO_TAMER_1_PPS = 1,
+/**
+ * Location of a discontinuity in the received counter
+ */
+struct bladerf_link_test_gap {
+    uint64_t sample;   /**< Index of the first sample after the gap, counted
+                        *   from the start of the test */
+    uint32_t expected; /**< Counter value that was expected */
+    uint32_t received; /**< Counter value that was received */
+};
 
-    /** Use a 10 MHz input source to tame the VCTCXO. */
-    BLADERF_VCTCXO_TAMER_10_MHZ = 2
-} bladerf_vctcxo_tamer_mode;
+/**
+ * Link test results
+ */
+struct bladerf_link_test_result {
+    uint64_t samples;   /**< Number of samples checked */
+    double seconds;     /**< Time spent receiving them */
+    double throughput;  /**< Sustained rate, in samples per second */
+    uint64_t gaps;      /**< Number of discontinuities */
+    uint64_t dropped;   /**< Total number of samples skipped by forward
+                         *   discontinuities */
+
+    /** Number of valid entries in `gap` */
+    unsigned int num_gaps;
+
+    /** The first ::BLADERF_LINK_TEST_MAX_GAPS gaps */
+    struct bladerf_link_test_gap gap[BLADERF_LINK_TEST_MAX_GAPS];
+};
 
 /**
- * Set the VCTCXO tamer mode.
+ * Run the link integrity test
  *
  * @param       dev         Device handle
- * @param[in]   mode        VCTCXO taming mode
+ * @param[in]   duration_ms Duration of the test, in milliseconds
+ * @param[out]  result      Test results. These are filled in for the samples
+ *                          checked before any RX failure, too.
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 if the test ran to completion (regardless of whether any gaps were
+ *         found), ::BLADERF_ERR_INVAL if `duration_ms` is 0, or a value from
+ *         \ref RETCODES list on other failures
  */
 API_EXPORT
-int CALL_CONV bladerf_set_vctcxo_tamer_mode(struct bladerf *dev,
-                                            bladerf_vctcxo_tamer_mode mode);
+int CALL_CONV bladerf_link_test(struct bladerf *dev,
+                                unsigned int duration_ms,
+                                struct bladerf_link_test_result *result);
+
+/** @} (End of FN_LINK_TEST) */
 
 /**
- * Get the current VCTCXO tamer mode
+ * @defgroup FN_LATENCY_TEST Pipeline latency measurement
  *
- * @param           dev         Device handle
- * @param[out]      mode        Current VCTCXO taming mode or
- *                              ::BLADERF_VCTCXO_TAMER_INVALID if a failure
- *                              occurs.
+ * This measures the latency through the host, USB, and FPGA sample pipelines
+ * with the current synchronous interface settings, so that buffer sizes and
+ * counts may be chosen against a latency budget.
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * Each measurement transmits a short, full-scale pulse via
+ * bladerf_sync_tx(), with ::BLADERF_META_FLAG_TX_NOW, while a dedicated
+ * thread receives continuously via bladerf_sync_rx(). The pulse must be
+ * looped back to RX, either via bladerf_set_loopback() or an external cable
+ * with suitable attenuation. The RX timestamp of the pulse's first sample
+ * is converted to host time per bladerf_timestamp_to_host_ns(), which marks
+ * when the pulse was at RF. From this, two latencies are found:
+ *
+ *  - Host to RF: from the bladerf_sync_tx() call to RF
+ *  - RF to host: from RF to the return of the bladerf_sync_rx() call
+ *    providing the pulse
+ *
+ * The propagation time through the loopback path is included in the former,
+ * but is negligible in comparison. Both are only as accurate as the
+ * timestamp correlation, typically to tens of microseconds.
+ *
+ * Before measuring, configure both directions of the synchronous interface
+ * with ::BLADERF_FORMAT_SC16_Q11_META, and enable both RX and TX. If the RX
+ * timestamp correlation service is not already running, it is started for
+ * the duration of the measurement.
+ *
+ * @{
+ */
+
+/**
+ * Latency measurement settings
+ */
+struct bladerf_latency_config {
+    unsigned int iterations;  /**< Number of pulses to measure */
+    unsigned int interval_ms; /**< Delay between pulses, in milliseconds */
+    unsigned int rx_samples;  /**< Samples per bladerf_sync_rx() call, or 0
+                               *   for 4096 */
+    int16_t threshold;        /**< Level at which a received I or Q sample
+                               *   is taken to be the pulse, or 0 for 1024 */
+    unsigned int timeout_ms;  /**< Timeout for stream operations and for the
+                               *   reception of each pulse */
+};
+
+/**
+ * Latency distribution
+ */
+struct bladerf_latency_dist {
+    uint64_t count;   /**< Number of measurements */
+    uint64_t min_ns;  /**< Minimum */
+    uint64_t mean_ns; /**< Mean */
+    uint64_t p50_ns;  /**< Median */
+    uint64_t p90_ns;  /**< 90th percentile */
+    uint64_t p99_ns;  /**< 99th percentile */
+    uint64_t max_ns;  /**< Maximum */
+};
+
+/**
+ * Latency measurement results
+ */
+struct bladerf_latency_result {
+    unsigned int missed; /**< Pulses not received within the timeout, or
+                          *   received while the timestamp correlation was
+                          *   being refitted */
+    struct bladerf_latency_dist host_to_rf; /**< Host to RF latency */
+    struct bladerf_latency_dist rf_to_host; /**< RF to host latency */
+};
+
+/**
+ * Measure the pipeline latency
+ *
+ * @param       dev         Device handle
+ * @param[in]   config      Measurement settings
+ * @param[out]  result      Measured latencies
+ *
+ * @return 0 on success (including when some pulses were missed),
+ *         ::BLADERF_ERR_INVAL if `config->iterations` is 0,
+ *         ::BLADERF_ERR_TIMEOUT if the timestamp correlation could not be
+ *         established, or a value from \ref RETCODES list on other
+ *         failures
  */
 API_EXPORT
-int CALL_CONV bladerf_get_vctcxo_tamer_mode(struct bladerf *dev,
-                                            bladerf_vctcxo_tamer_mode *mode);
+int CALL_CONV bladerf_measure_latency(
+    struct bladerf *dev,
+    const struct bladerf_latency_config *config,
+    struct bladerf_latency_result *result);
 
-/** @} (End of FN_VCTCXO_TAMER) */
+/** @} (End of FN_LATENCY_TEST) */
 
 /**
- * @defgroup FN_VCTCXO_TRIM_DAC VCTCXO Trim DAC
+ * @defgroup FN_ASYNC_CTRL Asynchronous control operations
  *
- * These functions provide the ability to manipulate the VCTCXO Trim DAC.
+ * These functions queue a control operation and return immediately. Queued
+ * operations are carried out in submission order by a per-device worker
+ * thread, which is started on first use, and which then invokes the
+ * operation's completion callback, if one was provided.
+ *
+ * This allows a caller to have several operations outstanding while it
+ * continues other work. Note that the device carries out control requests
+ * one at a time, so queued operations are not overlapped with one another.
+ * Operations that must be applied together may still be grouped via
+ * bladerf_batch_begin() and bladerf_batch_commit().
+ *
+ * Completion callbacks may call any libbladeRF function on the device,
+ * including those in this group, except for bladerf_flush_async_ctrl().
+ * Callbacks should return promptly, as subsequent operations are not
+ * started until they do.
+ *
+ * Operations still queued when bladerf_close() is called are carried out
+ * before the device is closed. Operations submitted once bladerf_close() has
+ * been called, including from completion callbacks, are rejected with
+ * ::BLADERF_ERR_NODEV.
  *
  * These functions are thread-safe.
  *
@@ -3595,52 +8234,145 @@ int CALL_CONV bladerf_get_vctcxo_tamer_mode(struct bladerf *dev,
  */
 
 /**
- * Query a device's VCTCXO calibration trim
+ * Completion callback for asynchronous control operations
+ *
+ * @param       dev         Device handle
+ * @param[in]   status      Return value of the operation: 0 on success, or a
+ *                          value from \ref RETCODES list on failure
+ * @param[in]   user_data   Value provided when the operation was submitted
+ */
+typedef void (*bladerf_ctrl_cb)(struct bladerf *dev,
+                                int status,
+                                void *user_data);
+
+/**
+ * Queue a bladerf_set_frequency() operation
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   frequency   Desired frequency
+ * @param[in]   cb          Completion callback. May be NULL.
+ * @param[in]   user_data   Passed to `cb`
+ *
+ * @return 0 if the operation was queued,
+ *         ::BLADERF_ERR_QUEUE_FULL if too many operations are outstanding,
+ *         or a value from \ref RETCODES list on failure
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_frequency_async(struct bladerf *dev,
+                                          bladerf_channel ch,
+                                          bladerf_frequency frequency,
+                                          bladerf_ctrl_cb cb,
+                                          void *user_data);
+
+/**
+ * Queue a bladerf_set_gain() operation
  *
- * @param       dev     Device handle
- * @param[out]  trim    VCTCXO calibration trim
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   gain        Desired gain, in dB
+ * @param[in]   cb          Completion callback. May be NULL.
+ * @param[in]   user_data   Passed to `cb`
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return As with bladerf_set_frequency_async()
  */
 API_EXPORT
-int CALL_CONV bladerf_get_vctcxo_trim(struct bladerf *dev, uint16_t *trim);
+int CALL_CONV bladerf_set_gain_async(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     bladerf_gain gain,
+                                     bladerf_ctrl_cb cb,
+                                     void *user_data);
 
 /**
- * Write value to VCTCXO trim DAC.
+ * Queue a bladerf_schedule_retune() operation
  *
- * @note This should not be used when the VCTCXO tamer is enabled.
- *
- * @param       dev     Device handle
- * @param[in]   val     Desired VCTCXO trim DAC value
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   timestamp   Channel timestamp to perform the retune at
+ * @param[in]   frequency   Desired frequency
+ * @param[in]   quick_tune  Quick retune parameters, or NULL. These are
+ *                          copied; the caller need not keep them.
+ * @param[in]   cb          Completion callback. May be NULL.
+ * @param[in]   user_data   Passed to `cb`
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return As with bladerf_set_frequency_async()
  */
 API_EXPORT
-int CALL_CONV bladerf_trim_dac_write(struct bladerf *dev, uint16_t val);
+int CALL_CONV bladerf_schedule_retune_async(struct bladerf *dev,
+                                            bladerf_channel ch,
+                                            bladerf_timestamp timestamp,
+                                            bladerf_frequency frequency,
+                                            struct bladerf_quick_tune *quick_tune,
+                                            bladerf_ctrl_cb cb,
+                                            void *user_data);
 
 /**
- * Read value from VCTCXO trim DAC.
+ * Queue a bladerf_get_timestamp() operation
  *
- * This is similar to bladerf_get_vctcxo_trim(), except that it returns the
- * current trim DAC value, as opposed to the calibration value read from flash.
+ * @param       dev         Device handle
+ * @param[in]   dir         Stream direction
+ * @param[out]  timestamp   Written with the timestamp before `cb` is
+ *                          invoked. This must remain valid until then.
+ * @param[in]   cb          Completion callback. May be NULL.
+ * @param[in]   user_data   Passed to `cb`
  *
- * Use this if you are trying to query the value after having previously made
- * calls to bladerf_trim_dac_write().
+ * @return As with bladerf_set_frequency_async()
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_timestamp_async(struct bladerf *dev,
+                                          bladerf_direction dir,
+                                          bladerf_timestamp *timestamp,
+                                          bladerf_ctrl_cb cb,
+                                          void *user_data);
+
+/**
+ * Wait for all previously queued asynchronous control operations, and their
+ * completion callbacks, to complete.
  *
- * @param       dev     Device handle
- * @param[out]  val     Current VCTCXO trim DAC value
+ * @param       dev         Device handle
+ * @param[in]   timeout_ms  Timeout (milliseconds). Zero implies "infinite."
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 on success,
+ *         ::BLADERF_ERR_TIMEOUT if the operations did not complete in time,
+ *         ::BLADERF_ERR_INVAL if called from a completion callback,
+ *         or a value from \ref RETCODES list on failure
  */
 API_EXPORT
-int CALL_CONV bladerf_trim_dac_read(struct bladerf *dev, uint16_t *val);
+int CALL_CONV bladerf_flush_async_ctrl(struct bladerf *dev,
+                                       unsigned int timeout_ms);
 
-/** @} (End of FN_VCTCXO_TRIM_DAC) */
+/** @} (End of FN_ASYNC_CTRL) */
 
 /**
- * @defgroup FN_TUNING_MODE Tuning Mode
+ * @defgroup FN_TX_SCHED TX burst scheduling
  *
- * These functions provide the ability to select the tuning mode.
+ * These functions allow timestamped TX bursts to be queued ahead of time, in
+ * any order, rather than requiring bladerf_sync_tx() to be called for each
+ * burst in timestamp order.
+ *
+ * Queued bursts are sorted by timestamp. A worker thread passes them to
+ * bladerf_sync_tx(), earliest first, each as a complete burst
+ * (::BLADERF_META_FLAG_TX_BURST_START and ::BLADERF_META_FLAG_TX_BURST_END).
+ * The device holds each burst until its timestamp, so the time between
+ * bursts need not be filled by the caller. As with bladerf_sync_tx(), each
+ * burst should end with at least three zero-valued samples.
+ *
+ * By default, bursts are passed on as soon as possible. A burst may then only
+ * be submitted ahead of those the worker has yet to reach. To allow bursts to
+ * be submitted out of order closer to their transmission, configure a lead
+ * time via bladerf_tx_sched_config(); bursts are then held until their
+ * timestamp is within the lead of the device's current TX timestamp.
+ *
+ * @pre A bladerf_sync_config() call has been made to configure the device for
+ *      synchronous TX with the ::BLADERF_FORMAT_SC16_Q11_META,
+ *      ::BLADERF_FORMAT_SC8_Q7_META, ::BLADERF_FORMAT_CF32_META,
+ *      ::BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META or
+ *      ::BLADERF_FORMAT_SC8_Q7_AS_CF32_META format, and the TX channels have been enabled. The TX stream must not be
+ *      reconfigured while bursts are queued, nor used via other functions
+ *      while the scheduler is in use.
+ *
+ * Bursts still queued when bladerf_close() is called are transmitted before
+ * the device is closed.
  *
  * These functions are thread-safe.
  *
@@ -3648,154 +8380,188 @@ int CALL_CONV bladerf_trim_dac_read(struct bladerf *dev, uint16_t *val);
  */
 
 /**
- * Frequency tuning modes
- *
- * The default tuning mode, `BLADERF_TUNING_MODE_HOST`, can be overridden by
- * setting a BLADERF_DEFAULT_TUNING_MODE environment variable to `host` or `fpga`.
- *
- * ::BLADERF_TUNING_MODE_HOST is the default tuning mode.
+ * Configure the TX scheduler
  *
- * ::BLADERF_TUNING_MODE_FPGA requirements:
- *  - libbladeRF >= v1.3.0
- *  - FPGA       >= v0.2.0
+ * @param       dev         Device handle
+ * @param[in]   lead        Hold bursts until their timestamp is within this
+ *                          many ticks of the device's TX timestamp. 0 passes
+ *                          bursts on as soon as possible.
+ * @param[in]   timeout_ms  Timeout (milliseconds) of each bladerf_sync_tx()
+ *                          call made by the scheduler. Zero implies
+ *                          "infinite." Defaults to 1000.
  *
- * @note Overriding this value with a mode not supported by the FPGA will result
- *       in failures or unexpected behavior.
+ * @return 0 on success, or a value from \ref RETCODES list on failure
  */
-typedef enum {
-    /** Indicates an invalid mode is set */
-    BLADERF_TUNING_MODE_INVALID = -1,
-
-    /**
-     * Perform tuning algorithm on the host. This is slower, but provides
-     * easier accessiblity to diagnostic information.
-     */
-    BLADERF_TUNING_MODE_HOST,
-
-    /** Perform tuning algorithm on the FPGA for faster tuning. */
-    BLADERF_TUNING_MODE_FPGA,
-} bladerf_tuning_mode;
+API_EXPORT
+int CALL_CONV bladerf_tx_sched_config(struct bladerf *dev,
+                                      uint64_t lead,
+                                      unsigned int timeout_ms);
 
 /**
- * Set the device's tuning mode
+ * Queue a burst for transmission at the specified timestamp. The samples are
+ * copied; the caller need not keep them.
  *
  * @param       dev         Device handle
- * @param[in]   mode        Desired tuning mode. Note that the available modes
- *                          depends on the FPGA version.
+ * @param[in]   samples     Samples in the configured format, interleaved as
+ *                          with bladerf_sync_tx()
+ * @param[in]   num_samples Number of samples, as with bladerf_sync_tx()
+ * @param[in]   timestamp   Timestamp of the first sample of the burst
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 if the burst was queued,
+ *         ::BLADERF_ERR_TIME_PAST if `timestamp` precedes the end of a burst
+ *         that has already been passed to bladerf_sync_tx(),
+ *         ::BLADERF_ERR_QUEUE_FULL if too many bursts are queued,
+ *         ::BLADERF_ERR_UNSUPPORTED if the configured format is not supported,
+ *         or a value from \ref RETCODES list on failure
  */
 API_EXPORT
-int CALL_CONV bladerf_set_tuning_mode(struct bladerf *dev,
-                                      bladerf_tuning_mode mode);
+int CALL_CONV bladerf_tx_sched_submit(struct bladerf *dev,
+                                      const void *samples,
+                                      unsigned int num_samples,
+                                      bladerf_timestamp timestamp);
 
 /**
- * Get the device's current tuning mode
+ * Wait for all previously queued bursts to be passed to bladerf_sync_tx()
  *
  * @param       dev         Device handle
- * @param[in]   mode        Tuning mode
+ * @param[in]   timeout_ms  Timeout (milliseconds). Zero implies "infinite."
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 on success,
+ *         the first error returned by bladerf_sync_tx() for a queued burst
+ *         since the previous call, e.g., ::BLADERF_ERR_TIME_PAST for bursts
+ *         that overlapped,
+ *         ::BLADERF_ERR_TIMEOUT if the bursts were not passed on in time,
+ *         or a value from \ref RETCODES list on failure
  */
 API_EXPORT
-int CALL_CONV bladerf_get_tuning_mode(struct bladerf *dev,
-                                      bladerf_tuning_mode *mode);
+int CALL_CONV bladerf_tx_sched_flush(struct bladerf *dev,
+                                     unsigned int timeout_ms);
 
-/** @} (End of FN_TUNING_MODE) */
+/** @} (End of FN_TX_SCHED) */
 
 /**
- * @defgroup FN_TRIGGER_CONTROL Trigger Control
- *
- * These functions provide the ability to read and write the trigger control
- * registers.
+ * @defgroup FN_RX_HISTORY RX history
  *
- * These functions are thread-safe.
+ * These functions retain the most recently received RX buffers, indexed by
+ * timestamp, such that samples from before and after an event may be read
+ * once the event has been detected; e.g., from 5 ms before a trigger to 5 ms
+ * after it. Reads may be made in any order, without stopping the stream.
  *
- * @{
- */
-
-/**
- * Trigger control register "Arm" bit
+ * While the history is running, a worker thread takes each buffer of the RX
+ * stream via bladerf_sync_rx_acquire(), and holds on to the newest
+ * `num_buffers` of them. Samples are only copied out of these buffers when
+ * they are read.
  *
- * This bit arms (i.e., enables) the trigger controller when set to 1. Samples
- * will be gated until the "Fire" bit has been asserted.
+ * The retained buffers are unavailable to the stream. `num_buffers` must
+ * therefore be less than the `num_buffers` passed to bladerf_sync_config(),
+ * less its `num_transfers`, leaving enough buffers for the stream to keep up
+ * with the sample rate. Otherwise, samples will be dropped, and reads that
+ * span the gaps will report ::BLADERF_META_STATUS_OVERRUN.
  *
- * A 0 in this bit disables the trigger controller. Samples will continue to
- * flow as they normally do in this state.
- */
-#define BLADERF_TRIGGER_REG_ARM ((uint8_t)(1 << 0))
-
-/**
- * Trigger control register "Fire" bit
+ * @pre A bladerf_sync_config() call has been made to configure the device for
+ *      synchronous RX with the ::BLADERF_FORMAT_SC16_Q11_META or
+ *      ::BLADERF_FORMAT_SC8_Q7_META format, and the RX channels have been
+ *      enabled. The RX stream must not be used via other functions while the
+ *      history is running. Reconfiguring the RX stream stops the history.
  *
- * For a master, this bit causes a trigger to be sent to all slave devices. Once
- * this trigger is received (the master "receives" it immediately as well),
- * devices begin streaming samples.
+ * These functions are thread-safe. Reads are serialized.
  *
- * This bit has no effect on slave devices.
+ * @{
  */
-#define BLADERF_TRIGGER_REG_FIRE ((uint8_t)(1 << 1))
 
 /**
- * Trigger control register "Master" bit
+ * Start retaining RX buffers, discarding any previously retained
  *
- * Selects whether the device is a trigger master (1) or trigger slave (0). The
- * trigger master drives the trigger signal as an output.
+ * @param       dev         Device handle
+ * @param[in]   num_buffers Number of buffers to retain
  *
- * Slave devices configure the trigger signal as an input.
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if the configured format is not supported,
+ *         or a value from \ref RETCODES list on failure
  */
-#define BLADERF_TRIGGER_REG_MASTER ((uint8_t)(1 << 2))
+API_EXPORT
+int CALL_CONV bladerf_rx_history_start(struct bladerf *dev,
+                                       unsigned int num_buffers);
 
 /**
- * Trigger control registers "line" bit
+ * Stop retaining RX buffers, and return those retained to the stream
  *
- * This is a read-only register bit that denotes the current state of the the
- * trigger signal.
+ * @param       dev         Device handle
+ *
+ * @return 0 on success, or a value from \ref RETCODES list on failure
  */
-#define BLADERF_TRIGGER_REG_LINE ((uint8_t)(1 << 3))
+API_EXPORT
+int CALL_CONV bladerf_rx_history_stop(struct bladerf *dev);
 
 /**
- * Read trigger control register
+ * Get the range of timestamps of the samples currently retained
  *
  * @param       dev         Device handle
- * @param[in]   ch          Channel
- * @param[in]   signal      Trigger signal (control register) to read from
- * @param[out]  val         Pointer to variable that register is read into See
- *                          the BLADERF_TRIGGER_REG_* macros for the meaning of
- *                          each bit.
+ * @param[out]  start       Timestamp of the oldest sample retained
+ * @param[out]  end         Timestamp following the newest sample retained
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 on success,
+ *         ::BLADERF_ERR_WOULD_BLOCK if no buffers have been retained yet,
+ *         ::BLADERF_ERR_INVAL if the history is not running,
+ *         or a value from \ref RETCODES list on failure
  */
 API_EXPORT
-int CALL_CONV bladerf_read_trigger(struct bladerf *dev,
-                                   bladerf_channel ch,
-                                   bladerf_trigger_signal signal,
-                                   uint8_t *val);
+int CALL_CONV bladerf_rx_history_range(struct bladerf *dev,
+                                       bladerf_timestamp *start,
+                                       bladerf_timestamp *end);
 
 /**
- * Write trigger control register
+ * Read retained samples, starting at the specified timestamp
+ *
+ * If the range extends beyond the newest sample received, this waits for
+ * the rest of the range to arrive.
+ *
+ * Samples that were never received, e.g., due to an overrun, are zeroed,
+ * and ::BLADERF_META_STATUS_OVERRUN is set in the metadata's `status`.
  *
  * @param       dev         Device handle
- * @param[in]   ch          Channel
- * @param[in]   signal      Trigger signal to configure
- * @param[in]   val         Data to write into the trigger control register.
- *                          See the BLADERF_TRIGGER_REG_* macros for options.
+ * @param[out]  samples     Buffer to fill with samples in the configured
+ *                          format, without metadata headers, interleaved as
+ *                          with bladerf_sync_rx()
+ * @param[in]   num_samples Number of samples, as with bladerf_sync_rx()
+ * @param[in]   timestamp   Timestamp of the first sample to read
+ * @param[out]  metadata    If not NULL, `timestamp`, `actual_count`, and
+ *                          `status` are populated
+ * @param[in]   timeout_ms  Timeout (milliseconds) for the range to arrive.
+ *                          Zero implies "infinite."
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 on success,
+ *         ::BLADERF_ERR_TIME_PAST if `timestamp` precedes the oldest sample
+ *         retained,
+ *         ::BLADERF_ERR_TIMEOUT if the range did not arrive in time,
+ *         ::BLADERF_ERR_INVAL if the history is not running,
+ *         or a value from \ref RETCODES list on failure
  */
 API_EXPORT
-int CALL_CONV bladerf_write_trigger(struct bladerf *dev,
-                                    bladerf_channel ch,
-                                    bladerf_trigger_signal signal,
-                                    uint8_t val);
+int CALL_CONV bladerf_rx_history_read(struct bladerf *dev,
+                                      void *samples,
+                                      unsigned int num_samples,
+                                      bladerf_timestamp timestamp,
+                                      struct bladerf_metadata *metadata,
+                                      unsigned int timeout_ms);
 
-/** @} (End of FN_TRIGGER_CONTROL) */
+/** @} (End of FN_RX_HISTORY) */
 
 /**
- * @defgroup FN_WISHBONE_MASTER Wishbone bus master
+ * @defgroup FN_CTRL_STATS Control request statistics
  *
- * These functions provide the ability to read and write to the wishbone peripheral bus,
- * which is reserved for modem
+ * Configuration operations are carried out via requests to the FPGA's control
+ * processor. When enabled, libbladeRF records the round-trip time of each
+ * request, from the time it is sent until its response is received, grouped
+ * by the request's packet format.
+ *
+ * Times are accumulated in histograms whose buckets are sized relative to
+ * the times they hold, such that the reported percentiles are within 1/16 of
+ * the actual values. Requests that fail to complete (e.g., due to a USB
+ * error or timeout) are counted, but are not included in the histograms.
+ *
+ * These statistics are only available when the device is accessed via a
+ * USB backend and the FPGA is loaded.
  *
  * These functions are thread-safe.
  *
@@ -3803,71 +8569,214 @@ int CALL_CONV bladerf_write_trigger(struct bladerf *dev,
  */
 
 /**
- * Read a specific Wishbone Master address
+ * Control request packet formats
+ */
+typedef enum {
+    BLADERF_CONTROL_PKT_8x8 = 0, /**< 8-bit address, 8-bit data */
+    BLADERF_CONTROL_PKT_8x16,    /**< 8-bit address, 16-bit data */
+    BLADERF_CONTROL_PKT_8x32,    /**< 8-bit address, 32-bit data */
+    BLADERF_CONTROL_PKT_8x64,    /**< 8-bit address, 64-bit data */
+    BLADERF_CONTROL_PKT_16x64,   /**< 16-bit address, 64-bit data */
+    BLADERF_CONTROL_PKT_32x32,   /**< 32-bit address, 32-bit data */
+    BLADERF_CONTROL_PKT_RETUNE,  /**< Scheduled and quick retune requests */
+    BLADERF_CONTROL_PKT_OTHER,   /**< All other request formats */
+} bladerf_control_pkt;
+
+/** Number of ::bladerf_control_pkt values */
+#define BLADERF_CONTROL_PKT_COUNT 8
+
+/**
+ * Round-trip times of one type of control request. All times are in
+ * nanoseconds, and are 0 if no requests have completed.
+ */
+struct bladerf_control_latency {
+    uint64_t count;   /**< Number of requests that completed */
+    uint64_t errors;  /**< Number of requests that failed to complete */
+    uint64_t min_ns;  /**< Minimum */
+    uint64_t mean_ns; /**< Mean */
+    uint64_t p50_ns;  /**< Median */
+    uint64_t p90_ns;  /**< 90th percentile */
+    uint64_t p99_ns;  /**< 99th percentile */
+    uint64_t p999_ns; /**< 99.9th percentile */
+    uint64_t max_ns;  /**< Maximum */
+};
+
+/**
+ * Control request statistics
+ */
+struct bladerf_control_stats {
+    /** Statistics for each packet format, indexed by ::bladerf_control_pkt */
+    struct bladerf_control_latency pkt[BLADERF_CONTROL_PKT_COUNT];
+};
+
+/**
+ * Enable or disable the recording of control request statistics. This is
+ * disabled by default.
  *
- * @param       dev     Device handle
- * @param       addr    Wishbone Master address
- * @param[out]  data    Wishbone Master data
+ * Enabling the recording clears any previously recorded statistics.
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @param       dev         Device handle
+ * @param[in]   enable      Set true to enable recording, false to disable it
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_UNSUPPORTED if the backend or FPGA in use does not
+ *         support this,
+ *         or a value from \ref RETCODES list on failure
  */
 API_EXPORT
-int CALL_CONV bladerf_wishbone_master_read(struct bladerf *dev, uint32_t addr, uint32_t *data);
+int CALL_CONV bladerf_enable_control_stats(struct bladerf *dev, bool enable);
 
 /**
- * Write value to a specific Wishbone Master address
+ * Retrieve the control request statistics recorded since they were last
+ * enabled via bladerf_enable_control_stats().
  *
+ * @param       dev         Device handle
+ * @param[out]  stats       Populated with the current statistics
  *
- * @param       dev     Device handle
- * @param       addr    Wishbone Master address
- * @param       data    Wishbone Master data
- *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if recording has not been enabled,
+ *         ::BLADERF_ERR_UNSUPPORTED if the backend or FPGA in use does not
+ *         support this,
+ *         or a value from \ref RETCODES list on failure
  */
 API_EXPORT
-int CALL_CONV bladerf_wishbone_master_write(struct bladerf *dev, uint32_t addr, uint32_t val);
-
-/** @} (End of FN_WISHBONE_MASTER) */
+int CALL_CONV bladerf_get_control_stats(struct bladerf *dev,
+                                        struct bladerf_control_stats *stats);
 
+/** @} (End of FN_CTRL_STATS) */
 
 /**
- * @defgroup FN_CONFIG_GPIO Configuration GPIO
+ * @defgroup FN_METRICS Metrics export
  *
- * These functions provide the ability to read and write the configuration
- * GPIO.
+ * A long-running service may need its device's statistics collected by a
+ * monitoring system without its own threads making calls to fetch them.
+ * When enabled, libbladeRF gathers them periodically on a thread of its own
+ * and publishes each snapshot to a POSIX shared memory object, from which
+ * other processes read the latest one via bladerf_read_metrics(). The
+ * `bladeRF-exporter` utility serves them to Prometheus.
  *
- * These functions are thread-safe.
+ * Each snapshot holds what is available of:
+ *  - the statistics of each configured synchronous stream, per
+ *    bladerf_get_stream_stats()
+ *  - the control request statistics, per bladerf_get_control_stats(), if
+ *    they have been enabled via bladerf_enable_control_stats()
+ *  - the length of each direction's retune queue, per
+ *    bladerf_get_retune_queue_status()
+ *  - the RFIC temperature, on the bladeRF 2.0 Micro. This comes from the
+ *    telemetry sampler, if it runs (see bladerf_enable_telemetry()).
+ *
+ * Gathering takes the device lock once for each item, as would the
+ * equivalent API calls. Publishing never waits on readers.
+ *
+ * This functionality is not available on Windows.
  *
  * @{
  */
 
+/** bladerf_metrics::rx holds RX stream statistics */
+#define BLADERF_METRICS_RX_STREAM (1 << 0)
+
+/** bladerf_metrics::tx holds TX stream statistics */
+#define BLADERF_METRICS_TX_STREAM (1 << 1)
+
+/** bladerf_metrics::control holds control request statistics */
+#define BLADERF_METRICS_CONTROL (1 << 2)
+
+/** bladerf_metrics::retune[::BLADERF_RX] holds the RX retune queue state */
+#define BLADERF_METRICS_RX_RETUNE (1 << 3)
+
+/** bladerf_metrics::retune[::BLADERF_TX] holds the TX retune queue state */
+#define BLADERF_METRICS_TX_RETUNE (1 << 4)
+
+/** bladerf_metrics::rfic_temperature holds the RFIC temperature */
+#define BLADERF_METRICS_TEMPERATURE (1 << 5)
+
 /**
- * Read the configuration GPIO register.
+ * Snapshot of a device's statistics
+ */
+struct bladerf_metrics {
+    /** bladerf_get_host_time_ns() when the snapshot was completed */
+    uint64_t host_ns;
+
+    /** Number of snapshots published, including this one */
+    uint64_t updates;
+
+    /** Interval between snapshots, in milliseconds */
+    unsigned int interval_ms;
+
+    /** BLADERF_METRICS_* flags of the fields below that were gathered */
+    uint32_t valid;
+
+    /** Device serial number */
+    char serial[BLADERF_SERIAL_LENGTH];
+
+    /** Board name, per bladerf_get_board_name() */
+    char board[16];
+
+    /** RX stream statistics */
+    struct bladerf_stream_stats rx;
+
+    /** TX stream statistics */
+    struct bladerf_stream_stats tx;
+
+    /** Control request statistics */
+    struct bladerf_control_stats control;
+
+    /** Retune queue state of channel 0 of each direction, indexed by
+     *  ::bladerf_direction */
+    struct bladerf_retune_queue_status retune[2];
+
+    /** RFIC temperature, in degrees C */
+    float rfic_temperature;
+};
+
+/**
+ * Start, restart or stop publishing the device's metrics
  *
- * @param       dev     Device handle
- * @param[out]  val     Current configuration GPIO value
+ * The metrics are published under the shared memory object
+ * `/bladerf-metrics-<name>`, which is removed when publishing stops or the
+ * device is closed.
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @param       dev         Device handle
+ * @param[in]   name        Name under which the metrics are published. If
+ *                          NULL, the device's serial number is used.
+ *                          Ignored when stopping.
+ * @param[in]   interval_ms Interval between snapshots, or 0 to stop
+ *                          publishing
+ *
+ * @return 0 on success,
+ *         ::BLADERF_ERR_INVAL if `name` is empty or contains a '/',
+ *         ::BLADERF_ERR_IO if the shared memory could not be created,
+ *         ::BLADERF_ERR_UNSUPPORTED on Windows,
+ *         or another value from \ref RETCODES on failure
  */
 API_EXPORT
-int CALL_CONV bladerf_config_gpio_read(struct bladerf *dev, uint32_t *val);
+int CALL_CONV bladerf_enable_metrics(struct bladerf *dev,
+                                     const char *name,
+                                     unsigned int interval_ms);
 
 /**
- * Write the configuration GPIO register.
+ * Read the latest metrics published by another process, or this one
  *
- * @note Callers should be sure to perform a read-modify-write sequence to
- *       avoid accidentally clearing other GPIO bits that may be set by the
- *       library internally.
+ * This does not wait on the publisher.
  *
- * @param       dev     Device handle
- * @param[out]  val     Desired configuration GPIO value
+ * @param[in]   name        Name under which the metrics are published
+ * @param[out]  metrics     Latest snapshot
  *
- * @return 0 on success, value from \ref RETCODES list on failure
+ * @return 0 on success,
+ *         ::BLADERF_ERR_NODEV if no such metrics are published, or their
+ *         publisher has exited,
+ *         ::BLADERF_ERR_WOULD_BLOCK if no snapshot has been published yet,
+ *         ::BLADERF_ERR_PERMISSION if the caller may not read them,
+ *         ::BLADERF_ERR_UNSUPPORTED if they were published by an
+ *         incompatible version of libbladeRF, or on Windows,
+ *         or another value from \ref RETCODES on failure
  */
 API_EXPORT
-int CALL_CONV bladerf_config_gpio_write(struct bladerf *dev, uint32_t val);
+int CALL_CONV bladerf_read_metrics(const char *name,
+                                   struct bladerf_metrics *metrics);
 
-/** @} (End of FN_CONFIG_GPIO) */
+/** @} (End of FN_METRICS) */
 
 /**
  * @defgroup FN_SPI_FLASH SPI Flash
@@ -4136,6 +9045,22 @@ int CALL_CONV bladerf_get_rf_ports(struct bladerf *dev,
 
 /**
  * Feature Set
+ *
+ * ::BLADERF_FEATURE_OVERSAMPLE runs the RFIC at up to 122.88 MHz, which
+ * requires the 8-bit sample formats to fit within USB 3.0 bandwidth. At
+ * 122.88 Msps, a single channel carries 245.76 MB/s.
+ *
+ * When bladerf_sync_config() is left to select the stream parameters, it
+ * sizes for the oversampled rate: 8 transfers of 122880 samples (1 ms)
+ * each, and 16 buffers. Callers that prefer SC16 Q11 or CF32 samples may use
+ * ::BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11 or ::BLADERF_FORMAT_SC8_Q7_AS_CF32,
+ * which are widened with SIMD instructions as bladerf_sync_rx() copies the
+ * samples out. This conversion quadruples the memory traffic of the CF32
+ * samples, so it should be benchmarked on the target host.
+ *
+ * Where the host cannot keep up with this copy, use ::BLADERF_FORMAT_SC8_Q7
+ * with bladerf_sync_rx_acquire(), or the \ref FN_STREAMING_ASYNC interface,
+ * both of which provide the stream buffers directly.
  */
 typedef enum {
     BLADERF_FEATURE_DEFAULT = 0,   /**< No feature enabled */
@@ -4323,6 +9248,64 @@ int CALL_CONV bladerf_get_gain_calibration(struct bladerf *dev, bladerf_channel
 API_EXPORT
 int CALL_CONV bladerf_get_gain_target(struct bladerf *dev, bladerf_channel ch, int *gain_target);
 
+/**
+ * Default gain calibration lookup resolution, in Hz.
+ *
+ * @see bladerf_set_gain_calibration_resolution()
+ */
+#define BLADERF_GAIN_CAL_RESOLUTION_DEFAULT 1000000
+
+/**
+ * Minimum gain calibration lookup resolution, in Hz, other than 0.
+ *
+ * @see bladerf_set_gain_calibration_resolution()
+ */
+#define BLADERF_GAIN_CAL_RESOLUTION_MIN 10000
+
+/**
+ * @brief Sets the frequency resolution of the gain calibration lookup table.
+ *
+ * When a gain calibration table is loaded, its corrections are resampled onto
+ * uniformly spaced frequency bins of this width. This allows the correction
+ * applied on each frequency change to be looked up without searching the
+ * calibration table. Corrections between bin edges are linearly interpolated,
+ * so finer resolutions more closely follow the calibration table, at the
+ * expense of memory.
+ *
+ * Channels in the same direction whose calibration was loaded from the same
+ * file share a lookup table.
+ *
+ * Changing the resolution rebuilds the lookup tables of any channels with
+ * loaded calibration tables, and applies to tables loaded afterwards. The
+ * corrected gain is not reapplied until the next frequency or gain change.
+ *
+ * @param[in] dev        Non-NULL pointer to a bladeRF device.
+ * @param[in] resolution Bin width, in Hz. Must be at least
+ *                       ::BLADERF_GAIN_CAL_RESOLUTION_MIN. A value of 0
+ *                       disables the lookup tables, in which case the
+ *                       calibration table is searched directly. Defaults to
+ *                       ::BLADERF_GAIN_CAL_RESOLUTION_DEFAULT.
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if `resolution` is out of range, or
+ * BLADERF_ERR_MEM if a lookup table could not be allocated. In this case, the
+ * affected channels fall back to searching the calibration table.
+ */
+API_EXPORT
+int CALL_CONV bladerf_set_gain_calibration_resolution(
+    struct bladerf *dev, bladerf_frequency resolution);
+
+/**
+ * @brief Gets the frequency resolution of the gain calibration lookup table.
+ *
+ * @param[in]  dev        Non-NULL pointer to a bladeRF device.
+ * @param[out] resolution Bin width, in Hz, or 0 if lookup tables are disabled.
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL for invalid inputs.
+ */
+API_EXPORT
+int CALL_CONV bladerf_get_gain_calibration_resolution(
+    struct bladerf *dev, bladerf_frequency *resolution);
+
 /** @} (End of FN_CAL) */
 
 /**
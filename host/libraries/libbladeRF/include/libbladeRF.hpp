@@ -0,0 +1,708 @@
+/**
+ * @file libbladeRF.hpp
+ *
+ * @brief Optional header-only C++17 interface to libbladeRF
+ *
+ * This wraps the C API in RAII types. Device handles are closed, channels
+ * disabled, and zero-copy stream buffers handed back when the objects that
+ * own them go out of scope. Failures are reported by throwing
+ * bladeRF::error.
+ *
+ * Streams are templated on their sample format and channel count, so that
+ * sample conversion, channel (de)interleaving and buffer size computations
+ * are resolved at compile time:
+ *
+ * @code
+ * bladeRF::device dev;
+ * dev.set_frequency(BLADERF_CHANNEL_RX(0), 915000000);
+ *
+ * bladeRF::rx_stream<bladeRF::sc16q11, 1> rx(dev);
+ *
+ * std::vector<std::complex<float>> iq;
+ * {
+ *     auto buf = rx.acquire();
+ *     iq.resize(buf.size());
+ *     buf.copy_channel(0, iq.data());
+ * } // buf is released back to the stream here
+ * @endcode
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#ifndef LIBBLADERF_HPP_
+#define LIBBLADERF_HPP_
+
+#if __cplusplus < 201703L && (!defined(_MSVC_LANG) || _MSVC_LANG < 201703L)
+#error "libbladeRF.hpp requires C++17"
+#endif
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <libbladeRF.h>
+
+namespace bladeRF
+{
+/**
+ * Exception thrown when a libbladeRF call fails
+ */
+class error : public std::runtime_error
+{
+  public:
+    /**
+     * @param   what    Operation that failed
+     * @param   code    Value from \ref RETCODES list
+     */
+    error(const std::string &what, int code)
+        : std::runtime_error(what + ": " + bladerf_strerror(code)),
+          code_(code)
+    {
+    }
+
+    /** @return Value from \ref RETCODES list */
+    int code() const noexcept { return code_; }
+
+  private:
+    int code_;
+};
+
+namespace detail
+{
+    inline void check(int status, const char *what)
+    {
+        if (status < 0) {
+            throw error(what, status);
+        }
+    }
+} // namespace detail
+
+/**
+ * @defgroup CPP_FORMATS Sample formats
+ *
+ * Each format describes how one I/Q pair is stored in a stream buffer, and
+ * how it converts to and from std::complex<float> in [-1.0, 1.0).
+ *
+ * @{
+ */
+
+/** ::BLADERF_FORMAT_SC16_Q11 */
+struct sc16q11 {
+    using value_type = int16_t;
+    static constexpr bladerf_format format = BLADERF_FORMAT_SC16_Q11;
+    static constexpr float scale = 2048.0f;
+};
+
+/** ::BLADERF_FORMAT_SC8_Q7 */
+struct sc8q7 {
+    using value_type = int8_t;
+    static constexpr bladerf_format format = BLADERF_FORMAT_SC8_Q7;
+    static constexpr float scale = 128.0f;
+};
+
+/** @} (End of CPP_FORMATS) */
+
+namespace detail
+{
+    template <typename Format>
+    inline std::complex<float> to_complex(const typename Format::value_type *p)
+    {
+        constexpr float k = 1.0f / Format::scale;
+        return { p[0] * k, p[1] * k };
+    }
+
+    template <typename Format>
+    inline void from_complex(typename Format::value_type *p,
+                             std::complex<float> v)
+    {
+        using T = typename Format::value_type;
+
+        constexpr float max = Format::scale - 1.0f;
+        constexpr float min = -Format::scale;
+
+        auto conv = [](float x) {
+            x *= Format::scale;
+            x = (x > max) ? max : ((x < min) ? min : x);
+            return static_cast<T>(x + (x < 0.0f ? -0.5f : 0.5f));
+        };
+
+        p[0] = conv(v.real());
+        p[1] = conv(v.imag());
+    }
+
+    template <bool Tx, std::size_t Channels>
+    constexpr bladerf_channel_layout layout()
+    {
+        static_assert(Channels == 1 || Channels == 2,
+                      "Streams support 1 or 2 channels");
+
+        if constexpr (Tx) {
+            return Channels == 1 ? BLADERF_TX_X1 : BLADERF_TX_X2;
+        } else {
+            return Channels == 1 ? BLADERF_RX_X1 : BLADERF_RX_X2;
+        }
+    }
+} // namespace detail
+
+/**
+ * Owning handle to an open device
+ *
+ * The handle is closed when the object is destroyed. Objects may be moved,
+ * but not copied.
+ */
+class device
+{
+  public:
+    /**
+     * Open a device
+     *
+     * @param   identifier  Device identifier, as with bladerf_open(). The
+     *                      default opens the first device found.
+     */
+    explicit device(const std::string &identifier = "")
+    {
+        detail::check(bladerf_open(&dev_, identifier.empty()
+                                              ? nullptr
+                                              : identifier.c_str()),
+                      "bladerf_open");
+    }
+
+    /**
+     * Take ownership of a handle opened through the C API
+     */
+    explicit device(struct bladerf *dev) noexcept : dev_(dev) {}
+
+    device(const device &) = delete;
+    device &operator=(const device &) = delete;
+
+    device(device &&other) noexcept : dev_(std::exchange(other.dev_, nullptr))
+    {
+    }
+
+    device &operator=(device &&other) noexcept
+    {
+        if (this != &other) {
+            close();
+            dev_ = std::exchange(other.dev_, nullptr);
+        }
+        return *this;
+    }
+
+    ~device() { close(); }
+
+    /** @return C API handle, for calls not wrapped here */
+    struct bladerf *get() const noexcept { return dev_; }
+
+    /** Release ownership of the C API handle */
+    struct bladerf *release() noexcept { return std::exchange(dev_, nullptr); }
+
+    void set_frequency(bladerf_channel ch, bladerf_frequency frequency)
+    {
+        detail::check(bladerf_set_frequency(dev_, ch, frequency),
+                      "bladerf_set_frequency");
+    }
+
+    bladerf_frequency frequency(bladerf_channel ch) const
+    {
+        bladerf_frequency frequency;
+        detail::check(bladerf_get_frequency(dev_, ch, &frequency),
+                      "bladerf_get_frequency");
+        return frequency;
+    }
+
+    /** @return Actual sample rate */
+    bladerf_sample_rate set_sample_rate(bladerf_channel ch,
+                                        bladerf_sample_rate rate)
+    {
+        bladerf_sample_rate actual;
+        detail::check(bladerf_set_sample_rate(dev_, ch, rate, &actual),
+                      "bladerf_set_sample_rate");
+        return actual;
+    }
+
+    bladerf_sample_rate sample_rate(bladerf_channel ch) const
+    {
+        bladerf_sample_rate rate;
+        detail::check(bladerf_get_sample_rate(dev_, ch, &rate),
+                      "bladerf_get_sample_rate");
+        return rate;
+    }
+
+    /** @return Actual bandwidth */
+    bladerf_bandwidth set_bandwidth(bladerf_channel ch,
+                                    bladerf_bandwidth bandwidth)
+    {
+        bladerf_bandwidth actual;
+        detail::check(bladerf_set_bandwidth(dev_, ch, bandwidth, &actual),
+                      "bladerf_set_bandwidth");
+        return actual;
+    }
+
+    void set_gain(bladerf_channel ch, bladerf_gain gain)
+    {
+        detail::check(bladerf_set_gain(dev_, ch, gain), "bladerf_set_gain");
+    }
+
+    bladerf_gain gain(bladerf_channel ch) const
+    {
+        bladerf_gain gain;
+        detail::check(bladerf_get_gain(dev_, ch, &gain), "bladerf_get_gain");
+        return gain;
+    }
+
+    void enable_module(bladerf_channel ch, bool enable)
+    {
+        detail::check(bladerf_enable_module(dev_, ch, enable),
+                      "bladerf_enable_module");
+    }
+
+  private:
+    void close() noexcept
+    {
+        if (dev_ != nullptr) {
+            bladerf_close(dev_);
+            dev_ = nullptr;
+        }
+    }
+
+    struct bladerf *dev_ = nullptr;
+};
+
+/**
+ * Synchronous stream configuration, as passed to bladerf_sync_config()
+ */
+struct stream_config {
+    unsigned int num_buffers        = 16;
+    unsigned int buffer_size        = 8192; /**< Samples per buffer */
+    unsigned int num_transfers      = 8;
+    unsigned int timeout_ms         = 3500;
+};
+
+/**
+ * Received buffer, lent by bladerf_sync_rx_acquire()
+ *
+ * The buffer is returned to the stream with bladerf_sync_rx_release() when
+ * the object is destroyed. Objects may be moved, but not copied, and must
+ * not outlive the stream they came from.
+ *
+ * @tparam  Format      Sample format
+ * @tparam  Channels    Number of interleaved channels
+ */
+template <typename Format, std::size_t Channels> class rx_buffer
+{
+  public:
+    using value_type = typename Format::value_type;
+
+    rx_buffer(const rx_buffer &) = delete;
+    rx_buffer &operator=(const rx_buffer &) = delete;
+
+    rx_buffer(rx_buffer &&other) noexcept
+        : dev_(other.dev_),
+          data_(std::exchange(other.data_, nullptr)),
+          num_samples_(other.num_samples_),
+          meta_(other.meta_)
+    {
+    }
+
+    rx_buffer &operator=(rx_buffer &&other) noexcept
+    {
+        if (this != &other) {
+            release();
+            dev_         = other.dev_;
+            data_        = std::exchange(other.data_, nullptr);
+            num_samples_ = other.num_samples_;
+            meta_        = other.meta_;
+        }
+        return *this;
+    }
+
+    ~rx_buffer() { release(); }
+
+    /** @return Number of samples per channel */
+    std::size_t size() const noexcept { return num_samples_ / Channels; }
+
+    /** @return Interleaved I/Q values, 2 * Channels per sample */
+    const value_type *data() const noexcept
+    {
+        return static_cast<const value_type *>(data_);
+    }
+
+    /** @return Position of the first sample, counted from stream start */
+    uint64_t timestamp() const noexcept { return meta_.timestamp; }
+
+    /** @return Sample `n` of channel `ch` */
+    std::complex<float> operator()(std::size_t n, std::size_t ch) const
+    {
+        return detail::to_complex<Format>(&data()[2 * (n * Channels + ch)]);
+    }
+
+    /**
+     * Convert one channel's samples into a contiguous array
+     *
+     * @param   ch      Channel index within the stream
+     * @param   out     Destination, of at least size() elements
+     */
+    void copy_channel(std::size_t ch, std::complex<float> *out) const
+    {
+        const value_type *p = data() + 2 * ch;
+        const std::size_t n = size();
+
+        for (std::size_t i = 0; i < n; i++, p += 2 * Channels) {
+            out[i] = detail::to_complex<Format>(p);
+        }
+    }
+
+    /**
+     * Copy one channel's raw I/Q values into a contiguous array
+     *
+     * @param   ch      Channel index within the stream
+     * @param   out     Destination, of at least 2 * size() elements
+     */
+    void copy_channel(std::size_t ch, value_type *out) const
+    {
+        const value_type *p = data() + 2 * ch;
+        const std::size_t n = size();
+
+        for (std::size_t i = 0; i < n; i++, p += 2 * Channels) {
+            out[2 * i]     = p[0];
+            out[2 * i + 1] = p[1];
+        }
+    }
+
+  private:
+    template <typename, std::size_t> friend class rx_stream;
+
+    rx_buffer(struct bladerf *dev,
+              void *data,
+              unsigned int num_samples,
+              const struct bladerf_metadata &meta) noexcept
+        : dev_(dev), data_(data), num_samples_(num_samples), meta_(meta)
+    {
+    }
+
+    void release() noexcept
+    {
+        if (data_ != nullptr) {
+            bladerf_sync_rx_release(dev_, data_);
+            data_ = nullptr;
+        }
+    }
+
+    struct bladerf *dev_;
+    void *data_;
+    unsigned int num_samples_;
+    struct bladerf_metadata meta_;
+};
+
+/**
+ * Empty buffer to fill in place, lent by bladerf_sync_tx_acquire()
+ *
+ * The buffer is handed back with submit(). If it is destroyed without being
+ * submitted, it is submitted with no samples, which transmits zeros. Objects
+ * may be moved, but not copied, and must not outlive the stream they came
+ * from.
+ *
+ * @tparam  Format      Sample format
+ * @tparam  Channels    Number of interleaved channels
+ */
+template <typename Format, std::size_t Channels> class tx_buffer
+{
+  public:
+    using value_type = typename Format::value_type;
+
+    tx_buffer(const tx_buffer &) = delete;
+    tx_buffer &operator=(const tx_buffer &) = delete;
+
+    tx_buffer(tx_buffer &&other) noexcept
+        : dev_(other.dev_),
+          data_(std::exchange(other.data_, nullptr)),
+          capacity_(other.capacity_)
+    {
+    }
+
+    tx_buffer &operator=(tx_buffer &&other) noexcept
+    {
+        if (this != &other) {
+            abandon();
+            dev_      = other.dev_;
+            data_     = std::exchange(other.data_, nullptr);
+            capacity_ = other.capacity_;
+        }
+        return *this;
+    }
+
+    ~tx_buffer() { abandon(); }
+
+    /** @return Number of samples per channel the buffer holds */
+    std::size_t capacity() const noexcept { return capacity_ / Channels; }
+
+    /** @return Interleaved I/Q values, 2 * Channels per sample */
+    value_type *data() noexcept { return static_cast<value_type *>(data_); }
+
+    /** Set sample `n` of channel `ch` */
+    void set(std::size_t n, std::size_t ch, std::complex<float> v)
+    {
+        detail::from_complex<Format>(&data()[2 * (n * Channels + ch)], v);
+    }
+
+    /**
+     * Fill one channel from a contiguous array
+     *
+     * @param   ch      Channel index within the stream
+     * @param   in      Source samples
+     * @param   n       Number of samples, at most capacity()
+     */
+    void fill_channel(std::size_t ch, const std::complex<float> *in,
+                      std::size_t n)
+    {
+        value_type *p = data() + 2 * ch;
+
+        for (std::size_t i = 0; i < n; i++, p += 2 * Channels) {
+            detail::from_complex<Format>(p, in[i]);
+        }
+    }
+
+    /**
+     * Submit the buffer for transmission. Samples beyond `n` are zeroed.
+     *
+     * @param   n       Number of samples per channel written
+     */
+    void submit(std::size_t n)
+    {
+        void *data = std::exchange(data_, nullptr);
+        detail::check(bladerf_sync_tx_submit(
+                          dev_, data, static_cast<unsigned int>(n * Channels)),
+                      "bladerf_sync_tx_submit");
+    }
+
+  private:
+    template <typename, std::size_t> friend class tx_stream;
+
+    tx_buffer(struct bladerf *dev, void *data, unsigned int capacity) noexcept
+        : dev_(dev), data_(data), capacity_(capacity)
+    {
+    }
+
+    void abandon() noexcept
+    {
+        if (data_ != nullptr) {
+            bladerf_sync_tx_submit(dev_, data_, 0);
+            data_ = nullptr;
+        }
+    }
+
+    struct bladerf *dev_;
+    void *data_;
+    unsigned int capacity_;
+};
+
+namespace detail
+{
+    /* Configures a synchronous stream and enables its channels, disabling
+     * them again on destruction */
+    template <typename Format, bool Tx, std::size_t Channels> class stream
+    {
+      public:
+        stream(const stream &) = delete;
+        stream &operator=(const stream &) = delete;
+
+        stream(stream &&other) noexcept
+            : dev_(std::exchange(other.dev_, nullptr)),
+              timeout_ms_(other.timeout_ms_)
+        {
+        }
+
+        stream &operator=(stream &&other) noexcept
+        {
+            if (this != &other) {
+                disable();
+                dev_        = std::exchange(other.dev_, nullptr);
+                timeout_ms_ = other.timeout_ms_;
+            }
+            return *this;
+        }
+
+        ~stream() { disable(); }
+
+      protected:
+        stream(device &dev, const stream_config &config)
+            : dev_(dev.get()), timeout_ms_(config.timeout_ms)
+        {
+            check(bladerf_sync_config(dev_, layout<Tx, Channels>(),
+                                      Format::format, config.num_buffers,
+                                      config.buffer_size, config.num_transfers,
+                                      config.timeout_ms),
+                  "bladerf_sync_config");
+
+            for (std::size_t i = 0; i < Channels; i++) {
+                const int status = bladerf_enable_module(dev_, channel(i), true);
+                if (status < 0) {
+                    for (std::size_t j = 0; j < i; j++) {
+                        bladerf_enable_module(dev_, channel(j), false);
+                    }
+                    dev_ = nullptr;
+                    throw error("bladerf_enable_module", status);
+                }
+            }
+        }
+
+        static constexpr bladerf_channel channel(std::size_t i)
+        {
+            return Tx ? BLADERF_CHANNEL_TX(static_cast<int>(i))
+                      : BLADERF_CHANNEL_RX(static_cast<int>(i));
+        }
+
+        void disable() noexcept
+        {
+            if (dev_ != nullptr) {
+                for (std::size_t i = 0; i < Channels; i++) {
+                    bladerf_enable_module(dev_, channel(i), false);
+                }
+                dev_ = nullptr;
+            }
+        }
+
+        struct bladerf *dev_;
+        unsigned int timeout_ms_;
+    };
+} // namespace detail
+
+/**
+ * Synchronous RX stream
+ *
+ * Construction configures the stream and enables channels 0 through
+ * Channels - 1. Destruction disables them. The stream must not outlive the
+ * device, and all buffers acquired from it must be destroyed first.
+ *
+ * @tparam  Format      Sample format, e.g. bladeRF::sc16q11
+ * @tparam  Channels    1 for ::BLADERF_RX_X1, 2 for ::BLADERF_RX_X2
+ */
+template <typename Format, std::size_t Channels>
+class rx_stream : public detail::stream<Format, false, Channels>
+{
+    using base = detail::stream<Format, false, Channels>;
+
+  public:
+    using buffer     = rx_buffer<Format, Channels>;
+    using value_type = typename Format::value_type;
+
+    explicit rx_stream(device &dev, const stream_config &config = {})
+        : base(dev, config)
+    {
+    }
+
+    /**
+     * Borrow the next received buffer, without copying it
+     *
+     * @param   timeout_ms  Timeout, or 0 to wait indefinitely. Defaults to
+     *                      the stream's timeout.
+     */
+    buffer acquire() { return acquire(this->timeout_ms_); }
+
+    buffer acquire(unsigned int timeout_ms)
+    {
+        void *data;
+        unsigned int num_samples;
+        struct bladerf_metadata meta = {};
+
+        detail::check(bladerf_sync_rx_acquire(this->dev_, &data, &num_samples,
+                                              &meta, timeout_ms),
+                      "bladerf_sync_rx_acquire");
+
+        return buffer(this->dev_, data, num_samples, meta);
+    }
+
+    /**
+     * Receive into an interleaved array
+     *
+     * @param   out     Destination, of 2 * Channels * n values
+     * @param   n       Number of samples per channel
+     */
+    void receive(value_type *out, std::size_t n)
+    {
+        detail::check(bladerf_sync_rx(this->dev_, out,
+                                      static_cast<unsigned int>(n * Channels),
+                                      nullptr, this->timeout_ms_),
+                      "bladerf_sync_rx");
+    }
+};
+
+/**
+ * Synchronous TX stream
+ *
+ * Construction configures the stream and enables channels 0 through
+ * Channels - 1. Destruction disables them. The stream must not outlive the
+ * device, and all buffers acquired from it must be destroyed first.
+ *
+ * @tparam  Format      Sample format, e.g. bladeRF::sc16q11
+ * @tparam  Channels    1 for ::BLADERF_TX_X1, 2 for ::BLADERF_TX_X2
+ */
+template <typename Format, std::size_t Channels>
+class tx_stream : public detail::stream<Format, true, Channels>
+{
+    using base = detail::stream<Format, true, Channels>;
+
+  public:
+    using buffer     = tx_buffer<Format, Channels>;
+    using value_type = typename Format::value_type;
+
+    explicit tx_stream(device &dev, const stream_config &config = {})
+        : base(dev, config)
+    {
+    }
+
+    /**
+     * Borrow the next empty buffer, to fill in place
+     *
+     * @param   timeout_ms  Timeout, or 0 to wait indefinitely. Defaults to
+     *                      the stream's timeout.
+     */
+    buffer acquire() { return acquire(this->timeout_ms_); }
+
+    buffer acquire(unsigned int timeout_ms)
+    {
+        void *data;
+        unsigned int capacity;
+
+        detail::check(bladerf_sync_tx_acquire(this->dev_, &data, &capacity,
+                                              timeout_ms),
+                      "bladerf_sync_tx_acquire");
+
+        return buffer(this->dev_, data, capacity);
+    }
+
+    /**
+     * Transmit from an interleaved array
+     *
+     * @param   in      Source, of 2 * Channels * n values
+     * @param   n       Number of samples per channel
+     */
+    void send(const value_type *in, std::size_t n)
+    {
+        detail::check(bladerf_sync_tx(this->dev_, in,
+                                      static_cast<unsigned int>(n * Channels),
+                                      nullptr, this->timeout_ms_),
+                      "bladerf_sync_tx");
+    }
+};
+
+} // namespace bladeRF
+
+#endif
@@ -0,0 +1,688 @@
+/**
+ * @file libbladeRF_async.hpp
+ *
+ * @brief Optional header-only C++20 coroutine interface to libbladeRF
+ *
+ * This builds upon libbladeRF.hpp, adding co_await-able stream and control
+ * operations, driven by a single-threaded bladeRF::reactor. One thread can
+ * thereby service many devices, without a blocking thread per device:
+ *
+ * @code
+ * bladeRF::task capture(bladeRF::reactor &r, bladeRF::device &dev)
+ * {
+ *     co_await bladeRF::async_set_frequency(r, dev, BLADERF_CHANNEL_RX(0),
+ *                                           915000000);
+ *
+ *     bladeRF::async_rx_stream<bladeRF::sc16q11, 1> rx(r, dev);
+ *     std::vector<int16_t> iq(2 * 8192);
+ *
+ *     for (;;) {
+ *         co_await rx.async_rx(iq.data(), 8192);
+ *         // ...
+ *     }
+ * }
+ *
+ * bladeRF::reactor r;
+ * r.spawn(capture(r, dev_a));
+ * r.spawn(capture(r, dev_b));
+ * r.run();
+ * @endcode
+ *
+ * Stream operations wait upon the readiness notification returned by
+ * bladerf_sync_get_ready_fd(), and then complete via bladerf_sync_rx_nb() and
+ * bladerf_sync_tx_nb(). Control operations are queued with the asynchronous
+ * control API (see \ref FN_ASYNC_CTRL), and resume the awaiting coroutine on
+ * the reactor's thread once they complete.
+ *
+ * Applications with their own event loop, e.g. Boost.Asio, may instead wait
+ * on the readiness notification themselves, and call the non-blocking
+ * functions directly.
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#ifndef LIBBLADERF_ASYNC_HPP_
+#define LIBBLADERF_ASYNC_HPP_
+
+#include <libbladeRF.hpp>
+
+#if !defined(__cpp_impl_coroutine) || __cpp_impl_coroutine < 201902L
+#error "libbladeRF_async.hpp requires C++20 coroutines"
+#endif
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace bladeRF
+{
+class reactor;
+
+/**
+ * Coroutine returning nothing
+ *
+ * A task does not start until it is either awaited by another coroutine, or
+ * handed to reactor::spawn(). Exceptions propagate to the awaiting
+ * coroutine, or, for spawned tasks, out of reactor::run().
+ */
+class task
+{
+  public:
+    struct promise_type;
+    using handle = std::coroutine_handle<promise_type>;
+
+    struct promise_type {
+        std::coroutine_handle<> continuation;
+        std::exception_ptr exception;
+        reactor *owner = nullptr; /* Set for spawned tasks */
+
+        task get_return_object() noexcept
+        {
+            return task(handle::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct final_awaiter {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(handle h) noexcept;
+            void await_resume() noexcept {}
+        };
+
+        final_awaiter final_suspend() noexcept { return {}; }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept
+        {
+            exception = std::current_exception();
+        }
+    };
+
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+
+    task(task &&other) noexcept : h_(std::exchange(other.h_, nullptr)) {}
+
+    task &operator=(task &&other) noexcept
+    {
+        if (this != &other) {
+            if (h_) {
+                h_.destroy();
+            }
+            h_ = std::exchange(other.h_, nullptr);
+        }
+        return *this;
+    }
+
+    ~task()
+    {
+        if (h_) {
+            h_.destroy();
+        }
+    }
+
+    auto operator co_await() && noexcept
+    {
+        struct awaiter {
+            handle h;
+
+            bool await_ready() noexcept { return false; }
+
+            std::coroutine_handle<> await_suspend(
+                std::coroutine_handle<> caller) noexcept
+            {
+                h.promise().continuation = caller;
+                return h;
+            }
+
+            void await_resume()
+            {
+                if (h.promise().exception) {
+                    std::rethrow_exception(h.promise().exception);
+                }
+            }
+        };
+
+        return awaiter{ h_ };
+    }
+
+  private:
+    friend class reactor;
+
+    explicit task(handle h) noexcept : h_(h) {}
+
+    handle h_;
+};
+
+namespace detail
+{
+    /* Stream operation awaiting a readiness notification. attempt() is
+     * called each time the notification is signalled, and returns true once
+     * the operation has completed, successfully or not. */
+    struct ready_op {
+        bladerf_ready_fd fd;
+        std::coroutine_handle<> waiter;
+
+        virtual bool attempt() noexcept = 0;
+
+      protected:
+        ~ready_op() = default;
+    };
+} // namespace detail
+
+/**
+ * Single-threaded event loop for coroutines using this interface
+ *
+ * All coroutines are resumed on the thread calling run(). Operations of
+ * a reactor, other than post(), must only be used from within that thread,
+ * or before run() is called.
+ */
+class reactor
+{
+  public:
+    reactor()
+    {
+#ifdef _WIN32
+        wake_ = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (wake_ == nullptr) {
+            throw error("CreateEvent", BLADERF_ERR_IO);
+        }
+#else
+        if (pipe(wake_) != 0) {
+            throw error("pipe", BLADERF_ERR_IO);
+        }
+
+        for (int fd : wake_) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+#endif
+    }
+
+    reactor(const reactor &) = delete;
+    reactor &operator=(const reactor &) = delete;
+
+    /** Spawned tasks that have not completed are destroyed */
+    ~reactor()
+    {
+        for (auto h : tasks_) {
+            h.destroy();
+        }
+
+#ifdef _WIN32
+        CloseHandle(wake_);
+#else
+        close(wake_[0]);
+        close(wake_[1]);
+#endif
+    }
+
+    /**
+     * Start a task, which is owned by the reactor until it completes. It
+     * first runs from within the next run() call.
+     */
+    void spawn(task t)
+    {
+        task::handle h = std::exchange(t.h_, nullptr);
+        h.promise().owner = this;
+        tasks_.push_back(h);
+        post(h);
+    }
+
+    /**
+     * Run until all spawned tasks have completed, or stop() is called.
+     *
+     * If a spawned task exits with an exception, it is rethrown here. run()
+     * may then be called again to continue the remaining tasks.
+     */
+    void run()
+    {
+        stopped_ = false;
+
+        while (!stopped_ && !tasks_.empty()) {
+            run_posted();
+
+            if (stopped_ || tasks_.empty()) {
+                break;
+            }
+
+            wait();
+            attempt_ops();
+
+            if (exception_) {
+                std::rethrow_exception(std::exchange(exception_, nullptr));
+            }
+        }
+    }
+
+    /** Make run() return after resuming any ready coroutines */
+    void stop() noexcept { stopped_ = true; }
+
+    /**
+     * Resume a coroutine from within run(). This may be called from any
+     * thread.
+     */
+    void post(std::coroutine_handle<> h)
+    {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            posted_.push_back(h);
+        }
+
+#ifdef _WIN32
+        SetEvent(wake_);
+#else
+        const char c = 0;
+        (void)!write(wake_[1], &c, 1);
+#endif
+    }
+
+    /* Resume op->waiter once op->attempt() succeeds */
+    void add_op(detail::ready_op *op) { ops_.push_back(op); }
+
+  private:
+    friend struct task::promise_type::final_awaiter;
+
+    void task_done(task::handle h) noexcept
+    {
+        for (auto it = tasks_.begin(); it != tasks_.end(); ++it) {
+            if (*it == h) {
+                tasks_.erase(it);
+                break;
+            }
+        }
+
+        if (h.promise().exception && !exception_) {
+            exception_ = h.promise().exception;
+        }
+
+        h.destroy();
+    }
+
+    void run_posted()
+    {
+        std::vector<std::coroutine_handle<>> posted;
+
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            posted.swap(posted_);
+        }
+
+        for (auto h : posted) {
+            h.resume();
+        }
+
+        if (exception_) {
+            std::rethrow_exception(std::exchange(exception_, nullptr));
+        }
+    }
+
+    /* Each op is attempted at least once before run() first waits, as its
+     * notification may have been signalled long before */
+    void attempt_ops()
+    {
+        std::vector<detail::ready_op *> ops;
+        ops.swap(ops_);
+
+        for (auto *op : ops) {
+            if (op->attempt()) {
+                op->waiter.resume();
+            } else {
+                ops_.push_back(op);
+            }
+        }
+    }
+
+    void wait()
+    {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            if (!posted_.empty()) {
+                return;
+            }
+        }
+
+#ifdef _WIN32
+        std::vector<HANDLE> handles{ wake_ };
+        for (auto *op : ops_) {
+            handles.push_back(static_cast<HANDLE>(op->fd));
+        }
+
+        WaitForMultipleObjects(static_cast<DWORD>(handles.size()),
+                               handles.data(), FALSE, INFINITE);
+#else
+        std::vector<struct pollfd> fds{ { wake_[0], POLLIN, 0 } };
+        for (auto *op : ops_) {
+            fds.push_back({ op->fd, POLLIN, 0 });
+        }
+
+        while (poll(fds.data(), fds.size(), -1) < 0 && errno == EINTR) {
+        }
+
+        char buf[64];
+        while (read(wake_[0], buf, sizeof(buf)) > 0) {
+        }
+#endif
+    }
+
+    std::vector<task::handle> tasks_;
+    std::vector<detail::ready_op *> ops_;
+    std::exception_ptr exception_;
+    bool stopped_ = false;
+
+    std::mutex lock_;
+    std::vector<std::coroutine_handle<>> posted_;
+
+#ifdef _WIN32
+    HANDLE wake_;
+#else
+    int wake_[2];
+#endif
+};
+
+inline std::coroutine_handle<> task::promise_type::final_awaiter::await_suspend(
+    handle h) noexcept
+{
+    promise_type &p = h.promise();
+
+    if (p.continuation) {
+        return p.continuation;
+    }
+
+    if (p.owner != nullptr) {
+        p.owner->task_done(h);
+    }
+
+    return std::noop_coroutine();
+}
+
+namespace detail
+{
+    /* Awaitable stream transfer. Tx selects bladerf_sync_tx_nb() rather
+     * than bladerf_sync_rx_nb(). */
+    template <bool Tx> class stream_op : public ready_op
+    {
+      public:
+        using buffer_ptr = std::conditional_t<Tx, const void *, void *>;
+
+        stream_op(reactor &r,
+                  struct bladerf *dev,
+                  bladerf_ready_fd fd,
+                  buffer_ptr samples,
+                  unsigned int num_samples) noexcept
+            : reactor_(r), dev_(dev), samples_(samples),
+              num_samples_(num_samples)
+        {
+            this->fd = fd;
+        }
+
+        bool await_ready() noexcept { return attempt(); }
+
+        void await_suspend(std::coroutine_handle<> h)
+        {
+            waiter = h;
+            reactor_.add_op(this);
+        }
+
+        void await_resume() const
+        {
+            check(status_, Tx ? "bladerf_sync_tx_nb" : "bladerf_sync_rx_nb");
+        }
+
+        bool attempt() noexcept override
+        {
+            if constexpr (Tx) {
+                status_ = bladerf_sync_tx_nb(dev_, samples_, num_samples_,
+                                             nullptr);
+            } else {
+                status_ = bladerf_sync_rx_nb(dev_, samples_, num_samples_,
+                                             nullptr);
+            }
+
+            return status_ != BLADERF_ERR_WOULD_BLOCK;
+        }
+
+      private:
+        reactor &reactor_;
+        struct bladerf *dev_;
+        buffer_ptr samples_;
+        unsigned int num_samples_;
+        int status_ = 0;
+    };
+
+    inline bladerf_ready_fd ready_fd(struct bladerf *dev, bladerf_direction dir)
+    {
+        bladerf_ready_fd fd;
+        check(bladerf_sync_get_ready_fd(dev, dir, &fd),
+              "bladerf_sync_get_ready_fd");
+        return fd;
+    }
+
+    /* Awaitable asynchronous control operation. Submit queues the operation
+     * with the completion callback and user data it is given, and returns
+     * the submission status. */
+    template <typename Submit> class ctrl_op
+    {
+      public:
+        ctrl_op(reactor &r, const char *what, Submit submit)
+            : reactor_(r), what_(what), submit_(std::move(submit))
+        {
+        }
+
+        bool await_ready() noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> h) noexcept
+        {
+            waiter_ = h;
+            status_ = submit_(&ctrl_op::complete, this);
+
+            /* Resume immediately if the operation could not be queued */
+            return status_ == 0;
+        }
+
+        void await_resume() const { check(status_, what_); }
+
+      private:
+        static void complete(struct bladerf *, int status, void *user_data)
+        {
+            auto *op    = static_cast<ctrl_op *>(user_data);
+            op->status_ = status;
+            op->reactor_.post(op->waiter_);
+        }
+
+        reactor &reactor_;
+        const char *what_;
+        Submit submit_;
+        std::coroutine_handle<> waiter_;
+        int status_ = 0;
+    };
+
+    template <typename Submit>
+    ctrl_op<Submit> make_ctrl_op(reactor &r, const char *what, Submit submit)
+    {
+        return ctrl_op<Submit>(r, what, std::move(submit));
+    }
+} // namespace detail
+
+/**
+ * Synchronous RX stream with awaitable transfers
+ *
+ * @tparam  Format      Sample format, e.g. bladeRF::sc16q11
+ * @tparam  Channels    1 for ::BLADERF_RX_X1, 2 for ::BLADERF_RX_X2
+ */
+template <typename Format, std::size_t Channels>
+class async_rx_stream : public rx_stream<Format, Channels>
+{
+  public:
+    using value_type = typename Format::value_type;
+
+    async_rx_stream(reactor &r, device &dev, const stream_config &config = {})
+        : rx_stream<Format, Channels>(dev, config), reactor_(&r),
+          fd_(detail::ready_fd(this->dev_, BLADERF_RX))
+    {
+    }
+
+    /**
+     * Receive into an interleaved array
+     *
+     * The request must fit within the samples the stream can hold:
+     * `(num_buffers - num_transfers) * buffer_size` per the stream_config.
+     * Only one transfer may be outstanding at a time.
+     *
+     * @param   out     Destination, of 2 * Channels * n values. This must
+     *                  remain valid until the transfer completes.
+     * @param   n       Number of samples per channel
+     */
+    [[nodiscard]] detail::stream_op<false> async_rx(value_type *out,
+                                                    std::size_t n)
+    {
+        return detail::stream_op<false>(
+            *reactor_, this->dev_, fd_, out,
+            static_cast<unsigned int>(n * Channels));
+    }
+
+  private:
+    reactor *reactor_;
+    bladerf_ready_fd fd_;
+};
+
+/**
+ * Synchronous TX stream with awaitable transfers
+ *
+ * @tparam  Format      Sample format, e.g. bladeRF::sc16q11
+ * @tparam  Channels    1 for ::BLADERF_TX_X1, 2 for ::BLADERF_TX_X2
+ */
+template <typename Format, std::size_t Channels>
+class async_tx_stream : public tx_stream<Format, Channels>
+{
+  public:
+    using value_type = typename Format::value_type;
+
+    async_tx_stream(reactor &r, device &dev, const stream_config &config = {})
+        : tx_stream<Format, Channels>(dev, config), reactor_(&r),
+          fd_(detail::ready_fd(this->dev_, BLADERF_TX))
+    {
+    }
+
+    /**
+     * Transmit from an interleaved array
+     *
+     * The request must fit within the samples the stream can hold:
+     * `(num_buffers - 1) * buffer_size` per the stream_config. Only one
+     * transfer may be outstanding at a time.
+     *
+     * @param   in      Source, of 2 * Channels * n values. This must remain
+     *                  valid until the transfer completes.
+     * @param   n       Number of samples per channel
+     */
+    [[nodiscard]] detail::stream_op<true> async_tx(const value_type *in,
+                                                   std::size_t n)
+    {
+        return detail::stream_op<true>(
+            *reactor_, this->dev_, fd_, in,
+            static_cast<unsigned int>(n * Channels));
+    }
+
+  private:
+    reactor *reactor_;
+    bladerf_ready_fd fd_;
+};
+
+/**
+ * @defgroup CPP_ASYNC_CTRL Awaitable control operations
+ *
+ * These queue an operation with the asynchronous control API, and resume the
+ * awaiting coroutine on the reactor's thread once it completes. Operations
+ * on a device complete in the order they were queued.
+ *
+ * @{
+ */
+
+[[nodiscard]] inline auto async_set_frequency(reactor &r,
+                                              device &dev,
+                                              bladerf_channel ch,
+                                              bladerf_frequency frequency)
+{
+    return detail::make_ctrl_op(
+        r, "bladerf_set_frequency_async",
+        [d = dev.get(), ch, frequency](bladerf_ctrl_cb cb, void *user_data) {
+            return bladerf_set_frequency_async(d, ch, frequency, cb, user_data);
+        });
+}
+
+[[nodiscard]] inline auto async_set_gain(reactor &r,
+                                         device &dev,
+                                         bladerf_channel ch,
+                                         bladerf_gain gain)
+{
+    return detail::make_ctrl_op(
+        r, "bladerf_set_gain_async",
+        [d = dev.get(), ch, gain](bladerf_ctrl_cb cb, void *user_data) {
+            return bladerf_set_gain_async(d, ch, gain, cb, user_data);
+        });
+}
+
+[[nodiscard]] inline auto async_schedule_retune(reactor &r,
+                                                device &dev,
+                                                bladerf_channel ch,
+                                                bladerf_timestamp timestamp,
+                                                bladerf_frequency frequency)
+{
+    return detail::make_ctrl_op(
+        r, "bladerf_schedule_retune_async",
+        [d = dev.get(), ch, timestamp, frequency](bladerf_ctrl_cb cb,
+                                                  void *user_data) {
+            return bladerf_schedule_retune_async(d, ch, timestamp, frequency,
+                                                 nullptr, cb, user_data);
+        });
+}
+
+/**
+ * @param[out]  timestamp   Written before the awaiting coroutine resumes.
+ *                          This must remain valid until then.
+ */
+[[nodiscard]] inline auto async_get_timestamp(reactor &r,
+                                              device &dev,
+                                              bladerf_direction dir,
+                                              bladerf_timestamp &timestamp)
+{
+    return detail::make_ctrl_op(
+        r, "bladerf_get_timestamp_async",
+        [d = dev.get(), dir, t = &timestamp](bladerf_ctrl_cb cb,
+                                             void *user_data) {
+            return bladerf_get_timestamp_async(d, dir, t, cb, user_data);
+        });
+}
+
+/** @} (End of CPP_ASYNC_CTRL) */
+
+} // namespace bladeRF
+
+#endif
@@ -0,0 +1,216 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libbladeRF.h>
+
+#include "log.h"
+
+#include "helpers/wallclock.h"
+
+#define ADSB_CHANNEL            BLADERF_CHANNEL_RX(0)
+
+/* Messages trickle in at a few thousand per second at most, so small
+ * buffers keep latency low without costing throughput */
+#define ADSB_BUFFERS            16
+#define ADSB_BUFFER_SIZE        1024
+#define ADSB_TRANSFERS          8
+#define ADSB_TIMEOUT_MS         1000
+
+/* Size of a message word, in bytes, and in SC16 Q11 "samples" */
+#define ADSB_WORD_BYTES         16
+#define ADSB_WORD_SAMPLES       (ADSB_WORD_BYTES / 4)
+
+/* Mode S parity generator polynomial, without its x^24 term */
+#define ADSB_CRC_POLY           0xfff409
+
+/* Mode S CRC-24 over the first `len` bytes of `data` */
+static uint32_t adsb_crc(const uint8_t *data, unsigned int len)
+{
+    uint32_t crc = 0;
+    unsigned int i, b;
+
+    for (i = 0; i < len; i++) {
+        crc ^= (uint32_t)data[i] << 16;
+        for (b = 0; b < 8; b++) {
+            crc <<= 1;
+            if (crc & 0x1000000) {
+                crc ^= ADSB_CRC_POLY;
+            }
+        }
+    }
+
+    return crc & 0xffffff;
+}
+
+void bladerf_adsb_parse(struct bladerf_adsb_msg *msg)
+{
+    uint32_t parity, residual;
+
+    msg->df  = msg->data[0] >> 3;
+    msg->len = (msg->df >= 16) ? BLADERF_ADSB_LONG_LEN
+                               : BLADERF_ADSB_SHORT_LEN;
+
+    parity   = ((uint32_t)msg->data[msg->len - 3] << 16) |
+               ((uint32_t)msg->data[msg->len - 2] << 8) |
+               msg->data[msg->len - 1];
+    residual = adsb_crc(msg->data, msg->len - 3) ^ parity;
+
+    switch (msg->df) {
+        case 11:
+            /* All-call replies overlay the parity with the interrogator's
+             * identifier, in its 7 least significant bits */
+            msg->address = ((uint32_t)msg->data[1] << 16) |
+                           ((uint32_t)msg->data[2] << 8) | msg->data[3];
+            msg->crc_ok  = (residual & ~0x7fu) == 0;
+            break;
+
+        case 17:
+        case 18:
+            msg->address = ((uint32_t)msg->data[1] << 16) |
+                           ((uint32_t)msg->data[2] << 8) | msg->data[3];
+            msg->crc_ok  = residual == 0;
+            break;
+
+        default:
+            /* Address/parity: the residual is the address itself */
+            msg->address = residual;
+            msg->crc_ok  = false;
+            break;
+    }
+}
+
+/* Unpack a word from the stream. Returns false for padding. */
+static bool adsb_unpack(const uint8_t *word, struct bladerf_adsb_msg *msg)
+{
+    unsigned int i;
+    bool padding = true;
+
+    for (i = 0; i < ADSB_WORD_BYTES; i++) {
+        if (word[i] != 0) {
+            padding = false;
+            break;
+        }
+    }
+
+    if (padding) {
+        return false;
+    }
+
+    /* Bits 111 to 0 hold the message, with its first byte in the most
+     * significant position, and words arrive least significant byte first */
+    for (i = 0; i < BLADERF_ADSB_LONG_LEN; i++) {
+        msg->data[i] = word[BLADERF_ADSB_LONG_LEN - 1 - i];
+    }
+
+    bladerf_adsb_parse(msg);
+
+    /* Clear whatever follows a short message */
+    if (msg->len == BLADERF_ADSB_SHORT_LEN) {
+        memset(&msg->data[BLADERF_ADSB_SHORT_LEN], 0,
+               BLADERF_ADSB_LONG_LEN - BLADERF_ADSB_SHORT_LEN);
+    }
+
+    return true;
+}
+
+static int adsb_run(struct bladerf *dev,
+                    const struct bladerf_adsb_config *config,
+                    int16_t *buf)
+{
+    const unsigned int timeout_ms =
+        (config->timeout_ms == 0) ? ADSB_TIMEOUT_MS : config->timeout_ms;
+    struct bladerf_adsb_msg msg;
+    unsigned int i;
+    int status;
+
+    while (true) {
+        status = bladerf_sync_rx(dev, buf, ADSB_BUFFER_SIZE, NULL, timeout_ms);
+        if (status != 0) {
+            return status;
+        }
+
+        memset(&msg, 0, sizeof(msg));
+        msg.time_us = wallclock_get_current_nsec() / 1000;
+
+        for (i = 0; i < ADSB_BUFFER_SIZE; i += ADSB_WORD_SAMPLES) {
+            if (!adsb_unpack((const uint8_t *)&buf[2 * i], &msg)) {
+                continue;
+            }
+
+            if (config->crc_ok_only && !msg.crc_ok) {
+                continue;
+            }
+
+            if (config->callback(dev, &msg, config->user_data) != 0) {
+                return 0;
+            }
+        }
+    }
+}
+
+int bladerf_adsb_rx(struct bladerf *dev,
+                    const struct bladerf_adsb_config *config)
+{
+    int16_t *buf = NULL;
+    int status;
+    int restore_status;
+
+    if (config == NULL || config->callback == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    buf = malloc(2 * sizeof(buf[0]) * ADSB_BUFFER_SIZE);
+    if (buf == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    status = bladerf_sync_config(dev, BLADERF_RX_X1, BLADERF_FORMAT_SC16_Q11,
+                                 ADSB_BUFFERS, ADSB_BUFFER_SIZE,
+                                 ADSB_TRANSFERS, ADSB_TIMEOUT_MS);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = bladerf_enable_module(dev, ADSB_CHANNEL, true);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = adsb_run(dev, config, buf);
+    if (status != 0) {
+        log_debug("%s: Reception failed: %s\n", __FUNCTION__,
+                  bladerf_strerror(status));
+    }
+
+    restore_status = bladerf_enable_module(dev, ADSB_CHANNEL, false);
+    if (status == 0) {
+        status = restore_status;
+    }
+
+out:
+    free(buf);
+    return status;
+}
@@ -0,0 +1,332 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <libbladeRF.h>
+
+#include "host_config.h"
+#include "log.h"
+
+#include "backend/backend.h"
+#include "board/board.h"
+#include "streaming/format.h"
+#include "agc.h"
+
+/* mean_power of a full-scale SC16 Q11 sinusoid */
+#define AGC_FULL_SCALE_POWER (2048.0 * 2048.0)
+
+struct agc {
+    struct bladerf_sync_rx_agc config;
+    int min_gain;
+    int max_gain;
+
+    /* Gain last requested */
+    int gain;
+
+    /* Cleared once bladerf_schedule_gain() reports that it is unsupported */
+    bool can_schedule;
+
+    /* Positions are RX timestamps for the metadata formats. Otherwise, they
+     * count the samples per channel returned since the AGC was enabled, in
+     * `count`. */
+    bool timed;
+    uint64_t count;
+    uint64_t last_end;
+
+    /* Position at which the last change takes effect, and whether it has
+     * yet to be reported. Decisions resume at `settle_pos`. */
+    bool pending;
+    uint64_t change_pos;
+    uint64_t settle_pos;
+};
+
+/* Gain change, in dB, toward the target for one channel's statistics */
+static int agc_decide(const struct agc *a,
+                      const struct bladerf_rx_channel_stats *st)
+{
+    double power_db, err;
+
+    if (st->count == 0) {
+        return 0;
+    }
+
+    if ((double)st->clipped > a->config.clip_fraction * (double)st->count) {
+        return -a->config.max_step;
+    }
+
+    /* Floored at 1 to keep silence finite, some 66 dB below full scale */
+    power_db = 10.0 * log10(fmax(st->mean_power, 1.0) / AGC_FULL_SCALE_POWER);
+    err      = a->config.target_dbfs - power_db;
+
+    if (fabs(err) <= a->config.hysteresis_db) {
+        return 0;
+    } else if (err > a->config.max_step) {
+        return a->config.max_step;
+    } else if (err < -a->config.max_step) {
+        return -a->config.max_step;
+    }
+
+    return (int)lround(err);
+}
+
+/* Change the gain by `step` dB, at `end` + lead_samples where the change can
+ * be scheduled, or at once */
+static void agc_apply(struct bladerf *dev,
+                      struct agc *a,
+                      bladerf_channel ch,
+                      int step,
+                      uint64_t end)
+{
+    int gain = a->gain + step;
+    uint64_t change_pos;
+    int status;
+
+    if (gain < a->min_gain) {
+        gain = a->min_gain;
+    } else if (gain > a->max_gain) {
+        gain = a->max_gain;
+    }
+
+    if (gain == a->gain) {
+        return;
+    }
+
+    if (a->timed && a->can_schedule) {
+        change_pos = end + a->config.lead_samples;
+        status     = bladerf_schedule_gain(dev, ch, change_pos, gain);
+
+        if (status == 0) {
+            goto applied;
+        } else if (status != BLADERF_ERR_UNSUPPORTED) {
+            log_debug("%s: Failed to schedule gain of %d dB: %s\n",
+                      __FUNCTION__, gain, bladerf_strerror(status));
+            return;
+        }
+
+        log_debug("%s: Scheduled gain changes are unsupported, setting the "
+                  "gain at once instead\n", __FUNCTION__);
+        a->can_schedule = false;
+    }
+
+    status = bladerf_set_gain(dev, ch, gain);
+    if (status != 0) {
+        log_debug("%s: Failed to set gain of %d dB: %s\n", __FUNCTION__, gain,
+                  bladerf_strerror(status));
+        return;
+    }
+
+    /* Reported by the next call */
+    change_pos = end;
+
+applied:
+    a->gain       = gain;
+    a->pending    = true;
+    a->change_pos = change_pos;
+    a->settle_pos = change_pos + a->config.settle_samples;
+}
+
+void agc_update(struct bladerf *dev,
+                unsigned int num_samples,
+                bool per_channel,
+                struct bladerf_metadata *meta)
+{
+    struct bladerf_rx_stats stats;
+    bladerf_format format;
+    size_t num_ch, i;
+    bool configured, have_stats, timed;
+    uint64_t per_ch;
+
+    if (ATOMIC_LOAD(&dev->agc_count) == 0) {
+        return;
+    }
+
+    MUTEX_LOCK(&dev->rx_history_lock);
+    configured = dev->rx_sync_configured;
+    format     = dev->rx_sync_format;
+    num_ch     = dev->rx_sync_channels;
+    MUTEX_UNLOCK(&dev->rx_history_lock);
+
+    if (!configured || num_ch == 0) {
+        return;
+    }
+
+    switch (wire_format(format)) {
+        case BLADERF_FORMAT_SC16_Q11_META:
+        case BLADERF_FORMAT_SC8_Q7_META:
+        case BLADERF_FORMAT_SC12_PACKED_META:
+            timed = (meta != NULL);
+            break;
+
+        default:
+            timed = false;
+            break;
+    }
+
+    per_ch = timed ? meta->actual_count : num_samples;
+    if (!per_channel) {
+        per_ch /= num_ch;
+    }
+
+    have_stats = (bladerf_get_sync_rx_stats(dev, &stats) == 0);
+    MUTEX_LOCK(&dev->agc_lock);
+
+    for (i = 0; i < num_ch && i < ARRAY_SIZE(dev->agc); i++) {
+        struct agc *a = dev->agc[i];
+        uint64_t start, end;
+        int step;
+
+        if (a == NULL) {
+            continue;
+        }
+
+        if (timed) {
+            start = meta->timestamp;
+        } else {
+            start = a->count;
+            a->count += per_ch;
+        }
+        end = start + per_ch;
+
+        /* Positions from before a change of format, or from a stream since
+         * reconfigured, no longer apply */
+        if (a->timed != timed || start < a->last_end) {
+            a->timed      = timed;
+            a->pending    = false;
+            a->settle_pos = 0;
+        }
+        a->last_end = end;
+
+        if (a->pending && a->change_pos < end) {
+            if (meta != NULL) {
+                meta->status |= BLADERF_META_STATUS_GAIN_CHANGE;
+            }
+            a->pending = false;
+        }
+
+        if (!have_stats || per_ch == 0 || a->pending ||
+            start < a->settle_pos) {
+            continue;
+        }
+
+        step = agc_decide(a, &stats.channel[i]);
+        if (step != 0) {
+            agc_apply(dev, a, BLADERF_CHANNEL_RX(i), step, end);
+        }
+    }
+
+    MUTEX_UNLOCK(&dev->agc_lock);
+}
+
+void agc_free(struct bladerf *dev)
+{
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(dev->agc); i++) {
+        free(dev->agc[i]);
+        dev->agc[i] = NULL;
+    }
+
+    ATOMIC_STORE(&dev->agc_count, 0);
+}
+
+/******************************************************************************/
+/* Public API */
+/******************************************************************************/
+
+int bladerf_set_sync_rx_agc(struct bladerf *dev,
+                            bladerf_channel ch,
+                            const struct bladerf_sync_rx_agc *config)
+{
+    struct bladerf_range const *range = NULL;
+    bladerf_gain_mode mode;
+    struct agc *a = NULL;
+    size_t const idx = ch >> 1;
+    int gain;
+    int status;
+
+    if (BLADERF_CHANNEL_IS_TX(ch) || idx >= ARRAY_SIZE(dev->agc)) {
+        log_debug("%s: Invalid channel: %d\n", __FUNCTION__, ch);
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (config != NULL &&
+        (config->max_step < 1 || !(config->hysteresis_db >= 0.0f) ||
+         !(config->clip_fraction >= 0.0f && config->clip_fraction <= 1.0f))) {
+        log_debug("%s: Invalid configuration\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->agc_lock);
+
+    if (config == NULL) {
+        status = 0;
+        goto out;
+    }
+
+    status = bladerf_get_gain_mode(dev, ch, &mode);
+    if (status == 0 && mode != BLADERF_GAIN_MGC) {
+        log_debug("%s: Channel is not in manual gain mode\n", __FUNCTION__);
+        status = BLADERF_ERR_INVAL;
+    }
+
+    if (status == 0) {
+        status = bladerf_get_gain_range(dev, ch, &range);
+    }
+
+    if (status == 0) {
+        status = bladerf_get_gain(dev, ch, &gain);
+    }
+
+    if (status != 0) {
+        MUTEX_UNLOCK(&dev->agc_lock);
+        return status;
+    }
+
+    a = calloc(1, sizeof(*a));
+    if (a == NULL) {
+        MUTEX_UNLOCK(&dev->agc_lock);
+        return BLADERF_ERR_MEM;
+    }
+
+    a->config       = *config;
+    a->min_gain     = (int)ceil(range->min * range->scale);
+    a->max_gain     = (int)floor(range->max * range->scale);
+    a->gain         = gain;
+    a->can_schedule = true;
+
+out:
+    if (dev->agc[idx] != NULL) {
+        ATOMIC_DEC(&dev->agc_count);
+    }
+    free(dev->agc[idx]);
+
+    dev->agc[idx] = a;
+    if (a != NULL) {
+        ATOMIC_INC(&dev->agc_count);
+    }
+
+    MUTEX_UNLOCK(&dev->agc_lock);
+    return status;
+}
@@ -0,0 +1,57 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AGC_H_
+#define AGC_H_
+
+#include <stdbool.h>
+
+#include <libbladeRF.h>
+
+/* AGC state of one RX channel, enabled by bladerf_set_sync_rx_agc() */
+struct agc;
+
+/**
+ * Report gain changes affecting the samples just returned by a successful
+ * bladerf_sync_rx() or bladerf_sync_rx_multi() call, and decide on the next
+ * change from their statistics. This returns at once if no channel has the
+ * AGC enabled. The caller must not hold dev->lock.
+ *
+ * @param       dev             Device handle
+ * @param[in]   num_samples     Number of samples requested by the call
+ * @param[in]   per_channel     True if `num_samples` and the `actual_count`
+ *                              of `meta` are per channel, as for
+ *                              bladerf_sync_rx_multi()
+ * @param       meta            Metadata returned by the call, or NULL
+ */
+void agc_update(struct bladerf *dev,
+                unsigned int num_samples,
+                bool per_channel,
+                struct bladerf_metadata *meta);
+
+/**
+ * Free the AGC state of all channels, for bladerf_close()
+ *
+ * @param       dev             Device handle
+ */
+void agc_free(struct bladerf *dev);
+
+#endif
@@ -114,6 +114,45 @@ int backend_probe(backend_probe_target probe_target,
     return status;
 }
 
+int backend_hotplug_start(backend_hotplug_cb cb)
+{
+    int status;
+    int ret = BLADERF_ERR_UNSUPPORTED;
+    size_t i;
+    const size_t n_backends = ARRAY_SIZE(backend_list);
+
+    for (i = 0; i < n_backends; i++) {
+        status = backend_list[i]->hotplug_start(cb);
+
+        if (status == 0) {
+            ret = 0;
+        } else if (status != BLADERF_ERR_UNSUPPORTED) {
+            log_debug("Failed to start hotplug on backend %d: %s\n",
+                      i, bladerf_strerror(status));
+
+            if (ret == BLADERF_ERR_UNSUPPORTED) {
+                ret = status;
+            }
+        }
+    }
+
+    if (ret != 0) {
+        backend_hotplug_stop();
+    }
+
+    return ret;
+}
+
+void backend_hotplug_stop(void)
+{
+    size_t i;
+    const size_t n_backends = ARRAY_SIZE(backend_list);
+
+    for (i = 0; i < n_backends; i++) {
+        backend_list[i]->hotplug_stop();
+    }
+}
+
 int backend_load_fw_from_bootloader(bladerf_backend backend,
                                     uint8_t bus, uint8_t addr,
                                     struct fx3_firmware *fw)
@@ -145,6 +184,12 @@ const char *backend2str(bladerf_backend backend)
         case BLADERF_BACKEND_CYPRESS:
             return BACKEND_STR_CYPRESS;
 
+        case BLADERF_BACKEND_DUMMY:
+            return BACKEND_STR_DUMMY;
+
+        case BLADERF_BACKEND_NET:
+            return BACKEND_STR_NET;
+
         default:
             return BACKEND_STR_ANY;
     }
@@ -160,6 +205,10 @@ int str2backend(const char *str, bladerf_backend *backend)
         *backend = BLADERF_BACKEND_LINUX;
     } else if (!strcasecmp(BACKEND_STR_CYPRESS, str)) {
         *backend = BLADERF_BACKEND_CYPRESS;
+    } else if (!strcasecmp(BACKEND_STR_DUMMY, str)) {
+        *backend = BLADERF_BACKEND_DUMMY;
+    } else if (!strcasecmp(BACKEND_STR_NET, str)) {
+        *backend = BLADERF_BACKEND_NET;
     } else if (!strcasecmp(BACKEND_STR_ANY, str)) {
         *backend = BLADERF_BACKEND_ANY;
     } else {
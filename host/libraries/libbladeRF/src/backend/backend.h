@@ -37,6 +37,8 @@
 #define BACKEND_STR_LIBUSB "libusb"
 #define BACKEND_STR_LINUX "linux"
 #define BACKEND_STR_CYPRESS "cypress"
+#define BACKEND_STR_DUMMY "dummy"
+#define BACKEND_STR_NET "net"
 
 /**
  * Specifies what to probe for
@@ -44,6 +46,10 @@
 typedef enum {
     BACKEND_PROBE_BLADERF,
     BACKEND_PROBE_FX3_BOOTLOADER,
+
+    /* bladeRF devices, without opening them to read their serial numbers and
+     * description strings, unless these were already read by this process */
+    BACKEND_PROBE_BLADERF_QUICK,
 } backend_probe_target;
 
 /**
@@ -56,6 +62,16 @@ typedef enum {
 
 struct bladerf_devinfo_list;
 struct fx3_firmware;
+struct fpga_image;
+
+/**
+ * Hotplug notification, made by backends from their own event thread.
+ *
+ * For departures, only the `backend`, `usb_bus`, and `usb_addr` fields of
+ * `info` are required to be valid.
+ */
+typedef void (*backend_hotplug_cb)(const struct bladerf_devinfo *info,
+                                   bool arrived);
 
 /**
  * Backend-specific function table
@@ -76,6 +92,13 @@ struct backend_fns {
     int (*probe)(backend_probe_target probe_target,
                  struct bladerf_devinfo_list *info_list);
 
+    /* Start and stop delivering hotplug notifications for bladeRF devices.
+     * Arrivals of devices already attached are reported before
+     * hotplug_start() returns. Backends that do not support this return
+     * BLADERF_ERR_UNSUPPORTED. */
+    int (*hotplug_start)(backend_hotplug_cb cb);
+    void (*hotplug_stop)(void);
+
     /* Get VID and PID of the device */
     int (*get_vid_pid)(struct bladerf *dev, uint16_t *vid, uint16_t *pid);
 
@@ -98,10 +121,8 @@ struct backend_fns {
     /* Get handle */
     int (*get_handle)(struct bladerf *dev, void **handle);
 
-    /* FPGA Loading and checking */
-    int (*load_fpga)(struct bladerf *dev,
-                     const uint8_t *image,
-                     size_t image_size);
+    /* FPGA Loading and checking. The image is read as it is sent. */
+    int (*load_fpga)(struct bladerf *dev, struct fpga_image *image);
     int (*is_fpga_configured)(struct bladerf *dev);
     bladerf_fpga_source (*get_fpga_source)(struct bladerf *dev);
 
@@ -110,6 +131,11 @@ struct backend_fns {
     int (*get_fpga_version)(struct bladerf *dev,
                             struct bladerf_version *version);
 
+    /* Configuration ID retained by the FPGA until it is reconfigured. Used to
+     * recognize a device left configured by an earlier open. */
+    int (*get_config_id)(struct bladerf *dev, uint64_t *id);
+    int (*set_config_id)(struct bladerf *dev, uint64_t id);
+
     /* Flash operations */
 
     /* Erase the specified number of erase blocks */
@@ -127,10 +153,24 @@ struct backend_fns {
                              uint32_t page,
                              uint32_t count);
 
+    /* Check the specified number of pages against `expected` without reading
+     * them back. Returns BLADERF_ERR_CHECKSUM on a mismatch, or
+     * BLADERF_ERR_UNSUPPORTED if the device cannot do this. */
+    int (*verify_flash_pages)(struct bladerf *dev,
+                              const uint8_t *expected,
+                              uint32_t page,
+                              uint32_t count);
+
     /* Device startup and reset */
     int (*device_reset)(struct bladerf *dev);
     int (*jump_to_bootloader)(struct bladerf *dev);
 
+    /* Reestablish the link to the device after a stream failed, finding it
+     * again if it re-enumerates, and restore the state of its sample
+     * interface, so that existing streams may be restarted. Fails with
+     * BLADERF_ERR_NODEV if the FPGA was unconfigured. May be NULL. */
+    int (*recover)(struct bladerf *dev);
+
     /* Platform information */
     int (*get_cal)(struct bladerf *dev, char *cal);
     int (*get_otp)(struct bladerf *dev, char *otp);
@@ -180,6 +220,12 @@ struct backend_fns {
                          bladerf_direction dir,
                          uint64_t *value);
 
+    /* Get the time at which a trigger last fired, in half-sample periods */
+    int (*get_trigger_time)(struct bladerf *dev,
+                            bladerf_direction dir,
+                            bool *fired,
+                            uint64_t *value);
+
     /* Si5338 accessors */
     int (*si5338_write)(struct bladerf *dev, uint8_t addr, uint8_t data);
     int (*si5338_read)(struct bladerf *dev, uint8_t addr, uint8_t *data);
@@ -218,6 +264,10 @@ struct backend_fns {
                               uint8_t rffe_profile,
                               uint16_t nios_profile);
 
+    /* RX NCO and decimation control accessors */
+    int (*rx_decim_write)(struct bladerf *dev, uint32_t value);
+    int (*rx_decim_read)(struct bladerf *dev, uint32_t *value);
+
     /* AD56X1 VCTCXO Trim DAC accessors */
     int (*ad56x1_vctcxo_trim_dac_write)(struct bladerf *dev, uint16_t value);
     int (*ad56x1_vctcxo_trim_dac_read)(struct bladerf *dev, uint16_t *value);
@@ -242,11 +292,36 @@ struct backend_fns {
     int (*set_firmware_loopback)(struct bladerf *dev, bool enable);
     int (*get_firmware_loopback)(struct bladerf *dev, bool *is_enabled);
 
+    /* Set the number of firmware DMA buffers in each RF sample channel,
+     * restarting the RF link if the running channels use another count.
+     * This must not be called while samples are streaming. */
+    int (*set_rf_dma_buffers)(struct bladerf *dev, unsigned int count);
+
+    /* Set the number of firmware DMA buffers in one direction's RF sample
+     * channel. Only that channel is rebuilt, so this may be called while
+     * the other direction streams, but not while this direction is
+     * enabled. */
+    int (*set_rf_dma_channel)(struct bladerf *dev,
+                              bladerf_direction dir,
+                              unsigned int count);
+
     /* Sample stream */
     int (*enable_module)(struct bladerf *dev,
                          bladerf_direction dir,
                          bool enable);
 
+    /* Allocate the contiguous block of memory backing a stream's sample
+     * buffers. Backends without a preferred allocator return
+     * BLADERF_ERR_UNSUPPORTED, in which case the caller falls back to a
+     * page-aligned heap allocation. Memory obtained from this function must
+     * be released with free_stream_buffers(). */
+    int (*alloc_stream_buffers)(struct bladerf_stream *stream,
+                                size_t size,
+                                void **buf);
+    void (*free_stream_buffers)(struct bladerf_stream *stream,
+                                void *buf,
+                                size_t size);
+
     int (*init_stream)(struct bladerf_stream *stream, size_t num_transfers);
     int (*stream)(struct bladerf_stream *stream, bladerf_channel_layout layout);
     int (*submit_stream_buffer)(struct bladerf_stream *stream,
@@ -277,6 +352,65 @@ struct backend_fns {
                    uint8_t port,
                    uint8_t spdt);
 
+    /* Schedule a gain change in the retune2 queue. See nios_pkt_retune2.h */
+    int (*retune2_gain)(struct bladerf *dev,
+                        bladerf_channel ch,
+                        uint64_t timestamp,
+                        uint16_t setting);
+
+    /* Query, or cancel a range of, the entries of the queue used by retune
+     * and retune2. See nios_pkt_retune_queue.h */
+    int (*retune_queue)(struct bladerf *dev,
+                        bladerf_channel ch,
+                        uint8_t cmd,
+                        uint64_t start,
+                        uint64_t end,
+                        struct bladerf_retune_queue_status *status,
+                        unsigned int *canceled);
+
+    /* Schedule a peripheral write through the queue used by retune and
+     * retune2, or perform it now. See nios_pkt_timed_write.h */
+    int (*timed_write)(struct bladerf *dev,
+                       bladerf_channel ch,
+                       uint64_t timestamp,
+                       uint8_t type,
+                       uint8_t id,
+                       uint8_t addr,
+                       uint32_t data);
+
+    /* Query the VCTCXO tamer's control loop, or restart its acquisition.
+     * See nios_pkt_vctcxo_tamer.h */
+    int (*vctcxo_tamer)(struct bladerf *dev,
+                        uint8_t cmd,
+                        bool seed_valid,
+                        uint16_t seed,
+                        struct bladerf_vctcxo_tamer_status *status);
+
+    /* NIOS II RX DC calibration sweep. See nios_pkt_dc_cal.h */
+    int (*dc_cal_clear)(struct bladerf *dev);
+    int (*dc_cal_add)(struct bladerf *dev,
+                      uint16_t nint,
+                      uint32_t nfrac,
+                      uint8_t freqsel,
+                      uint8_t vcocap,
+                      bool low_band,
+                      bool quick_tune);
+    int (*dc_cal_start)(struct bladerf *dev,
+                        uint32_t num_samples,
+                        uint16_t settle_us);
+    int (*dc_cal_status)(struct bladerf *dev, bool *busy, uint8_t *done);
+    int (*dc_cal_read)(struct bladerf *dev,
+                       uint8_t index,
+                       int16_t *dc_i,
+                       int16_t *dc_q);
+
+    /* Run an LMS6002D DC offset calibration on the NIOS II */
+    int (*lms_dc_cal)(struct bladerf *dev, bladerf_cal_module module);
+
+    /* Discard any host-side copies of device registers, as around a
+     * calibration that may change them. May be NULL. */
+    void (*invalidate_reg_shadow)(struct bladerf *dev);
+
     /* Load firmware from FX3 bootloader */
     int (*load_fw_from_bootloader)(bladerf_backend backend,
                                    uint8_t bus,
@@ -286,6 +420,12 @@ struct backend_fns {
     /* Read a log entry from the FX3 firmware */
     int (*read_fw_log)(struct bladerf *dev, logger_entry *e);
 
+    /* Read up to `count` log entries from the FX3 firmware in one request.
+     * Entries beyond the end of the log are set to LOG_EOF. */
+    int (*read_fw_log_entries)(struct bladerf *dev,
+                               logger_entry *e,
+                               unsigned int count);
+
     /* Read and Write access to trigger registers */
     int (*read_trigger)(struct bladerf *dev,
                         bladerf_channel ch,
@@ -296,6 +436,23 @@ struct backend_fns {
                          bladerf_trigger_signal trigger,
                          uint8_t val);
 
+    /* Begin and commit a scope in which control write requests may be
+     * queued and issued together. Backends that do not support this must
+     * still accept these calls, issuing requests immediately. */
+    int (*batch_begin)(struct bladerf *dev);
+    int (*batch_commit)(struct bladerf *dev);
+
+    /* Issue any writes queued in the current batch scope, leaving the scope
+     * open. This is used where queued writes must have taken effect before
+     * the caller waits on the hardware. */
+    int (*batch_flush)(struct bladerf *dev);
+
+    /* Control request latency statistics. These may be NULL if the backend
+     * does not record them. */
+    int (*enable_control_stats)(struct bladerf *dev, bool enable);
+    int (*get_control_stats)(struct bladerf *dev,
+                             struct bladerf_control_stats *stats);
+
     /* Backend name */
     const char *name;
 };
@@ -325,6 +482,22 @@ int backend_probe(backend_probe_target probe_target,
                   struct bladerf_devinfo **devinfo_items,
                   size_t *num_items);
 
+/**
+ * Start hotplug notifications on all backends that support them
+ *
+ * @param[in]   cb          Function to call upon hotplug events
+ *
+ * @return 0 if at least one backend started, BLADERF_ERR_UNSUPPORTED if none
+ *         support hotplug notifications, or BLADERF_ERR_* on failure
+ */
+int backend_hotplug_start(backend_hotplug_cb cb);
+
+/**
+ * Stop hotplug notifications started by backend_hotplug_start(). Once this
+ * returns, no further notifications are delivered.
+ */
+void backend_hotplug_stop(void);
+
 /**
  * Search for bootloader via provided specification, download firmware,
  * and boot it.
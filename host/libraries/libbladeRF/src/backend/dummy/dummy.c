@@ -3,6 +3,25 @@
  * enabled. This is intended for development purposes only, and should
  * generally should not be enabled for libbladeRF releases.
  *
+ * When explicitly opened with the "dummy" backend (e.g., "dummy:"), this
+ * backend presents itself as a bladeRF x40 with its FPGA loaded. Register
+ * writes are stored so that they read back, and sample streams are backed
+ * by a synthetic source/sink. This allows the host-side streaming code to
+ * be exercised and profiled without hardware, at rates well beyond what
+ * USB could sustain.
+ *
+ * The following environment variables configure the synthetic streams:
+ *
+ *  BLADERF_DUMMY_RATE          Rate, in samples per second per channel, at
+ *                              which streams complete transfers. A suffix of
+ *                              k, M, or G may be used. 0 completes transfers
+ *                              as fast as the host can keep up. By default,
+ *                              the configured sample rate is used.
+ *
+ *  BLADERF_DUMMY_OVERRUN_EVERY Drop one buffer's worth of RX samples before
+ *                              every Nth RX transfer, producing a timestamp
+ *                              discontinuity in metadata formats.
+ *
  * This file is part of the bladeRF project:
  *   http://www.github.com/nuand/bladeRF
  *
@@ -23,13 +42,155 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include "host_config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "log.h"
+#include "minmax.h"
+#include "conversions.h"
+#include "thread.h"
+
+#include "devinfo.h"
+
 #include "backend/backend.h"
+#include "backend/usb/usb.h"
 
 #include "board/board.h"
+#include "board/bladerf1/flash.h"
+
+#include "streaming/async.h"
+#include "streaming/format.h"
+#include "streaming/metadata.h"
+
+#include "helpers/timeout.h"
+#include "helpers/version.h"
+#include "helpers/wallclock.h"
+
+#include "bladeRF.h"
+
+/* Versions and calibration data reported by the emulated device */
+#define DUMMY_FW_VERSION "2.4.0"
+#define DUMMY_FPGA_VERSION "0.16.0"
+#define DUMMY_CAL_FPGA_SIZE "40"
+#define DUMMY_CAL_VCTCXO_TRIM "32768"
+
+/* Winbond W25Q32JV, as populated on the bladeRF x40 */
+#define DUMMY_FLASH_MID 0xef
+#define DUMMY_FLASH_DID 0x15
+
+/* The device is reported as SuperSpeed, so metadata is carried in messages
+ * of this size */
+#define DUMMY_MSG_SIZE USB_MSG_SIZE_SS
+
+/* Number of samples the FPGA FIFO can absorb while no transfer is available,
+ * before samples are dropped */
+#define DUMMY_FIFO_SAMPLES 4096
+
+/* Upper bound on how long the stream thread sleeps without re-checking the
+ * stream state */
+#define DUMMY_MAX_WAIT_MS 100
+
+struct bladerf_dummy {
+    uint32_t config_gpio;
+    uint32_t xb_gpio;
+    uint32_t xb_gpio_dir;
+    uint8_t lms_regs[128];
+    uint8_t si5338_regs[256];
+    int16_t iq_gain[2];  /* Indexed by bladerf_direction */
+    int16_t iq_phase[2]; /* Indexed by bladerf_direction */
+    uint16_t trim_dac;
+    bladerf_vctcxo_tamer_mode tamer_mode;
+    bool fw_loopback;
+    uint32_t rx_decim;
+
+    /* Stream rate, in samples per second. 0 denotes that streams are not
+     * throttled. Ignored if follow_samplerate is set. */
+    uint64_t rate;
+    bool follow_samplerate;
+
+    /* Drop a buffer's worth of samples every Nth RX transfer. 0 disables. */
+    unsigned int overrun_every;
+
+    /* Next sample timestamp, indexed by bladerf_direction */
+    MUTEX lock;
+    uint64_t timestamp[2];
+};
+
+/* Transfers always complete in the order they were submitted. Those in
+ * flight are the (num_transfers - num_avail) preceding index i. */
+struct dummy_stream_data {
+    void **buffers;           /* Buffer associated with each transfer */
+    uint64_t *submit_time_us; /* Time at which each transfer was submitted */
+    size_t num_transfers;     /* Total number of transfers */
+    size_t num_avail;         /* Number of transfers not in flight */
+    size_t i;                 /* Index of the next transfer to submit */
+
+    /* Signaled when a transfer is submitted or the stream is shut down */
+    pthread_cond_t submitted;
+
+    uint64_t rate;        /* Samples per second per channel, 0 if unlimited */
+    size_t buf_samples;   /* Samples per channel in each buffer */
+    size_t msg_per_buf;   /* Metadata messages per buffer, 0 if none */
+    size_t samples_per_msg;
+
+    uint64_t t0_us;       /* Time at which the stream started */
+    uint64_t ts0;         /* Timestamp at which the stream started */
+    uint64_t next_ts;     /* Timestamp of the next sample */
+};
+
+static const struct numeric_suffix dummy_rate_suffixes[] = {
+    { FIELD_INIT(.suffix, "k"), FIELD_INIT(.multiplier, 1000) },
+    { FIELD_INIT(.suffix, "M"), FIELD_INIT(.multiplier, 1000000) },
+    { FIELD_INIT(.suffix, "G"), FIELD_INIT(.multiplier, 1000000000) },
+};
+
+static inline struct bladerf_dummy *dummy_backend(struct bladerf *dev)
+{
+    return (struct bladerf_dummy *)dev->backend_data;
+}
+
+static inline size_t dir_idx(bladerf_channel ch)
+{
+    return BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX : BLADERF_RX;
+}
+
+static void dummy_load_env(struct bladerf_dummy *dummy)
+{
+    const char *env;
+    bool ok;
+
+    dummy->follow_samplerate = true;
+
+    env = getenv("BLADERF_DUMMY_RATE");
+    if (env != NULL) {
+        dummy->rate = str2uint64_suffix(env, 0, UINT64_MAX,
+                                        dummy_rate_suffixes,
+                                        ARRAY_SIZE(dummy_rate_suffixes), &ok);
+        if (ok) {
+            dummy->follow_samplerate = false;
+        } else {
+            log_warning("Ignoring invalid BLADERF_DUMMY_RATE value: %s\n",
+                        env);
+        }
+    }
+
+    env = getenv("BLADERF_DUMMY_OVERRUN_EVERY");
+    if (env != NULL) {
+        dummy->overrun_every = str2uint(env, 0, UINT_MAX, &ok);
+        if (!ok) {
+            log_warning("Ignoring invalid BLADERF_DUMMY_OVERRUN_EVERY "
+                        "value: %s\n", env);
+            dummy->overrun_every = 0;
+        }
+    }
+}
 
 static bool dummy_matches(bladerf_backend backend)
 {
-    return false;
+    return backend == BLADERF_BACKEND_DUMMY;
 }
 
 /* We never "find" dummy devices */
@@ -39,14 +200,58 @@ static int dummy_probe(backend_probe_target probe_target,
     return 0;
 }
 
-static int dummy_get_vid_pid(struct bladerf *dev, uint16_t *vid, uint16_t *pid)
+static int dummy_hotplug_start(backend_hotplug_cb cb)
 {
     return BLADERF_ERR_UNSUPPORTED;
 }
 
+static void dummy_hotplug_stop(void)
+{
+}
+
+static int dummy_get_vid_pid(struct bladerf *dev, uint16_t *vid, uint16_t *pid)
+{
+    *vid = USB_NUAND_VENDOR_ID;
+    *pid = USB_NUAND_BLADERF_PRODUCT_ID;
+    return 0;
+}
+
 static int dummy_open(struct bladerf *dev, struct bladerf_devinfo *info)
 {
-    return BLADERF_ERR_NODEV;
+    extern const struct backend_fns backend_fns_dummy;
+    struct bladerf_dummy *dummy;
+
+    /* Only hand out a dummy device when one has been explicitly requested,
+     * so that we never stand in for real hardware */
+    if (info->backend != BLADERF_BACKEND_DUMMY) {
+        return BLADERF_ERR_NODEV;
+    }
+
+    dummy = calloc(1, sizeof(*dummy));
+    if (dummy == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    dummy->trim_dac   = 0x8000;
+    dummy->tamer_mode = BLADERF_VCTCXO_TAMER_DISABLED;
+    dummy_load_env(dummy);
+    MUTEX_INIT(&dummy->lock);
+
+    dev->backend      = &backend_fns_dummy;
+    dev->backend_data = dummy;
+
+    memset(&dev->ident, 0, sizeof(dev->ident));
+    dev->ident.backend  = BLADERF_BACKEND_DUMMY;
+    dev->ident.instance = info->instance == DEVINFO_INST_ANY ? 0
+                                                             : info->instance;
+    snprintf(dev->ident.serial, sizeof(dev->ident.serial), "%032x",
+             dev->ident.instance);
+    strncpy(dev->ident.manufacturer, "Nuand",
+            sizeof(dev->ident.manufacturer) - 1);
+    strncpy(dev->ident.product, "bladeRF (dummy)",
+            sizeof(dev->ident.product) - 1);
+
+    return 0;
 }
 
 static int dummy_set_fpga_protocol(struct bladerf *dev,
@@ -57,46 +262,77 @@ static int dummy_set_fpga_protocol(struct bladerf *dev,
 
 static void dummy_close(struct bladerf *dev)
 {
-    /* Nothing to do */
+    struct bladerf_dummy *dummy = dummy_backend(dev);
+
+    if (dummy != NULL) {
+        MUTEX_DESTROY(&dummy->lock);
+        free(dummy);
+        dev->backend_data = NULL;
+    }
 }
 
 static int dummy_is_fw_ready(struct bladerf *dev)
 {
-    return 0;
+    return 1;
 }
 
 static int dummy_get_handle(struct bladerf *dev, void **handle)
 {
+    *handle = NULL;
     return 0;
 }
 
 static int dummy_get_flash_id(struct bladerf *dev, uint8_t *mid, uint8_t *did)
 {
-    return BLADERF_ERR_UNSUPPORTED;
+    *mid = DUMMY_FLASH_MID;
+    *did = DUMMY_FLASH_DID;
+    return 0;
 }
 
-static int dummy_load_fpga(struct bladerf *dev,
-                           const uint8_t *image,
-                           size_t image_size)
+static int dummy_load_fpga(struct bladerf *dev, struct fpga_image *image)
 {
     return 0;
 }
 
 static int dummy_is_fpga_configured(struct bladerf *dev)
 {
-    return 0;
+    return 1;
+}
+
+static bladerf_fpga_source dummy_get_fpga_source(struct bladerf *dev)
+{
+    return BLADERF_FPGA_SOURCE_HOST;
+}
+
+static int dummy_fill_version(struct bladerf_version *version, const char *str)
+{
+    /* The describe string points at board-owned storage of this size */
+    strncpy((char *)version->describe, str, BLADERF_VERSION_STR_MAX);
+    ((char *)version->describe)[BLADERF_VERSION_STR_MAX] = '\0';
+
+    return str2version(version->describe, version);
 }
 
 static int dummy_get_fw_version(struct bladerf *dev,
                                 struct bladerf_version *version)
 {
-    return 0;
+    return dummy_fill_version(version, DUMMY_FW_VERSION);
 }
 
 static int dummy_get_fpga_version(struct bladerf *dev,
                                   struct bladerf_version *version)
 {
-    return 0;
+    return dummy_fill_version(version, DUMMY_FPGA_VERSION);
+}
+
+static int dummy_get_config_id(struct bladerf *dev, uint64_t *id)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_set_config_id(struct bladerf *dev, uint64_t id)
+{
+    return BLADERF_ERR_UNSUPPORTED;
 }
 
 static int dummy_erase_flash_blocks(struct bladerf *dev,
@@ -122,6 +358,14 @@ static int dummy_write_flash_pages(struct bladerf *dev,
     return 0;
 }
 
+static int dummy_verify_flash_pages(struct bladerf *dev,
+                                    const uint8_t *expected,
+                                    uint32_t page,
+                                    uint32_t count)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
 static int dummy_device_reset(struct bladerf *dev)
 {
     return 0;
@@ -134,7 +378,18 @@ static int dummy_jump_to_bootloader(struct bladerf *dev)
 
 static int dummy_get_cal(struct bladerf *dev, char *cal)
 {
-    return 0;
+    int status;
+
+    /* Erased flash, followed by the fields the board code looks up */
+    memset(cal, 0xff, CAL_BUFFER_SIZE);
+
+    status = binkv_add_field(cal, CAL_BUFFER_SIZE, "B", DUMMY_CAL_FPGA_SIZE);
+    if (status == 0) {
+        status = binkv_add_field(cal, CAL_BUFFER_SIZE, "DAC",
+                                 DUMMY_CAL_VCTCXO_TRIM);
+    }
+
+    return status;
 }
 
 static int dummy_get_otp(struct bladerf *dev, char *otp)
@@ -155,16 +410,19 @@ static int dummy_lock_otp(struct bladerf *dev)
 static int dummy_get_device_speed(struct bladerf *dev,
                                   bladerf_dev_speed *device_speed)
 {
+    *device_speed = BLADERF_DEVICE_SPEED_SUPER;
     return 0;
 }
 
 static int dummy_config_gpio_write(struct bladerf *dev, uint32_t val)
 {
+    dummy_backend(dev)->config_gpio = val;
     return 0;
 }
 
 static int dummy_config_gpio_read(struct bladerf *dev, uint32_t *val)
 {
+    *val = dummy_backend(dev)->config_gpio;
     return 0;
 }
 
@@ -172,11 +430,14 @@ static int dummy_expansion_gpio_write(struct bladerf *dev,
                                       uint32_t mask,
                                       uint32_t val)
 {
+    struct bladerf_dummy *dummy = dummy_backend(dev);
+    dummy->xb_gpio = (dummy->xb_gpio & ~mask) | (val & mask);
     return 0;
 }
 
 static int dummy_expansion_gpio_read(struct bladerf *dev, uint32_t *val)
 {
+    *val = dummy_backend(dev)->xb_gpio;
     return 0;
 }
 
@@ -184,11 +445,14 @@ static int dummy_expansion_gpio_dir_write(struct bladerf *dev,
                                           uint32_t mask,
                                           uint32_t val)
 {
+    struct bladerf_dummy *dummy = dummy_backend(dev);
+    dummy->xb_gpio_dir = (dummy->xb_gpio_dir & ~mask) | (val & mask);
     return 0;
 }
 
 static int dummy_expansion_gpio_dir_read(struct bladerf *dev, uint32_t *val)
 {
+    *val = dummy_backend(dev)->xb_gpio_dir;
     return 0;
 }
 
@@ -196,6 +460,7 @@ static int dummy_set_iq_gain_correction(struct bladerf *dev,
                                         bladerf_channel ch,
                                         int16_t value)
 {
+    dummy_backend(dev)->iq_gain[dir_idx(ch)] = value;
     return 0;
 }
 
@@ -203,6 +468,7 @@ static int dummy_set_iq_phase_correction(struct bladerf *dev,
                                          bladerf_channel ch,
                                          int16_t value)
 {
+    dummy_backend(dev)->iq_phase[dir_idx(ch)] = value;
     return 0;
 }
 
@@ -210,7 +476,7 @@ static int dummy_get_iq_gain_correction(struct bladerf *dev,
                                         bladerf_channel ch,
                                         int16_t *value)
 {
-    *value = 0;
+    *value = dummy_backend(dev)->iq_gain[dir_idx(ch)];
     return 0;
 }
 
@@ -218,7 +484,18 @@ static int dummy_get_iq_phase_correction(struct bladerf *dev,
                                          bladerf_channel ch,
                                          int16_t *value)
 {
-    *value = 0;
+    *value = dummy_backend(dev)->iq_phase[dir_idx(ch)];
+    return 0;
+}
+
+static int dummy_set_agc_dc_correction(struct bladerf *dev,
+                                       int16_t q_max,
+                                       int16_t i_max,
+                                       int16_t q_mid,
+                                       int16_t i_mid,
+                                       int16_t q_low,
+                                       int16_t i_low)
+{
     return 0;
 }
 
@@ -226,26 +503,44 @@ static int dummy_get_timestamp(struct bladerf *dev,
                                bladerf_direction dir,
                                uint64_t *val)
 {
+    struct bladerf_dummy *dummy = dummy_backend(dev);
+
+    MUTEX_LOCK(&dummy->lock);
+    *val = dummy->timestamp[dir == BLADERF_TX ? BLADERF_TX : BLADERF_RX];
+    MUTEX_UNLOCK(&dummy->lock);
+
     return 0;
 }
 
+static int dummy_get_trigger_time(struct bladerf *dev,
+                                  bladerf_direction dir,
+                                  bool *fired,
+                                  uint64_t *val)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
 static int dummy_si5338_read(struct bladerf *dev, uint8_t addr, uint8_t *data)
 {
+    *data = dummy_backend(dev)->si5338_regs[addr];
     return 0;
 }
 
 static int dummy_si5338_write(struct bladerf *dev, uint8_t addr, uint8_t data)
 {
+    dummy_backend(dev)->si5338_regs[addr] = data;
     return 0;
 }
 
 static int dummy_lms_write(struct bladerf *dev, uint8_t addr, uint8_t data)
 {
+    dummy_backend(dev)->lms_regs[addr & 0x7f] = data;
     return 0;
 }
 
 static int dummy_lms_read(struct bladerf *dev, uint8_t addr, uint8_t *data)
 {
+    *data = dummy_backend(dev)->lms_regs[addr & 0x7f];
     return 0;
 }
 
@@ -256,6 +551,7 @@ static int dummy_ina219_write(struct bladerf *dev, uint8_t cmd, uint16_t data)
 
 static int dummy_ina219_read(struct bladerf *dev, uint8_t addr, uint16_t *data)
 {
+    *data = 0;
     return 0;
 }
 
@@ -287,6 +583,34 @@ static int dummy_adi_axi_read(struct bladerf *dev,
     return 0;
 }
 
+static int dummy_wishbone_master_write(struct bladerf *dev,
+                                       uint32_t addr,
+                                       uint32_t data)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_wishbone_master_read(struct bladerf *dev,
+                                      uint32_t addr,
+                                      uint32_t *data)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_rfic_command_write(struct bladerf *dev,
+                                    uint16_t cmd,
+                                    uint64_t data)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_rfic_command_read(struct bladerf *dev,
+                                   uint16_t cmd,
+                                   uint64_t *data)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
 static int dummy_rffe_control_write(struct bladerf *dev, uint32_t value)
 {
     return 0;
@@ -305,15 +629,29 @@ static int dummy_rffe_fastlock_save(struct bladerf *dev,
     return 0;
 }
 
+static int dummy_rx_decim_write(struct bladerf *dev, uint32_t value)
+{
+    dummy_backend(dev)->rx_decim = value;
+    return 0;
+}
+
+static int dummy_rx_decim_read(struct bladerf *dev, uint32_t *value)
+{
+    *value = dummy_backend(dev)->rx_decim;
+    return 0;
+}
+
 static int dummy_ad56x1_vctcxo_trim_dac_write(struct bladerf *dev,
                                               uint16_t value)
 {
+    dummy_backend(dev)->trim_dac = value;
     return 0;
 }
 
 static int dummy_ad56x1_vctcxo_trim_dac_read(struct bladerf *dev,
                                              uint16_t *value)
 {
+    *value = dummy_backend(dev)->trim_dac;
     return 0;
 }
 
@@ -331,6 +669,7 @@ static int dummy_vctcxo_dac_write(struct bladerf *dev,
                                   uint8_t addr,
                                   uint16_t value)
 {
+    dummy_backend(dev)->trim_dac = value;
     return 0;
 }
 
@@ -338,19 +677,21 @@ static int dummy_vctcxo_dac_read(struct bladerf *dev,
                                  uint8_t addr,
                                  uint16_t *value)
 {
+    *value = dummy_backend(dev)->trim_dac;
     return 0;
 }
 
 static int dummy_set_vctcxo_tamer_mode(struct bladerf *dev,
                                        bladerf_vctcxo_tamer_mode mode)
 {
+    dummy_backend(dev)->tamer_mode = mode;
     return 0;
 }
 
 static int dummy_get_vctcxo_tamer_mode(struct bladerf *dev,
                                        bladerf_vctcxo_tamer_mode *mode)
 {
-    *mode = BLADERF_VCTCXO_TAMER_INVALID;
+    *mode = dummy_backend(dev)->tamer_mode;
     return 0;
 }
 
@@ -361,12 +702,25 @@ static int dummy_xb_spi(struct bladerf *dev, uint32_t value)
 
 static int dummy_set_firmware_loopback(struct bladerf *dev, bool enable)
 {
+    dummy_backend(dev)->fw_loopback = enable;
     return 0;
 }
 
 static int dummy_get_firmware_loopback(struct bladerf *dev, bool *is_enabled)
 {
-    *is_enabled = false;
+    *is_enabled = dummy_backend(dev)->fw_loopback;
+    return 0;
+}
+
+static int dummy_set_rf_dma_buffers(struct bladerf *dev, unsigned int count)
+{
+    return 0;
+}
+
+static int dummy_set_rf_dma_channel(struct bladerf *dev,
+                                    bladerf_direction dir,
+                                    unsigned int count)
+{
     return 0;
 }
 
@@ -377,31 +731,469 @@ static int dummy_enable_module(struct bladerf *dev,
     return 0;
 }
 
+static int dummy_alloc_stream_buffers(struct bladerf_stream *stream,
+                                      size_t size,
+                                      void **buf)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static void dummy_free_stream_buffers(struct bladerf_stream *stream,
+                                      void *buf,
+                                      size_t size)
+{
+    return;
+}
+
 static int dummy_init_stream(struct bladerf_stream *stream,
                              size_t num_transfers)
 {
+    struct dummy_stream_data *data;
+
+    if (stream->format == BLADERF_FORMAT_PACKET_META) {
+        log_debug("The dummy backend does not support the packet format.\n");
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    data = calloc(1, sizeof(*data));
+    if (data == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    data->buffers        = calloc(num_transfers, sizeof(data->buffers[0]));
+    data->submit_time_us = calloc(num_transfers, sizeof(uint64_t));
+
+    if (data->buffers == NULL || data->submit_time_us == NULL) {
+        free(data->submit_time_us);
+        free(data->buffers);
+        free(data);
+        return BLADERF_ERR_MEM;
+    }
+
+    if (pthread_cond_init(&data->submitted, NULL) != 0) {
+        free(data->submit_time_us);
+        free(data->buffers);
+        free(data);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    data->num_transfers = num_transfers;
+    data->num_avail     = num_transfers;
+    data->i             = 0;
+
+    stream->backend_data = data;
+    return 0;
+}
+
+/* Fill an RX buffer with a ramp on I and its negation on Q, so that dropped
+ * or reordered samples stand out downstream */
+static void dummy_fill_rx_buffer(bladerf_format format, void *buf, size_t n)
+{
+    size_t i;
+
+    switch (format) {
+        case BLADERF_FORMAT_SC16_Q11:
+        case BLADERF_FORMAT_SC16_Q11_META: {
+            int16_t *s = buf;
+            for (i = 0; i < n; i++) {
+                const int16_t v = (int16_t)((i & 0xfff) - 2048);
+                s[2 * i]        = HOST_TO_LE16(v);
+                s[2 * i + 1]    = HOST_TO_LE16(-v);
+            }
+            break;
+        }
+
+        case BLADERF_FORMAT_SC8_Q7:
+        case BLADERF_FORMAT_SC8_Q7_META: {
+            int8_t *s = buf;
+            for (i = 0; i < n; i++) {
+                const int8_t v = (int8_t)((i & 0xff) - 128);
+                s[2 * i]       = v;
+                s[2 * i + 1]   = -v;
+            }
+            break;
+        }
+
+        default:
+            memset(buf, 0, samples_to_bytes(format, n));
+            break;
+    }
+}
+
+static inline bool dummy_format_has_meta(bladerf_format format)
+{
+    return format == BLADERF_FORMAT_SC16_Q11_META ||
+           format == BLADERF_FORMAT_SC8_Q7_META ||
+           format == BLADERF_FORMAT_SC12_PACKED_META;
+}
+
+static int dummy_setup_stream(struct bladerf_stream *stream,
+                              bladerf_channel_layout layout)
+{
+    struct bladerf *dev                = stream->dev;
+    struct bladerf_dummy *dummy        = dummy_backend(dev);
+    struct dummy_stream_data *data     = stream->backend_data;
+    const bladerf_direction dir        = layout & BLADERF_DIRECTION_MASK;
+    const size_t channels =
+        (layout == BLADERF_RX_X2 || layout == BLADERF_TX_X2) ? 2 : 1;
+    size_t i;
+
+    if (dummy->follow_samplerate) {
+        bladerf_sample_rate rate;
+        const bladerf_channel ch = (dir == BLADERF_TX) ? BLADERF_CHANNEL_TX(0)
+                                                       : BLADERF_CHANNEL_RX(0);
+        int status = dev->board->get_sample_rate(dev, ch, &rate);
+        if (status != 0) {
+            return status;
+        }
+
+        data->rate = rate;
+    } else {
+        data->rate = dummy->rate;
+    }
+
+    if (dummy_format_has_meta(stream->format)) {
+        const size_t bytes_per_sample = samples_to_bytes(stream->format, 1);
+
+        data->msg_per_buf =
+            samples_to_bytes(stream->format, stream->samples_per_buffer) /
+            DUMMY_MSG_SIZE;
+
+        data->samples_per_msg =
+            (DUMMY_MSG_SIZE - METADATA_HEADER_SIZE) / bytes_per_sample;
+
+        /* Packed messages only carry whole groups of 8 samples */
+        if (format_is_packed(stream->format)) {
+            data->samples_per_msg -= data->samples_per_msg % 8;
+        }
+
+        data->buf_samples = data->msg_per_buf * data->samples_per_msg;
+    } else {
+        data->msg_per_buf     = 0;
+        data->samples_per_msg = 0;
+        data->buf_samples     = stream->samples_per_buffer;
+    }
+
+    data->buf_samples /= channels;
+
+    /* RX buffers are handed back to us for every transfer, so their payload
+     * only needs to be generated once. Metadata headers are written as each
+     * transfer completes. */
+    if (dir == BLADERF_RX) {
+        for (i = 0; i < stream->num_buffers; i++) {
+            dummy_fill_rx_buffer(stream->format, stream->buffers[i],
+                                 stream->samples_per_buffer);
+        }
+    }
+
+    log_debug("Dummy %s stream: %" PRIu64 " samples/s, %u samples/buffer\n",
+              dir == BLADERF_TX ? "TX" : "RX", data->rate,
+              (unsigned int)data->buf_samples);
+
     return 0;
 }
 
+/* Timestamp reached by the emulated device at time t_us */
+static inline uint64_t dummy_ts_at(struct dummy_stream_data *data,
+                                   uint64_t t_us)
+{
+    if (t_us <= data->t0_us) {
+        return data->ts0;
+    }
+
+    return data->ts0 +
+           (uint64_t)((double)(t_us - data->t0_us) * data->rate / 1e6);
+}
+
+/* Time at which the emulated device reaches timestamp ts */
+static inline uint64_t dummy_time_at(struct dummy_stream_data *data,
+                                     uint64_t ts)
+{
+    return data->t0_us +
+           (uint64_t)((double)(ts - data->ts0) * 1e6 / data->rate);
+}
+
+/* Precondition: A transfer is available and stream->lock is held */
+static void dummy_submit_transfer(struct bladerf_stream *stream, void *buffer)
+{
+    struct dummy_stream_data *data = stream->backend_data;
+
+    assert(data->num_avail != 0);
+
+    data->buffers[data->i]        = buffer;
+    data->submit_time_us[data->i] = time_now_us();
+    data->i = (data->i + 1) % data->num_transfers;
+    data->num_avail--;
+
+    pthread_cond_signal(&data->submitted);
+}
+
+/* Complete the oldest transfer in flight and hand it to the user callback.
+ * Assumes stream->lock is held. */
+static void dummy_complete_transfer(struct bladerf_stream *stream,
+                                    bladerf_direction dir,
+                                    uint64_t now)
+{
+    struct bladerf *dev            = stream->dev;
+    struct bladerf_dummy *dummy    = dummy_backend(dev);
+    struct dummy_stream_data *data = stream->backend_data;
+    const size_t in_flight         = data->num_transfers - data->num_avail;
+    const size_t idx =
+        (data->i + data->num_transfers - in_flight) % data->num_transfers;
+    const uint64_t submitted = data->submit_time_us[idx];
+    uint8_t *buffer          = data->buffers[idx];
+    struct bladerf_metadata metadata;
+    void *next_buffer;
+    size_t n;
+
+    /* Only the host arrival time is provided to the callback */
+    memset(&metadata, 0, sizeof(metadata));
+    metadata.host_timestamp = wallclock_get_monotonic_nsec();
+
+    async_record_transfer(stream, now > submitted ? now - submitted : 0,
+                          false);
+
+    if (dir == BLADERF_RX) {
+        if (dummy->overrun_every != 0 &&
+            (stream->xfer_stats.completed % dummy->overrun_every) == 0) {
+            log_verbose("Injecting an RX overrun at t=%" PRIu64 "\n",
+                        data->next_ts);
+            data->next_ts += data->buf_samples;
+        }
+
+        for (n = 0; n < data->msg_per_buf; n++) {
+            metadata_set(buffer + n * DUMMY_MSG_SIZE,
+                         data->next_ts + n * data->samples_per_msg, 0);
+        }
+    }
+
+    data->next_ts += data->buf_samples;
+
+    MUTEX_LOCK(&dummy->lock);
+    dummy->timestamp[dir] = data->next_ts;
+    MUTEX_UNLOCK(&dummy->lock);
+
+    if (stream->state == STREAM_RUNNING) {
+        /* The transfer remains the oldest in flight until the callback
+         * returns, so buffers submitted meanwhile queue up behind it */
+        MUTEX_UNLOCK(&stream->lock);
+        next_buffer = async_stream_cb(stream, &metadata, buffer,
+                                      stream->samples_per_buffer);
+        MUTEX_LOCK(&stream->lock);
+
+        data->num_avail++;
+        pthread_cond_signal(&stream->can_submit_buffer);
+
+        if (next_buffer == BLADERF_STREAM_SHUTDOWN) {
+            stream->state = STREAM_SHUTTING_DOWN;
+        } else if (next_buffer != BLADERF_STREAM_NO_DATA &&
+                   stream->state == STREAM_RUNNING) {
+            dummy_submit_transfer(stream, next_buffer);
+        }
+    } else {
+        data->num_avail++;
+        pthread_cond_signal(&stream->can_submit_buffer);
+    }
+}
+
 static int dummy_stream(struct bladerf_stream *stream,
                         bladerf_channel_layout layout)
 {
+    size_t i;
+    int status;
+    void *buffer;
+    uint64_t now, due;
+    struct timespec timeout_abs;
+    struct bladerf_metadata metadata;
+    struct bladerf *dev            = stream->dev;
+    struct bladerf_dummy *dummy    = dummy_backend(dev);
+    struct dummy_stream_data *data = stream->backend_data;
+    const bladerf_direction dir    = layout & BLADERF_DIRECTION_MASK;
+
+    /* Currently unused, so zero it out for a sanity check when debugging */
+    memset(&metadata, 0, sizeof(metadata));
+
+    status = dummy_setup_stream(stream, layout);
+    if (status != 0) {
+        return status;
+    }
+
+    MUTEX_LOCK(&dummy->lock);
+    data->ts0 = dummy->timestamp[dir];
+    MUTEX_UNLOCK(&dummy->lock);
+
+    data->next_ts = data->ts0;
+    data->t0_us   = time_now_us();
+
+    MUTEX_LOCK(&stream->lock);
+
+    /* Set up initial set of buffers */
+    for (i = 0; i < data->num_transfers; i++) {
+        if (dir == BLADERF_TX) {
+            buffer = stream->cb(dev, stream, &metadata, NULL,
+                                stream->samples_per_buffer, stream->user_data);
+
+            if (buffer == BLADERF_STREAM_SHUTDOWN) {
+                stream->state = STREAM_SHUTTING_DOWN;
+                break;
+            }
+        } else {
+            buffer = stream->buffers[i];
+        }
+
+        if (buffer != BLADERF_STREAM_NO_DATA) {
+            dummy_submit_transfer(stream, buffer);
+        }
+    }
+
+    /* Obtain the initial buffers of a batched TX stream */
+    MUTEX_UNLOCK(&stream->lock);
+    async_dispatch_batch(stream);
+    MUTEX_LOCK(&stream->lock);
+
+    while (stream->state != STREAM_DONE) {
+        if (stream->state == STREAM_SHUTTING_DOWN) {
+            /* Nothing is actually in flight, so all transfers may be
+             * reclaimed at once */
+            data->num_avail = data->num_transfers;
+            stream->state   = STREAM_DONE;
+            pthread_cond_broadcast(&stream->can_submit_buffer);
+            break;
+        }
+
+        if (data->num_avail == data->num_transfers) {
+            /* Wait for the user to submit a buffer */
+            if (populate_abs_timeout(&timeout_abs, DUMMY_MAX_WAIT_MS) != 0) {
+                stream->error_code = BLADERF_ERR_UNEXPECTED;
+                stream->state      = STREAM_SHUTTING_DOWN;
+                continue;
+            }
+
+            pthread_cond_timedwait(&data->submitted, &stream->lock,
+                                   &timeout_abs);
+            continue;
+        }
+
+        now = time_now_us();
+
+        if (data->rate != 0) {
+            const size_t in_flight = data->num_transfers - data->num_avail;
+            const size_t idx = (data->i + data->num_transfers - in_flight) %
+                               data->num_transfers;
+            const uint64_t ts_submit =
+                dummy_ts_at(data, data->submit_time_us[idx]);
+
+            /* Had no transfers been available for a while, the samples in
+             * the meantime were lost (RX) or replaced by zeros (TX) */
+            if (ts_submit > data->next_ts + DUMMY_FIFO_SAMPLES) {
+                log_debug("Dummy %s stream starved: t=%" PRIu64
+                          " -> t=%" PRIu64 "\n",
+                          dir == BLADERF_TX ? "TX" : "RX", data->next_ts,
+                          ts_submit);
+                data->next_ts = ts_submit;
+            }
+
+            due = dummy_time_at(data, data->next_ts + data->buf_samples);
+            if (now < due) {
+                const uint64_t wait_us =
+                    u64_min(due - now, DUMMY_MAX_WAIT_MS * 1000);
+
+                MUTEX_UNLOCK(&stream->lock);
+                usleep((useconds_t)wait_us);
+                MUTEX_LOCK(&stream->lock);
+                continue;
+            }
+        }
+
+        dummy_complete_transfer(stream, dir, now);
+
+        if (stream->batch_cb != NULL) {
+            MUTEX_UNLOCK(&stream->lock);
+            async_dispatch_batch(stream);
+            MUTEX_LOCK(&stream->lock);
+        }
+    }
+
+    MUTEX_UNLOCK(&stream->lock);
+
     return 0;
 }
 
+/* The top-level code will have aquired the stream->lock for us */
 static int dummy_submit_stream_buffer(struct bladerf_stream *stream,
                                       void *buffer,
+                                      size_t *length,
                                       unsigned int timeout_ms,
                                       bool nonblock)
 {
+    int status = 0;
+    struct dummy_stream_data *data = stream->backend_data;
+    struct timespec timeout_abs;
+
+    if (buffer == BLADERF_STREAM_SHUTDOWN) {
+        if (data->num_avail == data->num_transfers) {
+            stream->state = STREAM_DONE;
+        } else {
+            stream->state = STREAM_SHUTTING_DOWN;
+        }
+
+        pthread_cond_signal(&data->submitted);
+        return 0;
+    }
+
+    if (data->num_avail == 0) {
+        if (nonblock) {
+            log_debug("Non-blocking buffer submission requested, but no "
+                      "transfers are currently available.\n");
+
+            return BLADERF_ERR_WOULD_BLOCK;
+        }
+
+        if (timeout_ms != 0) {
+            status = populate_abs_timeout(&timeout_abs, timeout_ms);
+            if (status != 0) {
+                return BLADERF_ERR_UNEXPECTED;
+            }
+
+            while (data->num_avail == 0 && status == 0) {
+                status = pthread_cond_timedwait(&stream->can_submit_buffer,
+                                                &stream->lock, &timeout_abs);
+            }
+        } else {
+            while (data->num_avail == 0 && status == 0) {
+                status = pthread_cond_wait(&stream->can_submit_buffer,
+                                           &stream->lock);
+            }
+        }
+    }
+
+    if (status == ETIMEDOUT) {
+        log_debug("%s: Timed out waiting for a transfer to become available.\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_TIMEOUT;
+    } else if (status != 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    dummy_submit_transfer(stream, buffer);
     return 0;
 }
 
 static void dummy_deinit_stream(struct bladerf_stream *stream)
 {
-    return;
+    struct dummy_stream_data *data = stream->backend_data;
+
+    if (data != NULL) {
+        pthread_cond_destroy(&data->submitted);
+        free(data->submit_time_us);
+        free(data->buffers);
+        free(data);
+        stream->backend_data = NULL;
+    }
 }
 
+/* Retunes take effect immediately. The LMS6002D PLL registers are updated as
+ * the NIOS II would, so that the frequency reads back. */
 static int dummy_retune(struct bladerf *dev,
                         bladerf_channel ch,
                         uint64_t timestamp,
@@ -410,11 +1202,112 @@ static int dummy_retune(struct bladerf *dev,
                         uint8_t freqsel,
                         uint8_t vcocap,
                         bool low_band,
+                        uint8_t xb_gpio,
                         bool quick_tune)
 {
+    uint8_t *regs      = dummy_backend(dev)->lms_regs;
+    const uint8_t base = BLADERF_CHANNEL_IS_TX(ch) ? 0x10 : 0x20;
+
+    regs[base + 0] = (uint8_t)(nint >> 1);
+    regs[base + 1] = (uint8_t)(((nint & 1) << 7) | ((nfrac >> 16) & 0x7f));
+    regs[base + 2] = (uint8_t)(nfrac >> 8);
+    regs[base + 3] = (uint8_t)nfrac;
+    regs[base + 5] = (uint8_t)((freqsel << 2) | (regs[base + 5] & 0x03));
+    regs[base + 9] = (uint8_t)((regs[base + 9] & 0xc0) | (vcocap & 0x3f));
+
     return 0;
 }
 
+static int dummy_retune2(struct bladerf *dev,
+                         bladerf_channel ch,
+                         uint64_t timestamp,
+                         uint16_t nios_profile,
+                         uint8_t rffe_profile,
+                         uint8_t port,
+                         uint8_t spdt)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_retune2_gain(struct bladerf *dev,
+                              bladerf_channel ch,
+                              uint64_t timestamp,
+                              uint16_t setting)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_retune_queue(struct bladerf *dev,
+                              bladerf_channel ch,
+                              uint8_t cmd,
+                              uint64_t start,
+                              uint64_t end,
+                              struct bladerf_retune_queue_status *status,
+                              unsigned int *canceled)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_timed_write(struct bladerf *dev,
+                             bladerf_channel ch,
+                             uint64_t timestamp,
+                             uint8_t type,
+                             uint8_t id,
+                             uint8_t addr,
+                             uint32_t data)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_vctcxo_tamer(struct bladerf *dev,
+                              uint8_t cmd,
+                              bool seed_valid,
+                              uint16_t seed,
+                              struct bladerf_vctcxo_tamer_status *status)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_dc_cal_clear(struct bladerf *dev)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_dc_cal_add(struct bladerf *dev,
+                            uint16_t nint,
+                            uint32_t nfrac,
+                            uint8_t freqsel,
+                            uint8_t vcocap,
+                            bool low_band,
+                            bool quick_tune)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_dc_cal_start(struct bladerf *dev,
+                              uint32_t num_samples,
+                              uint16_t settle_us)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_dc_cal_status(struct bladerf *dev, bool *busy, uint8_t *done)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_dc_cal_read(struct bladerf *dev,
+                             uint8_t index,
+                             int16_t *dc_i,
+                             int16_t *dc_q)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int dummy_lms_dc_cal(struct bladerf *dev, bladerf_cal_module module)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
 
 static int dummy_load_fw_from_bootloader(bladerf_backend backend,
                                          uint8_t bus,
@@ -430,6 +1323,19 @@ static int dummy_read_fw_log(struct bladerf *dev, logger_entry *e)
     return 0;
 }
 
+static int dummy_read_fw_log_entries(struct bladerf *dev,
+                                     logger_entry *e,
+                                     unsigned int count)
+{
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        e[i] = LOG_EOF;
+    }
+
+    return 0;
+}
+
 static int dummy_read_trigger(struct bladerf *dev,
                               bladerf_channel ch,
                               bladerf_trigger_signal trigger,
@@ -447,10 +1353,27 @@ static int dummy_write_trigger(struct bladerf *dev,
     return 0;
 }
 
+static int dummy_batch_begin(struct bladerf *dev)
+{
+    return 0;
+}
+
+static int dummy_batch_commit(struct bladerf *dev)
+{
+    return 0;
+}
+
+static int dummy_batch_flush(struct bladerf *dev)
+{
+    return 0;
+}
+
 const struct backend_fns backend_fns_dummy = {
     FIELD_INIT(.matches, dummy_matches),
 
     FIELD_INIT(.probe, dummy_probe),
+    FIELD_INIT(.hotplug_start, dummy_hotplug_start),
+    FIELD_INIT(.hotplug_stop, dummy_hotplug_stop),
 
     FIELD_INIT(.get_vid_pid, dummy_get_vid_pid),
     FIELD_INIT(.get_flash_id, dummy_get_flash_id),
@@ -464,16 +1387,21 @@ const struct backend_fns backend_fns_dummy = {
 
     FIELD_INIT(.load_fpga, dummy_load_fpga),
     FIELD_INIT(.is_fpga_configured, dummy_is_fpga_configured),
+    FIELD_INIT(.get_fpga_source, dummy_get_fpga_source),
 
     FIELD_INIT(.get_fw_version, dummy_get_fw_version),
     FIELD_INIT(.get_fpga_version, dummy_get_fpga_version),
+    FIELD_INIT(.get_config_id, dummy_get_config_id),
+    FIELD_INIT(.set_config_id, dummy_set_config_id),
 
     FIELD_INIT(.erase_flash_blocks, dummy_erase_flash_blocks),
     FIELD_INIT(.read_flash_pages, dummy_read_flash_pages),
     FIELD_INIT(.write_flash_pages, dummy_write_flash_pages),
+    FIELD_INIT(.verify_flash_pages, dummy_verify_flash_pages),
 
     FIELD_INIT(.device_reset, dummy_device_reset),
     FIELD_INIT(.jump_to_bootloader, dummy_jump_to_bootloader),
+    FIELD_INIT(.recover, NULL),
 
     FIELD_INIT(.get_cal, dummy_get_cal),
     FIELD_INIT(.get_otp, dummy_get_otp),
@@ -494,7 +1422,10 @@ const struct backend_fns backend_fns_dummy = {
     FIELD_INIT(.get_iq_gain_correction, dummy_get_iq_gain_correction),
     FIELD_INIT(.get_iq_phase_correction, dummy_get_iq_phase_correction),
 
+    FIELD_INIT(.set_agc_dc_correction, dummy_set_agc_dc_correction),
+
     FIELD_INIT(.get_timestamp, dummy_get_timestamp),
+    FIELD_INIT(.get_trigger_time, dummy_get_trigger_time),
 
     FIELD_INIT(.si5338_write, dummy_si5338_write),
     FIELD_INIT(.si5338_read, dummy_si5338_read),
@@ -511,11 +1442,20 @@ const struct backend_fns backend_fns_dummy = {
     FIELD_INIT(.adi_axi_write, dummy_adi_axi_write),
     FIELD_INIT(.adi_axi_read, dummy_adi_axi_read),
 
+    FIELD_INIT(.wishbone_master_write, dummy_wishbone_master_write),
+    FIELD_INIT(.wishbone_master_read, dummy_wishbone_master_read),
+
+    FIELD_INIT(.rfic_command_write, dummy_rfic_command_write),
+    FIELD_INIT(.rfic_command_read, dummy_rfic_command_read),
+
     FIELD_INIT(.rffe_control_write, dummy_rffe_control_write),
     FIELD_INIT(.rffe_control_read, dummy_rffe_control_read),
 
     FIELD_INIT(.rffe_fastlock_save, dummy_rffe_fastlock_save),
 
+    FIELD_INIT(.rx_decim_write, dummy_rx_decim_write),
+    FIELD_INIT(.rx_decim_read, dummy_rx_decim_read),
+
     FIELD_INIT(.ad56x1_vctcxo_trim_dac_write,
                dummy_ad56x1_vctcxo_trim_dac_write),
     FIELD_INIT(.ad56x1_vctcxo_trim_dac_read, dummy_ad56x1_vctcxo_trim_dac_read),
@@ -533,22 +1473,43 @@ const struct backend_fns backend_fns_dummy = {
 
     FIELD_INIT(.set_firmware_loopback, dummy_set_firmware_loopback),
     FIELD_INIT(.get_firmware_loopback, dummy_get_firmware_loopback),
+    FIELD_INIT(.set_rf_dma_buffers, dummy_set_rf_dma_buffers),
+    FIELD_INIT(.set_rf_dma_channel, dummy_set_rf_dma_channel),
 
     FIELD_INIT(.enable_module, dummy_enable_module),
 
+    FIELD_INIT(.alloc_stream_buffers, dummy_alloc_stream_buffers),
+    FIELD_INIT(.free_stream_buffers, dummy_free_stream_buffers),
     FIELD_INIT(.init_stream, dummy_init_stream),
     FIELD_INIT(.stream, dummy_stream),
     FIELD_INIT(.submit_stream_buffer, dummy_submit_stream_buffer),
     FIELD_INIT(.deinit_stream, dummy_deinit_stream),
 
     FIELD_INIT(.retune, dummy_retune),
+    FIELD_INIT(.retune2, dummy_retune2),
+    FIELD_INIT(.retune2_gain, dummy_retune2_gain),
+    FIELD_INIT(.retune_queue, dummy_retune_queue),
+    FIELD_INIT(.timed_write, dummy_timed_write),
+    FIELD_INIT(.vctcxo_tamer, dummy_vctcxo_tamer),
+
+    FIELD_INIT(.dc_cal_clear, dummy_dc_cal_clear),
+    FIELD_INIT(.dc_cal_add, dummy_dc_cal_add),
+    FIELD_INIT(.dc_cal_start, dummy_dc_cal_start),
+    FIELD_INIT(.dc_cal_status, dummy_dc_cal_status),
+    FIELD_INIT(.dc_cal_read, dummy_dc_cal_read),
+    FIELD_INIT(.lms_dc_cal, dummy_lms_dc_cal),
 
     FIELD_INIT(.load_fw_from_bootloader, dummy_load_fw_from_bootloader),
 
     FIELD_INIT(.read_fw_log, dummy_read_fw_log),
+    FIELD_INIT(.read_fw_log_entries, dummy_read_fw_log_entries),
 
     FIELD_INIT(.read_trigger, dummy_read_trigger),
     FIELD_INIT(.write_trigger, dummy_write_trigger),
 
+    FIELD_INIT(.batch_begin, dummy_batch_begin),
+    FIELD_INIT(.batch_commit, dummy_batch_commit),
+    FIELD_INIT(.batch_flush, dummy_batch_flush),
+
     FIELD_INIT(.name, "dummy"),
 };
@@ -0,0 +1,1829 @@
+/*
+ * Network backend, for devices served by bladerf_net_serve() (bladeRF-server)
+ * on another host, and opened with "net:host=<host> [port=<port>]".
+ *
+ * Each backend call is forwarded as a request on a TCP control connection,
+ * per net_proto.h. Writes made within a batch scope are queued and sent in a
+ * single request when the scope is committed, or before the next request
+ * that must observe them, so that a retune costs one round trip rather than
+ * one per register.
+ *
+ * Each run of a stream opens a connection of its own. RX samples are
+ * received straight into the oldest stream buffer in flight, and TX buffers
+ * are sent from where they lie, behind their frame header.
+ *
+ * The following environment variable configures streams:
+ *
+ *  BLADERF_NET_PACK            "sc12" or "sc8" packs SC16 Q11 samples to 12
+ *                              or 8 bits per component on the wire. Formats
+ *                              with metadata are never packed, so that
+ *                              timestamps pass through unchanged.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "host_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "log.h"
+#include "conversions.h"
+#include "thread.h"
+
+#include "devinfo.h"
+
+#include "backend/backend.h"
+#include "backend/net/net_proto.h"
+
+#include "board/board.h"
+
+#include "streaming/async.h"
+#include "streaming/format.h"
+
+#include "helpers/fpga_image.h"
+#include "helpers/timeout.h"
+#include "helpers/version.h"
+#include "helpers/wallclock.h"
+
+#include "bladeRF.h"
+
+/* Number of writes queued in a batch scope before they are sent */
+#define NET_BATCH_MAX_CALLS 256
+
+/* Upper bound on how long the stream thread waits without re-checking the
+ * stream state */
+#define NET_MAX_WAIT_MS 100
+
+struct bladerf_net {
+    int fd; /* Control connection */
+
+    char host[BLADERF_NET_HOST_LENGTH];
+    uint16_t port;
+    net_pack_mode pack;
+
+    /* Serializes requests on the control connection, and protects the
+     * members below */
+    MUTEX lock;
+    struct net_msg req;
+    struct net_msg resp;
+
+    /* Writes queued in the current batch scope */
+    struct net_msg batch;
+    unsigned int batch_depth;
+    unsigned int batch_count;
+    int batch_status; /* First failure since the outermost batch_begin */
+};
+
+/* Transfers always complete in the order they were submitted. Those in
+ * flight are the (num_transfers - num_avail) preceding index i. */
+struct net_stream_data {
+    int fd;                   /* Stream connection, or -1 if not running */
+    net_pack_mode pack;
+    uint8_t *packed;          /* Frame bodies, when packing samples */
+
+    void **buffers;           /* Buffer associated with each transfer */
+    size_t *lengths;          /* Bytes to send from each TX buffer */
+    uint64_t *submit_time_us; /* Time at which each transfer was submitted */
+    size_t num_transfers;     /* Total number of transfers */
+    size_t num_avail;         /* Number of transfers not in flight */
+    size_t i;                 /* Index of the next transfer to submit */
+
+    /* Signaled when a transfer is submitted or the stream is shut down */
+    pthread_cond_t submitted;
+};
+
+static inline struct bladerf_net *net_backend(struct bladerf *dev)
+{
+    return (struct bladerf_net *)dev->backend_data;
+}
+
+static void net_load_env(struct bladerf_net *net)
+{
+    const char *env = getenv("BLADERF_NET_PACK");
+
+    net->pack = NET_PACK_NONE;
+
+    if (env == NULL || !strcasecmp(env, "none")) {
+        return;
+    } else if (!strcasecmp(env, "sc12")) {
+        net->pack = NET_PACK_SC12;
+    } else if (!strcasecmp(env, "sc8")) {
+        net->pack = NET_PACK_SC8;
+    } else {
+        log_warning("Ignoring invalid BLADERF_NET_PACK value: %s\n", env);
+    }
+}
+
+static int net_connect(const char *host, uint16_t port, int *fd_out)
+{
+    struct addrinfo hints, *res, *ai;
+    char port_str[8];
+    int fd = -1;
+    int status;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    snprintf(port_str, sizeof(port_str), "%u", port);
+
+    status = getaddrinfo(host, port_str, &hints, &res);
+    if (status != 0) {
+        log_debug("Failed to resolve %s: %s\n", host, gai_strerror(status));
+        return BLADERF_ERR_NODEV;
+    }
+
+    for (ai = res; ai != NULL; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            break;
+        }
+
+        close(fd);
+        fd = -1;
+    }
+
+    freeaddrinfo(res);
+
+    if (fd < 0) {
+        log_debug("Failed to connect to %s port %u\n", host, port);
+        return BLADERF_ERR_NODEV;
+    }
+
+    *fd_out = fd;
+    return 0;
+}
+
+/* Send a request and receive its response into net->resp. Assumes
+ * net->lock is held.
+ *
+ * Returns the response status, which is the return value of the call on the
+ * server, or a BLADERF_ERR_* value if the exchange failed. */
+static int net_transact(struct bladerf_net *net, net_op op, uint16_t count,
+                        const struct net_msg *req)
+{
+    struct net_hdr hdr;
+    int status;
+
+    if (req->error) {
+        return BLADERF_ERR_MEM;
+    }
+
+    hdr.length = (uint32_t)req->len;
+    hdr.op     = (uint16_t)op;
+    hdr.count  = count;
+    hdr.status = 0;
+
+    status = net_send_frame(net->fd, &hdr, req->data);
+
+    if (status == 0) {
+        status = net_recv_hdr(net->fd, &hdr);
+    }
+
+    if (status == 0 && hdr.op != op) {
+        log_debug("Received a response for op %u, rather than %u\n",
+                  hdr.op, op);
+        status = BLADERF_ERR_IO;
+    }
+
+    if (status == 0) {
+        status = net_recv_body(net->fd, &hdr, &net->resp);
+    }
+
+    if (status != 0) {
+        /* The connection can no longer be relied upon to be in step, so
+         * fail all further requests */
+        log_error("Lost the connection to %s: %s\n", net->host,
+                  bladerf_strerror(status));
+        shutdown(net->fd, SHUT_RDWR);
+        return status;
+    }
+
+    return hdr.status;
+}
+
+/* Send the writes queued in the batch scope. Assumes net->lock is held. */
+static int net_batch_issue(struct bladerf_net *net)
+{
+    int status;
+
+    if (net->batch_count == 0) {
+        return 0;
+    }
+
+    status = net_transact(net, NET_OP_BATCH, (uint16_t)net->batch_count,
+                          &net->batch);
+
+    net_msg_reset(&net->batch);
+    net->batch_count = 0;
+
+    if (status != 0 && net->batch_status == 0) {
+        net->batch_status = status;
+    }
+
+    return status;
+}
+
+static int net_vcall(struct bladerf *dev, net_op op, const char *req_fmt,
+                     const char *resp_fmt, va_list *ap)
+{
+    struct bladerf_net *net = net_backend(dev);
+    int status;
+
+    MUTEX_LOCK(&net->lock);
+
+    /* Writes queued earlier must take effect before this request. Failures
+     * are reported when the batch scope is committed. */
+    net_batch_issue(net);
+
+    net_msg_reset(&net->req);
+    net_vpack(&net->req, req_fmt, ap);
+
+    status = net_transact(net, op, 0, &net->req);
+    if (status >= 0 && !net_vunpack(&net->resp, resp_fmt, ap)) {
+        log_debug("Malformed response for op %u\n", op);
+        status = BLADERF_ERR_IO;
+    }
+
+    MUTEX_UNLOCK(&net->lock);
+
+    return status;
+}
+
+/* Issue a request, whose arguments are formatted as `req_fmt` and whose
+ * results are read per `resp_fmt`. The variable arguments are those of the
+ * request, followed by pointers to the results. See net_pack(). */
+static int net_call(struct bladerf *dev, net_op op, const char *req_fmt,
+                    const char *resp_fmt, ...)
+{
+    va_list ap;
+    int status;
+
+    va_start(ap, resp_fmt);
+    status = net_vcall(dev, op, req_fmt, resp_fmt, &ap);
+    va_end(ap);
+
+    return status;
+}
+
+/* Issue a write without results, which is queued if a batch scope is open */
+static int net_write(struct bladerf *dev, net_op op, const char *fmt, ...)
+{
+    struct bladerf_net *net = net_backend(dev);
+    bool queued = false;
+    int status  = 0;
+    va_list ap;
+
+    va_start(ap, fmt);
+
+    MUTEX_LOCK(&net->lock);
+
+    if (net->batch_depth != 0) {
+        net_msg_reset(&net->req);
+        net_vpack(&net->req, fmt, &ap);
+        net_pack(&net->batch, "hB", op, net->req.data, net->req.len);
+
+        if (net->req.error || net->batch.error) {
+            status = BLADERF_ERR_MEM;
+        } else if (++net->batch_count == NET_BATCH_MAX_CALLS) {
+            net_batch_issue(net);
+        }
+
+        queued = true;
+    }
+
+    MUTEX_UNLOCK(&net->lock);
+
+    if (!queued) {
+        status = net_vcall(dev, op, fmt, "", &ap);
+    }
+
+    va_end(ap);
+
+    return status;
+}
+
+static bool net_matches(bladerf_backend backend)
+{
+    return backend == BLADERF_BACKEND_NET;
+}
+
+/* Served devices are never found by probing, as the server must be named */
+static int net_probe(backend_probe_target probe_target,
+                     struct bladerf_devinfo_list *info_list)
+{
+    return 0;
+}
+
+static int net_hotplug_start(backend_hotplug_cb cb)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static void net_hotplug_stop(void)
+{
+}
+
+static void net_free(struct bladerf_net *net)
+{
+    if (net->fd >= 0) {
+        close(net->fd);
+    }
+
+    net_msg_free(&net->req);
+    net_msg_free(&net->resp);
+    net_msg_free(&net->batch);
+    MUTEX_DESTROY(&net->lock);
+    free(net);
+}
+
+static int net_open(struct bladerf *dev, struct bladerf_devinfo *info)
+{
+    extern const struct backend_fns backend_fns_net;
+    struct bladerf_net *net;
+    uint32_t instance;
+    int status;
+
+    if (info->backend != BLADERF_BACKEND_NET) {
+        return BLADERF_ERR_NODEV;
+    }
+
+    if (info->net_host[0] == '\0') {
+        log_error("The net backend requires a host=<host> argument.\n");
+        return BLADERF_ERR_INVAL;
+    }
+
+    net = calloc(1, sizeof(*net));
+    if (net == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    net->fd = -1;
+    MUTEX_INIT(&net->lock);
+    net_msg_init(&net->req);
+    net_msg_init(&net->resp);
+    net_msg_init(&net->batch);
+
+    snprintf(net->host, sizeof(net->host), "%s", info->net_host);
+    net->port = info->net_port != 0 ? info->net_port : BLADERF_NET_DEFAULT_PORT;
+    net_load_env(net);
+
+    status = net_connect(net->host, net->port, &net->fd);
+    if (status != 0) {
+        net_free(net);
+        return status;
+    }
+
+    net_config_socket(net->fd, false, NET_CONTROL_TIMEOUT_MS);
+
+    dev->backend      = &backend_fns_net;
+    dev->backend_data = net;
+
+    memset(&dev->ident, 0, sizeof(dev->ident));
+
+    status = net_call(dev, NET_OP_HELLO, "ww", "SSSbbw", NET_MAGIC,
+                      (uint32_t)NET_VERSION,
+                      dev->ident.serial, sizeof(dev->ident.serial),
+                      dev->ident.manufacturer, sizeof(dev->ident.manufacturer),
+                      dev->ident.product, sizeof(dev->ident.product),
+                      &dev->ident.usb_bus, &dev->ident.usb_addr, &instance);
+
+    if (status != 0) {
+        if (status == BLADERF_ERR_NODEV) {
+            log_error("The device at %s is in use by another client.\n",
+                      net->host);
+        }
+
+        dev->backend_data = NULL;
+        net_free(net);
+        return status;
+    }
+
+    dev->ident.backend  = BLADERF_BACKEND_NET;
+    dev->ident.instance = instance;
+    snprintf(dev->ident.net_host, sizeof(dev->ident.net_host), "%s", net->host);
+    dev->ident.net_port = net->port;
+
+    log_verbose("Connected to %s port %u, serving device %s\n", net->host,
+                net->port, dev->ident.serial);
+
+    return 0;
+}
+
+static void net_close(struct bladerf *dev)
+{
+    struct bladerf_net *net = net_backend(dev);
+
+    if (net != NULL) {
+        MUTEX_LOCK(&net->lock);
+        net_batch_issue(net);
+        MUTEX_UNLOCK(&net->lock);
+
+        net_free(net);
+        dev->backend_data = NULL;
+    }
+}
+
+static int net_get_vid_pid(struct bladerf *dev, uint16_t *vid, uint16_t *pid)
+{
+    return net_call(dev, NET_OP_GET_VID_PID, "", "hh", vid, pid);
+}
+
+static int net_get_flash_id(struct bladerf *dev, uint8_t *mid, uint8_t *did)
+{
+    return net_call(dev, NET_OP_GET_FLASH_ID, "", "bb", mid, did);
+}
+
+static int net_set_fpga_protocol(struct bladerf *dev,
+                                 backend_fpga_protocol fpga_protocol)
+{
+    return net_call(dev, NET_OP_SET_FPGA_PROTOCOL, "d", "",
+                    (int32_t)fpga_protocol);
+}
+
+static int net_is_fw_ready(struct bladerf *dev)
+{
+    return net_call(dev, NET_OP_IS_FW_READY, "", "");
+}
+
+static int net_get_handle(struct bladerf *dev, void **handle)
+{
+    *handle = NULL;
+    return 0;
+}
+
+static int net_load_fpga(struct bladerf *dev, struct fpga_image *image)
+{
+    uint8_t *buf;
+    int status;
+
+    if (image->size > NET_MAX_BODY - 4) {
+        log_debug("FPGA image is too large to send.\n");
+        return BLADERF_ERR_INVAL;
+    }
+
+    buf = malloc(image->size);
+    if (buf == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    status = fpga_image_read(image, buf, image->size);
+    if (status == 0) {
+        status = net_call(dev, NET_OP_LOAD_FPGA, "B", "", buf, image->size);
+    }
+
+    free(buf);
+    return status;
+}
+
+static int net_is_fpga_configured(struct bladerf *dev)
+{
+    return net_call(dev, NET_OP_IS_FPGA_CONFIGURED, "", "");
+}
+
+static bladerf_fpga_source net_get_fpga_source(struct bladerf *dev)
+{
+    int32_t source;
+
+    if (net_call(dev, NET_OP_GET_FPGA_SOURCE, "", "d", &source) != 0) {
+        return BLADERF_FPGA_SOURCE_UNKNOWN;
+    }
+
+    return (bladerf_fpga_source)source;
+}
+
+static int net_get_version(struct bladerf *dev, net_op op,
+                           struct bladerf_version *version)
+{
+    /* The describe string points at board-owned storage of this size */
+    return net_call(dev, op, "", "hhhS", &version->major, &version->minor,
+                    &version->patch, (char *)version->describe,
+                    (size_t)BLADERF_VERSION_STR_MAX + 1);
+}
+
+static int net_get_fw_version(struct bladerf *dev,
+                              struct bladerf_version *version)
+{
+    return net_get_version(dev, NET_OP_GET_FW_VERSION, version);
+}
+
+static int net_get_fpga_version(struct bladerf *dev,
+                                struct bladerf_version *version)
+{
+    return net_get_version(dev, NET_OP_GET_FPGA_VERSION, version);
+}
+
+static int net_get_config_id(struct bladerf *dev, uint64_t *id)
+{
+    return net_call(dev, NET_OP_GET_CONFIG_ID, "", "q", id);
+}
+
+static int net_set_config_id(struct bladerf *dev, uint64_t id)
+{
+    return net_call(dev, NET_OP_SET_CONFIG_ID, "q", "", id);
+}
+
+static inline size_t net_flash_bytes(struct bladerf *dev, uint32_t count)
+{
+    return (size_t)count * dev->flash_arch->psize_bytes;
+}
+
+static int net_erase_flash_blocks(struct bladerf *dev,
+                                  uint32_t eb,
+                                  uint16_t count)
+{
+    return net_call(dev, NET_OP_ERASE_FLASH_BLOCKS, "wh", "", eb, count);
+}
+
+static int net_read_flash_pages(struct bladerf *dev,
+                                uint8_t *buf,
+                                uint32_t page,
+                                uint32_t count)
+{
+    return net_call(dev, NET_OP_READ_FLASH_PAGES, "ww", "B", page, count, buf,
+                    net_flash_bytes(dev, count));
+}
+
+static int net_write_flash_pages(struct bladerf *dev,
+                                 const uint8_t *buf,
+                                 uint32_t page,
+                                 uint32_t count)
+{
+    return net_call(dev, NET_OP_WRITE_FLASH_PAGES, "wwB", "", page, count, buf,
+                    net_flash_bytes(dev, count));
+}
+
+static int net_verify_flash_pages(struct bladerf *dev,
+                                  const uint8_t *expected,
+                                  uint32_t page,
+                                  uint32_t count)
+{
+    return net_call(dev, NET_OP_VERIFY_FLASH_PAGES, "wwB", "", page, count,
+                    expected, net_flash_bytes(dev, count));
+}
+
+static int net_device_reset(struct bladerf *dev)
+{
+    return net_call(dev, NET_OP_DEVICE_RESET, "", "");
+}
+
+static int net_jump_to_bootloader(struct bladerf *dev)
+{
+    return net_call(dev, NET_OP_JUMP_TO_BOOTLOADER, "", "");
+}
+
+static int net_get_cal(struct bladerf *dev, char *cal)
+{
+    return net_call(dev, NET_OP_GET_CAL, "", "B", cal,
+                    (size_t)CAL_BUFFER_SIZE);
+}
+
+static int net_get_otp(struct bladerf *dev, char *otp)
+{
+    return net_call(dev, NET_OP_GET_OTP, "", "B", otp,
+                    (size_t)CAL_BUFFER_SIZE);
+}
+
+static int net_write_otp(struct bladerf *dev, char *otp)
+{
+    return net_call(dev, NET_OP_WRITE_OTP, "B", "", otp,
+                    (size_t)CAL_BUFFER_SIZE);
+}
+
+static int net_lock_otp(struct bladerf *dev)
+{
+    return net_call(dev, NET_OP_LOCK_OTP, "", "");
+}
+
+static int net_get_device_speed(struct bladerf *dev, bladerf_dev_speed *speed)
+{
+    int32_t value;
+    int status;
+
+    status = net_call(dev, NET_OP_GET_DEVICE_SPEED, "", "d", &value);
+    if (status == 0) {
+        *speed = (bladerf_dev_speed)value;
+    }
+
+    return status;
+}
+
+static int net_config_gpio_write(struct bladerf *dev, uint32_t val)
+{
+    return net_write(dev, NET_OP_CONFIG_GPIO_WRITE, "w", val);
+}
+
+static int net_config_gpio_read(struct bladerf *dev, uint32_t *val)
+{
+    return net_call(dev, NET_OP_CONFIG_GPIO_READ, "", "w", val);
+}
+
+static int net_expansion_gpio_write(struct bladerf *dev,
+                                    uint32_t mask,
+                                    uint32_t val)
+{
+    return net_write(dev, NET_OP_EXPANSION_GPIO_WRITE, "ww", mask, val);
+}
+
+static int net_expansion_gpio_read(struct bladerf *dev, uint32_t *val)
+{
+    return net_call(dev, NET_OP_EXPANSION_GPIO_READ, "", "w", val);
+}
+
+static int net_expansion_gpio_dir_write(struct bladerf *dev,
+                                        uint32_t mask,
+                                        uint32_t outputs)
+{
+    return net_write(dev, NET_OP_EXPANSION_GPIO_DIR_WRITE, "ww", mask, outputs);
+}
+
+static int net_expansion_gpio_dir_read(struct bladerf *dev, uint32_t *outputs)
+{
+    return net_call(dev, NET_OP_EXPANSION_GPIO_DIR_READ, "", "w", outputs);
+}
+
+static int net_set_iq_gain_correction(struct bladerf *dev,
+                                      bladerf_channel ch,
+                                      int16_t value)
+{
+    return net_write(dev, NET_OP_SET_IQ_GAIN_CORRECTION, "ds", ch, value);
+}
+
+static int net_set_iq_phase_correction(struct bladerf *dev,
+                                       bladerf_channel ch,
+                                       int16_t value)
+{
+    return net_write(dev, NET_OP_SET_IQ_PHASE_CORRECTION, "ds", ch, value);
+}
+
+static int net_get_iq_gain_correction(struct bladerf *dev,
+                                      bladerf_channel ch,
+                                      int16_t *value)
+{
+    return net_call(dev, NET_OP_GET_IQ_GAIN_CORRECTION, "d", "s", ch, value);
+}
+
+static int net_get_iq_phase_correction(struct bladerf *dev,
+                                       bladerf_channel ch,
+                                       int16_t *value)
+{
+    return net_call(dev, NET_OP_GET_IQ_PHASE_CORRECTION, "d", "s", ch, value);
+}
+
+static int net_set_agc_dc_correction(struct bladerf *dev,
+                                     int16_t q_max,
+                                     int16_t i_max,
+                                     int16_t q_mid,
+                                     int16_t i_mid,
+                                     int16_t q_low,
+                                     int16_t i_low)
+{
+    return net_write(dev, NET_OP_SET_AGC_DC_CORRECTION, "ssssss", q_max,
+                     i_max, q_mid, i_mid, q_low, i_low);
+}
+
+static int net_get_timestamp(struct bladerf *dev,
+                             bladerf_direction dir,
+                             uint64_t *value)
+{
+    return net_call(dev, NET_OP_GET_TIMESTAMP, "d", "q", dir, value);
+}
+
+static int net_get_trigger_time(struct bladerf *dev,
+                                bladerf_direction dir,
+                                bool *fired,
+                                uint64_t *value)
+{
+    return net_call(dev, NET_OP_GET_TRIGGER_TIME, "d", "?q", dir, fired,
+                    value);
+}
+
+static int net_si5338_write(struct bladerf *dev, uint8_t addr, uint8_t data)
+{
+    return net_write(dev, NET_OP_SI5338_WRITE, "bb", addr, data);
+}
+
+static int net_si5338_read(struct bladerf *dev, uint8_t addr, uint8_t *data)
+{
+    return net_call(dev, NET_OP_SI5338_READ, "b", "b", addr, data);
+}
+
+static int net_lms_write(struct bladerf *dev, uint8_t addr, uint8_t data)
+{
+    return net_write(dev, NET_OP_LMS_WRITE, "bb", addr, data);
+}
+
+static int net_lms_read(struct bladerf *dev, uint8_t addr, uint8_t *data)
+{
+    return net_call(dev, NET_OP_LMS_READ, "b", "b", addr, data);
+}
+
+static int net_ina219_write(struct bladerf *dev, uint8_t addr, uint16_t data)
+{
+    return net_write(dev, NET_OP_INA219_WRITE, "bh", addr, data);
+}
+
+static int net_ina219_read(struct bladerf *dev, uint8_t addr, uint16_t *data)
+{
+    return net_call(dev, NET_OP_INA219_READ, "b", "h", addr, data);
+}
+
+static int net_ad9361_spi_write(struct bladerf *dev,
+                                uint16_t cmd,
+                                uint64_t data)
+{
+    return net_write(dev, NET_OP_AD9361_SPI_WRITE, "hq", cmd, data);
+}
+
+static int net_ad9361_spi_read(struct bladerf *dev,
+                               uint16_t cmd,
+                               uint64_t *data)
+{
+    return net_call(dev, NET_OP_AD9361_SPI_READ, "h", "q", cmd, data);
+}
+
+static int net_adi_axi_write(struct bladerf *dev, uint32_t addr, uint32_t data)
+{
+    return net_write(dev, NET_OP_ADI_AXI_WRITE, "ww", addr, data);
+}
+
+static int net_adi_axi_read(struct bladerf *dev, uint32_t addr, uint32_t *data)
+{
+    return net_call(dev, NET_OP_ADI_AXI_READ, "w", "w", addr, data);
+}
+
+static int net_wishbone_master_write(struct bladerf *dev,
+                                     uint32_t addr,
+                                     uint32_t data)
+{
+    return net_write(dev, NET_OP_WISHBONE_MASTER_WRITE, "ww", addr, data);
+}
+
+static int net_wishbone_master_read(struct bladerf *dev,
+                                    uint32_t addr,
+                                    uint32_t *data)
+{
+    return net_call(dev, NET_OP_WISHBONE_MASTER_READ, "w", "w", addr, data);
+}
+
+static int net_rfic_command_write(struct bladerf *dev,
+                                  uint16_t cmd,
+                                  uint64_t data)
+{
+    return net_write(dev, NET_OP_RFIC_COMMAND_WRITE, "hq", cmd, data);
+}
+
+static int net_rfic_command_read(struct bladerf *dev,
+                                 uint16_t cmd,
+                                 uint64_t *data)
+{
+    return net_call(dev, NET_OP_RFIC_COMMAND_READ, "h", "q", cmd, data);
+}
+
+static int net_rffe_control_write(struct bladerf *dev, uint32_t value)
+{
+    return net_write(dev, NET_OP_RFFE_CONTROL_WRITE, "w", value);
+}
+
+static int net_rffe_control_read(struct bladerf *dev, uint32_t *value)
+{
+    return net_call(dev, NET_OP_RFFE_CONTROL_READ, "", "w", value);
+}
+
+static int net_rffe_fastlock_save(struct bladerf *dev,
+                                  bool is_tx,
+                                  uint8_t rffe_profile,
+                                  uint16_t nios_profile)
+{
+    return net_write(dev, NET_OP_RFFE_FASTLOCK_SAVE, "?bh", is_tx,
+                     rffe_profile, nios_profile);
+}
+
+static int net_rx_decim_write(struct bladerf *dev, uint32_t value)
+{
+    return net_write(dev, NET_OP_RX_DECIM_WRITE, "w", value);
+}
+
+static int net_rx_decim_read(struct bladerf *dev, uint32_t *value)
+{
+    return net_call(dev, NET_OP_RX_DECIM_READ, "", "w", value);
+}
+
+static int net_ad56x1_vctcxo_trim_dac_write(struct bladerf *dev,
+                                            uint16_t value)
+{
+    return net_write(dev, NET_OP_AD56X1_VCTCXO_TRIM_DAC_WRITE, "h", value);
+}
+
+static int net_ad56x1_vctcxo_trim_dac_read(struct bladerf *dev,
+                                           uint16_t *value)
+{
+    return net_call(dev, NET_OP_AD56X1_VCTCXO_TRIM_DAC_READ, "", "h", value);
+}
+
+static int net_adf400x_write(struct bladerf *dev, uint8_t addr, uint32_t data)
+{
+    return net_write(dev, NET_OP_ADF400X_WRITE, "bw", addr, data);
+}
+
+static int net_adf400x_read(struct bladerf *dev, uint8_t addr, uint32_t *data)
+{
+    return net_call(dev, NET_OP_ADF400X_READ, "b", "w", addr, data);
+}
+
+static int net_vctcxo_dac_write(struct bladerf *dev,
+                                uint8_t addr,
+                                uint16_t value)
+{
+    return net_write(dev, NET_OP_VCTCXO_DAC_WRITE, "bh", addr, value);
+}
+
+static int net_vctcxo_dac_read(struct bladerf *dev,
+                               uint8_t addr,
+                               uint16_t *value)
+{
+    return net_call(dev, NET_OP_VCTCXO_DAC_READ, "b", "h", addr, value);
+}
+
+static int net_set_vctcxo_tamer_mode(struct bladerf *dev,
+                                     bladerf_vctcxo_tamer_mode mode)
+{
+    return net_call(dev, NET_OP_SET_VCTCXO_TAMER_MODE, "d", "", mode);
+}
+
+static int net_get_vctcxo_tamer_mode(struct bladerf *dev,
+                                     bladerf_vctcxo_tamer_mode *mode)
+{
+    int32_t value;
+    int status;
+
+    status = net_call(dev, NET_OP_GET_VCTCXO_TAMER_MODE, "", "d", &value);
+    if (status == 0) {
+        *mode = (bladerf_vctcxo_tamer_mode)value;
+    }
+
+    return status;
+}
+
+static int net_xb_spi(struct bladerf *dev, uint32_t value)
+{
+    return net_write(dev, NET_OP_XB_SPI, "w", value);
+}
+
+static int net_set_firmware_loopback(struct bladerf *dev, bool enable)
+{
+    return net_call(dev, NET_OP_SET_FIRMWARE_LOOPBACK, "?", "", enable);
+}
+
+static int net_get_firmware_loopback(struct bladerf *dev, bool *is_enabled)
+{
+    return net_call(dev, NET_OP_GET_FIRMWARE_LOOPBACK, "", "?", is_enabled);
+}
+
+static int net_set_rf_dma_buffers(struct bladerf *dev, unsigned int count)
+{
+    return net_call(dev, NET_OP_SET_RF_DMA_BUFFERS, "w", "",
+                    (uint32_t)count);
+}
+
+static int net_set_rf_dma_channel(struct bladerf *dev,
+                                  bladerf_direction dir,
+                                  unsigned int count)
+{
+    return net_call(dev, NET_OP_SET_RF_DMA_CHANNEL, "dw", "", dir,
+                    (uint32_t)count);
+}
+
+static int net_enable_module(struct bladerf *dev,
+                             bladerf_direction dir,
+                             bool enable)
+{
+    return net_call(dev, NET_OP_ENABLE_MODULE, "d?", "", dir, enable);
+}
+
+static int net_alloc_stream_buffers(struct bladerf_stream *stream,
+                                    size_t size,
+                                    void **buf)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static void net_free_stream_buffers(struct bladerf_stream *stream,
+                                    void *buf,
+                                    size_t size)
+{
+    return;
+}
+
+static void net_free_stream_data(struct net_stream_data *data)
+{
+    free(data->submit_time_us);
+    free(data->lengths);
+    free(data->buffers);
+    free(data);
+}
+
+static int net_init_stream(struct bladerf_stream *stream, size_t num_transfers)
+{
+    struct bladerf_net *net = net_backend(stream->dev);
+    struct net_stream_data *data;
+
+    if (stream->format == BLADERF_FORMAT_PACKET_META) {
+        log_debug("The net backend does not support the packet format.\n");
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    data = calloc(1, sizeof(*data));
+    if (data == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    data->buffers        = calloc(num_transfers, sizeof(data->buffers[0]));
+    data->lengths        = calloc(num_transfers, sizeof(data->lengths[0]));
+    data->submit_time_us = calloc(num_transfers, sizeof(uint64_t));
+
+    if (data->buffers == NULL || data->lengths == NULL ||
+        data->submit_time_us == NULL) {
+        net_free_stream_data(data);
+        return BLADERF_ERR_MEM;
+    }
+
+    if (pthread_cond_init(&data->submitted, NULL) != 0) {
+        net_free_stream_data(data);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    data->fd            = -1;
+    data->pack          = stream->format == BLADERF_FORMAT_SC16_Q11
+                              ? net->pack
+                              : NET_PACK_NONE;
+    data->num_transfers = num_transfers;
+    data->num_avail     = num_transfers;
+    data->i             = 0;
+
+    stream->backend_data = data;
+    return 0;
+}
+
+/* Open a stream connection, and start the stream on the server */
+static int net_stream_connect(struct bladerf_stream *stream,
+                              bladerf_channel_layout layout)
+{
+    struct bladerf_net *net        = net_backend(stream->dev);
+    struct net_stream_data *data   = stream->backend_data;
+    struct net_msg req;
+    struct net_hdr hdr;
+    int status;
+
+    status = net_connect(net->host, net->port, &data->fd);
+    if (status != 0) {
+        return status;
+    }
+
+    net_config_socket(data->fd, true, stream->transfer_timeout);
+
+    net_msg_init(&req);
+    net_pack(&req, "wwwwwwb?", (uint32_t)layout, (uint32_t)stream->format,
+             (uint32_t)stream->samples_per_buffer,
+             (uint32_t)stream->num_buffers, (uint32_t)data->num_transfers,
+             (uint32_t)stream->transfer_timeout, data->pack,
+             stream->tx_variable_length);
+
+    hdr.length = (uint32_t)req.len;
+    hdr.op     = NET_OP_STREAM;
+    hdr.count  = 0;
+    hdr.status = 0;
+
+    status = req.error ? BLADERF_ERR_MEM
+                       : net_send_frame(data->fd, &hdr, req.data);
+    net_msg_free(&req);
+
+    /* The server responds once its stream is initialized */
+    if (status == 0) {
+        status = net_recv_hdr(data->fd, &hdr);
+    }
+
+    if (status == 0) {
+        if (hdr.op != NET_OP_STREAM || hdr.length != 0) {
+            status = BLADERF_ERR_IO;
+        } else {
+            status = hdr.status;
+        }
+    }
+
+    if (status != 0) {
+        log_debug("Failed to start the stream on the server: %s\n",
+                  bladerf_strerror(status));
+        close(data->fd);
+        data->fd = -1;
+    }
+
+    return status;
+}
+
+static inline size_t net_oldest_transfer(struct net_stream_data *data)
+{
+    const size_t in_flight = data->num_transfers - data->num_avail;
+    return (data->i + data->num_transfers - in_flight) % data->num_transfers;
+}
+
+/* Precondition: A transfer is available and stream->lock is held */
+static void net_submit_transfer(struct bladerf_stream *stream,
+                                void *buffer,
+                                size_t length)
+{
+    struct net_stream_data *data = stream->backend_data;
+
+    assert(data->num_avail != 0);
+
+    data->buffers[data->i]        = buffer;
+    data->lengths[data->i]        = length;
+    data->submit_time_us[data->i] = time_now_us();
+    data->i = (data->i + 1) % data->num_transfers;
+    data->num_avail--;
+
+    pthread_cond_signal(&data->submitted);
+}
+
+/* Receive a sample frame into an RX buffer, without stream->lock held */
+static int net_rx_transfer(struct bladerf_stream *stream,
+                           void *buffer,
+                           size_t *bytes)
+{
+    struct net_stream_data *data = stream->backend_data;
+    struct net_hdr hdr;
+    int status;
+
+    status = net_recv_hdr(data->fd, &hdr);
+    if (status != 0) {
+        return status;
+    }
+
+    if (hdr.op != NET_OP_SAMPLES) {
+        return BLADERF_ERR_IO;
+    } else if (hdr.status != 0) {
+        /* The stream ended on the server */
+        return hdr.status;
+    }
+
+    *bytes = net_unpacked_bytes(data->pack, hdr.length);
+    if (*bytes > async_stream_buf_bytes(stream)) {
+        log_debug("Received a sample frame of %u bytes, which exceeds the "
+                  "stream's buffers\n", hdr.length);
+        return BLADERF_ERR_IO;
+    }
+
+    if (data->pack == NET_PACK_NONE) {
+        return net_recv_all(data->fd, buffer, hdr.length);
+    }
+
+    status = net_recv_all(data->fd, data->packed, hdr.length);
+    if (status == 0) {
+        net_unpack_samples(data->pack, data->packed, buffer, *bytes);
+    }
+
+    return status;
+}
+
+/* Send a TX buffer as a sample frame, without stream->lock held */
+static int net_tx_transfer(struct bladerf_stream *stream,
+                           const void *buffer,
+                           size_t bytes)
+{
+    struct net_stream_data *data = stream->backend_data;
+    struct net_hdr hdr;
+
+    hdr.length = (uint32_t)net_packed_bytes(data->pack, bytes);
+    hdr.op     = NET_OP_SAMPLES;
+    hdr.count  = 0;
+    hdr.status = 0;
+
+    if (data->pack == NET_PACK_NONE) {
+        return net_send_frame(data->fd, &hdr, buffer);
+    }
+
+    net_pack_samples(data->pack, buffer, data->packed, bytes);
+    return net_send_frame(data->fd, &hdr, data->packed);
+}
+
+/* Wait for a sample frame to arrive. Returns 1 if one has, 0 if the wait
+ * timed out, or a BLADERF_ERR_* value on failure. */
+static int net_rx_wait(struct net_stream_data *data)
+{
+    struct pollfd pfd;
+    int status;
+
+    pfd.fd      = data->fd;
+    pfd.events  = POLLIN;
+    pfd.revents = 0;
+
+    status = poll(&pfd, 1, NET_MAX_WAIT_MS);
+    if (status < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+
+        log_debug("poll failed: %s\n", strerror(errno));
+        return BLADERF_ERR_IO;
+    }
+
+    return status != 0 ? 1 : 0;
+}
+
+/* Complete the oldest transfer in flight and hand it to the user callback.
+ * Assumes stream->lock is held. */
+static void net_complete_transfer(struct bladerf_stream *stream,
+                                  bladerf_direction dir,
+                                  size_t bytes,
+                                  uint64_t now)
+{
+    struct net_stream_data *data = stream->backend_data;
+    const size_t idx             = net_oldest_transfer(data);
+    const uint64_t submitted     = data->submit_time_us[idx];
+    void *buffer                 = data->buffers[idx];
+    struct bladerf_metadata metadata;
+    void *next_buffer;
+
+    /* Only the host arrival time is provided to the callback */
+    memset(&metadata, 0, sizeof(metadata));
+    metadata.host_timestamp = wallclock_get_monotonic_nsec();
+
+    async_record_transfer(stream, now > submitted ? now - submitted : 0,
+                          dir == BLADERF_RX &&
+                              bytes != async_stream_buf_bytes(stream));
+
+    if (stream->state == STREAM_RUNNING) {
+        /* The transfer remains the oldest in flight until the callback
+         * returns, so buffers submitted meanwhile queue up behind it */
+        MUTEX_UNLOCK(&stream->lock);
+        next_buffer = async_stream_cb(stream, &metadata, buffer,
+                                      bytes_to_samples(stream->format, bytes));
+        MUTEX_LOCK(&stream->lock);
+
+        data->num_avail++;
+        pthread_cond_signal(&stream->can_submit_buffer);
+
+        if (next_buffer == BLADERF_STREAM_SHUTDOWN) {
+            stream->state = STREAM_SHUTTING_DOWN;
+        } else if (next_buffer != BLADERF_STREAM_NO_DATA &&
+                   stream->state == STREAM_RUNNING) {
+            net_submit_transfer(stream, next_buffer,
+                                dir == BLADERF_TX
+                                    ? async_stream_tx_bytes(stream, &metadata)
+                                    : async_stream_buf_bytes(stream));
+        }
+    } else {
+        data->num_avail++;
+        pthread_cond_signal(&stream->can_submit_buffer);
+    }
+}
+
+static int net_stream(struct bladerf_stream *stream,
+                      bladerf_channel_layout layout)
+{
+    size_t i, idx, bytes;
+    int status;
+    void *buffer;
+    uint64_t now, last_us;
+    struct timespec timeout_abs;
+    struct bladerf_metadata metadata;
+    struct bladerf *dev            = stream->dev;
+    struct net_stream_data *data   = stream->backend_data;
+    const bladerf_direction dir    = layout & BLADERF_DIRECTION_MASK;
+
+    status = net_stream_connect(stream, layout);
+    if (status != 0) {
+        return status;
+    }
+
+    if (data->pack != NET_PACK_NONE && data->packed == NULL) {
+        data->packed = malloc(
+            net_packed_bytes(data->pack, async_stream_buf_bytes(stream)));
+        if (data->packed == NULL) {
+            close(data->fd);
+            data->fd = -1;
+            return BLADERF_ERR_MEM;
+        }
+    }
+
+    memset(&metadata, 0, sizeof(metadata));
+
+    MUTEX_LOCK(&stream->lock);
+
+    /* Set up initial set of buffers */
+    for (i = 0; i < data->num_transfers; i++) {
+        if (dir == BLADERF_TX) {
+            buffer = stream->cb(dev, stream, &metadata, NULL,
+                                stream->samples_per_buffer, stream->user_data);
+
+            if (buffer == BLADERF_STREAM_SHUTDOWN) {
+                stream->state = STREAM_SHUTTING_DOWN;
+                break;
+            }
+        } else {
+            buffer = stream->buffers[i];
+        }
+
+        if (buffer != BLADERF_STREAM_NO_DATA) {
+            net_submit_transfer(stream, buffer,
+                                dir == BLADERF_TX
+                                    ? async_stream_tx_bytes(stream, &metadata)
+                                    : async_stream_buf_bytes(stream));
+        }
+    }
+
+    /* Obtain the initial buffers of a batched TX stream */
+    MUTEX_UNLOCK(&stream->lock);
+    async_dispatch_batch(stream);
+    MUTEX_LOCK(&stream->lock);
+
+    last_us = time_now_us();
+
+    while (stream->state != STREAM_DONE) {
+        if (stream->state == STREAM_SHUTTING_DOWN) {
+            /* Transfers are carried out one at a time on this thread, so
+             * none are outstanding and all may be reclaimed at once */
+            data->num_avail = data->num_transfers;
+            stream->state   = STREAM_DONE;
+            pthread_cond_broadcast(&stream->can_submit_buffer);
+            break;
+        }
+
+        if (data->num_avail == data->num_transfers) {
+            /* Wait for the user to submit a buffer */
+            if (populate_abs_timeout(&timeout_abs, NET_MAX_WAIT_MS) != 0) {
+                stream->error_code = BLADERF_ERR_UNEXPECTED;
+                stream->state      = STREAM_SHUTTING_DOWN;
+                continue;
+            }
+
+            pthread_cond_timedwait(&data->submitted, &stream->lock,
+                                   &timeout_abs);
+            last_us = time_now_us();
+            continue;
+        }
+
+        /* The oldest transfer's buffer remains ours while it is carried
+         * out, so the lock need not be held meanwhile */
+        idx    = net_oldest_transfer(data);
+        buffer = data->buffers[idx];
+        bytes  = data->lengths[idx];
+
+        MUTEX_UNLOCK(&stream->lock);
+
+        if (dir == BLADERF_RX) {
+            status = net_rx_wait(data);
+            if (status == 1) {
+                status = net_rx_transfer(stream, buffer, &bytes);
+            } else if (status == 0) {
+                /* Poll again, unless the transfer has timed out */
+                now = time_now_us();
+                if (stream->transfer_timeout != 0 &&
+                    now - last_us > stream->transfer_timeout * 1000ull) {
+                    status = BLADERF_ERR_TIMEOUT;
+                } else {
+                    MUTEX_LOCK(&stream->lock);
+                    continue;
+                }
+            }
+        } else {
+            status = net_tx_transfer(stream, buffer, bytes);
+        }
+
+        now     = time_now_us();
+        last_us = now;
+
+        MUTEX_LOCK(&stream->lock);
+
+        if (status != 0) {
+            log_debug("Net %s stream failed: %s\n",
+                      dir == BLADERF_TX ? "TX" : "RX",
+                      bladerf_strerror(status));
+            stream->error_code = status;
+            stream->state      = STREAM_SHUTTING_DOWN;
+            continue;
+        }
+
+        net_complete_transfer(stream, dir, bytes, now);
+
+        if (stream->batch_cb != NULL) {
+            MUTEX_UNLOCK(&stream->lock);
+            async_dispatch_batch(stream);
+            MUTEX_LOCK(&stream->lock);
+        }
+    }
+
+    MUTEX_UNLOCK(&stream->lock);
+
+    /* Closing the connection ends the stream on the server */
+    close(data->fd);
+    data->fd = -1;
+
+    return 0;
+}
+
+/* The top-level code will have aquired the stream->lock for us */
+static int net_submit_stream_buffer(struct bladerf_stream *stream,
+                                    void *buffer,
+                                    size_t *length,
+                                    unsigned int timeout_ms,
+                                    bool nonblock)
+{
+    int status = 0;
+    struct net_stream_data *data = stream->backend_data;
+    struct timespec timeout_abs;
+
+    if (buffer == BLADERF_STREAM_SHUTDOWN) {
+        if (data->num_avail == data->num_transfers) {
+            stream->state = STREAM_DONE;
+        } else {
+            stream->state = STREAM_SHUTTING_DOWN;
+        }
+
+        pthread_cond_signal(&data->submitted);
+        return 0;
+    }
+
+    if (data->num_avail == 0) {
+        if (nonblock) {
+            log_debug("Non-blocking buffer submission requested, but no "
+                      "transfers are currently available.\n");
+
+            return BLADERF_ERR_WOULD_BLOCK;
+        }
+
+        if (timeout_ms != 0) {
+            status = populate_abs_timeout(&timeout_abs, timeout_ms);
+            if (status != 0) {
+                return BLADERF_ERR_UNEXPECTED;
+            }
+
+            while (data->num_avail == 0 && status == 0) {
+                status = pthread_cond_timedwait(&stream->can_submit_buffer,
+                                                &stream->lock, &timeout_abs);
+            }
+        } else {
+            while (data->num_avail == 0 && status == 0) {
+                status = pthread_cond_wait(&stream->can_submit_buffer,
+                                           &stream->lock);
+            }
+        }
+    }
+
+    if (status == ETIMEDOUT) {
+        log_debug("%s: Timed out waiting for a transfer to become available.\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_TIMEOUT;
+    } else if (status != 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    net_submit_transfer(stream, buffer,
+                        (stream->layout & BLADERF_DIRECTION_MASK) == BLADERF_TX
+                            ? *length
+                            : async_stream_buf_bytes(stream));
+    return 0;
+}
+
+static void net_deinit_stream(struct bladerf_stream *stream)
+{
+    struct net_stream_data *data = stream->backend_data;
+
+    if (data != NULL) {
+        if (data->fd >= 0) {
+            close(data->fd);
+        }
+
+        pthread_cond_destroy(&data->submitted);
+        free(data->packed);
+        net_free_stream_data(data);
+        stream->backend_data = NULL;
+    }
+}
+
+static int net_retune(struct bladerf *dev,
+                      bladerf_channel ch,
+                      uint64_t timestamp,
+                      uint16_t nint,
+                      uint32_t nfrac,
+                      uint8_t freqsel,
+                      uint8_t vcocap,
+                      bool low_band,
+                      uint8_t xb_gpio,
+                      bool quick_tune)
+{
+    return net_call(dev, NET_OP_RETUNE, "dqhwbb?b?", "", ch, timestamp, nint,
+                    nfrac, freqsel, vcocap, low_band, xb_gpio, quick_tune);
+}
+
+static int net_retune2(struct bladerf *dev,
+                       bladerf_channel ch,
+                       uint64_t timestamp,
+                       uint16_t nios_profile,
+                       uint8_t rffe_profile,
+                       uint8_t port,
+                       uint8_t spdt)
+{
+    return net_call(dev, NET_OP_RETUNE2, "dqhbbb", "", ch, timestamp,
+                    nios_profile, rffe_profile, port, spdt);
+}
+
+static int net_retune2_gain(struct bladerf *dev,
+                            bladerf_channel ch,
+                            uint64_t timestamp,
+                            uint16_t setting)
+{
+    return net_call(dev, NET_OP_RETUNE2_GAIN, "dqh", "", ch, timestamp,
+                    setting);
+}
+
+static int net_retune_queue(struct bladerf *dev,
+                            bladerf_channel ch,
+                            uint8_t cmd,
+                            uint64_t start,
+                            uint64_t end,
+                            struct bladerf_retune_queue_status *status,
+                            unsigned int *canceled)
+{
+    uint32_t pending, capacity, num_canceled;
+    uint64_t next_timestamp;
+    int rv;
+
+    rv = net_call(dev, NET_OP_RETUNE_QUEUE, "dbqq", "wwqw", ch, cmd, start,
+                  end, &pending, &capacity, &next_timestamp, &num_canceled);
+
+    if (rv == 0 && status != NULL) {
+        status->pending        = pending;
+        status->capacity       = capacity;
+        status->next_timestamp = next_timestamp;
+    }
+
+    if (rv == 0 && canceled != NULL) {
+        *canceled = num_canceled;
+    }
+
+    return rv;
+}
+
+static int net_timed_write(struct bladerf *dev,
+                           bladerf_channel ch,
+                           uint64_t timestamp,
+                           uint8_t type,
+                           uint8_t id,
+                           uint8_t addr,
+                           uint32_t data)
+{
+    return net_call(dev, NET_OP_TIMED_WRITE, "dqbbbw", "", ch, timestamp, type,
+                    id, addr, data);
+}
+
+static int net_vctcxo_tamer(struct bladerf *dev,
+                            uint8_t cmd,
+                            bool seed_valid,
+                            uint16_t seed,
+                            struct bladerf_vctcxo_tamer_status *status)
+{
+    int32_t state, error_1s, error_10s;
+    uint32_t measurements;
+    uint16_t trim_dac;
+    bool locked;
+    int rv;
+
+    rv = net_call(dev, NET_OP_VCTCXO_TAMER, "b?h", "d?whdd", cmd, seed_valid,
+                  seed, &state, &locked, &measurements, &trim_dac, &error_1s,
+                  &error_10s);
+
+    if (rv == 0 && status != NULL) {
+        status->state        = (bladerf_vctcxo_tamer_state)state;
+        status->locked       = locked;
+        status->measurements = measurements;
+        status->trim_dac     = trim_dac;
+        status->error_1s     = error_1s;
+        status->error_10s    = error_10s;
+    }
+
+    return rv;
+}
+
+static int net_dc_cal_clear(struct bladerf *dev)
+{
+    return net_write(dev, NET_OP_DC_CAL_CLEAR, "");
+}
+
+static int net_dc_cal_add(struct bladerf *dev,
+                          uint16_t nint,
+                          uint32_t nfrac,
+                          uint8_t freqsel,
+                          uint8_t vcocap,
+                          bool low_band,
+                          bool quick_tune)
+{
+    return net_write(dev, NET_OP_DC_CAL_ADD, "hwbb??", nint, nfrac, freqsel,
+                     vcocap, low_band, quick_tune);
+}
+
+static int net_dc_cal_start(struct bladerf *dev,
+                            uint32_t num_samples,
+                            uint16_t settle_us)
+{
+    return net_call(dev, NET_OP_DC_CAL_START, "wh", "", num_samples,
+                    settle_us);
+}
+
+static int net_dc_cal_status(struct bladerf *dev, bool *busy, uint8_t *done)
+{
+    return net_call(dev, NET_OP_DC_CAL_STATUS, "", "?b", busy, done);
+}
+
+static int net_dc_cal_read(struct bladerf *dev,
+                           uint8_t index,
+                           int16_t *dc_i,
+                           int16_t *dc_q)
+{
+    return net_call(dev, NET_OP_DC_CAL_READ, "b", "ss", index, dc_i, dc_q);
+}
+
+static int net_lms_dc_cal(struct bladerf *dev, bladerf_cal_module module)
+{
+    return net_call(dev, NET_OP_LMS_DC_CAL, "d", "", module);
+}
+
+static int net_load_fw_from_bootloader(bladerf_backend backend,
+                                       uint8_t bus,
+                                       uint8_t addr,
+                                       struct fx3_firmware *fw)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int net_read_fw_log_entries(struct bladerf *dev,
+                                   logger_entry *e,
+                                   unsigned int count)
+{
+    const size_t len = (size_t)count * 4;
+    uint8_t *raw;
+    unsigned int i;
+    int status;
+
+    raw = malloc(len);
+    if (raw == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    /* Entries are carried as big-endian words */
+    status = net_call(dev, NET_OP_READ_FW_LOG_ENTRIES, "w", "B",
+                      (uint32_t)count, raw, len);
+
+    for (i = 0; status == 0 && i < count; i++) {
+        e[i] = ((logger_entry)raw[4 * i] << 24) |
+               ((logger_entry)raw[4 * i + 1] << 16) |
+               ((logger_entry)raw[4 * i + 2] << 8) |
+               (logger_entry)raw[4 * i + 3];
+    }
+
+    free(raw);
+    return status;
+}
+
+static int net_read_fw_log(struct bladerf *dev, logger_entry *e)
+{
+    return net_read_fw_log_entries(dev, e, 1);
+}
+
+static int net_read_trigger(struct bladerf *dev,
+                            bladerf_channel ch,
+                            bladerf_trigger_signal trigger,
+                            uint8_t *value)
+{
+    return net_call(dev, NET_OP_READ_TRIGGER, "dd", "b", ch, trigger, value);
+}
+
+static int net_write_trigger(struct bladerf *dev,
+                             bladerf_channel ch,
+                             bladerf_trigger_signal trigger,
+                             uint8_t value)
+{
+    return net_write(dev, NET_OP_WRITE_TRIGGER, "ddb", ch, trigger, value);
+}
+
+static int net_batch_begin(struct bladerf *dev)
+{
+    struct bladerf_net *net = net_backend(dev);
+
+    MUTEX_LOCK(&net->lock);
+    net->batch_depth++;
+    MUTEX_UNLOCK(&net->lock);
+
+    return 0;
+}
+
+static int net_batch_commit(struct bladerf *dev)
+{
+    struct bladerf_net *net = net_backend(dev);
+    int status = 0;
+
+    MUTEX_LOCK(&net->lock);
+
+    if (net->batch_depth == 0) {
+        status = BLADERF_ERR_INVAL;
+    } else if (--net->batch_depth == 0) {
+        net_batch_issue(net);
+        status            = net->batch_status;
+        net->batch_status = 0;
+    }
+
+    MUTEX_UNLOCK(&net->lock);
+
+    return status;
+}
+
+static int net_batch_flush(struct bladerf *dev)
+{
+    struct bladerf_net *net = net_backend(dev);
+    int status;
+
+    MUTEX_LOCK(&net->lock);
+    status = net_batch_issue(net);
+    MUTEX_UNLOCK(&net->lock);
+
+    return status;
+}
+
+const struct backend_fns backend_fns_net = {
+    FIELD_INIT(.matches, net_matches),
+
+    FIELD_INIT(.probe, net_probe),
+    FIELD_INIT(.hotplug_start, net_hotplug_start),
+    FIELD_INIT(.hotplug_stop, net_hotplug_stop),
+
+    FIELD_INIT(.get_vid_pid, net_get_vid_pid),
+    FIELD_INIT(.get_flash_id, net_get_flash_id),
+    FIELD_INIT(.open, net_open),
+    FIELD_INIT(.set_fpga_protocol, net_set_fpga_protocol),
+    FIELD_INIT(.close, net_close),
+
+    FIELD_INIT(.is_fw_ready, net_is_fw_ready),
+
+    FIELD_INIT(.get_handle, net_get_handle),
+
+    FIELD_INIT(.load_fpga, net_load_fpga),
+    FIELD_INIT(.is_fpga_configured, net_is_fpga_configured),
+    FIELD_INIT(.get_fpga_source, net_get_fpga_source),
+
+    FIELD_INIT(.get_fw_version, net_get_fw_version),
+    FIELD_INIT(.get_fpga_version, net_get_fpga_version),
+    FIELD_INIT(.get_config_id, net_get_config_id),
+    FIELD_INIT(.set_config_id, net_set_config_id),
+
+    FIELD_INIT(.erase_flash_blocks, net_erase_flash_blocks),
+    FIELD_INIT(.read_flash_pages, net_read_flash_pages),
+    FIELD_INIT(.write_flash_pages, net_write_flash_pages),
+    FIELD_INIT(.verify_flash_pages, net_verify_flash_pages),
+
+    FIELD_INIT(.device_reset, net_device_reset),
+    FIELD_INIT(.jump_to_bootloader, net_jump_to_bootloader),
+    FIELD_INIT(.recover, NULL),
+
+    FIELD_INIT(.get_cal, net_get_cal),
+    FIELD_INIT(.get_otp, net_get_otp),
+    FIELD_INIT(.write_otp, net_write_otp),
+    FIELD_INIT(.lock_otp, net_lock_otp),
+    FIELD_INIT(.get_device_speed, net_get_device_speed),
+
+    FIELD_INIT(.config_gpio_write, net_config_gpio_write),
+    FIELD_INIT(.config_gpio_read, net_config_gpio_read),
+
+    FIELD_INIT(.expansion_gpio_write, net_expansion_gpio_write),
+    FIELD_INIT(.expansion_gpio_read, net_expansion_gpio_read),
+    FIELD_INIT(.expansion_gpio_dir_write, net_expansion_gpio_dir_write),
+    FIELD_INIT(.expansion_gpio_dir_read, net_expansion_gpio_dir_read),
+
+    FIELD_INIT(.set_iq_gain_correction, net_set_iq_gain_correction),
+    FIELD_INIT(.set_iq_phase_correction, net_set_iq_phase_correction),
+    FIELD_INIT(.get_iq_gain_correction, net_get_iq_gain_correction),
+    FIELD_INIT(.get_iq_phase_correction, net_get_iq_phase_correction),
+
+    FIELD_INIT(.set_agc_dc_correction, net_set_agc_dc_correction),
+
+    FIELD_INIT(.get_timestamp, net_get_timestamp),
+    FIELD_INIT(.get_trigger_time, net_get_trigger_time),
+
+    FIELD_INIT(.si5338_write, net_si5338_write),
+    FIELD_INIT(.si5338_read, net_si5338_read),
+
+    FIELD_INIT(.lms_write, net_lms_write),
+    FIELD_INIT(.lms_read, net_lms_read),
+
+    FIELD_INIT(.ina219_write, net_ina219_write),
+    FIELD_INIT(.ina219_read, net_ina219_read),
+
+    FIELD_INIT(.ad9361_spi_write, net_ad9361_spi_write),
+    FIELD_INIT(.ad9361_spi_read, net_ad9361_spi_read),
+
+    FIELD_INIT(.adi_axi_write, net_adi_axi_write),
+    FIELD_INIT(.adi_axi_read, net_adi_axi_read),
+
+    FIELD_INIT(.wishbone_master_write, net_wishbone_master_write),
+    FIELD_INIT(.wishbone_master_read, net_wishbone_master_read),
+
+    FIELD_INIT(.rfic_command_write, net_rfic_command_write),
+    FIELD_INIT(.rfic_command_read, net_rfic_command_read),
+
+    FIELD_INIT(.rffe_control_write, net_rffe_control_write),
+    FIELD_INIT(.rffe_control_read, net_rffe_control_read),
+
+    FIELD_INIT(.rffe_fastlock_save, net_rffe_fastlock_save),
+
+    FIELD_INIT(.rx_decim_write, net_rx_decim_write),
+    FIELD_INIT(.rx_decim_read, net_rx_decim_read),
+
+    FIELD_INIT(.ad56x1_vctcxo_trim_dac_write,
+               net_ad56x1_vctcxo_trim_dac_write),
+    FIELD_INIT(.ad56x1_vctcxo_trim_dac_read, net_ad56x1_vctcxo_trim_dac_read),
+
+    FIELD_INIT(.adf400x_write, net_adf400x_write),
+    FIELD_INIT(.adf400x_read, net_adf400x_read),
+
+    FIELD_INIT(.vctcxo_dac_write, net_vctcxo_dac_write),
+    FIELD_INIT(.vctcxo_dac_read, net_vctcxo_dac_read),
+
+    FIELD_INIT(.set_vctcxo_tamer_mode, net_set_vctcxo_tamer_mode),
+    FIELD_INIT(.get_vctcxo_tamer_mode, net_get_vctcxo_tamer_mode),
+
+    FIELD_INIT(.xb_spi, net_xb_spi),
+
+    FIELD_INIT(.set_firmware_loopback, net_set_firmware_loopback),
+    FIELD_INIT(.get_firmware_loopback, net_get_firmware_loopback),
+    FIELD_INIT(.set_rf_dma_buffers, net_set_rf_dma_buffers),
+    FIELD_INIT(.set_rf_dma_channel, net_set_rf_dma_channel),
+
+    FIELD_INIT(.enable_module, net_enable_module),
+
+    FIELD_INIT(.alloc_stream_buffers, net_alloc_stream_buffers),
+    FIELD_INIT(.free_stream_buffers, net_free_stream_buffers),
+    FIELD_INIT(.init_stream, net_init_stream),
+    FIELD_INIT(.stream, net_stream),
+    FIELD_INIT(.submit_stream_buffer, net_submit_stream_buffer),
+    FIELD_INIT(.deinit_stream, net_deinit_stream),
+
+    FIELD_INIT(.retune, net_retune),
+    FIELD_INIT(.retune2, net_retune2),
+    FIELD_INIT(.retune2_gain, net_retune2_gain),
+    FIELD_INIT(.retune_queue, net_retune_queue),
+    FIELD_INIT(.timed_write, net_timed_write),
+    FIELD_INIT(.vctcxo_tamer, net_vctcxo_tamer),
+
+    FIELD_INIT(.dc_cal_clear, net_dc_cal_clear),
+    FIELD_INIT(.dc_cal_add, net_dc_cal_add),
+    FIELD_INIT(.dc_cal_start, net_dc_cal_start),
+    FIELD_INIT(.dc_cal_status, net_dc_cal_status),
+    FIELD_INIT(.dc_cal_read, net_dc_cal_read),
+    FIELD_INIT(.lms_dc_cal, net_lms_dc_cal),
+    FIELD_INIT(.invalidate_reg_shadow, NULL),
+
+    FIELD_INIT(.load_fw_from_bootloader, net_load_fw_from_bootloader),
+
+    FIELD_INIT(.read_fw_log, net_read_fw_log),
+    FIELD_INIT(.read_fw_log_entries, net_read_fw_log_entries),
+
+    FIELD_INIT(.read_trigger, net_read_trigger),
+    FIELD_INIT(.write_trigger, net_write_trigger),
+
+    FIELD_INIT(.batch_begin, net_batch_begin),
+    FIELD_INIT(.batch_commit, net_batch_commit),
+    FIELD_INIT(.batch_flush, net_batch_flush),
+
+    FIELD_INIT(.enable_control_stats, NULL),
+    FIELD_INIT(.get_control_stats, NULL),
+
+    FIELD_INIT(.name, "net"),
+};
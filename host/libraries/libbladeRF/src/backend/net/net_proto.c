@@ -0,0 +1,552 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+
+#include "log.h"
+
+#include "streaming/convert.h"
+#include "streaming/format.h"
+
+#include "backend/net/net_proto.h"
+
+/* Socket buffer size requested for stream connections */
+#define NET_STREAM_SOCKBUF  (4 * 1024 * 1024)
+
+static inline void put_be(uint8_t *p, uint64_t v, unsigned int n)
+{
+    unsigned int i;
+
+    for (i = 0; i < n; i++) {
+        p[i] = (uint8_t)(v >> (8 * (n - 1 - i)));
+    }
+}
+
+static inline uint64_t get_be(const uint8_t *p, unsigned int n)
+{
+    uint64_t v = 0;
+    unsigned int i;
+
+    for (i = 0; i < n; i++) {
+        v = (v << 8) | p[i];
+    }
+
+    return v;
+}
+
+void net_msg_init(struct net_msg *m)
+{
+    memset(m, 0, sizeof(*m));
+}
+
+void net_msg_free(struct net_msg *m)
+{
+    free(m->data);
+    net_msg_init(m);
+}
+
+void net_msg_reset(struct net_msg *m)
+{
+    m->len   = 0;
+    m->pos   = 0;
+    m->error = false;
+}
+
+int net_msg_reserve(struct net_msg *m, size_t len)
+{
+    size_t cap;
+    uint8_t *data;
+
+    if (len <= m->cap) {
+        return 0;
+    }
+
+    for (cap = m->cap != 0 ? m->cap : 256; cap < len; cap *= 2);
+
+    data = realloc(m->data, cap);
+    if (data == NULL) {
+        m->error = true;
+        return BLADERF_ERR_MEM;
+    }
+
+    m->data = data;
+    m->cap  = cap;
+    return 0;
+}
+
+static uint8_t *msg_append(struct net_msg *m, size_t n)
+{
+    uint8_t *p;
+
+    if (m->error || net_msg_reserve(m, m->len + n) != 0) {
+        return NULL;
+    }
+
+    p = m->data + m->len;
+    m->len += n;
+    return p;
+}
+
+static const uint8_t *msg_consume(struct net_msg *m, size_t n)
+{
+    const uint8_t *p;
+
+    if (m->error || m->len - m->pos < n) {
+        m->error = true;
+        return NULL;
+    }
+
+    p = m->data + m->pos;
+    m->pos += n;
+    return p;
+}
+
+static void pack_int(struct net_msg *m, uint64_t v, unsigned int n)
+{
+    uint8_t *p = msg_append(m, n);
+
+    if (p != NULL) {
+        put_be(p, v, n);
+    }
+}
+
+void net_vpack(struct net_msg *m, const char *fmt, va_list *ap)
+{
+    const void *bytes;
+    size_t len;
+    uint8_t *p;
+
+    for (; *fmt != '\0'; fmt++) {
+        switch (*fmt) {
+            case 'b':
+            case '?':
+                pack_int(m, (uint8_t)va_arg(*ap, int), 1);
+                break;
+
+            case 'h':
+            case 's':
+                pack_int(m, (uint16_t)va_arg(*ap, int), 2);
+                break;
+
+            case 'w':
+                pack_int(m, va_arg(*ap, uint32_t), 4);
+                break;
+
+            case 'd':
+                pack_int(m, (uint32_t)va_arg(*ap, int32_t), 4);
+                break;
+
+            case 'q':
+                pack_int(m, va_arg(*ap, uint64_t), 8);
+                break;
+
+            case 'B':
+                bytes = va_arg(*ap, const void *);
+                len   = va_arg(*ap, size_t);
+
+                pack_int(m, len, 4);
+                p = msg_append(m, len);
+                if (p != NULL && len != 0) {
+                    memcpy(p, bytes, len);
+                }
+                break;
+
+            case 'S':
+                bytes = va_arg(*ap, const char *);
+                len   = strlen(bytes);
+
+                pack_int(m, len, 4);
+                p = msg_append(m, len);
+                if (p != NULL && len != 0) {
+                    memcpy(p, bytes, len);
+                }
+                break;
+
+            default:
+                log_error("%s: Invalid format character: %c\n", __FUNCTION__,
+                          *fmt);
+                m->error = true;
+                return;
+        }
+    }
+}
+
+void net_pack(struct net_msg *m, const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    net_vpack(m, fmt, &ap);
+    va_end(ap);
+}
+
+const uint8_t *net_unpack_bytes(struct net_msg *m, size_t *len)
+{
+    const uint8_t *p = msg_consume(m, 4);
+
+    if (p == NULL) {
+        return NULL;
+    }
+
+    *len = (size_t)get_be(p, 4);
+    return msg_consume(m, *len);
+}
+
+bool net_vunpack(struct net_msg *m, const char *fmt, va_list *ap)
+{
+    const uint8_t *p;
+    size_t len, expected;
+    void *dst;
+
+    for (; *fmt != '\0'; fmt++) {
+        switch (*fmt) {
+            case 'b':
+                p = msg_consume(m, 1);
+                dst = va_arg(*ap, uint8_t *);
+                if (p != NULL) {
+                    *(uint8_t *)dst = p[0];
+                }
+                break;
+
+            case '?':
+                p = msg_consume(m, 1);
+                dst = va_arg(*ap, bool *);
+                if (p != NULL) {
+                    *(bool *)dst = p[0] != 0;
+                }
+                break;
+
+            case 'h':
+                p = msg_consume(m, 2);
+                dst = va_arg(*ap, uint16_t *);
+                if (p != NULL) {
+                    *(uint16_t *)dst = (uint16_t)get_be(p, 2);
+                }
+                break;
+
+            case 's':
+                p = msg_consume(m, 2);
+                dst = va_arg(*ap, int16_t *);
+                if (p != NULL) {
+                    *(int16_t *)dst = (int16_t)(uint16_t)get_be(p, 2);
+                }
+                break;
+
+            case 'w':
+                p = msg_consume(m, 4);
+                dst = va_arg(*ap, uint32_t *);
+                if (p != NULL) {
+                    *(uint32_t *)dst = (uint32_t)get_be(p, 4);
+                }
+                break;
+
+            case 'd':
+                p = msg_consume(m, 4);
+                dst = va_arg(*ap, int32_t *);
+                if (p != NULL) {
+                    *(int32_t *)dst = (int32_t)(uint32_t)get_be(p, 4);
+                }
+                break;
+
+            case 'q':
+                p = msg_consume(m, 8);
+                dst = va_arg(*ap, uint64_t *);
+                if (p != NULL) {
+                    *(uint64_t *)dst = get_be(p, 8);
+                }
+                break;
+
+            case 'B':
+                dst      = va_arg(*ap, void *);
+                expected = va_arg(*ap, size_t);
+
+                p = net_unpack_bytes(m, &len);
+                if (p != NULL && len != expected) {
+                    m->error = true;
+                } else if (p != NULL && len != 0) {
+                    memcpy(dst, p, len);
+                }
+                break;
+
+            case 'S':
+                dst      = va_arg(*ap, char *);
+                expected = va_arg(*ap, size_t);
+
+                p = net_unpack_bytes(m, &len);
+                if (p != NULL && expected != 0) {
+                    len = len < expected - 1 ? len : expected - 1;
+                    memcpy(dst, p, len);
+                    ((char *)dst)[len] = '\0';
+                }
+                break;
+
+            default:
+                log_error("%s: Invalid format character: %c\n", __FUNCTION__,
+                          *fmt);
+                m->error = true;
+                break;
+        }
+
+        if (m->error) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool net_unpack(struct net_msg *m, const char *fmt, ...)
+{
+    va_list ap;
+    bool ok;
+
+    va_start(ap, fmt);
+    ok = net_vunpack(m, fmt, &ap);
+    va_end(ap);
+
+    return ok;
+}
+
+int net_send_frame(int fd, const struct net_hdr *hdr, const void *body)
+{
+    uint8_t raw[NET_HDR_SIZE];
+    struct iovec iov[2];
+    struct msghdr msg;
+    size_t remaining = NET_HDR_SIZE + hdr->length;
+    ssize_t sent;
+
+    put_be(&raw[0], hdr->length, 4);
+    put_be(&raw[4], hdr->op, 2);
+    put_be(&raw[6], hdr->count, 2);
+    put_be(&raw[8], (uint32_t)hdr->status, 4);
+
+    /* The body is sent from where it lies, rather than being copied in
+     * behind the header */
+    iov[0].iov_base = raw;
+    iov[0].iov_len  = NET_HDR_SIZE;
+    iov[1].iov_base = (void *)body;
+    iov[1].iov_len  = hdr->length;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov    = iov;
+    msg.msg_iovlen = hdr->length != 0 ? 2 : 1;
+
+    while (remaining != 0) {
+        sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return BLADERF_ERR_TIMEOUT;
+            }
+
+            log_debug("%s: sendmsg failed: %s\n", __FUNCTION__,
+                      strerror(errno));
+            return BLADERF_ERR_IO;
+        }
+
+        remaining -= (size_t)sent;
+
+        /* Advance past what was sent */
+        while (msg.msg_iovlen != 0 && (size_t)sent >= msg.msg_iov->iov_len) {
+            sent -= (ssize_t)msg.msg_iov->iov_len;
+            msg.msg_iov++;
+            msg.msg_iovlen--;
+        }
+
+        if (msg.msg_iovlen != 0) {
+            msg.msg_iov->iov_base = (uint8_t *)msg.msg_iov->iov_base + sent;
+            msg.msg_iov->iov_len -= (size_t)sent;
+        }
+    }
+
+    return 0;
+}
+
+int net_recv_all(int fd, void *buf, size_t len)
+{
+    uint8_t *p = buf;
+    ssize_t n;
+
+    while (len != 0) {
+        n = recv(fd, p, len, MSG_WAITALL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return BLADERF_ERR_TIMEOUT;
+            }
+
+            log_debug("%s: recv failed: %s\n", __FUNCTION__, strerror(errno));
+            return BLADERF_ERR_IO;
+        } else if (n == 0) {
+            log_debug("%s: Connection closed by peer\n", __FUNCTION__);
+            return BLADERF_ERR_IO;
+        }
+
+        p += n;
+        len -= (size_t)n;
+    }
+
+    return 0;
+}
+
+int net_recv_hdr(int fd, struct net_hdr *hdr)
+{
+    uint8_t raw[NET_HDR_SIZE];
+    int status;
+
+    status = net_recv_all(fd, raw, sizeof(raw));
+    if (status != 0) {
+        return status;
+    }
+
+    hdr->length = (uint32_t)get_be(&raw[0], 4);
+    hdr->op     = (uint16_t)get_be(&raw[4], 2);
+    hdr->count  = (uint16_t)get_be(&raw[6], 2);
+    hdr->status = (int32_t)(uint32_t)get_be(&raw[8], 4);
+
+    if (hdr->length > NET_MAX_BODY) {
+        log_debug("%s: Frame body of %u bytes is too large\n", __FUNCTION__,
+                  hdr->length);
+        return BLADERF_ERR_IO;
+    }
+
+    return 0;
+}
+
+int net_recv_body(int fd, const struct net_hdr *hdr, struct net_msg *m)
+{
+    int status;
+
+    net_msg_reset(m);
+
+    status = net_msg_reserve(m, hdr->length);
+    if (status != 0) {
+        return status;
+    }
+
+    status = net_recv_all(fd, m->data, hdr->length);
+    if (status == 0) {
+        m->len = hdr->length;
+    }
+
+    return status;
+}
+
+void net_config_socket(int fd, bool stream, unsigned int timeout_ms)
+{
+    struct timeval tv;
+    int val;
+
+    /* Control requests are small and latency-bound */
+    val = stream ? 0 : 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &val, sizeof(val));
+
+    if (stream) {
+        val = NET_STREAM_SOCKBUF;
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &val, sizeof(val));
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &val, sizeof(val));
+    }
+
+    tv.tv_sec  = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+size_t net_packed_bytes(net_pack_mode pack, size_t bytes)
+{
+    const size_t n = bytes_to_sc16q11(bytes);
+
+    switch (pack) {
+        case NET_PACK_SC12:
+            return sc12_to_bytes(n);
+
+        case NET_PACK_SC8:
+            return sc8q7_to_bytes(n);
+
+        default:
+            return bytes;
+    }
+}
+
+size_t net_unpacked_bytes(net_pack_mode pack, size_t packed)
+{
+    switch (pack) {
+        case NET_PACK_SC12:
+            return sc16q11_to_bytes(bytes_to_sc12(packed));
+
+        case NET_PACK_SC8:
+            return sc16q11_to_bytes(bytes_to_sc8q7(packed));
+
+        default:
+            return packed;
+    }
+}
+
+void net_pack_samples(net_pack_mode pack, const void *src, void *dst,
+                      size_t bytes)
+{
+    const size_t n = bytes_to_sc16q11(bytes);
+
+    switch (pack) {
+        case NET_PACK_SC12:
+            convert_sc16q11_to_sc12(src, dst, n);
+            break;
+
+        case NET_PACK_SC8:
+            convert_sc16q11_to_sc8q7(src, dst, n);
+            break;
+
+        default:
+            memcpy(dst, src, bytes);
+            break;
+    }
+}
+
+void net_unpack_samples(net_pack_mode pack, const void *src, void *dst,
+                        size_t bytes)
+{
+    const size_t n = bytes_to_sc16q11(bytes);
+
+    switch (pack) {
+        case NET_PACK_SC12:
+            convert_sc12_to_sc16q11(src, dst, n);
+            break;
+
+        case NET_PACK_SC8:
+            convert_sc8q7_to_sc16q11(src, dst, n);
+            break;
+
+        default:
+            memcpy(dst, src, bytes);
+            break;
+    }
+}
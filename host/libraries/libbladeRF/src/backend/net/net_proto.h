@@ -0,0 +1,347 @@
+/**
+ * @file net_proto.h
+ *
+ * @brief Protocol shared by the network backend and bladerf_net_serve()
+ *
+ * The client and server exchange frames over TCP. Each frame is a header,
+ * followed by `length` bytes of body:
+ *
+ *      u32 length      Body length, in bytes
+ *      u16 op          NET_OP_* value
+ *      u16 count       Number of calls in a NET_OP_BATCH body, otherwise 0
+ *      i32 status      0 or a BLADERF_ERR_* value (responses only)
+ *
+ * All values are big-endian. Bodies are packed and unpacked with
+ * net_pack() and net_unpack().
+ *
+ * A connection is either a control connection or a stream connection, as
+ * identified by its first frame (NET_OP_HELLO or NET_OP_STREAM). Control
+ * connections carry one request at a time, each answered by a response with
+ * the same op, and correspond to the backend_fns calls. A NET_OP_BATCH
+ * request carries `count` write calls, each as a u16 op and u32 length
+ * followed by the call's arguments, which the server issues in a single
+ * batch scope of its own backend.
+ *
+ * Stream connections carry sample frames (NET_OP_SAMPLES) in one direction
+ * after the initial request: from the server for RX, and from the client for
+ * TX. The body of each is one stream buffer, optionally packed per
+ * NET_PACK_*. A sample frame with a non-zero status ends the stream.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef BACKEND_NET_PROTO_H_
+#define BACKEND_NET_PROTO_H_
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+#define NET_MAGIC           0x4252464eu /* "BRFN" */
+#define NET_VERSION         1
+
+#define NET_HDR_SIZE        12
+
+/* Largest frame body accepted, which bounds FPGA images and flash accesses */
+#define NET_MAX_BODY        (32 * 1024 * 1024)
+
+/* Timeout for a response to a control request. This accommodates the
+ * slowest operations, such as flash erasure and FPGA loading. */
+#define NET_CONTROL_TIMEOUT_MS  60000
+
+typedef enum {
+    NET_OP_HELLO = 1,
+    NET_OP_BATCH,
+    NET_OP_STREAM,
+    NET_OP_SAMPLES,
+
+    NET_OP_GET_VID_PID,
+    NET_OP_GET_FLASH_ID,
+    NET_OP_SET_FPGA_PROTOCOL,
+    NET_OP_IS_FW_READY,
+    NET_OP_LOAD_FPGA,
+    NET_OP_IS_FPGA_CONFIGURED,
+    NET_OP_GET_FPGA_SOURCE,
+    NET_OP_GET_FW_VERSION,
+    NET_OP_GET_FPGA_VERSION,
+    NET_OP_GET_CONFIG_ID,
+    NET_OP_SET_CONFIG_ID,
+    NET_OP_ERASE_FLASH_BLOCKS,
+    NET_OP_READ_FLASH_PAGES,
+    NET_OP_WRITE_FLASH_PAGES,
+    NET_OP_VERIFY_FLASH_PAGES,
+    NET_OP_DEVICE_RESET,
+    NET_OP_JUMP_TO_BOOTLOADER,
+    NET_OP_GET_CAL,
+    NET_OP_GET_OTP,
+    NET_OP_WRITE_OTP,
+    NET_OP_LOCK_OTP,
+    NET_OP_GET_DEVICE_SPEED,
+    NET_OP_CONFIG_GPIO_WRITE,
+    NET_OP_CONFIG_GPIO_READ,
+    NET_OP_EXPANSION_GPIO_WRITE,
+    NET_OP_EXPANSION_GPIO_READ,
+    NET_OP_EXPANSION_GPIO_DIR_WRITE,
+    NET_OP_EXPANSION_GPIO_DIR_READ,
+    NET_OP_SET_IQ_GAIN_CORRECTION,
+    NET_OP_SET_IQ_PHASE_CORRECTION,
+    NET_OP_GET_IQ_GAIN_CORRECTION,
+    NET_OP_GET_IQ_PHASE_CORRECTION,
+    NET_OP_SET_AGC_DC_CORRECTION,
+    NET_OP_GET_TIMESTAMP,
+    NET_OP_GET_TRIGGER_TIME,
+    NET_OP_SI5338_WRITE,
+    NET_OP_SI5338_READ,
+    NET_OP_LMS_WRITE,
+    NET_OP_LMS_READ,
+    NET_OP_INA219_WRITE,
+    NET_OP_INA219_READ,
+    NET_OP_AD9361_SPI_WRITE,
+    NET_OP_AD9361_SPI_READ,
+    NET_OP_ADI_AXI_WRITE,
+    NET_OP_ADI_AXI_READ,
+    NET_OP_WISHBONE_MASTER_WRITE,
+    NET_OP_WISHBONE_MASTER_READ,
+    NET_OP_RFIC_COMMAND_WRITE,
+    NET_OP_RFIC_COMMAND_READ,
+    NET_OP_RFFE_CONTROL_WRITE,
+    NET_OP_RFFE_CONTROL_READ,
+    NET_OP_RFFE_FASTLOCK_SAVE,
+    NET_OP_RX_DECIM_WRITE,
+    NET_OP_RX_DECIM_READ,
+    NET_OP_AD56X1_VCTCXO_TRIM_DAC_WRITE,
+    NET_OP_AD56X1_VCTCXO_TRIM_DAC_READ,
+    NET_OP_ADF400X_WRITE,
+    NET_OP_ADF400X_READ,
+    NET_OP_VCTCXO_DAC_WRITE,
+    NET_OP_VCTCXO_DAC_READ,
+    NET_OP_SET_VCTCXO_TAMER_MODE,
+    NET_OP_GET_VCTCXO_TAMER_MODE,
+    NET_OP_XB_SPI,
+    NET_OP_SET_FIRMWARE_LOOPBACK,
+    NET_OP_GET_FIRMWARE_LOOPBACK,
+    NET_OP_SET_RF_DMA_BUFFERS,
+    NET_OP_ENABLE_MODULE,
+    NET_OP_RETUNE,
+    NET_OP_RETUNE2,
+    NET_OP_RETUNE2_GAIN,
+    NET_OP_RETUNE_QUEUE,
+    NET_OP_TIMED_WRITE,
+    NET_OP_VCTCXO_TAMER,
+    NET_OP_DC_CAL_CLEAR,
+    NET_OP_DC_CAL_ADD,
+    NET_OP_DC_CAL_START,
+    NET_OP_DC_CAL_STATUS,
+    NET_OP_DC_CAL_READ,
+    NET_OP_LMS_DC_CAL,
+    NET_OP_READ_FW_LOG_ENTRIES,
+    NET_OP_READ_TRIGGER,
+    NET_OP_WRITE_TRIGGER,
+    NET_OP_SET_RF_DMA_CHANNEL,
+} net_op;
+
+/* Packing of SC16 Q11 stream samples in sample frames */
+typedef enum {
+    NET_PACK_NONE,
+    NET_PACK_SC12, /* 12-bit samples. Lossless for the 12-bit ADCs. */
+    NET_PACK_SC8,  /* 8-bit samples, rounded as for SC8 Q7 */
+} net_pack_mode;
+
+/* A frame header */
+struct net_hdr {
+    uint32_t length;
+    uint16_t op;
+    uint16_t count;
+    int32_t status;
+};
+
+/* A frame body being built or parsed */
+struct net_msg {
+    uint8_t *data;
+    size_t len; /* Bytes written */
+    size_t cap; /* Bytes allocated */
+    size_t pos; /* Bytes read */
+    bool error; /* Set on an allocation failure, or a read past the end */
+};
+
+/**
+ * Initialize an empty message
+ *
+ * @param[out]  m       Message
+ */
+void net_msg_init(struct net_msg *m);
+
+/**
+ * Free a message's storage
+ *
+ * @param       m       Message
+ */
+void net_msg_free(struct net_msg *m);
+
+/**
+ * Empty a message, retaining its storage
+ *
+ * @param       m       Message
+ */
+void net_msg_reset(struct net_msg *m);
+
+/**
+ * Reserve space for `len` bytes of body
+ *
+ * @param       m       Message
+ * @param[in]   len     Body length
+ *
+ * @return 0 on success, BLADERF_ERR_MEM on failure
+ */
+int net_msg_reserve(struct net_msg *m, size_t len);
+
+/**
+ * Append values to a message, per a format of one character per value:
+ *
+ *      b   uint8_t         h   uint16_t        s   int16_t
+ *      w   uint32_t        d   int32_t         q   uint64_t
+ *      ?   bool
+ *      B   const void *, size_t: a u32 length, followed by the bytes
+ *      S   const char *: as for B, of the string without its terminator
+ *
+ * Integers narrower than int are passed as int, per the default argument
+ * promotions.
+ *
+ * @param       m       Message
+ * @param[in]   fmt     Format
+ */
+void net_pack(struct net_msg *m, const char *fmt, ...);
+void net_vpack(struct net_msg *m, const char *fmt, va_list *ap);
+
+/**
+ * Read values from a message into the pointers provided, per a format as for
+ * net_pack(), except that `B` takes a `void *` and a `size_t` length, which
+ * must equal the length of the bytes read, and `S` takes a `char *` and a
+ * `size_t` capacity, into which a terminated string is truncated if needed.
+ *
+ * @param       m       Message
+ * @param[in]   fmt     Format
+ *
+ * @return true on success, false if the message is too short
+ */
+bool net_unpack(struct net_msg *m, const char *fmt, ...);
+bool net_vunpack(struct net_msg *m, const char *fmt, va_list *ap);
+
+/**
+ * Read bytes packed with `B`, without copying them
+ *
+ * @param       m       Message
+ * @param[out]  len     Number of bytes
+ *
+ * @return Pointer to the bytes within the message, or NULL if it is too short
+ */
+const uint8_t *net_unpack_bytes(struct net_msg *m, size_t *len);
+
+/**
+ * Send a frame
+ *
+ * @param[in]   fd      Socket
+ * @param[in]   hdr     Header. Its length is that of the body.
+ * @param[in]   body    Body, which may be NULL if the length is 0
+ *
+ * @return 0 on success, BLADERF_ERR_TIMEOUT if the socket's send timeout
+ *         expired, or BLADERF_ERR_IO on failure
+ */
+int net_send_frame(int fd, const struct net_hdr *hdr, const void *body);
+
+/**
+ * Receive a frame header
+ *
+ * @param[in]   fd      Socket
+ * @param[out]  hdr     Header
+ *
+ * @return 0 on success, BLADERF_ERR_TIMEOUT if the socket's receive timeout
+ *         expired, or BLADERF_ERR_IO on failure or disconnection
+ */
+int net_recv_hdr(int fd, struct net_hdr *hdr);
+
+/**
+ * Receive exactly `len` bytes
+ *
+ * @param[in]   fd      Socket
+ * @param[out]  buf     Buffer
+ * @param[in]   len     Number of bytes
+ *
+ * @return 0 on success, BLADERF_ERR_TIMEOUT or BLADERF_ERR_IO on failure
+ */
+int net_recv_all(int fd, void *buf, size_t len);
+
+/**
+ * Receive a frame body into a message, replacing its contents
+ *
+ * @param[in]   fd      Socket
+ * @param[in]   hdr     Header of the frame
+ * @param       m       Message
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int net_recv_body(int fd, const struct net_hdr *hdr, struct net_msg *m);
+
+/**
+ * Set a socket's options for control or stream traffic
+ *
+ * @param[in]   fd          Socket
+ * @param[in]   stream      Configure for stream traffic
+ * @param[in]   timeout_ms  Receive and send timeout, or 0 for none
+ */
+void net_config_socket(int fd, bool stream, unsigned int timeout_ms);
+
+/**
+ * Get the size of a stream buffer in a sample frame
+ *
+ * @param[in]   pack        Packing
+ * @param[in]   bytes       Size of the buffer in SC16 Q11
+ *
+ * @return Size of its frame body
+ */
+size_t net_packed_bytes(net_pack_mode pack, size_t bytes);
+
+/**
+ * Get the size of the stream buffer carried by a sample frame
+ *
+ * @param[in]   pack        Packing
+ * @param[in]   packed      Size of the frame body
+ *
+ * @return Size of the samples in SC16 Q11
+ */
+size_t net_unpacked_bytes(net_pack_mode pack, size_t packed);
+
+/**
+ * Pack or unpack SC16 Q11 samples
+ *
+ * @param[in]   pack        Packing
+ * @param[in]   src         Source
+ * @param[out]  dst         Destination
+ * @param[in]   bytes       Size of the samples in SC16 Q11
+ */
+void net_pack_samples(net_pack_mode pack, const void *src, void *dst,
+                      size_t bytes);
+void net_unpack_samples(net_pack_mode pack, const void *src, void *dst,
+                        size_t bytes);
+
+#endif
@@ -0,0 +1,1326 @@
+/*
+ * Server side of the network backend. See bladerf_net_serve() and
+ * net_proto.h.
+ *
+ * Each connection is served by a thread of its own. Requests on the control
+ * connection are issued to the device's backend with the device lock held,
+ * exactly as the client's board code would have issued them locally. Stream
+ * connections each run an asynchronous stream of the device, whose callbacks
+ * send or receive one sample frame per buffer.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "host_config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include <libbladeRF.h>
+
+#include "log.h"
+#include "thread.h"
+
+#include "backend/backend.h"
+#include "backend/net/net_proto.h"
+
+#include "board/board.h"
+
+#include "streaming/async.h"
+#include "streaming/format.h"
+
+#include "helpers/fpga_image.h"
+#include "helpers/version.h"
+
+#include "bladeRF.h"
+
+/* Interval at which the accept loop checks for a stop request */
+#define NET_SERVE_POLL_MS 100
+
+/* Largest number of log entries read by a single request */
+#define NET_SERVE_MAX_LOG_ENTRIES 1024
+
+/* Read a request's arguments, failing the request if it is malformed */
+#define NET_ARGS(...)                                   \
+    do {                                                \
+        if (!net_unpack(req, __VA_ARGS__)) {            \
+            return BLADERF_ERR_INVAL;                   \
+        }                                               \
+    } while (0)
+
+struct net_server;
+
+struct net_client {
+    struct net_server *srv;
+    int fd;
+    pthread_t thread;
+    int done; /* Set once the thread is finished. Accessed atomically. */
+    struct net_client *next;
+};
+
+struct net_server {
+    struct bladerf *dev;
+
+    /* Protects the members below */
+    MUTEX lock;
+    struct net_client *clients;
+    bool controlled; /* A client holds the control connection */
+};
+
+/* A stream run on behalf of a stream connection */
+struct net_serve_stream {
+    int fd;
+    void **buffers;
+    size_t next_buffer;  /* Next unused buffer, for the initial TX buffers */
+    net_pack_mode pack;
+    uint8_t *packed;     /* Frame bodies, when packing samples */
+    size_t buf_bytes;    /* Size of each stream buffer */
+};
+
+/* Issue a single control request to the backend. Assumes dev->lock is held.
+ *
+ * Returns the backend's return value, whose results have been appended to
+ * `resp` if it is not negative. */
+static int net_serve_call(struct bladerf *dev, net_op op, struct net_msg *req,
+                          struct net_msg *resp)
+{
+    const struct backend_fns *b = dev->backend;
+    int status;
+
+    switch (op) {
+        case NET_OP_GET_VID_PID: {
+            uint16_t vid, pid;
+            status = b->get_vid_pid(dev, &vid, &pid);
+            net_pack(resp, "hh", vid, pid);
+            return status;
+        }
+
+        case NET_OP_GET_FLASH_ID: {
+            uint8_t mid, did;
+            status = b->get_flash_id(dev, &mid, &did);
+            net_pack(resp, "bb", mid, did);
+            return status;
+        }
+
+        case NET_OP_SET_FPGA_PROTOCOL: {
+            int32_t protocol;
+            NET_ARGS("d", &protocol);
+            return b->set_fpga_protocol(dev, (backend_fpga_protocol)protocol);
+        }
+
+        case NET_OP_IS_FW_READY:
+            return b->is_fw_ready(dev);
+
+        case NET_OP_LOAD_FPGA: {
+            struct fpga_image image;
+            const uint8_t *data;
+            size_t len;
+
+            data = net_unpack_bytes(req, &len);
+            if (data == NULL) {
+                return BLADERF_ERR_INVAL;
+            }
+
+            fpga_image_init_buffer(&image, data, len);
+            status = b->load_fpga(dev, &image);
+            fpga_image_close(&image);
+            return status;
+        }
+
+        case NET_OP_IS_FPGA_CONFIGURED:
+            return b->is_fpga_configured(dev);
+
+        case NET_OP_GET_FPGA_SOURCE:
+            net_pack(resp, "d", (int32_t)b->get_fpga_source(dev));
+            return 0;
+
+        case NET_OP_GET_FW_VERSION:
+        case NET_OP_GET_FPGA_VERSION: {
+            char describe[BLADERF_VERSION_STR_MAX + 1] = { 0 };
+            struct bladerf_version version;
+
+            memset(&version, 0, sizeof(version));
+            version.describe = describe;
+
+            if (op == NET_OP_GET_FW_VERSION) {
+                status = b->get_fw_version(dev, &version);
+            } else {
+                status = b->get_fpga_version(dev, &version);
+            }
+
+            net_pack(resp, "hhhS", version.major, version.minor,
+                     version.patch, describe);
+            return status;
+        }
+
+        case NET_OP_GET_CONFIG_ID: {
+            uint64_t id = 0;
+            status = b->get_config_id(dev, &id);
+            net_pack(resp, "q", id);
+            return status;
+        }
+
+        case NET_OP_SET_CONFIG_ID: {
+            uint64_t id;
+            NET_ARGS("q", &id);
+            return b->set_config_id(dev, id);
+        }
+
+        case NET_OP_ERASE_FLASH_BLOCKS: {
+            uint32_t eb;
+            uint16_t count;
+            NET_ARGS("wh", &eb, &count);
+            return b->erase_flash_blocks(dev, eb, count);
+        }
+
+        case NET_OP_READ_FLASH_PAGES: {
+            uint32_t page, count;
+            uint8_t *buf;
+            size_t len;
+
+            NET_ARGS("ww", &page, &count);
+
+            len = (size_t)count * dev->flash_arch->psize_bytes;
+            if (len > NET_MAX_BODY - 4) {
+                return BLADERF_ERR_INVAL;
+            }
+
+            buf = malloc(len);
+            if (buf == NULL) {
+                return BLADERF_ERR_MEM;
+            }
+
+            status = b->read_flash_pages(dev, buf, page, count);
+            if (status == 0) {
+                net_pack(resp, "B", buf, len);
+            }
+
+            free(buf);
+            return status;
+        }
+
+        case NET_OP_WRITE_FLASH_PAGES:
+        case NET_OP_VERIFY_FLASH_PAGES: {
+            uint32_t page, count;
+            const uint8_t *data;
+            size_t len;
+
+            NET_ARGS("ww", &page, &count);
+
+            data = net_unpack_bytes(req, &len);
+            if (data == NULL ||
+                len != (size_t)count * dev->flash_arch->psize_bytes) {
+                return BLADERF_ERR_INVAL;
+            }
+
+            if (op == NET_OP_WRITE_FLASH_PAGES) {
+                return b->write_flash_pages(dev, data, page, count);
+            } else {
+                return b->verify_flash_pages(dev, data, page, count);
+            }
+        }
+
+        case NET_OP_DEVICE_RESET:
+            return b->device_reset(dev);
+
+        case NET_OP_JUMP_TO_BOOTLOADER:
+            return b->jump_to_bootloader(dev);
+
+        case NET_OP_GET_CAL:
+        case NET_OP_GET_OTP: {
+            char buf[CAL_BUFFER_SIZE];
+
+            memset(buf, 0, sizeof(buf));
+
+            if (op == NET_OP_GET_CAL) {
+                status = b->get_cal(dev, buf);
+            } else {
+                status = b->get_otp(dev, buf);
+            }
+
+            net_pack(resp, "B", buf, sizeof(buf));
+            return status;
+        }
+
+        case NET_OP_WRITE_OTP: {
+            char buf[CAL_BUFFER_SIZE];
+            NET_ARGS("B", buf, sizeof(buf));
+            return b->write_otp(dev, buf);
+        }
+
+        case NET_OP_LOCK_OTP:
+            return b->lock_otp(dev);
+
+        case NET_OP_GET_DEVICE_SPEED: {
+            bladerf_dev_speed speed = BLADERF_DEVICE_SPEED_UNKNOWN;
+            status = b->get_device_speed(dev, &speed);
+            net_pack(resp, "d", (int32_t)speed);
+            return status;
+        }
+
+        case NET_OP_CONFIG_GPIO_WRITE: {
+            uint32_t val;
+            NET_ARGS("w", &val);
+            return b->config_gpio_write(dev, val);
+        }
+
+        case NET_OP_CONFIG_GPIO_READ: {
+            uint32_t val = 0;
+            status = b->config_gpio_read(dev, &val);
+            net_pack(resp, "w", val);
+            return status;
+        }
+
+        case NET_OP_EXPANSION_GPIO_WRITE: {
+            uint32_t mask, val;
+            NET_ARGS("ww", &mask, &val);
+            return b->expansion_gpio_write(dev, mask, val);
+        }
+
+        case NET_OP_EXPANSION_GPIO_READ: {
+            uint32_t val = 0;
+            status = b->expansion_gpio_read(dev, &val);
+            net_pack(resp, "w", val);
+            return status;
+        }
+
+        case NET_OP_EXPANSION_GPIO_DIR_WRITE: {
+            uint32_t mask, outputs;
+            NET_ARGS("ww", &mask, &outputs);
+            return b->expansion_gpio_dir_write(dev, mask, outputs);
+        }
+
+        case NET_OP_EXPANSION_GPIO_DIR_READ: {
+            uint32_t outputs = 0;
+            status = b->expansion_gpio_dir_read(dev, &outputs);
+            net_pack(resp, "w", outputs);
+            return status;
+        }
+
+        case NET_OP_SET_IQ_GAIN_CORRECTION:
+        case NET_OP_SET_IQ_PHASE_CORRECTION: {
+            int32_t ch;
+            int16_t value;
+            NET_ARGS("ds", &ch, &value);
+
+            if (op == NET_OP_SET_IQ_GAIN_CORRECTION) {
+                return b->set_iq_gain_correction(dev, ch, value);
+            } else {
+                return b->set_iq_phase_correction(dev, ch, value);
+            }
+        }
+
+        case NET_OP_GET_IQ_GAIN_CORRECTION:
+        case NET_OP_GET_IQ_PHASE_CORRECTION: {
+            int32_t ch;
+            int16_t value = 0;
+            NET_ARGS("d", &ch);
+
+            if (op == NET_OP_GET_IQ_GAIN_CORRECTION) {
+                status = b->get_iq_gain_correction(dev, ch, &value);
+            } else {
+                status = b->get_iq_phase_correction(dev, ch, &value);
+            }
+
+            net_pack(resp, "s", value);
+            return status;
+        }
+
+        case NET_OP_SET_AGC_DC_CORRECTION: {
+            int16_t q_max, i_max, q_mid, i_mid, q_low, i_low;
+            NET_ARGS("ssssss", &q_max, &i_max, &q_mid, &i_mid, &q_low, &i_low);
+            return b->set_agc_dc_correction(dev, q_max, i_max, q_mid, i_mid,
+                                            q_low, i_low);
+        }
+
+        case NET_OP_GET_TIMESTAMP: {
+            int32_t dir;
+            uint64_t value = 0;
+            NET_ARGS("d", &dir);
+            status = b->get_timestamp(dev, (bladerf_direction)dir, &value);
+            net_pack(resp, "q", value);
+            return status;
+        }
+
+        case NET_OP_GET_TRIGGER_TIME: {
+            int32_t dir;
+            bool fired = false;
+            uint64_t value = 0;
+            NET_ARGS("d", &dir);
+            status = b->get_trigger_time(dev, (bladerf_direction)dir, &fired,
+                                         &value);
+            net_pack(resp, "?q", fired, value);
+            return status;
+        }
+
+        case NET_OP_SI5338_WRITE:
+        case NET_OP_LMS_WRITE: {
+            uint8_t addr, data;
+            NET_ARGS("bb", &addr, &data);
+
+            if (op == NET_OP_SI5338_WRITE) {
+                return b->si5338_write(dev, addr, data);
+            } else {
+                return b->lms_write(dev, addr, data);
+            }
+        }
+
+        case NET_OP_SI5338_READ:
+        case NET_OP_LMS_READ: {
+            uint8_t addr, data = 0;
+            NET_ARGS("b", &addr);
+
+            if (op == NET_OP_SI5338_READ) {
+                status = b->si5338_read(dev, addr, &data);
+            } else {
+                status = b->lms_read(dev, addr, &data);
+            }
+
+            net_pack(resp, "b", data);
+            return status;
+        }
+
+        case NET_OP_INA219_WRITE:
+        case NET_OP_VCTCXO_DAC_WRITE: {
+            uint8_t addr;
+            uint16_t data;
+            NET_ARGS("bh", &addr, &data);
+
+            if (op == NET_OP_INA219_WRITE) {
+                return b->ina219_write(dev, addr, data);
+            } else {
+                return b->vctcxo_dac_write(dev, addr, data);
+            }
+        }
+
+        case NET_OP_INA219_READ:
+        case NET_OP_VCTCXO_DAC_READ: {
+            uint8_t addr;
+            uint16_t data = 0;
+            NET_ARGS("b", &addr);
+
+            if (op == NET_OP_INA219_READ) {
+                status = b->ina219_read(dev, addr, &data);
+            } else {
+                status = b->vctcxo_dac_read(dev, addr, &data);
+            }
+
+            net_pack(resp, "h", data);
+            return status;
+        }
+
+        case NET_OP_AD9361_SPI_WRITE:
+        case NET_OP_RFIC_COMMAND_WRITE: {
+            uint16_t cmd;
+            uint64_t data;
+            NET_ARGS("hq", &cmd, &data);
+
+            if (op == NET_OP_AD9361_SPI_WRITE) {
+                return b->ad9361_spi_write(dev, cmd, data);
+            } else {
+                return b->rfic_command_write(dev, cmd, data);
+            }
+        }
+
+        case NET_OP_AD9361_SPI_READ:
+        case NET_OP_RFIC_COMMAND_READ: {
+            uint16_t cmd;
+            uint64_t data = 0;
+            NET_ARGS("h", &cmd);
+
+            if (op == NET_OP_AD9361_SPI_READ) {
+                status = b->ad9361_spi_read(dev, cmd, &data);
+            } else {
+                status = b->rfic_command_read(dev, cmd, &data);
+            }
+
+            net_pack(resp, "q", data);
+            return status;
+        }
+
+        case NET_OP_ADI_AXI_WRITE:
+        case NET_OP_WISHBONE_MASTER_WRITE: {
+            uint32_t addr, data;
+            NET_ARGS("ww", &addr, &data);
+
+            if (op == NET_OP_ADI_AXI_WRITE) {
+                return b->adi_axi_write(dev, addr, data);
+            } else {
+                return b->wishbone_master_write(dev, addr, data);
+            }
+        }
+
+        case NET_OP_ADI_AXI_READ:
+        case NET_OP_WISHBONE_MASTER_READ: {
+            uint32_t addr, data = 0;
+            NET_ARGS("w", &addr);
+
+            if (op == NET_OP_ADI_AXI_READ) {
+                status = b->adi_axi_read(dev, addr, &data);
+            } else {
+                status = b->wishbone_master_read(dev, addr, &data);
+            }
+
+            net_pack(resp, "w", data);
+            return status;
+        }
+
+        case NET_OP_RFFE_CONTROL_WRITE:
+        case NET_OP_RX_DECIM_WRITE:
+        case NET_OP_XB_SPI: {
+            uint32_t value;
+            NET_ARGS("w", &value);
+
+            if (op == NET_OP_RFFE_CONTROL_WRITE) {
+                return b->rffe_control_write(dev, value);
+            } else if (op == NET_OP_RX_DECIM_WRITE) {
+                return b->rx_decim_write(dev, value);
+            } else {
+                return b->xb_spi(dev, value);
+            }
+        }
+
+        case NET_OP_RFFE_CONTROL_READ:
+        case NET_OP_RX_DECIM_READ: {
+            uint32_t value = 0;
+
+            if (op == NET_OP_RFFE_CONTROL_READ) {
+                status = b->rffe_control_read(dev, &value);
+            } else {
+                status = b->rx_decim_read(dev, &value);
+            }
+
+            net_pack(resp, "w", value);
+            return status;
+        }
+
+        case NET_OP_RFFE_FASTLOCK_SAVE: {
+            bool is_tx;
+            uint8_t rffe_profile;
+            uint16_t nios_profile;
+            NET_ARGS("?bh", &is_tx, &rffe_profile, &nios_profile);
+            return b->rffe_fastlock_save(dev, is_tx, rffe_profile,
+                                         nios_profile);
+        }
+
+        case NET_OP_AD56X1_VCTCXO_TRIM_DAC_WRITE: {
+            uint16_t value;
+            NET_ARGS("h", &value);
+            return b->ad56x1_vctcxo_trim_dac_write(dev, value);
+        }
+
+        case NET_OP_AD56X1_VCTCXO_TRIM_DAC_READ: {
+            uint16_t value = 0;
+            status = b->ad56x1_vctcxo_trim_dac_read(dev, &value);
+            net_pack(resp, "h", value);
+            return status;
+        }
+
+        case NET_OP_ADF400X_WRITE: {
+            uint8_t addr;
+            uint32_t data;
+            NET_ARGS("bw", &addr, &data);
+            return b->adf400x_write(dev, addr, data);
+        }
+
+        case NET_OP_ADF400X_READ: {
+            uint8_t addr;
+            uint32_t data = 0;
+            NET_ARGS("b", &addr);
+            status = b->adf400x_read(dev, addr, &data);
+            net_pack(resp, "w", data);
+            return status;
+        }
+
+        case NET_OP_SET_VCTCXO_TAMER_MODE: {
+            int32_t mode;
+            NET_ARGS("d", &mode);
+            return b->set_vctcxo_tamer_mode(dev,
+                                            (bladerf_vctcxo_tamer_mode)mode);
+        }
+
+        case NET_OP_GET_VCTCXO_TAMER_MODE: {
+            bladerf_vctcxo_tamer_mode mode = BLADERF_VCTCXO_TAMER_INVALID;
+            status = b->get_vctcxo_tamer_mode(dev, &mode);
+            net_pack(resp, "d", (int32_t)mode);
+            return status;
+        }
+
+        case NET_OP_SET_FIRMWARE_LOOPBACK: {
+            bool enable;
+            NET_ARGS("?", &enable);
+            return b->set_firmware_loopback(dev, enable);
+        }
+
+        case NET_OP_GET_FIRMWARE_LOOPBACK: {
+            bool enabled = false;
+            status = b->get_firmware_loopback(dev, &enabled);
+            net_pack(resp, "?", enabled);
+            return status;
+        }
+
+        case NET_OP_SET_RF_DMA_BUFFERS: {
+            uint32_t count;
+            NET_ARGS("w", &count);
+            return b->set_rf_dma_buffers(dev, count);
+        }
+
+        case NET_OP_SET_RF_DMA_CHANNEL: {
+            int32_t dir;
+            uint32_t count;
+            NET_ARGS("dw", &dir, &count);
+            return b->set_rf_dma_channel(dev, (bladerf_direction)dir, count);
+        }
+
+        case NET_OP_ENABLE_MODULE: {
+            int32_t dir;
+            bool enable;
+            NET_ARGS("d?", &dir, &enable);
+            return b->enable_module(dev, (bladerf_direction)dir, enable);
+        }
+
+        case NET_OP_RETUNE: {
+            int32_t ch;
+            uint64_t timestamp;
+            uint16_t nint;
+            uint32_t nfrac;
+            uint8_t freqsel, vcocap, xb_gpio;
+            bool low_band, quick_tune;
+
+            NET_ARGS("dqhwbb?b?", &ch, &timestamp, &nint, &nfrac, &freqsel,
+                     &vcocap, &low_band, &xb_gpio, &quick_tune);
+
+            return b->retune(dev, ch, timestamp, nint, nfrac, freqsel, vcocap,
+                             low_band, xb_gpio, quick_tune);
+        }
+
+        case NET_OP_RETUNE2: {
+            int32_t ch;
+            uint64_t timestamp;
+            uint16_t nios_profile;
+            uint8_t rffe_profile, port, spdt;
+
+            NET_ARGS("dqhbbb", &ch, &timestamp, &nios_profile, &rffe_profile,
+                     &port, &spdt);
+
+            return b->retune2(dev, ch, timestamp, nios_profile, rffe_profile,
+                              port, spdt);
+        }
+
+        case NET_OP_RETUNE2_GAIN: {
+            int32_t ch;
+            uint64_t timestamp;
+            uint16_t setting;
+            NET_ARGS("dqh", &ch, &timestamp, &setting);
+            return b->retune2_gain(dev, ch, timestamp, setting);
+        }
+
+        case NET_OP_RETUNE_QUEUE: {
+            struct bladerf_retune_queue_status queue;
+            unsigned int canceled = 0;
+            int32_t ch;
+            uint8_t cmd;
+            uint64_t start, end;
+
+            NET_ARGS("dbqq", &ch, &cmd, &start, &end);
+
+            memset(&queue, 0, sizeof(queue));
+            status = b->retune_queue(dev, ch, cmd, start, end, &queue,
+                                     &canceled);
+
+            net_pack(resp, "wwqw", (uint32_t)queue.pending,
+                     (uint32_t)queue.capacity, queue.next_timestamp,
+                     (uint32_t)canceled);
+            return status;
+        }
+
+        case NET_OP_TIMED_WRITE: {
+            int32_t ch;
+            uint64_t timestamp;
+            uint8_t type, id, addr;
+            uint32_t data;
+
+            NET_ARGS("dqbbbw", &ch, &timestamp, &type, &id, &addr, &data);
+            return b->timed_write(dev, ch, timestamp, type, id, addr, data);
+        }
+
+        case NET_OP_VCTCXO_TAMER: {
+            struct bladerf_vctcxo_tamer_status tamer;
+            uint8_t cmd;
+            bool seed_valid;
+            uint16_t seed;
+
+            NET_ARGS("b?h", &cmd, &seed_valid, &seed);
+
+            memset(&tamer, 0, sizeof(tamer));
+            status = b->vctcxo_tamer(dev, cmd, seed_valid, seed, &tamer);
+
+            net_pack(resp, "d?whdd", (int32_t)tamer.state, tamer.locked,
+                     (uint32_t)tamer.measurements, tamer.trim_dac,
+                     tamer.error_1s, tamer.error_10s);
+            return status;
+        }
+
+        case NET_OP_DC_CAL_CLEAR:
+            return b->dc_cal_clear(dev);
+
+        case NET_OP_DC_CAL_ADD: {
+            uint16_t nint;
+            uint32_t nfrac;
+            uint8_t freqsel, vcocap;
+            bool low_band, quick_tune;
+
+            NET_ARGS("hwbb??", &nint, &nfrac, &freqsel, &vcocap, &low_band,
+                     &quick_tune);
+
+            return b->dc_cal_add(dev, nint, nfrac, freqsel, vcocap, low_band,
+                                 quick_tune);
+        }
+
+        case NET_OP_DC_CAL_START: {
+            uint32_t num_samples;
+            uint16_t settle_us;
+            NET_ARGS("wh", &num_samples, &settle_us);
+            return b->dc_cal_start(dev, num_samples, settle_us);
+        }
+
+        case NET_OP_DC_CAL_STATUS: {
+            bool busy = false;
+            uint8_t done = 0;
+            status = b->dc_cal_status(dev, &busy, &done);
+            net_pack(resp, "?b", busy, done);
+            return status;
+        }
+
+        case NET_OP_DC_CAL_READ: {
+            uint8_t index;
+            int16_t dc_i = 0, dc_q = 0;
+            NET_ARGS("b", &index);
+            status = b->dc_cal_read(dev, index, &dc_i, &dc_q);
+            net_pack(resp, "ss", dc_i, dc_q);
+            return status;
+        }
+
+        case NET_OP_LMS_DC_CAL: {
+            int32_t module;
+            NET_ARGS("d", &module);
+
+            /* The client cannot reach this device's register shadow */
+            if (b->invalidate_reg_shadow != NULL) {
+                b->invalidate_reg_shadow(dev);
+            }
+
+            status = b->lms_dc_cal(dev, (bladerf_cal_module)module);
+
+            if (b->invalidate_reg_shadow != NULL) {
+                b->invalidate_reg_shadow(dev);
+            }
+
+            return status;
+        }
+
+        case NET_OP_READ_FW_LOG_ENTRIES: {
+            logger_entry *e;
+            uint8_t *raw;
+            uint32_t count, i;
+
+            NET_ARGS("w", &count);
+
+            if (count > NET_SERVE_MAX_LOG_ENTRIES) {
+                return BLADERF_ERR_INVAL;
+            }
+
+            e   = calloc(count + 1, sizeof(e[0]));
+            raw = malloc((size_t)count * 4 + 1);
+            if (e == NULL || raw == NULL) {
+                free(raw);
+                free(e);
+                return BLADERF_ERR_MEM;
+            }
+
+            status = b->read_fw_log_entries(dev, e, count);
+
+            /* Entries are carried as big-endian words */
+            for (i = 0; i < count; i++) {
+                raw[4 * i]     = (uint8_t)(e[i] >> 24);
+                raw[4 * i + 1] = (uint8_t)(e[i] >> 16);
+                raw[4 * i + 2] = (uint8_t)(e[i] >> 8);
+                raw[4 * i + 3] = (uint8_t)e[i];
+            }
+
+            net_pack(resp, "B", raw, (size_t)count * 4);
+
+            free(raw);
+            free(e);
+            return status;
+        }
+
+        case NET_OP_READ_TRIGGER: {
+            int32_t ch, trigger;
+            uint8_t value = 0;
+            NET_ARGS("dd", &ch, &trigger);
+            status = b->read_trigger(dev, ch, (bladerf_trigger_signal)trigger,
+                                     &value);
+            net_pack(resp, "b", value);
+            return status;
+        }
+
+        case NET_OP_WRITE_TRIGGER: {
+            int32_t ch, trigger;
+            uint8_t value;
+            NET_ARGS("ddb", &ch, &trigger, &value);
+            return b->write_trigger(dev, ch, (bladerf_trigger_signal)trigger,
+                                    value);
+        }
+
+        default:
+            log_debug("Received a request for unknown op %u\n", op);
+            return BLADERF_ERR_UNSUPPORTED;
+    }
+}
+
+/* Issue the calls of a NET_OP_BATCH request in a batch scope of the backend.
+ * Assumes dev->lock is held. Returns the first failure. */
+static int net_serve_batch(struct bladerf *dev, struct net_msg *req,
+                           unsigned int count, struct net_msg *resp)
+{
+    struct net_msg call;
+    const uint8_t *args;
+    unsigned int i;
+    uint16_t op;
+    size_t len;
+    int status, commit_status;
+
+    status = dev->backend->batch_begin(dev);
+    if (status != 0) {
+        return status;
+    }
+
+    for (i = 0; i < count; i++) {
+        int call_status;
+
+        if (!net_unpack(req, "h", &op) ||
+            (args = net_unpack_bytes(req, &len)) == NULL) {
+            status = status == 0 ? BLADERF_ERR_INVAL : status;
+            break;
+        }
+
+        /* Parse the arguments in place, as a message of their own */
+        net_msg_init(&call);
+        call.data = (uint8_t *)args;
+        call.len  = len;
+        call.cap  = len;
+
+        call_status = net_serve_call(dev, (net_op)op, &call, resp);
+        if (call_status < 0 && status == 0) {
+            status = call_status;
+        }
+    }
+
+    /* Batched calls have no results */
+    net_msg_reset(resp);
+
+    commit_status = dev->backend->batch_commit(dev);
+    return status == 0 ? commit_status : status;
+}
+
+static int net_serve_respond(int fd, uint16_t op, int status,
+                             const struct net_msg *resp)
+{
+    struct net_hdr hdr;
+
+    if (resp->error) {
+        status = BLADERF_ERR_MEM;
+    }
+
+    hdr.length = status >= 0 && !resp->error ? (uint32_t)resp->len : 0;
+    hdr.op     = op;
+    hdr.count  = 0;
+    hdr.status = status;
+
+    return net_send_frame(fd, &hdr, resp->data);
+}
+
+static void net_serve_control(struct net_client *c, const struct net_hdr *hello)
+{
+    struct net_server *srv = c->srv;
+    struct bladerf *dev    = srv->dev;
+    struct net_msg req, resp;
+    struct net_hdr hdr;
+    uint32_t magic, version;
+    bool busy;
+    int status;
+
+    net_msg_init(&req);
+    net_msg_init(&resp);
+
+    MUTEX_LOCK(&srv->lock);
+    busy = srv->controlled;
+    srv->controlled = true;
+    MUTEX_UNLOCK(&srv->lock);
+
+    status = net_recv_body(c->fd, hello, &req);
+
+    if (status == 0) {
+        if (busy) {
+            log_info("Refusing a client, as the device is in use.\n");
+            status = BLADERF_ERR_NODEV;
+        } else if (!net_unpack(&req, "ww", &magic, &version) ||
+                   magic != NET_MAGIC || version != NET_VERSION) {
+            log_info("Refusing a client of an incompatible version.\n");
+            status = BLADERF_ERR_UNSUPPORTED;
+        }
+
+        net_pack(&resp, "SSSbbw", dev->ident.serial, dev->ident.manufacturer,
+                 dev->ident.product, dev->ident.usb_bus, dev->ident.usb_addr,
+                 (uint32_t)dev->ident.instance);
+
+        if (net_serve_respond(c->fd, NET_OP_HELLO, status, &resp) != 0) {
+            status = BLADERF_ERR_IO;
+        }
+    }
+
+    if (busy) {
+        goto out;
+    }
+
+    if (status == 0) {
+        log_info("Client connected.\n");
+        net_config_socket(c->fd, false, 0);
+    }
+
+    while (status == 0) {
+        status = net_recv_hdr(c->fd, &hdr);
+        if (status == 0) {
+            status = net_recv_body(c->fd, &hdr, &req);
+        }
+
+        if (status != 0) {
+            break;
+        }
+
+        net_msg_reset(&resp);
+
+        MUTEX_LOCK(&dev->lock);
+        if (hdr.op == NET_OP_BATCH) {
+            status = net_serve_batch(dev, &req, hdr.count, &resp);
+        } else {
+            status = net_serve_call(dev, (net_op)hdr.op, &req, &resp);
+        }
+        MUTEX_UNLOCK(&dev->lock);
+
+        status = net_serve_respond(c->fd, hdr.op, status, &resp);
+    }
+
+    log_info("Client disconnected.\n");
+
+    /* Don't leave the device streaming on behalf of a departed client */
+    MUTEX_LOCK(&dev->lock);
+    dev->backend->enable_module(dev, BLADERF_RX, false);
+    dev->backend->enable_module(dev, BLADERF_TX, false);
+    MUTEX_UNLOCK(&dev->lock);
+
+    MUTEX_LOCK(&srv->lock);
+    srv->controlled = false;
+    MUTEX_UNLOCK(&srv->lock);
+
+out:
+    net_msg_free(&resp);
+    net_msg_free(&req);
+}
+
+/* Send each received buffer as a sample frame */
+static void *net_serve_rx_cb(struct bladerf *dev,
+                             struct bladerf_stream *stream,
+                             struct bladerf_metadata *meta,
+                             void *samples,
+                             size_t num_samples,
+                             void *user_data)
+{
+    struct net_serve_stream *s = user_data;
+    const size_t bytes         = samples_to_bytes(stream->format, num_samples);
+    const void *body           = samples;
+    struct net_hdr hdr;
+
+    hdr.length = (uint32_t)net_packed_bytes(s->pack, bytes);
+    hdr.op     = NET_OP_SAMPLES;
+    hdr.count  = 0;
+    hdr.status = 0;
+
+    if (s->pack != NET_PACK_NONE) {
+        net_pack_samples(s->pack, samples, s->packed, bytes);
+        body = s->packed;
+    }
+
+    if (net_send_frame(s->fd, &hdr, body) != 0) {
+        return BLADERF_STREAM_SHUTDOWN;
+    }
+
+    /* The samples have been copied to the socket, so the buffer may be
+     * reused at once */
+    return samples;
+}
+
+/* Fill the next buffer to transmit from a sample frame */
+static void *net_serve_tx_cb(struct bladerf *dev,
+                             struct bladerf_stream *stream,
+                             struct bladerf_metadata *meta,
+                             void *samples,
+                             size_t num_samples,
+                             void *user_data)
+{
+    struct net_serve_stream *s = user_data;
+    struct net_hdr hdr;
+    size_t bytes;
+    void *buffer;
+    int status;
+
+    if (samples != NULL) {
+        buffer = samples;
+    } else if (s->next_buffer < stream->num_buffers) {
+        buffer = s->buffers[s->next_buffer++];
+    } else {
+        return BLADERF_STREAM_NO_DATA;
+    }
+
+    status = net_recv_hdr(s->fd, &hdr);
+    if (status != 0 || hdr.op != NET_OP_SAMPLES || hdr.status != 0) {
+        return BLADERF_STREAM_SHUTDOWN;
+    }
+
+    bytes = net_unpacked_bytes(s->pack, hdr.length);
+    if (bytes > s->buf_bytes) {
+        log_debug("Received a sample frame of %u bytes, which exceeds the "
+                  "stream's buffers\n", hdr.length);
+        return BLADERF_STREAM_SHUTDOWN;
+    }
+
+    if (s->pack == NET_PACK_NONE) {
+        status = net_recv_all(s->fd, buffer, hdr.length);
+    } else {
+        status = net_recv_all(s->fd, s->packed, hdr.length);
+        if (status == 0) {
+            net_unpack_samples(s->pack, s->packed, buffer, bytes);
+        }
+    }
+
+    if (status != 0) {
+        return BLADERF_STREAM_SHUTDOWN;
+    }
+
+    meta->actual_count = (unsigned int)bytes;
+    return buffer;
+}
+
+static void net_serve_stream(struct net_client *c, const struct net_hdr *first)
+{
+    struct bladerf *dev = c->srv->dev;
+    struct bladerf_stream *stream = NULL;
+    struct net_serve_stream s;
+    struct net_msg req, resp;
+    uint32_t layout, format, samples_per_buffer, num_buffers, num_transfers;
+    uint32_t timeout_ms;
+    uint8_t pack;
+    bool tx_variable_length;
+    int status;
+
+    memset(&s, 0, sizeof(s));
+    s.fd = c->fd;
+
+    net_msg_init(&req);
+    net_msg_init(&resp);
+
+    status = net_recv_body(c->fd, first, &req);
+    if (status != 0) {
+        goto out;
+    }
+
+    if (!net_unpack(&req, "wwwwwwb?", &layout, &format, &samples_per_buffer,
+                    &num_buffers, &num_transfers, &timeout_ms, &pack,
+                    &tx_variable_length) ||
+        pack > NET_PACK_SC8 ||
+        (pack != NET_PACK_NONE && format != BLADERF_FORMAT_SC16_Q11) ||
+        format == BLADERF_FORMAT_PACKET_META) {
+        status = BLADERF_ERR_INVAL;
+    }
+
+    if (status == 0) {
+        s.pack = (net_pack_mode)pack;
+
+        MUTEX_LOCK(&dev->lock);
+        status = async_init_stream(
+            &stream, dev,
+            (layout & BLADERF_DIRECTION_MASK) == BLADERF_TX ? net_serve_tx_cb
+                                                            : net_serve_rx_cb,
+            &s.buffers, num_buffers, (bladerf_format)format,
+            samples_per_buffer, num_transfers, &s, NULL);
+        MUTEX_UNLOCK(&dev->lock);
+    }
+
+    if (status == 0) {
+        status = async_set_transfer_timeout(stream, timeout_ms);
+        stream->tx_variable_length = tx_variable_length;
+        s.buf_bytes = async_stream_buf_bytes(stream);
+    }
+
+    if (status == 0 && s.pack != NET_PACK_NONE) {
+        s.packed = malloc(net_packed_bytes(s.pack, s.buf_bytes));
+        if (s.packed == NULL) {
+            status = BLADERF_ERR_MEM;
+        }
+    }
+
+    if (net_serve_respond(c->fd, NET_OP_STREAM, status, &resp) != 0 ||
+        status != 0) {
+        goto out;
+    }
+
+    net_config_socket(c->fd, true, 0);
+
+    log_verbose("Starting a %s stream for a client.\n",
+                (layout & BLADERF_DIRECTION_MASK) == BLADERF_TX ? "TX" : "RX");
+
+    status = async_run_stream(stream, (bladerf_channel_layout)layout);
+    if (status != 0) {
+        /* Let the client know why its stream ended */
+        struct net_hdr hdr;
+
+        log_debug("Client stream ended with: %s\n", bladerf_strerror(status));
+
+        hdr.length = 0;
+        hdr.op     = NET_OP_SAMPLES;
+        hdr.count  = 0;
+        hdr.status = status;
+        net_send_frame(c->fd, &hdr, NULL);
+    }
+
+out:
+    if (stream != NULL) {
+        async_deinit_stream(stream);
+    }
+
+    free(s.packed);
+    net_msg_free(&resp);
+    net_msg_free(&req);
+}
+
+static void *net_client_run(void *arg)
+{
+    struct net_client *c = arg;
+    struct net_hdr hdr;
+
+    /* The connection is dropped if it does not introduce itself */
+    net_config_socket(c->fd, false, NET_CONTROL_TIMEOUT_MS);
+
+    if (net_recv_hdr(c->fd, &hdr) == 0) {
+        if (hdr.op == NET_OP_HELLO) {
+            net_serve_control(c, &hdr);
+        } else if (hdr.op == NET_OP_STREAM) {
+            net_serve_stream(c, &hdr);
+        } else {
+            log_debug("Dropping a connection that began with op %u\n",
+                      hdr.op);
+        }
+    }
+
+    shutdown(c->fd, SHUT_RDWR);
+    ATOMIC_STORE(&c->done, 1);
+    return NULL;
+}
+
+/* Join and free finished client threads, or all of them if `all` is set */
+static void net_reap_clients(struct net_server *srv, bool all)
+{
+    struct net_client **p = &srv->clients;
+    struct net_client *c;
+
+    MUTEX_LOCK(&srv->lock);
+
+    while (*p != NULL) {
+        c = *p;
+
+        if (all || ATOMIC_LOAD(&c->done)) {
+            *p = c->next;
+
+            MUTEX_UNLOCK(&srv->lock);
+
+            if (all) {
+                /* Unblock the thread from its socket */
+                shutdown(c->fd, SHUT_RDWR);
+            }
+
+            pthread_join(c->thread, NULL);
+            close(c->fd);
+            free(c);
+
+            MUTEX_LOCK(&srv->lock);
+        } else {
+            p = &c->next;
+        }
+    }
+
+    MUTEX_UNLOCK(&srv->lock);
+}
+
+static int net_listen(const char *address, uint16_t port, int *fd_out)
+{
+    struct addrinfo hints, *res, *ai;
+    char port_str[8];
+    int fd = -1;
+    int status;
+    int one = 1;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags    = AI_PASSIVE;
+
+    snprintf(port_str, sizeof(port_str), "%u", port);
+
+    status = getaddrinfo(address, port_str, &hints, &res);
+    if (status != 0) {
+        log_error("Failed to resolve %s: %s\n",
+                  address != NULL ? address : "*", gai_strerror(status));
+        return BLADERF_ERR_INVAL;
+    }
+
+    for (ai = res; ai != NULL; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        if (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 && listen(fd, 8) == 0) {
+            break;
+        }
+
+        close(fd);
+        fd = -1;
+    }
+
+    freeaddrinfo(res);
+
+    if (fd < 0) {
+        log_error("Failed to listen on port %u: %s\n", port, strerror(errno));
+        return BLADERF_ERR_IO;
+    }
+
+    *fd_out = fd;
+    return 0;
+}
+
+int bladerf_net_serve(struct bladerf *dev, const char *address, uint16_t port)
+{
+    struct net_server srv;
+    struct net_client *c;
+    struct pollfd pfd;
+    int listen_fd, fd;
+    int status;
+
+    if (dev == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (port == 0) {
+        port = BLADERF_NET_DEFAULT_PORT;
+    }
+
+    status = net_listen(address, port, &listen_fd);
+    if (status != 0) {
+        return status;
+    }
+
+    memset(&srv, 0, sizeof(srv));
+    srv.dev = dev;
+    MUTEX_INIT(&srv.lock);
+
+    log_info("Serving device %s on port %u\n", dev->ident.serial, port);
+
+    while (!ATOMIC_LOAD(&dev->net_serve_stop)) {
+        net_reap_clients(&srv, false);
+
+        pfd.fd      = listen_fd;
+        pfd.events  = POLLIN;
+        pfd.revents = 0;
+
+        status = poll(&pfd, 1, NET_SERVE_POLL_MS);
+        if (status < 0 && errno != EINTR) {
+            log_error("poll failed: %s\n", strerror(errno));
+            status = BLADERF_ERR_IO;
+            break;
+        } else if (status <= 0) {
+            status = 0;
+            continue;
+        }
+
+        status = 0;
+
+        fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) {
+            log_debug("accept failed: %s\n", strerror(errno));
+            continue;
+        }
+
+        c = calloc(1, sizeof(*c));
+        if (c == NULL) {
+            close(fd);
+            continue;
+        }
+
+        c->srv = &srv;
+        c->fd  = fd;
+
+        if (pthread_create(&c->thread, NULL, net_client_run, c) != 0) {
+            log_debug("Failed to start a client thread.\n");
+            close(fd);
+            free(c);
+            continue;
+        }
+
+        MUTEX_LOCK(&srv.lock);
+        c->next     = srv.clients;
+        srv.clients = c;
+        MUTEX_UNLOCK(&srv.lock);
+    }
+
+    close(listen_fd);
+    net_reap_clients(&srv, true);
+    MUTEX_DESTROY(&srv.lock);
+
+    ATOMIC_STORE(&dev->net_serve_stop, 0);
+
+    log_info("Stopped serving device %s\n", dev->ident.serial);
+    return status;
+}
+
+void bladerf_net_serve_stop(struct bladerf *dev)
+{
+    if (dev != NULL) {
+        ATOMIC_STORE(&dev->net_serve_stop, 1);
+    }
+}
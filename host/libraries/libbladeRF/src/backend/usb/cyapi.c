@@ -35,6 +35,8 @@ extern "C" {
 #include "backend/usb/usb.h"
 #include "streaming/async.h"
 #include "helpers/timeout.h"
+#include "helpers/trace.h"
+#include "helpers/wallclock.h"
 #include "log.h"
 }
 
@@ -147,7 +149,9 @@ static bool device_matches_target(CCyUSBDevice *dev,
     bool matches = false;
 
     switch (target) {
+        /* Devices must be opened to be enumerated by CyAPI */
         case BACKEND_PROBE_BLADERF:
+        case BACKEND_PROBE_BLADERF_QUICK:
             matches = has_bladerf_ids(dev);
             break;
 
@@ -570,6 +574,8 @@ static int submit_transfer(struct bladerf_stream *stream, void *buffer, size_t l
     assert(data->transfers[data->avail_i].buffer == NULL);
     assert(data->num_avail != 0);
 
+    TRACE_POINT3(xfer_submit, (uintptr_t)stream, (uintptr_t)buffer, len);
+
     xfer = data->ep->BeginDataXfer((PUCHAR) buffer, buffer_size,
                                    &data->transfers[data->avail_i].event);
 
@@ -653,9 +659,9 @@ static int cyapi_stream(void *driver, struct bladerf_stream *stream,
             next_buffer = stream->buffers[i];
         }
 
-        if ((stream->layout & BLADERF_DIRECTION_MASK) == BLADERF_TX
-                && stream->format == BLADERF_FORMAT_PACKET_META) {
-            status = submit_transfer(stream, next_buffer, meta.actual_count);
+        if ((stream->layout & BLADERF_DIRECTION_MASK) == BLADERF_TX) {
+            status = submit_transfer(stream, next_buffer,
+                                     async_stream_tx_bytes(stream, &meta));
         } else {
             status = submit_transfer(stream, next_buffer, async_stream_buf_bytes(stream));
         }
@@ -666,6 +672,9 @@ static int cyapi_stream(void *driver, struct bladerf_stream *stream,
         goto out;
     }
 
+    /* Obtain the initial buffers of a batched TX stream */
+    async_dispatch_batch(stream);
+
     while (!done) {
         struct transfer *xfer;
         size_t i;
@@ -686,16 +695,22 @@ static int cyapi_stream(void *driver, struct bladerf_stream *stream,
         log_verbose("Got transfer complete in slot %u (buffer %p)\n",
                     i, data->transfers[i].buffer);
 
-        MUTEX_LOCK(&stream->lock);
-        success = data->ep->FinishDataXfer(data->transfers[i].buffer, (LONG &)len,
-                                           &data->transfers[i].event,
-                                           xfer->handle);
+        /* The slot remains ours until it's returned to the pool below, so
+         * the transfer is finished without holding the stream lock. This
+         * keeps submissions from the API caller's thread from stalling
+         * behind the driver request. */
+        success = data->ep->FinishDataXfer(xfer->buffer, (LONG &)len,
+                                           &xfer->event, xfer->handle);
+
+        TRACE_POINT4(xfer_complete, (uintptr_t)stream,
+                     (uintptr_t)xfer->buffer, success ? 0 : 1, len);
 
         if (success) {
-            next_buffer = stream->cb(stream->dev, stream, &meta,
-                                     data->transfers[i].buffer,
-                                     bytes_to_samples(stream->format, (LONG &)len),
-                                     stream->user_data);
+            /* Likewise, the user callback runs without the stream lock */
+            meta.host_timestamp = wallclock_get_monotonic_nsec();
+            next_buffer = async_stream_cb(stream, &meta,
+                                          data->transfers[i].buffer,
+                                          bytes_to_samples(stream->format, (LONG &)len));
 
         } else {
             done = true;
@@ -704,6 +719,8 @@ static int cyapi_stream(void *driver, struct bladerf_stream *stream,
                       (unsigned int)i, &data->transfers[i].buffer);
         }
 
+        MUTEX_LOCK(&stream->lock);
+
         data->transfers[i].buffer = NULL;
         data->transfers[i].handle = NULL;
         data->num_avail++;
@@ -712,9 +729,9 @@ static int cyapi_stream(void *driver, struct bladerf_stream *stream,
         if (next_buffer == BLADERF_STREAM_SHUTDOWN) {
             done = true;
         } else if (next_buffer != BLADERF_STREAM_NO_DATA) {
-            if ((layout & BLADERF_DIRECTION_MASK) == BLADERF_TX
-                    && stream->format == BLADERF_FORMAT_PACKET_META) {
-                status = submit_transfer(stream, next_buffer, meta.actual_count);
+            if ((layout & BLADERF_DIRECTION_MASK) == BLADERF_TX) {
+                status = submit_transfer(stream, next_buffer,
+                                         async_stream_tx_bytes(stream, &meta));
             } else {
                 status = submit_transfer(stream, next_buffer, async_stream_buf_bytes(stream));
             }
@@ -724,6 +741,11 @@ static int cyapi_stream(void *driver, struct bladerf_stream *stream,
 
         data->inflight_i = next_idx(data, data->inflight_i);
         MUTEX_UNLOCK(&stream->lock);
+
+        if (!done && stream->batch_cb != NULL) {
+            async_dispatch_batch(stream);
+            done = (stream->state != STREAM_RUNNING);
+        }
     }
 
 out:
@@ -829,6 +851,8 @@ int cyapi_open_bootloader(void **driver, uint8_t bus, uint8_t addr)
 extern "C" {
     static const struct usb_fns cypress_fns = {
         FIELD_INIT(.probe, cyapi_probe),
+        FIELD_INIT(.hotplug_start, NULL),
+        FIELD_INIT(.hotplug_stop, NULL),
         FIELD_INIT(.open, cyapi_open),
         FIELD_INIT(.close, cyapi_close),
         FIELD_INIT(.get_vid_pid, cyapi_get_vid_pid),
@@ -836,9 +860,15 @@ extern "C" {
         FIELD_INIT(.get_handle, cyapi_get_handle),
         FIELD_INIT(.get_speed, cyapi_get_speed),
         FIELD_INIT(.change_setting, cyapi_change_setting),
+        FIELD_INIT(.reset, NULL),
         FIELD_INIT(.control_transfer, cyapi_control_transfer),
         FIELD_INIT(.bulk_transfer, cyapi_bulk_transfer),
+        FIELD_INIT(.bulk_exchange, NULL),
+        FIELD_INIT(.bulk_write_stream, NULL),
+        FIELD_INIT(.control_transfers, NULL),
         FIELD_INIT(.get_string_descriptor, cyapi_get_string_descriptor),
+        FIELD_INIT(.alloc_stream_buffers, NULL),
+        FIELD_INIT(.free_stream_buffers, NULL),
         FIELD_INIT(.init_stream, cyapi_init_stream),
         FIELD_INIT(.stream, cyapi_stream),
         FIELD_INIT(.submit_stream_buffer, cyapi_submit_stream_buffer),
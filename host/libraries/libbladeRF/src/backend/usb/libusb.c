@@ -24,18 +24,22 @@
 #include <string.h>
 #include <pthread.h>
 #include <errno.h>
+#include <limits.h>
 #include <libusb.h>
 #if 1 == BLADERF_OS_FREEBSD  
 #include <limits.h>
 #endif // BLADERF_OS_FREEBSD
 
 #include "log.h"
+#include "minmax.h"
 
 #include "devinfo.h"
 #include "backend/backend.h"
 #include "backend/usb/usb.h"
 #include "streaming/async.h"
 #include "helpers/timeout.h"
+#include "helpers/trace.h"
+#include "helpers/wallclock.h"
 
 #include "bladeRF.h"
 
@@ -61,12 +65,36 @@ typedef enum {
     TRANSFER_CANCEL_PENDING
 } transfer_status;
 
+/* Stream transfer user data, identifying the transfer's slot */
+struct lusb_transfer_ctx {
+    struct bladerf_stream *stream;
+    size_t idx;   /* Index into the lusb_stream_data arrays */
+    uint64_t seq; /* Order in which the transfer was last claimed */
+};
+
+/* Available transfers are kept in the `avail` ring, in the order they became
+ * available, so that claiming and returning one is O(1). The ring is
+ * protected by stream->lock, which is held while claiming a transfer but
+ * released while handing it to libusb_submit_transfer(); stream->lock must
+ * not be held into libusb due to lock ordering with libusb's event lock.
+ *
+ * Transfer statuses and `num_avail` are also accessed atomically, so that
+ * they may be inspected while a claimed transfer is being submitted. */
 struct lusb_stream_data {
     size_t num_transfers;               /* Total # of allocated transfers */
-    size_t num_avail;                   /* # of currently available transfers */
-    size_t i;                           /* Index to next transfer */
+    unsigned int num_avail;             /* # of currently available transfers.
+                                         * Accessed atomically. */
+    unsigned int *avail;                /* Ring of available transfer indices,
+                                         * oldest first */
+    unsigned int avail_head;            /* Index into `avail` of the oldest */
     struct libusb_transfer **transfers; /* Array of transfer metadata */
-    transfer_status *transfer_status;   /* Status of each transfer */
+    struct lusb_transfer_ctx *ctx;      /* User data of each transfer */
+    transfer_status *transfer_status;   /* Status of each transfer.
+                                         * Accessed atomically. */
+    uint64_t *submit_time_us;           /* Submission time of each transfer.
+                                         * Written by the claimant. */
+    uint64_t claim_seq;                 /* Sequence # of the next claim */
+    uint64_t complete_seq;              /* Greatest sequence # completed */
 
    /* Warn the first time we get a transfer callback out of order.
     * This shouldn't happen normally, but we've seen it intermittently on
@@ -201,6 +229,203 @@ static int get_devinfo(libusb_device *dev, struct bladerf_devinfo *info)
     return status;
 }
 
+/* Descriptor strings of previously probed devices are cached for the lifetime
+ * of the process, so that each device need not be opened to read them again.
+ *
+ * Entries are keyed by the device's bus, address, port path, and device
+ * descriptor. As a device is assigned a new address whenever it re-enumerates
+ * (e.g., after being replugged or reset), an entry cannot be mistaken for a
+ * different device, and entries for devices that are no longer present in the
+ * device list are discarded on each probe. */
+#define DEVINFO_CACHE_LEN   32
+#define PORT_PATH_MAX       7   /* Limit imposed by the USB 3.0 spec */
+
+struct devinfo_cache_entry {
+    uint8_t bus;
+    uint8_t addr;
+    uint8_t ports[PORT_PATH_MAX];
+    int num_ports;
+    uint16_t vid;
+    uint16_t pid;
+    uint16_t bcd_device;
+
+    struct bladerf_devinfo info;
+};
+
+static struct devinfo_cache_entry devinfo_cache[DEVINFO_CACHE_LEN];
+static size_t devinfo_cache_count = 0;
+static pthread_mutex_t devinfo_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static bool devinfo_cache_key(libusb_device *dev,
+                              struct devinfo_cache_entry *key)
+{
+    struct libusb_device_descriptor desc;
+    int status;
+
+    memset(key, 0, sizeof(*key));
+
+    status = libusb_get_device_descriptor(dev, &desc);
+    if (status != 0) {
+        return false;
+    }
+
+    key->bus        = libusb_get_bus_number(dev);
+    key->addr       = libusb_get_device_address(dev);
+    key->vid        = desc.idVendor;
+    key->pid        = desc.idProduct;
+    key->bcd_device = desc.bcdDevice;
+
+    /* libusb_get_port_numbers() was added in libusb v1.0.16 */
+#if defined(LIBUSB_API_VERSION) && (LIBUSB_API_VERSION >= 0x01000102)
+    key->num_ports = libusb_get_port_numbers(dev, key->ports, PORT_PATH_MAX);
+    if (key->num_ports < 0) {
+        key->num_ports = 0;
+    }
+#endif
+
+    return true;
+}
+
+static bool devinfo_cache_key_matches(const struct devinfo_cache_entry *a,
+                                      const struct devinfo_cache_entry *b)
+{
+    return a->bus == b->bus && a->addr == b->addr && a->vid == b->vid &&
+           a->pid == b->pid && a->bcd_device == b->bcd_device &&
+           a->num_ports == b->num_ports &&
+           memcmp(a->ports, b->ports, a->num_ports) == 0;
+}
+
+/* Must be called with devinfo_cache_lock held */
+static struct devinfo_cache_entry *devinfo_cache_find(
+    const struct devinfo_cache_entry *key)
+{
+    size_t i;
+
+    for (i = 0; i < devinfo_cache_count; i++) {
+        if (devinfo_cache_key_matches(&devinfo_cache[i], key)) {
+            return &devinfo_cache[i];
+        }
+    }
+
+    return NULL;
+}
+
+static bool devinfo_cache_lookup(libusb_device *dev,
+                                 struct bladerf_devinfo *info)
+{
+    struct devinfo_cache_entry key;
+    struct devinfo_cache_entry *entry;
+
+    if (!devinfo_cache_key(dev, &key)) {
+        return false;
+    }
+
+    pthread_mutex_lock(&devinfo_cache_lock);
+
+    entry = devinfo_cache_find(&key);
+    if (entry != NULL) {
+        memcpy(info, &entry->info, sizeof(*info));
+    }
+
+    pthread_mutex_unlock(&devinfo_cache_lock);
+
+    return entry != NULL;
+}
+
+static void devinfo_cache_store(libusb_device *dev,
+                                const struct bladerf_devinfo *info)
+{
+    struct devinfo_cache_entry key;
+    struct devinfo_cache_entry *entry;
+
+    if (!devinfo_cache_key(dev, &key)) {
+        return;
+    }
+
+    pthread_mutex_lock(&devinfo_cache_lock);
+
+    entry = devinfo_cache_find(&key);
+    if (entry == NULL) {
+        if (devinfo_cache_count == DEVINFO_CACHE_LEN) {
+            /* Evict the oldest entry */
+            memmove(&devinfo_cache[0], &devinfo_cache[1],
+                    (DEVINFO_CACHE_LEN - 1) * sizeof(devinfo_cache[0]));
+            devinfo_cache_count--;
+        }
+
+        entry  = &devinfo_cache[devinfo_cache_count++];
+        *entry = key;
+    }
+
+    memcpy(&entry->info, info, sizeof(entry->info));
+
+    pthread_mutex_unlock(&devinfo_cache_lock);
+}
+
+/* Discard entries for devices that are not in the provided device list */
+static void devinfo_cache_prune(libusb_device **list, ssize_t count)
+{
+    struct devinfo_cache_entry *keys;
+    size_t i, n;
+    ssize_t j;
+
+    if (count <= 0) {
+        return;
+    }
+
+    keys = calloc((size_t)count, sizeof(keys[0]));
+    if (keys == NULL) {
+        return;
+    }
+
+    for (j = 0; j < count; j++) {
+        devinfo_cache_key(list[j], &keys[j]);
+    }
+
+    pthread_mutex_lock(&devinfo_cache_lock);
+
+    for (i = n = 0; i < devinfo_cache_count; i++) {
+        for (j = 0; j < count; j++) {
+            if (devinfo_cache_key_matches(&devinfo_cache[i], &keys[j])) {
+                break;
+            }
+        }
+
+        if (j < count) {
+            devinfo_cache[n++] = devinfo_cache[i];
+        } else {
+            log_verbose("Bus %03d Device %03d is no longer present\n",
+                        devinfo_cache[i].bus, devinfo_cache[i].addr);
+        }
+    }
+
+    devinfo_cache_count = n;
+
+    pthread_mutex_unlock(&devinfo_cache_lock);
+
+    free(keys);
+}
+
+/* As get_devinfo(), but uses and updates the cache. Returns libusb error
+ * codes. */
+static int get_devinfo_cached(libusb_device *dev, struct bladerf_devinfo *info)
+{
+    int status;
+
+    if (devinfo_cache_lookup(dev, info)) {
+        return 0;
+    }
+
+    status = get_devinfo(dev, info);
+
+    /* Don't cache partial results, which may be due to old firmware */
+    if (status == 0 && info->serial[0] != '\0') {
+        devinfo_cache_store(dev, info);
+    }
+
+    return status;
+}
+
 static bool device_has_vid_pid(libusb_device *dev, uint16_t vid, uint16_t pid)
 {
     int status;
@@ -277,6 +502,7 @@ static bool device_is_probe_target(backend_probe_target probe_target,
 
     switch (probe_target) {
         case BACKEND_PROBE_BLADERF:
+        case BACKEND_PROBE_BLADERF_QUICK:
             is_probe_target = device_is_bladerf(dev);
             if (is_probe_target) {
                 log_verbose("Found a bladeRF\n");
@@ -297,13 +523,97 @@ static bool device_is_probe_target(backend_probe_target probe_target,
     return is_probe_target;
 }
 
+/* Maximum number of threads used to read descriptors during a probe */
+#define PROBE_MAX_THREADS 8
+
+struct probe_job {
+    libusb_device *dev;
+    struct bladerf_devinfo info;
+    bool pending;   /* Descriptors need to be read */
+    int status;     /* libusb error code */
+};
+
+struct probe_work {
+    struct probe_job *jobs;
+    size_t num_jobs;
+    size_t next;
+    pthread_mutex_t lock;
+};
+
+static void *probe_worker(void *arg)
+{
+    struct probe_work *work = (struct probe_work *)arg;
+    struct probe_job *job;
+
+    while (true) {
+        job = NULL;
+
+        pthread_mutex_lock(&work->lock);
+        while (work->next < work->num_jobs && job == NULL) {
+            if (work->jobs[work->next].pending) {
+                job = &work->jobs[work->next];
+            }
+            work->next++;
+        }
+        pthread_mutex_unlock(&work->lock);
+
+        if (job == NULL) {
+            break;
+        }
+
+        job->status = get_devinfo_cached(job->dev, &job->info);
+    }
+
+    return NULL;
+}
+
+/* Read the descriptors of all pending jobs. Opening a device and reading its
+ * string descriptors takes a few control transfers' worth of round trips,
+ * so these are overlapped across devices. */
+static void probe_read_devinfo(struct probe_job *jobs, size_t num_jobs,
+                               size_t num_pending)
+{
+    pthread_t threads[PROBE_MAX_THREADS - 1];
+    struct probe_work work;
+    size_t i, num_threads;
+
+    work.jobs     = jobs;
+    work.num_jobs = num_jobs;
+    work.next     = 0;
+
+    if (num_pending == 0) {
+        return;
+    }
+
+    pthread_mutex_init(&work.lock, NULL);
+
+    /* The calling thread serves as a worker as well */
+    for (num_threads = 0; num_threads < num_pending - 1 &&
+                          num_threads < ARRAY_SIZE(threads);
+         num_threads++) {
+        if (pthread_create(&threads[num_threads], NULL, probe_worker,
+                           &work) != 0) {
+            break;
+        }
+    }
+
+    probe_worker(&work);
+
+    for (i = 0; i < num_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&work.lock);
+}
+
 static int lusb_probe(backend_probe_target probe_target,
                       struct bladerf_devinfo_list *info_list)
 {
-    int status, i, n;
-    ssize_t count;
+    int status, n;
+    ssize_t count, i;
     libusb_device **list;
-    struct bladerf_devinfo info;
+    struct probe_job *jobs = NULL;
+    size_t j, num_jobs, num_pending;
     bool printed_access_warning = false;
 
     libusb_context *context;
@@ -317,157 +627,438 @@ static int lusb_probe(backend_probe_target probe_target,
     }
 
     count = libusb_get_device_list(context, &list);
-    /* Iterate through all the USB devices */
-    for (i = 0, n = 0; i < count && status == 0; i++) {
+    if (count < 0) {
+        goto lusb_probe_exit;
+    } else if (count == 0) {
+        goto lusb_probe_free_list;
+    }
+
+    devinfo_cache_prune(list, count);
+
+    jobs = calloc((size_t)count, sizeof(jobs[0]));
+    if (jobs == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto lusb_probe_free_list;
+    }
+
+    /* Find the probe targets and the cached information for each */
+    for (i = 0, num_jobs = num_pending = 0; i < count; i++) {
         if (device_is_probe_target(probe_target, list[i])) {
-            bool do_add = true;
+            struct probe_job *job = &jobs[num_jobs++];
 
-            /* Open the USB device and get some information */
-            status = get_devinfo(list[i], &info);
-            if (status) {
-                /* We may not be able to open the device if another driver
-                 * (e.g., CyUSB3) is associated with it. Therefore, just log to
-                 * the debug level and carry on. */
-                log_debug("Could not open device: %s\n",
-                          libusb_error_name(status));
+            job->dev = list[i];
 
-                if (status == LIBUSB_ERROR_ACCESS) {
-                    /* If it's an access error, odds are good this is happening
-                     * because we've already got the device open. Pass the info
-                     * we have back to the caller. */
-                    do_add = true;
-
-                    if (!printed_access_warning) {
-                        printed_access_warning = true;
-                        log_warning(
-                            "Found a bladeRF via VID/PID, but could not open "
-                            "it due to insufficient permissions, or because "
-                            "the device is already open.\n");
-                    }
-                } else {
-                    do_add = false;
-                }
+            if (devinfo_cache_lookup(list[i], &job->info)) {
+                continue;
+            }
 
-                /* Don't stop probing because one device was "problematic" */
-                status = 0;
+            if (probe_target == BACKEND_PROBE_BLADERF_QUICK) {
+                /* Report what is known without opening the device */
+                bladerf_init_devinfo(&job->info);
+                job->info.backend  = BLADERF_BACKEND_LIBUSB;
+                job->info.usb_bus  = libusb_get_bus_number(list[i]);
+                job->info.usb_addr = libusb_get_device_address(list[i]);
+                memset(job->info.serial, 0, BLADERF_SERIAL_LENGTH);
+            } else {
+                job->pending = true;
+                num_pending++;
             }
+        }
+    }
 
-            if (do_add) {
-                info.instance = n++;
+    /* Open the USB devices and get some information */
+    probe_read_devinfo(jobs, num_jobs, num_pending);
 
-                status = bladerf_devinfo_list_add(info_list, &info);
-                if (status) {
-                    log_error("Could not add device to list: %s\n",
-                              bladerf_strerror(status));
-                } else {
-                    log_verbose("Added instance %d to device list\n",
-                                info.instance);
+    for (j = 0, n = 0; j < num_jobs && status == 0; j++) {
+        struct probe_job *job = &jobs[j];
+        bool do_add = true;
+
+        if (job->status) {
+            /* We may not be able to open the device if another driver
+             * (e.g., CyUSB3) is associated with it. Therefore, just log to
+             * the debug level and carry on. */
+            log_debug("Could not open device: %s\n",
+                      libusb_error_name(job->status));
+
+            if (job->status == LIBUSB_ERROR_ACCESS) {
+                /* If it's an access error, odds are good this is happening
+                 * because we've already got the device open. Pass the info
+                 * we have back to the caller. */
+                do_add = true;
+
+                if (!printed_access_warning) {
+                    printed_access_warning = true;
+                    log_warning(
+                        "Found a bladeRF via VID/PID, but could not open "
+                        "it due to insufficient permissions, or because "
+                        "the device is already open.\n");
                 }
+            } else {
+                do_add = false;
+            }
+        }
+
+        if (do_add) {
+            job->info.instance = n++;
+
+            status = bladerf_devinfo_list_add(info_list, &job->info);
+            if (status) {
+                log_error("Could not add device to list: %s\n",
+                          bladerf_strerror(status));
+            } else {
+                log_verbose("Added instance %d to device list\n",
+                            job->info.instance);
             }
         }
     }
 
+    free(jobs);
+
+lusb_probe_free_list:
     libusb_free_device_list(list, 1);
+
+lusb_probe_exit:
     libusb_exit(context);
 
 lusb_probe_done:
     return status;
 }
 
-#ifdef HAVE_LIBUSB_GET_VERSION
-static inline void get_libusb_version(char *buf, size_t buf_len)
-{
-    const struct libusb_version *version;
-    version = libusb_get_version();
+/* Hotplug support was added in libusb v1.0.16 */
+#if defined(LIBUSB_API_VERSION) && (LIBUSB_API_VERSION >= 0x01000102)
 
-    snprintf(buf, buf_len, "%d.%d.%d.%d%s", version->major, version->minor,
-             version->micro, version->nano, version->rc);
-}
-#else
-static void get_libusb_version(char *buf, size_t buf_len)
-{
-    snprintf(buf, buf_len, "<= 1.0.9");
-}
-#endif
+/* Devices may not be opened from within a libusb hotplug callback, so events
+ * are queued by lusb_hotplug_event() and processed by the hotplug thread
+ * after each return from libusb_handle_events(). */
+struct lusb_hotplug_event {
+    libusb_device *dev; /* Referenced until the event is processed */
+    bool arrived;
+    struct lusb_hotplug_event *next;
+};
 
-static int create_device_mutex(const struct bladerf_devinfo *info,
-                               struct bladerf_lusb *dev)
+/* Upper bound on how long it takes the hotplug thread to notice a stop
+ * request, should libusb not interrupt its event handling */
+#define LUSB_HOTPLUG_POLL_MS    100
+
+static libusb_context *hotplug_context = NULL;
+static libusb_hotplug_callback_handle hotplug_handle;
+static backend_hotplug_cb hotplug_cb;
+static pthread_t hotplug_thread;
+
+static pthread_mutex_t hotplug_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct lusb_hotplug_event *hotplug_head = NULL;
+static struct lusb_hotplug_event *hotplug_tail = NULL;
+static bool hotplug_stop = false;
+
+static int LIBUSB_CALL lusb_hotplug_event(libusb_context *context,
+                                          libusb_device *dev,
+                                          libusb_hotplug_event event,
+                                          void *user_data)
 {
-    int status = 0;
+    struct lusb_hotplug_event *e;
 
-#if 1 == BLADERF_OS_WINDOWS
-    const char prefix[] = "Global\\bladeRF-";
-    const size_t mutex_name_len = strlen(prefix) + BLADERF_SERIAL_LENGTH;
-    char *mutex_name = (char *)calloc(mutex_name_len, 1);
-    DWORD last_error;
+    if (!device_has_bladeRF_ids(dev)) {
+        return 0;
+    }
 
-    if (NULL == mutex_name) {
-        return BLADERF_ERR_MEM;
+    e = malloc(sizeof(*e));
+    if (e == NULL) {
+        log_error("Failed to allocate hotplug event; dropping it.\n");
+        return 0;
     }
 
-    snprintf(mutex_name, mutex_name_len, "%s%s", prefix, info->serial);
-    log_verbose("Mutex name: %s\n", mutex_name);
+    e->dev     = libusb_ref_device(dev);
+    e->arrived = (event == LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED);
+    e->next    = NULL;
 
-    SetLastError(0);
-    dev->mutex = CreateMutex(NULL, true, mutex_name);
-    last_error = GetLastError();
-    if (NULL == dev->mutex || last_error != 0) {
-        log_debug("Unable to create device mutex: mutex=%p, last_error=%ld\n",
-                  dev->mutex, last_error);
-        status = BLADERF_ERR_NODEV;
-        ReleaseMutex(dev->mutex);
-        CloseHandle(dev->mutex);
+    pthread_mutex_lock(&hotplug_lock);
+
+    if (hotplug_tail == NULL) {
+        hotplug_head = e;
+    } else {
+        hotplug_tail->next = e;
     }
 
-    free(mutex_name);
-#endif // BLADERF_OS_WINDOWS
+    hotplug_tail = e;
 
-    return status;
+    pthread_mutex_unlock(&hotplug_lock);
+
+    return 0;
 }
 
-static int open_device(const struct bladerf_devinfo *info,
-                       libusb_context *context,
-                       libusb_device *libusb_dev_in,
-                       struct bladerf_lusb **dev_out)
+static struct lusb_hotplug_event *hotplug_dequeue(void)
 {
-    int status;
-    struct bladerf_lusb *dev;
-
-    *dev_out = NULL;
+    struct lusb_hotplug_event *e;
 
-    dev = (struct bladerf_lusb *) calloc(1, sizeof(dev[0]));
-    if (dev == NULL) {
-        log_debug("Failed to allocate handle for instance %d.\n",
-                  info->instance);
+    pthread_mutex_lock(&hotplug_lock);
 
-        /* Report "no device" so we could try again with
-         * another matching device */
-        return BLADERF_ERR_NODEV;
+    e = hotplug_head;
+    if (e != NULL) {
+        hotplug_head = e->next;
+        if (hotplug_head == NULL) {
+            hotplug_tail = NULL;
+        }
     }
 
-    dev->context = context;
-    dev->dev = libusb_dev_in;
+    pthread_mutex_unlock(&hotplug_lock);
 
-    status = libusb_open(libusb_dev_in, &dev->handle);
-    if (status < 0) {
-        log_debug("Failed to open device instance %d: %s\n",
-                  info->instance, libusb_error_name(status));
+    return e;
+}
 
-        status = error_conv(status);
-        goto out;
-    }
+/* Process (or if `discard` is set, drop) all queued events */
+static void hotplug_process(bool discard)
+{
+    struct lusb_hotplug_event *e;
+    struct bladerf_devinfo info;
+    int status;
 
-    status = libusb_claim_interface(dev->handle, 0);
-    if (status < 0) {
-        log_debug("Failed to claim interface 0 for instance %d: %s\n",
-                  info->instance, libusb_error_name(status));
+    while ((e = hotplug_dequeue()) != NULL) {
+        if (discard) {
+            /* Nothing to do */
+        } else if (e->arrived) {
+            if (device_is_bladerf(e->dev)) {
+                status = get_devinfo_cached(e->dev, &info);
+
+                /* As with lusb_probe(), devices that are already open are
+                 * reported with the information available */
+                if (status == 0 || status == LIBUSB_ERROR_ACCESS) {
+                    hotplug_cb(&info, true);
+                } else {
+                    log_debug("Could not open hotplugged device: %s\n",
+                              libusb_error_name(status));
+                }
+            }
+        } else {
+            bladerf_init_devinfo(&info);
+            info.backend  = BLADERF_BACKEND_LIBUSB;
+            info.usb_bus  = libusb_get_bus_number(e->dev);
+            info.usb_addr = libusb_get_device_address(e->dev);
 
-        status = error_conv(status);
-        goto out;
+            hotplug_cb(&info, false);
+        }
+
+        libusb_unref_device(e->dev);
+        free(e);
     }
+}
 
-    status = create_device_mutex(info, dev);
-    if (status < 0) {
+static bool hotplug_stopping(void)
+{
+    bool stop;
+
+    pthread_mutex_lock(&hotplug_lock);
+    stop = hotplug_stop;
+    pthread_mutex_unlock(&hotplug_lock);
+
+    return stop;
+}
+
+static void *lusb_hotplug_task(void *arg)
+{
+    struct timeval tv;
+    int status;
+
+    while (!hotplug_stopping()) {
+        tv.tv_sec  = 0;
+        tv.tv_usec = LUSB_HOTPLUG_POLL_MS * 1000;
+
+        status = libusb_handle_events_timeout_completed(hotplug_context, &tv,
+                                                        NULL);
+        if (status != 0 && status != LIBUSB_ERROR_INTERRUPTED) {
+            log_debug("Hotplug event handling failed: %s\n",
+                      libusb_error_name(status));
+        }
+
+        hotplug_process(false);
+    }
+
+    return NULL;
+}
+
+static int lusb_hotplug_start(backend_hotplug_cb cb)
+{
+    int status;
+
+    if (hotplug_context != NULL) {
+        return 0;
+    }
+
+    if (!libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG)) {
+        log_debug("libusb does not support hotplug on this platform.\n");
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    status = libusb_init(&hotplug_context);
+    if (status != 0) {
+        hotplug_context = NULL;
+        log_debug("Could not initialize libusb: %s\n",
+                  libusb_error_name(status));
+        return error_conv(status);
+    }
+
+    hotplug_cb   = cb;
+    hotplug_stop = false;
+
+    /* Arrivals of the devices already attached are queued before this
+     * returns, and are reported prior to starting the thread */
+    status = libusb_hotplug_register_callback(
+        hotplug_context,
+        LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED | LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT,
+        LIBUSB_HOTPLUG_ENUMERATE, LIBUSB_HOTPLUG_MATCH_ANY,
+        LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY, lusb_hotplug_event,
+        NULL, &hotplug_handle);
+
+    if (status != 0) {
+        log_debug("Could not register hotplug callback: %s\n",
+                  libusb_error_name(status));
+        status = error_conv(status);
+        goto error;
+    }
+
+    hotplug_process(false);
+
+    if (pthread_create(&hotplug_thread, NULL, lusb_hotplug_task, NULL) != 0) {
+        libusb_hotplug_deregister_callback(hotplug_context, hotplug_handle);
+        status = BLADERF_ERR_UNEXPECTED;
+        goto error;
+    }
+
+    return 0;
+
+error:
+    hotplug_process(true);
+    libusb_exit(hotplug_context);
+    hotplug_context = NULL;
+    return status;
+}
+
+static void lusb_hotplug_stop(void)
+{
+    if (hotplug_context == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&hotplug_lock);
+    hotplug_stop = true;
+    pthread_mutex_unlock(&hotplug_lock);
+
+    /* This also interrupts the thread's event handling */
+    libusb_hotplug_deregister_callback(hotplug_context, hotplug_handle);
+    pthread_join(hotplug_thread, NULL);
+
+    hotplug_process(true);
+    libusb_exit(hotplug_context);
+    hotplug_context = NULL;
+}
+
+#else
+
+static int lusb_hotplug_start(backend_hotplug_cb cb)
+{
+    log_debug("This version of libusb does not support hotplug.\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static void lusb_hotplug_stop(void)
+{
+}
+
+#endif
+
+#ifdef HAVE_LIBUSB_GET_VERSION
+static inline void get_libusb_version(char *buf, size_t buf_len)
+{
+    const struct libusb_version *version;
+    version = libusb_get_version();
+
+    snprintf(buf, buf_len, "%d.%d.%d.%d%s", version->major, version->minor,
+             version->micro, version->nano, version->rc);
+}
+#else
+static void get_libusb_version(char *buf, size_t buf_len)
+{
+    snprintf(buf, buf_len, "<= 1.0.9");
+}
+#endif
+
+static int create_device_mutex(const struct bladerf_devinfo *info,
+                               struct bladerf_lusb *dev)
+{
+    int status = 0;
+
+#if 1 == BLADERF_OS_WINDOWS
+    const char prefix[] = "Global\\bladeRF-";
+    const size_t mutex_name_len = strlen(prefix) + BLADERF_SERIAL_LENGTH;
+    char *mutex_name = (char *)calloc(mutex_name_len, 1);
+    DWORD last_error;
+
+    if (NULL == mutex_name) {
+        return BLADERF_ERR_MEM;
+    }
+
+    snprintf(mutex_name, mutex_name_len, "%s%s", prefix, info->serial);
+    log_verbose("Mutex name: %s\n", mutex_name);
+
+    SetLastError(0);
+    dev->mutex = CreateMutex(NULL, true, mutex_name);
+    last_error = GetLastError();
+    if (NULL == dev->mutex || last_error != 0) {
+        log_debug("Unable to create device mutex: mutex=%p, last_error=%ld\n",
+                  dev->mutex, last_error);
+        status = BLADERF_ERR_NODEV;
+        ReleaseMutex(dev->mutex);
+        CloseHandle(dev->mutex);
+    }
+
+    free(mutex_name);
+#endif // BLADERF_OS_WINDOWS
+
+    return status;
+}
+
+static int open_device(const struct bladerf_devinfo *info,
+                       libusb_context *context,
+                       libusb_device *libusb_dev_in,
+                       struct bladerf_lusb **dev_out)
+{
+    int status;
+    struct bladerf_lusb *dev;
+
+    *dev_out = NULL;
+
+    dev = (struct bladerf_lusb *) calloc(1, sizeof(dev[0]));
+    if (dev == NULL) {
+        log_debug("Failed to allocate handle for instance %d.\n",
+                  info->instance);
+
+        /* Report "no device" so we could try again with
+         * another matching device */
+        return BLADERF_ERR_NODEV;
+    }
+
+    dev->context = context;
+    dev->dev = libusb_dev_in;
+
+    status = libusb_open(libusb_dev_in, &dev->handle);
+    if (status < 0) {
+        log_debug("Failed to open device instance %d: %s\n",
+                  info->instance, libusb_error_name(status));
+
+        status = error_conv(status);
+        goto out;
+    }
+
+    status = libusb_claim_interface(dev->handle, 0);
+    if (status < 0) {
+        log_debug("Failed to claim interface 0 for instance %d: %s\n",
+                  info->instance, libusb_error_name(status));
+
+        status = error_conv(status);
+        goto out;
+    }
+
+    status = create_device_mutex(info, dev);
+    if (status < 0) {
         log_debug("Failed to get device mutex for instance %d: %s\n",
                   info->instance, bladerf_strerror(status));
 
@@ -519,7 +1110,7 @@ static int find_and_open_device(libusb_context *context,
             log_verbose("Found a bladeRF (idx=%d)\n", i);
 
             /* Open the USB device and get some information */
-            status = get_devinfo(list[i], &curr_info);
+            status = get_devinfo_cached(list[i], &curr_info);
             if (status < 0) {
 
                 /* Give the user a helpful hint in case the have forgotten
@@ -684,6 +1275,59 @@ static int lusb_change_setting(void *driver, uint8_t setting)
     return error_conv(status);
 }
 
+static int lusb_reset(void *driver, struct bladerf_devinfo *info)
+{
+    struct bladerf_lusb *lusb  = (struct bladerf_lusb *)driver;
+    struct bladerf_lusb *found = NULL;
+    struct bladerf_devinfo new_info;
+    int status;
+
+    status = libusb_reset_device(lusb->handle);
+    if (status == 0) {
+        log_verbose("USB port reset succeeded for bladeRF %s\n", info->serial);
+        return 0;
+    } else if (status != LIBUSB_ERROR_NO_DEVICE &&
+               status != LIBUSB_ERROR_NOT_FOUND) {
+        log_debug("Port reset failed for bladeRF %s: %s\n", info->serial,
+                  libusb_error_name(status));
+        return error_conv(status);
+    }
+
+    /* As in reset_and_reopen(), the device has re-enumerated, and is found
+     * again via its serial number */
+    log_verbose("Re-scan required after port reset for bladeRF %s\n",
+                info->serial);
+
+#if 1 == BLADERF_OS_WINDOWS
+    /* The new handle takes the device mutex. None is held should the device
+     * not be found again. */
+    ReleaseMutex(lusb->mutex);
+    CloseHandle(lusb->mutex);
+    lusb->mutex = NULL;
+#endif // BLADERF_OS_WINDOWS
+
+    memcpy(&new_info, info, sizeof(new_info));
+    new_info.usb_bus  = DEVINFO_BUS_ANY;
+    new_info.usb_addr = DEVINFO_ADDR_ANY;
+
+    status = find_and_open_device(lusb->context, &new_info, &found, info);
+    if (status != 0) {
+        return status;
+    }
+
+    libusb_release_interface(lusb->handle, 0);
+    libusb_close(lusb->handle);
+
+    lusb->dev    = found->dev;
+    lusb->handle = found->handle;
+#if 1 == BLADERF_OS_WINDOWS
+    lusb->mutex = found->mutex;
+#endif // BLADERF_OS_WINDOWS
+    free(found);
+
+    return 0;
+}
+
 static void lusb_close(void *driver)
 {
     int status;
@@ -698,8 +1342,10 @@ static void lusb_close(void *driver)
     libusb_close(lusb->handle);
     libusb_exit(lusb->context);
 #if 1 == BLADERF_OS_WINDOWS
-    ReleaseMutex(lusb->mutex);
-    CloseHandle(lusb->mutex);
+    if (lusb->mutex != NULL) {
+        ReleaseMutex(lusb->mutex);
+        CloseHandle(lusb->mutex);
+    }
 #endif // BLADERF_OS_WINDOWS
     free(lusb);
 }
@@ -886,91 +1532,552 @@ static inline uint8_t bm_request_type(usb_target target_type,
             ret |= LIBUSB_RECIPIENT_DEVICE;
             break;
 
-        case USB_TARGET_INTERFACE:
-            ret |= LIBUSB_RECIPIENT_INTERFACE;
-            break;
+        case USB_TARGET_INTERFACE:
+            ret |= LIBUSB_RECIPIENT_INTERFACE;
+            break;
+
+        case USB_TARGET_ENDPOINT:
+            ret |= LIBUSB_RECIPIENT_ENDPOINT;
+            break;
+
+        default:
+            ret |= LIBUSB_RECIPIENT_OTHER;
+
+    }
+
+    switch (req_type) {
+        case USB_REQUEST_STANDARD:
+            ret |= LIBUSB_REQUEST_TYPE_STANDARD;
+            break;
+
+        case USB_REQUEST_CLASS:
+            ret |= LIBUSB_REQUEST_TYPE_CLASS;
+            break;
+
+        case USB_REQUEST_VENDOR:
+            ret |= LIBUSB_REQUEST_TYPE_VENDOR;
+            break;
+    }
+
+    switch (direction) {
+        case USB_DIR_HOST_TO_DEVICE:
+            ret |= LIBUSB_ENDPOINT_OUT;
+            break;
+
+        case USB_DIR_DEVICE_TO_HOST:
+            ret |= LIBUSB_ENDPOINT_IN;
+            break;
+    }
+
+    return ret;
+}
+
+static int lusb_control_transfer(void *driver,
+                                 usb_target target_type, usb_request req_type,
+                                 usb_direction dir, uint8_t request,
+                                 uint16_t wvalue, uint16_t windex,
+                                 void *buffer, uint32_t buffer_len,
+                                 uint32_t timeout_ms)
+{
+
+    int status;
+    struct bladerf_lusb *lusb = (struct bladerf_lusb *) driver;
+    const uint8_t bm_req_type = bm_request_type(target_type, req_type, dir);
+
+    status = libusb_control_transfer(lusb->handle,
+                                     bm_req_type, request,
+                                     wvalue, windex,
+                                     buffer, buffer_len,
+                                     timeout_ms);
+
+    if (status >= 0 && (uint32_t)status == buffer_len) {
+        status = 0;
+    } else {
+        log_debug("%s failed: status = %d\n", __FUNCTION__, status);
+    }
+
+    return error_conv(status);
+}
+
+static int lusb_bulk_transfer(void *driver, uint8_t endpoint, void *buffer,
+                              uint32_t buffer_len, uint32_t timeout_ms)
+{
+    int status;
+    int n_transferred;
+    struct bladerf_lusb *lusb = (struct bladerf_lusb *) driver;
+
+    status = libusb_bulk_transfer(lusb->handle, endpoint, buffer, buffer_len,
+                                  &n_transferred, timeout_ms);
+
+    status = error_conv(status);
+    if (status == 0 && ((uint32_t)n_transferred != buffer_len)) {
+        log_debug("Short bulk transfer: requested=%u, transferred=%u\n",
+                  buffer_len, n_transferred);
+        status = BLADERF_ERR_IO;
+    }
+
+    return status;
+}
+
+/* Completion tracking for lusb_bulk_exchange() */
+struct lusb_exchange {
+    struct libusb_transfer *in; /* Response transfer */
+    int remaining;              /* # of transfers yet to complete */
+    int completed;              /* Set when all transfers have completed */
+};
+
+static void LIBUSB_CALL lusb_exchange_cb(struct libusb_transfer *transfer)
+{
+    struct lusb_exchange *x = (struct lusb_exchange *) transfer->user_data;
+
+    /* No response is coming if the request didn't make it out */
+    if (transfer != x->in && transfer->status != LIBUSB_TRANSFER_COMPLETED) {
+        libusb_cancel_transfer(x->in);
+    }
+
+    if (--x->remaining == 0) {
+        x->completed = 1;
+    }
+}
+
+static int lusb_exchange_status(const struct libusb_transfer *transfer,
+                                uint32_t len)
+{
+    switch (transfer->status) {
+        case LIBUSB_TRANSFER_COMPLETED:
+            if ((uint32_t)transfer->actual_length != len) {
+                log_debug("Short bulk transfer: requested=%u, "
+                          "transferred=%d\n", len, transfer->actual_length);
+                return BLADERF_ERR_IO;
+            }
+            return 0;
+
+        case LIBUSB_TRANSFER_TIMED_OUT:
+            return BLADERF_ERR_TIMEOUT;
+
+        case LIBUSB_TRANSFER_NO_DEVICE:
+            return BLADERF_ERR_NODEV;
+
+        case LIBUSB_TRANSFER_CANCELLED:
+        case LIBUSB_TRANSFER_STALL:
+        case LIBUSB_TRANSFER_OVERFLOW:
+        case LIBUSB_TRANSFER_ERROR:
+        default:
+            return BLADERF_ERR_IO;
+    }
+}
+
+/* Submit the response transfer ahead of the request, so that the response is
+ * retrieved as soon as the device produces it, rather than after the host has
+ * processed the completion of the request. */
+static int lusb_bulk_exchange(void *driver,
+                              uint8_t ep_out, const void *request,
+                              uint8_t ep_in, void *response,
+                              uint32_t len, uint32_t timeout_ms)
+{
+    struct bladerf_lusb *lusb = (struct bladerf_lusb *) driver;
+    struct libusb_transfer *out = NULL;
+    struct libusb_transfer *in = NULL;
+    struct lusb_exchange x;
+    int status;
+
+    out = libusb_alloc_transfer(0);
+    in  = libusb_alloc_transfer(0);
+    if (out == NULL || in == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto out;
+    }
+
+    x.in        = in;
+    x.remaining = 0;
+    x.completed = 0;
+
+    libusb_fill_bulk_transfer(in, lusb->handle, ep_in,
+                              (unsigned char *) response, (int) len,
+                              lusb_exchange_cb, &x, timeout_ms);
+
+    /* libusb does not modify OUT transfer buffers */
+    libusb_fill_bulk_transfer(out, lusb->handle, ep_out,
+                              (unsigned char *) request, (int) len,
+                              lusb_exchange_cb, &x, timeout_ms);
+
+    status = libusb_submit_transfer(in);
+    if (status != 0) {
+        status = error_conv(status);
+        goto out;
+    }
+    x.remaining++;
+
+    status = libusb_submit_transfer(out);
+    if (status != 0) {
+        libusb_cancel_transfer(in);
+    } else {
+        x.remaining++;
+    }
+
+    while (!x.completed) {
+        int event_status = libusb_handle_events_completed(lusb->context,
+                                                          &x.completed);
+
+        if (event_status < 0 && event_status != LIBUSB_ERROR_INTERRUPTED) {
+            log_debug("Failed to handle exchange events: %s\n",
+                      libusb_error_name(event_status));
+
+            /* Cancel whatever remains, and wait for the cancellations to
+             * complete before releasing the transfers */
+            libusb_cancel_transfer(out);
+            libusb_cancel_transfer(in);
+        }
+    }
+
+    if (status != 0) {
+        /* The request was never submitted */
+        status = error_conv(status);
+    } else {
+        status = lusb_exchange_status(out, len);
+        if (status == 0) {
+            status = lusb_exchange_status(in, len);
+        }
+    }
+
+out:
+    libusb_free_transfer(out);
+    libusb_free_transfer(in);
+    return status;
+}
+
+/* State shared by the transfers of lusb_bulk_write_stream() */
+struct lusb_write_stream {
+    struct libusb_transfer **transfers;
+    unsigned int num_transfers;
+
+    int (*fill)(void *arg, uint8_t *buf, size_t len);
+    void *arg;
+
+    size_t remaining;           /* # of bytes yet to be submitted */
+    size_t transfer_size;
+    unsigned int in_flight;
+    int status;                 /* First error encountered */
+    int completed;              /* Set when no transfers remain in flight */
+};
+
+static int lusb_write_stream_submit(struct lusb_write_stream *w,
+                                    struct libusb_transfer *transfer)
+{
+    const size_t len = min_sz(w->remaining, w->transfer_size);
+    int status;
+
+    status = w->fill(w->arg, transfer->buffer, len);
+    if (status != 0) {
+        return status;
+    }
+
+    transfer->length = (int) len;
+
+    status = libusb_submit_transfer(transfer);
+    if (status != 0) {
+        return error_conv(status);
+    }
+
+    w->remaining -= len;
+    w->in_flight++;
+    return 0;
+}
+
+static void lusb_write_stream_cancel(struct lusb_write_stream *w)
+{
+    unsigned int i;
+
+    for (i = 0; i < w->num_transfers; i++) {
+        libusb_cancel_transfer(w->transfers[i]);
+    }
+}
+
+/* Completed transfers are refilled and resubmitted from within the event
+ * handler, so reading the next piece overlaps the transfer of those still in
+ * flight. */
+static void LIBUSB_CALL lusb_write_stream_cb(struct libusb_transfer *transfer)
+{
+    struct lusb_write_stream *w =
+        (struct lusb_write_stream *) transfer->user_data;
+
+    w->in_flight--;
+
+    if (w->status == 0) {
+        w->status = lusb_exchange_status(transfer, (uint32_t) transfer->length);
+
+        if (w->status == 0 && w->remaining > 0) {
+            w->status = lusb_write_stream_submit(w, transfer);
+        }
+
+        if (w->status != 0) {
+            lusb_write_stream_cancel(w);
+        }
+    }
+
+    if (w->in_flight == 0) {
+        w->completed = 1;
+    }
+}
+
+static int lusb_bulk_write_stream(void *driver, uint8_t endpoint, size_t len,
+                                  size_t transfer_size,
+                                  unsigned int num_transfers,
+                                  int (*fill)(void *arg, uint8_t *buf,
+                                              size_t len),
+                                  void *arg, uint32_t timeout_ms)
+{
+    struct bladerf_lusb *lusb = (struct bladerf_lusb *) driver;
+    struct lusb_write_stream w;
+    unsigned int i;
+
+    if (transfer_size == 0 || transfer_size > INT_MAX || num_transfers == 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    memset(&w, 0, sizeof(w));
+    w.fill          = fill;
+    w.arg           = arg;
+    w.remaining     = len;
+    w.transfer_size = transfer_size;
+
+    w.transfers = calloc(num_transfers, sizeof(w.transfers[0]));
+    if (w.transfers == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    for (i = 0; i < num_transfers; i++) {
+        unsigned char *buf = malloc(transfer_size);
+
+        w.transfers[i] = libusb_alloc_transfer(0);
+        if (w.transfers[i] == NULL || buf == NULL) {
+            libusb_free_transfer(w.transfers[i]);
+            free(buf);
+            w.status = BLADERF_ERR_MEM;
+            goto out;
+        }
+
+        libusb_fill_bulk_transfer(w.transfers[i], lusb->handle, endpoint,
+                                  buf, 0, lusb_write_stream_cb, &w,
+                                  timeout_ms);
+        w.num_transfers++;
+    }
+
+    for (i = 0; i < w.num_transfers && w.remaining > 0 && w.status == 0; i++) {
+        w.status = lusb_write_stream_submit(&w, w.transfers[i]);
+    }
+
+    if (w.status != 0) {
+        lusb_write_stream_cancel(&w);
+    }
+
+    w.completed = (w.in_flight == 0);
+
+    while (!w.completed) {
+        int event_status = libusb_handle_events_completed(lusb->context,
+                                                          &w.completed);
+
+        if (event_status < 0 && event_status != LIBUSB_ERROR_INTERRUPTED) {
+            log_debug("Failed to handle write stream events: %s\n",
+                      libusb_error_name(event_status));
+
+            if (w.status == 0) {
+                w.status = error_conv(event_status);
+            }
+
+            lusb_write_stream_cancel(&w);
+        }
+    }
+
+out:
+    for (i = 0; i < w.num_transfers; i++) {
+        free(w.transfers[i]->buffer);
+        libusb_free_transfer(w.transfers[i]);
+    }
+
+    free(w.transfers);
+    return w.status;
+}
+
+/* State shared by the transfers of lusb_control_transfers() */
+struct lusb_control_batch {
+    struct libusb_transfer **transfers;
+    size_t *req_index;          /* Request carried by each transfer */
+    unsigned int num_transfers;
+
+    const struct usb_control_request *reqs;
+    size_t count;
+    size_t next;                /* Next request to submit */
+    unsigned int in_flight;
+    int status;                 /* First error encountered */
+    int completed;              /* Set when no transfers remain in flight */
+};
+
+static int lusb_control_batch_submit(struct lusb_control_batch *b,
+                                     unsigned int slot)
+{
+    struct libusb_transfer *transfer = b->transfers[slot];
+    const struct usb_control_request *req = &b->reqs[b->next];
+    int status;
+
+    libusb_fill_control_setup(transfer->buffer,
+                              bm_request_type(req->target_type,
+                                              req->req_type, req->direction),
+                              req->request, req->wvalue, req->windex,
+                              (uint16_t) req->buffer_len);
+
+    if (req->direction == USB_DIR_HOST_TO_DEVICE && req->buffer_len > 0) {
+        memcpy(libusb_control_transfer_get_data(transfer), req->buffer,
+               req->buffer_len);
+    }
+
+    transfer->length = (int) (LIBUSB_CONTROL_SETUP_SIZE + req->buffer_len);
+
+    status = libusb_submit_transfer(transfer);
+    if (status != 0) {
+        return error_conv(status);
+    }
+
+    b->req_index[slot] = b->next++;
+    b->in_flight++;
+    return 0;
+}
+
+static void lusb_control_batch_cancel(struct lusb_control_batch *b)
+{
+    unsigned int i;
+
+    for (i = 0; i < b->num_transfers; i++) {
+        libusb_cancel_transfer(b->transfers[i]);
+    }
+}
+
+/* Transfers on the default control pipe complete in the order submitted, so
+ * each completed transfer is reused for the next request straight away. */
+static void LIBUSB_CALL lusb_control_batch_cb(struct libusb_transfer *transfer)
+{
+    struct lusb_control_batch *b =
+        (struct lusb_control_batch *) transfer->user_data;
+    unsigned int slot;
+
+    for (slot = 0; slot < b->num_transfers; slot++) {
+        if (b->transfers[slot] == transfer) {
+            break;
+        }
+    }
+
+    b->in_flight--;
+
+    if (b->status == 0) {
+        const struct usb_control_request *req = &b->reqs[b->req_index[slot]];
+
+        b->status = lusb_exchange_status(transfer, req->buffer_len);
 
-        case USB_TARGET_ENDPOINT:
-            ret |= LIBUSB_RECIPIENT_ENDPOINT;
-            break;
+        if (b->status == 0 && req->direction == USB_DIR_DEVICE_TO_HOST) {
+            memcpy(req->buffer, libusb_control_transfer_get_data(transfer),
+                   req->buffer_len);
+        }
 
-        default:
-            ret |= LIBUSB_RECIPIENT_OTHER;
+        if (b->status == 0 && b->next < b->count) {
+            b->status = lusb_control_batch_submit(b, slot);
+        }
 
+        if (b->status != 0) {
+            lusb_control_batch_cancel(b);
+        }
     }
 
-    switch (req_type) {
-        case USB_REQUEST_STANDARD:
-            ret |= LIBUSB_REQUEST_TYPE_STANDARD;
-            break;
+    if (b->in_flight == 0) {
+        b->completed = 1;
+    }
+}
 
-        case USB_REQUEST_CLASS:
-            ret |= LIBUSB_REQUEST_TYPE_CLASS;
-            break;
+static int lusb_control_transfers(void *driver,
+                                  const struct usb_control_request *reqs,
+                                  size_t count, unsigned int num_transfers,
+                                  uint32_t timeout_ms)
+{
+    struct bladerf_lusb *lusb = (struct bladerf_lusb *) driver;
+    struct lusb_control_batch b;
+    uint32_t max_len = 0;
+    unsigned int i;
+    size_t r;
 
-        case USB_REQUEST_VENDOR:
-            ret |= LIBUSB_REQUEST_TYPE_VENDOR;
-            break;
+    if (num_transfers == 0) {
+        return BLADERF_ERR_INVAL;
     }
 
-    switch (direction) {
-        case USB_DIR_HOST_TO_DEVICE:
-            ret |= LIBUSB_ENDPOINT_OUT;
-            break;
+    for (r = 0; r < count; r++) {
+        if (reqs[r].buffer_len > UINT16_MAX) {
+            return BLADERF_ERR_INVAL;
+        }
+        max_len = u32_max(max_len, reqs[r].buffer_len);
+    }
 
-        case USB_DIR_DEVICE_TO_HOST:
-            ret |= LIBUSB_ENDPOINT_IN;
-            break;
+    memset(&b, 0, sizeof(b));
+    b.reqs  = reqs;
+    b.count = count;
+
+    b.transfers = calloc(num_transfers, sizeof(b.transfers[0]));
+    b.req_index = calloc(num_transfers, sizeof(b.req_index[0]));
+    if (b.transfers == NULL || b.req_index == NULL) {
+        b.status = BLADERF_ERR_MEM;
+        goto out;
     }
 
-    return ret;
-}
+    for (i = 0; i < num_transfers; i++) {
+        unsigned char *buf = calloc(1, LIBUSB_CONTROL_SETUP_SIZE + max_len);
 
-static int lusb_control_transfer(void *driver,
-                                 usb_target target_type, usb_request req_type,
-                                 usb_direction dir, uint8_t request,
-                                 uint16_t wvalue, uint16_t windex,
-                                 void *buffer, uint32_t buffer_len,
-                                 uint32_t timeout_ms)
-{
+        b.transfers[i] = libusb_alloc_transfer(0);
+        if (b.transfers[i] == NULL || buf == NULL) {
+            libusb_free_transfer(b.transfers[i]);
+            free(buf);
+            b.status = BLADERF_ERR_MEM;
+            goto out;
+        }
 
-    int status;
-    struct bladerf_lusb *lusb = (struct bladerf_lusb *) driver;
-    const uint8_t bm_req_type = bm_request_type(target_type, req_type, dir);
+        libusb_fill_control_transfer(b.transfers[i], lusb->handle, buf,
+                                     lusb_control_batch_cb, &b, timeout_ms);
+        b.num_transfers++;
+    }
 
-    status = libusb_control_transfer(lusb->handle,
-                                     bm_req_type, request,
-                                     wvalue, windex,
-                                     buffer, buffer_len,
-                                     timeout_ms);
+    for (i = 0; i < b.num_transfers && b.next < count && b.status == 0; i++) {
+        b.status = lusb_control_batch_submit(&b, i);
+    }
 
-    if (status >= 0 && (uint32_t)status == buffer_len) {
-        status = 0;
-    } else {
-        log_debug("%s failed: status = %d\n", __FUNCTION__, status);
+    if (b.status != 0) {
+        lusb_control_batch_cancel(&b);
     }
 
-    return error_conv(status);
-}
+    b.completed = (b.in_flight == 0);
 
-static int lusb_bulk_transfer(void *driver, uint8_t endpoint, void *buffer,
-                              uint32_t buffer_len, uint32_t timeout_ms)
-{
-    int status;
-    int n_transferred;
-    struct bladerf_lusb *lusb = (struct bladerf_lusb *) driver;
+    while (!b.completed) {
+        int event_status = libusb_handle_events_completed(lusb->context,
+                                                          &b.completed);
 
-    status = libusb_bulk_transfer(lusb->handle, endpoint, buffer, buffer_len,
-                                  &n_transferred, timeout_ms);
+        if (event_status < 0 && event_status != LIBUSB_ERROR_INTERRUPTED) {
+            log_debug("Failed to handle control transfer events: %s\n",
+                      libusb_error_name(event_status));
 
-    status = error_conv(status);
-    if (status == 0 && ((uint32_t)n_transferred != buffer_len)) {
-        log_debug("Short bulk transfer: requested=%u, transferred=%u\n",
-                  buffer_len, n_transferred);
-        status = BLADERF_ERR_IO;
+            if (b.status == 0) {
+                b.status = error_conv(event_status);
+            }
+
+            lusb_control_batch_cancel(&b);
+        }
     }
 
-    return status;
+out:
+    if (b.transfers != NULL) {
+        for (i = 0; i < b.num_transfers; i++) {
+            free(b.transfers[i]->buffer);
+            libusb_free_transfer(b.transfers[i]);
+        }
+    }
+
+    free(b.transfers);
+    free(b.req_index);
+    return b.status;
 }
 
 static int lusb_get_string_descriptor(void *driver, uint8_t index,
@@ -1004,57 +2111,201 @@ static inline void cancel_all_transfers(struct bladerf_stream *stream)
     struct lusb_stream_data *stream_data = stream->backend_data;
 
     for (i = 0; i < stream_data->num_transfers; i++) {
-        if (stream_data->transfer_status[i] == TRANSFER_IN_FLIGHT) {
+        const transfer_status ts =
+            ATOMIC_LOAD(&stream_data->transfer_status[i]);
+
+        /* A transfer pending cancellation may have been claimed and
+         * submitted after the previous attempt, so it's retried as well */
+        if (ts == TRANSFER_IN_FLIGHT || ts == TRANSFER_CANCEL_PENDING) {
             status = libusb_cancel_transfer(stream_data->transfers[i]);
             if (status < 0 && status != LIBUSB_ERROR_NOT_FOUND) {
                 log_error("Error canceling transfer (%d): %s\n",
                         status, libusb_error_name(status));
             } else {
-                stream_data->transfer_status[i] = TRANSFER_CANCEL_PENDING;
+                /* The transfer may have completed in the meantime */
+                ATOMIC_CAS(&stream_data->transfer_status[i],
+                           TRANSFER_IN_FLIGHT, TRANSFER_CANCEL_PENDING);
             }
         }
     }
 }
 
-static inline size_t transfer_idx(struct lusb_stream_data *stream_data,
-                                  struct libusb_transfer *transfer)
+static void LIBUSB_CALL lusb_stream_cb(struct libusb_transfer *transfer);
+
+/* Claim the oldest available transfer, marking it in flight. Returns the
+ * transfer's index, or UINT_MAX if none are available.
+ * Assumes stream->lock is held. */
+static size_t claim_transfer(struct lusb_stream_data *stream_data)
 {
     size_t i;
-    for (i = 0; i < stream_data->num_transfers; i++) {
-        if (stream_data->transfers[i] == transfer) {
-            return i;
-        }
+
+    if (ATOMIC_LOAD(&stream_data->num_avail) == 0) {
+        return UINT_MAX;
+    }
+
+    i = stream_data->avail[stream_data->avail_head];
+    stream_data->avail_head =
+        (stream_data->avail_head + 1) % stream_data->num_transfers;
+
+    assert(ATOMIC_LOAD(&stream_data->transfer_status[i]) == TRANSFER_AVAIL);
+    ATOMIC_STORE(&stream_data->transfer_status[i], TRANSFER_IN_FLIGHT);
+    ATOMIC_DEC(&stream_data->num_avail);
+
+    stream_data->ctx[i].seq = stream_data->claim_seq++;
+
+    return i;
+}
+
+/* Return a transfer to the ring of available transfers, either upon its
+ * completion or when it could not be submitted.
+ * Assumes stream->lock is held. */
+static void release_transfer(struct bladerf_stream *stream, size_t i)
+{
+    struct lusb_stream_data *stream_data = stream->backend_data;
+    const size_t tail = (stream_data->avail_head +
+                         ATOMIC_LOAD(&stream_data->num_avail)) %
+                        stream_data->num_transfers;
+
+    stream_data->avail[tail] = (unsigned int)i;
+
+    ATOMIC_STORE(&stream_data->transfer_status[i], TRANSFER_AVAIL);
+    ATOMIC_INC(&stream_data->num_avail);
+    pthread_cond_signal(&stream->can_submit_buffer);
+}
+
+/* Submit a claimed transfer. This must be called WITHOUT stream->lock held.
+ *
+ * The transfer's completion callback may execute before this returns. Upon
+ * failure, the caller is responsible for returning the transfer via
+ * release_transfer(). */
+static int submit_transfer(struct bladerf_stream *stream, size_t i,
+                           void *buffer, size_t len)
+{
+    int status;
+    struct bladerf_lusb *lusb = lusb_backend(stream->dev);
+    struct lusb_stream_data *stream_data = stream->backend_data;
+    struct libusb_transfer *transfer = stream_data->transfers[i];
+    const unsigned char ep =
+        (stream->layout & BLADERF_DIRECTION_MASK) == BLADERF_TX ? SAMPLE_EP_OUT : SAMPLE_EP_IN;
+
+    /* cancel_all_transfers() may have flagged the transfer between it being
+     * claimed and submitted. It is canceled again at the next completion. */
+    assert(ATOMIC_LOAD(&stream_data->transfer_status[i]) ==
+               TRANSFER_IN_FLIGHT ||
+           ATOMIC_LOAD(&stream_data->transfer_status[i]) ==
+               TRANSFER_CANCEL_PENDING);
+    assert(len <= INT_MAX);
+
+    libusb_fill_bulk_transfer(transfer,
+                              lusb->handle,
+                              ep,
+                              buffer,
+                              (int)len,
+                              lusb_stream_cb,
+                              &stream_data->ctx[i],
+                              stream->transfer_timeout);
+
+    stream_data->submit_time_us[i] = time_now_us();
+
+    TRACE_POINT3(xfer_submit, (uintptr_t)stream, (uintptr_t)buffer, len);
+
+    status = libusb_submit_transfer(transfer);
+    if (status != 0) {
+        log_error("Failed to submit transfer in %s: %s\n",
+                  __FUNCTION__, libusb_error_name(status));
+    }
+
+    return error_conv(status);
+}
+
+/* Claim a transfer and submit it. Assumes stream->lock is held, and that a
+ * transfer is available. The lock is released while submitting. */
+static int claim_and_submit_transfer(struct bladerf_stream *stream,
+                                     void *buffer, size_t len)
+{
+    int status;
+    const size_t i = claim_transfer(stream->backend_data);
+
+    if (i == UINT_MAX) {
+        assert(!"No transfer available");
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    MUTEX_UNLOCK(&stream->lock);
+    status = submit_transfer(stream, i, buffer, len);
+    MUTEX_LOCK(&stream->lock);
+
+    if (status != 0) {
+        release_transfer(stream, i);
     }
 
-    return UINT_MAX;
+    return status;
 }
 
-static int submit_transfer(struct bladerf_stream *stream, void *buffer, size_t len);
+/* Check to see if all the transfers have been cancelled, and if so, clean up
+ * the stream. Assumes stream->lock is held. */
+static void check_stream_shutdown(struct bladerf_stream *stream)
+{
+    struct lusb_stream_data *stream_data = stream->backend_data;
+
+    if (stream->state == STREAM_SHUTTING_DOWN) {
+        /* We know we're done when all of our transfers have returned to their
+         * "available" states */
+        if (ATOMIC_LOAD(&stream_data->num_avail) ==
+                stream_data->num_transfers) {
+            stream->state = STREAM_DONE;
+        } else {
+            cancel_all_transfers(stream);
+        }
+    }
+}
 
 static void LIBUSB_CALL lusb_stream_cb(struct libusb_transfer *transfer)
 {
-    struct bladerf_stream *stream = transfer->user_data;
+    struct lusb_transfer_ctx *ctx = transfer->user_data;
+    struct bladerf_stream *stream = ctx->stream;
     void *next_buffer             = NULL;
+    size_t next_len               = 0;
+    bool resubmit                 = false;
     struct bladerf_metadata metadata;
     struct lusb_stream_data *stream_data = stream->backend_data;
-    size_t transfer_i;
+    const size_t transfer_i = ctx->idx;
+    int status;
+
+    TRACE_POINT4(xfer_complete, (uintptr_t)stream, (uintptr_t)transfer->buffer,
+                 transfer->status, transfer->actual_length);
 
-    /* Currently unused - zero out for out own debugging sanity... */
+    /* Only the host arrival time is provided to the callback */
     memset(&metadata, 0, sizeof(metadata));
+    metadata.host_timestamp = wallclock_get_monotonic_nsec();
 
     MUTEX_LOCK(&stream->lock);
 
-    transfer_i = transfer_idx(stream_data, transfer);
-    assert(stream_data->transfer_status[transfer_i] == TRANSFER_IN_FLIGHT ||
-           stream_data->transfer_status[transfer_i] == TRANSFER_CANCEL_PENDING);
-
-    if (transfer_i >= stream_data->num_transfers) {
-        log_error("Unable to find transfer\n");
-        stream->state = STREAM_SHUTTING_DOWN;
+    assert(transfer_i < stream_data->num_transfers &&
+           stream_data->transfers[transfer_i] == transfer);
+    assert(ATOMIC_LOAD(&stream_data->transfer_status[transfer_i]) ==
+               TRANSFER_IN_FLIGHT ||
+           ATOMIC_LOAD(&stream_data->transfer_status[transfer_i]) ==
+               TRANSFER_CANCEL_PENDING);
+
+    if (ctx->seq < stream_data->complete_seq) {
+        if (stream_data->out_of_order_event == false) {
+            log_warning("Transfer callback occurred out of order. "
+                        "(Warning only this time.)\n");
+            stream_data->out_of_order_event = true;
+        }
     } else {
-        stream_data->transfer_status[transfer_i] = TRANSFER_AVAIL;
-        stream_data->num_avail++;
-        pthread_cond_signal(&stream->can_submit_buffer);
+        stream_data->complete_seq = ctx->seq;
+    }
+
+    if (transfer->status == LIBUSB_TRANSFER_COMPLETED) {
+        const uint64_t submitted = stream_data->submit_time_us[transfer_i];
+        const uint64_t now = time_now_us();
+
+        async_record_transfer(stream,
+                              (submitted != 0 && now > submitted) ?
+                                  now - submitted : 0,
+                              transfer->actual_length < transfer->length);
     }
 
     /* Check to see if the transfer has been cancelled or errored */
@@ -1101,148 +2352,70 @@ static void LIBUSB_CALL lusb_stream_cb(struct libusb_transfer *transfer)
         }
     }
 
-    if (stream->state == STREAM_RUNNING) {
-        if (stream->format == BLADERF_FORMAT_PACKET_META) {
-            /* Call user callback requesting more data to transmit */
-            next_buffer = stream->cb(
-                stream->dev, stream, &metadata, transfer->buffer,
-                bytes_to_samples(stream->format, transfer->actual_length), stream->user_data);
-        } else {
-            /* Sanity check for debugging purposes */
-            if (transfer->length != transfer->actual_length) {
-                log_warning("Received short transfer\n");
-            }
-
-            /* Call user callback requesting more data to transmit */
-            next_buffer = stream->cb(
-                stream->dev, stream, &metadata, transfer->buffer,
-                bytes_to_samples(stream->format, transfer->actual_length), stream->user_data);
-        }
-
-        if (next_buffer == BLADERF_STREAM_SHUTDOWN) {
-            stream->state = STREAM_SHUTTING_DOWN;
-        } else if (next_buffer != BLADERF_STREAM_NO_DATA) {
-            int status;
-            if((stream->layout & BLADERF_DIRECTION_MASK) == BLADERF_TX
-                  && stream->format == BLADERF_FORMAT_PACKET_META) {
-               status = submit_transfer(stream, next_buffer, metadata.actual_count);
-            } else {
-               status = submit_transfer(stream, next_buffer, async_stream_buf_bytes(stream));
-            }
-            if (status != 0) {
-                /* If this fails, we probably have a serious problem...so just
-                 * shut it down. */
-                stream->state = STREAM_SHUTTING_DOWN;
-            }
-        }
-    }
-
-
-    /* Check to see if all the transfers have been cancelled,
-     * and if so, clean up the stream */
-    if (stream->state == STREAM_SHUTTING_DOWN) {
-        /* We know we're done when all of our transfers have returned to their
-         * "available" states */
-        if (stream_data->num_avail == stream_data->num_transfers) {
-            stream->state = STREAM_DONE;
-        } else {
-            cancel_all_transfers(stream);
-        }
+    /* The transfer is only returned to the available ring once the user
+     * callback is finished with it. Until then, the stream cannot be
+     * considered done, and may not be freed from underneath the callback. */
+    if (stream->state != STREAM_RUNNING) {
+        release_transfer(stream, transfer_i);
+        check_stream_shutdown(stream);
+        MUTEX_UNLOCK(&stream->lock);
+        return;
     }
 
     MUTEX_UNLOCK(&stream->lock);
-}
 
-static inline struct libusb_transfer *
-get_next_available_transfer(struct lusb_stream_data *stream_data)
-{
-    unsigned int n;
-    size_t i = stream_data->i;
+    /* Sanity check for debugging purposes */
+    if (stream->format != BLADERF_FORMAT_PACKET_META &&
+        transfer->length != transfer->actual_length) {
+        log_warning("Received short transfer\n");
+    }
 
-    for (n = 0; n < stream_data->num_transfers; n++) {
-        if (stream_data->transfer_status[i] == TRANSFER_AVAIL) {
+    /* Call user callback requesting more data to transmit, without
+     * stream->lock held, so that other threads may submit buffers or
+     * query the stream in the meantime */
+    next_buffer = async_stream_cb(
+        stream, &metadata, transfer->buffer,
+        bytes_to_samples(stream->format, transfer->actual_length));
 
-            if (stream_data->i != i &&
-                stream_data->out_of_order_event == false) {
+    MUTEX_LOCK(&stream->lock);
 
-                log_warning("Transfer callback occurred out of order. "
-                            "(Warning only this time.)\n");
-                stream_data->out_of_order_event = true;
-            }
+    if (next_buffer == BLADERF_STREAM_SHUTDOWN) {
+        stream->state = STREAM_SHUTTING_DOWN;
+    }
 
-            stream_data->i = i;
-            return stream_data->transfers[i];
+    if (stream->state == STREAM_RUNNING &&
+        next_buffer != BLADERF_STREAM_SHUTDOWN &&
+        next_buffer != BLADERF_STREAM_NO_DATA) {
+        if ((stream->layout & BLADERF_DIRECTION_MASK) == BLADERF_TX) {
+            next_len = async_stream_tx_bytes(stream, &metadata);
+        } else {
+            next_len = async_stream_buf_bytes(stream);
         }
 
-        i = (i + 1) % stream_data->num_transfers;
+        /* Resubmit the transfer we still hold, rather than returning it and
+         * claiming another */
+        stream_data->ctx[transfer_i].seq = stream_data->claim_seq++;
+        resubmit = true;
+    } else {
+        release_transfer(stream, transfer_i);
     }
 
-    return NULL;
-}
-
-/* Precondition: A transfer is available. */
-static int submit_transfer(struct bladerf_stream *stream, void *buffer, size_t len)
-{
-    int status;
-    struct bladerf_lusb *lusb = lusb_backend(stream->dev);
-    struct lusb_stream_data *stream_data = stream->backend_data;
-    struct libusb_transfer *transfer;
-    const size_t bytes_per_buffer = async_stream_buf_bytes(stream);
-    size_t prev_idx;
-    const unsigned char ep =
-        (stream->layout & BLADERF_DIRECTION_MASK) == BLADERF_TX ? SAMPLE_EP_OUT : SAMPLE_EP_IN;
-
-    transfer = get_next_available_transfer(stream_data);
-    assert(transfer != NULL);
-
-    assert(bytes_per_buffer <= INT_MAX);
-    libusb_fill_bulk_transfer(transfer,
-                              lusb->handle,
-                              ep,
-                              buffer,
-                              (int)len,
-                              lusb_stream_cb,
-                              stream,
-                              stream->transfer_timeout);
+    check_stream_shutdown(stream);
 
-    prev_idx = stream_data->i;
-    stream_data->transfer_status[stream_data->i] = TRANSFER_IN_FLIGHT;
-    stream_data->i = (stream_data->i + 1) % stream_data->num_transfers;
-    assert(stream_data->num_avail != 0);
-    stream_data->num_avail--;
-
-    /* FIXME We have an inherent issue here with lock ordering between
-     *       stream->lock and libusb's underlying event lock, so we
-     *       have to drop the stream->lock as a workaround.
-     *
-     *       This implies that a callback can potentially execute,
-     *       including a callback for this transfer. Therefore, the transfer
-     *       has been setup and its metadata logged.
-     *
-     *       Ultimately, we need to review our async scheme and associated
-     *       lock schemes.
-     */
     MUTEX_UNLOCK(&stream->lock);
-    status = libusb_submit_transfer(transfer);
-    MUTEX_LOCK(&stream->lock);
-
-    if (status != 0) {
-        log_error("Failed to submit transfer in %s: %s\n",
-                  __FUNCTION__, libusb_error_name(status));
 
-        /* We need to undo the metadata we updated prior to dropping
-         * the lock and attempting to submit the transfer */
-        assert(stream_data->transfer_status[prev_idx] == TRANSFER_IN_FLIGHT);
-        stream_data->transfer_status[prev_idx] = TRANSFER_AVAIL;
-        stream_data->num_avail++;
-        if (stream_data->i == 0) {
-            stream_data->i = stream_data->num_transfers - 1;
-        } else {
-            stream_data->i--;
+    if (resubmit) {
+        status = submit_transfer(stream, transfer_i, next_buffer, next_len);
+        if (status != 0) {
+            /* If this fails, we probably have a serious problem...so just
+             * shut it down. */
+            MUTEX_LOCK(&stream->lock);
+            release_transfer(stream, transfer_i);
+            stream->state = STREAM_SHUTTING_DOWN;
+            check_stream_shutdown(stream);
+            MUTEX_UNLOCK(&stream->lock);
         }
     }
-
-    return error_conv(status);
 }
 
 static int lusb_init_stream(void *driver, struct bladerf_stream *stream,
@@ -1261,10 +2434,15 @@ static int lusb_init_stream(void *driver, struct bladerf_stream *stream,
     /* Backend stream information */
     stream->backend_data = stream_data;
     stream_data->transfers = NULL;
+    stream_data->ctx = NULL;
+    stream_data->avail = NULL;
     stream_data->transfer_status = NULL;
+    stream_data->submit_time_us = NULL;
     stream_data->num_transfers = num_transfers;
     stream_data->num_avail = 0;
-    stream_data->i = 0;
+    stream_data->avail_head = 0;
+    stream_data->claim_seq = 0;
+    stream_data->complete_seq = 0;
     stream_data->out_of_order_event = false;
 
     stream_data->transfers =
@@ -1276,6 +2454,20 @@ static int lusb_init_stream(void *driver, struct bladerf_stream *stream,
         goto error;
     }
 
+    stream_data->ctx = calloc(num_transfers, sizeof(stream_data->ctx[0]));
+    if (stream_data->ctx == NULL) {
+        log_error("Failed to allocate libusb transfer contexts\n");
+        status = BLADERF_ERR_MEM;
+        goto error;
+    }
+
+    stream_data->avail = calloc(num_transfers, sizeof(stream_data->avail[0]));
+    if (stream_data->avail == NULL) {
+        log_error("Failed to allocate libusb transfer ring\n");
+        status = BLADERF_ERR_MEM;
+        goto error;
+    }
+
     stream_data->transfer_status =
         calloc(num_transfers, sizeof(transfer_status));
 
@@ -1285,6 +2477,13 @@ static int lusb_init_stream(void *driver, struct bladerf_stream *stream,
         goto error;
     }
 
+    stream_data->submit_time_us = calloc(num_transfers, sizeof(uint64_t));
+    if (stream_data->submit_time_us == NULL) {
+        log_error("Failed to allocate libusb transfer timestamp array\n");
+        status = BLADERF_ERR_MEM;
+        goto error;
+    }
+
     /* Create the libusb transfers */
     for (i = 0; i < stream_data->num_transfers; i++) {
         stream_data->transfers[i] = libusb_alloc_transfer(0);
@@ -1307,6 +2506,9 @@ static int lusb_init_stream(void *driver, struct bladerf_stream *stream,
             status = BLADERF_ERR_MEM;
             break;
         } else {
+            stream_data->ctx[i].stream = stream;
+            stream_data->ctx[i].idx = i;
+            stream_data->avail[i] = (unsigned int)i;
             stream_data->transfer_status[i] = TRANSFER_AVAIL;
             stream_data->num_avail++;
         }
@@ -1314,7 +2516,10 @@ static int lusb_init_stream(void *driver, struct bladerf_stream *stream,
 
 error:
     if (status != 0) {
+        free(stream_data->submit_time_us);
         free(stream_data->transfer_status);
+        free(stream_data->avail);
+        free(stream_data->ctx);
         free(stream_data->transfers);
         free(stream_data);
         stream->backend_data = NULL;
@@ -1343,17 +2548,22 @@ static int lusb_stream(void *driver, struct bladerf_stream *stream,
     /* Set up initial set of buffers */
     for (i = 0; i < stream_data->num_transfers; i++) {
         if ((layout & BLADERF_DIRECTION_MASK) == BLADERF_TX) {
+            /* Transfers submitted on previous iterations may already be
+             * completing, so serialize against their callbacks */
+            MUTEX_LOCK(&stream->cb_lock);
             buffer = stream->cb(dev,
                                 stream,
                                 &metadata,
                                 NULL,
                                 stream->samples_per_buffer,
                                 stream->user_data);
+            MUTEX_UNLOCK(&stream->cb_lock);
 
             if (buffer == BLADERF_STREAM_SHUTDOWN) {
                 /* If we have transfers in flight and the user prematurely
                  * cancels the stream, we'll start shutting down */
-                if (stream_data->num_avail != stream_data->num_transfers) {
+                if (ATOMIC_LOAD(&stream_data->num_avail) !=
+                        stream_data->num_transfers) {
                     stream->state = STREAM_SHUTTING_DOWN;
                 } else {
                     /* No transfers have been shipped out yet so we can
@@ -1370,11 +2580,12 @@ static int lusb_stream(void *driver, struct bladerf_stream *stream,
         }
 
         if (buffer != BLADERF_STREAM_NO_DATA) {
-            if((layout & BLADERF_DIRECTION_MASK) == BLADERF_TX
-                  && stream->format == BLADERF_FORMAT_PACKET_META) {
-               status = submit_transfer(stream, buffer, metadata.actual_count);
+            if ((layout & BLADERF_DIRECTION_MASK) == BLADERF_TX) {
+                status = claim_and_submit_transfer(stream, buffer,
+                            async_stream_tx_bytes(stream, &metadata));
             } else {
-               status = submit_transfer(stream, buffer, async_stream_buf_bytes(stream));
+                status = claim_and_submit_transfer(stream, buffer,
+                            async_stream_buf_bytes(stream));
             }
 
             /* If we failed to submit any transfers, cancel everything in
@@ -1388,6 +2599,9 @@ static int lusb_stream(void *driver, struct bladerf_stream *stream,
     }
     MUTEX_UNLOCK(&stream->lock);
 
+    /* Obtain the initial buffers of a batched TX stream */
+    async_dispatch_batch(stream);
+
     /* This loop is required so libusb can do callbacks and whatnot */
     while (stream->state != STREAM_DONE) {
         status = libusb_handle_events_timeout(lusb->context, &tv);
@@ -1397,6 +2611,8 @@ static int lusb_stream(void *driver, struct bladerf_stream *stream,
                         "%d: %s\n", status, libusb_error_name(status));
             status = error_conv(status);
         }
+
+        async_dispatch_batch(stream);
     }
 
     return status;
@@ -1412,7 +2628,8 @@ int lusb_submit_stream_buffer(void *driver, struct bladerf_stream *stream,
     struct timespec timeout_abs;
 
     if (buffer == BLADERF_STREAM_SHUTDOWN) {
-        if (stream_data->num_avail == stream_data->num_transfers) {
+        if (ATOMIC_LOAD(&stream_data->num_avail) ==
+                stream_data->num_transfers) {
             stream->state = STREAM_DONE;
         } else {
             stream->state = STREAM_SHUTTING_DOWN;
@@ -1421,7 +2638,7 @@ int lusb_submit_stream_buffer(void *driver, struct bladerf_stream *stream,
         return 0;
     }
 
-    if (stream_data->num_avail == 0) {
+    if (ATOMIC_LOAD(&stream_data->num_avail) == 0) {
         if (nonblock) {
             log_debug("Non-blocking buffer submission requested, but no "
                       "transfers are currently available.\n");
@@ -1435,13 +2652,15 @@ int lusb_submit_stream_buffer(void *driver, struct bladerf_stream *stream,
                 return BLADERF_ERR_UNEXPECTED;
             }
 
-            while (stream_data->num_avail == 0 && status == 0) {
+            while (ATOMIC_LOAD(&stream_data->num_avail) == 0 &&
+                   status == 0) {
                 status = pthread_cond_timedwait(&stream->can_submit_buffer,
                         &stream->lock,
                         &timeout_abs);
             }
         } else {
-            while (stream_data->num_avail == 0 && status == 0) {
+            while (ATOMIC_LOAD(&stream_data->num_avail) == 0 &&
+                   status == 0) {
                 status = pthread_cond_wait(&stream->can_submit_buffer,
                         &stream->lock);
             }
@@ -1455,8 +2674,59 @@ int lusb_submit_stream_buffer(void *driver, struct bladerf_stream *stream,
     } else if (status != 0) {
         return BLADERF_ERR_UNEXPECTED;
     } else {
-        return submit_transfer(stream, buffer, *length);
+        return claim_and_submit_transfer(stream, buffer, *length);
+    }
+}
+
+/* libusb_dev_mem_alloc() was added in libusb 1.0.21 (API version 0x01000105).
+ * It is currently only implemented for Linux usbfs, where it maps memory that
+ * the kernel can DMA to/from directly, avoiding a copy per transfer. */
+#if defined(LIBUSB_API_VERSION) && (LIBUSB_API_VERSION >= 0x01000105) && \
+    (1 == BLADERF_OS_LINUX)
+#   define LUSB_HAVE_DEV_MEM 1
+#else
+#   define LUSB_HAVE_DEV_MEM 0
+#endif
+
+static int lusb_alloc_stream_buffers(void *driver,
+                                     struct bladerf_stream *stream,
+                                     size_t size,
+                                     void **buf)
+{
+#if LUSB_HAVE_DEV_MEM
+    struct bladerf_lusb *lusb = (struct bladerf_lusb *) driver;
+    unsigned char *mem;
+
+    mem = libusb_dev_mem_alloc(lusb->handle, size);
+    if (mem == NULL) {
+        log_debug("libusb_dev_mem_alloc() failed for %zu bytes; "
+                  "using regular stream buffers.\n", size);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    log_verbose("Allocated %zu bytes of zero-copy stream buffers.\n", size);
+    *buf = mem;
+    return 0;
+#else
+    return BLADERF_ERR_UNSUPPORTED;
+#endif
+}
+
+static void lusb_free_stream_buffers(void *driver,
+                                     struct bladerf_stream *stream,
+                                     void *buf,
+                                     size_t size)
+{
+#if LUSB_HAVE_DEV_MEM
+    struct bladerf_lusb *lusb = (struct bladerf_lusb *) driver;
+    int status;
+
+    status = libusb_dev_mem_free(lusb->handle, (unsigned char *) buf, size);
+    if (status != 0) {
+        log_debug("libusb_dev_mem_free() failed: %s\n",
+                  libusb_error_name(status));
     }
+#endif
 }
 
 static int lusb_deinit_stream(void *driver, struct bladerf_stream *stream)
@@ -1471,7 +2741,10 @@ static int lusb_deinit_stream(void *driver, struct bladerf_stream *stream)
     }
 
     free(stream_data->transfers);
+    free(stream_data->ctx);
+    free(stream_data->avail);
     free(stream_data->transfer_status);
+    free(stream_data->submit_time_us);
     free(stream->backend_data);
 
     stream->backend_data = NULL;
@@ -1480,6 +2753,8 @@ static int lusb_deinit_stream(void *driver, struct bladerf_stream *stream)
 
 static const struct usb_fns libusb_fns = {
     FIELD_INIT(.probe, lusb_probe),
+    FIELD_INIT(.hotplug_start, lusb_hotplug_start),
+    FIELD_INIT(.hotplug_stop, lusb_hotplug_stop),
     FIELD_INIT(.open, lusb_open),
     FIELD_INIT(.close, lusb_close),
     FIELD_INIT(.get_vid_pid, lusb_get_vid_pid),
@@ -1487,9 +2762,15 @@ static const struct usb_fns libusb_fns = {
     FIELD_INIT(.get_handle, lusb_get_handle),
     FIELD_INIT(.get_speed, lusb_get_speed),
     FIELD_INIT(.change_setting, lusb_change_setting),
+    FIELD_INIT(.reset, lusb_reset),
     FIELD_INIT(.control_transfer, lusb_control_transfer),
     FIELD_INIT(.bulk_transfer, lusb_bulk_transfer),
+    FIELD_INIT(.bulk_exchange, lusb_bulk_exchange),
+    FIELD_INIT(.bulk_write_stream, lusb_bulk_write_stream),
+    FIELD_INIT(.control_transfers, lusb_control_transfers),
     FIELD_INIT(.get_string_descriptor, lusb_get_string_descriptor),
+    FIELD_INIT(.alloc_stream_buffers, lusb_alloc_stream_buffers),
+    FIELD_INIT(.free_stream_buffers, lusb_free_stream_buffers),
     FIELD_INIT(.init_stream, lusb_init_stream),
     FIELD_INIT(.stream, lusb_stream),
     FIELD_INIT(.submit_stream_buffer, lusb_submit_stream_buffer),
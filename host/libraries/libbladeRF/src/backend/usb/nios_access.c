@@ -31,9 +31,12 @@
 #include "usb.h"
 #include "nios_access.h"
 #include "nios_pkt_formats.h"
+#include "bladerf2_common.h"
 
 #include "board/board.h"
+#include "helpers/latency_hist.h"
 #include "helpers/version.h"
+#include "helpers/wallclock.h"
 
 #if 0
 static void print_buf(const char *msg, const uint8_t *buf, size_t len)
@@ -53,29 +56,64 @@ static void print_buf(const char *msg, const uint8_t *buf, size_t len)
 #define print_buf(msg, data, len) do {} while(0)
 #endif
 
-/* Buf is assumed to be NIOS_PKT_LEN bytes */
-static int nios_access(struct bladerf *dev, uint8_t *buf)
+/* All of the fixed-width packet formats (8x8 through 32x32) place their
+ * magic and flags bytes at the same offsets, with the same success bit */
+#define NIOS_PKT_IDX_MAGIC      NIOS_PKT_8x8_IDX_MAGIC
+#define NIOS_PKT_IDX_FLAGS      NIOS_PKT_8x8_IDX_FLAGS
+#define NIOS_PKT_FLAG_SUCCESS   NIOS_PKT_8x8_FLAG_SUCCESS
+
+/* RFIC status command, for the system channel. See RFIC_ADDRESS() in
+ * board/bladerf2/rfic_fpga.c */
+#define NIOS_RFIC_STATUS_ADDR \
+    ((BLADERF_RFIC_COMMAND_STATUS & 0xff) | ((BLADERF_CHANNEL_INVALID & 0xf) << 8))
+
+/* Polling for room in a full RFIC write queue while flushing a batch */
+#define NIOS_RFIC_BATCH_FULL_DELAY_US   100
+#define NIOS_RFIC_BATCH_FULL_TRIES      1000
+
+/* Buf is assumed to be NIOS_PKT_LEN bytes, and is overwritten with the
+ * response. If quiet is true, errors are not logged via log_error. */
+static int nios_exchange_usb(struct bladerf *dev, uint8_t *buf, bool quiet)
 {
     struct bladerf_usb *usb = dev->backend_data;
+    uint8_t resp[NIOS_PKT_LEN];
     int status;
 
     print_buf("NIOS II REQ:", buf, NIOS_PKT_LEN);
 
-    /* Send the command */
-    status = usb->fn->bulk_transfer(usb->driver, PERIPHERAL_EP_OUT, buf,
-                                    NIOS_PKT_LEN, PERIPHERAL_TIMEOUT_MS);
-    if (status != 0) {
-        log_error("Failed to send NIOS II request: %s\n",
-                  bladerf_strerror(status));
-        return status;
-    }
+    if (usb->fn->bulk_exchange != NULL) {
+        /* Have the response transfer pending while the request is sent */
+        status = usb->fn->bulk_exchange(usb->driver, PERIPHERAL_EP_OUT, buf,
+                                        PERIPHERAL_EP_IN, resp, NIOS_PKT_LEN,
+                                        PERIPHERAL_TIMEOUT_MS);
+        if (status != 0) {
+            if (!quiet) {
+                log_error("Failed to exchange NIOS II request: %s\n",
+                          bladerf_strerror(status));
+            }
+            return status;
+        }
 
-    /* Retrieve the request */
-    status = usb->fn->bulk_transfer(usb->driver, PERIPHERAL_EP_IN, buf,
-                                    NIOS_PKT_LEN, PERIPHERAL_TIMEOUT_MS);
-    if (status != 0) {
-        log_error("Failed to receive NIOS II response: %s\n",
-                  bladerf_strerror(status));
+        memcpy(buf, resp, NIOS_PKT_LEN);
+    } else {
+        /* Send the command */
+        status = usb->fn->bulk_transfer(usb->driver, PERIPHERAL_EP_OUT, buf,
+                                        NIOS_PKT_LEN, PERIPHERAL_TIMEOUT_MS);
+        if (status != 0) {
+            if (!quiet) {
+                log_error("Failed to send NIOS II request: %s\n",
+                          bladerf_strerror(status));
+            }
+            return status;
+        }
+
+        /* Retrieve the request */
+        status = usb->fn->bulk_transfer(usb->driver, PERIPHERAL_EP_IN, buf,
+                                        NIOS_PKT_LEN, PERIPHERAL_TIMEOUT_MS);
+        if (status != 0 && !quiet) {
+            log_error("Failed to receive NIOS II response: %s\n",
+                      bladerf_strerror(status));
+        }
     }
 
     print_buf("NIOS II res:", buf, NIOS_PKT_LEN);
@@ -83,30 +121,482 @@ static int nios_access(struct bladerf *dev, uint8_t *buf)
     return status;
 }
 
-/* Variant that doesn't output to log_error on error. */
-static int nios_access_quiet(struct bladerf *dev, uint8_t *buf)
+static bladerf_control_pkt nios_pkt_type(uint8_t magic)
+{
+    switch (magic) {
+        case NIOS_PKT_8x8_MAGIC:
+            return BLADERF_CONTROL_PKT_8x8;
+
+        case NIOS_PKT_8x16_MAGIC:
+            return BLADERF_CONTROL_PKT_8x16;
+
+        case NIOS_PKT_8x32_MAGIC:
+            return BLADERF_CONTROL_PKT_8x32;
+
+        case NIOS_PKT_8x64_MAGIC:
+            return BLADERF_CONTROL_PKT_8x64;
+
+        case NIOS_PKT_16x64_MAGIC:
+            return BLADERF_CONTROL_PKT_16x64;
+
+        case NIOS_PKT_32x32_MAGIC:
+            return BLADERF_CONTROL_PKT_32x32;
+
+        case NIOS_PKT_RETUNE_MAGIC:
+        case NIOS_PKT_RETUNE2_MAGIC:
+            return BLADERF_CONTROL_PKT_RETUNE;
+
+        default:
+            return BLADERF_CONTROL_PKT_OTHER;
+    }
+}
+
+/* As nios_exchange_usb(), recording the round-trip time while control request
+ * statistics are enabled */
+static int nios_exchange(struct bladerf *dev, uint8_t *buf, bool quiet)
+{
+    struct nios_ctrl_stats *stats =
+        ((struct bladerf_usb *)dev->backend_data)->ctrl_stats;
+    bladerf_control_pkt type;
+    uint64_t start;
+    int status;
+
+    if (stats == NULL) {
+        return nios_exchange_usb(dev, buf, quiet);
+    }
+
+    /* The response overwrites the request, so note its type first */
+    type  = nios_pkt_type(buf[NIOS_PKT_IDX_MAGIC]);
+    start = wallclock_get_monotonic_nsec();
+
+    status = nios_exchange_usb(dev, buf, quiet);
+
+    if (status == 0) {
+        latency_hist_add(&stats->hist[type],
+                         wallclock_get_monotonic_nsec() - start);
+    } else {
+        stats->errors[type]++;
+    }
+
+    return status;
+}
+
+static inline bool nios_batch_active(struct bladerf *dev)
 {
     struct bladerf_usb *usb = dev->backend_data;
+    return usb->batch.depth != 0;
+}
+
+/* Queue a write request. The request's response is checked when it is
+ * issued by nios_batch_flush(). */
+static int nios_batch_queue(struct bladerf *dev, const uint8_t *buf)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    struct nios_batch *b = &usb->batch;
+
+    if (b->count == NIOS_BATCH_MAX_REQUESTS) {
+        nios_batch_flush(dev);
+    }
+
+    memcpy(b->requests[b->count], buf, NIOS_PKT_LEN);
+    b->count++;
+
+    return 0;
+}
+
+/* Returns true if a queued request is an RFIC write that can be carried in
+ * an RFIC batch request */
+static bool nios_batch_is_rfic_write(const uint8_t *buf)
+{
+    uint8_t target;
+    bool write;
+    uint16_t addr;
+    uint64_t data;
+
+    if (buf[NIOS_PKT_IDX_MAGIC] != NIOS_PKT_16x64_MAGIC) {
+        return false;
+    }
+
+    nios_pkt_16x64_unpack(buf, &target, &write, &addr, &data);
+
+    return write && target == NIOS_PKT_16x64_TARGET_RFIC &&
+           nios_pkt_rfic_batch_fits(addr, data);
+}
+
+/* Returns true if a queued request is a single AD9361 SPI write, which can
+ * be carried in an AD9361 batch request */
+static bool nios_batch_is_ad9361_write(const uint8_t *buf)
+{
+    uint8_t target;
+    bool write;
+
+    if (buf[NIOS_PKT_IDX_MAGIC] != NIOS_PKT_16x64_MAGIC) {
+        return false;
+    }
+
+    nios_pkt_16x64_unpack(buf, &target, &write, NULL, NULL);
+
+    return write && target == NIOS_PKT_16x64_TARGET_AD9361;
+}
+
+/* FPGAs that accept RFIC batch requests report their RFIC write queue
+ * capacity in the RFIC status register, and those that accept AD9361 batch
+ * requests set a flag there. Both are probed together. */
+static void nios_batch_probe(struct bladerf *dev)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    struct nios_batch *b = &usb->batch;
+    uint8_t buf[NIOS_PKT_LEN];
+    uint64_t sreg;
+    bool success;
     int status;
 
-    print_buf("NIOS II REQ:", buf, NIOS_PKT_LEN);
+    nios_pkt_16x64_pack(buf, NIOS_PKT_16x64_TARGET_RFIC, false,
+                        NIOS_RFIC_STATUS_ADDR, 0);
 
-    /* Send the command */
-    status = usb->fn->bulk_transfer(usb->driver, PERIPHERAL_EP_OUT, buf,
-                                    NIOS_PKT_LEN, PERIPHERAL_TIMEOUT_MS);
+    /* This is called while flushing, so bypass nios_access() */
+    status = nios_exchange(dev, buf, true);
+    if (status != 0) {
+        return;
+    }
+
+    nios_pkt_16x64_resp_unpack(buf, NULL, NULL, NULL, &sreg, &success);
+
+    if (success && ((sreg >> BLADERF_RFIC_STATUS_WQMAX_SHIFT) &
+                    BLADERF_RFIC_STATUS_WQMAX_MASK) != 0) {
+        b->rfic_batch = NIOS_RFIC_BATCH_SUPPORTED;
+    } else {
+        b->rfic_batch = NIOS_RFIC_BATCH_UNSUPPORTED;
+    }
+
+    if (success && ((sreg >> BLADERF_RFIC_STATUS_SPIBATCH_SHIFT) &
+                    BLADERF_RFIC_STATUS_SPIBATCH_MASK) != 0) {
+        b->ad9361_batch = NIOS_RFIC_BATCH_SUPPORTED;
+    } else {
+        b->ad9361_batch = NIOS_RFIC_BATCH_UNSUPPORTED;
+    }
+
+    log_verbose("%s: RFIC batch requests are %ssupported.\n", __FUNCTION__,
+                b->rfic_batch == NIOS_RFIC_BATCH_SUPPORTED ? "" : "not ");
+    log_verbose("%s: AD9361 batch requests are %ssupported.\n", __FUNCTION__,
+                b->ad9361_batch == NIOS_RFIC_BATCH_SUPPORTED ? "" : "not ");
+}
+
+static bool nios_batch_rfic_supported(struct bladerf *dev)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    struct nios_batch *b = &usb->batch;
+
+    if (b->rfic_batch == NIOS_RFIC_BATCH_UNKNOWN) {
+        nios_batch_probe(dev);
+    }
+
+    return b->rfic_batch == NIOS_RFIC_BATCH_SUPPORTED;
+}
+
+static bool nios_batch_ad9361_supported(struct bladerf *dev)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    struct nios_batch *b = &usb->batch;
+
+    if (b->ad9361_batch == NIOS_RFIC_BATCH_UNKNOWN) {
+        nios_batch_probe(dev);
+    }
+
+    return b->ad9361_batch == NIOS_RFIC_BATCH_SUPPORTED;
+}
+
+/* Issue the queued RFIC writes starting at requests[first] as RFIC batch
+ * requests, consuming up to NIOS_PKT_RFIC_BATCH_MAX of them. If the RFIC
+ * write queue fills, the remainder is resent as it drains. */
+static int nios_batch_issue_rfic(struct bladerf *dev,
+                                 unsigned int first,
+                                 unsigned int *consumed)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    struct nios_batch *b = &usb->batch;
+    uint8_t buf[NIOS_PKT_LEN];
+    unsigned int count = 0;
+    unsigned int done = 0;
+    unsigned int tries = 0;
+    unsigned int i;
+    int status;
+
+    while (count < NIOS_PKT_RFIC_BATCH_MAX && first + count < b->count &&
+           nios_batch_is_rfic_write(b->requests[first + count])) {
+        count++;
+    }
+
+    *consumed = count;
+
+    while (done < count) {
+        uint8_t enqueued;
+        bool queue_full;
+        uint8_t queue_len;
+
+        nios_pkt_rfic_batch_init(buf);
+
+        for (i = done; i < count; i++) {
+            uint16_t addr;
+            uint64_t data;
+
+            nios_pkt_16x64_unpack(b->requests[first + i], NULL, NULL, &addr,
+                                  &data);
+            nios_pkt_rfic_batch_add(buf, addr, data);
+        }
+
+        status = nios_exchange(dev, buf, false);
+        if (status != 0) {
+            return status;
+        }
+
+        nios_pkt_rfic_batch_resp_unpack(buf, &enqueued, &queue_full,
+                                        &queue_len);
+        done += enqueued;
+
+        if (done == count) {
+            break;
+        }
+
+        if (!queue_full) {
+            uint16_t addr;
+
+            nios_pkt_16x64_unpack(b->requests[first + done], NULL, NULL,
+                                  &addr, NULL);
+            log_debug("%s: RFIC command 0x%03x was rejected.\n", __FUNCTION__,
+                      addr);
+            return BLADERF_ERR_FPGA_OP;
+        }
+
+        if (++tries > NIOS_RFIC_BATCH_FULL_TRIES) {
+            log_debug("%s: RFIC write queue did not drain (%u queued).\n",
+                      __FUNCTION__, queue_len);
+            return BLADERF_ERR_TIMEOUT;
+        }
+
+        usleep(NIOS_RFIC_BATCH_FULL_DELAY_US);
+    }
+
+    return 0;
+}
+
+/* Issue the queued AD9361 writes starting at requests[first] as a single
+ * AD9361 batch request, consuming as many of them as fit */
+static int nios_batch_issue_ad9361(struct bladerf *dev,
+                                   unsigned int first,
+                                   unsigned int *consumed)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    struct nios_batch *b = &usb->batch;
+    uint8_t buf[NIOS_PKT_LEN];
+    unsigned int count = 0;
+    uint8_t written;
+    bool success;
+    int status;
+
+    nios_pkt_ad9361_batch_init(buf);
+
+    while (first + count < b->count &&
+           nios_batch_is_ad9361_write(b->requests[first + count])) {
+        uint16_t cmd;
+        uint64_t data;
+
+        nios_pkt_16x64_unpack(b->requests[first + count], NULL, NULL, &cmd,
+                              &data);
+
+        if (!nios_pkt_ad9361_batch_fits(buf, cmd)) {
+            break;
+        }
+
+        nios_pkt_ad9361_batch_add(buf, cmd, data);
+        count++;
+    }
+
+    *consumed = count;
+
+    status = nios_exchange(dev, buf, false);
     if (status != 0) {
         return status;
     }
 
-    /* Retrieve the request */
-    status = usb->fn->bulk_transfer(usb->driver, PERIPHERAL_EP_IN, buf,
-                                    NIOS_PKT_LEN, PERIPHERAL_TIMEOUT_MS);
+    nios_pkt_ad9361_batch_resp_unpack(buf, &written, &success);
 
-    print_buf("NIOS II res:", buf, NIOS_PKT_LEN);
+    if (!success || written != count) {
+        log_debug("%s: %u of %u AD9361 writes were performed.\n",
+                  __FUNCTION__, written, count);
+        return BLADERF_ERR_FPGA_OP;
+    }
+
+    return 0;
+}
+
+int nios_batch_flush(struct bladerf *dev)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    struct nios_batch *b = &usb->batch;
+    unsigned int i;
+    int status = 0;
+
+    for (i = 0; i < b->count && status == 0; i++) {
+        uint8_t *buf = b->requests[i];
+        const uint8_t magic = buf[NIOS_PKT_IDX_MAGIC];
+        unsigned int consumed;
+
+        /* Consecutive RFIC writes are coalesced where the FPGA allows */
+        if (nios_batch_is_rfic_write(buf) &&
+            (i + 1 < b->count &&
+             nios_batch_is_rfic_write(b->requests[i + 1])) &&
+            nios_batch_rfic_supported(dev)) {
+            status = nios_batch_issue_rfic(dev, i, &consumed);
+            i += consumed - 1;
+            continue;
+        }
+
+        /* As are consecutive AD9361 SPI writes */
+        if (nios_batch_is_ad9361_write(buf) &&
+            (i + 1 < b->count &&
+             nios_batch_is_ad9361_write(b->requests[i + 1])) &&
+            nios_batch_ad9361_supported(dev)) {
+            status = nios_batch_issue_ad9361(dev, i, &consumed);
+            i += consumed - 1;
+            continue;
+        }
+
+        /* RFIC access times out occasionally, and this is fine. */
+        const bool quiet =
+            (magic == NIOS_PKT_16x64_MAGIC) &&
+            (buf[NIOS_PKT_16x64_IDX_TARGET_ID] == NIOS_PKT_16x64_TARGET_RFIC);
+
+        status = nios_exchange(dev, buf, quiet);
+        if (status == 0 && !(buf[NIOS_PKT_IDX_FLAGS] & NIOS_PKT_FLAG_SUCCESS)) {
+            log_debug("%s: response packet (magic 0x%02x) reported failure.\n",
+                      __FUNCTION__, magic);
+            status = BLADERF_ERR_FPGA_OP;
+        }
+    }
+
+    if (status != 0) {
+        /* We no longer know which queued writes took effect */
+        reg_shadow_invalidate(&usb->lms_shadow);
+        reg_shadow_invalidate(&usb->si5338_shadow);
+
+        if (i < b->count) {
+            log_debug("%s: discarding %u queued request(s).\n", __FUNCTION__,
+                      b->count - i);
+        }
+
+        if (b->status == 0) {
+            b->status = status;
+        }
+    }
+
+    b->count = 0;
+    return status;
+}
+
+int nios_batch_begin(struct bladerf *dev)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    struct nios_batch *b = &usb->batch;
+
+    if (b->depth == 0) {
+        b->status = 0;
+    }
+
+    b->depth++;
+    return 0;
+}
+
+int nios_batch_commit(struct bladerf *dev)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    struct nios_batch *b = &usb->batch;
+    int status;
+
+    if (b->depth == 0) {
+        log_debug("%s: no batch scope is active.\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    b->depth--;
+    if (b->depth != 0) {
+        return 0;
+    }
+
+    nios_batch_flush(dev);
+
+    status    = b->status;
+    b->status = 0;
 
     return status;
 }
 
+int nios_enable_control_stats(struct bladerf *dev, bool enable)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+
+    if (!enable) {
+        free(usb->ctrl_stats);
+        usb->ctrl_stats = NULL;
+        return 0;
+    }
+
+    if (usb->ctrl_stats == NULL) {
+        usb->ctrl_stats = malloc(sizeof(*usb->ctrl_stats));
+        if (usb->ctrl_stats == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+    }
+
+    memset(usb->ctrl_stats, 0, sizeof(*usb->ctrl_stats));
+    return 0;
+}
+
+int nios_get_control_stats(struct bladerf *dev,
+                           struct bladerf_control_stats *stats)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    size_t i;
+
+    if (usb->ctrl_stats == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    for (i = 0; i < BLADERF_CONTROL_PKT_COUNT; i++) {
+        const struct latency_hist *h = &usb->ctrl_stats->hist[i];
+        struct bladerf_control_latency *l = &stats->pkt[i];
+
+        l->count   = h->count;
+        l->errors  = usb->ctrl_stats->errors[i];
+        l->min_ns  = h->min;
+        l->mean_ns = h->count != 0 ? h->sum / h->count : 0;
+        l->p50_ns  = latency_hist_percentile(h, 50.0);
+        l->p90_ns  = latency_hist_percentile(h, 90.0);
+        l->p99_ns  = latency_hist_percentile(h, 99.0);
+        l->p999_ns = latency_hist_percentile(h, 99.9);
+        l->max_ns  = h->max;
+    }
+
+    return 0;
+}
+
+/* Buf is assumed to be NIOS_PKT_LEN bytes */
+static int nios_access(struct bladerf *dev, uint8_t *buf)
+{
+    /* Maintain ordering with respect to any queued requests */
+    nios_batch_flush(dev);
+
+    return nios_exchange(dev, buf, false);
+}
+
+/* Variant that doesn't output to log_error on error. */
+static int nios_access_quiet(struct bladerf *dev, uint8_t *buf)
+{
+    nios_batch_flush(dev);
+
+    return nios_exchange(dev, buf, true);
+}
+
 static int nios_8x8_read(struct bladerf *dev, uint8_t id,
                          uint8_t addr, uint8_t *data)
 {
@@ -141,6 +631,10 @@ static int nios_8x8_write(struct bladerf *dev, uint8_t id,
 
     nios_pkt_8x8_pack(buf, id, true, addr, data);
 
+    if (nios_batch_active(dev)) {
+        return nios_batch_queue(dev, buf);
+    }
+
     status = nios_access(dev, buf);
     if (status != 0) {
         return status;
@@ -192,6 +686,10 @@ static int nios_8x16_write(struct bladerf *dev, uint8_t id,
 
     nios_pkt_8x16_pack(buf, id, true, addr, data);
 
+    if (nios_batch_active(dev)) {
+        return nios_batch_queue(dev, buf);
+    }
+
     status = nios_access(dev, buf);
     if (status != 0) {
         return status;
@@ -267,6 +765,10 @@ static int nios_8x32_write(struct bladerf *dev, uint8_t id,
 
     nios_pkt_8x32_pack(buf, id, true, addr, data);
 
+    if (nios_batch_active(dev)) {
+        return nios_batch_queue(dev, buf);
+    }
+
     status = nios_access(dev, buf);
     if (status != 0) {
         return status;
@@ -327,6 +829,10 @@ static int nios_16x64_write(struct bladerf *dev,
 
     nios_pkt_16x64_pack(buf, id, true, addr, data);
 
+    if (nios_batch_active(dev)) {
+        return nios_batch_queue(dev, buf);
+    }
+
     /* RFIC access times out occasionally, and this is fine. */
     if (NIOS_PKT_16x64_TARGET_RFIC == id) {
         status = nios_access_quiet(dev, buf);
@@ -382,6 +888,10 @@ static int nios_32x32_write(struct bladerf *dev, uint32_t id,
 
     nios_pkt_32x32_pack(buf, id, true, addr, data);
 
+    if (nios_batch_active(dev)) {
+        return nios_batch_queue(dev, buf);
+    }
+
     status = nios_access(dev, buf);
     if (status != 0) {
         return status;
@@ -433,6 +943,10 @@ static int nios_32x32_masked_write(struct bladerf *dev, uint8_t id,
     /* The address is used as a mask of bits to read and return */
     nios_pkt_32x32_pack(buf, id, true, mask, val);
 
+    if (nios_batch_active(dev)) {
+        return nios_batch_queue(dev, buf);
+    }
+
     status = nios_access(dev, buf);
     if (status != 0) {
         return status;
@@ -526,20 +1040,242 @@ int nios_get_timestamp(struct bladerf *dev,
 
     nios_pkt_8x64_resp_unpack(buf, NULL, NULL, NULL, timestamp, &success);
 
-    if (success) {
-        log_verbose("%s: Read %s timestamp: %" PRIu64 "\n", __FUNCTION__,
-                    direction2str(dir), *timestamp);
-        return 0;
-    } else {
-        log_debug("%s: response packet reported failure.\n", __FUNCTION__);
-        *timestamp = 0;
-        return BLADERF_ERR_FPGA_OP;
+    if (success) {
+        log_verbose("%s: Read %s timestamp: %" PRIu64 "\n", __FUNCTION__,
+                    direction2str(dir), *timestamp);
+        return 0;
+    } else {
+        log_debug("%s: response packet reported failure.\n", __FUNCTION__);
+        *timestamp = 0;
+        return BLADERF_ERR_FPGA_OP;
+    }
+}
+
+int nios_get_trigger_time(struct bladerf *dev,
+                          bladerf_direction dir,
+                          bool *fired,
+                          uint64_t *time)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+    uint8_t addr;
+    uint64_t value;
+    bool success;
+
+    switch (dir) {
+        case BLADERF_RX:
+            addr = NIOS_PKT_8x64_TIMESTAMP_RX_TRIGGER;
+            break;
+
+        case BLADERF_TX:
+            addr = NIOS_PKT_8x64_TIMESTAMP_TX_TRIGGER;
+            break;
+
+        default:
+            log_debug("Invalid direction: %d\n", dir);
+            return BLADERF_ERR_INVAL;
+    }
+
+    nios_pkt_8x64_pack(buf, NIOS_PKT_8x64_TARGET_TIMESTAMP, false, addr, 0);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_8x64_resp_unpack(buf, NULL, NULL, NULL, &value, &success);
+
+    if (!success) {
+        log_debug("%s: response packet reported failure.\n", __FUNCTION__);
+        return BLADERF_ERR_FPGA_OP;
+    }
+
+    *fired = (value & NIOS_PKT_8x64_TRIGGER_FIRED) != 0;
+    *time  = value & NIOS_PKT_8x64_TRIGGER_TIME_MASK;
+
+    log_verbose("%s: Read %s trigger time: %" PRIu64 "%s\n", __FUNCTION__,
+                direction2str(dir), *time, *fired ? "" : " (not fired)");
+
+    return 0;
+}
+
+int nios_get_config_id(struct bladerf *dev, uint64_t *id)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+    bool success;
+
+    nios_pkt_8x64_pack(buf, NIOS_PKT_8x64_TARGET_CONFIG_ID, false, 0, 0);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_8x64_resp_unpack(buf, NULL, NULL, NULL, id, &success);
+
+    if (success) {
+        log_verbose("%s: Read 0x%016" PRIx64 "\n", __FUNCTION__, *id);
+        return 0;
+    } else {
+        /* Older FPGA images do not implement this target */
+        log_debug("%s: response packet reported failure.\n", __FUNCTION__);
+        *id = 0;
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+}
+
+int nios_set_config_id(struct bladerf *dev, uint64_t id)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+    bool success;
+
+    nios_pkt_8x64_pack(buf, NIOS_PKT_8x64_TARGET_CONFIG_ID, true, 0, id);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_8x64_resp_unpack(buf, NULL, NULL, NULL, NULL, &success);
+
+    if (success) {
+        log_verbose("%s: Wrote 0x%016" PRIx64 "\n", __FUNCTION__, id);
+        return 0;
+    } else {
+        log_debug("%s: response packet reported failure.\n", __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+}
+
+/* Si5338 registers that only change when written by the host: the clock
+ * input/output configuration and multisynth parameters on page 0. */
+static bool si5338_cacheable(uint8_t addr)
+{
+    return (addr >= 31 && addr <= 39) || (addr >= 53 && addr <= 95);
+}
+
+/* LMS6002D registers excluded from the shadow: the DC offset calibration
+ * blocks, whose results are updated by the device, and the VCO comparator
+ * readbacks used during tuning. */
+static bool lms6_cacheable(uint8_t addr)
+{
+    switch (addr & 0x70) {
+        case 0x00:
+        case 0x30:
+        case 0x50:
+        case 0x60:
+            if ((addr & 0x0f) <= 0x03) {
+                return false;
+            }
+            break;
+    }
+
+    return addr != 0x1a && addr != 0x2a && addr < 0x80;
+}
+
+void nios_reg_shadow_init(struct bladerf_usb *usb)
+{
+    reg_shadow_init(&usb->lms_shadow, "LMS6002D", lms6_cacheable);
+    reg_shadow_init(&usb->si5338_shadow, "Si5338", si5338_cacheable);
+}
+
+void nios_reg_shadow_invalidate(struct bladerf *dev)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+
+    reg_shadow_dump(&usb->lms_shadow);
+    reg_shadow_dump(&usb->si5338_shadow);
+
+    reg_shadow_invalidate(&usb->lms_shadow);
+    reg_shadow_invalidate(&usb->si5338_shadow);
+}
+
+/* LMS6002D registers rewritten by a NIOS II retune: the DSM enables, the PLL
+ * block of the module being tuned, and its PA or LNA band selection */
+static void lms6_shadow_invalidate_tuning(struct reg_shadow *shadow,
+                                          bladerf_channel ch)
+{
+    const bool tx = BLADERF_CHANNEL_IS_TX(ch);
+
+    reg_shadow_invalidate_reg(shadow, 0x09);
+    reg_shadow_invalidate_range(shadow, tx ? 0x10 : 0x20, tx ? 0x1f : 0x2f);
+    reg_shadow_invalidate_reg(shadow, tx ? 0x44 : 0x75);
+}
+
+static bool lms6_shadow_bypassed(const struct bladerf_usb *usb)
+{
+    return usb->lms_queued[BLADERF_RX] || usb->lms_queued[BLADERF_TX] ||
+           usb->dc_sweep_running;
+}
+
+static bool si5338_shadow_bypassed(const struct bladerf_usb *usb)
+{
+    /* Registers on page 1 alias those on page 0, so the shadow is also
+     * bypassed while page 1 is selected (register 255, cached from the last
+     * write) */
+    return usb->si5338_queued[BLADERF_RX] || usb->si5338_queued[BLADERF_TX] ||
+           usb->si5338_shadow.value[255] != 0;
+}
+
+/* The retune queue of `ch` is empty, so any writes it held have been made */
+static void nios_queue_drained(struct bladerf_usb *usb, bladerf_channel ch)
+{
+    const bladerf_direction dir = BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX
+                                                            : BLADERF_RX;
+
+    if (usb->lms_queued[dir]) {
+        usb->lms_queued[dir] = false;
+        reg_shadow_invalidate(&usb->lms_shadow);
+    }
+
+    if (usb->si5338_queued[dir]) {
+        usb->si5338_queued[dir] = false;
+        reg_shadow_invalidate(&usb->si5338_shadow);
+    }
+}
+
+/* Read an 8-bit register through a shadow. The cached value is returned
+ * directly unless verification is enabled, in which case the device is read
+ * and compared against it. */
+static int shadowed_8x8_read(struct bladerf *dev, struct reg_shadow *shadow,
+                             uint8_t id, uint8_t addr, uint8_t *data)
+{
+    uint8_t cached;
+    bool hit;
+    int status;
+
+    hit = shadow->cacheable(addr) && reg_shadow_lookup(shadow, addr, &cached);
+    if (hit && !shadow->verify) {
+        *data = cached;
+        return 0;
+    }
+
+    status = nios_8x8_read(dev, id, addr, data);
+    if (status == 0) {
+        if (hit) {
+            reg_shadow_check(shadow, addr, cached, *data);
+        }
+
+        reg_shadow_update(shadow, addr, *data);
     }
+
+    return status;
 }
 
 int nios_si5338_read(struct bladerf *dev, uint8_t addr, uint8_t *data)
 {
-    int status = nios_8x8_read(dev, NIOS_PKT_8x8_TARGET_SI5338, addr, data);
+    struct bladerf_usb *usb = dev->backend_data;
+    struct reg_shadow *shadow = &usb->si5338_shadow;
+    int status;
+
+    if (si5338_shadow_bypassed(usb)) {
+        status = nios_8x8_read(dev, NIOS_PKT_8x8_TARGET_SI5338, addr, data);
+    } else {
+        status = shadowed_8x8_read(dev, shadow, NIOS_PKT_8x8_TARGET_SI5338,
+                                   addr, data);
+    }
 
 #ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
     if (status == 0) {
@@ -553,8 +1289,23 @@ int nios_si5338_read(struct bladerf *dev, uint8_t addr, uint8_t *data)
 
 int nios_si5338_write(struct bladerf *dev, uint8_t addr, uint8_t data)
 {
+    struct bladerf_usb *usb = dev->backend_data;
+    struct reg_shadow *shadow = &usb->si5338_shadow;
     int status = nios_8x8_write(dev, NIOS_PKT_8x8_TARGET_SI5338, addr, data);
 
+    if (status != 0) {
+        reg_shadow_invalidate_reg(shadow, addr);
+    } else if (addr == 255) {
+        /* Page select */
+        reg_shadow_invalidate(shadow);
+        shadow->value[255] = data & 0x1;
+    } else if (addr == 246) {
+        /* Soft reset */
+        reg_shadow_invalidate(shadow);
+    } else if (shadow->value[255] == 0) {
+        reg_shadow_update(shadow, addr, data);
+    }
+
 #ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
     if (status == 0) {
         log_verbose("%s: Wrote 0x%02x to addr 0x%02x\n",
@@ -567,7 +1318,15 @@ int nios_si5338_write(struct bladerf *dev, uint8_t addr, uint8_t data)
 
 int nios_lms6_read(struct bladerf *dev, uint8_t addr, uint8_t *data)
 {
-    int status = nios_8x8_read(dev, NIOS_PKT_8x8_TARGET_LMS6, addr, data);
+    struct bladerf_usb *usb = dev->backend_data;
+    int status;
+
+    if (lms6_shadow_bypassed(usb)) {
+        status = nios_8x8_read(dev, NIOS_PKT_8x8_TARGET_LMS6, addr, data);
+    } else {
+        status = shadowed_8x8_read(dev, &usb->lms_shadow,
+                                   NIOS_PKT_8x8_TARGET_LMS6, addr, data);
+    }
 
 #ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
     if (status == 0) {
@@ -581,8 +1340,18 @@ int nios_lms6_read(struct bladerf *dev, uint8_t addr, uint8_t *data)
 
 int nios_lms6_write(struct bladerf *dev, uint8_t addr, uint8_t data)
 {
+    struct bladerf_usb *usb = dev->backend_data;
     int status = nios_8x8_write(dev, NIOS_PKT_8x8_TARGET_LMS6, addr, data);
 
+    if (status != 0) {
+        reg_shadow_invalidate_reg(&usb->lms_shadow, addr);
+    } else if (addr == 0x05 && !(data & (1 << 5))) {
+        /* Soft reset asserted: all registers return to their defaults */
+        reg_shadow_invalidate(&usb->lms_shadow);
+    } else {
+        reg_shadow_update(&usb->lms_shadow, addr, data);
+    }
+
 #ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
     if (status == 0) {
         log_verbose("%s: Wrote 0x%02x to addr 0x%02x\n",
@@ -825,6 +1594,36 @@ int nios_rffe_fastlock_save(struct bladerf *dev, bool is_tx,
     return status;
 }
 
+int nios_rx_decim_read(struct bladerf *dev, uint32_t *value)
+{
+    int status;
+
+    status = nios_8x32_read(dev, NIOS_PKT_8x32_TARGET_RX_DECIM, 0, value);
+
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (status == 0) {
+        log_verbose("%s: Read 0x%08x\n", __FUNCTION__, *value);
+    }
+#endif
+
+    return status;
+}
+
+int nios_rx_decim_write(struct bladerf *dev, uint32_t value)
+{
+    int status;
+
+    status = nios_8x32_write(dev, NIOS_PKT_8x32_TARGET_RX_DECIM, 0, value);
+
+#ifdef ENABLE_LIBBLADERF_NIOS_ACCESS_LOG_VERBOSE
+    if (status == 0) {
+        log_verbose("%s: Wrote 0x%08x\n", __FUNCTION__, value);
+    }
+#endif
+
+    return status;
+}
+
 int nios_ad56x1_vctcxo_trim_dac_read(struct bladerf *dev, uint16_t *value)
 {
     int status;
@@ -1141,6 +1940,7 @@ int nios_retune(struct bladerf *dev, bladerf_channel ch,
                 uint8_t freqsel, uint8_t vcocap, bool low_band,
                 uint8_t xb_gpio, bool quick_tune)
 {
+    struct bladerf_usb *usb = dev->backend_data;
     int status;
     uint8_t buf[NIOS_PKT_LEN];
 
@@ -1161,6 +1961,20 @@ int nios_retune(struct bladerf *dev, bladerf_channel ch,
                          xb_gpio, quick_tune);
 
     status = nios_access(dev, buf);
+
+    /* The NIOS II retunes the LMS6002D itself, so the shadow does not see
+     * the registers change. Scheduled retunes take effect later on. */
+    if (timestamp == NIOS_PKT_RETUNE_CLEAR_QUEUE) {
+        if (status == 0) {
+            nios_queue_drained(usb, ch);
+        }
+    } else if (timestamp == BLADERF_RETUNE_NOW) {
+        lms6_shadow_invalidate_tuning(&usb->lms_shadow, ch);
+    } else {
+        usb->lms_queued[BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX : BLADERF_RX] =
+            true;
+    }
+
     if (status != 0) {
         return status;
     }
@@ -1189,6 +2003,159 @@ int nios_retune(struct bladerf *dev, bladerf_channel ch,
     return status;
 }
 
+int nios_dc_cal_clear(struct bladerf *dev)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+    bool success;
+
+    nios_pkt_dc_cal_pack(buf, NIOS_PKT_DC_CAL_CMD_CLEAR, 0);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_dc_cal_resp_unpack(buf, NULL, &success, NULL);
+
+    return success ? 0 : BLADERF_ERR_UNEXPECTED;
+}
+
+int nios_dc_cal_add(struct bladerf *dev, uint16_t nint, uint32_t nfrac,
+                    uint8_t freqsel, uint8_t vcocap, bool low_band,
+                    bool quick_tune)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+    uint8_t index;
+    bool success;
+
+    nios_pkt_dc_cal_add_pack(buf, nint, nfrac, freqsel, vcocap, low_band,
+                             quick_tune);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_dc_cal_resp_unpack(buf, &index, &success, NULL);
+
+    if (!success) {
+        log_debug("%s: DC calibration table is full or busy.\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_QUEUE_FULL;
+    }
+
+    log_verbose("%s: entry %u: nint=%u nfrac=%u freqsel=0x%02x\n",
+                __FUNCTION__, index, nint, nfrac, freqsel);
+
+    return 0;
+}
+
+int nios_dc_cal_start(struct bladerf *dev, uint32_t num_samples,
+                      uint16_t settle_us)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+    bool success;
+
+    nios_pkt_dc_cal_start_pack(buf, num_samples, settle_us);
+
+    /* The sweep retunes RX and writes its DC offsets as it goes */
+    usb->dc_sweep_running = true;
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_dc_cal_resp_unpack(buf, NULL, &success, NULL);
+
+    return success ? 0 : BLADERF_ERR_UNEXPECTED;
+}
+
+int nios_dc_cal_status(struct bladerf *dev, bool *busy, uint8_t *done)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+
+    nios_pkt_dc_cal_pack(buf, NIOS_PKT_DC_CAL_CMD_STATUS, 0);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_dc_cal_resp_unpack(buf, NULL, NULL, busy);
+    *done = buf[NIOS_PKT_DC_CAL_IDX_DONE];
+
+    if (!*busy && usb->dc_sweep_running) {
+        usb->dc_sweep_running = false;
+        reg_shadow_invalidate(&usb->lms_shadow);
+    }
+
+    return 0;
+}
+
+int nios_dc_cal_read(struct bladerf *dev, uint8_t index, int16_t *dc_i,
+                     int16_t *dc_q)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+    bool success;
+
+    nios_pkt_dc_cal_pack(buf, NIOS_PKT_DC_CAL_CMD_READ, index);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_dc_cal_resp_unpack(buf, NULL, &success, NULL);
+
+    if (!success) {
+        log_debug("%s: entry %u was not calibrated.\n", __FUNCTION__, index);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    *dc_i = (int16_t) nios_pkt_dc_cal_get16(&buf[NIOS_PKT_DC_CAL_IDX_DC_I]);
+    *dc_q = (int16_t) nios_pkt_dc_cal_get16(&buf[NIOS_PKT_DC_CAL_IDX_DC_Q]);
+
+    return 0;
+}
+
+int nios_lms_dc_cal(struct bladerf *dev, bladerf_cal_module module)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+    int lms_status;
+    bool success, busy;
+
+    nios_pkt_dc_cal_lms_pack(buf, (uint8_t)module);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_dc_cal_resp_unpack(buf, NULL, &success, &busy);
+    nios_pkt_dc_cal_lms_resp_unpack(buf, &lms_status);
+
+    if (success) {
+        return 0;
+    } else if (busy) {
+        log_debug("%s: an RX DC calibration sweep is in progress.\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_UNEXPECTED;
+    } else if (lms_status == 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    return lms_status;
+}
+
 int nios_retune2(struct bladerf *dev, bladerf_channel ch,
                  uint64_t timestamp, uint16_t nios_profile,
                  uint8_t rffe_profile, uint8_t port,
@@ -1241,6 +2208,210 @@ int nios_retune2(struct bladerf *dev, bladerf_channel ch,
     return status;
 }
 
+int nios_retune2_gain(struct bladerf *dev, bladerf_channel ch,
+                      uint64_t timestamp, uint16_t setting)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+
+    uint8_t resp_flags;
+    uint64_t duration;
+
+    log_verbose("%s: channel=%s timestamp=%"PRIu64" setting=%u\n",
+                __FUNCTION__, channel2str(ch), timestamp, setting);
+
+    nios_pkt_retune2_gain_pack(buf, ch, timestamp, setting);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_retune2_resp_unpack(buf, &duration, &resp_flags);
+
+    if ((resp_flags & NIOS_PKT_RETUNE2_RESP_FLAG_SUCCESS) == 0) {
+        if (timestamp == BLADERF_RETUNE_NOW) {
+            log_debug("FPGA gain change reported failure.\n");
+            status = BLADERF_ERR_UNEXPECTED;
+        } else {
+            log_debug("The FPGA's retune queue is full. Try again after "
+                      "a previous request has completed.\n");
+            status = BLADERF_ERR_QUEUE_FULL;
+        }
+    }
+
+    return status;
+}
+
+int nios_retune_queue(struct bladerf *dev, bladerf_channel ch, uint8_t cmd,
+                      uint64_t start, uint64_t end,
+                      struct bladerf_retune_queue_status *queue,
+                      unsigned int *canceled)
+{
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+
+    bool success;
+    bool next_valid;
+    uint8_t count;
+    uint8_t capacity;
+    uint8_t num_canceled;
+    uint64_t next;
+
+    nios_pkt_retune_queue_pack(buf, !BLADERF_CHANNEL_IS_TX(ch), cmd, start,
+                               end);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_retune_queue_resp_unpack(buf, &success, &count, &capacity,
+                                      &num_canceled, &next_valid, &next);
+
+    if (!success) {
+        log_debug("FPGA retune queue request failed.\n");
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    log_verbose("%s: channel=%s pending=%u canceled=%u next=%"PRIu64"\n",
+                __FUNCTION__, channel2str(ch), count, num_canceled, next);
+
+    if (count == 0) {
+        nios_queue_drained(dev->backend_data, ch);
+    }
+
+    if (queue != NULL) {
+        queue->pending        = count;
+        queue->capacity       = capacity;
+        queue->next_timestamp = next_valid ? next : 0;
+    }
+
+    if (canceled != NULL) {
+        *canceled = num_canceled;
+    }
+
+    return 0;
+}
+
+int nios_timed_write(struct bladerf *dev, bladerf_channel ch,
+                     uint64_t timestamp, uint8_t type, uint8_t id,
+                     uint8_t addr, uint32_t data)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    const bladerf_direction dir = BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX
+                                                            : BLADERF_RX;
+    struct reg_shadow *shadow = NULL;
+    bool *queued = NULL;
+    int status;
+    uint8_t buf[NIOS_PKT_LEN];
+
+    bool success;
+    bool queue_full;
+    uint8_t count;
+
+    /* Writes to shadowed registers are made by the NIOS II, out of sight
+     * of the shadow */
+    if (type == NIOS_PKT_8x8_MAGIC && id == NIOS_PKT_8x8_TARGET_LMS6) {
+        shadow = &usb->lms_shadow;
+        queued = &usb->lms_queued[dir];
+    } else if (type == NIOS_PKT_8x8_MAGIC &&
+               id == NIOS_PKT_8x8_TARGET_SI5338) {
+        shadow = &usb->si5338_shadow;
+        queued = &usb->si5338_queued[dir];
+
+        if (addr == 255) {
+            shadow->value[255] = data & 0x1;
+        }
+    }
+
+    if (shadow != NULL) {
+        if (timestamp == NIOS_PKT_TIMED_WRITE_NOW) {
+            reg_shadow_invalidate(shadow);
+        } else {
+            *queued = true;
+        }
+    }
+
+    nios_pkt_timed_write_pack(buf, !BLADERF_CHANNEL_IS_TX(ch), timestamp,
+                              type, id, addr, data);
+
+    status = nios_access(dev, buf);
+    if (status != 0) {
+        return status;
+    }
+
+    nios_pkt_timed_write_resp_unpack(buf, &success, &queue_full, &count);
+
+    log_verbose("%s: channel=%s type=%c id=0x%02x addr=0x%02x data=0x%08x "
+                "ts=%"PRIu64" pending=%u\n", __FUNCTION__, channel2str(ch),
+                type, id, addr, data, timestamp, count);
+
+    if (queue_full) {
+        log_debug("The FPGA's retune queue is full. Try again after "
+                  "a previous request has completed.\n");
+        return BLADERF_ERR_QUEUE_FULL;
+    } else if (!success) {
+        log_debug("FPGA timed write request failed.\n");
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    return 0;
+}
+
+int nios_vctcxo_tamer(struct bladerf *dev, uint8_t cmd, bool seed_valid,
+                      uint16_t seed,
+                      struct bladerf_vctcxo_tamer_status *status)
+{
+    int rv;
+    uint8_t buf[NIOS_PKT_LEN];
+
+    bool success;
+    uint8_t flags;
+    uint8_t state;
+    uint8_t count;
+    uint16_t trim;
+    int32_t err_1s;
+    int32_t err_10s;
+
+    nios_pkt_vctcxo_tamer_pack(buf, cmd, seed_valid, seed);
+
+    rv = nios_access(dev, buf);
+    if (rv != 0) {
+        return rv;
+    }
+
+    nios_pkt_vctcxo_tamer_resp_unpack(buf, &success, &flags, &state, &count,
+                                      &trim, &err_1s, &err_10s);
+
+    if (!success) {
+        log_debug("FPGA VCTCXO tamer request failed.\n");
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    log_verbose("%s: state=%u flags=0x%02x count=%u trim=0x%04x "
+                "err_1s=%d err_10s=%d\n", __FUNCTION__, state, flags, count,
+                trim, err_1s, err_10s);
+
+    if (status != NULL) {
+        bool tracking = (state == NIOS_PKT_VCTCXO_TAMER_STATE_FINE);
+
+        status->state = tracking ? BLADERF_VCTCXO_TAMER_STATE_TRACKING
+                                 : BLADERF_VCTCXO_TAMER_STATE_ACQUIRING;
+
+        status->locked =
+            tracking && (flags & NIOS_PKT_VCTCXO_TAMER_RESP_FLAG_MEAS_VALID) &&
+            !(flags & NIOS_PKT_VCTCXO_TAMER_RESP_FLAG_ERR_1S);
+
+        status->measurements = count;
+        status->trim_dac     = trim;
+        status->error_1s     = err_1s;
+        status->error_10s    = err_10s;
+    }
+
+    return 0;
+}
+
 int nios_read_trigger(struct bladerf *dev, bladerf_channel ch,
                       bladerf_trigger_signal trigger, uint8_t *value)
 {
@@ -40,6 +40,78 @@
 #include "board/board.h"
 #include "usb.h"
 
+/**
+ * Begin a batch scope. Until the matching nios_batch_commit(), NIOS II write
+ * requests that use the fixed-width packet formats are queued rather than
+ * issued immediately, and report success. Queued requests are issued, in
+ * order, before any other NIOS II request or USB control request.
+ *
+ * @param       dev     Device handle
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_batch_begin(struct bladerf *dev);
+
+/**
+ * End a batch scope. Ending the outermost scope issues any queued requests.
+ *
+ * @param       dev     Device handle
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if no scope is active, or the
+ *         first error that occurred while issuing requests queued since
+ *         the outermost nios_batch_begin().
+ */
+int nios_batch_commit(struct bladerf *dev);
+
+/**
+ * Issue any queued batch requests. Failures are recorded and reported by
+ * nios_batch_commit().
+ *
+ * @param       dev     Device handle
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_batch_flush(struct bladerf *dev);
+
+/**
+ * Initialize the LMS6002D and Si5338 register shadows
+ *
+ * @param       usb     USB backend data
+ */
+void nios_reg_shadow_init(struct bladerf_usb *usb);
+
+/**
+ * Invalidate the LMS6002D and Si5338 register shadows. This must be called
+ * whenever device state may have changed without the host's knowledge, such
+ * as after an FPGA load or device reset.
+ *
+ * @param       dev     Device handle
+ */
+void nios_reg_shadow_invalidate(struct bladerf *dev);
+
+/**
+ * Enable or disable recording of NIOS II request round-trip times. Enabling
+ * clears any previously recorded times.
+ *
+ * @param       dev     Device handle
+ * @param[in]   enable  Enable recording
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_enable_control_stats(struct bladerf *dev, bool enable);
+
+/**
+ * Summarize the NIOS II request round-trip times recorded since recording
+ * was enabled
+ *
+ * @param       dev     Device handle
+ * @param[out]  stats   Statistics
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if recording is not enabled
+ */
+int nios_get_control_stats(struct bladerf *dev,
+                           struct bladerf_control_stats *stats);
+
 /**
  * Read from the FPGA's config register
  *
@@ -83,6 +155,47 @@ int nios_get_timestamp(struct bladerf *dev,
                        bladerf_direction dir,
                        uint64_t *timestamp);
 
+/**
+ * Read the time at which a trigger last fired
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Direction of the trigger
+ * @param[out]  fired       Whether the trigger has fired since the timestamp
+ *                          counter was last reset
+ * @param[out]  time        On success, updated with the time in half-sample
+ *                          periods. See NIOS_PKT_8x64_TIMESTAMP_RX_TRIGGER.
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_get_trigger_time(struct bladerf *dev,
+                          bladerf_direction dir,
+                          bool *fired,
+                          uint64_t *time);
+
+/**
+ * Read the configuration ID retained by the FPGA
+ *
+ * @param       dev         Device handle
+ * @param[out]  id          On success, updated with the ID last written by
+ *                          nios_set_config_id(), or 0 if none has been written
+ *                          since the FPGA was configured
+ *
+ * @return 0 on success, BLADERF_ERR_UNSUPPORTED if the FPGA does not implement
+ *         this, or another BLADERF_ERR_* code on error.
+ */
+int nios_get_config_id(struct bladerf *dev, uint64_t *id);
+
+/**
+ * Write the configuration ID retained by the FPGA
+ *
+ * @param       dev         Device handle
+ * @param[in]   id          Configuration ID
+ *
+ * @return 0 on success, BLADERF_ERR_UNSUPPORTED if the FPGA does not implement
+ *         this, or another BLADERF_ERR_* code on error.
+ */
+int nios_set_config_id(struct bladerf *dev, uint64_t id);
+
 /**
  * Read from an Si5338 register
  *
@@ -272,6 +385,26 @@ int nios_rffe_control_write(struct bladerf *dev, uint32_t value);
 int nios_rffe_fastlock_save(struct bladerf *dev, bool is_tx,
                             uint8_t rffe_profile, uint16_t nios_profile);
 
+/**
+ * Read the RX NCO and decimation control register.
+ *
+ * @param           dev         Device handle
+ * @param[out]      value       Value
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_rx_decim_read(struct bladerf *dev, uint32_t *value);
+
+/**
+ * Write the RX NCO and decimation control register.
+ *
+ * @param           dev         Device handle
+ * @param[in]       value       Value
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_rx_decim_write(struct bladerf *dev, uint32_t value);
+
 /**
  * Write to the AD56X1 VCTCXO trim DAC.
  *
@@ -548,6 +681,157 @@ int nios_retune2(struct bladerf *dev, bladerf_channel ch,
                  uint64_t timestamp, uint16_t nios_profile,
                  uint8_t rffe_profile, uint8_t port, uint8_t spdt);
 
+/**
+ * Schedule a gain change in the retune2 queue
+ *
+ * @param       dev          Device handle
+ * @param[in]   ch           Channel
+ * @param[in]   timestamp    Time to schedule the gain change at
+ * @param[in]   setting      RFIC gain setting. See nios_pkt_retune2.h
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_retune2_gain(struct bladerf *dev, bladerf_channel ch,
+                      uint64_t timestamp, uint16_t setting);
+
+/**
+ * Query the retune queue, or cancel the entries within a range of timestamps
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   cmd         NIOS_PKT_RETUNE_QUEUE_CMD_QUERY or
+ *                          NIOS_PKT_RETUNE_QUEUE_CMD_CANCEL
+ * @param[in]   start       First timestamp to cancel
+ * @param[in]   end         Last timestamp to cancel, inclusive
+ * @param[out]  queue       Queue state after the operation. May be NULL.
+ * @param[out]  canceled    Number of entries canceled. May be NULL.
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_retune_queue(struct bladerf *dev, bladerf_channel ch, uint8_t cmd,
+                      uint64_t start, uint64_t end,
+                      struct bladerf_retune_queue_status *queue,
+                      unsigned int *canceled);
+
+/**
+ * Schedule a peripheral write at a timestamp, or perform it now
+ *
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel whose timestamp and queue to use
+ * @param[in]   timestamp   Timestamp, or NIOS_PKT_TIMED_WRITE_NOW
+ * @param[in]   type        Magic value of the equivalent write request
+ * @param[in]   id          Target ID of the equivalent write request
+ * @param[in]   addr        Address of the equivalent write request
+ * @param[in]   data        Data to write
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_timed_write(struct bladerf *dev, bladerf_channel ch,
+                     uint64_t timestamp, uint8_t type, uint8_t id,
+                     uint8_t addr, uint32_t data);
+
+/**
+ * Query the VCTCXO tamer's control loop, or restart its acquisition
+ *
+ * @param       dev         Device handle
+ * @param[in]   cmd         NIOS_PKT_VCTCXO_TAMER_CMD_QUERY or
+ *                          NIOS_PKT_VCTCXO_TAMER_CMD_ACQUIRE
+ * @param[in]   seed_valid  When acquiring, start from `seed`
+ * @param[in]   seed        Trim DAC value to start acquiring from
+ * @param[out]  status      Loop state after the operation. The state is
+ *                          reported as acquiring or tracking; the caller
+ *                          determines whether the tamer is disabled.
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_vctcxo_tamer(struct bladerf *dev, uint8_t cmd, bool seed_valid,
+                      uint16_t seed,
+                      struct bladerf_vctcxo_tamer_status *status);
+
+/**
+ * Empty the NIOS II RX DC calibration table, stopping any calibration in
+ * progress
+ *
+ * @param       dev         Device handle
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_dc_cal_clear(struct bladerf *dev);
+
+/**
+ * Append a frequency to the NIOS II RX DC calibration table
+ *
+ * @param       dev         Device handle
+ * @param[in]   nint        Integer portion of frequency multiplier
+ * @param[in]   nfrac       Fractional portion of frequency multiplier
+ * @param[in]   freqsel     VCO and divider selection
+ * @param[in]   vcocap      VCOCAP hint
+ * @param[in]   low_band    High vs low band selection
+ * @param[in]   quick_tune  Denotes quick tune should be used instead of
+ *                          tuning algorithm
+ *
+ * @return 0 on success, BLADERF_ERR_QUEUE_FULL if the table is full or a
+ *         calibration is in progress, or another BLADERF_ERR_* code on error.
+ */
+int nios_dc_cal_add(struct bladerf *dev,
+                    uint16_t nint,
+                    uint32_t nfrac,
+                    uint8_t freqsel,
+                    uint8_t vcocap,
+                    bool low_band,
+                    bool quick_tune);
+
+/**
+ * Start calibrating each frequency in the NIOS II RX DC calibration table
+ *
+ * @param       dev         Device handle
+ * @param[in]   num_samples Samples per DC offset measurement
+ * @param[in]   settle_us   Time to wait after each correction change
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_dc_cal_start(struct bladerf *dev,
+                      uint32_t num_samples,
+                      uint16_t settle_us);
+
+/**
+ * Query the progress of a NIOS II RX DC calibration sweep
+ *
+ * @param       dev         Device handle
+ * @param[out]  busy        Set to true while the sweep is running
+ * @param[out]  done        Number of table entries processed so far
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_dc_cal_status(struct bladerf *dev, bool *busy, uint8_t *done);
+
+/**
+ * Read one result of a NIOS II RX DC calibration sweep
+ *
+ * @param       dev         Device handle
+ * @param[in]   index       Table index
+ * @param[out]  dc_i        I DC offset correction
+ * @param[out]  dc_q        Q DC offset correction
+ *
+ * @return 0 on success, BLADERF_ERR_UNEXPECTED if the entry could not be
+ *         calibrated, or another BLADERF_ERR_* code on error.
+ */
+int nios_dc_cal_read(struct bladerf *dev,
+                     uint8_t index,
+                     int16_t *dc_i,
+                     int16_t *dc_q);
+
+/**
+ * Run an LMS6002D DC offset calibration on the NIOS II, as with
+ * lms_calibrate_dc()
+ *
+ * @param       dev         Device handle
+ * @param[in]   module      Module to calibrate
+ *
+ * @return 0 on success, BLADERF_ERR_* code on error.
+ */
+int nios_lms_dc_cal(struct bladerf *dev, bladerf_cal_module module);
+
 /**
  * Read trigger register value
  *
@@ -289,6 +289,30 @@ int nios_legacy_rffe_fastlock_save(struct bladerf *dev, bool is_tx,
                                    uint8_t rffe_profile,
                                    uint16_t nios_profile);
 
+/**
+ * Read the RX NCO and decimation control register.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @param           dev         Device handle
+ * @param[out]      value       Value
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_rx_decim_read(struct bladerf *dev, uint32_t *value);
+
+/**
+ * Write the RX NCO and decimation control register.
+ *
+ * This is not supported by the legacy packet format.
+ *
+ * @param           dev         Device handle
+ * @param[in]       value       Value
+ *
+ * @return BLADERF_ERR_UNSUPPORTED
+ */
+int nios_legacy_rx_decim_write(struct bladerf *dev, uint32_t value);
+
 /**
  * Write to the AD56X1 VCTCXO trim DAC.
  *
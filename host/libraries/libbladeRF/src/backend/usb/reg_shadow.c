@@ -0,0 +1,118 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "log.h"
+
+#include "reg_shadow.h"
+
+#define VALID_BYTE(addr) ((addr) >> 3)
+#define VALID_BIT(addr)  ((uint8_t)(1 << ((addr) & 7)))
+
+void reg_shadow_init(struct reg_shadow *s, const char *name,
+                     bool (*cacheable)(uint8_t addr))
+{
+    const char *env = getenv("BLADERF_REG_SHADOW");
+
+    memset(s, 0, sizeof(*s));
+
+    s->name      = name;
+    s->cacheable = cacheable;
+    s->enabled   = true;
+
+    if (env != NULL) {
+        if (!strcmp(env, "off")) {
+            s->enabled = false;
+        } else if (!strcmp(env, "verify")) {
+            s->verify = true;
+        } else {
+            log_warning("Ignoring invalid BLADERF_REG_SHADOW value: %s\n",
+                        env);
+        }
+    }
+}
+
+bool reg_shadow_lookup(struct reg_shadow *s, uint8_t addr, uint8_t *val)
+{
+    if (s->enabled && (s->valid[VALID_BYTE(addr)] & VALID_BIT(addr))) {
+        *val = s->value[addr];
+        s->hits++;
+        return true;
+    }
+
+    s->misses++;
+    return false;
+}
+
+void reg_shadow_update(struct reg_shadow *s, uint8_t addr, uint8_t val)
+{
+    if (s->enabled && s->cacheable(addr)) {
+        s->value[addr] = val;
+        s->valid[VALID_BYTE(addr)] |= VALID_BIT(addr);
+    }
+}
+
+void reg_shadow_check(struct reg_shadow *s, uint8_t addr,
+                      uint8_t cached, uint8_t actual)
+{
+    if (s->verify && cached != actual) {
+        log_warning("%s register shadow mismatch at 0x%02x: "
+                    "cached=0x%02x, device=0x%02x\n",
+                    s->name, addr, cached, actual);
+    }
+}
+
+void reg_shadow_invalidate_reg(struct reg_shadow *s, uint8_t addr)
+{
+    s->valid[VALID_BYTE(addr)] &= (uint8_t)~VALID_BIT(addr);
+}
+
+void reg_shadow_invalidate_range(struct reg_shadow *s, uint8_t first,
+                                 uint8_t last)
+{
+    unsigned int i;
+
+    for (i = first; i <= last; i++) {
+        reg_shadow_invalidate_reg(s, (uint8_t)i);
+    }
+}
+
+void reg_shadow_invalidate(struct reg_shadow *s)
+{
+    memset(s->valid, 0, sizeof(s->valid));
+}
+
+void reg_shadow_dump(const struct reg_shadow *s)
+{
+    unsigned int i;
+
+    log_debug("%s register shadow: %" PRIu64 " hits, %" PRIu64 " misses\n",
+              s->name, s->hits, s->misses);
+
+    for (i = 0; i < REG_SHADOW_SIZE; i++) {
+        if (s->valid[VALID_BYTE(i)] & VALID_BIT(i)) {
+            log_debug("  [0x%02x] = 0x%02x\n", i, s->value[i]);
+        }
+    }
+}
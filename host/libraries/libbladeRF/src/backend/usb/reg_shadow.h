@@ -0,0 +1,133 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* This file defines a host-side copy ("shadow") of the 8-bit registers of
+ * a peripheral accessed via the NIOS II, such as the LMS6002D or Si5338.
+ *
+ * Reads of registers that the peripheral never changes on its own may be
+ * served from the shadow, saving a USB round trip. Registers that hold status,
+ * calibration results, or other hardware-updated values are never cached.
+ *
+ * The BLADERF_REG_SHADOW environment variable controls this behavior:
+ *
+ *  - "off"     Disable the shadow; all reads go to the device.
+ *  - "verify"  Read from the device anyway, and log a warning whenever the
+ *              shadow differs from the device. This is intended for
+ *              validating the cacheable register maps.
+ */
+
+#ifndef BACKEND_USB_REG_SHADOW_H_
+#define BACKEND_USB_REG_SHADOW_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define REG_SHADOW_SIZE 256
+
+struct reg_shadow {
+    const char *name;               /* Peripheral name, for log messages */
+    bool (*cacheable)(uint8_t addr);/* Registers that may be cached */
+    bool enabled;
+    bool verify;                    /* Compare cached values with device */
+
+    uint8_t valid[REG_SHADOW_SIZE / 8];
+    uint8_t value[REG_SHADOW_SIZE];
+
+    uint64_t hits;
+    uint64_t misses;
+};
+
+/**
+ * Initialize a register shadow. All entries start out invalid.
+ *
+ * @param[out]  s           Shadow to initialize
+ * @param[in]   name        Peripheral name
+ * @param[in]   cacheable   Returns true for registers that may be cached
+ */
+void reg_shadow_init(struct reg_shadow *s, const char *name,
+                     bool (*cacheable)(uint8_t addr));
+
+/**
+ * Look up a register value.
+ *
+ * @param       s       Shadow
+ * @param[in]   addr    Register address
+ * @param[out]  val     Cached value, if found
+ *
+ * @return true if a valid cached value was found, false otherwise
+ */
+bool reg_shadow_lookup(struct reg_shadow *s, uint8_t addr, uint8_t *val);
+
+/**
+ * Record a value read from, or written to, the device. This has no effect for
+ * registers that are not cacheable.
+ *
+ * @param       s       Shadow
+ * @param[in]   addr    Register address
+ * @param[in]   val     Register value
+ */
+void reg_shadow_update(struct reg_shadow *s, uint8_t addr, uint8_t val);
+
+/**
+ * Compare a value read from the device against a value found by
+ * reg_shadow_lookup(), logging any difference when verification is enabled.
+ *
+ * @param       s           Shadow
+ * @param[in]   addr        Register address
+ * @param[in]   cached      Value from the shadow
+ * @param[in]   actual      Value read from the device
+ */
+void reg_shadow_check(struct reg_shadow *s, uint8_t addr,
+                      uint8_t cached, uint8_t actual);
+
+/**
+ * Invalidate a single entry
+ *
+ * @param       s       Shadow
+ * @param[in]   addr    Register address
+ */
+void reg_shadow_invalidate_reg(struct reg_shadow *s, uint8_t addr);
+
+/**
+ * Invalidate the entries from `first` through `last`, inclusive
+ *
+ * @param       s       Shadow
+ * @param[in]   first   First register address
+ * @param[in]   last    Last register address
+ */
+void reg_shadow_invalidate_range(struct reg_shadow *s, uint8_t first,
+                                 uint8_t last);
+
+/**
+ * Invalidate all entries
+ *
+ * @param       s       Shadow
+ */
+void reg_shadow_invalidate(struct reg_shadow *s);
+
+/**
+ * Log the valid entries and hit/miss counts at the debug level
+ *
+ * @param       s       Shadow
+ */
+void reg_shadow_dump(const struct reg_shadow *s);
+
+#endif
@@ -37,9 +37,12 @@
 #include "backend/usb/usb.h"
 #include "driver/fx3_fw.h"
 #include "streaming/async.h"
+#include "helpers/fpga_image.h"
+#include "helpers/have_cap.h"
 #include "helpers/version.h"
 
 #include "bladeRF.h"
+#include "flash_crc32.h"
 #include "nios_pkt_formats.h"
 #include "nios_legacy_access.h"
 #include "nios_access.h"
@@ -59,6 +62,9 @@ static inline int vendor_cmd_int_windex(struct bladerf *dev, uint8_t cmd,
 {
     struct bladerf_usb *usb = dev->backend_data;
 
+    /* Vendor commands may depend upon the effects of queued NIOS requests */
+    nios_batch_flush(dev);
+
     return usb->fn->control_transfer(usb->driver,
                                       USB_TARGET_DEVICE,
                                       USB_REQUEST_VENDOR,
@@ -74,6 +80,9 @@ static inline int vendor_cmd_int_wvalue(struct bladerf *dev, uint8_t cmd,
 {
     struct bladerf_usb *usb = dev->backend_data;
 
+    /* Vendor commands may depend upon the effects of queued NIOS requests */
+    nios_batch_flush(dev);
+
     return usb->fn->control_transfer(usb->driver,
                                       USB_TARGET_DEVICE,
                                       USB_REQUEST_VENDOR,
@@ -84,12 +93,37 @@ static inline int vendor_cmd_int_wvalue(struct bladerf *dev, uint8_t cmd,
 }
 
 
+/* Vendor command wrapper to get a 32-bit integer and supplies wValue and
+ * wIndex */
+static inline int vendor_cmd_int_wvalue_windex(struct bladerf *dev,
+                                               uint8_t cmd,
+                                               uint16_t wvalue,
+                                               uint16_t windex,
+                                               int32_t *val)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+
+    /* Vendor commands may depend upon the effects of queued NIOS requests */
+    nios_batch_flush(dev);
+
+    return usb->fn->control_transfer(usb->driver,
+                                      USB_TARGET_DEVICE,
+                                      USB_REQUEST_VENDOR,
+                                      USB_DIR_DEVICE_TO_HOST,
+                                      cmd, wvalue, windex,
+                                      val, sizeof(uint32_t),
+                                      CTRL_TIMEOUT_MS);
+}
+
 /* Vendor command that gets/sets a 32-bit integer value */
 static inline int vendor_cmd_int(struct bladerf *dev, uint8_t cmd,
                                  usb_direction dir, int32_t *val)
 {
     struct bladerf_usb *usb = dev->backend_data;
 
+    /* Vendor commands may depend upon the effects of queued NIOS requests */
+    nios_batch_flush(dev);
+
     return usb->fn->control_transfer(usb->driver,
                                       USB_TARGET_DEVICE,
                                       USB_REQUEST_VENDOR,
@@ -105,6 +139,8 @@ static inline int change_setting(struct bladerf *dev, uint8_t setting)
 
     log_verbose("Changing to USB alt setting %u\n", setting);
 
+    nios_batch_flush(dev);
+
     status = usb->fn->change_setting(usb->driver, setting);
     if (status != 0) {
         log_debug("Failed to change setting: %s\n", bladerf_strerror(status));
@@ -224,12 +260,49 @@ static int usb_probe(backend_probe_target probe_target,
     return status;
 }
 
+static int usb_hotplug_start(backend_hotplug_cb cb)
+{
+    int status;
+    int ret = BLADERF_ERR_UNSUPPORTED;
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(usb_driver_list); i++) {
+        if (usb_driver_list[i]->fn->hotplug_start == NULL) {
+            continue;
+        }
+
+        status = usb_driver_list[i]->fn->hotplug_start(cb);
+        if (status == 0 || ret == BLADERF_ERR_UNSUPPORTED) {
+            ret = status;
+        }
+    }
+
+    return ret;
+}
+
+static void usb_hotplug_stop(void)
+{
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(usb_driver_list); i++) {
+        if (usb_driver_list[i]->fn->hotplug_stop != NULL) {
+            usb_driver_list[i]->fn->hotplug_stop();
+        }
+    }
+}
+
 static void usb_close(struct bladerf *dev)
 {
     int status;
     struct bladerf_usb *usb = dev->backend_data;
 
     if (usb != NULL) {
+        if (usb->batch.count != 0) {
+            log_warning("Issuing %u request(s) left queued by an "
+                        "uncommitted batch.\n", usb->batch.count);
+            nios_batch_flush(dev);
+        }
+
         /* It seems we need to switch back to our NULL interface before closing,
          * or else our device doesn't close upon exit in OSX and then fails to
          * re-open cleanly */
@@ -240,6 +313,7 @@ static void usb_close(struct bladerf *dev)
         }
 
         usb->fn->close(usb->driver);
+        free(usb->ctrl_stats);
         free(usb);
         dev->backend_data = NULL;
     }
@@ -325,6 +399,10 @@ static int usb_open(struct bladerf *dev, struct bladerf_devinfo *info)
         return BLADERF_ERR_MEM;
     }
 
+    memset(&usb->batch, 0, sizeof(usb->batch));
+    usb->ctrl_stats = NULL;
+    nios_reg_shadow_init(usb);
+
     /* Try each matching usb driver */
     for (i = 0; i < ARRAY_SIZE(usb_driver_list); i++) {
         if (info->backend == BLADERF_BACKEND_ANY
@@ -408,14 +486,62 @@ static int begin_fpga_programming(struct bladerf *dev)
     }
 }
 
-static int usb_load_fpga(struct bladerf *dev, const uint8_t *image, size_t image_size)
+/* Bitstreams are sent in pieces of this size, with several in flight so that
+ * reading the next piece from disk overlaps the transfer of the previous */
+#define FPGA_LOAD_TRANSFER_SIZE (64 * 1024)
+#define FPGA_LOAD_NUM_TRANSFERS 4
+
+static int fpga_image_fill(void *arg, uint8_t *buf, size_t len)
+{
+    return fpga_image_read((struct fpga_image *)arg, buf, len);
+}
+
+static int send_fpga_image(struct bladerf_usb *usb, struct fpga_image *image,
+                           uint32_t timeout_ms)
+{
+    uint8_t *buf;
+    size_t len;
+    int status = 0;
+
+    if (usb->fn->bulk_write_stream != NULL) {
+        return usb->fn->bulk_write_stream(usb->driver, PERIPHERAL_EP_OUT,
+                                          image->size,
+                                          FPGA_LOAD_TRANSFER_SIZE,
+                                          FPGA_LOAD_NUM_TRANSFERS,
+                                          fpga_image_fill, image, timeout_ms);
+    }
+
+    buf = malloc(FPGA_LOAD_TRANSFER_SIZE);
+    if (buf == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    while (status == 0 && image->pos < image->size) {
+        len    = min_sz(image->size - image->pos, FPGA_LOAD_TRANSFER_SIZE);
+        status = fpga_image_read(image, buf, len);
+        if (status == 0) {
+            status = usb->fn->bulk_transfer(usb->driver, PERIPHERAL_EP_OUT,
+                                            buf, (uint32_t)len, timeout_ms);
+        }
+    }
+
+    free(buf);
+    return status;
+}
+
+static int usb_load_fpga(struct bladerf *dev, struct fpga_image *image)
 {
     struct bladerf_usb *usb = dev->backend_data;
+    uint8_t digest[SHA256_DIGEST_SIZE];
 
     unsigned int wait_count;
     const unsigned int timeout_ms = (3 * CTRL_TIMEOUT_MS);
     int status;
 
+    nios_reg_shadow_invalidate(dev);
+    usb->batch.rfic_batch = NIOS_RFIC_BATCH_UNKNOWN;
+    usb->batch.ad9361_batch = NIOS_RFIC_BATCH_UNKNOWN;
+
     /* Switch to the FPGA configuration interface */
     status = change_setting(dev, USB_IF_CONFIG);
     if(status < 0) {
@@ -424,6 +550,9 @@ static int usb_load_fpga(struct bladerf *dev, const uint8_t *image, size_t image
         return status;
     }
 
+    /* Whatever was loaded is about to be replaced */
+    fpga_image_cache_store(dev, NULL);
+
     /* Begin programming */
     status = begin_fpga_programming(dev);
     if (status < 0) {
@@ -433,11 +562,7 @@ static int usb_load_fpga(struct bladerf *dev, const uint8_t *image, size_t image
     }
 
     /* Send the file down */
-    assert(image_size <= UINT32_MAX);
-    status = usb->fn->bulk_transfer(usb->driver, PERIPHERAL_EP_OUT,
-                                    (void *)image,
-                                    (uint32_t)image_size,
-                                    timeout_ms);
+    status = send_fpga_image(usb, image, timeout_ms);
     if (status < 0) {
         log_debug("Failed to write FPGA bitstream to FPGA: %s\n",
                   bladerf_strerror(status));
@@ -468,6 +593,11 @@ static int usb_load_fpga(struct bladerf *dev, const uint8_t *image, size_t image
         return BLADERF_ERR_TIMEOUT;
     }
 
+    status = fpga_image_digest(image, digest);
+    if (status == 0) {
+        fpga_image_cache_store(dev, digest);
+    }
+
     return 0;
 }
 
@@ -524,16 +654,11 @@ error:
     return status != 0 ? status : restore_status;
 }
 
-static inline int read_page(struct bladerf *dev, uint8_t read_operation,
-                            uint16_t page, uint8_t *buf)
+/* Size of each control transfer to or from the firmware's page buffer */
+static int page_buffer_xfer_size(struct bladerf *dev, uint16_t *size)
 {
     struct bladerf_usb *usb = dev->backend_data;
     bladerf_dev_speed usb_speed;
-    int status;
-    int32_t op_status;
-    uint16_t read_size;
-    uint16_t offset;
-    uint8_t request;
 
     if (usb->fn->get_speed(usb->driver, &usb_speed) != 0) {
         log_debug("Error getting USB speed in %s\n", __FUNCTION__);
@@ -541,14 +666,99 @@ static inline int read_page(struct bladerf *dev, uint8_t read_operation,
     }
 
     if (usb_speed == BLADERF_DEVICE_SPEED_SUPER) {
-        read_size = dev->flash_arch->psize_bytes;
+        *size = dev->flash_arch->psize_bytes;
     } else if (usb_speed == BLADERF_DEVICE_SPEED_HIGH) {
-        read_size = 64;
+        *size = 64;
     } else {
         log_debug("Encountered unknown USB speed in %s\n", __FUNCTION__);
         return BLADERF_ERR_UNEXPECTED;
     }
 
+    return 0;
+}
+
+/* Retrieve `len` bytes from the firmware page buffer via `request` */
+static int read_page_buffer(struct bladerf *dev, uint8_t request,
+                            uint8_t *buf, uint16_t len)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    int status;
+    uint16_t read_size;
+    uint16_t offset;
+
+    status = page_buffer_xfer_size(dev, &read_size);
+    if (status != 0) {
+        return status;
+    }
+
+    for (offset = 0; offset < len; offset += read_size) {
+        status = usb->fn->control_transfer(usb->driver,
+                                           USB_TARGET_DEVICE,
+                                           USB_REQUEST_VENDOR,
+                                           USB_DIR_DEVICE_TO_HOST,
+                                           request,
+                                           0,
+                                           offset, /* in bytes */
+                                           buf + offset,
+                                           read_size,
+                                           CTRL_TIMEOUT_MS);
+
+        if(status < 0) {
+            log_debug("Failed to read page buffer at offset 0x%02x: %s\n",
+                      offset, bladerf_strerror(status));
+            return status;
+        }
+    }
+
+    return 0;
+}
+
+/* Write `len` bytes to the firmware page buffer, for commit to `page` */
+static int write_page_buffer(struct bladerf *dev, const uint8_t *buf,
+                             uint16_t len, uint16_t page)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    int status;
+    uint16_t write_size;
+    uint16_t offset;
+
+    status = page_buffer_xfer_size(dev, &write_size);
+    if (status != 0) {
+        return status;
+    }
+
+    /* Casting away the buffer's const-ness here is gross, but this buffer
+     * will not be written to on an out transfer. */
+    for (offset = 0; offset < len; offset += write_size) {
+        status = usb->fn->control_transfer(usb->driver,
+                                            USB_TARGET_DEVICE,
+                                            USB_REQUEST_VENDOR,
+                                            USB_DIR_HOST_TO_DEVICE,
+                                            BLADE_USB_CMD_WRITE_PAGE_BUFFER,
+                                            0,
+                                            offset,
+                                            (uint8_t*)&buf[offset],
+                                            write_size,
+                                            CTRL_TIMEOUT_MS);
+
+        if(status < 0) {
+            log_error("Failed to write page buffer at offset 0x%02x "
+                      "for page %u: %s\n",
+                      offset, page, bladerf_strerror(status));
+            return status;
+        }
+    }
+
+    return 0;
+}
+
+static inline int read_page(struct bladerf *dev, uint8_t read_operation,
+                            uint16_t page, uint8_t *buf)
+{
+    int status;
+    int32_t op_status;
+    uint8_t request;
+
     if (read_operation == BLADE_USB_CMD_FLASH_READ ||
         read_operation == BLADE_USB_CMD_READ_OTP) {
 
@@ -572,26 +782,30 @@ static inline int read_page(struct bladerf *dev, uint8_t read_operation,
     }
 
     /* Retrieve data from the firmware page buffer */
-    for (offset = 0; offset < dev->flash_arch->psize_bytes; offset += read_size) {
-        status = usb->fn->control_transfer(usb->driver,
-                                           USB_TARGET_DEVICE,
-                                           USB_REQUEST_VENDOR,
-                                           USB_DIR_DEVICE_TO_HOST,
-                                           request,
-                                           0,
-                                           offset, /* in bytes */
-                                           buf + offset,
-                                           read_size,
-                                           CTRL_TIMEOUT_MS);
+    return read_page_buffer(dev, request, buf, dev->flash_arch->psize_bytes);
+}
 
-        if(status < 0) {
-            log_debug("Failed to read page buffer at offset 0x%02x: %s\n",
-                      offset, bladerf_strerror(status));
-            return status;
-        }
+/* Read up to FLASH_BUFFER_PAGES pages with a single firmware request */
+static int read_pages(struct bladerf *dev, uint16_t page, uint16_t count,
+                      uint8_t *buf)
+{
+    int status;
+    int32_t op_status;
+
+    assert(count <= FLASH_BUFFER_PAGES);
+
+    status = vendor_cmd_int_wvalue_windex(dev, BLADE_USB_CMD_FLASH_READ_PAGES,
+                                          count, page, &op_status);
+    if (status != 0) {
+        return status;
+    } else if (op_status != 0) {
+        log_error("Firmware read of %u pages failed at page %u: %d\n",
+                  count, page, op_status);
+        return BLADERF_ERR_UNEXPECTED;
     }
 
-    return 0;
+    return read_page_buffer(dev, BLADE_USB_CMD_READ_PAGE_BUFFER, buf,
+                            count * dev->flash_arch->psize_bytes);
 }
 
 static int usb_read_flash_pages(struct bladerf *dev,
@@ -599,15 +813,20 @@ static int usb_read_flash_pages(struct bladerf *dev,
                                 uint32_t page_u32,
                                 uint32_t count_u32)
 {
-    int status;
+    int status, restore_status;
     size_t n_read;
-    uint16_t i;
+    uint16_t i, n;
 
     /* 16-bit control transfer fields are used for these.
      * The current bladeRF build only has a 4MiB flash, anyway. */
     const uint16_t page  = (uint16_t)page_u32;
     const uint16_t count = (uint16_t)count_u32;
 
+    /* Pages read per firmware request */
+    const uint16_t step = have_cap_dev(dev, BLADERF_CAP_FW_FLASH_PAGES)
+                              ? FLASH_BUFFER_PAGES
+                              : 1;
+
     assert(page == page_u32);
     assert(count == count_u32);
 
@@ -619,77 +838,50 @@ static int usb_read_flash_pages(struct bladerf *dev,
     log_info("Reading %u page%s starting at page %u\n", count,
              1 == count ? "" : "s", page);
 
-    for (n_read = i = 0; i < count; i++) {
+    for (n_read = i = 0; i < count; i += n) {
+        n = (uint16_t)uint_min(step, count - i);
+
         log_info("Reading page %u (%u%%)...%c", page + i,
-                 (i + 1) == count ? 100 : 100 * i / count,
-                 (i + 1) == count ? '\n' : '\r');
+                 (i + n) == count ? 100 : 100 * i / count,
+                 (i + n) == count ? '\n' : '\r');
+
+        if (step == 1) {
+            status = read_page(dev, BLADE_USB_CMD_FLASH_READ, page + i,
+                               buf + n_read);
+        } else {
+            status = read_pages(dev, page + i, n, buf + n_read);
+        }
 
-        status =
-            read_page(dev, BLADE_USB_CMD_FLASH_READ, page + i, buf + n_read);
         if (status != 0) {
             goto error;
         }
 
-        n_read += dev->flash_arch->psize_bytes;
+        n_read += n * dev->flash_arch->psize_bytes;
     }
 
     log_info("Done reading %u page%s\n", count, 1 == count ? "" : "s");
 
 error:
-    status = restore_post_flash_setting(dev);
-    return status;
+    restore_status = restore_post_flash_setting(dev);
+    return status != 0 ? status : restore_status;
 }
 
-static int write_page(struct bladerf *dev, uint8_t write_operation,
-                      uint16_t page, const uint8_t *buf)
+/* Commit the page buffer to flash via `write_operation`. For
+ * BLADE_USB_CMD_FLASH_WRITE_PAGES, `count` pages are written. */
+static int commit_pages(struct bladerf *dev, uint8_t write_operation,
+                        uint16_t page, uint16_t count)
 {
     int status;
     int32_t commit_status;
-    uint16_t offset;
-    uint16_t write_size;
-    struct bladerf_usb *usb = dev->backend_data;
-    bladerf_dev_speed usb_speed;
 
-    if (usb->fn->get_speed(usb->driver, &usb_speed) != 0) {
-        log_debug("Error getting USB speed in %s\n", __FUNCTION__);
-        return BLADERF_ERR_UNEXPECTED;
-    }
-
-    if (usb_speed == BLADERF_DEVICE_SPEED_SUPER) {
-        write_size = dev->flash_arch->psize_bytes;
-    } else if (usb_speed == BLADERF_DEVICE_SPEED_HIGH) {
-        write_size = 64;
+    if (write_operation == BLADE_USB_CMD_FLASH_WRITE_PAGES) {
+        status = vendor_cmd_int_wvalue_windex(dev, write_operation, count,
+                                              page, &commit_status);
     } else {
-        assert(!"BUG - unexpected device speed");
-        return BLADERF_ERR_UNEXPECTED;
+        status = vendor_cmd_int_windex(dev, write_operation, page,
+                                       &commit_status);
     }
 
-    /* Write the data to the firmware's page buffer.
-     * Casting away the buffer's const-ness here is gross, but this buffer
-     * will not be written to on an out transfer. */
-    for (offset = 0; offset < dev->flash_arch->psize_bytes; offset += write_size) {
-        status = usb->fn->control_transfer(usb->driver,
-                                            USB_TARGET_DEVICE,
-                                            USB_REQUEST_VENDOR,
-                                            USB_DIR_HOST_TO_DEVICE,
-                                            BLADE_USB_CMD_WRITE_PAGE_BUFFER,
-                                            0,
-                                            offset,
-                                            (uint8_t*)&buf[offset],
-                                            write_size,
-                                            CTRL_TIMEOUT_MS);
-
-        if(status < 0) {
-            log_error("Failed to write page buffer at offset 0x%02x "
-                      "for page %u: %s\n",
-                      offset, page, bladerf_strerror(status));
-            return status;
-        }
-    }
-
-    /* Commit the page to flash */
-    status = vendor_cmd_int_windex(dev, write_operation, page, &commit_status);
-
     if (status != 0) {
         log_error("Failed to commit page %u: %s\n", page,
                   bladerf_strerror(status));
@@ -705,6 +897,42 @@ static int write_page(struct bladerf *dev, uint8_t write_operation,
     return 0;
 }
 
+static int write_page(struct bladerf *dev, uint8_t write_operation,
+                      uint16_t page, const uint8_t *buf)
+{
+    int status;
+
+    /* Write the data to the firmware's page buffer */
+    status = write_page_buffer(dev, buf, dev->flash_arch->psize_bytes, page);
+    if (status != 0) {
+        return status;
+    }
+
+    /* Commit the page to flash */
+    return commit_pages(dev, write_operation, page, 1);
+}
+
+/* Write up to FLASH_BUFFER_PAGES pages with a single firmware request.
+ *
+ * The firmware does not wait for the last page to finish programming before
+ * responding, so this overlaps with the transfer of the next request's
+ * data to the page buffer. */
+static int write_pages(struct bladerf *dev, uint16_t page, uint16_t count,
+                       const uint8_t *buf)
+{
+    int status;
+
+    assert(count <= FLASH_BUFFER_PAGES);
+
+    status = write_page_buffer(dev, buf, count * dev->flash_arch->psize_bytes,
+                               page);
+    if (status != 0) {
+        return status;
+    }
+
+    return commit_pages(dev, BLADE_USB_CMD_FLASH_WRITE_PAGES, page, count);
+}
+
 static int usb_write_flash_pages(struct bladerf *dev,
                                  const uint8_t *buf,
                                  uint32_t page_u32,
@@ -712,7 +940,7 @@ static int usb_write_flash_pages(struct bladerf *dev,
 
 {
     int status, restore_status;
-    uint16_t i;
+    uint16_t i, n;
     size_t n_written;
 
     /* 16-bit control transfer fields are used for these.
@@ -720,6 +948,11 @@ static int usb_write_flash_pages(struct bladerf *dev,
     const uint16_t page  = (uint16_t)page_u32;
     const uint16_t count = (uint16_t)count_u32;
 
+    /* Pages written per firmware request */
+    const uint16_t step = have_cap_dev(dev, BLADERF_CAP_FW_FLASH_PAGES)
+                              ? FLASH_BUFFER_PAGES
+                              : 1;
+
     assert(page == page_u32);
     assert(count == count_u32);
 
@@ -732,17 +965,25 @@ static int usb_write_flash_pages(struct bladerf *dev,
              1 == count ? "" : "s", page);
 
     n_written = 0;
-    for (i = 0; i < count; i++) {
+    for (i = 0; i < count; i += n) {
+        n = (uint16_t)uint_min(step, count - i);
+
         log_info("Writing page %u (%u%%)...%c", page + i,
-                 (i + 1) == count ? 100 : 100 * i / count,
-                 (i + 1) == count ? '\n' : '\r');
+                 (i + n) == count ? 100 : 100 * i / count,
+                 (i + n) == count ? '\n' : '\r');
+
+        if (step == 1) {
+            status = write_page(dev, BLADE_USB_CMD_FLASH_WRITE, page + i,
+                                buf + n_written);
+        } else {
+            status = write_pages(dev, page + i, n, buf + n_written);
+        }
 
-        status = write_page(dev, BLADE_USB_CMD_FLASH_WRITE, page + i, buf + n_written);
         if (status) {
             goto error;
         }
 
-        n_written += dev->flash_arch->psize_bytes;
+        n_written += n * dev->flash_arch->psize_bytes;
     }
     log_info("Done writing %u page%s\n", count, 1 == count ? "" : "s");
 
@@ -757,10 +998,82 @@ error:
     }
 }
 
+static int usb_verify_flash_pages(struct bladerf *dev,
+                                  const uint8_t *expected,
+                                  uint32_t page_u32,
+                                  uint32_t count_u32)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    struct bladerf_fx3_flash_crc resp;
+    int status, restore_status;
+    uint32_t expected_crc;
+    uint16_t i, n;
+    size_t offset;
+
+    const uint16_t page  = (uint16_t)page_u32;
+    const uint16_t count = (uint16_t)count_u32;
+
+    assert(page == page_u32);
+    assert(count == count_u32);
+
+    if (!have_cap_dev(dev, BLADERF_CAP_FW_FLASH_PAGES)) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    status = change_setting(dev, USB_IF_SPI_FLASH);
+    if (status != 0) {
+        return status;
+    }
+
+    for (offset = i = 0; i < count; i += n) {
+        n = (uint16_t)uint_min(FLASH_CRC32_MAX_PAGES, count - i);
+
+        status = usb->fn->control_transfer(usb->driver,
+                                           USB_TARGET_DEVICE,
+                                           USB_REQUEST_VENDOR,
+                                           USB_DIR_DEVICE_TO_HOST,
+                                           BLADE_USB_CMD_FLASH_CRC32,
+                                           n,
+                                           page + i,
+                                           &resp,
+                                           sizeof(resp),
+                                           CTRL_TIMEOUT_MS);
+        if (status != 0) {
+            log_debug("Failed to request CRC of page %u: %s\n", page + i,
+                      bladerf_strerror(status));
+            goto error;
+        } else if (LE32_TO_HOST(resp.status) != 0) {
+            log_debug("Firmware failed to compute CRC of page %u: %d\n",
+                      page + i, (int)LE32_TO_HOST(resp.status));
+            status = BLADERF_ERR_UNEXPECTED;
+            goto error;
+        }
+
+        expected_crc = flash_crc32(0, expected + offset,
+                                   n * dev->flash_arch->psize_bytes);
+
+        if (LE32_TO_HOST(resp.crc) != expected_crc) {
+            log_debug("CRC mismatch in pages %u-%u: read 0x%08x, "
+                      "expected 0x%08x\n", page + i, page + i + n - 1,
+                      LE32_TO_HOST(resp.crc), expected_crc);
+            status = BLADERF_ERR_CHECKSUM;
+            goto error;
+        }
+
+        offset += n * dev->flash_arch->psize_bytes;
+    }
+
+error:
+    restore_status = restore_post_flash_setting(dev);
+    return status != 0 ? status : restore_status;
+}
+
 static int usb_device_reset(struct bladerf *dev)
 {
     struct bladerf_usb *usb = dev->backend_data;
 
+    nios_reg_shadow_invalidate(dev);
+
     return usb->fn->control_transfer(usb->driver, USB_TARGET_DEVICE,
                                       USB_REQUEST_VENDOR,
                                       USB_DIR_HOST_TO_DEVICE,
@@ -773,6 +1086,8 @@ static int usb_jump_to_bootloader(struct bladerf *dev)
 {
     struct bladerf_usb *usb = dev->backend_data;
 
+    nios_reg_shadow_invalidate(dev);
+
     return usb->fn->control_transfer(usb->driver, USB_TARGET_DEVICE,
                                       USB_REQUEST_VENDOR,
                                       USB_DIR_HOST_TO_DEVICE,
@@ -891,6 +1206,56 @@ static int usb_get_firmware_loopback(struct bladerf *dev, bool *is_enabled)
     return status;
 }
 
+static int usb_set_rf_dma_buffers(struct bladerf *dev, unsigned int count)
+{
+    int status;
+    int32_t in_use;
+
+    if (count < RF_DMA_BUFFERS_MIN || count > RF_DMA_BUFFERS_MAX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = vendor_cmd_int_wvalue(dev, BLADE_USB_CMD_SET_RF_DMA_BUFFERS,
+                                   (uint16_t) count, &in_use);
+    if (status != 0 || (unsigned int) in_use == count) {
+        return status;
+    }
+
+    log_debug("Restarting RF link with %u DMA buffers (was %d)\n",
+              count, in_use);
+
+    /* The DMA channels are only rebuilt when the RF link is started */
+    status = change_setting(dev, USB_IF_NULL);
+    if (status == 0) {
+        status = change_setting(dev, USB_IF_RF_LINK);
+    }
+
+    return status;
+}
+
+static int usb_set_rf_dma_channel(struct bladerf *dev,
+                                  bladerf_direction dir,
+                                  unsigned int count)
+{
+    int status;
+    int32_t in_use;
+
+    if (count < RF_DMA_BUFFERS_MIN || count > RF_DMA_BUFFERS_MAX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = vendor_cmd_int_wvalue_windex(
+        dev, BLADE_USB_CMD_SET_RF_DMA_CHANNEL, (uint16_t)count,
+        (dir == BLADERF_TX) ? BLADE_RF_DMA_TX : BLADE_RF_DMA_RX, &in_use);
+
+    if (status == 0) {
+        log_debug("%s DMA channel uses %d buffers\n",
+                  (dir == BLADERF_TX) ? "TX" : "RX", in_use);
+    }
+
+    return status;
+}
+
 static int usb_enable_module(struct bladerf *dev, bladerf_direction dir, bool enable)
 {
     int status;
@@ -925,9 +1290,80 @@ static int usb_enable_module(struct bladerf *dev, bladerf_direction dir, bool en
         }
     }
 
+    if (status == 0) {
+        struct bladerf_usb *usb = dev->backend_data;
+        usb->rf_enabled[dir]    = enable;
+    }
+
     return status;
 }
 
+static int usb_recover(struct bladerf *dev)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    bladerf_direction dir;
+    int status;
+
+    if (usb->fn->reset == NULL) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    /* Requests queued for the old connection are abandoned */
+    usb->batch.count = 0;
+
+    status = usb->fn->reset(usb->driver, &dev->ident);
+    if (status != 0) {
+        return status;
+    }
+
+    status = usb_is_fpga_configured(dev);
+    if (status < 0) {
+        return status;
+    } else if (status == 0) {
+        log_debug("FPGA configuration was lost across the reset\n");
+        return BLADERF_ERR_NODEV;
+    }
+
+    /* The reset returns the interface to its default alt setting */
+    status = change_setting(dev, USB_IF_RF_LINK);
+    if (status != 0) {
+        return status;
+    }
+
+    for (dir = BLADERF_RX; dir <= BLADERF_TX; dir++) {
+        if (usb->rf_enabled[dir]) {
+            status = usb_enable_module(dev, dir, true);
+            if (status != 0) {
+                return status;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int usb_alloc_stream_buffers(struct bladerf_stream *stream,
+                                    size_t size, void **buf)
+{
+    struct bladerf_usb *usb = stream->dev->backend_data;
+
+    if (usb->fn->alloc_stream_buffers == NULL) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return usb->fn->alloc_stream_buffers(usb->driver, stream, size, buf);
+}
+
+static void usb_free_stream_buffers(struct bladerf_stream *stream,
+                                    void *buf, size_t size)
+{
+    struct bladerf_usb *usb = stream->dev->backend_data;
+
+    if (usb->fn->free_stream_buffers != NULL) {
+        usb->fn->free_stream_buffers(usb->driver, stream, buf, size);
+    }
+}
+
 static int usb_init_stream(struct bladerf_stream *stream, size_t num_transfers)
 {
     struct bladerf_usb *usb = stream->dev->backend_data;
@@ -1048,8 +1484,72 @@ static int execute_fw_from_bootloader(struct bladerf_usb *usb, uint32_t addr)
     return status;
 }
 
+/* Chunk writes and read-backs kept in flight by write_fw_section() */
+#define FX3_BOOTLOADER_TRANSFERS 8
+
+/* Write a section, and read it back to verify it, as a single series of
+ * control transfers. Each chunk's read-back is queued behind its write, and
+ * the next chunk's write behind that, so the bootloader need not wait on the
+ * host between them. The ROM bootloader has no request to checksum its
+ * memory, so the data itself must be read back. */
+static int write_fw_section(struct bladerf_usb *usb, uint32_t addr,
+                            uint8_t *data, uint32_t data_len)
+{
+    const size_t num_chunks =
+        (data_len + FX3_BOOTLOADER_MAX_LOAD_LEN - 1) /
+        FX3_BOOTLOADER_MAX_LOAD_LEN;
+    struct usb_control_request *reqs;
+    uint8_t *readback;
+    uint32_t offset, to_write, chunk_addr;
+    size_t i;
+    int status;
+
+    reqs     = calloc(2 * num_chunks, sizeof(reqs[0]));
+    readback = malloc(data_len);
+    if (reqs == NULL || readback == NULL) {
+        free(reqs);
+        free(readback);
+        return BLADERF_ERR_MEM;
+    }
+
+    for (i = 0, offset = 0; offset < data_len; i += 2, offset += to_write) {
+        to_write   = u32_min(data_len - offset, FX3_BOOTLOADER_MAX_LOAD_LEN);
+        chunk_addr = addr + offset;
+
+        reqs[i].target_type = USB_TARGET_DEVICE;
+        reqs[i].req_type    = USB_REQUEST_VENDOR;
+        reqs[i].direction   = USB_DIR_HOST_TO_DEVICE;
+        reqs[i].request     = FX3_BOOTLOADER_LOAD_BREQUEST;
+        reqs[i].wvalue      = FX3_BOOTLOADER_ADDR_WVALUE(chunk_addr);
+        reqs[i].windex      = FX3_BOOTLOADER_ADDR_WINDEX(chunk_addr);
+        reqs[i].buffer      = data + offset;
+        reqs[i].buffer_len  = to_write;
+
+        reqs[i + 1]           = reqs[i];
+        reqs[i + 1].direction = USB_DIR_DEVICE_TO_HOST;
+        reqs[i + 1].buffer    = readback + offset;
+    }
+
+    log_verbose("Writing %u bytes to bootloader @ 0x%08x\n", data_len, addr);
+
+    status = usb->fn->control_transfers(usb->driver, reqs, 2 * num_chunks,
+                                        FX3_BOOTLOADER_TRANSFERS,
+                                        CTRL_TIMEOUT_MS);
+    if (status != 0) {
+        log_debug("Failed to write FW section (%d)\n", status);
+    } else if (memcmp(data, readback, data_len) != 0) {
+        log_debug("Readback did match written data.\n");
+        status = BLADERF_ERR_UNEXPECTED;
+    }
+
+    free(reqs);
+    free(readback);
+    return status;
+}
+
 static int write_fw_to_bootloader(void *driver, struct fx3_firmware *fw)
 {
+    struct bladerf_usb *usb = driver;
     int status = 0;
     uint32_t to_write;
     uint32_t data_len;
@@ -1069,6 +1569,11 @@ static int write_fw_to_bootloader(void *driver, struct fx3_firmware *fw)
              * include the terminating section in its count */
             assert(data_len != 0);
 
+            if (usb->fn->control_transfers != NULL) {
+                status = write_fw_section(usb, addr, data, data_len);
+                continue;
+            }
+
             do {
                 to_write = u32_min(data_len, FX3_BOOTLOADER_MAX_LOAD_LEN);
 
@@ -1134,6 +1639,19 @@ static int get_vctcxo_tamer_mode_unsupported(struct bladerf *dev,
     return BLADERF_ERR_UNSUPPORTED;
 }
 
+static int get_config_id_unsupported(struct bladerf *dev, uint64_t *id)
+{
+    *id = 0;
+    log_debug("Operation not supported with legacy NIOS packet format.\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int set_config_id_unsupported(struct bladerf *dev, uint64_t id)
+{
+    log_debug("Operation not supported with legacy NIOS packet format.\n");
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
 static int usb_read_fw_log(struct bladerf *dev, logger_entry *e)
 {
     int status;
@@ -1145,6 +1663,40 @@ static int usb_read_fw_log(struct bladerf *dev, logger_entry *e)
     return status;
 }
 
+static int usb_read_fw_log_entries(struct bladerf *dev,
+                                   logger_entry *e,
+                                   unsigned int count)
+{
+    struct bladerf_usb *usb = dev->backend_data;
+    unsigned int i;
+    int status;
+
+    if (count == 0 || count > LOG_READ_MAX_ENTRIES) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* Vendor commands may depend upon the effects of queued NIOS requests */
+    nios_batch_flush(dev);
+
+    status = usb->fn->control_transfer(usb->driver,
+                                       USB_TARGET_DEVICE,
+                                       USB_REQUEST_VENDOR,
+                                       USB_DIR_DEVICE_TO_HOST,
+                                       BLADE_USB_CMD_READ_LOG_ENTRIES,
+                                       0, 0,
+                                       e, count * sizeof(e[0]),
+                                       CTRL_TIMEOUT_MS);
+    if (status != 0) {
+        return status;
+    }
+
+    for (i = 0; i < count; i++) {
+        e[i] = LE32_TO_HOST(e[i]);
+    }
+
+    return 0;
+}
+
 static int config_gpio_write(struct bladerf *dev, uint32_t val)
 {
     struct bladerf_usb *usb = dev->backend_data;
@@ -1177,6 +1729,22 @@ static int set_agc_dc_correction_unsupported(struct bladerf *dev,
     return BLADERF_ERR_UNSUPPORTED;
 }
 
+/* The legacy packet format is not batched; requests are issued immediately */
+static int legacy_batch_begin(struct bladerf *dev)
+{
+    return 0;
+}
+
+static int legacy_batch_commit(struct bladerf *dev)
+{
+    return 0;
+}
+
+static int legacy_batch_flush(struct bladerf *dev)
+{
+    return 0;
+}
+
 static int legacy_config_gpio_write(struct bladerf *dev, uint32_t val)
 {
     struct bladerf_usb *usb = dev->backend_data;
@@ -1205,6 +1773,8 @@ const struct backend_fns backend_fns_usb_legacy = {
     FIELD_INIT(.matches, usb_matches),
 
     FIELD_INIT(.probe, usb_probe),
+    FIELD_INIT(.hotplug_start, usb_hotplug_start),
+    FIELD_INIT(.hotplug_stop, usb_hotplug_stop),
 
     FIELD_INIT(.get_vid_pid, usb_get_vid_pid),
     FIELD_INIT(.get_flash_id, usb_get_flash_id),
@@ -1222,13 +1792,17 @@ const struct backend_fns backend_fns_usb_legacy = {
 
     FIELD_INIT(.get_fw_version, usb_get_fw_version),
     FIELD_INIT(.get_fpga_version, usb_get_fpga_version),
+    FIELD_INIT(.get_config_id, get_config_id_unsupported),
+    FIELD_INIT(.set_config_id, set_config_id_unsupported),
 
     FIELD_INIT(.erase_flash_blocks, usb_erase_flash_blocks),
     FIELD_INIT(.read_flash_pages, usb_read_flash_pages),
     FIELD_INIT(.write_flash_pages, usb_write_flash_pages),
+    FIELD_INIT(.verify_flash_pages, usb_verify_flash_pages),
 
     FIELD_INIT(.device_reset, usb_device_reset),
     FIELD_INIT(.jump_to_bootloader, usb_jump_to_bootloader),
+    FIELD_INIT(.recover, usb_recover),
 
     FIELD_INIT(.get_cal, usb_get_cal),
     FIELD_INIT(.get_otp, usb_get_otp),
@@ -1252,6 +1826,7 @@ const struct backend_fns backend_fns_usb_legacy = {
     FIELD_INIT(.set_agc_dc_correction, set_agc_dc_correction_unsupported),
 
     FIELD_INIT(.get_timestamp, nios_legacy_get_timestamp),
+    FIELD_INIT(.get_trigger_time, nios_get_trigger_time),
 
     FIELD_INIT(.si5338_write, nios_legacy_si5338_write),
     FIELD_INIT(.si5338_read, nios_legacy_si5338_read),
@@ -1276,6 +1851,9 @@ const struct backend_fns backend_fns_usb_legacy = {
 
     FIELD_INIT(.rffe_fastlock_save, nios_legacy_rffe_fastlock_save),
 
+    FIELD_INIT(.rx_decim_write, nios_legacy_rx_decim_write),
+    FIELD_INIT(.rx_decim_read, nios_legacy_rx_decim_read),
+
     FIELD_INIT(.ad56x1_vctcxo_trim_dac_write, nios_legacy_ad56x1_vctcxo_trim_dac_write),
     FIELD_INIT(.ad56x1_vctcxo_trim_dac_read, nios_legacy_ad56x1_vctcxo_trim_dac_read),
 
@@ -1292,9 +1870,13 @@ const struct backend_fns backend_fns_usb_legacy = {
 
     FIELD_INIT(.set_firmware_loopback, usb_set_firmware_loopback),
     FIELD_INIT(.get_firmware_loopback, usb_get_firmware_loopback),
+    FIELD_INIT(.set_rf_dma_buffers, usb_set_rf_dma_buffers),
+    FIELD_INIT(.set_rf_dma_channel, usb_set_rf_dma_channel),
 
     FIELD_INIT(.enable_module, usb_enable_module),
 
+    FIELD_INIT(.alloc_stream_buffers, usb_alloc_stream_buffers),
+    FIELD_INIT(.free_stream_buffers, usb_free_stream_buffers),
     FIELD_INIT(.init_stream, usb_init_stream),
     FIELD_INIT(.stream, usb_stream),
     FIELD_INIT(.submit_stream_buffer, usb_submit_stream_buffer),
@@ -1302,14 +1884,23 @@ const struct backend_fns backend_fns_usb_legacy = {
 
     FIELD_INIT(.retune, nios_retune),
     FIELD_INIT(.retune2, nios_retune2),
+    FIELD_INIT(.retune2_gain, nios_retune2_gain),
+    FIELD_INIT(.retune_queue, nios_retune_queue),
+    FIELD_INIT(.timed_write, nios_timed_write),
+    FIELD_INIT(.vctcxo_tamer, nios_vctcxo_tamer),
 
     FIELD_INIT(.load_fw_from_bootloader, usb_load_fw_from_bootloader),
 
     FIELD_INIT(.read_fw_log, usb_read_fw_log),
+    FIELD_INIT(.read_fw_log_entries, usb_read_fw_log_entries),
 
     FIELD_INIT(.read_trigger, nios_legacy_read_trigger),
     FIELD_INIT(.write_trigger, nios_legacy_write_trigger),
 
+    FIELD_INIT(.batch_begin, legacy_batch_begin),
+    FIELD_INIT(.batch_commit, legacy_batch_commit),
+    FIELD_INIT(.batch_flush, legacy_batch_flush),
+
     FIELD_INIT(.name, "usb"),
 };
 
@@ -1318,6 +1909,8 @@ const struct backend_fns backend_fns_usb = {
     FIELD_INIT(.matches, usb_matches),
 
     FIELD_INIT(.probe, usb_probe),
+    FIELD_INIT(.hotplug_start, usb_hotplug_start),
+    FIELD_INIT(.hotplug_stop, usb_hotplug_stop),
 
     FIELD_INIT(.get_vid_pid, usb_get_vid_pid),
     FIELD_INIT(.get_flash_id, usb_get_flash_id),
@@ -1335,13 +1928,17 @@ const struct backend_fns backend_fns_usb = {
 
     FIELD_INIT(.get_fw_version, usb_get_fw_version),
     FIELD_INIT(.get_fpga_version, usb_get_fpga_version),
+    FIELD_INIT(.get_config_id, nios_get_config_id),
+    FIELD_INIT(.set_config_id, nios_set_config_id),
 
     FIELD_INIT(.erase_flash_blocks, usb_erase_flash_blocks),
     FIELD_INIT(.read_flash_pages, usb_read_flash_pages),
     FIELD_INIT(.write_flash_pages, usb_write_flash_pages),
+    FIELD_INIT(.verify_flash_pages, usb_verify_flash_pages),
 
     FIELD_INIT(.device_reset, usb_device_reset),
     FIELD_INIT(.jump_to_bootloader, usb_jump_to_bootloader),
+    FIELD_INIT(.recover, usb_recover),
 
     FIELD_INIT(.get_cal, usb_get_cal),
     FIELD_INIT(.get_otp, usb_get_otp),
@@ -1365,6 +1962,7 @@ const struct backend_fns backend_fns_usb = {
     FIELD_INIT(.set_agc_dc_correction, nios_set_agc_dc_correction),
 
     FIELD_INIT(.get_timestamp, nios_get_timestamp),
+    FIELD_INIT(.get_trigger_time, nios_get_trigger_time),
 
     FIELD_INIT(.si5338_write, nios_si5338_write),
     FIELD_INIT(.si5338_read, nios_si5338_read),
@@ -1392,6 +1990,9 @@ const struct backend_fns backend_fns_usb = {
 
     FIELD_INIT(.rffe_fastlock_save, nios_rffe_fastlock_save),
 
+    FIELD_INIT(.rx_decim_write, nios_rx_decim_write),
+    FIELD_INIT(.rx_decim_read, nios_rx_decim_read),
+
     FIELD_INIT(.ad56x1_vctcxo_trim_dac_write, nios_ad56x1_vctcxo_trim_dac_write),
     FIELD_INIT(.ad56x1_vctcxo_trim_dac_read, nios_ad56x1_vctcxo_trim_dac_read),
 
@@ -1408,9 +2009,13 @@ const struct backend_fns backend_fns_usb = {
 
     FIELD_INIT(.set_firmware_loopback, usb_set_firmware_loopback),
     FIELD_INIT(.get_firmware_loopback, usb_get_firmware_loopback),
+    FIELD_INIT(.set_rf_dma_buffers, usb_set_rf_dma_buffers),
+    FIELD_INIT(.set_rf_dma_channel, usb_set_rf_dma_channel),
 
     FIELD_INIT(.enable_module, usb_enable_module),
 
+    FIELD_INIT(.alloc_stream_buffers, usb_alloc_stream_buffers),
+    FIELD_INIT(.free_stream_buffers, usb_free_stream_buffers),
     FIELD_INIT(.init_stream, usb_init_stream),
     FIELD_INIT(.stream, usb_stream),
     FIELD_INIT(.submit_stream_buffer, usb_submit_stream_buffer),
@@ -1418,13 +2023,33 @@ const struct backend_fns backend_fns_usb = {
 
     FIELD_INIT(.retune, nios_retune),
     FIELD_INIT(.retune2, nios_retune2),
+    FIELD_INIT(.retune2_gain, nios_retune2_gain),
+    FIELD_INIT(.retune_queue, nios_retune_queue),
+    FIELD_INIT(.timed_write, nios_timed_write),
+    FIELD_INIT(.vctcxo_tamer, nios_vctcxo_tamer),
+
+    FIELD_INIT(.dc_cal_clear, nios_dc_cal_clear),
+    FIELD_INIT(.dc_cal_add, nios_dc_cal_add),
+    FIELD_INIT(.dc_cal_start, nios_dc_cal_start),
+    FIELD_INIT(.dc_cal_status, nios_dc_cal_status),
+    FIELD_INIT(.dc_cal_read, nios_dc_cal_read),
+    FIELD_INIT(.lms_dc_cal, nios_lms_dc_cal),
+    FIELD_INIT(.invalidate_reg_shadow, nios_reg_shadow_invalidate),
 
     FIELD_INIT(.load_fw_from_bootloader, usb_load_fw_from_bootloader),
 
     FIELD_INIT(.read_fw_log, usb_read_fw_log),
+    FIELD_INIT(.read_fw_log_entries, usb_read_fw_log_entries),
 
     FIELD_INIT(.read_trigger, nios_read_trigger),
     FIELD_INIT(.write_trigger, nios_write_trigger),
 
+    FIELD_INIT(.batch_begin, nios_batch_begin),
+    FIELD_INIT(.batch_commit, nios_batch_commit),
+    FIELD_INIT(.batch_flush, nios_batch_flush),
+
+    FIELD_INIT(.enable_control_stats, nios_enable_control_stats),
+    FIELD_INIT(.get_control_stats, nios_get_control_stats),
+
     FIELD_INIT(.name, "usb"),
 };
@@ -25,6 +25,10 @@
 #include "host_config.h"
 
 #include "board/board.h"
+#include "nios_pkt_formats.h"
+#include "reg_shadow.h"
+
+#include "helpers/latency_hist.h"
 
 #if ENABLE_USB_DEV_RESET_ON_OPEN
 extern bool bladerf_usb_reset_device_on_open;
@@ -82,6 +86,18 @@ typedef enum {
     USB_DIR_DEVICE_TO_HOST = 0x80
 } usb_direction;
 
+/* A control transfer, as for usb_fns.control_transfer() */
+struct usb_control_request {
+    usb_target target_type;
+    usb_request req_type;
+    usb_direction direction;
+    uint8_t request;
+    uint16_t wvalue;
+    uint16_t windex;
+    void *buffer;
+    uint32_t buffer_len;
+};
+
 /**
  * USB backend driver function table
  *
@@ -92,6 +108,11 @@ struct usb_fns {
     int (*probe)(backend_probe_target probe_target,
                  struct bladerf_devinfo_list *info_list);
 
+    /* Hotplug notifications, as described for struct backend_fns. These may
+     * be NULL if unsupported. */
+    int (*hotplug_start)(backend_hotplug_cb cb);
+    void (*hotplug_stop)(void);
+
     /* Populates the `driver` pointer with a handle for the specific USB driver.
      * `info_in` describes the device to open, and may contain wildcards.
      * On success, the driver should fill in `info_out` with the complete
@@ -112,6 +133,12 @@ struct usb_fns {
 
     int (*change_setting)(void *driver, uint8_t setting);
 
+    /* Reset the USB port. If the device re-enumerates, it is found again via
+     * `info`, which is updated with its new location, and `driver` is updated
+     * in place, so that existing streams submit transfers to the new handle.
+     * May be NULL if unsupported. */
+    int (*reset)(void *driver, struct bladerf_devinfo *info);
+
     int (*control_transfer)(void *driver,
                             usb_target target_type,
                             usb_request req_type,
@@ -129,11 +156,58 @@ struct usb_fns {
                          uint32_t buffer_len,
                          uint32_t timeout_ms);
 
+    /* Optional. Send a request and receive its response of the same length,
+     * with the response transfer submitted before the request transfer
+     * completes. This may be NULL, in which case two bulk_transfer() calls
+     * are used. */
+    int (*bulk_exchange)(void *driver,
+                         uint8_t ep_out,
+                         const void *request,
+                         uint8_t ep_in,
+                         void *response,
+                         uint32_t len,
+                         uint32_t timeout_ms);
+
+    /* Optional. Write `len` bytes to an endpoint in pieces of up to
+     * `transfer_size` bytes, keeping up to `num_transfers` of them in flight.
+     * `fill` is called from the caller's thread to provide the data for each
+     * piece, in order, while the previous pieces are being sent. This may be
+     * NULL, in which case bulk_transfer() is used for each piece. */
+    int (*bulk_write_stream)(void *driver,
+                             uint8_t endpoint,
+                             size_t len,
+                             size_t transfer_size,
+                             unsigned int num_transfers,
+                             int (*fill)(void *arg, uint8_t *buf, size_t len),
+                             void *arg,
+                             uint32_t timeout_ms);
+
+    /* Optional. Perform `count` control transfers in order, keeping up to
+     * `num_transfers` of them in flight, so that each is queued before the
+     * previous ones complete. Stops at the first failure. This may be NULL,
+     * in which case control_transfer() is used for each. */
+    int (*control_transfers)(void *driver,
+                             const struct usb_control_request *reqs,
+                             size_t count,
+                             unsigned int num_transfers,
+                             uint32_t timeout_ms);
+
     int (*get_string_descriptor)(void *driver,
                                  uint8_t index,
                                  void *buffer,
                                  uint32_t buffer_len);
 
+    /* Optional. These may be NULL if the driver has no preferred allocator
+     * for stream buffers. */
+    int (*alloc_stream_buffers)(void *driver,
+                                struct bladerf_stream *stream,
+                                size_t size,
+                                void **buf);
+    void (*free_stream_buffers)(void *driver,
+                                struct bladerf_stream *stream,
+                                void *buf,
+                                size_t size);
+
     int (*init_stream)(void *driver,
                        struct bladerf_stream *stream,
                        size_t num_transfers);
@@ -160,9 +234,58 @@ struct usb_driver {
     bladerf_backend id;
 };
 
+/* Maximum number of NIOS II write requests queued within a batch scope
+ * before they are issued */
+#define NIOS_BATCH_MAX_REQUESTS 64
+
+/* Whether the FPGA accepts RFIC batch requests (see nios_pkt_rfic_batch.h)
+ * or AD9361 batch requests (see nios_pkt_ad9361_batch.h) */
+enum nios_rfic_batch_support {
+    NIOS_RFIC_BATCH_UNKNOWN = 0,    /* Not yet probed since the FPGA loaded */
+    NIOS_RFIC_BATCH_UNSUPPORTED,
+    NIOS_RFIC_BATCH_SUPPORTED,
+};
+
+/* NIOS II write requests queued within a batch scope. See nios_batch_begin() */
+struct nios_batch {
+    unsigned int depth;     /* Nesting depth of begin calls */
+    unsigned int count;     /* Number of queued requests */
+    int status;             /* First failure since the outermost begin */
+    enum nios_rfic_batch_support rfic_batch;
+    enum nios_rfic_batch_support ad9361_batch;
+    uint8_t requests[NIOS_BATCH_MAX_REQUESTS][NIOS_PKT_LEN];
+};
+
+/* NIOS II request round-trip times, per packet type. Failed requests are
+ * only counted, so they do not skew the histograms with their timeouts. */
+struct nios_ctrl_stats {
+    struct latency_hist hist[BLADERF_CONTROL_PKT_COUNT];
+    uint64_t errors[BLADERF_CONTROL_PKT_COUNT];
+};
+
 struct bladerf_usb {
     const struct usb_fns *fn;
     void *driver;
+    struct nios_batch batch;
+
+    /* Allocated while control request statistics are enabled */
+    struct nios_ctrl_stats *ctrl_stats;
+
+    /* Host-side copies of LMS6002D and Si5338 registers */
+    struct reg_shadow lms_shadow;
+    struct reg_shadow si5338_shadow;
+
+    /* Set while the NIOS II may change LMS6002D or Si5338 registers at a
+     * time the host cannot know: while scheduled retunes or timed writes
+     * are queued for a direction, or an RX DC calibration sweep runs. Reads
+     * bypass the shadow meanwhile, and it is invalidated once they finish. */
+    bool lms_queued[2];
+    bool si5338_queued[2];
+    bool dc_sweep_running;
+
+    /* Directions whose RF link the FX3 has been told to enable, to be
+     * enabled again after a reset */
+    bool rf_enabled[2];
 };
 
 #endif
@@ -29,28 +29,50 @@
 
 #include "log.h"
 #include "rel_assert.h"
+#include "bladeRF.h"
 #define LOGGER_ID_STRING
 #include "logger_entry.h"
 #include "logger_id.h"
 
 #include "backend/backend.h"
+#include "backend/backend_config.h"
 #include "backend/usb/usb.h"
 #include "board/board.h"
 #include "conversions.h"
+#include "minmax.h"
 #include "driver/fx3_fw.h"
 #include "device_calibration.h"
 #include "streaming/async.h"
+#include "streaming/convert.h"
+#include "streaming/correction.h"
+#include "streaming/format.h"
+#include "streaming/sync.h"
 #include "version.h"
 
 #include "expansion/xb100.h"
 #include "expansion/xb200.h"
 #include "expansion/xb300.h"
 
+#include "agc.h"
 #include "devinfo.h"
+#include "metrics.h"
+#include "stream_pool.h"
+#include "stream_recovery.h"
 #include "helpers/configfile.h"
+#include "helpers/ctrl_queue.h"
+#include "helpers/dev_lock.h"
 #include "helpers/file.h"
+#include "helpers/fpga_image.h"
 #include "helpers/have_cap.h"
+#include "helpers/hop_table.h"
+#include "helpers/tune_cache.h"
 #include "helpers/interleave.h"
+#include "helpers/telemetry.h"
+#include "helpers/timestamp_corr.h"
+#include "helpers/trace.h"
+#include "helpers/rx_history.h"
+#include "helpers/tx_sched.h"
+#include "helpers/wallclock.h"
 
 #define CHECK_NULL(...) do { \
     const void* _args[] = { __VA_ARGS__, NULL }; \
@@ -149,6 +171,21 @@ int bladerf_open_with_devinfo(struct bladerf **opened_device,
     }
 
     MUTEX_INIT(&dev->lock);
+    MUTEX_INIT(&dev->ts_corr_lock);
+    MUTEX_INIT(&dev->ctrl_queue_lock);
+    MUTEX_INIT(&dev->tx_sched_lock);
+    MUTEX_INIT(&dev->rx_history_lock);
+    MUTEX_INIT(&dev->hop_lock);
+    MUTEX_INIT(&dev->telemetry_lock);
+    MUTEX_INIT(&dev->metrics_lock);
+    MUTEX_INIT(&dev->host_corr_lock);
+    MUTEX_INIT(&dev->agc_lock);
+    MUTEX_INIT(&dev->recovery_lock);
+
+    /* Released in bladerf_close() */
+    trace_register();
+
+    dev->gain_cal_resolution = BLADERF_GAIN_CAL_RESOLUTION_DEFAULT;
 
     /* Open board */
     status = dev->board->open(dev, devinfo);
@@ -202,25 +239,114 @@ int bladerf_get_backendinfo(struct bladerf *dev, struct bladerf_backendinfo *inf
 void bladerf_close(struct bladerf *dev)
 {
     if (dev) {
+        /* The control queue, TX scheduler, RX history, hop tables, and
+         * correlation services take the device lock, so they must be stopped
+         * before it is held here. Any queued control operations and TX bursts
+         * are carried out first. */
+        struct ctrl_queue *ctrl_queue;
+
+        MUTEX_LOCK(&dev->ctrl_queue_lock);
+        ctrl_queue              = dev->ctrl_queue;
+        dev->ctrl_queue         = NULL;
+        dev->ctrl_queue_closing = true;
+        MUTEX_UNLOCK(&dev->ctrl_queue_lock);
+
+        /* The lock is not held while the worker is joined, as completion
+         * callbacks may still try to submit operations */
+        ctrl_queue_stop(ctrl_queue);
+
+        MUTEX_LOCK(&dev->tx_sched_lock);
+        tx_sched_stop(dev->tx_sched);
+        dev->tx_sched = NULL;
+        MUTEX_UNLOCK(&dev->tx_sched_lock);
+
+        MUTEX_LOCK(&dev->rx_history_lock);
+        rx_history_stop(dev->rx_history);
+        dev->rx_history = NULL;
+        MUTEX_UNLOCK(&dev->rx_history_lock);
+
+        MUTEX_LOCK(&dev->hop_lock);
+        for (size_t i = 0; i < ARRAY_SIZE(dev->hop_table); i++) {
+            hop_table_free(dev->hop_table[i]);
+            dev->hop_table[i] = NULL;
+        }
+        MUTEX_UNLOCK(&dev->hop_lock);
+
+        MUTEX_LOCK(&dev->metrics_lock);
+        metrics_stop(dev->metrics);
+        dev->metrics = NULL;
+        MUTEX_UNLOCK(&dev->metrics_lock);
+
+        MUTEX_LOCK(&dev->telemetry_lock);
+        telemetry_stop(dev->telemetry);
+        dev->telemetry = NULL;
+        MUTEX_UNLOCK(&dev->telemetry_lock);
+
+        MUTEX_LOCK(&dev->ts_corr_lock);
+        timestamp_corr_stop(dev->ts_corr[BLADERF_RX]);
+        timestamp_corr_stop(dev->ts_corr[BLADERF_TX]);
+        dev->ts_corr[BLADERF_RX] = NULL;
+        dev->ts_corr[BLADERF_TX] = NULL;
+        MUTEX_UNLOCK(&dev->ts_corr_lock);
+
         MUTEX_LOCK(&dev->lock);
 
         dev->board->close(dev);
 
+        /* The sync streams have freed their buffers by now */
+        stream_pool_detach(dev->stream_pool);
+        dev->stream_pool = NULL;
+
         if (dev->backend) {
             dev->backend->close(dev);
         }
 
         /** Free gain table entries */
         for (int i = 0; i < NUM_GAIN_CAL_TBLS; i++) {
-            gain_cal_tbl_free(&dev->gain_tbls[i]);
+            gain_cal_unload(dev, i);
+        }
+
+        for (size_t i = 0; i < ARRAY_SIZE(dev->tune_cache); i++) {
+            tune_cache_free(dev->tune_cache[i]);
+            dev->tune_cache[i] = NULL;
+        }
+
+        for (size_t i = 0; i < ARRAY_SIZE(dev->host_corr); i++) {
+            host_corr_free(dev->host_corr[i]);
+            dev->host_corr[i] = NULL;
         }
 
         MUTEX_UNLOCK(&dev->lock);
 
+        MUTEX_DESTROY(&dev->ts_corr_lock);
+        MUTEX_DESTROY(&dev->ctrl_queue_lock);
+        MUTEX_DESTROY(&dev->tx_sched_lock);
+        MUTEX_DESTROY(&dev->rx_history_lock);
+        MUTEX_DESTROY(&dev->hop_lock);
+        MUTEX_DESTROY(&dev->telemetry_lock);
+        MUTEX_DESTROY(&dev->metrics_lock);
+        MUTEX_DESTROY(&dev->host_corr_lock);
+        agc_free(dev);
+        MUTEX_DESTROY(&dev->agc_lock);
+        MUTEX_DESTROY(&dev->recovery_lock);
         free(dev);
+
+        trace_unregister();
     }
 }
 
+#ifndef ENABLE_BACKEND_NET
+/* The network backend provides these when it is built */
+int bladerf_net_serve(struct bladerf *dev, const char *address, uint16_t port)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+void bladerf_net_serve_stop(struct bladerf *dev)
+{
+}
+#endif
+
 /******************************************************************************/
 /* FX3 Firmware (common to bladerf1 and bladerf2) */
 /******************************************************************************/
@@ -294,14 +420,18 @@ int bladerf_load_fw_from_bootloader(const char *device_identifier,
 
 int bladerf_get_fw_log(struct bladerf *dev, const char *filename)
 {
-    int status;
+    int status = 0;
     FILE *f = NULL;
-    logger_entry e;
+    logger_entry entries[LOG_READ_MAX_ENTRIES];
+    unsigned int count;
+    unsigned int i;
+    bool done = false;
+    uint64_t capabilities;
 
     MUTEX_LOCK(&dev->lock);
+    capabilities = dev->board->get_capabilities(dev);
 
-    if (!have_cap(dev->board->get_capabilities(dev),
-                  BLADERF_CAP_READ_FW_LOG_ENTRY)) {
+    if (!have_cap(capabilities, BLADERF_CAP_READ_FW_LOG_ENTRY)) {
         struct bladerf_version fw_version;
 
         if (dev->board->get_fw_version(dev, &fw_version) == 0) {
@@ -309,56 +439,74 @@ int bladerf_get_fw_log(struct bladerf *dev, const char *filename)
                       fw_version.describe);
         }
 
-        status = BLADERF_ERR_UNSUPPORTED;
-        goto error;
+        MUTEX_UNLOCK(&dev->lock);
+        return BLADERF_ERR_UNSUPPORTED;
     }
 
+    MUTEX_UNLOCK(&dev->lock);
+
+    /* Firmware with BLADERF_CAP_FW_LOG_ENTRIES drains a batch of entries per
+     * request; older firmware returns one at a time */
+    count = have_cap(capabilities, BLADERF_CAP_FW_LOG_ENTRIES)
+                ? LOG_READ_MAX_ENTRIES
+                : 1;
+
     if (filename != NULL) {
         f = fopen(filename, "w");
         if (f == NULL) {
             switch (errno) {
                 case ENOENT:
-                    status = BLADERF_ERR_NO_FILE;
-                    break;
+                    return BLADERF_ERR_NO_FILE;
                 case EACCES:
-                    status = BLADERF_ERR_PERMISSION;
-                    break;
+                    return BLADERF_ERR_PERMISSION;
                 default:
-                    status = BLADERF_ERR_IO;
-                    break;
+                    return BLADERF_ERR_IO;
             }
-            goto error;
         }
     } else {
         f = stdout;
     }
 
-    do {
-        status = dev->backend->read_fw_log(dev, &e);
+    /* The device lock is held only for each request, so that other threads'
+     * control and NIOS accesses are interleaved with a long drain */
+    while (!done) {
+        MUTEX_LOCK(&dev->lock);
+
+        if (count == 1) {
+            status = dev->backend->read_fw_log(dev, &entries[0]);
+        } else {
+            status = dev->backend->read_fw_log_entries(dev, entries, count);
+        }
+
+        MUTEX_UNLOCK(&dev->lock);
+
         if (status != 0) {
             log_debug("Failed to read FW log: %s\n", bladerf_strerror(status));
-            goto error;
+            goto out;
         }
 
-        if (e == LOG_ERR) {
-            fprintf(f, "<Unexpected error>,,\n");
-        } else if (e != LOG_EOF) {
-            uint8_t file_id;
-            uint16_t line;
-            uint16_t data;
-            const char *src_file;
+        for (i = 0; i < count && !done; i++) {
+            if (entries[i] == LOG_ERR) {
+                fprintf(f, "<Unexpected error>,,\n");
+                done = true;
+            } else if (entries[i] == LOG_EOF) {
+                done = true;
+            } else {
+                uint8_t file_id;
+                uint16_t line;
+                uint16_t data;
+                const char *src_file;
 
-            logger_entry_unpack(e, &file_id, &line, &data);
-            src_file = logger_id_string(file_id);
+                logger_entry_unpack(entries[i], &file_id, &line, &data);
+                src_file = logger_id_string(file_id);
 
-            fprintf(f, "%s, %u, 0x%04x\n", src_file, line, data);
+                fprintf(f, "%s, %u, 0x%04x\n", src_file, line, data);
+            }
         }
-    } while (e != LOG_EOF && e != LOG_ERR);
-
-error:
-    MUTEX_UNLOCK(&dev->lock);
+    }
 
-    if (f != NULL && f != stdout) {
+out:
+    if (f != stdout) {
         fclose(f);
     }
 
@@ -819,14 +967,52 @@ int bladerf_get_bandwidth_range(struct bladerf *dev,
 /* Frequency */
 /******************************************************************************/
 
-int bladerf_set_frequency(struct bladerf *dev,
-                          bladerf_channel ch,
-                          bladerf_frequency frequency)
+/* Host-side corrections are only applied to RX channels */
+#define HOST_CORR_INDEX(ch) ((size_t)(ch) >> 1)
+#define HOST_CORR_CHANNEL_OK(ch) \
+    (!BLADERF_CHANNEL_IS_TX(ch) && HOST_CORR_INDEX(ch) < 2)
+
+/* Apply a channel's host-side correction table, if any, for the frequency it
+ * has been tuned to. Called with dev->lock held. */
+static void retune_host_corr(struct bladerf *dev,
+                             bladerf_channel ch,
+                             bladerf_frequency frequency)
+{
+    struct host_corr *hc;
+
+    if (!HOST_CORR_CHANNEL_OK(ch)) {
+        return;
+    }
+
+    MUTEX_LOCK(&dev->host_corr_lock);
+
+    hc = dev->host_corr[HOST_CORR_INDEX(ch)];
+    if (hc != NULL && hc->table != NULL) {
+        host_corr_apply_table(hc, frequency);
+        __atomic_add_fetch(&dev->host_corr_gen, 1, __ATOMIC_RELEASE);
+    }
+
+    MUTEX_UNLOCK(&dev->host_corr_lock);
+}
+
+/* Retune a channel, optionally leaving its synthesizer to lock */
+static int set_frequency(struct bladerf *dev,
+                         bladerf_channel ch,
+                         bladerf_frequency frequency,
+                         bool wait)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->set_frequency(dev, ch, frequency);
+    if ((size_t)ch < ARRAY_SIZE(dev->tune_cache) &&
+        dev->tune_cache[ch] != NULL) {
+        status = tune_cache_set_frequency(dev->tune_cache[ch], dev, ch,
+                                          frequency);
+    } else if (wait) {
+        status = dev->board->set_frequency(dev, ch, frequency);
+    } else {
+        status = dev->board->set_frequency_begin(dev, ch, frequency);
+    }
 
     if (dev->gain_tbls[ch].enabled && status == 0) {
         status = apply_gain_correction(dev, ch, frequency);
@@ -835,10 +1021,77 @@ int bladerf_set_frequency(struct bladerf *dev,
         }
     }
 
+    if (status == 0) {
+        retune_host_corr(dev, ch, frequency);
+    }
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_frequency(struct bladerf *dev,
+                          bladerf_channel ch,
+                          bladerf_frequency frequency)
+{
+    return set_frequency(dev, ch, frequency, true);
+}
+
+int bladerf_set_frequency_begin(struct bladerf *dev,
+                                bladerf_channel ch,
+                                bladerf_frequency frequency)
+{
+    return set_frequency(dev, ch, frequency, false);
+}
+
+int bladerf_get_pll_lock(struct bladerf *dev, bladerf_channel ch, bool *locked)
+{
+    int status;
+
+    CHECK_NULL(locked);
+
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->get_pll_lock(dev, ch, locked);
+
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
+/* Interval between polls while waiting for a synthesizer to lock. The
+ * AD9361 VCO calibration typically takes a few hundred microseconds. */
+#define PLL_LOCK_POLL_US 50
+
+int bladerf_wait_pll_lock(struct bladerf *dev,
+                          bladerf_channel ch,
+                          unsigned int timeout_ms)
+{
+    uint64_t deadline;
+    bool locked;
+    int status;
+
+    deadline = wallclock_get_monotonic_nsec() +
+               (uint64_t)timeout_ms * 1000000ULL;
+
+    while (true) {
+        status = bladerf_get_pll_lock(dev, ch, &locked);
+        if (status != 0) {
+            return status;
+        }
+
+        if (locked) {
+            return 0;
+        }
+
+        if (wallclock_get_monotonic_nsec() >= deadline) {
+            log_debug("%s: %s did not lock within %u ms\n", __FUNCTION__,
+                      channel2str(ch), timeout_ms);
+            return BLADERF_ERR_TIMEOUT;
+        }
+
+        usleep(PLL_LOCK_POLL_US);
+    }
+}
+
 int bladerf_get_frequency(struct bladerf *dev,
                           bladerf_channel ch,
                           bladerf_frequency *frequency)
@@ -974,7 +1227,7 @@ int bladerf_schedule_retune(struct bladerf *dev,
 
 {
     int status;
-    MUTEX_LOCK(&dev->lock);
+    dev_lock_urgent(dev);
 
     status =
         dev->board->schedule_retune(dev, ch, timestamp, frequency, quick_tune);
@@ -986,7 +1239,7 @@ int bladerf_schedule_retune(struct bladerf *dev,
 int bladerf_cancel_scheduled_retunes(struct bladerf *dev, bladerf_channel ch)
 {
     int status;
-    MUTEX_LOCK(&dev->lock);
+    dev_lock_urgent(dev);
 
     status = dev->board->cancel_scheduled_retunes(dev, ch);
 
@@ -994,619 +1247,2417 @@ int bladerf_cancel_scheduled_retunes(struct bladerf *dev, bladerf_channel ch)
     return status;
 }
 
-/******************************************************************************/
-/* DC/Phase/Gain Correction */
-/******************************************************************************/
-
-int bladerf_get_correction(struct bladerf *dev,
-                           bladerf_channel ch,
-                           bladerf_correction corr,
-                           bladerf_correction_value *value)
+int bladerf_get_retune_queue_status(struct bladerf *dev,
+                                    bladerf_channel ch,
+                                    struct bladerf_retune_queue_status *status)
 {
-    int status;
-    MUTEX_LOCK(&dev->lock);
+    int stat;
+    dev_lock_urgent(dev);
 
-    status = dev->board->get_correction(dev, ch, corr, value);
+    stat = dev->board->get_retune_queue_status(dev, ch, status);
 
     MUTEX_UNLOCK(&dev->lock);
-    return status;
+    return stat;
 }
 
-int bladerf_set_correction(struct bladerf *dev,
-                           bladerf_channel ch,
-                           bladerf_correction corr,
-                           bladerf_correction_value value)
+int bladerf_cancel_scheduled_retunes_range(struct bladerf *dev,
+                                           bladerf_channel ch,
+                                           bladerf_timestamp start,
+                                           bladerf_timestamp end,
+                                           unsigned int *canceled)
 {
     int status;
-    MUTEX_LOCK(&dev->lock);
+    dev_lock_urgent(dev);
 
-    status = dev->board->set_correction(dev, ch, corr, value);
+    status = dev->board->cancel_scheduled_retunes_range(dev, ch, start, end,
+                                                        canceled);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-/******************************************************************************/
-/* Trigger */
-/******************************************************************************/
-
-int bladerf_trigger_init(struct bladerf *dev,
-                         bladerf_channel ch,
-                         bladerf_trigger_signal signal,
-                         struct bladerf_trigger *trigger)
+int bladerf_schedule_write(struct bladerf *dev,
+                           bladerf_channel ch,
+                           bladerf_timestamp timestamp,
+                           bladerf_timed_write_target target,
+                           uint32_t value)
 {
     int status;
-    MUTEX_LOCK(&dev->lock);
+    dev_lock_urgent(dev);
 
-    status = dev->board->trigger_init(dev, ch, signal, trigger);
+    status = dev->board->schedule_write(dev, ch, timestamp, target, value);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_trigger_arm(struct bladerf *dev,
-                        const struct bladerf_trigger *trigger,
-                        bool arm,
-                        uint64_t resv1,
-                        uint64_t resv2)
+/******************************************************************************/
+/* Quick Tune Cache */
+/******************************************************************************/
+
+int bladerf_set_quick_tune_cache(struct bladerf *dev,
+                                 bladerf_channel ch,
+                                 unsigned int capacity)
 {
     int status;
-    MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->trigger_arm(dev, trigger, arm, resv1, resv2);
-
-    MUTEX_UNLOCK(&dev->lock);
-    return status;
-}
+    if ((size_t)ch >= ARRAY_SIZE(dev->tune_cache) ||
+        capacity > BLADERF_QUICK_TUNE_CACHE_MAX) {
+        return BLADERF_ERR_INVAL;
+    }
 
-int bladerf_trigger_fire(struct bladerf *dev,
-                         const struct bladerf_trigger *trigger)
-{
-    int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->trigger_fire(dev, trigger);
+    if (capacity > 0 && (dev->board->get_capabilities(dev) &
+                         BLADERF_CAP_SCHEDULED_RETUNE) == 0) {
+        log_debug("%s: FPGA does not support scheduled retunes\n",
+                  __FUNCTION__);
+        status = BLADERF_ERR_UNSUPPORTED;
+    } else if (capacity == 0 && dev->tune_cache[ch] == NULL) {
+        status = 0;
+    } else {
+        status = tune_cache_set_capacity(&dev->tune_cache[ch], capacity);
+    }
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_trigger_state(struct bladerf *dev,
-                          const struct bladerf_trigger *trigger,
-                          bool *is_armed,
-                          bool *has_fired,
-                          bool *fire_requested,
-                          uint64_t *reserved1,
-                          uint64_t *reserved2)
+int bladerf_invalidate_quick_tune_cache(struct bladerf *dev)
 {
-    int status;
     MUTEX_LOCK(&dev->lock);
-
-    status = dev->board->trigger_state(dev, trigger, is_armed, has_fired,
-                                       fire_requested, reserved1, reserved2);
-
+    tune_cache_invalidate_all(dev);
     MUTEX_UNLOCK(&dev->lock);
-    return status;
+
+    return 0;
 }
 
 /******************************************************************************/
-/* Streaming */
+/* Frequency Hopping */
 /******************************************************************************/
 
-int bladerf_init_stream(struct bladerf_stream **stream,
-                        struct bladerf *dev,
-                        bladerf_stream_cb callback,
-                        void ***buffers,
-                        size_t num_buffers,
-                        bladerf_format format,
-                        size_t samples_per_buffer,
-                        size_t num_transfers,
-                        void *data)
+#define CHECK_HOP_CHANNEL(dev, ch)                                     \
+    do {                                                               \
+        if ((size_t)(ch) >= ARRAY_SIZE((dev)->hop_table)) {            \
+            log_debug("%s: Invalid channel: %d\n", __FUNCTION__, ch); \
+            return BLADERF_ERR_INVAL;                                  \
+        }                                                              \
+    } while (0)
+
+int bladerf_load_hop_table(struct bladerf *dev,
+                           bladerf_channel ch,
+                           const bladerf_frequency *frequencies,
+                           unsigned int num_frequencies)
 {
+    struct hop_table *table = NULL;
     int status;
-    bladerf_sample_rate tx_samp_rate;
-    bladerf_sample_rate rx_samp_rate;
-    MUTEX_LOCK(&dev->lock);
 
-    if (format == BLADERF_FORMAT_SC8_Q7 || format == BLADERF_FORMAT_SC8_Q7_META) {
-        if (strcmp(bladerf_get_board_name(dev), "bladerf2") != 0) {
-            log_error("bladeRF 2.0 required for 8bit format\n");
-            return BLADERF_ERR_UNSUPPORTED;
-        }
-    }
+    CHECK_NULL(frequencies);
+    CHECK_HOP_CHANNEL(dev, ch);
 
-    status = dev->board->init_stream(stream, dev, callback, buffers,
-                                     num_buffers, format, samples_per_buffer,
-                                     num_transfers, data);
+    MUTEX_LOCK(&dev->hop_lock);
 
-    dev->board->get_sample_rate(dev, BLADERF_MODULE_TX, &tx_samp_rate);
-    if (tx_samp_rate) {
-        if (tx_samp_rate < num_transfers * samples_per_buffer / (*stream)->transfer_timeout) {
-            log_warning("TX samples may be dropped.\n");
-            log_warning("Condition to meet: samp_rate > num_transfers * samples_per_buffer / transfer_timeout\n");
-        }
-    }
+    hop_table_free(dev->hop_table[ch]);
+    dev->hop_table[ch] = NULL;
 
-    dev->board->get_sample_rate(dev, BLADERF_MODULE_RX, &rx_samp_rate);
-    if (rx_samp_rate) {
-        if (rx_samp_rate < num_transfers * samples_per_buffer / (*stream)->transfer_timeout) {
-            log_warning("RX samples may be dropped.\n");
-            log_warning("Condition to meet: samp_rate > num_transfers * samples_per_buffer / transfer_timeout\n");
-        }
+    status = hop_table_create(&table, dev, ch, frequencies, num_frequencies);
+    if (status == 0) {
+        dev->hop_table[ch] = table;
     }
 
-    MUTEX_UNLOCK(&dev->lock);
+    MUTEX_UNLOCK(&dev->hop_lock);
     return status;
 }
 
-int bladerf_stream(struct bladerf_stream *stream, bladerf_channel_layout layout)
+int bladerf_free_hop_table(struct bladerf *dev, bladerf_channel ch)
 {
-    return stream->dev->board->stream(stream, layout);
-}
+    CHECK_HOP_CHANNEL(dev, ch);
 
-int bladerf_submit_stream_buffer(struct bladerf_stream *stream,
-                                 void *buffer,
-                                 unsigned int timeout_ms)
-{
-    return stream->dev->board->submit_stream_buffer(stream, buffer, timeout_ms,
-                                                    false);
-}
+    MUTEX_LOCK(&dev->hop_lock);
 
-int bladerf_submit_stream_buffer_nb(struct bladerf_stream *stream, void *buffer)
-{
-    return stream->dev->board->submit_stream_buffer(stream, buffer, 0, true);
+    hop_table_free(dev->hop_table[ch]);
+    dev->hop_table[ch] = NULL;
+
+    MUTEX_UNLOCK(&dev->hop_lock);
+    return 0;
 }
 
-void bladerf_deinit_stream(struct bladerf_stream *stream)
+int bladerf_start_hopping(struct bladerf *dev,
+                          bladerf_channel ch,
+                          bladerf_timestamp start,
+                          uint64_t dwell)
 {
-    if (stream) {
-        stream->dev->board->deinit_stream(stream);
+    int status;
+
+    CHECK_HOP_CHANNEL(dev, ch);
+
+    MUTEX_LOCK(&dev->hop_lock);
+
+    if (dev->hop_table[ch] == NULL) {
+        status = BLADERF_ERR_NOT_INIT;
+    } else {
+        status = hop_table_start(dev->hop_table[ch], start, dwell);
     }
+
+    MUTEX_UNLOCK(&dev->hop_lock);
+    return status;
 }
 
-int bladerf_set_stream_timeout(struct bladerf *dev,
-                               bladerf_direction dir,
-                               unsigned int timeout)
+int bladerf_enqueue_hops(struct bladerf *dev,
+                         bladerf_channel ch,
+                         const unsigned int *indices,
+                         unsigned int count)
 {
     int status;
-    MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->set_stream_timeout(dev, dir, timeout);
+    CHECK_NULL(indices);
+    CHECK_HOP_CHANNEL(dev, ch);
 
-    MUTEX_UNLOCK(&dev->lock);
+    MUTEX_LOCK(&dev->hop_lock);
+
+    if (dev->hop_table[ch] == NULL) {
+        status = BLADERF_ERR_NOT_INIT;
+    } else {
+        status = hop_table_enqueue(dev->hop_table[ch], indices, count);
+    }
+
+    MUTEX_UNLOCK(&dev->hop_lock);
     return status;
 }
 
-int bladerf_get_stream_timeout(struct bladerf *dev,
-                               bladerf_direction dir,
-                               unsigned int *timeout)
+int bladerf_get_hop_status(struct bladerf *dev,
+                           bladerf_channel ch,
+                           unsigned int *pending,
+                           bladerf_timestamp *next)
 {
     int status;
-    MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_stream_timeout(dev, dir, timeout);
+    CHECK_HOP_CHANNEL(dev, ch);
 
-    MUTEX_UNLOCK(&dev->lock);
-    return status;
-}
+    MUTEX_LOCK(&dev->hop_lock);
 
-int bladerf_sync_config(struct bladerf *dev,
-                        bladerf_channel_layout layout,
+    if (dev->hop_table[ch] == NULL) {
+        status = BLADERF_ERR_NOT_INIT;
+    } else {
+        status = hop_table_status(dev->hop_table[ch], pending, next);
+    }
+
+    MUTEX_UNLOCK(&dev->hop_lock);
+    return status;
+}
+
+/******************************************************************************/
+/* DC/Phase/Gain Correction */
+/******************************************************************************/
+
+int bladerf_get_correction(struct bladerf *dev,
+                           bladerf_channel ch,
+                           bladerf_correction corr,
+                           bladerf_correction_value *value)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    MUTEX_LOCK(&dev->host_corr_lock);
+    if (HOST_CORR_CHANNEL_OK(ch) && dev->host_corr[HOST_CORR_INDEX(ch)]) {
+        struct host_corr *hc = dev->host_corr[HOST_CORR_INDEX(ch)];
+
+        if ((unsigned int)corr < ARRAY_SIZE(hc->value)) {
+            *value = hc->value[corr];
+            status = 0;
+        } else {
+            status = BLADERF_ERR_INVAL;
+        }
+
+        MUTEX_UNLOCK(&dev->host_corr_lock);
+        MUTEX_UNLOCK(&dev->lock);
+        return status;
+    }
+    MUTEX_UNLOCK(&dev->host_corr_lock);
+
+    status = dev->board->get_correction(dev, ch, corr, value);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_correction(struct bladerf *dev,
+                           bladerf_channel ch,
+                           bladerf_correction corr,
+                           bladerf_correction_value value)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    MUTEX_LOCK(&dev->host_corr_lock);
+    if (HOST_CORR_CHANNEL_OK(ch) && dev->host_corr[HOST_CORR_INDEX(ch)]) {
+        struct host_corr *hc = dev->host_corr[HOST_CORR_INDEX(ch)];
+
+        if (host_corr_valid(corr, value)) {
+            hc->value[corr] = value;
+            __atomic_add_fetch(&dev->host_corr_gen, 1, __ATOMIC_RELEASE);
+            status = 0;
+        } else {
+            log_debug("%s: Invalid value for correction %d: %d\n",
+                      __FUNCTION__, corr, value);
+            status = BLADERF_ERR_INVAL;
+        }
+
+        MUTEX_UNLOCK(&dev->host_corr_lock);
+        MUTEX_UNLOCK(&dev->lock);
+        return status;
+    }
+    MUTEX_UNLOCK(&dev->host_corr_lock);
+
+    status = dev->board->set_correction(dev, ch, corr, value);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_enable_host_correction(struct bladerf *dev,
+                                   bladerf_channel ch,
+                                   bool enable)
+{
+    struct host_corr **hc;
+    int status = 0;
+
+    if (BLADERF_CHANNEL_IS_TX(ch)) {
+        log_debug("%s: Only RX channels may be corrected\n", __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    } else if (!HOST_CORR_CHANNEL_OK(ch)) {
+        log_debug("%s: Invalid channel: %d\n", __FUNCTION__, ch);
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->host_corr_lock);
+
+    hc = &dev->host_corr[HOST_CORR_INDEX(ch)];
+
+    if (enable && *hc == NULL) {
+        *hc = calloc(1, sizeof(**hc));
+        if (*hc == NULL) {
+            status = BLADERF_ERR_MEM;
+        }
+    } else if (!enable) {
+        host_corr_free(*hc);
+        *hc = NULL;
+    }
+
+    if (status == 0) {
+        __atomic_add_fetch(&dev->host_corr_gen, 1, __ATOMIC_RELEASE);
+    }
+
+    MUTEX_UNLOCK(&dev->host_corr_lock);
+    return status;
+}
+
+int bladerf_get_host_correction(struct bladerf *dev,
+                                bladerf_channel ch,
+                                bool *enabled)
+{
+    CHECK_NULL(enabled);
+
+    MUTEX_LOCK(&dev->host_corr_lock);
+    *enabled = HOST_CORR_CHANNEL_OK(ch) &&
+               dev->host_corr[HOST_CORR_INDEX(ch)] != NULL;
+    MUTEX_UNLOCK(&dev->host_corr_lock);
+
+    return 0;
+}
+
+int bladerf_load_host_correction_table(
+    struct bladerf *dev,
+    bladerf_channel ch,
+    const struct bladerf_correction_entry *entries,
+    unsigned int num_entries)
+{
+    struct bladerf_correction_entry *table = NULL;
+    bladerf_frequency frequency = 0;
+    struct host_corr *hc;
+    unsigned int i;
+    int status = 0;
+
+    if (!HOST_CORR_CHANNEL_OK(ch)) {
+        log_debug("%s: Invalid channel: %d\n", __FUNCTION__, ch);
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (num_entries != 0) {
+        CHECK_NULL(entries);
+
+        for (i = 0; i < num_entries; i++) {
+            const struct bladerf_correction_entry *e = &entries[i];
+
+            if ((i > 0 && e->frequency <= entries[i - 1].frequency) ||
+                !host_corr_valid(BLADERF_CORR_DCOFF_I, e->dcoff_i) ||
+                !host_corr_valid(BLADERF_CORR_DCOFF_Q, e->dcoff_q) ||
+                !host_corr_valid(BLADERF_CORR_PHASE, e->phase) ||
+                !host_corr_valid(BLADERF_CORR_GAIN, e->gain)) {
+                log_debug("%s: Invalid entry %u\n", __FUNCTION__, i);
+                return BLADERF_ERR_INVAL;
+            }
+        }
+
+        table = malloc(num_entries * sizeof(table[0]));
+        if (table == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+
+        memcpy(table, entries, num_entries * sizeof(table[0]));
+    }
+
+    /* Held across the lookup of the current frequency, so that a concurrent
+     * retune cannot be missed */
+    MUTEX_LOCK(&dev->lock);
+
+    if (table != NULL) {
+        status = dev->board->get_frequency(dev, ch, &frequency);
+    }
+
+    MUTEX_LOCK(&dev->host_corr_lock);
+
+    hc = dev->host_corr[HOST_CORR_INDEX(ch)];
+    if (hc == NULL) {
+        status = BLADERF_ERR_NOT_INIT;
+    }
+
+    if (status == 0) {
+        free(hc->table);
+        hc->table     = table;
+        hc->table_len = num_entries;
+        table         = NULL;
+
+        if (hc->table != NULL) {
+            host_corr_apply_table(hc, frequency);
+            __atomic_add_fetch(&dev->host_corr_gen, 1, __ATOMIC_RELEASE);
+        }
+    }
+
+    MUTEX_UNLOCK(&dev->host_corr_lock);
+    MUTEX_UNLOCK(&dev->lock);
+
+    free(table);
+    return status;
+}
+
+/******************************************************************************/
+/* Trigger */
+/******************************************************************************/
+
+int bladerf_trigger_init(struct bladerf *dev,
+                         bladerf_channel ch,
+                         bladerf_trigger_signal signal,
+                         struct bladerf_trigger *trigger)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->trigger_init(dev, ch, signal, trigger);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_trigger_arm(struct bladerf *dev,
+                        const struct bladerf_trigger *trigger,
+                        bool arm,
+                        uint64_t resv1,
+                        uint64_t resv2)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->trigger_arm(dev, trigger, arm, resv1, resv2);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_trigger_fire(struct bladerf *dev,
+                         const struct bladerf_trigger *trigger)
+{
+    int status;
+    dev_lock_urgent(dev);
+
+    status = dev->board->trigger_fire(dev, trigger);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_trigger_state(struct bladerf *dev,
+                          const struct bladerf_trigger *trigger,
+                          bool *is_armed,
+                          bool *has_fired,
+                          bool *fire_requested,
+                          uint64_t *reserved1,
+                          uint64_t *reserved2)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->trigger_state(dev, trigger, is_armed, has_fired,
+                                       fire_requested, reserved1, reserved2);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_get_trigger_time(struct bladerf *dev,
+                             const struct bladerf_trigger *trigger,
+                             struct bladerf_trigger_time *time)
+{
+    int status;
+
+    CHECK_NULL(trigger, time);
+
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->get_trigger_time(dev, trigger, time);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+/******************************************************************************/
+/* Streaming */
+/******************************************************************************/
+
+static int init_stream(struct bladerf_stream **stream,
+                       struct bladerf *dev,
+                       bladerf_stream_cb callback,
+                       void ***buffers,
+                       size_t num_buffers,
+                       bladerf_format format,
+                       size_t samples_per_buffer,
+                       size_t num_transfers,
+                       void *data,
+                       const struct bladerf_buffer_allocator *allocator)
+{
+    int status;
+    bladerf_sample_rate tx_samp_rate;
+    bladerf_sample_rate rx_samp_rate;
+    MUTEX_LOCK(&dev->lock);
+
+    if (format == BLADERF_FORMAT_SC8_Q7 || format == BLADERF_FORMAT_SC8_Q7_META) {
+        if (strcmp(bladerf_get_board_name(dev), "bladerf2") != 0) {
+            log_error("bladeRF 2.0 required for 8bit format\n");
+            MUTEX_UNLOCK(&dev->lock);
+            return BLADERF_ERR_UNSUPPORTED;
+        }
+    }
+
+    if (format == BLADERF_FORMAT_SC12_PACKED ||
+        format == BLADERF_FORMAT_SC12_PACKED_META) {
+        if (strcmp(bladerf_get_board_name(dev), "bladerf2") != 0) {
+            log_error("bladeRF 2.0 required for 12bit packed format\n");
+            MUTEX_UNLOCK(&dev->lock);
+            return BLADERF_ERR_UNSUPPORTED;
+        }
+    }
+
+    status = dev->board->init_stream(stream, dev, callback, buffers,
+                                     num_buffers, format, samples_per_buffer,
+                                     num_transfers, data, allocator);
+    if (status != 0) {
+        MUTEX_UNLOCK(&dev->lock);
+        return status;
+    }
+
+    dev->board->get_sample_rate(dev, BLADERF_MODULE_TX, &tx_samp_rate);
+    if (tx_samp_rate) {
+        if (tx_samp_rate < num_transfers * samples_per_buffer / (*stream)->transfer_timeout) {
+            log_warning("TX samples may be dropped.\n");
+            log_warning("Condition to meet: samp_rate > num_transfers * samples_per_buffer / transfer_timeout\n");
+        }
+    }
+
+    dev->board->get_sample_rate(dev, BLADERF_MODULE_RX, &rx_samp_rate);
+    if (rx_samp_rate) {
+        if (rx_samp_rate < num_transfers * samples_per_buffer / (*stream)->transfer_timeout) {
+            log_warning("RX samples may be dropped.\n");
+            log_warning("Condition to meet: samp_rate > num_transfers * samples_per_buffer / transfer_timeout\n");
+        }
+    }
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_init_stream(struct bladerf_stream **stream,
+                        struct bladerf *dev,
+                        bladerf_stream_cb callback,
+                        void ***buffers,
+                        size_t num_buffers,
                         bladerf_format format,
-                        unsigned int num_buffers,
-                        unsigned int buffer_size,
-                        unsigned int num_transfers,
-                        unsigned int stream_timeout)
+                        size_t samples_per_buffer,
+                        size_t num_transfers,
+                        void *data)
+{
+    return init_stream(stream, dev, callback, buffers, num_buffers, format,
+                       samples_per_buffer, num_transfers, data, NULL);
+}
+
+int bladerf_init_stream_with_allocator(
+    struct bladerf_stream **stream,
+    struct bladerf *dev,
+    bladerf_stream_cb callback,
+    void ***buffers,
+    size_t num_buffers,
+    bladerf_format format,
+    size_t samples_per_buffer,
+    size_t num_transfers,
+    void *data,
+    const struct bladerf_buffer_allocator *allocator)
+{
+    return init_stream(stream, dev, callback, buffers, num_buffers, format,
+                       samples_per_buffer, num_transfers, data, allocator);
+}
+
+int bladerf_init_stream_batch(struct bladerf_stream **stream,
+                              struct bladerf *dev,
+                              bladerf_stream_batch_cb callback,
+                              void ***buffers,
+                              size_t num_buffers,
+                              bladerf_format format,
+                              size_t samples_per_buffer,
+                              size_t num_transfers,
+                              void *data)
+{
+    int status;
+
+    CHECK_NULL(stream);
+
+    if (callback == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (format == BLADERF_FORMAT_PACKET_META) {
+        log_debug("%s: The packet format is not supported\n", __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    status = bladerf_init_stream(stream, dev, async_batch_collect, buffers,
+                                 num_buffers, format, samples_per_buffer,
+                                 num_transfers, NULL);
+    if (status != 0) {
+        return status;
+    }
+
+    status = async_enable_batch(*stream, callback, data);
+    if (status != 0) {
+        bladerf_deinit_stream(*stream);
+        *stream = NULL;
+    }
+
+    return status;
+}
+
+int bladerf_stream(struct bladerf_stream *stream, bladerf_channel_layout layout)
+{
+    return stream->dev->board->stream(stream, layout);
+}
+
+int bladerf_submit_stream_buffer(struct bladerf_stream *stream,
+                                 void *buffer,
+                                 unsigned int timeout_ms)
+{
+    return stream->dev->board->submit_stream_buffer(stream, buffer, timeout_ms,
+                                                    false);
+}
+
+int bladerf_submit_stream_buffer_nb(struct bladerf_stream *stream, void *buffer)
+{
+    return stream->dev->board->submit_stream_buffer(stream, buffer, 0, true);
+}
+
+int bladerf_stream_set_thread_attrs(struct bladerf_stream *stream,
+                                    const struct bladerf_thread_attrs *attrs)
+{
+    CHECK_NULL(stream);
+
+    return async_set_thread_attrs(stream, attrs);
+}
+
+void bladerf_deinit_stream(struct bladerf_stream *stream)
+{
+    if (stream) {
+        stream->dev->board->deinit_stream(stream);
+    }
+}
+
+int bladerf_set_stream_timeout(struct bladerf *dev,
+                               bladerf_direction dir,
+                               unsigned int timeout)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->set_stream_timeout(dev, dir, timeout);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_get_stream_timeout(struct bladerf *dev,
+                               bladerf_direction dir,
+                               unsigned int *timeout)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->get_stream_timeout(dev, dir, timeout);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_sync_wait_policy(struct bladerf *dev,
+                                 bladerf_direction dir,
+                                 bladerf_sync_wait_policy policy,
+                                 unsigned int spin_us)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->set_sync_wait_policy(dev, dir, policy, spin_us);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_get_stream_stats(struct bladerf *dev,
+                             bladerf_direction dir,
+                             struct bladerf_stream_stats *stats)
+{
+    int status;
+    CHECK_NULL(stats);
+
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->get_stream_stats(dev, dir, stats);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_sync_thread_attrs(struct bladerf *dev,
+                                  bladerf_direction dir,
+                                  const struct bladerf_thread_attrs *attrs)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->set_sync_thread_attrs(dev, dir, attrs);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_stream_memory_flags(struct bladerf *dev, uint32_t flags)
+{
+    uint32_t const valid = BLADERF_STREAM_MEM_PREFAULT |
+                           BLADERF_STREAM_MEM_LOCK |
+                           BLADERF_STREAM_MEM_LOCK_STACKS;
+
+    if ((flags & ~valid) != 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    ATOMIC_STORE(&dev->stream_mem_flags, flags);
+    return 0;
+}
+
+int bladerf_set_sync_buffer_allocator(
+    struct bladerf *dev,
+    bladerf_direction dir,
+    const struct bladerf_buffer_allocator *allocator)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->set_sync_buffer_allocator(dev, dir, allocator);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_sync_rx_pool(struct bladerf *dev, bool enable)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->set_sync_rx_pool(dev, enable);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_sync_tx_pool(struct bladerf *dev, bool enable)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->set_sync_tx_pool(dev, enable);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_sync_rx_stats(struct bladerf *dev,
+                              bool enable,
+                              unsigned int clip_threshold)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->set_sync_rx_stats(dev, enable, clip_threshold);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_get_sync_rx_stats(struct bladerf *dev,
+                              struct bladerf_rx_stats *stats)
+{
+    int status;
+    CHECK_NULL(stats);
+
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->get_sync_rx_stats(dev, stats);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_sync_rx_tap(struct bladerf *dev,
+                            const struct bladerf_sync_rx_tap *tap)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->set_sync_rx_tap(dev, tap);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_sync_rx_meta_msg_size(struct bladerf *dev, unsigned int size)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->set_sync_rx_meta_msg_size(dev, size);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_get_sync_rx_meta_msg_size(struct bladerf *dev, unsigned int *size)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->get_sync_rx_meta_msg_size(dev, size);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_schedule_rx(struct bladerf *dev,
+                        bladerf_timestamp timestamp,
+                        unsigned int num_samples)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->schedule_rx(dev, timestamp, num_samples);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_schedule_rx_bursts(struct bladerf *dev,
+                               bladerf_timestamp timestamp,
+                               unsigned int burst_len,
+                               unsigned int period)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->schedule_rx_bursts(dev, timestamp, burst_len, period);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_cancel_rx_schedule(struct bladerf *dev)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->cancel_rx_schedule(dev);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_sync_config(struct bladerf *dev,
+                        bladerf_channel_layout layout,
+                        bladerf_format format,
+                        unsigned int num_buffers,
+                        unsigned int buffer_size,
+                        unsigned int num_transfers,
+                        unsigned int stream_timeout)
+{
+    bladerf_direction const dir = layout & BLADERF_DIRECTION_MASK;
+    bladerf_format effective;
+    int status;
+
+    /* The RX history holds buffers of the stream being reconfigured */
+    if ((layout & BLADERF_DIRECTION_MASK) == BLADERF_RX) {
+        MUTEX_LOCK(&dev->rx_history_lock);
+        rx_history_stop(dev->rx_history);
+        dev->rx_history         = NULL;
+        dev->rx_sync_configured = false;
+        MUTEX_UNLOCK(&dev->rx_history_lock);
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    if (wire_format(format) == BLADERF_FORMAT_SC8_Q7 ||
+        wire_format(format) == BLADERF_FORMAT_SC8_Q7_META) {
+        if (strcmp(bladerf_get_board_name(dev), "bladerf2") != 0) {
+            log_error("bladeRF 2.0 required for 8bit format\n");
+            MUTEX_UNLOCK(&dev->lock);
+            return BLADERF_ERR_UNSUPPORTED;
+        }
+    }
+
+    if (format == BLADERF_FORMAT_SC12_PACKED ||
+        format == BLADERF_FORMAT_SC12_PACKED_META) {
+        if (strcmp(bladerf_get_board_name(dev), "bladerf2") != 0) {
+            log_error("bladeRF 2.0 required for 12bit packed format\n");
+            MUTEX_UNLOCK(&dev->lock);
+            return BLADERF_ERR_UNSUPPORTED;
+        }
+    }
+
+    /* The caller's samples are unchanged by any narrower format chosen */
+    effective = sync_adapt_format(dev, layout, format, buffer_size,
+                                  dev->sync_link_adapt);
+
+    status =
+        dev->board->sync_config(dev, layout, effective, num_buffers,
+                                buffer_size, num_transfers, stream_timeout);
+
+    dev->sync_format[dir]       = effective;
+    dev->sync_format_valid[dir] = (status == 0);
+
+    MUTEX_UNLOCK(&dev->lock);
+
+    /* Recorded for the TX scheduler, which copies bursts in this format */
+    if (status == 0 && (layout & BLADERF_DIRECTION_MASK) == BLADERF_TX) {
+        MUTEX_LOCK(&dev->tx_sched_lock);
+        dev->tx_sync_configured = true;
+        dev->tx_sync_format     = format;
+        dev->tx_sync_channels   = _interleave_calc_num_channels(layout);
+        MUTEX_UNLOCK(&dev->tx_sched_lock);
+    }
+
+    /* Likewise, recorded for the RX history */
+    if (status == 0 && (layout & BLADERF_DIRECTION_MASK) == BLADERF_RX) {
+        MUTEX_LOCK(&dev->rx_history_lock);
+        dev->rx_sync_configured = true;
+        dev->rx_sync_format     = format;
+        dev->rx_sync_channels   = _interleave_calc_num_channels(layout);
+        MUTEX_UNLOCK(&dev->rx_history_lock);
+    }
+
+    return status;
+}
+
+int bladerf_set_sync_link_adaptation(struct bladerf *dev, uint32_t allowed)
+{
+    uint32_t const valid = BLADERF_LINK_ADAPT_SC12 | BLADERF_LINK_ADAPT_SC8;
+
+    if ((allowed & ~valid) != 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+    dev->sync_link_adapt = allowed;
+    MUTEX_UNLOCK(&dev->lock);
+
+    return 0;
+}
+
+int bladerf_get_sync_format(struct bladerf *dev,
+                            bladerf_direction dir,
+                            bladerf_format *format)
+{
+    int status = 0;
+
+    CHECK_NULL(format);
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    if (dev->sync_format_valid[dir]) {
+        *format = dev->sync_format[dir];
+    } else {
+        status = BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_UNLOCK(&dev->lock);
+
+    return status;
+}
+
+int bladerf_sync_tx(struct bladerf *dev,
+                    void const *samples,
+                    unsigned int num_samples,
+                    struct bladerf_metadata *metadata,
+                    unsigned int timeout_ms)
+{
+    CHECK_NULL(samples);
+
+    unsigned int const gen = stream_recovery_gen(dev);
+    int status;
+
+    status = dev->board->sync_tx(dev, samples, num_samples, metadata,
+                                 timeout_ms);
+
+    if (status != 0 && stream_recover(dev, gen, status)) {
+        status = dev->board->sync_tx(dev, samples, num_samples, metadata,
+                                     timeout_ms);
+
+        if (status == 0 && metadata != NULL) {
+            metadata->status |= BLADERF_META_STATUS_RECOVERED;
+        }
+    }
+
+    return status;
+}
+
+int bladerf_sync_rx(struct bladerf *dev,
+                    void *samples,
+                    unsigned int num_samples,
+                    struct bladerf_metadata *metadata,
+                    unsigned int timeout_ms)
+{
+    unsigned int const gen = stream_recovery_gen(dev);
+    int status;
+
+    status = dev->board->sync_rx(dev, samples, num_samples, metadata,
+                                 timeout_ms);
+
+    if (status != 0 && stream_recover(dev, gen, status)) {
+        status = dev->board->sync_rx(dev, samples, num_samples, metadata,
+                                     timeout_ms);
+
+        if (status == 0 && metadata != NULL) {
+            metadata->status |= BLADERF_META_STATUS_RECOVERED;
+        }
+    }
+
+    if (status == 0) {
+        agc_update(dev, num_samples, false, metadata);
+    }
+
+    return status;
+}
+
+int bladerf_sync_tx_nb(struct bladerf *dev,
+                       void const *samples,
+                       unsigned int num_samples,
+                       struct bladerf_metadata *metadata)
+{
+    CHECK_NULL(samples);
+    return dev->board->sync_tx_nb(dev, samples, num_samples, metadata);
+}
+
+int bladerf_sync_rx_nb(struct bladerf *dev,
+                       void *samples,
+                       unsigned int num_samples,
+                       struct bladerf_metadata *metadata)
+{
+    return dev->board->sync_rx_nb(dev, samples, num_samples, metadata);
+}
+
+int bladerf_sync_get_ready_fd(struct bladerf *dev,
+                              bladerf_direction dir,
+                              bladerf_ready_fd *fd)
+{
+    CHECK_NULL(fd);
+    return dev->board->sync_get_ready_fd(dev, dir, fd);
+}
+
+int bladerf_sync_tx_multi(struct bladerf *dev,
+                          const void *const *bufs,
+                          unsigned int num_samples,
+                          struct bladerf_metadata *metadata,
+                          unsigned int timeout_ms)
+{
+    CHECK_NULL(bufs);
+    return dev->board->sync_tx_multi(dev, bufs, num_samples, metadata,
+                                     timeout_ms);
+}
+
+int bladerf_sync_create_tx_template(struct bladerf *dev,
+                                    const void *samples,
+                                    unsigned int num_samples,
+                                    struct bladerf_tx_template **tmpl)
+{
+    CHECK_NULL(samples, tmpl);
+    return dev->board->sync_create_tx_template(dev, samples, num_samples,
+                                               tmpl);
+}
+
+int bladerf_sync_tx_template(struct bladerf *dev,
+                             struct bladerf_tx_template *tmpl,
+                             bladerf_timestamp timestamp,
+                             unsigned int timeout_ms)
+{
+    CHECK_NULL(tmpl);
+    return dev->board->sync_tx_template(dev, tmpl, timestamp, timeout_ms);
+}
+
+int bladerf_sync_free_tx_template(struct bladerf *dev,
+                                  struct bladerf_tx_template *tmpl)
+{
+    if (tmpl == NULL) {
+        return 0;
+    }
+
+    return dev->board->sync_free_tx_template(dev, tmpl);
+}
+
+int bladerf_sync_rx_multi(struct bladerf *dev,
+                          void *const *bufs,
+                          unsigned int num_samples,
+                          struct bladerf_metadata *metadata,
+                          unsigned int timeout_ms)
+{
+    int status;
+
+    CHECK_NULL(bufs);
+
+    status = dev->board->sync_rx_multi(dev, bufs, num_samples, metadata,
+                                       timeout_ms);
+
+    if (status == 0) {
+        agc_update(dev, num_samples, true, metadata);
+    }
+
+    return status;
+}
+
+int bladerf_sync_rx_packets(struct bladerf *dev,
+                            struct bladerf_packet *packets,
+                            unsigned int num_packets,
+                            unsigned int *num_received,
+                            unsigned int timeout_ms)
+{
+    CHECK_NULL(packets, num_received);
+    return dev->board->sync_rx_packets(dev, packets, num_packets,
+                                       num_received, timeout_ms);
+}
+
+int bladerf_sync_tx_packets(struct bladerf *dev,
+                            const struct bladerf_packet *packets,
+                            unsigned int num_packets,
+                            unsigned int *num_sent,
+                            unsigned int timeout_ms)
+{
+    CHECK_NULL(packets);
+    return dev->board->sync_tx_packets(dev, packets, num_packets, num_sent,
+                                       timeout_ms);
+}
+
+int bladerf_sync_rx_acquire(struct bladerf *dev,
+                            void **buffer,
+                            unsigned int *num_samples,
+                            struct bladerf_metadata *metadata,
+                            unsigned int timeout_ms)
+{
+    CHECK_NULL(buffer, num_samples);
+    return dev->board->sync_rx_acquire(dev, buffer, num_samples, metadata,
+                                       timeout_ms);
+}
+
+int bladerf_sync_rx_release(struct bladerf *dev, void *buffer)
+{
+    CHECK_NULL(buffer);
+    return dev->board->sync_rx_release(dev, buffer);
+}
+
+int bladerf_sync_prearm(struct bladerf *dev, bladerf_direction dir)
+{
+    return dev->board->sync_prearm(dev, dir);
+}
+
+int bladerf_sync_tx_acquire(struct bladerf *dev,
+                            void **buffer,
+                            unsigned int *num_samples,
+                            unsigned int timeout_ms)
+{
+    CHECK_NULL(buffer, num_samples);
+    return dev->board->sync_tx_acquire(dev, buffer, num_samples, timeout_ms);
+}
+
+int bladerf_sync_tx_submit(struct bladerf *dev,
+                           void *buffer,
+                           unsigned int num_samples)
+{
+    CHECK_NULL(buffer);
+    return dev->board->sync_tx_submit(dev, buffer, num_samples);
+}
+
+int bladerf_sync_tx_reserve(struct bladerf *dev,
+                            void **buffer,
+                            unsigned int *num_samples,
+                            uint64_t *position,
+                            unsigned int timeout_ms)
+{
+    CHECK_NULL(buffer, num_samples);
+    return dev->board->sync_tx_reserve(dev, buffer, num_samples, position,
+                                       timeout_ms);
+}
+
+int bladerf_get_timestamp(struct bladerf *dev,
+                          bladerf_direction dir,
+                          bladerf_timestamp *timestamp)
+{
+    int status;
+    dev_lock_urgent(dev);
+
+    status = dev->board->get_timestamp(dev, dir, timestamp);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_set_timestamp_correlation(struct bladerf *dev,
+                                      bladerf_direction dir,
+                                      unsigned int interval_ms)
+{
+    struct timestamp_corr *corr = NULL;
+    int status = 0;
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->ts_corr_lock);
+
+    timestamp_corr_stop(dev->ts_corr[dir]);
+    dev->ts_corr[dir] = NULL;
+
+    if (interval_ms != 0) {
+        status = timestamp_corr_start(&corr, dev, dir, interval_ms);
+        if (status == 0) {
+            dev->ts_corr[dir] = corr;
+        }
+    }
+
+    MUTEX_UNLOCK(&dev->ts_corr_lock);
+    return status;
+}
+
+int bladerf_timestamp_to_host_ns(struct bladerf *dev,
+                                 bladerf_direction dir,
+                                 bladerf_timestamp timestamp,
+                                 uint64_t *host_ns)
+{
+    int status;
+
+    CHECK_NULL(host_ns);
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->ts_corr_lock);
+
+    if (dev->ts_corr[dir] == NULL) {
+        status = BLADERF_ERR_NOT_INIT;
+    } else {
+        status = timestamp_corr_to_host(dev->ts_corr[dir], timestamp, host_ns);
+    }
+
+    MUTEX_UNLOCK(&dev->ts_corr_lock);
+    return status;
+}
+
+int bladerf_host_ns_to_timestamp(struct bladerf *dev,
+                                 bladerf_direction dir,
+                                 uint64_t host_ns,
+                                 bladerf_timestamp *timestamp)
+{
+    int status;
+
+    CHECK_NULL(timestamp);
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->ts_corr_lock);
+
+    if (dev->ts_corr[dir] == NULL) {
+        status = BLADERF_ERR_NOT_INIT;
+    } else {
+        status =
+            timestamp_corr_from_host(dev->ts_corr[dir], host_ns, timestamp);
+    }
+
+    MUTEX_UNLOCK(&dev->ts_corr_lock);
+    return status;
+}
+
+uint64_t bladerf_get_host_time_ns(void)
+{
+    return wallclock_get_monotonic_nsec();
+}
+
+int bladerf_interleave_stream_buffer(bladerf_channel_layout layout,
+                                     bladerf_format format,
+                                     unsigned int buffer_size,
+                                     void *samples)
+{
+    return _interleave_interleave_buf(layout, format, buffer_size, samples);
+}
+
+int bladerf_deinterleave_stream_buffer(bladerf_channel_layout layout,
+                                       bladerf_format format,
+                                       unsigned int buffer_size,
+                                       void *samples)
+{
+    return _interleave_deinterleave_buf(layout, format, buffer_size, samples);
+}
+
+int bladerf_deinterleave_stream_buffer_to(bladerf_channel_layout layout,
+                                          bladerf_format format,
+                                          unsigned int buffer_size,
+                                          const void *samples,
+                                          void *const *dest)
+{
+    if (samples == NULL || dest == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return _interleave_deinterleave_buf_to(layout, format, buffer_size,
+                                           samples, dest);
+}
+
+int bladerf_convert_samples(bladerf_format in_format,
+                            const void *in,
+                            bladerf_format out_format,
+                            void *out,
+                            size_t num_samples)
+{
+    if (in == NULL || out == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (in_format == out_format) {
+        switch (in_format) {
+            case BLADERF_FORMAT_SC16_Q11:
+            case BLADERF_FORMAT_SC8_Q7:
+            case BLADERF_FORMAT_CF32:
+            case BLADERF_FORMAT_SC12_PACKED:
+                memcpy(out, in, samples_to_bytes(in_format, num_samples));
+                return 0;
+
+            default:
+                return BLADERF_ERR_UNSUPPORTED;
+        }
+    }
+
+    if (in_format == BLADERF_FORMAT_SC16_Q11) {
+        switch (out_format) {
+            case BLADERF_FORMAT_CF32:
+                convert_sc16q11_to_cf32(in, out, num_samples);
+                return 0;
+
+            case BLADERF_FORMAT_SC8_Q7:
+                convert_sc16q11_to_sc8q7(in, out, num_samples);
+                return 0;
+
+            case BLADERF_FORMAT_SC12_PACKED:
+                convert_sc16q11_to_sc12(in, out, num_samples);
+                return 0;
+
+            default:
+                return BLADERF_ERR_UNSUPPORTED;
+        }
+    }
+
+    if (out_format == BLADERF_FORMAT_SC16_Q11) {
+        switch (in_format) {
+            case BLADERF_FORMAT_CF32:
+                convert_cf32_to_sc16q11(in, out, num_samples);
+                return 0;
+
+            case BLADERF_FORMAT_SC8_Q7:
+                convert_sc8q7_to_sc16q11(in, out, num_samples);
+                return 0;
+
+            case BLADERF_FORMAT_SC12_PACKED:
+                convert_sc12_to_sc16q11(in, out, num_samples);
+                return 0;
+
+            default:
+                return BLADERF_ERR_UNSUPPORTED;
+        }
+    }
+
+    if (in_format == BLADERF_FORMAT_SC8_Q7 &&
+        out_format == BLADERF_FORMAT_CF32) {
+        convert_sc8q7_to_cf32(in, out, num_samples);
+        return 0;
+    }
+
+    if (in_format == BLADERF_FORMAT_CF32 &&
+        out_format == BLADERF_FORMAT_SC8_Q7) {
+        convert_cf32_to_sc8q7(in, out, num_samples);
+        return 0;
+    }
+
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+/******************************************************************************/
+/* FPGA/Firmware Loading/Flashing */
+/******************************************************************************/
+
+int bladerf_load_fpga(struct bladerf *dev, const char *fpga_file)
+{
+    return bladerf_load_fpga_with_progress(dev, fpga_file, NULL, NULL);
+}
+
+int bladerf_load_fpga_with_progress(struct bladerf *dev,
+                                    const char *fpga_file,
+                                    bladerf_progress_cb cb,
+                                    void *user_data)
+{
+    struct fpga_image image;
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    int status;
+
+    status = fpga_image_open_file(&image, fpga_file);
+    if (status != 0) {
+        log_error("Failed to read FPGA image: %s\n", bladerf_strerror(status));
+        return status;
+    }
+
+    /* Hashing the image is far cheaper than reconfiguring the FPGA */
+    if (dev->backend->is_fpga_configured(dev) == 1) {
+        status = fpga_image_digest(&image, digest);
+        if (status != 0) {
+            log_error("Failed to read FPGA image: %s\n",
+                      bladerf_strerror(status));
+            goto exit;
+        }
+
+        if (fpga_image_cache_match(dev, digest)) {
+            log_info("FPGA image is already loaded, skipping reload.\n");
+            if (cb != NULL) {
+                cb(image.size, image.size, user_data);
+            }
+            goto exit;
+        }
+    }
+
+    fpga_image_set_progress(&image, cb, user_data);
+    status = dev->board->load_fpga(dev, &image);
+
+    /* The bladeRF2's fast lock profiles held by cached quick tunes are lost
+     * with the Nios II */
+    MUTEX_LOCK(&dev->lock);
+    tune_cache_invalidate_all(dev);
+    MUTEX_UNLOCK(&dev->lock);
+
+exit:
+    fpga_image_close(&image);
+    return status;
+}
+
+int bladerf_flash_fpga(struct bladerf *dev, const char *fpga_file)
+{
+    uint8_t *buf = NULL;
+    size_t buf_size;
+    int status;
+
+    status = file_read_buffer(fpga_file, &buf, &buf_size);
+    if (status != 0) {
+        goto exit;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+    status = dev->board->flash_fpga(dev, buf, buf_size);
+    MUTEX_UNLOCK(&dev->lock);
+
+exit:
+    free(buf);
+    return status;
+}
+
+int bladerf_erase_stored_fpga(struct bladerf *dev)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->erase_stored_fpga(dev);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_flash_firmware(struct bladerf *dev, const char *firmware_file)
+{
+    uint8_t *buf = NULL;
+    size_t buf_size;
+    int status;
+
+    status = file_read_buffer(firmware_file, &buf, &buf_size);
+    if (status != 0) {
+        goto exit;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+    status = dev->board->flash_firmware(dev, buf, buf_size);
+    MUTEX_UNLOCK(&dev->lock);
+
+exit:
+    free(buf);
+    return status;
+}
+
+int bladerf_device_reset(struct bladerf *dev)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->device_reset(dev);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+/******************************************************************************/
+/* Tuning mode */
+/******************************************************************************/
+
+int bladerf_set_tuning_mode(struct bladerf *dev, bladerf_tuning_mode mode)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->set_tuning_mode(dev, mode);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_get_tuning_mode(struct bladerf *dev, bladerf_tuning_mode *mode)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->get_tuning_mode(dev, mode);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+/******************************************************************************/
+/* Loopback */
+/******************************************************************************/
+
+int bladerf_get_loopback_modes(struct bladerf *dev,
+                               struct bladerf_loopback_modes const **modes)
+{
+    int status;
+
+    status = dev->board->get_loopback_modes(dev, modes);
+
+    return status;
+}
+
+bool bladerf_is_loopback_mode_supported(struct bladerf *dev,
+                                        bladerf_loopback mode)
+{
+    struct bladerf_loopback_modes modes;
+    struct bladerf_loopback_modes const *modesptr = &modes;
+    int i, count;
+
+    count = bladerf_get_loopback_modes(dev, &modesptr);
+
+    for (i = 0; i < count; ++i) {
+        if (modesptr[i].mode == mode) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int bladerf_set_loopback(struct bladerf *dev, bladerf_loopback l)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->set_loopback(dev, l);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_get_loopback(struct bladerf *dev, bladerf_loopback *l)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->get_loopback(dev, l);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+/******************************************************************************/
+/* Sample RX FPGA Mux */
+/******************************************************************************/
+
+int bladerf_set_rx_mux(struct bladerf *dev, bladerf_rx_mux mux)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->set_rx_mux(dev, mux);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_get_rx_mux(struct bladerf *dev, bladerf_rx_mux *mux)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->get_rx_mux(dev, mux);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+/******************************************************************************/
+/* RX FPGA decimation */
+/******************************************************************************/
+
+int bladerf_set_rx_decimation(struct bladerf *dev,
+                              unsigned int decimation,
+                              int32_t nco_offset)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    if (format == BLADERF_FORMAT_SC8_Q7 || format == BLADERF_FORMAT_SC8_Q7_META) {
-        if (strcmp(bladerf_get_board_name(dev), "bladerf2") != 0) {
-            log_error("bladeRF 2.0 required for 8bit format\n");
-            return BLADERF_ERR_UNSUPPORTED;
-        }
-    }
-
-    status =
-        dev->board->sync_config(dev, layout, format, num_buffers, buffer_size,
-                                num_transfers, stream_timeout);
+    status = dev->board->set_rx_decimation(dev, decimation, nco_offset);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_sync_tx(struct bladerf *dev,
-                    void const *samples,
-                    unsigned int num_samples,
-                    struct bladerf_metadata *metadata,
-                    unsigned int timeout_ms)
+int bladerf_get_rx_decimation(struct bladerf *dev,
+                              unsigned int *decimation,
+                              int32_t *nco_offset)
 {
-    CHECK_NULL(samples);
-    return dev->board->sync_tx(dev, samples, num_samples, metadata, timeout_ms);
-}
+    int status;
+    MUTEX_LOCK(&dev->lock);
 
-int bladerf_sync_rx(struct bladerf *dev,
-                    void *samples,
-                    unsigned int num_samples,
-                    struct bladerf_metadata *metadata,
-                    unsigned int timeout_ms)
-{
-    return dev->board->sync_rx(dev, samples, num_samples, metadata, timeout_ms);
+    status = dev->board->get_rx_decimation(dev, decimation, nco_offset);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
 }
 
-int bladerf_get_timestamp(struct bladerf *dev,
-                          bladerf_direction dir,
-                          bladerf_timestamp *timestamp)
+/******************************************************************************/
+/* TX waveform playback */
+/******************************************************************************/
+
+int bladerf_tx_load_waveform(struct bladerf *dev,
+                             const int16_t *samples,
+                             unsigned int num_samples)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_timestamp(dev, dir, timestamp);
+    status = dev->board->tx_load_waveform(dev, samples, num_samples);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_interleave_stream_buffer(bladerf_channel_layout layout,
-                                     bladerf_format format,
-                                     unsigned int buffer_size,
-                                     void *samples)
+int bladerf_tx_loop_start(struct bladerf *dev, unsigned int interpolation)
 {
-    return _interleave_interleave_buf(layout, format, buffer_size, samples);
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->tx_loop_start(dev, interpolation);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
 }
 
-int bladerf_deinterleave_stream_buffer(bladerf_channel_layout layout,
-                                       bladerf_format format,
-                                       unsigned int buffer_size,
-                                       void *samples)
+int bladerf_tx_loop_stop(struct bladerf *dev)
 {
-    return _interleave_deinterleave_buf(layout, format, buffer_size, samples);
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->tx_loop_stop(dev);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
 }
 
 /******************************************************************************/
-/* FPGA/Firmware Loading/Flashing */
+/* RX power measurement */
 /******************************************************************************/
 
-int bladerf_load_fpga(struct bladerf *dev, const char *fpga_file)
+int bladerf_measure_rx_power(struct bladerf *dev,
+                             bladerf_channel ch,
+                             unsigned int num_samples,
+                             struct bladerf_rx_power *power)
 {
-    uint8_t *buf = NULL;
-    size_t buf_size;
     int status;
+    MUTEX_LOCK(&dev->lock);
 
-    status = file_read_buffer(fpga_file, &buf, &buf_size);
-    if (status != 0) {
-        log_error("Failed to read FPGA image: %s\n", bladerf_strerror(status));
-        goto exit;
-    }
-
-    status = dev->board->load_fpga(dev, buf, buf_size);
+    status = dev->board->measure_rx_power(dev, ch, num_samples, power);
 
-exit:
-    free(buf);
+    MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_flash_fpga(struct bladerf *dev, const char *fpga_file)
+int bladerf_rx_snapshot(struct bladerf *dev,
+                        bladerf_channel ch,
+                        int16_t *samples,
+                        unsigned int num_samples)
 {
-    uint8_t *buf = NULL;
-    size_t buf_size;
     int status;
+    MUTEX_LOCK(&dev->lock);
 
-    status = file_read_buffer(fpga_file, &buf, &buf_size);
-    if (status != 0) {
-        goto exit;
-    }
+    status = dev->board->rx_snapshot(dev, ch, samples, num_samples);
 
-    MUTEX_LOCK(&dev->lock);
-    status = dev->board->flash_fpga(dev, buf, buf_size);
     MUTEX_UNLOCK(&dev->lock);
-
-exit:
-    free(buf);
     return status;
 }
 
-int bladerf_erase_stored_fpga(struct bladerf *dev)
+/******************************************************************************/
+/* Low-level VCTCXO Tamer Mode */
+/******************************************************************************/
+
+int bladerf_set_vctcxo_tamer_mode(struct bladerf *dev,
+                                  bladerf_vctcxo_tamer_mode mode)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->erase_stored_fpga(dev);
+    status = dev->board->set_vctcxo_tamer_mode(dev, mode);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_flash_firmware(struct bladerf *dev, const char *firmware_file)
+int bladerf_get_vctcxo_tamer_mode(struct bladerf *dev,
+                                  bladerf_vctcxo_tamer_mode *mode)
 {
-    uint8_t *buf = NULL;
-    size_t buf_size;
     int status;
+    MUTEX_LOCK(&dev->lock);
 
-    status = file_read_buffer(firmware_file, &buf, &buf_size);
-    if (status != 0) {
-        goto exit;
-    }
+    status = dev->board->get_vctcxo_tamer_mode(dev, mode);
 
-    MUTEX_LOCK(&dev->lock);
-    status = dev->board->flash_firmware(dev, buf, buf_size);
     MUTEX_UNLOCK(&dev->lock);
-
-exit:
-    free(buf);
     return status;
 }
 
-int bladerf_device_reset(struct bladerf *dev)
+int bladerf_get_vctcxo_tamer_status(struct bladerf *dev,
+                                    struct bladerf_vctcxo_tamer_status *status)
 {
-    int status;
+    int rv;
+
+    CHECK_NULL(status);
+
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->device_reset(dev);
+    rv = dev->board->get_vctcxo_tamer_status(dev, status);
 
     MUTEX_UNLOCK(&dev->lock);
-    return status;
+    return rv;
+}
+
+/* Interval between polls while waiting for lock. The tamer measures each
+ * second, so there's no point polling much faster. */
+#define VCTCXO_TAMER_POLL_MS 100
+
+int bladerf_wait_vctcxo_tamer_lock(struct bladerf *dev,
+                                   unsigned int timeout_ms)
+{
+    struct bladerf_vctcxo_tamer_status status;
+    uint64_t deadline;
+    int rv;
+
+    deadline = wallclock_get_monotonic_nsec() +
+               (uint64_t)timeout_ms * 1000000ULL;
+
+    while (true) {
+        rv = bladerf_get_vctcxo_tamer_status(dev, &status);
+        if (rv != 0) {
+            return rv;
+        }
+
+        if (status.locked) {
+            return 0;
+        }
+
+        if (status.state == BLADERF_VCTCXO_TAMER_STATE_DISABLED) {
+            log_debug("%s: the VCTCXO tamer is disabled\n", __FUNCTION__);
+            return BLADERF_ERR_UNEXPECTED;
+        }
+
+        if (wallclock_get_monotonic_nsec() >= deadline) {
+            log_debug("%s: timed out after %u measurements, error=%d\n",
+                      __FUNCTION__, status.measurements, status.error_1s);
+            return BLADERF_ERR_TIMEOUT;
+        }
+
+        usleep(VCTCXO_TAMER_POLL_MS * 1000);
+    }
 }
 
 /******************************************************************************/
-/* Tuning mode */
+/* Low-level VCTCXO Trim DAC access */
 /******************************************************************************/
 
-int bladerf_set_tuning_mode(struct bladerf *dev, bladerf_tuning_mode mode)
+int bladerf_get_vctcxo_trim(struct bladerf *dev, uint16_t *trim)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->set_tuning_mode(dev, mode);
+    status = dev->board->get_vctcxo_trim(dev, trim);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_get_tuning_mode(struct bladerf *dev, bladerf_tuning_mode *mode)
+int bladerf_trim_dac_read(struct bladerf *dev, uint16_t *trim)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_tuning_mode(dev, mode);
+    status = dev->board->trim_dac_read(dev, trim);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_trim_dac_write(struct bladerf *dev, uint16_t trim)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->trim_dac_write(dev, trim);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
+int bladerf_dac_read(struct bladerf *dev, uint16_t *trim)
+{
+    return bladerf_trim_dac_read(dev, trim);
+}
+int bladerf_dac_write(struct bladerf *dev, uint16_t trim)
+{
+    return bladerf_trim_dac_write(dev, trim);
+}
+
 /******************************************************************************/
-/* Loopback */
+/* Device state snapshot */
 /******************************************************************************/
 
-int bladerf_get_loopback_modes(struct bladerf *dev,
-                               struct bladerf_loopback_modes const **modes)
+static void get_channel_state(struct bladerf *dev,
+                              struct bladerf_channel_state *c)
 {
-    int status;
+    const char *names[BLADERF_STATE_MAX_STAGES];
+    unsigned int i;
+    int count;
 
-    status = dev->board->get_loopback_modes(dev, modes);
+    if (dev->board->get_frequency(dev, c->channel, &c->frequency) == 0) {
+        c->valid |= BLADERF_CHAN_STATE_FREQUENCY;
+    }
 
-    return status;
+    if (dev->board->get_rational_sample_rate(dev, c->channel,
+                                             &c->samplerate) == 0) {
+        c->valid |= BLADERF_CHAN_STATE_SAMPLERATE;
+    }
+
+    if (dev->board->get_bandwidth(dev, c->channel, &c->bandwidth) == 0) {
+        c->valid |= BLADERF_CHAN_STATE_BANDWIDTH;
+    }
+
+    if (dev->board->get_rf_port(dev, c->channel, &c->rf_port) == 0 &&
+        c->rf_port != NULL) {
+        c->valid |= BLADERF_CHAN_STATE_RF_PORT;
+    }
+
+    if (!BLADERF_CHANNEL_IS_TX(c->channel) &&
+        dev->board->get_gain_mode(dev, c->channel, &c->gain_mode) == 0) {
+        c->valid |= BLADERF_CHAN_STATE_GAIN_MODE;
+    }
+
+    if (dev->board->get_gain(dev, c->channel, &c->gain) == 0) {
+        c->valid |= BLADERF_CHAN_STATE_GAIN;
+    }
+
+    count = dev->board->get_gain_stages(dev, c->channel, names,
+                                        BLADERF_STATE_MAX_STAGES);
+    if (count > BLADERF_STATE_MAX_STAGES) {
+        count = BLADERF_STATE_MAX_STAGES;
+    }
+
+    for (i = 0; count > 0 && i < (unsigned int)count; i++) {
+        struct bladerf_gain_stage_value *s = &c->stages[c->num_stages];
+
+        if (dev->board->get_gain_stage(dev, c->channel, names[i],
+                                       &s->gain) == 0) {
+            s->name = names[i];
+            c->num_stages++;
+        }
+    }
 }
 
-bool bladerf_is_loopback_mode_supported(struct bladerf *dev,
-                                        bladerf_loopback mode)
+int bladerf_get_device_state(struct bladerf *dev,
+                             struct bladerf_device_state *state)
 {
-    struct bladerf_loopback_modes modes;
-    struct bladerf_loopback_modes const *modesptr = &modes;
-    int i, count;
+    static const bladerf_direction dirs[] = { BLADERF_RX, BLADERF_TX };
+    size_t d, i, n;
 
-    count = bladerf_get_loopback_modes(dev, &modesptr);
+    if (state == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
 
-    for (i = 0; i < count; ++i) {
-        if (modesptr[i].mode == mode) {
-            return true;
+    memset(state, 0, sizeof(*state));
+
+    MUTEX_LOCK(&dev->lock);
+
+    if (dev->board->get_loopback(dev, &state->loopback) == 0) {
+        state->valid |= BLADERF_DEV_STATE_LOOPBACK;
+    }
+
+    if (dev->board->get_rx_mux(dev, &state->rx_mux) == 0) {
+        state->valid |= BLADERF_DEV_STATE_RX_MUX;
+    }
+
+    if (dev->board->get_tuning_mode(dev, &state->tuning_mode) == 0) {
+        state->valid |= BLADERF_DEV_STATE_TUNING_MODE;
+    }
+
+    if (dev->board->trim_dac_read(dev, &state->trim_dac) == 0) {
+        state->valid |= BLADERF_DEV_STATE_TRIM_DAC;
+    }
+
+    for (d = 0; d < ARRAY_SIZE(dirs); d++) {
+        n = dev->board->get_channel_count(dev, dirs[d]);
+
+        for (i = 0; i < n && state->num_channels < BLADERF_STATE_MAX_CHANNELS;
+             i++) {
+            struct bladerf_channel_state *c =
+                &state->channels[state->num_channels++];
+
+            c->channel = (dirs[d] == BLADERF_RX) ? BLADERF_CHANNEL_RX(i)
+                                                 : BLADERF_CHANNEL_TX(i);
+
+            get_channel_state(dev, c);
         }
     }
 
-    return false;
+    MUTEX_UNLOCK(&dev->lock);
+
+    return 0;
 }
 
-int bladerf_set_loopback(struct bladerf *dev, bladerf_loopback l)
+/******************************************************************************/
+/* Low-level Trigger control access */
+/******************************************************************************/
+
+int bladerf_read_trigger(struct bladerf *dev,
+                         bladerf_channel ch,
+                         bladerf_trigger_signal trigger,
+                         uint8_t *val)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->set_loopback(dev, l);
+    status = dev->board->read_trigger(dev, ch, trigger, val);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_write_trigger(struct bladerf *dev,
+                          bladerf_channel ch,
+                          bladerf_trigger_signal trigger,
+                          uint8_t val)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->write_trigger(dev, ch, trigger, val);
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+/******************************************************************************/
+/* Low-level Wishbone Master access */
+/******************************************************************************/
+int bladerf_wishbone_master_read(struct bladerf *dev, uint32_t addr, uint32_t *data)
+{
+    int status;
+    MUTEX_LOCK(&dev->lock);
+
+    status = dev->board->wishbone_master_read(dev, addr, data);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_get_loopback(struct bladerf *dev, bladerf_loopback *l)
+int bladerf_wishbone_master_write(struct bladerf *dev, uint32_t addr, uint32_t data)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_loopback(dev, l);
+    status = dev->board->wishbone_master_write(dev, addr, data);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
 /******************************************************************************/
-/* Sample RX FPGA Mux */
+/* Low-level Configuration GPIO access */
 /******************************************************************************/
 
-int bladerf_set_rx_mux(struct bladerf *dev, bladerf_rx_mux mux)
+int bladerf_config_gpio_read(struct bladerf *dev, uint32_t *val)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->set_rx_mux(dev, mux);
+    status = dev->board->config_gpio_read(dev, val);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_get_rx_mux(struct bladerf *dev, bladerf_rx_mux *mux)
+int bladerf_config_gpio_write(struct bladerf *dev, uint32_t val)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_rx_mux(dev, mux);
+    status = dev->board->config_gpio_write(dev, val);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
 /******************************************************************************/
-/* Low-level VCTCXO Tamer Mode */
+/* Control request batching */
 /******************************************************************************/
 
-int bladerf_set_vctcxo_tamer_mode(struct bladerf *dev,
-                                  bladerf_vctcxo_tamer_mode mode)
+int bladerf_batch_begin(struct bladerf *dev)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->set_vctcxo_tamer_mode(dev, mode);
+    status = dev->board->batch_begin(dev);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_get_vctcxo_tamer_mode(struct bladerf *dev,
-                                  bladerf_vctcxo_tamer_mode *mode)
+int bladerf_batch_commit(struct bladerf *dev)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->get_vctcxo_tamer_mode(dev, mode);
+    status = dev->board->batch_commit(dev);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
 /******************************************************************************/
-/* Low-level VCTCXO Trim DAC access */
+/* Asynchronous control operations */
 /******************************************************************************/
 
-int bladerf_get_vctcxo_trim(struct bladerf *dev, uint16_t *trim)
+static int submit_ctrl_op(struct bladerf *dev, struct ctrl_op *op,
+                          bladerf_ctrl_cb cb, void *user_data)
 {
-    int status;
-    MUTEX_LOCK(&dev->lock);
+    int status = 0;
 
-    status = dev->board->get_vctcxo_trim(dev, trim);
+    op->cb        = cb;
+    op->user_data = user_data;
 
-    MUTEX_UNLOCK(&dev->lock);
+    MUTEX_LOCK(&dev->ctrl_queue_lock);
+
+    /* The worker is only started once asynchronous operations are used */
+    if (dev->ctrl_queue_closing) {
+        status = BLADERF_ERR_NODEV;
+    } else if (dev->ctrl_queue == NULL) {
+        status = ctrl_queue_start(&dev->ctrl_queue, dev);
+    }
+
+    if (status == 0) {
+        status = ctrl_queue_submit(dev->ctrl_queue, op);
+    }
+
+    MUTEX_UNLOCK(&dev->ctrl_queue_lock);
     return status;
 }
 
-int bladerf_trim_dac_read(struct bladerf *dev, uint16_t *trim)
+int bladerf_set_frequency_async(struct bladerf *dev,
+                                bladerf_channel ch,
+                                bladerf_frequency frequency,
+                                bladerf_ctrl_cb cb,
+                                void *user_data)
 {
-    int status;
-    MUTEX_LOCK(&dev->lock);
+    struct ctrl_op op;
 
-    status = dev->board->trim_dac_read(dev, trim);
+    memset(&op, 0, sizeof(op));
+    op.type                     = CTRL_OP_SET_FREQUENCY;
+    op.args.frequency.ch        = ch;
+    op.args.frequency.frequency = frequency;
 
-    MUTEX_UNLOCK(&dev->lock);
-    return status;
+    return submit_ctrl_op(dev, &op, cb, user_data);
 }
 
-int bladerf_trim_dac_write(struct bladerf *dev, uint16_t trim)
+int bladerf_set_gain_async(struct bladerf *dev,
+                           bladerf_channel ch,
+                           bladerf_gain gain,
+                           bladerf_ctrl_cb cb,
+                           void *user_data)
 {
-    int status;
-    MUTEX_LOCK(&dev->lock);
+    struct ctrl_op op;
 
-    status = dev->board->trim_dac_write(dev, trim);
+    memset(&op, 0, sizeof(op));
+    op.type           = CTRL_OP_SET_GAIN;
+    op.args.gain.ch   = ch;
+    op.args.gain.gain = gain;
 
-    MUTEX_UNLOCK(&dev->lock);
-    return status;
+    return submit_ctrl_op(dev, &op, cb, user_data);
 }
 
-int bladerf_dac_read(struct bladerf *dev, uint16_t *trim)
+int bladerf_schedule_retune_async(struct bladerf *dev,
+                                  bladerf_channel ch,
+                                  bladerf_timestamp timestamp,
+                                  bladerf_frequency frequency,
+                                  struct bladerf_quick_tune *quick_tune,
+                                  bladerf_ctrl_cb cb,
+                                  void *user_data)
+{
+    struct ctrl_op op;
+
+    memset(&op, 0, sizeof(op));
+    op.type                  = CTRL_OP_SCHEDULE_RETUNE;
+    op.args.retune.ch        = ch;
+    op.args.retune.timestamp = timestamp;
+    op.args.retune.frequency = frequency;
+
+    if (quick_tune != NULL) {
+        op.args.retune.use_quick_tune = true;
+        op.args.retune.quick_tune     = *quick_tune;
+    }
+
+    return submit_ctrl_op(dev, &op, cb, user_data);
+}
+
+int bladerf_get_timestamp_async(struct bladerf *dev,
+                                bladerf_direction dir,
+                                bladerf_timestamp *timestamp,
+                                bladerf_ctrl_cb cb,
+                                void *user_data)
 {
-    return bladerf_trim_dac_read(dev, trim);
+    struct ctrl_op op;
+
+    CHECK_NULL(timestamp);
+
+    memset(&op, 0, sizeof(op));
+    op.type                 = CTRL_OP_GET_TIMESTAMP;
+    op.args.timestamp.dir   = dir;
+    op.args.timestamp.value = timestamp;
+
+    return submit_ctrl_op(dev, &op, cb, user_data);
 }
-int bladerf_dac_write(struct bladerf *dev, uint16_t trim)
+
+int bladerf_flush_async_ctrl(struct bladerf *dev, unsigned int timeout_ms)
 {
-    return bladerf_trim_dac_write(dev, trim);
+    struct ctrl_queue *queue;
+
+    MUTEX_LOCK(&dev->ctrl_queue_lock);
+    queue = dev->ctrl_queue;
+    MUTEX_UNLOCK(&dev->ctrl_queue_lock);
+
+    /* The queue persists until the device is closed, so the lock need not
+     * be held while waiting. Doing so would block callbacks that submit
+     * further operations. */
+    if (queue == NULL) {
+        return 0;
+    }
+
+    return ctrl_queue_flush(queue, timeout_ms);
 }
 
 /******************************************************************************/
-/* Low-level Trigger control access */
+/* TX burst scheduling */
 /******************************************************************************/
 
-int bladerf_read_trigger(struct bladerf *dev,
-                         bladerf_channel ch,
-                         bladerf_trigger_signal trigger,
-                         uint8_t *val)
+/* Start the scheduler if it's not yet running. Assumes tx_sched_lock is
+ * held. */
+static int get_tx_sched(struct bladerf *dev, struct tx_sched **sched)
+{
+    int status = 0;
+
+    if (dev->tx_sched == NULL) {
+        status = tx_sched_start(&dev->tx_sched, dev);
+    }
+
+    *sched = dev->tx_sched;
+    return status;
+}
+
+int bladerf_tx_sched_config(struct bladerf *dev,
+                            uint64_t lead,
+                            unsigned int timeout_ms)
 {
+    struct tx_sched *sched;
     int status;
-    MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->read_trigger(dev, ch, trigger, val);
+    MUTEX_LOCK(&dev->tx_sched_lock);
 
-    MUTEX_UNLOCK(&dev->lock);
+    status = get_tx_sched(dev, &sched);
+    if (status == 0) {
+        tx_sched_config(sched, lead, timeout_ms);
+    }
+
+    MUTEX_UNLOCK(&dev->tx_sched_lock);
     return status;
 }
 
-int bladerf_write_trigger(struct bladerf *dev,
-                          bladerf_channel ch,
-                          bladerf_trigger_signal trigger,
-                          uint8_t val)
+int bladerf_tx_sched_submit(struct bladerf *dev,
+                            const void *samples,
+                            unsigned int num_samples,
+                            bladerf_timestamp timestamp)
 {
+    struct tx_sched *sched;
     int status;
-    MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->write_trigger(dev, ch, trigger, val);
+    CHECK_NULL(samples);
 
-    MUTEX_UNLOCK(&dev->lock);
+    MUTEX_LOCK(&dev->tx_sched_lock);
+
+    if (!dev->tx_sync_configured) {
+        log_debug("%s: TX has not been configured via bladerf_sync_config()\n",
+                  __FUNCTION__);
+        status = BLADERF_ERR_INVAL;
+        goto out;
+    }
+
+    switch (dev->tx_sync_format) {
+        case BLADERF_FORMAT_SC16_Q11_META:
+        case BLADERF_FORMAT_SC8_Q7_META:
+        case BLADERF_FORMAT_CF32_META:
+        case BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META:
+        case BLADERF_FORMAT_SC8_Q7_AS_CF32_META:
+            break;
+
+        default:
+            log_debug("%s: Unsupported format: %d\n", __FUNCTION__,
+                      dev->tx_sync_format);
+            status = BLADERF_ERR_UNSUPPORTED;
+            goto out;
+    }
+
+    if (num_samples == 0 || num_samples % dev->tx_sync_channels != 0) {
+        status = BLADERF_ERR_INVAL;
+        goto out;
+    }
+
+    status = get_tx_sched(dev, &sched);
+    if (status == 0) {
+        status = tx_sched_submit(
+            sched, samples, samples_to_bytes(dev->tx_sync_format, num_samples),
+            num_samples, timestamp, num_samples / dev->tx_sync_channels);
+    }
+
+out:
+    MUTEX_UNLOCK(&dev->tx_sched_lock);
     return status;
 }
 
+int bladerf_tx_sched_flush(struct bladerf *dev, unsigned int timeout_ms)
+{
+    struct tx_sched *sched;
+
+    MUTEX_LOCK(&dev->tx_sched_lock);
+    sched = dev->tx_sched;
+    MUTEX_UNLOCK(&dev->tx_sched_lock);
+
+    /* As with bladerf_flush_async_ctrl(), the scheduler persists until the
+     * device is closed */
+    if (sched == NULL) {
+        return 0;
+    }
+
+    return tx_sched_flush(sched, timeout_ms);
+}
+
 /******************************************************************************/
-/* Low-level Wishbone Master access */
+/* RX history */
 /******************************************************************************/
-int bladerf_wishbone_master_read(struct bladerf *dev, uint32_t addr, uint32_t *data)
+
+int bladerf_rx_history_start(struct bladerf *dev, unsigned int num_buffers)
 {
+    unsigned int msg_size;
     int status;
-    MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->wishbone_master_read(dev, addr, data);
+    status = bladerf_get_sync_rx_meta_msg_size(dev, &msg_size);
+    if (status != 0) {
+        return status;
+    }
 
-    MUTEX_UNLOCK(&dev->lock);
+    MUTEX_LOCK(&dev->rx_history_lock);
+
+    if (!dev->rx_sync_configured) {
+        log_debug("%s: RX has not been configured via bladerf_sync_config()\n",
+                  __FUNCTION__);
+        status = BLADERF_ERR_INVAL;
+        goto out;
+    }
+
+    switch (dev->rx_sync_format) {
+        case BLADERF_FORMAT_SC16_Q11_META:
+        case BLADERF_FORMAT_SC8_Q7_META:
+            break;
+
+        default:
+            log_debug("%s: Unsupported format: %d\n", __FUNCTION__,
+                      dev->rx_sync_format);
+            status = BLADERF_ERR_UNSUPPORTED;
+            goto out;
+    }
+
+    rx_history_stop(dev->rx_history);
+    dev->rx_history = NULL;
+
+    status = rx_history_start(&dev->rx_history, dev, dev->rx_sync_format,
+                              dev->rx_sync_channels, msg_size, num_buffers);
+
+out:
+    MUTEX_UNLOCK(&dev->rx_history_lock);
     return status;
 }
 
-int bladerf_wishbone_master_write(struct bladerf *dev, uint32_t addr, uint32_t data)
+int bladerf_rx_history_stop(struct bladerf *dev)
+{
+    MUTEX_LOCK(&dev->rx_history_lock);
+    rx_history_stop(dev->rx_history);
+    dev->rx_history = NULL;
+    MUTEX_UNLOCK(&dev->rx_history_lock);
+
+    return 0;
+}
+
+int bladerf_rx_history_range(struct bladerf *dev,
+                             bladerf_timestamp *start,
+                             bladerf_timestamp *end)
 {
     int status;
-    MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->wishbone_master_write(dev, addr, data);
+    CHECK_NULL(start, end);
 
-    MUTEX_UNLOCK(&dev->lock);
+    MUTEX_LOCK(&dev->rx_history_lock);
+
+    if (dev->rx_history == NULL) {
+        status = BLADERF_ERR_INVAL;
+    } else {
+        status = rx_history_range(dev->rx_history, start, end);
+    }
+
+    MUTEX_UNLOCK(&dev->rx_history_lock);
+    return status;
+}
+
+int bladerf_rx_history_read(struct bladerf *dev,
+                            void *samples,
+                            unsigned int num_samples,
+                            bladerf_timestamp timestamp,
+                            struct bladerf_metadata *metadata,
+                            unsigned int timeout_ms)
+{
+    int status;
+
+    CHECK_NULL(samples);
+
+    /* Held while waiting, such that the history is not stopped and freed
+     * from beneath the read. Reads are therefore serialized. */
+    MUTEX_LOCK(&dev->rx_history_lock);
+
+    if (dev->rx_history == NULL) {
+        status = BLADERF_ERR_INVAL;
+    } else {
+        status = rx_history_read(dev->rx_history, samples, num_samples,
+                                 timestamp, metadata, timeout_ms);
+    }
+
+    MUTEX_UNLOCK(&dev->rx_history_lock);
     return status;
 }
 
 /******************************************************************************/
-/* Low-level Configuration GPIO access */
+/* Control request statistics */
 /******************************************************************************/
 
-int bladerf_config_gpio_read(struct bladerf *dev, uint32_t *val)
+int bladerf_enable_control_stats(struct bladerf *dev, bool enable)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->config_gpio_read(dev, val);
+    /* The backend's functions change once the FPGA is loaded */
+    if (dev->backend->enable_control_stats == NULL) {
+        status = BLADERF_ERR_UNSUPPORTED;
+    } else {
+        status = dev->backend->enable_control_stats(dev, enable);
+    }
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
 
-int bladerf_config_gpio_write(struct bladerf *dev, uint32_t val)
+int bladerf_get_control_stats(struct bladerf *dev,
+                              struct bladerf_control_stats *stats)
 {
     int status;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->config_gpio_write(dev, val);
+    if (dev->backend->get_control_stats == NULL) {
+        status = BLADERF_ERR_UNSUPPORTED;
+    } else {
+        status = dev->backend->get_control_stats(dev, stats);
+    }
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -1616,14 +3667,51 @@ int bladerf_config_gpio_write(struct bladerf *dev, uint32_t val)
 /* Low-level SPI Flash access */
 /******************************************************************************/
 
+/* Flash accesses are split into chunks of this many pages (erase blocks),
+ * between which the device lock is offered to latency-critical operations.
+ * See helpers/dev_lock.h. */
+#ifndef FLASH_ACCESS_CHUNK_PAGES
+#   define FLASH_ACCESS_CHUNK_PAGES 256
+#endif
+
+#ifndef FLASH_ERASE_CHUNK_BLOCKS
+#   define FLASH_ERASE_CHUNK_BLOCKS 1
+#endif
+
+/* Reject requests extending past the end of flash before splitting them, so
+ * that they fail without any part having been carried out */
+static bool flash_range_valid(uint32_t start, uint32_t count, uint32_t size)
+{
+    return (uint64_t)start + count <= size;
+}
+
 int bladerf_erase_flash(struct bladerf *dev,
                         uint32_t erase_block,
                         uint32_t count)
 {
-    int status;
+    int status = 0;
+    uint32_t n;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->erase_flash(dev, erase_block, count);
+    if (!flash_range_valid(erase_block, count, dev->flash_arch->num_ebs)) {
+        MUTEX_UNLOCK(&dev->lock);
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* Erase a block at a time, such that latency-critical operations may
+     * be serviced in between */
+    while (status == 0 && count != 0) {
+        n = u32_min(count, FLASH_ERASE_CHUNK_BLOCKS);
+
+        status = dev->board->erase_flash(dev, erase_block, n);
+
+        erase_block += n;
+        count -= n;
+
+        if (status == 0 && count != 0) {
+            dev_lock_yield(dev);
+        }
+    }
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -1670,10 +3758,30 @@ int bladerf_read_flash(struct bladerf *dev,
                        uint32_t page,
                        uint32_t count)
 {
-    int status;
+    int status = 0;
+    uint32_t n;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->read_flash(dev, buf, page, count);
+    if (!flash_range_valid(page, count, dev->flash_arch->num_pages)) {
+        MUTEX_UNLOCK(&dev->lock);
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* Split large accesses, such that latency-critical operations may be
+     * serviced in between */
+    while (status == 0 && count != 0) {
+        n = u32_min(count, FLASH_ACCESS_CHUNK_PAGES);
+
+        status = dev->board->read_flash(dev, buf, page, n);
+
+        buf += (size_t)n * dev->flash_arch->psize_bytes;
+        page += n;
+        count -= n;
+
+        if (status == 0 && count != 0) {
+            dev_lock_yield(dev);
+        }
+    }
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -1709,10 +3817,30 @@ int bladerf_write_flash(struct bladerf *dev,
                         uint32_t page,
                         uint32_t count)
 {
-    int status;
+    int status = 0;
+    uint32_t n;
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->board->write_flash(dev, buf, page, count);
+    if (!flash_range_valid(page, count, dev->flash_arch->num_pages)) {
+        MUTEX_UNLOCK(&dev->lock);
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* Split large accesses, such that latency-critical operations may be
+     * serviced in between */
+    while (status == 0 && count != 0) {
+        n = u32_min(count, FLASH_ACCESS_CHUNK_PAGES);
+
+        status = dev->board->write_flash(dev, buf, page, n);
+
+        buf += (size_t)n * dev->flash_arch->psize_bytes;
+        page += n;
+        count -= n;
+
+        if (status == 0 && count != 0) {
+            dev_lock_yield(dev);
+        }
+    }
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -1856,6 +3984,13 @@ void bladerf_set_usb_reset_on_open(bool enabled)
 #endif
 }
 
+void bladerf_set_warm_open(bool enabled)
+{
+    bladerf_warm_open = enabled;
+
+    log_verbose("Warm open %s\n", enabled ? "enabled" : "disabled");
+}
+
 /******************************************************************************/
 /* Expansion board APIs */
 /******************************************************************************/
@@ -1866,6 +4001,7 @@ int bladerf_expansion_attach(struct bladerf *dev, bladerf_xb xb)
     MUTEX_LOCK(&dev->lock);
 
     status = dev->board->expansion_attach(dev, xb);
+    tune_cache_invalidate_all(dev);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -1902,6 +4038,10 @@ int bladerf_expansion_gpio_write(struct bladerf *dev, uint32_t val)
 
     status = xb100_gpio_write(dev, val);
 
+    if (dev->xb == BLADERF_XB_200) {
+        xb200_invalidate(dev);
+    }
+
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
@@ -1915,6 +4055,10 @@ int bladerf_expansion_gpio_masked_write(struct bladerf *dev,
 
     status = xb100_gpio_masked_write(dev, mask, val);
 
+    if (dev->xb == BLADERF_XB_200) {
+        xb200_invalidate(dev);
+    }
+
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
@@ -1937,6 +4081,10 @@ int bladerf_expansion_gpio_dir_write(struct bladerf *dev, uint32_t val)
 
     status = xb100_gpio_dir_write(dev, val);
 
+    if (dev->xb == BLADERF_XB_200) {
+        xb200_invalidate(dev);
+    }
+
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
@@ -1950,6 +4098,10 @@ int bladerf_expansion_gpio_dir_masked_write(struct bladerf *dev,
 
     status = xb100_gpio_dir_masked_write(dev, mask, val);
 
+    if (dev->xb == BLADERF_XB_200) {
+        xb200_invalidate(dev);
+    }
+
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
@@ -1964,6 +4116,7 @@ int bladerf_xb200_set_filterbank(struct bladerf *dev,
     MUTEX_LOCK(&dev->lock);
 
     status = xb200_set_filterbank(dev, ch, filter);
+    tune_cache_invalidate_all(dev);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -1990,6 +4143,7 @@ int bladerf_xb200_set_path(struct bladerf *dev,
     MUTEX_LOCK(&dev->lock);
 
     status = xb200_set_path(dev, ch, path);
+    tune_cache_invalidate_all(dev);
 
     MUTEX_UNLOCK(&dev->lock);
     return status;
@@ -2219,8 +4373,14 @@ int bladerf_load_gain_calibration(struct bladerf *dev, bladerf_channel ch, const
     strcpy(full_path_bin, full_path);
     ext = strstr(full_path_bin, ".csv");
     if (ext) {
-        log_debug("Converting gain calibration to binary format\n");
         strcpy(ext, ".tbl");
+    }
+
+    if (ext && gain_cal_bin_is_current(full_path, full_path_bin, ch)) {
+        log_debug("Using existing binary gain calibration: %s\n",
+                  full_path_bin);
+    } else if (ext) {
+        log_debug("Converting gain calibration to binary format\n");
         status = gain_cal_csv_to_bin(dev, full_path, full_path_bin, ch);
         if (status != 0) {
             log_error("Failed to convert csv to binary: %s -> %s\n",
@@ -2319,6 +4479,13 @@ int bladerf_print_gain_calibration(struct bladerf *dev, bladerf_channel ch, bool
     printf("  Stop Frequency: %" PRIu64 " Hz\n", gain_tbls[ch].stop_freq);
     printf("  File Path: %s\n", gain_tbls[ch].file_path);
 
+    if (dev->gain_luts[ch] != NULL) {
+        printf("  Lookup Resolution: %" PRIu64 " Hz\n",
+               dev->gain_luts[ch]->resolution);
+    } else {
+        printf("  Lookup Resolution: disabled\n");
+    }
+
     if (with_entries) {
         for (size_t i = 0; i < gain_tbls[ch].n_entries; i++) {
             printf("%" PRIu64 ",%f\n", gain_tbls[ch].entries[i].freq, gain_tbls[ch].entries[i].gain_corr);
@@ -2353,7 +4520,7 @@ int bladerf_get_gain_target(struct bladerf *dev, bladerf_channel ch, int *gain_t
     MUTEX_LOCK(&dev->lock);
     bladerf_frequency current_frequency;
     struct bladerf_gain_cal_tbl *cal_table = &dev->gain_tbls[ch];
-    struct bladerf_gain_cal_entry current_entry;
+    double gain_corr;
     bladerf_gain current_gain;
     bladerf_gain_mode gain_mode;
 
@@ -2378,10 +4545,57 @@ int bladerf_get_gain_target(struct bladerf *dev, bladerf_channel ch, int *gain_t
 
     CHECK_STATUS(dev->board->get_gain(dev, ch, &current_gain));
     CHECK_STATUS(dev->board->get_frequency(dev, ch, &current_frequency));
-    CHECK_STATUS(get_gain_cal_entry(cal_table, current_frequency, &current_entry));
-    *gain_target = current_gain + current_entry.gain_corr;
+    CHECK_STATUS(lookup_gain_correction(dev, ch, current_frequency, &gain_corr));
+    *gain_target = current_gain + gain_corr;
 
 error:
     MUTEX_UNLOCK(&dev->lock);
     return status;
 }
+
+int bladerf_set_gain_calibration_resolution(struct bladerf *dev,
+                                            bladerf_frequency resolution)
+{
+    int status = 0;
+    int i, s;
+
+    CHECK_NULL(dev);
+
+    if (resolution != 0 && resolution < BLADERF_GAIN_CAL_RESOLUTION_MIN) {
+        log_debug("%s: Resolution below minimum: %" PRIu64 " Hz\n",
+                  __FUNCTION__, resolution);
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    dev->gain_cal_resolution = resolution;
+
+    /* Release all tables first, so that none are shared at the old
+     * resolution */
+    for (i = 0; i < NUM_GAIN_CAL_TBLS; i++) {
+        gain_cal_lut_release(dev, i);
+    }
+
+    for (i = 0; i < NUM_GAIN_CAL_TBLS; i++) {
+        s = gain_cal_lut_update(dev, i);
+        if (s != 0 && status == 0) {
+            status = s;
+        }
+    }
+
+    MUTEX_UNLOCK(&dev->lock);
+    return status;
+}
+
+int bladerf_get_gain_calibration_resolution(struct bladerf *dev,
+                                            bladerf_frequency *resolution)
+{
+    CHECK_NULL(dev, resolution);
+
+    MUTEX_LOCK(&dev->lock);
+    *resolution = dev->gain_cal_resolution;
+    MUTEX_UNLOCK(&dev->lock);
+
+    return 0;
+}
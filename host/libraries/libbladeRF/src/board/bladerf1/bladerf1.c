@@ -41,9 +41,16 @@
 #include "driver/dac161s055.h"
 #include "driver/spi_flash.h"
 #include "driver/fpga_trigger.h"
+#include "driver/rx_gate.h"
+#include "driver/rx_power_meter.h"
 #include "lms.h"
 #include "nios_pkt_retune.h"
+#include "nios_pkt_dc_cal.h"
+#include "nios_pkt_retune_queue.h"
+#include "nios_pkt_timed_write.h"
+#include "nios_pkt_vctcxo_tamer.h"
 #include "band_select.h"
+#include "vco_table.h"
 
 #include "backend/usb/usb.h"
 #include "backend/backend_config.h"
@@ -57,7 +64,10 @@
 
 #include "devinfo.h"
 #include "helpers/version.h"
+#include "helpers/wallclock.h"
 #include "helpers/file.h"
+#include "helpers/fpga_image.h"
+#include "helpers/tune_cache.h"
 #include "version.h"
 
 /******************************************************************************
@@ -85,10 +95,24 @@ struct bladerf1_board_data {
     /* Which mode of operation we use for tuning */
     bladerf_tuning_mode tuning_mode;
 
+    /* Band last selected on each module by the host, so that retunes within
+     * a band may skip selecting it again. Reset to BAND_UNKNOWN wherever the
+     * LNA, PA, or band select GPIOs may otherwise change. */
+    enum {
+        BAND_UNKNOWN,
+        BAND_LOW,
+        BAND_HIGH,
+    } band[NUM_MODULES];
+
+    /* Sample rate multisynth state last written to or read from the Si5338
+     * for each module */
+    struct si5338_cache samplerate[NUM_MODULES];
+
     /* Calibration data */
     struct calibrations {
         struct dc_cal_tbl *dc_rx;
         struct dc_cal_tbl *dc_tx;
+        struct vco_table *vco;
     } cal;
     uint16_t dac_trim;
 
@@ -534,6 +558,24 @@ static int bladerf1_apply_lms_dc_cals(struct bladerf *dev)
     return 0;
 }
 
+/* Forget the band selections made by select_band() */
+static void invalidate_band(struct bladerf *dev)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    board_data->band[BLADERF_MODULE_RX] = BAND_UNKNOWN;
+    board_data->band[BLADERF_MODULE_TX] = BAND_UNKNOWN;
+}
+
+/* Forget the sample rate multisynth registers last seen in the Si5338 */
+static void invalidate_samplerate(struct bladerf *dev)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    si5338_cache_invalidate(&board_data->samplerate[BLADERF_MODULE_RX]);
+    si5338_cache_invalidate(&board_data->samplerate[BLADERF_MODULE_TX]);
+}
+
 /**
  * Initialize device registers - required after power-up, but safe
  * to call multiple times after power-up (e.g., multiple close and reopens)
@@ -546,6 +588,9 @@ static int bladerf1_initialize(struct bladerf *dev)
     int status;
     uint32_t val;
 
+    invalidate_band(dev);
+    invalidate_samplerate(dev);
+
     /* Read FPGA version */
     status = dev->backend->get_fpga_version(dev, &board_data->fpga_version);
     if (status < 0) {
@@ -717,12 +762,16 @@ static int bladerf1_initialize(struct bladerf *dev)
         }
 
         /* Set a default samplerate */
-        status = si5338_set_sample_rate(dev, BLADERF_CHANNEL_TX(0), 1000000, NULL);
+        status = si5338_set_sample_rate(
+            dev, &board_data->samplerate[BLADERF_MODULE_TX],
+            BLADERF_CHANNEL_TX(0), 1000000, NULL);
         if (status != 0) {
             return status;
         }
 
-        status = si5338_set_sample_rate(dev, BLADERF_CHANNEL_RX(0), 1000000, NULL);
+        status = si5338_set_sample_rate(
+            dev, &board_data->samplerate[BLADERF_MODULE_RX],
+            BLADERF_CHANNEL_RX(0), 1000000, NULL);
         if (status != 0) {
             return status;
         }
@@ -984,6 +1033,23 @@ static int bladerf1_open(struct bladerf *dev, struct bladerf_devinfo *devinfo)
         }
     }
 
+    /* The VCOCAP table is optional; without it, VCOCAP is searched for */
+    board_data->cal.vco = malloc(sizeof(*board_data->cal.vco));
+    if (board_data->cal.vco != NULL) {
+        status = vco_table_load(dev, board_data->cal.vco);
+        if (status != 0) {
+            if (status != BLADERF_ERR_NO_FILE) {
+                log_debug("Failed to load VCOCAP table: %s\n",
+                          bladerf_strerror(status));
+            }
+
+            free(board_data->cal.vco);
+            board_data->cal.vco = NULL;
+        } else {
+            log_verbose("Loaded VCOCAP table from flash.\n");
+        }
+    }
+
     /* Skip further work if BLADERF_FORCE_NO_FPGA_PRESENT is set */
     if (getenv("BLADERF_FORCE_NO_FPGA_PRESENT")) {
         log_debug("Skipping FPGA configuration and initialization - "
@@ -1066,12 +1132,11 @@ static int bladerf1_open(struct bladerf *dev, struct bladerf_devinfo *devinfo)
         }
 
         if (full_path != NULL) {
-            uint8_t *buf;
-            size_t buf_size;
+            struct fpga_image image;
 
             log_debug("Loading FPGA from: %s\n", full_path);
 
-            status = file_read_buffer(full_path, &buf, &buf_size);
+            status = fpga_image_open_file(&image, full_path);
 
             free(full_path);
             full_path = NULL;
@@ -1080,7 +1145,8 @@ static int bladerf1_open(struct bladerf *dev, struct bladerf_devinfo *devinfo)
                 return status;
             }
 
-            status = dev->backend->load_fpga(dev, buf, buf_size);
+            status = dev->backend->load_fpga(dev, &image);
+            fpga_image_close(&image);
             if (status != 0) {
                 log_warning("Failure loading FPGA: %s\n",
                             bladerf_strerror(status));
@@ -1171,6 +1237,7 @@ static void bladerf1_close(struct bladerf *dev)
 
         dc_cal_tbl_free(&board_data->cal.dc_rx);
         dc_cal_tbl_free(&board_data->cal.dc_tx);
+        free(board_data->cal.vco);
 
         free(board_data);
         board_data = NULL;
@@ -1912,16 +1979,30 @@ static int bladerf1_get_gain_stages(struct bladerf *dev,
 
 static int bladerf1_set_sample_rate(struct bladerf *dev, bladerf_channel ch, unsigned int rate, unsigned int *actual)
 {
+    struct bladerf1_board_data *board_data = dev->board_data;
+
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    return si5338_set_sample_rate(dev, ch, rate, actual);
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_TX(0)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return si5338_set_sample_rate(dev, &board_data->samplerate[ch], ch,
+                                  rate, actual);
 }
 
 static int bladerf1_get_sample_rate(struct bladerf *dev, bladerf_channel ch, unsigned int *rate)
 {
+    struct bladerf1_board_data *board_data = dev->board_data;
+
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    return si5338_get_sample_rate(dev, ch, rate);
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_TX(0)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return si5338_get_sample_rate(dev, &board_data->samplerate[ch], ch,
+                                  rate);
 }
 
 static int bladerf1_get_sample_rate_range(struct bladerf *dev, bladerf_channel ch, const struct bladerf_range **range)
@@ -1932,16 +2013,30 @@ static int bladerf1_get_sample_rate_range(struct bladerf *dev, bladerf_channel c
 
 static int bladerf1_set_rational_sample_rate(struct bladerf *dev, bladerf_channel ch, struct bladerf_rational_rate *rate, struct bladerf_rational_rate *actual)
 {
+    struct bladerf1_board_data *board_data = dev->board_data;
+
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    return si5338_set_rational_sample_rate(dev, ch, rate, actual);
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_TX(0)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return si5338_set_rational_sample_rate(dev, &board_data->samplerate[ch], ch,
+                                           rate, actual);
 }
 
 static int bladerf1_get_rational_sample_rate(struct bladerf *dev, bladerf_channel ch, struct bladerf_rational_rate *rate)
 {
+    struct bladerf1_board_data *board_data = dev->board_data;
+
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    return si5338_get_rational_sample_rate(dev, ch, rate);
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_TX(0)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return si5338_get_rational_sample_rate(dev, &board_data->samplerate[ch], ch,
+                                           rate);
 }
 
 /******************************************************************************/
@@ -2016,12 +2111,35 @@ static int bladerf1_get_bandwidth_range(struct bladerf *dev,
 /* Frequency */
 /******************************************************************************/
 
-static int bladerf1_set_frequency(struct bladerf *dev,
-                                  bladerf_channel ch,
-                                  bladerf_frequency frequency)
+static int select_band(struct bladerf *dev,
+                       bladerf_channel ch,
+                       bladerf_frequency frequency)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+    bool const low_band = frequency < BLADERF1_BAND_HIGH;
+    int status;
+
+    if (board_data->band[ch] == (low_band ? BAND_LOW : BAND_HIGH)) {
+        return 0;
+    }
+
+    board_data->band[ch] = BAND_UNKNOWN;
+
+    status = band_select(dev, ch, low_band);
+    if (status == 0) {
+        board_data->band[ch] = low_band ? BAND_LOW : BAND_HIGH;
+    }
+
+    return status;
+}
+
+/* Apply the DC offset corrections from the loaded calibration table, if any,
+ * for a frequency the channel has just been tuned to */
+static int apply_dc_cal(struct bladerf *dev,
+                        bladerf_channel ch,
+                        bladerf_frequency frequency)
 {
     struct bladerf1_board_data *board_data = dev->board_data;
-    const bladerf_xb attached              = dev->xb;
     int status;
     int16_t dc_i, dc_q;
     struct dc_cal_entry entry;
@@ -2029,41 +2147,91 @@ static int bladerf1_set_frequency(struct bladerf *dev,
                                           ? board_data->cal.dc_rx
                                           : board_data->cal.dc_tx;
 
+    if (dc_cal == NULL) {
+        return 0;
+    }
+
+    dc_cal_tbl_entry(dc_cal, (uint32_t)frequency, &entry);
+
+    dc_i = entry.dc_i;
+    dc_q = entry.dc_q;
+
+    status = lms_set_dc_offset_i(dev, ch, dc_i);
+    if (status != 0) {
+        return status;
+    }
+
+    status = lms_set_dc_offset_q(dev, ch, dc_q);
+    if (status != 0) {
+        return status;
+    }
+
+    if (ch == BLADERF_CHANNEL_RX(0) &&
+        have_cap(board_data->capabilities, BLADERF_CAP_AGC_DC_LUT)) {
+        status = dev->backend->set_agc_dc_correction(
+            dev, entry.max_dc_q, entry.max_dc_i, entry.mid_dc_q,
+            entry.mid_dc_i, entry.min_dc_q, entry.min_dc_i);
+        if (status != 0) {
+            return status;
+        }
+
+        log_verbose("Set AGC DC offset cal (I, Q) to: Max (%d, %d) "
+                    " Mid (%d, %d) Min (%d, %d)\n",
+                    entry.max_dc_q, entry.max_dc_i, entry.mid_dc_q,
+                    entry.mid_dc_i, entry.min_dc_q, entry.min_dc_i);
+    }
+
+    log_verbose("Set %s DC offset cal (I, Q) to: (%d, %d)\n",
+                (ch == BLADERF_CHANNEL_RX(0)) ? "RX" : "TX", dc_i, dc_q);
+
+    return 0;
+}
+
+static int bladerf1_set_frequency(struct bladerf *dev,
+                                  bladerf_channel ch,
+                                  bladerf_frequency frequency)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+    const bladerf_xb attached              = dev->xb;
+    int status;
+
     CHECK_BOARD_STATE(STATE_FPGA_LOADED);
 
     log_debug("Setting %s frequency to %" BLADERF_PRIuFREQ "\n",
               channel2str(ch), frequency);
 
     if (attached == BLADERF_XB_200) {
-        if (frequency < BLADERF_FREQUENCY_MIN) {
-            status = xb200_set_path(dev, ch, BLADERF_XB200_MIX);
-            if (status) {
-                return status;
-            }
+        status = xb200_set_frequency(dev, ch, frequency, &frequency);
+        if (status) {
+            return status;
+        }
+    }
+
+    switch (board_data->tuning_mode) {
+        case BLADERF_TUNING_MODE_HOST: {
+            struct lms_freq f;
 
-            status = xb200_auto_filter_selection(dev, ch, frequency);
-            if (status) {
+            status = lms_calculate_tuning_params((uint32_t)frequency, &f);
+            if (status != 0) {
                 return status;
             }
 
-            frequency = 1248000000 - frequency;
-        } else {
-            status = xb200_set_path(dev, ch, BLADERF_XB200_BYPASS);
-            if (status) {
-                return status;
+            /* With a characterized VCOCAP, only verify it rather than
+             * searching for it */
+            if (board_data->cal.vco != NULL) {
+                vco_table_apply(board_data->cal.vco, ch, (uint32_t)frequency,
+                                &f);
+                f.flags |= LMS_FREQ_FLAGS_VERIFY_VCOCAP;
             }
-        }
-    }
 
-    switch (board_data->tuning_mode) {
-        case BLADERF_TUNING_MODE_HOST:
-            status = lms_set_frequency(dev, ch, (uint32_t)frequency);
+            status = lms_set_precalculated_frequency(dev, ch, &f);
             if (status != 0) {
                 return status;
             }
 
-            status = band_select(dev, ch, frequency < BLADERF1_BAND_HIGH);
+            status = select_band(dev, ch, frequency);
             break;
+        }
 
         case BLADERF_TUNING_MODE_FPGA: {
             status = dev->board->schedule_retune(dev, ch, BLADERF_RETUNE_NOW,
@@ -2080,42 +2248,16 @@ static int bladerf1_set_frequency(struct bladerf *dev,
         return status;
     }
 
-    if (dc_cal != NULL) {
-        dc_cal_tbl_entry(dc_cal, (uint32_t)frequency, &entry);
-
-        dc_i = entry.dc_i;
-        dc_q = entry.dc_q;
-
-        status = lms_set_dc_offset_i(dev, ch, dc_i);
-        if (status != 0) {
-            return status;
-        }
-
-        status = lms_set_dc_offset_q(dev, ch, dc_q);
-        if (status != 0) {
-            return status;
-        }
-
-        if (ch == BLADERF_CHANNEL_RX(0) &&
-            have_cap(board_data->capabilities, BLADERF_CAP_AGC_DC_LUT)) {
-            status = dev->backend->set_agc_dc_correction(
-                dev, entry.max_dc_q, entry.max_dc_i, entry.mid_dc_q,
-                entry.mid_dc_i, entry.min_dc_q, entry.min_dc_i);
-            if (status != 0) {
-                return status;
-            }
-
-            log_verbose("Set AGC DC offset cal (I, Q) to: Max (%d, %d) "
-                        " Mid (%d, %d) Min (%d, %d)\n",
-                        entry.max_dc_q, entry.max_dc_i, entry.mid_dc_q,
-                        entry.mid_dc_i, entry.min_dc_q, entry.min_dc_i);
-        }
+    return apply_dc_cal(dev, ch, frequency);
+}
 
-        log_verbose("Set %s DC offset cal (I, Q) to: (%d, %d)\n",
-                    (ch == BLADERF_CHANNEL_RX(0)) ? "RX" : "TX", dc_i, dc_q);
-    }
+static int bladerf1_get_pll_lock(struct bladerf *dev,
+                                 bladerf_channel ch,
+                                 bool *locked)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
 
-    return 0;
+    return lms_get_pll_lock(dev, ch, locked);
 }
 
 static int bladerf1_get_frequency(struct bladerf *dev,
@@ -2177,7 +2319,7 @@ static int bladerf1_select_band(struct bladerf *dev,
 {
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    return band_select(dev, ch, frequency < BLADERF1_BAND_HIGH);
+    return select_band(dev, ch, frequency);
 }
 
 /******************************************************************************/
@@ -2247,6 +2389,7 @@ static int bladerf1_set_rf_port(struct bladerf *dev,
             }
         }
     } else {
+        invalidate_band(dev);
         status = lms_select_lna(dev, rx_lna);
     }
 
@@ -2393,14 +2536,29 @@ static int bladerf1_schedule_retune(struct bladerf *dev,
     }
 
     if (quick_tune == NULL) {
+        uint8_t xb_gpio = 0;
+
+        /* The NIOS II switches the path and filterbank along with the
+         * retune */
         if (dev->xb == BLADERF_XB_200) {
-           log_info("Consider supplying the quick_tune parameter to"
-                 " bladerf_schedule_retune() when the XB-200 is enabled.\n");
+            status = xb200_get_retune_params(dev, ch, frequency, &frequency,
+                                             &xb_gpio);
+            if (status != 0) {
+                return status;
+            }
         }
+
         status = lms_calculate_tuning_params((uint32_t)frequency, &f);
         if (status != 0) {
             return status;
         }
+
+        f.xb_gpio = xb_gpio;
+
+        /* The NIOS II still runs its own search, but from a better start */
+        if (board_data->cal.vco != NULL) {
+            vco_table_apply(board_data->cal.vco, ch, (uint32_t)frequency, &f);
+        }
     } else {
         f.freqsel       = quick_tune->freqsel;
         f.vcocap        = quick_tune->vcocap;
@@ -2412,11 +2570,30 @@ static int bladerf1_schedule_retune(struct bladerf *dev,
         f.vcocap_result = 0;
     }
 
-    return dev->backend->retune(dev, ch, timestamp, f.nint, f.nfrac, f.freqsel,
-                                f.vcocap,
-                                (f.flags & LMS_FREQ_FLAGS_LOW_BAND) != 0,
-                                f.xb_gpio,
-                                (f.flags & LMS_FREQ_FLAGS_FORCE_VCOCAP) != 0);
+    /* The NIOS II selects the band and any XB-200 GPIOs itself */
+    board_data->band[ch] = BAND_UNKNOWN;
+    if (dev->xb == BLADERF_XB_200) {
+        xb200_invalidate(dev);
+    }
+
+    status = dev->backend->retune(dev, ch, timestamp, f.nint, f.nfrac,
+                                  f.freqsel, f.vcocap,
+                                  (f.flags & LMS_FREQ_FLAGS_LOW_BAND) != 0,
+                                  f.xb_gpio,
+                                  (f.flags & LMS_FREQ_FLAGS_FORCE_VCOCAP) != 0);
+    if (status != 0) {
+        return status;
+    }
+
+    /* An immediate quick retune takes the place of bladerf_set_frequency(),
+     * so it applies the same DC corrections. The Nios II retune request has
+     * no room for them, so timed retunes keep the current corrections. */
+    if (timestamp == BLADERF_RETUNE_NOW && quick_tune != NULL) {
+        f.x = 1 << ((f.freqsel & 7) - 3);
+        status = apply_dc_cal(dev, ch, lms_frequency_to_hz(&f));
+    }
+
+    return status;
 }
 
 static int bladerf1_cancel_scheduled_retunes(struct bladerf *dev,
@@ -2443,6 +2620,121 @@ static int bladerf1_cancel_scheduled_retunes(struct bladerf *dev,
     return status;
 }
 
+static int bladerf1_get_retune_queue_status(
+    struct bladerf *dev,
+    bladerf_channel ch,
+    struct bladerf_retune_queue_status *status)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    if (status == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_RETUNE_QUEUE_CONTROL)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "retune queue queries.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return dev->backend->retune_queue(dev, ch, NIOS_PKT_RETUNE_QUEUE_CMD_QUERY,
+                                      0, 0, status, NULL);
+}
+
+static int bladerf1_cancel_scheduled_retunes_range(struct bladerf *dev,
+                                                   bladerf_channel ch,
+                                                   bladerf_timestamp start,
+                                                   bladerf_timestamp end,
+                                                   unsigned int *canceled)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_RETUNE_QUEUE_CONTROL)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "selective retune cancellation.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return dev->backend->retune_queue(dev, ch, NIOS_PKT_RETUNE_QUEUE_CMD_CANCEL,
+                                      start, end, NULL, canceled);
+}
+
+static int bladerf1_schedule_write(struct bladerf *dev,
+                                   bladerf_channel ch,
+                                   bladerf_timestamp timestamp,
+                                   bladerf_timed_write_target target,
+                                   uint32_t value)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_TIMED_WRITE)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "scheduled peripheral writes.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    switch (target) {
+        case BLADERF_TIMED_WRITE_CONFIG_GPIO:
+            return dev->backend->timed_write(dev, ch, timestamp,
+                                             NIOS_PKT_8x32_MAGIC,
+                                             NIOS_PKT_8x32_TARGET_CONTROL, 0,
+                                             value);
+
+        case BLADERF_TIMED_WRITE_EXPANSION_GPIO:
+            return dev->backend->timed_write(dev, ch, timestamp,
+                                             NIOS_PKT_32x32_MAGIC,
+                                             NIOS_PKT_32x32_TARGET_EXP, 0xff,
+                                             value);
+
+        case BLADERF_TIMED_WRITE_EXPANSION_GPIO_DIR:
+            return dev->backend->timed_write(dev, ch, timestamp,
+                                             NIOS_PKT_32x32_MAGIC,
+                                             NIOS_PKT_32x32_TARGET_EXP_DIR,
+                                             0xff, value);
+
+        case BLADERF_TIMED_WRITE_TRIM_DAC:
+            /* DAC161S055 channel 0 write. The DAC is left in write-through
+             * mode by dac161s055_write(). */
+            return dev->backend->timed_write(dev, ch, timestamp,
+                                             NIOS_PKT_8x16_MAGIC,
+                                             NIOS_PKT_8x16_TARGET_VCTCXO_DAC,
+                                             0x08, value & 0xffff);
+
+        case BLADERF_TIMED_WRITE_RFFE_CONTROL:
+            log_debug("%s: the bladeRF 1 has no RFFE control register\n",
+                      __FUNCTION__);
+            return BLADERF_ERR_UNSUPPORTED;
+
+        default:
+            log_debug("%s: invalid target: %d\n", __FUNCTION__, target);
+            return BLADERF_ERR_INVAL;
+    }
+}
+
+static int bladerf1_get_rfic_temperature(struct bladerf *dev, float *val)
+{
+    /* The LMS6002D has no temperature sensor */
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
 /******************************************************************************/
 /* DC/Phase/Gain Correction */
 /******************************************************************************/
@@ -2599,6 +2891,23 @@ static int bladerf1_trigger_state(struct bladerf *dev, const struct bladerf_trig
     return status;
 }
 
+static int bladerf1_get_trigger_time(struct bladerf *dev,
+                                     const struct bladerf_trigger *trigger,
+                                     struct bladerf_trigger_time *time)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_TRIGGER_TIME)) {
+        log_debug("FPGA v%s does not support trigger times.\n",
+                  board_data->fpga_version.describe);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return fpga_trigger_time(dev, trigger, time);
+}
+
 /******************************************************************************/
 /* Streaming */
 /******************************************************************************/
@@ -2617,6 +2926,11 @@ static inline int requires_timestamps(bladerf_format format, bool *required)
             *required = false;
             break;
 
+        /* The bladeRF x40/x115 FPGA does not pack samples */
+        case BLADERF_FORMAT_SC12_PACKED:
+        case BLADERF_FORMAT_SC12_PACKED_META:
+            return BLADERF_ERR_UNSUPPORTED;
+
         default:
             return BLADERF_ERR_INVAL;
     }
@@ -2734,12 +3048,13 @@ static int perform_format_deconfig(struct bladerf *dev, bladerf_direction dir)
     return 0;
 }
 
-static int bladerf1_init_stream(struct bladerf_stream **stream, struct bladerf *dev, bladerf_stream_cb callback, void ***buffers, size_t num_buffers, bladerf_format format, size_t samples_per_buffer, size_t num_transfers, void *user_data)
+static int bladerf1_init_stream(struct bladerf_stream **stream, struct bladerf *dev, bladerf_stream_cb callback, void ***buffers, size_t num_buffers, bladerf_format format, size_t samples_per_buffer, size_t num_transfers, void *user_data, const struct bladerf_buffer_allocator *allocator)
 {
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
     return async_init_stream(stream, dev, callback, buffers, num_buffers,
-                             format, samples_per_buffer, num_transfers, user_data);
+                             format, samples_per_buffer, num_transfers, user_data,
+                             allocator);
 }
 
 static int bladerf1_stream(struct bladerf_stream *stream, bladerf_channel_layout layout)
@@ -2800,56 +3115,175 @@ static int bladerf1_get_stream_timeout(struct bladerf *dev, bladerf_direction di
     return 0;
 }
 
-static int bladerf1_sync_config(struct bladerf *dev, bladerf_channel_layout layout, bladerf_format format, unsigned int num_buffers, unsigned int buffer_size, unsigned int num_transfers, unsigned int stream_timeout)
+static int bladerf1_set_sync_wait_policy(struct bladerf *dev, bladerf_direction dir, bladerf_sync_wait_policy policy, unsigned int spin_us)
 {
     struct bladerf1_board_data *board_data = dev->board_data;
-    bladerf_direction dir = layout & BLADERF_DIRECTION_MASK;
-    int status;
 
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    if (layout != BLADERF_RX_X1 && layout != BLADERF_TX_X1) {
-        return -EINVAL;
-    }
-
-    status = perform_format_config(dev, dir, format);
-    if (status == 0) {
-        status = sync_init(&board_data->sync[dir], dev, layout,
-                           format, num_buffers, buffer_size,
-                           board_data->msg_size, num_transfers,
-                           stream_timeout);
-        if (status != 0) {
-            perform_format_deconfig(dev, dir);
-        }
-    }
-
-    return status;
+    return sync_set_wait_policy(&board_data->sync[dir], policy, spin_us);
 }
 
-static int bladerf1_sync_tx(struct bladerf *dev,
-                            void const *samples,
-                            unsigned int num_samples,
-                            struct bladerf_metadata *metadata,
-                            unsigned int timeout_ms)
+static int bladerf1_set_sync_thread_attrs(struct bladerf *dev, bladerf_direction dir, const struct bladerf_thread_attrs *attrs)
 {
     struct bladerf1_board_data *board_data = dev->board_data;
-    int status;
-
-    if (!board_data->sync[BLADERF_TX].initialized) {
-        return BLADERF_ERR_INVAL;
-    }
 
-    status = sync_tx(&board_data->sync[BLADERF_TX], samples, num_samples,
-                     metadata, timeout_ms);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    return status;
+    return sync_set_thread_attrs(&board_data->sync[dir], attrs);
 }
 
-static int bladerf1_sync_rx(struct bladerf *dev,
-                            void *samples,
-                            unsigned int num_samples,
-                            struct bladerf_metadata *metadata,
-                            unsigned int timeout_ms)
+static int bladerf1_set_sync_buffer_allocator(struct bladerf *dev, bladerf_direction dir, const struct bladerf_buffer_allocator *allocator)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    return sync_set_buffer_allocator(&board_data->sync[dir], allocator);
+}
+
+static int bladerf1_set_sync_rx_pool(struct bladerf *dev, bool enable)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    sync_set_rx_pool(&board_data->sync[BLADERF_RX], enable);
+    return 0;
+}
+
+static int bladerf1_set_sync_tx_pool(struct bladerf *dev, bool enable)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    sync_set_tx_pool(&board_data->sync[BLADERF_TX], enable);
+    return 0;
+}
+
+static int bladerf1_set_sync_rx_stats(struct bladerf *dev, bool enable, unsigned int clip_threshold)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    return sync_set_rx_stats(&board_data->sync[BLADERF_RX], enable,
+                             clip_threshold);
+}
+
+static int bladerf1_get_sync_rx_stats(struct bladerf *dev, struct bladerf_rx_stats *stats)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_get_rx_stats(&board_data->sync[BLADERF_RX], stats);
+}
+
+static int bladerf1_set_sync_rx_tap(struct bladerf *dev,
+                                    const struct bladerf_sync_rx_tap *tap)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    return sync_set_rx_tap(&board_data->sync[BLADERF_RX], tap);
+}
+
+static int bladerf1_set_sync_rx_meta_msg_size(struct bladerf *dev,
+                                              unsigned int size)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    /* The bladeRF 1 FPGA always places a header in every DMA buffer */
+    if (size != 0 && size != board_data->msg_size) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return 0;
+}
+
+static int bladerf1_get_sync_rx_meta_msg_size(struct bladerf *dev,
+                                              unsigned int *size)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    *size = (unsigned int)board_data->msg_size;
+    return 0;
+}
+
+static int bladerf1_get_stream_stats(struct bladerf *dev, bladerf_direction dir, struct bladerf_stream_stats *stats)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    if (!board_data->sync[dir].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_get_stats(&board_data->sync[dir], stats);
+}
+
+static int bladerf1_sync_config(struct bladerf *dev, bladerf_channel_layout layout, bladerf_format format, unsigned int num_buffers, unsigned int buffer_size, unsigned int num_transfers, unsigned int stream_timeout)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+    bladerf_direction dir = layout & BLADERF_DIRECTION_MASK;
+    int status;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    if (layout != BLADERF_RX_X1 && layout != BLADERF_TX_X1) {
+        return -EINVAL;
+    }
+
+    status = perform_format_config(dev, dir, wire_format(format));
+    if (status == 0) {
+        status = sync_init(&board_data->sync[dir], dev, layout,
+                           format, num_buffers, buffer_size,
+                           board_data->msg_size, num_transfers,
+                           stream_timeout);
+        if (status != 0) {
+            perform_format_deconfig(dev, dir);
+        }
+    }
+
+    return status;
+}
+
+static int bladerf1_sync_tx(struct bladerf *dev,
+                            void const *samples,
+                            unsigned int num_samples,
+                            struct bladerf_metadata *metadata,
+                            unsigned int timeout_ms)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+    int status;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = sync_tx(&board_data->sync[BLADERF_TX], samples, num_samples,
+                     metadata, timeout_ms);
+
+    return status;
+}
+
+static int bladerf1_sync_rx(struct bladerf *dev,
+                            void *samples,
+                            unsigned int num_samples,
+                            struct bladerf_metadata *metadata,
+                            unsigned int timeout_ms)
 {
     struct bladerf1_board_data *board_data = dev->board_data;
     int status;
@@ -2864,6 +3298,245 @@ static int bladerf1_sync_rx(struct bladerf *dev,
     return status;
 }
 
+static int bladerf1_sync_tx_nb(struct bladerf *dev,
+                               void const *samples,
+                               unsigned int num_samples,
+                               struct bladerf_metadata *metadata)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_tx_nb(&board_data->sync[BLADERF_TX], samples, num_samples,
+                      metadata);
+}
+
+static int bladerf1_sync_rx_nb(struct bladerf *dev,
+                               void *samples,
+                               unsigned int num_samples,
+                               struct bladerf_metadata *metadata)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_rx_nb(&board_data->sync[BLADERF_RX], samples, num_samples,
+                      metadata);
+}
+
+static int bladerf1_sync_get_ready_fd(struct bladerf *dev,
+                                      bladerf_direction dir,
+                                      bladerf_ready_fd *fd)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!board_data->sync[dir].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_get_ready_fd(&board_data->sync[dir], fd);
+}
+
+static int bladerf1_sync_tx_multi(struct bladerf *dev,
+                                  const void *const *bufs,
+                                  unsigned int num_samples,
+                                  struct bladerf_metadata *metadata,
+                                  unsigned int timeout_ms)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_tx_multi(&board_data->sync[BLADERF_TX], bufs, num_samples,
+                         metadata, timeout_ms);
+}
+
+static int bladerf1_sync_rx_multi(struct bladerf *dev,
+                                  void *const *bufs,
+                                  unsigned int num_samples,
+                                  struct bladerf_metadata *metadata,
+                                  unsigned int timeout_ms)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_rx_multi(&board_data->sync[BLADERF_RX], bufs, num_samples,
+                         metadata, timeout_ms);
+}
+
+static int bladerf1_sync_rx_packets(struct bladerf *dev,
+                                    struct bladerf_packet *packets,
+                                    unsigned int num_packets,
+                                    unsigned int *num_received,
+                                    unsigned int timeout_ms)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_rx_packets(&board_data->sync[BLADERF_RX], packets,
+                           num_packets, num_received, timeout_ms);
+}
+
+static int bladerf1_sync_tx_packets(struct bladerf *dev,
+                                    const struct bladerf_packet *packets,
+                                    unsigned int num_packets,
+                                    unsigned int *num_sent,
+                                    unsigned int timeout_ms)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_tx_packets(&board_data->sync[BLADERF_TX], packets,
+                           num_packets, num_sent, timeout_ms);
+}
+
+static int bladerf1_sync_create_tx_template(struct bladerf *dev,
+                                           const void *samples,
+                                           unsigned int num_samples,
+                                           struct bladerf_tx_template **tmpl)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_tx_template_create(&board_data->sync[BLADERF_TX], samples,
+                                   num_samples, tmpl);
+}
+
+static int bladerf1_sync_tx_template(struct bladerf *dev,
+                                    struct bladerf_tx_template *tmpl,
+                                    bladerf_timestamp timestamp,
+                                    unsigned int timeout_ms)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_tx_template(&board_data->sync[BLADERF_TX], tmpl, timestamp,
+                            timeout_ms);
+}
+
+static int bladerf1_sync_free_tx_template(struct bladerf *dev,
+                                         struct bladerf_tx_template *tmpl)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_tx_template_free(&board_data->sync[BLADERF_TX], tmpl);
+}
+
+static int bladerf1_sync_rx_acquire(struct bladerf *dev,
+                                    void **buffer,
+                                    unsigned int *num_samples,
+                                    struct bladerf_metadata *metadata,
+                                    unsigned int timeout_ms)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_rx_acquire(&board_data->sync[BLADERF_RX], buffer, num_samples,
+                           metadata, timeout_ms);
+}
+
+static int bladerf1_sync_rx_release(struct bladerf *dev, void *buffer)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_rx_release(&board_data->sync[BLADERF_RX], buffer);
+}
+
+static int bladerf1_sync_prearm(struct bladerf *dev, bladerf_direction dir)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!board_data->sync[dir].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_prearm(&board_data->sync[dir]);
+}
+
+static int bladerf1_sync_tx_acquire(struct bladerf *dev,
+                                    void **buffer,
+                                    unsigned int *num_samples,
+                                    unsigned int timeout_ms)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_tx_acquire(&board_data->sync[BLADERF_TX], buffer, num_samples,
+                           timeout_ms);
+}
+
+static int bladerf1_sync_tx_submit(struct bladerf *dev,
+                                   void *buffer,
+                                   unsigned int num_samples)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_tx_submit(&board_data->sync[BLADERF_TX], buffer, num_samples);
+}
+
+static int bladerf1_sync_tx_reserve(struct bladerf *dev,
+                                    void **buffer,
+                                    unsigned int *num_samples,
+                                    uint64_t *position,
+                                    unsigned int timeout_ms)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_tx_reserve(&board_data->sync[BLADERF_TX], buffer, num_samples,
+                           position, timeout_ms);
+}
+
 static int bladerf1_get_timestamp(struct bladerf *dev,
                                   bladerf_direction dir,
                                   bladerf_timestamp *value)
@@ -2927,20 +3600,20 @@ static bool is_valid_fpga_size(struct bladerf *dev,
     return valid;
 }
 
-static int bladerf1_load_fpga(struct bladerf *dev, const uint8_t *buf, size_t length)
+static int bladerf1_load_fpga(struct bladerf *dev, struct fpga_image *image)
 {
     struct bladerf1_board_data *board_data = dev->board_data;
     int status;
 
     CHECK_BOARD_STATE(STATE_FIRMWARE_LOADED);
 
-    if (!is_valid_fpga_size(dev, board_data->fpga_size, length)) {
+    if (!is_valid_fpga_size(dev, board_data->fpga_size, image->size)) {
         return BLADERF_ERR_INVAL;
     }
 
     MUTEX_LOCK(&dev->lock);
 
-    status = dev->backend->load_fpga(dev, buf, length);
+    status = dev->backend->load_fpga(dev, image);
     if (status != 0) {
         MUTEX_UNLOCK(&dev->lock);
         return status;
@@ -3088,6 +3761,9 @@ static int bladerf1_set_loopback(struct bladerf *dev, bladerf_loopback l)
 
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
+    /* Entering or leaving loopback changes the LNA and PA selections */
+    invalidate_band(dev);
+
     if (l == BLADERF_LB_FIRMWARE) {
         /* Firmware loopback was fully implemented in FW v1.7.1
          * (1.7.0 could enable it, but 1.7.1 also allowed readback,
@@ -3174,67 +3850,262 @@ static int bladerf1_set_rx_mux(struct bladerf *dev, bladerf_rx_mux mode)
 
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    /* Validate desired mux mode */
-    switch (mode) {
-        case BLADERF_RX_MUX_BASEBAND:
-        case BLADERF_RX_MUX_12BIT_COUNTER:
-        case BLADERF_RX_MUX_32BIT_COUNTER:
-        case BLADERF_RX_MUX_DIGITAL_LOOPBACK:
-            rx_mux_val = ((uint32_t) mode) << BLADERF_GPIO_RX_MUX_SHIFT;
-            break;
-
-        default:
-            log_debug("Invalid RX mux mode setting passed to %s(): %d\n",
-                      mode, __FUNCTION__);
-            return BLADERF_ERR_INVAL;
+    /* Validate desired mux mode */
+    switch (mode) {
+        case BLADERF_RX_MUX_BASEBAND:
+        case BLADERF_RX_MUX_12BIT_COUNTER:
+        case BLADERF_RX_MUX_32BIT_COUNTER:
+        case BLADERF_RX_MUX_DIGITAL_LOOPBACK:
+            rx_mux_val = ((uint32_t) mode) << BLADERF_GPIO_RX_MUX_SHIFT;
+            break;
+
+        default:
+            log_debug("Invalid RX mux mode setting passed to %s(): %d\n",
+                      mode, __FUNCTION__);
+            return BLADERF_ERR_INVAL;
+    }
+
+    status = dev->backend->config_gpio_read(dev, &config_gpio);
+    if (status != 0) {
+        return status;
+    }
+
+    /* Clear out and assign the associated RX mux bits */
+    config_gpio &= ~BLADERF_GPIO_RX_MUX_MASK;
+    config_gpio |= rx_mux_val;
+
+    return dev->backend->config_gpio_write(dev, config_gpio);
+}
+
+static int bladerf1_get_rx_mux(struct bladerf *dev, bladerf_rx_mux *mode)
+{
+    bladerf_rx_mux val;
+    uint32_t config_gpio;
+    int status;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    status = dev->backend->config_gpio_read(dev, &config_gpio);
+    if (status != 0) {
+        return status;
+    }
+
+    /* Extract RX mux bits */
+    config_gpio &= BLADERF_GPIO_RX_MUX_MASK;
+    config_gpio >>= BLADERF_GPIO_RX_MUX_SHIFT;
+    val = (bladerf_rx_mux) (config_gpio);
+
+    /* Enure it's a valid/supported value */
+    switch (val) {
+        case BLADERF_RX_MUX_BASEBAND:
+        case BLADERF_RX_MUX_12BIT_COUNTER:
+        case BLADERF_RX_MUX_32BIT_COUNTER:
+        case BLADERF_RX_MUX_DIGITAL_LOOPBACK:
+            *mode = val;
+            break;
+
+        default:
+            *mode = BLADERF_RX_MUX_INVALID;
+            status = BLADERF_ERR_UNEXPECTED;
+            log_debug("Invalid rx mux mode %d read from config gpio\n", val);
+    }
+
+    return status;
+}
+
+/******************************************************************************/
+/* RX FPGA decimation */
+/******************************************************************************/
+
+static int bladerf1_set_rx_decimation(struct bladerf *dev,
+                                      unsigned int decimation,
+                                      int32_t nco_offset)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int bladerf1_get_rx_decimation(struct bladerf *dev,
+                                      unsigned int *decimation,
+                                      int32_t *nco_offset)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+/******************************************************************************/
+/* TX waveform playback */
+/******************************************************************************/
+
+static int bladerf1_tx_load_waveform(struct bladerf *dev,
+                                     const int16_t *samples,
+                                     unsigned int num_samples)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int bladerf1_tx_loop_start(struct bladerf *dev,
+                                  unsigned int interpolation)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int bladerf1_tx_loop_stop(struct bladerf *dev)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+/******************************************************************************/
+/* RX power measurement */
+/******************************************************************************/
+
+static int bladerf1_rx_power_check(struct bladerf *dev, bladerf_channel ch)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RX_POWER_METER)) {
+        log_debug("FPGA %s does not support RX power measurement\n",
+                  board_data->fpga_version.describe);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (ch != BLADERF_CHANNEL_RX(0)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return 0;
+}
+
+static int bladerf1_measure_rx_power(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     unsigned int num_samples,
+                                     struct bladerf_rx_power *power)
+{
+    int status;
+    unsigned int rate;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    status = bladerf1_rx_power_check(dev, ch);
+    if (status != 0) {
+        return status;
+    }
+
+    status = bladerf1_get_sample_rate(dev, ch, &rate);
+    if (status != 0) {
+        return status;
+    }
+
+    return rx_power_meter_measure(dev, 0, rate, num_samples, power);
+}
+
+static int bladerf1_rx_snapshot(struct bladerf *dev,
+                                bladerf_channel ch,
+                                int16_t *samples,
+                                unsigned int num_samples)
+{
+    int status;
+    unsigned int rate;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    status = bladerf1_rx_power_check(dev, ch);
+    if (status != 0) {
+        return status;
+    }
+
+    status = bladerf1_get_sample_rate(dev, ch, &rate);
+    if (status != 0) {
+        return status;
+    }
+
+    return rx_power_meter_snapshot(dev, 0, rate, samples, num_samples);
+}
+
+/******************************************************************************/
+/* Scheduled RX start */
+/******************************************************************************/
+
+static int bladerf1_rx_gate_check(struct bladerf *dev)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RX_GATE)) {
+        log_debug("FPGA %s does not support scheduling RX\n",
+                  board_data->fpga_version.describe);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return 0;
+}
+
+static int bladerf1_schedule_rx(struct bladerf *dev,
+                                bladerf_timestamp timestamp,
+                                unsigned int num_samples)
+{
+    int status;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    status = bladerf1_rx_gate_check(dev);
+    if (status != 0) {
+        return status;
+    }
+
+    return rx_gate_schedule(dev, timestamp, num_samples);
+}
+
+static int bladerf1_schedule_rx_bursts(struct bladerf *dev,
+                                       bladerf_timestamp timestamp,
+                                       unsigned int burst_len,
+                                       unsigned int period)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+    unsigned int msg_samples;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RX_BURSTS)) {
+        log_debug("FPGA %s does not support RX bursts\n",
+                  board_data->fpga_version.describe);
+        return BLADERF_ERR_UNSUPPORTED;
     }
 
-    status = dev->backend->config_gpio_read(dev, &config_gpio);
-    if (status != 0) {
-        return status;
+    if (burst_len == 0 || period < burst_len) {
+        log_debug("Invalid burst: %u samples every %u\n", burst_len, period);
+        return BLADERF_ERR_INVAL;
     }
 
-    /* Clear out and assign the associated RX mux bits */
-    config_gpio &= ~BLADERF_GPIO_RX_MUX_MASK;
-    config_gpio |= rx_mux_val;
+    msg_samples = sync_rx_msg_samples(&board_data->sync[BLADERF_RX]);
+    if (msg_samples != 0 && burst_len % msg_samples != 0) {
+        log_debug("Burst length must be a multiple of %u samples\n",
+                  msg_samples);
+        return BLADERF_ERR_INVAL;
+    }
 
-    return dev->backend->config_gpio_write(dev, config_gpio);
+    return rx_gate_schedule_bursts(dev, timestamp, burst_len, period);
 }
 
-static int bladerf1_get_rx_mux(struct bladerf *dev, bladerf_rx_mux *mode)
+static int bladerf1_cancel_rx_schedule(struct bladerf *dev)
 {
-    bladerf_rx_mux val;
-    uint32_t config_gpio;
     int status;
 
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    status = dev->backend->config_gpio_read(dev, &config_gpio);
+    status = bladerf1_rx_gate_check(dev);
     if (status != 0) {
         return status;
     }
 
-    /* Extract RX mux bits */
-    config_gpio &= BLADERF_GPIO_RX_MUX_MASK;
-    config_gpio >>= BLADERF_GPIO_RX_MUX_SHIFT;
-    val = (bladerf_rx_mux) (config_gpio);
-
-    /* Enure it's a valid/supported value */
-    switch (val) {
-        case BLADERF_RX_MUX_BASEBAND:
-        case BLADERF_RX_MUX_12BIT_COUNTER:
-        case BLADERF_RX_MUX_32BIT_COUNTER:
-        case BLADERF_RX_MUX_DIGITAL_LOOPBACK:
-            *mode = val;
-            break;
-
-        default:
-            *mode = BLADERF_RX_MUX_INVALID;
-            status = BLADERF_ERR_UNEXPECTED;
-            log_debug("Invalid rx mux mode %d read from config gpio\n", val);
-    }
-
-    return status;
+    return rx_gate_cancel(dev);
 }
 
 /******************************************************************************/
@@ -3245,6 +4116,7 @@ static int bladerf1_set_vctcxo_tamer_mode(struct bladerf *dev,
                                           bladerf_vctcxo_tamer_mode mode)
 {
     struct bladerf1_board_data *board_data = dev->board_data;
+    int status;
 
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
@@ -3254,7 +4126,20 @@ static int bladerf1_set_vctcxo_tamer_mode(struct bladerf *dev,
         return BLADERF_ERR_UNSUPPORTED;
     }
 
-    return dev->backend->set_vctcxo_tamer_mode(dev, mode);
+    status = dev->backend->set_vctcxo_tamer_mode(dev, mode);
+    if (status != 0 || mode == BLADERF_VCTCXO_TAMER_DISABLED) {
+        return status;
+    }
+
+    /* Start from the factory trim, which is usually close to error-free,
+     * rather than measuring across the trim DAC's full range */
+    if (have_cap(board_data->capabilities, BLADERF_CAP_VCTCXO_TAMER_STATUS)) {
+        status = dev->backend->vctcxo_tamer(dev,
+                                            NIOS_PKT_VCTCXO_TAMER_CMD_ACQUIRE,
+                                            true, board_data->dac_trim, NULL);
+    }
+
+    return status;
 }
 
 static int bladerf1_get_vctcxo_tamer_mode(struct bladerf *dev,
@@ -3273,6 +4158,40 @@ static int bladerf1_get_vctcxo_tamer_mode(struct bladerf *dev,
     return dev->backend->get_vctcxo_tamer_mode(dev, mode);
 }
 
+static int bladerf1_get_vctcxo_tamer_status(
+    struct bladerf *dev, struct bladerf_vctcxo_tamer_status *status)
+{
+    struct bladerf1_board_data *board_data = dev->board_data;
+    bladerf_vctcxo_tamer_mode mode;
+    int rv;
+
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_VCTCXO_TAMER_STATUS)) {
+        log_debug("FPGA %s does not support VCTCXO tamer status\n",
+                  board_data->fpga_version.describe);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    rv = dev->backend->get_vctcxo_tamer_mode(dev, &mode);
+    if (rv != 0) {
+        return rv;
+    }
+
+    rv = dev->backend->vctcxo_tamer(dev, NIOS_PKT_VCTCXO_TAMER_CMD_QUERY,
+                                    false, 0, status);
+    if (rv != 0) {
+        return rv;
+    }
+
+    if (mode == BLADERF_VCTCXO_TAMER_DISABLED) {
+        status->state  = BLADERF_VCTCXO_TAMER_STATE_DISABLED;
+        status->locked = false;
+    }
+
+    return 0;
+}
+
 /******************************************************************************/
 /* Low-level VCTCXO Trim DAC access */
 /******************************************************************************/
@@ -3363,9 +4282,29 @@ static int bladerf1_config_gpio_write(struct bladerf *dev, uint32_t val)
 {
     CHECK_BOARD_STATE(STATE_FPGA_LOADED);
 
+    invalidate_band(dev);
+
     return dev->backend->config_gpio_write(dev, val);
 }
 
+/******************************************************************************/
+/* Control request batching */
+/******************************************************************************/
+
+static int bladerf1_batch_begin(struct bladerf *dev)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    return dev->backend->batch_begin(dev);
+}
+
+static int bladerf1_batch_commit(struct bladerf *dev)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    return dev->backend->batch_commit(dev);
+}
+
 /******************************************************************************/
 /* Low-level SPI Flash access */
 /******************************************************************************/
@@ -3559,20 +4498,29 @@ const struct board_fns bladerf1_board_fns = {
     FIELD_INIT(.get_bandwidth_range, bladerf1_get_bandwidth_range),
     FIELD_INIT(.get_frequency, bladerf1_get_frequency),
     FIELD_INIT(.set_frequency, bladerf1_set_frequency),
+    FIELD_INIT(.set_frequency_begin, bladerf1_set_frequency),
+    FIELD_INIT(.get_pll_lock, bladerf1_get_pll_lock),
     FIELD_INIT(.get_frequency_range, bladerf1_get_frequency_range),
     FIELD_INIT(.select_band, bladerf1_select_band),
     FIELD_INIT(.set_rf_port, bladerf1_set_rf_port),
     FIELD_INIT(.get_rf_port, bladerf1_get_rf_port),
     FIELD_INIT(.get_rf_ports, bladerf1_get_rf_ports),
     FIELD_INIT(.get_quick_tune, bladerf1_get_quick_tune),
+    FIELD_INIT(.update_quick_tune, bladerf1_get_quick_tune),
     FIELD_INIT(.schedule_retune, bladerf1_schedule_retune),
     FIELD_INIT(.cancel_scheduled_retunes, bladerf1_cancel_scheduled_retunes),
+    FIELD_INIT(.cancel_scheduled_retunes_range,
+               bladerf1_cancel_scheduled_retunes_range),
+    FIELD_INIT(.get_retune_queue_status, bladerf1_get_retune_queue_status),
+    FIELD_INIT(.schedule_write, bladerf1_schedule_write),
+    FIELD_INIT(.get_rfic_temperature, bladerf1_get_rfic_temperature),
     FIELD_INIT(.get_correction, bladerf1_get_correction),
     FIELD_INIT(.set_correction, bladerf1_set_correction),
     FIELD_INIT(.trigger_init, bladerf1_trigger_init),
     FIELD_INIT(.trigger_arm, bladerf1_trigger_arm),
     FIELD_INIT(.trigger_fire, bladerf1_trigger_fire),
     FIELD_INIT(.trigger_state, bladerf1_trigger_state),
+    FIELD_INIT(.get_trigger_time, bladerf1_get_trigger_time),
     FIELD_INIT(.enable_module, bladerf1_enable_module),
     FIELD_INIT(.init_stream, bladerf1_init_stream),
     FIELD_INIT(.stream, bladerf1_stream),
@@ -3580,9 +4528,36 @@ const struct board_fns bladerf1_board_fns = {
     FIELD_INIT(.deinit_stream, bladerf1_deinit_stream),
     FIELD_INIT(.set_stream_timeout, bladerf1_set_stream_timeout),
     FIELD_INIT(.get_stream_timeout, bladerf1_get_stream_timeout),
+    FIELD_INIT(.set_sync_wait_policy, bladerf1_set_sync_wait_policy),
+    FIELD_INIT(.get_stream_stats, bladerf1_get_stream_stats),
+    FIELD_INIT(.set_sync_thread_attrs, bladerf1_set_sync_thread_attrs),
+    FIELD_INIT(.set_sync_buffer_allocator, bladerf1_set_sync_buffer_allocator),
+    FIELD_INIT(.set_sync_rx_pool, bladerf1_set_sync_rx_pool),
+    FIELD_INIT(.set_sync_tx_pool, bladerf1_set_sync_tx_pool),
+    FIELD_INIT(.set_sync_rx_stats, bladerf1_set_sync_rx_stats),
+    FIELD_INIT(.get_sync_rx_stats, bladerf1_get_sync_rx_stats),
+    FIELD_INIT(.set_sync_rx_tap, bladerf1_set_sync_rx_tap),
+    FIELD_INIT(.set_sync_rx_meta_msg_size, bladerf1_set_sync_rx_meta_msg_size),
+    FIELD_INIT(.get_sync_rx_meta_msg_size, bladerf1_get_sync_rx_meta_msg_size),
     FIELD_INIT(.sync_config, bladerf1_sync_config),
     FIELD_INIT(.sync_tx, bladerf1_sync_tx),
     FIELD_INIT(.sync_rx, bladerf1_sync_rx),
+    FIELD_INIT(.sync_tx_nb, bladerf1_sync_tx_nb),
+    FIELD_INIT(.sync_rx_nb, bladerf1_sync_rx_nb),
+    FIELD_INIT(.sync_get_ready_fd, bladerf1_sync_get_ready_fd),
+    FIELD_INIT(.sync_rx_acquire, bladerf1_sync_rx_acquire),
+    FIELD_INIT(.sync_rx_release, bladerf1_sync_rx_release),
+    FIELD_INIT(.sync_prearm, bladerf1_sync_prearm),
+    FIELD_INIT(.sync_tx_acquire, bladerf1_sync_tx_acquire),
+    FIELD_INIT(.sync_tx_submit, bladerf1_sync_tx_submit),
+    FIELD_INIT(.sync_tx_reserve, bladerf1_sync_tx_reserve),
+    FIELD_INIT(.sync_tx_multi, bladerf1_sync_tx_multi),
+    FIELD_INIT(.sync_rx_multi, bladerf1_sync_rx_multi),
+    FIELD_INIT(.sync_rx_packets, bladerf1_sync_rx_packets),
+    FIELD_INIT(.sync_tx_packets, bladerf1_sync_tx_packets),
+    FIELD_INIT(.sync_create_tx_template, bladerf1_sync_create_tx_template),
+    FIELD_INIT(.sync_tx_template, bladerf1_sync_tx_template),
+    FIELD_INIT(.sync_free_tx_template, bladerf1_sync_free_tx_template),
     FIELD_INIT(.get_timestamp, bladerf1_get_timestamp),
     FIELD_INIT(.load_fpga, bladerf1_load_fpga),
     FIELD_INIT(.flash_fpga, bladerf1_flash_fpga),
@@ -3596,8 +4571,19 @@ const struct board_fns bladerf1_board_fns = {
     FIELD_INIT(.get_loopback, bladerf1_get_loopback),
     FIELD_INIT(.get_rx_mux, bladerf1_get_rx_mux),
     FIELD_INIT(.set_rx_mux, bladerf1_set_rx_mux),
+    FIELD_INIT(.set_rx_decimation, bladerf1_set_rx_decimation),
+    FIELD_INIT(.get_rx_decimation, bladerf1_get_rx_decimation),
+    FIELD_INIT(.tx_load_waveform, bladerf1_tx_load_waveform),
+    FIELD_INIT(.tx_loop_start, bladerf1_tx_loop_start),
+    FIELD_INIT(.tx_loop_stop, bladerf1_tx_loop_stop),
+    FIELD_INIT(.measure_rx_power, bladerf1_measure_rx_power),
+    FIELD_INIT(.rx_snapshot, bladerf1_rx_snapshot),
+    FIELD_INIT(.schedule_rx, bladerf1_schedule_rx),
+    FIELD_INIT(.schedule_rx_bursts, bladerf1_schedule_rx_bursts),
+    FIELD_INIT(.cancel_rx_schedule, bladerf1_cancel_rx_schedule),
     FIELD_INIT(.set_vctcxo_tamer_mode, bladerf1_set_vctcxo_tamer_mode),
     FIELD_INIT(.get_vctcxo_tamer_mode, bladerf1_get_vctcxo_tamer_mode),
+    FIELD_INIT(.get_vctcxo_tamer_status, bladerf1_get_vctcxo_tamer_status),
     FIELD_INIT(.get_vctcxo_trim, bladerf1_get_vctcxo_trim),
     FIELD_INIT(.trim_dac_read, bladerf1_trim_dac_read),
     FIELD_INIT(.trim_dac_write, bladerf1_trim_dac_write),
@@ -3607,6 +4593,8 @@ const struct board_fns bladerf1_board_fns = {
     FIELD_INIT(.wishbone_master_write, bladerf1_wishbone_master_write),
     FIELD_INIT(.config_gpio_read, bladerf1_config_gpio_read),
     FIELD_INIT(.config_gpio_write, bladerf1_config_gpio_write),
+    FIELD_INIT(.batch_begin, bladerf1_batch_begin),
+    FIELD_INIT(.batch_commit, bladerf1_batch_commit),
     FIELD_INIT(.erase_flash, bladerf1_erase_flash),
     FIELD_INIT(.read_flash, bladerf1_read_flash),
     FIELD_INIT(.write_flash, bladerf1_write_flash),
@@ -3926,6 +4914,9 @@ int bladerf_set_smb_mode(struct bladerf *dev, bladerf_smb_mode mode)
 
     status = smb_clock_set_mode(dev, mode);
 
+    /* Cached quick tunes were taken with the previous reference */
+    tune_cache_invalidate_all(dev);
+
     MUTEX_UNLOCK(&dev->lock);
 
     return status;
@@ -4008,8 +4999,238 @@ int bladerf_set_rational_smb_frequency(struct bladerf *dev, struct bladerf_ratio
 /******************************************************************************/
 
 int bladerf_calibrate_dc(struct bladerf *dev, bladerf_cal_module module)
+{
+    struct bladerf1_board_data *board_data;
+    int status;
+
+    if (dev->board != &bladerf1_board_fns)
+        return BLADERF_ERR_UNSUPPORTED;
+
+    MUTEX_LOCK(&dev->lock);
+
+    CHECK_BOARD_STATE_LOCKED(STATE_INITIALIZED);
+
+    board_data = dev->board_data;
+
+    /* The calibration leaves its results in the LMS6002D's registers */
+    if (dev->backend->invalidate_reg_shadow != NULL) {
+        dev->backend->invalidate_reg_shadow(dev);
+    }
+
+    /* The NIOS II runs the same procedure without a USB round trip per
+     * register access */
+    if (have_cap(board_data->capabilities, BLADERF_CAP_NIOS_LMS_DC_CAL)) {
+        status = dev->backend->lms_dc_cal(dev, module);
+    } else {
+        status = lms_calibrate_dc(dev, module);
+    }
+
+    if (dev->backend->invalidate_reg_shadow != NULL) {
+        dev->backend->invalidate_reg_shadow(dev);
+    }
+
+    MUTEX_UNLOCK(&dev->lock);
+
+    return status;
+}
+
+/* Time to let the DC offset settle after each correction change */
+#define RX_DC_SWEEP_SETTLE_US       1000
+
+/* At most two end points and six bisection steps are measured per entry */
+#define RX_DC_SWEEP_MEASUREMENTS    9
+
+/* Slack on top of the expected sweep time before giving up */
+#define RX_DC_SWEEP_TIMEOUT_MS      1000
+
+static int rx_dc_sweep_block(struct bladerf *dev,
+                             const bladerf_frequency *frequencies,
+                             unsigned int count,
+                             unsigned int num_samples,
+                             unsigned int rate,
+                             int16_t *dc_i,
+                             int16_t *dc_q)
 {
     int status;
+    unsigned int i;
+    struct lms_freq f;
+    uint64_t deadline;
+    uint64_t per_entry_us;
+    bool busy;
+    uint8_t done;
+
+    status = dev->backend->dc_cal_clear(dev);
+    if (status != 0) {
+        return status;
+    }
+
+    for (i = 0; i < count; i++) {
+        status = lms_calculate_tuning_params((uint32_t)frequencies[i], &f);
+        if (status != 0) {
+            return status;
+        }
+
+        status = dev->backend->dc_cal_add(
+            dev, f.nint, f.nfrac, f.freqsel, f.vcocap,
+            (f.flags & LMS_FREQ_FLAGS_LOW_BAND) != 0,
+            (f.flags & LMS_FREQ_FLAGS_FORCE_VCOCAP) != 0);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    status = dev->backend->dc_cal_start(dev, num_samples,
+                                        RX_DC_SWEEP_SETTLE_US);
+    if (status != 0) {
+        return status;
+    }
+
+    per_entry_us = RX_DC_SWEEP_MEASUREMENTS *
+                   (RX_DC_SWEEP_SETTLE_US +
+                    ((uint64_t)num_samples * 1000000ULL) / rate);
+
+    deadline = wallclock_get_monotonic_nsec() +
+               count * per_entry_us * 1000ULL +
+               (uint64_t)RX_DC_SWEEP_TIMEOUT_MS * 1000000ULL;
+
+    do {
+        usleep(1000);
+
+        status = dev->backend->dc_cal_status(dev, &busy, &done);
+        if (status != 0) {
+            return status;
+        }
+
+        if (busy && wallclock_get_monotonic_nsec() > deadline) {
+            log_debug("%s: timed out after %u of %u entries. "
+                      "Is the RX module enabled?\n",
+                      __FUNCTION__, done, count);
+            dev->backend->dc_cal_clear(dev);
+            return BLADERF_ERR_TIMEOUT;
+        }
+    } while (busy);
+
+    for (i = 0; i < count; i++) {
+        status = dev->backend->dc_cal_read(dev, i, &dc_i[i], &dc_q[i]);
+        if (status != 0) {
+            log_debug("Failed to calibrate at %" PRIu64 " Hz\n",
+                      frequencies[i]);
+            return status;
+        }
+    }
+
+    return 0;
+}
+
+int bladerf_calibrate_rx_dc_sweep(struct bladerf *dev,
+                                  const bladerf_frequency *frequencies,
+                                  unsigned int count,
+                                  unsigned int num_samples,
+                                  int16_t *dc_i,
+                                  int16_t *dc_q)
+{
+    struct bladerf1_board_data *board_data;
+    const bladerf_channel ch = BLADERF_CHANNEL_RX(0);
+    bladerf_frequency orig_freq;
+    int16_t orig_i, orig_q;
+    unsigned int rate;
+    unsigned int n, i;
+    int status, restore_status;
+
+    if (dev->board != &bladerf1_board_fns)
+        return BLADERF_ERR_UNSUPPORTED;
+
+    if (frequencies == NULL || dc_i == NULL || dc_q == NULL || count == 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (num_samples < 1 || num_samples > BLADERF_RX_POWER_MAX_SAMPLES) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    CHECK_BOARD_STATE_LOCKED(STATE_INITIALIZED);
+
+    board_data = dev->board_data;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RX_DC_SWEEP)) {
+        log_debug("FPGA %s does not support RX DC calibration sweeps\n",
+                  board_data->fpga_version.describe);
+        status = BLADERF_ERR_UNSUPPORTED;
+        goto out;
+    }
+
+    /* The NIOS II does not reconfigure the XB-200 filter banks */
+    if (dev->xb == BLADERF_XB_200) {
+        log_debug("RX DC calibration sweeps are not supported with the "
+                  "XB-200 attached\n");
+        status = BLADERF_ERR_UNSUPPORTED;
+        goto out;
+    }
+
+    status = bladerf1_get_sample_rate(dev, ch, &rate);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = bladerf1_get_frequency(dev, ch, &orig_freq);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = bladerf1_get_correction(dev, ch, BLADERF_CORR_DCOFF_I, &orig_i);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = bladerf1_get_correction(dev, ch, BLADERF_CORR_DCOFF_Q, &orig_q);
+    if (status != 0) {
+        goto out;
+    }
+
+    for (i = 0; i < count && status == 0; i += n) {
+        n = count - i;
+        if (n > NIOS_PKT_DC_CAL_MAX_ENTRIES) {
+            n = NIOS_PKT_DC_CAL_MAX_ENTRIES;
+        }
+
+        status = rx_dc_sweep_block(dev, &frequencies[i], n, num_samples, rate,
+                                   &dc_i[i], &dc_q[i]);
+    }
+
+    restore_status = bladerf1_set_frequency(dev, ch, orig_freq);
+
+    if (restore_status == 0) {
+        restore_status =
+            bladerf1_set_correction(dev, ch, BLADERF_CORR_DCOFF_I, orig_i);
+    }
+
+    if (restore_status == 0) {
+        restore_status =
+            bladerf1_set_correction(dev, ch, BLADERF_CORR_DCOFF_Q, orig_q);
+    }
+
+    if (status == 0) {
+        status = restore_status;
+    }
+
+out:
+    MUTEX_UNLOCK(&dev->lock);
+
+    return status;
+}
+
+/******************************************************************************/
+/* VCOCAP characterization */
+/******************************************************************************/
+
+int bladerf_characterize_vcocap(struct bladerf *dev, bool store)
+{
+    struct bladerf1_board_data *board_data;
+    struct vco_table *tbl;
+    bladerf_frequency rx_freq, tx_freq;
+    int status, restore_status;
 
     if (dev->board != &bladerf1_board_fns)
         return BLADERF_ERR_UNSUPPORTED;
@@ -4018,7 +5239,74 @@ int bladerf_calibrate_dc(struct bladerf *dev, bladerf_cal_module module)
 
     CHECK_BOARD_STATE_LOCKED(STATE_INITIALIZED);
 
-    status = lms_calibrate_dc(dev, module);
+    board_data = dev->board_data;
+
+    tbl = malloc(sizeof(*tbl));
+    if (tbl == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto out;
+    }
+
+    status = bladerf1_get_frequency(dev, BLADERF_CHANNEL_RX(0), &rx_freq);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = bladerf1_get_frequency(dev, BLADERF_CHANNEL_TX(0), &tx_freq);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = vco_table_characterize(dev, tbl);
+
+    if (status == 0 && store) {
+        status = vco_table_store(dev, tbl);
+    }
+
+    if (status == 0) {
+        free(board_data->cal.vco);
+        board_data->cal.vco = tbl;
+        tbl                 = NULL;
+    }
+
+    restore_status = bladerf1_set_frequency(dev, BLADERF_CHANNEL_RX(0), rx_freq);
+
+    if (restore_status == 0) {
+        restore_status =
+            bladerf1_set_frequency(dev, BLADERF_CHANNEL_TX(0), tx_freq);
+    }
+
+    if (status == 0) {
+        status = restore_status;
+    }
+
+out:
+    free(tbl);
+    MUTEX_UNLOCK(&dev->lock);
+
+    return status;
+}
+
+int bladerf_clear_vcocap_table(struct bladerf *dev, bool erase)
+{
+    struct bladerf1_board_data *board_data;
+    int status = 0;
+
+    if (dev->board != &bladerf1_board_fns)
+        return BLADERF_ERR_UNSUPPORTED;
+
+    MUTEX_LOCK(&dev->lock);
+
+    CHECK_BOARD_STATE_LOCKED(STATE_FIRMWARE_LOADED);
+
+    board_data = dev->board_data;
+
+    free(board_data->cal.vco);
+    board_data->cal.vco = NULL;
+
+    if (erase) {
+        status = vco_table_store(dev, NULL);
+    }
 
     MUTEX_UNLOCK(&dev->lock);
 
@@ -4058,6 +5346,8 @@ int bladerf_si5338_write(struct bladerf *dev, uint8_t address, uint8_t val)
 
     CHECK_BOARD_STATE_LOCKED(STATE_FPGA_LOADED);
 
+    invalidate_samplerate(dev);
+
     status = dev->backend->si5338_write(dev,address,val);
 
     MUTEX_UNLOCK(&dev->lock);
@@ -4098,6 +5388,11 @@ int bladerf_lms_write(struct bladerf *dev, uint8_t address, uint8_t val)
 
     CHECK_BOARD_STATE_LOCKED(STATE_FPGA_LOADED);
 
+    invalidate_band(dev);
+    if (dev->xb == BLADERF_XB_200) {
+        xb200_invalidate(dev);
+    }
+
     status = dev->backend->lms_write(dev,address,val);
 
     MUTEX_UNLOCK(&dev->lock);
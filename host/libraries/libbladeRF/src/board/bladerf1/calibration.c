@@ -47,7 +47,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
-#include <float.h>
+#include <math.h>
 
 #include "host_config.h"
 #include "minmax.h"
@@ -70,6 +70,15 @@
 #define DC_CAL_TBL_ENTRY_SIZE   (sizeof(uint32_t) + 2 * sizeof(int16_t))
 #define DC_CAL_TBL_MIN_SIZE     (DC_CAL_TBL_META_SIZE + DC_CAL_TBL_ENTRY_SIZE)
 
+/* Grid arrays start on cache line boundaries */
+#define DC_CAL_GRID_ALIGN       64
+
+/* Upper bound on grid size, should a very small step be requested. At 1 MHz,
+ * the bladeRF x40/x115 tuning range needs fewer than 4000 points. */
+#define DC_CAL_GRID_MAX_POINTS  (1 << 20)
+
+static void dc_cal_grid_build(struct dc_cal_tbl *tbl);
+
 static inline bool entry_matches(const struct dc_cal_tbl *tbl,
                                  unsigned int entry_idx, unsigned int freq)
 {
@@ -174,14 +183,15 @@ struct dc_cal_tbl * dc_cal_tbl_load(const uint8_t *buf, size_t buf_len)
     ret->n_entries = LE32_TO_HOST(ret->n_entries);
     buf += sizeof(ret->n_entries);
 
-    if (buf_len <
+    if (ret->n_entries == 0 || buf_len <
          (DC_CAL_TBL_META_SIZE + DC_CAL_TBL_ENTRY_SIZE * ret->n_entries) ) {
 
         free(ret);
         return NULL;
     }
 
-    ret->entries = malloc(sizeof(ret->entries[0]) * ret->n_entries);
+    /* Zeroed, so that fields absent in older versions are defined */
+    ret->entries = calloc(ret->n_entries, sizeof(ret->entries[0]));
     if (ret->entries == NULL) {
         free(ret);
         return NULL;
@@ -241,6 +251,9 @@ struct dc_cal_tbl * dc_cal_tbl_load(const uint8_t *buf, size_t buf_len)
         }
     }
 
+    ret->grid = NULL;
+    dc_cal_grid_build(ret);
+
     return ret;
 }
 
@@ -277,18 +290,20 @@ int dc_cal_tbl_image_load(struct bladerf *dev,
  *
  * y = interp( (x0, y0), (x1, y1), x )
  *
- * Returns
+ * Returns the interpolated value, rounded to the nearest integer
  */
-static inline unsigned int interp(unsigned int x0, unsigned int y0,
-                           unsigned int x1, unsigned int y1,
-                           unsigned int x)
+static inline int16_t interp(unsigned int x0, int16_t y0,
+                             unsigned int x1, int16_t y1,
+                             unsigned int x)
 {
     const float num = (float) y1 - y0;
     const float den = (float) x1 - x0;
-    const float m = den == 0 ? FLT_MAX : num / den;
-    const float y = (x - x0) * m + y0;
 
-    return (unsigned int) y;
+    if (den == 0) {
+        return y0;
+    }
+
+    return (int16_t) roundf(((float) x - x0) * num / den + y0);
 }
 
 static inline void dc_cal_interp_entry(const struct dc_cal_tbl *tbl,
@@ -301,9 +316,11 @@ static inline void dc_cal_interp_entry(const struct dc_cal_tbl *tbl,
     const unsigned int f_high = tbl->entries[idx_high].freq;
 
 #define ENTRY_VAR(x)                                                        \
-    entry->x    = (int16_t) interp(f_low, tbl->entries[idx_low].x,          \
-                             f_high, tbl->entries[idx_low].x,               \
-                             freq)
+    entry->x    = interp(f_low, tbl->entries[idx_low].x,                    \
+                         f_high, tbl->entries[idx_high].x,                  \
+                         freq)
+
+    entry->freq = freq;
 
     ENTRY_VAR(dc_i);
     ENTRY_VAR(dc_q);
@@ -314,25 +331,165 @@ static inline void dc_cal_interp_entry(const struct dc_cal_tbl *tbl,
     ENTRY_VAR(mid_dc_q);
     ENTRY_VAR(min_dc_i);
     ENTRY_VAR(min_dc_q);
+
+#undef ENTRY_VAR
 }
 
-void dc_cal_tbl_entry(const struct dc_cal_tbl *tbl, unsigned int freq,
-                      struct dc_cal_entry *entry)
+/* Look up and interpolate values from the table entries themselves */
+static void dc_cal_tbl_interp(const struct dc_cal_tbl *tbl, unsigned int freq,
+                              struct dc_cal_entry *entry)
 {
-    const unsigned int idx = dc_cal_tbl_lookup(tbl, freq);
+    const unsigned int last = tbl->n_entries - 1;
+    unsigned int idx;
+
+    if (freq <= tbl->entries[0].freq) {
+        memcpy(entry, &tbl->entries[0], sizeof(struct dc_cal_entry));
+        return;
+    } else if (freq >= tbl->entries[last].freq) {
+        memcpy(entry, &tbl->entries[last], sizeof(struct dc_cal_entry));
+        return;
+    }
+
+    idx = dc_cal_tbl_lookup(tbl, freq);
 
     if (tbl->entries[idx].freq == freq) {
         memcpy(entry, &tbl->entries[idx], sizeof(struct dc_cal_entry));
-    } else if (idx == (tbl->n_entries - 1)) {
-        dc_cal_interp_entry(tbl, idx - 1, idx, freq, entry);
     } else {
         dc_cal_interp_entry(tbl, idx, idx + 1, freq, entry);
     }
 }
 
+static unsigned int dc_cal_grid_step(void)
+{
+    const char *env = getenv("BLADERF_DC_CAL_GRID_STEP");
+    unsigned long step;
+    char *end;
+
+    if (env == NULL) {
+        return DC_CAL_GRID_STEP;
+    }
+
+    step = strtoul(env, &end, 0);
+    if (end == env || *end != '\0' || step > UINT32_MAX) {
+        WARN("Ignoring invalid BLADERF_DC_CAL_GRID_STEP value.\n");
+        return DC_CAL_GRID_STEP;
+    }
+
+    return (unsigned int) step;
+}
+
+static void dc_cal_grid_build(struct dc_cal_tbl *tbl)
+{
+    const unsigned int step = dc_cal_grid_step();
+    const unsigned int f_min = tbl->entries[0].freq;
+    const unsigned int f_max = tbl->entries[tbl->n_entries - 1].freq;
+    struct dc_cal_grid *grid;
+    struct dc_cal_entry entry;
+    uint64_t n_points;
+    size_t stride;
+    uintptr_t base;
+    unsigned int i;
+
+    if (step == 0 || f_max < f_min) {
+        return;
+    }
+
+    /* Points at f_min, f_min + step, ..., with the last at or beyond f_max */
+    n_points = (f_max - f_min + (uint64_t) step - 1) / step + 1;
+    if (n_points > DC_CAL_GRID_MAX_POINTS) {
+        log_debug("DC cal grid step of %u Hz is too small; not using a "
+                  "grid.\n", step);
+        return;
+    }
+
+    grid = calloc(1, sizeof(*grid));
+    if (grid == NULL) {
+        return;
+    }
+
+    /* Round each array up to whole cache lines */
+    stride = ((size_t) n_points * sizeof(int16_t) + DC_CAL_GRID_ALIGN - 1) &
+             ~((size_t) DC_CAL_GRID_ALIGN - 1);
+
+    grid->mem = malloc(8 * stride + DC_CAL_GRID_ALIGN - 1);
+    if (grid->mem == NULL) {
+        free(grid);
+        return;
+    }
+
+    base = ((uintptr_t) grid->mem + DC_CAL_GRID_ALIGN - 1) &
+           ~((uintptr_t) DC_CAL_GRID_ALIGN - 1);
+
+    grid->f_min    = f_min;
+    grid->step     = step;
+    grid->n_points = (unsigned int) n_points;
+
+    grid->dc_i     = (int16_t *) (base + 0 * stride);
+    grid->dc_q     = (int16_t *) (base + 1 * stride);
+    grid->max_dc_i = (int16_t *) (base + 2 * stride);
+    grid->max_dc_q = (int16_t *) (base + 3 * stride);
+    grid->mid_dc_i = (int16_t *) (base + 4 * stride);
+    grid->mid_dc_q = (int16_t *) (base + 5 * stride);
+    grid->min_dc_i = (int16_t *) (base + 6 * stride);
+    grid->min_dc_q = (int16_t *) (base + 7 * stride);
+
+    for (i = 0; i < grid->n_points; i++) {
+        const uint64_t freq = f_min + (uint64_t) i * step;
+
+        dc_cal_tbl_interp(tbl, (unsigned int) u64_min(freq, f_max), &entry);
+
+        grid->dc_i[i]     = entry.dc_i;
+        grid->dc_q[i]     = entry.dc_q;
+        grid->max_dc_i[i] = entry.max_dc_i;
+        grid->max_dc_q[i] = entry.max_dc_q;
+        grid->mid_dc_i[i] = entry.mid_dc_i;
+        grid->mid_dc_q[i] = entry.mid_dc_q;
+        grid->min_dc_i[i] = entry.min_dc_i;
+        grid->min_dc_q[i] = entry.min_dc_q;
+    }
+
+    tbl->grid = grid;
+}
+
+void dc_cal_tbl_entry(const struct dc_cal_tbl *tbl, unsigned int freq,
+                      struct dc_cal_entry *entry)
+{
+    const struct dc_cal_grid *grid = tbl->grid;
+    unsigned int i;
+
+    if (grid == NULL) {
+        dc_cal_tbl_interp(tbl, freq, entry);
+        return;
+    }
+
+    /* Nearest grid point */
+    if (freq <= grid->f_min) {
+        i = 0;
+    } else {
+        i = (unsigned int) u64_min(
+            ((uint64_t) freq - grid->f_min + grid->step / 2) / grid->step,
+            grid->n_points - 1);
+    }
+
+    entry->freq     = freq;
+    entry->dc_i     = grid->dc_i[i];
+    entry->dc_q     = grid->dc_q[i];
+    entry->max_dc_i = grid->max_dc_i[i];
+    entry->max_dc_q = grid->max_dc_q[i];
+    entry->mid_dc_i = grid->mid_dc_i[i];
+    entry->mid_dc_q = grid->mid_dc_q[i];
+    entry->min_dc_i = grid->min_dc_i[i];
+    entry->min_dc_q = grid->min_dc_q[i];
+}
+
 void dc_cal_tbl_free(struct dc_cal_tbl **tbl)
 {
     if (*tbl != NULL) {
+        if ((*tbl)->grid != NULL) {
+            free((*tbl)->grid->mem);
+            free((*tbl)->grid);
+        }
+
         free((*tbl)->entries);
         free(*tbl);
         *tbl = NULL;
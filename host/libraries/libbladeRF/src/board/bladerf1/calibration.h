@@ -39,6 +39,31 @@ struct dc_cal_entry {
     int16_t min_dc_q;
 };
 
+/* Default spacing of the correction grid, in Hz. This may be overridden via
+ * the BLADERF_DC_CAL_GRID_STEP environment variable, where 0 disables the
+ * grid. */
+#define DC_CAL_GRID_STEP 1000000
+
+/* Corrections interpolated from a table at every `step` Hz from `f_min`,
+ * stored as one array per field so that each lookup touches only the
+ * fields it uses */
+struct dc_cal_grid {
+    unsigned int f_min;
+    unsigned int step;
+    unsigned int n_points;
+
+    int16_t *dc_i;
+    int16_t *dc_q;
+    int16_t *max_dc_i;
+    int16_t *max_dc_q;
+    int16_t *mid_dc_i;
+    int16_t *mid_dc_q;
+    int16_t *min_dc_i;
+    int16_t *min_dc_q;
+
+    void *mem; /* Allocation backing the arrays above */
+};
+
 struct dc_cal_tbl {
     uint32_t version;
     uint32_t n_entries;
@@ -46,6 +71,8 @@ struct dc_cal_tbl {
 
     unsigned int curr_idx;
     struct dc_cal_entry *entries; /* Sorted (increasing) by freq */
+
+    struct dc_cal_grid *grid; /* NULL if disabled or unavailable */
 };
 
 extern struct dc_cal_tbl rx_cal_test;
@@ -63,7 +90,11 @@ unsigned int dc_cal_tbl_lookup(const struct dc_cal_tbl *tbl, unsigned int freq);
 /**
  * Get the DC cal values associated with the specified frequencies. If the
  * specified frequency is not in the table, the DC calibration values will
- * be interpolated from surrounding entries.
+ * be interpolated from surrounding entries. Frequencies outside of the table
+ * use the nearest entry.
+ *
+ * When the table has a correction grid, the values at the nearest grid point
+ * are returned.
  *
  * @param[in]   tbl      Table to search
  * @param[in]   freq     Desired frequency
@@ -74,7 +105,8 @@ void dc_cal_tbl_entry(const struct dc_cal_tbl *tbl,
                       struct dc_cal_entry *entry);
 
 /**
- * Load a DC calibration table from the provided data
+ * Load a DC calibration table from the provided data, and build its
+ * correction grid
  *
  * @param[in]   buf   Packed table data
  * @param[in]   len   Length of packed data, in bytes
@@ -54,6 +54,19 @@ uint64_t bladerf1_get_fw_capabilities(const struct bladerf_version *fw_version)
         capabilities |= BLADERF_CAP_FW_SHORT_PACKET;
     }
 
+    if (version_fields_greater_or_equal(fw_version, 2, 5, 0)) {
+        capabilities |= BLADERF_CAP_FW_FLASH_PAGES;
+        capabilities |= BLADERF_CAP_FW_DMA_BUFFERS;
+    }
+
+    if (version_fields_greater_or_equal(fw_version, 2, 6, 0)) {
+        capabilities |= BLADERF_CAP_FW_LOG_ENTRIES;
+    }
+
+    if (version_fields_greater_or_equal(fw_version, 2, 7, 0)) {
+        capabilities |= BLADERF_CAP_FW_DMA_CHANNELS;
+    }
+
     return capabilities;
 }
 
@@ -114,5 +127,46 @@ uint64_t bladerf1_get_fpga_capabilities(const struct bladerf_version *fpga_versi
         capabilities |= BLADERF_CAP_FPGA_8BIT_SAMPLES;
     }
 
+    if (version_fields_greater_or_equal(fpga_version, 0, 16, 0)) {
+        capabilities |= BLADERF_CAP_FPGA_RX_POWER_METER;
+        capabilities |= BLADERF_CAP_FPGA_RX_DC_SWEEP;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 16, 1)) {
+        capabilities |= BLADERF_CAP_RETUNE_QUEUE_CONTROL;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 16, 2)) {
+        capabilities |= BLADERF_CAP_TIMED_WRITE;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 16, 3)) {
+        capabilities |= BLADERF_CAP_VCTCXO_TAMER_STATUS;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 16, 4)) {
+        capabilities |= BLADERF_CAP_TRIGGER_TIME;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 16, 5)) {
+        capabilities |= BLADERF_CAP_NIOS_LMS_DC_CAL;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 16, 6)) {
+        capabilities |= BLADERF_CAP_FPGA_RX_GATE;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 16, 7)) {
+        capabilities |= BLADERF_CAP_FPGA_RX_BURSTS;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 16, 8)) {
+        capabilities |= BLADERF_CAP_FPGA_TX_IDLE_ZERO;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 16, 9)) {
+        capabilities |= BLADERF_CAP_FPGA_STREAM_STATS;
+    }
+
     return capabilities;
 }
@@ -35,6 +35,16 @@ const struct version_compat_table bladerf1_fw_compat_table = {fw_compat, ARRAY_S
 
 static const struct compat fpga_compat[] = {
     /*    FPGA          requires >=        Firmware */
+    { VERSION(0, 16, 9),                VERSION(2, 4, 0) },
+    { VERSION(0, 16, 8),                VERSION(2, 4, 0) },
+    { VERSION(0, 16, 7),                VERSION(2, 4, 0) },
+    { VERSION(0, 16, 6),                VERSION(2, 4, 0) },
+    { VERSION(0, 16, 5),                VERSION(2, 4, 0) },
+    { VERSION(0, 16, 4),                VERSION(2, 4, 0) },
+    { VERSION(0, 16, 3),                VERSION(2, 4, 0) },
+    { VERSION(0, 16, 2),                VERSION(2, 4, 0) },
+    { VERSION(0, 16, 1),                VERSION(2, 4, 0) },
+    { VERSION(0, 16, 0),                VERSION(2, 4, 0) },
     { VERSION(0, 15, 1),                VERSION(2, 4, 0) },
     { VERSION(0, 15, 0),                VERSION(2, 4, 0) },
     { VERSION(0, 14, 0),                VERSION(2, 4, 0) },
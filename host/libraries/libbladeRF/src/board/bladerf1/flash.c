@@ -19,8 +19,7 @@ int spi_flash_write_fx3_fw(struct bladerf *dev, const uint8_t *image, size_t len
 {
     int status;
     uint8_t *readback_buf;
-    uint8_t *padded_image;
-    uint32_t padded_image_len;
+    uint8_t *region;
 
     /* Pad firwmare data out to a page size */
     const uint32_t page_size = dev->flash_arch->psize_bytes;
@@ -39,59 +38,47 @@ int spi_flash_write_fx3_fw(struct bladerf *dev, const uint8_t *image, size_t len
     const uint32_t flash_eb_len_fw = BLADERF_FLASH_BYTE_LEN_FIRMWARE /
         dev->flash_arch->ebsize_bytes;
 
-    if (len >= (UINT32_MAX - padding_len)) {
+    const size_t region_len =
+        (size_t)flash_eb_len_fw * dev->flash_arch->ebsize_bytes;
+
+    if (len + padding_len > region_len) {
+        log_debug("Firmware image is larger than its region of flash\n");
         return BLADERF_ERR_INVAL;
     }
 
-    padded_image_len = (uint32_t) len + padding_len;
-
-    readback_buf = malloc(padded_image_len);
+    readback_buf = malloc(region_len);
     if (readback_buf == NULL) {
         return BLADERF_ERR_MEM;
     }
 
-    padded_image = malloc(padded_image_len);
-    if (padded_image == NULL) {
+    region = malloc(region_len);
+    if (region == NULL) {
         free(readback_buf);
         return BLADERF_ERR_MEM;
     }
 
-    /* Copy image */
-    memcpy(padded_image, image, len);
-
-    /* Clear the padded region */
-    memset(padded_image + len, 0xFF, padded_image_len - len);
+    /* Lay out the whole region as it would be after erasing it and writing
+     * the image, so that only blocks that differ need be rewritten */
+    memcpy(region, image, len);
+    memset(region + len, 0xFF, region_len - len);
 
-    /* Erase the entire firmware region */
-    status = spi_flash_erase(dev, flash_eb_fw, flash_eb_len_fw);
+    status = spi_flash_update(dev, readback_buf, region, flash_eb_fw,
+                              flash_eb_len_fw);
     if (status != 0) {
-        log_debug("Failed to erase firmware region: %s\n",
-                  bladerf_strerror(status));
-        goto error;
-    }
-
-    /* Convert the image length to pages */
-    padded_image_len /= page_size;
-
-    /* Write the firmware image to flash */
-    status = spi_flash_write(dev, padded_image,
-                             flash_page_fw, padded_image_len);
-
-    if (status < 0) {
         log_debug("Failed to write firmware: %s\n", bladerf_strerror(status));
         goto error;
     }
 
     /* Read back and double-check what we just wrote */
-    status = spi_flash_verify(dev, readback_buf, padded_image,
-                              flash_page_fw, padded_image_len);
+    status = spi_flash_verify(dev, readback_buf, region, flash_page_fw,
+                              (uint32_t)((len + padding_len) / page_size));
     if (status != 0) {
         log_debug("Flash verification failed: %s\n", bladerf_strerror(status));
         goto error;
     }
 
 error:
-    free(padded_image);
+    free(region);
     free(readback_buf);
     return status;
 }
@@ -134,8 +121,6 @@ static inline size_t get_flash_eb_len_fpga(struct bladerf *dev)
     return eb_count;
 }
 
-#define METADATA_LEN 256
-
 int spi_flash_write_fpga_bitstream(struct bladerf *dev,
                                    const uint8_t *bitstream,
                                    size_t len)
@@ -156,77 +141,52 @@ int spi_flash_write_fpga_bitstream(struct bladerf *dev,
     /** Length of entire FPGA region, in units of erase blocks */
     const uint32_t flash_eb_len_fpga = (uint32_t)get_flash_eb_len_fpga(dev);
 
-    assert(METADATA_LEN <= page_size);
+    const size_t region_len =
+        (size_t)flash_eb_len_fpga * dev->flash_arch->ebsize_bytes;
 
     int status;
     uint8_t *readback_buf;
-    uint8_t *padded_bitstream;
-    uint8_t metadata[METADATA_LEN];
-    uint32_t padded_bitstream_len;
+    uint8_t *region;
 
     if (len >= (UINT32_MAX - padding_len)) {
         return BLADERF_ERR_INVAL;
     }
 
-    padded_bitstream_len = (uint32_t)len + padding_len;
-
-    /* Fill in metadata with the *actual* FPGA bitstream length */
-    fill_fpga_metadata_page(dev, metadata, len);
+    /* The metadata page precedes the bitstream */
+    if (page_size + len + padding_len > region_len) {
+        log_debug("FPGA bitstream is larger than its region of flash\n");
+        return BLADERF_ERR_INVAL;
+    }
 
-    readback_buf = malloc(padded_bitstream_len);
+    readback_buf = malloc(region_len);
     if (readback_buf == NULL) {
         return BLADERF_ERR_MEM;
     }
 
-    padded_bitstream = malloc(padded_bitstream_len);
-    if (padded_bitstream == NULL) {
+    region = malloc(region_len);
+    if (region == NULL) {
         free(readback_buf);
         return BLADERF_ERR_MEM;
     }
 
-    /* Copy bitstream */
-    memcpy(padded_bitstream, bitstream, len);
+    /* Lay out the whole region as it would be after erasing it and writing
+     * the metadata and bitstream, so that only blocks that differ need be
+     * rewritten. The metadata holds the *actual* FPGA bitstream length. */
+    fill_fpga_metadata_page(dev, region, len);
+    memcpy(region + page_size, bitstream, len);
+    memset(region + page_size + len, 0xFF, region_len - page_size - len);
 
-    /* Clear the padded region */
-    memset(padded_bitstream + len, 0xFF, padded_bitstream_len - len);
-
-    /* Erase FPGA metadata and bitstream region */
-    status = spi_flash_erase(dev, flash_eb_fpga, flash_eb_len_fpga);
-    if (status != 0) {
-        log_debug("Failed to erase FPGA meta & bitstream regions: %s\n",
-                  bladerf_strerror(status));
-        goto error;
-    }
-
-    /* Write the metadata page */
-    status = spi_flash_write(dev, metadata, flash_page_fpga, 1);
+    status = spi_flash_update(dev, readback_buf, region, flash_eb_fpga,
+                              flash_eb_len_fpga);
     if (status != 0) {
-        log_debug("Failed to write FPGA metadata page: %s\n",
+        log_debug("Failed to write FPGA meta & bitstream regions: %s\n",
                   bladerf_strerror(status));
         goto error;
     }
 
-    /* Convert the padded bitstream length to pages */
-    padded_bitstream_len /= page_size;
-
-    /* Write the padded bitstream */
-    status = spi_flash_write(dev, padded_bitstream, flash_page_fpga + 1,
-                             padded_bitstream_len);
-    if (status != 0) {
-        log_debug("Failed to write bitstream: %s\n", bladerf_strerror(status));
-        goto error;
-    }
-
-    /* Read back and verify metadata */
-    status = spi_flash_verify(dev, readback_buf, metadata, flash_page_fpga, 1);
-    if (status != 0) {
-        log_debug("Failed to verify metadata: %s\n", bladerf_strerror(status));
-        goto error;
-    }
-
-    /* Read back and verify the bitstream data */
-    status = spi_flash_verify(dev, readback_buf, padded_bitstream,
-                              flash_page_fpga + 1, padded_bitstream_len);
+    /* Read back and verify the metadata and bitstream data */
+    status = spi_flash_verify(dev, readback_buf, region, flash_page_fpga,
+                              (uint32_t)(1 + (len + padding_len) / page_size));
     if (status != 0) {
         log_debug("Failed to verify bitstream data: %s\n",
                   bladerf_strerror(status));
@@ -234,7 +194,7 @@ int spi_flash_write_fpga_bitstream(struct bladerf *dev,
     }
 
 error:
-    free(padded_bitstream);
+    free(region);
     free(readback_buf);
     return status;
 }
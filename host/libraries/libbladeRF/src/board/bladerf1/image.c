@@ -96,34 +96,89 @@ static void sha256_buffer(const char *buf, size_t len,
     SHA256_Final((uint8_t*)digest, &ctx);
 }
 
-static int verify_checksum(uint8_t *buf, size_t buf_len)
+/* Images are hashed a chunk at a time as they are read, rather than in a
+ * second pass over the whole buffer */
+#define IMAGE_READ_CHUNK (64 * 1024)
+
+/* Read an image file, and compute the checksum it should contain: that of
+ * its contents with the checksum field cleared */
+static int read_image_file(const char *file, uint8_t **buf_ret,
+                           size_t *len_ret,
+                           char checksum[SHA256_DIGEST_SIZE])
 {
-    char checksum_expected[SHA256_DIGEST_SIZE];
-    char checksum_calc[SHA256_DIGEST_SIZE];
+    static const uint8_t zeros[BLADERF_IMAGE_CHECKSUM_LEN] = { 0 };
+    const size_t checksum_end = BLADERF_IMAGE_MAGIC_LEN +
+                                BLADERF_IMAGE_CHECKSUM_LEN;
+    int rv;
+    FILE *f;
+    uint8_t *buf = NULL;
+    ssize_t len;
+    size_t i, n;
+    SHA256_CTX ctx;
 
-    if (buf_len <= CALC_IMAGE_SIZE(0)) {
-        log_debug("Provided buffer isn't a full image\n");
-        return BLADERF_ERR_INVAL;
+    f = fopen(file, "rb");
+    if (!f) {
+        log_debug("Failed to open \"%s\": %s\n", file, strerror(errno));
+
+        switch (errno) {
+            case ENOENT:
+                return BLADERF_ERR_NO_FILE;
+            case EACCES:
+                return BLADERF_ERR_PERMISSION;
+            default:
+                return BLADERF_ERR_IO;
+        }
     }
 
-    /* Backup and clear the expected checksum before we calculate the
-     * expected checksum */
-    memcpy(checksum_expected, &buf[BLADERF_IMAGE_MAGIC_LEN],
-           sizeof(checksum_expected));
+    len = file_size(f);
+    if (len < 0) {
+        rv = BLADERF_ERR_IO;
+        goto error;
+    }
 
-    memset(&buf[BLADERF_IMAGE_MAGIC_LEN], 0, SHA256_DIGEST_SIZE);
+    if ((size_t)len <= CALC_IMAGE_SIZE(0)) {
+        log_debug("Provided file isn't a full image\n");
+        rv = BLADERF_ERR_INVAL;
+        goto error;
+    }
 
-    sha256_buffer((const char *)buf, buf_len, checksum_calc);
+    buf = (uint8_t *)malloc(len);
+    if (!buf) {
+        rv = BLADERF_ERR_MEM;
+        goto error;
+    }
 
-    if (memcmp(checksum_expected, checksum_calc, SHA256_DIGEST_SIZE) != 0) {
-        return BLADERF_ERR_CHECKSUM;
-    } else {
-        /* Restore the buffer's checksum so the caller can still use it */
-        memcpy(&buf[BLADERF_IMAGE_MAGIC_LEN], checksum_expected,
-               sizeof(checksum_expected));
+    SHA256_Init(&ctx);
+
+    for (i = 0; i < (size_t)len; i += n) {
+        n = min_sz(IMAGE_READ_CHUNK, (size_t)len - i);
+
+        rv = file_read(f, (char *)&buf[i], n);
+        if (rv < 0) {
+            goto error;
+        }
 
-        return 0;
+        if (i == 0) {
+            /* The first chunk always extends past the checksum field */
+            SHA256_Update(&ctx, buf, BLADERF_IMAGE_MAGIC_LEN);
+            SHA256_Update(&ctx, zeros, sizeof(zeros));
+            SHA256_Update(&ctx, &buf[checksum_end], n - checksum_end);
+        } else {
+            SHA256_Update(&ctx, &buf[i], n);
+        }
     }
+
+    SHA256_Final((uint8_t *)checksum, &ctx);
+
+    fclose(f);
+    *buf_ret = buf;
+    *len_ret = len;
+    return 0;
+
+error:
+    fclose(f);
+    free(buf);
+    return rv;
 }
 
 static bool image_type_is_valid(bladerf_image_type type) {
@@ -416,14 +471,16 @@ int bladerf_image_read(struct bladerf_image *img, const char *file)
     int rv = -1;
     uint8_t *buf = NULL;
     size_t buf_len;
+    char checksum_calc[SHA256_DIGEST_SIZE];
 
-    rv = file_read_buffer(file, &buf, &buf_len);
+    rv = read_image_file(file, &buf, &buf_len, checksum_calc);
     if (rv < 0) {
         goto bladerf_image_read_out;
     }
 
-    rv = verify_checksum(buf, buf_len);
-    if (rv < 0) {
+    if (memcmp(&buf[BLADERF_IMAGE_MAGIC_LEN], checksum_calc,
+               SHA256_DIGEST_SIZE) != 0) {
+        rv = BLADERF_ERR_CHECKSUM;
         goto bladerf_image_read_out;
     }
 
@@ -0,0 +1,320 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* The VCOCAP table is stored in flash immediately after the calibration data,
+ * within the same erase block. All values are little-endian byte order.
+ *
+ * 0x0000 [uint32_t: Fixed value of 0x54434f56 ("VCOT")]
+ * 0x0004 [uint8_t:  Table format version]
+ * 0x0005 [uint8_t:  Number of bands]
+ * 0x0006 [uint8_t:  Number of points per band]
+ * 0x0007 [uint8_t:  Reserved. Set to 0x00]
+ * 0x0008 [uint32_t: CRC-32 of the table entries]
+ * 0x000c [Start of table entries]
+ *
+ * Where a table entry is:
+ *        [uint32_t: Frequency]
+ *        [uint8_t:  TX VCOCAP]
+ *        [uint8_t:  RX VCOCAP]
+ *        [uint16_t: Reserved. Set to 0x0000]
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "host_config.h"
+#include "flash_crc32.h"
+
+#include "board/board.h"
+#include "driver/spi_flash.h"
+
+#include "vco_table.h"
+
+#define VCO_TABLE_MAGIC     0x54434f56
+#define VCO_TABLE_VERSION   1
+
+#define VCO_TABLE_HDR_LEN   12
+#define VCO_TABLE_ENTRY_LEN 8
+#define VCO_TABLE_DATA_LEN  (VCO_TABLE_NUM_POINTS * VCO_TABLE_ENTRY_LEN)
+#define VCO_TABLE_LEN       (VCO_TABLE_HDR_LEN + VCO_TABLE_DATA_LEN)
+
+#define VCO_TABLE_ADDR (BLADERF_FLASH_ADDR_CAL + BLADERF_FLASH_BYTE_LEN_CAL)
+
+static inline void put_le32(uint8_t *buf, uint32_t val)
+{
+    val = HOST_TO_LE32(val);
+    memcpy(buf, &val, sizeof(val));
+}
+
+static inline uint32_t get_le32(const uint8_t *buf)
+{
+    uint32_t val;
+    memcpy(&val, buf, sizeof(val));
+    return LE32_TO_HOST(val);
+}
+
+int vco_table_characterize(struct bladerf *dev, struct vco_table *tbl)
+{
+    unsigned int band, i;
+    int status;
+
+    for (band = 0; band < VCO_TABLE_NUM_BANDS; band++) {
+        uint32_t low, high;
+
+        status = lms_get_band(band, &low, &high);
+        if (status != 0) {
+            return status;
+        }
+
+        for (i = 0; i < VCO_TABLE_POINTS_PER_BAND; i++) {
+            struct vco_table_point *p =
+                &tbl->points[band * VCO_TABLE_POINTS_PER_BAND + i];
+            uint64_t span = (uint64_t)(high - low) * i;
+            struct lms_freq f;
+
+            p->freq = low + (uint32_t)(span / (VCO_TABLE_POINTS_PER_BAND - 1));
+
+            status = lms_calculate_tuning_params(p->freq, &f);
+            if (status != 0) {
+                return status;
+            }
+
+            status = lms_set_precalculated_frequency(dev, BLADERF_MODULE_RX, &f);
+            if (status != 0) {
+                return status;
+            }
+
+            p->vcocap[BLADERF_MODULE_RX] = f.vcocap_result;
+
+            status = lms_calculate_tuning_params(p->freq, &f);
+            if (status != 0) {
+                return status;
+            }
+
+            status = lms_set_precalculated_frequency(dev, BLADERF_MODULE_TX, &f);
+            if (status != 0) {
+                return status;
+            }
+
+            p->vcocap[BLADERF_MODULE_TX] = f.vcocap_result;
+
+            log_verbose("%s: %u Hz: RX VCOCAP=%u, TX VCOCAP=%u\n", __FUNCTION__,
+                        p->freq, p->vcocap[BLADERF_MODULE_RX],
+                        p->vcocap[BLADERF_MODULE_TX]);
+        }
+    }
+
+    return 0;
+}
+
+/* Read the pages spanning the calibration data and the table */
+static int read_region(struct bladerf *dev, uint8_t **buf, uint32_t *page,
+                       uint32_t *count)
+{
+    const uint32_t psize = dev->flash_arch->psize_bytes;
+    const uint32_t end   = VCO_TABLE_ADDR + VCO_TABLE_LEN;
+    int status;
+
+    *page  = BLADERF_FLASH_ADDR_CAL / psize;
+    *count = (end - BLADERF_FLASH_ADDR_CAL + psize - 1) / psize;
+
+    *buf = malloc(*count * psize);
+    if (*buf == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    /* Erased flash reads back as 0xff; start from that should the read
+     * leave the buffer untouched */
+    memset(*buf, 0xff, *count * psize);
+
+    status = spi_flash_read(dev, *buf, *page, *count);
+    if (status != 0) {
+        free(*buf);
+        *buf = NULL;
+    }
+
+    return status;
+}
+
+int vco_table_load(struct bladerf *dev, struct vco_table *tbl)
+{
+    const uint8_t *hdr, *entry;
+    uint8_t *buf;
+    uint32_t page, count;
+    unsigned int i;
+    int status;
+
+    status = read_region(dev, &buf, &page, &count);
+    if (status != 0) {
+        return status;
+    }
+
+    hdr   = buf + (VCO_TABLE_ADDR - BLADERF_FLASH_ADDR_CAL);
+    entry = hdr + VCO_TABLE_HDR_LEN;
+
+    if (get_le32(hdr) != VCO_TABLE_MAGIC) {
+        status = BLADERF_ERR_NO_FILE;
+        goto out;
+    }
+
+    if (hdr[4] != VCO_TABLE_VERSION || hdr[5] != VCO_TABLE_NUM_BANDS ||
+        hdr[6] != VCO_TABLE_POINTS_PER_BAND) {
+        log_debug("Unsupported VCOCAP table (version %u, %ux%u points).\n",
+                  hdr[4], hdr[5], hdr[6]);
+        status = BLADERF_ERR_NO_FILE;
+        goto out;
+    }
+
+    if (get_le32(hdr + 8) != flash_crc32(0, entry, VCO_TABLE_DATA_LEN)) {
+        log_warning("VCOCAP table in flash is corrupt. Ignoring it.\n");
+        status = BLADERF_ERR_NO_FILE;
+        goto out;
+    }
+
+    for (i = 0; i < VCO_TABLE_NUM_POINTS; i++) {
+        tbl->points[i].freq                      = get_le32(entry);
+        tbl->points[i].vcocap[BLADERF_MODULE_TX] = entry[4];
+        tbl->points[i].vcocap[BLADERF_MODULE_RX] = entry[5];
+        entry += VCO_TABLE_ENTRY_LEN;
+    }
+
+out:
+    free(buf);
+    return status;
+}
+
+int vco_table_store(struct bladerf *dev, const struct vco_table *tbl)
+{
+    const uint32_t psize  = dev->flash_arch->psize_bytes;
+    const uint32_t ebsize = dev->flash_arch->ebsize_bytes;
+    uint8_t *buf, *hdr, *entry, *readback;
+    uint32_t page, count;
+    unsigned int i;
+    int status;
+
+    /* The region must not straddle an erase block, as only one is rewritten */
+    if (BLADERF_FLASH_ADDR_CAL / ebsize !=
+        (VCO_TABLE_ADDR + VCO_TABLE_LEN - 1) / ebsize) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    status = read_region(dev, &buf, &page, &count);
+    if (status != 0) {
+        return status;
+    }
+
+    hdr   = buf + (VCO_TABLE_ADDR - BLADERF_FLASH_ADDR_CAL);
+    entry = hdr + VCO_TABLE_HDR_LEN;
+
+    if (tbl == NULL) {
+        memset(hdr, 0xff, VCO_TABLE_LEN);
+    } else {
+        for (i = 0; i < VCO_TABLE_NUM_POINTS; i++) {
+            put_le32(entry, tbl->points[i].freq);
+            entry[4] = tbl->points[i].vcocap[BLADERF_MODULE_TX];
+            entry[5] = tbl->points[i].vcocap[BLADERF_MODULE_RX];
+            entry[6] = 0;
+            entry[7] = 0;
+            entry += VCO_TABLE_ENTRY_LEN;
+        }
+
+        put_le32(hdr, VCO_TABLE_MAGIC);
+        hdr[4] = VCO_TABLE_VERSION;
+        hdr[5] = VCO_TABLE_NUM_BANDS;
+        hdr[6] = VCO_TABLE_POINTS_PER_BAND;
+        hdr[7] = 0;
+        put_le32(hdr + 8, flash_crc32(0, hdr + VCO_TABLE_HDR_LEN,
+                                      VCO_TABLE_DATA_LEN));
+    }
+
+    readback = malloc(count * psize);
+    if (readback == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto out;
+    }
+
+    status = spi_flash_erase(dev, BLADERF_FLASH_ADDR_CAL / ebsize, 1);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = spi_flash_write(dev, buf, page, count);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = spi_flash_verify(dev, readback, buf, page, count);
+
+out:
+    free(readback);
+    free(buf);
+    return status;
+}
+
+void vco_table_apply(const struct vco_table *tbl,
+                     bladerf_module module,
+                     uint32_t freq,
+                     struct lms_freq *f)
+{
+    const struct vco_table_point *p = NULL;
+    unsigned int band, i;
+    uint32_t low, high;
+
+    /* Find the band containing the frequency, as VCOCAP is only monotonic
+     * within a band */
+    for (band = 0; band < VCO_TABLE_NUM_BANDS; band++) {
+        if (lms_get_band(band, &low, &high) != 0) {
+            return;
+        }
+
+        if (freq >= low && freq <= high) {
+            p = &tbl->points[band * VCO_TABLE_POINTS_PER_BAND];
+            break;
+        }
+    }
+
+    if (p == NULL) {
+        return;
+    }
+
+    /* Interpolate between the points bracketing the frequency */
+    for (i = 0; i < VCO_TABLE_POINTS_PER_BAND - 2; i++) {
+        if (freq <= p[i + 1].freq) {
+            break;
+        }
+    }
+
+    if (freq <= p[i].freq) {
+        f->vcocap = p[i].vcocap[module];
+    } else if (freq >= p[i + 1].freq) {
+        f->vcocap = p[i + 1].vcocap[module];
+    } else {
+        const int32_t v0 = p[i].vcocap[module];
+        const int32_t v1 = p[i + 1].vcocap[module];
+        const uint64_t num = (uint64_t)(freq - p[i].freq);
+        const uint64_t den = (uint64_t)(p[i + 1].freq - p[i].freq);
+        const int32_t delta =
+            (int32_t)(((uint64_t)abs(v1 - v0) * num + den / 2) / den);
+
+        f->vcocap = (uint8_t)(v1 >= v0 ? v0 + delta : v0 - delta);
+    }
+}
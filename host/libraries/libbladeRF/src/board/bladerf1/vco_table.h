@@ -0,0 +1,104 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef BLADERF1_VCO_TABLE_H_
+#define BLADERF1_VCO_TABLE_H_
+
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+#include "lms.h"
+
+/* Number of frequencies characterized within each FREQSEL band, including
+ * the band edges */
+#define VCO_TABLE_POINTS_PER_BAND 9
+
+/* Number of FREQSEL bands */
+#define VCO_TABLE_NUM_BANDS 16
+
+#define VCO_TABLE_NUM_POINTS (VCO_TABLE_POINTS_PER_BAND * VCO_TABLE_NUM_BANDS)
+
+struct vco_table_point {
+    uint32_t freq;
+    uint8_t vcocap[2]; /* Indexed by bladerf_module */
+};
+
+/* VCOCAP values found by the tuning algorithm at points across each band.
+ * The points are sorted by frequency, with those of band i at indices
+ * [i * VCO_TABLE_POINTS_PER_BAND, (i + 1) * VCO_TABLE_POINTS_PER_BAND). */
+struct vco_table {
+    struct vco_table_point points[VCO_TABLE_NUM_POINTS];
+};
+
+/**
+ * Characterize the VCOCAP values of both LMS6002D PLLs over frequency, by
+ * running the full tuning algorithm at each point of the table.
+ *
+ * This retunes both modules; the caller is responsible for restoring their
+ * frequencies.
+ *
+ * @param       dev     Device handle
+ * @param[out]  tbl     Populated table
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int vco_table_characterize(struct bladerf *dev, struct vco_table *tbl);
+
+/**
+ * Load the table stored in flash, following the calibration data.
+ *
+ * @param       dev     Device handle
+ * @param[out]  tbl     Populated table
+ *
+ * @return 0 on success, BLADERF_ERR_NO_FILE if no valid table is stored, or
+ *         another BLADERF_ERR_* value on failure
+ */
+int vco_table_load(struct bladerf *dev, struct vco_table *tbl);
+
+/**
+ * Store a table in flash, following the calibration data, or remove a
+ * stored table. The calibration data shares the table's erase block, and is
+ * rewritten along with it.
+ *
+ * @param       dev     Device handle
+ * @param[in]   tbl     Table to store, or NULL to remove the stored table
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int vco_table_store(struct bladerf *dev, const struct vco_table *tbl);
+
+/**
+ * Replace the VCOCAP estimate of computed tuning parameters with one
+ * interpolated from the table. This is close enough to the final value for
+ * LMS_FREQ_FLAGS_VERIFY_VCOCAP to be used in place of a search.
+ *
+ * @param[in]   tbl     Table
+ * @param[in]   module  Module being tuned
+ * @param[in]   freq    Frequency being tuned to
+ * @param[inout] f      Tuning parameters from lms_calculate_tuning_params()
+ */
+void vco_table_apply(const struct vco_table *tbl,
+                     bladerf_module module,
+                     uint32_t freq,
+                     struct lms_freq *f);
+
+#endif
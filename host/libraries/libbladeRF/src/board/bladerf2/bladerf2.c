@@ -19,6 +19,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <math.h>
 #include <string.h>
 
 #include <libbladeRF.h>
@@ -35,6 +36,7 @@
 #include "board/board.h"
 #include "capabilities.h"
 #include "compatibility.h"
+#include "fastlock_store.h"
 
 #include "ad936x.h"
 #include "ad936x_helpers.h"
@@ -42,6 +44,8 @@
 #include "driver/fpga_trigger.h"
 #include "driver/fx3_fw.h"
 #include "driver/ina219.h"
+#include "driver/rx_gate.h"
+#include "driver/rx_power_meter.h"
 #include "driver/spi_flash.h"
 
 #include "backend/backend_config.h"
@@ -53,9 +57,14 @@
 #include "conversions.h"
 #include "devinfo.h"
 #include "helpers/file.h"
+#include "helpers/dev_lock.h"
+#include "helpers/fpga_image.h"
+#include "helpers/telemetry.h"
+#include "helpers/tune_cache.h"
 #include "helpers/version.h"
 #include "helpers/wallclock.h"
 #include "iterators.h"
+#include "sha256.h"
 #include "version.h"
 
 #include "bladerf2_common.h"
@@ -101,14 +110,249 @@ static struct bladerf_loopback_modes const bladerf2_loopback_modes[] = {
 // clang-format on
 
 
+/******************************************************************************/
+/* Warm open */
+/******************************************************************************/
+
+/* The state recorded after a full initialization, when warm opens are enabled,
+ * is kept in a per-user state file (see file_open_state()). Each line consists
+ * of the USB bus and address of the device, the configuration ID written to the
+ * FPGA, and the recorded state:
+ *
+ *  <bus> <addr> <config ID> <FPGA version> <FPGA size> <flash MID> <flash DID>
+ *      <capabilities> <VCTCXO trim> <firmware version string>
+ *
+ * The configuration ID is derived from the library version and the recorded
+ * state. It is cleared by the FPGA when reconfigured, and the USB address
+ * changes when the device is reset, so a device whose FPGA reports this ID can
+ * be assumed to still be in the recorded state. */
+#define WARM_STATE_NAME "state"
+#define WARM_STATE_LEN  256
+
+static uint64_t _warm_state_id(char const *state)
+{
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    SHA256_CTX ctx;
+    uint64_t id = 0;
+    size_t i;
+
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, LIBBLADERF_VERSION, strlen(LIBBLADERF_VERSION));
+    SHA256_Update(&ctx, state, strlen(state));
+    SHA256_Final(digest, &ctx);
+
+    for (i = 0; i < sizeof(id); i++) {
+        id = (id << 8) | digest[i];
+    }
+
+    /* 0 is reported by an FPGA that has not been assigned an ID */
+    return (id != 0) ? id : 1;
+}
+
+static void _warm_state_format(struct bladerf *dev, char *state, size_t len)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    snprintf(state, len, "%u.%u.%u %d %02x %02x %016" PRIx64 " %04x %s",
+             board_data->fpga_version.major, board_data->fpga_version.minor,
+             board_data->fpga_version.patch, board_data->fpga_size,
+             dev->flash_arch->manufacturer_id, dev->flash_arch->device_id,
+             board_data->capabilities, board_data->trimdac_stored_value,
+             board_data->fw_version.describe);
+}
+
+/**
+ * @brief      Record the state of a fully initialized device, for later warm
+ *             opens
+ *
+ * Failures are not reported, as they only result in later opens performing a
+ * full initialization.
+ *
+ * @param      dev   Device handle
+ */
+static void _bladerf2_warm_state_store(struct bladerf *dev)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    char state[WARM_STATE_LEN];
+    uint64_t id;
+    FILE *f;
+    int status;
+
+    /* Host-based RFIC control does not survive the closing of the device */
+    if (board_data->tuning_mode != BLADERF_TUNING_MODE_FPGA) {
+        log_debug("%s: warm opens require FPGA-based tuning\n", __FUNCTION__);
+        return;
+    }
+
+    _warm_state_format(dev, state, sizeof(state));
+    id = _warm_state_id(state);
+
+    status = dev->backend->set_config_id(dev, id);
+    if (status != 0) {
+        log_debug("%s: could not set configuration ID: %s\n", __FUNCTION__,
+                  bladerf_strerror(status));
+        return;
+    }
+
+    f = file_open_state(dev->ident.serial, WARM_STATE_NAME, true);
+    if (f != NULL) {
+        fprintf(f, "%u %u %016" PRIx64 " %s\n", dev->ident.usb_bus,
+                dev->ident.usb_addr, id, state);
+        fclose(f);
+    }
+}
+
+/**
+ * @brief      Clear the configuration ID of a device whose state no longer
+ *             matches its record (e.g., after writing calibration data to
+ *             flash), so that the next open performs a full initialization
+ *
+ * @param      dev   Device handle
+ */
+static void _bladerf2_warm_state_invalidate(struct bladerf *dev)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (board_data->state >= STATE_FPGA_LOADED) {
+        dev->backend->set_config_id(dev, 0);
+    }
+}
+
+/**
+ * @brief      Restore the state of a device initialized by an earlier open
+ *
+ * On success, the board state is ::STATE_FPGA_LOADED, and the board should be
+ * initialized via _bladerf2_initialize() with `warm` set.
+ *
+ * @param      dev   Device handle
+ * @param[out] warm  Set true if the device state was restored, and false if a
+ *                   full initialization is required
+ *
+ * @return     0 on success, value from \ref RETCODES list on failure
+ */
+static int _bladerf2_warm_open(struct bladerf *dev, bool *warm)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    char line[WARM_STATE_LEN + 64];
+    char fw_describe[BLADERF_VERSION_STR_MAX + 1];
+    unsigned int bus, addr, fpga_major, fpga_minor, fpga_patch, mid, did, trim;
+    uint64_t id, fpga_id, capabilities;
+    int fpga_size, state_pos, status;
+    bladerf_dev_speed usb_speed;
+    char *state;
+    FILE *f;
+
+    *warm = false;
+
+    f = file_open_state(dev->ident.serial, WARM_STATE_NAME, false);
+    if (f == NULL) {
+        return 0;
+    }
+
+    state = fgets(line, sizeof(line), f);
+    fclose(f);
+
+    if (state == NULL) {
+        return 0;
+    }
+
+    line[strcspn(line, "\n")] = '\0';
+
+    if (sscanf(line, "%u %u %" SCNx64 " %n", &bus, &addr, &id, &state_pos) !=
+            3 ||
+        sscanf(&line[state_pos], "%u.%u.%u %d %x %x %" SCNx64 " %x %32s",
+               &fpga_major, &fpga_minor, &fpga_patch, &fpga_size, &mid, &did,
+               &capabilities, &trim, fw_describe) != 9) {
+        log_debug("%s: ignoring malformed state\n", __FUNCTION__);
+        return 0;
+    }
+
+    state = &line[state_pos];
+
+    if (bus != dev->ident.usb_bus || addr != dev->ident.usb_addr ||
+        id != _warm_state_id(state)) {
+        log_debug("%s: device has been reset, or was recorded by a different "
+                  "library version\n",
+                  __FUNCTION__);
+        return 0;
+    }
+
+    if (dev->backend->is_fw_ready(dev) != 1 ||
+        dev->backend->is_fpga_configured(dev) != 1) {
+        return 0;
+    }
+
+    CHECK_STATUS(dev->backend->get_device_speed(dev, &usb_speed));
+    CHECK_STATUS(
+        dev->backend->set_fpga_protocol(dev, BACKEND_FPGA_PROTOCOL_NIOSII));
+
+    status = dev->backend->get_config_id(dev, &fpga_id);
+    if (status != 0 || fpga_id != id) {
+        log_debug("%s: FPGA configuration ID 0x%016" PRIx64 " does not "
+                  "match\n",
+                  __FUNCTION__, fpga_id);
+        return 0;
+    }
+
+    switch (usb_speed) {
+        case BLADERF_DEVICE_SPEED_SUPER:
+            board_data->msg_size = USB_MSG_SIZE_SS;
+            break;
+        case BLADERF_DEVICE_SPEED_HIGH:
+            board_data->msg_size = USB_MSG_SIZE_HS;
+            break;
+        default:
+            return 0;
+    }
+
+    snprintf(board_data->fw_version_str, sizeof(board_data->fw_version_str),
+             "%s", fw_describe);
+    CHECK_STATUS(str2version(board_data->fw_version_str,
+                             &board_data->fw_version));
+
+    board_data->fpga_version.major = fpga_major;
+    board_data->fpga_version.minor = fpga_minor;
+    board_data->fpga_version.patch = fpga_patch;
+    snprintf(board_data->fpga_version_str, sizeof(board_data->fpga_version_str),
+             "%u.%u.%u", fpga_major, fpga_minor, fpga_patch);
+
+    board_data->fpga_size            = (bladerf_fpga_size)fpga_size;
+    board_data->capabilities         = capabilities;
+    board_data->trimdac_stored_value = (uint16_t)trim;
+
+    dev->flash_arch->manufacturer_id = (uint8_t)mid;
+    dev->flash_arch->device_id       = (uint8_t)did;
+    spi_flash_decode_flash_architecture(dev, &board_data->fpga_size);
+
+    board_data->state = STATE_FPGA_LOADED;
+
+    log_verbose("%s: restored state of firmware v%s, FPGA v%s\n",
+                __FUNCTION__, board_data->fw_version.describe,
+                board_data->fpga_version.describe);
+
+    *warm = true;
+    return 0;
+}
+
 /******************************************************************************/
 /* Low-level Initialization */
 /******************************************************************************/
 
-static int _bladerf2_initialize(struct bladerf *dev)
+/**
+ * @brief      Initialize the board
+ *
+ * @param      dev   Device handle
+ * @param[in]  warm  The FPGA version, capabilities, and VCTCXO trim value
+ *                   have been restored by _bladerf2_warm_open(), and hardware
+ *                   state that persists across opens is left as-is
+ *
+ * @return     0 on success, value from \ref RETCODES list on failure
+ */
+static int _bladerf2_initialize(struct bladerf *dev, bool warm)
 {
     struct bladerf2_board_data *board_data;
     struct bladerf_version required_fw_version, required_fpga_version;
+    size_t i;
     int status;
 
     /* Test for uninitialized dev struct */
@@ -118,6 +362,10 @@ static int _bladerf2_initialize(struct bladerf *dev)
     /* Initialize board_data struct and members */
     board_data = dev->board_data;
 
+    if (warm) {
+        goto initialize_rfic;
+    }
+
     /* Read FPGA version */
     CHECK_STATUS(
         dev->backend->get_fpga_version(dev, &board_data->fpga_version));
@@ -174,6 +422,7 @@ static int _bladerf2_initialize(struct bladerf *dev)
     /* Initialize INA219 */
     CHECK_STATUS(ina219_init(dev, ina219_r_shunt));
 
+initialize_rfic:
     /* Set tuning mode. This will trigger initialization of the RFIC.
      *
      * RFIC initialization consists of:
@@ -192,7 +441,10 @@ static int _bladerf2_initialize(struct bladerf *dev)
     /* Initialize VCTCXO trim DAC to stored value */
     uint16_t *trimval = &(board_data->trimdac_stored_value);
 
-    CHECK_STATUS(bladerf2_read_flash_vctcxo_trim(dev, trimval));
+    if (!warm) {
+        CHECK_STATUS(bladerf2_read_flash_vctcxo_trim(dev, trimval));
+    }
+
     CHECK_STATUS(dev->backend->ad56x1_vctcxo_trim_dac_write(dev, *trimval));
 
     board_data->trim_source = TRIM_SOURCE_TRIM_DAC;
@@ -204,6 +456,18 @@ static int _bladerf2_initialize(struct bladerf *dev)
     board_data->quick_tune_rx_profile = 0;
     board_data->quick_tune_tx_profile = 0;
 
+    /* The Nios copies of stored fast lock profiles are gone, along with the
+     * slots that were reserved for them */
+    for (i = 0; i < ARRAY_SIZE(board_data->fastlocks); i++) {
+        if (board_data->fastlocks[i] != NULL) {
+            fastlock_store_set_window(board_data->fastlocks[i], 0, 0);
+        }
+    }
+
+    if (bladerf_warm_open && !warm) {
+        _bladerf2_warm_state_store(dev);
+    }
+
     log_debug("%s: complete\n", __FUNCTION__);
 
     return 0;
@@ -254,6 +518,7 @@ static int bladerf2_open(struct bladerf *dev, struct bladerf_devinfo *devinfo)
     struct bladerf_version required_fw_version;
     char *full_path;
     bladerf_dev_speed usb_speed;
+    bool warm = false;
     size_t i;
     int ready, status;
 
@@ -287,6 +552,15 @@ static int bladerf2_open(struct bladerf *dev, struct bladerf_devinfo *devinfo)
 
     board_data->rfic_reset_on_close = false;
 
+    /* Skip probing a device whose state was recorded by an earlier open */
+    if (bladerf_warm_open) {
+        CHECK_STATUS(_bladerf2_warm_open(dev, &warm));
+
+        if (warm) {
+            goto initialize;
+        }
+    }
+
     /* Read firmware version */
     CHECK_STATUS(dev->backend->get_fw_version(dev, &board_data->fw_version));
 
@@ -441,20 +715,23 @@ static int bladerf2_open(struct bladerf *dev, struct bladerf_devinfo *devinfo)
         }
 
         if (full_path != NULL) {
-            uint8_t *buf;
-            size_t buf_size;
+            struct fpga_image image;
 
             log_debug("Loading FPGA from: %s\n", full_path);
 
-            status = file_read_buffer(full_path, &buf, &buf_size);
+            status = fpga_image_open_file(&image, full_path);
             free(full_path);
             full_path = NULL;
 
             if (status != 0) {
-                RETURN_ERROR_STATUS("file_read_buffer", status);
+                RETURN_ERROR_STATUS("fpga_image_open_file", status);
             }
 
-            CHECK_STATUS(dev->backend->load_fpga(dev, buf, buf_size));
+            status = dev->backend->load_fpga(dev, &image);
+            fpga_image_close(&image);
+            if (status != 0) {
+                RETURN_ERROR_STATUS("dev->backend->load_fpga", status);
+            }
 
             board_data->state = STATE_FPGA_LOADED;
         } else {
@@ -464,8 +741,9 @@ static int bladerf2_open(struct bladerf *dev, struct bladerf_devinfo *devinfo)
         }
     }
 
+initialize:
     /* Initialize the board */
-    CHECK_STATUS(_bladerf2_initialize(dev));
+    CHECK_STATUS(_bladerf2_initialize(dev, warm));
 
     if (have_cap(board_data->capabilities, BLADERF_CAP_SCHEDULED_RETUNE)) {
         /* Cancel any pending re-tunes that may have been left over as the
@@ -542,6 +820,9 @@ static void bladerf2_close(struct bladerf *dev)
                 }
             }
 
+            fastlock_store_free(board_data->fastlocks[BLADERF_RX]);
+            fastlock_store_free(board_data->fastlocks[BLADERF_TX]);
+
             free(board_data);
             board_data = NULL;
         }
@@ -741,38 +1022,19 @@ static int bladerf2_get_gain_stage_range(struct bladerf *dev,
     CHECK_BOARD_STATE(STATE_INITIALIZED);
     NULL_CHECK(range);
 
-    struct bladerf_gain_range const *ranges = NULL;
-    bladerf_frequency frequency             = 0;
-    size_t i, ranges_len;
-
-    if (BLADERF_CHANNEL_IS_TX(ch)) {
-        ranges     = bladerf2_tx_gain_ranges;
-        ranges_len = ARRAY_SIZE(bladerf2_tx_gain_ranges);
-    } else {
-        ranges     = bladerf2_rx_gain_ranges;
-        ranges_len = ARRAY_SIZE(bladerf2_rx_gain_ranges);
-    }
+    struct bladerf_gain_range const *r = NULL;
+    bladerf_frequency frequency        = 0;
 
     CHECK_STATUS(dev->board->get_frequency(dev, ch, &frequency));
 
-    for (i = 0; i < ranges_len; ++i) {
-        struct bladerf_gain_range const *r = &(ranges[i]);
-        struct bladerf_range const *rfreq  = &(r->frequency);
-
-        // if the frequency range matches, and either:
-        //  both the range name and the stage name are null, or
-        //  neither name is null and the strings match
-        // then we found our match
-        if (is_within_range(rfreq, frequency) &&
-            ((NULL == r->name && NULL == stage) ||
-             (r->name != NULL && stage != NULL &&
-              (strcmp(r->name, stage) == 0)))) {
-            *range = &(r->gain);
-            return 0;
-        }
+    r = find_gain_range(ch, stage, frequency);
+    if (NULL == r) {
+        return BLADERF_ERR_INVAL;
     }
 
-    return BLADERF_ERR_INVAL;
+    *range = &(r->gain);
+
+    return 0;
 }
 
 static int bladerf2_get_gain_range(struct bladerf *dev,
@@ -817,11 +1079,6 @@ static int bladerf2_get_gain_stages(struct bladerf *dev,
     unsigned int ranges_len;
     size_t i, j;
 
-    IF_COMMAND_MODE(dev, RFIC_COMMAND_FPGA, {
-        *stages = NULL;
-        return 0;
-    });
-
     if (BLADERF_CHANNEL_IS_TX(ch)) {
         ranges     = bladerf2_tx_gain_ranges;
         ranges_len = ARRAY_SIZE(bladerf2_tx_gain_ranges);
@@ -910,6 +1167,11 @@ static int bladerf2_set_gain(struct bladerf *dev, bladerf_channel ch, int gain)
     struct bladerf2_board_data *board_data = dev->board_data;
     struct bladerf_range const *range      = NULL;
 
+    /* A precomputed gain table does its own clamping */
+    if (gain_table_covers(board_data, ch, gain)) {
+        return board_data->rfic->set_gain(dev, ch, gain);
+    }
+
     CHECK_STATUS(dev->board->get_gain_range(dev, ch, &range));
 
     return board_data->rfic->set_gain(dev, ch, clamp_to_range(range, gain));
@@ -1253,6 +1515,38 @@ static int bladerf2_set_frequency(struct bladerf *dev,
     return board_data->rfic->set_frequency(dev, ch, frequency);
 }
 
+static int bladerf2_set_frequency_begin(struct bladerf *dev,
+                                        bladerf_channel ch,
+                                        bladerf_frequency frequency)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    return board_data->rfic->set_frequency_begin(dev, ch, frequency);
+}
+
+static int bladerf2_get_pll_lock(struct bladerf *dev,
+                                 bladerf_channel ch,
+                                 bool *locked)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    uint16_t address = BLADERF_CHANNEL_IS_TX(ch)
+                           ? AD936X_REG_TX_CP_OVERRANGE_VCO_LOCK
+                           : AD936X_REG_RX_CP_OVERRANGE_VCO_LOCK;
+    uint64_t data;
+
+    /* Read directly, as either RFIC control may have left the VCO settling */
+    address |= (AD936X_READ | AD936X_CNT(1));
+
+    CHECK_AD936X(dev->backend->ad9361_spi_read(dev, address, &data));
+
+    *locked = (((data >> 56) & 0xff) & AD936X_VCO_LOCK) != 0;
+
+    return 0;
+}
+
 
 /******************************************************************************/
 /* RF ports */
@@ -1265,17 +1559,13 @@ static int bladerf2_set_rf_port(struct bladerf *dev,
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
     struct bladerf2_board_data *board_data      = dev->board_data;
-    struct ad9361_rf_phy *phy                   = board_data->phy;
+    struct controller_fns const *rfic           = board_data->rfic;
     struct bladerf_rfic_port_name_map const *pm = NULL;
     unsigned int pm_len                         = 0;
     uint32_t port_id                            = UINT32_MAX;
+    size_t const dir = BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX : BLADERF_RX;
     size_t i;
 
-    IF_COMMAND_MODE(dev, RFIC_COMMAND_FPGA, {
-        log_debug("%s: FPGA command mode not supported\n", __FUNCTION__);
-        return BLADERF_ERR_UNSUPPORTED;
-    });
-
     if (BLADERF_CHANNEL_IS_TX(ch)) {
         pm     = bladerf2_tx_port_map;
         pm_len = ARRAY_SIZE(bladerf2_tx_port_map);
@@ -1295,11 +1585,12 @@ static int bladerf2_set_rf_port(struct bladerf *dev,
         RETURN_INVAL("port", "is not valid");
     }
 
-    if (BLADERF_CHANNEL_IS_TX(ch)) {
-        CHECK_AD936X(ad9361_set_tx_rf_port_output(phy, port_id));
-    } else {
-        CHECK_AD936X(ad9361_set_rx_rf_port_input(phy, port_id));
-    }
+    board_data->rfic_port_valid[dir] = false;
+
+    CHECK_STATUS(rfic->set_rf_port(dev, ch, port_id));
+
+    board_data->rfic_port[dir]       = port_id;
+    board_data->rfic_port_valid[dir] = true;
 
     return 0;
 }
@@ -1312,28 +1603,23 @@ static int bladerf2_get_rf_port(struct bladerf *dev,
     NULL_CHECK(port);
 
     struct bladerf2_board_data *board_data      = dev->board_data;
-    struct ad9361_rf_phy *phy                   = board_data->phy;
+    struct controller_fns const *rfic           = board_data->rfic;
     struct bladerf_rfic_port_name_map const *pm = NULL;
     unsigned int pm_len                         = 0;
     uint32_t port_id;
     bool ok;
     size_t i;
 
-    IF_COMMAND_MODE(dev, RFIC_COMMAND_FPGA, {
-        log_debug("%s: FPGA command mode not supported\n", __FUNCTION__);
-        return BLADERF_ERR_UNSUPPORTED;
-    });
-
     if (BLADERF_CHANNEL_IS_TX(ch)) {
         pm     = bladerf2_tx_port_map;
         pm_len = ARRAY_SIZE(bladerf2_tx_port_map);
-        CHECK_AD936X(ad9361_get_tx_rf_port_output(phy, &port_id));
     } else {
         pm     = bladerf2_rx_port_map;
         pm_len = ARRAY_SIZE(bladerf2_rx_port_map);
-        CHECK_AD936X(ad9361_get_rx_rf_port_input(phy, &port_id));
     }
 
+    CHECK_STATUS(rfic->get_rf_port(dev, ch, &port_id));
+
     ok = false;
 
     for (i = 0; i < pm_len; i++) {
@@ -1362,11 +1648,6 @@ static int bladerf2_get_rf_ports(struct bladerf *dev,
     unsigned int pm_len;
     size_t i;
 
-    IF_COMMAND_MODE(dev, RFIC_COMMAND_FPGA, {
-        *ports = NULL;
-        return 0;
-    });
-
     if (BLADERF_CHANNEL_IS_TX(ch)) {
         pm     = bladerf2_tx_port_map;
         pm_len = ARRAY_SIZE(bladerf2_tx_port_map);
@@ -1391,6 +1672,69 @@ static int bladerf2_get_rf_ports(struct bladerf *dev,
 /* Scheduled Tuning */
 /******************************************************************************/
 
+/* Get the Nios retune port and SPDT settings for a channel's frequency */
+static void _bladerf2_quick_tune_ports(bladerf_channel ch,
+                                       bladerf_frequency freq,
+                                       uint8_t *port,
+                                       uint8_t *spdt)
+{
+    struct band_port_map const *pm = _get_band_port_map_by_freq(ch, freq);
+
+    if (BLADERF_CHANNEL_IS_TX(ch)) {
+        /* Set the TX band */
+        *port = (pm->rfic_port << 6);
+
+        /* Set the TX SPDTs */
+        *spdt = (pm->spdt << 6) | (pm->spdt << 4);
+
+    } else {
+        /* Set the RX bit */
+        *port = NIOS_PKT_RETUNE2_PORT_IS_RX_MASK;
+
+        /* Set the RX band */
+        if (pm->rfic_port < 3) {
+            *port |= (3 << (pm->rfic_port << 1));
+        } else {
+            *port |= (1 << (pm->rfic_port - 3));
+        }
+
+        /* Set the RX SPDTs */
+        *spdt = (pm->spdt << 2) | (pm->spdt);
+    }
+}
+
+/* Store the current tuning of a channel in the fast lock profiles assigned
+ * to `quick_tune`, and fill in the remaining quick tune parameters */
+static int _bladerf2_store_quick_tune(struct bladerf *dev,
+                                      bladerf_channel ch,
+                                      struct bladerf_quick_tune *quick_tune)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct controller_fns const *rfic      = board_data->rfic;
+
+    bladerf_frequency freq;
+
+    CHECK_STATUS(dev->board->get_frequency(dev, ch, &freq));
+
+    /* Create a fast lock profile in the RFIC */
+    CHECK_STATUS(
+        rfic->store_fastlock_profile(dev, ch, quick_tune->rffe_profile));
+
+    /* Save a copy of the fast lock profile to the Nios */
+    dev->backend->rffe_fastlock_save(dev, BLADERF_CHANNEL_IS_TX(ch),
+                                     quick_tune->rffe_profile,
+                                     quick_tune->nios_profile);
+
+    _bladerf2_quick_tune_ports(ch, freq, &quick_tune->port, &quick_tune->spdt);
+
+    /* Workaround: the RFIC can end up in a bad state after fastlock use, and
+     * needs to be reset and re-initialized. This is likely due to our direct
+     * SPI writes causing state incongruence. */
+    board_data->rfic_reset_on_close = true;
+
+    return 0;
+}
+
 static int bladerf2_get_quick_tune(struct bladerf *dev,
                                    bladerf_channel ch,
                                    struct bladerf_quick_tune *quick_tune)
@@ -1399,20 +1743,12 @@ static int bladerf2_get_quick_tune(struct bladerf *dev,
     NULL_CHECK(quick_tune);
 
     struct bladerf2_board_data *board_data = dev->board_data;
-    struct controller_fns const *rfic      = board_data->rfic;
-    struct band_port_map const *pm         = NULL;
-
-    bladerf_frequency freq;
 
     if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_RX(1) &&
         ch != BLADERF_CHANNEL_TX(0) && ch != BLADERF_CHANNEL_TX(1)) {
         RETURN_INVAL_ARG("channel", ch, "is not valid");
     }
 
-    CHECK_STATUS(dev->board->get_frequency(dev, ch, &freq));
-
-    pm = _get_band_port_map_by_freq(ch, freq);
-
     if (BLADERF_CHANNEL_IS_TX(ch)) {
         if (board_data->quick_tune_tx_profile < NUM_BBP_FASTLOCK_PROFILES) {
             /* Assign Nios and RFFE profile numbers */
@@ -1427,21 +1763,6 @@ static int bladerf2_get_quick_tune(struct bladerf *dev,
             log_error("Reached maximum number of TX quick tune profiles.");
             return BLADERF_ERR_UNEXPECTED;
         }
-
-        /* Create a fast lock profile in the RFIC */
-        CHECK_STATUS(
-            rfic->store_fastlock_profile(dev, ch, quick_tune->rffe_profile));
-
-        /* Save a copy of the TX fast lock profile to the Nios */
-        dev->backend->rffe_fastlock_save(dev, true, quick_tune->rffe_profile,
-                                         quick_tune->nios_profile);
-
-        /* Set the TX band */
-        quick_tune->port = (pm->rfic_port << 6);
-
-        /* Set the TX SPDTs */
-        quick_tune->spdt = (pm->spdt << 6) | (pm->spdt << 4);
-
     } else {
         if (board_data->quick_tune_rx_profile < NUM_BBP_FASTLOCK_PROFILES) {
             /* Assign Nios and RFFE profile numbers */
@@ -1456,35 +1777,24 @@ static int bladerf2_get_quick_tune(struct bladerf *dev,
             log_error("Reached maximum number of RX quick tune profiles.");
             return BLADERF_ERR_UNEXPECTED;
         }
+    }
 
-        /* Create a fast lock profile in the RFIC */
-        CHECK_STATUS(
-            rfic->store_fastlock_profile(dev, ch, quick_tune->rffe_profile));
+    return _bladerf2_store_quick_tune(dev, ch, quick_tune);
+}
 
-        /* Save a copy of the RX fast lock profile to the Nios */
-        dev->backend->rffe_fastlock_save(dev, false, quick_tune->rffe_profile,
-                                         quick_tune->nios_profile);
+static int bladerf2_update_quick_tune(struct bladerf *dev,
+                                      bladerf_channel ch,
+                                      struct bladerf_quick_tune *quick_tune)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(quick_tune);
 
-        /* Set the RX bit */
-        quick_tune->port = NIOS_PKT_RETUNE2_PORT_IS_RX_MASK;
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_RX(1) &&
+        ch != BLADERF_CHANNEL_TX(0) && ch != BLADERF_CHANNEL_TX(1)) {
+        RETURN_INVAL_ARG("channel", ch, "is not valid");
+    }
 
-        /* Set the RX band */
-        if (pm->rfic_port < 3) {
-            quick_tune->port |= (3 << (pm->rfic_port << 1));
-        } else {
-            quick_tune->port |= (1 << (pm->rfic_port - 3));
-        }
-
-        /* Set the RX SPDTs */
-        quick_tune->spdt = (pm->spdt << 2) | (pm->spdt);
-    }
-
-    /* Workaround: the RFIC can end up in a bad state after fastlock use, and
-     * needs to be reset and re-initialized. This is likely due to our direct
-     * SPI writes causing state incongruence. */
-    board_data->rfic_reset_on_close = true;
-
-    return 0;
+    return _bladerf2_store_quick_tune(dev, ch, quick_tune);
 }
 
 static int bladerf2_schedule_retune(struct bladerf *dev,
@@ -1508,6 +1818,12 @@ static int bladerf2_schedule_retune(struct bladerf *dev,
         return BLADERF_ERR_UNSUPPORTED;
     }
 
+    /* The retune selects its own port, and moves the LO */
+    board_data->rfic_port_valid[BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX
+                                                          : BLADERF_RX] = false;
+    gain_table_invalidate(board_data, BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX
+                                                                : BLADERF_RX);
+
     return dev->backend->retune2(dev, ch, timestamp, quick_tune->nios_profile,
                                  quick_tune->rffe_profile, quick_tune->port,
                                  quick_tune->spdt);
@@ -1534,6 +1850,121 @@ static int bladerf2_cancel_scheduled_retunes(struct bladerf *dev,
                                  0);
 }
 
+static int bladerf2_get_retune_queue_status(
+    struct bladerf *dev,
+    bladerf_channel ch,
+    struct bladerf_retune_queue_status *status)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+    NULL_CHECK(status);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_RETUNE_QUEUE_CONTROL)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "retune queue queries.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return dev->backend->retune_queue(dev, ch, NIOS_PKT_RETUNE_QUEUE_CMD_QUERY,
+                                      0, 0, status, NULL);
+}
+
+static int bladerf2_cancel_scheduled_retunes_range(struct bladerf *dev,
+                                                   bladerf_channel ch,
+                                                   bladerf_timestamp start,
+                                                   bladerf_timestamp end,
+                                                   unsigned int *canceled)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_RETUNE_QUEUE_CONTROL)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "selective retune cancellation.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return dev->backend->retune_queue(dev, ch, NIOS_PKT_RETUNE_QUEUE_CMD_CANCEL,
+                                      start, end, NULL, canceled);
+}
+
+static int bladerf2_schedule_write(struct bladerf *dev,
+                                   bladerf_channel ch,
+                                   bladerf_timestamp timestamp,
+                                   bladerf_timed_write_target target,
+                                   uint32_t value)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_TIMED_WRITE)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "scheduled peripheral writes.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    switch (target) {
+        case BLADERF_TIMED_WRITE_CONFIG_GPIO:
+            return dev->backend->timed_write(dev, ch, timestamp,
+                                             NIOS_PKT_8x32_MAGIC,
+                                             NIOS_PKT_8x32_TARGET_CONTROL, 0,
+                                             value);
+
+        case BLADERF_TIMED_WRITE_EXPANSION_GPIO:
+            return dev->backend->timed_write(dev, ch, timestamp,
+                                             NIOS_PKT_32x32_MAGIC,
+                                             NIOS_PKT_32x32_TARGET_EXP, 0xff,
+                                             value);
+
+        case BLADERF_TIMED_WRITE_EXPANSION_GPIO_DIR:
+            return dev->backend->timed_write(dev, ch, timestamp,
+                                             NIOS_PKT_32x32_MAGIC,
+                                             NIOS_PKT_32x32_TARGET_EXP_DIR,
+                                             0xff, value);
+
+        case BLADERF_TIMED_WRITE_TRIM_DAC:
+            return dev->backend->timed_write(dev, ch, timestamp,
+                                             NIOS_PKT_8x16_MAGIC,
+                                             NIOS_PKT_8x16_TARGET_AD56X1_DAC,
+                                             0, value & 0xffff);
+
+        case BLADERF_TIMED_WRITE_RFFE_CONTROL:
+            return dev->backend->timed_write(dev, ch, timestamp,
+                                             NIOS_PKT_8x32_MAGIC,
+                                             NIOS_PKT_8x32_TARGET_RFFE_CSR, 0,
+                                             value);
+
+        default:
+            RETURN_INVAL("target", "is not valid");
+    }
+}
+
+static int bladerf2_get_rfic_temperature(struct bladerf *dev, float *val)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+    NULL_CHECK(val);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct controller_fns const *rfic      = board_data->rfic;
+
+    return rfic->get_temperature(dev, val);
+}
+
 
 /******************************************************************************/
 /* DC/Phase/Gain Correction */
@@ -2035,6 +2466,13 @@ static int bladerf2_trigger_state(struct bladerf *dev,
                               fire_requested);
 }
 
+static int bladerf2_get_trigger_time(struct bladerf *dev,
+                                     struct bladerf_trigger const *trigger,
+                                     struct bladerf_trigger_time *time)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
 
 /******************************************************************************/
 /* Streaming */
@@ -2048,13 +2486,14 @@ static int bladerf2_init_stream(struct bladerf_stream **stream,
                                 bladerf_format format,
                                 size_t samples_per_buffer,
                                 size_t num_transfers,
-                                void *user_data)
+                                void *user_data,
+                                const struct bladerf_buffer_allocator *allocator)
 {
     CHECK_BOARD_STATE(STATE_INITIALIZED);
 
     return async_init_stream(stream, dev, callback, buffers, num_buffers,
                              format, samples_per_buffer, num_transfers,
-                             user_data);
+                             user_data, allocator);
 }
 
 static int bladerf2_stream(struct bladerf_stream *stream,
@@ -2074,6 +2513,8 @@ static int bladerf2_stream(struct bladerf_stream *stream,
     }
 
     WITH_MUTEX(&stream->dev->lock, {
+        CHECK_STATUS_LOCKED(
+            perform_dma_config(stream->dev, layout, stream->format));
         CHECK_STATUS_LOCKED(
             perform_format_config(stream->dev, dir, stream->format));
     });
@@ -2132,6 +2573,212 @@ static int bladerf2_get_stream_timeout(struct bladerf *dev,
     return 0;
 }
 
+static int bladerf2_set_sync_wait_policy(struct bladerf *dev,
+                                         bladerf_direction dir,
+                                         bladerf_sync_wait_policy policy,
+                                         unsigned int spin_us)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    return sync_set_wait_policy(&board_data->sync[dir], policy, spin_us);
+}
+
+static int bladerf2_get_stream_stats(struct bladerf *dev,
+                                     bladerf_direction dir,
+                                     struct bladerf_stream_stats *stats)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[dir].initialized) {
+        RETURN_INVAL("sync", "not initialized");
+    }
+
+    return sync_get_stats(&board_data->sync[dir], stats);
+}
+
+static int bladerf2_set_sync_thread_attrs(
+    struct bladerf *dev,
+    bladerf_direction dir,
+    const struct bladerf_thread_attrs *attrs)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    return sync_set_thread_attrs(&board_data->sync[dir], attrs);
+}
+
+static int bladerf2_set_sync_buffer_allocator(
+    struct bladerf *dev,
+    bladerf_direction dir,
+    const struct bladerf_buffer_allocator *allocator)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    return sync_set_buffer_allocator(&board_data->sync[dir], allocator);
+}
+
+static int bladerf2_set_sync_rx_pool(struct bladerf *dev, bool enable)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    sync_set_rx_pool(&board_data->sync[BLADERF_RX], enable);
+    return 0;
+}
+
+static int bladerf2_set_sync_tx_pool(struct bladerf *dev, bool enable)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    sync_set_tx_pool(&board_data->sync[BLADERF_TX], enable);
+    return 0;
+}
+
+static int bladerf2_set_sync_rx_stats(struct bladerf *dev,
+                                      bool enable,
+                                      unsigned int clip_threshold)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    return sync_set_rx_stats(&board_data->sync[BLADERF_RX], enable,
+                             clip_threshold);
+}
+
+static int bladerf2_get_sync_rx_stats(struct bladerf *dev,
+                                      struct bladerf_rx_stats *stats)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        RETURN_INVAL("sync", "not initialized");
+    }
+
+    return sync_get_rx_stats(&board_data->sync[BLADERF_RX], stats);
+}
+
+static int bladerf2_set_sync_rx_tap(struct bladerf *dev,
+                                    const struct bladerf_sync_rx_tap *tap)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    return sync_set_rx_tap(&board_data->sync[BLADERF_RX], tap);
+}
+
+static int bladerf2_set_sync_rx_meta_msg_size(struct bladerf *dev,
+                                              unsigned int size)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (size != 0 && size < board_data->msg_size) {
+        RETURN_INVAL("size", "is smaller than a DMA buffer");
+    }
+
+    if (size > board_data->msg_size &&
+        !have_cap(board_data->capabilities,
+                  BLADERF_CAP_FPGA_RX_META_MSG_SIZE)) {
+        log_debug("FPGA does not support RX metadata messages spanning "
+                  "multiple DMA buffers.\n");
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    board_data->rx_meta_msg_req = size;
+    return 0;
+}
+
+static int bladerf2_get_sync_rx_meta_msg_size(struct bladerf *dev,
+                                              unsigned int *size)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (board_data->rx_meta_msg_size != 0) {
+        *size = (unsigned int)board_data->rx_meta_msg_size;
+    } else {
+        *size = (unsigned int)board_data->msg_size;
+    }
+
+    return 0;
+}
+
+/* Select the number of DMA buffers per RX metadata message, as a log2, and
+ * program it into the FPGA. Messages are kept to a single buffer unless a
+ * larger size was requested, the format carries headers in every message,
+ * and the stream buffers hold a whole number of the larger messages. */
+static int config_rx_meta_msg(struct bladerf *dev,
+                              bladerf_format format,
+                              unsigned int buffer_size,
+                              size_t *msg_size)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    size_t buf_bytes;
+    uint32_t gpio_val;
+    unsigned int log2 = 0;
+
+    *msg_size = board_data->msg_size;
+
+    if (!have_cap(board_data->capabilities,
+                  BLADERF_CAP_FPGA_RX_META_MSG_SIZE)) {
+        return 0;
+    }
+
+    buf_bytes = samples_to_bytes(wire_format(format), buffer_size);
+
+    if (board_data->rx_meta_msg_req > board_data->msg_size &&
+        (format == BLADERF_FORMAT_SC16_Q11_META ||
+         format == BLADERF_FORMAT_SC8_Q7_META ||
+         format == BLADERF_FORMAT_CF32_META ||
+         format == BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META ||
+         format == BLADERF_FORMAT_SC8_Q7_AS_CF32_META)) {
+        if (buffer_size == 0) {
+            log_debug("Using single-buffer RX metadata messages with an "
+                      "automatically sized stream.\n");
+        }
+
+        while (log2 < 3 &&
+               (board_data->msg_size << (log2 + 1)) <=
+                   board_data->rx_meta_msg_req &&
+               buf_bytes % (board_data->msg_size << (log2 + 1)) == 0 &&
+               buf_bytes != 0) {
+            log2++;
+        }
+    }
+
+    CHECK_STATUS(dev->backend->config_gpio_read(dev, &gpio_val));
+
+    gpio_val &= ~BLADERF_GPIO_RX_META_MSG_MASK;
+    gpio_val |= (log2 << BLADERF_GPIO_RX_META_MSG_SHIFT) &
+                BLADERF_GPIO_RX_META_MSG_MASK;
+
+    CHECK_STATUS(dev->backend->config_gpio_write(dev, gpio_val));
+
+    *msg_size = board_data->msg_size << log2;
+
+    if (log2 != 0) {
+        log_debug("Using %zu-byte RX metadata messages\n", *msg_size);
+    }
+
+    return 0;
+}
+
 static int bladerf2_sync_config(struct bladerf *dev,
                                 bladerf_channel_layout layout,
                                 bladerf_format format,
@@ -2145,11 +2792,15 @@ static int bladerf2_sync_config(struct bladerf *dev,
     struct bladerf2_board_data *board_data = dev->board_data;
 
     bladerf_direction dir = layout & BLADERF_DIRECTION_MASK;
+    size_t msg_size = board_data->msg_size;
     int status;
 
     if (dev->feature == BLADERF_FEATURE_OVERSAMPLE
-        && (format == BLADERF_FORMAT_SC16_Q11 || format == BLADERF_FORMAT_SC16_Q11_META)) {
-        log_error("16bit format unsupported with OVERSAMPLE feature enabled\n");
+        && (wire_format(format) == BLADERF_FORMAT_SC16_Q11
+            || wire_format(format) == BLADERF_FORMAT_SC16_Q11_META
+            || format_is_packed(format))) {
+        log_error("16bit and 12bit formats unsupported with OVERSAMPLE "
+                  "feature enabled\n");
         return BLADERF_ERR_UNSUPPORTED;
     }
 
@@ -2163,16 +2814,31 @@ static int bladerf2_sync_config(struct bladerf *dev,
             return -EINVAL;
     }
 
-    status = perform_format_config(dev, dir, format);
+    status = perform_dma_config(dev, layout, wire_format(format));
+    if (0 == status) {
+        status = perform_format_config(dev, dir, wire_format(format));
+    }
+
+    if (0 == status && dir == BLADERF_RX) {
+        status = config_rx_meta_msg(dev, format, buffer_size, &msg_size);
+        if (status != 0) {
+            perform_format_deconfig(dev, dir);
+        }
+    }
+
     if (0 == status) {
         status = sync_init(&board_data->sync[dir], dev, layout, format,
-                           num_buffers, buffer_size, board_data->msg_size,
+                           num_buffers, buffer_size, msg_size,
                            num_transfers, stream_timeout);
         if (status != 0) {
             perform_format_deconfig(dev, dir);
         }
     }
 
+    if (dir == BLADERF_RX) {
+        board_data->rx_meta_msg_size = (0 == status) ? msg_size : 0;
+    }
+
     return status;
 }
 
@@ -2212,65 +2878,336 @@ static int bladerf2_sync_rx(struct bladerf *dev,
                    metadata, timeout_ms);
 }
 
-static int bladerf2_get_timestamp(struct bladerf *dev,
-                                  bladerf_direction dir,
-                                  bladerf_timestamp *value)
+static int bladerf2_sync_tx_nb(struct bladerf *dev,
+                               void const *samples,
+                               unsigned int num_samples,
+                               struct bladerf_metadata *metadata)
 {
     CHECK_BOARD_STATE(STATE_INITIALIZED);
-    NULL_CHECK(value);
 
-    return dev->backend->get_timestamp(dev, dir, value);
-}
+    struct bladerf2_board_data *board_data = dev->board_data;
 
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        RETURN_INVAL("sync tx", "not initialized");
+    }
 
-/******************************************************************************/
-/* FPGA/Firmware Loading/Flashing */
-/******************************************************************************/
+    return sync_tx_nb(&board_data->sync[BLADERF_TX], samples, num_samples,
+                      metadata);
+}
 
-static int bladerf2_load_fpga(struct bladerf *dev,
-                              uint8_t const *buf,
-                              size_t length)
+static int bladerf2_sync_rx_nb(struct bladerf *dev,
+                               void *samples,
+                               unsigned int num_samples,
+                               struct bladerf_metadata *metadata)
 {
-    CHECK_BOARD_STATE(STATE_FIRMWARE_LOADED);
-    NULL_CHECK(buf);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
 
     struct bladerf2_board_data *board_data = dev->board_data;
 
-    if (!is_valid_fpga_size(dev, board_data->fpga_size, length)) {
-        RETURN_INVAL("fpga file", "incorrect file size");
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        RETURN_INVAL("sync rx", "not initialized");
     }
 
-    CHECK_STATUS(dev->backend->load_fpga(dev, buf, length));
+    return sync_rx_nb(&board_data->sync[BLADERF_RX], samples, num_samples,
+                      metadata);
+}
 
-    /* Update device state */
-    board_data->state = STATE_FPGA_LOADED;
+static int bladerf2_sync_get_ready_fd(struct bladerf *dev,
+                                      bladerf_direction dir,
+                                      bladerf_ready_fd *fd)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    CHECK_STATUS(_bladerf2_initialize(dev));
+    struct bladerf2_board_data *board_data = dev->board_data;
 
-    return 0;
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        RETURN_INVAL("direction", "is invalid");
+    }
+
+    if (!board_data->sync[dir].initialized) {
+        RETURN_INVAL("sync", "not initialized");
+    }
+
+    return sync_get_ready_fd(&board_data->sync[dir], fd);
 }
 
-static int bladerf2_flash_fpga(struct bladerf *dev,
-                               uint8_t const *buf,
-                               size_t length)
+static int bladerf2_sync_tx_multi(struct bladerf *dev,
+                                  const void *const *bufs,
+                                  unsigned int num_samples,
+                                  struct bladerf_metadata *metadata,
+                                  unsigned int timeout_ms)
 {
-    CHECK_BOARD_STATE(STATE_FIRMWARE_LOADED);
-    NULL_CHECK(buf);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
 
     struct bladerf2_board_data *board_data = dev->board_data;
 
-    if (!is_valid_fpga_size(dev, board_data->fpga_size, length)) {
-        RETURN_INVAL("fpga file", "incorrect file size");
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        RETURN_INVAL("sync tx", "not initialized");
     }
 
-    return spi_flash_write_fpga_bitstream(dev, buf, length);
+    return sync_tx_multi(&board_data->sync[BLADERF_TX], bufs, num_samples,
+                         metadata, timeout_ms);
 }
 
-static int bladerf2_erase_stored_fpga(struct bladerf *dev)
+static int bladerf2_sync_rx_multi(struct bladerf *dev,
+                                  void *const *bufs,
+                                  unsigned int num_samples,
+                                  struct bladerf_metadata *metadata,
+                                  unsigned int timeout_ms)
 {
-    CHECK_BOARD_STATE(STATE_FIRMWARE_LOADED);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-    return spi_flash_erase_fpga(dev);
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        RETURN_INVAL("sync rx", "not initialized");
+    }
+
+    return sync_rx_multi(&board_data->sync[BLADERF_RX], bufs, num_samples,
+                         metadata, timeout_ms);
+}
+
+static int bladerf2_sync_rx_packets(struct bladerf *dev,
+                                    struct bladerf_packet *packets,
+                                    unsigned int num_packets,
+                                    unsigned int *num_received,
+                                    unsigned int timeout_ms)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        RETURN_INVAL("sync rx", "not initialized");
+    }
+
+    return sync_rx_packets(&board_data->sync[BLADERF_RX], packets,
+                           num_packets, num_received, timeout_ms);
+}
+
+static int bladerf2_sync_tx_packets(struct bladerf *dev,
+                                    const struct bladerf_packet *packets,
+                                    unsigned int num_packets,
+                                    unsigned int *num_sent,
+                                    unsigned int timeout_ms)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        RETURN_INVAL("sync tx", "not initialized");
+    }
+
+    return sync_tx_packets(&board_data->sync[BLADERF_TX], packets,
+                           num_packets, num_sent, timeout_ms);
+}
+
+static int bladerf2_sync_create_tx_template(struct bladerf *dev,
+                                           const void *samples,
+                                           unsigned int num_samples,
+                                           struct bladerf_tx_template **tmpl)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        RETURN_INVAL("sync tx", "not initialized");
+    }
+
+    return sync_tx_template_create(&board_data->sync[BLADERF_TX], samples,
+                                   num_samples, tmpl);
+}
+
+static int bladerf2_sync_tx_template(struct bladerf *dev,
+                                    struct bladerf_tx_template *tmpl,
+                                    bladerf_timestamp timestamp,
+                                    unsigned int timeout_ms)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        RETURN_INVAL("sync tx", "not initialized");
+    }
+
+    return sync_tx_template(&board_data->sync[BLADERF_TX], tmpl, timestamp,
+                            timeout_ms);
+}
+
+static int bladerf2_sync_free_tx_template(struct bladerf *dev,
+                                         struct bladerf_tx_template *tmpl)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        RETURN_INVAL("sync tx", "not initialized");
+    }
+
+    return sync_tx_template_free(&board_data->sync[BLADERF_TX], tmpl);
+}
+
+static int bladerf2_sync_rx_acquire(struct bladerf *dev,
+                                    void **buffer,
+                                    unsigned int *num_samples,
+                                    struct bladerf_metadata *metadata,
+                                    unsigned int timeout_ms)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        RETURN_INVAL("sync rx", "not initialized");
+    }
+
+    return sync_rx_acquire(&board_data->sync[BLADERF_RX], buffer, num_samples,
+                           metadata, timeout_ms);
+}
+
+static int bladerf2_sync_rx_release(struct bladerf *dev, void *buffer)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_RX].initialized) {
+        RETURN_INVAL("sync rx", "not initialized");
+    }
+
+    return sync_rx_release(&board_data->sync[BLADERF_RX], buffer);
+}
+
+static int bladerf2_sync_prearm(struct bladerf *dev, bladerf_direction dir)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (dir != BLADERF_RX && dir != BLADERF_TX) {
+        RETURN_INVAL("direction", "is invalid");
+    }
+
+    if (!board_data->sync[dir].initialized) {
+        RETURN_INVAL("sync", "not initialized");
+    }
+
+    return sync_prearm(&board_data->sync[dir]);
+}
+
+static int bladerf2_sync_tx_acquire(struct bladerf *dev,
+                                    void **buffer,
+                                    unsigned int *num_samples,
+                                    unsigned int timeout_ms)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        RETURN_INVAL("sync tx", "not initialized");
+    }
+
+    return sync_tx_acquire(&board_data->sync[BLADERF_TX], buffer, num_samples,
+                           timeout_ms);
+}
+
+static int bladerf2_sync_tx_submit(struct bladerf *dev,
+                                   void *buffer,
+                                   unsigned int num_samples)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        RETURN_INVAL("sync tx", "not initialized");
+    }
+
+    return sync_tx_submit(&board_data->sync[BLADERF_TX], buffer, num_samples);
+}
+
+static int bladerf2_sync_tx_reserve(struct bladerf *dev,
+                                    void **buffer,
+                                    unsigned int *num_samples,
+                                    uint64_t *position,
+                                    unsigned int timeout_ms)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->sync[BLADERF_TX].initialized) {
+        RETURN_INVAL("sync tx", "not initialized");
+    }
+
+    return sync_tx_reserve(&board_data->sync[BLADERF_TX], buffer, num_samples,
+                           position, timeout_ms);
+}
+
+static int bladerf2_get_timestamp(struct bladerf *dev,
+                                  bladerf_direction dir,
+                                  bladerf_timestamp *value)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(value);
+
+    return dev->backend->get_timestamp(dev, dir, value);
+}
+
+
+/******************************************************************************/
+/* FPGA/Firmware Loading/Flashing */
+/******************************************************************************/
+
+static int bladerf2_load_fpga(struct bladerf *dev, struct fpga_image *image)
+{
+    CHECK_BOARD_STATE(STATE_FIRMWARE_LOADED);
+    NULL_CHECK(image);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!is_valid_fpga_size(dev, board_data->fpga_size, image->size)) {
+        RETURN_INVAL("fpga file", "incorrect file size");
+    }
+
+    CHECK_STATUS(dev->backend->load_fpga(dev, image));
+
+    /* Update device state */
+    board_data->state            = STATE_FPGA_LOADED;
+    board_data->rfic_wq_capacity = 0;
+    board_data->rfic_wq_pending  = false;
+
+    CHECK_STATUS(_bladerf2_initialize(dev, false));
+
+    return 0;
+}
+
+static int bladerf2_flash_fpga(struct bladerf *dev,
+                               uint8_t const *buf,
+                               size_t length)
+{
+    CHECK_BOARD_STATE(STATE_FIRMWARE_LOADED);
+    NULL_CHECK(buf);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!is_valid_fpga_size(dev, board_data->fpga_size, length)) {
+        RETURN_INVAL("fpga file", "incorrect file size");
+    }
+
+    return spi_flash_write_fpga_bitstream(dev, buf, length);
+}
+
+static int bladerf2_erase_stored_fpga(struct bladerf *dev)
+{
+    CHECK_BOARD_STATE(STATE_FIRMWARE_LOADED);
+
+    return spi_flash_erase_fpga(dev);
 }
 
 static int bladerf2_flash_firmware(struct bladerf *dev,
@@ -2584,95 +3521,467 @@ static int bladerf2_get_rx_mux(struct bladerf *dev, bladerf_rx_mux *mode)
 
 
 /******************************************************************************/
-/* Low-level VCTCXO Tamer Mode */
+/* RX FPGA decimation */
 /******************************************************************************/
 
-static int bladerf2_set_vctcxo_tamer_mode(struct bladerf *dev,
-                                          bladerf_vctcxo_tamer_mode mode)
-{
-    return BLADERF_ERR_UNSUPPORTED;
-}
-
-static int bladerf2_get_vctcxo_tamer_mode(struct bladerf *dev,
-                                          bladerf_vctcxo_tamer_mode *mode)
+/* RX decimation control register: [18:16] log2 of the decimation factor,
+ * [15:0] signed NCO phase step per sample, where 8192 is one full cycle. */
+#define RX_DECIM_LOG2_SHIFT 16
+#define RX_DECIM_LOG2_MASK (0x7 << RX_DECIM_LOG2_SHIFT)
+#define RX_DECIM_DPHASE_MASK 0xffff
+#define RX_DECIM_MAX_LOG2 6
+#define RX_DECIM_NCO_CYCLE 8192
+
+static int bladerf2_set_rx_decimation(struct bladerf *dev,
+                                      unsigned int decimation,
+                                      int32_t nco_offset)
 {
-    return BLADERF_ERR_UNSUPPORTED;
-}
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
 
+    struct bladerf2_board_data *board_data = dev->board_data;
+    bladerf_sample_rate rate;
+    unsigned int log2_rate;
+    int64_t scaled;
+    int32_t dphase;
+    uint32_t reg;
 
-/******************************************************************************/
-/* Low-level VCTCXO Trim DAC access */
-/******************************************************************************/
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RX_DECIMATION)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "RX decimation.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
 
-static int _bladerf2_get_trim_dac_enable(struct bladerf *dev, bool *enable)
-{
-    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
-    NULL_CHECK(enable);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
 
-    uint16_t trim;
+    for (log2_rate = 0; log2_rate <= RX_DECIM_MAX_LOG2; ++log2_rate) {
+        if (decimation == (1u << log2_rate)) {
+            break;
+        }
+    }
 
-    // Read current trim DAC setting
-    CHECK_STATUS(dev->backend->ad56x1_vctcxo_trim_dac_read(dev, &trim));
+    if (log2_rate > RX_DECIM_MAX_LOG2) {
+        RETURN_INVAL_ARG("decimation", decimation,
+                         "must be a power of two from 1 to 64");
+    }
 
-    // Determine if it's enabled...
-    *enable = (TRIMDAC_EN_ACTIVE == (trim >> TRIMDAC_EN));
+    CHECK_STATUS(dev->board->get_sample_rate(dev, BLADERF_CHANNEL_RX(0),
+                                             &rate));
 
-    log_debug("trim DAC is %s\n", (*enable ? "enabled" : "disabled"));
+    scaled = (nco_offset < 0) ? -(int64_t)nco_offset : nco_offset;
+    if ((uint64_t)scaled * 2 > rate) {
+        RETURN_INVAL_ARG("nco offset", nco_offset,
+                         "exceeds half the sample rate");
+    }
 
-    if ((trim >> TRIMDAC_EN) != TRIMDAC_EN_ACTIVE &&
-        (trim >> TRIMDAC_EN) != TRIMDAC_EN_HIGHZ) {
-        log_warning("unknown trim DAC state: 0x%x\n", (trim >> TRIMDAC_EN));
+    /* Round to the nearest NCO step */
+    scaled = (int64_t)nco_offset * RX_DECIM_NCO_CYCLE;
+    if (scaled >= 0) {
+        dphase = (int32_t)((scaled + rate / 2) / rate);
+    } else {
+        dphase = (int32_t)((scaled - (int64_t)(rate / 2)) / rate);
     }
 
+    reg = (log2_rate << RX_DECIM_LOG2_SHIFT) |
+          ((uint32_t)dphase & RX_DECIM_DPHASE_MASK);
+
+    log_debug("%s: decimation %u, NCO step %d (reg 0x%08x)\n", __FUNCTION__,
+              decimation, dphase, reg);
+
+    CHECK_STATUS(dev->backend->rx_decim_write(dev, reg));
+
     return 0;
 }
 
-static int _bladerf2_set_trim_dac_enable(struct bladerf *dev, bool enable)
+static int bladerf2_get_rx_decimation(struct bladerf *dev,
+                                      unsigned int *decimation,
+                                      int32_t *nco_offset)
 {
-    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(decimation);
+    NULL_CHECK(nco_offset);
 
     struct bladerf2_board_data *board_data = dev->board_data;
-    uint16_t trim;
-    bool current_state;
-
-    // See if we have anything to do
-    CHECK_STATUS(_bladerf2_get_trim_dac_enable(dev, &current_state));
+    bladerf_sample_rate rate;
+    unsigned int log2_rate;
+    int16_t dphase;
+    uint32_t reg;
 
-    if (enable == current_state) {
-        log_debug("trim DAC already %s, nothing to do\n",
-                  enable ? "enabled" : "disabled");
-        return 0;
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RX_DECIMATION)) {
+        return BLADERF_ERR_UNSUPPORTED;
     }
 
-    // Read current trim DAC setting
-    CHECK_STATUS(dev->backend->ad56x1_vctcxo_trim_dac_read(dev, &trim));
+    CHECK_STATUS(dev->backend->rx_decim_read(dev, &reg));
+    CHECK_STATUS(dev->board->get_sample_rate(dev, BLADERF_CHANNEL_RX(0),
+                                             &rate));
 
-    // Set the trim DAC to high z if applicable
-    if (!enable && trim != (TRIMDAC_EN_HIGHZ << TRIMDAC_EN)) {
-        board_data->trimdac_last_value = trim;
-        log_debug("saving current trim DAC value: 0x%04x\n", trim);
-        trim = TRIMDAC_EN_HIGHZ << TRIMDAC_EN;
-    } else if (enable && trim == (TRIMDAC_EN_HIGHZ << TRIMDAC_EN)) {
-        trim = board_data->trimdac_last_value;
-        log_debug("restoring old trim DAC value: 0x%04x\n", trim);
+    log2_rate = (reg & RX_DECIM_LOG2_MASK) >> RX_DECIM_LOG2_SHIFT;
+    if (log2_rate > RX_DECIM_MAX_LOG2) {
+        log_debug("Invalid decimation %u read from FPGA\n", log2_rate);
+        return BLADERF_ERR_UNEXPECTED;
     }
 
-    // Write back the trim DAC setting
-    CHECK_STATUS(dev->backend->ad56x1_vctcxo_trim_dac_write(dev, trim));
+    dphase = (int16_t)(reg & RX_DECIM_DPHASE_MASK);
 
-    // Update our state flag
-    board_data->trim_source = enable ? TRIM_SOURCE_TRIM_DAC : TRIM_SOURCE_NONE;
+    *decimation = 1u << log2_rate;
+    *nco_offset = (int32_t)(((int64_t)dphase * rate) / RX_DECIM_NCO_CYCLE);
 
     return 0;
 }
 
-/**
- * @brief      Read the VCTCXO trim value from the SPI flash
- *
- * Retrieves the factory VCTCXO value from the SPI flash. This function
- * should not be used while sample streaming is in progress.
- *
- * @param      dev   Device handle
+
+/******************************************************************************/
+/* TX waveform playback */
+/******************************************************************************/
+
+/* The waveform player sits on the Wishbone bus. Byte addresses: */
+#define TX_WAVE_CONTROL 0x00000
+#define TX_WAVE_LENGTH 0x00004
+#define TX_WAVE_RAM 0x10000
+
+/* Control register: [0] loop enable, [10:8] log2 of the interpolation */
+#define TX_WAVE_CONTROL_ENABLE 0x1
+#define TX_WAVE_CONTROL_LOG2_SHIFT 8
+#define TX_WAVE_MAX_LOG2 6
+
+static int _bladerf2_tx_waveform_check(struct bladerf *dev)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_TX_WAVEFORM)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "TX waveform playback.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return 0;
+}
+
+static int bladerf2_tx_load_waveform(struct bladerf *dev,
+                                     const int16_t *samples,
+                                     unsigned int num_samples)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(samples);
+
+    unsigned int i;
+    uint32_t word;
+
+    CHECK_STATUS(_bladerf2_tx_waveform_check(dev));
+
+    if (num_samples < 1 || num_samples > BLADERF_TX_WAVEFORM_MAX_SAMPLES) {
+        RETURN_INVAL_ARG("number of samples", num_samples,
+                         "must be between 1 and 4096");
+    }
+
+    CHECK_STATUS(dev->backend->wishbone_master_write(dev, TX_WAVE_CONTROL, 0));
+
+    for (i = 0; i < num_samples; ++i) {
+        word = ((uint32_t)(uint16_t)samples[2 * i + 1] << 16) |
+               (uint16_t)samples[2 * i];
+
+        CHECK_STATUS(dev->backend->wishbone_master_write(
+            dev, TX_WAVE_RAM + 4 * i, word));
+    }
+
+    CHECK_STATUS(dev->backend->wishbone_master_write(dev, TX_WAVE_LENGTH,
+                                                     num_samples));
+
+    return 0;
+}
+
+static int bladerf2_tx_loop_start(struct bladerf *dev,
+                                  unsigned int interpolation)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    unsigned int log2_interp;
+    uint32_t reg;
+
+    CHECK_STATUS(_bladerf2_tx_waveform_check(dev));
+
+    for (log2_interp = 0; log2_interp <= TX_WAVE_MAX_LOG2; ++log2_interp) {
+        if (interpolation == (1u << log2_interp)) {
+            break;
+        }
+    }
+
+    if (log2_interp > TX_WAVE_MAX_LOG2) {
+        RETURN_INVAL_ARG("interpolation", interpolation,
+                         "must be a power of two from 1 to 64");
+    }
+
+    /* Restart from the top of the waveform if a loop is already running */
+    CHECK_STATUS(dev->backend->wishbone_master_write(dev, TX_WAVE_CONTROL, 0));
+
+    reg = (log2_interp << TX_WAVE_CONTROL_LOG2_SHIFT) | TX_WAVE_CONTROL_ENABLE;
+
+    CHECK_STATUS(dev->backend->wishbone_master_write(dev, TX_WAVE_CONTROL, reg));
+
+    return 0;
+}
+
+static int bladerf2_tx_loop_stop(struct bladerf *dev)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    CHECK_STATUS(_bladerf2_tx_waveform_check(dev));
+
+    CHECK_STATUS(dev->backend->wishbone_master_write(dev, TX_WAVE_CONTROL, 0));
+
+    return 0;
+}
+
+
+/******************************************************************************/
+/* RX power measurement */
+/******************************************************************************/
+
+static int _bladerf2_rx_power_check(struct bladerf *dev, bladerf_channel ch)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RX_POWER_METER)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "RX power measurement.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (BLADERF_CHANNEL_IS_TX(ch) || (ch >> 1) >= NUM_MODULES) {
+        RETURN_INVAL("channel", "must be an RX channel");
+    }
+
+    return 0;
+}
+
+static int bladerf2_measure_rx_power(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     unsigned int num_samples,
+                                     struct bladerf_rx_power *power)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(power);
+
+    bladerf_sample_rate rate;
+
+    CHECK_STATUS(_bladerf2_rx_power_check(dev, ch));
+
+    if (num_samples < 1 || num_samples > BLADERF_RX_POWER_MAX_SAMPLES) {
+        RETURN_INVAL_ARG("number of samples", num_samples,
+                         "must be between 1 and 2^24");
+    }
+
+    CHECK_STATUS(dev->board->get_sample_rate(dev, ch, &rate));
+
+    return rx_power_meter_measure(dev, ch >> 1, rate, num_samples, power);
+}
+
+static int bladerf2_rx_snapshot(struct bladerf *dev,
+                                bladerf_channel ch,
+                                int16_t *samples,
+                                unsigned int num_samples)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(samples);
+
+    bladerf_sample_rate rate;
+
+    CHECK_STATUS(_bladerf2_rx_power_check(dev, ch));
+
+    if (num_samples < 1 || num_samples > BLADERF_RX_SNAPSHOT_MAX_SAMPLES) {
+        RETURN_INVAL_ARG("number of samples", num_samples,
+                         "must be between 1 and 1024");
+    }
+
+    CHECK_STATUS(dev->board->get_sample_rate(dev, ch, &rate));
+
+    return rx_power_meter_snapshot(dev, ch >> 1, rate, samples, num_samples);
+}
+
+/******************************************************************************/
+/* Scheduled RX start */
+/******************************************************************************/
+
+static int _bladerf2_rx_gate_check(struct bladerf *dev)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RX_GATE)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "scheduling RX.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return 0;
+}
+
+static int bladerf2_schedule_rx(struct bladerf *dev,
+                                bladerf_timestamp timestamp,
+                                unsigned int num_samples)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    CHECK_STATUS(_bladerf2_rx_gate_check(dev));
+
+    return rx_gate_schedule(dev, timestamp, num_samples);
+}
+
+static int bladerf2_schedule_rx_bursts(struct bladerf *dev,
+                                       bladerf_timestamp timestamp,
+                                       unsigned int burst_len,
+                                       unsigned int period)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    unsigned int msg_samples;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FPGA_RX_BURSTS)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "RX bursts.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (burst_len == 0) {
+        RETURN_INVAL("burst length", "must be nonzero");
+    }
+
+    if (period < burst_len) {
+        RETURN_INVAL("period", "must be at least the burst length");
+    }
+
+    msg_samples = sync_rx_msg_samples(&board_data->sync[BLADERF_RX]);
+    if (msg_samples != 0 && burst_len % msg_samples != 0) {
+        RETURN_INVAL_ARG("burst length", burst_len,
+                         "must be a whole number of RX messages");
+    }
+
+    return rx_gate_schedule_bursts(dev, timestamp, burst_len, period);
+}
+
+static int bladerf2_cancel_rx_schedule(struct bladerf *dev)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    CHECK_STATUS(_bladerf2_rx_gate_check(dev));
+
+    return rx_gate_cancel(dev);
+}
+
+
+/******************************************************************************/
+/* Low-level VCTCXO Tamer Mode */
+/******************************************************************************/
+
+static int bladerf2_set_vctcxo_tamer_mode(struct bladerf *dev,
+                                          bladerf_vctcxo_tamer_mode mode)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int bladerf2_get_vctcxo_tamer_mode(struct bladerf *dev,
+                                          bladerf_vctcxo_tamer_mode *mode)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int bladerf2_get_vctcxo_tamer_status(
+    struct bladerf *dev, struct bladerf_vctcxo_tamer_status *status)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+
+/******************************************************************************/
+/* Low-level VCTCXO Trim DAC access */
+/******************************************************************************/
+
+static int _bladerf2_get_trim_dac_enable(struct bladerf *dev, bool *enable)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+    NULL_CHECK(enable);
+
+    uint16_t trim;
+
+    // Read current trim DAC setting
+    CHECK_STATUS(dev->backend->ad56x1_vctcxo_trim_dac_read(dev, &trim));
+
+    // Determine if it's enabled...
+    *enable = (TRIMDAC_EN_ACTIVE == (trim >> TRIMDAC_EN));
+
+    log_debug("trim DAC is %s\n", (*enable ? "enabled" : "disabled"));
+
+    if ((trim >> TRIMDAC_EN) != TRIMDAC_EN_ACTIVE &&
+        (trim >> TRIMDAC_EN) != TRIMDAC_EN_HIGHZ) {
+        log_warning("unknown trim DAC state: 0x%x\n", (trim >> TRIMDAC_EN));
+    }
+
+    return 0;
+}
+
+static int _bladerf2_set_trim_dac_enable(struct bladerf *dev, bool enable)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    uint16_t trim;
+    bool current_state;
+
+    // See if we have anything to do
+    CHECK_STATUS(_bladerf2_get_trim_dac_enable(dev, &current_state));
+
+    if (enable == current_state) {
+        log_debug("trim DAC already %s, nothing to do\n",
+                  enable ? "enabled" : "disabled");
+        return 0;
+    }
+
+    // Read current trim DAC setting
+    CHECK_STATUS(dev->backend->ad56x1_vctcxo_trim_dac_read(dev, &trim));
+
+    // Set the trim DAC to high z if applicable
+    if (!enable && trim != (TRIMDAC_EN_HIGHZ << TRIMDAC_EN)) {
+        board_data->trimdac_last_value = trim;
+        log_debug("saving current trim DAC value: 0x%04x\n", trim);
+        trim = TRIMDAC_EN_HIGHZ << TRIMDAC_EN;
+    } else if (enable && trim == (TRIMDAC_EN_HIGHZ << TRIMDAC_EN)) {
+        trim = board_data->trimdac_last_value;
+        log_debug("restoring old trim DAC value: 0x%04x\n", trim);
+    }
+
+    // Write back the trim DAC setting
+    CHECK_STATUS(dev->backend->ad56x1_vctcxo_trim_dac_write(dev, trim));
+
+    // Update our state flag
+    board_data->trim_source = enable ? TRIM_SOURCE_TRIM_DAC : TRIM_SOURCE_NONE;
+
+    return 0;
+}
+
+/**
+ * @brief      Read the VCTCXO trim value from the SPI flash
+ *
+ * Retrieves the factory VCTCXO value from the SPI flash. This function
+ * should not be used while sample streaming is in progress.
+ *
+ * @param      dev   Device handle
  * @param      trim  Pointer to populate with the trim value
  *
  * @return     0 on success, value from \ref RETCODES list on failure
@@ -2789,237 +4098,932 @@ static int bladerf2_wishbone_master_write(struct bladerf *dev, uint32_t addr, ui
 }
 
 
-/******************************************************************************/
-/* Low-level Configuration GPIO access */
-/******************************************************************************/
+/******************************************************************************/
+/* Low-level Configuration GPIO access */
+/******************************************************************************/
+
+static int bladerf2_config_gpio_read(struct bladerf *dev, uint32_t *val)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+    NULL_CHECK(val);
+
+    return dev->backend->config_gpio_read(dev, val);
+}
+
+static int bladerf2_config_gpio_write(struct bladerf *dev, uint32_t val)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    return dev->backend->config_gpio_write(dev, val);
+}
+
+/******************************************************************************/
+/* Control request batching */
+/******************************************************************************/
+
+static int bladerf2_batch_begin(struct bladerf *dev)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    CHECK_STATUS(dev->backend->batch_begin(dev));
+
+    board_data->batch_depth++;
+
+    return 0;
+}
+
+static int bladerf2_batch_commit(struct bladerf *dev)
+{
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct controller_fns const *rfic      = board_data->rfic;
+    int status;
+
+    status = dev->backend->batch_commit(dev);
+
+    /* No scope was active */
+    if (board_data->batch_depth == 0) {
+        return status;
+    }
+
+    board_data->batch_depth--;
+
+    /* Wait for any RFIC commands left running in the FPGA */
+    if (board_data->batch_depth == 0 && rfic->wait_pending != NULL) {
+        int wait_status = rfic->wait_pending(dev);
+
+        if (status == 0) {
+            status = wait_status;
+        }
+    }
+
+    return status;
+}
+
+
+/******************************************************************************/
+/* Low-level SPI Flash access */
+/******************************************************************************/
+
+static int bladerf2_erase_flash(struct bladerf *dev,
+                                uint32_t erase_block,
+                                uint32_t count)
+{
+    CHECK_BOARD_STATE(STATE_FIRMWARE_LOADED);
+
+    _bladerf2_warm_state_invalidate(dev);
+
+    return spi_flash_erase(dev, erase_block, count);
+}
+
+static int bladerf2_read_flash(struct bladerf *dev,
+                               uint8_t *buf,
+                               uint32_t page,
+                               uint32_t count)
+{
+    CHECK_BOARD_STATE(STATE_FIRMWARE_LOADED);
+    NULL_CHECK(buf);
+
+    return spi_flash_read(dev, buf, page, count);
+}
+
+static int bladerf2_write_flash(struct bladerf *dev,
+                                uint8_t const *buf,
+                                uint32_t page,
+                                uint32_t count)
+{
+    CHECK_BOARD_STATE(STATE_FIRMWARE_LOADED);
+    NULL_CHECK(buf);
+
+    _bladerf2_warm_state_invalidate(dev);
+
+    return spi_flash_write(dev, buf, page, count);
+}
+
+
+/******************************************************************************/
+/* Expansion support */
+/******************************************************************************/
+
+static int bladerf2_expansion_attach(struct bladerf *dev, bladerf_xb xb)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+static int bladerf2_expansion_get_attached(struct bladerf *dev, bladerf_xb *xb)
+{
+    NULL_CHECK(xb);
+
+    *xb = BLADERF_XB_NONE;
+
+    return 0;
+}
+
+
+/******************************************************************************/
+/* Board binding */
+/******************************************************************************/
+
+struct board_fns const bladerf2_board_fns = {
+    FIELD_INIT(.matches, bladerf2_matches),
+    FIELD_INIT(.open, bladerf2_open),
+    FIELD_INIT(.close, bladerf2_close),
+    FIELD_INIT(.device_speed, bladerf2_device_speed),
+    FIELD_INIT(.get_serial, bladerf2_get_serial),
+    FIELD_INIT(.get_fpga_size, bladerf2_get_fpga_size),
+    FIELD_INIT(.get_fpga_bytes, bladerf2_get_fpga_bytes),
+    FIELD_INIT(.get_flash_size, bladerf2_get_flash_size),
+    FIELD_INIT(.is_fpga_configured, bladerf2_is_fpga_configured),
+    FIELD_INIT(.get_fpga_source, bladerf2_get_fpga_source),
+    FIELD_INIT(.get_capabilities, bladerf2_get_capabilities),
+    FIELD_INIT(.get_channel_count, bladerf2_get_channel_count),
+    FIELD_INIT(.get_fpga_version, bladerf2_get_fpga_version),
+    FIELD_INIT(.get_fw_version, bladerf2_get_fw_version),
+    FIELD_INIT(.set_gain, bladerf2_set_gain),
+    FIELD_INIT(.get_gain, bladerf2_get_gain),
+    FIELD_INIT(.set_gain_mode, bladerf2_set_gain_mode),
+    FIELD_INIT(.get_gain_mode, bladerf2_get_gain_mode),
+    FIELD_INIT(.get_gain_modes, bladerf2_get_gain_modes),
+    FIELD_INIT(.get_gain_range, bladerf2_get_gain_range),
+    FIELD_INIT(.set_gain_stage, bladerf2_set_gain_stage),
+    FIELD_INIT(.get_gain_stage, bladerf2_get_gain_stage),
+    FIELD_INIT(.get_gain_stage_range, bladerf2_get_gain_stage_range),
+    FIELD_INIT(.get_gain_stages, bladerf2_get_gain_stages),
+    FIELD_INIT(.set_sample_rate, bladerf2_set_sample_rate),
+    FIELD_INIT(.set_rational_sample_rate, bladerf2_set_rational_sample_rate),
+    FIELD_INIT(.get_sample_rate, bladerf2_get_sample_rate),
+    FIELD_INIT(.get_sample_rate_range, bladerf2_get_sample_rate_range),
+    FIELD_INIT(.get_rational_sample_rate, bladerf2_get_rational_sample_rate),
+    FIELD_INIT(.set_bandwidth, bladerf2_set_bandwidth),
+    FIELD_INIT(.get_bandwidth, bladerf2_get_bandwidth),
+    FIELD_INIT(.get_bandwidth_range, bladerf2_get_bandwidth_range),
+    FIELD_INIT(.get_frequency, bladerf2_get_frequency),
+    FIELD_INIT(.set_frequency, bladerf2_set_frequency),
+    FIELD_INIT(.set_frequency_begin, bladerf2_set_frequency_begin),
+    FIELD_INIT(.get_pll_lock, bladerf2_get_pll_lock),
+    FIELD_INIT(.get_frequency_range, bladerf2_get_frequency_range),
+    FIELD_INIT(.select_band, bladerf2_select_band),
+    FIELD_INIT(.set_rf_port, bladerf2_set_rf_port),
+    FIELD_INIT(.get_rf_port, bladerf2_get_rf_port),
+    FIELD_INIT(.get_rf_ports, bladerf2_get_rf_ports),
+    FIELD_INIT(.get_quick_tune, bladerf2_get_quick_tune),
+    FIELD_INIT(.update_quick_tune, bladerf2_update_quick_tune),
+    FIELD_INIT(.schedule_retune, bladerf2_schedule_retune),
+    FIELD_INIT(.cancel_scheduled_retunes, bladerf2_cancel_scheduled_retunes),
+    FIELD_INIT(.cancel_scheduled_retunes_range,
+               bladerf2_cancel_scheduled_retunes_range),
+    FIELD_INIT(.get_retune_queue_status, bladerf2_get_retune_queue_status),
+    FIELD_INIT(.schedule_write, bladerf2_schedule_write),
+    FIELD_INIT(.get_rfic_temperature, bladerf2_get_rfic_temperature),
+    FIELD_INIT(.get_correction, bladerf2_get_correction),
+    FIELD_INIT(.set_correction, bladerf2_set_correction),
+    FIELD_INIT(.trigger_init, bladerf2_trigger_init),
+    FIELD_INIT(.trigger_arm, bladerf2_trigger_arm),
+    FIELD_INIT(.trigger_fire, bladerf2_trigger_fire),
+    FIELD_INIT(.trigger_state, bladerf2_trigger_state),
+    FIELD_INIT(.get_trigger_time, bladerf2_get_trigger_time),
+    FIELD_INIT(.enable_module, bladerf2_enable_module),
+    FIELD_INIT(.init_stream, bladerf2_init_stream),
+    FIELD_INIT(.stream, bladerf2_stream),
+    FIELD_INIT(.submit_stream_buffer, bladerf2_submit_stream_buffer),
+    FIELD_INIT(.deinit_stream, bladerf2_deinit_stream),
+    FIELD_INIT(.set_stream_timeout, bladerf2_set_stream_timeout),
+    FIELD_INIT(.get_stream_timeout, bladerf2_get_stream_timeout),
+    FIELD_INIT(.set_sync_wait_policy, bladerf2_set_sync_wait_policy),
+    FIELD_INIT(.get_stream_stats, bladerf2_get_stream_stats),
+    FIELD_INIT(.set_sync_thread_attrs, bladerf2_set_sync_thread_attrs),
+    FIELD_INIT(.set_sync_buffer_allocator, bladerf2_set_sync_buffer_allocator),
+    FIELD_INIT(.set_sync_rx_pool, bladerf2_set_sync_rx_pool),
+    FIELD_INIT(.set_sync_tx_pool, bladerf2_set_sync_tx_pool),
+    FIELD_INIT(.set_sync_rx_stats, bladerf2_set_sync_rx_stats),
+    FIELD_INIT(.get_sync_rx_stats, bladerf2_get_sync_rx_stats),
+    FIELD_INIT(.set_sync_rx_tap, bladerf2_set_sync_rx_tap),
+    FIELD_INIT(.set_sync_rx_meta_msg_size, bladerf2_set_sync_rx_meta_msg_size),
+    FIELD_INIT(.get_sync_rx_meta_msg_size, bladerf2_get_sync_rx_meta_msg_size),
+    FIELD_INIT(.sync_config, bladerf2_sync_config),
+    FIELD_INIT(.sync_tx, bladerf2_sync_tx),
+    FIELD_INIT(.sync_rx, bladerf2_sync_rx),
+    FIELD_INIT(.sync_tx_nb, bladerf2_sync_tx_nb),
+    FIELD_INIT(.sync_rx_nb, bladerf2_sync_rx_nb),
+    FIELD_INIT(.sync_get_ready_fd, bladerf2_sync_get_ready_fd),
+    FIELD_INIT(.sync_rx_acquire, bladerf2_sync_rx_acquire),
+    FIELD_INIT(.sync_rx_release, bladerf2_sync_rx_release),
+    FIELD_INIT(.sync_prearm, bladerf2_sync_prearm),
+    FIELD_INIT(.sync_tx_acquire, bladerf2_sync_tx_acquire),
+    FIELD_INIT(.sync_tx_submit, bladerf2_sync_tx_submit),
+    FIELD_INIT(.sync_tx_reserve, bladerf2_sync_tx_reserve),
+    FIELD_INIT(.sync_tx_multi, bladerf2_sync_tx_multi),
+    FIELD_INIT(.sync_rx_multi, bladerf2_sync_rx_multi),
+    FIELD_INIT(.sync_rx_packets, bladerf2_sync_rx_packets),
+    FIELD_INIT(.sync_tx_packets, bladerf2_sync_tx_packets),
+    FIELD_INIT(.sync_create_tx_template, bladerf2_sync_create_tx_template),
+    FIELD_INIT(.sync_tx_template, bladerf2_sync_tx_template),
+    FIELD_INIT(.sync_free_tx_template, bladerf2_sync_free_tx_template),
+    FIELD_INIT(.get_timestamp, bladerf2_get_timestamp),
+    FIELD_INIT(.load_fpga, bladerf2_load_fpga),
+    FIELD_INIT(.flash_fpga, bladerf2_flash_fpga),
+    FIELD_INIT(.erase_stored_fpga, bladerf2_erase_stored_fpga),
+    FIELD_INIT(.flash_firmware, bladerf2_flash_firmware),
+    FIELD_INIT(.device_reset, bladerf2_device_reset),
+    FIELD_INIT(.set_tuning_mode, bladerf2_set_tuning_mode),
+    FIELD_INIT(.get_tuning_mode, bladerf2_get_tuning_mode),
+    FIELD_INIT(.get_loopback_modes, bladerf2_get_loopback_modes),
+    FIELD_INIT(.set_loopback, bladerf2_set_loopback),
+    FIELD_INIT(.get_loopback, bladerf2_get_loopback),
+    FIELD_INIT(.get_rx_mux, bladerf2_get_rx_mux),
+    FIELD_INIT(.set_rx_mux, bladerf2_set_rx_mux),
+    FIELD_INIT(.set_rx_decimation, bladerf2_set_rx_decimation),
+    FIELD_INIT(.get_rx_decimation, bladerf2_get_rx_decimation),
+    FIELD_INIT(.tx_load_waveform, bladerf2_tx_load_waveform),
+    FIELD_INIT(.tx_loop_start, bladerf2_tx_loop_start),
+    FIELD_INIT(.tx_loop_stop, bladerf2_tx_loop_stop),
+    FIELD_INIT(.measure_rx_power, bladerf2_measure_rx_power),
+    FIELD_INIT(.rx_snapshot, bladerf2_rx_snapshot),
+    FIELD_INIT(.schedule_rx, bladerf2_schedule_rx),
+    FIELD_INIT(.schedule_rx_bursts, bladerf2_schedule_rx_bursts),
+    FIELD_INIT(.cancel_rx_schedule, bladerf2_cancel_rx_schedule),
+    FIELD_INIT(.set_vctcxo_tamer_mode, bladerf2_set_vctcxo_tamer_mode),
+    FIELD_INIT(.get_vctcxo_tamer_mode, bladerf2_get_vctcxo_tamer_mode),
+    FIELD_INIT(.get_vctcxo_tamer_status, bladerf2_get_vctcxo_tamer_status),
+    FIELD_INIT(.get_vctcxo_trim, bladerf2_get_vctcxo_trim),
+    FIELD_INIT(.trim_dac_read, bladerf2_trim_dac_read),
+    FIELD_INIT(.trim_dac_write, bladerf2_trim_dac_write),
+    FIELD_INIT(.read_trigger, bladerf2_read_trigger),
+    FIELD_INIT(.write_trigger, bladerf2_write_trigger),
+    FIELD_INIT(.wishbone_master_read, bladerf2_wishbone_master_read),
+    FIELD_INIT(.wishbone_master_write, bladerf2_wishbone_master_write),
+    FIELD_INIT(.config_gpio_read, bladerf2_config_gpio_read),
+    FIELD_INIT(.config_gpio_write, bladerf2_config_gpio_write),
+    FIELD_INIT(.batch_begin, bladerf2_batch_begin),
+    FIELD_INIT(.batch_commit, bladerf2_batch_commit),
+    FIELD_INIT(.erase_flash, bladerf2_erase_flash),
+    FIELD_INIT(.read_flash, bladerf2_read_flash),
+    FIELD_INIT(.write_flash, bladerf2_write_flash),
+    FIELD_INIT(.expansion_attach, bladerf2_expansion_attach),
+    FIELD_INIT(.expansion_get_attached, bladerf2_expansion_get_attached),
+    FIELD_INIT(.name, "bladerf2"),
+};
+
+
+/******************************************************************************
+ ******************************************************************************
+ *                         bladeRF2-specific Functions *
+ ******************************************************************************
+ ******************************************************************************/
+
+/******************************************************************************/
+/* Bias Tee Control */
+/******************************************************************************/
+
+int bladerf_get_bias_tee(struct bladerf *dev, bladerf_channel ch, bool *enable)
+{
+    CHECK_BOARD_IS_BLADERF2(dev);
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+    NULL_CHECK(enable);
+
+    WITH_MUTEX(&dev->lock, {
+        uint32_t reg;
+        uint32_t shift;
+
+        shift = BLADERF_CHANNEL_IS_TX(ch) ? RFFE_CONTROL_TX_BIAS_EN
+                                          : RFFE_CONTROL_RX_BIAS_EN;
+
+        /* Read RFFE control register */
+        CHECK_STATUS_LOCKED(dev->backend->rffe_control_read(dev, &reg));
+
+        /* Check register value */
+        *enable = (reg >> shift) & 0x1;
+    });
+
+    return 0;
+}
+
+int bladerf_set_bias_tee(struct bladerf *dev, bladerf_channel ch, bool enable)
+{
+    CHECK_BOARD_IS_BLADERF2(dev);
+    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+
+    WITH_MUTEX(&dev->lock, {
+        uint32_t reg;
+        uint32_t shift;
+
+        shift = BLADERF_CHANNEL_IS_TX(ch) ? RFFE_CONTROL_TX_BIAS_EN
+                                          : RFFE_CONTROL_RX_BIAS_EN;
+
+        /* Read RFFE control register */
+        CHECK_STATUS_LOCKED(dev->backend->rffe_control_read(dev, &reg));
+
+        /* Clear register value */
+        reg &= ~(1 << shift);
+
+        /* Set register value */
+        if (enable) {
+            reg |= (1 << shift);
+        }
+
+        /* Write RFFE control register */
+        log_debug("%s: rffe_control_write %08x\n", __FUNCTION__, reg);
+        CHECK_STATUS_LOCKED(dev->backend->rffe_control_write(dev, reg));
+    });
+
+    return 0;
+}
+
+
+/******************************************************************************/
+/* Fast lock profile store */
+/******************************************************************************/
+
+/* Number of Nios fast lock slots reserved for each direction's store, out of
+ * those otherwise handed out by bladerf_get_quick_tune() */
+#define FASTLOCK_STORE_NIOS_SLOTS 128
+
+/* RFFE slot through which profile data is moved between the host and the
+ * Nios. Retunes from the store activate profiles in the other slots, so that
+ * this is never in use by a pending retune. */
+#define FASTLOCK_STAGING_SLOT (NUM_RFFE_FASTLOCK_PROFILES - 1)
+
+#define CHECK_FASTLOCK_CHANNEL(_ch)                                  \
+    do {                                                             \
+        if (_ch != BLADERF_CHANNEL_RX(0) && _ch != BLADERF_CHANNEL_RX(1) && \
+            _ch != BLADERF_CHANNEL_TX(0) && _ch != BLADERF_CHANNEL_TX(1)) { \
+            RETURN_INVAL_ARG("channel", _ch, "is not valid");        \
+        }                                                            \
+    } while (0)
+
+/* Get the store for a channel's direction, creating it and reserving its
+ * window of Nios slots as needed */
+static int _bladerf2_get_fastlock_store(struct bladerf *dev,
+                                        bladerf_channel ch,
+                                        struct fastlock_store **store)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct controller_fns const *rfic      = board_data->rfic;
+    size_t const dir = BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX : BLADERF_RX;
+
+    uint16_t *next_profile = BLADERF_CHANNEL_IS_TX(ch)
+                                 ? &board_data->quick_tune_tx_profile
+                                 : &board_data->quick_tune_rx_profile;
+    unsigned int count;
+    uint16_t base;
+
+    if (rfic->save_fastlock_profile == NULL ||
+        rfic->load_fastlock_profile == NULL) {
+        log_debug("%s: RFIC control cannot transfer fast lock profiles\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_SCHEDULED_RETUNE)) {
+        log_debug("%s: FPGA does not support scheduled retunes\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (board_data->fastlocks[dir] == NULL) {
+        board_data->fastlocks[dir] = fastlock_store_create();
+        if (board_data->fastlocks[dir] == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+    }
+
+    *store = board_data->fastlocks[dir];
+
+    if (fastlock_store_get_window(*store, &base) == 0) {
+        count = NUM_BBP_FASTLOCK_PROFILES - *next_profile;
+        if (count > FASTLOCK_STORE_NIOS_SLOTS) {
+            count = FASTLOCK_STORE_NIOS_SLOTS;
+        }
+
+        if (count <= FASTLOCK_STORE_PINNED) {
+            log_error("Too few quick tune profiles remain for the fast lock "
+                      "profile store.\n");
+            return BLADERF_ERR_UNEXPECTED;
+        }
+
+        CHECK_STATUS(fastlock_store_set_window(*store, *next_profile, count));
+
+        log_verbose("%s: %s store uses Nios fast lock slots %u-%u\n",
+                    __FUNCTION__, BLADERF_CHANNEL_IS_TX(ch) ? "TX" : "RX",
+                    *next_profile, *next_profile + count - 1);
+
+        *next_profile += count;
+    }
+
+    return 0;
+}
+
+/* Ensure a stored profile occupies a Nios slot */
+static int _bladerf2_load_fastlock(struct bladerf *dev,
+                                   bladerf_channel ch,
+                                   struct fastlock_store *store,
+                                   unsigned int index,
+                                   uint16_t *slot)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct controller_fns const *rfic      = board_data->rfic;
+    struct fastlock_profile_data data;
+    bool load;
+    int status;
+
+    CHECK_STATUS(fastlock_store_assign(store, index, slot, &load));
+
+    if (!load) {
+        return 0;
+    }
+
+    data = *fastlock_store_get(store, index);
+
+    /* Write the profile into the staging slot, from which the Nios copies it
+     * into its own memory */
+    status = rfic->load_fastlock_profile(dev, ch, FASTLOCK_STAGING_SLOT,
+                                         data.values);
+    if (status == 0) {
+        status = dev->backend->rffe_fastlock_save(dev,
+                                                  BLADERF_CHANNEL_IS_TX(ch),
+                                                  FASTLOCK_STAGING_SLOT, *slot);
+    }
+
+    if (status != 0) {
+        fastlock_store_evict(store, index);
+    }
+
+    return status;
+}
+
+int bladerf_store_fastlock_profile(struct bladerf *dev,
+                                   bladerf_channel ch,
+                                   unsigned int *index)
+{
+    CHECK_BOARD_IS_BLADERF2(dev);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(index);
+    CHECK_FASTLOCK_CHANNEL(ch);
+
+    WITH_MUTEX(&dev->lock, {
+        struct bladerf2_board_data *board_data = dev->board_data;
+        struct controller_fns const *rfic      = board_data->rfic;
+        struct fastlock_profile_data data;
+        struct fastlock_store *store;
+        bladerf_frequency freq;
+
+        CHECK_STATUS_LOCKED(_bladerf2_get_fastlock_store(dev, ch, &store));
+        CHECK_STATUS_LOCKED(dev->board->get_frequency(dev, ch, &freq));
+
+        _bladerf2_quick_tune_ports(ch, freq, &data.port, &data.spdt);
+
+        CHECK_STATUS_LOCKED(
+            rfic->store_fastlock_profile(dev, ch, FASTLOCK_STAGING_SLOT));
+        CHECK_STATUS_LOCKED(rfic->save_fastlock_profile(
+            dev, ch, FASTLOCK_STAGING_SLOT, data.values));
+
+        CHECK_STATUS_LOCKED(fastlock_store_add(store, &data, index));
+
+        /* See the fastlock workaround in _bladerf2_store_quick_tune() */
+        board_data->rfic_reset_on_close = true;
+    });
+
+    return 0;
+}
+
+int bladerf_prefetch_fastlock_profiles(struct bladerf *dev,
+                                       bladerf_channel ch,
+                                       const unsigned int *indices,
+                                       unsigned int count)
+{
+    CHECK_BOARD_IS_BLADERF2(dev);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(indices);
+    CHECK_FASTLOCK_CHANNEL(ch);
+
+    WITH_MUTEX(&dev->lock, {
+        struct fastlock_store *store;
+        unsigned int i;
+        uint16_t slot;
+
+        CHECK_STATUS_LOCKED(_bladerf2_get_fastlock_store(dev, ch, &store));
+
+        for (i = 0; i < count; i++) {
+            CHECK_STATUS_LOCKED(
+                _bladerf2_load_fastlock(dev, ch, store, indices[i], &slot));
+        }
+    });
+
+    return 0;
+}
+
+int bladerf_schedule_fastlock_retune(struct bladerf *dev,
+                                     bladerf_channel ch,
+                                     bladerf_timestamp timestamp,
+                                     unsigned int index)
+{
+    CHECK_BOARD_IS_BLADERF2(dev);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    CHECK_FASTLOCK_CHANNEL(ch);
+
+    WITH_MUTEX(&dev->lock, {
+        struct bladerf2_board_data *board_data = dev->board_data;
+        struct fastlock_profile_data const *data;
+        struct fastlock_store *store;
+        size_t dir = BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX : BLADERF_RX;
+        uint16_t slot;
+
+        CHECK_STATUS_LOCKED(_bladerf2_get_fastlock_store(dev, ch, &store));
+        CHECK_STATUS_LOCKED(_bladerf2_load_fastlock(dev, ch, store, index, &slot));
+
+        data = fastlock_store_get(store, index);
+
+        board_data->rfic_port_valid[dir] = false;
+        gain_table_invalidate(board_data, dir);
+
+        CHECK_STATUS_LOCKED(dev->backend->retune2(
+            dev, ch, timestamp, slot, slot % FASTLOCK_STAGING_SLOT, data->port,
+            data->spdt));
+
+        fastlock_store_pin(store, slot);
+    });
+
+    return 0;
+}
+
+int bladerf_clear_fastlock_profiles(struct bladerf *dev, bladerf_channel ch)
+{
+    CHECK_BOARD_IS_BLADERF2(dev);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    CHECK_FASTLOCK_CHANNEL(ch);
+
+    WITH_MUTEX(&dev->lock, {
+        struct bladerf2_board_data *board_data = dev->board_data;
+        size_t dir = BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX : BLADERF_RX;
+
+        if (board_data->fastlocks[dir] != NULL) {
+            fastlock_store_clear(board_data->fastlocks[dir]);
+        }
+    });
+
+    return 0;
+}
+
+
+/******************************************************************************/
+/* Scheduled gain changes */
+/******************************************************************************/
+
+int bladerf_schedule_gain(struct bladerf *dev,
+                          bladerf_channel ch,
+                          bladerf_timestamp timestamp,
+                          int gain)
+{
+    CHECK_BOARD_IS_BLADERF2(dev);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    CHECK_FASTLOCK_CHANNEL(ch);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct controller_fns const *rfic      = board_data->rfic;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_SCHEDULED_GAIN)) {
+        log_debug("This FPGA version (%u.%u.%u) does not support "
+                  "scheduled gain changes.\n",
+                  board_data->fpga_version.major,
+                  board_data->fpga_version.minor,
+                  board_data->fpga_version.patch);
+
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (rfic->schedule_gain == NULL) {
+        log_debug("%s: scheduled gain changes require host RFIC control\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    WITH_MUTEX(&dev->lock, {
+        struct bladerf_range const *range = NULL;
+
+        CHECK_STATUS_LOCKED(dev->board->get_gain_range(dev, ch, &range));
+        CHECK_STATUS_LOCKED(rfic->schedule_gain(
+            dev, ch, timestamp, clamp_to_range(range, gain)));
+    });
+
+    return 0;
+}
+
+
+/******************************************************************************/
+/* Sample rate changes on a live stream */
+/******************************************************************************/
+
+int bladerf_set_sample_rate_live(struct bladerf *dev,
+                                 bladerf_channel ch,
+                                 bladerf_sample_rate rate,
+                                 bladerf_sample_rate *actual,
+                                 bladerf_timestamp *timestamp)
+{
+    CHECK_BOARD_IS_BLADERF2(dev);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    if (dev->feature == BLADERF_FEATURE_OVERSAMPLE) {
+        log_debug("%s: not supported with the OVERSAMPLE feature\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    WITH_MUTEX(&dev->lock, {
+        struct bladerf2_board_data *board_data = dev->board_data;
+        struct bladerf_sync *rx = &board_data->sync[BLADERF_RX];
+        struct bladerf_sync *tx = &board_data->sync[BLADERF_TX];
+        int status;
+
+        /* The RX and TX rates are one and the same, so let the TX samples
+         * already submitted go out at the rate they were meant for */
+        if (tx->initialized) {
+            CHECK_STATUS_LOCKED(
+                sync_tx_drain(tx, tx->stream_config.timeout_ms));
+        }
+
+        if (rx->initialized) {
+            sync_rx_rate_change(rx, true);
+        }
+
+        status = dev->board->set_sample_rate(dev, ch, rate, actual);
+
+        if (status == 0 && timestamp != NULL) {
+            status = dev->board->get_timestamp(dev, BLADERF_RX, timestamp);
+        }
+
+        /* Resume, even on failure, as the rate may have changed anyway */
+        if (rx->initialized) {
+            sync_rx_rate_change(rx, false);
+        }
+
+        CHECK_STATUS_LOCKED(status);
+    });
+
+    return 0;
+}
+
+
+/******************************************************************************/
+/* Background telemetry */
+/******************************************************************************/
+
+/* The temperature change threshold for each BLADERF_RECAL_* calibration,
+ * indexed by bit position */
+static float _bladerf2_recal_threshold(struct bladerf_recal_config const *cfg,
+                                       size_t i)
+{
+    switch (i) {
+        case 0:
+            return cfg->synth_threshold;
+        case 1:
+            return cfg->rx_dc_threshold;
+        default:
+            return cfg->tx_quad_threshold;
+    }
+}
+
+/* Run the pending recalibrations, with the device lock held */
+static int _bladerf2_run_recal(struct bladerf *dev, uint32_t *ran)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct controller_fns const *rfic      = board_data->rfic;
+    uint32_t const cals                    = board_data->recal_pending;
+    float temperature;
+    size_t i;
+
+    if (ran != NULL) {
+        *ran = 0;
+    }
+
+    if (cals == 0) {
+        return 0;
+    }
+
+    CHECK_STATUS(rfic->get_temperature(dev, &temperature));
+    CHECK_STATUS(rfic->recalibrate(dev, cals));
+
+    for (i = 0; i < ARRAY_SIZE(board_data->recal_temp); i++) {
+        if (cals & (1 << i)) {
+            board_data->recal_temp[i] = temperature;
+        }
+    }
+
+    board_data->recal_pending = 0;
+
+    log_debug("%s: ran 0x%x at %.1f C\n", __FUNCTION__, cals, temperature);
+
+    if (ran != NULL) {
+        *ran = cals;
+    }
+
+    return 0;
+}
+
+/* Mark the calibrations whose thresholds the temperature has crossed as
+ * pending, and run them unless they are deferred */
+static void _bladerf2_check_recal(struct bladerf *dev, float temperature)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    size_t i;
+    int status;
+
+    if (!board_data->recal_enabled) {
+        return;
+    }
+
+    for (i = 0; i < ARRAY_SIZE(board_data->recal_temp); i++) {
+        float const threshold =
+            _bladerf2_recal_threshold(&board_data->recal, i);
+
+        if (threshold > 0.0F &&
+            fabsf(temperature - board_data->recal_temp[i]) >= threshold) {
+            board_data->recal_pending |= (1 << i);
+        }
+    }
+
+    if (board_data->recal_pending != 0 && !board_data->recal.deferred) {
+        dev_lock_yield(dev);
+
+        status = _bladerf2_run_recal(dev, NULL);
+        if (status < 0) {
+            log_debug("%s: recalibration failed: %s\n", __FUNCTION__,
+                      bladerf_strerror(status));
+        }
+    }
+}
+
+/* Take a telemetry sample, with the device lock held. The lock is handed to
+ * latency-critical operations between reads. */
+static void _bladerf2_sample_telemetry(struct bladerf *dev,
+                                       struct bladerf_telemetry *sample)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct controller_fns const *rfic      = board_data->rfic;
+    size_t i;
+
+    if (board_data->state >= STATE_INITIALIZED) {
+        if (rfic->get_temperature(dev, &sample->rfic_temperature) == 0) {
+            sample->valid |= BLADERF_TELEMETRY_TEMPERATURE;
+        }
 
-static int bladerf2_config_gpio_read(struct bladerf *dev, uint32_t *val)
-{
-    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
-    NULL_CHECK(val);
+        for (i = 0; i < 2; i++) {
+            int pre_rssi, sym_rssi;
 
-    return dev->backend->config_gpio_read(dev, val);
-}
+            dev_lock_yield(dev);
 
-static int bladerf2_config_gpio_write(struct bladerf *dev, uint32_t val)
-{
-    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
+            if (rfic->get_rssi(dev, BLADERF_CHANNEL_RX(i), &pre_rssi,
+                               &sym_rssi) == 0) {
+                sample->pre_rssi[i] = pre_rssi;
+                sample->sym_rssi[i] = sym_rssi;
+                sample->valid |= BLADERF_TELEMETRY_RSSI(i);
+            }
+        }
+    }
 
-    return dev->backend->config_gpio_write(dev, val);
-}
+    if (board_data->state >= STATE_FPGA_LOADED) {
+        bool ok;
 
+        dev_lock_yield(dev);
+        ok = ina219_read_shunt_voltage(dev, &sample->voltage_shunt) == 0;
 
-/******************************************************************************/
-/* Low-level SPI Flash access */
-/******************************************************************************/
+        dev_lock_yield(dev);
+        ok = ok && ina219_read_bus_voltage(dev, &sample->voltage_bus) == 0;
 
-static int bladerf2_erase_flash(struct bladerf *dev,
-                                uint32_t erase_block,
-                                uint32_t count)
-{
-    CHECK_BOARD_STATE(STATE_FIRMWARE_LOADED);
+        dev_lock_yield(dev);
+        ok = ok && ina219_read_power(dev, &sample->power) == 0;
 
-    return spi_flash_erase(dev, erase_block, count);
-}
+        dev_lock_yield(dev);
+        ok = ok && ina219_read_current(dev, &sample->current) == 0;
 
-static int bladerf2_read_flash(struct bladerf *dev,
-                               uint8_t *buf,
-                               uint32_t page,
-                               uint32_t count)
-{
-    CHECK_BOARD_STATE(STATE_FIRMWARE_LOADED);
-    NULL_CHECK(buf);
+        if (ok) {
+            sample->valid |= BLADERF_TELEMETRY_PMIC;
+        }
+    }
 
-    return spi_flash_read(dev, buf, page, count);
+    if (sample->valid & BLADERF_TELEMETRY_TEMPERATURE) {
+        _bladerf2_check_recal(dev, sample->rfic_temperature);
+    }
 }
 
-static int bladerf2_write_flash(struct bladerf *dev,
-                                uint8_t const *buf,
-                                uint32_t page,
-                                uint32_t count)
+/* Fetch the latest telemetry sample, if the sampler is running and has read
+ * all of the `fields` */
+static bool _bladerf2_telemetry_cached(struct bladerf *dev,
+                                       uint32_t fields,
+                                       struct bladerf_telemetry *sample)
 {
-    CHECK_BOARD_STATE(STATE_FIRMWARE_LOADED);
-    NULL_CHECK(buf);
+    bool cached = false;
 
-    return spi_flash_write(dev, buf, page, count);
-}
+    MUTEX_LOCK(&dev->telemetry_lock);
 
+    if (dev->telemetry != NULL && telemetry_read(dev->telemetry, sample) == 0) {
+        cached = (sample->valid & fields) == fields;
+    }
 
-/******************************************************************************/
-/* Expansion support */
-/******************************************************************************/
+    MUTEX_UNLOCK(&dev->telemetry_lock);
 
-static int bladerf2_expansion_attach(struct bladerf *dev, bladerf_xb xb)
-{
-    return BLADERF_ERR_UNSUPPORTED;
+    return cached;
 }
 
-static int bladerf2_expansion_get_attached(struct bladerf *dev, bladerf_xb *xb)
+int bladerf_enable_telemetry(struct bladerf *dev, unsigned int interval_ms)
 {
-    NULL_CHECK(xb);
+    CHECK_BOARD_IS_BLADERF2(dev);
 
-    *xb = BLADERF_XB_NONE;
+    struct telemetry *telemetry = NULL;
+    int status                  = 0;
 
-    return 0;
+    MUTEX_LOCK(&dev->telemetry_lock);
+
+    telemetry_stop(dev->telemetry);
+    dev->telemetry = NULL;
+
+    if (interval_ms != 0) {
+        status = telemetry_start(&telemetry, dev, interval_ms,
+                                 _bladerf2_sample_telemetry);
+        if (status == 0) {
+            dev->telemetry = telemetry;
+        }
+    }
+
+    MUTEX_UNLOCK(&dev->telemetry_lock);
+
+    return status;
 }
 
+int bladerf_get_telemetry(struct bladerf *dev,
+                          struct bladerf_telemetry *sample)
+{
+    CHECK_BOARD_IS_BLADERF2(dev);
+    NULL_CHECK(sample);
 
-/******************************************************************************/
-/* Board binding */
-/******************************************************************************/
+    int status;
 
-struct board_fns const bladerf2_board_fns = {
-    FIELD_INIT(.matches, bladerf2_matches),
-    FIELD_INIT(.open, bladerf2_open),
-    FIELD_INIT(.close, bladerf2_close),
-    FIELD_INIT(.device_speed, bladerf2_device_speed),
-    FIELD_INIT(.get_serial, bladerf2_get_serial),
-    FIELD_INIT(.get_fpga_size, bladerf2_get_fpga_size),
-    FIELD_INIT(.get_fpga_bytes, bladerf2_get_fpga_bytes),
-    FIELD_INIT(.get_flash_size, bladerf2_get_flash_size),
-    FIELD_INIT(.is_fpga_configured, bladerf2_is_fpga_configured),
-    FIELD_INIT(.get_fpga_source, bladerf2_get_fpga_source),
-    FIELD_INIT(.get_capabilities, bladerf2_get_capabilities),
-    FIELD_INIT(.get_channel_count, bladerf2_get_channel_count),
-    FIELD_INIT(.get_fpga_version, bladerf2_get_fpga_version),
-    FIELD_INIT(.get_fw_version, bladerf2_get_fw_version),
-    FIELD_INIT(.set_gain, bladerf2_set_gain),
-    FIELD_INIT(.get_gain, bladerf2_get_gain),
-    FIELD_INIT(.set_gain_mode, bladerf2_set_gain_mode),
-    FIELD_INIT(.get_gain_mode, bladerf2_get_gain_mode),
-    FIELD_INIT(.get_gain_modes, bladerf2_get_gain_modes),
-    FIELD_INIT(.get_gain_range, bladerf2_get_gain_range),
-    FIELD_INIT(.set_gain_stage, bladerf2_set_gain_stage),
-    FIELD_INIT(.get_gain_stage, bladerf2_get_gain_stage),
-    FIELD_INIT(.get_gain_stage_range, bladerf2_get_gain_stage_range),
-    FIELD_INIT(.get_gain_stages, bladerf2_get_gain_stages),
-    FIELD_INIT(.set_sample_rate, bladerf2_set_sample_rate),
-    FIELD_INIT(.set_rational_sample_rate, bladerf2_set_rational_sample_rate),
-    FIELD_INIT(.get_sample_rate, bladerf2_get_sample_rate),
-    FIELD_INIT(.get_sample_rate_range, bladerf2_get_sample_rate_range),
-    FIELD_INIT(.get_rational_sample_rate, bladerf2_get_rational_sample_rate),
-    FIELD_INIT(.set_bandwidth, bladerf2_set_bandwidth),
-    FIELD_INIT(.get_bandwidth, bladerf2_get_bandwidth),
-    FIELD_INIT(.get_bandwidth_range, bladerf2_get_bandwidth_range),
-    FIELD_INIT(.get_frequency, bladerf2_get_frequency),
-    FIELD_INIT(.set_frequency, bladerf2_set_frequency),
-    FIELD_INIT(.get_frequency_range, bladerf2_get_frequency_range),
-    FIELD_INIT(.select_band, bladerf2_select_band),
-    FIELD_INIT(.set_rf_port, bladerf2_set_rf_port),
-    FIELD_INIT(.get_rf_port, bladerf2_get_rf_port),
-    FIELD_INIT(.get_rf_ports, bladerf2_get_rf_ports),
-    FIELD_INIT(.get_quick_tune, bladerf2_get_quick_tune),
-    FIELD_INIT(.schedule_retune, bladerf2_schedule_retune),
-    FIELD_INIT(.cancel_scheduled_retunes, bladerf2_cancel_scheduled_retunes),
-    FIELD_INIT(.get_correction, bladerf2_get_correction),
-    FIELD_INIT(.set_correction, bladerf2_set_correction),
-    FIELD_INIT(.trigger_init, bladerf2_trigger_init),
-    FIELD_INIT(.trigger_arm, bladerf2_trigger_arm),
-    FIELD_INIT(.trigger_fire, bladerf2_trigger_fire),
-    FIELD_INIT(.trigger_state, bladerf2_trigger_state),
-    FIELD_INIT(.enable_module, bladerf2_enable_module),
-    FIELD_INIT(.init_stream, bladerf2_init_stream),
-    FIELD_INIT(.stream, bladerf2_stream),
-    FIELD_INIT(.submit_stream_buffer, bladerf2_submit_stream_buffer),
-    FIELD_INIT(.deinit_stream, bladerf2_deinit_stream),
-    FIELD_INIT(.set_stream_timeout, bladerf2_set_stream_timeout),
-    FIELD_INIT(.get_stream_timeout, bladerf2_get_stream_timeout),
-    FIELD_INIT(.sync_config, bladerf2_sync_config),
-    FIELD_INIT(.sync_tx, bladerf2_sync_tx),
-    FIELD_INIT(.sync_rx, bladerf2_sync_rx),
-    FIELD_INIT(.get_timestamp, bladerf2_get_timestamp),
-    FIELD_INIT(.load_fpga, bladerf2_load_fpga),
-    FIELD_INIT(.flash_fpga, bladerf2_flash_fpga),
-    FIELD_INIT(.erase_stored_fpga, bladerf2_erase_stored_fpga),
-    FIELD_INIT(.flash_firmware, bladerf2_flash_firmware),
-    FIELD_INIT(.device_reset, bladerf2_device_reset),
-    FIELD_INIT(.set_tuning_mode, bladerf2_set_tuning_mode),
-    FIELD_INIT(.get_tuning_mode, bladerf2_get_tuning_mode),
-    FIELD_INIT(.get_loopback_modes, bladerf2_get_loopback_modes),
-    FIELD_INIT(.set_loopback, bladerf2_set_loopback),
-    FIELD_INIT(.get_loopback, bladerf2_get_loopback),
-    FIELD_INIT(.get_rx_mux, bladerf2_get_rx_mux),
-    FIELD_INIT(.set_rx_mux, bladerf2_set_rx_mux),
-    FIELD_INIT(.set_vctcxo_tamer_mode, bladerf2_set_vctcxo_tamer_mode),
-    FIELD_INIT(.get_vctcxo_tamer_mode, bladerf2_get_vctcxo_tamer_mode),
-    FIELD_INIT(.get_vctcxo_trim, bladerf2_get_vctcxo_trim),
-    FIELD_INIT(.trim_dac_read, bladerf2_trim_dac_read),
-    FIELD_INIT(.trim_dac_write, bladerf2_trim_dac_write),
-    FIELD_INIT(.read_trigger, bladerf2_read_trigger),
-    FIELD_INIT(.write_trigger, bladerf2_write_trigger),
-    FIELD_INIT(.wishbone_master_read, bladerf2_wishbone_master_read),
-    FIELD_INIT(.wishbone_master_write, bladerf2_wishbone_master_write),
-    FIELD_INIT(.config_gpio_read, bladerf2_config_gpio_read),
-    FIELD_INIT(.config_gpio_write, bladerf2_config_gpio_write),
-    FIELD_INIT(.erase_flash, bladerf2_erase_flash),
-    FIELD_INIT(.read_flash, bladerf2_read_flash),
-    FIELD_INIT(.write_flash, bladerf2_write_flash),
-    FIELD_INIT(.expansion_attach, bladerf2_expansion_attach),
-    FIELD_INIT(.expansion_get_attached, bladerf2_expansion_get_attached),
-    FIELD_INIT(.name, "bladerf2"),
-};
+    MUTEX_LOCK(&dev->telemetry_lock);
 
+    if (dev->telemetry == NULL) {
+        status = BLADERF_ERR_NOT_INIT;
+    } else {
+        status = telemetry_read(dev->telemetry, sample);
+    }
 
-/******************************************************************************
- ******************************************************************************
- *                         bladeRF2-specific Functions *
- ******************************************************************************
- ******************************************************************************/
+    MUTEX_UNLOCK(&dev->telemetry_lock);
 
-/******************************************************************************/
-/* Bias Tee Control */
-/******************************************************************************/
+    return status;
+}
 
-int bladerf_get_bias_tee(struct bladerf *dev, bladerf_channel ch, bool *enable)
+int bladerf_set_recal_config(struct bladerf *dev,
+                             const struct bladerf_recal_config *config)
 {
     CHECK_BOARD_IS_BLADERF2(dev);
-    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
-    NULL_CHECK(enable);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct controller_fns const *rfic      = board_data->rfic;
+    float temperature;
+    size_t i;
 
     WITH_MUTEX(&dev->lock, {
-        uint32_t reg;
-        uint32_t shift;
+        board_data->recal_enabled = false;
+        board_data->recal_pending = 0;
 
-        shift = BLADERF_CHANNEL_IS_TX(ch) ? RFFE_CONTROL_TX_BIAS_EN
-                                          : RFFE_CONTROL_RX_BIAS_EN;
+        if (config != NULL) {
+            /* Probe for support with an empty set of calibrations */
+            CHECK_STATUS_LOCKED(rfic->recalibrate(dev, 0));
+            CHECK_STATUS_LOCKED(rfic->get_temperature(dev, &temperature));
 
-        /* Read RFFE control register */
-        CHECK_STATUS_LOCKED(dev->backend->rffe_control_read(dev, &reg));
+            for (i = 0; i < ARRAY_SIZE(board_data->recal_temp); i++) {
+                board_data->recal_temp[i] = temperature;
+            }
 
-        /* Check register value */
-        *enable = (reg >> shift) & 0x1;
+            board_data->recal         = *config;
+            board_data->recal_enabled = true;
+        }
     });
 
     return 0;
 }
 
-int bladerf_set_bias_tee(struct bladerf *dev, bladerf_channel ch, bool enable)
+int bladerf_get_recal_pending(struct bladerf *dev, uint32_t *pending)
 {
     CHECK_BOARD_IS_BLADERF2(dev);
-    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
-
-    WITH_MUTEX(&dev->lock, {
-        uint32_t reg;
-        uint32_t shift;
+    NULL_CHECK(pending);
 
-        shift = BLADERF_CHANNEL_IS_TX(ch) ? RFFE_CONTROL_TX_BIAS_EN
-                                          : RFFE_CONTROL_RX_BIAS_EN;
+    struct bladerf2_board_data *board_data = dev->board_data;
 
-        /* Read RFFE control register */
-        CHECK_STATUS_LOCKED(dev->backend->rffe_control_read(dev, &reg));
+    WITH_MUTEX(&dev->lock, { *pending = board_data->recal_pending; });
 
-        /* Clear register value */
-        reg &= ~(1 << shift);
+    return 0;
+}
 
-        /* Set register value */
-        if (enable) {
-            reg |= (1 << shift);
-        }
+int bladerf_run_recal(struct bladerf *dev, uint32_t *ran)
+{
+    CHECK_BOARD_IS_BLADERF2(dev);
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
 
-        /* Write RFFE control register */
-        log_debug("%s: rffe_control_write %08x\n", __FUNCTION__, reg);
-        CHECK_STATUS_LOCKED(dev->backend->rffe_control_write(dev, reg));
-    });
+    WITH_MUTEX(&dev->lock,
+               { CHECK_STATUS_LOCKED(_bladerf2_run_recal(dev, ran)); });
 
     return 0;
 }
@@ -3058,10 +5062,16 @@ int bladerf_set_rfic_register(struct bladerf *dev,
     CHECK_BOARD_STATE(STATE_FPGA_LOADED);
 
     WITH_MUTEX(&dev->lock, {
+        struct bladerf2_board_data *board_data = dev->board_data;
         uint64_t data = (((uint64_t)val) << 56);
 
         address |= (AD936X_WRITE | AD936X_CNT(1));
 
+        /* The write may affect the LO, gain or filter settings */
+        board_data->rfic_bbf_valid = false;
+        gain_table_invalidate(board_data, BLADERF_RX);
+        gain_table_invalidate(board_data, BLADERF_TX);
+
         CHECK_AD936X_LOCKED(dev->backend->ad9361_spi_write(dev, address, data));
     });
 
@@ -3071,20 +5081,21 @@ int bladerf_set_rfic_register(struct bladerf *dev,
 int bladerf_get_rfic_temperature(struct bladerf *dev, float *val)
 {
     CHECK_BOARD_IS_BLADERF2(dev);
-    CHECK_BOARD_STATE(STATE_FPGA_LOADED);
     NULL_CHECK(val);
 
-    struct bladerf2_board_data *board_data = dev->board_data;
-    struct ad9361_rf_phy *phy              = board_data->phy;
+    struct bladerf_telemetry sample;
+    int status;
 
-    IF_COMMAND_MODE(dev, RFIC_COMMAND_FPGA, {
-        log_debug("%s: FPGA command mode not supported\n", __FUNCTION__);
-        return BLADERF_ERR_UNSUPPORTED;
-    });
+    if (_bladerf2_telemetry_cached(dev, BLADERF_TELEMETRY_TEMPERATURE,
+                                   &sample)) {
+        *val = sample.rfic_temperature;
+        return 0;
+    }
 
-    WITH_MUTEX(&dev->lock, { *val = ad9361_get_temp(phy) / 1000.0F; });
+    WITH_MUTEX(&dev->lock,
+               { status = bladerf2_get_rfic_temperature(dev, val); });
 
-    return 0;
+    return status;
 }
 
 int bladerf_get_rfic_rssi(struct bladerf *dev,
@@ -3099,6 +5110,15 @@ int bladerf_get_rfic_rssi(struct bladerf *dev,
 
     struct bladerf2_board_data *board_data = dev->board_data;
     struct controller_fns const *rfic      = board_data->rfic;
+    struct bladerf_telemetry sample;
+
+    if ((ch == BLADERF_CHANNEL_RX(0) || ch == BLADERF_CHANNEL_RX(1)) &&
+        _bladerf2_telemetry_cached(dev, BLADERF_TELEMETRY_RSSI(ch >> 1),
+                                   &sample)) {
+        *pre_rssi = sample.pre_rssi[ch >> 1];
+        *sym_rssi = sample.sym_rssi[ch >> 1];
+        return 0;
+    }
 
     WITH_MUTEX(&dev->lock, {
         CHECK_STATUS_LOCKED(rfic->get_rssi(dev, ch, pre_rssi, sym_rssi));
@@ -3409,6 +5429,9 @@ int bladerf_set_pll_enable(struct bladerf *dev, bool enable)
         // Update our state flag
         board_data->trim_source = enable ? TRIM_SOURCE_PLL : TRIM_SOURCE_NONE;
 
+        // Cached quick tunes were taken with the previous reference
+        tune_cache_invalidate_all(dev);
+
         // Enable the trim DAC if we're done with the
         // PLL
         if (!enable) {
@@ -3597,6 +5620,9 @@ int bladerf_set_clock_select(struct bladerf *dev, bladerf_clock_select sel)
 
         // Write back the config GPIO
         CHECK_STATUS_LOCKED(dev->backend->config_gpio_write(dev, gpio));
+
+        // Cached quick tunes were taken with the previous reference
+        tune_cache_invalidate_all(dev);
     });
 
     return 0;
@@ -3658,8 +5684,32 @@ int bladerf_get_pmic_register(struct bladerf *dev,
     CHECK_BOARD_STATE(STATE_FPGA_LOADED);
     NULL_CHECK(val);
 
+    struct bladerf_telemetry sample;
     int rv;
 
+    if (_bladerf2_telemetry_cached(dev, BLADERF_TELEMETRY_PMIC, &sample)) {
+        switch (reg) {
+            case BLADERF_PMIC_VOLTAGE_SHUNT:
+                *(float *)val = sample.voltage_shunt;
+                return 0;
+
+            case BLADERF_PMIC_VOLTAGE_BUS:
+                *(float *)val = sample.voltage_bus;
+                return 0;
+
+            case BLADERF_PMIC_POWER:
+                *(float *)val = sample.power;
+                return 0;
+
+            case BLADERF_PMIC_CURRENT:
+                *(float *)val = sample.current;
+                return 0;
+
+            default:
+                break;
+        }
+    }
+
     WITH_MUTEX(&dev->lock, {
         switch (reg) {
             case BLADERF_PMIC_CONFIGURATION:
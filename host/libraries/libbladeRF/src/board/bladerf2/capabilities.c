@@ -58,6 +58,19 @@ uint64_t bladerf2_get_fw_capabilities(const struct bladerf_version *fw_version)
         capabilities |= BLADERF_CAP_FW_SHORT_PACKET;
     }
 
+    if (version_fields_greater_or_equal(fw_version, 2, 5, 0)) {
+        capabilities |= BLADERF_CAP_FW_FLASH_PAGES;
+        capabilities |= BLADERF_CAP_FW_DMA_BUFFERS;
+    }
+
+    if (version_fields_greater_or_equal(fw_version, 2, 6, 0)) {
+        capabilities |= BLADERF_CAP_FW_LOG_ENTRIES;
+    }
+
+    if (version_fields_greater_or_equal(fw_version, 2, 7, 0)) {
+        capabilities |= BLADERF_CAP_FW_DMA_CHANNELS;
+    }
+
     return capabilities;
 }
 
@@ -102,5 +115,47 @@ uint64_t bladerf2_get_fpga_capabilities(
         capabilities |= BLADERF_CAP_FPGA_8BIT_SAMPLES;
     }
 
+    if (version_fields_greater_or_equal(fpga_version, 0, 16, 0)) {
+        capabilities |= BLADERF_CAP_FPGA_RX_DECIMATION;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 17, 0)) {
+        capabilities |= BLADERF_CAP_FPGA_TX_WAVEFORM;
+        capabilities |= BLADERF_CAP_FPGA_RX_POWER_METER;
+        capabilities |= BLADERF_CAP_FPGA_SC12_PACKED;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 17, 1)) {
+        capabilities |= BLADERF_CAP_SCHEDULED_GAIN;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 17, 2)) {
+        capabilities |= BLADERF_CAP_RETUNE_QUEUE_CONTROL;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 17, 3)) {
+        capabilities |= BLADERF_CAP_FPGA_RX_META_MSG_SIZE;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 17, 4)) {
+        capabilities |= BLADERF_CAP_TIMED_WRITE;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 17, 5)) {
+        capabilities |= BLADERF_CAP_FPGA_RX_GATE;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 17, 6)) {
+        capabilities |= BLADERF_CAP_FPGA_RX_BURSTS;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 17, 7)) {
+        capabilities |= BLADERF_CAP_FPGA_TX_IDLE_ZERO;
+    }
+
+    if (version_fields_greater_or_equal(fpga_version, 0, 17, 8)) {
+        capabilities |= BLADERF_CAP_FPGA_STREAM_STATS;
+    }
+
     return capabilities;
 }
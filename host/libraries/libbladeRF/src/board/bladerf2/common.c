@@ -21,10 +21,13 @@
 
 #include <string.h>
 
+#include "bladeRF.h"
 #include "board/board.h"
 #include "capabilities.h"
 #include "common.h"
 
+#include "streaming/format.h"
+
 
 /******************************************************************************/
 /* Constants */
@@ -48,12 +51,14 @@ static inline int requires_timestamps(bladerf_format format, bool *required)
     switch (format) {
         case BLADERF_FORMAT_SC8_Q7_META:
         case BLADERF_FORMAT_SC16_Q11_META:
+        case BLADERF_FORMAT_SC12_PACKED_META:
         case BLADERF_FORMAT_PACKET_META:
             *required = true;
             break;
 
         case BLADERF_FORMAT_SC8_Q7:
         case BLADERF_FORMAT_SC16_Q11:
+        case BLADERF_FORMAT_SC12_PACKED:
             *required = false;
             break;
 
@@ -123,6 +128,12 @@ int perform_format_config(struct bladerf *dev,
        gpio_val &= ~BLADERF_GPIO_8BIT_MODE;
     }
 
+    if (format_is_packed(format)) {
+       gpio_val |= BLADERF_GPIO_SC12_PACKED;
+    } else {
+       gpio_val &= ~BLADERF_GPIO_SC12_PACKED;
+    }
+
     CHECK_STATUS(dev->backend->config_gpio_write(dev, gpio_val));
 
     board_data->module_format[dir] = format;
@@ -130,6 +141,93 @@ int perform_format_config(struct bladerf *dev,
     return 0;
 }
 
+/* 16-bit and 12-bit samples are the ones that need more than the default
+ * number of firmware DMA buffers at high sample rates */
+static bool dma_wide_format(bladerf_format format)
+{
+    return format == BLADERF_FORMAT_SC16_Q11 ||
+           format == BLADERF_FORMAT_SC16_Q11_META || format_is_packed(format);
+}
+
+/* Size each direction's DMA channel separately. In full duplex, the USB 3
+ * link alternates between IN and OUT bursts, so each channel is serviced less
+ * often than when it streams alone, and wide formats get the maximum.
+ * Changing a channel does not disturb the other direction, so the other
+ * channel is raised too if it is configured but not yet enabled. */
+static int perform_dma_channel_config(struct bladerf *dev,
+                                      bladerf_channel_layout layout,
+                                      bladerf_format format,
+                                      uint32_t rffe_reg)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    bladerf_direction dir = layout & BLADERF_DIRECTION_MASK;
+    bladerf_direction other = (dir == BLADERF_RX) ? BLADERF_TX : BLADERF_RX;
+    bool duplex = (int)board_data->module_format[other] != -1;
+    unsigned int count = RF_DMA_BUFFERS_DEFAULT;
+
+    if (_rffe_dir_enabled(rffe_reg, dir)) {
+        return 0;
+    }
+
+    if (dma_wide_format(format) &&
+        (duplex || layout == BLADERF_RX_X2 || layout == BLADERF_TX_X2)) {
+        count = RF_DMA_BUFFERS_MAX;
+    }
+
+    CHECK_STATUS(dev->backend->set_rf_dma_channel(dev, dir, count));
+
+    if (duplex && dma_wide_format(board_data->module_format[other]) &&
+        !_rffe_dir_enabled(rffe_reg, other)) {
+        CHECK_STATUS(dev->backend->set_rf_dma_channel(dev, other,
+                                                      RF_DMA_BUFFERS_MAX));
+    }
+
+    return 0;
+}
+
+int perform_dma_config(struct bladerf *dev,
+                       bladerf_channel_layout layout,
+                       bladerf_format format)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    bladerf_direction dir = layout & BLADERF_DIRECTION_MASK;
+    bladerf_direction other = (dir == BLADERF_RX) ? BLADERF_TX : BLADERF_RX;
+    unsigned int count = RF_DMA_BUFFERS_DEFAULT;
+    uint32_t reg;
+
+    if (!have_cap(board_data->capabilities, BLADERF_CAP_FW_DMA_BUFFERS)) {
+        return 0;
+    }
+
+    if (have_cap(board_data->capabilities, BLADERF_CAP_FW_DMA_CHANNELS)) {
+        CHECK_STATUS(dev->backend->rffe_control_read(dev, &reg));
+        return perform_dma_channel_config(dev, layout, format, reg);
+    }
+
+    /* Older firmware shares the buffer count between both directions, and
+     * changing it restarts the RF link, so leave it alone while the other
+     * direction is in use or either direction is enabled */
+    if ((int)board_data->module_format[other] != -1) {
+        return 0;
+    }
+
+    CHECK_STATUS(dev->backend->rffe_control_read(dev, &reg));
+
+    if (_rffe_dir_enabled(reg, BLADERF_RX) ||
+        _rffe_dir_enabled(reg, BLADERF_TX)) {
+        return 0;
+    }
+
+    /* 2x2 is the only case that needs more than the default to sustain the
+     * full sample rate with a single direction */
+    if ((layout == BLADERF_RX_X2 || layout == BLADERF_TX_X2) &&
+        dma_wide_format(format)) {
+        count = RF_DMA_BUFFERS_MAX;
+    }
+
+    return dev->backend->set_rf_dma_buffers(dev, count);
+}
+
 int perform_format_deconfig(struct bladerf *dev, bladerf_direction dir)
 {
     struct bladerf2_board_data *board_data = dev->board_data;
@@ -232,6 +330,13 @@ bladerf_tuning_mode default_tuning_mode(struct bladerf *dev)
 
     mode = BLADERF_TUNING_MODE_HOST;
 
+    /* Unlike host-based control, the state of FPGA-based RFIC control persists
+     * after the device is closed, which warm opens rely upon */
+    if (bladerf_warm_open &&
+        have_cap(board_data->capabilities, BLADERF_CAP_FPGA_TUNING)) {
+        mode = BLADERF_TUNING_MODE_FPGA;
+    }
+
     /* Detect TX FPGA bug and report warning */
     if (BLADERF_TUNING_MODE_FPGA == mode && rfic_fpga_control.is_present(dev) &&
         version_fields_less_than(&board_data->fpga_version, 0, 10, 2)) {
@@ -380,13 +485,11 @@ bool does_rffe_dir_have_enabled_ch(uint32_t reg, bladerf_direction dir)
     return false;
 }
 
-int get_gain_offset(struct bladerf *dev, bladerf_channel ch, float *offset)
+struct bladerf_gain_range const *find_gain_range(bladerf_channel ch,
+                                                 char const *stage,
+                                                 bladerf_frequency frequency)
 {
-    CHECK_BOARD_STATE(STATE_INITIALIZED);
-    NULL_CHECK(offset);
-
     struct bladerf_gain_range const *ranges = NULL;
-    bladerf_frequency frequency             = 0;
     size_t i, ranges_len;
 
     if (BLADERF_CHANNEL_IS_TX(ch)) {
@@ -397,19 +500,64 @@ int get_gain_offset(struct bladerf *dev, bladerf_channel ch, float *offset)
         ranges_len = ARRAY_SIZE(bladerf2_rx_gain_ranges);
     }
 
-    CHECK_STATUS(dev->board->get_frequency(dev, ch, &frequency));
-
     for (i = 0; i < ranges_len; ++i) {
         struct bladerf_gain_range const *r = &(ranges[i]);
         struct bladerf_range const *rfreq  = &(r->frequency);
 
-        // if the frequency range matches, and the range name is null,
+        // if the frequency range matches, and either:
+        //  both the range name and the stage name are null, or
+        //  neither name is null and the strings match
         // then we found our match
-        if (is_within_range(rfreq, frequency) && (NULL == r->name)) {
-            *offset = r->offset;
-            return 0;
+        if (is_within_range(rfreq, frequency) &&
+            ((NULL == r->name && NULL == stage) ||
+             (r->name != NULL && stage != NULL &&
+              (strcmp(r->name, stage) == 0)))) {
+            return r;
         }
     }
 
-    return BLADERF_ERR_INVAL;
+    return NULL;
+}
+
+int get_gain_offset(struct bladerf *dev, bladerf_channel ch, float *offset)
+{
+    CHECK_BOARD_STATE(STATE_INITIALIZED);
+    NULL_CHECK(offset);
+
+    struct bladerf_gain_range const *range = NULL;
+    bladerf_frequency frequency            = 0;
+
+    CHECK_STATUS(dev->board->get_frequency(dev, ch, &frequency));
+
+    range = find_gain_range(ch, NULL, frequency);
+    if (NULL == range) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    *offset = range->offset;
+
+    return 0;
+}
+
+void gain_table_invalidate(struct bladerf2_board_data *board_data,
+                           bladerf_direction dir)
+{
+    size_t i;
+
+    for (i = 0; i < 2; ++i) {
+        bladerf_channel ch = (dir == BLADERF_TX) ? BLADERF_CHANNEL_TX(i)
+                                                 : BLADERF_CHANNEL_RX(i);
+
+        board_data->gain_table[ch].valid = false;
+    }
+}
+
+bool gain_table_covers(struct bladerf2_board_data const *board_data,
+                       bladerf_channel ch,
+                       int gain)
+{
+    return ch >= 0 && (size_t)ch < ARRAY_SIZE(board_data->gain_table) &&
+           board_data->gain_table[ch].valid &&
+           gain >= BLADERF2_GAIN_TABLE_MIN &&
+           gain < BLADERF2_GAIN_TABLE_MIN + BLADERF2_GAIN_TABLE_LEN;
 }
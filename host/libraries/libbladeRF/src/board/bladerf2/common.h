@@ -72,6 +72,11 @@ struct controller_fns {
     int (*set_frequency)(struct bladerf *dev,
                          bladerf_channel ch,
                          bladerf_frequency frequency);
+    /* As set_frequency, but without waiting for the VCO to lock, where the
+     * control allows it */
+    int (*set_frequency_begin)(struct bladerf *dev,
+                               bladerf_channel ch,
+                               bladerf_frequency frequency);
     int (*select_band)(struct bladerf *dev,
                        bladerf_channel ch,
                        bladerf_frequency frequency);
@@ -120,6 +125,20 @@ struct controller_fns {
     int (*get_txmute)(struct bladerf *dev, bladerf_channel ch, bool *state);
     int (*set_txmute)(struct bladerf *dev, bladerf_channel ch, bool state);
 
+    /* RF ports are AD9361 port IDs (see bladerf2_rx_port_map) */
+    int (*get_rf_port)(struct bladerf *dev,
+                       bladerf_channel ch,
+                       uint32_t *port_id);
+    int (*set_rf_port)(struct bladerf *dev,
+                       bladerf_channel ch,
+                       uint32_t port_id);
+
+    /* Temperature in degrees Celsius */
+    int (*get_temperature)(struct bladerf *dev, float *val);
+
+    /* Re-run the BLADERF_RECAL_* calibrations in `cals` */
+    int (*recalibrate)(struct bladerf *dev, uint32_t cals);
+
     int (*store_fastlock_profile)(struct bladerf *dev,
                                   bladerf_channel ch,
                                   uint32_t profile);
@@ -129,9 +148,45 @@ struct controller_fns {
                                  uint32_t profile,
                                  uint8_t *values);
 
+    /* Write profile data previously read by save_fastlock_profile back into
+     * an RFIC fast lock slot. May be NULL. */
+    int (*load_fastlock_profile)(struct bladerf *dev,
+                                 bladerf_channel ch,
+                                 uint32_t profile,
+                                 uint8_t *values);
+
+    /* Schedule a change to an overall gain, already clamped to the channel's
+     * gain range, in the FPGA's retune queue. May be NULL. */
+    int (*schedule_gain)(struct bladerf *dev,
+                         bladerf_channel ch,
+                         bladerf_timestamp timestamp,
+                         int gain);
+
+    /* Wait for commands left to complete in the background (see
+     * bladerf2_board_data.batch_depth) to finish. May be NULL. */
+    int (*wait_pending)(struct bladerf *dev);
+
     enum bladerf2_rfic_command_mode const command_mode;
 };
 
+/* Range of overall gains, in dB, covered by a precomputed gain table */
+#define BLADERF2_GAIN_TABLE_MIN (-32)
+#define BLADERF2_GAIN_TABLE_LEN 128
+
+/* A channel's RFIC gain settings for each integer dB of overall gain,
+ * precomputed by the host RFIC control for the frequency it was tuned to.
+ * Gains are clamped to the overall gain range, as bladerf2_set_gain() does. */
+struct bladerf2_gain_table {
+    bool valid;
+
+    /* RX: full gain table index to write to the manual gain register, or -1
+     * if the driver would reject the gain. TX: attenuation, in mdB. */
+    int32_t setting[BLADERF2_GAIN_TABLE_LEN];
+
+    /* TX: attenuation to cache while muted, in mdB */
+    uint32_t muted_atten[BLADERF2_GAIN_TABLE_LEN];
+};
+
 struct bladerf2_board_data {
     /* Board state */
     enum {
@@ -161,6 +216,11 @@ struct bladerf2_board_data {
     /* Data message size */
     size_t msg_size;
 
+    /* Requested RX metadata message size in bytes, or 0 for msg_size, and
+     * the size in use by the current RX sync configuration */
+    size_t rx_meta_msg_req;
+    size_t rx_meta_msg_size;
+
     /* Version information */
     struct bladerf_version fpga_version;
     struct bladerf_version fw_version;
@@ -179,6 +239,36 @@ struct bladerf2_board_data {
     uint16_t quick_tune_tx_profile;
     uint16_t quick_tune_rx_profile;
 
+    /* Host-side fast lock profile stores, indexed by direction. NULL until
+     * first used. */
+    struct fastlock_store *fastlocks[2];
+
+    /* AD9361 port last selected by the host RFIC control for each direction,
+     * valid if rfic_port_valid is set. Reset wherever something else may have
+     * changed the port. */
+    uint32_t rfic_port[2];
+    bool rfic_port_valid[2];
+
+    /* Precomputed gain settings, indexed by channel. Reset wherever the LO
+     * may be retuned by something other than the host RFIC control. */
+    struct bladerf2_gain_table gain_table[4];
+
+    /* RF bandwidths, indexed by direction, and RFIC temperature (milli-degrees
+     * C) at which the host RFIC control last calibrated the baseband filters,
+     * valid if rfic_bbf_valid is set. Reset wherever something else may have
+     * changed the filters. */
+    bladerf_bandwidth rfic_bbf_bw[2];
+    int32_t rfic_bbf_temp;
+    bool rfic_bbf_valid;
+
+    /* Temperature-triggered recalibration configuration, the RFIC
+     * temperature at which each BLADERF_RECAL_* calibration (indexed by bit
+     * position) was last run, and the mask of those found due. */
+    bool recal_enabled;
+    struct bladerf_recal_config recal;
+    float recal_temp[3];
+    uint32_t recal_pending;
+
     /* RFIC backend command handling */
     struct controller_fns const *rfic;
 
@@ -189,11 +279,24 @@ struct bladerf2_board_data {
     /* If true, RFIC control will be fully de-initialized on close, instead of
      * just put into a standby state. */
     bool rfic_reset_on_close;
+
+    /* Nesting depth of control request batch scopes. While nonzero, FPGA RFIC
+     * configuration commands are not waited upon individually, so that they
+     * may be issued back-to-back. */
+    unsigned int batch_depth;
+
+    /* FPGA RFIC commands have been issued but not waited upon */
+    bool rfic_wq_pending;
+
+    /* Capacity of the FPGA RFIC write queue, or 0 if it has not been
+     * reported */
+    size_t rfic_wq_capacity;
 };
 
 struct bladerf_rfic_status_register {
     bool rfic_initialized;
     size_t write_queue_length;
+    size_t write_queue_capacity;
 };
 
 
@@ -466,6 +569,24 @@ int perform_format_config(struct bladerf *dev,
                           bladerf_direction dir,
                           bladerf_format format);
 
+/**
+ * Select the number of firmware DMA buffers for a stream that is about to be
+ * configured, based on its channel layout and sample format, and on whether
+ * the other direction is configured too. With BLADERF_CAP_FW_DMA_CHANNELS,
+ * each direction's channel is sized separately while it is not enabled.
+ * Older firmware shares one count, which is only changed while the other
+ * direction is not configured and neither direction is enabled.
+ *
+ * @param           dev     Device handle
+ * @param[in]       layout  Channel layout of the stream
+ * @param[in]       format  Wire format of the stream
+ *
+ * @return 0 on success, BLADERF_ERR_* on failure
+ */
+int perform_dma_config(struct bladerf *dev,
+                       bladerf_channel_layout layout,
+                       bladerf_format format);
+
 /**
  * Deconfigure and update any state pertaining what a format that a stream
  * direction is no longer using.
@@ -489,6 +610,35 @@ bool check_total_sample_rate(struct bladerf *dev);
 
 bool does_rffe_dir_have_enabled_ch(uint32_t reg, bladerf_direction dir);
 
+/**
+ * Find the gain range of a channel's gain stage at a frequency
+ *
+ * @param[in]   ch          Channel
+ * @param[in]   stage       Gain stage name, or NULL for the overall gain
+ * @param[in]   frequency   Frequency
+ *
+ * @return Gain range, or NULL if there is none
+ */
+struct bladerf_gain_range const *find_gain_range(bladerf_channel ch,
+                                                 char const *stage,
+                                                 bladerf_frequency frequency);
+
 int get_gain_offset(struct bladerf *dev, bladerf_channel ch, float *offset);
 
+/**
+ * Discard the precomputed gain tables of a direction's channels
+ *
+ * @param       board_data  Board data
+ * @param[in]   dir         Direction
+ */
+void gain_table_invalidate(struct bladerf2_board_data *board_data,
+                           bladerf_direction dir);
+
+/**
+ * @return true if the channel has a precomputed gain table covering `gain`
+ */
+bool gain_table_covers(struct bladerf2_board_data const *board_data,
+                       bladerf_channel ch,
+                       int gain);
+
 #endif  // BLADERF2_COMMON_H_
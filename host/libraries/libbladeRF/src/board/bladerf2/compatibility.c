@@ -27,6 +27,16 @@ const struct version_compat_table bladerf2_fw_compat_table = {fw_compat, ARRAY_S
 
 static const struct compat fpga_compat[] = {
     /*    FPGA          requires >=        Firmware */
+    { VERSION(0, 17, 8),                VERSION(2, 4, 0) },
+    { VERSION(0, 17, 7),                VERSION(2, 4, 0) },
+    { VERSION(0, 17, 6),                VERSION(2, 4, 0) },
+    { VERSION(0, 17, 5),                VERSION(2, 4, 0) },
+    { VERSION(0, 17, 4),                VERSION(2, 4, 0) },
+    { VERSION(0, 17, 3),                VERSION(2, 4, 0) },
+    { VERSION(0, 17, 2),                VERSION(2, 4, 0) },
+    { VERSION(0, 17, 1),                VERSION(2, 4, 0) },
+    { VERSION(0, 17, 0),                VERSION(2, 4, 0) },
+    { VERSION(0, 16, 0),                VERSION(2, 4, 0) },
     { VERSION(0, 15, 3),                VERSION(2, 4, 0) },
     { VERSION(0, 15, 2),                VERSION(2, 4, 0) },
     { VERSION(0, 15, 1),                VERSION(2, 4, 0) },
@@ -0,0 +1,253 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "fastlock_store.h"
+
+struct fastlock_entry {
+    struct fastlock_profile_data data;
+    int slot; /* Index into fastlock_store.slots, or -1 if not resident */
+};
+
+struct fastlock_slot {
+    long owner; /* Index of the resident profile, or -1 */
+    uint64_t last_use;
+};
+
+struct fastlock_store {
+    struct fastlock_entry *entries;
+    unsigned int num_entries;
+    unsigned int max_entries;
+
+    uint16_t base;
+    unsigned int num_slots;
+    struct fastlock_slot *slots;
+    uint64_t use_count;
+
+    /* Slots of the most recently scheduled retunes */
+    uint16_t pinned[FASTLOCK_STORE_PINNED];
+    unsigned int num_pinned;
+    unsigned int pin_idx;
+};
+
+struct fastlock_store *fastlock_store_create(void)
+{
+    return calloc(1, sizeof(struct fastlock_store));
+}
+
+void fastlock_store_free(struct fastlock_store *store)
+{
+    if (store != NULL) {
+        free(store->entries);
+        free(store->slots);
+        free(store);
+    }
+}
+
+void fastlock_store_clear(struct fastlock_store *store)
+{
+    unsigned int i;
+
+    for (i = 0; i < store->num_slots; i++) {
+        store->slots[i].owner = -1;
+    }
+
+    store->num_entries = 0;
+}
+
+unsigned int fastlock_store_get_window(const struct fastlock_store *store,
+                                       uint16_t *base)
+{
+    *base = store->base;
+    return store->num_slots;
+}
+
+int fastlock_store_set_window(struct fastlock_store *store,
+                              uint16_t base,
+                              unsigned int count)
+{
+    struct fastlock_slot *slots = NULL;
+    unsigned int i;
+
+    if (count != 0 && count <= FASTLOCK_STORE_PINNED) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (count != 0) {
+        slots = malloc(count * sizeof(slots[0]));
+        if (slots == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+
+        for (i = 0; i < count; i++) {
+            slots[i].owner    = -1;
+            slots[i].last_use = 0;
+        }
+    }
+
+    free(store->slots);
+    store->slots      = slots;
+    store->num_slots  = count;
+    store->base       = base;
+    store->num_pinned = 0;
+    store->pin_idx    = 0;
+
+    for (i = 0; i < store->num_entries; i++) {
+        store->entries[i].slot = -1;
+    }
+
+    return 0;
+}
+
+int fastlock_store_add(struct fastlock_store *store,
+                       const struct fastlock_profile_data *data,
+                       unsigned int *index)
+{
+    if (store->num_entries == store->max_entries) {
+        unsigned int max = store->max_entries ? 2 * store->max_entries : 64;
+        struct fastlock_entry *entries;
+
+        entries = realloc(store->entries, max * sizeof(entries[0]));
+        if (entries == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+
+        store->entries     = entries;
+        store->max_entries = max;
+    }
+
+    store->entries[store->num_entries].data = *data;
+    store->entries[store->num_entries].slot = -1;
+
+    *index = store->num_entries++;
+
+    return 0;
+}
+
+const struct fastlock_profile_data *fastlock_store_get(
+    const struct fastlock_store *store, unsigned int index)
+{
+    if (index >= store->num_entries) {
+        return NULL;
+    }
+
+    return &store->entries[index].data;
+}
+
+static bool is_pinned(const struct fastlock_store *store, unsigned int slot)
+{
+    unsigned int i;
+
+    for (i = 0; i < store->num_pinned; i++) {
+        if (store->pinned[i] == store->base + slot) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int fastlock_store_assign(struct fastlock_store *store,
+                          unsigned int index,
+                          uint16_t *slot,
+                          bool *load)
+{
+    struct fastlock_entry *e;
+    int victim = -1;
+    unsigned int i;
+
+    if (index >= store->num_entries) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (store->num_slots == 0) {
+        return BLADERF_ERR_NOT_INIT;
+    }
+
+    e = &store->entries[index];
+
+    if (e->slot >= 0) {
+        store->slots[e->slot].last_use = ++store->use_count;
+        *slot = store->base + e->slot;
+        *load = false;
+        return 0;
+    }
+
+    /* Prefer a free slot, then the least recently used one. At most
+     * FASTLOCK_STORE_PINNED are excluded, so one is always found. */
+    for (i = 0; i < store->num_slots; i++) {
+        const struct fastlock_slot *s = &store->slots[i];
+
+        if (is_pinned(store, i)) {
+            continue;
+        }
+
+        if (s->owner < 0) {
+            victim = i;
+            break;
+        }
+
+        if (victim < 0 || s->last_use < store->slots[victim].last_use) {
+            victim = i;
+        }
+    }
+
+    if (store->slots[victim].owner >= 0) {
+        store->entries[store->slots[victim].owner].slot = -1;
+    }
+
+    store->slots[victim].owner    = (long)index;
+    store->slots[victim].last_use = ++store->use_count;
+    e->slot                       = victim;
+
+    *slot = store->base + victim;
+    *load = true;
+
+    return 0;
+}
+
+void fastlock_store_evict(struct fastlock_store *store, unsigned int index)
+{
+    struct fastlock_entry *e;
+
+    if (index >= store->num_entries) {
+        return;
+    }
+
+    e = &store->entries[index];
+
+    if (e->slot >= 0) {
+        store->slots[e->slot].owner = -1;
+        e->slot                     = -1;
+    }
+}
+
+void fastlock_store_pin(struct fastlock_store *store, uint16_t slot)
+{
+    store->pinned[store->pin_idx] = slot;
+    store->pin_idx = (store->pin_idx + 1) % FASTLOCK_STORE_PINNED;
+
+    if (store->num_pinned < FASTLOCK_STORE_PINNED) {
+        store->num_pinned++;
+    }
+}
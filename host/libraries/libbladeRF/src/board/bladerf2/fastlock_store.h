@@ -0,0 +1,150 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Host-side store of AD9361 fast lock profiles for one direction.
+ *
+ * The AD9361 holds 8 fast lock profiles per synthesizer, and the Nios II
+ * keeps copies of up to NUM_BBP_FASTLOCK_PROFILES of them, which it loads
+ * into the RFIC as retunes come due (see bladerf_get_quick_tune()). This
+ * store holds any number of profiles on the host, and tracks which of them
+ * occupy a window of the Nios II's slots, so that profiles may be swapped
+ * into the Nios II ahead of the retunes that use them.
+ *
+ * This only handles the bookkeeping; moving profile data is left to the
+ * caller. */
+
+#ifndef BLADERF2_FASTLOCK_STORE_H_
+#define BLADERF2_FASTLOCK_STORE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+/* Size of an AD9361 fast lock profile, in bytes */
+#define FASTLOCK_PROFILE_LEN 16
+
+/* Depth of the Nios II retune queue (RETUNE2_QUEUE_MAX). Slots used by this
+ * many of the most recently scheduled retunes may still be pending, and are
+ * never chosen for replacement. */
+#define FASTLOCK_STORE_PINNED 16
+
+struct fastlock_profile_data {
+    uint8_t values[FASTLOCK_PROFILE_LEN];
+    uint8_t port;
+    uint8_t spdt;
+};
+
+struct fastlock_store;
+
+/**
+ * Create an empty store
+ *
+ * @return Store, or NULL on allocation failure
+ */
+struct fastlock_store *fastlock_store_create(void);
+
+/**
+ * Free a store. NULL is ignored.
+ */
+void fastlock_store_free(struct fastlock_store *store);
+
+/**
+ * Discard all profiles. The window is kept.
+ */
+void fastlock_store_clear(struct fastlock_store *store);
+
+/**
+ * Get the window of Nios II slots used by the store
+ *
+ * @param[in]   store   Store
+ * @param[out]  base    First slot
+ *
+ * @return Number of slots, or 0 if no window has been assigned
+ */
+unsigned int fastlock_store_get_window(const struct fastlock_store *store,
+                                       uint16_t *base);
+
+/**
+ * Assign the window of Nios II slots used by the store, or 0 slots to drop
+ * it, as when the Nios II's copies have been lost. Residency of all profiles
+ * is forgotten.
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if `count` is nonzero but cannot
+ *         satisfy FASTLOCK_STORE_PINNED, BLADERF_ERR_MEM on allocation
+ *         failure
+ */
+int fastlock_store_set_window(struct fastlock_store *store,
+                              uint16_t base,
+                              unsigned int count);
+
+/**
+ * Add a profile
+ *
+ * @param       store   Store
+ * @param[in]   data    Profile data
+ * @param[out]  index   Index of the new profile
+ *
+ * @return 0 on success, BLADERF_ERR_MEM on allocation failure
+ */
+int fastlock_store_add(struct fastlock_store *store,
+                       const struct fastlock_profile_data *data,
+                       unsigned int *index);
+
+/**
+ * Get a profile
+ *
+ * @return Profile data, or NULL if `index` is out of range
+ */
+const struct fastlock_profile_data *fastlock_store_get(
+    const struct fastlock_store *store, unsigned int index);
+
+/**
+ * Find or choose the Nios II slot for a profile. If the profile is not
+ * resident, the least recently used slot that may not be pending is taken
+ * from its current occupant. The caller must then copy the profile into the
+ * slot, or call fastlock_store_evict() on failure.
+ *
+ * @param       store   Store
+ * @param[in]   index   Profile index
+ * @param[out]  slot    Nios II slot
+ * @param[out]  load    Set to true if the profile must be copied to `slot`
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if `index` is out of range,
+ *         BLADERF_ERR_NOT_INIT if no window has been assigned
+ */
+int fastlock_store_assign(struct fastlock_store *store,
+                          unsigned int index,
+                          uint16_t *slot,
+                          bool *load);
+
+/**
+ * Mark a profile as no longer resident
+ */
+void fastlock_store_evict(struct fastlock_store *store, unsigned int index);
+
+/**
+ * Record that a retune using a slot was scheduled, pinning the slot until
+ * FASTLOCK_STORE_PINNED further retunes have been scheduled
+ */
+void fastlock_store_pin(struct fastlock_store *store, uint16_t slot);
+
+#endif
@@ -0,0 +1,261 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+
+#include "bladerf2_common.h"
+#include "board/board.h"
+#include "helpers/file.h"
+
+#include "rfic_cal_cache.h"
+
+/* State file name, as provided to file_open_state() */
+#define CACHE_NAME "rfic_cal"
+
+/* Version of the entry format, written at the start of each entry */
+#define CACHE_VERSION 1
+
+/* Longest entry: header fields plus two hex digits per register */
+#define ENTRY_LEN (128 + 2 * (RFIC_CAL_CACHE_NUM_REGS + 2))
+
+bool rfic_cal_cache_enabled(void)
+{
+    return getenv("BLADERF_RFIC_CAL_CACHE") != NULL;
+}
+
+void rfic_cal_cache_key(struct rfic_cal_key *key,
+                        AD9361_InitParam const *params)
+{
+    memset(key, 0, sizeof(*key));
+
+    /* The last path clock is the sample rate */
+    key->rx_samplerate = params->rx_path_clock_frequencies[5];
+    key->tx_samplerate = params->tx_path_clock_frequencies[5];
+    key->rx_bandwidth  = params->rf_rx_bandwidth_hz;
+    key->tx_bandwidth  = params->rf_tx_bandwidth_hz;
+    key->tx_frequency  = params->tx_synthesizer_frequency_hz;
+}
+
+static void format_hex(char *buf, uint8_t const *data, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        snprintf(&buf[2 * i], 3, "%02x", data[i]);
+    }
+}
+
+static bool parse_hex(char const *buf, uint8_t *data, size_t len)
+{
+    size_t i;
+
+    if (strlen(buf) != 2 * len) {
+        return false;
+    }
+
+    for (i = 0; i < len; i++) {
+        unsigned int val;
+
+        if (sscanf(&buf[2 * i], "%2x", &val) != 1) {
+            return false;
+        }
+
+        data[i] = (uint8_t)val;
+    }
+
+    return true;
+}
+
+bool rfic_cal_cache_load(struct bladerf *dev,
+                         struct rfic_cal_key const *key,
+                         struct rfic_cal_entry *entry)
+{
+    char line[ENTRY_LEN];
+    char regs[ENTRY_LEN];
+    char status[ENTRY_LEN];
+    unsigned int version;
+    uint64_t tx_frequency;
+    bool valid = false;
+    FILE *f;
+
+    f = file_open_state(dev->ident.serial, CACHE_NAME, false);
+    if (f == NULL) {
+        return false;
+    }
+
+    memset(entry, 0, sizeof(*entry));
+
+    if (fgets(line, sizeof(line), f) != NULL) {
+        valid = sscanf(line, "%u %" SCNu32 " %" SCNu32 " %" SCNu32
+                             " %" SCNu32 " %" SCNu64 " %" SCNd32 " %s %s",
+                       &version, &entry->key.rx_samplerate,
+                       &entry->key.tx_samplerate, &entry->key.rx_bandwidth,
+                       &entry->key.tx_bandwidth, &tx_frequency,
+                       &entry->temperature, regs, status) == 9 &&
+                version == CACHE_VERSION &&
+                parse_hex(regs, entry->regs, sizeof(entry->regs)) &&
+                parse_hex(status, entry->status, sizeof(entry->status));
+
+        entry->key.tx_frequency = tx_frequency;
+    }
+
+    fclose(f);
+
+    if (!valid) {
+        log_debug("%s: ignoring malformed entry\n", __FUNCTION__);
+        return false;
+    }
+
+    if (memcmp(&entry->key, key, sizeof(*key)) != 0) {
+        log_debug("%s: entry was saved under other conditions\n",
+                  __FUNCTION__);
+        return false;
+    }
+
+    return true;
+}
+
+void rfic_cal_cache_store(struct bladerf *dev,
+                          struct rfic_cal_entry const *entry)
+{
+    char regs[2 * RFIC_CAL_CACHE_NUM_REGS + 1];
+    char status[2 * 2 + 1];
+    FILE *f;
+
+    f = file_open_state(dev->ident.serial, CACHE_NAME, true);
+    if (f == NULL) {
+        return;
+    }
+
+    format_hex(regs, entry->regs, sizeof(entry->regs));
+    format_hex(status, entry->status, sizeof(entry->status));
+
+    fprintf(f,
+            "%u %" PRIu32 " %" PRIu32 " %" PRIu32 " %" PRIu32 " %" PRIu64
+            " %" PRId32 " %s %s\n",
+            CACHE_VERSION, entry->key.rx_samplerate, entry->key.tx_samplerate,
+            entry->key.rx_bandwidth, entry->key.tx_bandwidth,
+            entry->key.tx_frequency, entry->temperature, regs, status);
+
+    fclose(f);
+}
+
+void rfic_cal_cache_skip(struct rfic_cal_entry const *entry,
+                         struct platform_cal_skip *skip)
+{
+    memset(skip, 0, sizeof(*skip));
+
+    skip->ctrl_reg  = AD936X_REG_CALIBRATION_CTRL;
+    skip->ctrl_mask = AD936X_TX_QUAD_CAL;
+
+    /* ad9361_init() checks these for convergence, and searches for a better
+     * RX phase when they don't report it */
+    skip->num_status    = 2;
+    skip->status_reg[0] = AD936X_REG_QUAD_CAL_STATUS_TX1;
+    skip->status_val[0] = entry->status[0];
+    skip->status_reg[1] = AD936X_REG_QUAD_CAL_STATUS_TX2;
+    skip->status_val[1] = entry->status[1];
+}
+
+int rfic_cal_cache_capture(struct ad9361_rf_phy *phy,
+                           struct rfic_cal_key const *key,
+                           struct rfic_cal_entry *entry)
+{
+    int32_t val;
+    size_t i;
+
+    memset(entry, 0, sizeof(*entry));
+    entry->key = *key;
+
+    for (i = 0; i < RFIC_CAL_CACHE_NUM_REGS; i++) {
+        val = ad9361_spi_read(phy->spi, AD936X_REG_TX1_OUT_1_PHASE_CORR + i);
+        if (val < 0) {
+            return errno_ad9361_to_bladerf(val);
+        }
+
+        entry->regs[i] = (uint8_t)val;
+    }
+
+    val = ad9361_spi_read(phy->spi, AD936X_REG_QUAD_CAL_STATUS_TX1);
+    if (val < 0) {
+        return errno_ad9361_to_bladerf(val);
+    }
+
+    entry->status[0] = (uint8_t)val;
+
+    val = ad9361_spi_read(phy->spi, AD936X_REG_QUAD_CAL_STATUS_TX2);
+    if (val < 0) {
+        return errno_ad9361_to_bladerf(val);
+    }
+
+    entry->status[1] = (uint8_t)val;
+
+    entry->temperature = ad9361_get_temp(phy);
+
+    return 0;
+}
+
+int rfic_cal_cache_restore(struct ad9361_rf_phy *phy,
+                           struct rfic_cal_entry const *entry)
+{
+    int32_t status;
+    size_t i;
+
+    for (i = 0; i < RFIC_CAL_CACHE_NUM_REGS; i++) {
+        status = ad9361_spi_write(phy->spi,
+                                  AD936X_REG_TX1_OUT_1_PHASE_CORR + i,
+                                  entry->regs[i]);
+        if (status < 0) {
+            return errno_ad9361_to_bladerf(status);
+        }
+    }
+
+    return 0;
+}
+
+static int32_t temperature_bucket(int32_t temperature)
+{
+    const int32_t width = RFIC_CAL_CACHE_TEMP_BUCKET * 1000;
+
+    /* Round toward negative infinity, so that buckets are equally wide
+     * either side of 0 */
+    if (temperature < 0) {
+        return -((-temperature + width - 1) / width);
+    }
+
+    return temperature / width;
+}
+
+bool rfic_cal_cache_temperature_match(struct rfic_cal_entry const *entry,
+                                      int32_t temperature)
+{
+    return rfic_cal_cache_temperatures_match(entry->temperature, temperature);
+}
+
+bool rfic_cal_cache_temperatures_match(int32_t a, int32_t b)
+{
+    return temperature_bucket(a) == temperature_bucket(b);
+}
@@ -0,0 +1,153 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Cache of AD9361 calibration results across device opens.
+ *
+ * TX quadrature calibration dominates the time ad9361_init() spends
+ * calibrating, and its results are held in readable correction registers.
+ * When the BLADERF_RFIC_CAL_CACHE environment variable is defined, these
+ * are saved to a per-device state file after a full initialization, keyed by
+ * the initial sample rates, bandwidths, and TX LO frequency. A later
+ * initialization with the same key skips the calibration and restores the
+ * saved results instead, provided the RFIC temperature is within the same
+ * RFIC_CAL_CACHE_TEMP_BUCKET as when they were saved.
+ *
+ * The DC offset calibrations keep their results in internal per-gain tables
+ * and are always run. */
+
+#ifndef BLADERF2_RFIC_CAL_CACHE_H_
+#define BLADERF2_RFIC_CAL_CACHE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+#include "ad936x.h"
+
+/* Width of the temperature ranges within which results are reused, in
+ * degrees C */
+#define RFIC_CAL_CACHE_TEMP_BUCKET 10
+
+/* TX quadrature correction registers, TX1_OUT_1_PHASE_CORR through
+ * TX2_OUT_2_OFFSET_Q */
+#define RFIC_CAL_CACHE_NUM_REGS                                        \
+    (AD936X_REG_TX2_OUT_2_OFFSET_Q - AD936X_REG_TX1_OUT_1_PHASE_CORR + 1)
+
+/* Conditions the calibration results depend upon */
+struct rfic_cal_key {
+    uint32_t rx_samplerate;
+    uint32_t tx_samplerate;
+    uint32_t rx_bandwidth;
+    uint32_t tx_bandwidth;
+    uint64_t tx_frequency;
+};
+
+struct rfic_cal_entry {
+    struct rfic_cal_key key;
+    int32_t temperature; /* milli-degrees C */
+    uint8_t regs[RFIC_CAL_CACHE_NUM_REGS];
+    uint8_t status[2]; /* QUAD_CAL_STATUS_TX1 and TX2 */
+};
+
+/**
+ * @return true if the cache has been enabled via its environment variable
+ */
+bool rfic_cal_cache_enabled(void);
+
+/**
+ * Fill in the key for an initialization with the given parameters
+ *
+ * @param[out]  key     Key
+ * @param[in]   params  ad9361_init() parameters
+ */
+void rfic_cal_cache_key(struct rfic_cal_key *key,
+                        AD9361_InitParam const *params);
+
+/**
+ * Load the device's saved results, if they were saved with the given key
+ *
+ * @param[in]   dev     Device handle
+ * @param[in]   key     Key
+ * @param[out]  entry   Saved results
+ *
+ * @return true if results were loaded, false otherwise
+ */
+bool rfic_cal_cache_load(struct bladerf *dev,
+                         struct rfic_cal_key const *key,
+                         struct rfic_cal_entry *entry);
+
+/**
+ * Save results for the device, replacing any previously saved
+ *
+ * @param[in]   dev     Device handle
+ * @param[in]   entry   Results
+ */
+void rfic_cal_cache_store(struct bladerf *dev,
+                          struct rfic_cal_entry const *entry);
+
+/**
+ * Describe the calibrations to skip while restoring an entry
+ *
+ * @param[in]   entry   Saved results
+ * @param[out]  skip    Description for platform_spi_cal_skip_begin()
+ */
+void rfic_cal_cache_skip(struct rfic_cal_entry const *entry,
+                         struct platform_cal_skip *skip);
+
+/**
+ * Read the current results and RFIC temperature into an entry
+ *
+ * @param[in]   phy     RFIC handle
+ * @param[in]   key     Key
+ * @param[out]  entry   Results
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int rfic_cal_cache_capture(struct ad9361_rf_phy *phy,
+                           struct rfic_cal_key const *key,
+                           struct rfic_cal_entry *entry);
+
+/**
+ * Write saved results to the RFIC
+ *
+ * @param[in]   phy     RFIC handle
+ * @param[in]   entry   Saved results
+ *
+ * @return 0 on success, value from \ref RETCODES list on failure
+ */
+int rfic_cal_cache_restore(struct ad9361_rf_phy *phy,
+                           struct rfic_cal_entry const *entry);
+
+/**
+ * @return true if a temperature is within the same bucket as that at which
+ *         the entry was saved
+ */
+bool rfic_cal_cache_temperature_match(struct rfic_cal_entry const *entry,
+                                      int32_t temperature);
+
+/**
+ * @return true if two temperatures, in milli-degrees C, are within the same
+ *         bucket
+ */
+bool rfic_cal_cache_temperatures_match(int32_t a, int32_t b);
+
+#endif
@@ -92,6 +92,14 @@ static int _rfic_fpga_get_status(
 
     rfic_status->rfic_initialized   = ((sreg >> 0) & 0x1);
     rfic_status->write_queue_length = ((sreg >> 8) & 0xFF);
+    rfic_status->write_queue_capacity =
+        ((sreg >> BLADERF_RFIC_STATUS_WQMAX_SHIFT) &
+         BLADERF_RFIC_STATUS_WQMAX_MASK);
+
+    if (status == 0) {
+        struct bladerf2_board_data *board_data = dev->board_data;
+        board_data->rfic_wq_capacity = rfic_status->write_queue_capacity;
+    }
 
     return status;
 }
@@ -118,14 +126,23 @@ static int _rfic_fpga_get_status_wqlen(struct bladerf *dev)
 
 static int _rfic_fpga_spinwait(struct bladerf *dev)
 {
+    struct bladerf2_board_data *board_data = dev->board_data;
     size_t const TRIES       = 30;
     unsigned int const DELAY = 100;
     size_t count             = 0;
+    int last_jobs            = -1;
     int jobs;
 
-    /* Poll the CPU and spin until the job has been completed. */
+    /* Poll the CPU and spin until the job has been completed. The timeout
+     * applies per job, so it restarts whenever the queue shrinks. */
     do {
         jobs = _rfic_fpga_get_status_wqlen(dev);
+        if (jobs > 0 && last_jobs > 0 && jobs < last_jobs) {
+            count = 0;
+        }
+
+        last_jobs = jobs;
+
         if (0 != jobs) {
             usleep(DELAY);
         }
@@ -137,9 +154,30 @@ static int _rfic_fpga_spinwait(struct bladerf *dev)
         jobs = BLADERF_ERR_TIMEOUT;
     }
 
+    if (0 == jobs) {
+        board_data->rfic_wq_pending = false;
+    }
+
     return jobs;
 }
 
+/* Commands that only adjust the RFIC's own configuration, and so may be left
+ * to complete in the background within a batch scope */
+static bool _rfic_cmd_deferrable(bladerf_rfic_command cmd)
+{
+    switch (cmd) {
+        case BLADERF_RFIC_COMMAND_FREQUENCY:
+        case BLADERF_RFIC_COMMAND_BANDWIDTH:
+        case BLADERF_RFIC_COMMAND_GAINMODE:
+        case BLADERF_RFIC_COMMAND_GAIN:
+        case BLADERF_RFIC_COMMAND_FILTER:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
 
 /******************************************************************************/
 /* Low level RFIC Accessors */
@@ -150,6 +188,13 @@ static int _rfic_cmd_read(struct bladerf *dev,
                           bladerf_rfic_command cmd,
                           uint64_t *data)
 {
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    /* Reads are not queued, so let earlier writes take effect first */
+    if (board_data->rfic_wq_pending && cmd != BLADERF_RFIC_COMMAND_STATUS) {
+        CHECK_STATUS(_rfic_fpga_spinwait(dev));
+    }
+
     return dev->backend->rfic_command_read(dev, RFIC_ADDRESS(cmd, ch), data);
 }
 
@@ -158,14 +203,37 @@ static int _rfic_cmd_write(struct bladerf *dev,
                            bladerf_rfic_command cmd,
                            uint64_t data)
 {
+    struct bladerf2_board_data *board_data = dev->board_data;
+
     /* Perform the write command. */
     CHECK_STATUS(
         dev->backend->rfic_command_write(dev, RFIC_ADDRESS(cmd, ch), data));
 
+    /* Within a batch scope, leave configuration changes queued in the FPGA so
+     * that subsequent ones may be sent along with them. This requires an FPGA
+     * that reports its queue capacity, as it also accepts batched commands
+     * and reports when its queue is full. */
+    if (board_data->batch_depth > 0 && board_data->rfic_wq_capacity > 0 &&
+        _rfic_cmd_deferrable(cmd)) {
+        board_data->rfic_wq_pending = true;
+        return 0;
+    }
+
     /* Block until the job has been completed. */
     return _rfic_fpga_spinwait(dev);
 }
 
+static int _rfic_fpga_wait_pending(struct bladerf *dev)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    if (!board_data->rfic_wq_pending) {
+        return 0;
+    }
+
+    return _rfic_fpga_spinwait(dev);
+}
+
 
 /******************************************************************************/
 /* Initialization */
@@ -687,7 +755,9 @@ static int _rfic_fpga_get_txmute(struct bladerf *dev,
         CHECK_STATUS(
             _rfic_cmd_read(dev, ch, BLADERF_RFIC_COMMAND_TXMUTE, &readval));
 
-        return (readval > 0);
+        *state = (readval > 0);
+
+        return 0;
     }
 
     return BLADERF_ERR_UNSUPPORTED;
@@ -706,10 +776,62 @@ static int _rfic_fpga_set_txmute(struct bladerf *dev,
 }
 
 
+/******************************************************************************/
+/* RF ports */
+/******************************************************************************/
+
+static int _rfic_fpga_get_rf_port(struct bladerf *dev,
+                                  bladerf_channel ch,
+                                  uint32_t *port_id)
+{
+    uint64_t readval;
+
+    CHECK_STATUS(
+        _rfic_cmd_read(dev, ch, BLADERF_RFIC_COMMAND_RFPORT, &readval));
+
+    *port_id = (uint32_t)readval;
+
+    return 0;
+}
+
+static int _rfic_fpga_set_rf_port(struct bladerf *dev,
+                                  bladerf_channel ch,
+                                  uint32_t port_id)
+{
+    return _rfic_cmd_write(dev, ch, BLADERF_RFIC_COMMAND_RFPORT, port_id);
+}
+
+
+/******************************************************************************/
+/* Temperature */
+/******************************************************************************/
+
+static int _rfic_fpga_get_temperature(struct bladerf *dev, float *val)
+{
+    uint64_t readval;
+
+    CHECK_STATUS(_rfic_cmd_read(dev, BLADERF_CHANNEL_INVALID,
+                                BLADERF_RFIC_COMMAND_TEMPERATURE, &readval));
+
+    *val = (int32_t)(uint32_t)readval / 1000.0F;
+
+    return 0;
+}
+
+static int _rfic_fpga_recalibrate(struct bladerf *dev, uint32_t cals)
+{
+    /* The FPGA's RFIC command set has no calibration commands */
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+
 /******************************************************************************/
 /* Fastlock */
 /******************************************************************************/
 
+/* Number of BLADERF_RFIC_COMMAND_FASTLOCK_DATA accesses per profile */
+#define FASTLOCK_DATA_WORDS (BLADERF_RFIC_FASTLOCK_PROFILE_LEN / 8)
+
 static int _rfic_fpga_store_fastlock_profile(struct bladerf *dev,
                                              bladerf_channel ch,
                                              uint32_t profile)
@@ -717,6 +839,52 @@ static int _rfic_fpga_store_fastlock_profile(struct bladerf *dev,
     return _rfic_cmd_write(dev, ch, BLADERF_RFIC_COMMAND_FASTLOCK, profile);
 }
 
+static int _rfic_fpga_save_fastlock_profile(struct bladerf *dev,
+                                            bladerf_channel ch,
+                                            uint32_t profile,
+                                            uint8_t *values)
+{
+    size_t i, j;
+
+    CHECK_STATUS(
+        _rfic_cmd_write(dev, ch, BLADERF_RFIC_COMMAND_FASTLOCK_SAVE, profile));
+
+    for (i = 0; i < FASTLOCK_DATA_WORDS; ++i) {
+        uint64_t readval;
+
+        CHECK_STATUS(_rfic_cmd_read(dev, ch, BLADERF_RFIC_COMMAND_FASTLOCK_DATA,
+                                    &readval));
+
+        for (j = 0; j < 8; ++j) {
+            values[i * 8 + j] = (uint8_t)(readval >> (j * 8));
+        }
+    }
+
+    return 0;
+}
+
+static int _rfic_fpga_load_fastlock_profile(struct bladerf *dev,
+                                            bladerf_channel ch,
+                                            uint32_t profile,
+                                            uint8_t *values)
+{
+    size_t i, j;
+
+    for (i = 0; i < FASTLOCK_DATA_WORDS; ++i) {
+        uint64_t data = 0;
+
+        for (j = 0; j < 8; ++j) {
+            data |= (uint64_t)values[i * 8 + j] << (j * 8);
+        }
+
+        CHECK_STATUS(_rfic_cmd_write(dev, ch,
+                                     BLADERF_RFIC_COMMAND_FASTLOCK_DATA, data));
+    }
+
+    return _rfic_cmd_write(dev, ch, BLADERF_RFIC_COMMAND_FASTLOCK_LOAD,
+                           profile);
+}
+
 
 /******************************************************************************/
 /* Function pointers */
@@ -739,6 +907,7 @@ struct controller_fns const rfic_fpga_control = {
 
     FIELD_INIT(.get_frequency, _rfic_fpga_get_frequency),
     FIELD_INIT(.set_frequency, _rfic_fpga_set_frequency),
+    FIELD_INIT(.set_frequency_begin, _rfic_fpga_set_frequency),
     FIELD_INIT(.select_band, _rfic_fpga_select_band),
 
     FIELD_INIT(.get_bandwidth, _rfic_fpga_get_bandwidth),
@@ -761,7 +930,17 @@ struct controller_fns const rfic_fpga_control = {
     FIELD_INIT(.get_txmute, _rfic_fpga_get_txmute),
     FIELD_INIT(.set_txmute, _rfic_fpga_set_txmute),
 
+    FIELD_INIT(.get_rf_port, _rfic_fpga_get_rf_port),
+    FIELD_INIT(.set_rf_port, _rfic_fpga_set_rf_port),
+
+    FIELD_INIT(.get_temperature, _rfic_fpga_get_temperature),
+    FIELD_INIT(.recalibrate, _rfic_fpga_recalibrate),
+
     FIELD_INIT(.store_fastlock_profile, _rfic_fpga_store_fastlock_profile),
+    FIELD_INIT(.save_fastlock_profile, _rfic_fpga_save_fastlock_profile),
+    FIELD_INIT(.load_fastlock_profile, _rfic_fpga_load_fastlock_profile),
+
+    FIELD_INIT(.wait_pending, _rfic_fpga_wait_pending),
 
     FIELD_INIT(.command_mode, RFIC_COMMAND_FPGA),
 };
@@ -30,10 +30,158 @@
 #include "helpers/wallclock.h"
 #include "iterators.h"
 #include "log.h"
+#include "rfic_cal_cache.h"
 
 // #define BLADERF_HOSTED_C_DEBUG
 
 
+/******************************************************************************/
+/* Helpers */
+/******************************************************************************/
+
+/* Precompute the gain settings of a direction's channels for the LO frequency
+ * it is now tuned to, following _rfic_host_set_gain() and
+ * _rfic_host_set_gain_stage() */
+static int _rfic_host_build_gain_tables(struct bladerf *dev,
+                                        bladerf_direction dir)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct ad9361_rf_phy *phy              = board_data->phy;
+    struct bladerf_gain_range const *overall, *stage;
+    struct rx_gain_info const *info = NULL;
+    bladerf_frequency frequency;
+    size_t i, j;
+
+    gain_table_invalidate(board_data, dir);
+
+    if (dir == BLADERF_TX) {
+        CHECK_AD936X(ad9361_get_tx_lo_freq(phy, &frequency));
+        stage = find_gain_range(BLADERF_CHANNEL_TX(0), "dsa", frequency);
+    } else {
+        CHECK_AD936X(ad9361_get_rx_lo_freq(phy, &frequency));
+        stage = find_gain_range(BLADERF_CHANNEL_RX(0), "full", frequency);
+
+        /* The gain table the driver loaded for this LO */
+        if (phy->current_table >= RXGAIN_TBLS_END ||
+            phy->rx_gain[phy->current_table].tbl_type != RXGAIN_FULL_TBL) {
+            return 0;
+        }
+
+        info = &phy->rx_gain[phy->current_table];
+    }
+
+    overall = find_gain_range(dir == BLADERF_TX ? BLADERF_CHANNEL_TX(0)
+                                                : BLADERF_CHANNEL_RX(0),
+                              NULL, frequency);
+
+    if (NULL == overall || NULL == stage) {
+        return 0;
+    }
+
+    for (i = 0; i < 2; ++i) {
+        bladerf_channel ch = (dir == BLADERF_TX) ? BLADERF_CHANNEL_TX(i)
+                                                 : BLADERF_CHANNEL_RX(i);
+        struct bladerf2_gain_table *table = &board_data->gain_table[ch];
+
+        for (j = 0; j < BLADERF2_GAIN_TABLE_LEN; ++j) {
+            int gain = BLADERF2_GAIN_TABLE_MIN + (int)j;
+            int val  = clamp_to_range(&overall->gain, gain) - overall->offset;
+
+            if (dir == BLADERF_TX) {
+                table->muted_atten[j] = -__scale_int(&stage->gain, val);
+
+                if (val < -89) {
+                    table->setting[j] = 89750;
+                } else {
+                    table->setting[j] = -__scale_int(
+                        &stage->gain, clamp_to_range(&stage->gain, val));
+                }
+            } else {
+                int gain_db = __scale_int(&stage->gain,
+                                          clamp_to_range(&stage->gain, val));
+
+                /* As the driver's set_full_table_gain() */
+                if (gain_db < info->starting_gain_db ||
+                    gain_db > info->max_gain_db) {
+                    table->setting[j] = -1;
+                } else {
+                    table->setting[j] =
+                        ((gain_db - info->starting_gain_db) /
+                         info->gain_step_db) +
+                        info->idx_step_offset;
+                }
+            }
+        }
+
+        table->valid = true;
+    }
+
+    return 0;
+}
+
+/* Follow an ad9361_init() with the calibration cache enabled. If results were
+ * restored from `cached`, and the RFIC is still near the temperature they were
+ * saved at, they are written back. Otherwise, the skipped calibration is run
+ * if need be, and the results are saved for next time. */
+static int _rfic_host_apply_cal_cache(struct bladerf *dev,
+                                      struct rfic_cal_key const *key,
+                                      struct rfic_cal_entry const *cached)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct ad9361_rf_phy *phy              = board_data->phy;
+    struct rfic_cal_entry entry;
+
+    if (cached != NULL) {
+        if (rfic_cal_cache_temperature_match(cached, ad9361_get_temp(phy))) {
+            log_debug("%s: restoring cached calibration results\n",
+                      __FUNCTION__);
+            return rfic_cal_cache_restore(phy, cached);
+        }
+
+        log_debug("%s: temperature has drifted, recalibrating\n",
+                  __FUNCTION__);
+        CHECK_AD936X(ad9361_do_calib(phy, AD936X_TX_QUAD_CAL, -1));
+    }
+
+    CHECK_STATUS(rfic_cal_cache_capture(phy, key, &entry));
+    rfic_cal_cache_store(dev, &entry);
+
+    return 0;
+}
+
+/* Select the AD9361 port for a frequency, unless it is already selected */
+static int _rfic_host_set_port(struct bladerf *dev,
+                               bladerf_channel ch,
+                               bool enabled,
+                               bladerf_frequency frequency)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct band_port_map const *port_map   = NULL;
+    size_t const dir = BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX : BLADERF_RX;
+
+    port_map = _get_band_port_map_by_freq(ch, enabled ? frequency : 0);
+
+    if (NULL == port_map) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (board_data->rfic_port_valid[dir] &&
+        board_data->rfic_port[dir] == port_map->rfic_port) {
+        return 0;
+    }
+
+    board_data->rfic_port_valid[dir] = false;
+
+    CHECK_STATUS(set_ad9361_port_by_freq(board_data->phy, ch, enabled,
+                                         frequency));
+
+    board_data->rfic_port[dir]       = port_map->rfic_port;
+    board_data->rfic_port_valid[dir] = true;
+
+    return 0;
+}
+
+
 /******************************************************************************/
 /* Initialization */
 /******************************************************************************/
@@ -81,6 +229,12 @@ static int _rfic_host_initialize(struct bladerf *dev)
     bladerf_channel ch;
     size_t i;
     uint32_t config_gpio;
+    bool const cal_cache = rfic_cal_cache_enabled();
+    bool cal_cached      = false;
+    struct rfic_cal_key cal_key;
+    struct rfic_cal_entry cal_entry;
+    struct platform_cal_skip cal_skip;
+    int status;
 
     log_debug("%s: initializating\n", __FUNCTION__);
 
@@ -95,8 +249,28 @@ static int _rfic_host_initialize(struct bladerf *dev)
                 (void *)&bladerf2_rfic_init_params_fastagc_burst :
                 (void *)&bladerf2_rfic_init_params;
 
-    /* Initialize AD9361 */
-    CHECK_AD936X(ad9361_init(&phy, (AD9361_InitParam *)board_data->rfic_init_params, dev));
+    /* Skip calibrations whose results were saved by an earlier open */
+    if (cal_cache) {
+        rfic_cal_cache_key(&cal_key, board_data->rfic_init_params);
+        cal_cached = rfic_cal_cache_load(dev, &cal_key, &cal_entry);
+    }
+
+    /* Initialize AD9361, queueing its SPI writes between delays and reads */
+    CHECK_STATUS(platform_spi_batch_begin(dev));
+
+    if (cal_cached) {
+        rfic_cal_cache_skip(&cal_entry, &cal_skip);
+        platform_spi_cal_skip_begin(dev, &cal_skip);
+    }
+
+    status = ad9361_init(&phy, (AD9361_InitParam *)board_data->rfic_init_params, dev);
+
+    platform_spi_cal_skip_end(dev);
+    CHECK_STATUS(platform_spi_batch_commit(dev));
+
+    if (status < 0) {
+        RETURN_ERROR_AD9361("ad9361_init", status);
+    }
 
     if (NULL == phy || NULL == phy->pdata) {
         RETURN_ERROR_STATUS("ad9361_init struct initialization",
@@ -107,6 +281,18 @@ static int _rfic_host_initialize(struct bladerf *dev)
 
     board_data->phy = phy;
 
+    if (cal_cache) {
+        CHECK_STATUS(_rfic_host_apply_cal_cache(
+            dev, &cal_key, cal_cached ? &cal_entry : NULL));
+    }
+
+    /* ad9361_init() has selected its default ports */
+    board_data->rfic_port_valid[BLADERF_RX] = false;
+    board_data->rfic_port_valid[BLADERF_TX] = false;
+    board_data->rfic_bbf_valid              = false;
+    gain_table_invalidate(board_data, BLADERF_RX);
+    gain_table_invalidate(board_data, BLADERF_TX);
+
     /* Force AD9361 to a non-default freq. This will entice it to do a
      * proper re-tuning when we set it back to the default freq later on. */
     FOR_EACH_DIRECTION(dir)
@@ -177,6 +363,10 @@ static int _rfic_host_deinitialize(struct bladerf *dev)
     reg &= ~(1 << RFFE_CONTROL_MIMO_TX_EN_1);
     CHECK_STATUS(dev->backend->rffe_control_write(dev, reg));
 
+    board_data->rfic_bbf_valid = false;
+    gain_table_invalidate(board_data, BLADERF_RX);
+    gain_table_invalidate(board_data, BLADERF_TX);
+
     if (NULL != board_data->phy) {
         CHECK_STATUS(ad9361_deinit(board_data->phy));
         board_data->phy = NULL;
@@ -311,7 +501,7 @@ static int _rfic_host_enable_module(struct bladerf *dev,
         }
 
         /* Select RFIC port */
-        CHECK_STATUS(set_ad9361_port_by_freq(phy, ch, dir_enable, freq));
+        CHECK_STATUS(_rfic_host_set_port(dev, ch, dir_enable, freq));
 
         /* Tear down sync interface if required */
         if (!dir_enable) {
@@ -391,17 +581,95 @@ static int _rfic_host_get_sample_rate(struct bladerf *dev,
     return 0;
 }
 
+/* Note that the baseband filters have just been calibrated for the current
+ * bandwidths */
+static void _rfic_host_bbf_calibrated(struct bladerf *dev)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct ad9361_rf_phy *phy              = board_data->phy;
+
+    board_data->rfic_bbf_valid =
+        ad9361_get_rx_rf_bandwidth(phy, &board_data->rfic_bbf_bw[BLADERF_RX]) >=
+            0 &&
+        ad9361_get_tx_rf_bandwidth(phy, &board_data->rfic_bbf_bw[BLADERF_TX]) >=
+            0;
+
+    board_data->rfic_bbf_temp = ad9361_get_temp(phy);
+}
+
+/* Returns true if the baseband filters were calibrated for the current
+ * bandwidths, at about the current temperature */
+static bool _rfic_host_bbf_current(struct bladerf *dev)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct ad9361_rf_phy *phy              = board_data->phy;
+    bladerf_bandwidth rx_bw, tx_bw;
+
+    if (!board_data->rfic_bbf_valid ||
+        ad9361_get_rx_rf_bandwidth(phy, &rx_bw) < 0 ||
+        ad9361_get_tx_rf_bandwidth(phy, &tx_bw) < 0) {
+        return false;
+    }
+
+    return rx_bw == board_data->rfic_bbf_bw[BLADERF_RX] &&
+           tx_bw == board_data->rfic_bbf_bw[BLADERF_TX] &&
+           rfic_cal_cache_temperatures_match(board_data->rfic_bbf_temp,
+                                             ad9361_get_temp(phy));
+}
+
 static int _rfic_host_set_sample_rate(struct bladerf *dev,
                                       bladerf_channel ch,
                                       bladerf_sample_rate rate)
 {
     struct bladerf2_board_data *board_data = dev->board_data;
     struct ad9361_rf_phy *phy              = board_data->phy;
+    struct platform_cal_skip cal_skip;
+    bladerf_sample_rate current;
+    bool skip_bbf;
+    int status;
+
+    /* Leave the clock chain alone if the rate is unchanged */
+    CHECK_STATUS(_rfic_host_get_sample_rate(dev, ch, &current));
+
+    if (rate == current) {
+        return 0;
+    }
+
+    /* The driver recalibrates the baseband filters after changing the clock
+     * chain. For unchanged bandwidths, this would only reproduce the settings
+     * they already have. */
+    skip_bbf = _rfic_host_bbf_current(dev);
+
+    if (skip_bbf) {
+        memset(&cal_skip, 0, sizeof(cal_skip));
+        cal_skip.ctrl_reg  = AD936X_REG_CALIBRATION_CTRL;
+        cal_skip.ctrl_mask = AD936X_RX_BB_TUNE_CAL | AD936X_TX_BB_TUNE_CAL;
+    }
+
+    /* Change the clock chain, queueing its SPI writes between delays and
+     * reads */
+    CHECK_STATUS(platform_spi_batch_begin(dev));
+
+    if (skip_bbf) {
+        platform_spi_cal_skip_begin(dev, &cal_skip);
+    }
 
     if (BLADERF_CHANNEL_IS_TX(ch)) {
-        CHECK_AD936X(ad9361_set_tx_sampling_freq(phy, rate));
+        status = ad9361_set_tx_sampling_freq(phy, rate);
     } else {
-        CHECK_AD936X(ad9361_set_rx_sampling_freq(phy, rate));
+        status = ad9361_set_rx_sampling_freq(phy, rate);
+    }
+
+    platform_spi_cal_skip_end(dev);
+    CHECK_STATUS(platform_spi_batch_commit(dev));
+
+    if (status < 0) {
+        board_data->rfic_bbf_valid = false;
+        RETURN_ERROR_AD9361("ad9361_set_sampling_freq", status);
+    }
+
+    if (!skip_bbf) {
+        _rfic_host_bbf_calibrated(dev);
     }
 
     return 0;
@@ -431,14 +699,20 @@ static int _rfic_host_get_frequency(struct bladerf *dev,
     return 0;
 }
 
-static int _rfic_host_set_frequency(struct bladerf *dev,
-                                    bladerf_channel ch,
-                                    bladerf_frequency frequency)
+/* Tune the LO. Unless `wait` is set, the driver's VCO lock check is answered
+ * as though the VCO had locked, leaving its calibration to run on while the
+ * caller gets on with something else. */
+static int _rfic_host_tune(struct bladerf *dev,
+                           bladerf_channel ch,
+                           bladerf_frequency frequency,
+                           bool wait)
 {
     struct bladerf2_board_data *board_data = dev->board_data;
     struct ad9361_rf_phy *phy              = board_data->phy;
     struct controller_fns const *rfic      = board_data->rfic;
     struct bladerf_range const *range      = NULL;
+    struct platform_cal_skip lock_skip;
+    int status;
 
     CHECK_STATUS(dev->board->get_frequency_range(dev, ch, &range));
 
@@ -449,27 +723,63 @@ static int _rfic_host_set_frequency(struct bladerf *dev,
     /* Set up band selection */
     CHECK_STATUS(rfic->select_band(dev, ch, frequency));
 
-    /* Change LO frequency */
+    if (!wait) {
+        memset(&lock_skip, 0, sizeof(lock_skip));
+        lock_skip.num_status    = 1;
+        lock_skip.status_reg[0] = BLADERF_CHANNEL_IS_TX(ch)
+                                      ? AD936X_REG_TX_CP_OVERRANGE_VCO_LOCK
+                                      : AD936X_REG_RX_CP_OVERRANGE_VCO_LOCK;
+        lock_skip.status_val[0] = AD936X_VCO_LOCK;
+    }
+
+    /* Change LO frequency, queueing the synthesizer writes */
+    CHECK_STATUS(platform_spi_batch_begin(dev));
+
+    if (!wait) {
+        platform_spi_cal_skip_begin(dev, &lock_skip);
+    }
+
     if (BLADERF_CHANNEL_IS_TX(ch)) {
-        CHECK_AD936X(ad9361_set_tx_lo_freq(phy, frequency));
+        status = ad9361_set_tx_lo_freq(phy, frequency);
     } else {
-        CHECK_AD936X(ad9361_set_rx_lo_freq(phy, frequency));
+        status = ad9361_set_rx_lo_freq(phy, frequency);
     }
 
-    return 0;
+    platform_spi_cal_skip_end(dev);
+    CHECK_STATUS(platform_spi_batch_commit(dev));
+
+    if (status < 0) {
+        RETURN_ERROR_AD9361("ad9361_set_lo_freq", status);
+    }
+
+    return _rfic_host_build_gain_tables(
+        dev, BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX : BLADERF_RX);
+}
+
+static int _rfic_host_set_frequency(struct bladerf *dev,
+                                    bladerf_channel ch,
+                                    bladerf_frequency frequency)
+{
+    return _rfic_host_tune(dev, ch, frequency, true);
+}
+
+static int _rfic_host_set_frequency_begin(struct bladerf *dev,
+                                          bladerf_channel ch,
+                                          bladerf_frequency frequency)
+{
+    return _rfic_host_tune(dev, ch, frequency, false);
 }
 
 static int _rfic_host_select_band(struct bladerf *dev,
                                   bladerf_channel ch,
                                   bladerf_frequency frequency)
 {
-    struct bladerf2_board_data *board_data = dev->board_data;
-    struct ad9361_rf_phy *phy              = board_data->phy;
-    uint32_t reg;
+    uint32_t reg, reg_old;
     size_t i;
 
     /* Read RFFE control register */
     CHECK_STATUS(dev->backend->rffe_control_read(dev, &reg));
+    reg_old = reg;
 
     /* Modify the SPDT bits. */
     /* We have to do this for all the channels sharing the same LO. */
@@ -480,12 +790,14 @@ static int _rfic_host_select_band(struct bladerf *dev,
             &reg, bch, _rffe_ch_enabled(reg, bch), frequency));
     }
 
-    /* Write RFFE control register */
-    CHECK_STATUS(dev->backend->rffe_control_write(dev, reg));
+    /* Write RFFE control register, unless retuning within the same band */
+    if (reg != reg_old) {
+        CHECK_STATUS(dev->backend->rffe_control_write(dev, reg));
+    }
 
     /* Set AD9361 port */
     CHECK_STATUS(
-        set_ad9361_port_by_freq(phy, ch, _rffe_ch_enabled(reg, ch), frequency));
+        _rfic_host_set_port(dev, ch, _rffe_ch_enabled(reg, ch), frequency));
 
     return 0;
 }
@@ -520,15 +832,34 @@ static int _rfic_host_set_bandwidth(struct bladerf *dev,
     struct ad9361_rf_phy *phy              = board_data->phy;
     struct controller_fns const *rfic      = board_data->rfic;
     struct bladerf_range const *range      = NULL;
+    bladerf_bandwidth current;
+    int status;
 
     CHECK_STATUS(dev->board->get_bandwidth_range(dev, ch, &range));
 
     bandwidth = (unsigned int)clamp_to_range(range, bandwidth);
 
-    if (BLADERF_CHANNEL_IS_TX(ch)) {
-        CHECK_AD936X(ad9361_set_tx_rf_bandwidth(phy, bandwidth));
-    } else {
-        CHECK_AD936X(ad9361_set_rx_rf_bandwidth(phy, bandwidth));
+    /* Changing the bandwidth recalibrates the baseband filters, which is
+     * pointless if it is unchanged */
+    CHECK_STATUS(rfic->get_bandwidth(dev, ch, &current));
+
+    if (bandwidth != current) {
+        CHECK_STATUS(platform_spi_batch_begin(dev));
+
+        if (BLADERF_CHANNEL_IS_TX(ch)) {
+            status = ad9361_set_tx_rf_bandwidth(phy, bandwidth);
+        } else {
+            status = ad9361_set_rx_rf_bandwidth(phy, bandwidth);
+        }
+
+        CHECK_STATUS(platform_spi_batch_commit(dev));
+
+        if (status < 0) {
+            board_data->rfic_bbf_valid = false;
+            RETURN_ERROR_AD9361("ad9361_set_rf_bandwidth", status);
+        }
+
+        _rfic_host_bbf_calibrated(dev);
     }
 
     if (actual != NULL) {
@@ -668,9 +999,45 @@ static int _rfic_host_set_gain(struct bladerf *dev,
     struct bladerf2_board_data *board_data = dev->board_data;
     struct ad9361_rf_phy *phy              = board_data->phy;
     struct controller_fns const *rfic      = board_data->rfic;
+    uint8_t const rfic_ch                  = ch >> 1;
     int val;
     float offset;
 
+    if (gain_table_covers(board_data, ch, gain)) {
+        struct bladerf2_gain_table const *table = &board_data->gain_table[ch];
+        size_t const idx = gain - BLADERF2_GAIN_TABLE_MIN;
+
+        if (BLADERF_CHANNEL_IS_TX(ch)) {
+            bool muted;
+
+            CHECK_STATUS(txmute_get(phy, ch, &muted));
+
+            if (muted) {
+                return txmute_set_cached(phy, ch, table->muted_atten[idx]);
+            }
+
+            CHECK_STATUS(platform_spi_batch_begin(dev));
+            val = ad9361_set_tx_attenuation(phy, rfic_ch, table->setting[idx]);
+            CHECK_STATUS(platform_spi_batch_commit(dev));
+            CHECK_AD936X(val);
+
+            return 0;
+        }
+
+        /* Outside of manual gain control, leave the driver to complain */
+        if (table->setting[idx] >= 0 &&
+            (rfic_ch == 0 ? phy->pdata->gain_ctrl.rx1_mode
+                          : phy->pdata->gain_ctrl.rx2_mode) == RF_GAIN_MGC) {
+            CHECK_AD936X(ad9361_spi_write(
+                phy->spi,
+                rfic_ch == 0 ? AD936X_REG_RX1_MANUAL_LMT_FULL_GAIN
+                             : AD936X_REG_RX2_MANUAL_LMT_FULL_GAIN,
+                table->setting[idx]));
+
+            return 0;
+        }
+    }
+
     CHECK_STATUS(get_gain_offset(dev, ch, &offset));
 
     val = gain - offset;
@@ -703,6 +1070,58 @@ static int _rfic_host_set_gain(struct bladerf *dev,
 /* These functions handle scaling */
 /******************************************************************************/
 
+static int _rfic_host_schedule_gain(struct bladerf *dev,
+                                    bladerf_channel ch,
+                                    bladerf_timestamp timestamp,
+                                    int gain)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct ad9361_rf_phy *phy              = board_data->phy;
+    struct bladerf2_gain_table const *table;
+    uint8_t const rfic_ch = ch >> 1;
+    size_t idx;
+    int32_t setting;
+
+    /* The Nios applies settings from the table, which goes stale after a
+     * scheduled retune until the next bladerf_set_frequency() */
+    if (!gain_table_covers(board_data, ch, gain)) {
+        log_debug("%s: no gain table for the current frequency\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    table = &board_data->gain_table[ch];
+    idx   = gain - BLADERF2_GAIN_TABLE_MIN;
+
+    if (BLADERF_CHANNEL_IS_TX(ch)) {
+        bool muted;
+
+        CHECK_STATUS(txmute_get(phy, ch, &muted));
+
+        /* Nothing to schedule; the attenuation applies once unmuted */
+        if (muted) {
+            return txmute_set_cached(phy, ch, table->muted_atten[idx]);
+        }
+
+        /* mdB to 0.25 dB steps */
+        setting = table->setting[idx] / 250;
+    } else {
+        if ((rfic_ch == 0 ? phy->pdata->gain_ctrl.rx1_mode
+                          : phy->pdata->gain_ctrl.rx2_mode) != RF_GAIN_MGC) {
+            log_debug("%s: RX gain changes require manual gain mode\n",
+                      __FUNCTION__);
+            return BLADERF_ERR_UNSUPPORTED;
+        }
+
+        setting = table->setting[idx];
+        if (setting < 0) {
+            RETURN_INVAL_ARG("gain", gain, "is not in the RX gain table");
+        }
+    }
+
+    return dev->backend->retune2_gain(dev, ch, timestamp, (uint16_t)setting);
+}
+
 static int _rfic_host_get_gain_stage(struct bladerf *dev,
                                      bladerf_channel ch,
                                      char const *stage,
@@ -858,6 +1277,7 @@ static int _rfic_host_set_filter(struct bladerf *dev,
 {
     struct bladerf2_board_data *board_data = dev->board_data;
     struct ad9361_rf_phy *phy              = board_data->phy;
+    int status;
 
     if (BLADERF_CHANNEL_IS_TX(ch)) {
         AD9361_TXFIRConfig *fir_config = NULL;
@@ -891,8 +1311,16 @@ static int _rfic_host_set_filter(struct bladerf *dev,
                 return BLADERF_ERR_UNEXPECTED;
         }
 
-        CHECK_AD936X(ad9361_set_tx_fir_config(phy, *fir_config));
-        CHECK_AD936X(ad9361_set_tx_fir_en_dis(phy, enable));
+        /* Queue the coefficient writes, rather than waiting on each */
+        CHECK_STATUS(platform_spi_batch_begin(dev));
+
+        status = ad9361_set_tx_fir_config(phy, *fir_config);
+        if (status >= 0) {
+            status = ad9361_set_tx_fir_en_dis(phy, enable);
+        }
+
+        CHECK_STATUS(platform_spi_batch_commit(dev));
+        CHECK_AD936X(status);
 
         board_data->txfir = txfir;
     } else {
@@ -927,8 +1355,16 @@ static int _rfic_host_set_filter(struct bladerf *dev,
                 return BLADERF_ERR_UNEXPECTED;
         }
 
-        CHECK_AD936X(ad9361_set_rx_fir_config(phy, *fir_config));
-        CHECK_AD936X(ad9361_set_rx_fir_en_dis(phy, enable));
+        /* Queue the coefficient writes, rather than waiting on each */
+        CHECK_STATUS(platform_spi_batch_begin(dev));
+
+        status = ad9361_set_rx_fir_config(phy, *fir_config);
+        if (status >= 0) {
+            status = ad9361_set_rx_fir_en_dis(phy, enable);
+        }
+
+        CHECK_STATUS(platform_spi_batch_commit(dev));
+        CHECK_AD936X(status);
 
         board_data->rxfir = rxfir;
     }
@@ -970,6 +1406,96 @@ static int _rfic_host_set_txmute(struct bladerf *dev,
 }
 
 
+/******************************************************************************/
+/* RF ports */
+/******************************************************************************/
+
+static int _rfic_host_get_rf_port(struct bladerf *dev,
+                                  bladerf_channel ch,
+                                  uint32_t *port_id)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct ad9361_rf_phy *phy              = board_data->phy;
+
+    if (BLADERF_CHANNEL_IS_TX(ch)) {
+        CHECK_AD936X(ad9361_get_tx_rf_port_output(phy, port_id));
+    } else {
+        CHECK_AD936X(ad9361_get_rx_rf_port_input(phy, port_id));
+    }
+
+    return 0;
+}
+
+static int _rfic_host_set_rf_port(struct bladerf *dev,
+                                  bladerf_channel ch,
+                                  uint32_t port_id)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct ad9361_rf_phy *phy              = board_data->phy;
+
+    if (BLADERF_CHANNEL_IS_TX(ch)) {
+        CHECK_AD936X(ad9361_set_tx_rf_port_output(phy, port_id));
+    } else {
+        CHECK_AD936X(ad9361_set_rx_rf_port_input(phy, port_id));
+    }
+
+    return 0;
+}
+
+
+/******************************************************************************/
+/* Temperature */
+/******************************************************************************/
+
+static int _rfic_host_get_temperature(struct bladerf *dev, float *val)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+
+    *val = ad9361_get_temp(board_data->phy) / 1000.0F;
+
+    return 0;
+}
+
+static int _rfic_host_recalibrate(struct bladerf *dev, uint32_t cals)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct ad9361_rf_phy *phy              = board_data->phy;
+    bladerf_frequency frequency            = 0;
+    bladerf_direction dir;
+    int status = 0;
+
+    /* Retuning to the current frequency re-runs the VCO calibrations */
+    if (cals & BLADERF_RECAL_SYNTH) {
+        FOR_EACH_DIRECTION(dir)
+        {
+            bladerf_channel const ch = (BLADERF_TX == dir)
+                                           ? BLADERF_CHANNEL_TX(0)
+                                           : BLADERF_CHANNEL_RX(0);
+
+            CHECK_STATUS(_rfic_host_get_frequency(dev, ch, &frequency));
+            CHECK_STATUS(_rfic_host_tune(dev, ch, frequency, true));
+        }
+    }
+
+    if (cals & (BLADERF_RECAL_RX_DC | BLADERF_RECAL_TX_QUAD)) {
+        CHECK_STATUS(platform_spi_batch_begin(dev));
+
+        if (cals & BLADERF_RECAL_RX_DC) {
+            status = ad9361_do_calib(phy, AD936X_RFDC_CAL, -1);
+        }
+
+        if (status >= 0 && (cals & BLADERF_RECAL_TX_QUAD)) {
+            status = ad9361_do_calib(phy, AD936X_TX_QUAD_CAL, -1);
+        }
+
+        CHECK_STATUS(platform_spi_batch_commit(dev));
+        CHECK_AD936X(status);
+    }
+
+    return 0;
+}
+
+
 /******************************************************************************/
 /* Fastlock */
 /******************************************************************************/
@@ -1007,6 +1533,23 @@ static int _rfic_host_save_fastlock_profile(struct bladerf *dev,
     return 0;
 }
 
+static int _rfic_host_load_fastlock_profile(struct bladerf *dev,
+                                            bladerf_channel ch,
+                                            uint32_t profile,
+                                            uint8_t *values)
+{
+    struct bladerf2_board_data *board_data = dev->board_data;
+    struct ad9361_rf_phy *phy              = board_data->phy;
+
+    if (BLADERF_CHANNEL_IS_TX(ch)) {
+        CHECK_AD936X(ad9361_tx_fastlock_load(phy, profile, values));
+    } else {
+        CHECK_AD936X(ad9361_rx_fastlock_load(phy, profile, values));
+    }
+
+    return 0;
+}
+
 
 /******************************************************************************/
 /* Function pointers */
@@ -1029,6 +1572,7 @@ struct controller_fns const rfic_host_control = {
 
     FIELD_INIT(.get_frequency, _rfic_host_get_frequency),
     FIELD_INIT(.set_frequency, _rfic_host_set_frequency),
+    FIELD_INIT(.set_frequency_begin, _rfic_host_set_frequency_begin),
     FIELD_INIT(.select_band, _rfic_host_select_band),
 
     FIELD_INIT(.get_bandwidth, _rfic_host_get_bandwidth),
@@ -1051,8 +1595,17 @@ struct controller_fns const rfic_host_control = {
     FIELD_INIT(.get_txmute, _rfic_host_get_txmute),
     FIELD_INIT(.set_txmute, _rfic_host_set_txmute),
 
+    FIELD_INIT(.get_rf_port, _rfic_host_get_rf_port),
+    FIELD_INIT(.set_rf_port, _rfic_host_set_rf_port),
+
+    FIELD_INIT(.get_temperature, _rfic_host_get_temperature),
+    FIELD_INIT(.recalibrate, _rfic_host_recalibrate),
+
     FIELD_INIT(.store_fastlock_profile, _rfic_host_store_fastlock_profile),
     FIELD_INIT(.save_fastlock_profile, _rfic_host_save_fastlock_profile),
+    FIELD_INIT(.load_fastlock_profile, _rfic_host_load_fastlock_profile),
+
+    FIELD_INIT(.schedule_gain, _rfic_host_schedule_gain),
 
     FIELD_INIT(.command_mode, RFIC_COMMAND_HOST),
 };
@@ -11,3 +11,5 @@ const struct board_fns *bladerf_boards[] = {
 };
 
 const unsigned int bladerf_boards_len = ARRAY_SIZE(bladerf_boards);
+
+bool bladerf_warm_open = false;
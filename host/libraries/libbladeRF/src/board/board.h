@@ -161,6 +161,126 @@
  */
 #define BLADERF_CAP_FPGA_8BIT_SAMPLES (((uint64_t)1) << 39)
 
+/**
+ * FX3 firmware v2.5.0 introduced multi-page SPI flash reads and writes, and
+ * computing the CRC-32 of SPI flash contents.
+ */
+#define BLADERF_CAP_FW_FLASH_PAGES (((uint64_t)1) << 40)
+
+/**
+ * FPGA v0.16.0 introduced the RX NCO and decimation stage.
+ */
+#define BLADERF_CAP_FPGA_RX_DECIMATION (((uint64_t)1) << 41)
+
+/**
+ * FPGA v0.17.0 introduced looped TX waveform playback from on-chip RAM.
+ */
+#define BLADERF_CAP_FPGA_TX_WAVEFORM (((uint64_t)1) << 42)
+
+/**
+ * FPGA v0.17.0 introduced the RX power meter and sample snapshot on the
+ * bladeRF 2.0 Micro, and FPGA v0.16.0 on the bladeRF x40 and x115.
+ */
+#define BLADERF_CAP_FPGA_RX_POWER_METER (((uint64_t)1) << 43)
+
+/**
+ * FPGA v0.16.0 on the bladeRF x40 and x115 introduced the NIOS II RX DC
+ * calibration sweep.
+ */
+#define BLADERF_CAP_FPGA_RX_DC_SWEEP (((uint64_t)1) << 44)
+
+/**
+ * FX3 firmware v2.5.0 introduced setting the number of RF link DMA buffers.
+ */
+#define BLADERF_CAP_FW_DMA_BUFFERS (((uint64_t)1) << 45)
+
+/**
+ * FPGA v0.17.0 on the bladeRF 2.0 Micro introduced the 12-bit packed sample
+ * formats.
+ */
+#define BLADERF_CAP_FPGA_SC12_PACKED (((uint64_t)1) << 46)
+
+/**
+ * FPGA v0.17.1 on the bladeRF 2.0 Micro introduced gain changes in the
+ * scheduled retune queue.
+ */
+#define BLADERF_CAP_SCHEDULED_GAIN (((uint64_t)1) << 47)
+
+/**
+ * FPGA v0.16.1 on the bladeRF 1 and FPGA v0.17.2 on the bladeRF 2.0 Micro
+ * introduced retune queue queries and selective cancellation, and keep the
+ * queue in timestamp order.
+ */
+#define BLADERF_CAP_RETUNE_QUEUE_CONTROL (((uint64_t)1) << 48)
+
+/**
+ * FPGA v0.17.3 on the bladeRF 2.0 Micro introduced RX metadata messages that
+ * span multiple DMA buffers.
+ */
+#define BLADERF_CAP_FPGA_RX_META_MSG_SIZE (((uint64_t)1) << 49)
+
+/**
+ * FPGA v0.16.2 on the bladeRF 1 and FPGA v0.17.4 on the bladeRF 2.0 Micro
+ * introduced peripheral writes scheduled through the retune queue.
+ */
+#define BLADERF_CAP_TIMED_WRITE (((uint64_t)1) << 50)
+
+/**
+ * FPGA v0.16.3 on the bladeRF 1 introduced VCTCXO tamer status reporting, and
+ * acquisition seeded with the stored trim.
+ */
+#define BLADERF_CAP_VCTCXO_TAMER_STATUS (((uint64_t)1) << 51)
+
+/**
+ * FPGA v0.16.4 on the bladeRF 1 introduced latching of the time at which a
+ * trigger fires.
+ */
+#define BLADERF_CAP_TRIGGER_TIME (((uint64_t)1) << 52)
+
+/**
+ * FX3 firmware v2.6.0 introduced reading a batch of firmware log entries per
+ * vendor request.
+ */
+#define BLADERF_CAP_FW_LOG_ENTRIES (((uint64_t)1) << 53)
+
+/**
+ * FPGA v0.16.5 on the bladeRF 1 introduced running the LMS6002D DC offset
+ * calibrations on the NIOS II.
+ */
+#define BLADERF_CAP_NIOS_LMS_DC_CAL (((uint64_t)1) << 54)
+
+/**
+ * FX3 firmware v2.7.0 introduced setting the number of DMA buffers of each
+ * RF sample channel separately, without restarting the RF link.
+ */
+#define BLADERF_CAP_FW_DMA_CHANNELS (((uint64_t)1) << 55)
+
+/**
+ * FPGA v0.16.6 (bladeRF x40/x115) and v0.17.5 (bladeRF 2.0 Micro) added a
+ * gate that holds RX samples back until a scheduled timestamp.
+ */
+#define BLADERF_CAP_FPGA_RX_GATE (((uint64_t)1) << 56)
+
+/**
+ * FPGA v0.16.7 (bladeRF x40/x115) and v0.17.6 (bladeRF 2.0 Micro) added
+ * periodic RX bursts to the RX gate.
+ */
+#define BLADERF_CAP_FPGA_RX_BURSTS (((uint64_t)1) << 57)
+
+/**
+ * FPGA v0.16.8 (bladeRF x40/x115) and v0.17.7 (bladeRF 2.0 Micro) return
+ * the DAC to zero on their own when a TX metadata stream runs out of
+ * samples, so bursts need not end with zero samples.
+ */
+#define BLADERF_CAP_FPGA_TX_IDLE_ZERO (((uint64_t)1) << 58)
+
+/**
+ * FPGA v0.16.9 (bladeRF x40/x115) and v0.17.8 (bladeRF 2.0 Micro) count RX
+ * FIFO overflows and TX FIFO underflows, and keep the timestamp of the
+ * latest of each.
+ */
+#define BLADERF_CAP_FPGA_STREAM_STATS (((uint64_t)1) << 59)
+
 /**
  * Max number of gain calibration tables associated to max number of channels
  */
@@ -171,6 +291,10 @@ struct bladerf {
      * operations */
     MUTEX lock;
 
+    /* Number of latency-critical operations blocked on `lock`. Accessed
+     * atomically. See helpers/dev_lock.h. */
+    unsigned int urgent_waiters;
+
     /* Identifying information */
     struct bladerf_devinfo ident;
 
@@ -200,6 +324,114 @@ struct bladerf {
 
     /* Calibration */
     struct bladerf_gain_cal_tbl gain_tbls[NUM_GAIN_CAL_TBLS];
+
+    /* Gain correction lookup tables, indexed as gain_tbls. Entries may
+     * point to the same table. */
+    struct gain_cal_lut *gain_luts[NUM_GAIN_CAL_TBLS];
+    bladerf_frequency gain_cal_resolution;
+
+    /* Mapped gain calibration files, whose entries the corresponding
+     * gain_tbls use in place. `data` is NULL if the table was not mapped. */
+    struct {
+        const uint8_t *data;
+        size_t len;
+    } gain_maps[NUM_GAIN_CAL_TBLS];
+
+    /* Timestamp correlation services, indexed by direction. These are not
+     * protected by `lock`, which the services acquire to sample the
+     * timestamp, but by ts_corr_lock. */
+    MUTEX ts_corr_lock;
+    struct timestamp_corr *ts_corr[2];
+
+    /* Worker for the asynchronous control API, started on first use.
+     * Protected by ctrl_queue_lock, for the same reason as ts_corr. Once
+     * ctrl_queue_closing is set by bladerf_close(), no further operations
+     * are accepted. */
+    MUTEX ctrl_queue_lock;
+    struct ctrl_queue *ctrl_queue;
+    bool ctrl_queue_closing;
+
+    /* Scheduler for timestamped TX bursts, started on first use, along with
+     * the TX configuration last applied via bladerf_sync_config(). Protected
+     * by tx_sched_lock, for the same reason as ts_corr. */
+    MUTEX tx_sched_lock;
+    struct tx_sched *tx_sched;
+    bool tx_sync_configured;
+    bladerf_format tx_sync_format;
+    size_t tx_sync_channels;
+
+    /* History of recent RX buffers, along with the RX configuration last
+     * applied via bladerf_sync_config(). Protected by rx_history_lock, for
+     * the same reason as ts_corr. */
+    MUTEX rx_history_lock;
+    struct rx_history *rx_history;
+    bool rx_sync_configured;
+    bladerf_format rx_sync_format;
+    size_t rx_sync_channels;
+
+    /* Frequency hop tables, indexed by channel. Protected by hop_lock, for
+     * the same reason as ts_corr. */
+    MUTEX hop_lock;
+    struct hop_table *hop_table[4];
+
+    /* Telemetry sampler, or NULL if not running. Protected by
+     * telemetry_lock, for the same reason as ts_corr. */
+    MUTEX telemetry_lock;
+    struct telemetry *telemetry;
+
+    /* Metrics publisher, or NULL if not running. Protected by metrics_lock,
+     * for the same reason as ts_corr. */
+    MUTEX metrics_lock;
+    struct metrics *metrics;
+
+    /* Quick tune caches used by bladerf_set_frequency(), indexed by channel.
+     * Protected by `lock`. */
+    struct tune_cache *tune_cache[4];
+
+    /* Host-side RX corrections, indexed by RX channel number, or NULL where
+     * disabled. Protected by host_corr_lock, which the sync interface takes
+     * to copy them whenever host_corr_gen has changed. host_corr_gen is
+     * incremented on each change, and is accessed atomically. */
+    MUTEX host_corr_lock;
+    unsigned int host_corr_gen;
+    struct host_corr *host_corr[2];
+
+    /* RX AGC state, indexed by RX channel number, or NULL where disabled.
+     * Protected by agc_lock, which is taken before `lock`. agc_count is the
+     * number of channels with the AGC enabled, and is accessed atomically so
+     * that sync RX calls skip the lock when it is 0. */
+    MUTEX agc_lock;
+    struct agc *agc[2];
+    unsigned int agc_count;
+
+    /* Stream recovery, enabled by bladerf_enable_stream_recovery(), and the
+     * profile saved then. Protected by recovery_lock, which is taken before
+     * `lock`. recovery_gen counts the recoveries so far, and is accessed
+     * atomically. */
+    MUTEX recovery_lock;
+    bool recovery;
+    uint8_t recovery_profile[BLADERF_PROFILE_MAX_LEN];
+    size_t recovery_profile_len;
+    unsigned int recovery_gen;
+
+    /* Stream memory pool set by bladerf_set_stream_pool(), or NULL if none.
+     * Protected by `lock`. */
+    struct stream_pool *stream_pool;
+
+    /* BLADERF_STREAM_MEM_* flags set by bladerf_set_stream_memory_flags(),
+     * applied to streams as they are initialized. Accessed atomically. */
+    uint32_t stream_mem_flags;
+
+    /* Formats the sync interface may fall back to on a USB 2.0 link, set by
+     * bladerf_set_sync_link_adaptation(), and the format each direction was
+     * last configured with. Protected by `lock`. */
+    uint32_t sync_link_adapt;
+    bladerf_format sync_format[2];
+    bool sync_format_valid[2];
+
+    /* Set by bladerf_net_serve_stop() to end bladerf_net_serve(). Accessed
+     * atomically. */
+    int net_serve_stop;
 };
 
 struct board_fns {
@@ -298,6 +530,12 @@ struct board_fns {
     int (*set_frequency)(struct bladerf *dev,
                          bladerf_channel ch,
                          bladerf_frequency frequency);
+    /* As set_frequency, but without waiting for the synthesizer to lock,
+     * where the board allows it */
+    int (*set_frequency_begin)(struct bladerf *dev,
+                               bladerf_channel ch,
+                               bladerf_frequency frequency);
+    int (*get_pll_lock)(struct bladerf *dev, bladerf_channel ch, bool *locked);
     int (*get_frequency_range)(struct bladerf *dev,
                                bladerf_channel ch,
                                const struct bladerf_range **range);
@@ -321,12 +559,35 @@ struct board_fns {
     int (*get_quick_tune)(struct bladerf *dev,
                           bladerf_channel ch,
                           struct bladerf_quick_tune *quick_tune);
+    /* As get_quick_tune, but reusing any device resources (such as a fast
+     * lock profile) held by a `quick_tune` previously filled in by
+     * get_quick_tune for the same channel */
+    int (*update_quick_tune)(struct bladerf *dev,
+                             bladerf_channel ch,
+                             struct bladerf_quick_tune *quick_tune);
     int (*schedule_retune)(struct bladerf *dev,
                            bladerf_channel ch,
                            bladerf_timestamp timestamp,
                            bladerf_frequency frequency,
                            struct bladerf_quick_tune *quick_tune);
     int (*cancel_scheduled_retunes)(struct bladerf *dev, bladerf_channel ch);
+    int (*cancel_scheduled_retunes_range)(struct bladerf *dev,
+                                          bladerf_channel ch,
+                                          bladerf_timestamp start,
+                                          bladerf_timestamp end,
+                                          unsigned int *canceled);
+    int (*get_retune_queue_status)(struct bladerf *dev,
+                                   bladerf_channel ch,
+                                   struct bladerf_retune_queue_status *status);
+    int (*schedule_write)(struct bladerf *dev,
+                          bladerf_channel ch,
+                          bladerf_timestamp timestamp,
+                          bladerf_timed_write_target target,
+                          uint32_t value);
+
+    /* Temperature, for boards with a sensor in the RFIC. Called with the
+     * device lock held. */
+    int (*get_rfic_temperature)(struct bladerf *dev, float *val);
 
     /* DC/Phase/Gain Correction */
     int (*get_correction)(struct bladerf *dev,
@@ -357,6 +618,9 @@ struct board_fns {
                          bool *fire_requested,
                          uint64_t *resv1,
                          uint64_t *resv2);
+    int (*get_trigger_time)(struct bladerf *dev,
+                            const struct bladerf_trigger *trigger,
+                            struct bladerf_trigger_time *time);
 
     /* Streaming */
     int (*enable_module)(struct bladerf *dev, bladerf_channel ch, bool enable);
@@ -368,7 +632,8 @@ struct board_fns {
                        bladerf_format format,
                        size_t samples_per_buffer,
                        size_t num_transfers,
-                       void *user_data);
+                       void *user_data,
+                       const struct bladerf_buffer_allocator *allocator);
     int (*stream)(struct bladerf_stream *stream, bladerf_channel_layout layout);
     int (*submit_stream_buffer)(struct bladerf_stream *stream,
                                 void *buffer,
@@ -381,6 +646,31 @@ struct board_fns {
     int (*get_stream_timeout)(struct bladerf *dev,
                               bladerf_direction dir,
                               unsigned int *timeout);
+    int (*set_sync_wait_policy)(struct bladerf *dev,
+                                bladerf_direction dir,
+                                bladerf_sync_wait_policy policy,
+                                unsigned int spin_us);
+    int (*get_stream_stats)(struct bladerf *dev,
+                            bladerf_direction dir,
+                            struct bladerf_stream_stats *stats);
+    int (*set_sync_thread_attrs)(struct bladerf *dev,
+                                 bladerf_direction dir,
+                                 const struct bladerf_thread_attrs *attrs);
+    int (*set_sync_buffer_allocator)(
+        struct bladerf *dev,
+        bladerf_direction dir,
+        const struct bladerf_buffer_allocator *allocator);
+    int (*set_sync_rx_pool)(struct bladerf *dev, bool enable);
+    int (*set_sync_tx_pool)(struct bladerf *dev, bool enable);
+    int (*set_sync_rx_stats)(struct bladerf *dev,
+                             bool enable,
+                             unsigned int clip_threshold);
+    int (*get_sync_rx_stats)(struct bladerf *dev,
+                             struct bladerf_rx_stats *stats);
+    int (*set_sync_rx_tap)(struct bladerf *dev,
+                           const struct bladerf_sync_rx_tap *tap);
+    int (*set_sync_rx_meta_msg_size)(struct bladerf *dev, unsigned int size);
+    int (*get_sync_rx_meta_msg_size)(struct bladerf *dev, unsigned int *size);
     int (*sync_config)(struct bladerf *dev,
                        bladerf_channel_layout layout,
                        bladerf_format format,
@@ -398,12 +688,72 @@ struct board_fns {
                    unsigned int num_samples,
                    struct bladerf_metadata *metadata,
                    unsigned int timeout_ms);
+    int (*sync_tx_nb)(struct bladerf *dev,
+                      const void *samples,
+                      unsigned int num_samples,
+                      struct bladerf_metadata *metadata);
+    int (*sync_rx_nb)(struct bladerf *dev,
+                      void *samples,
+                      unsigned int num_samples,
+                      struct bladerf_metadata *metadata);
+    int (*sync_get_ready_fd)(struct bladerf *dev,
+                             bladerf_direction dir,
+                             bladerf_ready_fd *fd);
+    int (*sync_rx_acquire)(struct bladerf *dev,
+                           void **buffer,
+                           unsigned int *num_samples,
+                           struct bladerf_metadata *metadata,
+                           unsigned int timeout_ms);
+    int (*sync_rx_release)(struct bladerf *dev, void *buffer);
+    int (*sync_prearm)(struct bladerf *dev, bladerf_direction dir);
+    int (*sync_tx_acquire)(struct bladerf *dev,
+                           void **buffer,
+                           unsigned int *num_samples,
+                           unsigned int timeout_ms);
+    int (*sync_tx_submit)(struct bladerf *dev,
+                          void *buffer,
+                          unsigned int num_samples);
+    int (*sync_tx_reserve)(struct bladerf *dev,
+                           void **buffer,
+                           unsigned int *num_samples,
+                           uint64_t *position,
+                           unsigned int timeout_ms);
+    int (*sync_tx_multi)(struct bladerf *dev,
+                         const void *const *bufs,
+                         unsigned int num_samples,
+                         struct bladerf_metadata *metadata,
+                         unsigned int timeout_ms);
+    int (*sync_rx_multi)(struct bladerf *dev,
+                         void *const *bufs,
+                         unsigned int num_samples,
+                         struct bladerf_metadata *metadata,
+                         unsigned int timeout_ms);
+    int (*sync_rx_packets)(struct bladerf *dev,
+                           struct bladerf_packet *packets,
+                           unsigned int num_packets,
+                           unsigned int *num_received,
+                           unsigned int timeout_ms);
+    int (*sync_tx_packets)(struct bladerf *dev,
+                           const struct bladerf_packet *packets,
+                           unsigned int num_packets,
+                           unsigned int *num_sent,
+                           unsigned int timeout_ms);
+    int (*sync_create_tx_template)(struct bladerf *dev,
+                                   const void *samples,
+                                   unsigned int num_samples,
+                                   struct bladerf_tx_template **tmpl);
+    int (*sync_tx_template)(struct bladerf *dev,
+                            struct bladerf_tx_template *tmpl,
+                            bladerf_timestamp timestamp,
+                            unsigned int timeout_ms);
+    int (*sync_free_tx_template)(struct bladerf *dev,
+                                 struct bladerf_tx_template *tmpl);
     int (*get_timestamp)(struct bladerf *dev,
                          bladerf_direction dir,
                          bladerf_timestamp *timestamp);
 
     /* FPGA/Firmware Loading/Flashing */
-    int (*load_fpga)(struct bladerf *dev, const uint8_t *buf, size_t length);
+    int (*load_fpga)(struct bladerf *dev, struct fpga_image *image);
     int (*flash_fpga)(struct bladerf *dev, const uint8_t *buf, size_t length);
     int (*erase_stored_fpga)(struct bladerf *dev);
     int (*flash_firmware)(struct bladerf *dev,
@@ -425,11 +775,48 @@ struct board_fns {
     int (*get_rx_mux)(struct bladerf *dev, bladerf_rx_mux *mode);
     int (*set_rx_mux)(struct bladerf *dev, bladerf_rx_mux mode);
 
+    /* RX FPGA decimation */
+    int (*set_rx_decimation)(struct bladerf *dev,
+                             unsigned int decimation,
+                             int32_t nco_offset);
+    int (*get_rx_decimation)(struct bladerf *dev,
+                             unsigned int *decimation,
+                             int32_t *nco_offset);
+
+    /* TX waveform playback */
+    int (*tx_load_waveform)(struct bladerf *dev,
+                            const int16_t *samples,
+                            unsigned int num_samples);
+    int (*tx_loop_start)(struct bladerf *dev, unsigned int interpolation);
+    int (*tx_loop_stop)(struct bladerf *dev);
+
+    /* RX power measurement */
+    int (*measure_rx_power)(struct bladerf *dev,
+                            bladerf_channel ch,
+                            unsigned int num_samples,
+                            struct bladerf_rx_power *power);
+    int (*rx_snapshot)(struct bladerf *dev,
+                       bladerf_channel ch,
+                       int16_t *samples,
+                       unsigned int num_samples);
+
+    /* Scheduled RX start */
+    int (*schedule_rx)(struct bladerf *dev,
+                       bladerf_timestamp timestamp,
+                       unsigned int num_samples);
+    int (*schedule_rx_bursts)(struct bladerf *dev,
+                              bladerf_timestamp timestamp,
+                              unsigned int burst_len,
+                              unsigned int period);
+    int (*cancel_rx_schedule)(struct bladerf *dev);
+
     /* Low-level VCTCXO Tamer Mode */
     int (*set_vctcxo_tamer_mode)(struct bladerf *dev,
                                  bladerf_vctcxo_tamer_mode mode);
     int (*get_vctcxo_tamer_mode)(struct bladerf *dev,
                                  bladerf_vctcxo_tamer_mode *mode);
+    int (*get_vctcxo_tamer_status)(
+        struct bladerf *dev, struct bladerf_vctcxo_tamer_status *status);
 
     /* Low-level VCTCXO Trim DAC access */
     int (*get_vctcxo_trim)(struct bladerf *dev, uint16_t *trim);
@@ -454,6 +841,10 @@ struct board_fns {
     int (*config_gpio_read)(struct bladerf *dev, uint32_t *val);
     int (*config_gpio_write)(struct bladerf *dev, uint32_t val);
 
+    /* Control request batching */
+    int (*batch_begin)(struct bladerf *dev);
+    int (*batch_commit)(struct bladerf *dev);
+
     /* Low-level SPI flash access */
     int (*erase_flash)(struct bladerf *dev,
                        uint32_t erase_block,
@@ -492,4 +883,8 @@ struct bladerf_flash_arch {
 extern const struct board_fns *bladerf_boards[];
 extern const unsigned int bladerf_boards_len;
 
+/* Skip initialization of previously initialized devices on open. See
+ * bladerf_set_warm_open(). */
+extern bool bladerf_warm_open;
+
 #endif
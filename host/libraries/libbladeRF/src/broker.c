@@ -0,0 +1,764 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <libbladeRF.h>
+
+#include "log.h"
+
+#if defined(WIN32) || defined(__CYGWIN__)
+
+int bladerf_broker_start(struct bladerf *dev,
+                         struct bladerf_broker **broker,
+                         const char *name,
+                         bladerf_channel_layout layout,
+                         bladerf_format format,
+                         unsigned int num_buffers,
+                         unsigned int buffer_size,
+                         unsigned int timeout_ms)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int bladerf_broker_stop(struct bladerf_broker *broker)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int bladerf_broker_attach(struct bladerf_broker_reader **reader,
+                          const char *name)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+void bladerf_broker_detach(struct bladerf_broker_reader *reader)
+{
+}
+
+int bladerf_broker_get_config(struct bladerf_broker_reader *reader,
+                              bladerf_channel_layout *layout,
+                              bladerf_format *format,
+                              unsigned int *buffer_size)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int bladerf_broker_acquire(struct bladerf_broker_reader *reader,
+                           const void **samples,
+                           unsigned int *num_samples,
+                           struct bladerf_metadata *metadata,
+                           unsigned int timeout_ms)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int bladerf_broker_release(struct bladerf_broker_reader *reader)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+#else
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "streaming/format.h"
+
+#define BROKER_MAGIC 0x424c4442 /* "BLDB" */
+#define BROKER_VERSION 1
+
+#define BROKER_NAME_MAX 64
+
+typedef enum {
+    BROKER_STATE_RUNNING,
+    BROKER_STATE_STOPPED,
+    BROKER_STATE_ERROR,
+} broker_state;
+
+/* Per-reader cursor. A slot is free when its pid is 0. */
+struct broker_reader_slot {
+    int32_t pid;
+    bool held;       /* A buffer has been acquired and not released */
+    uint64_t cursor; /* Sequence number of the next buffer to acquire */
+    uint64_t overruns;
+};
+
+/* Description of a buffer in the ring. Sequence numbers start at 1, and a
+ * seq of 0 denotes a buffer that is being written. */
+struct broker_buffer {
+    uint64_t seq;
+    uint64_t timestamp;
+    uint64_t host_timestamp;
+    uint32_t status;
+    uint32_t num_samples;
+};
+
+/* Start of the shared memory object, mapped read/write by all processes.
+ * The samples follow at data_offset, and are mapped read-only by readers.
+ *
+ * Everything below `lock` is protected by it. */
+struct broker_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t header_size;
+    int32_t publisher_pid;
+
+    uint32_t layout;
+    uint32_t format;
+    uint32_t num_buffers;
+    uint32_t buffer_size;
+    uint64_t buffer_bytes;
+    uint64_t data_offset;
+
+    pthread_mutex_t lock;
+    pthread_cond_t published;
+
+    uint32_t state;
+    int32_t status; /* Error that stopped the stream */
+    uint64_t head;  /* Sequence number of the most recent buffer */
+
+    struct broker_reader_slot readers[BLADERF_BROKER_MAX_READERS];
+    struct broker_buffer buffers[];
+};
+
+struct bladerf_broker {
+    struct bladerf *dev;
+    char shm_name[BROKER_NAME_MAX];
+    bool meta;
+    unsigned int timeout_ms;
+
+    struct broker_header *hdr;
+    size_t map_size;
+    uint8_t *data;
+
+    pthread_t thread;
+    bool running; /* Protected by hdr->lock */
+};
+
+struct bladerf_broker_reader {
+    struct broker_header *hdr;
+    size_t hdr_size;
+    const uint8_t *data;
+    size_t data_size;
+    unsigned int index; /* Our entry in hdr->readers */
+};
+
+static bool is_meta_format(bladerf_format format)
+{
+    return format == BLADERF_FORMAT_SC16_Q11_META ||
+           format == BLADERF_FORMAT_SC8_Q7_META ||
+           format == BLADERF_FORMAT_CF32_META ||
+           format == BLADERF_FORMAT_SC12_PACKED_META ||
+           format == BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META ||
+           format == BLADERF_FORMAT_SC8_Q7_AS_CF32_META;
+}
+
+static int broker_shm_name(char *buf, size_t len, const char *name)
+{
+    int n;
+
+    /* The name forms a single path component */
+    if (name[0] == '\0' || strchr(name, '/') != NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    n = snprintf(buf, len, "/bladerf-%s", name);
+    if (n < 0 || (size_t)n >= len) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return 0;
+}
+
+static bool process_alive(pid_t pid)
+{
+    return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+static size_t page_align(size_t n)
+{
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    return (n + page - 1) / page * page;
+}
+
+static size_t header_size(unsigned int num_buffers)
+{
+    return page_align(sizeof(struct broker_header) +
+                      num_buffers * sizeof(struct broker_buffer));
+}
+
+/* Remove an existing object of this name if its publisher has died */
+static void remove_stale(const char *shm_name)
+{
+    struct broker_header hdr;
+    int fd;
+
+    fd = shm_open(shm_name, O_RDONLY, 0);
+    if (fd < 0) {
+        return;
+    }
+
+    if (pread(fd, &hdr, sizeof(hdr), 0) == (ssize_t)sizeof(hdr) &&
+        hdr.magic == BROKER_MAGIC && !process_alive(hdr.publisher_pid)) {
+        log_debug("Removing stale broker %s of pid %d\n", shm_name,
+                  hdr.publisher_pid);
+        shm_unlink(shm_name);
+    }
+
+    close(fd);
+}
+
+static int init_shared_sync(struct broker_header *hdr)
+{
+    pthread_mutexattr_t mattr;
+    pthread_condattr_t cattr;
+    int status = 0;
+
+    pthread_mutexattr_init(&mattr);
+    pthread_condattr_init(&cattr);
+
+    if (pthread_mutexattr_setpshared(&mattr, PTHREAD_PROCESS_SHARED) != 0 ||
+        pthread_condattr_setpshared(&cattr, PTHREAD_PROCESS_SHARED) != 0 ||
+        pthread_mutex_init(&hdr->lock, &mattr) != 0) {
+        status = BLADERF_ERR_UNSUPPORTED;
+    } else if (pthread_cond_init(&hdr->published, &cattr) != 0) {
+        pthread_mutex_destroy(&hdr->lock);
+        status = BLADERF_ERR_UNSUPPORTED;
+    }
+
+    pthread_mutexattr_destroy(&mattr);
+    pthread_condattr_destroy(&cattr);
+
+    return status;
+}
+
+static void *broker_thread(void *arg)
+{
+    struct bladerf_broker *b = arg;
+    struct broker_header *hdr = b->hdr;
+    struct bladerf_metadata meta;
+    struct broker_buffer *buf;
+    uint64_t seq;
+    int status = 0;
+
+    pthread_mutex_lock(&hdr->lock);
+
+    while (b->running) {
+        seq = hdr->head + 1;
+        buf = &hdr->buffers[seq % hdr->num_buffers];
+
+        /* Readers holding this buffer find out at release */
+        buf->seq = 0;
+
+        pthread_mutex_unlock(&hdr->lock);
+
+        memset(&meta, 0, sizeof(meta));
+        meta.flags = BLADERF_META_FLAG_RX_NOW;
+
+        status = bladerf_sync_rx(
+            b->dev, b->data + (seq % hdr->num_buffers) * hdr->buffer_bytes,
+            hdr->buffer_size, b->meta ? &meta : NULL, b->timeout_ms);
+
+        pthread_mutex_lock(&hdr->lock);
+
+        if (status == BLADERF_ERR_TIMEOUT) {
+            continue;
+        } else if (status != 0) {
+            log_error("Broker stream failed: %s\n", bladerf_strerror(status));
+            break;
+        }
+
+        buf->timestamp      = meta.timestamp;
+        buf->host_timestamp = meta.host_timestamp;
+        buf->status         = meta.status;
+        buf->num_samples    = b->meta ? meta.actual_count : hdr->buffer_size;
+        buf->seq            = seq;
+
+        hdr->head = seq;
+        pthread_cond_broadcast(&hdr->published);
+    }
+
+    hdr->state  = (status == 0 || status == BLADERF_ERR_TIMEOUT)
+                     ? BROKER_STATE_STOPPED
+                     : BROKER_STATE_ERROR;
+    hdr->status = (hdr->state == BROKER_STATE_ERROR) ? status : 0;
+    pthread_cond_broadcast(&hdr->published);
+
+    pthread_mutex_unlock(&hdr->lock);
+
+    return NULL;
+}
+
+int bladerf_broker_start(struct bladerf *dev,
+                         struct bladerf_broker **broker,
+                         const char *name,
+                         bladerf_channel_layout layout,
+                         bladerf_format format,
+                         unsigned int num_buffers,
+                         unsigned int buffer_size,
+                         unsigned int timeout_ms)
+{
+    struct bladerf_broker *b;
+    struct broker_header *hdr;
+    struct bladerf_serial sn;
+    size_t hdr_size;
+    size_t buffer_bytes;
+    int fd;
+    int status;
+
+    if (dev == NULL || broker == NULL || num_buffers < 3 ||
+        buffer_size == 0 ||
+        (layout != BLADERF_RX_X1 && layout != BLADERF_RX_X2)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    *broker = NULL;
+
+    if (name == NULL) {
+        status = bladerf_get_serial_struct(dev, &sn);
+        if (status != 0) {
+            return status;
+        }
+
+        name = sn.serial;
+    }
+
+    b = calloc(1, sizeof(*b));
+    if (b == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    status = broker_shm_name(b->shm_name, sizeof(b->shm_name), name);
+    if (status != 0) {
+        free(b);
+        return status;
+    }
+
+    b->dev        = dev;
+    b->meta       = is_meta_format(format);
+    b->timeout_ms = timeout_ms;
+
+    hdr_size     = header_size(num_buffers);
+    buffer_bytes = samples_to_bytes(format, buffer_size);
+    b->map_size  = hdr_size + (size_t)num_buffers * buffer_bytes;
+
+    remove_stale(b->shm_name);
+
+    fd = shm_open(b->shm_name, O_RDWR | O_CREAT | O_EXCL, 0660);
+    if (fd < 0) {
+        log_debug("Failed to create %s: %s\n", b->shm_name, strerror(errno));
+        free(b);
+        return BLADERF_ERR_IO;
+    }
+
+    if (ftruncate(fd, (off_t)b->map_size) != 0) {
+        log_debug("Failed to size %s: %s\n", b->shm_name, strerror(errno));
+        status = BLADERF_ERR_IO;
+    } else {
+        hdr = mmap(NULL, b->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                   0);
+        if (hdr == MAP_FAILED) {
+            status = BLADERF_ERR_MEM;
+        }
+    }
+
+    close(fd);
+
+    if (status != 0) {
+        goto error_unlink;
+    }
+
+    b->hdr  = hdr;
+    b->data = (uint8_t *)hdr + hdr_size;
+
+    status = init_shared_sync(hdr);
+    if (status != 0) {
+        goto error_unmap;
+    }
+
+    hdr->version       = BROKER_VERSION;
+    hdr->header_size   = sizeof(*hdr);
+    hdr->publisher_pid = (int32_t)getpid();
+    hdr->layout        = layout;
+    hdr->format        = format;
+    hdr->num_buffers   = num_buffers;
+    hdr->buffer_size   = buffer_size;
+    hdr->buffer_bytes  = buffer_bytes;
+    hdr->data_offset   = hdr_size;
+    hdr->state         = BROKER_STATE_RUNNING;
+
+    b->running = true;
+
+    if (pthread_create(&b->thread, NULL, broker_thread, b) != 0) {
+        status = BLADERF_ERR_UNEXPECTED;
+        goto error_sync;
+    }
+
+    /* Readers check this last, so they never see a partially initialized
+     * header */
+    __atomic_store_n(&hdr->magic, BROKER_MAGIC, __ATOMIC_RELEASE);
+
+    *broker = b;
+    return 0;
+
+error_sync:
+    pthread_cond_destroy(&hdr->published);
+    pthread_mutex_destroy(&hdr->lock);
+error_unmap:
+    munmap(hdr, b->map_size);
+error_unlink:
+    shm_unlink(b->shm_name);
+    free(b);
+    return status;
+}
+
+int bladerf_broker_stop(struct bladerf_broker *broker)
+{
+    struct broker_header *hdr;
+    int status;
+
+    if (broker == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    hdr = broker->hdr;
+
+    pthread_mutex_lock(&hdr->lock);
+    broker->running = false;
+    pthread_mutex_unlock(&hdr->lock);
+
+    /* This returns within the stream timeout */
+    pthread_join(broker->thread, NULL);
+
+    status = hdr->status;
+
+    /* Attached readers keep their mappings until they detach */
+    shm_unlink(broker->shm_name);
+    munmap(hdr, broker->map_size);
+    free(broker);
+
+    return status;
+}
+
+int bladerf_broker_attach(struct bladerf_broker_reader **reader,
+                          const char *name)
+{
+    struct bladerf_broker_reader *r;
+    struct broker_header *hdr;
+    struct stat st;
+    char shm_name[BROKER_NAME_MAX];
+    unsigned int i;
+    int fd;
+    int status;
+
+    if (reader == NULL || name == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    *reader = NULL;
+
+    status = broker_shm_name(shm_name, sizeof(shm_name), name);
+    if (status != 0) {
+        return status;
+    }
+
+    fd = shm_open(shm_name, O_RDWR, 0);
+    if (fd < 0) {
+        return (errno == EACCES) ? BLADERF_ERR_PERMISSION : BLADERF_ERR_NODEV;
+    }
+
+    r = calloc(1, sizeof(*r));
+    if (r == NULL) {
+        close(fd);
+        return BLADERF_ERR_MEM;
+    }
+
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < page_align(sizeof(*hdr))) {
+        status = BLADERF_ERR_NODEV;
+        goto out;
+    }
+
+    /* Map the header alone first, to find the size of the rest */
+    hdr = mmap(NULL, sizeof(*hdr), PROT_READ, MAP_SHARED, fd, 0);
+    if (hdr == MAP_FAILED) {
+        status = BLADERF_ERR_MEM;
+        goto out;
+    }
+
+    if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != BROKER_MAGIC ||
+        hdr->version != BROKER_VERSION || hdr->header_size != sizeof(*hdr) ||
+        hdr->data_offset + (size_t)hdr->num_buffers * hdr->buffer_bytes >
+            (size_t)st.st_size) {
+        log_debug("%s is not a compatible broker\n", shm_name);
+        munmap(hdr, sizeof(*hdr));
+        status = BLADERF_ERR_NODEV;
+        goto out;
+    }
+
+    r->hdr_size  = hdr->data_offset;
+    r->data_size = (size_t)hdr->num_buffers * hdr->buffer_bytes;
+    munmap(hdr, sizeof(*hdr));
+
+    r->hdr = mmap(NULL, r->hdr_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                  0);
+    if (r->hdr == MAP_FAILED) {
+        r->hdr = NULL;
+        status = BLADERF_ERR_MEM;
+        goto out;
+    }
+
+    r->data = mmap(NULL, r->data_size, PROT_READ, MAP_SHARED, fd,
+                   (off_t)r->hdr_size);
+    if (r->data == MAP_FAILED) {
+        r->data = NULL;
+        status = BLADERF_ERR_MEM;
+        goto out;
+    }
+
+    hdr    = r->hdr;
+    status = BLADERF_ERR_QUEUE_FULL;
+
+    pthread_mutex_lock(&hdr->lock);
+
+    if (hdr->state != BROKER_STATE_RUNNING) {
+        status = BLADERF_ERR_NODEV;
+    } else {
+        for (i = 0; i < BLADERF_BROKER_MAX_READERS; i++) {
+            struct broker_reader_slot *slot = &hdr->readers[i];
+
+            /* Reclaim the entries of readers that exited without
+             * detaching */
+            if (slot->pid == 0 || !process_alive(slot->pid)) {
+                slot->pid      = (int32_t)getpid();
+                slot->held     = false;
+                slot->cursor   = hdr->head + 1;
+                slot->overruns = 0;
+                r->index       = i;
+                status         = 0;
+                break;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&hdr->lock);
+
+out:
+    close(fd);
+
+    if (status != 0) {
+        log_debug("Failed to attach to %s: %s\n", shm_name,
+                  bladerf_strerror(status));
+        if (r->data != NULL) {
+            munmap((void *)r->data, r->data_size);
+        }
+        if (r->hdr != NULL) {
+            munmap(r->hdr, r->hdr_size);
+        }
+        free(r);
+    } else {
+        *reader = r;
+    }
+
+    return status;
+}
+
+void bladerf_broker_detach(struct bladerf_broker_reader *reader)
+{
+    struct broker_header *hdr;
+
+    if (reader == NULL) {
+        return;
+    }
+
+    hdr = reader->hdr;
+
+    pthread_mutex_lock(&hdr->lock);
+    memset(&hdr->readers[reader->index], 0, sizeof(hdr->readers[0]));
+    pthread_mutex_unlock(&hdr->lock);
+
+    munmap((void *)reader->data, reader->data_size);
+    munmap(hdr, reader->hdr_size);
+    free(reader);
+}
+
+int bladerf_broker_get_config(struct bladerf_broker_reader *reader,
+                              bladerf_channel_layout *layout,
+                              bladerf_format *format,
+                              unsigned int *buffer_size)
+{
+    if (reader == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* These are constant once the broker is published */
+    if (layout != NULL) {
+        *layout = (bladerf_channel_layout)reader->hdr->layout;
+    }
+
+    if (format != NULL) {
+        *format = (bladerf_format)reader->hdr->format;
+    }
+
+    if (buffer_size != NULL) {
+        *buffer_size = reader->hdr->buffer_size;
+    }
+
+    return 0;
+}
+
+static void deadline_from_now(struct timespec *deadline,
+                              unsigned int timeout_ms)
+{
+    clock_gettime(CLOCK_REALTIME, deadline);
+
+    deadline->tv_sec += timeout_ms / 1000;
+    deadline->tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+    if (deadline->tv_nsec >= 1000000000) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000;
+    }
+}
+
+int bladerf_broker_acquire(struct bladerf_broker_reader *reader,
+                           const void **samples,
+                           unsigned int *num_samples,
+                           struct bladerf_metadata *metadata,
+                           unsigned int timeout_ms)
+{
+    struct broker_header *hdr;
+    struct broker_reader_slot *slot;
+    const struct broker_buffer *buf;
+    struct timespec deadline;
+    uint32_t dropped = 0;
+    int status       = 0;
+
+    if (reader == NULL || samples == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    hdr  = reader->hdr;
+    slot = &hdr->readers[reader->index];
+
+    if (timeout_ms != 0) {
+        deadline_from_now(&deadline, timeout_ms);
+    }
+
+    pthread_mutex_lock(&hdr->lock);
+
+    if (slot->held) {
+        pthread_mutex_unlock(&hdr->lock);
+        return BLADERF_ERR_INVAL;
+    }
+
+    while (hdr->head < slot->cursor && status == 0) {
+        if (hdr->state != BROKER_STATE_RUNNING) {
+            status = BLADERF_ERR_NODEV;
+        } else if (timeout_ms == 0) {
+            pthread_cond_wait(&hdr->published, &hdr->lock);
+        } else if (pthread_cond_timedwait(&hdr->published, &hdr->lock,
+                                          &deadline) == ETIMEDOUT) {
+            if (hdr->head < slot->cursor) {
+                /* Distinguish a stalled stream from a dead publisher */
+                status = process_alive(hdr->publisher_pid)
+                             ? BLADERF_ERR_TIMEOUT
+                             : BLADERF_ERR_NODEV;
+            }
+        }
+    }
+
+    if (status != 0) {
+        pthread_mutex_unlock(&hdr->lock);
+        return status;
+    }
+
+    /* The buffer after the head is being overwritten, so the oldest intact
+     * buffer is head - num_buffers + 2 */
+    if (slot->cursor + hdr->num_buffers < hdr->head + 2) {
+        slot->overruns += hdr->head - slot->cursor;
+        slot->cursor = hdr->head;
+        dropped      = BLADERF_META_STATUS_OVERRUN;
+    }
+
+    buf        = &hdr->buffers[slot->cursor % hdr->num_buffers];
+    slot->held = true;
+
+    *samples = reader->data +
+               (slot->cursor % hdr->num_buffers) * hdr->buffer_bytes;
+
+    if (num_samples != NULL) {
+        *num_samples = buf->num_samples;
+    }
+
+    if (metadata != NULL) {
+        metadata->timestamp      = buf->timestamp;
+        metadata->host_timestamp = buf->host_timestamp;
+        metadata->status         = buf->status | dropped;
+        metadata->actual_count   = buf->num_samples;
+    }
+
+    pthread_mutex_unlock(&hdr->lock);
+
+    return 0;
+}
+
+int bladerf_broker_release(struct bladerf_broker_reader *reader)
+{
+    struct broker_header *hdr;
+    struct broker_reader_slot *slot;
+    int status = 0;
+
+    if (reader == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    hdr  = reader->hdr;
+    slot = &hdr->readers[reader->index];
+
+    pthread_mutex_lock(&hdr->lock);
+
+    if (!slot->held) {
+        status = BLADERF_ERR_INVAL;
+    } else {
+        if (hdr->buffers[slot->cursor % hdr->num_buffers].seq !=
+            slot->cursor) {
+            slot->overruns++;
+            status = BLADERF_ERR_TIME_PAST;
+        }
+
+        slot->held = false;
+        slot->cursor++;
+    }
+
+    pthread_mutex_unlock(&hdr->lock);
+
+    return status;
+}
+
+#endif
@@ -20,16 +20,22 @@
  */
 
 
+#include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <unistd.h>
 #include <limits.h>
+#include <sys/stat.h>
 #include "libbladeRF.h"
 #include "board/board.h"
+#include "helpers/file.h"
 #include "helpers/version.h"
 #include "device_calibration.h"
 #include "log.h"
 #include "common.h"
+#include "conversions.h"
+#include "sha256.h"
 
 #define GAIN_CAL_HEADER_RX "RX Chain,RX Gain,VSG Power into bladeRF RX (dBm),Frequency of signal (Hz),Frequency of bladeRF+PXI (Hz),AD9361 RSSI register value,Power of Signal from Full Scale (dBFS)\0"
 #define GAIN_CAL_HEADER_TX "TX Chain,TX Gain,Frequency of Signal (Hz),Frequency of bladeRF+PXI (Hz),VSA Measured Power (dBm)\0"
@@ -58,32 +64,157 @@
         }                                  \
     } while (0)
 
-static size_t count_csv_entries(const char *filename) {
-    char line[1024]; // Adjust buffer size as needed
-    int count = 0;
+/*
+ * Compiled gain calibration file layout
+ *
+ * CSV calibration data is converted to this layout, which holds the
+ * calibration table entries exactly as struct bladerf_gain_cal_entry, so that
+ * the file may be mapped and its entries used in place. All fields are in host
+ * byte order, as recorded by GAIN_CAL_MAP_FLAG_BIG_ENDIAN; files written on a
+ * host of the other byte order are rejected.
+ *
+ * The header is followed, at offset hdr_len, by n_entries entries sorted by
+ * frequency. hdr_sha256 covers the header up to, but not including, itself.
+ */
+#define GAIN_CAL_MAP_MAGIC              "bRFgcal"
+#define GAIN_CAL_MAP_VERSION            1
+
+#define GAIN_CAL_MAP_FLAG_TX            (1 << 0)
+#define GAIN_CAL_MAP_FLAG_BIG_ENDIAN    (1 << 1)
+
+#if BLADERF_BIG_ENDIAN
+#   define GAIN_CAL_MAP_FLAG_HOST_ORDER GAIN_CAL_MAP_FLAG_BIG_ENDIAN
+#else
+#   define GAIN_CAL_MAP_FLAG_HOST_ORDER 0
+#endif
+
+struct gain_cal_map_hdr {
+    char magic[8];
+    uint32_t version;
+    uint32_t hdr_len;
+    uint32_t n_entries;
+    uint32_t flags;
+    char serial[40];
+    uint8_t entries_sha256[SHA256_DIGEST_SIZE];
+    uint8_t hdr_sha256[SHA256_DIGEST_SIZE];
+};
+
+#define GAIN_CAL_MAP_HDR_HASHED_LEN \
+    offsetof(struct gain_cal_map_hdr, hdr_sha256)
+
+static void gain_cal_map_hash(const void *data, size_t len,
+                              uint8_t digest[SHA256_DIGEST_SIZE])
+{
+    SHA256_CTX ctx;
+
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, data, len);
+    SHA256_Final(digest, &ctx);
+}
+
+static uint32_t gain_cal_map_flags(bladerf_channel ch)
+{
+    return GAIN_CAL_MAP_FLAG_HOST_ORDER |
+           (BLADERF_CHANNEL_IS_TX(ch) ? GAIN_CAL_MAP_FLAG_TX : 0);
+}
+
+/* Validate a mapped file, returning a pointer to its header on success */
+static int gain_cal_map_validate(const uint8_t *data, size_t len,
+                                 bladerf_channel ch,
+                                 const struct gain_cal_map_hdr **hdr_out)
+{
+    const struct gain_cal_map_hdr *hdr = (const struct gain_cal_map_hdr *) data;
+    const size_t entry_size = sizeof(struct bladerf_gain_cal_entry);
+    uint8_t digest[SHA256_DIGEST_SIZE];
+
+    /* Mappings are page-aligned, so the header may be accessed in place */
+    if (len < sizeof(*hdr) ||
+        memcmp(hdr->magic, GAIN_CAL_MAP_MAGIC, sizeof(hdr->magic)) != 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    gain_cal_map_hash(hdr, GAIN_CAL_MAP_HDR_HASHED_LEN, digest);
+    if (memcmp(digest, hdr->hdr_sha256, sizeof(digest)) != 0) {
+        log_debug("Gain calibration file header checksum mismatch\n");
+        return BLADERF_ERR_CHECKSUM;
+    }
+
+    if (hdr->version != GAIN_CAL_MAP_VERSION) {
+        log_debug("Unsupported gain calibration file version: %u\n",
+                  hdr->version);
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (hdr->flags != gain_cal_map_flags(ch)) {
+        log_debug("Gain calibration file flags (0x%x) do not match "
+                  "channel or host (0x%x)\n", hdr->flags, gain_cal_map_flags(ch));
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (hdr->hdr_len < sizeof(*hdr) || hdr->hdr_len % entry_size != 0 ||
+        hdr->hdr_len > len || hdr->n_entries == 0 ||
+        hdr->n_entries > (len - hdr->hdr_len) / entry_size) {
+        log_debug("Invalid gain calibration file layout\n");
+        return BLADERF_ERR_INVAL;
+    }
+
+    gain_cal_map_hash(&data[hdr->hdr_len], hdr->n_entries * entry_size, digest);
+    if (memcmp(digest, hdr->entries_sha256, sizeof(digest)) != 0) {
+        log_debug("Gain calibration file entries checksum mismatch\n");
+        return BLADERF_ERR_CHECKSUM;
+    }
+
+    *hdr_out = hdr;
+    return 0;
+}
+
+static int gain_cal_map_write(const char *binary_path, const char *serial,
+                              bladerf_channel ch,
+                              const struct bladerf_gain_cal_entry *entries,
+                              uint32_t n_entries)
+{
+    struct gain_cal_map_hdr hdr;
+    FILE *f;
+    int status;
 
-    FILE *file = fopen(filename, "r");
-    if (file == NULL) {
-        perror("Error opening file");
-        return -1;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, GAIN_CAL_MAP_MAGIC, sizeof(hdr.magic));
+    hdr.version   = GAIN_CAL_MAP_VERSION;
+    hdr.hdr_len   = sizeof(hdr);
+    hdr.n_entries = n_entries;
+    hdr.flags     = gain_cal_map_flags(ch);
+    strncpy(hdr.serial, serial, sizeof(hdr.serial) - 1);
+
+    gain_cal_map_hash(entries, n_entries * sizeof(entries[0]),
+                      hdr.entries_sha256);
+    gain_cal_map_hash(&hdr, GAIN_CAL_MAP_HDR_HASHED_LEN, hdr.hdr_sha256);
+
+    f = fopen(binary_path, "wb");
+    if (f == NULL) {
+        log_error("Error opening binary file: %s\n", binary_path);
+        return BLADERF_ERR_NO_FILE;
     }
 
-    while (fgets(line, sizeof(line), file)) {
-        count++;
+    status = file_write(f, (uint8_t *) &hdr, sizeof(hdr));
+    if (status == 0) {
+        status = file_write(f, (uint8_t *) entries,
+                            n_entries * sizeof(entries[0]));
     }
 
-    fclose(file);
+    if (fclose(f) != 0 && status == 0) {
+        status = BLADERF_ERR_IO;
+    }
 
-    return count - 2; // Subtract 2 to account for the serial number and header lines
+    return status;
 }
 
 int gain_cal_csv_to_bin(struct bladerf *dev, const char *csv_path, const char *binary_path, bladerf_channel ch)
 {
     int status = 0;
-    struct bladerf_image *image;
-    size_t data_size;
-    size_t entry_size;
-    size_t offset = 0;
+    struct bladerf_gain_cal_entry *entries = NULL;
+    struct bladerf_gain_cal_entry *tmp;
+    uint32_t num_entries = 0;
+    uint32_t max_entries = 0;
 
     char line[256];
     char current_dir[1000];
@@ -101,8 +232,7 @@ int gain_cal_csv_to_bin(struct bladerf *dev, const char *csv_path, const char *b
     uint64_t signal_freq;
 
     FILE *csvFile = fopen(csv_path, "r");
-    FILE *binaryFile = fopen(binary_path, "wb");
-    if (!csvFile || !binaryFile) {
+    if (!csvFile) {
         status = BLADERF_ERR_NO_FILE;
         if (getcwd(current_dir, sizeof(current_dir)) != NULL) {
             log_error("Error opening calibration file: %s\n", strcat(current_dir, csv_path));
@@ -121,31 +251,11 @@ int gain_cal_csv_to_bin(struct bladerf *dev, const char *csv_path, const char *b
         goto error;
     }
 
-    sscanf(line, "Serial: %s", csv_serial);
+    sscanf(line, "Serial: %32s", csv_serial);
     if (strcmp(device_serial, csv_serial) != 0) {
         log_warning("Gain calibration file serial (%s) does not match device serial (%s)\n", csv_serial, device_serial);
     }
 
-    size_t num_entries = count_csv_entries(csv_path);
-    if (num_entries == 0) {
-        status = BLADERF_ERR_INVAL;
-        log_error("Error reading header from CSV file or file is empty.\n");
-        goto error;
-    }
-
-    entry_size = (BLADERF_CHANNEL_IS_TX(ch))
-        ? sizeof(chain) + sizeof(gain) + sizeof(cw_freq) + sizeof(frequency) + sizeof(power)
-        : sizeof(chain) + sizeof(gain) + sizeof(vsg_power) + sizeof(signal_freq) + sizeof(frequency) + sizeof(rssi) + sizeof(power);
-
-    data_size = num_entries * entry_size + BLADERF_SERIAL_LENGTH;
-
-    image = bladerf_alloc_image(dev, BLADERF_IMAGE_TYPE_GAIN_CAL, 0xffffffff, data_size);
-    if (image == NULL) {
-        log_error("Failed to allocate image\n");
-        status = BLADERF_ERR_MEM;
-        goto error;
-    }
-
     if (!fgets(line, sizeof(line), csvFile)) {
         status = BLADERF_ERR_INVAL;
         log_error("Error reading header from CSV file or file is empty.\n");
@@ -159,63 +269,90 @@ int gain_cal_csv_to_bin(struct bladerf *dev, const char *csv_path, const char *b
         goto error;
     }
 
-    image->version = GAIN_CAL_VERSION;
-
-    memcpy(&image->data[offset], device_serial, BLADERF_SERIAL_LENGTH);
-    offset += BLADERF_SERIAL_LENGTH;
-
-    for (size_t i = 0; i < num_entries; i++) {
-        if (!fgets(line, sizeof(line), csvFile)) {
-            break;
-        }
+    /* Only the measurements at the reference gain are retained. These are
+     * converted to gain corrections here, rather than at load time. */
+    while (fgets(line, sizeof(line), csvFile)) {
+        double gain_corr;
 
         if (BLADERF_CHANNEL_IS_TX(ch)) {
-            sscanf(line, "%" SCNu8 ",%" SCNi32 ",%" SCNu64 ",%" SCNu64 ",%f",
-                &chain, &gain, &cw_freq, &frequency, &power);
+            if (sscanf(line, "%" SCNu8 ",%" SCNi32 ",%" SCNu64 ",%" SCNu64 ",%f",
+                       &chain, &gain, &cw_freq, &frequency, &power) != 5) {
+                continue;
+            }
 
-            memcpy(&image->data[offset], &chain, sizeof(chain));
-            offset += sizeof(chain);
-            memcpy(&image->data[offset], &gain, sizeof(gain));
-            offset += sizeof(gain);
-            memcpy(&image->data[offset], &cw_freq, sizeof(cw_freq));
-            offset += sizeof(cw_freq);
-            memcpy(&image->data[offset], &frequency, sizeof(frequency));
-            offset += sizeof(frequency);
-            memcpy(&image->data[offset], &power, sizeof(power));
-            offset += sizeof(power);
+            if (chain != 0 || gain != 60) {
+                continue;
+            }
+
+            gain_corr = power;
         } else {
-            sscanf(line, "%" SCNu8 ",%" SCNi32 ",%f,%" SCNu64 ",%" SCNu64 ",%" SCNi32 ",%f",
-                &chain, &gain, &vsg_power, &signal_freq, &frequency, &rssi, &power);
+            if (sscanf(line, "%" SCNu8 ",%" SCNi32 ",%f,%" SCNu64 ",%" SCNu64 ",%" SCNi32 ",%f",
+                       &chain, &gain, &vsg_power, &signal_freq, &frequency, &rssi, &power) != 7) {
+                continue;
+            }
 
-            memcpy(&image->data[offset], &chain, sizeof(chain));
-            offset += sizeof(chain);
-            memcpy(&image->data[offset], &gain, sizeof(gain));
-            offset += sizeof(gain);
-            memcpy(&image->data[offset], &vsg_power, sizeof(vsg_power));
-            offset += sizeof(vsg_power);
-            memcpy(&image->data[offset], &signal_freq, sizeof(signal_freq));
-            offset += sizeof(signal_freq);
-            memcpy(&image->data[offset], &frequency, sizeof(frequency));
-            offset += sizeof(frequency);
-            memcpy(&image->data[offset], &rssi, sizeof(rssi));
-            offset += sizeof(rssi);
-            memcpy(&image->data[offset], &power, sizeof(power));
-            offset += sizeof(power);
+            if (chain != 0 || gain != 0) {
+                continue;
+            }
+
+            gain_corr = power - vsg_power;
         }
+
+        if (num_entries == max_entries) {
+            max_entries = (max_entries == 0) ? 1024 : 2 * max_entries;
+            tmp = realloc(entries, max_entries * sizeof(entries[0]));
+            if (tmp == NULL) {
+                status = BLADERF_ERR_MEM;
+                goto error;
+            }
+            entries = tmp;
+        }
+
+        entries[num_entries].freq = frequency;
+        entries[num_entries].gain_corr = gain_corr;
+        num_entries++;
     }
 
-    log_debug("Writing image to file: %s\n", binary_path);
-    bladerf_image_write(dev, image, binary_path);
-    bladerf_free_image(image);
+    if (num_entries == 0) {
+        status = BLADERF_ERR_INVAL;
+        log_error("No valid entries found: %s\n", csv_path);
+        goto error;
+    }
+
+    log_debug("Writing gain calibration to file: %s\n", binary_path);
+    status = gain_cal_map_write(binary_path, device_serial, ch, entries,
+                                num_entries);
 
 error:
     if (csvFile)
         fclose(csvFile);
-    if (binaryFile)
-        fclose(binaryFile);
+    free(entries);
     return status;
 }
 
+bool gain_cal_bin_is_current(const char *csv_path, const char *binary_path, bladerf_channel ch)
+{
+    const struct gain_cal_map_hdr *hdr;
+    const uint8_t *data;
+    struct stat csv_st, bin_st;
+    size_t len;
+    bool current;
+
+    if (stat(csv_path, &csv_st) != 0 || stat(binary_path, &bin_st) != 0 ||
+        bin_st.st_mtime < csv_st.st_mtime) {
+        return false;
+    }
+
+    if (file_map(binary_path, &data, &len) != 0) {
+        return false;
+    }
+
+    current = gain_cal_map_validate(data, len, ch, &hdr) == 0;
+    file_unmap(data, len);
+
+    return current;
+}
+
 static int gain_cal_tbl_init(struct bladerf_gain_cal_tbl *tbl, uint32_t num_entries) {
     if (tbl == NULL) {
         log_error("calibration table is NULL\n");
@@ -227,11 +364,15 @@ static int gain_cal_tbl_init(struct bladerf_gain_cal_tbl *tbl, uint32_t num_entr
     tbl->start_freq = 0;
     tbl->stop_freq = 0;
     tbl->file_path_len = PATH_MAX;
-
-    tbl->entries = malloc(num_entries * sizeof(struct bladerf_gain_cal_entry));
-    if (tbl->entries == NULL) {
-        log_error("failed to allocate memory for calibration table entries\n");
-        return BLADERF_ERR_MEM;
+    tbl->entries = NULL;
+
+    /* Tables loaded from a mapped file use its entries in place */
+    if (num_entries > 0) {
+        tbl->entries = malloc(num_entries * sizeof(struct bladerf_gain_cal_entry));
+        if (tbl->entries == NULL) {
+            log_error("failed to allocate memory for calibration table entries\n");
+            return BLADERF_ERR_MEM;
+        }
     }
 
     tbl->file_path = malloc(tbl->file_path_len + 1);
@@ -268,10 +409,27 @@ void gain_cal_tbl_free(struct bladerf_gain_cal_tbl *tbl) {
     tbl->state = BLADERF_GAIN_CAL_UNLOADED;
 }
 
-int load_gain_calibration(struct bladerf *dev, bladerf_channel ch, const char *binary_path) {
-    int num_channels = 4;
-    struct bladerf_gain_cal_tbl gain_tbls[num_channels];
-    bladerf_gain current_gain;
+void gain_cal_unload(struct bladerf *dev, bladerf_channel ch)
+{
+    gain_cal_lut_release(dev, ch);
+
+    /* The entries of a mapped table belong to the mapping */
+    if (dev->gain_maps[ch].data != NULL) {
+        dev->gain_tbls[ch].entries = NULL;
+        file_unmap(dev->gain_maps[ch].data, dev->gain_maps[ch].len);
+        dev->gain_maps[ch].data = NULL;
+        dev->gain_maps[ch].len = 0;
+    }
+
+    gain_cal_tbl_free(&dev->gain_tbls[ch]);
+}
+
+/* Load a table from the (legacy) bladeRF image format, which contains all of
+ * the raw calibration measurements */
+static int load_gain_cal_image(struct bladerf *dev, bladerf_channel ch,
+                               const char *binary_path,
+                               struct bladerf_gain_cal_tbl *tbl)
+{
     uint64_t frequency;
     float power;
     size_t entry_counter;
@@ -291,26 +449,6 @@ int load_gain_calibration(struct bladerf *dev, bladerf_channel ch, const char *b
     char device_serial[BLADERF_SERIAL_LENGTH];
     char file_serial[BLADERF_SERIAL_LENGTH];
 
-    FILE *binaryFile = fopen(binary_path, "rb");
-    if (!binaryFile) {
-        log_error("Error opening binary file.\n");
-        status = BLADERF_ERR_NO_FILE;
-        goto error;
-    }
-
-    status = dev->board->get_gain(dev, ch, &current_gain);
-    if (status != 0) {
-        log_error("Failed to get gain: %s\n", bladerf_strerror(status));
-        goto error;
-    }
-
-    status = gain_cal_tbl_init(&gain_tbls[ch], (uint32_t) 10e3);
-    if (status != 0) {
-        log_error("Error initializing gain calibration table\n");
-        status = BLADERF_ERR_MEM;
-        goto error;
-    }
-
     entry_size = (BLADERF_CHANNEL_IS_TX(ch))
         ? sizeof(chain) + sizeof(gain) + sizeof(cw_freq) + sizeof(frequency) + sizeof(power)
         : sizeof(chain) + sizeof(gain) + sizeof(vsg_power) + sizeof(signal_freq) + sizeof(frequency) + sizeof(rssi) + sizeof(power);
@@ -331,6 +469,21 @@ int load_gain_calibration(struct bladerf *dev, bladerf_channel ch, const char *b
         goto error;
     }
 
+    if (image->length <= BLADERF_SERIAL_LENGTH) {
+        log_error("No valid entries found: %s\n", binary_path);
+        status = BLADERF_ERR_UNEXPECTED;
+        goto error;
+    }
+
+    num_entries = (image->length - BLADERF_SERIAL_LENGTH) / entry_size;
+
+    status = gain_cal_tbl_init(tbl, (uint32_t) num_entries);
+    if (status != 0) {
+        log_error("Error initializing gain calibration table\n");
+        status = BLADERF_ERR_MEM;
+        goto error;
+    }
+
     strncpy(device_serial, dev->ident.serial, BLADERF_SERIAL_LENGTH);
     device_serial[BLADERF_SERIAL_LENGTH - 1] = '\0';
     memcpy(file_serial, image->data, BLADERF_SERIAL_LENGTH);
@@ -342,7 +495,6 @@ int load_gain_calibration(struct bladerf *dev, bladerf_channel ch, const char *b
 
     offset = BLADERF_SERIAL_LENGTH;
     entry_counter = 0;
-    num_entries = (image->length - BLADERF_SERIAL_LENGTH) / entry_size;
     for (uint64_t i = 0; i < num_entries; i++) {
         if (BLADERF_CHANNEL_IS_TX(ch)) {
             memcpy(&chain, &image->data[offset], sizeof(chain));
@@ -373,14 +525,14 @@ int load_gain_calibration(struct bladerf *dev, bladerf_channel ch, const char *b
         }
 
         if (BLADERF_CHANNEL_IS_TX(ch) && chain == 0 && gain == 60) {
-            gain_tbls[ch].entries[entry_counter].freq = frequency;
-            gain_tbls[ch].entries[entry_counter].gain_corr = power;
+            tbl->entries[entry_counter].freq = frequency;
+            tbl->entries[entry_counter].gain_corr = power;
             entry_counter++;
         }
 
         if (!BLADERF_CHANNEL_IS_TX(ch) && chain == 0 && gain == 0) {
-            gain_tbls[ch].entries[entry_counter].freq = frequency;
-            gain_tbls[ch].entries[entry_counter].gain_corr = power - vsg_power;
+            tbl->entries[entry_counter].freq = frequency;
+            tbl->entries[entry_counter].gain_corr = power - vsg_power;
             entry_counter++;
         }
     }
@@ -391,28 +543,119 @@ int load_gain_calibration(struct bladerf *dev, bladerf_channel ch, const char *b
         goto error;
     }
 
-    gain_tbls[ch].version = image->version;
-    gain_tbls[ch].start_freq = gain_tbls[ch].entries[0].freq;
-    gain_tbls[ch].stop_freq = gain_tbls[ch].entries[entry_counter-1].freq;
-    gain_tbls[ch].n_entries = entry_counter;
-    gain_tbls[ch].ch = ch;
-    gain_tbls[ch].state = BLADERF_GAIN_CAL_LOADED;
-    gain_tbls[ch].enabled = true;
-    gain_tbls[ch].gain_target = current_gain;
-    strncpy(gain_tbls[ch].file_path, binary_path, gain_tbls[ch].file_path_len);
-
-    gain_cal_tbl_free(&dev->gain_tbls[ch]);
-    dev->gain_tbls[ch] = gain_tbls[ch];
+    tbl->version = image->version;
+    tbl->n_entries = entry_counter;
 
 error:
+    if (image)
+        bladerf_free_image(image);
+    return status;
+}
+
+/* Load a table from a mapped file in the compiled layout, using its entries
+ * in place */
+static int load_gain_cal_map(struct bladerf *dev, bladerf_channel ch,
+                             const uint8_t *data, size_t len,
+                             struct bladerf_gain_cal_tbl *tbl)
+{
+    const struct gain_cal_map_hdr *hdr;
+    char device_serial[BLADERF_SERIAL_LENGTH];
+    char file_serial[BLADERF_SERIAL_LENGTH];
+    int status;
+
+    status = gain_cal_map_validate(data, len, ch, &hdr);
     if (status != 0) {
-        log_error("binary_path: %s\n", binary_path);
+        log_error("Invalid gain calibration file: %s\n", bladerf_strerror(status));
+        return status;
     }
 
-    if (binaryFile)
-        fclose(binaryFile);
-    if (image)
-        bladerf_free_image(image);
+    status = gain_cal_tbl_init(tbl, 0);
+    if (status != 0) {
+        log_error("Error initializing gain calibration table\n");
+        return BLADERF_ERR_MEM;
+    }
+
+    strncpy(device_serial, dev->ident.serial, BLADERF_SERIAL_LENGTH);
+    device_serial[BLADERF_SERIAL_LENGTH - 1] = '\0';
+    strncpy(file_serial, hdr->serial, BLADERF_SERIAL_LENGTH);
+    file_serial[BLADERF_SERIAL_LENGTH - 1] = '\0';
+
+    if (strcmp(device_serial, file_serial) != 0) {
+        log_warning("Calibration file serial (%s) does not match device serial (%s)\n", file_serial, device_serial);
+    }
+
+    tbl->version = GAIN_CAL_VERSION;
+    tbl->entries = (struct bladerf_gain_cal_entry *) &data[hdr->hdr_len];
+    tbl->n_entries = hdr->n_entries;
+
+    return 0;
+}
+
+int load_gain_calibration(struct bladerf *dev, bladerf_channel ch, const char *binary_path) {
+    struct bladerf_gain_cal_tbl tbl;
+    bladerf_gain current_gain;
+    const uint8_t *map = NULL;
+    size_t map_len = 0;
+    int status = 0;
+
+    memset(&tbl, 0, sizeof(tbl));
+
+    status = dev->board->get_gain(dev, ch, &current_gain);
+    if (status != 0) {
+        log_error("Failed to get gain: %s\n", bladerf_strerror(status));
+        goto error;
+    }
+
+    status = file_map(binary_path, &map, &map_len);
+    if (status != 0) {
+        log_error("Error opening binary file.\n");
+        status = BLADERF_ERR_NO_FILE;
+        goto error;
+    }
+
+    if (map_len >= sizeof(GAIN_CAL_MAP_MAGIC) &&
+        memcmp(map, GAIN_CAL_MAP_MAGIC, sizeof(GAIN_CAL_MAP_MAGIC)) == 0) {
+        status = load_gain_cal_map(dev, ch, map, map_len, &tbl);
+    } else {
+        file_unmap(map, map_len);
+        map = NULL;
+        map_len = 0;
+
+        status = load_gain_cal_image(dev, ch, binary_path, &tbl);
+    }
+
+    if (status != 0) {
+        goto error;
+    }
+
+    tbl.start_freq = tbl.entries[0].freq;
+    tbl.stop_freq = tbl.entries[tbl.n_entries-1].freq;
+    tbl.ch = ch;
+    tbl.state = BLADERF_GAIN_CAL_LOADED;
+    tbl.enabled = true;
+    tbl.gain_target = current_gain;
+    strncpy(tbl.file_path, binary_path, tbl.file_path_len);
+    tbl.file_path[tbl.file_path_len] = '\0';
+
+    gain_cal_unload(dev, ch);
+    dev->gain_tbls[ch] = tbl;
+    dev->gain_maps[ch].data = map;
+    dev->gain_maps[ch].len = map_len;
+
+    /* The search-based lookup remains available if this fails */
+    gain_cal_lut_update(dev, ch);
+
+    return 0;
+
+error:
+    log_error("binary_path: %s\n", binary_path);
+
+    if (map != NULL) {
+        tbl.entries = NULL;
+        file_unmap(map, map_len);
+    }
+
+    gain_cal_tbl_free(&tbl);
     return status;
 }
 
@@ -482,14 +725,176 @@ int get_gain_cal_entry(const struct bladerf_gain_cal_tbl *tbl, bladerf_frequency
     return 0;
 }
 
+static bool gain_cal_lut_shareable(const struct bladerf_gain_cal_tbl *a,
+                                   const struct bladerf_gain_cal_tbl *b)
+{
+    if (a->state != BLADERF_GAIN_CAL_LOADED ||
+        b->state != BLADERF_GAIN_CAL_LOADED) {
+        return false;
+    }
+
+    if (BLADERF_CHANNEL_IS_TX(a->ch) != BLADERF_CHANNEL_IS_TX(b->ch) ||
+        strcmp(a->file_path, b->file_path) != 0) {
+        return false;
+    }
+
+    /* The file may have been rewritten between loads */
+    return a->n_entries == b->n_entries &&
+           memcmp(a->entries, b->entries,
+                  a->n_entries * sizeof(a->entries[0])) == 0;
+}
+
+static int gain_cal_lut_build(const struct bladerf_gain_cal_tbl *tbl,
+                              bladerf_frequency resolution,
+                              struct gain_cal_lut **lut_out)
+{
+    struct gain_cal_lut *lut;
+    struct bladerf_gain_cal_entry entry;
+    bladerf_frequency freq;
+    uint64_t n_bins;
+    uint32_t i;
+    int status;
+
+    /* One more edge than the number of bins, so that stop_freq always has an
+     * upper edge to interpolate against */
+    n_bins = (tbl->stop_freq - tbl->start_freq) / resolution + 1;
+    if (n_bins + 1 > UINT32_MAX) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    lut = calloc(1, sizeof(*lut));
+    if (lut == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    lut->corr = malloc((n_bins + 1) * sizeof(lut->corr[0]));
+    if (lut->corr == NULL) {
+        free(lut);
+        return BLADERF_ERR_MEM;
+    }
+
+    lut->refcount       = 1;
+    lut->start_freq     = tbl->start_freq;
+    lut->stop_freq      = tbl->stop_freq;
+    lut->resolution     = resolution;
+    lut->inv_resolution = 1.0f / resolution;
+    lut->n_bins         = (uint32_t) n_bins;
+
+    for (i = 0; i <= lut->n_bins; i++) {
+        freq = tbl->start_freq + i * resolution;
+        if (freq > tbl->stop_freq) {
+            freq = tbl->stop_freq;
+        }
+
+        status = get_gain_cal_entry(tbl, freq, &entry);
+        if (status != 0) {
+            free(lut->corr);
+            free(lut);
+            return status;
+        }
+
+        lut->corr[i] = (float) entry.gain_corr;
+    }
+
+    log_verbose("Built %u-bin gain correction table for %s\n",
+                lut->n_bins, tbl->file_path);
+
+    *lut_out = lut;
+    return 0;
+}
+
+void gain_cal_lut_release(struct bladerf *dev, bladerf_channel ch)
+{
+    struct gain_cal_lut *lut = dev->gain_luts[ch];
+
+    dev->gain_luts[ch] = NULL;
+
+    if (lut != NULL && --lut->refcount == 0) {
+        free(lut->corr);
+        free(lut);
+    }
+}
+
+int gain_cal_lut_update(struct bladerf *dev, bladerf_channel ch)
+{
+    const struct bladerf_gain_cal_tbl *tbl = &dev->gain_tbls[ch];
+    struct gain_cal_lut *lut = NULL;
+    int i;
+    int status;
+
+    gain_cal_lut_release(dev, ch);
+
+    if (dev->gain_cal_resolution == 0 ||
+        tbl->state != BLADERF_GAIN_CAL_LOADED) {
+        return 0;
+    }
+
+    for (i = 0; i < NUM_GAIN_CAL_TBLS; i++) {
+        if (i != (int) ch && dev->gain_luts[i] != NULL &&
+            dev->gain_luts[i]->resolution == dev->gain_cal_resolution &&
+            gain_cal_lut_shareable(tbl, &dev->gain_tbls[i])) {
+            lut = dev->gain_luts[i];
+            lut->refcount++;
+            log_verbose("Sharing gain correction table with %s\n",
+                        channel2str(i));
+            break;
+        }
+    }
+
+    if (lut == NULL) {
+        status = gain_cal_lut_build(tbl, dev->gain_cal_resolution, &lut);
+        if (status != 0) {
+            log_warning("Failed to build gain correction table: %s\n",
+                        bladerf_strerror(status));
+            return status;
+        }
+    }
+
+    dev->gain_luts[ch] = lut;
+    return 0;
+}
+
+static inline float gain_cal_lut_lookup(const struct gain_cal_lut *lut,
+                                        bladerf_frequency freq)
+{
+    /* Frequencies below the table take the first entry's correction, as
+     * get_gain_cal_entry() does */
+    const uint64_t offset = (freq > lut->start_freq) ? freq - lut->start_freq : 0;
+    const uint64_t n      = offset / lut->resolution;
+    const float frac = (float) (offset - n * lut->resolution) * lut->inv_resolution;
+
+    return lut->corr[n] + frac * (lut->corr[n + 1] - lut->corr[n]);
+}
+
+int lookup_gain_correction(struct bladerf *dev, bladerf_channel ch,
+                           bladerf_frequency freq, double *gain_corr)
+{
+    const struct gain_cal_lut *lut = dev->gain_luts[ch];
+    struct bladerf_gain_cal_entry entry;
+
+    if (lut == NULL) {
+        CHECK_STATUS(get_gain_cal_entry(&dev->gain_tbls[ch], freq, &entry));
+        *gain_corr = entry.gain_corr;
+        return 0;
+    }
+
+    if (freq > lut->stop_freq) {
+        log_error("Could not find ceil or floor entries in the calibration table\n");
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    *gain_corr = gain_cal_lut_lookup(lut, freq);
+    return 0;
+}
+
 int get_gain_correction(struct bladerf *dev, bladerf_frequency freq, bladerf_channel ch, bladerf_gain *compensated_gain) {
     int status = 0;
     struct bladerf_gain_cal_tbl *cal_table = &dev->gain_tbls[ch];
-    struct bladerf_gain_cal_entry entry_next;
+    double gain_corr;
 
-    CHECK_STATUS(get_gain_cal_entry(cal_table, freq, &entry_next));
+    CHECK_STATUS(lookup_gain_correction(dev, ch, freq, &gain_corr));
 
-    *compensated_gain = __round_int(cal_table->gain_target - entry_next.gain_corr);
+    *compensated_gain = __round_int(cal_table->gain_target - gain_corr);
 
     log_verbose("Target gain:  %i, Compen. gain: %i\n", dev->gain_tbls[ch].gain_target, *compensated_gain);
     return status;
@@ -0,0 +1,608 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libbladeRF.h>
+
+#include "log.h"
+
+#include "helpers/thread_attrs.h"
+
+/* Number of attempts at realigning the devices after one drops samples,
+ * before giving up on a bladerf_group_rx() call */
+#define GROUP_MAX_REALIGN 8
+
+struct group_worker {
+    struct bladerf_group *group;
+    struct bladerf *dev;
+    unsigned int index;
+
+    pthread_t thread;
+    bool thread_started;
+    struct bladerf_thread_attrs attrs;
+
+    /* Timestamp of the first sample of the stream, against which this
+     * device's timestamps are aligned */
+    bladerf_timestamp origin;
+
+    /* Receive with BLADERF_META_FLAG_RX_NOW, rather than at the target */
+    bool now;
+
+    /* Current request, valid while `active` is set */
+    bool active;
+    void *samples;
+    unsigned int num_samples;
+    unsigned int timeout_ms;
+    struct bladerf_metadata meta;
+    int status;
+};
+
+struct bladerf_group {
+    unsigned int num_devices;
+    struct group_worker *workers;
+
+    bool configured;
+    bool started;
+    bool aligned; /* The devices' origins have been determined */
+    bladerf_channel_layout layout;
+    unsigned int samples_per_ts;
+    unsigned int master;
+    struct bladerf_trigger *triggers;
+
+    /* Aligned timestamp of the next sample to return */
+    bladerf_timestamp next;
+
+    /* Protects the fields below, and the workers' requests */
+    pthread_mutex_t lock;
+    pthread_cond_t request;
+    pthread_cond_t done;
+    unsigned int generation;
+    unsigned int pending;
+    bool shutdown;
+};
+
+static bool is_supported_format(bladerf_format format)
+{
+    return format == BLADERF_FORMAT_SC16_Q11_META ||
+           format == BLADERF_FORMAT_SC8_Q7_META ||
+           format == BLADERF_FORMAT_CF32_META ||
+           format == BLADERF_FORMAT_SC12_PACKED_META ||
+           format == BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META ||
+           format == BLADERF_FORMAT_SC8_Q7_AS_CF32_META;
+}
+
+static void *group_worker_thread(void *arg)
+{
+    struct group_worker *w   = arg;
+    struct bladerf_group *g  = w->group;
+    unsigned int generation  = 0;
+
+    if (thread_attrs_nondefault(&w->attrs)) {
+        if (thread_attrs_apply(&w->attrs) != 0) {
+            log_warning("Failed to apply thread attributes to the reception "
+                        "thread of group device %u\n", w->index);
+        }
+    }
+
+    pthread_mutex_lock(&g->lock);
+
+    while (true) {
+        while (!g->shutdown && g->generation == generation) {
+            pthread_cond_wait(&g->request, &g->lock);
+        }
+
+        if (g->shutdown) {
+            break;
+        }
+
+        generation = g->generation;
+
+        if (!w->active) {
+            continue;
+        }
+
+        pthread_mutex_unlock(&g->lock);
+
+        w->status = bladerf_sync_rx(w->dev, w->samples, w->num_samples,
+                                    &w->meta, w->timeout_ms);
+
+        pthread_mutex_lock(&g->lock);
+
+        w->active = false;
+        if (--g->pending == 0) {
+            pthread_cond_signal(&g->done);
+        }
+    }
+
+    pthread_mutex_unlock(&g->lock);
+    return NULL;
+}
+
+/* Receive on all workers with `active` set, and wait for them to finish */
+static void group_dispatch(struct bladerf_group *g)
+{
+    unsigned int i;
+
+    pthread_mutex_lock(&g->lock);
+
+    g->pending = 0;
+    for (i = 0; i < g->num_devices; i++) {
+        if (g->workers[i].active) {
+            g->pending++;
+        }
+    }
+
+    if (g->pending != 0) {
+        g->generation++;
+        pthread_cond_broadcast(&g->request);
+
+        while (g->pending != 0) {
+            pthread_cond_wait(&g->done, &g->lock);
+        }
+    }
+
+    pthread_mutex_unlock(&g->lock);
+}
+
+static void group_stop_workers(struct bladerf_group *g)
+{
+    unsigned int i;
+
+    pthread_mutex_lock(&g->lock);
+    g->shutdown = true;
+    pthread_cond_broadcast(&g->request);
+    pthread_mutex_unlock(&g->lock);
+
+    for (i = 0; i < g->num_devices; i++) {
+        if (g->workers[i].thread_started) {
+            pthread_join(g->workers[i].thread, NULL);
+            g->workers[i].thread_started = false;
+        }
+    }
+
+    g->shutdown = false;
+}
+
+int bladerf_group_open(struct bladerf_group **group,
+                       const char *const *device_ids,
+                       unsigned int num_devices)
+{
+    struct bladerf_group *g;
+    unsigned int i;
+    int status = 0;
+
+    if (group == NULL || device_ids == NULL || num_devices == 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    *group = NULL;
+
+    g = calloc(1, sizeof(*g));
+    if (g == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    g->workers  = calloc(num_devices, sizeof(g->workers[0]));
+    g->triggers = calloc(num_devices, sizeof(g->triggers[0]));
+    if (g->workers == NULL || g->triggers == NULL) {
+        free(g->workers);
+        free(g->triggers);
+        free(g);
+        return BLADERF_ERR_MEM;
+    }
+
+    g->num_devices = num_devices;
+
+    for (i = 0; i < num_devices && status == 0; i++) {
+        g->workers[i].group = g;
+        g->workers[i].index = i;
+        thread_attrs_init(&g->workers[i].attrs);
+
+        status = bladerf_open(&g->workers[i].dev, device_ids[i]);
+        if (status != 0) {
+            log_debug("%s: Failed to open device %u (%s): %s\n", __FUNCTION__,
+                      i, device_ids[i] ? device_ids[i] : "",
+                      bladerf_strerror(status));
+        }
+    }
+
+    if (status != 0) {
+        bladerf_group_close(g);
+        return status;
+    }
+
+    pthread_mutex_init(&g->lock, NULL);
+    pthread_cond_init(&g->request, NULL);
+    pthread_cond_init(&g->done, NULL);
+
+    *group = g;
+    return 0;
+}
+
+void bladerf_group_close(struct bladerf_group *group)
+{
+    unsigned int i;
+
+    if (group == NULL) {
+        return;
+    }
+
+    /* A partially opened group has no workers or synchronization
+     * primitives to tear down */
+    if (group->workers[group->num_devices - 1].dev != NULL) {
+        bladerf_group_stop(group);
+
+        pthread_mutex_destroy(&group->lock);
+        pthread_cond_destroy(&group->request);
+        pthread_cond_destroy(&group->done);
+    }
+
+    for (i = 0; i < group->num_devices; i++) {
+        if (group->workers[i].dev != NULL) {
+            bladerf_close(group->workers[i].dev);
+        }
+    }
+
+    free(group->workers);
+    free(group->triggers);
+    free(group);
+}
+
+struct bladerf *bladerf_group_get_device(struct bladerf_group *group,
+                                         unsigned int index)
+{
+    if (group == NULL || index >= group->num_devices) {
+        return NULL;
+    }
+
+    return group->workers[index].dev;
+}
+
+int bladerf_group_sync_config(struct bladerf_group *group,
+                              bladerf_channel_layout layout,
+                              bladerf_format format,
+                              unsigned int num_buffers,
+                              unsigned int buffer_size,
+                              unsigned int num_transfers,
+                              unsigned int stream_timeout,
+                              const int *cpus)
+{
+    unsigned int i;
+    int status;
+
+    if (group == NULL || group->started ||
+        (layout != BLADERF_RX_X1 && layout != BLADERF_RX_X2)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!is_supported_format(format)) {
+        log_debug("%s: Only metadata formats are supported\n", __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    group->configured = false;
+
+    for (i = 0; i < group->num_devices; i++) {
+        struct group_worker *w = &group->workers[i];
+
+        thread_attrs_init(&w->attrs);
+        if (cpus != NULL) {
+            w->attrs.cpu = cpus[i];
+        }
+
+        status = bladerf_set_sync_thread_attrs(w->dev, BLADERF_RX, &w->attrs);
+        if (status == 0) {
+            status = bladerf_sync_config(w->dev, layout, format, num_buffers,
+                                         buffer_size, num_transfers,
+                                         stream_timeout);
+        }
+
+        if (status != 0) {
+            log_debug("%s: Failed to configure device %u: %s\n", __FUNCTION__,
+                      i, bladerf_strerror(status));
+            return status;
+        }
+    }
+
+    group->layout         = layout;
+    group->samples_per_ts = (layout == BLADERF_RX_X2) ? 2 : 1;
+    group->configured     = true;
+
+    return 0;
+}
+
+/* Enable or disable the RX channels of the configured layout */
+static int group_enable_channels(struct bladerf *dev,
+                                 bladerf_channel_layout layout,
+                                 bool enable)
+{
+    int status;
+
+    status = bladerf_enable_module(dev, BLADERF_CHANNEL_RX(0), enable);
+
+    if (status == 0 && layout == BLADERF_RX_X2) {
+        status = bladerf_enable_module(dev, BLADERF_CHANNEL_RX(1), enable);
+    }
+
+    return status;
+}
+
+int bladerf_group_start(struct bladerf_group *group,
+                        unsigned int master,
+                        bladerf_trigger_signal signal)
+{
+    unsigned int i;
+    int status = 0;
+
+    if (group == NULL || group->started || master >= group->num_devices) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!group->configured) {
+        return BLADERF_ERR_NOT_INIT;
+    }
+
+    group->master  = master;
+    group->aligned = false;
+    group->next    = 0;
+
+    /* Arm the slaves ahead of the master, so that none miss its signal */
+    for (i = 0; i < group->num_devices && status == 0; i++) {
+        struct bladerf_trigger *t = &group->triggers[i];
+
+        status = bladerf_trigger_init(group->workers[i].dev,
+                                      BLADERF_CHANNEL_RX(0), signal, t);
+        if (status == 0) {
+            t->role = (i == master) ? BLADERF_TRIGGER_ROLE_MASTER
+                                    : BLADERF_TRIGGER_ROLE_SLAVE;
+
+            if (i != master) {
+                status = bladerf_trigger_arm(group->workers[i].dev, t, true,
+                                             0, 0);
+            }
+        }
+    }
+
+    if (status == 0) {
+        status = bladerf_trigger_arm(group->workers[master].dev,
+                                     &group->triggers[master], true, 0, 0);
+    }
+
+    for (i = 0; i < group->num_devices && status == 0; i++) {
+        status = group_enable_channels(group->workers[i].dev, group->layout,
+                                       true);
+    }
+
+    for (i = 0; i < group->num_devices && status == 0; i++) {
+        struct group_worker *w = &group->workers[i];
+
+        if (pthread_create(&w->thread, NULL, group_worker_thread, w) != 0) {
+            status = BLADERF_ERR_UNEXPECTED;
+        } else {
+            w->thread_started = true;
+        }
+    }
+
+    /* The devices' streams remain held off until this fires */
+    if (status == 0) {
+        status = bladerf_trigger_fire(group->workers[master].dev,
+                                      &group->triggers[master]);
+    }
+
+    group->started = true;
+
+    if (status != 0) {
+        log_debug("%s: Failed to start group: %s\n", __FUNCTION__,
+                  bladerf_strerror(status));
+        bladerf_group_stop(group);
+    }
+
+    return status;
+}
+
+int bladerf_group_stop(struct bladerf_group *group)
+{
+    unsigned int i;
+    int status = 0;
+    int s;
+
+    if (group == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!group->started) {
+        return 0;
+    }
+
+    group_stop_workers(group);
+
+    for (i = 0; i < group->num_devices; i++) {
+        struct bladerf *dev       = group->workers[i].dev;
+        struct bladerf_trigger *t = &group->triggers[i];
+
+        /* Restore normal RX operation on devices whose triggers were
+         * configured by bladerf_group_start() */
+        if (t->role == BLADERF_TRIGGER_ROLE_MASTER ||
+            t->role == BLADERF_TRIGGER_ROLE_SLAVE) {
+            t->role = BLADERF_TRIGGER_ROLE_DISABLED;
+            s       = bladerf_trigger_arm(dev, t, false, 0, 0);
+            if (s != 0 && status == 0) {
+                status = s;
+            }
+        }
+
+        s = group_enable_channels(dev, group->layout, false);
+        if (s != 0 && status == 0) {
+            status = s;
+        }
+    }
+
+    group->started = false;
+    return status;
+}
+
+int bladerf_group_get_trigger_times(struct bladerf_group *group,
+                                    struct bladerf_trigger_time *times)
+{
+    unsigned int i;
+    int status;
+
+    if (group == NULL || times == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!group->started) {
+        return BLADERF_ERR_NOT_INIT;
+    }
+
+    for (i = 0; i < group->num_devices; i++) {
+        status = bladerf_get_trigger_time(group->workers[i].dev,
+                                          &group->triggers[i], &times[i]);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    return 0;
+}
+
+int bladerf_group_rx(struct bladerf_group *group,
+                     void *const *samples,
+                     unsigned int num_samples,
+                     struct bladerf_metadata *metadata,
+                     unsigned int timeout_ms)
+{
+    bladerf_timestamp target;
+    unsigned int span;
+    uint32_t status_flags = 0;
+    unsigned int attempt;
+    unsigned int i;
+
+    if (group == NULL || samples == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!group->started) {
+        return BLADERF_ERR_NOT_INIT;
+    }
+
+    span   = num_samples / group->samples_per_ts;
+    target = group->next;
+
+    /* The first reception takes the first sample of each stream, which was
+     * taken at the trigger, as the device's origin */
+    for (i = 0; i < group->num_devices; i++) {
+        group->workers[i].now = !group->aligned;
+    }
+
+    for (attempt = 0; attempt < GROUP_MAX_REALIGN; attempt++) {
+        bladerf_timestamp end = target;
+        bool retry            = false;
+
+        for (i = 0; i < group->num_devices; i++) {
+            struct group_worker *w = &group->workers[i];
+
+            w->samples     = samples[i];
+            w->num_samples = num_samples;
+            w->timeout_ms  = timeout_ms;
+            w->status      = 0;
+
+            memset(&w->meta, 0, sizeof(w->meta));
+            if (w->now) {
+                w->meta.flags = BLADERF_META_FLAG_RX_NOW;
+            } else {
+                w->meta.timestamp = w->origin + target;
+            }
+
+            w->active = true;
+        }
+
+        group_dispatch(group);
+
+        for (i = 0; i < group->num_devices; i++) {
+            struct group_worker *w = &group->workers[i];
+            bladerf_timestamp ts;
+
+            if (w->status == BLADERF_ERR_TIME_PAST) {
+                /* The device has already dropped the samples at the target,
+                 * so find out where its stream is now */
+                w->now = true;
+                retry  = true;
+                continue;
+            } else if (w->status != 0) {
+                log_debug("%s: Device %u failed: %s\n", __FUNCTION__, i,
+                          bladerf_strerror(w->status));
+                return w->status;
+            }
+
+            if (!group->aligned) {
+                w->origin = w->meta.timestamp;
+            }
+
+            ts = w->meta.timestamp - w->origin;
+
+            if ((w->meta.status & BLADERF_META_STATUS_OVERRUN) ||
+                w->meta.actual_count != num_samples || ts != target) {
+                retry = true;
+            }
+
+            /* The samples up to here have been consumed from the device */
+            ts += w->meta.actual_count / group->samples_per_ts;
+            if (ts > end) {
+                end = ts;
+            }
+
+            status_flags |= w->meta.status;
+            w->now = false;
+        }
+
+        group->aligned = true;
+
+        if (!retry) {
+            break;
+        }
+
+        /* Realign on the device that is furthest ahead */
+        log_debug("%s: Realigning devices at t=%llu\n", __FUNCTION__,
+                  (unsigned long long)end);
+
+        status_flags |= BLADERF_META_STATUS_OVERRUN;
+        target = end;
+    }
+
+    if (attempt == GROUP_MAX_REALIGN) {
+        log_debug("%s: Failed to realign devices\n", __FUNCTION__);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    if (metadata != NULL) {
+        metadata->timestamp    = group->workers[group->master].origin + target;
+        metadata->status       = status_flags;
+        metadata->actual_count = num_samples;
+    }
+
+    group->next = target + span;
+
+    return 0;
+}
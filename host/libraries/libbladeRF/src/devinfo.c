@@ -28,6 +28,7 @@
 #include "rel_assert.h"
 
 #include "devinfo.h"
+#include "hotplug.h"
 #include "conversions.h"
 #include "log.h"
 
@@ -57,9 +58,26 @@ int probe(backend_probe_target target_device, struct bladerf_devinfo **devices)
 
 int bladerf_get_device_list(struct bladerf_devinfo **devices)
 {
+    int count;
+
+    if (hotplug_get_device_list(devices, &count)) {
+        return count;
+    }
+
     return probe(BACKEND_PROBE_BLADERF, devices);
 }
 
+int bladerf_get_device_list_quick(struct bladerf_devinfo **devices)
+{
+    int count;
+
+    if (hotplug_get_device_list(devices, &count)) {
+        return count;
+    }
+
+    return probe(BACKEND_PROBE_BLADERF_QUICK, devices);
+}
+
 void bladerf_free_device_list(struct bladerf_devinfo *devices)
 {
     /* Admittedly, we could just have the user call free() directly,
@@ -174,6 +192,9 @@ void bladerf_init_devinfo(struct bladerf_devinfo *info)
 
     memset(info->product, 0, BLADERF_DESCRIPTION_LENGTH);
     strncpy(info->product, "<unknown>", BLADERF_DESCRIPTION_LENGTH - 1);
+
+    memset(info->net_host, 0, BLADERF_NET_HOST_LENGTH);
+    info->net_port = 0;
 }
 
 bool bladerf_devinfo_matches(const struct bladerf_devinfo *a,
@@ -321,6 +342,42 @@ static int handle_serial(struct bladerf_devinfo *d, char *value)
     return 0;
 }
 
+static int handle_host(struct bladerf_devinfo *d, char *value)
+{
+    if (value == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (strlen(value) > (BLADERF_NET_HOST_LENGTH - 1)) {
+        log_debug("Provided host name too long: %s\n", value);
+        return BLADERF_ERR_INVAL;
+    }
+
+    strncpy(d->net_host, value, sizeof(d->net_host));
+    d->net_host[sizeof(d->net_host) - 1] = '\0';
+
+    log_debug("Host: %s\n", d->net_host);
+    return 0;
+}
+
+static int handle_port(struct bladerf_devinfo *d, char *value)
+{
+    bool ok;
+
+    if (value == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    d->net_port = str2uint(value, 1, UINT16_MAX, &ok);
+    if (!ok) {
+        log_debug("Bad port: %s\n", value);
+        return BLADERF_ERR_INVAL;
+    } else {
+        log_debug("Port: %u\n", d->net_port);
+        return 0;
+    }
+}
+
 /* Returns: 1 on arg and value populated
  *          0 on no args left
  *          BLADERF_ERR_INVAL on bad format
@@ -401,6 +458,10 @@ int str2devinfo(const char *dev_id_const, struct bladerf_devinfo *d)
                     status = handle_instance(d, val);
                 } else if (!strcasecmp("serial", arg)) {
                     status = handle_serial(d, val);
+                } else if (!strcasecmp("host", arg)) {
+                    status = handle_host(d, val);
+                } else if (!strcasecmp("port", arg)) {
+                    status = handle_port(d, val);
                 } else {
                     arg_status = BLADERF_ERR_INVAL;
                 }
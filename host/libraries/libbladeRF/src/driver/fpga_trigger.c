@@ -194,3 +194,40 @@ int fpga_trigger_state(struct bladerf *dev, const struct bladerf_trigger *trigge
     return status;
 }
 
+int fpga_trigger_time(struct bladerf *dev,
+                      const struct bladerf_trigger *trigger,
+                      struct bladerf_trigger_time *time)
+{
+    int status;
+    bladerf_direction dir;
+    bool fired;
+    uint64_t half_periods;
+
+    switch (trigger->channel) {
+        case BLADERF_CHANNEL_RX(0):
+            dir = BLADERF_RX;
+            break;
+
+        case BLADERF_CHANNEL_TX(0):
+            dir = BLADERF_TX;
+            break;
+
+        default:
+            return BLADERF_ERR_INVAL;
+    }
+
+    if (!is_valid_signal(trigger->signal)) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = dev->backend->get_trigger_time(dev, dir, &fired, &half_periods);
+    if (status != 0) {
+        return status;
+    }
+
+    time->fired       = fired;
+    time->timestamp   = half_periods >> 1;
+    time->second_half = (half_periods & 1) != 0;
+
+    return 0;
+}
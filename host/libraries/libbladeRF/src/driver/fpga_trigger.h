@@ -125,4 +125,17 @@ int fpga_trigger_state(struct bladerf *dev,
                        bool *has_fired,
                        bool *fire_requested);
 
+/**
+ * Read the time at which a trigger last fired
+ *
+ * @param       dev     Device handle
+ * @param[in]   trigger Trigger to query
+ * @param[out]  time    Time at which the trigger fired
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int fpga_trigger_time(struct bladerf *dev,
+                      const struct bladerf_trigger *trigger,
+                      struct bladerf_trigger_time *time);
+
 #endif
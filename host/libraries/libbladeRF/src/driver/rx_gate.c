@@ -0,0 +1,122 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+#include <inttypes.h>
+
+#include <libbladeRF.h>
+
+#include "log.h"
+
+#include "rx_gate.h"
+
+/* The RX gate sits on the Wishbone bus. Byte addresses: */
+#define RX_GATE_CONTROL 0x30000
+#define RX_GATE_START 0x30004
+#define RX_GATE_COUNT 0x3000c
+#define RX_GATE_PERIOD 0x30010
+
+/* Control register: [0] arm, [1] cancel */
+#define RX_GATE_CONTROL_ARM 0x1
+#define RX_GATE_CONTROL_CANCEL 0x2
+
+/* The FPGA stamps a message with the timestamp of its first sample, a clock
+ * or two after the gate sees it. sync_rx() rejects a first message stamped
+ * later than the timestamp it was asked for, so open a single burst this
+ * many samples early and let sync_rx() discard them. Repeated bursts are
+ * read with BLADERF_META_FLAG_RX_NOW, and must fill whole messages, so they
+ * open on time. */
+#define RX_GATE_LEAD 16
+
+/* Load the gate registers and arm it. On an FPGA without bursts, the period
+ * register aliases the control register, where writing 0 does nothing. */
+static int arm(struct bladerf *dev,
+               uint64_t start,
+               uint32_t count,
+               uint32_t period)
+{
+    int status;
+
+    status = dev->backend->wishbone_master_write(dev, RX_GATE_START,
+                                                 (uint32_t)start);
+    if (status != 0) {
+        return status;
+    }
+
+    status = dev->backend->wishbone_master_write(dev, RX_GATE_START + 4,
+                                                 (uint32_t)(start >> 32));
+    if (status != 0) {
+        return status;
+    }
+
+    status = dev->backend->wishbone_master_write(dev, RX_GATE_COUNT, count);
+    if (status != 0) {
+        return status;
+    }
+
+    status = dev->backend->wishbone_master_write(dev, RX_GATE_PERIOD, period);
+    if (status != 0) {
+        return status;
+    }
+
+    return dev->backend->wishbone_master_write(dev, RX_GATE_CONTROL,
+                                               RX_GATE_CONTROL_ARM);
+}
+
+int rx_gate_schedule(struct bladerf *dev,
+                     uint64_t timestamp,
+                     unsigned int num_samples)
+{
+    uint64_t start;
+    uint64_t count;
+
+    start = (timestamp > RX_GATE_LEAD) ? timestamp - RX_GATE_LEAD : 0;
+
+    count = 0;
+    if (num_samples != 0) {
+        count = num_samples + (timestamp - start);
+        if (count > UINT32_MAX) {
+            count = UINT32_MAX;
+        }
+    }
+
+    log_debug("%s: %u samples at %" PRIu64 "\n", __FUNCTION__, num_samples,
+              timestamp);
+
+    return arm(dev, start, (uint32_t)count, 0);
+}
+
+int rx_gate_schedule_bursts(struct bladerf *dev,
+                            uint64_t timestamp,
+                            unsigned int burst_len,
+                            unsigned int period)
+{
+    log_debug("%s: %u samples every %u from %" PRIu64 "\n", __FUNCTION__,
+              burst_len, period, timestamp);
+
+    return arm(dev, timestamp, burst_len, period);
+}
+
+int rx_gate_cancel(struct bladerf *dev)
+{
+    return dev->backend->wishbone_master_write(dev, RX_GATE_CONTROL,
+                                               RX_GATE_CONTROL_CANCEL);
+}
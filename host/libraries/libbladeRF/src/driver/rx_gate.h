@@ -0,0 +1,69 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+#ifndef DRIVER_RX_GATE_H_
+#define DRIVER_RX_GATE_H_
+
+#include "board/board.h"
+
+/**
+ * Arm the FPGA RX gate to deliver samples from a timestamp onward
+ *
+ * The caller is responsible for checking that the FPGA has the RX gate.
+ *
+ * @param       dev         Device handle
+ * @param[in]   timestamp   RX timestamp of the first sample wanted
+ * @param[in]   num_samples Number of samples to deliver, or 0 for no limit
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int rx_gate_schedule(struct bladerf *dev,
+                     uint64_t timestamp,
+                     unsigned int num_samples);
+
+/**
+ * Arm the FPGA RX gate to deliver a burst of samples every `period` samples
+ *
+ * The caller is responsible for checking that the FPGA has RX bursts.
+ *
+ * @param       dev         Device handle
+ * @param[in]   timestamp   RX timestamp of the first burst
+ * @param[in]   burst_len   Number of samples in each burst
+ * @param[in]   period      Number of samples from one burst to the next
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int rx_gate_schedule_bursts(struct bladerf *dev,
+                            uint64_t timestamp,
+                            unsigned int burst_len,
+                            unsigned int period);
+
+/**
+ * Return the FPGA RX gate to passing every sample
+ *
+ * @param       dev         Device handle
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int rx_gate_cancel(struct bladerf *dev);
+
+#endif
@@ -0,0 +1,232 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <libbladeRF.h>
+
+#include "host_config.h"
+#include "log.h"
+
+#include "helpers/wallclock.h"
+
+#include "rx_power_meter.h"
+
+/* The power meter sits on the Wishbone bus. Byte addresses: */
+#define RX_POWER_CONTROL 0x20000
+#define RX_POWER_WINDOW 0x20004
+#define RX_POWER_SUM 0x20008
+#define RX_POWER_I_SUM 0x20010
+#define RX_POWER_Q_SUM 0x20018
+#define RX_POWER_PEAK 0x20020
+#define RX_POWER_I2_SUM 0x20024
+#define RX_POWER_Q2_SUM 0x2002c
+#define RX_POWER_IQ_SUM 0x20034
+#define RX_POWER_SNAPSHOT 0x24000
+
+/* Control register: [0] start/busy, [1] snapshot arm/busy, [8] stream */
+#define RX_POWER_CONTROL_MEASURE 0x1
+#define RX_POWER_CONTROL_SNAPSHOT 0x2
+#define RX_POWER_CONTROL_STREAM_SHIFT 8
+
+/* Slack on top of the expected capture time before giving up */
+#define RX_POWER_TIMEOUT_MS 250
+
+static int read64(struct bladerf *dev, uint32_t addr, uint64_t *val)
+{
+    int status;
+    uint32_t lo, hi;
+
+    status = dev->backend->wishbone_master_read(dev, addr, &lo);
+    if (status != 0) {
+        return status;
+    }
+
+    status = dev->backend->wishbone_master_read(dev, addr + 4, &hi);
+    if (status != 0) {
+        return status;
+    }
+
+    *val = ((uint64_t)hi << 32) | lo;
+
+    return 0;
+}
+
+/* Start a power measurement or snapshot and wait for it to finish */
+static int run(struct bladerf *dev,
+               unsigned int stream,
+               bladerf_sample_rate rate,
+               uint32_t busy_mask,
+               unsigned int num_samples)
+{
+    int status;
+    uint64_t deadline;
+    uint32_t reg;
+
+    if (rate == 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    deadline = wallclock_get_monotonic_nsec() +
+               ((uint64_t)num_samples * 1000000000ULL) / rate +
+               (uint64_t)RX_POWER_TIMEOUT_MS * 1000000ULL;
+
+    reg    = (stream << RX_POWER_CONTROL_STREAM_SHIFT) | busy_mask;
+    status = dev->backend->wishbone_master_write(dev, RX_POWER_CONTROL, reg);
+    if (status != 0) {
+        return status;
+    }
+
+    while (true) {
+        status = dev->backend->wishbone_master_read(dev, RX_POWER_CONTROL,
+                                                    &reg);
+        if (status != 0) {
+            return status;
+        }
+
+        if ((reg & busy_mask) == 0) {
+            return 0;
+        }
+
+        if (wallclock_get_monotonic_nsec() > deadline) {
+            log_debug("%s: timed out. Is the channel enabled?\n",
+                      __FUNCTION__);
+            return BLADERF_ERR_TIMEOUT;
+        }
+
+        usleep(1000);
+    }
+}
+
+int rx_power_meter_measure(struct bladerf *dev,
+                           unsigned int stream,
+                           bladerf_sample_rate rate,
+                           unsigned int num_samples,
+                           struct bladerf_rx_power *power)
+{
+    int status;
+    uint64_t val;
+    uint32_t peak;
+
+    if (power == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (num_samples < 1 || num_samples > BLADERF_RX_POWER_MAX_SAMPLES) {
+        log_debug("Invalid number of samples: %u\n", num_samples);
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = dev->backend->wishbone_master_write(dev, RX_POWER_WINDOW,
+                                                 num_samples);
+    if (status != 0) {
+        return status;
+    }
+
+    status = run(dev, stream, rate, RX_POWER_CONTROL_MEASURE, num_samples);
+    if (status != 0) {
+        return status;
+    }
+
+    power->num_samples = num_samples;
+
+    status = read64(dev, RX_POWER_SUM, &val);
+    if (status != 0) {
+        return status;
+    }
+    power->power_sum = val;
+
+    status = read64(dev, RX_POWER_I_SUM, &val);
+    if (status != 0) {
+        return status;
+    }
+    power->i_sum = (int64_t)val;
+
+    status = read64(dev, RX_POWER_Q_SUM, &val);
+    if (status != 0) {
+        return status;
+    }
+    power->q_sum = (int64_t)val;
+
+    status = dev->backend->wishbone_master_read(dev, RX_POWER_PEAK, &peak);
+    if (status != 0) {
+        return status;
+    }
+    power->peak = (uint16_t)peak;
+
+    status = read64(dev, RX_POWER_I2_SUM, &val);
+    if (status != 0) {
+        return status;
+    }
+    power->i2_sum = val;
+
+    status = read64(dev, RX_POWER_Q2_SUM, &val);
+    if (status != 0) {
+        return status;
+    }
+    power->q2_sum = val;
+
+    status = read64(dev, RX_POWER_IQ_SUM, &val);
+    if (status != 0) {
+        return status;
+    }
+    power->iq_sum = (int64_t)val;
+
+    return 0;
+}
+
+int rx_power_meter_snapshot(struct bladerf *dev,
+                            unsigned int stream,
+                            bladerf_sample_rate rate,
+                            int16_t *samples,
+                            unsigned int num_samples)
+{
+    int status;
+    unsigned int i;
+    uint32_t word;
+
+    if (samples == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (num_samples < 1 || num_samples > BLADERF_RX_SNAPSHOT_MAX_SAMPLES) {
+        log_debug("Invalid number of samples: %u\n", num_samples);
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* The FPGA always captures a full snapshot */
+    status = run(dev, stream, rate, RX_POWER_CONTROL_SNAPSHOT,
+                 BLADERF_RX_SNAPSHOT_MAX_SAMPLES);
+    if (status != 0) {
+        return status;
+    }
+
+    for (i = 0; i < num_samples; ++i) {
+        status = dev->backend->wishbone_master_read(
+            dev, RX_POWER_SNAPSHOT + 4 * i, &word);
+        if (status != 0) {
+            return status;
+        }
+
+        samples[2 * i]     = (int16_t)(word & 0xffff);
+        samples[2 * i + 1] = (int16_t)(word >> 16);
+    }
+
+    return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef DRIVER_RX_POWER_METER_H_
+#define DRIVER_RX_POWER_METER_H_
+
+#include "board/board.h"
+
+/**
+ * Measure the power, DC offset and second-order statistics of an RX stream
+ * with the FPGA power meter
+ *
+ * The caller is responsible for checking that the FPGA has the power meter.
+ *
+ * @param       dev         Device handle
+ * @param[in]   stream      Index of the RX stream in the FPGA
+ * @param[in]   rate        Current sample rate of the stream, used to bound
+ *                          how long to wait for the measurement
+ * @param[in]   num_samples Number of samples to measure
+ * @param[out]  power       Measurement result
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int rx_power_meter_measure(struct bladerf *dev,
+                           unsigned int stream,
+                           bladerf_sample_rate rate,
+                           unsigned int num_samples,
+                           struct bladerf_rx_power *power);
+
+/**
+ * Capture and read back a snapshot of an RX stream with the FPGA power meter
+ *
+ * @param       dev         Device handle
+ * @param[in]   stream      Index of the RX stream in the FPGA
+ * @param[in]   rate        Current sample rate of the stream
+ * @param[out]  samples     Buffer for `num_samples` interleaved SC16 Q11
+ *                          samples
+ * @param[in]   num_samples Number of samples to read back
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int rx_power_meter_snapshot(struct bladerf *dev,
+                            unsigned int stream,
+                            bladerf_sample_rate rate,
+                            int16_t *samples,
+                            unsigned int num_samples);
+
+#endif
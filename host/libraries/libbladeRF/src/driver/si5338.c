@@ -220,29 +220,51 @@ static void si5338_pack_regs(struct si5338_multisynth *ms)
 }
 
 static int si5338_write_multisynth(struct bladerf *dev,
+                                   struct si5338_cache *cache,
                                    struct si5338_multisynth *ms)
 {
     int i, status;
     uint8_t r_power, r_count, val;
+    bool cached = (cache != NULL && cache->valid);
 
     log_verbose("Writing MS%d\n", ms->index);
 
+    /* Registers are only trusted again once all of them have been written */
+    if (cache != NULL) {
+        cache->valid = false;
+    }
+
     /* Write out the enables */
-    status = dev->backend->si5338_read(dev, 36 + ms->index, &val);
-    if (status < 0) {
-        si5338_log_read_error(status, bladerf_strerror(status));
-        return status;
+    if (cached) {
+        val = cache->enable;
+    } else {
+        status = dev->backend->si5338_read(dev, 36 + ms->index, &val);
+        if (status < 0) {
+            si5338_log_read_error(status, bladerf_strerror(status));
+            return status;
+        }
     }
-    val |= ms->enable;
-    log_verbose("Wrote enable register: 0x%2.2x\n", val);
-    status = dev->backend->si5338_write(dev, 36 + ms->index, val);
-    if (status < 0) {
-        si5338_log_write_error(status, bladerf_strerror(status));
-        return status;
+
+    if (!cached || (val | ms->enable) != val) {
+        val |= ms->enable;
+        log_verbose("Wrote enable register: 0x%2.2x\n", val);
+        status = dev->backend->si5338_write(dev, 36 + ms->index, val);
+        if (status < 0) {
+            si5338_log_write_error(status, bladerf_strerror(status));
+            return status;
+        }
+    }
+
+    if (cache != NULL) {
+        cache->enable = val;
     }
 
-    /* Write out the registers */
+    /* Write out the registers, skipping those already holding their value */
     for (i = 0 ; i < 10 ; i++) {
+        if (cached && cache->regs[i] == ms->regs[i]) {
+            continue;
+        }
+
         status = dev->backend->si5338_write(dev, ms->base + i, *(ms->regs+i));
         if (status < 0) {
             si5338_log_write_error(status, bladerf_strerror(status));
@@ -263,18 +285,29 @@ static int si5338_write_multisynth(struct bladerf *dev,
     val = 0xc0;
     val |= (r_power<<2);
 
-    log_verbose("Wrote r register: 0x%2.2x\n", val);
+    if (!cached || cache->r != val) {
+        log_verbose("Wrote r register: 0x%2.2x\n", val);
 
-    status = dev->backend->si5338_write(dev, 31 + ms->index, val);
-    if (status < 0) {
-        si5338_log_write_error(status, bladerf_strerror(status));
+        status = dev->backend->si5338_write(dev, 31 + ms->index, val);
+        if (status < 0) {
+            si5338_log_write_error(status, bladerf_strerror(status));
+            return status;
+        }
     }
 
-    return status ;
+    if (cache != NULL) {
+        memcpy(cache->regs, ms->regs, sizeof(cache->regs));
+        cache->r     = val;
+        cache->valid = true;
+    }
+
+    return 0;
 }
 
 static int si5338_read_multisynth(struct bladerf *dev,
-                                  struct si5338_multisynth *ms)
+                                  struct si5338_multisynth *ms,
+                                  uint8_t *enable_reg,
+                                  uint8_t *r_reg)
 {
     int i, status;
     uint8_t val;
@@ -287,6 +320,7 @@ static int si5338_read_multisynth(struct bladerf *dev,
         si5338_log_read_error(status, bladerf_strerror(status));
         return status ;
     }
+    *enable_reg = val;
     ms->enable = val&7;
     log_verbose("Read enable register: 0x%2.2x\n", val);
 
@@ -308,6 +342,7 @@ static int si5338_read_multisynth(struct bladerf *dev,
     }
     /* RxDIV is stored as a power of 2, so restore it on readback */
     log_verbose("Read r register: 0x%2.2x\n", val);
+    *r_reg = val;
     val = (val>>2)&7;
     ms->r = (1<<val);
 
@@ -433,6 +468,7 @@ static int si5338_calculate_multisynth(struct si5338_multisynth *ms,
  * or for the SMB output (index=3).
  */
 static int si5338_set_rational_multisynth(struct bladerf *dev,
+                                          struct si5338_cache *cache,
                                           uint8_t index, uint8_t channel,
                                           struct bladerf_rational_rate *rate,
                                           struct bladerf_rational_rate *actual_ret)
@@ -467,14 +503,24 @@ static int si5338_set_rational_multisynth(struct bladerf *dev,
     }
 
     /* Program it to the part */
-    status = si5338_write_multisynth(dev, &ms);
+    status = si5338_write_multisynth(dev, cache, &ms);
+    if (status == 0 && cache != NULL) {
+        cache->actual = actual;
+    }
 
     /* Done */
     return status ;
 }
 
 
-int si5338_set_rational_sample_rate(struct bladerf *dev, bladerf_channel ch,
+void si5338_cache_invalidate(struct si5338_cache *cache)
+{
+    cache->valid = false;
+}
+
+int si5338_set_rational_sample_rate(struct bladerf *dev,
+                                    struct si5338_cache *cache,
+                                    bladerf_channel ch,
                                     const struct bladerf_rational_rate *rate,
                                     struct bladerf_rational_rate *actual)
 {
@@ -493,7 +539,8 @@ int si5338_set_rational_sample_rate(struct bladerf *dev, bladerf_channel ch,
         channel |= SI5338_EN_B;
     }
 
-    return si5338_set_rational_multisynth(dev, index, channel, &rate_reduced, actual);
+    return si5338_set_rational_multisynth(dev, cache, index, channel,
+                                          &rate_reduced, actual);
 }
 
 int si5338_set_rational_smb_freq(struct bladerf *dev,
@@ -513,11 +560,15 @@ int si5338_set_rational_smb_freq(struct bladerf *dev,
         return BLADERF_ERR_INVAL;
     }
 
-    return si5338_set_rational_multisynth(dev, 3, SI5338_EN_A, &rate_reduced, actual);
+    return si5338_set_rational_multisynth(dev, NULL, 3, SI5338_EN_A,
+                                          &rate_reduced, actual);
 }
 
-int si5338_set_sample_rate(struct bladerf *dev, bladerf_channel ch,
-                           uint32_t rate, uint32_t *actual)
+int si5338_set_sample_rate(struct bladerf *dev,
+                           struct si5338_cache *cache,
+                           bladerf_channel ch,
+                           uint32_t rate,
+                           uint32_t *actual)
 {
     struct bladerf_rational_rate req, act;
     int status;
@@ -528,7 +579,7 @@ int si5338_set_sample_rate(struct bladerf *dev, bladerf_channel ch,
     req.num = 0;
     req.den = 1;
 
-    status = si5338_set_rational_sample_rate(dev, ch, &req, &act);
+    status = si5338_set_rational_sample_rate(dev, cache, ch, &req, &act);
 
     if (status == 0 && act.num != 0) {
         log_info("Non-integer sample rate set from integer sample rate, "
@@ -573,13 +624,20 @@ int si5338_set_smb_freq(struct bladerf *dev, uint32_t rate, uint32_t *actual)
     return status;
 }
 
-int si5338_get_rational_sample_rate(struct bladerf *dev, bladerf_channel ch,
+int si5338_get_rational_sample_rate(struct bladerf *dev,
+                                    struct si5338_cache *cache,
+                                    bladerf_channel ch,
                                     struct bladerf_rational_rate *rate)
 {
 
     struct si5338_multisynth ms;
     int status;
 
+    if (cache->valid) {
+        *rate = cache->actual;
+        return 0;
+    }
+
     /* Select the multisynth we want to read */
     ms.index = (ch == BLADERF_CHANNEL_RX(0)) ? 1 : 2;
 
@@ -587,7 +645,7 @@ int si5338_get_rational_sample_rate(struct bladerf *dev, bladerf_channel ch,
     si5338_update_base(&ms);
 
     /* Readback */
-    status = si5338_read_multisynth(dev, &ms);
+    status = si5338_read_multisynth(dev, &ms, &cache->enable, &cache->r);
 
     if (status) {
         si5338_log_read_error(status, bladerf_strerror(status));
@@ -596,6 +654,10 @@ int si5338_get_rational_sample_rate(struct bladerf *dev, bladerf_channel ch,
 
     si5338_calculate_ms_freq(&ms, rate);
 
+    memcpy(cache->regs, ms.regs, sizeof(cache->regs));
+    cache->actual = *rate;
+    cache->valid  = true;
+
     return 0;
 }
 
@@ -603,13 +665,14 @@ int si5338_get_rational_smb_freq(struct bladerf *dev,
                                  struct bladerf_rational_rate *rate)
 {
     struct si5338_multisynth ms;
+    uint8_t enable_reg, r_reg;
     int status;
 
     /* Select MS3 for the SMB output */
     ms.index = 3;
     si5338_update_base(&ms);
 
-    status = si5338_read_multisynth(dev, &ms);
+    status = si5338_read_multisynth(dev, &ms, &enable_reg, &r_reg);
 
     if (status) {
         si5338_log_read_error(status, bladerf_strerror(status));
@@ -621,13 +684,15 @@ int si5338_get_rational_smb_freq(struct bladerf *dev,
     return 0;
 }
 
-int si5338_get_sample_rate(struct bladerf *dev, bladerf_channel ch,
+int si5338_get_sample_rate(struct bladerf *dev,
+                           struct si5338_cache *cache,
+                           bladerf_channel ch,
                            unsigned int *rate)
 {
     struct bladerf_rational_rate actual;
     int status;
 
-    status = si5338_get_rational_sample_rate(dev, ch, &actual);
+    status = si5338_get_rational_sample_rate(dev, cache, ch, &actual);
 
     if (status) {
         si5338_log_read_error(status, bladerf_strerror(status));
@@ -26,14 +26,50 @@
 #ifndef DRIVER_SI5338_H_
 #define DRIVER_SI5338_H_
 
+#include <stdbool.h>
+
 #include <libbladeRF.h>
 
 #include "board/board.h"
 
+/**
+ * Last state programmed to, or read back from, a sample rate multisynth.
+ *
+ * The Si5338 is only reachable one register at a time through the NIOS II,
+ * so sample rate changes write only those registers that differ from the
+ * cached ones, and sample rate queries are answered without a readback. The
+ * cache must be invalidated whenever the registers may have been changed
+ * elsewhere, e.g. by an FPGA load or a raw register write.
+ */
+struct si5338_cache {
+    bool valid;
+
+    /* Output driver enable register */
+    uint8_t enable;
+
+    /* Multisynth (p1, p2, p3) registers */
+    uint8_t regs[10];
+
+    /* R divider register */
+    uint8_t r;
+
+    /* Rational rate these registers produce */
+    struct bladerf_rational_rate actual;
+};
+
+/**
+ * Discard a channel's cached multisynth state, so that the next access
+ * reads back or fully rewrites the registers
+ *
+ * @param       cache   Cache
+ */
+void si5338_cache_invalidate(struct si5338_cache *cache);
+
 /**
  * Set the rational sample rate of the specified channel.
  *
  * @param       dev     Device handle
+ * @param       cache   Cached state of the channel's multisynth
  * @param[in]   ch      Channel
  * @param[in]   rate    Rational rate requested
  * @param[out]  actual  Rational rate actually set
@@ -41,6 +77,7 @@
  * @return 0 on success, BLADERF_ERR_* value on failure
  */
 int si5338_set_rational_sample_rate(struct bladerf *dev,
+                                    struct si5338_cache *cache,
                                     bladerf_channel ch,
                                     const struct bladerf_rational_rate *rate,
                                     struct bladerf_rational_rate *actual);
@@ -49,12 +86,14 @@ int si5338_set_rational_sample_rate(struct bladerf *dev,
  * Get the rational sample rate of the specified channel.
  *
  * @param       dev     Device handle
+ * @param       cache   Cached state of the channel's multisynth
  * @param[in]   ch      Channel
  * @param[out]  rate    Rational rate
  *
  * @return 0 on success, BLADERF_ERR_* value on failure
  */
 int si5338_get_rational_sample_rate(struct bladerf *dev,
+                                    struct si5338_cache *cache,
                                     bladerf_channel ch,
                                     struct bladerf_rational_rate *rate);
 
@@ -62,6 +101,7 @@ int si5338_get_rational_sample_rate(struct bladerf *dev,
  * Set the integral sample rate of the specified channel.
  *
  * @param       dev     Device handle
+ * @param       cache   Cached state of the channel's multisynth
  * @param[in]   ch      Channel
  * @param[in]   rate    Integral rate requested
  * @param[out]  actual  Integral rate actually set
@@ -69,6 +109,7 @@ int si5338_get_rational_sample_rate(struct bladerf *dev,
  * @return 0 on success, BLADERF_ERR_* value on failure
  */
 int si5338_set_sample_rate(struct bladerf *dev,
+                           struct si5338_cache *cache,
                            bladerf_channel ch,
                            uint32_t rate,
                            uint32_t *actual);
@@ -77,12 +118,14 @@ int si5338_set_sample_rate(struct bladerf *dev,
  * Get the integral sample rate of the specified channel.
  *
  * @param       dev     Device handle
+ * @param       cache   Cached state of the channel's multisynth
  * @param[in]   ch      Channel
  * @param[out]  rate    Integral rate
  *
  * @return 0 on success, BLADERF_ERR_* value on failure
  */
 int si5338_get_sample_rate(struct bladerf *dev,
+                           struct si5338_cache *cache,
                            bladerf_channel ch,
                            unsigned int *rate);
 
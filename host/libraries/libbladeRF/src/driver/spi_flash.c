@@ -112,6 +112,19 @@ int spi_flash_verify(struct bladerf *dev, uint8_t *readback_buf,
     const size_t len = count * dev->flash_arch->psize_bytes;
 
     log_info("Verifying %u pages, starting at page %u\n", count, page);
+
+    /* Have the device checksum its flash contents, if it can. On a mismatch,
+     * read the pages back to report the offending byte. */
+    status = dev->backend->verify_flash_pages(dev, expected_buf, page, count);
+    if (status == 0) {
+        log_info("Flash contents match expected CRC-32\n");
+        return 0;
+    } else if (status != BLADERF_ERR_UNSUPPORTED &&
+               status != BLADERF_ERR_CHECKSUM) {
+        log_debug("Failed to verify flash: %s\n", bladerf_strerror(status));
+        return status;
+    }
+
     status = spi_flash_read(dev, readback_buf, page, count);
 
     if (status < 0) {
@@ -132,3 +145,103 @@ int spi_flash_verify(struct bladerf *dev, uint8_t *readback_buf,
     return status;
 }
 
+/* Check whether an erase block already holds `expected` */
+static int eb_matches(struct bladerf *dev, uint8_t *readback_buf,
+                      const uint8_t *expected, uint32_t erase_block,
+                      bool *match)
+{
+    const uint32_t pages_per_eb =
+        dev->flash_arch->ebsize_bytes / dev->flash_arch->psize_bytes;
+    const uint32_t page = erase_block * pages_per_eb;
+    int status;
+
+    status = dev->backend->verify_flash_pages(dev, expected, page,
+                                              pages_per_eb);
+    if (status == 0 || status == BLADERF_ERR_CHECKSUM) {
+        *match = (status == 0);
+        return 0;
+    } else if (status != BLADERF_ERR_UNSUPPORTED) {
+        return status;
+    }
+
+    status = spi_flash_read(dev, readback_buf, page, pages_per_eb);
+    if (status == 0) {
+        *match = memcmp(readback_buf, expected,
+                        dev->flash_arch->ebsize_bytes) == 0;
+    }
+
+    return status;
+}
+
+static bool eb_erased(struct bladerf *dev, const uint8_t *buf)
+{
+    size_t i;
+
+    for (i = 0; i < dev->flash_arch->ebsize_bytes; i++) {
+        if (buf[i] != 0xff) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int spi_flash_update(struct bladerf *dev, uint8_t *readback_buf,
+                     const uint8_t *image, uint32_t erase_block,
+                     uint32_t count)
+{
+    const uint32_t ebsize = dev->flash_arch->ebsize_bytes;
+    const uint32_t pages_per_eb = ebsize / dev->flash_arch->psize_bytes;
+    uint32_t i, rewritten = 0;
+    const uint8_t *eb_image;
+    bool match;
+    int status;
+
+    status = check_eb_access(dev, erase_block, count);
+    if (status != 0) {
+        return status;
+    }
+
+    for (i = 0; i < count; i++) {
+        eb_image = image + (size_t)i * ebsize;
+
+        status = eb_matches(dev, readback_buf, eb_image, erase_block + i,
+                            &match);
+        if (status != 0) {
+            log_debug("Failed to check erase block %u: %s\n",
+                      erase_block + i, bladerf_strerror(status));
+            return status;
+        }
+
+        if (match) {
+            continue;
+        }
+
+        status = spi_flash_erase(dev, erase_block + i, 1);
+        if (status != 0) {
+            log_debug("Failed to erase block %u: %s\n", erase_block + i,
+                      bladerf_strerror(status));
+            return status;
+        }
+
+        /* An erased block reads as all 1s, so nothing more need be written
+         * to it */
+        if (!eb_erased(dev, eb_image)) {
+            status = spi_flash_write(dev, eb_image,
+                                     (erase_block + i) * pages_per_eb,
+                                     pages_per_eb);
+            if (status != 0) {
+                log_debug("Failed to write block %u: %s\n",
+                          erase_block + i, bladerf_strerror(status));
+                return status;
+            }
+        }
+
+        rewritten++;
+    }
+
+    log_info("Rewrote %u of %u erase blocks, starting at block %u\n",
+             rewritten, count, erase_block);
+
+    return 0;
+}
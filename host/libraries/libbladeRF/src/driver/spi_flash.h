@@ -64,6 +64,10 @@ int spi_flash_read(struct bladerf *dev,
 /**
  * Verify data in flash
  *
+ * If the device supports it, the flash contents are checked against the
+ * CRC-32 of `expected_buf` without being read back. Otherwise, or if this
+ * check fails, the data is read into `readback_buf` and compared.
+ *
  * @param       dev             Device handle
  * @param[out]  readback_buf    Buffer to read data into. Must be `count` *
  *                              flash-page-size bytes or larger.
@@ -96,4 +100,30 @@ int spi_flash_write(struct bladerf *dev,
                     uint32_t page,
                     uint32_t count);
 
+/**
+ * Bring erase blocks of flash up to date with an image
+ *
+ * Only the blocks whose contents differ from the image are erased and
+ * rewritten. Each is checked against the CRC-32 of its part of the image if
+ * the device supports it, or is otherwise read back and compared. The result
+ * is the same as erasing every block and writing the image, but is reached
+ * with less flash wear, and much sooner when little has changed.
+ *
+ * @param       dev             Device handle
+ * @param[out]  readback_buf    Buffer to read data into. Must be one erase
+ *                              block or larger.
+ * @param[in]   image           New contents of the blocks, `count` * erase
+ *                              block size bytes long
+ * @param[in]   erase_block     Erase block to start at
+ * @param[in]   count           Number of erase blocks
+ *
+ * @return 0 on success, or BLADERF_ERR_INVAL on an invalid `erase_block` or
+ * `count` value, or a value from \ref RETCODES list on other failures.
+ */
+int spi_flash_update(struct bladerf *dev,
+                     uint8_t *readback_buf,
+                     const uint8_t *image,
+                     uint32_t erase_block,
+                     uint32_t count);
+
 #endif
@@ -0,0 +1,56 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+#include <libbladeRF.h>
+
+#include "stream_stats.h"
+
+/* The stream statistics sit on the Wishbone bus. Byte addresses: */
+#define STREAM_STATS_RX 0x38000
+#define STREAM_STATS_TX 0x38010
+
+int stream_stats_read(struct bladerf *dev,
+                      bladerf_direction dir,
+                      uint64_t *count,
+                      uint64_t *timestamp)
+{
+    const uint32_t addr = (dir == BLADERF_TX) ? STREAM_STATS_TX
+                                              : STREAM_STATS_RX;
+    uint32_t words[4];
+    size_t i;
+    int status;
+
+    /* Reading the low word of the count captures all four words, so it
+     * must come first */
+    for (i = 0; i < 4; i++) {
+        status = dev->backend->wishbone_master_read(dev, addr + 4 * i,
+                                                    &words[i]);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    *count     = ((uint64_t)words[1] << 32) | words[0];
+    *timestamp = ((uint64_t)words[3] << 32) | words[2];
+
+    return 0;
+}
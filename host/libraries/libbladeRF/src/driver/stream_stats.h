@@ -0,0 +1,47 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+#ifndef DRIVER_STREAM_STATS_H_
+#define DRIVER_STREAM_STATS_H_
+
+#include "board/board.h"
+
+/**
+ * Read the FPGA's RX overflow or TX underflow count
+ *
+ * The count runs from FPGA reset. The caller is responsible for checking
+ * that the FPGA has the counters.
+ *
+ * @param       dev         Device handle
+ * @param[in]   dir         Direction: RX overflows or TX underflows
+ * @param[out]  count       Number of events
+ * @param[out]  timestamp   Timestamp at which the latest event began, in the
+ *                          direction's timebase, or 0 if there were none
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int stream_stats_read(struct bladerf *dev,
+                      bladerf_direction dir,
+                      uint64_t *count,
+                      uint64_t *timestamp);
+
+#endif
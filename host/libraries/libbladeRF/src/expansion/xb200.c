@@ -54,6 +54,10 @@
 struct xb200_xb_data {
     /* Track filterbank selection for RX and TX auto-selection */
     bladerf_xb200_filter auto_filter[2];
+
+    /* Last path and filterbank written for RX and TX, or -1 if unknown */
+    int path[2];
+    int filter[2];
 };
 
 int xb200_attach(struct bladerf *dev)
@@ -82,6 +86,8 @@ int xb200_attach(struct bladerf *dev)
 
     dev->xb_data = xb_data;
 
+    xb200_invalidate(dev);
+
     log_debug("  Attaching transverter board\n");
     status = dev->backend->si5338_read(dev, 39, &val8);
     if (status < 0) {
@@ -167,6 +173,18 @@ void xb200_detach(struct bladerf *dev)
     }
 }
 
+void xb200_invalidate(struct bladerf *dev)
+{
+    struct xb200_xb_data *xb_data = dev->xb_data;
+
+    if (xb_data != NULL) {
+        xb_data->path[BLADERF_CHANNEL_RX(0)]   = -1;
+        xb_data->path[BLADERF_CHANNEL_TX(0)]   = -1;
+        xb_data->filter[BLADERF_CHANNEL_RX(0)] = -1;
+        xb_data->filter[BLADERF_CHANNEL_TX(0)] = -1;
+    }
+}
+
 int xb200_enable(struct bladerf *dev, bool enable)
 {
     int status;
@@ -305,46 +323,186 @@ int xb200_get_filterbank(struct bladerf *dev, bladerf_channel ch,
     return status;
 }
 
-static int set_filterbank_mux(struct bladerf *dev, bladerf_channel ch, bladerf_xb200_filter filter)
+/* Expansion GPIO mask and value selecting a channel's path and filterbank.
+ * Either may be negative to leave it out. */
+static void gpio_state(bladerf_channel ch,
+                       int path,
+                       int filter,
+                       uint32_t *mask,
+                       uint32_t *val)
+{
+    bool const rx = (ch == BLADERF_CHANNEL_RX(0));
+
+    *mask = 0;
+    *val  = 0;
+
+    if (path >= 0) {
+        *mask |= BLADERF_XB_RF_ON;
+        *val  |= BLADERF_XB_RF_ON;
+
+        if (rx) {
+            *mask |= BLADERF_XB_CONFIG_RX_BYPASS_MASK | BLADERF_XB_RX_ENABLE;
+            *val  |= (path == BLADERF_XB200_MIX)
+                         ? (BLADERF_XB_RX_ENABLE | BLADERF_XB_CONFIG_RX_PATH_MIX)
+                         : BLADERF_XB_CONFIG_RX_PATH_BYPASS;
+        } else {
+            *mask |= BLADERF_XB_CONFIG_TX_BYPASS_MASK | BLADERF_XB_TX_ENABLE;
+            *val  |= (path == BLADERF_XB200_MIX)
+                         ? (BLADERF_XB_TX_ENABLE | BLADERF_XB_CONFIG_TX_PATH_MIX)
+                         : BLADERF_XB_CONFIG_TX_PATH_BYPASS;
+        }
+    }
+
+    if (filter >= 0) {
+        *mask |= rx ? BLADERF_XB_RX_MASK : BLADERF_XB_TX_MASK;
+        *val  |= (uint32_t)filter << (rx ? BLADERF_XB_RX_SHIFT
+                                         : BLADERF_XB_TX_SHIFT);
+    }
+}
+
+#define LMS_RX_SWAP 0x40
+#define LMS_TX_SWAP 0x08
+
+/* Select a channel's path and filterbank with a single masked expansion GPIO
+ * write. Either may be negative to leave it unchanged. Selections that are
+ * already in effect are skipped. */
+static int configure(struct bladerf *dev,
+                     bladerf_channel ch,
+                     int path,
+                     int filter)
 {
-    int status;
-    uint32_t orig, val, mask;
-    unsigned int shift;
     static const char *filters[] = { "50M", "144M", "222M", "custom" };
+    struct xb200_xb_data *xb_data = dev->xb_data;
+    int status;
+    uint32_t val, mask;
+    uint8_t lval, lorig = 0;
 
-    assert(filter >= 0);
-    assert(filter < ARRAY_SIZE(filters));
+    if (xb_data != NULL) {
+        if (path >= 0 && xb_data->path[ch] == path) {
+            path = -1;
+        }
 
-    if (ch == BLADERF_CHANNEL_RX(0)) {
-        mask = BLADERF_XB_RX_MASK;
-        shift = BLADERF_XB_RX_SHIFT;
-    } else {
-        mask = BLADERF_XB_TX_MASK;
-        shift = BLADERF_XB_TX_SHIFT;
+        if (filter >= 0 && xb_data->filter[ch] == filter) {
+            filter = -1;
+        }
     }
 
-    status = dev->backend->expansion_gpio_read(dev, &orig);
-    if (status != 0) {
-        return status;
+    if (path < 0 && filter < 0) {
+        return 0;
     }
 
-    val = orig & ~mask;
-    val |= filter << shift;
+    if (path >= 0) {
+        /* The board can only have been powered off since it was last
+         * configured if we've lost track of its state */
+        bool const known = xb_data != NULL &&
+                           xb_data->path[BLADERF_CHANNEL_RX(0)] >= 0 &&
+                           xb_data->path[BLADERF_CHANNEL_TX(0)] >= 0;
 
-    if (orig != val) {
-        log_debug("Engaging %s band XB-200 %s filter\n", filters[filter],
-            mask == BLADERF_XB_TX_MASK ? "TX" : "RX");
+        if (xb_data != NULL) {
+            xb_data->path[ch] = -1;
+        }
 
-        status = dev->backend->expansion_gpio_write(dev, 0xffffffff, val);
+        status = LMS_READ(dev, 0x5A, &lorig);
         if (status != 0) {
             return status;
         }
+
+        lval = lorig;
+
+        if (path == BLADERF_XB200_MIX) {
+            lval |= (ch == BLADERF_CHANNEL_RX(0)) ? LMS_RX_SWAP : LMS_TX_SWAP;
+        } else {
+            lval &= ~((ch == BLADERF_CHANNEL_RX(0)) ? LMS_RX_SWAP
+                                                     : LMS_TX_SWAP);
+        }
+
+        if (lval != lorig) {
+            status = LMS_WRITE(dev, 0x5A, lval);
+            if (status != 0) {
+                return status;
+            }
+        }
+
+        if (!known) {
+            status = dev->backend->expansion_gpio_read(dev, &val);
+            if (status != 0) {
+                return status;
+            }
+
+            if (!(val & BLADERF_XB_RF_ON)) {
+                status = xb200_attach(dev);
+                if (status != 0) {
+                    return status;
+                }
+            }
+
+            /* This may have been replaced by the reattach */
+            xb_data = dev->xb_data;
+        }
     }
 
+    if (filter >= 0) {
+        assert((size_t)filter < ARRAY_SIZE(filters));
+
+        log_debug("Engaging %s band XB-200 %s filter\n", filters[filter],
+                  (ch == BLADERF_CHANNEL_TX(0)) ? "TX" : "RX");
+
+        if (xb_data != NULL) {
+            xb_data->filter[ch] = -1;
+        }
+    }
+
+    gpio_state(ch, path, filter, &mask, &val);
+
+    status = dev->backend->expansion_gpio_write(dev, mask, val);
+    if (status != 0) {
+        return status;
+    }
+
+    if (xb_data != NULL) {
+        if (path >= 0) {
+            xb_data->path[ch] = path;
+        }
+
+        if (filter >= 0) {
+            xb_data->filter[ch] = filter;
+        }
+    }
 
     return 0;
 }
 
+/* Filterbank the auto selection mode in effect chooses for a frequency, or
+ * -1 if the filterbank was selected manually */
+static int select_auto_filter(struct xb200_xb_data const *xb_data,
+                              bladerf_channel ch,
+                              uint64_t frequency)
+{
+    if (xb_data->auto_filter[ch] == BLADERF_XB200_AUTO_1DB) {
+        if (37774405 <= frequency && frequency <= 59535436) {
+            return BLADERF_XB200_50M;
+        } else if (128326173 <= frequency && frequency <= 166711171) {
+            return BLADERF_XB200_144M;
+        } else if (187593160 <= frequency && frequency <= 245346403) {
+            return BLADERF_XB200_222M;
+        } else {
+            return BLADERF_XB200_CUSTOM;
+        }
+    } else if (xb_data->auto_filter[ch] == BLADERF_XB200_AUTO_3DB) {
+        if (34782924 <= frequency && frequency <= 61899260) {
+            return BLADERF_XB200_50M;
+        } else if (121956957 <= frequency && frequency <= 178444099) {
+            return BLADERF_XB200_144M;
+        } else if (177522675 <= frequency && frequency <= 260140935) {
+            return BLADERF_XB200_222M;
+        } else {
+            return BLADERF_XB200_CUSTOM;
+        }
+    }
+
+    return -1;
+}
+
 int xb200_set_filterbank(struct bladerf *dev,
                          bladerf_channel ch,
                          bladerf_xb200_filter filter)
@@ -381,7 +539,7 @@ int xb200_set_filterbank(struct bladerf *dev,
         /* Invalidate the soft auto filter mode entry */
         xb_data->auto_filter[ch] = -1;
 
-        status = set_filterbank_mux(dev, ch, filter);
+        status = configure(dev, ch, -1, filter);
     }
 
     return status;
@@ -392,9 +550,7 @@ int xb200_auto_filter_selection(struct bladerf *dev,
                                 uint64_t frequency)
 {
     struct xb200_xb_data *xb_data = dev->xb_data;
-    bladerf_xb200_filter filter;
-
-    int status = 0;
+    int filter;
 
     if (frequency >= 300000000u) {
         return 0;
@@ -409,112 +565,115 @@ int xb200_auto_filter_selection(struct bladerf *dev,
         return BLADERF_ERR_INVAL;
     }
 
-    if (xb_data->auto_filter[ch] == BLADERF_XB200_AUTO_1DB) {
-        if (37774405 <= frequency && frequency <= 59535436) {
-            filter = BLADERF_XB200_50M;
-        } else if (128326173 <= frequency && frequency <= 166711171) {
-            filter = BLADERF_XB200_144M;
-        } else if (187593160 <= frequency && frequency <= 245346403) {
-            filter = BLADERF_XB200_222M;
-        } else {
-            filter = BLADERF_XB200_CUSTOM;
-        }
-
-        status = set_filterbank_mux(dev, ch, filter);
-    } else if (xb_data->auto_filter[ch] == BLADERF_XB200_AUTO_3DB) {
-        if (34782924 <= frequency && frequency <= 61899260) {
-            filter = BLADERF_XB200_50M;
-        } else if (121956957 <= frequency && frequency <= 178444099) {
-            filter = BLADERF_XB200_144M;
-        } else if (177522675 <= frequency && frequency <= 260140935) {
-            filter = BLADERF_XB200_222M;
-        } else {
-            filter = BLADERF_XB200_CUSTOM;
-        }
-
-        status = set_filterbank_mux(dev, ch, filter);
+    filter = select_auto_filter(xb_data, ch, frequency);
+    if (filter < 0) {
+        return 0;
     }
 
-    return status;
+    return configure(dev, ch, -1, filter);
 }
 
-#define LMS_RX_SWAP 0x40
-#define LMS_TX_SWAP 0x08
+/* Path and automatically selected filterbank (or -1) for a frequency, and
+ * the frequency the LMS6002D must then be tuned to */
+static void tuning(struct xb200_xb_data const *xb_data,
+                   bladerf_channel ch,
+                   uint64_t frequency,
+                   int *path,
+                   int *filter,
+                   uint64_t *lms_frequency)
+{
+    if (frequency < BLADERF_FREQUENCY_MIN) {
+        *path          = BLADERF_XB200_MIX;
+        *filter        = -1;
+        *lms_frequency = 1248000000 - frequency;
 
-int xb200_set_path(struct bladerf *dev,
-                   bladerf_channel ch, bladerf_xb200_path path) {
-    int status;
-    uint32_t val;
-    uint32_t mask;
-    uint8_t lval, lorig = 0;
+        if (xb_data != NULL) {
+            *filter = select_auto_filter(xb_data, ch, frequency);
+        }
+    } else {
+        *path          = BLADERF_XB200_BYPASS;
+        *filter        = -1;
+        *lms_frequency = frequency;
+    }
+}
 
-    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_TX(0))
-        return BLADERF_ERR_INVAL;
+int xb200_set_frequency(struct bladerf *dev,
+                        bladerf_channel ch,
+                        uint64_t frequency,
+                        uint64_t *lms_frequency)
+{
+    int path;
+    int filter;
 
-    status = check_xb200_path(path);
-    if (status != 0) {
-        return status;
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_TX(0)) {
+        return BLADERF_ERR_INVAL;
     }
 
-    status = LMS_READ(dev, 0x5A, &lorig);
-    if (status != 0) {
-        return status;
-    }
+    tuning(dev->xb_data, ch, frequency, &path, &filter, lms_frequency);
 
-    lval = lorig;
+    return configure(dev, ch, path, filter);
+}
 
-    if (path == BLADERF_XB200_MIX) {
-        lval |= (ch == BLADERF_CHANNEL_RX(0)) ? LMS_RX_SWAP : LMS_TX_SWAP;
-    } else {
-        lval &= ~((ch == BLADERF_CHANNEL_RX(0)) ? LMS_RX_SWAP : LMS_TX_SWAP);
-    }
+int xb200_get_retune_params(struct bladerf *dev,
+                            bladerf_channel ch,
+                            uint64_t frequency,
+                            uint64_t *lms_frequency,
+                            uint8_t *xb_gpio)
+{
+    struct xb200_xb_data *xb_data = dev->xb_data;
+    bladerf_xb200_filter current;
+    int path;
+    int filter;
+    int status;
 
-    status = LMS_WRITE(dev, 0x5A, lval);
-    if (status != 0) {
-        return status;
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_TX(0)) {
+        return BLADERF_ERR_INVAL;
     }
 
-    status = dev->backend->expansion_gpio_read(dev, &val);
-    if (status != 0) {
-        return status;
-    }
+    tuning(xb_data, ch, frequency, &path, &filter, lms_frequency);
 
-    status = dev->backend->expansion_gpio_read(dev, &val);
-    if (status != 0) {
-        return status;
-    }
+    /* The NIOS II writes the filterbank selection along with the path, so
+     * a manual selection must be carried along */
+    if (filter < 0) {
+        if (xb_data != NULL && xb_data->filter[ch] >= 0) {
+            filter = xb_data->filter[ch];
+        } else {
+            status = xb200_get_filterbank(dev, ch, &current);
+            if (status != 0) {
+                return status;
+            }
 
-    if (!(val & BLADERF_XB_RF_ON)) {
-        status = xb200_attach(dev);
-        if (status != 0) {
-            return status;
+            filter = current;
         }
     }
 
+    *xb_gpio = LMS_FREQ_XB_200_ENABLE |
+               ((filter << LMS_FREQ_XB_200_FILTER_SW_SHIFT) &
+                LMS_FREQ_XB_200_FILTER_SW) |
+               /* Mix selects the first of the bypass switch controls */
+               (((path == BLADERF_XB200_MIX) ? 1 : 2)
+                << LMS_FREQ_XB_200_PATH_SHIFT);
+
     if (ch == BLADERF_CHANNEL_RX(0)) {
-        mask = (BLADERF_XB_CONFIG_RX_BYPASS_MASK | BLADERF_XB_RX_ENABLE);
-    } else {
-        mask = (BLADERF_XB_CONFIG_TX_BYPASS_MASK | BLADERF_XB_TX_ENABLE);
+        *xb_gpio |= LMS_FREQ_XB_200_MODULE_RX;
     }
 
-    val |= BLADERF_XB_RF_ON;
-    val &= ~mask;
+    return 0;
+}
 
-    if (ch == BLADERF_CHANNEL_RX(0)) {
-        if (path == BLADERF_XB200_MIX) {
-            val |= (BLADERF_XB_RX_ENABLE | BLADERF_XB_CONFIG_RX_PATH_MIX);
-        } else {
-            val |= BLADERF_XB_CONFIG_RX_PATH_BYPASS;
-        }
-    } else {
-        if (path == BLADERF_XB200_MIX) {
-            val |= (BLADERF_XB_TX_ENABLE | BLADERF_XB_CONFIG_TX_PATH_MIX);
-        } else {
-            val |= BLADERF_XB_CONFIG_TX_PATH_BYPASS;
-        }
+int xb200_set_path(struct bladerf *dev,
+                   bladerf_channel ch, bladerf_xb200_path path) {
+    int status;
+
+    if (ch != BLADERF_CHANNEL_RX(0) && ch != BLADERF_CHANNEL_TX(0))
+        return BLADERF_ERR_INVAL;
+
+    status = check_xb200_path(path);
+    if (status != 0) {
+        return status;
     }
 
-    return dev->backend->expansion_gpio_write(dev, 0xffffffff, val);
+    return configure(dev, ch, path, -1);
 }
 
 int xb200_get_path(struct bladerf *dev,
@@ -37,6 +37,16 @@ void xb200_detach(struct bladerf *dev);
 int xb200_enable(struct bladerf *dev, bool enable);
 int xb200_init(struct bladerf *dev);
 
+/**
+ * Forget the path and filterbank selections that let xb200_set_path() and
+ * filterbank selection skip redundant writes. Call this after the expansion
+ * GPIOs or the LMS baseband swap register may have been changed by other
+ * means.
+ *
+ * @param       dev     Device handle
+ */
+void xb200_invalidate(struct bladerf *dev);
+
 /**
  * Select an XB-200 filterbank
  *
@@ -63,6 +73,42 @@ int xb200_auto_filter_selection(struct bladerf *dev,
                                 bladerf_channel ch,
                                 uint64_t frequency);
 
+/**
+ * Select the XB-200 path, and the filterbank if it is selected
+ * automatically, for a frequency. The expansion GPIO changes are made with a
+ * single masked write.
+ *
+ * @param       dev             Device handle
+ * @param[in]   ch              Channel
+ * @param[in]   frequency       Frequency
+ * @param[out]  lms_frequency   Frequency to tune the LMS6002D to
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int xb200_set_frequency(struct bladerf *dev,
+                        bladerf_channel ch,
+                        uint64_t frequency,
+                        uint64_t *lms_frequency);
+
+/**
+ * Get the XB-200 settings of a retune to a frequency, for the NIOS II to
+ * apply along with the retune. These are the settings xb200_set_frequency()
+ * would select.
+ *
+ * @param       dev             Device handle
+ * @param[in]   ch              Channel
+ * @param[in]   frequency       Frequency
+ * @param[out]  lms_frequency   Frequency to tune the LMS6002D to
+ * @param[out]  xb_gpio         XB-200 settings, as in struct lms_freq
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int xb200_get_retune_params(struct bladerf *dev,
+                            bladerf_channel ch,
+                            uint64_t frequency,
+                            uint64_t *lms_frequency,
+                            uint8_t *xb_gpio);
+
 /**
  * Get the current selected XB-200 filterbank
  *
@@ -283,6 +283,76 @@ static int apply_config_options(struct bladerf *dev, struct config_options opt)
     return status;
 }
 
+/* Options are applied in order of these phases, rather than in the order in
+ * which they appear. The FPGA is loaded first, since doing so reinitializes
+ * the device, and clocking is configured before anything that depends upon
+ * it. Sample rate and bandwidth precede frequency, so that the device is
+ * tuned (and, on the bladeRF 2.0 micro, calibrated) once with its final
+ * filter configuration. Options within a phase keep their file order. */
+static const struct {
+    const char *key;
+    int phase;
+} option_phases[] = {
+    { "fpga", 0 },         { "clock_sel", 1 },  { "refin_freq", 1 },
+    { "clock_ref", 1 },    { "vctcxo_tamer", 1 }, { "trimdac", 1 },
+    { "clock_out", 1 },    { "sampling", 2 },   { "samplerate", 3 },
+    { "bandwidth", 4 },    { "frequency", 5 },  { "agc", 6 },
+    { "biastee_rx", 7 },   { "biastee_tx", 7 }, { "gpio", 7 },
+};
+
+#define PHASE_FPGA 0
+#define PHASE_LAST 8
+
+static int option_phase(const struct config_options *opt)
+{
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(option_phases); i++) {
+        if (!strcasecmp(opt->key, option_phases[i].key)) {
+            return option_phases[i].phase;
+        }
+    }
+
+    /* Invalid keys are only reported, so their position doesn't matter */
+    return PHASE_LAST;
+}
+
+/* Fill in the order in which to apply options, omitting any that are
+ * overridden later in the file. Returns the number of options to apply. */
+static int order_options(const struct config_options *optv,
+                         int optc,
+                         int *order)
+{
+    int n = 0;
+    int i, j;
+
+    for (i = 0; i < optc; i++) {
+        bool superseded = false;
+
+        for (j = i + 1; j < optc && !superseded; j++) {
+            superseded = !strcasecmp(optv[i].key, optv[j].key);
+        }
+
+        if (superseded) {
+            log_verbose("Config line %d: `%s' is overridden later in the "
+                        "file\n", optv[i].lineno, optv[i].key);
+            continue;
+        }
+
+        /* Insert after all options of the same or an earlier phase */
+        for (j = n; j > 0 && option_phase(&optv[order[j - 1]]) >
+                                 option_phase(&optv[i]);
+             j--) {
+            order[j] = order[j - 1];
+        }
+
+        order[j] = i;
+        n++;
+    }
+
+    return n;
+}
+
 int config_load_options_file(struct bladerf *dev)
 {
     char *filename = NULL;
@@ -291,9 +361,12 @@ int config_load_options_file(struct bladerf *dev)
     uint8_t *buf = NULL;
     size_t buf_size;
 
-    int optc;
+    int optc, n;
     int j;
     struct config_options *optv;
+    int *order;
+    bool batch_tried = false;
+    bool batch       = false;
 
     filename = file_find("bladeRF.conf");
     if (!filename) {
@@ -316,11 +389,30 @@ int config_load_options_file(struct bladerf *dev)
         goto out_buf;
     }
 
-    for (j = 0; j < optc; j++) {
-        status = apply_config_options(dev, optv[j]);
+    order = calloc(optc > 0 ? optc : 1, sizeof(order[0]));
+    if (order == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto out_opts;
+    }
+
+    n = order_options(optv, optc, order);
+
+    for (j = 0; j < n; j++) {
+        struct config_options *opt = &optv[order[j]];
+
+        /* Once the FPGA is in place, queue up the remaining writes rather
+         * than waiting upon each in turn. Without an FPGA, or one that
+         * doesn't support batching, they are simply issued one at a time. */
+        if (!batch_tried && option_phase(opt) != PHASE_FPGA) {
+            batch_tried = true;
+            batch       = bladerf_is_fpga_configured(dev) > 0 &&
+                    bladerf_batch_begin(dev) == 0;
+        }
+
+        status = apply_config_options(dev, *opt);
         if (status < 0) {
-            log_warning("Invalid config option `%s' on line %d\n", optv[j].key,
-                        optv[j].lineno);
+            log_warning("Invalid config option `%s' on line %d\n", opt->key,
+                        opt->lineno);
             /* Some config options will require the FPGA to be loaded, however
              * this function is called during bladerf_open(). The solution is
              * to treat BLADERF_ERR_NOT_INIT as a warning and continue. */
@@ -332,6 +424,21 @@ int config_load_options_file(struct bladerf *dev)
         }
     }
 
+    if (batch) {
+        int commit_status = bladerf_batch_commit(dev);
+
+        if (commit_status < 0) {
+            log_warning("Failed to apply config options: %s\n",
+                        bladerf_strerror(commit_status));
+            if (status == 0) {
+                status = commit_status;
+            }
+        }
+    }
+
+    free(order);
+
+out_opts:
     free_opts(optv, optc);
 
 out_buf:
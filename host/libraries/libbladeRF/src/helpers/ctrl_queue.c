@@ -0,0 +1,249 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "rel_assert.h"
+#include "thread.h"
+
+#include "helpers/ctrl_queue.h"
+#include "helpers/timeout.h"
+
+#ifndef CTRL_QUEUE_LEN
+#   define CTRL_QUEUE_LEN 256
+#endif
+
+struct ctrl_queue {
+    struct bladerf *dev;
+    pthread_t thread;
+
+    MUTEX lock;             /* Protects all of the following */
+    pthread_cond_t work;    /* Signaled on submission and stop requests */
+    pthread_cond_t done;    /* Signaled as operations complete */
+    bool stop;
+
+    struct ctrl_op ops[CTRL_QUEUE_LEN];
+    unsigned int head;      /* Index of the oldest queued operation */
+    unsigned int count;     /* Number of queued operations */
+
+    /* Operations submitted and completed, for flushing. Completion includes
+     * the return of the callback. */
+    uint64_t submitted;
+    uint64_t completed;
+};
+
+static int execute(struct bladerf *dev, struct ctrl_op *op)
+{
+    switch (op->type) {
+        case CTRL_OP_SET_FREQUENCY:
+            return bladerf_set_frequency(dev, op->args.frequency.ch,
+                                         op->args.frequency.frequency);
+
+        case CTRL_OP_SET_GAIN:
+            return bladerf_set_gain(dev, op->args.gain.ch, op->args.gain.gain);
+
+        case CTRL_OP_SCHEDULE_RETUNE:
+            return bladerf_schedule_retune(
+                dev, op->args.retune.ch, op->args.retune.timestamp,
+                op->args.retune.frequency,
+                op->args.retune.use_quick_tune ? &op->args.retune.quick_tune
+                                               : NULL);
+
+        case CTRL_OP_GET_TIMESTAMP:
+            return bladerf_get_timestamp(dev, op->args.timestamp.dir,
+                                         op->args.timestamp.value);
+
+        default:
+            assert(!"Invalid control operation");
+            return BLADERF_ERR_UNEXPECTED;
+    }
+}
+
+static void *ctrl_queue_task(void *arg)
+{
+    struct ctrl_queue *q = (struct ctrl_queue *)arg;
+    struct ctrl_op op;
+    int status;
+
+    MUTEX_LOCK(&q->lock);
+
+    while (true) {
+        while (q->count == 0 && !q->stop) {
+            pthread_cond_wait(&q->work, &q->lock);
+        }
+
+        /* Queued operations are always carried out, even when stopping */
+        if (q->count == 0) {
+            break;
+        }
+
+        op      = q->ops[q->head];
+        q->head = (q->head + 1) % CTRL_QUEUE_LEN;
+        q->count--;
+
+        /* The lock is not held while the operation runs, so that callbacks
+         * (and other threads) may submit further operations */
+        MUTEX_UNLOCK(&q->lock);
+
+        status = execute(q->dev, &op);
+
+        if (status != 0) {
+            log_debug("%s: Control operation %d failed: %s\n", __FUNCTION__,
+                      op.type, bladerf_strerror(status));
+        }
+
+        if (op.cb != NULL) {
+            op.cb(q->dev, status, op.user_data);
+        }
+
+        MUTEX_LOCK(&q->lock);
+        q->completed++;
+        pthread_cond_broadcast(&q->done);
+    }
+
+    MUTEX_UNLOCK(&q->lock);
+
+    return NULL;
+}
+
+int ctrl_queue_start(struct ctrl_queue **queue, struct bladerf *dev)
+{
+    struct ctrl_queue *q;
+    int status;
+
+    q = calloc(1, sizeof(*q));
+    if (q == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    q->dev = dev;
+
+    MUTEX_INIT(&q->lock);
+
+    if (pthread_cond_init(&q->work, NULL) != 0) {
+        goto err_work;
+    }
+
+    if (pthread_cond_init(&q->done, NULL) != 0) {
+        goto err_done;
+    }
+
+    status = pthread_create(&q->thread, NULL, ctrl_queue_task, q);
+    if (status != 0) {
+        goto err_thread;
+    }
+
+    *queue = q;
+    return 0;
+
+err_thread:
+    pthread_cond_destroy(&q->done);
+err_done:
+    pthread_cond_destroy(&q->work);
+err_work:
+    MUTEX_DESTROY(&q->lock);
+    free(q);
+    return BLADERF_ERR_UNEXPECTED;
+}
+
+void ctrl_queue_stop(struct ctrl_queue *q)
+{
+    if (q == NULL) {
+        return;
+    }
+
+    MUTEX_LOCK(&q->lock);
+    q->stop = true;
+    pthread_cond_signal(&q->work);
+    MUTEX_UNLOCK(&q->lock);
+
+    pthread_join(q->thread, NULL);
+
+    pthread_cond_destroy(&q->done);
+    pthread_cond_destroy(&q->work);
+    MUTEX_DESTROY(&q->lock);
+    free(q);
+}
+
+int ctrl_queue_submit(struct ctrl_queue *q, const struct ctrl_op *op)
+{
+    int status = 0;
+
+    MUTEX_LOCK(&q->lock);
+
+    if (q->stop) {
+        status = BLADERF_ERR_INVAL;
+    } else if (q->count == CTRL_QUEUE_LEN) {
+        status = BLADERF_ERR_QUEUE_FULL;
+    } else {
+        q->ops[(q->head + q->count) % CTRL_QUEUE_LEN] = *op;
+        q->count++;
+        q->submitted++;
+        pthread_cond_signal(&q->work);
+    }
+
+    MUTEX_UNLOCK(&q->lock);
+
+    return status;
+}
+
+int ctrl_queue_flush(struct ctrl_queue *q, unsigned int timeout_ms)
+{
+    struct timespec deadline;
+    uint64_t target;
+    int status = 0;
+
+    /* A callback waiting on itself would never return */
+    if (pthread_equal(pthread_self(), q->thread)) {
+        log_debug("%s: Cannot flush from a completion callback\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (timeout_ms != 0 && populate_abs_timeout(&deadline, timeout_ms) != 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    MUTEX_LOCK(&q->lock);
+
+    target = q->submitted;
+
+    while (status == 0 && q->completed < target) {
+        if (timeout_ms == 0) {
+            status = pthread_cond_wait(&q->done, &q->lock);
+        } else {
+            status = pthread_cond_timedwait(&q->done, &q->lock, &deadline);
+        }
+    }
+
+    MUTEX_UNLOCK(&q->lock);
+
+    if (status == ETIMEDOUT) {
+        return BLADERF_ERR_TIMEOUT;
+    } else if (status != 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    return 0;
+}
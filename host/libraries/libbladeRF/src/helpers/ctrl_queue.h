@@ -0,0 +1,111 @@
+/**
+ * @file ctrl_queue.h
+ *
+ * @brief Queue of control operations carried out by a per-device worker
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_CTRL_QUEUE_H_
+#define HELPERS_CTRL_QUEUE_H_
+
+#include <stdbool.h>
+
+#include <libbladeRF.h>
+
+typedef enum {
+    CTRL_OP_SET_FREQUENCY,
+    CTRL_OP_SET_GAIN,
+    CTRL_OP_SCHEDULE_RETUNE,
+    CTRL_OP_GET_TIMESTAMP,
+} ctrl_op_type;
+
+struct ctrl_op {
+    ctrl_op_type type;
+
+    union {
+        struct {
+            bladerf_channel ch;
+            bladerf_frequency frequency;
+        } frequency;
+
+        struct {
+            bladerf_channel ch;
+            bladerf_gain gain;
+        } gain;
+
+        struct {
+            bladerf_channel ch;
+            bladerf_timestamp timestamp;
+            bladerf_frequency frequency;
+            bool use_quick_tune;
+            struct bladerf_quick_tune quick_tune; /* Copied at submission */
+        } retune;
+
+        struct {
+            bladerf_direction dir;
+            bladerf_timestamp *value;
+        } timestamp;
+    } args;
+
+    bladerf_ctrl_cb cb;
+    void *user_data;
+};
+
+struct ctrl_queue;
+
+/**
+ * Create a control queue and start its worker thread
+ *
+ * @param[out]  queue       Set to the new queue on success
+ * @param       dev         Device the queued operations are applied to
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int ctrl_queue_start(struct ctrl_queue **queue, struct bladerf *dev);
+
+/**
+ * Carry out all queued operations, then stop the worker and free the queue.
+ * The caller must not hold dev->lock.
+ *
+ * @param[in]   queue       Queue to stop. NULL is ignored.
+ */
+void ctrl_queue_stop(struct ctrl_queue *queue);
+
+/**
+ * Append an operation to the queue. The operation is copied.
+ *
+ * @return 0 on success, BLADERF_ERR_QUEUE_FULL if the queue is full
+ */
+int ctrl_queue_submit(struct ctrl_queue *queue, const struct ctrl_op *op);
+
+/**
+ * Wait for all operations submitted thus far to complete, including their
+ * callbacks.
+ *
+ * @return 0 on success, BLADERF_ERR_TIMEOUT on timeout, BLADERF_ERR_INVAL if
+ *         called from a completion callback
+ */
+int ctrl_queue_flush(struct ctrl_queue *queue, unsigned int timeout_ms);
+
+#endif
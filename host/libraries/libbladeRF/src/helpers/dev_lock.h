@@ -0,0 +1,82 @@
+/**
+ * @file dev_lock.h
+ *
+ * @brief Prioritized acquisition of the device handle lock
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_DEV_LOCK_H_
+#define HELPERS_DEV_LOCK_H_
+
+#include "thread.h"
+
+#include "board/board.h"
+
+/* All control operations share a single request/response path to the
+ * device, and some (e.g., flash access) change the device's USB
+ * configuration while running, so they are serialized by dev->lock.
+ *
+ * To keep latency-critical operations (retune scheduling, timestamp reads,
+ * triggers) from stalling behind long-running ones, the former register
+ * themselves as urgent waiters while blocked on the lock, and the latter
+ * periodically check for urgent waiters and briefly step aside. */
+
+/**
+ * Acquire dev->lock on behalf of a latency-critical operation. Release it
+ * with MUTEX_UNLOCK(&dev->lock), as usual.
+ */
+static inline void dev_lock_urgent(struct bladerf *dev)
+{
+    ATOMIC_INC(&dev->urgent_waiters);
+    MUTEX_LOCK(&dev->lock);
+    ATOMIC_DEC(&dev->urgent_waiters);
+}
+
+/**
+ * Hand dev->lock over to any waiting latency-critical operations, then
+ * re-acquire it. This must only be called with dev->lock held, at a point
+ * where the device is in its normal operating state.
+ *
+ * @return true if the lock was released in the meantime
+ */
+static inline bool dev_lock_yield(struct bladerf *dev)
+{
+    if (ATOMIC_LOAD(&dev->urgent_waiters) == 0) {
+        return false;
+    }
+
+    MUTEX_UNLOCK(&dev->lock);
+
+    /* Urgent waiters deregister once they hold the lock, so this only spins
+     * for as long as it takes them to be woken */
+    while (ATOMIC_LOAD(&dev->urgent_waiters) != 0) {
+        CPU_RELAX();
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    return true;
+}
+
+#endif
@@ -37,6 +37,14 @@
 
 #include "helpers/file.h"
 
+#if BLADERF_OS_WINDOWS
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
+
 /* Paths to search for bladeRF files */
 struct search_path_entries {
     bool prepend_home;
@@ -110,6 +118,20 @@ out:
     return rv;
 }
 
+static int errno_to_status(int err)
+{
+    switch (err) {
+        case ENOENT:
+            return BLADERF_ERR_NO_FILE;
+
+        case EACCES:
+            return BLADERF_ERR_PERMISSION;
+
+        default:
+            return BLADERF_ERR_IO;
+    }
+}
+
 int file_read_buffer(const char *filename, uint8_t **buf_ret, size_t *size_ret)
 {
     int status = BLADERF_ERR_UNEXPECTED;
@@ -121,16 +143,7 @@ int file_read_buffer(const char *filename, uint8_t **buf_ret, size_t *size_ret)
     if (!f) {
         log_error("%s: could not open %s: %s\n", __FUNCTION__, filename,
                   strerror(errno));
-        switch (errno) {
-            case ENOENT:
-                return BLADERF_ERR_NO_FILE;
-
-            case EACCES:
-                return BLADERF_ERR_PERMISSION;
-
-            default:
-                return BLADERF_ERR_IO;
-        }
+        return errno_to_status(errno);
     }
 
     len = file_size(f);
@@ -164,6 +177,185 @@ out:
     return status;
 }
 
+#if BLADERF_OS_WINDOWS
+int file_map(const char *filename, const uint8_t **data, size_t *size)
+{
+    HANDLE file, mapping;
+    LARGE_INTEGER len;
+    void *view = NULL;
+
+    file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        const DWORD err = GetLastError();
+        log_debug("%s: could not open %s: 0x%lx\n", __FUNCTION__, filename,
+                  err);
+        return (err == ERROR_FILE_NOT_FOUND) ? BLADERF_ERR_NO_FILE
+                                             : BLADERF_ERR_IO;
+    }
+
+    if (!GetFileSizeEx(file, &len) || len.QuadPart == 0 ||
+        (uint64_t)len.QuadPart > SIZE_MAX) {
+        CloseHandle(file);
+        return BLADERF_ERR_IO;
+    }
+
+    /* The view holds its own reference to the mapping and file */
+    mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping != NULL) {
+        view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+    }
+
+    CloseHandle(file);
+
+    if (view == NULL) {
+        log_debug("%s: could not map %s\n", __FUNCTION__, filename);
+        return BLADERF_ERR_IO;
+    }
+
+    *data = (const uint8_t *)view;
+    *size = (size_t)len.QuadPart;
+    return 0;
+}
+
+void file_unmap(const uint8_t *data, size_t size)
+{
+    if (data != NULL) {
+        UnmapViewOfFile(data);
+    }
+}
+#else
+int file_map(const char *filename, const uint8_t **data, size_t *size)
+{
+    struct stat st;
+    void *addr;
+    int fd;
+
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        log_debug("%s: could not open %s: %s\n", __FUNCTION__, filename,
+                  strerror(errno));
+        return errno_to_status(errno);
+    }
+
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return BLADERF_ERR_IO;
+    }
+
+    /* The mapping remains valid after the descriptor is closed */
+    addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (addr == MAP_FAILED) {
+        log_debug("%s: could not map %s: %s\n", __FUNCTION__, filename,
+                  strerror(errno));
+        return BLADERF_ERR_IO;
+    }
+
+    *data = (const uint8_t *)addr;
+    *size = (size_t)st.st_size;
+    return 0;
+}
+
+void file_unmap(const uint8_t *data, size_t size)
+{
+    if (data != NULL) {
+        munmap((void *)data, size);
+    }
+}
+#endif
+
+static bool state_path(const char *serial, const char *name, char *path,
+                       size_t len)
+{
+    char dir[PATH_MAX];
+    int n;
+
+#if BLADERF_OS_WINDOWS
+    DWORD dir_len = GetTempPathA(sizeof(dir), dir);
+    if (dir_len == 0 || dir_len >= sizeof(dir)) {
+        return false;
+    }
+#else
+    /* Prefer per-user locations, as state files are trusted */
+    const char *env = getenv("XDG_RUNTIME_DIR");
+    if (env == NULL) {
+        env = getenv("TMPDIR");
+    }
+
+    n = snprintf(dir, sizeof(dir), "%s/", (env != NULL) ? env : "/tmp");
+    if (n < 0 || (size_t)n >= sizeof(dir)) {
+        return false;
+    }
+#endif
+
+    n = snprintf(path, len, "%sbladeRF-%s-%s", dir, serial, name);
+    return n > 0 && (size_t)n < len;
+}
+
+#if BLADERF_OS_WINDOWS
+FILE *file_open_state(const char *serial, const char *name, bool write)
+{
+    char path[PATH_MAX];
+
+    if (!state_path(serial, name, path, sizeof(path))) {
+        return NULL;
+    }
+
+    return fopen(path, write ? "w" : "r");
+}
+#else
+FILE *file_open_state(const char *serial, const char *name, bool write)
+{
+    char path[PATH_MAX];
+    struct stat st;
+    FILE *f;
+    int fd;
+
+    if (!state_path(serial, name, path, sizeof(path))) {
+        return NULL;
+    }
+
+    if (write) {
+        fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW, 0600);
+    } else {
+        fd = open(path, O_RDONLY | O_NOFOLLOW);
+    }
+
+    if (fd < 0) {
+        if (write) {
+            log_debug("%s: could not open %s: %s\n", __FUNCTION__, path,
+                      strerror(errno));
+        }
+        return NULL;
+    }
+
+    /* Ignore files that another user may have planted */
+    if (fstat(fd, &st) != 0 || st.st_uid != geteuid()) {
+        close(fd);
+        return NULL;
+    }
+
+    f = fdopen(fd, write ? "w" : "r");
+    if (f == NULL) {
+        close(fd);
+    }
+
+    return f;
+}
+#endif
+
+void file_remove_state(const char *serial, const char *name)
+{
+    char path[PATH_MAX];
+
+    if (state_path(serial, name, path, sizeof(path))) {
+        remove(path);
+    }
+}
+
 /* Remove the last entry in a path. This is used to strip the executable name
 * from a path to get the directory that the executable resides in. */
 static size_t strip_last_path_entry(char *buf, char dir_delim)
@@ -30,6 +30,7 @@
 #ifndef HELPERS_FILE_H_
 #define HELPERS_FILE_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 
@@ -49,6 +50,31 @@
  */
 int file_read_buffer(const char *filename, uint8_t **buf, size_t *size);
 
+/**
+ * Map a file's contents into memory, read-only.
+ *
+ * This avoids copying the file into a buffer, e.g., for files whose contents
+ * are used in place.
+ *
+ * @param[in]   filename    File to map
+ * @param[out]  data        Upon success, this will point to the file contents
+ * @param[out]  size        Upon success, this will be updated to reflect the
+ *                          size of the file
+ *
+ * @return 0 on success, negative BLADERF_ERR_* value on failure. Empty files
+ *         cannot be mapped, and result in BLADERF_ERR_IO.
+ */
+int file_map(const char *filename, const uint8_t **data, size_t *size);
+
+/**
+ * Unmap a file mapped by file_map()
+ *
+ * @param[in]   data        File contents, as provided by file_map(). This may
+ *                          be NULL, in which case this function does nothing.
+ * @param[in]   size        File size, as provided by file_map()
+ */
+void file_unmap(const uint8_t *data, size_t size);
+
 /**
  * Write to an open file stream.
  *
@@ -83,6 +109,32 @@ int file_read(FILE *f, char *buf, size_t len);
  */
 ssize_t file_size(FILE *f);
 
+/**
+ * Open a per-user file holding state associated with a device, which should
+ * not outlive the system's uptime.
+ *
+ * The file is named "bladeRF-<serial>-<name>", and resides in
+ * $XDG_RUNTIME_DIR, $TMPDIR, or /tmp (or the temporary directory, on Windows).
+ * As its contents are trusted, symbolic links are not followed, and files owned
+ * by another user are ignored.
+ *
+ * @param[in]   serial      Device serial number
+ * @param[in]   name        State file name
+ * @param[in]   write       Create or truncate the file for writing if true.
+ *                          Otherwise, open an existing file for reading.
+ *
+ * @return Open file stream on success, NULL otherwise
+ */
+FILE *file_open_state(const char *serial, const char *name, bool write);
+
+/**
+ * Remove a state file created by file_open_state(), if it exists
+ *
+ * @param[in]   serial      Device serial number
+ * @param[in]   name        State file name
+ */
+void file_remove_state(const char *serial, const char *name);
+
 /**
  * Search for the specified filename in bladeRF config directories. If found,
  * the full path is returned. There is a chance that the file will be removed
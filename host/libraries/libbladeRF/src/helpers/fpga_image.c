@@ -0,0 +1,218 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_config.h"
+#include "log.h"
+
+#include "board/board.h"
+#include "helpers/file.h"
+#include "helpers/fpga_image.h"
+
+/* Invoke the progress callback roughly this often */
+#define PROGRESS_INTERVAL (64 * 1024)
+
+int fpga_image_open_file(struct fpga_image *img, const char *filename)
+{
+    ssize_t size;
+
+    memset(img, 0, sizeof(*img));
+
+    img->file = fopen(filename, "rb");
+    if (img->file == NULL) {
+        log_debug("%s: could not open %s: %s\n", __FUNCTION__, filename,
+                  strerror(errno));
+        return (errno == ENOENT) ? BLADERF_ERR_NO_FILE : BLADERF_ERR_IO;
+    }
+
+    size = file_size(img->file);
+    if (size < 0) {
+        fclose(img->file);
+        img->file = NULL;
+        return (int)size;
+    }
+
+    img->size = (size_t)size;
+    SHA256_Init(&img->sha);
+
+    return 0;
+}
+
+void fpga_image_init_buffer(struct fpga_image *img, const uint8_t *buf,
+                            size_t len)
+{
+    memset(img, 0, sizeof(*img));
+
+    img->buf  = buf;
+    img->size = len;
+    SHA256_Init(&img->sha);
+}
+
+void fpga_image_set_progress(struct fpga_image *img, bladerf_progress_cb cb,
+                             void *arg)
+{
+    img->progress     = cb;
+    img->progress_arg = arg;
+}
+
+int fpga_image_read(struct fpga_image *img, uint8_t *buf, size_t len)
+{
+    const size_t prev = img->pos;
+    int status;
+
+    if (len > img->size - img->pos) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (img->file != NULL) {
+        status = file_read(img->file, (char *)buf, len);
+        if (status != 0) {
+            return status;
+        }
+    } else {
+        memcpy(buf, &img->buf[img->pos], len);
+    }
+
+    SHA256_Update(&img->sha, buf, len);
+    img->pos += len;
+
+    if (img->progress != NULL &&
+        (img->pos == img->size ||
+         img->pos / PROGRESS_INTERVAL != prev / PROGRESS_INTERVAL)) {
+        img->progress(img->pos, img->size, img->progress_arg);
+    }
+
+    return 0;
+}
+
+int fpga_image_rewind(struct fpga_image *img)
+{
+    if (img->file != NULL && fseek(img->file, 0, SEEK_SET) != 0) {
+        return BLADERF_ERR_IO;
+    }
+
+    img->pos = 0;
+    SHA256_Init(&img->sha);
+
+    return 0;
+}
+
+int fpga_image_digest(struct fpga_image *img,
+                      uint8_t digest[SHA256_DIGEST_SIZE])
+{
+    const bladerf_progress_cb progress = img->progress;
+    uint8_t buf[16 * 1024];
+    size_t len;
+    int status = 0;
+
+    img->progress = NULL;
+
+    while (status == 0 && img->pos < img->size) {
+        len    = img->size - img->pos;
+        len    = (len < sizeof(buf)) ? len : sizeof(buf);
+        status = fpga_image_read(img, buf, len);
+    }
+
+    if (status == 0) {
+        SHA256_Final(digest, &img->sha);
+        status = fpga_image_rewind(img);
+    }
+
+    img->progress = progress;
+    return status;
+}
+
+void fpga_image_close(struct fpga_image *img)
+{
+    if (img->file != NULL) {
+        fclose(img->file);
+        img->file = NULL;
+    }
+}
+
+/******************************************************************************
+ * Loaded image cache
+ ******************************************************************************/
+
+/* State file name, as provided to file_open_state() */
+#define CACHE_NAME "fpga"
+
+static void format_entry(struct bladerf *dev,
+                         const uint8_t digest[SHA256_DIGEST_SIZE],
+                         char *buf, size_t len)
+{
+    char hex[2 * SHA256_DIGEST_SIZE + 1];
+    size_t i;
+
+    for (i = 0; i < SHA256_DIGEST_SIZE; i++) {
+        snprintf(&hex[2 * i], 3, "%02x", digest[i]);
+    }
+
+    snprintf(buf, len, "%s %u %u\n", hex, dev->ident.usb_bus,
+             dev->ident.usb_addr);
+}
+
+bool fpga_image_cache_match(struct bladerf *dev,
+                            const uint8_t digest[SHA256_DIGEST_SIZE])
+{
+    char expected[128];
+    char entry[128];
+    bool match = false;
+    FILE *f;
+
+    f = file_open_state(dev->ident.serial, CACHE_NAME, false);
+    if (f == NULL) {
+        return false;
+    }
+
+    format_entry(dev, digest, expected, sizeof(expected));
+
+    if (fgets(entry, sizeof(entry), f) != NULL) {
+        match = strcmp(entry, expected) == 0;
+    }
+
+    fclose(f);
+    return match;
+}
+
+void fpga_image_cache_store(struct bladerf *dev,
+                            const uint8_t digest[SHA256_DIGEST_SIZE])
+{
+    char entry[128];
+    FILE *f;
+
+    if (digest == NULL) {
+        file_remove_state(dev->ident.serial, CACHE_NAME);
+        return;
+    }
+
+    f = file_open_state(dev->ident.serial, CACHE_NAME, true);
+    if (f == NULL) {
+        return;
+    }
+
+    format_entry(dev, digest, entry, sizeof(entry));
+    fputs(entry, f);
+    fclose(f);
+}
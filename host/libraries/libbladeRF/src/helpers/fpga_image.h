@@ -0,0 +1,154 @@
+/**
+ * @file fpga_image.h
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_FPGA_IMAGE_H_
+#define HELPERS_FPGA_IMAGE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <libbladeRF.h>
+
+#include "sha256.h"
+
+/* An FPGA bitstream, read sequentially from a file or memory as it is sent to
+ * the device. This allows the backend to overlap reading the image with its
+ * transfer, without first reading the entire file into memory.
+ *
+ * A SHA-256 digest of the data is accumulated as it is read. */
+struct fpga_image {
+    size_t size;        /* Total image size, in bytes */
+    size_t pos;         /* Number of bytes read so far */
+
+    FILE *file;         /* Source file, or NULL if reading from `buf` */
+    const uint8_t *buf;
+
+    SHA256_CTX sha;
+
+    bladerf_progress_cb progress;
+    void *progress_arg;
+};
+
+/**
+ * Open an FPGA image file for reading
+ *
+ * @param[out]  img         Image to initialize
+ * @param[in]   filename    Bitstream file
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int fpga_image_open_file(struct fpga_image *img, const char *filename);
+
+/**
+ * Initialize an FPGA image that reads from a buffer. The buffer must remain
+ * valid until the image is closed.
+ *
+ * @param[out]  img         Image to initialize
+ * @param[in]   buf         Bitstream data
+ * @param[in]   len         Length of `buf`, in bytes
+ */
+void fpga_image_init_buffer(struct fpga_image *img, const uint8_t *buf,
+                            size_t len);
+
+/**
+ * Set a callback to be invoked as the image is read
+ *
+ * @param       img         Image
+ * @param[in]   cb          Progress callback. May be NULL.
+ * @param[in]   arg         User data passed to `cb`
+ */
+void fpga_image_set_progress(struct fpga_image *img, bladerf_progress_cb cb,
+                             void *arg);
+
+/**
+ * Read the next `len` bytes of the image
+ *
+ * @param       img         Image
+ * @param[out]  buf         Buffer to fill
+ * @param[in]   len         Number of bytes to read. Reading past the end of the
+ *                          image is an error.
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int fpga_image_read(struct fpga_image *img, uint8_t *buf, size_t len);
+
+/**
+ * Return to the start of the image, discarding the accumulated digest
+ *
+ * @param       img         Image
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int fpga_image_rewind(struct fpga_image *img);
+
+/**
+ * Read the remainder of the image and compute its SHA-256 digest, then
+ * rewind it. The progress callback is not invoked.
+ *
+ * @param       img         Image
+ * @param[out]  digest      Digest of the entire image
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int fpga_image_digest(struct fpga_image *img,
+                      uint8_t digest[SHA256_DIGEST_SIZE]);
+
+/**
+ * Close an image opened with fpga_image_open_file(). This is a no-op for
+ * images reading from a buffer.
+ *
+ * @param       img         Image
+ */
+void fpga_image_close(struct fpga_image *img);
+
+/**
+ * Check whether the FPGA of a device has been configured, by this library,
+ * with an image of the specified digest since the device last enumerated.
+ *
+ * This is tracked with a per-user cache file, keyed by serial number and USB
+ * bus/address, which fpga_image_cache_store() updates after each load.
+ *
+ * @param       dev         Device handle
+ * @param[in]   digest      Image digest
+ *
+ * @return true if the image is believed to already be loaded
+ */
+bool fpga_image_cache_match(struct bladerf *dev,
+                            const uint8_t digest[SHA256_DIGEST_SIZE]);
+
+/**
+ * Record the digest of the image loaded onto a device's FPGA
+ *
+ * @param       dev         Device handle
+ * @param[in]   digest      Digest of the loaded image, or NULL to record that
+ *                          the FPGA contents are unknown (e.g., before
+ *                          attempting a load)
+ */
+void fpga_image_cache_store(struct bladerf *dev,
+                            const uint8_t digest[SHA256_DIGEST_SIZE]);
+
+#endif
@@ -0,0 +1,347 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "conversions.h"
+#include "log.h"
+#include "thread.h"
+
+#include "helpers/hop_table.h"
+#include "helpers/timeout.h"
+
+/* Number of hop indices that may be queued on the host */
+#ifndef HOP_SEQUENCE_LEN
+#   define HOP_SEQUENCE_LEN 1024
+#endif
+
+/* Bounds on how long the thread waits for the Nios retune queue to drain
+ * after finding it full */
+#define HOP_POLL_MIN_MS 1
+#define HOP_POLL_MAX_MS 100
+
+/* A hop that has fallen behind the device is rescheduled this far ahead of
+ * the device's timestamp, to leave time for it to reach the device */
+#define HOP_LEAD_MS 10
+
+struct hop_entry {
+    bladerf_frequency frequency;
+    struct bladerf_quick_tune quick_tune;
+};
+
+struct hop_table {
+    struct bladerf *dev;
+    bladerf_channel ch;
+    bladerf_direction dir;
+
+    struct hop_entry *entries;
+    unsigned int num_entries;
+
+    pthread_t thread;
+    bool started;
+    unsigned int poll_ms;
+    uint64_t dwell;
+    uint64_t lead;       /* HOP_LEAD_MS, in ticks */
+    uint64_t skipped;    /* Dwell periods skipped by falling behind */
+
+    MUTEX lock;          /* Protects all of the following */
+    pthread_cond_t work; /* Signaled on enqueue and stop requests */
+    bool stop;
+    int status;          /* Error that stopped hopping, if any */
+
+    unsigned int seq[HOP_SEQUENCE_LEN];
+    unsigned int head;   /* Index of the oldest pending entry in `seq` */
+    unsigned int count;  /* Number of pending entries in `seq` */
+    bladerf_timestamp next;
+};
+
+static void *hop_table_task(void *arg)
+{
+    struct hop_table *t = (struct hop_table *)arg;
+    struct bladerf_quick_tune quick_tune;
+    struct timespec deadline;
+    bladerf_frequency frequency;
+    bladerf_timestamp timestamp;
+    bladerf_timestamp now;
+    uint64_t skipped;
+    int status;
+
+    MUTEX_LOCK(&t->lock);
+
+    while (!t->stop) {
+        if (t->count == 0 || t->status != 0) {
+            pthread_cond_wait(&t->work, &t->lock);
+            continue;
+        }
+
+        frequency  = t->entries[t->seq[t->head]].frequency;
+        quick_tune = t->entries[t->seq[t->head]].quick_tune;
+        timestamp  = t->next;
+        skipped    = 0;
+
+        MUTEX_UNLOCK(&t->lock);
+
+        /* Rather than hand the device a burst of hops that are already due,
+         * restart the schedule from just ahead of the device's time */
+        status = bladerf_get_timestamp(t->dev, t->dir, &now);
+        if (status == 0 && timestamp < now + t->lead) {
+            skipped   = (now + t->lead - timestamp + t->dwell - 1) / t->dwell;
+            timestamp = now + t->lead;
+        }
+
+        if (status == 0) {
+            status = bladerf_schedule_retune(t->dev, t->ch, timestamp,
+                                             frequency, &quick_tune);
+        }
+
+        MUTEX_LOCK(&t->lock);
+
+        if (status == 0) {
+            if (skipped != 0) {
+                t->skipped += skipped;
+                log_warning("%s: %s hop schedule fell behind. Skipped %" PRIu64
+                            " dwell periods (%" PRIu64 " in total).\n",
+                            __FUNCTION__, channel2str(t->ch), skipped,
+                            t->skipped);
+            }
+
+            t->head = (t->head + 1) % HOP_SEQUENCE_LEN;
+            t->count--;
+            t->next = timestamp + t->dwell;
+        } else if (status == BLADERF_ERR_QUEUE_FULL) {
+            /* Wait for a scheduled hop to occur, unless asked to stop */
+            if (populate_abs_timeout(&deadline, t->poll_ms) == 0) {
+                pthread_cond_timedwait(&t->work, &t->lock, &deadline);
+            }
+        } else {
+            log_error("%s: Failed to schedule hop at %" PRIu64 ": %s\n",
+                      __FUNCTION__, timestamp, bladerf_strerror(status));
+            t->status = status;
+        }
+    }
+
+    MUTEX_UNLOCK(&t->lock);
+
+    return NULL;
+}
+
+int hop_table_create(struct hop_table **table,
+                     struct bladerf *dev,
+                     bladerf_channel ch,
+                     const bladerf_frequency *freqs,
+                     unsigned int num_freqs)
+{
+    struct hop_table *t;
+    bladerf_frequency orig_freq;
+    unsigned int i;
+    int status;
+
+    if (num_freqs == 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    t = calloc(1, sizeof(*t));
+    if (t == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    t->entries = calloc(num_freqs, sizeof(t->entries[0]));
+    if (t->entries == NULL) {
+        free(t);
+        return BLADERF_ERR_MEM;
+    }
+
+    t->dev         = dev;
+    t->ch          = ch;
+    t->dir         = BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX : BLADERF_RX;
+    t->num_entries = num_freqs;
+
+    status = bladerf_get_frequency(dev, ch, &orig_freq);
+    if (status != 0) {
+        goto error;
+    }
+
+    for (i = 0; i < num_freqs; i++) {
+        t->entries[i].frequency = freqs[i];
+
+        status = bladerf_set_frequency(dev, ch, freqs[i]);
+        if (status == 0) {
+            status =
+                bladerf_get_quick_tune(dev, ch, &t->entries[i].quick_tune);
+        }
+
+        if (status != 0) {
+            log_debug("%s: Failed to build entry %u (%" PRIu64 " Hz): %s\n",
+                      __FUNCTION__, i, freqs[i], bladerf_strerror(status));
+            bladerf_set_frequency(dev, ch, orig_freq);
+            goto error;
+        }
+    }
+
+    status = bladerf_set_frequency(dev, ch, orig_freq);
+    if (status != 0) {
+        goto error;
+    }
+
+    MUTEX_INIT(&t->lock);
+
+    if (pthread_cond_init(&t->work, NULL) != 0) {
+        MUTEX_DESTROY(&t->lock);
+        status = BLADERF_ERR_UNEXPECTED;
+        goto error;
+    }
+
+    *table = t;
+    return 0;
+
+error:
+    free(t->entries);
+    free(t);
+    return status;
+}
+
+void hop_table_free(struct hop_table *t)
+{
+    int status;
+
+    if (t == NULL) {
+        return;
+    }
+
+    if (t->started) {
+        MUTEX_LOCK(&t->lock);
+        t->stop = true;
+        pthread_cond_signal(&t->work);
+        MUTEX_UNLOCK(&t->lock);
+
+        pthread_join(t->thread, NULL);
+
+        status = bladerf_cancel_scheduled_retunes(t->dev, t->ch);
+        if (status != 0) {
+            log_debug("%s: Failed to cancel scheduled hops: %s\n",
+                      __FUNCTION__, bladerf_strerror(status));
+        }
+    }
+
+    pthread_cond_destroy(&t->work);
+    MUTEX_DESTROY(&t->lock);
+    free(t->entries);
+    free(t);
+}
+
+int hop_table_start(struct hop_table *t,
+                    bladerf_timestamp start,
+                    uint64_t dwell)
+{
+    bladerf_sample_rate rate;
+    uint64_t dwell_ms;
+    int status;
+
+    if (t->started || dwell == 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = bladerf_get_sample_rate(t->dev, t->ch, &rate);
+    if (status != 0) {
+        return status;
+    }
+
+    /* Check for room in the Nios queue about twice per hop */
+    dwell_ms   = (rate == 0) ? HOP_POLL_MAX_MS : (dwell * 1000) / rate;
+    t->poll_ms = (unsigned int)(dwell_ms / 2);
+
+    if (t->poll_ms < HOP_POLL_MIN_MS) {
+        t->poll_ms = HOP_POLL_MIN_MS;
+    } else if (t->poll_ms > HOP_POLL_MAX_MS) {
+        t->poll_ms = HOP_POLL_MAX_MS;
+    }
+
+    t->dwell = dwell;
+    t->lead  = ((uint64_t)rate * HOP_LEAD_MS) / 1000;
+    t->next  = start;
+
+    status = pthread_create(&t->thread, NULL, hop_table_task, t);
+    if (status != 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    t->started = true;
+    return 0;
+}
+
+int hop_table_enqueue(struct hop_table *t,
+                      const unsigned int *indices,
+                      unsigned int count)
+{
+    unsigned int i;
+    int status = 0;
+
+    for (i = 0; i < count; i++) {
+        if (indices[i] >= t->num_entries) {
+            log_debug("%s: Invalid hop index: %u\n", __FUNCTION__,
+                      indices[i]);
+            return BLADERF_ERR_INVAL;
+        }
+    }
+
+    MUTEX_LOCK(&t->lock);
+
+    if (count > HOP_SEQUENCE_LEN - t->count) {
+        status = BLADERF_ERR_QUEUE_FULL;
+    } else {
+        for (i = 0; i < count; i++) {
+            t->seq[(t->head + t->count) % HOP_SEQUENCE_LEN] = indices[i];
+            t->count++;
+        }
+
+        pthread_cond_signal(&t->work);
+    }
+
+    MUTEX_UNLOCK(&t->lock);
+
+    return status;
+}
+
+int hop_table_status(struct hop_table *t,
+                     unsigned int *pending,
+                     bladerf_timestamp *next)
+{
+    int status;
+
+    MUTEX_LOCK(&t->lock);
+
+    if (pending != NULL) {
+        *pending = t->count;
+    }
+
+    if (next != NULL) {
+        *next = t->next;
+    }
+
+    status = t->status;
+
+    MUTEX_UNLOCK(&t->lock);
+
+    return status;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file hop_table.h
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_HOP_TABLE_H_
+#define HELPERS_HOP_TABLE_H_
+
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+/* A table of precomputed quick tune entries for one channel, and a background
+ * thread that walks a caller-supplied sequence of table indices, keeping the
+ * Nios retune queue filled with one hop per dwell period.
+ *
+ * The thread schedules retunes through bladerf_schedule_retune(), so the
+ * functions below must be called without dev->lock held. */
+struct hop_table;
+
+/**
+ * Create a hop table by tuning to each frequency in turn and fetching its
+ * quick tune parameters. The channel is returned to its prior frequency
+ * afterwards.
+ *
+ * @param[out]  table       Set to the new table on success
+ * @param       dev         Device handle
+ * @param[in]   ch          Channel
+ * @param[in]   freqs       Frequencies, in Hz
+ * @param[in]   num_freqs   Number of entries in `freqs`
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int hop_table_create(struct hop_table **table,
+                     struct bladerf *dev,
+                     bladerf_channel ch,
+                     const bladerf_frequency *freqs,
+                     unsigned int num_freqs);
+
+/**
+ * Stop hopping, cancel any retunes already handed to the device, and free
+ * the table. NULL is ignored.
+ */
+void hop_table_free(struct hop_table *table);
+
+/**
+ * Start the hop thread. The first queued index is tuned at `start`, and each
+ * following one `dwell` ticks after its predecessor.
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if already started, or another
+ *         BLADERF_ERR_* value on failure
+ */
+int hop_table_start(struct hop_table *table,
+                    bladerf_timestamp start,
+                    uint64_t dwell);
+
+/**
+ * Append indices to the hop sequence. Either all or none are accepted.
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if an index is out of range,
+ *         BLADERF_ERR_QUEUE_FULL if there is insufficient space
+ */
+int hop_table_enqueue(struct hop_table *table,
+                      const unsigned int *indices,
+                      unsigned int count);
+
+/**
+ * Fetch the hop sequence state
+ *
+ * @param[in]   table       Table
+ * @param[out]  pending     Indices not yet handed to the device. May be NULL.
+ * @param[out]  next        Timestamp of the next hop to be handed to the
+ *                          device. May be NULL.
+ *
+ * @return 0, or the error that stopped the hop thread
+ */
+int hop_table_status(struct hop_table *table,
+                     unsigned int *pending,
+                     bladerf_timestamp *next);
+
+#endif
@@ -19,12 +19,37 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <libbladeRF.h>
 
+#include "rel_assert.h"
+#include "thread.h"
+
 #include "helpers/interleave.h"
 
+#if defined(LIBBLADERF_NO_SIMD)
+/* Scalar loops only, e.g., to benchmark against */
+#elif defined(__SSE2__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define INTERLEAVE_USE_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define INTERLEAVE_USE_NEON
+#endif
+
+/* In-place (de)interleaving of a 2-channel buffer requires scratch space for
+ * half of the payload. Buffers up to this size are handled with scratch space
+ * on the stack; larger buffers use a per-thread heap buffer, which is only
+ * reallocated when a larger buffer comes along. A thread that keeps
+ * (de)interleaving buffers of the same size thus allocates only once. */
+#ifndef INTERLEAVE_STACK_SCRATCH_BYTES
+#   define INTERLEAVE_STACK_SCRATCH_BYTES (16 * 1024)
+#endif
+
 size_t _interleave_calc_num_channels(bladerf_channel_layout layout)
 {
     switch (layout) {
@@ -49,7 +74,20 @@ size_t _interleave_calc_bytes_per_sample(bladerf_format format)
         case BLADERF_FORMAT_SC16_Q11:
         case BLADERF_FORMAT_SC16_Q11_META:
         case BLADERF_FORMAT_PACKET_META:
+        case BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11:
+        case BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META:
             return 4;
+
+        case BLADERF_FORMAT_CF32:
+        case BLADERF_FORMAT_CF32_META:
+        case BLADERF_FORMAT_SC8_Q7_AS_CF32:
+        case BLADERF_FORMAT_SC8_Q7_AS_CF32_META:
+            return 8;
+
+        /* Packed samples are not handled by these helpers */
+        case BLADERF_FORMAT_SC12_PACKED:
+        case BLADERF_FORMAT_SC12_PACKED_META:
+            return 0;
     }
 
     return 0;
@@ -65,63 +103,399 @@ size_t _interleave_calc_metadata_bytes(bladerf_format format)
         case BLADERF_FORMAT_SC8_Q7:
         case BLADERF_FORMAT_SC16_Q11:
             return 0;
+
+        /* Metadata is not carried in host-converted sample buffers */
+        case BLADERF_FORMAT_CF32:
+        case BLADERF_FORMAT_CF32_META:
+        case BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11:
+        case BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META:
+        case BLADERF_FORMAT_SC8_Q7_AS_CF32:
+        case BLADERF_FORMAT_SC8_Q7_AS_CF32_META:
+            return 0;
+
+        case BLADERF_FORMAT_SC12_PACKED:
+        case BLADERF_FORMAT_SC12_PACKED_META:
+            return 0;
+    }
+
+    return 0;
+}
+
+/******************************************************************************
+ * Format-specialized 2-channel kernels
+ *
+ * An SC16Q11 sample (I+Q) is moved as a single 32-bit word, and an SC8Q7
+ * sample as a single 16-bit word. None of these kernels look at sample
+ * values, so no endianness conversions are required.
+ ******************************************************************************/
+
+/* Split [a0 b0 a1 b1 ...] into [a0 a1 ...] and [b0 b1 ...]
+ *
+ * `a` may alias `src`: outputs are written strictly behind the inputs. */
+static void deinterleave2_u32(const uint32_t *src,
+                              uint32_t *a,
+                              uint32_t *b,
+                              size_t n)
+{
+    size_t i = 0;
+
+#if defined(INTERLEAVE_USE_SSE2)
+    for (; i + 4 <= n; i += 4) {
+        __m128i x0 = _mm_loadu_si128((const __m128i *)(src + 2 * i));
+        __m128i x1 = _mm_loadu_si128((const __m128i *)(src + 2 * i + 4));
+
+        /* [a0 b0 a1 b1] -> [a0 a1 b0 b1] */
+        x0 = _mm_shuffle_epi32(x0, _MM_SHUFFLE(3, 1, 2, 0));
+        x1 = _mm_shuffle_epi32(x1, _MM_SHUFFLE(3, 1, 2, 0));
+
+        _mm_storeu_si128((__m128i *)(a + i), _mm_unpacklo_epi64(x0, x1));
+        _mm_storeu_si128((__m128i *)(b + i), _mm_unpackhi_epi64(x0, x1));
+    }
+#elif defined(INTERLEAVE_USE_NEON)
+    for (; i + 4 <= n; i += 4) {
+        uint32x4x2_t x = vld2q_u32(src + 2 * i);
+        vst1q_u32(a + i, x.val[0]);
+        vst1q_u32(b + i, x.val[1]);
+    }
+#endif
+
+    for (; i < n; i++) {
+        const uint32_t sa = src[2 * i];
+        const uint32_t sb = src[2 * i + 1];
+        a[i]              = sa;
+        b[i]              = sb;
+    }
+}
+
+/* Merge [a0 a1 ...] and [b0 b1 ...] into [a0 b0 a1 b1 ...]
+ *
+ * `a` may alias `dst`: the buffer is walked from the end, so outputs are
+ * only ever written at or ahead of the inputs still to be read. */
+static void interleave2_u32(const uint32_t *a,
+                            const uint32_t *b,
+                            uint32_t *dst,
+                            size_t n)
+{
+    size_t i = n;
+
+    /* Handle the tail that doesn't fill an entire vector first */
+    for (; i % 4 != 0; i--) {
+        const uint32_t sa = a[i - 1];
+        const uint32_t sb = b[i - 1];
+        dst[2 * (i - 1)]     = sa;
+        dst[2 * (i - 1) + 1] = sb;
+    }
+
+    for (; i >= 4; i -= 4) {
+#if defined(INTERLEAVE_USE_SSE2)
+        const __m128i va = _mm_loadu_si128((const __m128i *)(a + i - 4));
+        const __m128i vb = _mm_loadu_si128((const __m128i *)(b + i - 4));
+
+        _mm_storeu_si128((__m128i *)(dst + 2 * (i - 4)),
+                         _mm_unpacklo_epi32(va, vb));
+        _mm_storeu_si128((__m128i *)(dst + 2 * (i - 4) + 4),
+                         _mm_unpackhi_epi32(va, vb));
+#elif defined(INTERLEAVE_USE_NEON)
+        uint32x4x2_t x;
+        x.val[0] = vld1q_u32(a + i - 4);
+        x.val[1] = vld1q_u32(b + i - 4);
+        vst2q_u32(dst + 2 * (i - 4), x);
+#else
+        size_t j;
+        uint32_t sa[4], sb[4];
+
+        for (j = 0; j < 4; j++) {
+            sa[j] = a[i - 4 + j];
+            sb[j] = b[i - 4 + j];
+        }
+
+        for (j = 0; j < 4; j++) {
+            dst[2 * (i - 4 + j)]     = sa[j];
+            dst[2 * (i - 4 + j) + 1] = sb[j];
+        }
+#endif
+    }
+}
+
+/* 16-bit (SC8Q7) equivalent of deinterleave2_u32() */
+static void deinterleave2_u16(const uint16_t *src,
+                              uint16_t *a,
+                              uint16_t *b,
+                              size_t n)
+{
+    size_t i = 0;
+
+#if defined(INTERLEAVE_USE_SSE2)
+    for (; i + 8 <= n; i += 8) {
+        __m128i x0 = _mm_loadu_si128((const __m128i *)(src + 2 * i));
+        __m128i x1 = _mm_loadu_si128((const __m128i *)(src + 2 * i + 8));
+
+        /* [a0 b0 a1 b1 a2 b2 a3 b3] -> [a0 a1 a2 a3 b0 b1 b2 b3] */
+        x0 = _mm_shufflelo_epi16(x0, _MM_SHUFFLE(3, 1, 2, 0));
+        x0 = _mm_shufflehi_epi16(x0, _MM_SHUFFLE(3, 1, 2, 0));
+        x0 = _mm_shuffle_epi32(x0, _MM_SHUFFLE(3, 1, 2, 0));
+
+        x1 = _mm_shufflelo_epi16(x1, _MM_SHUFFLE(3, 1, 2, 0));
+        x1 = _mm_shufflehi_epi16(x1, _MM_SHUFFLE(3, 1, 2, 0));
+        x1 = _mm_shuffle_epi32(x1, _MM_SHUFFLE(3, 1, 2, 0));
+
+        _mm_storeu_si128((__m128i *)(a + i), _mm_unpacklo_epi64(x0, x1));
+        _mm_storeu_si128((__m128i *)(b + i), _mm_unpackhi_epi64(x0, x1));
+    }
+#elif defined(INTERLEAVE_USE_NEON)
+    for (; i + 8 <= n; i += 8) {
+        uint16x8x2_t x = vld2q_u16(src + 2 * i);
+        vst1q_u16(a + i, x.val[0]);
+        vst1q_u16(b + i, x.val[1]);
+    }
+#endif
+
+    for (; i < n; i++) {
+        const uint16_t sa = src[2 * i];
+        const uint16_t sb = src[2 * i + 1];
+        a[i]              = sa;
+        b[i]              = sb;
+    }
+}
+
+/* 16-bit (SC8Q7) equivalent of interleave2_u32() */
+static void interleave2_u16(const uint16_t *a,
+                            const uint16_t *b,
+                            uint16_t *dst,
+                            size_t n)
+{
+    size_t i = n;
+
+    for (; i % 8 != 0; i--) {
+        const uint16_t sa = a[i - 1];
+        const uint16_t sb = b[i - 1];
+        dst[2 * (i - 1)]     = sa;
+        dst[2 * (i - 1) + 1] = sb;
+    }
+
+    for (; i >= 8; i -= 8) {
+#if defined(INTERLEAVE_USE_SSE2)
+        const __m128i va = _mm_loadu_si128((const __m128i *)(a + i - 8));
+        const __m128i vb = _mm_loadu_si128((const __m128i *)(b + i - 8));
+
+        _mm_storeu_si128((__m128i *)(dst + 2 * (i - 8)),
+                         _mm_unpacklo_epi16(va, vb));
+        _mm_storeu_si128((__m128i *)(dst + 2 * (i - 8) + 8),
+                         _mm_unpackhi_epi16(va, vb));
+#elif defined(INTERLEAVE_USE_NEON)
+        uint16x8x2_t x;
+        x.val[0] = vld1q_u16(a + i - 8);
+        x.val[1] = vld1q_u16(b + i - 8);
+        vst2q_u16(dst + 2 * (i - 8), x);
+#else
+        size_t j;
+        uint16_t sa[8], sb[8];
+
+        for (j = 0; j < 8; j++) {
+            sa[j] = a[i - 8 + j];
+            sb[j] = b[i - 8 + j];
+        }
+
+        for (j = 0; j < 8; j++) {
+            dst[2 * (i - 8 + j)]     = sa[j];
+            dst[2 * (i - 8 + j) + 1] = sb[j];
+        }
+#endif
+    }
+}
+
+/* 64-bit (CF32) equivalent of deinterleave2_u32(). These buffers are only
+ * produced by the host-converted sync formats, so no SIMD path is provided. */
+static void deinterleave2_u64(const uint64_t *src,
+                              uint64_t *a,
+                              uint64_t *b,
+                              size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        const uint64_t sa = src[2 * i];
+        const uint64_t sb = src[2 * i + 1];
+        a[i]              = sa;
+        b[i]              = sb;
+    }
+}
+
+/* 64-bit (CF32) equivalent of interleave2_u32() */
+static void interleave2_u64(const uint64_t *a,
+                            const uint64_t *b,
+                            uint64_t *dst,
+                            size_t n)
+{
+    size_t i;
+
+    for (i = n; i > 0; i--) {
+        const uint64_t sa = a[i - 1];
+        const uint64_t sb = b[i - 1];
+        dst[2 * (i - 1)]     = sa;
+        dst[2 * (i - 1) + 1] = sb;
+    }
+}
+
+void _interleave_deinterleave2(size_t samp_size,
+                               const void *src,
+                               void *a,
+                               void *b,
+                               size_t n)
+{
+    if (samp_size == sizeof(uint32_t)) {
+        deinterleave2_u32(src, a, b, n);
+    } else if (samp_size == sizeof(uint64_t)) {
+        deinterleave2_u64(src, a, b, n);
+    } else {
+        assert(samp_size == sizeof(uint16_t));
+        deinterleave2_u16(src, a, b, n);
+    }
+}
+
+void _interleave_interleave2(size_t samp_size,
+                             const void *a,
+                             const void *b,
+                             void *dst,
+                             size_t n)
+{
+    if (samp_size == sizeof(uint32_t)) {
+        interleave2_u32(a, b, dst, n);
+    } else if (samp_size == sizeof(uint64_t)) {
+        interleave2_u64(a, b, dst, n);
+    } else {
+        assert(samp_size == sizeof(uint16_t));
+        interleave2_u16(a, b, dst, n);
+    }
+}
+
+/* Number of samples per channel, excluding any metadata header */
+static size_t samples_per_channel(size_t num_channels,
+                                  size_t samp_size,
+                                  size_t meta_size,
+                                  unsigned int buffer_size)
+{
+    size_t samps_per_ch = buffer_size / num_channels;
+    return samps_per_ch - (meta_size / samp_size / num_channels);
+}
+
+/* Per-thread heap scratch space, freed as each thread exits */
+struct heap_scratch {
+    void *ptr;
+    size_t bytes;
+};
+
+static pthread_once_t heap_scratch_once = PTHREAD_ONCE_INIT;
+static pthread_key_t heap_scratch_key;
+static bool heap_scratch_key_valid = false;
+
+static void free_heap_scratch(void *arg)
+{
+    struct heap_scratch *h = arg;
+
+    free(h->ptr);
+    free(h);
+}
+
+static void create_heap_scratch_key(void)
+{
+    heap_scratch_key_valid =
+        (pthread_key_create(&heap_scratch_key, free_heap_scratch) == 0);
+}
+
+/* Obtain `bytes` of scratch space, from the stack if possible */
+static int get_scratch(uint8_t *stack_scratch, size_t bytes, void **scratch)
+{
+    struct heap_scratch *h;
+    void *ptr;
+
+    if (bytes <= INTERLEAVE_STACK_SCRATCH_BYTES) {
+        *scratch = stack_scratch;
+        return 0;
+    }
+
+    pthread_once(&heap_scratch_once, create_heap_scratch_key);
+
+    /* Without a key, fall back to an allocation per call */
+    if (!heap_scratch_key_valid) {
+        *scratch = malloc(bytes);
+        return (*scratch == NULL) ? BLADERF_ERR_MEM : 0;
+    }
+
+    h = pthread_getspecific(heap_scratch_key);
+    if (h == NULL) {
+        h = calloc(1, sizeof(*h));
+        if (h == NULL || pthread_setspecific(heap_scratch_key, h) != 0) {
+            free(h);
+            return BLADERF_ERR_MEM;
+        }
+    }
+
+    if (h->bytes < bytes) {
+        ptr = malloc(bytes);
+        if (ptr == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+
+        free(h->ptr);
+        h->ptr   = ptr;
+        h->bytes = bytes;
     }
 
+    *scratch = h->ptr;
     return 0;
 }
 
+static void put_scratch(uint8_t *stack_scratch, void *scratch)
+{
+    if (scratch != stack_scratch && !heap_scratch_key_valid) {
+        free(scratch);
+    }
+}
+
 int _interleave_interleave_buf(bladerf_channel_layout layout,
                                bladerf_format format,
                                unsigned int buffer_size,
                                void *samples)
 {
-    void *buf;
-    uint8_t *srcptr, *dstptr;
+    uint8_t stack_scratch[INTERLEAVE_STACK_SCRATCH_BYTES];
+    void *scratch;
+    uint8_t *payload;
     size_t num_channels = _interleave_calc_num_channels(layout);
     size_t samp_size, meta_size, samps_per_ch;
-    size_t srcidx, dstidx, samp, ch;
+    int status;
 
     // Easy:
     if (num_channels < 2) {
         return 0;
     }
 
-    // Placeholder for an actually efficient algorithm
+    assert(num_channels == 2);
+
     samp_size    = _interleave_calc_bytes_per_sample(format);
     meta_size    = _interleave_calc_metadata_bytes(format);
-    samps_per_ch = buffer_size / num_channels;
-    buf          = malloc(samp_size * buffer_size);
-    srcptr       = samples;
-    dstptr       = buf;
-
-    if (NULL == buf) {
-        return BLADERF_ERR_MEM;
-    }
-
-    // Copy metadata if applicable
-    if (meta_size > 0) {
-        memcpy(dstptr, srcptr, meta_size);
-        srcptr += meta_size;
-        dstptr += meta_size;
-        samps_per_ch -= (meta_size / samp_size / num_channels);
-    }
-
-    // Iterate...
-    for (ch = 0; ch < num_channels; ++ch) {
-        srcidx = samps_per_ch * ch;
-        for (samp = 0; samp < samps_per_ch; ++samp) {
-            dstidx = (samp * num_channels) + ch;
-            memcpy(dstptr + (dstidx * samp_size),
-                   srcptr + ((srcidx + samp) * samp_size),
-                   samp_size);
-        }
+    if (samp_size == 0) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    samps_per_ch = samples_per_channel(num_channels, samp_size, meta_size,
+                                       buffer_size);
+    payload      = (uint8_t *)samples + meta_size;
+
+    status = get_scratch(stack_scratch, samps_per_ch * samp_size, &scratch);
+    if (status != 0) {
+        return status;
     }
 
-    // Copy back...
-    memcpy(samples, buf, buffer_size * samp_size);
+    /* Stash channel 1, then spread channel 0 out over the whole buffer while
+     * merging channel 1 back in. Metadata, if any, is left untouched. */
+    memcpy(scratch, payload + samps_per_ch * samp_size,
+           samps_per_ch * samp_size);
 
-    // Done
-    free(buf);
+    _interleave_interleave2(samp_size, payload, scratch, payload,
+                            samps_per_ch);
+
+    put_scratch(stack_scratch, scratch);
 
     return 0;
 }
@@ -131,52 +505,82 @@ int _interleave_deinterleave_buf(bladerf_channel_layout layout,
                                  unsigned int buffer_size,
                                  void *samples)
 {
-    void *buf;
-    uint8_t *srcptr, *dstptr;
+    uint8_t stack_scratch[INTERLEAVE_STACK_SCRATCH_BYTES];
+    void *scratch;
+    uint8_t *payload;
     size_t num_channels = _interleave_calc_num_channels(layout);
     size_t samp_size, meta_size, samps_per_ch;
-    size_t srcidx, dstidx, samp, ch;
+    int status;
 
     // Easy:
     if (num_channels < 2) {
         return 0;
     }
 
-    // Placeholder for an actually efficient algorithm
+    assert(num_channels == 2);
+
     samp_size    = _interleave_calc_bytes_per_sample(format);
     meta_size    = _interleave_calc_metadata_bytes(format);
-    samps_per_ch = buffer_size / num_channels;
-    buf          = malloc(samp_size * buffer_size);
-    srcptr       = samples;
-    dstptr       = buf;
-
-    if (NULL == buf) {
-        return BLADERF_ERR_MEM;
-    }
-
-    // Copy metadata if applicable
-    if (meta_size > 0) {
-        memcpy(dstptr, srcptr, meta_size);
-        srcptr += meta_size;
-        dstptr += meta_size;
-        samps_per_ch -= (meta_size / samp_size / num_channels);
-    }
-
-    // Iterate...
-    for (samp = 0; samp < samps_per_ch; ++samp) {
-        srcidx = num_channels * samp;
-        for (ch = 0; ch < num_channels; ++ch) {
-            dstidx = (samps_per_ch * ch) + samp;
-            memcpy(dstptr + (dstidx * samp_size),
-                   srcptr + ((srcidx + ch) * samp_size), samp_size);
-        }
+    if (samp_size == 0) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    samps_per_ch = samples_per_channel(num_channels, samp_size, meta_size,
+                                       buffer_size);
+    payload      = (uint8_t *)samples + meta_size;
+
+    status = get_scratch(stack_scratch, samps_per_ch * samp_size, &scratch);
+    if (status != 0) {
+        return status;
+    }
+
+    /* Compact channel 0 into the front of the buffer, collecting channel 1
+     * off to the side, then append channel 1. Metadata, if any, is left
+     * untouched. */
+    _interleave_deinterleave2(samp_size, payload, payload, scratch,
+                              samps_per_ch);
+
+    memcpy(payload + samps_per_ch * samp_size, scratch,
+           samps_per_ch * samp_size);
+
+    put_scratch(stack_scratch, scratch);
+
+    return 0;
+}
+
+int _interleave_deinterleave_buf_to(bladerf_channel_layout layout,
+                                    bladerf_format format,
+                                    unsigned int buffer_size,
+                                    const void *samples,
+                                    void *const *dest)
+{
+    const uint8_t *payload;
+    size_t num_channels = _interleave_calc_num_channels(layout);
+    size_t samp_size, meta_size, samps_per_ch;
+
+    if (num_channels < 1) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    samp_size    = _interleave_calc_bytes_per_sample(format);
+    meta_size    = _interleave_calc_metadata_bytes(format);
+    if (samp_size == 0) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    samps_per_ch = samples_per_channel(num_channels, samp_size, meta_size,
+                                       buffer_size);
+    payload      = (const uint8_t *)samples + meta_size;
+
+    if (num_channels == 1) {
+        memcpy(dest[0], payload, samps_per_ch * samp_size);
+        return 0;
     }
 
-    // Copy back...
-    memcpy(samples, buf, buffer_size * samp_size);
+    assert(num_channels == 2);
 
-    // Done
-    free(buf);
+    _interleave_deinterleave2(samp_size, payload, dest[0], dest[1],
+                              samps_per_ch);
 
     return 0;
 }
@@ -41,4 +41,55 @@ int _interleave_deinterleave_buf(bladerf_channel_layout layout,
                                  unsigned int buffer_size,
                                  void *samples);
 
+/**
+ * Out-of-place deinterleave: splits an interleaved buffer directly into one
+ * destination array per channel. The metadata header of *_META formats is
+ * not copied.
+ *
+ * @param[in]   layout          Stream direction and layout
+ * @param[in]   format          Sample format
+ * @param[in]   buffer_size     Size of `samples`, in samples (all channels)
+ * @param[in]   samples         Interleaved input buffer
+ * @param[out]  dest            One destination array per channel, each with
+ *                              room for the per-channel sample count
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int _interleave_deinterleave_buf_to(bladerf_channel_layout layout,
+                                    bladerf_format format,
+                                    unsigned int buffer_size,
+                                    const void *samples,
+                                    void *const *dest);
+
+/**
+ * Split `n` interleaved 2-channel samples into one array per channel
+ *
+ * @param[in]   samp_size   Size of one sample, in bytes (2, 4, or 8)
+ * @param[in]   src         Interleaved input samples
+ * @param[out]  a           Channel 0 output. May alias `src`.
+ * @param[out]  b           Channel 1 output
+ * @param[in]   n           Number of samples per channel
+ */
+void _interleave_deinterleave2(size_t samp_size,
+                               const void *src,
+                               void *a,
+                               void *b,
+                               size_t n);
+
+/**
+ * Merge `n` samples from each of two per-channel arrays into an interleaved
+ * 2-channel array
+ *
+ * @param[in]   samp_size   Size of one sample, in bytes (2, 4, or 8)
+ * @param[in]   a           Channel 0 input. May alias `dst`.
+ * @param[in]   b           Channel 1 input
+ * @param[out]  dst         Interleaved output samples
+ * @param[in]   n           Number of samples per channel
+ */
+void _interleave_interleave2(size_t samp_size,
+                             const void *a,
+                             const void *b,
+                             void *dst,
+                             size_t n);
+
 #endif
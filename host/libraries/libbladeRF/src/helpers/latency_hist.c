@@ -0,0 +1,123 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <string.h>
+
+#include "helpers/latency_hist.h"
+
+#define SUB_COUNT   (1u << LATENCY_HIST_SUB_BITS)
+#define SUB_MASK    (SUB_COUNT - 1)
+
+static unsigned int value_to_bucket(uint64_t value)
+{
+    unsigned int msb = 0;
+    unsigned int idx;
+
+    if (value < SUB_COUNT) {
+        return (unsigned int)value;
+    }
+
+    while ((value >> msb) > 1) {
+        msb++;
+    }
+
+    /* Each power-of-two range after the first is a group of SUB_COUNT
+     * buckets, indexed by the bits just below the MSB */
+    idx = ((msb - LATENCY_HIST_SUB_BITS + 1) << LATENCY_HIST_SUB_BITS) |
+          ((unsigned int)(value >> (msb - LATENCY_HIST_SUB_BITS)) & SUB_MASK);
+
+    if (idx >= LATENCY_HIST_NUM_BUCKETS) {
+        idx = LATENCY_HIST_NUM_BUCKETS - 1;
+    }
+
+    return idx;
+}
+
+/* Lowest value counted in the specified bucket */
+static uint64_t bucket_to_value(unsigned int idx)
+{
+    unsigned int group = idx >> LATENCY_HIST_SUB_BITS;
+
+    if (group == 0) {
+        return idx;
+    }
+
+    return (uint64_t)(SUB_COUNT | (idx & SUB_MASK)) << (group - 1);
+}
+
+void latency_hist_reset(struct latency_hist *h)
+{
+    memset(h, 0, sizeof(*h));
+}
+
+void latency_hist_add(struct latency_hist *h, uint64_t value)
+{
+    if (h->count == 0 || value < h->min) {
+        h->min = value;
+    }
+
+    if (value > h->max) {
+        h->max = value;
+    }
+
+    h->count++;
+    h->sum += value;
+    h->buckets[value_to_bucket(value)]++;
+}
+
+uint64_t latency_hist_percentile(const struct latency_hist *h, double pct)
+{
+    uint64_t target, seen;
+    unsigned int i;
+
+    if (h->count == 0) {
+        return 0;
+    }
+
+    if (pct >= 100.0) {
+        return h->max;
+    } else if (pct < 0.0) {
+        pct = 0.0;
+    }
+
+    /* Rank of the value at this percentile, counting from 1 */
+    target = (uint64_t)(pct / 100.0 * h->count + 0.5);
+    if (target == 0) {
+        target = 1;
+    }
+
+    seen = 0;
+    for (i = 0; i < LATENCY_HIST_NUM_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= target) {
+            uint64_t high;
+
+            if (i + 1 == LATENCY_HIST_NUM_BUCKETS) {
+                return h->max;
+            }
+
+            high = bucket_to_value(i + 1) - 1;
+            return high < h->max ? high : h->max;
+        }
+    }
+
+    return h->max;
+}
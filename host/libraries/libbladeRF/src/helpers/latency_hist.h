@@ -0,0 +1,79 @@
+/**
+ * @file latency_hist.h
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_LATENCY_HIST_H_
+#define HELPERS_LATENCY_HIST_H_
+
+#include <stdint.h>
+
+/* Log-linear latency histogram, in the style of HdrHistogram.
+ *
+ * Values below 2^LATENCY_HIST_SUB_BITS are counted exactly. Above that, each
+ * power-of-two range is split into 2^LATENCY_HIST_SUB_BITS equal buckets, so
+ * a value is known to within 1/16 of itself. Values of 2^(MAX_MSB + 1) and
+ * above are counted in the last bucket. With nanosecond values, this covers
+ * up to ~8.6 s, well beyond any USB request timeout. */
+#define LATENCY_HIST_SUB_BITS   4
+#define LATENCY_HIST_MAX_MSB    32
+#define LATENCY_HIST_NUM_BUCKETS \
+    ((LATENCY_HIST_MAX_MSB - LATENCY_HIST_SUB_BITS + 2) << LATENCY_HIST_SUB_BITS)
+
+struct latency_hist {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    uint32_t buckets[LATENCY_HIST_NUM_BUCKETS];
+};
+
+/**
+ * Clear all recorded values
+ *
+ * @param       h       Histogram
+ */
+void latency_hist_reset(struct latency_hist *h);
+
+/**
+ * Record a value
+ *
+ * @param       h       Histogram
+ * @param[in]   value   Value to record
+ */
+void latency_hist_add(struct latency_hist *h, uint64_t value);
+
+/**
+ * Compute a percentile of the recorded values. The result is the highest
+ * value that falls in the same bucket as the percentile, limited to the
+ * maximum value recorded.
+ *
+ * @param       h       Histogram
+ * @param[in]   pct     Percentile, [0, 100]
+ *
+ * @return Percentile value, or 0 if no values have been recorded
+ */
+uint64_t latency_hist_percentile(const struct latency_hist *h, double pct);
+
+#endif
@@ -0,0 +1,215 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Required for pthread_getattr_np() on glibc */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "host_config.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#if BLADERF_OS_WINDOWS
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#if BLADERF_OS_LINUX
+#include <alloca.h>
+#endif
+#include <sys/mman.h>
+#endif
+
+#include <libbladeRF.h>
+
+#include "log.h"
+
+#include "helpers/mem_lock.h"
+
+/* Fallback page size, should it not be queried */
+#define MEM_LOCK_PAGE_SIZE  4096
+
+/* Depth of stack locked below the current frame. This covers the stream's
+ * callbacks, and any libusb or kernel frames above them. */
+#define MEM_LOCK_STACK_DEPTH (256 * 1024)
+
+static size_t page_size(void)
+{
+#if BLADERF_OS_WINDOWS
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? (size_t)size : MEM_LOCK_PAGE_SIZE;
+#endif
+}
+
+/* Round a range out to whole pages, as some systems require of mlock() */
+static void page_range(void **addr, size_t *len)
+{
+    uintptr_t const mask  = ~(uintptr_t)(page_size() - 1);
+    uintptr_t const start = (uintptr_t)*addr & mask;
+    uintptr_t const end   = ((uintptr_t)*addr + *len + ~mask) & mask;
+
+    *addr = (void *)start;
+    *len  = end - start;
+}
+
+void mem_prefault(void *addr, size_t len)
+{
+    size_t const page = page_size();
+    volatile uint8_t *p = addr;
+    size_t i;
+
+    if (addr == NULL || len == 0) {
+        return;
+    }
+
+#if !BLADERF_OS_WINDOWS
+    {
+        uintptr_t const start = (uintptr_t)addr & ~(uintptr_t)(page - 1);
+
+        /* This is only a hint; the pages are written below regardless */
+        if (madvise((void *)start, (uintptr_t)addr + len - start,
+                    MADV_WILLNEED) != 0) {
+            log_verbose("madvise(MADV_WILLNEED) failed: %s\n",
+                        strerror(errno));
+        }
+    }
+#endif
+
+    /* A write, rather than a read, is needed to fault in private pages that
+     * would otherwise map the shared zero page */
+    for (i = 0; i < len; i += page) {
+        p[i] = p[i];
+    }
+
+    p[len - 1] = p[len - 1];
+}
+
+int mem_lock(void *addr, size_t len)
+{
+    if (addr == NULL || len == 0) {
+        return 0;
+    }
+
+    page_range(&addr, &len);
+
+#if BLADERF_OS_WINDOWS
+    if (!VirtualLock(addr, len)) {
+        log_debug("VirtualLock failed: %lu\n", GetLastError());
+        return BLADERF_ERR_MEM;
+    }
+#else
+    if (mlock(addr, len) != 0) {
+        log_debug("mlock of %zu bytes failed: %s\n", len, strerror(errno));
+        return BLADERF_ERR_MEM;
+    }
+#endif
+
+    return 0;
+}
+
+void mem_unlock(void *addr, size_t len)
+{
+    if (addr == NULL || len == 0) {
+        return;
+    }
+
+    page_range(&addr, &len);
+
+#if BLADERF_OS_WINDOWS
+    VirtualUnlock(addr, len);
+#else
+    munlock(addr, len);
+#endif
+}
+
+#if BLADERF_OS_LINUX
+/* Touch `depth` bytes of stack below the caller's frame. The main thread's
+ * stack is only mapped as it grows, and mlock() fails on unmapped pages. */
+static void __attribute__((noinline)) prefault_stack(size_t depth)
+{
+    volatile uint8_t *p = alloca(depth);
+    size_t const page   = page_size();
+    size_t i;
+
+    for (i = 0; i < depth; i += page) {
+        p[i] = 0;
+    }
+}
+#endif
+
+int mem_lock_stack(void **addr, size_t *len)
+{
+#if BLADERF_OS_LINUX
+    size_t const page = page_size();
+    pthread_attr_t attr;
+    void *stack_addr;
+    size_t stack_size;
+    uintptr_t lo, hi, here;
+    int status;
+
+    if (pthread_getattr_np(pthread_self(), &attr) != 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    status = pthread_attr_getstack(&attr, &stack_addr, &stack_size);
+    pthread_attr_destroy(&attr);
+
+    if (status != 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    /* The stack grows down from the current frame, and is bounded below by
+     * its lowest address */
+    here = (uintptr_t)&attr;
+    hi   = (here + page - 1) & ~(uintptr_t)(page - 1);
+    lo   = (uintptr_t)stack_addr;
+
+    if (hi - lo > MEM_LOCK_STACK_DEPTH) {
+        lo = hi - MEM_LOCK_STACK_DEPTH;
+    }
+
+    /* Leave the bottom pages clear for prefault_stack()'s own frame, and
+     * lock only what it has touched */
+    if (here - lo <= 2 * page) {
+        return BLADERF_ERR_MEM;
+    }
+
+    prefault_stack(here - lo - 2 * page);
+    lo += 2 * page;
+
+    status = mem_lock((void *)lo, hi - lo);
+    if (status == 0) {
+        *addr = (void *)lo;
+        *len  = hi - lo;
+    }
+
+    return status;
+#else
+    return BLADERF_ERR_UNSUPPORTED;
+#endif
+}
@@ -0,0 +1,73 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Prefaulting and locking of stream memory, such that streaming does not
+ * incur page faults once it has started. Locking is subject to the process's
+ * RLIMIT_MEMLOCK on POSIX systems, and to its working set size on Windows;
+ * callers are expected to treat a failure as a warning. */
+
+#ifndef HELPERS_MEM_LOCK_H_
+#define HELPERS_MEM_LOCK_H_
+
+#include <stddef.h>
+
+/**
+ * Fault in memory ahead of its use, by hinting that it will be needed and
+ * writing each of its pages. Its contents are preserved.
+ *
+ * @param       addr        Start of the memory
+ * @param[in]   len         Length of the memory, in bytes
+ */
+void mem_prefault(void *addr, size_t len);
+
+/**
+ * Lock memory into RAM, which also faults it in
+ *
+ * @param       addr        Start of the memory
+ * @param[in]   len         Length of the memory, in bytes
+ *
+ * @return 0 on success, BLADERF_ERR_UNSUPPORTED if locking is not supported,
+ *         or BLADERF_ERR_MEM if the memory could not be locked
+ */
+int mem_lock(void *addr, size_t len);
+
+/**
+ * Unlock memory locked by mem_lock()
+ *
+ * @param       addr        Start of the memory
+ * @param[in]   len         Length of the memory, in bytes
+ */
+void mem_unlock(void *addr, size_t len);
+
+/**
+ * Lock the calling thread's stack, up to a bounded depth below the current
+ * frame, into RAM. This is only implemented on Linux.
+ *
+ * @param[out]  addr        Start of the locked range
+ * @param[out]  len         Length of the locked range, to be passed to
+ *                          mem_unlock() along with `addr`
+ *
+ * @return 0 on success, BLADERF_ERR_UNSUPPORTED if not implemented, or
+ *         BLADERF_ERR_MEM if the stack could not be locked
+ */
+int mem_lock_stack(void **addr, size_t *len);
+
+#endif
@@ -0,0 +1,261 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Required for pthread_setaffinity_np() and the CPU_* macros on glibc */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "host_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#if BLADERF_OS_LINUX
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+#include <libbladeRF.h>
+
+#include "log.h"
+
+#include "helpers/numa.h"
+
+#if BLADERF_OS_LINUX
+
+/* From <linux/mempolicy.h>, which is not installed everywhere. libnuma's
+ * <numaif.h> is avoided to keep it from becoming a dependency. */
+#define NUMA_MPOL_PREFERRED 1
+
+/* Nodes whose index exceeds this are left alone */
+#define NUMA_MAX_NODES      64
+
+/* Read the first line of a sysfs attribute. Returns 0 on success. */
+static int read_attr(const char *path, char *buf, size_t len)
+{
+    FILE *f = fopen(path, "r");
+    int status = -1;
+
+    if (f == NULL) {
+        return -1;
+    }
+
+    if (fgets(buf, (int)len, f) != NULL) {
+        buf[strcspn(buf, "\n")] = '\0';
+        status = 0;
+    }
+
+    fclose(f);
+    return status;
+}
+
+static bool multiple_nodes_online(void)
+{
+    char online[64];
+
+    /* A single node is listed as "0", and several as a range or list */
+    if (read_attr("/sys/devices/system/node/online", online, sizeof(online))) {
+        return false;
+    }
+
+    return strpbrk(online, "-,") != NULL;
+}
+
+int numa_device_node(struct bladerf *dev)
+{
+    char path[PATH_MAX];
+    char controller[PATH_MAX];
+    char value[16];
+    char *sep;
+    long node;
+
+    if (getenv("BLADERF_NUMA_DISABLE") != NULL) {
+        return -1;
+    }
+
+    if (dev->ident.backend != BLADERF_BACKEND_LIBUSB &&
+        dev->ident.backend != BLADERF_BACKEND_LINUX) {
+        return -1;
+    }
+
+    if (!multiple_nodes_online()) {
+        return -1;
+    }
+
+    /* The root hub's link resolves to a directory beneath its controller,
+     * e.g. /sys/devices/pci0000:00/0000:00:14.0/usb1 */
+    snprintf(path, sizeof(path), "/sys/bus/usb/devices/usb%u",
+             (unsigned int)dev->ident.usb_bus);
+
+    if (realpath(path, controller) == NULL) {
+        log_debug("Failed to resolve %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    sep = strrchr(controller, '/');
+    if (sep == NULL) {
+        return -1;
+    }
+
+    *sep = '\0';
+    if (snprintf(path, sizeof(path), "%s/numa_node", controller) >=
+        (int)sizeof(path)) {
+        return -1;
+    }
+
+    if (read_attr(path, value, sizeof(value))) {
+        log_debug("Failed to read %s\n", path);
+        return -1;
+    }
+
+    node = strtol(value, NULL, 10);
+    if (node < 0 || node >= NUMA_MAX_NODES) {
+        return -1;
+    }
+
+    log_verbose("USB bus %u is attached to NUMA node %ld\n",
+                (unsigned int)dev->ident.usb_bus, node);
+
+    return (int)node;
+}
+
+void numa_prefer_node(void *addr, size_t len, int node)
+{
+    unsigned long mask;
+
+    if (node < 0) {
+        return;
+    }
+
+    mask = 1UL << node;
+
+    if (syscall(SYS_mbind, addr, len, NUMA_MPOL_PREFERRED, &mask,
+                sizeof(mask) * 8, 0) != 0) {
+        log_verbose("mbind() to NUMA node %d failed: %s\n", node,
+                    strerror(errno));
+    }
+}
+
+/* Parse a sysfs CPU list, e.g. "0-7,16-23", into `cpus` */
+static int parse_cpulist(const char *list, cpu_set_t *cpus)
+{
+    const char *p = list;
+    char *end;
+    long first, last, i;
+
+    CPU_ZERO(cpus);
+
+    while (*p != '\0') {
+        first = strtol(p, &end, 10);
+        if (end == p || first < 0) {
+            return -1;
+        }
+
+        last = first;
+        p    = end;
+
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            if (end == p + 1 || last < first) {
+                return -1;
+            }
+            p = end;
+        }
+
+        for (i = first; i <= last && i < CPU_SETSIZE; i++) {
+            CPU_SET(i, cpus);
+        }
+
+        if (*p == ',') {
+            p++;
+        } else if (*p != '\0') {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int numa_bind_thread(int node)
+{
+    char path[64];
+    char list[1024];
+    cpu_set_t node_cpus, cpus;
+    int status;
+
+    if (node < 0) {
+        return 0;
+    }
+
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist",
+             node);
+
+    if (read_attr(path, list, sizeof(list)) || parse_cpulist(list, &node_cpus)) {
+        log_debug("Failed to read CPUs of NUMA node %d\n", node);
+        return 0;
+    }
+
+    status = pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (status != 0) {
+        log_debug("Failed to get thread affinity: %s\n", strerror(status));
+        return 0;
+    }
+
+    CPU_AND(&cpus, &cpus, &node_cpus);
+    if (CPU_COUNT(&cpus) == 0) {
+        /* None of the node's CPUs are available to us */
+        return 0;
+    }
+
+    status = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (status != 0) {
+        log_debug("Failed to bind thread to NUMA node %d: %s\n", node,
+                  strerror(status));
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    log_verbose("Bound thread to the CPUs of NUMA node %d\n", node);
+    return 0;
+}
+
+#else
+
+int numa_device_node(struct bladerf *dev)
+{
+    return -1;
+}
+
+void numa_prefer_node(void *addr, size_t len, int node)
+{
+}
+
+int numa_bind_thread(int node)
+{
+    return 0;
+}
+
+#endif
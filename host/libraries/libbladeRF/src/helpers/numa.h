@@ -0,0 +1,76 @@
+/**
+ * @file numa.h
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Placement of stream buffers and the sync worker thread on the NUMA node of
+ * the USB host controller a device is attached to, such that transfers and
+ * their completions do not cross the interconnect between sockets.
+ *
+ * This is only implemented on Linux, where the node is read from sysfs;
+ * elsewhere, no node is found and nothing is changed. It may be disabled by
+ * setting the BLADERF_NUMA_DISABLE environment variable. */
+
+#ifndef HELPERS_NUMA_H_
+#define HELPERS_NUMA_H_
+
+#include <stddef.h>
+
+#include "board/board.h"
+
+/**
+ * Find the NUMA node of the USB host controller hosting a device
+ *
+ * @param[in]   dev         Device handle
+ *
+ * @return node index, or -1 if it is unknown, the system has a single node,
+ *         or NUMA placement is disabled
+ */
+int numa_device_node(struct bladerf *dev);
+
+/**
+ * Prefer that memory be backed by the provided node. This must be called
+ * before the memory is first written, and is only a hint.
+ *
+ * @param       addr        Page-aligned start of the memory
+ * @param[in]   len         Length of the memory, in bytes
+ * @param[in]   node        Node from numa_device_node(). Nothing is done for
+ *                          a negative value.
+ */
+void numa_prefer_node(void *addr, size_t len, int node);
+
+/**
+ * Restrict the calling thread to the CPUs of the provided node. CPUs outside
+ * of the thread's current affinity are never added, so a process confined
+ * with taskset or cgroups stays confined.
+ *
+ * @param[in]   node        Node from numa_device_node(). Nothing is done for
+ *                          a negative value.
+ *
+ * @return 0 on success or if nothing was to be done, BLADERF_ERR_UNEXPECTED
+ *         if the affinity could not be changed
+ */
+int numa_bind_thread(int node);
+
+#endif
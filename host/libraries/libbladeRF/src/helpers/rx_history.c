@@ -0,0 +1,387 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_config.h"
+#include "log.h"
+#include "minmax.h"
+#include "rel_assert.h"
+#include "thread.h"
+
+#include "helpers/rx_history.h"
+#include "helpers/timeout.h"
+#include "streaming/format.h"
+#include "streaming/metadata.h"
+
+/* Timeout of each bladerf_sync_rx_acquire() call made by the worker, which
+ * bounds how long stopping the history may take */
+#define RX_HISTORY_ACQUIRE_TIMEOUT_MS 100
+
+/* Delay before the worker retries after bladerf_sync_rx_acquire() fails */
+#define RX_HISTORY_RETRY_MS 100
+
+struct rx_history {
+    struct bladerf *dev;
+    pthread_t thread;
+
+    size_t msg_size;
+    size_t slot_bytes;              /* Bytes per timestamp tick, i.e., one
+                                     * sample from each channel */
+    unsigned int samples_per_msg;
+    unsigned int ticks_per_msg;
+    size_t num_channels;
+
+    MUTEX lock;                     /* Protects all of the following */
+    pthread_cond_t work;            /* Signaled on stop requests */
+    pthread_cond_t filled;          /* Signaled as buffers are retained */
+    bool stop;
+
+    /* Messages per buffer, learned from the first buffer received */
+    unsigned int msg_per_buf;
+
+    /* Retained buffers, oldest first, starting at head */
+    void **bufs;
+    unsigned int num_bufs;
+    unsigned int head;
+    unsigned int count;
+
+    /* Last error reported by bladerf_sync_rx_acquire(), cleared once a
+     * buffer is received */
+    int error;
+};
+
+static inline uint8_t *buf_msg(struct rx_history *h, unsigned int i,
+                               unsigned int m)
+{
+    uint8_t *buf = h->bufs[(h->head + i) % h->num_bufs];
+    return buf + m * h->msg_size;
+}
+
+/* Timestamp of the first sample in the i-th oldest retained buffer */
+static inline uint64_t buf_start(struct rx_history *h, unsigned int i)
+{
+    return metadata_get_timestamp(buf_msg(h, i, 0));
+}
+
+/* Timestamp following the last sample in the i-th oldest retained buffer */
+static inline uint64_t buf_end(struct rx_history *h, unsigned int i)
+{
+    return metadata_get_timestamp(buf_msg(h, i, h->msg_per_buf - 1)) +
+           h->ticks_per_msg;
+}
+
+static void *rx_history_task(void *arg)
+{
+    struct rx_history *h = (struct rx_history *)arg;
+    struct bladerf_metadata meta;
+    struct timespec deadline;
+    unsigned int num_samples;
+    void *buf;
+    void *oldest;
+    int status;
+
+    MUTEX_LOCK(&h->lock);
+
+    while (!h->stop) {
+        MUTEX_UNLOCK(&h->lock);
+
+        memset(&meta, 0, sizeof(meta));
+        status = bladerf_sync_rx_acquire(h->dev, &buf, &num_samples, &meta,
+                                         RX_HISTORY_ACQUIRE_TIMEOUT_MS);
+
+        MUTEX_LOCK(&h->lock);
+
+        if (status == BLADERF_ERR_TIMEOUT) {
+            continue;
+        } else if (status != 0) {
+            log_debug("%s: Failed to acquire buffer: %s\n", __FUNCTION__,
+                      bladerf_strerror(status));
+
+            h->error = status;
+            pthread_cond_broadcast(&h->filled);
+
+            if (!h->stop &&
+                populate_abs_timeout(&deadline, RX_HISTORY_RETRY_MS) == 0) {
+                pthread_cond_timedwait(&h->work, &h->lock, &deadline);
+            }
+            continue;
+        }
+
+        h->msg_per_buf = num_samples / h->samples_per_msg;
+        if (h->msg_per_buf == 0) {
+            h->msg_per_buf = 1;
+        }
+
+        oldest = NULL;
+        if (h->count == h->num_bufs) {
+            oldest  = h->bufs[h->head];
+            h->head = (h->head + 1) % h->num_bufs;
+            h->count--;
+        }
+
+        h->bufs[(h->head + h->count) % h->num_bufs] = buf;
+        h->count++;
+        h->error = 0;
+
+        pthread_cond_broadcast(&h->filled);
+
+        if (oldest != NULL) {
+            status = bladerf_sync_rx_release(h->dev, oldest);
+            if (status != 0) {
+                log_debug("%s: Failed to release buffer: %s\n", __FUNCTION__,
+                          bladerf_strerror(status));
+            }
+        }
+    }
+
+    /* A reader may still be waiting on buffers that will no longer arrive */
+    pthread_cond_broadcast(&h->filled);
+
+    while (h->count > 0) {
+        bladerf_sync_rx_release(h->dev, h->bufs[h->head]);
+        h->head = (h->head + 1) % h->num_bufs;
+        h->count--;
+    }
+
+    MUTEX_UNLOCK(&h->lock);
+
+    return NULL;
+}
+
+int rx_history_start(struct rx_history **hist,
+                     struct bladerf *dev,
+                     bladerf_format format,
+                     size_t num_channels,
+                     size_t msg_size,
+                     unsigned int num_buffers)
+{
+    struct rx_history *h;
+    int status;
+
+    if (num_channels == 0 || num_buffers == 0 ||
+        msg_size <= METADATA_HEADER_SIZE) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    h = calloc(1, sizeof(*h));
+    if (h == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    h->bufs = calloc(num_buffers, sizeof(h->bufs[0]));
+    if (h->bufs == NULL) {
+        free(h);
+        return BLADERF_ERR_MEM;
+    }
+
+    h->dev             = dev;
+    h->msg_size        = msg_size;
+    h->num_channels    = num_channels;
+    h->slot_bytes      = samples_to_bytes(format, num_channels);
+    h->samples_per_msg = (unsigned int)((msg_size - METADATA_HEADER_SIZE) /
+                                        samples_to_bytes(format, 1));
+    h->ticks_per_msg   = (unsigned int)(h->samples_per_msg / num_channels);
+    h->num_bufs        = num_buffers;
+    h->msg_per_buf     = 1;
+
+    MUTEX_INIT(&h->lock);
+
+    if (pthread_cond_init(&h->work, NULL) != 0) {
+        goto err_work;
+    }
+
+    if (pthread_cond_init(&h->filled, NULL) != 0) {
+        goto err_filled;
+    }
+
+    status = pthread_create(&h->thread, NULL, rx_history_task, h);
+    if (status != 0) {
+        goto err_thread;
+    }
+
+    *hist = h;
+    return 0;
+
+err_thread:
+    pthread_cond_destroy(&h->filled);
+err_filled:
+    pthread_cond_destroy(&h->work);
+err_work:
+    MUTEX_DESTROY(&h->lock);
+    free(h->bufs);
+    free(h);
+    return BLADERF_ERR_UNEXPECTED;
+}
+
+void rx_history_stop(struct rx_history *h)
+{
+    if (h == NULL) {
+        return;
+    }
+
+    MUTEX_LOCK(&h->lock);
+    h->stop = true;
+    pthread_cond_signal(&h->work);
+    MUTEX_UNLOCK(&h->lock);
+
+    pthread_join(h->thread, NULL);
+
+    pthread_cond_destroy(&h->filled);
+    pthread_cond_destroy(&h->work);
+    MUTEX_DESTROY(&h->lock);
+    free(h->bufs);
+    free(h);
+}
+
+int rx_history_range(struct rx_history *h, uint64_t *start, uint64_t *end)
+{
+    int status = 0;
+
+    MUTEX_LOCK(&h->lock);
+
+    if (h->count == 0) {
+        status = BLADERF_ERR_WOULD_BLOCK;
+    } else {
+        *start = buf_start(h, 0);
+        *end   = buf_end(h, h->count - 1);
+    }
+
+    MUTEX_UNLOCK(&h->lock);
+
+    return status;
+}
+
+/* Copy the portion of each retained message that falls within
+ * [timestamp, timestamp + ticks), returning the number of ticks copied.
+ * Assumes h->lock is held. */
+static uint64_t copy_range(struct rx_history *h,
+                           uint8_t *samples,
+                           uint64_t timestamp,
+                           uint64_t ticks)
+{
+    const uint64_t end = timestamp + ticks;
+    uint64_t copied    = 0;
+    unsigned int i, m;
+
+    for (i = 0; i < h->count; i++) {
+        /* Skip whole buffers outside of the range */
+        if (buf_end(h, i) <= timestamp || buf_start(h, i) >= end) {
+            continue;
+        }
+
+        for (m = 0; m < h->msg_per_buf; m++) {
+            const uint8_t *msg    = buf_msg(h, i, m);
+            const uint64_t msg_ts = metadata_get_timestamp(msg);
+            const uint64_t first  = u64_max(msg_ts, timestamp);
+            const uint64_t last   = u64_min(msg_ts + h->ticks_per_msg, end);
+
+            if (first >= last) {
+                continue;
+            }
+
+            memcpy(samples + (first - timestamp) * h->slot_bytes,
+                   msg + METADATA_HEADER_SIZE +
+                       (first - msg_ts) * h->slot_bytes,
+                   (size_t)(last - first) * h->slot_bytes);
+
+            copied += last - first;
+        }
+    }
+
+    return copied;
+}
+
+int rx_history_read(struct rx_history *h,
+                    void *samples,
+                    unsigned int num_samples,
+                    uint64_t timestamp,
+                    struct bladerf_metadata *metadata,
+                    unsigned int timeout_ms)
+{
+    struct timespec deadline;
+    uint64_t ticks, copied;
+    int status = 0;
+
+    if (num_samples == 0 || num_samples % h->num_channels != 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    ticks = num_samples / h->num_channels;
+
+    if (timeout_ms != 0 && populate_abs_timeout(&deadline, timeout_ms) != 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    MUTEX_LOCK(&h->lock);
+
+    /* Wait for the end of the range to be received */
+    while (status == 0 && !h->stop &&
+           (h->count == 0 ||
+            buf_end(h, h->count - 1) < timestamp + ticks)) {
+        if (timeout_ms == 0) {
+            status = pthread_cond_wait(&h->filled, &h->lock);
+        } else {
+            status = pthread_cond_timedwait(&h->filled, &h->lock, &deadline);
+        }
+    }
+
+    if (status == ETIMEDOUT) {
+        status = (h->error != 0) ? h->error : BLADERF_ERR_TIMEOUT;
+        goto out;
+    } else if (status != 0) {
+        status = BLADERF_ERR_UNEXPECTED;
+        goto out;
+    } else if (h->count == 0) {
+        status = BLADERF_ERR_TIMEOUT;
+        goto out;
+    }
+
+    if (buf_start(h, 0) > timestamp) {
+        log_debug("%s: t=%" PRIu64 " is no longer retained; oldest is "
+                  "t=%" PRIu64 "\n",
+                  __FUNCTION__, timestamp, buf_start(h, 0));
+        status = BLADERF_ERR_TIME_PAST;
+        goto out;
+    }
+
+    /* Samples missing due to overruns are left zeroed */
+    memset(samples, 0, (size_t)ticks * h->slot_bytes);
+    copied = copy_range(h, samples, timestamp, ticks);
+
+    if (metadata != NULL) {
+        metadata->timestamp    = timestamp;
+        metadata->actual_count = num_samples;
+        metadata->status       = 0;
+
+        if (copied < ticks) {
+            metadata->status |= BLADERF_META_STATUS_OVERRUN;
+        }
+    }
+
+out:
+    MUTEX_UNLOCK(&h->lock);
+
+    return status;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file rx_history.h
+ *
+ * @brief Retention of recent RX buffers for reads by timestamp
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* History of recently received RX buffers.
+ *
+ * A worker thread takes each buffer of the RX sync stream, via
+ * bladerf_sync_rx_acquire(), and holds on to the most recent ones, releasing
+ * the oldest as new buffers arrive. The buffers are indexed by the hardware
+ * timestamps in their metadata headers, such that any range of samples
+ * within them may be read. Samples are only copied when read.
+ *
+ * Only formats with hardware timestamps that are not converted by the host
+ * are supported, i.e., BLADERF_FORMAT_SC16_Q11_META and
+ * BLADERF_FORMAT_SC8_Q7_META. */
+
+#ifndef HELPERS_RX_HISTORY_H_
+#define HELPERS_RX_HISTORY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+struct rx_history;
+
+/**
+ * Create an RX history and start its worker thread
+ *
+ * @param[out]  hist        Set to the new history on success
+ * @param       dev         Device to receive from
+ * @param[in]   format      Format of the RX sync stream
+ * @param[in]   num_channels Number of channels in the RX sync stream
+ * @param[in]   msg_size    Size of the stream's metadata messages, in bytes
+ * @param[in]   num_buffers Number of buffers to retain
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int rx_history_start(struct rx_history **hist,
+                     struct bladerf *dev,
+                     bladerf_format format,
+                     size_t num_channels,
+                     size_t msg_size,
+                     unsigned int num_buffers);
+
+/**
+ * Stop the worker, release all retained buffers, and free the history. The
+ * caller must not hold dev->lock.
+ *
+ * @param[in]   hist        History to stop. NULL is ignored.
+ */
+void rx_history_stop(struct rx_history *hist);
+
+/**
+ * Get the range of timestamps currently retained
+ *
+ * @param       hist        History
+ * @param[out]  start       Timestamp of the oldest retained sample
+ * @param[out]  end         Timestamp following the newest retained sample
+ *
+ * @return 0 on success, BLADERF_ERR_WOULD_BLOCK if no buffers are retained
+ */
+int rx_history_range(struct rx_history *hist, uint64_t *start, uint64_t *end);
+
+/**
+ * Read samples by timestamp. See bladerf_rx_history_read().
+ */
+int rx_history_read(struct rx_history *hist,
+                    void *samples,
+                    unsigned int num_samples,
+                    uint64_t timestamp,
+                    struct bladerf_metadata *metadata,
+                    unsigned int timeout_ms);
+
+#endif
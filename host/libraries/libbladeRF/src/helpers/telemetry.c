@@ -0,0 +1,180 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "thread.h"
+
+#include "board/board.h"
+#include "helpers/telemetry.h"
+#include "helpers/timeout.h"
+#include "helpers/wallclock.h"
+
+struct telemetry {
+    struct bladerf *dev;
+    unsigned int interval_ms;
+    telemetry_sample_fn sample;
+    pthread_t thread;
+
+    MUTEX lock; /* Protects `stop` */
+    pthread_cond_t stop_cond;
+    bool stop;
+
+    /* Latest sample, published under a sequence count. The count is odd
+     * while `latest` is being written, and 0 until the first sample. It is
+     * accessed atomically. */
+    unsigned int seq;
+    struct bladerf_telemetry latest;
+};
+
+static void publish(struct telemetry *t, struct bladerf_telemetry const *s)
+{
+    /* The atomic increments order the copy between them */
+    ATOMIC_INC(&t->seq);
+    memcpy(&t->latest, s, sizeof(t->latest));
+    ATOMIC_INC(&t->seq);
+}
+
+static void *telemetry_task(void *arg)
+{
+    struct telemetry *t = (struct telemetry *)arg;
+    struct bladerf_telemetry s;
+    struct timespec deadline;
+    int status;
+
+    MUTEX_LOCK(&t->lock);
+
+    while (!t->stop) {
+        MUTEX_UNLOCK(&t->lock);
+
+        memset(&s, 0, sizeof(s));
+
+        /* Not dev_lock_urgent(): sampling must not hold up anything else */
+        MUTEX_LOCK(&t->dev->lock);
+        t->sample(t->dev, &s);
+        MUTEX_UNLOCK(&t->dev->lock);
+
+        s.host_ns = wallclock_get_monotonic_nsec();
+        publish(t, &s);
+
+        MUTEX_LOCK(&t->lock);
+
+        if (populate_abs_timeout(&deadline, t->interval_ms) != 0) {
+            break;
+        }
+
+        status = 0;
+        while (!t->stop && status != ETIMEDOUT) {
+            status = pthread_cond_timedwait(&t->stop_cond, &t->lock, &deadline);
+        }
+    }
+
+    MUTEX_UNLOCK(&t->lock);
+
+    return NULL;
+}
+
+int telemetry_start(struct telemetry **telemetry,
+                    struct bladerf *dev,
+                    unsigned int interval_ms,
+                    telemetry_sample_fn sample)
+{
+    struct telemetry *t;
+    int status;
+
+    if (interval_ms == 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    t = calloc(1, sizeof(*t));
+    if (t == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    t->dev         = dev;
+    t->interval_ms = interval_ms;
+    t->sample      = sample;
+
+    MUTEX_INIT(&t->lock);
+
+    status = pthread_cond_init(&t->stop_cond, NULL);
+    if (status != 0) {
+        MUTEX_DESTROY(&t->lock);
+        free(t);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    status = pthread_create(&t->thread, NULL, telemetry_task, t);
+    if (status != 0) {
+        pthread_cond_destroy(&t->stop_cond);
+        MUTEX_DESTROY(&t->lock);
+        free(t);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    *telemetry = t;
+    return 0;
+}
+
+void telemetry_stop(struct telemetry *t)
+{
+    if (t == NULL) {
+        return;
+    }
+
+    MUTEX_LOCK(&t->lock);
+    t->stop = true;
+    pthread_cond_signal(&t->stop_cond);
+    MUTEX_UNLOCK(&t->lock);
+
+    pthread_join(t->thread, NULL);
+
+    pthread_cond_destroy(&t->stop_cond);
+    MUTEX_DESTROY(&t->lock);
+    free(t);
+}
+
+int telemetry_read(struct telemetry *t, struct bladerf_telemetry *sample)
+{
+    unsigned int seq;
+
+    while (true) {
+        seq = ATOMIC_LOAD(&t->seq);
+
+        if (seq == 0) {
+            return BLADERF_ERR_WOULD_BLOCK;
+        }
+
+        if ((seq & 1) == 0) {
+            memcpy(sample, &t->latest, sizeof(*sample));
+
+            /* A full barrier, so that the copy is complete before the count
+             * is checked again */
+            if (ATOMIC_CAS(&t->seq, seq, seq)) {
+                return 0;
+            }
+        }
+
+        CPU_RELAX();
+    }
+}
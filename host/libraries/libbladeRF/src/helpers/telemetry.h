@@ -0,0 +1,84 @@
+/**
+ * @file telemetry.h
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_TELEMETRY_H_
+#define HELPERS_TELEMETRY_H_
+
+#include <libbladeRF.h>
+
+/* Background sampler of slowly-changing device measurements.
+ *
+ * A thread periodically calls a board-provided function, with the device
+ * lock held, to fill in a struct bladerf_telemetry. Each completed sample is
+ * published as a snapshot that readers copy without taking any lock. */
+struct telemetry;
+
+/**
+ * Fill in a sample. Called with dev->lock held; the function may hand the
+ * lock to latency-critical operations between reads with dev_lock_yield().
+ *
+ * @param       dev         Device handle
+ * @param[out]  sample      Zeroed sample to fill in, setting the
+ *                          BLADERF_TELEMETRY_* flags of the fields read
+ */
+typedef void (*telemetry_sample_fn)(struct bladerf *dev,
+                                    struct bladerf_telemetry *sample);
+
+/**
+ * Start a sampler
+ *
+ * @param[out]  telemetry   Set to the new sampler on success
+ * @param       dev         Device handle. The caller must not hold dev->lock.
+ * @param[in]   interval_ms Sampling interval
+ * @param[in]   sample      Function to take each sample
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int telemetry_start(struct telemetry **telemetry,
+                    struct bladerf *dev,
+                    unsigned int interval_ms,
+                    telemetry_sample_fn sample);
+
+/**
+ * Stop and free a sampler. The caller must not hold dev->lock.
+ *
+ * @param[in]   telemetry   Sampler to stop. NULL is ignored.
+ */
+void telemetry_stop(struct telemetry *telemetry);
+
+/**
+ * Copy the latest sample. This does not block.
+ *
+ * @param[in]   telemetry   Sampler
+ * @param[out]  sample      Latest sample
+ *
+ * @return 0 on success, BLADERF_ERR_WOULD_BLOCK if no sample has been taken
+ *         yet
+ */
+int telemetry_read(struct telemetry *telemetry,
+                   struct bladerf_telemetry *sample);
+
+#endif
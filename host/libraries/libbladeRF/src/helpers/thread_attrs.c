@@ -0,0 +1,219 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Required for pthread_setaffinity_np() and the CPU_* macros on glibc */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "host_config.h"
+
+#include <string.h>
+#include <errno.h>
+
+#if BLADERF_OS_WINDOWS
+#include <windows.h>
+#include <avrt.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if BLADERF_OS_FREEBSD
+#include <pthread_np.h>
+#include <sys/cpuset.h>
+typedef cpuset_t cpu_set_t;
+#endif
+
+#include <libbladeRF.h>
+
+#include "log.h"
+
+#include "helpers/thread_attrs.h"
+
+void thread_attrs_init(struct bladerf_thread_attrs *attrs)
+{
+    attrs->cpu      = -1;
+    attrs->realtime = false;
+    attrs->priority = 0;
+}
+
+int thread_attrs_validate(const struct bladerf_thread_attrs *attrs)
+{
+    if (attrs->cpu < -1) {
+        log_debug("Invalid CPU index: %d\n", attrs->cpu);
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (attrs->priority < 0) {
+        log_debug("Invalid thread priority: %d\n", attrs->priority);
+        return BLADERF_ERR_INVAL;
+    }
+
+    return 0;
+}
+
+bool thread_attrs_nondefault(const struct bladerf_thread_attrs *attrs)
+{
+    return attrs->cpu >= 0 || attrs->realtime;
+}
+
+#if BLADERF_OS_WINDOWS
+
+static int set_affinity(int cpu)
+{
+    DWORD_PTR mask;
+
+    if ((size_t)cpu >= sizeof(mask) * 8) {
+        log_warning("CPU index %d exceeds the supported affinity mask.\n", cpu);
+        return BLADERF_ERR_INVAL;
+    }
+
+    mask = ((DWORD_PTR)1) << cpu;
+    if (SetThreadAffinityMask(GetCurrentThread(), mask) == 0) {
+        log_warning("Failed to pin thread to CPU %d: error %lu\n", cpu,
+                    (unsigned long)GetLastError());
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    return 0;
+}
+
+static int set_realtime(int priority)
+{
+    HANDLE task;
+    DWORD task_index = 0;
+
+    /* The MMCSS registration is released when the thread exits */
+    task = AvSetMmThreadCharacteristicsA("Pro Audio", &task_index);
+    if (task != NULL) {
+        if (!AvSetMmThreadPriority(task, AVRT_PRIORITY_HIGH)) {
+            log_debug("AvSetMmThreadPriority failed: error %lu\n",
+                      (unsigned long)GetLastError());
+        }
+        return 0;
+    }
+
+    log_debug("MMCSS registration failed (error %lu). Falling back to "
+              "THREAD_PRIORITY_TIME_CRITICAL.\n",
+              (unsigned long)GetLastError());
+
+    if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL)) {
+        log_warning("Failed to raise thread priority: error %lu\n",
+                    (unsigned long)GetLastError());
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    return 0;
+}
+
+#else
+
+static int set_affinity(int cpu)
+{
+#if BLADERF_OS_LINUX || BLADERF_OS_FREEBSD
+    cpu_set_t cpus;
+    int status;
+
+    if (cpu >= CPU_SETSIZE) {
+        log_warning("CPU index %d exceeds CPU_SETSIZE.\n", cpu);
+        return BLADERF_ERR_INVAL;
+    }
+
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+
+    status = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (status != 0) {
+        log_warning("Failed to pin thread to CPU %d: %s\n", cpu,
+                    strerror(status));
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    return 0;
+#else
+    log_warning("Thread CPU affinity is not supported on this platform.\n");
+    return BLADERF_ERR_UNSUPPORTED;
+#endif
+}
+
+static int set_realtime(int priority)
+{
+    struct sched_param param;
+    int prio_min, prio_max;
+    int status;
+
+    prio_min = sched_get_priority_min(SCHED_FIFO);
+    prio_max = sched_get_priority_max(SCHED_FIFO);
+    if (prio_min < 0 || prio_max < 0) {
+        log_warning("Unable to query SCHED_FIFO priority range.\n");
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (priority == 0) {
+        priority = prio_min + (prio_max - prio_min) / 2;
+    } else if (priority < prio_min) {
+        priority = prio_min;
+    } else if (priority > prio_max) {
+        priority = prio_max;
+    }
+
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = priority;
+
+    status = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (status != 0) {
+        log_warning("Failed to enable SCHED_FIFO (priority %d): %s\n",
+                    priority, strerror(status));
+        return (status == EPERM) ? BLADERF_ERR_PERMISSION
+                                 : BLADERF_ERR_UNEXPECTED;
+    }
+
+    return 0;
+}
+
+#endif
+
+int thread_attrs_apply(const struct bladerf_thread_attrs *attrs)
+{
+    int first_error = 0;
+    int status;
+
+    if (attrs->cpu >= 0) {
+        status = set_affinity(attrs->cpu);
+        if (status == 0) {
+            log_verbose("Pinned thread to CPU %d\n", attrs->cpu);
+        } else if (first_error == 0) {
+            first_error = status;
+        }
+    }
+
+    if (attrs->realtime) {
+        status = set_realtime(attrs->priority);
+        if (status == 0) {
+            log_verbose("Enabled real-time scheduling for thread\n");
+        } else if (first_error == 0) {
+            first_error = status;
+        }
+    }
+
+    return first_error;
+}
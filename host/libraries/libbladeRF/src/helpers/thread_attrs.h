@@ -0,0 +1,70 @@
+/**
+ * @file thread_attrs.h
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_THREAD_ATTRS_H_
+#define HELPERS_THREAD_ATTRS_H_
+
+#include <libbladeRF.h>
+
+/**
+ * Initialize thread attributes to their defaults: no pinning, and the
+ * default scheduling policy.
+ *
+ * @param[out]  attrs       Attributes to initialize
+ */
+void thread_attrs_init(struct bladerf_thread_attrs *attrs);
+
+/**
+ * Check whether thread attributes contain valid values
+ *
+ * @param[in]   attrs       Attributes to check
+ *
+ * @return 0 if valid, BLADERF_ERR_INVAL otherwise
+ */
+int thread_attrs_validate(const struct bladerf_thread_attrs *attrs);
+
+/**
+ * Determine whether the attributes request anything beyond the defaults
+ *
+ * @param[in]   attrs       Attributes to check
+ *
+ * @return true if applying `attrs` would change the calling thread
+ */
+bool thread_attrs_nondefault(const struct bladerf_thread_attrs *attrs);
+
+/**
+ * Apply thread attributes to the calling thread. Each attribute is applied
+ * independently; a failure to apply one does not prevent the others from
+ * being applied.
+ *
+ * @param[in]   attrs       Attributes to apply
+ *
+ * @return 0 on success, or the error code associated with the first
+ *         attribute that could not be applied.
+ */
+int thread_attrs_apply(const struct bladerf_thread_attrs *attrs);
+
+#endif
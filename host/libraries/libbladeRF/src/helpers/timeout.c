@@ -29,6 +29,8 @@
 
 #include <libbladeRF.h>
 
+#include "helpers/wallclock.h"
+
 int populate_abs_timeout(struct timespec *t, unsigned int timeout_ms)
 {
     static const int nsec_per_sec = 1000 * 1000 * 1000;
@@ -50,3 +52,8 @@ int populate_abs_timeout(struct timespec *t, unsigned int timeout_ms)
         return 0;
     }
 }
+
+uint64_t time_now_us(void)
+{
+    return wallclock_get_monotonic_nsec() / 1000;
+}
@@ -27,6 +27,8 @@
 #ifndef HELPERS_TIMEOUT_H_
 #define HELPERS_TIMEOUT_H_
 
+#include <stdint.h>
+
 /**
  * Populate the provided timeval structure for the specified timeout
  *
@@ -37,4 +39,13 @@
  */
 int populate_abs_timeout(struct timespec *t_abs, unsigned int timeout_ms);
 
+/**
+ * Get the current time, in microseconds, from a monotonic clock. This is
+ * intended for measuring short intervals, and is unaffected by changes to the
+ * system time.
+ *
+ * @return Current time, or 0 on failure
+ */
+uint64_t time_now_us(void);
+
 #endif
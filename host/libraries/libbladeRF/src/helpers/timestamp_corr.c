@@ -0,0 +1,340 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "rel_assert.h"
+#include "thread.h"
+
+#include "board/board.h"
+#include "helpers/dev_lock.h"
+#include "helpers/timeout.h"
+#include "helpers/timestamp_corr.h"
+#include "helpers/wallclock.h"
+
+/* Number of samples the model is fit over */
+#ifndef TIMESTAMP_CORR_WINDOW
+#   define TIMESTAMP_CORR_WINDOW 32
+#endif
+
+/* Samples whose host clock bracket is this many times wider than the
+ * narrowest one in the window are presumed to have been delayed (e.g., by
+ * contention for the device lock) and are discarded */
+#define TIMESTAMP_CORR_RTT_FACTOR 4
+
+/* A sample deviating from the model by more than this implies the counter
+ * was reset or the sample rate changed, so the window is restarted */
+#define TIMESTAMP_CORR_RESET_NS (5 * 1000 * 1000)
+
+struct corr_sample {
+    bladerf_timestamp timestamp;
+    uint64_t host_ns; /* Midpoint of the host clock reads */
+    uint64_t rtt_ns;  /* Time between the host clock reads */
+};
+
+struct timestamp_corr {
+    struct bladerf *dev;
+    bladerf_direction dir;
+    unsigned int interval_ms;
+    pthread_t thread;
+
+    MUTEX lock; /* Protects all of the following */
+    pthread_cond_t stop_cond;
+    bool stop;
+
+    struct corr_sample window[TIMESTAMP_CORR_WINDOW];
+    unsigned int count; /* Number of valid entries in `window` */
+    unsigned int next;  /* Index of the next entry to replace */
+
+    /* Fitted model, relative to the most recent sample:
+     *  host_ns = host_ref + offset_ns + ns_per_tick * (timestamp - ts_ref) */
+    bool valid;
+    bladerf_timestamp ts_ref;
+    uint64_t host_ref;
+    double offset_ns;
+    double ns_per_tick;
+};
+
+static int take_sample(struct timestamp_corr *c, struct corr_sample *s)
+{
+    uint64_t before, after;
+    int status;
+
+    dev_lock_urgent(c->dev);
+    before = wallclock_get_monotonic_nsec();
+    status = c->dev->board->get_timestamp(c->dev, c->dir, &s->timestamp);
+    after  = wallclock_get_monotonic_nsec();
+    MUTEX_UNLOCK(&c->dev->lock);
+
+    if (status == 0 && (before == 0 || after < before)) {
+        status = BLADERF_ERR_UNEXPECTED;
+    }
+
+    s->host_ns = before + (after - before) / 2;
+    s->rtt_ns  = after - before;
+
+    return status;
+}
+
+static inline double model_host(struct timestamp_corr *c, bladerf_timestamp t)
+{
+    return (double)c->host_ref + c->offset_ns +
+           c->ns_per_tick * ((double)t - (double)c->ts_ref);
+}
+
+static inline double abs_diff(double a, double b)
+{
+    return a > b ? a - b : b - a;
+}
+
+/* Round to the nearest integer, clamping negative values to zero */
+static inline uint64_t round_u64(double x)
+{
+    return x > 0 ? (uint64_t)(x + 0.5) : 0;
+}
+
+static void reset_window(struct timestamp_corr *c)
+{
+    c->count = 0;
+    c->next  = 0;
+    c->valid = false;
+}
+
+/* Least-squares fit over the window. Coordinates are taken relative to the
+ * newest sample to retain precision in the double arithmetic. */
+static void fit_model(struct timestamp_corr *c, const struct corr_sample *ref)
+{
+    double sx = 0, sy = 0, sxx = 0, sxy = 0, n = c->count;
+    double denom;
+    unsigned int i;
+
+    for (i = 0; i < c->count; i++) {
+        const double x = (double)c->window[i].timestamp - (double)ref->timestamp;
+        const double y = (double)c->window[i].host_ns - (double)ref->host_ns;
+
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+    }
+
+    denom = n * sxx - sx * sx;
+    if (c->count < 2 || denom <= 0) {
+        c->valid = false;
+        return;
+    }
+
+    c->ns_per_tick = (n * sxy - sx * sy) / denom;
+    c->offset_ns   = (sy - c->ns_per_tick * sx) / n;
+    c->ts_ref      = ref->timestamp;
+    c->host_ref    = ref->host_ns;
+    c->valid       = c->ns_per_tick > 0;
+}
+
+static uint64_t min_rtt(struct timestamp_corr *c)
+{
+    uint64_t ret = UINT64_MAX;
+    unsigned int i;
+
+    for (i = 0; i < c->count; i++) {
+        if (c->window[i].rtt_ns < ret) {
+            ret = c->window[i].rtt_ns;
+        }
+    }
+
+    return ret;
+}
+
+static void add_sample(struct timestamp_corr *c, const struct corr_sample *s)
+{
+    if (c->count != 0) {
+        const struct corr_sample *prev =
+            &c->window[(c->next + TIMESTAMP_CORR_WINDOW - 1) %
+                       TIMESTAMP_CORR_WINDOW];
+
+        if (s->timestamp < prev->timestamp || s->host_ns < prev->host_ns) {
+            log_debug("%s: Timestamp went backwards; restarting fit\n",
+                      __FUNCTION__);
+            reset_window(c);
+        } else if (c->valid &&
+                   abs_diff(model_host(c, s->timestamp), (double)s->host_ns) >
+                       TIMESTAMP_CORR_RESET_NS) {
+            log_debug("%s: Sample deviates from fit; restarting fit\n",
+                      __FUNCTION__);
+            reset_window(c);
+        } else if (c->count >= 4 &&
+                   s->rtt_ns > TIMESTAMP_CORR_RTT_FACTOR * min_rtt(c)) {
+            log_verbose("%s: Discarding delayed sample (%" PRIu64 " ns)\n",
+                        __FUNCTION__, s->rtt_ns);
+            return;
+        }
+    }
+
+    c->window[c->next] = *s;
+    c->next            = (c->next + 1) % TIMESTAMP_CORR_WINDOW;
+    if (c->count < TIMESTAMP_CORR_WINDOW) {
+        c->count++;
+    }
+
+    fit_model(c, s);
+}
+
+static void *timestamp_corr_task(void *arg)
+{
+    struct timestamp_corr *c = (struct timestamp_corr *)arg;
+    struct corr_sample s;
+    struct timespec deadline;
+    int status;
+
+    MUTEX_LOCK(&c->lock);
+
+    while (!c->stop) {
+        MUTEX_UNLOCK(&c->lock);
+        status = take_sample(c, &s);
+        MUTEX_LOCK(&c->lock);
+
+        if (status == 0) {
+            add_sample(c, &s);
+        } else {
+            log_debug("%s: Failed to read timestamp: %s\n", __FUNCTION__,
+                      bladerf_strerror(status));
+        }
+
+        if (populate_abs_timeout(&deadline, c->interval_ms) != 0) {
+            break;
+        }
+
+        status = 0;
+        while (!c->stop && status != ETIMEDOUT) {
+            status = pthread_cond_timedwait(&c->stop_cond, &c->lock, &deadline);
+        }
+    }
+
+    MUTEX_UNLOCK(&c->lock);
+
+    return NULL;
+}
+
+int timestamp_corr_start(struct timestamp_corr **corr,
+                         struct bladerf *dev,
+                         bladerf_direction dir,
+                         unsigned int interval_ms)
+{
+    struct timestamp_corr *c;
+    int status;
+
+    if (interval_ms == 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    c = calloc(1, sizeof(*c));
+    if (c == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    c->dev         = dev;
+    c->dir         = dir;
+    c->interval_ms = interval_ms;
+    reset_window(c);
+
+    MUTEX_INIT(&c->lock);
+
+    status = pthread_cond_init(&c->stop_cond, NULL);
+    if (status != 0) {
+        MUTEX_DESTROY(&c->lock);
+        free(c);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    status = pthread_create(&c->thread, NULL, timestamp_corr_task, c);
+    if (status != 0) {
+        pthread_cond_destroy(&c->stop_cond);
+        MUTEX_DESTROY(&c->lock);
+        free(c);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    *corr = c;
+    return 0;
+}
+
+void timestamp_corr_stop(struct timestamp_corr *c)
+{
+    if (c == NULL) {
+        return;
+    }
+
+    MUTEX_LOCK(&c->lock);
+    c->stop = true;
+    pthread_cond_signal(&c->stop_cond);
+    MUTEX_UNLOCK(&c->lock);
+
+    pthread_join(c->thread, NULL);
+
+    pthread_cond_destroy(&c->stop_cond);
+    MUTEX_DESTROY(&c->lock);
+    free(c);
+}
+
+int timestamp_corr_to_host(struct timestamp_corr *c,
+                           bladerf_timestamp timestamp,
+                           uint64_t *host_ns)
+{
+    int status = BLADERF_ERR_WOULD_BLOCK;
+
+    MUTEX_LOCK(&c->lock);
+
+    if (c->valid) {
+        *host_ns = round_u64(model_host(c, timestamp));
+        status   = 0;
+    }
+
+    MUTEX_UNLOCK(&c->lock);
+
+    return status;
+}
+
+int timestamp_corr_from_host(struct timestamp_corr *c,
+                             uint64_t host_ns,
+                             bladerf_timestamp *timestamp)
+{
+    int status = BLADERF_ERR_WOULD_BLOCK;
+    double t;
+
+    MUTEX_LOCK(&c->lock);
+
+    if (c->valid) {
+        t = (double)c->ts_ref +
+            ((double)host_ns - (double)c->host_ref - c->offset_ns) /
+                c->ns_per_tick;
+
+        *timestamp = round_u64(t);
+        status     = 0;
+    }
+
+    MUTEX_UNLOCK(&c->lock);
+
+    return status;
+}
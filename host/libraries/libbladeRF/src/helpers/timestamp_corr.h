@@ -0,0 +1,84 @@
+/**
+ * @file timestamp_corr.h
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_TIMESTAMP_CORR_H_
+#define HELPERS_TIMESTAMP_CORR_H_
+
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+/* Correlates a device's timestamp counter with the host's monotonic clock.
+ *
+ * A background thread periodically reads the counter (via the board's
+ * get_timestamp() op, with the device lock held) bracketed by host clock
+ * reads, and fits a linear model over a sliding window of these samples.
+ * Conversions only consult the fitted model. */
+struct timestamp_corr;
+
+/**
+ * Start a correlation service for the specified direction's timestamp.
+ *
+ * @param[out]  corr        Set to the new service on success
+ * @param       dev         Device handle. The caller must not hold dev->lock.
+ * @param[in]   dir         Timestamp to correlate
+ * @param[in]   interval_ms Sampling interval
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int timestamp_corr_start(struct timestamp_corr **corr,
+                         struct bladerf *dev,
+                         bladerf_direction dir,
+                         unsigned int interval_ms);
+
+/**
+ * Stop and free a correlation service. The caller must not hold dev->lock.
+ *
+ * @param[in]   corr        Service to stop. NULL is ignored.
+ */
+void timestamp_corr_stop(struct timestamp_corr *corr);
+
+/**
+ * Convert a timestamp to the host clock
+ *
+ * @return 0 on success, BLADERF_ERR_WOULD_BLOCK if too few samples have been
+ *         collected to fit a model
+ */
+int timestamp_corr_to_host(struct timestamp_corr *corr,
+                           bladerf_timestamp timestamp,
+                           uint64_t *host_ns);
+
+/**
+ * Convert a host clock time to a timestamp
+ *
+ * @return 0 on success, BLADERF_ERR_WOULD_BLOCK if too few samples have been
+ *         collected to fit a model
+ */
+int timestamp_corr_from_host(struct timestamp_corr *corr,
+                             uint64_t host_ns,
+                             bladerf_timestamp *timestamp);
+
+#endif
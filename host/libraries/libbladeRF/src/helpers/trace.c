@@ -0,0 +1,61 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "helpers/trace.h"
+
+/* Only the ETW tracepoints require any state */
+#ifdef LIBBLADERF_TRACE_ETW
+
+#include <pthread.h>
+
+/* The GUID is the one ETW tools derive from the provider name, so the
+ * provider may also be enabled as "*Nuand.libbladeRF" */
+TRACELOGGING_DEFINE_PROVIDER(bladerf_trace_provider,
+                             "Nuand.libbladeRF",
+                             (0x530b65ab, 0xb9bc, 0x5f64, 0x79, 0x55, 0xd3,
+                              0x87, 0xc2, 0x47, 0x2e, 0x8e));
+
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int trace_refs    = 0;
+
+void trace_register(void)
+{
+    pthread_mutex_lock(&trace_lock);
+
+    if (trace_refs++ == 0) {
+        TraceLoggingRegister(bladerf_trace_provider);
+    }
+
+    pthread_mutex_unlock(&trace_lock);
+}
+
+void trace_unregister(void)
+{
+    pthread_mutex_lock(&trace_lock);
+
+    if (trace_refs != 0 && --trace_refs == 0) {
+        TraceLoggingUnregister(bladerf_trace_provider);
+    }
+
+    pthread_mutex_unlock(&trace_lock);
+}
+
+#endif
@@ -0,0 +1,115 @@
+/**
+ * @file trace.h
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_TRACE_H_
+#define HELPERS_TRACE_H_
+
+#include <stdint.h>
+
+/* Static tracepoints in the streaming data path, for building latency
+ * timelines with external tools. These are compiled out unless libbladeRF is
+ * built with ENABLE_LIBBLADERF_TRACEPOINTS.
+ *
+ * On Linux, these are USDT probes of the "libbladerf" provider, which cost a
+ * single NOP while no tracer is attached. For example:
+ *
+ *   bpftrace -e 'usdt:/usr/lib/libbladeRF.so:libbladerf:xfer_complete
+ *                { @[arg2] = count(); }'
+ *
+ * On Windows, these are TraceLogging events of the "Nuand.libbladeRF" ETW
+ * provider, named after the tracepoint.
+ *
+ * Arguments must be integers; pass pointers via (uintptr_t). The
+ * tracepoints are:
+ *
+ *   xfer_submit(stream, buffer, length)
+ *   xfer_complete(stream, buffer, status, actual_length)
+ *   buf_status(buf_mgmt, index, status)
+ *   rx_overrun(sync, index)
+ *   worker_state(worker, state)
+ *   sync_rx_entry(sync, num_samples)
+ *   sync_rx_return(sync, status, num_samples)
+ *   sync_tx_entry(sync, num_samples)
+ *   sync_tx_return(sync, status, num_samples)
+ */
+
+#if defined(LIBBLADERF_TRACE_USDT)
+
+#include <sys/sdt.h>
+
+#define TRACE_POINT2(name, a, b) \
+    DTRACE_PROBE2(libbladerf, name, a, b)
+#define TRACE_POINT3(name, a, b, c) \
+    DTRACE_PROBE3(libbladerf, name, a, b, c)
+#define TRACE_POINT4(name, a, b, c, d) \
+    DTRACE_PROBE4(libbladerf, name, a, b, c, d)
+
+#define trace_register()    do {} while (0)
+#define trace_unregister()  do {} while (0)
+
+#elif defined(LIBBLADERF_TRACE_ETW)
+
+#include <windows.h>
+#include <TraceLoggingProvider.h>
+
+TRACELOGGING_DECLARE_PROVIDER(bladerf_trace_provider);
+
+#define TRACE_ARG(x) TraceLoggingUInt64((uint64_t)(x), #x)
+
+#define TRACE_POINT2(name, a, b)                                  \
+    TraceLoggingWrite(bladerf_trace_provider, #name, TRACE_ARG(a), \
+                      TRACE_ARG(b))
+#define TRACE_POINT3(name, a, b, c)                               \
+    TraceLoggingWrite(bladerf_trace_provider, #name, TRACE_ARG(a), \
+                      TRACE_ARG(b), TRACE_ARG(c))
+#define TRACE_POINT4(name, a, b, c, d)                            \
+    TraceLoggingWrite(bladerf_trace_provider, #name, TRACE_ARG(a), \
+                      TRACE_ARG(b), TRACE_ARG(c), TRACE_ARG(d))
+
+/**
+ * Register the ETW provider. Calls are reference counted, such that the
+ * provider remains registered until the matching number of
+ * trace_unregister() calls.
+ */
+void trace_register(void);
+
+/**
+ * Release a reference taken by trace_register()
+ */
+void trace_unregister(void);
+
+#else
+
+#define TRACE_POINT2(name, a, b)        do {} while (0)
+#define TRACE_POINT3(name, a, b, c)     do {} while (0)
+#define TRACE_POINT4(name, a, b, c, d)  do {} while (0)
+
+#define trace_register()    do {} while (0)
+#define trace_unregister()  do {} while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,258 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+
+#include "board/board.h"
+#include "helpers/tune_cache.h"
+#include "helpers/wallclock.h"
+
+/* Entries are dropped once the RFIC temperature has drifted by more than
+ * this many degrees Celsius since the cache was last emptied */
+#define TUNE_CACHE_MAX_TEMP_DELTA 10.0F
+
+/* Minimum interval between temperature checks, in ns */
+#define TUNE_CACHE_TEMP_INTERVAL_NS 1000000000ULL
+
+struct tune_cache_entry {
+    bladerf_frequency frequency;
+    struct bladerf_quick_tune quick_tune;
+    uint64_t last_use;
+    bool valid;     /* Entry holds quick tune parameters for `frequency` */
+    bool allocated; /* quick_tune holds device resources, to be reused */
+};
+
+struct tune_cache {
+    struct tune_cache_entry *entries;
+    unsigned int num_slots;
+    unsigned int capacity;
+    uint64_t use_count;
+
+    /* No further get_quick_tune() calls are made after one fails, as the
+     * board has run out of resources for them */
+    bool exhausted;
+
+    bool have_temp;
+    bool no_temp_sensor;
+    float temp;
+    uint64_t temp_checked;
+};
+
+int tune_cache_set_capacity(struct tune_cache **cache, unsigned int capacity)
+{
+    struct tune_cache *c = *cache;
+    unsigned int i;
+
+    if (c == NULL) {
+        c = calloc(1, sizeof(*c));
+        if (c == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+
+        *cache = c;
+    }
+
+    if (capacity > c->num_slots) {
+        struct tune_cache_entry *entries;
+
+        entries = realloc(c->entries, capacity * sizeof(entries[0]));
+        if (entries == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+
+        memset(&entries[c->num_slots], 0,
+               (capacity - c->num_slots) * sizeof(entries[0]));
+
+        c->entries   = entries;
+        c->num_slots = capacity;
+    }
+
+    for (i = capacity; i < c->num_slots; i++) {
+        c->entries[i].valid = false;
+    }
+
+    c->capacity = capacity;
+
+    return 0;
+}
+
+void tune_cache_free(struct tune_cache *cache)
+{
+    if (cache != NULL) {
+        free(cache->entries);
+        free(cache);
+    }
+}
+
+static void invalidate(struct tune_cache *cache)
+{
+    unsigned int i;
+
+    for (i = 0; i < cache->num_slots; i++) {
+        cache->entries[i].valid = false;
+    }
+}
+
+static void check_temperature(struct tune_cache *cache, struct bladerf *dev)
+{
+    const uint64_t now = wallclock_get_monotonic_nsec();
+    float temp;
+    int status;
+
+    if (cache->no_temp_sensor ||
+        (cache->have_temp &&
+         now - cache->temp_checked < TUNE_CACHE_TEMP_INTERVAL_NS)) {
+        return;
+    }
+
+    status = dev->board->get_rfic_temperature(dev, &temp);
+    if (status == BLADERF_ERR_UNSUPPORTED) {
+        cache->no_temp_sensor = true;
+        return;
+    } else if (status != 0) {
+        return;
+    }
+
+    cache->temp_checked = now;
+
+    if (cache->have_temp &&
+        fabsf(temp - cache->temp) <= TUNE_CACHE_MAX_TEMP_DELTA) {
+        return;
+    }
+
+    if (cache->have_temp) {
+        log_verbose("%s: RFIC temperature moved from %.1f to %.1f C. "
+                    "Dropping cached quick tunes.\n",
+                    __FUNCTION__, cache->temp, temp);
+        invalidate(cache);
+    }
+
+    cache->temp      = temp;
+    cache->have_temp = true;
+}
+
+static void record(struct tune_cache *cache,
+                   struct bladerf *dev,
+                   bladerf_channel ch,
+                   bladerf_frequency freq)
+{
+    struct tune_cache_entry *e = NULL;
+    unsigned int i;
+    int status;
+
+    /* Prefer an empty slot already holding device resources, then any empty
+     * slot, then the least recently used entry */
+    for (i = 0; i < cache->capacity; i++) {
+        struct tune_cache_entry *c = &cache->entries[i];
+
+        if (!c->valid && (c->allocated || !cache->exhausted)) {
+            if (e == NULL || e->valid || (c->allocated && !e->allocated)) {
+                e = c;
+            }
+        } else if (c->valid && (e == NULL || (e->valid &&
+                                              c->last_use < e->last_use))) {
+            e = c;
+        }
+    }
+
+    if (e == NULL) {
+        return;
+    }
+
+    e->valid = false;
+
+    if (e->allocated) {
+        status = dev->board->update_quick_tune(dev, ch, &e->quick_tune);
+    } else {
+        status = dev->board->get_quick_tune(dev, ch, &e->quick_tune);
+        if (status == 0) {
+            e->allocated = true;
+        } else {
+            cache->exhausted = true;
+        }
+    }
+
+    if (status != 0) {
+        log_debug("%s: Failed to record quick tune for %" PRIu64 " Hz: %s\n",
+                  __FUNCTION__, freq, bladerf_strerror(status));
+        return;
+    }
+
+    e->frequency = freq;
+    e->last_use  = ++cache->use_count;
+    e->valid     = true;
+}
+
+int tune_cache_set_frequency(struct tune_cache *cache,
+                             struct bladerf *dev,
+                             bladerf_channel ch,
+                             bladerf_frequency freq)
+{
+    unsigned int i;
+    int status;
+
+    if (cache->capacity == 0) {
+        return dev->board->set_frequency(dev, ch, freq);
+    }
+
+    check_temperature(cache, dev);
+
+    for (i = 0; i < cache->capacity; i++) {
+        struct tune_cache_entry *e = &cache->entries[i];
+
+        if (e->valid && e->frequency == freq) {
+            status = dev->board->schedule_retune(dev, ch, BLADERF_RETUNE_NOW,
+                                                 freq, &e->quick_tune);
+            if (status == 0) {
+                e->last_use = ++cache->use_count;
+                return 0;
+            }
+
+            log_debug("%s: Quick tune to %" PRIu64 " Hz failed: %s\n",
+                      __FUNCTION__, freq, bladerf_strerror(status));
+            e->valid = false;
+            break;
+        }
+    }
+
+    status = dev->board->set_frequency(dev, ch, freq);
+    if (status == 0) {
+        record(cache, dev, ch, freq);
+    }
+
+    return status;
+}
+
+void tune_cache_invalidate_all(struct bladerf *dev)
+{
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(dev->tune_cache); i++) {
+        if (dev->tune_cache[i] != NULL) {
+            invalidate(dev->tune_cache[i]);
+        }
+    }
+}
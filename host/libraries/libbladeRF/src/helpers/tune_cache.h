@@ -0,0 +1,86 @@
+/**
+ * @file tune_cache.h
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HELPERS_TUNE_CACHE_H_
+#define HELPERS_TUNE_CACHE_H_
+
+#include <libbladeRF.h>
+
+/* A bounded, least-recently-used cache of quick tune parameters for one
+ * channel, keyed by frequency. Entries are recorded after each successful
+ * tuning, and repeat frequencies are tuned via schedule_retune() with the
+ * recorded parameters instead of the full tuning procedure.
+ *
+ * On boards where quick tunes hold device resources (the bladeRF2's fast
+ * lock profiles), each cache slot keeps its resources when its entry is
+ * evicted or invalidated, and they are reused for the slot's next entry.
+ *
+ * All of the functions below must be called with dev->lock held. */
+struct tune_cache;
+
+/**
+ * Create a cache, or change the number of entries an existing one holds.
+ * Entries beyond a reduced capacity are dropped, but their slots are kept
+ * for reuse should the capacity be raised again.
+ *
+ * @param[inout]    cache       Cache, or NULL to create one
+ * @param[in]       capacity    Maximum number of entries. 0 disables the
+ *                              cache without freeing it.
+ *
+ * @return 0 on success, BLADERF_ERR_MEM on allocation failure
+ */
+int tune_cache_set_capacity(struct tune_cache **cache, unsigned int capacity);
+
+/**
+ * Free a cache. NULL is ignored.
+ */
+void tune_cache_free(struct tune_cache *cache);
+
+/**
+ * Tune a channel, using and updating its cache
+ *
+ * @param       cache   Cache for the channel
+ * @param       dev     Device handle
+ * @param[in]   ch      Channel
+ * @param[in]   freq    Frequency
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure. Failures to record
+ *         an entry are not reported.
+ */
+int tune_cache_set_frequency(struct tune_cache *cache,
+                             struct bladerf *dev,
+                             bladerf_channel ch,
+                             bladerf_frequency freq);
+
+/**
+ * Drop the entries of every channel's cache, as when the reference clock or
+ * the RF path configuration changes
+ *
+ * @param       dev     Device handle
+ */
+void tune_cache_invalidate_all(struct bladerf *dev);
+
+#endif
@@ -0,0 +1,443 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "rel_assert.h"
+#include "thread.h"
+
+#include "helpers/timeout.h"
+#include "helpers/tx_sched.h"
+
+#ifndef TX_SCHED_LEN
+#   define TX_SCHED_LEN 256
+#endif
+
+/* Default timeout of each bladerf_sync_tx() call made by the worker */
+#define TX_SCHED_DEFAULT_TIMEOUT_MS 1000
+
+/* Longest the worker sleeps, when waiting for a burst to come within the
+ * lead, before checking the device's timestamp again */
+#define TX_SCHED_MAX_WAIT_MS 100
+
+struct tx_burst {
+    void *samples;
+    size_t capacity;        /* Size of `samples`, in bytes */
+    unsigned int num_samples;
+    uint64_t timestamp;
+    uint64_t duration;
+};
+
+struct tx_sched {
+    struct bladerf *dev;
+    pthread_t thread;
+
+    MUTEX lock;             /* Protects all of the following */
+    pthread_cond_t work;    /* Signaled on submission, configuration, and
+                             * stop requests */
+    pthread_cond_t done;    /* Signaled as bursts are transmitted */
+    bool stop;
+
+    uint64_t lead;
+    unsigned int timeout_ms;
+
+    /* Queued bursts, sorted by timestamp. Bursts with equal timestamps are
+     * kept in the order they were submitted. */
+    struct tx_burst bursts[TX_SCHED_LEN];
+    unsigned int count;
+
+    /* Sample buffers of transmitted bursts, kept for reuse such that
+     * steady-state submission does not allocate */
+    struct tx_burst spare[TX_SCHED_LEN];
+    unsigned int num_spare;
+
+    /* End of the last burst passed to bladerf_sync_tx() */
+    uint64_t sent_end;
+    bool sent_any;
+
+    /* First error reported since the last flush */
+    int error;
+
+    /* Bursts submitted and transmitted, for flushing */
+    uint64_t submitted;
+    uint64_t completed;
+};
+
+/* Determine how long to wait before the earliest burst comes within the
+ * lead, querying the device's TX timestamp. Returns 0 if it should be
+ * transmitted now. Called without q->lock held. */
+static unsigned int lead_wait_ms(struct tx_sched *q,
+                                 uint64_t timestamp,
+                                 uint64_t lead)
+{
+    bladerf_timestamp now;
+    bladerf_sample_rate rate;
+    uint64_t wait_ms;
+    int status;
+
+    status = bladerf_get_timestamp(q->dev, BLADERF_TX, &now);
+    if (status == 0) {
+        status = bladerf_get_sample_rate(q->dev, BLADERF_CHANNEL_TX(0), &rate);
+    }
+
+    /* Without a timestamp to go by, there is nothing to wait for */
+    if (status != 0 || rate == 0) {
+        return 0;
+    }
+
+    if (timestamp <= now || timestamp - now <= lead) {
+        return 0;
+    }
+
+    wait_ms = (timestamp - now - lead) * 1000 / rate;
+
+    if (wait_ms == 0) {
+        wait_ms = 1;
+    } else if (wait_ms > TX_SCHED_MAX_WAIT_MS) {
+        wait_ms = TX_SCHED_MAX_WAIT_MS;
+    }
+
+    return (unsigned int)wait_ms;
+}
+
+static int transmit(struct tx_sched *q, struct tx_burst *b,
+                    unsigned int timeout_ms)
+{
+    struct bladerf_metadata meta;
+
+    memset(&meta, 0, sizeof(meta));
+    meta.timestamp = b->timestamp;
+    meta.flags     = BLADERF_META_FLAG_TX_BURST_START |
+                     BLADERF_META_FLAG_TX_BURST_END;
+
+    return bladerf_sync_tx(q->dev, b->samples, b->num_samples, &meta,
+                           timeout_ms);
+}
+
+/* Take a spare buffer of at least `num_bytes`. Assumes q->lock is held. */
+static bool take_spare(struct tx_sched *q, size_t num_bytes,
+                       struct tx_burst *burst)
+{
+    unsigned int i;
+
+    for (i = 0; i < q->num_spare; i++) {
+        if (q->spare[i].capacity >= num_bytes) {
+            *burst = q->spare[i];
+            q->spare[i] = q->spare[--q->num_spare];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Keep a burst's buffer for reuse. Assumes q->lock is held. */
+static void put_spare(struct tx_sched *q, struct tx_burst *burst)
+{
+    unsigned int i;
+
+    if (q->num_spare < TX_SCHED_LEN) {
+        q->spare[q->num_spare++] = *burst;
+        return;
+    }
+
+    /* Replace the smallest spare, should this one be larger */
+    for (i = 0; i < q->num_spare; i++) {
+        if (q->spare[i].capacity < burst->capacity) {
+            free(q->spare[i].samples);
+            q->spare[i] = *burst;
+            return;
+        }
+    }
+
+    free(burst->samples);
+}
+
+static void *tx_sched_task(void *arg)
+{
+    struct tx_sched *q = (struct tx_sched *)arg;
+    struct timespec deadline;
+    struct tx_burst burst;
+    unsigned int timeout_ms;
+    unsigned int wait_ms;
+    uint64_t lead;
+    int status;
+
+    MUTEX_LOCK(&q->lock);
+
+    while (true) {
+        while (q->count == 0 && !q->stop) {
+            pthread_cond_wait(&q->work, &q->lock);
+        }
+
+        /* Queued bursts are always transmitted, even when stopping */
+        if (q->count == 0) {
+            break;
+        }
+
+        if (q->lead != 0 && !q->stop) {
+            burst = q->bursts[0];
+            lead  = q->lead;
+
+            MUTEX_UNLOCK(&q->lock);
+            wait_ms = lead_wait_ms(q, burst.timestamp, lead);
+            MUTEX_LOCK(&q->lock);
+
+            if (wait_ms != 0) {
+                /* An earlier burst may be submitted in the meantime */
+                if (populate_abs_timeout(&deadline, wait_ms) == 0) {
+                    pthread_cond_timedwait(&q->work, &q->lock, &deadline);
+                }
+                continue;
+            }
+        }
+
+        burst = q->bursts[0];
+        q->count--;
+        memmove(&q->bursts[0], &q->bursts[1],
+                q->count * sizeof(q->bursts[0]));
+
+        q->sent_end = burst.timestamp + burst.duration;
+        q->sent_any = true;
+        timeout_ms  = q->timeout_ms;
+
+        MUTEX_UNLOCK(&q->lock);
+
+        status = transmit(q, &burst, timeout_ms);
+
+        if (status != 0) {
+            log_debug("%s: Burst at t=%" PRIu64 " failed: %s\n", __FUNCTION__,
+                      burst.timestamp, bladerf_strerror(status));
+        }
+
+        MUTEX_LOCK(&q->lock);
+
+        put_spare(q, &burst);
+
+        if (status != 0 && q->error == 0) {
+            q->error = status;
+        }
+
+        q->completed++;
+        pthread_cond_broadcast(&q->done);
+    }
+
+    MUTEX_UNLOCK(&q->lock);
+
+    return NULL;
+}
+
+int tx_sched_start(struct tx_sched **sched, struct bladerf *dev)
+{
+    struct tx_sched *q;
+    int status;
+
+    /* The queue is large, so it's not zeroed via calloc() */
+    q = malloc(sizeof(*q));
+    if (q == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    q->dev        = dev;
+    q->stop       = false;
+    q->lead       = 0;
+    q->timeout_ms = TX_SCHED_DEFAULT_TIMEOUT_MS;
+    q->count      = 0;
+    q->num_spare  = 0;
+    q->sent_end   = 0;
+    q->sent_any   = false;
+    q->error      = 0;
+    q->submitted  = 0;
+    q->completed  = 0;
+
+    MUTEX_INIT(&q->lock);
+
+    if (pthread_cond_init(&q->work, NULL) != 0) {
+        goto err_work;
+    }
+
+    if (pthread_cond_init(&q->done, NULL) != 0) {
+        goto err_done;
+    }
+
+    status = pthread_create(&q->thread, NULL, tx_sched_task, q);
+    if (status != 0) {
+        goto err_thread;
+    }
+
+    *sched = q;
+    return 0;
+
+err_thread:
+    pthread_cond_destroy(&q->done);
+err_done:
+    pthread_cond_destroy(&q->work);
+err_work:
+    MUTEX_DESTROY(&q->lock);
+    free(q);
+    return BLADERF_ERR_UNEXPECTED;
+}
+
+void tx_sched_stop(struct tx_sched *q)
+{
+    unsigned int i;
+
+    if (q == NULL) {
+        return;
+    }
+
+    MUTEX_LOCK(&q->lock);
+    q->stop = true;
+    pthread_cond_signal(&q->work);
+    MUTEX_UNLOCK(&q->lock);
+
+    pthread_join(q->thread, NULL);
+
+    for (i = 0; i < q->num_spare; i++) {
+        free(q->spare[i].samples);
+    }
+
+    pthread_cond_destroy(&q->done);
+    pthread_cond_destroy(&q->work);
+    MUTEX_DESTROY(&q->lock);
+    free(q);
+}
+
+void tx_sched_config(struct tx_sched *q, uint64_t lead, unsigned int timeout_ms)
+{
+    MUTEX_LOCK(&q->lock);
+    q->lead       = lead;
+    q->timeout_ms = timeout_ms;
+    pthread_cond_signal(&q->work);
+    MUTEX_UNLOCK(&q->lock);
+}
+
+int tx_sched_submit(struct tx_sched *q,
+                    const void *samples,
+                    size_t num_bytes,
+                    unsigned int num_samples,
+                    uint64_t timestamp,
+                    uint64_t duration)
+{
+    struct tx_burst burst;
+    bool have_spare;
+    unsigned int i;
+    int status = 0;
+
+    MUTEX_LOCK(&q->lock);
+    have_spare = take_spare(q, num_bytes, &burst);
+    MUTEX_UNLOCK(&q->lock);
+
+    if (!have_spare) {
+        burst.samples = malloc(num_bytes);
+        if (burst.samples == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+
+        burst.capacity = num_bytes;
+    }
+
+    memcpy(burst.samples, samples, num_bytes);
+    burst.num_samples = num_samples;
+    burst.timestamp   = timestamp;
+    burst.duration    = duration;
+
+    MUTEX_LOCK(&q->lock);
+
+    if (q->stop) {
+        status = BLADERF_ERR_INVAL;
+    } else if (q->sent_any && timestamp < q->sent_end) {
+        log_debug("%s: t=%" PRIu64 " precedes the end of the last burst "
+                  "transmitted, t=%" PRIu64 "\n",
+                  __FUNCTION__, timestamp, q->sent_end);
+        status = BLADERF_ERR_TIME_PAST;
+    } else if (q->count == TX_SCHED_LEN) {
+        status = BLADERF_ERR_QUEUE_FULL;
+    } else {
+        /* Bursts tend to be submitted in roughly chronological order, so
+         * the insertion point is searched for from the end */
+        i = q->count;
+        while (i > 0 && q->bursts[i - 1].timestamp > timestamp) {
+            i--;
+        }
+
+        memmove(&q->bursts[i + 1], &q->bursts[i],
+                (q->count - i) * sizeof(q->bursts[0]));
+        q->bursts[i] = burst;
+
+        q->count++;
+        q->submitted++;
+        pthread_cond_signal(&q->work);
+    }
+
+    if (status != 0) {
+        put_spare(q, &burst);
+    }
+
+    MUTEX_UNLOCK(&q->lock);
+
+    return status;
+}
+
+int tx_sched_flush(struct tx_sched *q, unsigned int timeout_ms)
+{
+    struct timespec deadline;
+    uint64_t target;
+    int status = 0;
+
+    if (pthread_equal(pthread_self(), q->thread)) {
+        log_debug("%s: Cannot flush from the worker thread\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (timeout_ms != 0 && populate_abs_timeout(&deadline, timeout_ms) != 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    MUTEX_LOCK(&q->lock);
+
+    target = q->submitted;
+
+    while (status == 0 && q->completed < target) {
+        if (timeout_ms == 0) {
+            status = pthread_cond_wait(&q->done, &q->lock);
+        } else {
+            status = pthread_cond_timedwait(&q->done, &q->lock, &deadline);
+        }
+    }
+
+    if (status == 0) {
+        status   = q->error;
+        q->error = 0;
+    } else if (status == ETIMEDOUT) {
+        status = BLADERF_ERR_TIMEOUT;
+    } else {
+        status = BLADERF_ERR_UNEXPECTED;
+    }
+
+    MUTEX_UNLOCK(&q->lock);
+
+    return status;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file tx_sched.h
+ *
+ * @brief Scheduler for timestamped TX bursts, run by a per-device worker
+ *
+ * This file is not part of the API and may be changed at any time.
+ * If you're interfacing with libbladeRF, DO NOT use this file.
+ *
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Scheduler for timestamped TX bursts.
+ *
+ * Bursts may be submitted in any order. They are held in a queue sorted by
+ * timestamp, from which a worker thread passes them to bladerf_sync_tx(),
+ * earliest first, each as a complete burst. The device holds each burst
+ * until its timestamp is reached, so the gaps between bursts need not be
+ * filled by the caller.
+ *
+ * A burst is passed on once its timestamp is within the configured lead of
+ * the device's current TX timestamp. Until then, bursts with earlier
+ * timestamps may still be submitted ahead of it. With a lead of 0, bursts
+ * are passed on as soon as the worker is able to; bladerf_sync_tx() then
+ * paces the worker as the stream buffers fill. */
+
+#ifndef HELPERS_TX_SCHED_H_
+#define HELPERS_TX_SCHED_H_
+
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+struct tx_sched;
+
+/**
+ * Create a TX scheduler and start its worker thread
+ *
+ * @param[out]  sched       Set to the new scheduler on success
+ * @param       dev         Device the bursts are transmitted on
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int tx_sched_start(struct tx_sched **sched, struct bladerf *dev);
+
+/**
+ * Transmit all queued bursts, without regard to the lead, then stop the
+ * worker and free the scheduler. The caller must not hold dev->lock.
+ *
+ * @param[in]   sched       Scheduler to stop. NULL is ignored.
+ */
+void tx_sched_stop(struct tx_sched *sched);
+
+/**
+ * Configure the scheduler. See bladerf_tx_sched_config().
+ */
+void tx_sched_config(struct tx_sched *sched,
+                     uint64_t lead,
+                     unsigned int timeout_ms);
+
+/**
+ * Queue a burst. The samples are copied.
+ *
+ * @param       sched       Scheduler
+ * @param[in]   samples     Samples in the TX stream's format
+ * @param[in]   num_bytes   Size of `samples`, in bytes
+ * @param[in]   num_samples Number of samples, as with bladerf_sync_tx()
+ * @param[in]   timestamp   Timestamp of the first sample
+ * @param[in]   duration    Number of timestamp ticks the burst spans
+ *
+ * @return 0 on success,
+ *         BLADERF_ERR_TIME_PAST if `timestamp` precedes the end of a burst
+ *         already passed to bladerf_sync_tx(),
+ *         BLADERF_ERR_QUEUE_FULL if the queue is full,
+ *         or another BLADERF_ERR_* value on failure
+ */
+int tx_sched_submit(struct tx_sched *sched,
+                    const void *samples,
+                    size_t num_bytes,
+                    unsigned int num_samples,
+                    uint64_t timestamp,
+                    uint64_t duration);
+
+/**
+ * Wait for all bursts submitted thus far to be passed to bladerf_sync_tx()
+ *
+ * @return 0 on success, the first error reported by bladerf_sync_tx() since
+ *         the previous flush, BLADERF_ERR_TIMEOUT on timeout, or
+ *         BLADERF_ERR_INVAL if called from the worker thread
+ */
+int tx_sched_flush(struct tx_sched *sched, unsigned int timeout_ms);
+
+#endif
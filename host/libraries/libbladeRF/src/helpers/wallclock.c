@@ -45,3 +45,21 @@ uint64_t wallclock_get_current_nsec()
 
     return rv;
 }
+
+uint64_t wallclock_get_monotonic_nsec(void)
+{
+#if defined(CLOCK_MONOTONIC_RAW)
+    const clockid_t clk = CLOCK_MONOTONIC_RAW;
+#elif defined(CLOCK_MONOTONIC)
+    const clockid_t clk = CLOCK_MONOTONIC;
+#else
+    const clockid_t clk = CLOCK_REALTIME;
+#endif
+    struct timespec t;
+
+    if (clock_gettime(clk, &t) != 0) {
+        return 0;
+    }
+
+    return (uint64_t)t.tv_sec * 1000000000 + (uint64_t)t.tv_nsec;
+}
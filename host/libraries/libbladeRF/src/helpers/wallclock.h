@@ -26,4 +26,13 @@
 
 uint64_t wallclock_get_current_nsec();
 
+/**
+ * Read a monotonic clock that is not subject to NTP slewing, where the
+ * platform provides one (CLOCK_MONOTONIC_RAW on Linux). Otherwise, this
+ * falls back to CLOCK_MONOTONIC and, lastly, CLOCK_REALTIME.
+ *
+ * @return Time in nanoseconds, or 0 on failure
+ */
+uint64_t wallclock_get_monotonic_nsec(void);
+
 #endif  // WALLCLOCK_H_
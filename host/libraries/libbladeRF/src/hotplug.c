@@ -0,0 +1,266 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libbladeRF.h>
+
+#include "log.h"
+
+#include "backend/backend.h"
+#include "devinfo.h"
+#include "hotplug.h"
+
+#define HOTPLUG_MAX_CALLBACKS 16
+
+struct hotplug_callback {
+    bladerf_hotplug_cb cb;
+    void *user_data;
+};
+
+/* Lock ordering: start_lock, then cb_lock, then registry_lock.
+ *
+ * start_lock serializes starting and stopping the backends' notifications.
+ *
+ * cb_lock is held while callbacks are invoked, and while the registry is
+ * updated by the backends, so that a newly registered callback sees each
+ * device arrive exactly once.
+ *
+ * registry_lock protects only the registry, so that it may be read from
+ * within callbacks. */
+static pthread_mutex_t start_lock    = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t cb_lock       = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct hotplug_callback callbacks[HOTPLUG_MAX_CALLBACKS];
+static unsigned int num_callbacks = 0;
+
+static struct bladerf_devinfo_list registry;
+static bool registry_active = false;
+
+static bool same_device(const struct bladerf_devinfo *a,
+                        const struct bladerf_devinfo *b)
+{
+    return a->backend == b->backend && a->usb_bus == b->usb_bus &&
+           a->usb_addr == b->usb_addr;
+}
+
+static void notify(bladerf_hotplug_event event,
+                   const struct bladerf_devinfo *info)
+{
+    size_t i;
+
+    for (i = 0; i < HOTPLUG_MAX_CALLBACKS; i++) {
+        if (callbacks[i].cb != NULL) {
+            callbacks[i].cb(event, info, callbacks[i].user_data);
+        }
+    }
+}
+
+/* Called by the backends */
+static void hotplug_backend_cb(const struct bladerf_devinfo *info,
+                               bool arrived)
+{
+    struct bladerf_devinfo entry;
+    bool changed = false;
+    size_t i;
+    int status;
+
+    pthread_mutex_lock(&cb_lock);
+    pthread_mutex_lock(&registry_lock);
+
+    for (i = 0; i < registry.num_elt; i++) {
+        if (same_device(&registry.elt[i], info)) {
+            break;
+        }
+    }
+
+    if (arrived && i == registry.num_elt) {
+        memcpy(&entry, info, sizeof(entry));
+        entry.instance = (unsigned int)registry.num_elt;
+
+        status = bladerf_devinfo_list_add(&registry, &entry);
+        if (status != 0) {
+            log_error("Failed to add device to hotplug registry: %s\n",
+                      bladerf_strerror(status));
+        } else {
+            changed = true;
+        }
+    } else if (!arrived && i < registry.num_elt) {
+        memcpy(&entry, &registry.elt[i], sizeof(entry));
+
+        memmove(&registry.elt[i], &registry.elt[i + 1],
+                (registry.num_elt - i - 1) * sizeof(registry.elt[0]));
+        registry.num_elt--;
+
+        for (; i < registry.num_elt; i++) {
+            registry.elt[i].instance = (unsigned int)i;
+        }
+
+        changed = true;
+    }
+
+    pthread_mutex_unlock(&registry_lock);
+
+    if (changed) {
+        log_verbose("Hotplug: device %s bus=%u, addr=%u\n",
+                    arrived ? "arrived on" : "left", entry.usb_bus,
+                    entry.usb_addr);
+
+        notify(arrived ? BLADERF_HOTPLUG_ARRIVED : BLADERF_HOTPLUG_LEFT,
+               &entry);
+    }
+
+    pthread_mutex_unlock(&cb_lock);
+}
+
+bool hotplug_get_device_list(struct bladerf_devinfo **devices, int *count)
+{
+    struct bladerf_devinfo *list = NULL;
+    bool active;
+
+    pthread_mutex_lock(&registry_lock);
+
+    active = registry_active;
+    if (active) {
+        if (registry.num_elt == 0) {
+            *count = BLADERF_ERR_NODEV;
+        } else {
+            list = malloc(registry.num_elt * sizeof(list[0]));
+            if (list == NULL) {
+                *count = BLADERF_ERR_MEM;
+            } else {
+                memcpy(list, registry.elt, registry.num_elt * sizeof(list[0]));
+                *count   = (int)registry.num_elt;
+                *devices = list;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&registry_lock);
+
+    return active;
+}
+
+int bladerf_register_hotplug_callback(bladerf_hotplug_cb cb,
+                                      void *user_data,
+                                      int *handle)
+{
+    int status = 0;
+    size_t i;
+
+    if (cb == NULL || handle == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    pthread_mutex_lock(&start_lock);
+
+    if (num_callbacks == HOTPLUG_MAX_CALLBACKS) {
+        status = BLADERF_ERR_MEM;
+        goto out;
+    }
+
+    if (num_callbacks == 0) {
+        pthread_mutex_lock(&registry_lock);
+        status = bladerf_devinfo_list_init(&registry);
+        pthread_mutex_unlock(&registry_lock);
+
+        if (status != 0) {
+            goto out;
+        }
+
+        status = backend_hotplug_start(hotplug_backend_cb);
+        if (status != 0) {
+            free(registry.elt);
+            goto out;
+        }
+
+        pthread_mutex_lock(&registry_lock);
+        registry_active = true;
+        pthread_mutex_unlock(&registry_lock);
+    }
+
+    pthread_mutex_lock(&cb_lock);
+
+    /* num_callbacks guarantees a free slot */
+    i = 0;
+    while (callbacks[i].cb != NULL) {
+        i++;
+    }
+
+    callbacks[i].cb        = cb;
+    callbacks[i].user_data = user_data;
+    num_callbacks++;
+    *handle = (int)i;
+
+    /* Report the devices already attached. The registry is only modified
+     * with cb_lock held, so any further arrivals are reported once it is
+     * released. */
+    for (i = 0; i < registry.num_elt; i++) {
+        cb(BLADERF_HOTPLUG_ARRIVED, &registry.elt[i], user_data);
+    }
+
+    pthread_mutex_unlock(&cb_lock);
+
+out:
+    pthread_mutex_unlock(&start_lock);
+    return status;
+}
+
+int bladerf_deregister_hotplug_callback(int handle)
+{
+    int status = 0;
+
+    pthread_mutex_lock(&start_lock);
+
+    if (handle < 0 || handle >= HOTPLUG_MAX_CALLBACKS) {
+        status = BLADERF_ERR_INVAL;
+        goto out;
+    }
+
+    pthread_mutex_lock(&cb_lock);
+
+    if (callbacks[handle].cb == NULL) {
+        status = BLADERF_ERR_INVAL;
+    } else {
+        callbacks[handle].cb        = NULL;
+        callbacks[handle].user_data = NULL;
+        num_callbacks--;
+    }
+
+    pthread_mutex_unlock(&cb_lock);
+
+    if (status == 0 && num_callbacks == 0) {
+        backend_hotplug_stop();
+
+        pthread_mutex_lock(&registry_lock);
+        registry_active = false;
+        free(registry.elt);
+        memset(&registry, 0, sizeof(registry));
+        pthread_mutex_unlock(&registry_lock);
+    }
+
+out:
+    pthread_mutex_unlock(&start_lock);
+    return status;
+}
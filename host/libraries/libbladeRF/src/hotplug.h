@@ -0,0 +1,44 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef HOTPLUG_H_
+#define HOTPLUG_H_
+
+#include <stdbool.h>
+
+#include <libbladeRF.h>
+
+/**
+ * Copy the registry of attached devices maintained while hotplug callbacks
+ * are registered.
+ *
+ * @param[out]  devices     Device list, to be freed with
+ *                          bladerf_free_device_list(). Set to NULL if there
+ *                          are no devices.
+ * @param[out]  count       Number of devices in the list, or a BLADERF_ERR_*
+ *                          value on failure, as returned by probe()
+ *
+ * @return true if the registry is active and `count` was updated, or false if
+ *         the caller must probe for devices itself.
+ */
+bool hotplug_get_device_list(struct bladerf_devinfo **devices, int *count);
+
+#endif
@@ -96,6 +96,7 @@ void __fini __bladerf_fini(void)
 
     bladerf_log_set_verbosity(log_level);
     log_debug("libbladeRF %s: deinitializing\n", LIBBLADERF_VERSION);
+    log_shutdown();
     fflush(NULL);
 #if !defined(WIN32) && !defined(__CYGWIN__) && defined(LOG_SYSLOG_ENABLED)
     closelog();
@@ -0,0 +1,353 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libbladeRF.h>
+
+#include "host_config.h"
+#include "log.h"
+
+#include "helpers/latency_hist.h"
+#include "helpers/timeout.h"
+
+/* Each measurement transmits a burst of LATENCY_BURST_LEN samples, the first
+ * LATENCY_PULSE_LEN of which are a full-scale pulse, and the rest zero */
+#define LATENCY_BURST_LEN       4096
+#define LATENCY_PULSE_LEN       256
+#define LATENCY_PULSE_AMPLITUDE 2000
+
+#define LATENCY_DEFAULT_THRESHOLD   1024
+#define LATENCY_DEFAULT_RX_SAMPLES  4096
+#define LATENCY_CORR_INTERVAL_MS    10
+
+struct latency_test {
+    struct bladerf *dev;
+    const struct bladerf_latency_config *config;
+    int16_t *rx_buf;
+
+    pthread_mutex_t lock;
+    pthread_cond_t detected_cond;
+
+    /* Protected by `lock` */
+    bool armed;    /* A pulse is expected */
+    bool detected; /* The expected pulse has been received */
+    bool done;
+    bladerf_timestamp pulse_ts; /* RX timestamp of the pulse */
+    uint64_t returned_ns;       /* Host time at which it was returned */
+    int rx_status;
+};
+
+/* Get the index of the first sample with a component at or above the
+ * threshold, or `n` if there is none */
+static size_t find_pulse(const int16_t *samples, size_t n, int16_t threshold)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        const int16_t si = samples[2 * i];
+        const int16_t sq = samples[2 * i + 1];
+
+        if (si >= threshold || si <= -threshold || sq >= threshold ||
+            sq <= -threshold) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+static void *latency_rx_thread(void *arg)
+{
+    struct latency_test *t                    = arg;
+    const struct bladerf_latency_config *cfg  = t->config;
+    struct bladerf_metadata meta;
+    uint64_t returned_ns;
+    size_t idx;
+    bool armed;
+    int status = 0;
+
+    while (true) {
+        pthread_mutex_lock(&t->lock);
+        if (t->done) {
+            pthread_mutex_unlock(&t->lock);
+            break;
+        }
+        pthread_mutex_unlock(&t->lock);
+
+        memset(&meta, 0, sizeof(meta));
+        meta.flags = BLADERF_META_FLAG_RX_NOW;
+
+        status = bladerf_sync_rx(t->dev, t->rx_buf, cfg->rx_samples, &meta,
+                                 cfg->timeout_ms);
+        returned_ns = bladerf_get_host_time_ns();
+
+        if (status != 0) {
+            break;
+        }
+
+        pthread_mutex_lock(&t->lock);
+        armed = t->armed;
+        pthread_mutex_unlock(&t->lock);
+
+        if (!armed) {
+            continue;
+        }
+
+        idx = find_pulse(t->rx_buf, meta.actual_count, cfg->threshold);
+        if (idx == meta.actual_count) {
+            continue;
+        }
+
+        pthread_mutex_lock(&t->lock);
+        t->armed       = false;
+        t->detected    = true;
+        t->pulse_ts    = meta.timestamp + idx;
+        t->returned_ns = returned_ns;
+        pthread_cond_signal(&t->detected_cond);
+        pthread_mutex_unlock(&t->lock);
+    }
+
+    pthread_mutex_lock(&t->lock);
+    t->rx_status = status;
+    t->done      = true;
+    pthread_cond_signal(&t->detected_cond);
+    pthread_mutex_unlock(&t->lock);
+
+    return NULL;
+}
+
+/* Wait for the correlation service to fit its first model */
+static int wait_for_correlation(struct bladerf *dev, unsigned int timeout_ms)
+{
+    const uint64_t deadline =
+        bladerf_get_host_time_ns() + (uint64_t)timeout_ms * 1000000;
+    uint64_t host_ns;
+    int status;
+
+    do {
+        status = bladerf_timestamp_to_host_ns(dev, BLADERF_RX, 0, &host_ns);
+        if (status != BLADERF_ERR_WOULD_BLOCK) {
+            return status;
+        }
+
+        usleep(LATENCY_CORR_INTERVAL_MS * 1000);
+    } while (bladerf_get_host_time_ns() < deadline);
+
+    return BLADERF_ERR_TIMEOUT;
+}
+
+static void fill_dist(struct bladerf_latency_dist *d,
+                      const struct latency_hist *h)
+{
+    memset(d, 0, sizeof(*d));
+
+    if (h->count == 0) {
+        return;
+    }
+
+    d->count   = h->count;
+    d->min_ns  = h->min;
+    d->mean_ns = h->sum / h->count;
+    d->p50_ns  = latency_hist_percentile(h, 50.0);
+    d->p90_ns  = latency_hist_percentile(h, 90.0);
+    d->p99_ns  = latency_hist_percentile(h, 99.0);
+    d->max_ns  = h->max;
+}
+
+/* Transmit a pulse, and wait for it to be received */
+static int measure_once(struct latency_test *t,
+                        const int16_t *burst,
+                        struct latency_hist *host_to_rf,
+                        struct latency_hist *rf_to_host,
+                        bool *missed)
+{
+    const struct bladerf_latency_config *cfg = t->config;
+    struct bladerf_metadata meta;
+    struct timespec deadline;
+    uint64_t call_ns, rf_ns;
+    int status;
+
+    pthread_mutex_lock(&t->lock);
+    t->armed    = true;
+    t->detected = false;
+    pthread_mutex_unlock(&t->lock);
+
+    memset(&meta, 0, sizeof(meta));
+    meta.flags = BLADERF_META_FLAG_TX_BURST_START |
+                 BLADERF_META_FLAG_TX_BURST_END |
+                 BLADERF_META_FLAG_TX_NOW;
+
+    call_ns = bladerf_get_host_time_ns();
+    status  = bladerf_sync_tx(t->dev, burst, LATENCY_BURST_LEN, &meta,
+                              cfg->timeout_ms);
+    if (status != 0) {
+        return status;
+    }
+
+    if (populate_abs_timeout(&deadline, cfg->timeout_ms) != 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    pthread_mutex_lock(&t->lock);
+
+    while (!t->detected && !t->done) {
+        if (pthread_cond_timedwait(&t->detected_cond, &t->lock, &deadline) ==
+            ETIMEDOUT) {
+            break;
+        }
+    }
+
+    t->armed = false;
+    *missed  = true;
+
+    if (t->detected) {
+        status = bladerf_timestamp_to_host_ns(t->dev, BLADERF_RX, t->pulse_ts,
+                                              &rf_ns);
+
+        /* The correlation is refitted after a discontinuity in the RX
+         * timestamp, during which this pulse cannot be placed */
+        if (status == BLADERF_ERR_WOULD_BLOCK) {
+            status = 0;
+        } else if (status == 0) {
+            *missed = false;
+
+            /* The correlation is only accurate to the timestamp read's
+             * round-trip time, which may place the pulse before the call */
+            latency_hist_add(host_to_rf,
+                             rf_ns > call_ns ? rf_ns - call_ns : 0);
+            latency_hist_add(rf_to_host, t->returned_ns > rf_ns
+                                             ? t->returned_ns - rf_ns
+                                             : 0);
+        }
+    } else if (t->done) {
+        status = t->rx_status != 0 ? t->rx_status : BLADERF_ERR_UNEXPECTED;
+    }
+
+    pthread_mutex_unlock(&t->lock);
+
+    return status;
+}
+
+int bladerf_measure_latency(struct bladerf *dev,
+                            const struct bladerf_latency_config *config,
+                            struct bladerf_latency_result *result)
+{
+    struct bladerf_latency_config cfg;
+    struct latency_test t;
+    struct latency_hist *hists = NULL;
+    int16_t *burst             = NULL;
+    pthread_t rx_thread;
+    bool started_corr = false;
+    bool missed;
+    uint64_t host_ns;
+    unsigned int i;
+    int status;
+
+    if (config == NULL || result == NULL || config->iterations == 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    cfg = *config;
+    if (cfg.threshold <= 0) {
+        cfg.threshold = LATENCY_DEFAULT_THRESHOLD;
+    }
+    if (cfg.rx_samples == 0) {
+        cfg.rx_samples = LATENCY_DEFAULT_RX_SAMPLES;
+    }
+
+    memset(result, 0, sizeof(*result));
+    memset(&t, 0, sizeof(t));
+    t.dev    = dev;
+    t.config = &cfg;
+
+    hists    = calloc(2, sizeof(hists[0]));
+    burst    = calloc(LATENCY_BURST_LEN, 2 * sizeof(burst[0]));
+    t.rx_buf = malloc(cfg.rx_samples * 2 * sizeof(t.rx_buf[0]));
+    if (hists == NULL || burst == NULL || t.rx_buf == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto out;
+    }
+
+    for (i = 0; i < LATENCY_PULSE_LEN; i++) {
+        burst[2 * i] = LATENCY_PULSE_AMPLITUDE;
+    }
+
+    pthread_mutex_init(&t.lock, NULL);
+    pthread_cond_init(&t.detected_cond, NULL);
+
+    /* Receive throughout, including while the correlation is established,
+     * so that the RX timestamp counter is advancing */
+    if (pthread_create(&rx_thread, NULL, latency_rx_thread, &t) != 0) {
+        status = BLADERF_ERR_UNEXPECTED;
+        goto out_sync;
+    }
+
+    /* Use the caller's correlation service, if one is running */
+    status = bladerf_timestamp_to_host_ns(dev, BLADERF_RX, 0, &host_ns);
+    if (status == BLADERF_ERR_NOT_INIT) {
+        status = bladerf_set_timestamp_correlation(dev, BLADERF_RX,
+                                                   LATENCY_CORR_INTERVAL_MS);
+        started_corr = (status == 0);
+    }
+
+    if (status == 0 || status == BLADERF_ERR_WOULD_BLOCK) {
+        status = wait_for_correlation(dev, cfg.timeout_ms);
+    }
+
+    for (i = 0; i < cfg.iterations && status == 0; i++) {
+        status = measure_once(&t, burst, &hists[0], &hists[1], &missed);
+        if (status == 0 && missed) {
+            result->missed++;
+        }
+
+        if (status == 0 && cfg.interval_ms != 0) {
+            usleep(cfg.interval_ms * 1000);
+        }
+    }
+
+    pthread_mutex_lock(&t.lock);
+    t.done = true;
+    pthread_mutex_unlock(&t.lock);
+    pthread_join(rx_thread, NULL);
+
+    if (started_corr) {
+        bladerf_set_timestamp_correlation(dev, BLADERF_RX, 0);
+    }
+
+    fill_dist(&result->host_to_rf, &hists[0]);
+    fill_dist(&result->rf_to_host, &hists[1]);
+
+out_sync:
+    pthread_cond_destroy(&t.detected_cond);
+    pthread_mutex_destroy(&t.lock);
+
+out:
+    free(t.rx_buf);
+    free(burst);
+    free(hists);
+    return status;
+}
@@ -0,0 +1,253 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libbladeRF.h>
+
+#include "log.h"
+
+#include "helpers/wallclock.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define LINK_TEST_SSE2
+#endif
+
+/* With BLADERF_RX_MUX_32BIT_COUNTER, each SC16 Q11 sample read is a 32-bit
+ * little-endian word, incremented by one per sample. */
+
+#define LINK_TEST_BUFFERS       32
+#define LINK_TEST_BUFFER_SIZE   32768
+#define LINK_TEST_TRANSFERS     16
+#define LINK_TEST_TIMEOUT_MS    3500
+
+struct counter_check {
+    uint32_t expected;
+    bool started;
+    uint64_t index; /* Index of the next sample to be checked */
+    struct bladerf_link_test_result *result;
+};
+
+static void record_gap(struct counter_check *c, size_t i, uint32_t got)
+{
+    struct bladerf_link_test_result *r = c->result;
+    uint32_t delta = got - c->expected;
+
+    if (r->num_gaps < BLADERF_LINK_TEST_MAX_GAPS) {
+        struct bladerf_link_test_gap *g = &r->gap[r->num_gaps++];
+        g->sample   = c->index + i;
+        g->expected = c->expected;
+        g->received = got;
+    }
+
+    r->gaps++;
+
+    /* A counter that stepped backwards (or jumped by more than half its
+     * range) is not a run of dropped samples; count only the gap */
+    if (delta < UINT32_C(0x80000000)) {
+        r->dropped += delta;
+    }
+}
+
+/* Check the `len` words starting at word `start`, one at a time */
+static void check_scalar(struct counter_check *c,
+                         const uint32_t *buf,
+                         size_t start,
+                         size_t len)
+{
+    size_t k;
+
+    for (k = 0; k < len; k++) {
+        const size_t i = start + k;
+
+        if (buf[i] != c->expected) {
+            record_gap(c, i, buf[i]);
+        }
+        c->expected = buf[i] + 1;
+    }
+}
+
+#ifdef LINK_TEST_SSE2
+/* Compare 8 words per iteration against a vector of the expected counter
+ * values. On a mismatch, the 8 words are rechecked with check_scalar(), which
+ * records the gap and resynchronizes the expected value.
+ *
+ * Returns the number of words consumed, a multiple of 8. */
+static size_t check_sse2(struct counter_check *c, const uint32_t *buf, size_t n)
+{
+    const __m128i step = _mm_set1_epi32(8);
+    __m128i exp_lo, exp_hi;
+    size_t i = 0;
+
+    exp_lo = _mm_add_epi32(_mm_set1_epi32((int32_t)c->expected),
+                           _mm_set_epi32(3, 2, 1, 0));
+    exp_hi = _mm_add_epi32(exp_lo, _mm_set1_epi32(4));
+
+    while (n - i >= 8) {
+        const __m128i lo = _mm_loadu_si128((const __m128i *)&buf[i]);
+        const __m128i hi = _mm_loadu_si128((const __m128i *)&buf[i + 4]);
+        const __m128i eq = _mm_and_si128(_mm_cmpeq_epi32(lo, exp_lo),
+                                         _mm_cmpeq_epi32(hi, exp_hi));
+
+        if (_mm_movemask_epi8(eq) == 0xffff) {
+            exp_lo = _mm_add_epi32(exp_lo, step);
+            exp_hi = _mm_add_epi32(exp_hi, step);
+            c->expected += 8;
+        } else {
+            check_scalar(c, buf, i, 8);
+            exp_lo = _mm_add_epi32(_mm_set1_epi32((int32_t)c->expected),
+                                   _mm_set_epi32(3, 2, 1, 0));
+            exp_hi = _mm_add_epi32(exp_lo, _mm_set1_epi32(4));
+        }
+
+        i += 8;
+    }
+
+    return i;
+}
+#endif
+
+static void check_counter(struct counter_check *c,
+                          const uint32_t *buf,
+                          size_t n)
+{
+    size_t i = 0;
+
+    if (n == 0) {
+        return;
+    }
+
+    /* The counter's starting value is arbitrary */
+    if (!c->started) {
+        c->expected = buf[0];
+        c->started  = true;
+    }
+
+#ifdef LINK_TEST_SSE2
+    i = check_sse2(c, buf, n);
+#endif
+
+    /* The vector loop consumes at most n words */
+    check_scalar(c, buf, i, n - i);
+
+    c->index += n;
+}
+
+int bladerf_link_test(struct bladerf *dev,
+                      unsigned int duration_ms,
+                      struct bladerf_link_test_result *result)
+{
+    struct counter_check check;
+    bladerf_rx_mux mux;
+    uint32_t *buf;
+    uint64_t start, now, end;
+    int status;
+    int restore_status;
+
+    if (result == NULL || duration_ms == 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    memset(result, 0, sizeof(*result));
+    memset(&check, 0, sizeof(check));
+    check.result = result;
+
+    buf = malloc(LINK_TEST_BUFFER_SIZE * sizeof(buf[0]));
+    if (buf == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    status = bladerf_get_rx_mux(dev, &mux);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = bladerf_set_rx_mux(dev, BLADERF_RX_MUX_32BIT_COUNTER);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = bladerf_sync_config(dev, BLADERF_RX_X1, BLADERF_FORMAT_SC16_Q11,
+                                 LINK_TEST_BUFFERS, LINK_TEST_BUFFER_SIZE,
+                                 LINK_TEST_TRANSFERS, LINK_TEST_TIMEOUT_MS);
+    if (status != 0) {
+        goto out_mux;
+    }
+
+    status = bladerf_enable_module(dev, BLADERF_CHANNEL_RX(0), true);
+    if (status != 0) {
+        goto out_mux;
+    }
+
+    /* Discard the first buffer, which may hold samples queued before the
+     * mux was switched */
+    status = bladerf_sync_rx(dev, buf, LINK_TEST_BUFFER_SIZE, NULL,
+                             LINK_TEST_TIMEOUT_MS);
+    if (status != 0) {
+        goto out_module;
+    }
+
+    start = wallclock_get_monotonic_nsec();
+    end   = start + (uint64_t)duration_ms * 1000000;
+    now   = start;
+
+    do {
+        status = bladerf_sync_rx(dev, buf, LINK_TEST_BUFFER_SIZE, NULL,
+                                 LINK_TEST_TIMEOUT_MS);
+        if (status != 0) {
+            log_debug("%s: RX failed after %" PRIu64 " samples: %s\n",
+                      __FUNCTION__, check.index, bladerf_strerror(status));
+            break;
+        }
+
+        check_counter(&check, buf, LINK_TEST_BUFFER_SIZE);
+        now = wallclock_get_monotonic_nsec();
+    } while (now < end);
+
+    /* Report what was checked, even if RX failed part way through */
+    result->samples = check.index;
+    result->seconds = (now - start) / 1e9;
+    if (now > start) {
+        result->throughput = result->samples / result->seconds;
+    }
+
+out_module:
+    restore_status = bladerf_enable_module(dev, BLADERF_CHANNEL_RX(0), false);
+    if (status == 0) {
+        status = restore_status;
+    }
+
+out_mux:
+    restore_status = bladerf_set_rx_mux(dev, mux);
+    if (status == 0) {
+        status = restore_status;
+    }
+
+out:
+    free(buf);
+    return status;
+}
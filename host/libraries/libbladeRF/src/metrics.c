@@ -0,0 +1,463 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <libbladeRF.h>
+
+#include "log.h"
+
+#include "board/board.h"
+#include "metrics.h"
+
+#if defined(WIN32) || defined(__CYGWIN__)
+
+int bladerf_enable_metrics(struct bladerf *dev,
+                           const char *name,
+                           unsigned int interval_ms)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+int bladerf_read_metrics(const char *name, struct bladerf_metrics *metrics)
+{
+    return BLADERF_ERR_UNSUPPORTED;
+}
+
+void metrics_stop(struct metrics *metrics)
+{
+}
+
+#else
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "helpers/timeout.h"
+#include "helpers/wallclock.h"
+
+#define METRICS_MAGIC 0x424c444d /* "BLDM" */
+#define METRICS_VERSION 1
+
+#define METRICS_NAME_MAX 80
+
+/* The shared memory object. The snapshot is published under a sequence
+ * count, which is odd while it is being written and 0 until the first one,
+ * so that readers copy it without taking any lock. */
+struct metrics_region {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t metrics_size;
+    int32_t publisher_pid;
+    uint64_t seq;
+    struct bladerf_metrics metrics;
+};
+
+struct metrics {
+    struct bladerf *dev;
+    char shm_name[METRICS_NAME_MAX];
+    unsigned int interval_ms;
+    struct metrics_region *region;
+    struct bladerf_metrics snapshot; /* Being gathered */
+    pthread_t thread;
+
+    pthread_mutex_t lock; /* Protects `stop` */
+    pthread_cond_t stop_cond;
+    bool stop;
+};
+
+static int metrics_shm_name(char *buf, size_t len, const char *name)
+{
+    int n;
+
+    /* The name forms a single path component */
+    if (name[0] == '\0' || strchr(name, '/') != NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    n = snprintf(buf, len, "/bladerf-metrics-%s", name);
+    if (n < 0 || (size_t)n >= len) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return 0;
+}
+
+static bool process_alive(pid_t pid)
+{
+    return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+/* Remove an existing object of this name if its publisher has died */
+static void remove_stale(const char *shm_name)
+{
+    struct metrics_region region;
+    int fd;
+
+    fd = shm_open(shm_name, O_RDONLY, 0);
+    if (fd < 0) {
+        return;
+    }
+
+    if (pread(fd, &region, sizeof(region), 0) == (ssize_t)sizeof(region) &&
+        region.magic == METRICS_MAGIC &&
+        !process_alive(region.publisher_pid)) {
+        log_debug("Removing stale metrics %s of pid %d\n", shm_name,
+                  region.publisher_pid);
+        shm_unlink(shm_name);
+    }
+
+    close(fd);
+}
+
+/* Gather a snapshot. As for the telemetry sampler, the device lock is taken
+ * normally rather than via dev_lock_urgent(), and only for one item at a
+ * time, so that gathering holds up nothing else. */
+static void gather(struct metrics *m, struct bladerf_metrics *s)
+{
+    struct bladerf *dev = m->dev;
+    float temperature;
+    bool fpga;
+
+    MUTEX_LOCK(&dev->lock);
+    if (dev->sync_format_valid[BLADERF_RX] &&
+        dev->board->get_stream_stats(dev, BLADERF_RX, &s->rx) == 0) {
+        s->valid |= BLADERF_METRICS_RX_STREAM;
+    }
+    MUTEX_UNLOCK(&dev->lock);
+
+    MUTEX_LOCK(&dev->lock);
+    if (dev->sync_format_valid[BLADERF_TX] &&
+        dev->board->get_stream_stats(dev, BLADERF_TX, &s->tx) == 0) {
+        s->valid |= BLADERF_METRICS_TX_STREAM;
+    }
+    MUTEX_UNLOCK(&dev->lock);
+
+    MUTEX_LOCK(&dev->lock);
+    if (dev->backend->get_control_stats != NULL &&
+        dev->backend->get_control_stats(dev, &s->control) == 0) {
+        s->valid |= BLADERF_METRICS_CONTROL;
+    }
+    MUTEX_UNLOCK(&dev->lock);
+
+    /* The rest needs the FPGA, and would log errors each time without it */
+    MUTEX_LOCK(&dev->lock);
+    fpga = dev->board->is_fpga_configured(dev) > 0;
+    if (fpga && dev->board->get_retune_queue_status(
+                    dev, BLADERF_CHANNEL_RX(0), &s->retune[BLADERF_RX]) == 0) {
+        s->valid |= BLADERF_METRICS_RX_RETUNE;
+    }
+    if (fpga && dev->board->get_retune_queue_status(
+                    dev, BLADERF_CHANNEL_TX(0), &s->retune[BLADERF_TX]) == 0) {
+        s->valid |= BLADERF_METRICS_TX_RETUNE;
+    }
+    MUTEX_UNLOCK(&dev->lock);
+
+    /* This takes the device lock itself, unless the telemetry sampler has
+     * the temperature already */
+    if (fpga && strcmp(s->board, "bladerf2") == 0 &&
+        bladerf_get_rfic_temperature(dev, &temperature) == 0) {
+        s->rfic_temperature = temperature;
+        s->valid |= BLADERF_METRICS_TEMPERATURE;
+    }
+}
+
+static void publish(struct metrics_region *r, struct bladerf_metrics const *s)
+{
+    const uint64_t seq = __atomic_load_n(&r->seq, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&r->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    memcpy(&r->metrics, s, sizeof(r->metrics));
+
+    __atomic_store_n(&r->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+static void *metrics_task(void *arg)
+{
+    struct metrics *m = arg;
+    struct bladerf_metrics *s = &m->snapshot;
+    struct timespec deadline;
+    uint64_t updates = 0;
+    int status;
+
+    pthread_mutex_lock(&m->lock);
+
+    while (!m->stop) {
+        pthread_mutex_unlock(&m->lock);
+
+        /* The identity fields carry over from the last snapshot */
+        s->valid = 0;
+        gather(m, s);
+
+        s->host_ns = wallclock_get_monotonic_nsec();
+        s->updates = ++updates;
+        publish(m->region, s);
+
+        pthread_mutex_lock(&m->lock);
+
+        if (populate_abs_timeout(&deadline, m->interval_ms) != 0) {
+            break;
+        }
+
+        status = 0;
+        while (!m->stop && status != ETIMEDOUT) {
+            status = pthread_cond_timedwait(&m->stop_cond, &m->lock, &deadline);
+        }
+    }
+
+    pthread_mutex_unlock(&m->lock);
+
+    return NULL;
+}
+
+static int metrics_start(struct metrics **metrics,
+                         struct bladerf *dev,
+                         const char *name,
+                         unsigned int interval_ms)
+{
+    struct metrics *m;
+    struct metrics_region *region = NULL;
+    struct bladerf_serial sn;
+    const char *board;
+    int fd;
+    int status;
+
+    status = bladerf_get_serial_struct(dev, &sn);
+    if (status != 0) {
+        return status;
+    }
+
+    if (name == NULL) {
+        name = sn.serial;
+    }
+
+    m = calloc(1, sizeof(*m));
+    if (m == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    status = metrics_shm_name(m->shm_name, sizeof(m->shm_name), name);
+    if (status != 0) {
+        free(m);
+        return status;
+    }
+
+    m->dev         = dev;
+    m->interval_ms = interval_ms;
+
+    board = bladerf_get_board_name(dev);
+    m->snapshot.interval_ms = interval_ms;
+    snprintf(m->snapshot.serial, sizeof(m->snapshot.serial), "%s", sn.serial);
+    snprintf(m->snapshot.board, sizeof(m->snapshot.board), "%s",
+             board != NULL ? board : "");
+
+    remove_stale(m->shm_name);
+
+    fd = shm_open(m->shm_name, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        log_debug("Failed to create %s: %s\n", m->shm_name, strerror(errno));
+        free(m);
+        return BLADERF_ERR_IO;
+    }
+
+    if (ftruncate(fd, (off_t)sizeof(*region)) != 0) {
+        log_debug("Failed to size %s: %s\n", m->shm_name, strerror(errno));
+        status = BLADERF_ERR_IO;
+    } else {
+        region = mmap(NULL, sizeof(*region), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+        if (region == MAP_FAILED) {
+            region = NULL;
+            status = BLADERF_ERR_MEM;
+        }
+    }
+
+    close(fd);
+
+    if (status != 0) {
+        goto error_unlink;
+    }
+
+    m->region = region;
+
+    region->version       = METRICS_VERSION;
+    region->metrics_size  = sizeof(region->metrics);
+    region->publisher_pid = (int32_t)getpid();
+
+    pthread_mutex_init(&m->lock, NULL);
+    pthread_cond_init(&m->stop_cond, NULL);
+
+    if (pthread_create(&m->thread, NULL, metrics_task, m) != 0) {
+        status = BLADERF_ERR_UNEXPECTED;
+        goto error_sync;
+    }
+
+    /* Readers check this last, so they never see a partially initialized
+     * header */
+    __atomic_store_n(&region->magic, METRICS_MAGIC, __ATOMIC_RELEASE);
+
+    *metrics = m;
+    return 0;
+
+error_sync:
+    pthread_cond_destroy(&m->stop_cond);
+    pthread_mutex_destroy(&m->lock);
+    munmap(region, sizeof(*region));
+error_unlink:
+    shm_unlink(m->shm_name);
+    free(m);
+    return status;
+}
+
+void metrics_stop(struct metrics *m)
+{
+    if (m == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&m->lock);
+    m->stop = true;
+    pthread_cond_signal(&m->stop_cond);
+    pthread_mutex_unlock(&m->lock);
+
+    pthread_join(m->thread, NULL);
+
+    /* Readers map the object only for the duration of a read */
+    shm_unlink(m->shm_name);
+    munmap(m->region, sizeof(*m->region));
+
+    pthread_cond_destroy(&m->stop_cond);
+    pthread_mutex_destroy(&m->lock);
+    free(m);
+}
+
+int bladerf_enable_metrics(struct bladerf *dev,
+                           const char *name,
+                           unsigned int interval_ms)
+{
+    struct metrics *metrics = NULL;
+    int status              = 0;
+
+    if (dev == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->metrics_lock);
+
+    metrics_stop(dev->metrics);
+    dev->metrics = NULL;
+
+    if (interval_ms != 0) {
+        status = metrics_start(&metrics, dev, name, interval_ms);
+        if (status == 0) {
+            dev->metrics = metrics;
+        }
+    }
+
+    MUTEX_UNLOCK(&dev->metrics_lock);
+
+    return status;
+}
+
+int bladerf_read_metrics(const char *name, struct bladerf_metrics *metrics)
+{
+    const struct metrics_region *region;
+    char shm_name[METRICS_NAME_MAX];
+    struct stat st;
+    uint64_t seq;
+    int fd;
+    int status;
+
+    if (name == NULL || metrics == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = metrics_shm_name(shm_name, sizeof(shm_name), name);
+    if (status != 0) {
+        return status;
+    }
+
+    fd = shm_open(shm_name, O_RDONLY, 0);
+    if (fd < 0) {
+        return (errno == EACCES) ? BLADERF_ERR_PERMISSION : BLADERF_ERR_NODEV;
+    }
+
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(*region)) {
+        close(fd);
+        return BLADERF_ERR_NODEV;
+    }
+
+    region = mmap(NULL, sizeof(*region), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (region == MAP_FAILED) {
+        return BLADERF_ERR_MEM;
+    }
+
+    if (__atomic_load_n(&region->magic, __ATOMIC_ACQUIRE) != METRICS_MAGIC ||
+        !process_alive(region->publisher_pid)) {
+        status = BLADERF_ERR_NODEV;
+    } else if (region->version != METRICS_VERSION ||
+               region->metrics_size != sizeof(*metrics)) {
+        log_debug("%s is from an incompatible libbladeRF\n", shm_name);
+        status = BLADERF_ERR_UNSUPPORTED;
+    } else {
+        while (true) {
+            seq = __atomic_load_n(&region->seq, __ATOMIC_ACQUIRE);
+
+            if (seq == 0) {
+                status = BLADERF_ERR_WOULD_BLOCK;
+                break;
+            }
+
+            if ((seq & 1) == 0) {
+                memcpy(metrics, (const void *)&region->metrics,
+                       sizeof(*metrics));
+
+                /* The copy must be complete before the count is checked
+                 * again */
+                __atomic_thread_fence(__ATOMIC_ACQUIRE);
+                if (__atomic_load_n(&region->seq, __ATOMIC_RELAXED) == seq) {
+                    break;
+                }
+            }
+
+            sched_yield();
+        }
+    }
+
+    munmap((void *)region, sizeof(*region));
+
+    return status;
+}
+
+#endif
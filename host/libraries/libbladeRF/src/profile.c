@@ -0,0 +1,616 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <libbladeRF.h>
+
+#include "log.h"
+#include "rel_assert.h"
+
+#include "board/board.h"
+
+/* Profiles are serialized field by field, least significant byte first, so
+ * that they may be saved to a file and loaded on another host.
+ *
+ * Header:
+ *   magic[5], version u8, board name[16], serial[33], flags u8, trim DAC u16,
+ *   channel count u8
+ *
+ * Each channel:
+ *   channel u8, flags u16, frequency u64, quick tune (freqsel u8, vcocap u8,
+ *   nint u16, nfrac u32, flags u8, xb_gpio u8), sample rate (integer u64,
+ *   num u64, den u64), bandwidth u32, RF port[16], gain mode u32,
+ *   stage count u8, stages (name[16], gain u32) * PROFILE_MAX_STAGES,
+ *   corrections (DC I, DC Q, phase, gain) u16 * 4
+ *
+ * Fields whose flag is clear were not supported by the device, and are
+ * ignored on load. */
+
+#define PROFILE_MAGIC "BRFP"
+#define PROFILE_VERSION 1
+
+#define PROFILE_NAME_LEN 16
+#define PROFILE_MAX_CHANNELS 4
+#define PROFILE_MAX_STAGES 8
+
+#define PROFILE_HAVE_TRIM_DAC (1 << 0)
+
+#define PROFILE_HAVE_FREQUENCY (1 << 0)
+#define PROFILE_HAVE_QUICK_TUNE (1 << 1)
+#define PROFILE_HAVE_SAMPLERATE (1 << 2)
+#define PROFILE_HAVE_BANDWIDTH (1 << 3)
+#define PROFILE_HAVE_PORT (1 << 4)
+#define PROFILE_HAVE_GAIN_MODE (1 << 5)
+#define PROFILE_HAVE_CORR(i) (1 << (6 + (i)))
+
+static const bladerf_correction corrections[] = {
+    BLADERF_CORR_DCOFF_I,
+    BLADERF_CORR_DCOFF_Q,
+    BLADERF_CORR_PHASE,
+    BLADERF_CORR_GAIN,
+};
+
+#define NUM_CORRECTIONS (sizeof(corrections) / sizeof(corrections[0]))
+
+struct profile_stage {
+    char name[PROFILE_NAME_LEN];
+    bladerf_gain gain;
+};
+
+struct profile_channel {
+    bladerf_channel ch;
+    uint16_t flags;
+
+    bladerf_frequency frequency;
+    struct bladerf_quick_tune quick_tune;
+    struct bladerf_rational_rate samplerate;
+    bladerf_bandwidth bandwidth;
+    char port[PROFILE_NAME_LEN];
+    bladerf_gain_mode gain_mode;
+
+    unsigned int num_stages;
+    struct profile_stage stages[PROFILE_MAX_STAGES];
+
+    bladerf_correction_value corr[NUM_CORRECTIONS];
+};
+
+struct profile {
+    char board[PROFILE_NAME_LEN];
+    char serial[BLADERF_SERIAL_LENGTH];
+    uint8_t flags;
+    uint16_t trim_dac;
+
+    unsigned int num_channels;
+    struct profile_channel channels[PROFILE_MAX_CHANNELS];
+};
+
+/* Cursor into a serialized profile */
+struct blob {
+    uint8_t *buf;
+    size_t len;
+    size_t pos;
+    bool overrun;
+};
+
+/******************************************************************************/
+/* Serialization */
+/******************************************************************************/
+
+/* Copy a NUL-terminated string, truncating it to fit `size` bytes */
+static void copy_str(char *dst, const char *src, size_t size)
+{
+    size_t n = strlen(src);
+
+    if (n > size - 1) {
+        n = size - 1;
+    }
+
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+}
+
+static void put_uint(struct blob *b, uint64_t val, size_t width)
+{
+    size_t i;
+
+    if (b->pos + width > b->len) {
+        b->overrun = true;
+        return;
+    }
+
+    for (i = 0; i < width; i++) {
+        b->buf[b->pos++] = (uint8_t)(val >> (8 * i));
+    }
+}
+
+static uint64_t get_uint(struct blob *b, size_t width)
+{
+    uint64_t val = 0;
+    size_t i;
+
+    if (b->pos + width > b->len) {
+        b->overrun = true;
+        return 0;
+    }
+
+    for (i = 0; i < width; i++) {
+        val |= (uint64_t)b->buf[b->pos++] << (8 * i);
+    }
+
+    return val;
+}
+
+static void put_str(struct blob *b, const char *str, size_t width)
+{
+    if (b->pos + width > b->len) {
+        b->overrun = true;
+        return;
+    }
+
+    memset(&b->buf[b->pos], 0, width);
+    copy_str((char *)&b->buf[b->pos], str, width);
+    b->pos += width;
+}
+
+static void get_str(struct blob *b, char *str, size_t width)
+{
+    if (b->pos + width > b->len) {
+        b->overrun = true;
+        str[0] = '\0';
+        return;
+    }
+
+    memcpy(str, &b->buf[b->pos], width);
+    str[width - 1] = '\0';
+    b->pos += width;
+}
+
+static void serialize(struct blob *b, const struct profile *p)
+{
+    unsigned int i, j;
+
+    put_str(b, PROFILE_MAGIC, sizeof(PROFILE_MAGIC));
+    put_uint(b, PROFILE_VERSION, 1);
+    put_str(b, p->board, PROFILE_NAME_LEN);
+    put_str(b, p->serial, BLADERF_SERIAL_LENGTH);
+    put_uint(b, p->flags, 1);
+    put_uint(b, p->trim_dac, 2);
+    put_uint(b, p->num_channels, 1);
+
+    for (i = 0; i < p->num_channels; i++) {
+        const struct profile_channel *c = &p->channels[i];
+
+        put_uint(b, (uint64_t)c->ch, 1);
+        put_uint(b, c->flags, 2);
+        put_uint(b, c->frequency, 8);
+
+        put_uint(b, c->quick_tune.freqsel, 1);
+        put_uint(b, c->quick_tune.vcocap, 1);
+        put_uint(b, c->quick_tune.nint, 2);
+        put_uint(b, c->quick_tune.nfrac, 4);
+        put_uint(b, c->quick_tune.flags, 1);
+        put_uint(b, c->quick_tune.xb_gpio, 1);
+
+        put_uint(b, c->samplerate.integer, 8);
+        put_uint(b, c->samplerate.num, 8);
+        put_uint(b, c->samplerate.den, 8);
+        put_uint(b, c->bandwidth, 4);
+        put_str(b, c->port, PROFILE_NAME_LEN);
+        put_uint(b, (uint64_t)c->gain_mode, 4);
+
+        put_uint(b, c->num_stages, 1);
+        for (j = 0; j < PROFILE_MAX_STAGES; j++) {
+            put_str(b, c->stages[j].name, PROFILE_NAME_LEN);
+            put_uint(b, (uint32_t)c->stages[j].gain, 4);
+        }
+
+        for (j = 0; j < NUM_CORRECTIONS; j++) {
+            put_uint(b, (uint16_t)c->corr[j], 2);
+        }
+    }
+}
+
+static int deserialize(struct blob *b, struct profile *p)
+{
+    char magic[sizeof(PROFILE_MAGIC)];
+    unsigned int version;
+    unsigned int i, j;
+
+    memset(p, 0, sizeof(*p));
+
+    get_str(b, magic, sizeof(magic));
+    version = (unsigned int)get_uint(b, 1);
+
+    if (b->overrun || strcmp(magic, PROFILE_MAGIC) != 0) {
+        log_debug("%s: not a device profile\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (version != PROFILE_VERSION) {
+        log_debug("%s: unsupported profile version %u\n", __FUNCTION__,
+                  version);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    get_str(b, p->board, PROFILE_NAME_LEN);
+    get_str(b, p->serial, BLADERF_SERIAL_LENGTH);
+    p->flags        = (uint8_t)get_uint(b, 1);
+    p->trim_dac     = (uint16_t)get_uint(b, 2);
+    p->num_channels = (unsigned int)get_uint(b, 1);
+
+    if (p->num_channels > PROFILE_MAX_CHANNELS) {
+        log_debug("%s: invalid channel count\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    for (i = 0; i < p->num_channels; i++) {
+        struct profile_channel *c = &p->channels[i];
+
+        c->ch        = (bladerf_channel)get_uint(b, 1);
+        c->flags     = (uint16_t)get_uint(b, 2);
+        c->frequency = get_uint(b, 8);
+
+        c->quick_tune.freqsel = (uint8_t)get_uint(b, 1);
+        c->quick_tune.vcocap  = (uint8_t)get_uint(b, 1);
+        c->quick_tune.nint    = (uint16_t)get_uint(b, 2);
+        c->quick_tune.nfrac   = (uint32_t)get_uint(b, 4);
+        c->quick_tune.flags   = (uint8_t)get_uint(b, 1);
+        c->quick_tune.xb_gpio = (uint8_t)get_uint(b, 1);
+
+        c->samplerate.integer = get_uint(b, 8);
+        c->samplerate.num     = get_uint(b, 8);
+        c->samplerate.den     = get_uint(b, 8);
+        c->bandwidth          = (bladerf_bandwidth)get_uint(b, 4);
+        get_str(b, c->port, PROFILE_NAME_LEN);
+        c->gain_mode = (bladerf_gain_mode)get_uint(b, 4);
+
+        c->num_stages = (unsigned int)get_uint(b, 1);
+        for (j = 0; j < PROFILE_MAX_STAGES; j++) {
+            get_str(b, c->stages[j].name, PROFILE_NAME_LEN);
+            c->stages[j].gain = (bladerf_gain)(int32_t)get_uint(b, 4);
+        }
+
+        for (j = 0; j < NUM_CORRECTIONS; j++) {
+            c->corr[j] = (bladerf_correction_value)(int16_t)get_uint(b, 2);
+        }
+
+        if (c->num_stages > PROFILE_MAX_STAGES) {
+            log_debug("%s: invalid gain stage count\n", __FUNCTION__);
+            return BLADERF_ERR_INVAL;
+        }
+    }
+
+    if (b->overrun) {
+        log_debug("%s: profile is truncated\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/* Capture and restore */
+/******************************************************************************/
+
+static bool is_bladerf1(const struct profile *p)
+{
+    return strcmp(p->board, "bladerf1") == 0;
+}
+
+static void capture_channel(struct bladerf *dev,
+                            const struct profile *p,
+                            struct profile_channel *c)
+{
+    const char *names[PROFILE_MAX_STAGES];
+    const char *port;
+    int count;
+    unsigned int i;
+
+    if (bladerf_get_frequency(dev, c->ch, &c->frequency) == 0) {
+        c->flags |= PROFILE_HAVE_FREQUENCY;
+
+        /* On the bladeRF 2.0 micro, quick tunes are fast lock profiles held
+         * in the FPGA only for the life of the device handle, and each
+         * request consumes one of a limited number. Those of the bladeRF1
+         * are plain LMS register values. */
+        if (is_bladerf1(p) &&
+            bladerf_get_quick_tune(dev, c->ch, &c->quick_tune) == 0) {
+            c->flags |= PROFILE_HAVE_QUICK_TUNE;
+        }
+    }
+
+    if (bladerf_get_rational_sample_rate(dev, c->ch, &c->samplerate) == 0) {
+        c->flags |= PROFILE_HAVE_SAMPLERATE;
+    }
+
+    if (bladerf_get_bandwidth(dev, c->ch, &c->bandwidth) == 0) {
+        c->flags |= PROFILE_HAVE_BANDWIDTH;
+    }
+
+    if (bladerf_get_rf_port(dev, c->ch, &port) == 0 && port != NULL) {
+        copy_str(c->port, port, sizeof(c->port));
+        c->flags |= PROFILE_HAVE_PORT;
+    }
+
+    if (!BLADERF_CHANNEL_IS_TX(c->ch) &&
+        bladerf_get_gain_mode(dev, c->ch, &c->gain_mode) == 0) {
+        c->flags |= PROFILE_HAVE_GAIN_MODE;
+    }
+
+    count = bladerf_get_gain_stages(dev, c->ch, names, PROFILE_MAX_STAGES);
+    if (count > PROFILE_MAX_STAGES) {
+        count = PROFILE_MAX_STAGES;
+    }
+
+    for (i = 0; count > 0 && i < (unsigned int)count; i++) {
+        struct profile_stage *s = &c->stages[c->num_stages];
+
+        if (bladerf_get_gain_stage(dev, c->ch, names[i], &s->gain) == 0) {
+            copy_str(s->name, names[i], sizeof(s->name));
+            c->num_stages++;
+        }
+    }
+
+    for (i = 0; i < NUM_CORRECTIONS; i++) {
+        if (bladerf_get_correction(dev, c->ch, corrections[i], &c->corr[i]) ==
+            0) {
+            c->flags |= PROFILE_HAVE_CORR(i);
+        }
+    }
+}
+
+static int capture(struct bladerf *dev, struct profile *p)
+{
+    static const bladerf_direction dirs[] = { BLADERF_RX, BLADERF_TX };
+    const char *board;
+    size_t d, i, n;
+
+    memset(p, 0, sizeof(*p));
+
+    board = bladerf_get_board_name(dev);
+    copy_str(p->board, board, sizeof(p->board));
+    copy_str(p->serial, dev->ident.serial, sizeof(p->serial));
+
+    if (bladerf_trim_dac_read(dev, &p->trim_dac) == 0) {
+        p->flags |= PROFILE_HAVE_TRIM_DAC;
+    }
+
+    for (d = 0; d < sizeof(dirs) / sizeof(dirs[0]); d++) {
+        n = bladerf_get_channel_count(dev, dirs[d]);
+
+        for (i = 0; i < n; i++) {
+            struct profile_channel *c;
+
+            if (p->num_channels >= PROFILE_MAX_CHANNELS) {
+                log_debug("%s: too many channels\n", __FUNCTION__);
+                return BLADERF_ERR_UNSUPPORTED;
+            }
+
+            c     = &p->channels[p->num_channels++];
+            c->ch = (dirs[d] == BLADERF_RX) ? BLADERF_CHANNEL_RX(i)
+                                            : BLADERF_CHANNEL_TX(i);
+
+            capture_channel(dev, p, c);
+        }
+    }
+
+    return 0;
+}
+
+static int restore_channel(struct bladerf *dev,
+                           const struct profile *p,
+                           const struct profile_channel *c)
+{
+    struct bladerf_rational_rate rate;
+    unsigned int i;
+    int status;
+
+    /* Set up the sample rate and filters before tuning, so that the tune
+     * isn't repeated to account for them */
+    if (c->flags & PROFILE_HAVE_SAMPLERATE) {
+        rate   = c->samplerate;
+        status = bladerf_set_rational_sample_rate(dev, c->ch, &rate, NULL);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    if (c->flags & PROFILE_HAVE_BANDWIDTH) {
+        status = bladerf_set_bandwidth(dev, c->ch, c->bandwidth, NULL);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    if (c->flags & PROFILE_HAVE_PORT) {
+        status = bladerf_set_rf_port(dev, c->ch, c->port);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    if (c->flags & PROFILE_HAVE_FREQUENCY) {
+        status = BLADERF_ERR_UNSUPPORTED;
+
+        /* Quick tunes are only valid for the device they were taken on */
+        if ((c->flags & PROFILE_HAVE_QUICK_TUNE) &&
+            strcmp(p->serial, dev->ident.serial) == 0) {
+            struct bladerf_quick_tune qt = c->quick_tune;
+
+            status = bladerf_schedule_retune(dev, c->ch, BLADERF_RETUNE_NOW,
+                                             c->frequency, &qt);
+        }
+
+        if (status == BLADERF_ERR_UNSUPPORTED) {
+            status = bladerf_set_frequency(dev, c->ch, c->frequency);
+        }
+
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    if (c->flags & PROFILE_HAVE_GAIN_MODE) {
+        status = bladerf_set_gain_mode(dev, c->ch, c->gain_mode);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    /* Gains are left to the AGC when it was in use */
+    if (!(c->flags & PROFILE_HAVE_GAIN_MODE) ||
+        c->gain_mode == BLADERF_GAIN_MGC) {
+        for (i = 0; i < c->num_stages; i++) {
+            status = bladerf_set_gain_stage(dev, c->ch, c->stages[i].name,
+                                            c->stages[i].gain);
+            if (status != 0) {
+                return status;
+            }
+        }
+    }
+
+    for (i = 0; i < NUM_CORRECTIONS; i++) {
+        if (c->flags & PROFILE_HAVE_CORR(i)) {
+            status =
+                bladerf_set_correction(dev, c->ch, corrections[i], c->corr[i]);
+            if (status != 0) {
+                return status;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int restore(struct bladerf *dev, const struct profile *p)
+{
+    unsigned int i;
+    int status;
+
+    if (p->flags & PROFILE_HAVE_TRIM_DAC) {
+        status = bladerf_trim_dac_write(dev, p->trim_dac);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    for (i = 0; i < p->num_channels; i++) {
+        status = restore_channel(dev, p, &p->channels[i]);
+        if (status != 0) {
+            log_debug("%s: failed to restore channel %d: %s\n", __FUNCTION__,
+                      p->channels[i].ch, bladerf_strerror(status));
+            return status;
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/* Public API */
+/******************************************************************************/
+
+int bladerf_save_profile(struct bladerf *dev, void *buf, size_t *len)
+{
+    struct profile p;
+    struct blob b;
+    int status;
+
+    if (buf == NULL || len == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = capture(dev, &p);
+    if (status != 0) {
+        return status;
+    }
+
+    b.buf     = buf;
+    b.len     = *len;
+    b.pos     = 0;
+    b.overrun = false;
+
+    serialize(&b, &p);
+
+    if (b.overrun) {
+        log_debug("%s: buffer is too small\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    assert(b.pos <= BLADERF_PROFILE_MAX_LEN);
+    *len = b.pos;
+
+    return 0;
+}
+
+int bladerf_load_profile(struct bladerf *dev, const void *buf, size_t len)
+{
+    struct profile p;
+    struct blob b;
+    unsigned int i;
+    int status, commit_status;
+
+    if (buf == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* The blob is only read from */
+    b.buf     = (uint8_t *)buf;
+    b.len     = len;
+    b.pos     = 0;
+    b.overrun = false;
+
+    status = deserialize(&b, &p);
+    if (status != 0) {
+        return status;
+    }
+
+    if (strcmp(p.board, bladerf_get_board_name(dev)) != 0) {
+        log_debug("%s: profile was saved from a %s\n", __FUNCTION__, p.board);
+        return BLADERF_ERR_INVAL;
+    }
+
+    for (i = 0; i < p.num_channels; i++) {
+        bladerf_channel ch    = p.channels[i].ch;
+        bladerf_direction dir = BLADERF_CHANNEL_IS_TX(ch) ? BLADERF_TX
+                                                          : BLADERF_RX;
+
+        if ((size_t)(ch >> 1) >= bladerf_get_channel_count(dev, dir)) {
+            log_debug("%s: device lacks channel %d\n", __FUNCTION__, ch);
+            return BLADERF_ERR_INVAL;
+        }
+    }
+
+    /* Queue up the writes rather than waiting upon each in turn */
+    status = bladerf_batch_begin(dev);
+    if (status != 0) {
+        return status;
+    }
+
+    status = restore(dev, &p);
+
+    commit_status = bladerf_batch_commit(dev);
+
+    return (status != 0) ? status : commit_status;
+}
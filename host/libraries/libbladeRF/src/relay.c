@@ -0,0 +1,415 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libbladeRF.h>
+
+#include "host_config.h"
+#include "log.h"
+#include "rel_assert.h"
+
+#include "streaming/format.h"
+#include "streaming/metadata.h"
+
+/* Size of a DMA buffer, and of each metadata message */
+#define RELAY_MSG_SIZE_SS 2048
+#define RELAY_MSG_SIZE_HS 1024
+
+/* The RX stream allocates the buffers, and the TX stream is given the same
+ * ones via relay_alloc(). Each buffer is then owned by exactly one of:
+ *  - an RX transfer,
+ *  - the thread running the RX callback, while it is processed,
+ *  - a TX transfer,
+ *  - the free list, between its transmission and its next reception.
+ *
+ * As at most num_transfers buffers are held by each stream, the free list
+ * cannot be empty when the RX callback needs a buffer if num_buffers exceeds
+ * twice num_transfers. */
+struct bladerf_relay {
+    struct bladerf *dev;
+    struct bladerf_relay_config config;
+    bladerf_channel_layout rx_layout;
+    bladerf_channel_layout tx_layout;
+
+    /* Bytes per message with metadata, or 0 without */
+    size_t msg_size;
+    size_t samples_per_msg;
+
+    struct bladerf_stream *rx;
+    struct bladerf_stream *tx;
+    void **buffers;
+
+    bool ran;
+
+    /* Protects the fields below */
+    pthread_mutex_t lock;
+    pthread_cond_t tx_state;
+    void **free_list;
+    size_t num_free;
+    bool stop;
+    bool tx_started;
+    bool tx_done;
+    int status;
+};
+
+static bool is_supported_format(bladerf_format format)
+{
+    return format == BLADERF_FORMAT_SC16_Q11 ||
+           format == BLADERF_FORMAT_SC16_Q11_META ||
+           format == BLADERF_FORMAT_SC8_Q7 ||
+           format == BLADERF_FORMAT_SC8_Q7_META;
+}
+
+static bool format_has_metadata(bladerf_format format)
+{
+    return format == BLADERF_FORMAT_SC16_Q11_META ||
+           format == BLADERF_FORMAT_SC8_Q7_META;
+}
+
+/* Hands the RX stream's buffers to the TX stream. They are freed along with
+ * the RX stream. */
+static void *relay_alloc(size_t size, void *user_data)
+{
+    struct bladerf_relay *r = user_data;
+    return r->buffers[0];
+}
+
+static void relay_free(void *ptr, size_t size, void *user_data)
+{
+}
+
+/* Run the processing callback over a received buffer, and, with metadata,
+ * rewrite each message's header to schedule its transmission */
+static void process_buffer(struct bladerf_relay *r, uint8_t *buf)
+{
+    const struct bladerf_relay_config *c = &r->config;
+    size_t num_msgs, i;
+
+    if (r->msg_size == 0) {
+        if (c->process != NULL) {
+            c->process(r->dev, buf, c->samples_per_buffer, 0, c->user_data);
+        }
+        return;
+    }
+
+    num_msgs = samples_to_bytes(c->format, c->samples_per_buffer) / r->msg_size;
+
+    for (i = 0; i < num_msgs; i++) {
+        uint8_t *hdr = buf + i * r->msg_size;
+        const uint64_t ts = metadata_get_timestamp(hdr);
+
+        if (c->process != NULL) {
+            c->process(r->dev, hdr + METADATA_HEADER_SIZE, r->samples_per_msg,
+                       ts, c->user_data);
+        }
+
+        /* A timestamp of 0 requests transmission as soon as possible */
+        metadata_set(hdr, c->tx_delay == 0 ? 0 : ts + c->tx_delay, 0);
+    }
+}
+
+static void *relay_rx_cb(struct bladerf *dev,
+                         struct bladerf_stream *stream,
+                         struct bladerf_metadata *meta,
+                         void *samples,
+                         size_t num_samples,
+                         void *user_data)
+{
+    struct bladerf_relay *r = user_data;
+    void *next = BLADERF_STREAM_SHUTDOWN;
+    bool stop;
+    int status;
+
+    pthread_mutex_lock(&r->lock);
+    stop = r->stop || r->tx_done;
+    pthread_mutex_unlock(&r->lock);
+
+    if (stop) {
+        return BLADERF_STREAM_SHUTDOWN;
+    }
+
+    process_buffer(r, samples);
+
+    /* This blocks while every TX transfer is in flight, which keeps RX
+     * paced to TX */
+    status = bladerf_submit_stream_buffer(r->tx, samples, r->config.timeout_ms);
+
+    pthread_mutex_lock(&r->lock);
+
+    if (status != 0) {
+        log_debug("%s: Failed to submit TX buffer: %s\n", __FUNCTION__,
+                  bladerf_strerror(status));
+        if (r->status == 0) {
+            r->status = status;
+        }
+    } else if (r->num_free == 0) {
+        assert(!"Relay free list is empty");
+        if (r->status == 0) {
+            r->status = BLADERF_ERR_UNEXPECTED;
+        }
+    } else {
+        next = r->free_list[--r->num_free];
+    }
+
+    pthread_mutex_unlock(&r->lock);
+
+    return next;
+}
+
+static void *relay_tx_cb(struct bladerf *dev,
+                         struct bladerf_stream *stream,
+                         struct bladerf_metadata *meta,
+                         void *samples,
+                         size_t num_samples,
+                         void *user_data)
+{
+    struct bladerf_relay *r = user_data;
+
+    pthread_mutex_lock(&r->lock);
+
+    if (samples == NULL) {
+        /* Request for an initial buffer. Buffers are instead submitted by
+         * relay_rx_cb() as they are received. */
+        r->tx_started = true;
+        pthread_cond_broadcast(&r->tx_state);
+    } else {
+        assert(r->num_free < r->config.num_buffers);
+        r->free_list[r->num_free++] = samples;
+    }
+
+    pthread_mutex_unlock(&r->lock);
+
+    return BLADERF_STREAM_NO_DATA;
+}
+
+static void *relay_tx_thread(void *arg)
+{
+    struct bladerf_relay *r = arg;
+    int status;
+
+    status = bladerf_stream(r->tx, r->tx_layout);
+
+    pthread_mutex_lock(&r->lock);
+    if (status != 0 && r->status == 0) {
+        r->status = status;
+    }
+    r->tx_done = true;
+    pthread_cond_broadcast(&r->tx_state);
+    pthread_mutex_unlock(&r->lock);
+
+    return NULL;
+}
+
+int bladerf_relay_init(struct bladerf_relay **relay,
+                       struct bladerf *dev,
+                       const struct bladerf_relay_config *config)
+{
+    struct bladerf_buffer_allocator allocator;
+    struct bladerf_relay *r;
+    void **tx_buffers;
+    unsigned int rx_msg_size;
+    int status;
+
+    if (relay == NULL || config == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!is_supported_format(config->format)) {
+        log_debug("%s: Unsupported format\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (config->num_channels != 1 && config->num_channels != 2) {
+        log_debug("%s: Invalid number of channels: %u\n", __FUNCTION__,
+                  config->num_channels);
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (config->num_transfers == 0 ||
+        config->num_buffers <= 2 * config->num_transfers) {
+        log_debug("%s: num_buffers must exceed twice num_transfers\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    }
+
+    r = calloc(1, sizeof(*r));
+    if (r == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    r->dev       = dev;
+    r->config    = *config;
+    r->rx_layout = config->num_channels == 2 ? BLADERF_RX_X2 : BLADERF_RX_X1;
+    r->tx_layout = config->num_channels == 2 ? BLADERF_TX_X2 : BLADERF_TX_X1;
+
+    pthread_mutex_init(&r->lock, NULL);
+    pthread_cond_init(&r->tx_state, NULL);
+
+    if (format_has_metadata(config->format)) {
+        r->msg_size = bladerf_device_speed(dev) == BLADERF_DEVICE_SPEED_SUPER
+                          ? RELAY_MSG_SIZE_SS
+                          : RELAY_MSG_SIZE_HS;
+
+        /* RX messages must be framed as TX expects them */
+        status = bladerf_get_sync_rx_meta_msg_size(dev, &rx_msg_size);
+        if (status != 0) {
+            goto error;
+        }
+
+        if (rx_msg_size != r->msg_size) {
+            log_debug("%s: RX metadata messages of %u bytes are not "
+                      "supported\n", __FUNCTION__, rx_msg_size);
+            status = BLADERF_ERR_UNSUPPORTED;
+            goto error;
+        }
+
+        r->samples_per_msg = (r->msg_size - METADATA_HEADER_SIZE) /
+                             samples_to_bytes(config->format, 1);
+    }
+
+    r->free_list = calloc(config->num_buffers, sizeof(r->free_list[0]));
+    if (r->free_list == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto error;
+    }
+
+    status = bladerf_init_stream(&r->rx, dev, relay_rx_cb, &r->buffers,
+                                 config->num_buffers, config->format,
+                                 config->samples_per_buffer,
+                                 config->num_transfers, r);
+    if (status != 0) {
+        goto error;
+    }
+
+    allocator.alloc     = relay_alloc;
+    allocator.free      = relay_free;
+    allocator.user_data = r;
+
+    status = bladerf_init_stream_with_allocator(
+        &r->tx, dev, relay_tx_cb, &tx_buffers, config->num_buffers,
+        config->format, config->samples_per_buffer, config->num_transfers, r,
+        &allocator);
+    if (status != 0) {
+        goto error;
+    }
+
+    /* Both streams carve their buffers identically from the same memory */
+    assert(tx_buffers[config->num_buffers - 1] ==
+           r->buffers[config->num_buffers - 1]);
+
+    status = bladerf_set_stream_timeout(dev, BLADERF_RX, config->timeout_ms);
+    if (status == 0) {
+        status = bladerf_set_stream_timeout(dev, BLADERF_TX,
+                                            config->timeout_ms);
+    }
+
+    if (status != 0) {
+        goto error;
+    }
+
+    *relay = r;
+    return 0;
+
+error:
+    bladerf_relay_deinit(r);
+    return status;
+}
+
+int bladerf_relay_run(struct bladerf_relay *relay)
+{
+    struct bladerf_relay *r = relay;
+    pthread_t tx_thread;
+    bool tx_failed;
+    size_t i;
+    int status;
+
+    if (r == NULL || r->ran) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    r->ran = true;
+
+    /* The RX stream starts with the first num_transfers buffers */
+    pthread_mutex_lock(&r->lock);
+    r->num_free = 0;
+    for (i = r->config.num_transfers; i < r->config.num_buffers; i++) {
+        r->free_list[r->num_free++] = r->buffers[i];
+    }
+    r->status = 0;
+    pthread_mutex_unlock(&r->lock);
+
+    if (pthread_create(&tx_thread, NULL, relay_tx_thread, r) != 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    /* Buffers may only be submitted to TX, and TX may only be shut down,
+     * once its stream is running */
+    pthread_mutex_lock(&r->lock);
+    while (!r->tx_started && !r->tx_done) {
+        pthread_cond_wait(&r->tx_state, &r->lock);
+    }
+    tx_failed = r->tx_done;
+    pthread_mutex_unlock(&r->lock);
+
+    if (!tx_failed) {
+        status = bladerf_stream(r->rx, r->rx_layout);
+        bladerf_submit_stream_buffer(r->tx, BLADERF_STREAM_SHUTDOWN, 0);
+    } else {
+        status = 0;
+    }
+
+    pthread_join(tx_thread, NULL);
+
+    pthread_mutex_lock(&r->lock);
+    if (r->status != 0) {
+        status = r->status;
+    }
+    pthread_mutex_unlock(&r->lock);
+
+    return status;
+}
+
+void bladerf_relay_stop(struct bladerf_relay *relay)
+{
+    pthread_mutex_lock(&relay->lock);
+    relay->stop = true;
+    pthread_mutex_unlock(&relay->lock);
+}
+
+void bladerf_relay_deinit(struct bladerf_relay *relay)
+{
+    if (relay == NULL) {
+        return;
+    }
+
+    /* The TX stream's buffers belong to the RX stream */
+    bladerf_deinit_stream(relay->tx);
+    bladerf_deinit_stream(relay->rx);
+
+    pthread_cond_destroy(&relay->tx_state);
+    pthread_mutex_destroy(&relay->lock);
+
+    free(relay->free_list);
+    free(relay);
+}
@@ -0,0 +1,368 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_config.h"
+
+#if BLADERF_OS_WINDOWS
+#include <malloc.h>
+#endif
+
+#include <libbladeRF.h>
+
+#include "log.h"
+
+#include "board/board.h"
+#include "stream_pool.h"
+
+/* Alignment of the pool and of each block within it */
+#define STREAM_POOL_ALIGN       4096
+
+/* Each sync direction holds one block, but the old stream's block outlives
+ * the new one's allocation when the worker is rebuilt */
+#define STREAM_POOL_MAX_BLOCKS  8
+
+struct stream_pool_block {
+    size_t offset;
+    size_t size;
+    bladerf_direction dir;
+};
+
+/* Passed to the allocator of each direction */
+struct stream_pool_user {
+    struct stream_pool *pool;
+    bladerf_direction dir;
+};
+
+struct stream_pool {
+    MUTEX lock;
+
+    uint8_t *region;
+    size_t size;
+    size_t reserve[2];
+
+    /* Blocks in use, sorted by offset */
+    struct stream_pool_block blocks[STREAM_POOL_MAX_BLOCKS];
+    size_t num_blocks;
+
+    size_t used[2];
+    size_t peak;
+    unsigned int failures;
+
+    struct stream_pool_user user[2];
+
+    /* Set once the device no longer refers to the pool */
+    bool detached;
+};
+
+static void *alloc_region(size_t size)
+{
+    void *region = NULL;
+
+#if BLADERF_OS_WINDOWS
+    region = _aligned_malloc(size, STREAM_POOL_ALIGN);
+#else
+    if (posix_memalign(&region, STREAM_POOL_ALIGN, size) != 0) {
+        region = NULL;
+    }
+#endif
+
+    return region;
+}
+
+static void free_region(void *region)
+{
+#if BLADERF_OS_WINDOWS
+    _aligned_free(region);
+#else
+    free(region);
+#endif
+}
+
+static void pool_free(struct stream_pool *pool)
+{
+    MUTEX_DESTROY(&pool->lock);
+    free_region(pool->region);
+    free(pool);
+}
+
+static inline size_t align_up(size_t size)
+{
+    return (size + STREAM_POOL_ALIGN - 1) & ~((size_t)STREAM_POOL_ALIGN - 1);
+}
+
+/* Offset of the first gap that fits `size` bytes, and the index of the block
+ * to be inserted there, or false if there is none */
+static bool find_gap(struct stream_pool *pool,
+                     size_t size,
+                     size_t *offset,
+                     size_t *index)
+{
+    size_t start = 0;
+    size_t i;
+
+    for (i = 0; i < pool->num_blocks; i++) {
+        if (pool->blocks[i].offset - start >= size) {
+            break;
+        }
+
+        start = pool->blocks[i].offset + pool->blocks[i].size;
+    }
+
+    if (pool->size - start < size) {
+        return false;
+    }
+
+    *offset = start;
+    *index  = i;
+    return true;
+}
+
+static void *pool_alloc(size_t size, void *user_data)
+{
+    struct stream_pool_user *user = user_data;
+    struct stream_pool *pool      = user->pool;
+    bladerf_direction const other =
+        (user->dir == BLADERF_RX) ? BLADERF_TX : BLADERF_RX;
+    size_t const aligned = align_up(size);
+    size_t held, reserved, offset, index;
+    void *ptr = NULL;
+
+    MUTEX_LOCK(&pool->lock);
+
+    held     = pool->used[BLADERF_RX] + pool->used[BLADERF_TX];
+    reserved = 0;
+    if (pool->used[other] < pool->reserve[other]) {
+        reserved = pool->reserve[other] - pool->used[other];
+    }
+
+    if (aligned < size || pool->num_blocks == STREAM_POOL_MAX_BLOCKS ||
+        pool->size - held < reserved ||
+        aligned > pool->size - held - reserved) {
+        goto out;
+    }
+
+    if (!find_gap(pool, aligned, &offset, &index)) {
+        goto out;
+    }
+
+    memmove(&pool->blocks[index + 1], &pool->blocks[index],
+            (pool->num_blocks - index) * sizeof(pool->blocks[0]));
+
+    pool->blocks[index].offset = offset;
+    pool->blocks[index].size   = aligned;
+    pool->blocks[index].dir    = user->dir;
+    pool->num_blocks++;
+
+    pool->used[user->dir] += aligned;
+    if (held + aligned > pool->peak) {
+        pool->peak = held + aligned;
+    }
+
+    ptr = pool->region + offset;
+
+out:
+    if (ptr == NULL) {
+        pool->failures++;
+        log_debug("%s: %zu %s bytes do not fit in the stream pool "
+                  "(%zu of %zu bytes held, %zu reserved)\n",
+                  __FUNCTION__, size,
+                  (user->dir == BLADERF_RX) ? "RX" : "TX", held, pool->size,
+                  reserved);
+    }
+
+    MUTEX_UNLOCK(&pool->lock);
+    return ptr;
+}
+
+static void pool_release(void *ptr, size_t size, void *user_data)
+{
+    struct stream_pool_user *user = user_data;
+    struct stream_pool *pool      = user->pool;
+    size_t const offset           = (uint8_t *)ptr - pool->region;
+    bool found = false;
+    bool unused;
+    size_t i;
+
+    MUTEX_LOCK(&pool->lock);
+
+    for (i = 0; i < pool->num_blocks; i++) {
+        if (pool->blocks[i].offset == offset) {
+            pool->used[pool->blocks[i].dir] -= pool->blocks[i].size;
+            pool->num_blocks--;
+            memmove(&pool->blocks[i], &pool->blocks[i + 1],
+                    (pool->num_blocks - i) * sizeof(pool->blocks[0]));
+            found = true;
+            break;
+        }
+    }
+
+    if (!found) {
+        log_error("%s: %p is not a stream pool block\n", __FUNCTION__, ptr);
+    }
+
+    unused = pool->detached && pool->num_blocks == 0;
+
+    MUTEX_UNLOCK(&pool->lock);
+
+    if (unused) {
+        pool_free(pool);
+    }
+}
+
+void stream_pool_detach(struct stream_pool *pool)
+{
+    bool unused;
+
+    if (pool == NULL) {
+        return;
+    }
+
+    MUTEX_LOCK(&pool->lock);
+    pool->detached = true;
+    unused         = (pool->num_blocks == 0);
+    MUTEX_UNLOCK(&pool->lock);
+
+    if (unused) {
+        pool_free(pool);
+    }
+}
+
+/* Point both sync directions at `pool`'s allocators, or the default
+ * allocation if it is NULL */
+static int set_allocators(struct bladerf *dev, struct stream_pool *pool)
+{
+    struct bladerf_buffer_allocator allocator;
+    bladerf_direction dir;
+    int status;
+
+    for (dir = BLADERF_RX; dir <= BLADERF_TX; dir++) {
+        if (pool == NULL) {
+            status = dev->board->set_sync_buffer_allocator(dev, dir, NULL);
+        } else {
+            allocator.alloc     = pool_alloc;
+            allocator.free      = pool_release;
+            allocator.user_data = &pool->user[dir];
+
+            status =
+                dev->board->set_sync_buffer_allocator(dev, dir, &allocator);
+        }
+
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/* Public API */
+/******************************************************************************/
+
+int bladerf_set_stream_pool(struct bladerf *dev,
+                            const struct bladerf_stream_pool_config *config)
+{
+    struct stream_pool *pool = NULL;
+    int status;
+
+    if (config != NULL) {
+        if (config->size == 0 || config->rx_reserve > config->size ||
+            config->tx_reserve > config->size - config->rx_reserve) {
+            log_debug("%s: invalid pool size or reserves\n", __FUNCTION__);
+            return BLADERF_ERR_INVAL;
+        }
+
+        pool = calloc(1, sizeof(*pool));
+        if (pool == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+
+        /* The region is left untouched until buffers are zeroed upon
+         * allocation, so that unused parts need not be backed by memory */
+        pool->region = alloc_region(align_up(config->size));
+        if (pool->region == NULL) {
+            free(pool);
+            return BLADERF_ERR_MEM;
+        }
+
+        pool->size                = align_up(config->size);
+        pool->reserve[BLADERF_RX] = config->rx_reserve;
+        pool->reserve[BLADERF_TX] = config->tx_reserve;
+
+        pool->user[BLADERF_RX].pool = pool;
+        pool->user[BLADERF_RX].dir  = BLADERF_RX;
+        pool->user[BLADERF_TX].pool = pool;
+        pool->user[BLADERF_TX].dir  = BLADERF_TX;
+
+        MUTEX_INIT(&pool->lock);
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    status = set_allocators(dev, pool);
+    if (status != 0) {
+        /* Restore the previous allocators before dropping the new pool */
+        set_allocators(dev, dev->stream_pool);
+        stream_pool_detach(pool);
+    } else {
+        stream_pool_detach(dev->stream_pool);
+        dev->stream_pool = pool;
+    }
+
+    MUTEX_UNLOCK(&dev->lock);
+
+    return status;
+}
+
+int bladerf_get_stream_pool_stats(struct bladerf *dev,
+                                  struct bladerf_stream_pool_stats *stats)
+{
+    struct stream_pool *pool;
+    int status = 0;
+
+    if (stats == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&dev->lock);
+
+    pool = dev->stream_pool;
+    if (pool == NULL) {
+        status = BLADERF_ERR_NOT_INIT;
+    } else {
+        MUTEX_LOCK(&pool->lock);
+        stats->size     = pool->size;
+        stats->rx_used  = pool->used[BLADERF_RX];
+        stats->tx_used  = pool->used[BLADERF_TX];
+        stats->peak     = pool->peak;
+        stats->failures = pool->failures;
+        MUTEX_UNLOCK(&pool->lock);
+    }
+
+    MUTEX_UNLOCK(&dev->lock);
+
+    return status;
+}
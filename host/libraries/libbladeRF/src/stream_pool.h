@@ -0,0 +1,38 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef STREAM_POOL_H_
+#define STREAM_POOL_H_
+
+#include <libbladeRF.h>
+
+struct stream_pool;
+
+/**
+ * Detach a pool from its device, upon bladerf_close() or its replacement.
+ * Its memory is freed once all buffers allocated from it have been freed.
+ * Passing NULL is a no-op.
+ *
+ * @param       pool    Pool to detach
+ */
+void stream_pool_detach(struct stream_pool *pool);
+
+#endif
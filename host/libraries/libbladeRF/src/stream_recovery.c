@@ -0,0 +1,128 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdbool.h>
+
+#include <libbladeRF.h>
+
+#include "log.h"
+
+#include "backend/backend.h"
+#include "board/board.h"
+#include "stream_recovery.h"
+
+unsigned int stream_recovery_gen(struct bladerf *dev)
+{
+    return ATOMIC_LOAD(&dev->recovery_gen);
+}
+
+bool stream_recover(struct bladerf *dev, unsigned int gen, int error)
+{
+    bool recovered = false;
+    int status;
+
+    /* Timeouts and invalid requests do not call for a new connection */
+    if (error != BLADERF_ERR_IO && error != BLADERF_ERR_NODEV) {
+        return false;
+    }
+
+    MUTEX_LOCK(&dev->recovery_lock);
+
+    if (!dev->recovery) {
+        goto out;
+    }
+
+    /* The other direction's stream restarts on the new connection as well */
+    if (ATOMIC_LOAD(&dev->recovery_gen) != gen) {
+        recovered = true;
+        goto out;
+    }
+
+    log_warning("Stream failed (%s), attempting to recover.\n",
+                bladerf_strerror(error));
+
+    MUTEX_LOCK(&dev->lock);
+    status = dev->backend->recover(dev);
+    MUTEX_UNLOCK(&dev->lock);
+
+    if (status == 0) {
+        status = bladerf_load_profile(dev, dev->recovery_profile,
+                                      dev->recovery_profile_len);
+    }
+
+    if (status != 0) {
+        log_error("Stream recovery failed: %s\n", bladerf_strerror(status));
+        goto out;
+    }
+
+    ATOMIC_INC(&dev->recovery_gen);
+    recovered = true;
+
+    log_info("Stream recovered.\n");
+
+out:
+    MUTEX_UNLOCK(&dev->recovery_lock);
+    return recovered;
+}
+
+/******************************************************************************/
+/* Public API */
+/******************************************************************************/
+
+int bladerf_enable_stream_recovery(struct bladerf *dev, bool enable)
+{
+    size_t len = sizeof(dev->recovery_profile);
+    int status = 0;
+
+    MUTEX_LOCK(&dev->recovery_lock);
+
+    dev->recovery = false;
+
+    if (enable) {
+        if (dev->backend->recover == NULL) {
+            log_debug("%s: backend does not support recovery\n",
+                      __FUNCTION__);
+            status = BLADERF_ERR_UNSUPPORTED;
+        } else {
+            status = bladerf_save_profile(dev, dev->recovery_profile, &len);
+        }
+
+        if (status == 0) {
+            dev->recovery_profile_len = len;
+            dev->recovery             = true;
+        }
+    }
+
+    MUTEX_UNLOCK(&dev->recovery_lock);
+
+    return status;
+}
+
+int bladerf_get_stream_recoveries(struct bladerf *dev, unsigned int *count)
+{
+    if (count == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    *count = stream_recovery_gen(dev);
+
+    return 0;
+}
@@ -0,0 +1,54 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef STREAM_RECOVERY_H_
+#define STREAM_RECOVERY_H_
+
+#include <stdbool.h>
+
+#include <libbladeRF.h>
+
+/**
+ * Get the number of stream recoveries so far, to be passed to
+ * stream_recover() should the sync call about to be made fail.
+ *
+ * @param       dev     Device handle
+ *
+ * @return recovery count
+ */
+unsigned int stream_recovery_gen(struct bladerf *dev);
+
+/**
+ * Recover from the failure of a sync call, if stream recovery is enabled and
+ * the error is one it applies to. The failed stream restarts when the call is
+ * retried.
+ *
+ * @param       dev     Device handle
+ * @param       gen     stream_recovery_gen() before the failed call. If the
+ *                      count has since changed, another stream has already
+ *                      recovered the device.
+ * @param       error   Error returned by the failed call
+ *
+ * @return true if the call should be retried, or false if `error` stands
+ */
+bool stream_recover(struct bladerf *dev, unsigned int gen, int error);
+
+#endif
@@ -22,6 +22,19 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <string.h>
+
+#include "host_config.h"
+
+#if BLADERF_OS_WINDOWS
+#include <malloc.h>
+#else
+#include <unistd.h>
+#endif
+
+#if BLADERF_OS_LINUX
+#include <sys/mman.h>
+#endif
 
 #include "log.h"
 
@@ -31,6 +44,215 @@
 #include "board/board.h"
 #include "helpers/timeout.h"
 #include "helpers/have_cap.h"
+#include "helpers/mem_lock.h"
+#include "helpers/numa.h"
+#include "helpers/thread_attrs.h"
+
+/* Fallback alignment for stream buffers when the page size can't be queried */
+#define ASYNC_DEFAULT_PAGE_SIZE     4096
+
+/* Slabs at least this large are aligned such that the kernel may back them
+ * with transparent huge pages, reducing TLB pressure at high sample rates. */
+#define ASYNC_HUGEPAGE_SIZE         (2 * 1024 * 1024)
+
+static void *alloc_default_slab(size_t size, int numa_node)
+{
+    void *slab = NULL;
+
+#if BLADERF_OS_WINDOWS
+    slab = _aligned_malloc(size, ASYNC_DEFAULT_PAGE_SIZE);
+#else
+    long page_size = sysconf(_SC_PAGESIZE);
+    size_t alignment;
+
+    if (page_size <= 0) {
+        page_size = ASYNC_DEFAULT_PAGE_SIZE;
+    }
+
+    alignment = (size_t) page_size;
+
+#   if BLADERF_OS_LINUX && defined(MADV_HUGEPAGE)
+    if (size >= ASYNC_HUGEPAGE_SIZE) {
+        alignment = ASYNC_HUGEPAGE_SIZE;
+    }
+#   endif
+
+    if (posix_memalign(&slab, alignment, size) != 0) {
+        slab = NULL;
+    }
+
+    /* Place the buffers by the USB controller, before they are first
+     * touched by the memset() below */
+    if (slab != NULL) {
+        numa_prefer_node(slab, size, numa_node);
+    }
+
+#   if BLADERF_OS_LINUX && defined(MADV_HUGEPAGE)
+    if (slab != NULL && alignment == ASYNC_HUGEPAGE_SIZE) {
+        /* This is only a hint; failure is harmless */
+        if (madvise(slab, size, MADV_HUGEPAGE) != 0) {
+            log_verbose("madvise(MADV_HUGEPAGE) failed: %s\n",
+                        strerror(errno));
+        }
+    }
+#   endif
+#endif
+
+    if (slab != NULL) {
+        memset(slab, 0, size);
+    }
+
+    return slab;
+}
+
+static void free_default_slab(void *slab)
+{
+#if BLADERF_OS_WINDOWS
+    _aligned_free(slab);
+#else
+    free(slab);
+#endif
+}
+
+/* Obtain the stream's buffer slab, preferring the backend's allocator */
+static int alloc_buffer_slab(struct bladerf_stream *stream, size_t size)
+{
+    struct bladerf *dev = stream->dev;
+    void *slab = NULL;
+    int status;
+
+    if (stream->allocator.alloc != NULL) {
+        slab = stream->allocator.alloc(size, stream->allocator.user_data);
+        if (slab == NULL) {
+            log_debug("Caller's stream buffer allocator failed\n");
+            return BLADERF_ERR_MEM;
+        }
+
+        memset(slab, 0, size);
+        stream->buffer_slab = (uint8_t *) slab;
+        return 0;
+    }
+
+    status = dev->backend->alloc_stream_buffers(stream, size, &slab);
+    if (status == 0) {
+        stream->buffer_slab_from_backend = true;
+    } else {
+        if (status != BLADERF_ERR_UNSUPPORTED) {
+            log_debug("Backend stream buffer allocation failed: %s\n",
+                      bladerf_strerror(status));
+        }
+
+        slab = alloc_default_slab(size, numa_device_node(dev));
+        if (slab == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+
+        stream->buffer_slab_from_backend = false;
+    }
+
+    stream->buffer_slab = (uint8_t *) slab;
+    return 0;
+}
+
+static void free_buffer_slab(struct bladerf_stream *stream)
+{
+    if (stream->buffer_slab == NULL) {
+        return;
+    }
+
+    if (stream->buffer_slab_locked) {
+        mem_unlock(stream->buffer_slab,
+                   stream->num_buffers * stream->buffer_bytes);
+        stream->buffer_slab_locked = false;
+    }
+
+    if (stream->allocator.alloc != NULL) {
+        if (stream->allocator.free != NULL) {
+            stream->allocator.free(stream->buffer_slab,
+                                   stream->num_buffers * stream->buffer_bytes,
+                                   stream->allocator.user_data);
+        }
+    } else if (stream->buffer_slab_from_backend) {
+        stream->dev->backend->free_stream_buffers(
+            stream, stream->buffer_slab,
+            stream->num_buffers * stream->buffer_bytes);
+    } else {
+        free_default_slab(stream->buffer_slab);
+    }
+
+    stream->buffer_slab = NULL;
+}
+
+/* Fault in, and optionally lock, the buffer slab per the stream's mem_flags,
+ * so that the first transfers do not take page faults */
+static void prepare_buffer_slab(struct bladerf_stream *stream, size_t size)
+{
+    if (stream->mem_flags & BLADERF_STREAM_MEM_LOCK) {
+        if (mem_lock(stream->buffer_slab, size) == 0) {
+            stream->buffer_slab_locked = true;
+            return;
+        }
+
+        log_warning("Could not lock %zu bytes of stream buffers into RAM. "
+                    "Check RLIMIT_MEMLOCK (ulimit -l).\n", size);
+    }
+
+    if (stream->mem_flags &
+        (BLADERF_STREAM_MEM_PREFAULT | BLADERF_STREAM_MEM_LOCK)) {
+        mem_prefault(stream->buffer_slab, size);
+    }
+}
+
+/* Size of each stream buffer in bytes, after checking that it is a valid
+ * size for the format */
+static int stream_buffer_bytes(bladerf_format format,
+                               size_t samples_per_buffer,
+                               size_t *bytes)
+{
+    size_t granularity;
+
+    granularity = async_buffer_granularity(format);
+    if (samples_per_buffer < granularity ||
+        samples_per_buffer % granularity != 0) {
+        log_error("samples_per_buffer must be multiples of %u with this "
+                  "format\n", (unsigned int)granularity);
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* Packed metadata buffers must hold a whole number of messages */
+    if (format == BLADERF_FORMAT_SC12_PACKED_META &&
+        samples_per_buffer % 2048 != 0) {
+        log_error("samples_per_buffer must be multiples of 2048 with the "
+                  "12bit packed meta format\n");
+        return BLADERF_ERR_INVAL;
+    }
+
+    switch(format) {
+        case BLADERF_FORMAT_SC8_Q7:
+        case BLADERF_FORMAT_SC8_Q7_META:
+            *bytes = sc8q7_to_bytes(samples_per_buffer);
+            break;
+
+        case BLADERF_FORMAT_SC12_PACKED:
+        case BLADERF_FORMAT_SC12_PACKED_META:
+            *bytes = sc12_to_bytes(samples_per_buffer);
+            break;
+
+        case BLADERF_FORMAT_SC16_Q11:
+        case BLADERF_FORMAT_SC16_Q11_META:
+            *bytes = sc16q11_to_bytes(samples_per_buffer);
+            break;
+
+        case BLADERF_FORMAT_PACKET_META:
+            *bytes = samples_per_buffer;
+            break;
+
+        default:
+            return BLADERF_ERR_INVAL;
+    }
+
+    return 0;
+}
 
 int async_init_stream(struct bladerf_stream **stream,
                       struct bladerf *dev,
@@ -40,7 +262,8 @@ int async_init_stream(struct bladerf_stream **stream,
                       bladerf_format format,
                       size_t samples_per_buffer,
                       size_t num_transfers,
-                      void *user_data)
+                      void *user_data,
+                      const struct bladerf_buffer_allocator *allocator)
 {
     struct bladerf_stream *lstream;
     size_t buffer_size_bytes;
@@ -52,11 +275,17 @@ int async_init_stream(struct bladerf_stream **stream,
         return BLADERF_ERR_INVAL;
     }
 
-    if (samples_per_buffer < 1024 || samples_per_buffer % 1024 != 0) {
-        log_error("samples_per_buffer must be multiples of 1024\n");
+    if (allocator != NULL && allocator->alloc == NULL) {
+        log_error("Stream buffer allocator requires an alloc function\n");
         return BLADERF_ERR_INVAL;
     }
 
+    status = stream_buffer_bytes(format, samples_per_buffer,
+                                 &buffer_size_bytes);
+    if (status != 0) {
+        return status;
+    }
+
     /* Create a stream and populate it with the appropriate information */
     lstream = malloc(sizeof(struct bladerf_stream));
 
@@ -65,6 +294,7 @@ int async_init_stream(struct bladerf_stream **stream,
     }
 
     MUTEX_INIT(&lstream->lock);
+    MUTEX_INIT(&lstream->cb_lock);
 
     if (pthread_cond_init(&lstream->can_submit_buffer, NULL) != 0) {
         free(lstream);
@@ -86,6 +316,26 @@ int async_init_stream(struct bladerf_stream **stream,
     lstream->cb = callback;
     lstream->user_data = user_data;
     lstream->buffers = NULL;
+    lstream->tx_variable_length = false;
+    lstream->buffer_slab = NULL;
+    lstream->buffer_bytes = 0;
+    lstream->buffer_slab_from_backend = false;
+    lstream->mem_flags = ATOMIC_LOAD(&dev->stream_mem_flags);
+    lstream->buffer_slab_locked = false;
+    if (allocator != NULL) {
+        lstream->allocator = *allocator;
+    } else {
+        memset(&lstream->allocator, 0, sizeof(lstream->allocator));
+    }
+    memset(&lstream->xfer_stats, 0, sizeof(lstream->xfer_stats));
+    thread_attrs_init(&lstream->thread_attrs);
+    lstream->batch_cb = NULL;
+    lstream->batch_user_data = NULL;
+    lstream->batch = NULL;
+    lstream->batch_count = 0;
+    lstream->batch_prime = 0;
+    lstream->batch_dispatch = NULL;
+    lstream->batch_next = NULL;
 
     if (format == BLADERF_FORMAT_PACKET_META) {
         if (!have_cap_dev(dev, BLADERF_CAP_FW_SHORT_PACKET)) {
@@ -109,51 +359,40 @@ int async_init_stream(struct bladerf_stream **stream,
         }
     }
 
-    switch(format) {
-        case BLADERF_FORMAT_SC8_Q7:
-        case BLADERF_FORMAT_SC8_Q7_META:
-            buffer_size_bytes = sc8q7_to_bytes(samples_per_buffer);
-            break;
-
-        case BLADERF_FORMAT_SC16_Q11:
-        case BLADERF_FORMAT_SC16_Q11_META:
-            buffer_size_bytes = sc16q11_to_bytes(samples_per_buffer);
-            break;
-
-        case BLADERF_FORMAT_PACKET_META:
-            buffer_size_bytes = samples_per_buffer;
-            break;
-
-        default:
-            status = BLADERF_ERR_INVAL;
-            break;
+    if (format_is_packed(format)) {
+        if (!have_cap_dev(dev, BLADERF_CAP_FPGA_SC12_PACKED)) {
+            log_error("FPGA does not support 12bit packed mode. "
+                      "It requires a bladeRF 2.0 Micro with at least "
+                      "FPGA version 0.17.0.\n");
+            return BLADERF_ERR_UNSUPPORTED;
+        }
     }
 
+
     if (!status) {
+        lstream->buffer_bytes = buffer_size_bytes;
         lstream->buffers = calloc(num_buffers, sizeof(lstream->buffers[0]));
-        if (lstream->buffers) {
-            for (i = 0; i < num_buffers && !status; i++) {
-                lstream->buffers[i] = calloc(1, buffer_size_bytes);
-                if (!lstream->buffers[i]) {
-                    status = BLADERF_ERR_MEM;
-                }
-            }
-        } else {
-            status = BLADERF_ERR_MEM;
-        }
-    }
 
-    /* Clean up everything we've allocated if we hit any errors */
-    if (status) {
-
-        if (lstream->buffers) {
+        if (num_buffers > SIZE_MAX / buffer_size_bytes) {
+            status = BLADERF_ERR_INVAL;
+        } else if (lstream->buffers == NULL ||
+                   alloc_buffer_slab(lstream, num_buffers * buffer_size_bytes)
+                        != 0) {
+            status = BLADERF_ERR_MEM;
+        } else {
             for (i = 0; i < num_buffers; i++) {
-                free(lstream->buffers[i]);
+                lstream->buffers[i] =
+                    lstream->buffer_slab + i * buffer_size_bytes;
             }
 
-            free(lstream->buffers);
+            prepare_buffer_slab(lstream, num_buffers * buffer_size_bytes);
         }
+    }
 
+    /* Clean up everything we've allocated if we hit any errors */
+    if (status) {
+        free_buffer_slab(lstream);
+        free(lstream->buffers);
         free(lstream);
     } else {
         /* Perform any backend-specific stream initialization */
@@ -175,6 +414,30 @@ int async_init_stream(struct bladerf_stream **stream,
     return status;
 }
 
+int async_reconfigure_stream(struct bladerf_stream *stream,
+                             bladerf_format format,
+                             size_t samples_per_buffer)
+{
+    size_t bytes;
+    int status;
+
+    status = stream_buffer_bytes(format, samples_per_buffer, &bytes);
+    if (status != 0) {
+        return status;
+    }
+
+    if (bytes != stream->buffer_bytes) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&stream->lock);
+    stream->format             = format;
+    stream->samples_per_buffer = samples_per_buffer;
+    MUTEX_UNLOCK(&stream->lock);
+
+    return 0;
+}
+
 int async_set_transfer_timeout(struct bladerf_stream *stream,
                                unsigned int transfer_timeout_ms)
 {
@@ -195,19 +458,57 @@ int async_get_transfer_timeout(struct bladerf_stream *stream,
     return 0;
 }
 
+int async_set_thread_attrs(struct bladerf_stream *stream,
+                           const struct bladerf_thread_attrs *attrs)
+{
+    int status = 0;
+
+    MUTEX_LOCK(&stream->lock);
+
+    if (attrs == NULL) {
+        thread_attrs_init(&stream->thread_attrs);
+    } else {
+        status = thread_attrs_validate(attrs);
+        if (status == 0) {
+            stream->thread_attrs = *attrs;
+        }
+    }
+
+    MUTEX_UNLOCK(&stream->lock);
+    return status;
+}
+
 int async_run_stream(struct bladerf_stream *stream, bladerf_channel_layout layout)
 {
     int status;
     struct bladerf *dev = stream->dev;
+    struct bladerf_thread_attrs thread_attrs;
+    void *stack_addr = NULL;
+    size_t stack_len = 0;
 
     MUTEX_LOCK(&stream->lock);
     stream->layout = layout;
     stream->state = STREAM_RUNNING;
+    thread_attrs = stream->thread_attrs;
     pthread_cond_signal(&stream->stream_started);
     MUTEX_UNLOCK(&stream->lock);
 
+    /* This thread services the backend's transfer completions */
+    if (thread_attrs_nondefault(&thread_attrs)) {
+        thread_attrs_apply(&thread_attrs);
+    }
+
+    if (stream->mem_flags & BLADERF_STREAM_MEM_LOCK_STACKS) {
+        if (mem_lock_stack(&stack_addr, &stack_len) != 0) {
+            log_warning("Could not lock the stream thread's stack into "
+                        "RAM.\n");
+        }
+    }
+
     status = dev->backend->stream(stream, layout);
 
+    mem_unlock(stack_addr, stack_len);
+
     /* Backend return value takes precedence over stream error status */
     return status == 0 ? stream->error_code : status;
 }
@@ -263,10 +564,160 @@ error:
     return status;
 }
 
-void async_deinit_stream(struct bladerf_stream *stream)
+int async_enable_batch(struct bladerf_stream *stream,
+                       bladerf_stream_batch_cb cb,
+                       void *user_data)
 {
-    size_t i;
+    /* There can be no more completions queued than there are buffers */
+    const size_t n = stream->num_buffers;
+
+    if (stream->format == BLADERF_FORMAT_PACKET_META) {
+        log_debug("Batched callbacks do not support the packet format.\n");
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    stream->batch          = calloc(n, sizeof(stream->batch[0]));
+    stream->batch_dispatch = calloc(n, sizeof(stream->batch_dispatch[0]));
+    stream->batch_next     = calloc(n, sizeof(stream->batch_next[0]));
+
+    if (stream->batch == NULL || stream->batch_dispatch == NULL ||
+        stream->batch_next == NULL) {
+        free(stream->batch);
+        free(stream->batch_dispatch);
+        free(stream->batch_next);
+        stream->batch          = NULL;
+        stream->batch_dispatch = NULL;
+        stream->batch_next     = NULL;
+        return BLADERF_ERR_MEM;
+    }
 
+    stream->batch_cb        = cb;
+    stream->batch_user_data = user_data;
+
+    return 0;
+}
+
+void *async_stream_cb(struct bladerf_stream *stream,
+                      struct bladerf_metadata *meta,
+                      void *samples,
+                      size_t num_samples)
+{
+    void *next;
+
+    if (stream->batch_cb != NULL) {
+        MUTEX_LOCK(&stream->lock);
+        next = async_batch_collect(stream->dev, stream, meta, samples,
+                                   num_samples, stream->user_data);
+        MUTEX_UNLOCK(&stream->lock);
+    } else {
+        MUTEX_LOCK(&stream->cb_lock);
+        next = stream->cb(stream->dev, stream, meta, samples, num_samples,
+                          stream->user_data);
+        MUTEX_UNLOCK(&stream->cb_lock);
+    }
+
+    return next;
+}
+
+void *async_batch_collect(struct bladerf *dev,
+                          struct bladerf_stream *stream,
+                          struct bladerf_metadata *meta,
+                          void *samples,
+                          size_t num_samples,
+                          void *user_data)
+{
+    struct bladerf_stream_buffer *b;
+
+    if (samples == NULL) {
+        /* The backend is requesting an initial TX buffer */
+        stream->batch_prime++;
+        return BLADERF_STREAM_NO_DATA;
+    }
+
+    if (stream->batch_count >= stream->num_buffers) {
+        assert(!"Batch overflow");
+        return BLADERF_STREAM_NO_DATA;
+    }
+
+    b              = &stream->batch[stream->batch_count++];
+    b->samples     = samples;
+    b->num_samples = num_samples;
+    b->meta        = *meta;
+
+    return BLADERF_STREAM_NO_DATA;
+}
+
+void async_dispatch_batch(struct bladerf_stream *stream)
+{
+    int status;
+    size_t i, num_completed, max_next, num_next;
+
+    /* Immutable once the stream is running, so this may be checked without
+     * the lock */
+    if (stream->batch_cb == NULL) {
+        return;
+    }
+
+    MUTEX_LOCK(&stream->lock);
+
+    num_completed = stream->batch_count;
+    max_next      = num_completed + stream->batch_prime;
+
+    if (max_next == 0 || stream->state != STREAM_RUNNING) {
+        MUTEX_UNLOCK(&stream->lock);
+        return;
+    }
+
+    memcpy(stream->batch_dispatch, stream->batch,
+           num_completed * sizeof(stream->batch[0]));
+
+    stream->batch_count = 0;
+    stream->batch_prime = 0;
+
+    MUTEX_UNLOCK(&stream->lock);
+
+    num_next = stream->batch_cb(stream->dev, stream, stream->batch_dispatch,
+                                num_completed, stream->batch_next, max_next,
+                                stream->batch_user_data);
+
+    if (num_next > max_next) {
+        log_warning("%s: Ignoring %zu excess buffers from callback\n",
+                    __FUNCTION__, num_next - max_next);
+        num_next = max_next;
+    }
+
+    MUTEX_LOCK(&stream->lock);
+
+    for (i = 0; i < num_next && stream->state == STREAM_RUNNING; i++) {
+        void *buffer  = stream->batch_next[i];
+        size_t length = async_stream_buf_bytes(stream);
+
+        if (buffer == BLADERF_STREAM_SHUTDOWN) {
+            stream->dev->backend->submit_stream_buffer(stream, buffer,
+                                                       &length, 0, true);
+            break;
+        }
+
+        /* Each of these transfers was freed by a completion (or an initial
+         * setup request), so this is not expected to block */
+        status = stream->dev->backend->submit_stream_buffer(stream, buffer,
+                                                            &length, 0, true);
+        if (status != 0) {
+            log_debug("%s: Failed to submit buffer %p: %s\n", __FUNCTION__,
+                      buffer, bladerf_strerror(status));
+
+            stream->error_code = status;
+            stream->dev->backend->submit_stream_buffer(
+                stream, BLADERF_STREAM_SHUTDOWN, &length, 0, true);
+            break;
+        }
+    }
+
+    MUTEX_UNLOCK(&stream->lock);
+}
+
+void async_deinit_stream(struct bladerf_stream *stream)
+{
     if (!stream) {
         log_debug("%s called with NULL stream\n", __FUNCTION__);
         return;
@@ -281,13 +732,15 @@ void async_deinit_stream(struct bladerf_stream *stream)
     stream->dev->backend->deinit_stream(stream);
 
     /* Free up the buffers */
-    for (i = 0; i < stream->num_buffers; i++) {
-        free(stream->buffers[i]);
-    }
+    free_buffer_slab(stream);
 
     /* Free up the pointer to the buffers */
     free(stream->buffers);
 
+    free(stream->batch);
+    free(stream->batch_dispatch);
+    free(stream->batch_next);
+
     /* Free up the stream itself */
     free(stream);
 }
@@ -40,6 +40,15 @@ typedef enum {
     STREAM_DONE           /* Done and deallocated */
 } bladerf_stream_state;
 
+/* Transfer statistics maintained by the backend. Access while holding the
+ * stream lock. */
+struct async_xfer_stats {
+    uint64_t completed;      /* Successfully completed transfers */
+    uint64_t short_xfers;    /* Transfers with fewer bytes than requested */
+    uint64_t latency_sum_us; /* Total submission-to-completion latency */
+    uint64_t latency_max_us; /* Max submission-to-completion latency */
+};
+
 struct bladerf_stream {
     /* These items are configured in async_init_stream() and should only be
      * read (NOT MODIFIED) during the execution of the stream */
@@ -53,16 +62,83 @@ struct bladerf_stream {
     size_t num_buffers;
     void **buffers;
 
+    /* All buffers are carved out of this single allocation, in order, such
+     * that buffers[i] == buffer_slab + i * buffer_bytes. This allows a
+     * buffer's index to be computed from its address. */
+    uint8_t *buffer_slab;
+    size_t buffer_bytes;
+
+    /* Set when buffer_slab was provided by the backend's
+     * alloc_stream_buffers() and must be returned to it on deinit. */
+    bool buffer_slab_from_backend;
+
+    /* BLADERF_STREAM_MEM_* flags latched from the device at initialization,
+     * and whether buffer_slab was then locked into RAM */
+    uint32_t mem_flags;
+    bool buffer_slab_locked;
+
+    /* Caller-provided allocator, used in place of both the backend's and the
+     * default allocation when `allocator.alloc` is non-NULL. */
+    struct bladerf_buffer_allocator allocator;
+
+    /* Set by the sync interface when TX buffers returned by the callback may
+     * be shorter than a full buffer, in which case their length, in bytes,
+     * is reported via bladerf_metadata::actual_count. Must be set before the
+     * stream is started. */
+    bool tx_variable_length;
+
     MUTEX lock;
 
+    /* Serializes invocations of `cb` made without `lock` held, such that only
+     * one callback occurs at a time. See async_stream_cb(). */
+    MUTEX cb_lock;
+
     /* The following items must be accessed atomically */
     int error_code;
     bladerf_stream_state state;
     pthread_cond_t can_submit_buffer;
     pthread_cond_t stream_started;
     void *backend_data;
+
+    struct async_xfer_stats xfer_stats;
+
+    /* Applied to the thread that runs the stream. Protected by `lock`. */
+    struct bladerf_thread_attrs thread_attrs;
+
+    /* Batched callback mode, set up by async_enable_batch() before the stream
+     * is started. When batch_cb is non-NULL, `cb` is async_batch_collect(),
+     * which queues completed buffers for async_dispatch_batch(). */
+    bladerf_stream_batch_cb batch_cb;
+    void *batch_user_data;
+    struct bladerf_stream_buffer *batch; /* Queued completions. Protected by
+                                          * `lock`. */
+    size_t batch_count;                  /* # of entries in `batch` */
+    size_t batch_prime;                  /* # of initial TX buffers requested
+                                          * by the backend */
+
+    /* Only accessed by the thread that runs the stream */
+    struct bladerf_stream_buffer *batch_dispatch;
+    void **batch_next;
 };
 
+/* Account for a successfully completed transfer. Assumes stream->lock is
+ * held. A `latency_us` of 0 denotes that the latency is unknown. */
+static inline void async_record_transfer(struct bladerf_stream *s,
+                                         uint64_t latency_us,
+                                         bool short_xfer)
+{
+    s->xfer_stats.completed++;
+    s->xfer_stats.latency_sum_us += latency_us;
+
+    if (latency_us > s->xfer_stats.latency_max_us) {
+        s->xfer_stats.latency_max_us = latency_us;
+    }
+
+    if (short_xfer) {
+        s->xfer_stats.short_xfers++;
+    }
+}
+
 /* Get the number of bytes per stream buffer */
 static inline size_t async_stream_buf_bytes(struct bladerf_stream *s)
 {
@@ -71,6 +147,41 @@ static inline size_t async_stream_buf_bytes(struct bladerf_stream *s)
     return samples_to_bytes(s->format, s->samples_per_buffer);
 }
 
+/* Size of a SuperSpeed bulk packet, in bytes */
+#define ASYNC_PACKET_BYTES 1024
+
+/* Get the granularity of samples_per_buffer for a format. Buffers of the
+ * unpacked formats without metadata need only span whole bulk packets, which
+ * permits short, low-latency transfers. The others keep to 1024 samples, such
+ * that buffers hold whole metadata messages and packed samples. */
+static inline size_t async_buffer_granularity(bladerf_format format)
+{
+    switch (format) {
+        case BLADERF_FORMAT_SC16_Q11:
+        case BLADERF_FORMAT_SC8_Q7:
+            return ASYNC_PACKET_BYTES / samples_to_bytes(format, 1);
+
+        default:
+            return 1024;
+    }
+}
+
+/* Get the number of bytes to submit for a TX buffer, given the metadata
+ * filled in by the stream callback that provided it */
+static inline size_t async_stream_tx_bytes(struct bladerf_stream *s,
+                                           struct bladerf_metadata const *meta)
+{
+    if (s->format == BLADERF_FORMAT_PACKET_META) {
+        return meta->actual_count;
+    }
+
+    if (s->tx_variable_length && meta->actual_count != 0) {
+        return meta->actual_count;
+    }
+
+    return async_stream_buf_bytes(s);
+}
+
 int async_init_stream(struct bladerf_stream **stream,
                       struct bladerf *dev,
                       bladerf_stream_cb callback,
@@ -79,7 +190,15 @@ int async_init_stream(struct bladerf_stream **stream,
                       bladerf_format format,
                       size_t buffer_size,
                       size_t num_transfers,
-                      void *user_data);
+                      void *user_data,
+                      const struct bladerf_buffer_allocator *allocator);
+
+/* Change the format and buffer size of a stream that is not running. This
+ * fails with BLADERF_ERR_INVAL, leaving the stream unchanged, unless its
+ * buffers are exactly as long in the new format. */
+int async_reconfigure_stream(struct bladerf_stream *stream,
+                             bladerf_format format,
+                             size_t samples_per_buffer);
 
 /* Set the transfer timeout. This acquires stream->lock. */
 int async_set_transfer_timeout(struct bladerf_stream *stream,
@@ -89,6 +208,45 @@ int async_set_transfer_timeout(struct bladerf_stream *stream,
 int async_get_transfer_timeout(struct bladerf_stream *stream,
                                unsigned int *transfer_timeout_ms);
 
+/* Set the attributes applied to the thread calling async_run_stream().
+ * NULL restores the defaults. This acquires stream->lock. */
+int async_set_thread_attrs(struct bladerf_stream *stream,
+                           const struct bladerf_thread_attrs *attrs);
+
+/* Switch a stream initialized with async_batch_collect() as its callback to
+ * batched mode, in which completed buffers are delivered to `cb` by
+ * async_dispatch_batch() */
+int async_enable_batch(struct bladerf_stream *stream,
+                       bladerf_stream_batch_cb cb,
+                       void *user_data);
+
+/* Per-buffer callback for batched mode. Assumes stream->lock is held. */
+void *async_batch_collect(struct bladerf *dev,
+                          struct bladerf_stream *stream,
+                          struct bladerf_metadata *meta,
+                          void *samples,
+                          size_t num_samples,
+                          void *user_data);
+
+/* Deliver queued completions to a batched stream's callback and submit the
+ * buffers it returns. Backends call this from the thread running the stream,
+ * WITHOUT stream->lock held, after handling transfer completions. This does
+ * nothing for streams not in batched mode. */
+void async_dispatch_batch(struct bladerf_stream *stream);
+
+/* Invoke the stream's callback for a completed buffer. This must be called
+ * WITHOUT stream->lock held; the user callback is serialized against other
+ * callbacks from the same stream via stream->cb_lock instead. In batched
+ * mode, this acquires stream->lock to queue the buffer.
+ *
+ * The backend must ensure the stream cannot reach STREAM_DONE until this
+ * returns, e.g., by not returning the buffer's transfer to its pool until
+ * afterwards. */
+void *async_stream_cb(struct bladerf_stream *stream,
+                      struct bladerf_metadata *meta,
+                      void *samples,
+                      size_t num_samples);
+
 /* Backend code is responsible for acquiring stream->lock in their callbacks */
 int async_run_stream(struct bladerf_stream *stream,
                      bladerf_channel_layout layout);
@@ -0,0 +1,541 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <string.h>
+
+#include "convert.h"
+
+#if defined(LIBBLADERF_NO_SIMD)
+/* Scalar loops only, e.g., to benchmark against */
+#elif defined(__AVX2__)
+#   include <immintrin.h>
+#   define CONVERT_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define CONVERT_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#   include <arm_neon.h>
+#   define CONVERT_NEON
+#endif
+
+#if defined(LIBBLADERF_NO_SIMD)
+#elif defined(__SSSE3__) || defined(__AVX2__)
+#   include <tmmintrin.h>
+#   define CONVERT_PACK_SSSE3
+#elif defined(CONVERT_NEON)
+#   define CONVERT_PACK_NEON
+#endif
+
+#define SC16Q11_SCALE   2048.0f
+#define SC16Q11_MAX     2047.0f
+#define SC16Q11_MIN     (-2048.0f)
+
+#define SC8Q7_SCALE     128.0f
+#define SC8Q7_MAX       127.0f
+#define SC8Q7_MIN       (-128.0f)
+
+static inline int16_t cf32_to_sc16q11_value(float v)
+{
+    v *= SC16Q11_SCALE;
+
+    if (v > SC16Q11_MAX) {
+        v = SC16Q11_MAX;
+    } else if (v < SC16Q11_MIN) {
+        v = SC16Q11_MIN;
+    }
+
+    return (int16_t)(v >= 0.0f ? v + 0.5f : v - 0.5f);
+}
+
+static inline int8_t cf32_to_sc8q7_value(float v)
+{
+    v *= SC8Q7_SCALE;
+
+    if (v > SC8Q7_MAX) {
+        v = SC8Q7_MAX;
+    } else if (v < SC8Q7_MIN) {
+        v = SC8Q7_MIN;
+    }
+
+    return (int8_t)(v >= 0.0f ? v + 0.5f : v - 0.5f);
+}
+
+static inline int8_t sc16q11_to_sc8q7_value(int16_t v)
+{
+    const int r = ((int)v + 8) >> 4;
+
+    if (r > 127) {
+        return 127;
+    } else if (r < -128) {
+        return -128;
+    }
+
+    return (int8_t)r;
+}
+
+void convert_sc16q11_to_cf32(const int16_t *in, float *out, size_t n)
+{
+    /* Number of int16_t/float values, rather than I/Q pairs */
+    const size_t count = 2 * n;
+    size_t i = 0;
+
+#if defined(CONVERT_AVX2)
+    const __m256 scale = _mm256_set1_ps(1.0f / SC16Q11_SCALE);
+
+    for (; i + 8 <= count; i += 8) {
+        __m128i s16 = _mm_loadu_si128((const __m128i *)&in[i]);
+        __m256i s32 = _mm256_cvtepi16_epi32(s16);
+        _mm256_storeu_ps(&out[i], _mm256_mul_ps(_mm256_cvtepi32_ps(s32),
+                                                scale));
+    }
+#elif defined(CONVERT_SSE2)
+    const __m128 scale = _mm_set1_ps(1.0f / SC16Q11_SCALE);
+
+    for (; i + 8 <= count; i += 8) {
+        __m128i s16 = _mm_loadu_si128((const __m128i *)&in[i]);
+
+        /* Sign-extend by placing each value in the upper half of a 32-bit
+         * lane and arithmetically shifting it back down */
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s16, s16), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s16, s16), 16);
+
+        _mm_storeu_ps(&out[i], _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(&out[i + 4], _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+#elif defined(CONVERT_NEON)
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t s16 = vld1q_s16(&in[i]);
+        int32x4_t lo  = vmovl_s16(vget_low_s16(s16));
+        int32x4_t hi  = vmovl_s16(vget_high_s16(s16));
+
+        vst1q_f32(&out[i], vmulq_n_f32(vcvtq_f32_s32(lo),
+                                       1.0f / SC16Q11_SCALE));
+        vst1q_f32(&out[i + 4], vmulq_n_f32(vcvtq_f32_s32(hi),
+                                           1.0f / SC16Q11_SCALE));
+    }
+#endif
+
+    for (; i < count; i++) {
+        out[i] = (float)in[i] * (1.0f / SC16Q11_SCALE);
+    }
+}
+
+void convert_cf32_to_sc16q11(const float *in, int16_t *out, size_t n)
+{
+    const size_t count = 2 * n;
+    size_t i = 0;
+
+#if defined(CONVERT_AVX2)
+    const __m256 scale = _mm256_set1_ps(SC16Q11_SCALE);
+    const __m256 max   = _mm256_set1_ps(SC16Q11_MAX);
+    const __m256 min   = _mm256_set1_ps(SC16Q11_MIN);
+
+    for (; i + 16 <= count; i += 16) {
+        __m256 a = _mm256_mul_ps(_mm256_loadu_ps(&in[i]), scale);
+        __m256 b = _mm256_mul_ps(_mm256_loadu_ps(&in[i + 8]), scale);
+        __m256i packed;
+
+        a = _mm256_max_ps(_mm256_min_ps(a, max), min);
+        b = _mm256_max_ps(_mm256_min_ps(b, max), min);
+
+        /* The pack operates per 128-bit lane, so restore sample order */
+        packed = _mm256_packs_epi32(_mm256_cvtps_epi32(a),
+                                    _mm256_cvtps_epi32(b));
+        packed = _mm256_permute4x64_epi64(packed, 0xd8);
+
+        _mm256_storeu_si256((__m256i *)&out[i], packed);
+    }
+#elif defined(CONVERT_SSE2)
+    const __m128 scale = _mm_set1_ps(SC16Q11_SCALE);
+    const __m128 max   = _mm_set1_ps(SC16Q11_MAX);
+    const __m128 min   = _mm_set1_ps(SC16Q11_MIN);
+
+    for (; i + 8 <= count; i += 8) {
+        __m128 a = _mm_mul_ps(_mm_loadu_ps(&in[i]), scale);
+        __m128 b = _mm_mul_ps(_mm_loadu_ps(&in[i + 4]), scale);
+
+        a = _mm_max_ps(_mm_min_ps(a, max), min);
+        b = _mm_max_ps(_mm_min_ps(b, max), min);
+
+        _mm_storeu_si128((__m128i *)&out[i],
+                         _mm_packs_epi32(_mm_cvtps_epi32(a),
+                                         _mm_cvtps_epi32(b)));
+    }
+#elif defined(CONVERT_NEON)
+    const float32x4_t max = vdupq_n_f32(SC16Q11_MAX);
+    const float32x4_t min = vdupq_n_f32(SC16Q11_MIN);
+
+    for (; i + 8 <= count; i += 8) {
+        float32x4_t a = vmulq_n_f32(vld1q_f32(&in[i]), SC16Q11_SCALE);
+        float32x4_t b = vmulq_n_f32(vld1q_f32(&in[i + 4]), SC16Q11_SCALE);
+
+        a = vmaxq_f32(vminq_f32(a, max), min);
+        b = vmaxq_f32(vminq_f32(b, max), min);
+
+        vst1q_s16(&out[i], vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(a)),
+                                        vqmovn_s32(vcvtnq_s32_f32(b))));
+    }
+#endif
+
+    for (; i < count; i++) {
+        out[i] = cf32_to_sc16q11_value(in[i]);
+    }
+}
+
+/* Sign-extend the 12-bit value v */
+static inline int16_t sc12_value(unsigned int v)
+{
+    return (int16_t)((int)(v ^ 0x800) - 0x800);
+}
+
+void convert_sc12_to_sc16q11(const uint8_t *in, int16_t *out, size_t n)
+{
+    size_t i = 0;
+
+#if defined(CONVERT_PACK_SSSE3)
+    /* Gather each 12-bit value into a 16-bit lane: I from bytes 0-1 and Q
+     * from bytes 1-2 of every 3-byte sample */
+    const __m128i idx = _mm_setr_epi8(0, 1, 1, 2, 3, 4, 4, 5,
+                                      6, 7, 7, 8, 9, 10, 10, 11);
+    /* Moves I up against the sign bit, while Q is already there */
+    const __m128i align = _mm_set1_epi32(0x00010010);
+
+    for (; i + 4 <= n; i += 4) {
+        const uint8_t *p = &in[3 * i];
+        int32_t tail;
+        __m128i v;
+
+        memcpy(&tail, p + 8, sizeof(tail));
+        v = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)p),
+                               _mm_cvtsi32_si128(tail));
+        v = _mm_shuffle_epi8(v, idx);
+        v = _mm_srai_epi16(_mm_mullo_epi16(v, align), 4);
+
+        _mm_storeu_si128((__m128i *)&out[2 * i], v);
+    }
+#elif defined(CONVERT_PACK_NEON)
+    static const uint8_t idx_bytes[16] = { 0, 1, 1, 2, 3, 4, 4, 5,
+                                           6, 7, 7, 8, 9, 10, 10, 11 };
+    static const int16_t align_vals[8] = { 16, 1, 16, 1, 16, 1, 16, 1 };
+    const uint8x16_t idx  = vld1q_u8(idx_bytes);
+    const int16x8_t align = vld1q_s16(align_vals);
+
+    for (; i + 4 <= n; i += 4) {
+        const uint8_t *p = &in[3 * i];
+        uint32_t tail;
+        uint8x16_t v;
+        int16x8_t s;
+
+        memcpy(&tail, p + 8, sizeof(tail));
+        v = vcombine_u8(vld1_u8(p), vreinterpret_u8_u32(vdup_n_u32(tail)));
+        s = vreinterpretq_s16_u8(vqtbl1q_u8(v, idx));
+
+        vst1q_s16(&out[2 * i], vshrq_n_s16(vmulq_s16(s, align), 4));
+    }
+#endif
+
+    for (; i < n; i++) {
+        const uint8_t *p = &in[3 * i];
+
+        out[2 * i]     = sc12_value(p[0] | ((p[1] & 0x0f) << 8));
+        out[2 * i + 1] = sc12_value((p[1] >> 4) | (p[2] << 4));
+    }
+}
+
+void convert_sc16q11_to_sc12(const int16_t *in, uint8_t *out, size_t n)
+{
+    size_t i = 0;
+
+#if defined(CONVERT_PACK_SSSE3)
+    const __m128i mask_i = _mm_set1_epi32(0x00000fff);
+    const __m128i mask_q = _mm_set1_epi32(0x00fff000);
+    /* Drop the unused top byte of each 24-bit sample */
+    const __m128i idx    = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9,
+                                         10, 12, 13, 14, -1, -1, -1, -1);
+
+    for (; i + 4 <= n; i += 4) {
+        uint8_t *p = &out[3 * i];
+        __m128i v  = _mm_loadu_si128((const __m128i *)&in[2 * i]);
+        int32_t tail;
+
+        v = _mm_or_si128(_mm_and_si128(v, mask_i),
+                         _mm_and_si128(_mm_srli_epi32(v, 4), mask_q));
+        v = _mm_shuffle_epi8(v, idx);
+
+        _mm_storel_epi64((__m128i *)p, v);
+        tail = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+        memcpy(p + 8, &tail, sizeof(tail));
+    }
+#elif defined(CONVERT_PACK_NEON)
+    static const uint8_t idx_bytes[16] = { 0, 1, 2, 4, 5, 6, 8, 9,
+                                           10, 12, 13, 14, 255, 255, 255, 255 };
+    const uint8x16_t idx   = vld1q_u8(idx_bytes);
+    const uint32x4_t mask_i = vdupq_n_u32(0x00000fff);
+    const uint32x4_t mask_q = vdupq_n_u32(0x00fff000);
+
+    for (; i + 4 <= n; i += 4) {
+        uint8_t *p   = &out[3 * i];
+        uint32x4_t v = vreinterpretq_u32_s16(vld1q_s16(&in[2 * i]));
+        uint8x16_t b;
+        uint32_t tail;
+
+        v = vorrq_u32(vandq_u32(v, mask_i),
+                      vandq_u32(vshrq_n_u32(v, 4), mask_q));
+        b = vqtbl1q_u8(vreinterpretq_u8_u32(v), idx);
+
+        vst1_u8(p, vget_low_u8(b));
+        tail = vgetq_lane_u32(vreinterpretq_u32_u8(b), 2);
+        memcpy(p + 8, &tail, sizeof(tail));
+    }
+#endif
+
+    for (; i < n; i++) {
+        const unsigned int si = (uint16_t)in[2 * i] & 0x0fff;
+        const unsigned int sq = (uint16_t)in[2 * i + 1] & 0x0fff;
+        uint8_t *p            = &out[3 * i];
+
+        p[0] = (uint8_t)si;
+        p[1] = (uint8_t)((si >> 8) | (sq << 4));
+        p[2] = (uint8_t)(sq >> 4);
+    }
+}
+
+void convert_sc8q7_to_sc16q11(const int8_t *in, int16_t *out, size_t n)
+{
+    const size_t count = 2 * n;
+    size_t i = 0;
+
+#if defined(CONVERT_AVX2)
+    for (; i + 16 <= count; i += 16) {
+        __m128i s8  = _mm_loadu_si128((const __m128i *)&in[i]);
+        __m256i s16 = _mm256_slli_epi16(_mm256_cvtepi8_epi16(s8), 4);
+        _mm256_storeu_si256((__m256i *)&out[i], s16);
+    }
+#elif defined(CONVERT_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i s8 = _mm_loadu_si128((const __m128i *)&in[i]);
+
+        /* Place each value in the upper byte of a 16-bit lane, and shift it
+         * arithmetically down to the scaled position */
+        __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(zero, s8), 4);
+        __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(zero, s8), 4);
+
+        _mm_storeu_si128((__m128i *)&out[i], lo);
+        _mm_storeu_si128((__m128i *)&out[i + 8], hi);
+    }
+#elif defined(CONVERT_NEON)
+    for (; i + 16 <= count; i += 16) {
+        int8x16_t s8 = vld1q_s8(&in[i]);
+
+        vst1q_s16(&out[i], vshll_n_s8(vget_low_s8(s8), 4));
+        vst1q_s16(&out[i + 8], vshll_n_s8(vget_high_s8(s8), 4));
+    }
+#endif
+
+    for (; i < count; i++) {
+        out[i] = (int16_t)(in[i] * 16);
+    }
+}
+
+void convert_sc16q11_to_sc8q7(const int16_t *in, int8_t *out, size_t n)
+{
+    const size_t count = 2 * n;
+    size_t i = 0;
+
+#if defined(CONVERT_AVX2)
+    const __m256i round = _mm256_set1_epi16(8);
+
+    for (; i + 32 <= count; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)&in[i]);
+        __m256i b = _mm256_loadu_si256((const __m256i *)&in[i + 16]);
+        __m256i packed;
+
+        a = _mm256_srai_epi16(_mm256_adds_epi16(a, round), 4);
+        b = _mm256_srai_epi16(_mm256_adds_epi16(b, round), 4);
+
+        /* The pack operates per 128-bit lane, so restore sample order */
+        packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(a, b), 0xd8);
+
+        _mm256_storeu_si256((__m256i *)&out[i], packed);
+    }
+#elif defined(CONVERT_SSE2)
+    const __m128i round = _mm_set1_epi16(8);
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)&in[i]);
+        __m128i b = _mm_loadu_si128((const __m128i *)&in[i + 8]);
+
+        a = _mm_srai_epi16(_mm_adds_epi16(a, round), 4);
+        b = _mm_srai_epi16(_mm_adds_epi16(b, round), 4);
+
+        _mm_storeu_si128((__m128i *)&out[i], _mm_packs_epi16(a, b));
+    }
+#elif defined(CONVERT_NEON)
+    for (; i + 16 <= count; i += 16) {
+        int16x8_t a = vld1q_s16(&in[i]);
+        int16x8_t b = vld1q_s16(&in[i + 8]);
+
+        vst1q_s8(&out[i], vcombine_s8(vqrshrn_n_s16(a, 4),
+                                      vqrshrn_n_s16(b, 4)));
+    }
+#endif
+
+    for (; i < count; i++) {
+        out[i] = sc16q11_to_sc8q7_value(in[i]);
+    }
+}
+
+void convert_sc8q7_to_cf32(const int8_t *in, float *out, size_t n)
+{
+    const size_t count = 2 * n;
+    size_t i = 0;
+
+#if defined(CONVERT_AVX2)
+    const __m256 scale = _mm256_set1_ps(1.0f / SC8Q7_SCALE);
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i s8 = _mm_loadu_si128((const __m128i *)&in[i]);
+        __m256i lo = _mm256_cvtepi8_epi32(s8);
+        __m256i hi = _mm256_cvtepi8_epi32(_mm_srli_si128(s8, 8));
+
+        _mm256_storeu_ps(&out[i], _mm256_mul_ps(_mm256_cvtepi32_ps(lo),
+                                                scale));
+        _mm256_storeu_ps(&out[i + 8], _mm256_mul_ps(_mm256_cvtepi32_ps(hi),
+                                                    scale));
+    }
+#elif defined(CONVERT_SSE2)
+    const __m128 scale = _mm_set1_ps(1.0f / SC8Q7_SCALE);
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i s8 = _mm_loadu_si128((const __m128i *)&in[i]);
+        __m128i s16_lo = _mm_unpacklo_epi8(s8, s8);
+        __m128i s16_hi = _mm_unpackhi_epi8(s8, s8);
+        __m128i s32[4];
+        int j;
+
+        /* Sign-extend by placing each value in the top byte of a 32-bit
+         * lane and arithmetically shifting it back down */
+        s32[0] = _mm_srai_epi32(_mm_unpacklo_epi16(s16_lo, s16_lo), 24);
+        s32[1] = _mm_srai_epi32(_mm_unpackhi_epi16(s16_lo, s16_lo), 24);
+        s32[2] = _mm_srai_epi32(_mm_unpacklo_epi16(s16_hi, s16_hi), 24);
+        s32[3] = _mm_srai_epi32(_mm_unpackhi_epi16(s16_hi, s16_hi), 24);
+
+        for (j = 0; j < 4; j++) {
+            _mm_storeu_ps(&out[i + 4 * j],
+                          _mm_mul_ps(_mm_cvtepi32_ps(s32[j]), scale));
+        }
+    }
+#elif defined(CONVERT_NEON)
+    for (; i + 16 <= count; i += 16) {
+        int8x16_t s8     = vld1q_s8(&in[i]);
+        int16x8_t s16_lo = vmovl_s8(vget_low_s8(s8));
+        int16x8_t s16_hi = vmovl_s8(vget_high_s8(s8));
+        int32x4_t s32[4];
+        int j;
+
+        s32[0] = vmovl_s16(vget_low_s16(s16_lo));
+        s32[1] = vmovl_s16(vget_high_s16(s16_lo));
+        s32[2] = vmovl_s16(vget_low_s16(s16_hi));
+        s32[3] = vmovl_s16(vget_high_s16(s16_hi));
+
+        for (j = 0; j < 4; j++) {
+            vst1q_f32(&out[i + 4 * j], vmulq_n_f32(vcvtq_f32_s32(s32[j]),
+                                                   1.0f / SC8Q7_SCALE));
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        out[i] = (float)in[i] * (1.0f / SC8Q7_SCALE);
+    }
+}
+
+void convert_cf32_to_sc8q7(const float *in, int8_t *out, size_t n)
+{
+    const size_t count = 2 * n;
+    size_t i = 0;
+
+#if defined(CONVERT_AVX2)
+    const __m256 scale = _mm256_set1_ps(SC8Q7_SCALE);
+    const __m256 max   = _mm256_set1_ps(SC8Q7_MAX);
+    const __m256 min   = _mm256_set1_ps(SC8Q7_MIN);
+
+    for (; i + 16 <= count; i += 16) {
+        __m256 a = _mm256_mul_ps(_mm256_loadu_ps(&in[i]), scale);
+        __m256 b = _mm256_mul_ps(_mm256_loadu_ps(&in[i + 8]), scale);
+        __m256i s16;
+
+        a = _mm256_max_ps(_mm256_min_ps(a, max), min);
+        b = _mm256_max_ps(_mm256_min_ps(b, max), min);
+
+        s16 = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+        s16 = _mm256_permute4x64_epi64(s16, 0xd8);
+
+        _mm_storeu_si128((__m128i *)&out[i],
+                         _mm_packs_epi16(_mm256_castsi256_si128(s16),
+                                         _mm256_extracti128_si256(s16, 1)));
+    }
+#elif defined(CONVERT_SSE2)
+    const __m128 scale = _mm_set1_ps(SC8Q7_SCALE);
+    const __m128 max   = _mm_set1_ps(SC8Q7_MAX);
+    const __m128 min   = _mm_set1_ps(SC8Q7_MIN);
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i s32[4];
+        int j;
+
+        for (j = 0; j < 4; j++) {
+            __m128 v = _mm_mul_ps(_mm_loadu_ps(&in[i + 4 * j]), scale);
+            s32[j]   = _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(v, max), min));
+        }
+
+        _mm_storeu_si128((__m128i *)&out[i],
+                         _mm_packs_epi16(_mm_packs_epi32(s32[0], s32[1]),
+                                         _mm_packs_epi32(s32[2], s32[3])));
+    }
+#elif defined(CONVERT_NEON)
+    const float32x4_t max = vdupq_n_f32(SC8Q7_MAX);
+    const float32x4_t min = vdupq_n_f32(SC8Q7_MIN);
+
+    for (; i + 16 <= count; i += 16) {
+        int16x4_t s16[4];
+        int j;
+
+        for (j = 0; j < 4; j++) {
+            float32x4_t v = vmulq_n_f32(vld1q_f32(&in[i + 4 * j]),
+                                        SC8Q7_SCALE);
+            v      = vmaxq_f32(vminq_f32(v, max), min);
+            s16[j] = vqmovn_s32(vcvtnq_s32_f32(v));
+        }
+
+        vst1q_s8(&out[i],
+                 vcombine_s8(vqmovn_s16(vcombine_s16(s16[0], s16[1])),
+                             vqmovn_s16(vcombine_s16(s16[2], s16[3]))));
+    }
+#endif
+
+    for (; i < count; i++) {
+        out[i] = cf32_to_sc8q7_value(in[i]);
+    }
+}
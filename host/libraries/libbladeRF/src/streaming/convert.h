@@ -0,0 +1,116 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Sample conversions used by the sync interface's host-side formats. These
+ * are applied while copying samples out of, or into, the stream buffers, so
+ * callers receive converted samples without an additional pass over them.
+ *
+ * SIMD implementations are selected at compile time: AVX2 when the library
+ * is built with AVX2 enabled, SSE2 on other x86-64 builds, and NEON on
+ * AArch64. Other targets use scalar loops. The 12-bit packing kernels need
+ * a byte shuffle, so on x86 they are only vectorized in SSSE3 and AVX2
+ * builds. Defining LIBBLADERF_NO_SIMD selects the scalar loops on every
+ * target. */
+
+#ifndef STREAMING_CONVERT_H_
+#define STREAMING_CONVERT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Convert SC16Q11 samples to CF32 samples, scaled such that 2048 maps to 1.0
+ *
+ * @param[in]   in      Input samples (interleaved I/Q)
+ * @param[out]  out     Output samples (interleaved I/Q)
+ * @param[in]   n       Number of I/Q sample pairs
+ */
+void convert_sc16q11_to_cf32(const int16_t *in, float *out, size_t n);
+
+/**
+ * Convert CF32 samples to SC16Q11 samples. Values are rounded to the nearest
+ * integer and saturated to [-2048, 2047].
+ *
+ * @param[in]   in      Input samples (interleaved I/Q)
+ * @param[out]  out     Output samples (interleaved I/Q)
+ * @param[in]   n       Number of I/Q sample pairs
+ */
+void convert_cf32_to_sc16q11(const float *in, int16_t *out, size_t n);
+
+/**
+ * Unpack 12-bit packed samples, as carried over USB by the
+ * BLADERF_FORMAT_SC12_PACKED formats, into SC16Q11 samples
+ *
+ * @param[in]   in      Packed samples, 3 bytes per I/Q pair
+ * @param[out]  out     Output samples (interleaved I/Q)
+ * @param[in]   n       Number of I/Q sample pairs
+ */
+void convert_sc12_to_sc16q11(const uint8_t *in, int16_t *out, size_t n);
+
+/**
+ * Pack SC16Q11 samples into the 12-bit packed format. Only the low 12 bits of
+ * each value are kept, so values must be within [-2048, 2047].
+ *
+ * @param[in]   in      Input samples (interleaved I/Q)
+ * @param[out]  out     Packed samples, 3 bytes per I/Q pair
+ * @param[in]   n       Number of I/Q sample pairs
+ */
+void convert_sc16q11_to_sc12(const int16_t *in, uint8_t *out, size_t n);
+
+/**
+ * Convert SC8Q7 samples to SC16Q11 samples, scaled by 16
+ *
+ * @param[in]   in      Input samples (interleaved I/Q)
+ * @param[out]  out     Output samples (interleaved I/Q)
+ * @param[in]   n       Number of I/Q sample pairs
+ */
+void convert_sc8q7_to_sc16q11(const int8_t *in, int16_t *out, size_t n);
+
+/**
+ * Convert SC16Q11 samples to SC8Q7 samples. Values are divided by 16, rounded
+ * to the nearest integer and saturated to [-128, 127].
+ *
+ * @param[in]   in      Input samples (interleaved I/Q)
+ * @param[out]  out     Output samples (interleaved I/Q)
+ * @param[in]   n       Number of I/Q sample pairs
+ */
+void convert_sc16q11_to_sc8q7(const int16_t *in, int8_t *out, size_t n);
+
+/**
+ * Convert SC8Q7 samples to CF32 samples, scaled such that 128 maps to 1.0
+ *
+ * @param[in]   in      Input samples (interleaved I/Q)
+ * @param[out]  out     Output samples (interleaved I/Q)
+ * @param[in]   n       Number of I/Q sample pairs
+ */
+void convert_sc8q7_to_cf32(const int8_t *in, float *out, size_t n);
+
+/**
+ * Convert CF32 samples to SC8Q7 samples. Values are rounded to the nearest
+ * integer and saturated to [-128, 127].
+ *
+ * @param[in]   in      Input samples (interleaved I/Q)
+ * @param[out]  out     Output samples (interleaved I/Q)
+ * @param[in]   n       Number of I/Q sample pairs
+ */
+void convert_cf32_to_sc8q7(const float *in, int8_t *out, size_t n);
+
+#endif
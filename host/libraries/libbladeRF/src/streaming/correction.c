@@ -0,0 +1,300 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdlib.h>
+
+#include "correction.h"
+
+#if defined(LIBBLADERF_NO_SIMD)
+/* Scalar loops only, e.g., to benchmark against */
+#elif defined(__AVX2__)
+#   include <immintrin.h>
+#   define CORR_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define CORR_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#   include <arm_neon.h>
+#   define CORR_NEON
+#endif
+
+#define CORR_Q          12
+#define CORR_ONE        (1 << CORR_Q)
+
+#define CORR_DC_MAX     2048
+#define CORR_COUNT_MAX  4096
+
+/* Phase corrections span [-10, 10] degrees, in radians */
+#define CORR_PHASE_MAX_RAD 0.17453292519943295
+
+/* Largest number of samples per vector, over which the per-lane coefficient
+ * patterns are built */
+#define CORR_PATTERN_SAMPLES 8
+
+bool host_corr_valid(bladerf_correction corr, bladerf_correction_value value)
+{
+    switch (corr) {
+        case BLADERF_CORR_DCOFF_I:
+        case BLADERF_CORR_DCOFF_Q:
+            return value >= -CORR_DC_MAX && value <= CORR_DC_MAX;
+
+        case BLADERF_CORR_PHASE:
+        case BLADERF_CORR_GAIN:
+            return value >= -CORR_COUNT_MAX && value <= CORR_COUNT_MAX;
+
+        default:
+            return false;
+    }
+}
+
+void host_corr_free(struct host_corr *hc)
+{
+    if (hc != NULL) {
+        free(hc->table);
+        free(hc);
+    }
+}
+
+static bladerf_correction_value interpolate(bladerf_correction_value y0,
+                                            bladerf_correction_value y1,
+                                            uint64_t dx, uint64_t span)
+{
+    const int64_t num = (int64_t)(y1 - y0) * (int64_t)dx;
+    const int64_t half = (int64_t)(span / 2);
+
+    /* Round to the nearest integer */
+    return (bladerf_correction_value)(
+        y0 + (num >= 0 ? (num + half) : (num - half)) / (int64_t)span);
+}
+
+void host_corr_apply_table(struct host_corr *hc, bladerf_frequency frequency)
+{
+    const struct bladerf_correction_entry *t = hc->table;
+    const struct bladerf_correction_entry *lo, *hi;
+    unsigned int a = 0, b = hc->table_len;
+    uint64_t dx, span;
+
+    /* Find the first entry at or above the frequency */
+    while (a < b) {
+        const unsigned int mid = a + (b - a) / 2;
+
+        if (t[mid].frequency < frequency) {
+            a = mid + 1;
+        } else {
+            b = mid;
+        }
+    }
+
+    if (a == 0 || a == hc->table_len) {
+        lo = hi = &t[a == 0 ? 0 : hc->table_len - 1];
+    } else {
+        lo = &t[a - 1];
+        hi = &t[a];
+    }
+
+    if (lo == hi || hi->frequency == frequency) {
+        hc->value[BLADERF_CORR_DCOFF_I] = hi->dcoff_i;
+        hc->value[BLADERF_CORR_DCOFF_Q] = hi->dcoff_q;
+        hc->value[BLADERF_CORR_PHASE]   = hi->phase;
+        hc->value[BLADERF_CORR_GAIN]    = hi->gain;
+        return;
+    }
+
+    dx   = frequency - lo->frequency;
+    span = hi->frequency - lo->frequency;
+
+    hc->value[BLADERF_CORR_DCOFF_I] =
+        interpolate(lo->dcoff_i, hi->dcoff_i, dx, span);
+    hc->value[BLADERF_CORR_DCOFF_Q] =
+        interpolate(lo->dcoff_q, hi->dcoff_q, dx, span);
+    hc->value[BLADERF_CORR_PHASE] = interpolate(lo->phase, hi->phase, dx, span);
+    hc->value[BLADERF_CORR_GAIN]  = interpolate(lo->gain, hi->gain, dx, span);
+}
+
+/* tan(x) for |x| <= 10 degrees, whose error here is under 2e-7 */
+static double small_tan(double x)
+{
+    const double x2 = x * x;
+    return x * (1.0 + x2 * (1.0 / 3.0 + x2 * (2.0 / 15.0)));
+}
+
+void host_corr_coeffs(const struct host_corr *hc, struct corr_coeffs *c)
+{
+    double t;
+
+    if (hc == NULL) {
+        c->dc_i = 0;
+        c->dc_q = 0;
+        c->gain = CORR_ONE;
+        c->tan  = 0;
+        return;
+    }
+
+    /* As the FPGA's tan_table, which spans 10 degrees in 4096 steps */
+    t = CORR_ONE * small_tan(CORR_PHASE_MAX_RAD *
+                             hc->value[BLADERF_CORR_PHASE] / CORR_COUNT_MAX);
+
+    c->dc_i = hc->value[BLADERF_CORR_DCOFF_I];
+    c->dc_q = hc->value[BLADERF_CORR_DCOFF_Q];
+    c->gain = (int16_t)(CORR_ONE + hc->value[BLADERF_CORR_GAIN]);
+    c->tan  = (int16_t)(t >= 0.0 ? t + 0.5 : t - 0.5);
+}
+
+static inline int16_t sat16(int32_t v)
+{
+    if (v > INT16_MAX) {
+        return INT16_MAX;
+    } else if (v < INT16_MIN) {
+        return INT16_MIN;
+    }
+
+    return (int16_t)v;
+}
+
+#if defined(CORR_SSE2)
+/* (a * b) >> 12 per 16-bit lane, saturated */
+static inline __m128i mul_q12(__m128i a, __m128i b)
+{
+    const __m128i lo = _mm_mullo_epi16(a, b);
+    const __m128i hi = _mm_mulhi_epi16(a, b);
+
+    return _mm_packs_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), CORR_Q),
+                           _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), CORR_Q));
+}
+#elif defined(CORR_AVX2)
+static inline __m256i mul_q12(__m256i a, __m256i b)
+{
+    const __m256i lo = _mm256_mullo_epi16(a, b);
+    const __m256i hi = _mm256_mulhi_epi16(a, b);
+
+    /* The unpacks and pack both operate per 128-bit lane, so the order of
+     * the values is preserved */
+    return _mm256_packs_epi32(
+        _mm256_srai_epi32(_mm256_unpacklo_epi16(lo, hi), CORR_Q),
+        _mm256_srai_epi32(_mm256_unpackhi_epi16(lo, hi), CORR_Q));
+}
+#elif defined(CORR_NEON)
+static inline int16x8_t mul_q12(int16x8_t a, int16x8_t b)
+{
+    const int32x4_t lo = vmull_s16(vget_low_s16(a), vget_low_s16(b));
+    const int32x4_t hi = vmull_s16(vget_high_s16(a), vget_high_s16(b));
+
+    return vcombine_s16(vqmovn_s32(vshrq_n_s32(lo, CORR_Q)),
+                        vqmovn_s32(vshrq_n_s32(hi, CORR_Q)));
+}
+#endif
+
+void host_corr_sc16q11(const int16_t *in, int16_t *out, size_t n,
+                       const struct corr_coeffs *c,
+                       unsigned int num_channels, unsigned int first)
+{
+    size_t i = 0;
+
+#if defined(CORR_SSE2) || defined(CORR_AVX2) || defined(CORR_NEON)
+    /* Per-lane coefficients. The I lane of a sample is scaled by the gain,
+     * and the Q lane is passed through. The pattern repeats every 1 or 2
+     * samples, so any whole number of vectors may be processed at once. */
+    int16_t dc[2 * CORR_PATTERN_SAMPLES];
+    int16_t gain[2 * CORR_PATTERN_SAMPLES];
+    int16_t tangent[2 * CORR_PATTERN_SAMPLES];
+    unsigned int k;
+
+    for (k = 0; k < CORR_PATTERN_SAMPLES; k++) {
+        const struct corr_coeffs *ck = &c[(first + k) % num_channels];
+
+        dc[2 * k]          = ck->dc_i;
+        dc[2 * k + 1]      = ck->dc_q;
+        gain[2 * k]        = ck->gain;
+        gain[2 * k + 1]    = CORR_ONE;
+        tangent[2 * k]     = ck->tan;
+        tangent[2 * k + 1] = ck->tan;
+    }
+#endif
+
+#if defined(CORR_AVX2)
+    {
+        const __m256i v_dc   = _mm256_loadu_si256((const __m256i *)dc);
+        const __m256i v_gain = _mm256_loadu_si256((const __m256i *)gain);
+        const __m256i v_tan  = _mm256_loadu_si256((const __m256i *)tangent);
+
+        for (; i + 8 <= n; i += 8) {
+            __m256i v = _mm256_loadu_si256((const __m256i *)&in[2 * i]);
+            __m256i swapped;
+
+            v = mul_q12(_mm256_subs_epi16(v, v_dc), v_gain);
+
+            /* Each lane's offset is computed from the other lane of its
+             * sample */
+            swapped = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v, 0xb1),
+                                             0xb1);
+            v = _mm256_adds_epi16(v, mul_q12(swapped, v_tan));
+
+            _mm256_storeu_si256((__m256i *)&out[2 * i], v);
+        }
+    }
+#elif defined(CORR_SSE2)
+    {
+        const __m128i v_dc   = _mm_loadu_si128((const __m128i *)dc);
+        const __m128i v_gain = _mm_loadu_si128((const __m128i *)gain);
+        const __m128i v_tan  = _mm_loadu_si128((const __m128i *)tangent);
+
+        for (; i + 4 <= n; i += 4) {
+            __m128i v = _mm_loadu_si128((const __m128i *)&in[2 * i]);
+            __m128i swapped;
+
+            v = mul_q12(_mm_subs_epi16(v, v_dc), v_gain);
+
+            /* Each lane's offset is computed from the other lane of its
+             * sample */
+            swapped = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xb1), 0xb1);
+            v = _mm_adds_epi16(v, mul_q12(swapped, v_tan));
+
+            _mm_storeu_si128((__m128i *)&out[2 * i], v);
+        }
+    }
+#elif defined(CORR_NEON)
+    {
+        const int16x8_t v_dc   = vld1q_s16(dc);
+        const int16x8_t v_gain = vld1q_s16(gain);
+        const int16x8_t v_tan  = vld1q_s16(tangent);
+
+        for (; i + 4 <= n; i += 4) {
+            int16x8_t v = vld1q_s16(&in[2 * i]);
+
+            v = mul_q12(vqsubq_s16(v, v_dc), v_gain);
+            v = vqaddq_s16(v, mul_q12(vrev32q_s16(v), v_tan));
+
+            vst1q_s16(&out[2 * i], v);
+        }
+    }
+#endif
+
+    for (; i < n; i++) {
+        const struct corr_coeffs *ck = &c[(first + i) % num_channels];
+        const int16_t si = sat16((int32_t)in[2 * i] - ck->dc_i);
+        const int16_t sq = sat16((int32_t)in[2 * i + 1] - ck->dc_q);
+        const int16_t gi = sat16(((int32_t)si * ck->gain) >> CORR_Q);
+
+        out[2 * i]     = sat16(gi + (((int32_t)sq * ck->tan) >> CORR_Q));
+        out[2 * i + 1] = sat16(sq + (((int32_t)gi * ck->tan) >> CORR_Q));
+    }
+}
@@ -0,0 +1,114 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Host-side RX DC offset, IQ gain and phase correction, applied by the
+ * synchronous interface as it copies SC16 Q11 samples out of its stream
+ * buffers. See bladerf_enable_host_correction().
+ *
+ * The math is that of the FPGA's iq_correction block (RX architecture), in
+ * Q12 fixed point:
+ *
+ *      i' = ((I - dc_i) * (4096 + gain)) >> 12
+ *      q' = Q - dc_q
+ *      I_out = i' + ((q' * tan(phase)) >> 12)
+ *      Q_out = q' + ((i' * tan(phase)) >> 12)
+ *
+ * with results saturated to 16 bits, rather than wrapped. */
+
+#ifndef STREAMING_CORRECTION_H_
+#define STREAMING_CORRECTION_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+/* Corrections of a channel, in the units of bladerf_set_correction() */
+struct host_corr {
+    bladerf_correction_value value[4]; /* Indexed by bladerf_correction */
+
+    /* Table applied on retune, sorted by frequency, or NULL */
+    struct bladerf_correction_entry *table;
+    unsigned int table_len;
+};
+
+/* Fixed-point coefficients of a channel's corrections */
+struct corr_coeffs {
+    int16_t dc_i;
+    int16_t dc_q;
+    int16_t gain; /* Q12 */
+    int16_t tan;  /* Q12 */
+};
+
+/**
+ * Check a correction value's range
+ *
+ * @param[in]   corr        Correction
+ * @param[in]   value       Value
+ *
+ * @return true if `value` is valid for `corr`
+ */
+bool host_corr_valid(bladerf_correction corr, bladerf_correction_value value);
+
+/**
+ * Free a channel's corrections, and its table
+ *
+ * @param[in]   hc          Channel corrections, may be NULL
+ */
+void host_corr_free(struct host_corr *hc);
+
+/**
+ * Set a channel's corrections from its table, for the provided frequency.
+ * Corrections between table entries are linearly interpolated, and those
+ * outside of the table take the value of the nearest entry.
+ *
+ * @param[inout]    hc          Channel corrections, with a table
+ * @param[in]       frequency   Frequency the channel is tuned to
+ */
+void host_corr_apply_table(struct host_corr *hc, bladerf_frequency frequency);
+
+/**
+ * Compute the coefficients of a channel's corrections
+ *
+ * @param[in]   hc          Channel corrections, or NULL for none
+ * @param[out]  c           Coefficients
+ */
+void host_corr_coeffs(const struct host_corr *hc, struct corr_coeffs *c);
+
+/**
+ * Correct SC16 Q11 samples
+ *
+ * Sample `k` of `in` belongs to channel `(first + k) % num_channels`. `in`
+ * and `out` may be the same buffer.
+ *
+ * @param[in]   in              Interleaved I/Q samples
+ * @param[out]  out             Corrected samples
+ * @param[in]   n               Number of samples (I/Q pairs)
+ * @param[in]   c               Coefficients of each channel
+ * @param[in]   num_channels    1 or 2
+ * @param[in]   first           Channel of the first sample
+ */
+void host_corr_sc16q11(const int16_t *in, int16_t *out, size_t n,
+                       const struct corr_coeffs *c,
+                       unsigned int num_channels, unsigned int first);
+
+#endif
@@ -64,6 +64,78 @@ static inline size_t bytes_to_sc16q11(size_t n_bytes)
     return n_bytes / sample_size;
 }
 
+/*
+ * Convert CF32 samples to bytes
+ */
+static inline size_t cf32_to_bytes(size_t n_samples)
+{
+    const size_t sample_size = 2 * sizeof(float);
+    assert(n_samples <= (SIZE_MAX / sample_size));
+    return n_samples * sample_size;
+}
+
+/*
+ * Convert bytes to CF32 samples
+ */
+static inline size_t bytes_to_cf32(size_t n_bytes)
+{
+    const size_t sample_size = 2 * sizeof(float);
+    assert((n_bytes % sample_size) == 0);
+    return n_bytes / sample_size;
+}
+
+/*
+ * Convert 12-bit packed samples to bytes
+ */
+static inline size_t sc12_to_bytes(size_t n_samples)
+{
+    const size_t sample_size = 3;
+    assert(n_samples <= (SIZE_MAX / sample_size));
+    return n_samples * sample_size;
+}
+
+/*
+ * Convert bytes to 12-bit packed samples
+ */
+static inline size_t bytes_to_sc12(size_t n_bytes)
+{
+    const size_t sample_size = 3;
+    assert((n_bytes % sample_size) == 0);
+    return n_bytes / sample_size;
+}
+
+/* True for the formats that carry 12-bit packed samples over USB */
+static inline bool format_is_packed(bladerf_format format)
+{
+    return format == BLADERF_FORMAT_SC12_PACKED ||
+           format == BLADERF_FORMAT_SC12_PACKED_META;
+}
+
+/* Format of the samples carried over USB for the provided format. The CF32
+ * formats are converted from/to SC16Q11 on the host, and the SC8Q7_AS_*
+ * formats from/to SC8Q7. */
+static inline bladerf_format wire_format(bladerf_format format)
+{
+    switch (format) {
+        case BLADERF_FORMAT_CF32:
+            return BLADERF_FORMAT_SC16_Q11;
+
+        case BLADERF_FORMAT_CF32_META:
+            return BLADERF_FORMAT_SC16_Q11_META;
+
+        case BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11:
+        case BLADERF_FORMAT_SC8_Q7_AS_CF32:
+            return BLADERF_FORMAT_SC8_Q7;
+
+        case BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META:
+        case BLADERF_FORMAT_SC8_Q7_AS_CF32_META:
+            return BLADERF_FORMAT_SC8_Q7_META;
+
+        default:
+            return format;
+    }
+}
+
 /* Covert samples to bytes based upon the provided format */
 static inline size_t samples_to_bytes(bladerf_format format, size_t n)
 {
@@ -74,8 +146,20 @@ static inline size_t samples_to_bytes(bladerf_format format, size_t n)
 
         case BLADERF_FORMAT_SC16_Q11:
         case BLADERF_FORMAT_SC16_Q11_META:
+        case BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11:
+        case BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META:
             return sc16q11_to_bytes(n);
 
+        case BLADERF_FORMAT_CF32:
+        case BLADERF_FORMAT_CF32_META:
+        case BLADERF_FORMAT_SC8_Q7_AS_CF32:
+        case BLADERF_FORMAT_SC8_Q7_AS_CF32_META:
+            return cf32_to_bytes(n);
+
+        case BLADERF_FORMAT_SC12_PACKED:
+        case BLADERF_FORMAT_SC12_PACKED_META:
+            return sc12_to_bytes(n);
+
         case BLADERF_FORMAT_PACKET_META:
             return n*4;
 
@@ -95,8 +179,20 @@ static inline size_t bytes_to_samples(bladerf_format format, size_t n)
 
         case BLADERF_FORMAT_SC16_Q11:
         case BLADERF_FORMAT_SC16_Q11_META:
+        case BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11:
+        case BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META:
             return bytes_to_sc16q11(n);
 
+        case BLADERF_FORMAT_CF32:
+        case BLADERF_FORMAT_CF32_META:
+        case BLADERF_FORMAT_SC8_Q7_AS_CF32:
+        case BLADERF_FORMAT_SC8_Q7_AS_CF32_META:
+            return bytes_to_cf32(n);
+
+        case BLADERF_FORMAT_SC12_PACKED:
+        case BLADERF_FORMAT_SC12_PACKED_META:
+            return bytes_to_sc12(n);
+
         case BLADERF_FORMAT_PACKET_META:
             return (n+3)/4;
 
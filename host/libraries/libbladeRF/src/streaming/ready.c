@@ -0,0 +1,201 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "host_config.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#if BLADERF_OS_WINDOWS
+#   include <windows.h>
+#elif BLADERF_OS_LINUX
+#   include <sys/eventfd.h>
+#   include <unistd.h>
+#else
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
+
+#include <libbladeRF.h>
+
+#include "log.h"
+
+#include "ready.h"
+
+#if BLADERF_OS_WINDOWS
+
+int sync_ready_open(struct sync_ready *r)
+{
+    if (r->armed) {
+        return 0;
+    }
+
+    /* Manual-reset, such that it stays signalled until the next
+     * sync_ready_clear(), as with the descriptors on other platforms */
+    r->fd = CreateEvent(NULL, TRUE, TRUE, NULL);
+    if (r->fd == NULL) {
+        log_debug("Failed to create event: %lu\n", GetLastError());
+        return BLADERF_ERR_IO;
+    }
+
+    ATOMIC_STORE(&r->armed, 1);
+    return 0;
+}
+
+void sync_ready_close(struct sync_ready *r)
+{
+    if (r->armed) {
+        CloseHandle(r->fd);
+        ATOMIC_STORE(&r->armed, 0);
+    }
+}
+
+void sync_ready_signal(struct sync_ready *r)
+{
+    SetEvent(r->fd);
+}
+
+void sync_ready_clear(struct sync_ready *r)
+{
+    ResetEvent(r->fd);
+}
+
+#elif BLADERF_OS_LINUX
+
+int sync_ready_open(struct sync_ready *r)
+{
+    if (r->armed) {
+        return 0;
+    }
+
+    r->fd = eventfd(1, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (r->fd < 0) {
+        log_debug("Failed to create eventfd: %s\n", strerror(errno));
+        return BLADERF_ERR_IO;
+    }
+
+    ATOMIC_STORE(&r->armed, 1);
+    return 0;
+}
+
+void sync_ready_close(struct sync_ready *r)
+{
+    if (r->armed) {
+        close(r->fd);
+        ATOMIC_STORE(&r->armed, 0);
+    }
+}
+
+void sync_ready_signal(struct sync_ready *r)
+{
+    const uint64_t one = 1;
+    ssize_t n;
+
+    /* This can only fail if the counter would overflow, in which case it is
+     * signalled anyway */
+    n = write(r->fd, &one, sizeof(one));
+    (void)n;
+}
+
+void sync_ready_clear(struct sync_ready *r)
+{
+    uint64_t count;
+    ssize_t n;
+
+    /* Fails with EAGAIN if it was not signalled */
+    n = read(r->fd, &count, sizeof(count));
+    (void)n;
+}
+
+#else
+
+static int set_nonblock_cloexec(int fd)
+{
+    const int flags = fcntl(fd, F_GETFL);
+
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0 ||
+        fcntl(fd, F_SETFD, FD_CLOEXEC) < 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int sync_ready_open(struct sync_ready *r)
+{
+    int fds[2];
+
+    if (r->armed) {
+        return 0;
+    }
+
+    if (pipe(fds) != 0) {
+        log_debug("Failed to create pipe: %s\n", strerror(errno));
+        return BLADERF_ERR_IO;
+    }
+
+    if (set_nonblock_cloexec(fds[0]) != 0 ||
+        set_nonblock_cloexec(fds[1]) != 0) {
+        log_debug("Failed to configure pipe: %s\n", strerror(errno));
+        close(fds[0]);
+        close(fds[1]);
+        return BLADERF_ERR_IO;
+    }
+
+    r->fd = fds[0];
+    r->wr = fds[1];
+
+    sync_ready_signal(r);
+
+    ATOMIC_STORE(&r->armed, 1);
+    return 0;
+}
+
+void sync_ready_close(struct sync_ready *r)
+{
+    if (r->armed) {
+        close(r->fd);
+        close(r->wr);
+        ATOMIC_STORE(&r->armed, 0);
+    }
+}
+
+void sync_ready_signal(struct sync_ready *r)
+{
+    const uint8_t one = 1;
+    ssize_t n;
+
+    /* If the pipe is full, it is already readable */
+    n = write(r->wr, &one, sizeof(one));
+    (void)n;
+}
+
+void sync_ready_clear(struct sync_ready *r)
+{
+    uint8_t buf[64];
+
+    while (read(r->fd, buf, sizeof(buf)) > 0) {
+        /* Drain */
+    }
+}
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Pollable readiness notification for the synchronous interface, handed out
+ * via bladerf_sync_get_ready_fd().
+ *
+ * This is an eventfd on Linux, a manual-reset event on Windows, and the read
+ * end of a non-blocking pipe elsewhere. It is signalled by the stream worker
+ * alongside buffer_mgmt.buf_ready, and cleared by the non-blocking sync calls
+ * before they report ::BLADERF_ERR_WOULD_BLOCK. */
+
+#ifndef STREAMING_READY_H_
+#define STREAMING_READY_H_
+
+#include <libbladeRF.h>
+
+#include "host_config.h"
+#include "thread.h"
+
+struct sync_ready {
+    bladerf_ready_fd fd; /**< Handed out to the caller */
+#if !BLADERF_OS_LINUX && !BLADERF_OS_WINDOWS
+    int wr;              /**< Write end of the pipe */
+#endif
+    unsigned int armed;  /**< Non-zero once opened. Accessed atomically, as
+                          *   it is checked by worker callbacks that do not
+                          *   hold the buffer lock. */
+};
+
+/**
+ * Create the notification object, initially signalled
+ *
+ * @return 0 on success, BLADERF_ERR_IO if it could not be created
+ */
+int sync_ready_open(struct sync_ready *r);
+
+/**
+ * Close the notification object, if it has been opened. The worker must not
+ * be running.
+ */
+void sync_ready_close(struct sync_ready *r);
+
+/**
+ * Signal the notification object. This does not block.
+ */
+void sync_ready_signal(struct sync_ready *r);
+
+/**
+ * Clear any pending signal on the notification object
+ */
+void sync_ready_clear(struct sync_ready *r);
+
+/* Signal the notification object, if one has been opened */
+static inline void sync_ready_notify(struct sync_ready *r)
+{
+    if (ATOMIC_LOAD(&r->armed) != 0) {
+        sync_ready_signal(r);
+    }
+}
+
+#endif
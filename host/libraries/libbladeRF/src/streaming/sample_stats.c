@@ -0,0 +1,213 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <string.h>
+
+#include "sample_stats.h"
+
+#if defined(LIBBLADERF_NO_SIMD)
+/* Scalar loops only, e.g., to benchmark against */
+#elif defined(__SSE2__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define SAMPLE_STATS_SSE2
+#endif
+
+void sample_stats_reset(struct sample_stats *st)
+{
+    memset(st, 0, sizeof(*st));
+}
+
+#ifdef SAMPLE_STATS_SSE2
+
+/* Samples per pass, bounding the 32-bit I/Q sum and clip count lanes */
+#define SAMPLE_STATS_BLOCK  (4 * 16384)
+
+/* Each 128-bit vector holds 4 samples. With 1 or 2 channels, the channel of
+ * each of the 4 sample lanes is the same for every vector, so lanes are
+ * accumulated separately and folded into their channels at the end.
+ *
+ * Returns the number of samples consumed, a multiple of 4. */
+static size_t stats_sse2(struct sample_stats *st,
+                         const int16_t *in,
+                         int16_t *out,
+                         size_t n,
+                         unsigned int num_channels,
+                         unsigned int first,
+                         uint16_t clip)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one  = _mm_set1_epi32(1);
+    const __m128i thr  = _mm_set1_epi16((int16_t)(clip - 1));
+
+    __m128i peak   = zero;
+    __m128i pow_lo = zero; /* 64-bit sums of I^2 + Q^2 for lanes 0 and 1 */
+    __m128i pow_hi = zero; /* ...and for lanes 2 and 3 */
+
+    int64_t sums[8]   = { 0 }; /* I and Q of each lane */
+    uint64_t clips[4] = { 0 };
+    uint64_t pows[4];
+    uint16_t peaks[8];
+    int32_t lanes[8];
+    size_t i = 0;
+    unsigned int j;
+
+    while (i + 4 <= n) {
+        const size_t end = (n - i > SAMPLE_STATS_BLOCK)
+                               ? i + SAMPLE_STATS_BLOCK
+                               : n;
+        __m128i sum_lo  = zero; /* I0 Q0 I1 Q1 */
+        __m128i sum_hi  = zero; /* I2 Q2 I3 Q3 */
+        __m128i clipped = zero;
+
+        for (; i + 4 <= end; i += 4) {
+            const __m128i v = _mm_loadu_si128((const __m128i *)&in[2 * i]);
+            const __m128i a = _mm_max_epi16(v, _mm_subs_epi16(zero, v));
+            const __m128i m = _mm_cmpgt_epi16(a, thr);
+            const __m128i p = _mm_madd_epi16(v, v);
+
+            if (out != NULL) {
+                _mm_storeu_si128((__m128i *)&out[2 * i], v);
+            }
+
+            peak = _mm_max_epi16(peak, a);
+
+            /* A sample is clipped if either half of its lane is set */
+            clipped = _mm_add_epi32(
+                clipped, _mm_andnot_si128(_mm_cmpeq_epi32(m, zero), one));
+
+            /* I^2 + Q^2 <= 2^31, which fits when taken as unsigned */
+            pow_lo = _mm_add_epi64(pow_lo, _mm_unpacklo_epi32(p, zero));
+            pow_hi = _mm_add_epi64(pow_hi, _mm_unpackhi_epi32(p, zero));
+
+            sum_lo = _mm_add_epi32(
+                sum_lo, _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+            sum_hi = _mm_add_epi32(
+                sum_hi, _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16));
+        }
+
+        _mm_storeu_si128((__m128i *)&lanes[0], sum_lo);
+        _mm_storeu_si128((__m128i *)&lanes[4], sum_hi);
+        for (j = 0; j < 8; j++) {
+            sums[j] += lanes[j];
+        }
+
+        _mm_storeu_si128((__m128i *)&lanes[0], clipped);
+        for (j = 0; j < 4; j++) {
+            clips[j] += (uint32_t)lanes[j];
+        }
+    }
+
+    _mm_storeu_si128((__m128i *)&pows[0], pow_lo);
+    _mm_storeu_si128((__m128i *)&pows[2], pow_hi);
+    _mm_storeu_si128((__m128i *)peaks, peak);
+
+    for (j = 0; j < 4; j++) {
+        const unsigned int ch = (first + j) % num_channels;
+        const uint16_t pk = peaks[2 * j] > peaks[2 * j + 1] ? peaks[2 * j]
+                                                            : peaks[2 * j + 1];
+
+        st->count[ch] += i / 4;
+        st->clipped[ch] += clips[j];
+        st->sum_i[ch] += sums[2 * j];
+        st->sum_q[ch] += sums[2 * j + 1];
+        st->sum_power[ch] += pows[j];
+
+        if (pk > st->peak[ch]) {
+            st->peak[ch] = pk;
+        }
+    }
+
+    return i;
+}
+
+#endif
+
+static inline uint16_t abs_sc16(int16_t v)
+{
+    /* Saturate -32768, as _mm_subs_epi16() does */
+    return v < 0 ? (uint16_t)(v == INT16_MIN ? INT16_MAX : -v) : (uint16_t)v;
+}
+
+void sample_stats_sc16(struct sample_stats *st,
+                       const int16_t *in,
+                       int16_t *out,
+                       size_t n,
+                       unsigned int num_channels,
+                       unsigned int first,
+                       uint16_t clip)
+{
+    size_t i = 0;
+
+#ifdef SAMPLE_STATS_SSE2
+    i = stats_sse2(st, in, out, n, num_channels, first, clip);
+#endif
+
+    for (; i < n; i++) {
+        const unsigned int ch = (first + i) % num_channels;
+        const int16_t si = in[2 * i];
+        const int16_t sq = in[2 * i + 1];
+        const uint16_t ai = abs_sc16(si);
+        const uint16_t aq = abs_sc16(sq);
+        const uint16_t pk = ai > aq ? ai : aq;
+
+        if (out != NULL) {
+            out[2 * i]     = si;
+            out[2 * i + 1] = sq;
+        }
+
+        st->count[ch]++;
+        st->sum_i[ch] += si;
+        st->sum_q[ch] += sq;
+        st->sum_power[ch] += (uint32_t)(si * si) + (uint32_t)(sq * sq);
+
+        if (pk >= clip) {
+            st->clipped[ch]++;
+        }
+
+        if (pk > st->peak[ch]) {
+            st->peak[ch] = pk;
+        }
+    }
+}
+
+void sample_stats_get(const struct sample_stats *st,
+                      struct bladerf_rx_stats *stats)
+{
+    unsigned int ch;
+
+    memset(stats, 0, sizeof(*stats));
+
+    for (ch = 0; ch < 2; ch++) {
+        struct bladerf_rx_channel_stats *c = &stats->channel[ch];
+        const double count = (double)st->count[ch];
+
+        c->count   = st->count[ch];
+        c->clipped = st->clipped[ch];
+        c->peak    = st->peak[ch];
+
+        if (st->count[ch] != 0) {
+            c->mean_i     = (double)st->sum_i[ch] / count;
+            c->mean_q     = (double)st->sum_q[ch] / count;
+            c->mean_power = (double)st->sum_power[ch] / count;
+        }
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Per-channel statistics of SC16 Q11 samples, accumulated as the synchronous
+ * interface copies them out of its stream buffers. See
+ * bladerf_set_sync_rx_stats(). */
+
+#ifndef STREAMING_SAMPLE_STATS_H_
+#define STREAMING_SAMPLE_STATS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <libbladeRF.h>
+
+struct sample_stats {
+    uint64_t count[2];
+    uint64_t clipped[2];
+    int64_t sum_i[2];
+    int64_t sum_q[2];
+    uint64_t sum_power[2];
+    uint16_t peak[2];
+};
+
+/**
+ * Clear accumulated statistics
+ *
+ * @param[out]  st          Statistics to clear
+ */
+void sample_stats_reset(struct sample_stats *st);
+
+/**
+ * Accumulate statistics over SC16 Q11 samples, optionally copying them.
+ *
+ * Sample `k` of `in` belongs to channel `(first + k) % num_channels`.
+ *
+ * @param[inout]    st              Statistics to update
+ * @param[in]       in              Interleaved I/Q samples
+ * @param[out]      out             Destination for a copy of `in`, or NULL
+ * @param[in]       n               Number of samples (I/Q pairs)
+ * @param[in]       num_channels    1 or 2
+ * @param[in]       first           Channel of the first sample
+ * @param[in]       clip            |I| or |Q| at or above which a sample is
+ *                                  considered clipped. Must be non-zero.
+ */
+void sample_stats_sc16(struct sample_stats *st,
+                       const int16_t *in,
+                       int16_t *out,
+                       size_t n,
+                       unsigned int num_channels,
+                       unsigned int first,
+                       uint16_t clip);
+
+/**
+ * Convert accumulated statistics to the form returned to API users
+ *
+ * @param[in]   st              Accumulated statistics
+ * @param[out]  stats           Converted statistics
+ */
+void sample_stats_get(const struct sample_stats *st,
+                      struct bladerf_rx_stats *stats);
+
+#endif
@@ -29,36 +29,40 @@
 #define log_verbose(...)
 #endif
 #include "minmax.h"
+#include "conversions.h"
 #include "rel_assert.h"
 
 #include "async.h"
 #include "sync.h"
 #include "sync_worker.h"
 #include "metadata.h"
+#include "convert.h"
 
 #include "board/board.h"
+#include "driver/stream_stats.h"
 #include "helpers/timeout.h"
 #include "helpers/have_cap.h"
+#include "helpers/thread_attrs.h"
+#include "helpers/interleave.h"
+#include "helpers/trace.h"
 
 #ifdef ENABLE_LIBBLADERF_SYNC_LOG_VERBOSE
+/* Buffers shown by dump_buf_states(), which are truncated beyond this so that
+ * it need not allocate */
+#define SYNC_DUMP_MAX_BUFFERS 256
+
 static inline void dump_buf_states(struct bladerf_sync *s)
 {
-    static char *out      = NULL;
+    char out[SYNC_DUMP_MAX_BUFFERS + 1];
     struct buffer_mgmt *b = &s->buf_mgmt;
     char *statestr        = "UNKNOWN";
+    size_t const n        = (b->num_buffers < SYNC_DUMP_MAX_BUFFERS)
+                                ? b->num_buffers
+                                : SYNC_DUMP_MAX_BUFFERS;
 
-    if (out == NULL) {
-        out = malloc((b->num_buffers + 1) * sizeof(char));
-    }
-
-    if (out == NULL) {
-        log_verbose("%s: malloc failed\n");
-        return;
-    }
-
-    out[b->num_buffers] = '\0';
+    out[n] = '\0';
 
-    for (size_t i = 0; i < b->num_buffers; ++i) {
+    for (size_t i = 0; i < n; ++i) {
         switch (b->status[i]) {
             case SYNC_BUFFER_EMPTY:
                 out[i] = '_';
@@ -72,6 +76,12 @@ static inline void dump_buf_states(struct bladerf_sync *s)
             case SYNC_BUFFER_PARTIAL:
                 out[i] = 'o';
                 break;
+            case SYNC_BUFFER_LEASED:
+                out[i] = 'L';
+                break;
+            case SYNC_BUFFER_COMMITTED:
+                out[i] = 'C';
+                break;
         }
     }
 
@@ -100,6 +110,9 @@ static inline void dump_buf_states(struct bladerf_sync *s)
         case SYNC_STATE_WAIT_FOR_BUFFER:
             statestr = "WAIT_FOR_BUFFER";
             break;
+        case SYNC_STATE_USING_LEASE:
+            statestr = "USING_LEASE";
+            break;
     }
 
     log_verbose("%s: %s (%s)\n", __FUNCTION__, out, statestr);
@@ -108,26 +121,647 @@ static inline void dump_buf_states(struct bladerf_sync *s)
 #define dump_buf_states(...)
 #endif  // ENABLE_LIBBLADERF_SYNC_LOG_VERBOSE
 
+static inline bool is_meta_format(bladerf_format format)
+{
+    return format == BLADERF_FORMAT_SC16_Q11_META ||
+           format == BLADERF_FORMAT_SC8_Q7_META ||
+           format == BLADERF_FORMAT_SC12_PACKED_META;
+}
+
 static inline size_t samples2bytes(struct bladerf_sync *s, size_t n) {
     return s->stream_config.bytes_per_sample * n;
 }
 
+static inline size_t user_samples2bytes(struct bladerf_sync *s, size_t n) {
+    return s->stream_config.user_bytes_per_sample * n;
+}
+
+/* True if the caller's samples are in the stream buffer format. Packed
+ * samples are always exchanged with the caller as SC16Q11. */
+static inline bool user_format_is_native(struct bladerf_sync *s)
+{
+    return s->stream_config.user_format == s->stream_config.format &&
+           !format_is_packed(s->stream_config.format);
+}
+
+/* Number of samples converted at a time when the caller's format differs
+ * and channels are also being (de)interleaved. This is small enough for the
+ * intermediate samples to remain in the L1 cache. */
+#define SYNC_CONVERT_BLOCK 512
+
+/* Intermediate samples in the caller's format */
+union sync_convert_block {
+    float cf32[2 * SYNC_CONVERT_BLOCK];
+    int16_t sc16[2 * SYNC_CONVERT_BLOCK];
+};
+
+/* Convert n samples from the stream buffer format to the caller's */
+static inline void convert_from_buf(struct bladerf_sync *s,
+                                    const uint8_t *src, void *dest, size_t n)
+{
+    switch (s->stream_config.user_format) {
+        case BLADERF_FORMAT_SC12_PACKED:
+        case BLADERF_FORMAT_SC12_PACKED_META:
+            convert_sc12_to_sc16q11(src, (int16_t *)dest, n);
+            break;
+
+        case BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11:
+        case BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META:
+            convert_sc8q7_to_sc16q11((const int8_t *)src, (int16_t *)dest, n);
+            break;
+
+        case BLADERF_FORMAT_SC8_Q7_AS_CF32:
+        case BLADERF_FORMAT_SC8_Q7_AS_CF32_META:
+            convert_sc8q7_to_cf32((const int8_t *)src, (float *)dest, n);
+            break;
+
+        default:
+            convert_sc16q11_to_cf32((const int16_t *)src, (float *)dest, n);
+            break;
+    }
+}
+
+/* Convert n samples from the caller's format to the stream buffer format */
+static inline void convert_to_buf(struct bladerf_sync *s,
+                                  const void *src, uint8_t *dest, size_t n)
+{
+    switch (s->stream_config.user_format) {
+        case BLADERF_FORMAT_SC12_PACKED:
+        case BLADERF_FORMAT_SC12_PACKED_META:
+            convert_sc16q11_to_sc12((const int16_t *)src, dest, n);
+            break;
+
+        case BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11:
+        case BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META:
+            convert_sc16q11_to_sc8q7((const int16_t *)src, (int8_t *)dest, n);
+            break;
+
+        case BLADERF_FORMAT_SC8_Q7_AS_CF32:
+        case BLADERF_FORMAT_SC8_Q7_AS_CF32_META:
+            convert_cf32_to_sc8q7((const float *)src, (int8_t *)dest, n);
+            break;
+
+        default:
+            convert_cf32_to_sc16q11((const float *)src, (int16_t *)dest, n);
+            break;
+    }
+}
+
+/* Copy n samples from a stream buffer to the caller's buffer(s), converting
+ * them to the caller's format if needed.
+ *
+ * If num_dest is 1, dest[0] receives the samples as they appear in the
+ * stream. Otherwise, the 2-channel samples are split into dest[0] and
+ * dest[1]. dest_off is the number of samples (all channels) already provided
+ * to the caller. */
+/* Refresh the stream's host-side correction coefficients if those of the
+ * device have changed since they were last computed, or if `force` is set.
+ * Called with s->lock held. */
+static void sync_refresh_correction(struct bladerf_sync *s, bool force)
+{
+    struct bladerf *dev = s->dev;
+    const unsigned int gen =
+        __atomic_load_n(&dev->host_corr_gen, __ATOMIC_ACQUIRE);
+    const bool sc16 = s->stream_config.format == BLADERF_FORMAT_SC16_Q11 ||
+                      s->stream_config.format == BLADERF_FORMAT_SC16_Q11_META;
+    unsigned int i;
+
+    if (!force && gen == s->corr_gen) {
+        return;
+    }
+
+    s->corr_gen    = gen;
+    s->corr_active = false;
+
+    if ((s->stream_config.layout & BLADERF_DIRECTION_MASK) != BLADERF_RX ||
+        !sc16) {
+        return;
+    }
+
+    MUTEX_LOCK(&dev->host_corr_lock);
+
+    for (i = 0; i < s->meta.samples_per_ts && i < ARRAY_SIZE(s->corr); i++) {
+        const struct host_corr *hc = dev->host_corr[i];
+
+        host_corr_coeffs(hc, &s->corr[i]);
+        if (hc != NULL) {
+            s->corr_active = true;
+        }
+    }
+
+    MUTEX_UNLOCK(&dev->host_corr_lock);
+}
+
+/* Copy n samples from a stream buffer to the caller's buffer(s), converting
+ * them to the caller's format if needed. See copy_from_buf(). */
+static void copy_out(struct bladerf_sync *s,
+                     void *const *dest, unsigned int num_dest,
+                     size_t dest_off, const uint8_t *src, size_t n)
+{
+    uint8_t *a, *b;
+
+    if (num_dest == 1) {
+        uint8_t *d = (uint8_t *)dest[0] + user_samples2bytes(s, dest_off);
+
+        if (user_format_is_native(s)) {
+            memcpy(d, src, samples2bytes(s, n));
+        } else {
+            convert_from_buf(s, src, d, n);
+        }
+
+        return;
+    }
+
+    /* Chunks always start on a channel 0 sample and contain whole sample
+     * pairs, as num_samples and the message payloads are multiples of 2 */
+    assert(num_dest == 2 && dest_off % 2 == 0 && n % 2 == 0);
+
+    a = (uint8_t *)dest[0] + user_samples2bytes(s, dest_off / 2);
+    b = (uint8_t *)dest[1] + user_samples2bytes(s, dest_off / 2);
+
+    if (user_format_is_native(s)) {
+        _interleave_deinterleave2(s->stream_config.bytes_per_sample, src, a, b,
+                                  n / 2);
+    } else {
+        union sync_convert_block tmp;
+        size_t i, to_copy;
+
+        for (i = 0; i < n; i += to_copy) {
+            to_copy = min_sz(n - i, SYNC_CONVERT_BLOCK);
+            convert_from_buf(s, src + samples2bytes(s, i), &tmp, to_copy);
+
+            _interleave_deinterleave2(s->stream_config.user_bytes_per_sample,
+                                      &tmp,
+                                      a + user_samples2bytes(s, i / 2),
+                                      b + user_samples2bytes(s, i / 2),
+                                      to_copy / 2);
+        }
+    }
+}
+
+static void copy_from_buf(struct bladerf_sync *s,
+                          void *const *dest, unsigned int num_dest,
+                          size_t dest_off, const uint8_t *src, size_t n)
+{
+    const unsigned int num_ch = s->meta.samples_per_ts;
+    const unsigned int first  = (unsigned int)(dest_off % num_ch);
+    const bool direct = num_dest == 1 && user_format_is_native(s);
+
+    /* Statistics are gathered in the same pass as a plain copy. Otherwise,
+     * the samples are re-read by the correction, conversion or
+     * deinterleaving below while they are still in the cache. Statistics
+     * are always those of the uncorrected samples, so that they reflect
+     * the ADC's range. */
+    if (s->stats_active && direct && !s->corr_active) {
+        sample_stats_sc16(&s->stats, (const int16_t *)src,
+                          (int16_t *)((uint8_t *)dest[0] +
+                                      user_samples2bytes(s, dest_off)),
+                          n, num_ch, first, s->rx_stats_clip);
+        return;
+    } else if (s->stats_active) {
+        sample_stats_sc16(&s->stats, (const int16_t *)src, NULL, n, num_ch,
+                          first, s->rx_stats_clip);
+    }
+
+    if (!s->corr_active) {
+        copy_out(s, dest, num_dest, dest_off, src, n);
+    } else if (direct) {
+        host_corr_sc16q11((const int16_t *)src,
+                          (int16_t *)((uint8_t *)dest[0] +
+                                      user_samples2bytes(s, dest_off)),
+                          n, s->corr, num_ch, first);
+    } else {
+        /* Correct a block at a time, ahead of the conversion or
+         * deinterleaving. SYNC_CONVERT_BLOCK is even, so each block starts
+         * on the same channel as the next sample of the stream. */
+        int16_t tmp[2 * SYNC_CONVERT_BLOCK];
+        size_t i, to_copy;
+
+        for (i = 0; i < n; i += to_copy) {
+            to_copy = min_sz(n - i, SYNC_CONVERT_BLOCK);
+            host_corr_sc16q11((const int16_t *)src + 2 * i, tmp, to_copy,
+                              s->corr, num_ch,
+                              (unsigned int)((first + i) % num_ch));
+            copy_out(s, dest, num_dest, dest_off + i, (const uint8_t *)tmp,
+                     to_copy);
+        }
+    }
+}
+
+/* Copy n samples from the caller's buffer(s) into a stream buffer, converting
+ * them from the caller's format if needed. See copy_from_buf(). */
+static void copy_to_buf(struct bladerf_sync *s,
+                        uint8_t *dest, const void *const *src,
+                        unsigned int num_src, size_t src_off, size_t n)
+{
+    const uint8_t *a, *b;
+
+    if (num_src == 1) {
+        const uint8_t *p = (const uint8_t *)src[0] +
+                           user_samples2bytes(s, src_off);
+
+        if (user_format_is_native(s)) {
+            memcpy(dest, p, samples2bytes(s, n));
+        } else {
+            convert_to_buf(s, p, dest, n);
+        }
+
+        return;
+    }
+
+    assert(num_src == 2 && src_off % 2 == 0 && n % 2 == 0);
+
+    a = (const uint8_t *)src[0] + user_samples2bytes(s, src_off / 2);
+    b = (const uint8_t *)src[1] + user_samples2bytes(s, src_off / 2);
+
+    if (user_format_is_native(s)) {
+        _interleave_interleave2(s->stream_config.bytes_per_sample, a, b, dest,
+                                n / 2);
+    } else {
+        union sync_convert_block tmp;
+        size_t i, to_copy;
+
+        for (i = 0; i < n; i += to_copy) {
+            to_copy = min_sz(n - i, SYNC_CONVERT_BLOCK);
+
+            _interleave_interleave2(s->stream_config.user_bytes_per_sample,
+                                    a + user_samples2bytes(s, i / 2),
+                                    b + user_samples2bytes(s, i / 2),
+                                    &tmp, to_copy / 2);
+
+            convert_to_buf(s, &tmp, dest + samples2bytes(s, i), to_copy);
+        }
+    }
+}
+
 static inline unsigned int msg_per_buf(size_t msg_size, size_t buf_size,
                                        size_t bytes_per_sample)
 {
-    size_t n = buf_size / (msg_size / bytes_per_sample);
+    size_t n = (buf_size * bytes_per_sample) / msg_size;
     assert(n <= UINT_MAX);
     return (unsigned int) n;
 }
 
+/* Packed messages carry whole groups of 8 samples (24 bytes), as the FPGA
+ * packs them into its 64-bit FIFO words, and leave the rest unused */
 static inline unsigned int samples_per_msg(size_t msg_size,
+                                           bladerf_format format,
                                            size_t bytes_per_sample)
 {
     size_t n = (msg_size - METADATA_HEADER_SIZE) / bytes_per_sample;
+
+    if (format_is_packed(format)) {
+        n -= n % 8;
+    }
+
     assert(n <= UINT_MAX);
     return (unsigned int) n;
 }
 
+#ifndef SYNC_AUTO_XFER_US
+#   define SYNC_AUTO_XFER_US 1000       /* Target duration of a transfer */
+#endif
+
+#ifndef SYNC_AUTO_IN_FLIGHT_US
+#   define SYNC_AUTO_IN_FLIGHT_US 8000  /* Target duration of all in-flight
+                                         * transfers */
+#endif
+
+#define SYNC_AUTO_MIN_XFERS 4
+#define SYNC_AUTO_MAX_XFERS 32
+
+/* Select stream parameters for any of `num_buffers`, `buffer_size` and
+ * `num_transfers` that are 0, based upon the current sample rate and USB
+ * bus speed.
+ *
+ * Each transfer is sized to hold roughly SYNC_AUTO_XFER_US worth of
+ * samples, bounded by what the bus can move efficiently. Enough transfers are
+ * kept in flight to ride out SYNC_AUTO_IN_FLIGHT_US of host scheduling
+ * latency. */
+static int autosize_stream(struct bladerf *dev,
+                           bladerf_channel_layout layout,
+                           size_t bytes_per_sample,
+                           unsigned int *num_buffers,
+                           unsigned int *buffer_size,
+                           unsigned int *num_transfers)
+{
+    const bladerf_direction dir = layout & BLADERF_DIRECTION_MASK;
+    const bladerf_channel ch =
+        (dir == BLADERF_RX) ? BLADERF_CHANNEL_RX(0) : BLADERF_CHANNEL_TX(0);
+    const unsigned int num_ch =
+        (layout == BLADERF_RX_X2 || layout == BLADERF_TX_X2) ? 2 : 1;
+
+    /* Buffers must be a multiple of the GPIF DMA size, and hold a whole
+     * number of samples. 3-byte packed samples need three DMA blocks. */
+    const uint64_t granularity = (bytes_per_sample == 3) ? 3 * 4096 : 4096;
+
+    uint64_t min_bytes, max_bytes, bytes_per_sec, buf_bytes, xfer_us;
+    bladerf_sample_rate rate;
+    unsigned int xfers;
+    int status;
+
+    status = dev->board->get_sample_rate(dev, ch, &rate);
+    if (status != 0) {
+        return status;
+    }
+
+    if (dev->board->device_speed(dev) == BLADERF_DEVICE_SPEED_SUPER) {
+        min_bytes = 32 * 1024;
+        max_bytes = 512 * 1024;
+    } else {
+        min_bytes = 8 * 1024;
+        max_bytes = 128 * 1024;
+    }
+
+    bytes_per_sec = (uint64_t)rate * num_ch * bytes_per_sample;
+    if (bytes_per_sec == 0) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    if (*buffer_size == 0) {
+        buf_bytes = bytes_per_sec * SYNC_AUTO_XFER_US / 1000000;
+        buf_bytes = u64_max(min_bytes, u64_min(max_bytes, buf_bytes));
+        buf_bytes = (buf_bytes + granularity - 1) / granularity * granularity;
+        *buffer_size = (unsigned int)(buf_bytes / bytes_per_sample);
+    } else {
+        buf_bytes = (uint64_t)*buffer_size * bytes_per_sample;
+    }
+
+    if (*num_transfers == 0) {
+        xfer_us = u64_max(1, buf_bytes * 1000000 / bytes_per_sec);
+        xfers = (unsigned int)u64_min(SYNC_AUTO_MAX_XFERS,
+                    (SYNC_AUTO_IN_FLIGHT_US + xfer_us - 1) / xfer_us);
+        xfers = uint_max(SYNC_AUTO_MIN_XFERS, xfers);
+
+        /* Leave room for the caller's buffers if they fixed the count */
+        if (*num_buffers != 0) {
+            xfers = uint_min(xfers, uint_max(1, *num_buffers / 2));
+        }
+
+        *num_transfers = xfers;
+    }
+
+    if (*num_buffers == 0) {
+        *num_buffers = 2 * *num_transfers;
+    }
+
+    log_debug("%s: %s @ %u Hz: %u buffers of %u samples, %u transfers\n",
+              __FUNCTION__, direction2str(dir), rate, *num_buffers,
+              *buffer_size, *num_transfers);
+
+    return 0;
+}
+
+#ifndef SYNC_USB2_BYTES_PER_SEC
+#   define SYNC_USB2_BYTES_PER_SEC (36 * 1000 * 1000)   /* Sustainable USB 2.0
+                                                        * bulk throughput */
+#endif
+
+/* Narrower formats that carry the same caller-side samples as `format`, in
+ * order of preference */
+struct sync_adapt_candidate {
+    uint32_t flag;
+    bladerf_format format;
+    uint64_t cap;
+};
+
+static size_t adapt_candidates(bladerf_format format,
+                               struct sync_adapt_candidate *c)
+{
+    switch (format) {
+        case BLADERF_FORMAT_SC16_Q11:
+            c[0] = (struct sync_adapt_candidate){
+                BLADERF_LINK_ADAPT_SC12, BLADERF_FORMAT_SC12_PACKED,
+                BLADERF_CAP_FPGA_SC12_PACKED };
+            c[1] = (struct sync_adapt_candidate){
+                BLADERF_LINK_ADAPT_SC8, BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11,
+                BLADERF_CAP_FPGA_8BIT_SAMPLES };
+            return 2;
+
+        case BLADERF_FORMAT_SC16_Q11_META:
+            c[0] = (struct sync_adapt_candidate){
+                BLADERF_LINK_ADAPT_SC12, BLADERF_FORMAT_SC12_PACKED_META,
+                BLADERF_CAP_FPGA_SC12_PACKED };
+            c[1] = (struct sync_adapt_candidate){
+                BLADERF_LINK_ADAPT_SC8, BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META,
+                BLADERF_CAP_FPGA_8BIT_SAMPLES };
+            return 2;
+
+        case BLADERF_FORMAT_CF32:
+            c[0] = (struct sync_adapt_candidate){
+                BLADERF_LINK_ADAPT_SC8, BLADERF_FORMAT_SC8_Q7_AS_CF32,
+                BLADERF_CAP_FPGA_8BIT_SAMPLES };
+            return 1;
+
+        case BLADERF_FORMAT_CF32_META:
+            c[0] = (struct sync_adapt_candidate){
+                BLADERF_LINK_ADAPT_SC8, BLADERF_FORMAT_SC8_Q7_AS_CF32_META,
+                BLADERF_CAP_FPGA_8BIT_SAMPLES };
+            return 1;
+
+        default:
+            return 0;
+    }
+}
+
+/* Whether a caller-specified buffer size, in samples, suits `format` */
+static bool adapt_buffer_size_ok(bladerf_format format, unsigned int size)
+{
+    const bladerf_format wire = wire_format(format);
+    uint64_t granularity;
+
+    if (size == 0) {
+        return true;
+    }
+
+    if (wire == BLADERF_FORMAT_SC16_Q11 || wire == BLADERF_FORMAT_SC8_Q7) {
+        granularity = ASYNC_PACKET_BYTES;
+    } else {
+        granularity = 4096;
+    }
+
+    return (uint64_t)size * samples_to_bytes(wire, 1) % granularity == 0;
+}
+
+bladerf_format sync_adapt_format(struct bladerf *dev,
+                                 bladerf_channel_layout layout,
+                                 bladerf_format format,
+                                 unsigned int buffer_size,
+                                 uint32_t allowed)
+{
+    const bladerf_direction dir = layout & BLADERF_DIRECTION_MASK;
+    const bladerf_channel ch =
+        (dir == BLADERF_RX) ? BLADERF_CHANNEL_RX(0) : BLADERF_CHANNEL_TX(0);
+    const uint64_t num_ch =
+        (layout == BLADERF_RX_X2 || layout == BLADERF_TX_X2) ? 2 : 1;
+    struct sync_adapt_candidate c[2];
+    bladerf_format chosen = format;
+    bladerf_sample_rate rate;
+    uint64_t bytes_per_sec;
+    size_t n, i;
+
+    if (allowed == 0 ||
+        dev->board->device_speed(dev) != BLADERF_DEVICE_SPEED_HIGH) {
+        return format;
+    }
+
+    n = adapt_candidates(format, c);
+    if (n == 0 || dev->board->get_sample_rate(dev, ch, &rate) != 0) {
+        return format;
+    }
+
+    bytes_per_sec =
+        (uint64_t)rate * num_ch * samples_to_bytes(wire_format(format), 1);
+    if (bytes_per_sec <= SYNC_USB2_BYTES_PER_SEC) {
+        return format;
+    }
+
+    /* Take the widest format that fits, or else the narrowest available */
+    for (i = 0; i < n; i++) {
+        if (!(allowed & c[i].flag) || !have_cap_dev(dev, c[i].cap) ||
+            !adapt_buffer_size_ok(c[i].format, buffer_size)) {
+            continue;
+        }
+
+        chosen        = c[i].format;
+        bytes_per_sec = (uint64_t)rate * num_ch *
+                        samples_to_bytes(wire_format(chosen), 1);
+
+        if (bytes_per_sec <= SYNC_USB2_BYTES_PER_SEC) {
+            break;
+        }
+    }
+
+    if (chosen != format) {
+        log_info("%s: USB 2.0 link: carrying %s samples as %s bits.\n",
+                 direction2str(dir),
+                 (format == BLADERF_FORMAT_CF32 ||
+                  format == BLADERF_FORMAT_CF32_META) ? "CF32" : "SC16 Q11",
+                 format_is_packed(chosen) ? "12" : "8");
+    }
+
+    if (bytes_per_sec > SYNC_USB2_BYTES_PER_SEC) {
+        log_warning("%s: %" PRIu64 " bytes/s likely exceeds the throughput "
+                    "of this USB 2.0 link.\n",
+                    direction2str(dir), bytes_per_sec);
+    }
+
+    return chosen;
+}
+
+/* Allocate the buffer management arrays of a new stream */
+static int sync_alloc_buf_mgmt(struct bladerf_sync *sync)
+{
+    const unsigned int num_buffers = sync->buf_mgmt.num_buffers;
+
+    MUTEX_INIT(&sync->buf_mgmt.lock);
+    pthread_cond_init(&sync->buf_mgmt.buf_ready, NULL);
+
+    sync->buf_mgmt.status = (sync_buffer_status*) malloc(num_buffers * sizeof(sync_buffer_status));
+    if (sync->buf_mgmt.status == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    sync->buf_mgmt.actual_lengths = (size_t *) malloc(num_buffers * sizeof(size_t));
+    if (sync->buf_mgmt.actual_lengths == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    sync->buf_mgmt.discontinuity = (bool *) calloc(num_buffers, sizeof(bool));
+    if (sync->buf_mgmt.discontinuity == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    sync->buf_mgmt.position = (uint64_t *) calloc(num_buffers, sizeof(uint64_t));
+    if (sync->buf_mgmt.position == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    sync->buf_mgmt.host_arrival =
+        (uint64_t *) calloc(num_buffers, sizeof(uint64_t));
+    if (sync->buf_mgmt.host_arrival == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    sync->buf_mgmt.rate_change = (bool *) calloc(num_buffers, sizeof(bool));
+    if (sync->buf_mgmt.rate_change == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    if (sync->buf_mgmt.pool) {
+        sync->buf_mgmt.ready = (unsigned int *) malloc(num_buffers *
+                                                       sizeof(unsigned int));
+        if (sync->buf_mgmt.ready == NULL) {
+            return BLADERF_ERR_MEM;
+        }
+    }
+
+    return 0;
+}
+
+/* Reset the buffer management arrays of a reused stream */
+static void sync_clear_buf_mgmt(struct bladerf_sync *sync)
+{
+    const unsigned int n = sync->buf_mgmt.num_buffers;
+
+    memset(sync->buf_mgmt.discontinuity, 0, n * sizeof(bool));
+    memset(sync->buf_mgmt.position, 0, n * sizeof(uint64_t));
+    memset(sync->buf_mgmt.host_arrival, 0, n * sizeof(uint64_t));
+    memset(sync->buf_mgmt.rate_change, 0, n * sizeof(bool));
+}
+
+/* Free the TX templates of a handle whose stream is not running */
+static void sync_free_templates(struct bladerf_sync *sync)
+{
+    while (sync->templates != NULL) {
+        struct bladerf_tx_template *next = sync->templates->next;
+        free(sync->templates->slab);
+        free(sync->templates);
+        sync->templates = next;
+    }
+}
+
+/* Open the capture tap of an RX stream whose buffers are allocated */
+static int sync_open_tap(struct bladerf_sync *sync)
+{
+    struct bladerf *dev = sync->dev;
+    struct sync_tap_config config;
+    bladerf_sample_rate rate = 0;
+    bladerf_frequency freq   = 0;
+    int status;
+
+    /* These only describe the recording, so a failure is not fatal */
+    if (dev->board->get_sample_rate(dev, BLADERF_CHANNEL_RX(0), &rate) != 0 ||
+        dev->board->get_frequency(dev, BLADERF_CHANNEL_RX(0), &freq) != 0) {
+        log_warning("Failed to get the RX sample rate or frequency of the "
+                    "capture tap\n");
+    }
+
+    memset(&config, 0, sizeof(config));
+    config.path             = sync->tap_path;
+    config.depth            = sync->tap_depth;
+    config.buffers          = sync->buf_mgmt.buffers;
+    config.num_buffers      = sync->buf_mgmt.num_buffers;
+    config.buffer_bytes     = sync->buf_mgmt.buffer_bytes;
+    config.sc8 = sync->stream_config.format == BLADERF_FORMAT_SC8_Q7 ||
+                 sync->stream_config.format == BLADERF_FORMAT_SC8_Q7_META;
+    config.bytes_per_sample = sync->stream_config.bytes_per_sample;
+    config.msg_size         = is_meta_format(sync->stream_config.format)
+                                  ? sync->meta.msg_size
+                                  : 0;
+    config.num_channels     = sync->meta.samples_per_ts;
+    config.sample_rate      = rate;
+    config.frequency        = freq;
+    config.hw               = dev->board->name;
+
+    status = sync_tap_open(&sync->tap, &config);
+    if (status != 0) {
+        log_debug("Failed to open capture tap: %s\n", bladerf_strerror(status));
+    }
+
+    return status;
+}
+
 int sync_init(struct bladerf_sync *sync,
               struct bladerf *dev,
               bladerf_channel_layout layout,
@@ -140,11 +774,12 @@ int sync_init(struct bladerf_sync *sync,
 
 {
     int status = 0;
-    size_t i, bytes_per_sample;
+    size_t i, bytes_per_sample, granularity;
+    const bladerf_format user_format = format;
+    bool reuse;
 
-    if (num_transfers >= num_buffers) {
-        return BLADERF_ERR_INVAL;
-    }
+    /* Host-converted formats are carried in their native equivalent */
+    format = wire_format(user_format);
 
     if (format == BLADERF_FORMAT_PACKET_META) {
         if (!have_cap_dev(dev, BLADERF_CAP_FW_SHORT_PACKET)) {
@@ -168,12 +803,36 @@ int sync_init(struct bladerf_sync *sync,
         }
     }
 
+    if (format_is_packed(format)) {
+        if (!have_cap_dev(dev, BLADERF_CAP_FPGA_SC12_PACKED)) {
+            log_error("FPGA does not support 12bit packed mode. "
+                      "It requires a bladeRF 2.0 Micro with at least "
+                      "FPGA version 0.17.0.\n");
+            return BLADERF_ERR_UNSUPPORTED;
+        }
+    }
+
+    /* The tap records stream samples as-is, and SigMF has no equivalent of
+     * the packed format */
+    if ((layout & BLADERF_DIRECTION_MASK) == BLADERF_RX &&
+        sync->tap_path[0] != '\0' &&
+        (format_is_packed(format) || format == BLADERF_FORMAT_PACKET_META)) {
+        log_error("The capture tap does not support the %s format.\n",
+                  format_is_packed(format) ? "SC12 packed" : "packet meta");
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
     switch (format) {
         case BLADERF_FORMAT_SC8_Q7:
         case BLADERF_FORMAT_SC8_Q7_META:
             bytes_per_sample = 2;
             break;
 
+        case BLADERF_FORMAT_SC12_PACKED:
+        case BLADERF_FORMAT_SC12_PACKED_META:
+            bytes_per_sample = 3;
+            break;
+
         case BLADERF_FORMAT_SC16_Q11:
         case BLADERF_FORMAT_SC16_Q11_META:
         case BLADERF_FORMAT_PACKET_META:
@@ -185,45 +844,149 @@ int sync_init(struct bladerf_sync *sync,
             return BLADERF_ERR_INVAL;
     }
 
-    /* bladeRF GPIF DMA requirement */
-    if ((bytes_per_sample * buffer_size) % 4096 != 0) {
-        assert(!"Invalid buffer size");
-        return BLADERF_ERR_INVAL;
-    }
+    if (num_buffers == 0 || buffer_size == 0 || num_transfers == 0) {
+        unsigned int nbuf = num_buffers;
+        unsigned int size = (unsigned int)buffer_size;
+        unsigned int nxfer = num_transfers;
 
-    /* Deinitialize sync handle if it's initialized */
-    sync_deinit(sync);
+        status = autosize_stream(dev, layout, bytes_per_sample,
+                                 &nbuf, &size, &nxfer);
+        if (status != 0) {
+            log_debug("Failed to select stream parameters: %s\n",
+                      bladerf_strerror(status));
+            return status;
+        }
 
-    MUTEX_INIT(&sync->lock);
+        num_buffers = nbuf;
+        buffer_size = size;
+        num_transfers = nxfer;
+    }
 
-    switch (layout & BLADERF_DIRECTION_MASK) {
-        case BLADERF_TX:
-            sync->buf_mgmt.submitter = SYNC_TX_SUBMITTER_FN;
-            break;
-        case BLADERF_RX:
-            sync->buf_mgmt.submitter = SYNC_TX_SUBMITTER_INVALID;
-            break;
+    if (num_transfers >= num_buffers) {
+        return BLADERF_ERR_INVAL;
     }
 
-    sync->dev = dev;
+    /* bladeRF GPIF DMA requirement. Buffers of the unpacked formats without
+     * metadata may be as short as a bulk packet, for low-latency streaming. */
+    if (format == BLADERF_FORMAT_SC16_Q11 || format == BLADERF_FORMAT_SC8_Q7) {
+        granularity = ASYNC_PACKET_BYTES;
+    } else {
+        granularity = 4096;
+    }
+
+    if ((bytes_per_sample * buffer_size) % granularity != 0) {
+        log_debug("Invalid buffer size: %zu\n", buffer_size);
+        return BLADERF_ERR_INVAL;
+    }
+
+    /* Keep the stream, buffers and worker of a handle whose footprint and
+     * rebuild settings are unchanged, so that reconfiguration need only
+     * update its metadata. Otherwise, deinitialize the handle. */
+    reuse = sync->initialized && !sync->rebuild &&
+            (sync->stream_config.layout & BLADERF_DIRECTION_MASK) ==
+                (layout & BLADERF_DIRECTION_MASK) &&
+            sync->buf_mgmt.num_buffers == num_buffers &&
+            sync->stream_config.num_xfers == num_transfers;
+
+    if (reuse) {
+        reuse = sync_worker_pause(sync) == 0 &&
+                async_reconfigure_stream(sync->worker->stream, format,
+                                         buffer_size) == 0;
+    }
+
+    if (reuse) {
+        log_verbose("%s: Reusing stream buffers\n", __FUNCTION__);
+        sync_free_templates(sync);
+
+        /* The worker is paused, so the tap may complete its recording */
+        sync_tap_close(sync->tap);
+        sync->tap = NULL;
+    } else {
+        sync_deinit(sync);
+        MUTEX_INIT(&sync->lock);
+        sync->rebuild = false;
+    }
+
+    switch (layout & BLADERF_DIRECTION_MASK) {
+        case BLADERF_TX:
+            sync->buf_mgmt.submitter = SYNC_TX_SUBMITTER_FN;
+            break;
+        case BLADERF_RX:
+            sync->buf_mgmt.submitter = SYNC_TX_SUBMITTER_INVALID;
+            break;
+    }
+
+    sync->dev = dev;
     sync->state = SYNC_STATE_CHECK_WORKER;
 
     sync->buf_mgmt.num_buffers = num_buffers;
     sync->buf_mgmt.resubmit_count = 0;
+    sync->buf_mgmt.wait_policy = sync->wait_policy;
+    sync->buf_mgmt.spin_us = sync->spin_us;
+    sync->buf_mgmt.waiters = 0;
+    sync->buf_mgmt.overrun_pending = false;
+    sync->buf_mgmt.rate_change_req = SYNC_RATE_CHANGE_NONE;
+    sync->buf_mgmt.rate_change_pending = false;
+    sync->buf_mgmt.rx_position = 0;
+    sync->buf_mgmt.pool = sync->rx_pool &&
+                          (layout & BLADERF_DIRECTION_MASK) == BLADERF_RX;
+    sync->buf_mgmt.ready_head = 0;
+    sync->buf_mgmt.ready_count = 0;
+    sync->buf_mgmt.tx_pool = sync->tx_pool &&
+                             (layout & BLADERF_DIRECTION_MASK) == BLADERF_TX;
+    sync->buf_mgmt.commit_i = 0;
+    sync->buf_mgmt.committing = false;
+    sync->buf_mgmt.tx_position = 0;
+    memset(&sync->buf_mgmt.stats, 0, sizeof(sync->buf_mgmt.stats));
+
+    /* Statistics are only computed over SC16 Q11 stream samples */
+    sync->stats_active = sync->rx_stats &&
+                         (layout & BLADERF_DIRECTION_MASK) == BLADERF_RX &&
+                         (format == BLADERF_FORMAT_SC16_Q11 ||
+                          format == BLADERF_FORMAT_SC16_Q11_META);
+    sample_stats_reset(&sync->stats);
 
     sync->stream_config.layout = layout;
     sync->stream_config.format = format;
+    sync->stream_config.user_format = user_format;
     sync->stream_config.samples_per_buffer = (unsigned int)buffer_size;
     sync->stream_config.num_xfers = num_transfers;
     sync->stream_config.timeout_ms = stream_timeout;
     sync->stream_config.bytes_per_sample = bytes_per_sample;
+    sync->stream_config.user_bytes_per_sample =
+        format_is_packed(user_format) ? sc16q11_to_bytes(1) :
+        (user_format == format)       ? bytes_per_sample
+                                      : samples_to_bytes(user_format, 1);
+    sync->stream_config.tx_short_bursts =
+        (layout & BLADERF_DIRECTION_MASK) == BLADERF_TX &&
+        is_meta_format(format) &&
+        have_cap_dev(dev, BLADERF_CAP_FW_SHORT_PACKET);
+    sync->stream_config.tx_idle_zero =
+        (layout & BLADERF_DIRECTION_MASK) == BLADERF_TX &&
+        is_meta_format(format) &&
+        have_cap_dev(dev, BLADERF_CAP_FPGA_TX_IDLE_ZERO);
 
     sync->meta.state = SYNC_META_STATE_HEADER;
     sync->meta.msg_size = msg_size;
     sync->meta.msg_per_buf = msg_per_buf(msg_size, buffer_size, bytes_per_sample);
-    sync->meta.samples_per_msg = samples_per_msg(msg_size, bytes_per_sample);
+    sync->meta.samples_per_msg = samples_per_msg(msg_size, format,
+                                                 bytes_per_sample);
     sync->meta.samples_per_ts = (layout == BLADERF_RX_X2 || layout == BLADERF_TX_X2) ? 2:1;
 
+    sync->fpga_xruns_active =
+        have_cap_dev(dev, BLADERF_CAP_FPGA_STREAM_STATS);
+    if (sync->fpga_xruns_active) {
+        uint64_t last;
+
+        status = stream_stats_read(dev, layout & BLADERF_DIRECTION_MASK,
+                                   &sync->fpga_xruns_base, &last);
+        if (status != 0) {
+            goto error;
+        }
+    }
+
+    sync_refresh_correction(sync, true);
+
     log_verbose("%s: Buffer size (in bytes): %u\n",
                 __FUNCTION__, buffer_size * bytes_per_sample);
 
@@ -236,19 +999,13 @@ int sync_init(struct bladerf_sync *sync,
     log_verbose("%s: Samples per msg: %u\n",
                 __FUNCTION__, sync->meta.samples_per_msg);
 
-    MUTEX_INIT(&sync->buf_mgmt.lock);
-    pthread_cond_init(&sync->buf_mgmt.buf_ready, NULL);
-
-    sync->buf_mgmt.status = (sync_buffer_status*) malloc(num_buffers * sizeof(sync_buffer_status));
-    if (sync->buf_mgmt.status == NULL) {
-        status = BLADERF_ERR_MEM;
-        goto error;
-    }
-
-    sync->buf_mgmt.actual_lengths = (size_t *) malloc(num_buffers * sizeof(size_t));
-    if (sync->buf_mgmt.actual_lengths == NULL) {
-        status = BLADERF_ERR_MEM;
-        goto error;
+    if (reuse) {
+        sync_clear_buf_mgmt(sync);
+    } else {
+        status = sync_alloc_buf_mgmt(sync);
+        if (status != 0) {
+            goto error;
+        }
     }
 
     switch (layout & BLADERF_DIRECTION_MASK) {
@@ -287,11 +1044,28 @@ int sync_init(struct bladerf_sync *sync,
             break;
     }
 
-    status = sync_worker_init(sync);
+    if (reuse) {
+        status = sync_worker_update(sync);
+    } else {
+        status = sync_worker_init(sync);
+    }
+
     if (status < 0) {
         goto error;
     }
 
+    /* The worker is idle until the first RX call, so the tap is in place
+     * before any buffer is received */
+    if ((layout & BLADERF_DIRECTION_MASK) == BLADERF_RX &&
+        sync->tap_path[0] != '\0') {
+        status = sync_open_tap(sync);
+        if (status != 0) {
+            /* Tear down the worker and buffers along with the handle */
+            sync->initialized = true;
+            goto error;
+        }
+    }
+
     sync->initialized = true;
 
     return 0;
@@ -312,9 +1086,31 @@ void sync_deinit(struct bladerf_sync *sync)
         sync_worker_deinit(sync->worker, &sync->buf_mgmt.lock,
                            &sync->buf_mgmt.buf_ready);
 
+        /* The stream has been torn down, so the tap may complete its
+         * recording before the buffers are freed */
+        sync_tap_close(sync->tap);
+        sync->tap = NULL;
+
+        sync_ready_close(&sync->buf_mgmt.notify);
+
         if (sync->buf_mgmt.actual_lengths) {
             free(sync->buf_mgmt.actual_lengths);
         }
+
+        free(sync->buf_mgmt.discontinuity);
+        sync->buf_mgmt.discontinuity = NULL;
+        free(sync->buf_mgmt.position);
+        sync->buf_mgmt.position = NULL;
+        free(sync->buf_mgmt.host_arrival);
+        sync->buf_mgmt.host_arrival = NULL;
+        free(sync->buf_mgmt.rate_change);
+        sync->buf_mgmt.rate_change = NULL;
+        free(sync->buf_mgmt.ready);
+        sync->buf_mgmt.ready = NULL;
+
+        /* The stream has been torn down, so no template is in flight */
+        sync_free_templates(sync);
+
         /* De-allocate our buffer management resources */
         if (sync->buf_mgmt.status) {
             MUTEX_DESTROY(&sync->buf_mgmt.lock);
@@ -327,6 +1123,150 @@ void sync_deinit(struct bladerf_sync *sync)
     }
 }
 
+int sync_set_wait_policy(struct bladerf_sync *sync,
+                         bladerf_sync_wait_policy policy,
+                         unsigned int spin_us)
+{
+    switch (policy) {
+        case BLADERF_SYNC_WAIT_BLOCK:
+        case BLADERF_SYNC_WAIT_SPIN:
+            sync->wait_policy = policy;
+            sync->spin_us = spin_us;
+            return 0;
+
+        default:
+            log_debug("Invalid sync wait policy: %d\n", policy);
+            return BLADERF_ERR_INVAL;
+    }
+}
+
+void sync_set_rx_pool(struct bladerf_sync *sync, bool enable)
+{
+    /* The pool's ready FIFO is allocated with the stream */
+    if (sync->rx_pool != enable) {
+        sync->rebuild = true;
+    }
+
+    sync->rx_pool = enable;
+}
+
+void sync_set_tx_pool(struct bladerf_sync *sync, bool enable)
+{
+    sync->tx_pool = enable;
+}
+
+/* Positive full scale of a Q11 sample */
+#define SYNC_STATS_DEFAULT_CLIP 2047
+
+int sync_set_rx_stats(struct bladerf_sync *sync,
+                      bool enable,
+                      unsigned int clip)
+{
+    if (clip > INT16_MAX) {
+        log_debug("Invalid clip threshold: %u\n", clip);
+        return BLADERF_ERR_INVAL;
+    }
+
+    sync->rx_stats      = enable;
+    sync->rx_stats_clip = (clip == 0) ? SYNC_STATS_DEFAULT_CLIP
+                                      : (uint16_t)clip;
+    return 0;
+}
+
+int sync_get_rx_stats(struct bladerf_sync *sync, struct bladerf_rx_stats *stats)
+{
+    int status = 0;
+
+    MUTEX_LOCK(&sync->lock);
+
+    if (sync->stats_active) {
+        sample_stats_get(&sync->stats, stats);
+    } else {
+        status = BLADERF_ERR_UNSUPPORTED;
+    }
+
+    MUTEX_UNLOCK(&sync->lock);
+    return status;
+}
+
+int sync_set_rx_tap(struct bladerf_sync *sync,
+                    const struct bladerf_sync_rx_tap *tap)
+{
+    if (tap == NULL) {
+        sync->tap_path[0] = '\0';
+        return 0;
+    }
+
+    if (tap->path == NULL || tap->path[0] == '\0' ||
+        strlen(tap->path) >= sizeof(sync->tap_path)) {
+        log_debug("Invalid capture tap path\n");
+        return BLADERF_ERR_INVAL;
+    }
+
+    strcpy(sync->tap_path, tap->path);
+    sync->tap_depth = tap->queue_depth;
+    return 0;
+}
+
+unsigned int sync_rx_msg_samples(struct bladerf_sync *sync)
+{
+    if (!sync->initialized || !is_meta_format(sync->stream_config.format) ||
+        sync->meta.samples_per_ts == 0) {
+        return 0;
+    }
+
+    return sync->meta.samples_per_msg / sync->meta.samples_per_ts;
+}
+
+int sync_set_buffer_allocator(struct bladerf_sync *sync,
+                              const struct bladerf_buffer_allocator *allocator)
+{
+    if (allocator == NULL) {
+        if (sync->allocator.alloc != NULL) {
+            sync->rebuild = true;
+        }
+
+        memset(&sync->allocator, 0, sizeof(sync->allocator));
+        return 0;
+    }
+
+    if (allocator->alloc == NULL) {
+        log_debug("Buffer allocator requires an alloc function\n");
+        return BLADERF_ERR_INVAL;
+    }
+
+    sync->allocator = *allocator;
+    sync->rebuild   = true;
+    return 0;
+}
+
+int sync_set_thread_attrs(struct bladerf_sync *sync,
+                          const struct bladerf_thread_attrs *attrs)
+{
+    int status;
+
+    if (attrs == NULL) {
+        if (sync->use_thread_attrs) {
+            sync->rebuild = true;
+        }
+
+        sync->use_thread_attrs = false;
+        thread_attrs_init(&sync->thread_attrs);
+        return 0;
+    }
+
+    status = thread_attrs_validate(attrs);
+    if (status == 0) {
+        sync->thread_attrs = *attrs;
+        sync->use_thread_attrs = thread_attrs_nondefault(attrs);
+
+        /* The attributes are applied by the worker thread as it starts */
+        sync->rebuild = true;
+    }
+
+    return status;
+}
+
 static int wait_for_buffer(struct buffer_mgmt *b,
                            unsigned int timeout_ms,
                            const char *dbg_name,
@@ -359,6 +1299,113 @@ static int wait_for_buffer(struct buffer_mgmt *b,
     return status;
 }
 
+#ifndef SYNC_SPIN_POLLS_PER_CLOCK_CHECK
+#   define SYNC_SPIN_POLLS_PER_CLOCK_CHECK 64
+#endif
+
+/* Busy-poll for buffer `idx` to reach the `desired` status, for up to
+ * b->spin_us. The buffer lock is released while polling.
+ *
+ * Returns true if the buffer reached the desired status. */
+static bool spin_for_buffer(struct buffer_mgmt *b,
+                            unsigned int idx,
+                            sync_buffer_status desired)
+{
+    const uint64_t start = time_now_us();
+    uint64_t now;
+    bool ready = false;
+    unsigned int i;
+
+    if (b->spin_us == 0 || start == 0) {
+        return false;
+    }
+
+    MUTEX_UNLOCK(&b->lock);
+
+    while (!ready) {
+        for (i = 0; i < SYNC_SPIN_POLLS_PER_CLOCK_CHECK && !ready; i++) {
+            CPU_RELAX();
+            ready = (sync_buf_status(b, idx) == desired);
+        }
+
+        if (!ready) {
+            now = time_now_us();
+            if (now == 0 || now < start || now - start >= b->spin_us) {
+                break;
+            }
+        }
+    }
+
+    MUTEX_LOCK(&b->lock);
+
+    return ready;
+}
+
+/* Wait for buffer `idx` to reach the `desired` status, per the configured
+ * wait policy. Assumes the buffer lock is held.
+ *
+ * As with wait_for_buffer(), a return value of 0 does not guarantee the
+ * buffer has reached the desired status; the caller must re-check it. */
+static int wait_for_buffer_status(struct buffer_mgmt *b,
+                                  unsigned int idx,
+                                  sync_buffer_status desired,
+                                  unsigned int timeout_ms,
+                                  const char *dbg_name)
+{
+    int status = 0;
+
+    if (b->wait_policy == BLADERF_SYNC_WAIT_SPIN &&
+        spin_for_buffer(b, idx, desired)) {
+        return 0;
+    }
+
+    /* Register as a waiter before re-checking the status. A callback that
+     * does not hold the buffer lock will either observe us here and signal
+     * buf_ready, or we will observe its status update. */
+    ATOMIC_INC(&b->waiters);
+
+    if (sync_buf_status(b, idx) != desired) {
+        status = wait_for_buffer(b, timeout_ms, dbg_name, idx);
+    }
+
+    ATOMIC_DEC(&b->waiters);
+
+    return status;
+}
+
+/* Used by the non-blocking calls in place of wait_for_buffer_status(), when
+ * buffer `idx` has not reached the `desired` status. Assumes the buffer lock
+ * is held.
+ *
+ * Returns BLADERF_ERR_WOULD_BLOCK if the caller would have to wait. Otherwise,
+ * either the buffer has since reached the desired status, or the worker has
+ * stopped and the caller should go on to check it, and 0 is returned. */
+static int nonblock_check_buffer(struct bladerf_sync *s,
+                                 unsigned int idx,
+                                 sync_buffer_status desired)
+{
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    sync_worker_state worker_state;
+    int stream_error;
+
+    /* Clear the notification before checking again, such that a change in
+     * status after this check signals it again */
+    if (ATOMIC_LOAD(&b->notify.armed) != 0) {
+        sync_ready_clear(&b->notify);
+    }
+
+    if (sync_buf_status(b, idx) == desired) {
+        return 0;
+    }
+
+    worker_state = sync_worker_get_state(s->worker, &stream_error);
+    if (worker_state != SYNC_WORKER_STATE_RUNNING || stream_error != 0) {
+        return 0;
+    }
+
+    return BLADERF_ERR_WOULD_BLOCK;
+}
+
 #ifndef SYNC_WORKER_START_TIMEOUT_MS
 #   define SYNC_WORKER_START_TIMEOUT_MS 250
 #endif
@@ -385,8 +1432,9 @@ static inline void advance_rx_buffer(struct buffer_mgmt *b)
 {
     log_verbose("%s: Marking buf[%u] empty.\n", __FUNCTION__, b->cons_i);
 
-    b->status[b->cons_i] = SYNC_BUFFER_EMPTY;
+    sync_set_buf_status(b, b->cons_i, SYNC_BUFFER_EMPTY);
     b->cons_i = (b->cons_i + 1) % b->num_buffers;
+    sync_stats_consumed(&b->stats);
 }
 
 static inline unsigned int timestamp_to_msg(struct bladerf_sync *s, uint64_t t)
@@ -396,155 +1444,449 @@ static inline unsigned int timestamp_to_msg(struct bladerf_sync *s, uint64_t t)
     return (unsigned int) m;
 }
 
-int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
-            struct bladerf_metadata *user_meta, unsigned int timeout_ms)
+#define RX_META_STATUS_FLAGS (BLADERF_META_FLAG_RX_HW_UNDERFLOW | \
+                              BLADERF_META_FLAG_RX_HW_MINIEXP1 | \
+                              BLADERF_META_FLAG_RX_HW_MINIEXP2)
+
+/* Bulk path for message-aligned reads of the *_META formats. Starting at
+ * `msg`, whose timestamp has already been checked, find the run of up to
+ * `max_msgs` messages with contiguous timestamps, accumulate their status
+ * flags, and copy out their payloads.
+ *
+ * All headers are checked before any samples are copied, so that the copy
+ * is a simple strided pass over the buffer.
+ *
+ * Returns the number of messages consumed. */
+static unsigned int rx_copy_contiguous_msgs(struct bladerf_sync *s,
+                                            void *const *bufs,
+                                            unsigned int num_bufs,
+                                            size_t dest_off,
+                                            const uint8_t *msg,
+                                            unsigned int max_msgs,
+                                            uint32_t *status_flags)
 {
-    struct buffer_mgmt *b;
+    const size_t msg_size         = s->meta.msg_size;
+    const unsigned int per_msg    = s->meta.samples_per_msg;
+    const uint64_t ts_per_msg     = per_msg / s->meta.samples_per_ts;
+    const uint64_t t0             = metadata_get_timestamp(msg);
+    uint32_t flags                = metadata_get_flags(msg);
+    unsigned int n, i;
 
-    int status = 0;
-    bool exit_early = false;
-    bool copied_data = false;
-    unsigned int samples_returned = 0;
-    uint8_t *samples_dest = (uint8_t*)samples;
-    uint8_t *buf_src = NULL;
-    unsigned int samples_to_copy = 0;
-    unsigned int samples_per_buffer = 0;
-    uint64_t target_timestamp = UINT64_MAX;
-    unsigned int pkt_len_dwords = 0;
+    for (n = 1; n < max_msgs; n++) {
+        const uint8_t *hdr = msg + n * msg_size;
 
-    if (s == NULL || samples == NULL) {
-        log_debug("NULL pointer passed to %s\n", __FUNCTION__);
-        return BLADERF_ERR_INVAL;
-    } else if (!s->initialized) {
-        return BLADERF_ERR_INVAL;
-    }
+        if (metadata_get_timestamp(hdr) != t0 + n * ts_per_msg) {
+            break;
+        }
 
-    if (num_samples % s->meta.samples_per_ts != 0) {
-        log_debug("%s: %u samples %% %u channels != 0\n",
-                  __FUNCTION__, num_samples, s->meta.samples_per_ts);
-        return BLADERF_ERR_INVAL;
+        flags |= metadata_get_flags(hdr);
     }
 
-    MUTEX_LOCK(&s->lock);
+    *status_flags |= flags & RX_META_STATUS_FLAGS;
 
-    if (s->stream_config.format == BLADERF_FORMAT_SC16_Q11_META ||
-          s->stream_config.format == BLADERF_FORMAT_SC8_Q7_META ||
-          s->stream_config.format == BLADERF_FORMAT_PACKET_META) {
-        if (user_meta == NULL) {
-            log_debug("NULL metadata pointer passed to %s\n", __FUNCTION__);
-            status = BLADERF_ERR_INVAL;
-            goto out;
-        } else {
-            user_meta->status = 0;
-            target_timestamp = user_meta->timestamp;
-        }
+    for (i = 0; i < n; i++) {
+        copy_from_buf(s, bufs, num_bufs, dest_off + (size_t)i * per_msg,
+                      msg + i * msg_size + METADATA_HEADER_SIZE, per_msg);
     }
 
-    b = &s->buf_mgmt;
-    samples_per_buffer = s->stream_config.samples_per_buffer;
-
-    log_verbose("%s: Requests %u samples.\n", __FUNCTION__, num_samples);
+    return n;
+}
 
-    while (!exit_early && samples_returned < num_samples && status == 0) {
-        dump_buf_states(s);
+/* Executes one step of the RX state machine required to get from
+ * SYNC_STATE_CHECK_WORKER to SYNC_STATE_BUFFER_READY */
+static int rx_wait_step(struct bladerf_sync *s,
+                        unsigned int timeout_ms,
+                        bool nonblock)
+{
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    int status            = 0;
 
-        switch (s->state) {
-            case SYNC_STATE_CHECK_WORKER: {
-                int stream_error;
-                sync_worker_state worker_state =
-                    sync_worker_get_state(s->worker, &stream_error);
-
-                /* Propagate stream error back to the caller.
-                 * They can call this function again to restart the stream and
-                 * try again.
-                 */
-                if (stream_error != 0) {
-                    status = stream_error;
+    switch (s->state) {
+        case SYNC_STATE_CHECK_WORKER: {
+            int stream_error;
+            sync_worker_state worker_state =
+                sync_worker_get_state(s->worker, &stream_error);
+
+            /* Propagate stream error back to the caller.
+             * They can call this function again to restart the stream and
+             * try again.
+             */
+            if (stream_error != 0) {
+                status = stream_error;
+            } else {
+                if (worker_state == SYNC_WORKER_STATE_IDLE) {
+                    log_debug("%s: Worker is idle. Going to reset buf "
+                              "mgmt.\n", __FUNCTION__);
+                    s->state = SYNC_STATE_RESET_BUF_MGMT;
+                } else if (worker_state == SYNC_WORKER_STATE_RUNNING) {
+                    s->state = SYNC_STATE_WAIT_FOR_BUFFER;
                 } else {
-                    if (worker_state == SYNC_WORKER_STATE_IDLE) {
-                        log_debug("%s: Worker is idle. Going to reset buf "
-                                  "mgmt.\n", __FUNCTION__);
-                        s->state = SYNC_STATE_RESET_BUF_MGMT;
-                    } else if (worker_state == SYNC_WORKER_STATE_RUNNING) {
-                        s->state = SYNC_STATE_WAIT_FOR_BUFFER;
-                    } else {
-                        status = BLADERF_ERR_UNEXPECTED;
-                        log_debug("%s: Unexpected worker state=%d\n",
-                                __FUNCTION__, worker_state);
-                    }
+                    status = BLADERF_ERR_UNEXPECTED;
+                    log_debug("%s: Unexpected worker state=%d\n",
+                            __FUNCTION__, worker_state);
                 }
-
-                break;
             }
 
-            case SYNC_STATE_RESET_BUF_MGMT:
-                MUTEX_LOCK(&b->lock);
-                /* When the RX stream starts up, it will submit the first T
-                 * transfers, so the consumer index must be reset to 0 */
-                b->cons_i = 0;
-                MUTEX_UNLOCK(&b->lock);
-                log_debug("%s: Reset buf_mgmt consumer index\n", __FUNCTION__);
-                s->state = SYNC_STATE_START_WORKER;
-                break;
-
+            break;
+        }
 
-            case SYNC_STATE_START_WORKER:
-                sync_worker_submit_request(s->worker, SYNC_WORKER_START);
+        case SYNC_STATE_RESET_BUF_MGMT:
+            MUTEX_LOCK(&b->lock);
+            /* When the RX stream starts up, it will submit the first T
+             * transfers, so the consumer index must be reset to 0 */
+            b->cons_i = 0;
+            MUTEX_UNLOCK(&b->lock);
+            log_debug("%s: Reset buf_mgmt consumer index\n", __FUNCTION__);
+            s->state = SYNC_STATE_START_WORKER;
+            break;
 
-                status = sync_worker_wait_for_state(
-                                                s->worker,
-                                                SYNC_WORKER_STATE_RUNNING,
-                                                SYNC_WORKER_START_TIMEOUT_MS);
+        case SYNC_STATE_START_WORKER:
+            sync_worker_submit_request(s->worker, SYNC_WORKER_START);
 
-                if (status == 0) {
-                    s->state = SYNC_STATE_WAIT_FOR_BUFFER;
-                    log_debug("%s: Worker is now running.\n", __FUNCTION__);
-                } else {
-                    log_debug("%s: Failed to start worker, (%d)\n",
-                              __FUNCTION__, status);
-                }
-                break;
+            status = sync_worker_wait_for_state(
+                                            s->worker,
+                                            SYNC_WORKER_STATE_RUNNING,
+                                            SYNC_WORKER_START_TIMEOUT_MS);
 
-            case SYNC_STATE_WAIT_FOR_BUFFER:
-                MUTEX_LOCK(&b->lock);
+            if (status == 0) {
+                s->state = SYNC_STATE_WAIT_FOR_BUFFER;
+                log_debug("%s: Worker is now running.\n", __FUNCTION__);
+            } else {
+                log_debug("%s: Failed to start worker, (%d)\n",
+                          __FUNCTION__, status);
+            }
+            break;
 
-                /* Check the buffer state, as the worker may have produced one
-                 * since we last queried the status */
-                if (b->status[b->cons_i] == SYNC_BUFFER_FULL) {
-                    s->state = SYNC_STATE_BUFFER_READY;
-                    log_verbose("%s: buffer %u is ready to consume\n",
-                                __FUNCTION__, b->cons_i);
+        case SYNC_STATE_WAIT_FOR_BUFFER:
+            MUTEX_LOCK(&b->lock);
+
+            /* Check the buffer state, as the worker may have produced one
+             * since we last queried the status */
+            if (sync_buf_status(b, b->cons_i) == SYNC_BUFFER_FULL) {
+                s->state = SYNC_STATE_BUFFER_READY;
+                log_verbose("%s: buffer %u is ready to consume\n",
+                            __FUNCTION__, b->cons_i);
+            } else {
+                if (nonblock) {
+                    status = nonblock_check_buffer(s, b->cons_i,
+                                                   SYNC_BUFFER_FULL);
                 } else {
-                    status = wait_for_buffer(b, timeout_ms,
-                                             __FUNCTION__, b->cons_i);
+                    status = wait_for_buffer_status(b, b->cons_i,
+                                                    SYNC_BUFFER_FULL,
+                                                    timeout_ms, __FUNCTION__);
+                }
 
-                    if (status == 0) {
-                        if (b->status[b->cons_i] != SYNC_BUFFER_FULL) {
-                            s->state = SYNC_STATE_CHECK_WORKER;
-                        } else {
-                            s->state = SYNC_STATE_BUFFER_READY;
-                            log_verbose("%s: buffer %u is ready to consume\n",
-                                        __FUNCTION__, b->cons_i);
-                        }
+                if (status == 0) {
+                    if (sync_buf_status(b, b->cons_i) != SYNC_BUFFER_FULL) {
+                        s->state = SYNC_STATE_CHECK_WORKER;
+                    } else {
+                        s->state = SYNC_STATE_BUFFER_READY;
+                        log_verbose("%s: buffer %u is ready to consume\n",
+                                    __FUNCTION__, b->cons_i);
                     }
                 }
+            }
 
-                MUTEX_UNLOCK(&b->lock);
-                break;
+            MUTEX_UNLOCK(&b->lock);
+            break;
+
+        default:
+            assert(!"Invalid state");
+            status = BLADERF_ERR_UNEXPECTED;
+    }
+
+    return status;
+}
+
+static int tx_wait_step(struct bladerf_sync *s,
+                        unsigned int timeout_ms,
+                        bool nonblock);
+
+/* Run the state machine up to the wait for a buffer, as the non-blocking calls
+ * must before checking buffer availability. Only starting the worker may take
+ * a little time. */
+static int nonblock_start_worker(struct bladerf_sync *s, bool rx)
+{
+    int status = 0;
+
+    while (status == 0 && (s->state == SYNC_STATE_CHECK_WORKER ||
+                           s->state == SYNC_STATE_RESET_BUF_MGMT ||
+                           s->state == SYNC_STATE_START_WORKER)) {
+        status = rx ? rx_wait_step(s, 0, true) : tx_wait_step(s, 0, true);
+    }
+
+    return status;
+}
+
+/* Number of samples a sync_rx() or sync_tx() call could transfer without
+ * waiting for a buffer, counted up to at least `limit`. Assumes the buffer
+ * lock is held.
+ *
+ * In states from which such a call would fail without waiting, `limit` is
+ * returned, so that the call goes on to report why. */
+static uint64_t nonblock_available(struct bladerf_sync *s,
+                                   bool rx,
+                                   uint64_t limit)
+{
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    const sync_buffer_status ready = rx ? SYNC_BUFFER_FULL : SYNC_BUFFER_EMPTY;
+    unsigned int idx               = rx ? b->cons_i : b->prod_i;
+    uint64_t per_buf               = s->stream_config.samples_per_buffer;
+    uint64_t avail                 = 0;
+    unsigned int i;
+
+    if (is_meta_format(s->stream_config.format)) {
+        per_buf = (uint64_t)s->meta.samples_per_msg * s->meta.msg_per_buf;
+    }
+
+    switch (s->state) {
+        case SYNC_STATE_WAIT_FOR_BUFFER:
+        case SYNC_STATE_BUFFER_READY:
+            break;
+
+        case SYNC_STATE_USING_BUFFER:
+            avail = s->stream_config.samples_per_buffer - b->partial_off;
+            idx   = (idx + 1) % b->num_buffers;
+            break;
+
+        case SYNC_STATE_USING_BUFFER_META:
+            avail = (uint64_t)s->meta.samples_per_msg *
+                    (s->meta.msg_per_buf - s->meta.msg_num);
+
+            if (s->meta.state == SYNC_META_STATE_SAMPLES) {
+                avail -= s->meta.curr_msg_off;
+            }
+
+            idx = (idx + 1) % b->num_buffers;
+            break;
+
+        default:
+            return limit;
+    }
+
+    /* The partially used buffer, if any, ends the search on wrapping */
+    for (i = 0; i < b->num_buffers && avail < limit; i++) {
+        if (sync_buf_status(b, idx) != ready) {
+            break;
+        }
+
+        avail += per_buf;
+        idx = (idx + 1) % b->num_buffers;
+    }
+
+    return avail;
+}
+
+/* Check that a non-blocking call needing `need` samples of buffer space (TX)
+ * or received samples (RX) can complete without waiting.
+ *
+ * If the worker has stopped, 0 is returned so that the call goes on to
+ * handle that. */
+static int nonblock_check_available(struct bladerf_sync *s,
+                                    bool rx,
+                                    uint64_t need)
+{
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    sync_worker_state worker_state;
+    int stream_error;
+    int status = 0;
+
+    MUTEX_LOCK(&b->lock);
+
+    if (nonblock_available(s, rx, need) < need) {
+        /* As with nonblock_check_buffer() */
+        if (ATOMIC_LOAD(&b->notify.armed) != 0) {
+            sync_ready_clear(&b->notify);
+        }
+
+        if (nonblock_available(s, rx, need) < need) {
+            worker_state = sync_worker_get_state(s->worker, &stream_error);
+            if (worker_state == SYNC_WORKER_STATE_RUNNING &&
+                stream_error == 0) {
+                status = BLADERF_ERR_WOULD_BLOCK;
+            }
+        }
+    }
+
+    MUTEX_UNLOCK(&b->lock);
+
+    return status;
+}
+
+/* Take the rate change mark of RX buffer `idx`. Assumes the buffer lock is
+ * held. */
+static inline bool rx_take_rate_change(struct buffer_mgmt *b, unsigned int idx)
+{
+    const bool marked = b->rate_change[idx];
+
+    b->rate_change[idx] = false;
+
+    return marked;
+}
+
+/* Report the arrival time of the current buffer, from which the first
+ * samples of a sync_rx() call are about to be copied. Assumes the buffer
+ * lock is held. */
+static inline void note_host_arrival(struct buffer_mgmt *b,
+                                     struct bladerf_metadata *user_meta)
+{
+    if (user_meta != NULL) {
+        user_meta->host_timestamp = b->host_arrival[b->cons_i];
+    }
+}
+
+/* Common implementation of sync_rx() and sync_rx_multi(). See
+ * copy_from_buf() for the meaning of bufs and num_bufs. num_samples is the
+ * total for all channels. */
+static int sync_rx_bufs(struct bladerf_sync *s,
+                        void *const *bufs, unsigned int num_bufs,
+                        unsigned int num_samples,
+                        struct bladerf_metadata *user_meta,
+                        unsigned int timeout_ms,
+                        bool nonblock)
+{
+    struct buffer_mgmt *b;
+
+    int status = 0;
+    bool exit_early = false;
+    bool copied_data = false;
+    unsigned int samples_returned = 0;
+    uint8_t *samples_dest = (uint8_t*)bufs[0];
+    uint8_t *buf_src = NULL;
+    unsigned int samples_to_copy = 0;
+    unsigned int msgs_to_copy = 0;
+    unsigned int samples_per_buffer = 0;
+    uint64_t target_timestamp = UINT64_MAX;
+    unsigned int pkt_len_dwords = 0;
+
+    if (s->buf_mgmt.pool) {
+        log_debug("%s: Buffers must be acquired in RX buffer pool mode\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (num_samples % s->meta.samples_per_ts != 0) {
+        log_debug("%s: %u samples %% %u channels != 0\n",
+                  __FUNCTION__, num_samples, s->meta.samples_per_ts);
+        return BLADERF_ERR_INVAL;
+    }
+
+    TRACE_POINT2(sync_rx_entry, (uintptr_t)s, num_samples);
+
+    MUTEX_LOCK(&s->lock);
+
+    sync_refresh_correction(s, false);
+
+    if (s->stats_active) {
+        sample_stats_reset(&s->stats);
+    }
+
+    if (is_meta_format(s->stream_config.format) ||
+          s->stream_config.format == BLADERF_FORMAT_PACKET_META) {
+        if (user_meta == NULL) {
+            log_debug("NULL metadata pointer passed to %s\n", __FUNCTION__);
+            status = BLADERF_ERR_INVAL;
+            goto out;
+        } else {
+            user_meta->status = 0;
+            user_meta->host_timestamp = 0;
+            target_timestamp = user_meta->timestamp;
+        }
+    } else if (user_meta != NULL) {
+        /* Only overruns are reported for the non-metadata formats */
+        user_meta->status = 0;
+        user_meta->host_timestamp = 0;
+    }
+
+    b = &s->buf_mgmt;
+    samples_per_buffer = s->stream_config.samples_per_buffer;
+
+    log_verbose("%s: Requests %u samples.\n", __FUNCTION__, num_samples);
+
+    /* The metadata formats instead return early once they would have to
+     * wait, as the number of buffers needed depends on their timestamps */
+    if (nonblock) {
+        status = nonblock_start_worker(s, true);
+
+        if (status == 0 && !is_meta_format(s->stream_config.format) &&
+            s->stream_config.format != BLADERF_FORMAT_PACKET_META) {
+            status = nonblock_check_available(s, true, num_samples);
+        }
+
+        if (status != 0) {
+            goto out;
+        }
+    }
+
+    while (!exit_early && samples_returned < num_samples && status == 0) {
+        dump_buf_states(s);
+
+        switch (s->state) {
+            case SYNC_STATE_CHECK_WORKER:
+            case SYNC_STATE_RESET_BUF_MGMT:
+            case SYNC_STATE_START_WORKER:
+            case SYNC_STATE_WAIT_FOR_BUFFER:
+                status = rx_wait_step(s, timeout_ms, nonblock);
+
+                /* Return what we have so far, rather than waiting */
+                if (status == BLADERF_ERR_WOULD_BLOCK &&
+                    samples_returned != 0) {
+                    status     = 0;
+                    exit_early = true;
+                }
+                break;
 
             case SYNC_STATE_BUFFER_READY:
                 MUTEX_LOCK(&b->lock);
-                b->status[b->cons_i] = SYNC_BUFFER_PARTIAL;
+
+                /* Samples at a new sample rate start a new call, so that
+                 * their status can be reported */
+                if (b->rate_change[b->cons_i] && user_meta != NULL &&
+                    samples_returned != 0) {
+                    MUTEX_UNLOCK(&b->lock);
+                    exit_early = true;
+                    break;
+                }
+
+                sync_set_buf_status(b, b->cons_i, SYNC_BUFFER_PARTIAL);
                 b->partial_off = 0;
 
+                /* Samples were dropped across the change, so the metadata
+                 * formats pick up from its first message, as they would
+                 * with BLADERF_META_FLAG_RX_NOW */
+                if (rx_take_rate_change(b, b->cons_i) && user_meta != NULL) {
+                    user_meta->status |= BLADERF_META_STATUS_RATE_CHANGE;
+
+                    if (is_meta_format(s->stream_config.format)) {
+                        target_timestamp =
+                            metadata_get_timestamp(b->buffers[b->cons_i]);
+                        user_meta->timestamp = target_timestamp;
+                    }
+                }
+
+                /* The metadata formats detect discontinuities via the
+                 * message timestamps. For the others, report that samples
+                 * were dropped ahead of this buffer. */
+                if (b->discontinuity[b->cons_i]) {
+                    b->discontinuity[b->cons_i] = false;
+
+                    if (user_meta != NULL &&
+                        !is_meta_format(s->stream_config.format) &&
+                        s->stream_config.format != BLADERF_FORMAT_PACKET_META) {
+                        user_meta->status |= BLADERF_META_STATUS_OVERRUN;
+                    }
+                }
+
                 switch (s->stream_config.format) {
                     case BLADERF_FORMAT_SC16_Q11:
                     case BLADERF_FORMAT_SC8_Q7:
+                    case BLADERF_FORMAT_SC12_PACKED:
                         s->state = SYNC_STATE_USING_BUFFER;
                         break;
 
                     case BLADERF_FORMAT_SC16_Q11_META:
                     case BLADERF_FORMAT_SC8_Q7_META:
+                    case BLADERF_FORMAT_SC12_PACKED_META:
                         s->state = SYNC_STATE_USING_BUFFER_META;
                         s->meta.curr_msg_off = 0;
                         s->meta.msg_num = 0;
@@ -565,14 +1907,18 @@ int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
             case SYNC_STATE_USING_BUFFER: /* SC16Q11 buffers w/o metadata */
                 MUTEX_LOCK(&b->lock);
 
+                if (samples_returned == 0) {
+                    note_host_arrival(b, user_meta);
+                }
+
                 buf_src = (uint8_t*)b->buffers[b->cons_i];
 
                 samples_to_copy = uint_min(num_samples - samples_returned,
                                            samples_per_buffer - b->partial_off);
 
-                memcpy(samples_dest + samples2bytes(s, samples_returned),
-                       buf_src + samples2bytes(s, b->partial_off),
-                       samples2bytes(s, samples_to_copy));
+                copy_from_buf(s, bufs, num_bufs, samples_returned,
+                              buf_src + samples2bytes(s, b->partial_off),
+                              samples_to_copy);
 
                 b->partial_off += samples_to_copy;
                 samples_returned += samples_to_copy;
@@ -598,6 +1944,10 @@ int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
             case SYNC_STATE_USING_BUFFER_META: /* SC16Q11 buffers w/ metadata */
                 MUTEX_LOCK(&b->lock);
 
+                if (samples_returned == 0) {
+                    note_host_arrival(b, user_meta);
+                }
+
                 switch (s->meta.state) {
                     case SYNC_META_STATE_HEADER:
 
@@ -605,6 +1955,59 @@ int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
 
                         buf_src = (uint8_t*)b->buffers[b->cons_i];
 
+                        /* If the caller wants whole messages starting right
+                         * here, consume as many as possible in bulk. Any
+                         * discontinuity ends the run, and is then handled
+                         * below on the following pass. */
+                        msgs_to_copy = uint_min(
+                            s->meta.msg_per_buf - s->meta.msg_num,
+                            (num_samples - samples_returned) /
+                                s->meta.samples_per_msg);
+
+                        if (msgs_to_copy > 1) {
+                            const uint8_t *msg =
+                                buf_src + s->meta.msg_size * s->meta.msg_num;
+                            const uint64_t t = metadata_get_timestamp(msg);
+                            const bool now =
+                                (user_meta->flags & BLADERF_META_FLAG_RX_NOW);
+
+                            if (copied_data ? (t == s->meta.curr_timestamp)
+                                            : (now || t == target_timestamp)) {
+                                msgs_to_copy = rx_copy_contiguous_msgs(
+                                    s, bufs, num_bufs, samples_returned, msg,
+                                    msgs_to_copy, &user_meta->status);
+
+                                samples_to_copy =
+                                    msgs_to_copy * s->meta.samples_per_msg;
+
+                                if (!copied_data && now) {
+                                    user_meta->timestamp = t;
+                                }
+
+                                copied_data = true;
+                                samples_returned += samples_to_copy;
+
+                                s->meta.curr_timestamp =
+                                    t + samples_to_copy / s->meta.samples_per_ts;
+                                target_timestamp = s->meta.curr_timestamp;
+
+                                log_verbose("%s: Copied %u messages in bulk, "
+                                            "t=%llu\n", __FUNCTION__,
+                                            msgs_to_copy, (unsigned long long)
+                                            s->meta.curr_timestamp);
+
+                                s->meta.msg_num += msgs_to_copy;
+                                if (s->meta.msg_num >= s->meta.msg_per_buf) {
+                                    assert(s->meta.msg_num ==
+                                           s->meta.msg_per_buf);
+                                    advance_rx_buffer(b);
+                                    s->meta.msg_num = 0;
+                                    s->state = SYNC_STATE_WAIT_FOR_BUFFER;
+                                }
+                                break;
+                            }
+                        }
+
                         s->meta.curr_msg =
                             buf_src + s->meta.msg_size * s->meta.msg_num;
 
@@ -614,10 +2017,8 @@ int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
                         s->meta.msg_flags =
                             metadata_get_flags(s->meta.curr_msg);
 
-                        user_meta->status |= s->meta.msg_flags &
-                           (BLADERF_META_FLAG_RX_HW_UNDERFLOW |
-                              BLADERF_META_FLAG_RX_HW_MINIEXP1 |
-                              BLADERF_META_FLAG_RX_HW_MINIEXP2);
+                        user_meta->status |=
+                            s->meta.msg_flags & RX_META_STATUS_FLAGS;
 
                         s->meta.curr_msg_off = 0;
 
@@ -668,11 +2069,11 @@ int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
                                 uint_min(num_samples - samples_returned,
                                          left_in_msg(s));
 
-                            memcpy(samples_dest + samples2bytes(s, samples_returned),
+                            copy_from_buf(s, bufs, num_bufs, samples_returned,
                                    s->meta.curr_msg +
                                         METADATA_HEADER_SIZE +
                                         samples2bytes(s, s->meta.curr_msg_off),
-                                   samples2bytes(s, samples_to_copy));
+                                   samples_to_copy);
 
                             samples_returned += samples_to_copy;
                             s->meta.curr_msg_off += samples_to_copy;
@@ -764,6 +2165,10 @@ int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
             case SYNC_STATE_USING_PACKET_META: /* Packet buffers w/ metadata */
                 MUTEX_LOCK(&b->lock);
 
+                if (samples_returned == 0) {
+                    note_host_arrival(b, user_meta);
+                }
+
                 buf_src = (uint8_t*)b->buffers[b->cons_i];
 
                 pkt_len_dwords = metadata_get_packet_len(buf_src);
@@ -779,7 +2184,10 @@ int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
                 MUTEX_UNLOCK(&b->lock);
                 break;
 
-
+            case SYNC_STATE_USING_LEASE:
+                assert(!"Invalid RX state");
+                status = BLADERF_ERR_UNEXPECTED;
+                break;
         }
     }
 
@@ -790,20 +2198,97 @@ int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
 out:
     MUTEX_UNLOCK(&s->lock);
 
+    TRACE_POINT3(sync_rx_return, (uintptr_t)s, status, samples_returned);
+
     return status;
 }
 
-/* Assumes buffer lock is held */
-static int advance_tx_buffer(struct bladerf_sync *s, struct buffer_mgmt *b)
+int sync_rx(struct bladerf_sync *s, void *samples, unsigned num_samples,
+            struct bladerf_metadata *user_meta, unsigned int timeout_ms)
+{
+    if (s == NULL || samples == NULL) {
+        log_debug("NULL pointer passed to %s\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (!s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_rx_bufs(s, &samples, 1, num_samples, user_meta, timeout_ms,
+                        false);
+}
+
+/* Validate the per-channel buffer array of sync_rx_multi()/sync_tx_multi()
+ * and compute the total number of samples */
+static int check_multi_bufs(struct bladerf_sync *s, const void *const *bufs,
+                            unsigned int num_samples, unsigned int *total)
+{
+    const unsigned int num_ch = s->meta.samples_per_ts;
+    unsigned int i;
+
+    if (s->stream_config.format == BLADERF_FORMAT_PACKET_META) {
+        log_debug("Per-channel buffers are not supported with the "
+                  "packet meta format\n");
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    for (i = 0; i < num_ch; i++) {
+        if (bufs[i] == NULL) {
+            log_debug("NULL buffer provided for channel %u\n", i);
+            return BLADERF_ERR_INVAL;
+        }
+    }
+
+    if (num_samples > UINT_MAX / num_ch) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    *total = num_samples * num_ch;
+    return 0;
+}
+
+int sync_rx_multi(struct bladerf_sync *s, void *const *bufs,
+                  unsigned int num_samples,
+                  struct bladerf_metadata *user_meta, unsigned int timeout_ms)
+{
+    unsigned int total;
+    int status;
+
+    if (s == NULL || bufs == NULL) {
+        log_debug("NULL pointer passed to %s\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (!s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = check_multi_bufs(s, (const void *const *)bufs, num_samples,
+                              &total);
+    if (status != 0) {
+        return status;
+    }
+
+    status = sync_rx_bufs(s, bufs, s->meta.samples_per_ts, total, user_meta,
+                          timeout_ms, false);
+
+    if (status == 0 && user_meta != NULL) {
+        user_meta->actual_count /= s->meta.samples_per_ts;
+    }
+
+    return status;
+}
+
+/* Hand buffer `idx` off for transmission, either by submitting it or by
+ * leaving it to the worker callback. Assumes buffer lock is held. */
+static int submit_tx_buffer(struct bladerf_sync *s,
+                            struct buffer_mgmt *b,
+                            unsigned int idx)
 {
     int status = 0;
-    const unsigned int idx = b->prod_i;
 
     if (b->submitter == SYNC_TX_SUBMITTER_FN) {
         /* Mark buffer in flight because we're going to send it out.
          * This ensures that if the callback fires before this function
          * completes, its state will be correct. */
-        b->status[idx] = SYNC_BUFFER_IN_FLIGHT;
+        sync_set_buf_status(b, idx, SYNC_BUFFER_IN_FLIGHT);
 
         /* This call may block and it results in a per-stream lock being held,
          * so the buffer lock must be dropped.
@@ -813,7 +2298,8 @@ static int advance_tx_buffer(struct bladerf_sync *s, struct buffer_mgmt *b)
          */
         MUTEX_UNLOCK(&b->lock);
         size_t len;
-        if (s->stream_config.format == BLADERF_FORMAT_PACKET_META) {
+        if (s->stream_config.format == BLADERF_FORMAT_PACKET_META ||
+            s->stream_config.tx_short_bursts) {
            len = b->actual_lengths[idx];
         } else {
            len = async_stream_buf_bytes(s->worker->stream);
@@ -834,7 +2320,7 @@ static int advance_tx_buffer(struct bladerf_sync *s, struct buffer_mgmt *b)
                         __FUNCTION__, idx);
 
             /* Mark this buffer as being full of data, but not in flight */
-            b->status[idx] = SYNC_BUFFER_FULL;
+            sync_set_buf_status(b, idx, SYNC_BUFFER_FULL);
 
             /* Assign callback the duty of submitting deferred buffers,
              * and use buffer_mgmt.cons_i to denote which it should submit
@@ -847,7 +2333,7 @@ static int advance_tx_buffer(struct bladerf_sync *s, struct buffer_mgmt *b)
             status = 0;
         } else {
             /* Unmark this as being in flight */
-            b->status[idx] = SYNC_BUFFER_FULL;
+            sync_set_buf_status(b, idx, SYNC_BUFFER_FULL);
 
             log_debug("%s: Failed to submit buf[%u].\n", __FUNCTION__, idx);
             return status;
@@ -855,7 +2341,23 @@ static int advance_tx_buffer(struct bladerf_sync *s, struct buffer_mgmt *b)
     } else {
         /* We are not submitting this buffer; this is deffered to the worker
          * call back. Just update its state to being full of samples. */
-        b->status[idx] = SYNC_BUFFER_FULL;
+        sync_set_buf_status(b, idx, SYNC_BUFFER_FULL);
+    }
+
+    sync_stats_produced(&b->stats);
+
+    return status;
+}
+
+/* Assumes buffer lock is held */
+static int advance_tx_buffer(struct bladerf_sync *s, struct buffer_mgmt *b)
+{
+    const unsigned int idx = b->prod_i;
+    int status;
+
+    status = submit_tx_buffer(s, b, idx);
+    if (status != 0) {
+        return status;
     }
 
     /* Advance "producer" insertion index. */
@@ -897,7 +2399,8 @@ static inline int handle_tx_parameters(struct bladerf_metadata *user_meta,
                                        struct bladerf_sync *s,
                                        struct tx_options *options)
 {
-    if (s->stream_config.format == BLADERF_FORMAT_SC16_Q11_META) {
+    if (s->stream_config.format == BLADERF_FORMAT_SC16_Q11_META ||
+        s->stream_config.format == BLADERF_FORMAT_SC12_PACKED_META) {
         if (user_meta == NULL) {
             log_debug("NULL metadata pointer passed to %s\n", __FUNCTION__);
             return BLADERF_ERR_INVAL;
@@ -956,32 +2459,176 @@ static inline int handle_tx_parameters(struct bladerf_metadata *user_meta,
     return 0;
 }
 
-int sync_tx(struct bladerf_sync *s,
-            void const *samples,
-            unsigned int num_samples,
-            struct bladerf_metadata *user_meta,
-            unsigned int timeout_ms)
+/* Executes one step of the TX state machine required to get from
+ * SYNC_STATE_CHECK_WORKER to SYNC_STATE_BUFFER_READY */
+static int tx_wait_step(struct bladerf_sync *s,
+                        unsigned int timeout_ms,
+                        bool nonblock)
 {
-    struct buffer_mgmt *b = NULL;
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    int status            = 0;
 
-    int status                      = 0;
-    unsigned int samples_written    = 0;
-    unsigned int samples_to_copy    = 0;
-    unsigned int samples_per_buffer = 0;
-    uint8_t const *samples_src      = (uint8_t const *)samples;
-    uint8_t *buf_dest               = NULL;
-    struct tx_options op            = {
-        FIELD_INIT(.flush, false), FIELD_INIT(.zero_pad, false),
-    };
+    switch (s->state) {
+        case SYNC_STATE_CHECK_WORKER: {
+            int stream_error;
+            sync_worker_state worker_state =
+                sync_worker_get_state(s->worker, &stream_error);
 
-    log_verbose("%s: called for %u samples.\n", __FUNCTION__, num_samples);
+            if (stream_error != 0) {
+                status = stream_error;
+            } else {
+                if (worker_state == SYNC_WORKER_STATE_IDLE) {
+                    /* No need to reset any buffer management for TX since
+                     * the TX stream does not submit an initial set of
+                     * buffers.  Therefore the RESET_BUF_MGMT state is
+                     * skipped here. */
+                    s->state = SYNC_STATE_START_WORKER;
+                } else {
+                    /* Worker is running - continue onto checking for and
+                     * potentially waiting for an available buffer */
+                    s->state = SYNC_STATE_WAIT_FOR_BUFFER;
+                }
+            }
+            break;
+        }
 
-    if (s == NULL || samples == NULL || !s->initialized) {
-        return BLADERF_ERR_INVAL;
-    }
+        case SYNC_STATE_RESET_BUF_MGMT:
+            assert(!"Bug");
+            break;
+
+        case SYNC_STATE_START_WORKER:
+            sync_worker_submit_request(s->worker, SYNC_WORKER_START);
+
+            status = sync_worker_wait_for_state(
+                s->worker, SYNC_WORKER_STATE_RUNNING,
+                SYNC_WORKER_START_TIMEOUT_MS);
+
+            if (status == 0) {
+                s->state = SYNC_STATE_WAIT_FOR_BUFFER;
+                log_debug("%s: Worker is now running.\n", __FUNCTION__);
+            }
+            break;
+
+        case SYNC_STATE_WAIT_FOR_BUFFER:
+            MUTEX_LOCK(&b->lock);
+
+            /* Check the buffer state, as the worker may have consumed one
+             * since we last queried the status */
+            if (sync_buf_status(b, b->prod_i) == SYNC_BUFFER_EMPTY) {
+                s->state = SYNC_STATE_BUFFER_READY;
+            } else if (nonblock) {
+                status = nonblock_check_buffer(s, b->prod_i,
+                                               SYNC_BUFFER_EMPTY);
+
+                if (status == 0 &&
+                    sync_buf_status(b, b->prod_i) != SYNC_BUFFER_EMPTY) {
+                    s->state = SYNC_STATE_CHECK_WORKER;
+                }
+            } else {
+                status = wait_for_buffer_status(b, b->prod_i,
+                                                SYNC_BUFFER_EMPTY, timeout_ms,
+                                                __FUNCTION__);
+            }
+
+            MUTEX_UNLOCK(&b->lock);
+            break;
+
+        default:
+            assert(!"Invalid state");
+            status = BLADERF_ERR_UNEXPECTED;
+    }
+
+    return status;
+}
+
+/* Upper bound on the buffer space, in samples, that a sync_tx() call may use,
+ * including any zero padding it is asked to insert, and the flushing of the
+ * rest of the buffer (and perhaps a message of the next) at the end of a
+ * burst */
+static uint64_t tx_nonblock_need(struct bladerf_sync *s,
+                                 unsigned int num_samples,
+                                 const struct bladerf_metadata *user_meta)
+{
+    uint64_t need = num_samples;
+
+    if (user_meta == NULL || !is_meta_format(s->stream_config.format)) {
+        return need;
+    }
+
+    if ((user_meta->flags & BLADERF_META_FLAG_TX_UPDATE_TIMESTAMP) &&
+        !(user_meta->flags & BLADERF_META_FLAG_TX_BURST_START) &&
+        user_meta->timestamp > s->meta.curr_timestamp) {
+        const uint64_t delta = user_meta->timestamp - s->meta.curr_timestamp;
+
+        if (delta > UINT32_MAX) {
+            return UINT64_MAX;
+        }
+
+        need += delta * s->meta.samples_per_ts;
+    }
+
+    if (user_meta->flags & BLADERF_META_FLAG_TX_BURST_END) {
+        need += (uint64_t)s->meta.samples_per_msg * s->meta.msg_per_buf;
+    }
+
+    return need;
+}
+
+/* Short transfers ending a burst are kept to a multiple of this many bytes,
+ * as with full buffers, for the sake of the GPIF DMA */
+#define SYNC_TX_SHORT_ALIGN 4096
+
+/* Common implementation of sync_tx() and sync_tx_multi(). See
+ * copy_to_buf() for the meaning of bufs and num_bufs. num_samples is the
+ * total for all channels. */
+static int sync_tx_bufs(struct bladerf_sync *s,
+                        const void *const *bufs, unsigned int num_bufs,
+                        unsigned int num_samples,
+                        struct bladerf_metadata *user_meta,
+                        unsigned int timeout_ms,
+                        bool nonblock)
+{
+    struct buffer_mgmt *b = NULL;
+
+    int status                      = 0;
+    unsigned int samples_written    = 0;
+    unsigned int samples_to_copy    = 0;
+    unsigned int samples_per_buffer = 0;
+    uint8_t const *samples_src      = (uint8_t const *)bufs[0];
+    uint8_t *buf_dest               = NULL;
+    bool tail_zeroed                = false;
+    struct tx_options op            = {
+        FIELD_INIT(.flush, false), FIELD_INIT(.zero_pad, false),
+    };
+
+    log_verbose("%s: called for %u samples.\n", __FUNCTION__, num_samples);
+
+    TRACE_POINT2(sync_tx_entry, (uintptr_t)s, num_samples);
+
+    if (s->buf_mgmt.tx_pool) {
+        log_debug("%s: Buffers must be reserved in TX buffer pool mode\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
 
     MUTEX_LOCK(&s->lock);
 
+    /* Checked before acting upon the metadata, so that the call may simply
+     * be repeated */
+    if (nonblock) {
+        status = nonblock_start_worker(s, false);
+
+        if (status == 0 &&
+            !(is_meta_format(s->stream_config.format) && user_meta == NULL)) {
+            status = nonblock_check_available(
+                s, false, tx_nonblock_need(s, num_samples, user_meta));
+        }
+
+        if (status != 0) {
+            goto out;
+        }
+    }
+
     status = handle_tx_parameters(user_meta, s, &op);
     if (status != 0) {
         goto out;
@@ -992,74 +2639,34 @@ int sync_tx(struct bladerf_sync *s,
 
     while (status == 0 && ((samples_written < num_samples) || op.flush)) {
         switch (s->state) {
-            case SYNC_STATE_CHECK_WORKER: {
-                int stream_error;
-                sync_worker_state worker_state =
-                    sync_worker_get_state(s->worker, &stream_error);
-
-                if (stream_error != 0) {
-                    status = stream_error;
-                } else {
-                    if (worker_state == SYNC_WORKER_STATE_IDLE) {
-                        /* No need to reset any buffer management for TX since
-                         * the TX stream does not submit an initial set of
-                         * buffers.  Therefore the RESET_BUF_MGMT state is
-                         * skipped here. */
-                        s->state = SYNC_STATE_START_WORKER;
-                    } else {
-                        /* Worker is running - continue onto checking for and
-                         * potentially waiting for an available buffer */
-                        s->state = SYNC_STATE_WAIT_FOR_BUFFER;
-                    }
-                }
-                break;
-            }
-
+            case SYNC_STATE_CHECK_WORKER:
             case SYNC_STATE_RESET_BUF_MGMT:
-                assert(!"Bug");
-                break;
-
             case SYNC_STATE_START_WORKER:
-                sync_worker_submit_request(s->worker, SYNC_WORKER_START);
-
-                status = sync_worker_wait_for_state(
-                    s->worker, SYNC_WORKER_STATE_RUNNING,
-                    SYNC_WORKER_START_TIMEOUT_MS);
-
-                if (status == 0) {
-                    s->state = SYNC_STATE_WAIT_FOR_BUFFER;
-                    log_debug("%s: Worker is now running.\n", __FUNCTION__);
-                }
-                break;
-
             case SYNC_STATE_WAIT_FOR_BUFFER:
-                MUTEX_LOCK(&b->lock);
-
-                /* Check the buffer state, as the worker may have consumed one
-                 * since we last queried the status */
-                if (b->status[b->prod_i] == SYNC_BUFFER_EMPTY) {
-                    s->state = SYNC_STATE_BUFFER_READY;
-                } else {
-                    status =
-                        wait_for_buffer(b, timeout_ms, __FUNCTION__, b->prod_i);
-                }
+                status = tx_wait_step(s, timeout_ms, nonblock);
+                break;
 
-                MUTEX_UNLOCK(&b->lock);
+            case SYNC_STATE_USING_LEASE:
+                log_debug("%s: TX buffer is currently lent out. Call "
+                          "sync_tx_submit() first.\n", __FUNCTION__);
+                status = BLADERF_ERR_INVAL;
                 break;
 
             case SYNC_STATE_BUFFER_READY:
                 MUTEX_LOCK(&b->lock);
-                b->status[b->prod_i] = SYNC_BUFFER_PARTIAL;
+                sync_set_buf_status(b, b->prod_i, SYNC_BUFFER_PARTIAL);
                 b->partial_off       = 0;
 
                 switch (s->stream_config.format) {
                     case BLADERF_FORMAT_SC16_Q11:
                     case BLADERF_FORMAT_SC8_Q7:
+                    case BLADERF_FORMAT_SC12_PACKED:
                         s->state = SYNC_STATE_USING_BUFFER;
                         break;
 
                     case BLADERF_FORMAT_SC16_Q11_META:
                     case BLADERF_FORMAT_SC8_Q7_META:
+                    case BLADERF_FORMAT_SC12_PACKED_META:
                         s->state             = SYNC_STATE_USING_BUFFER_META;
                         s->meta.curr_msg_off = 0;
                         s->meta.msg_num      = 0;
@@ -1087,9 +2694,8 @@ int sync_tx(struct bladerf_sync *s,
                 samples_to_copy = uint_min(num_samples - samples_written,
                                            samples_per_buffer - b->partial_off);
 
-                memcpy(buf_dest + samples2bytes(s, b->partial_off),
-                       samples_src + samples2bytes(s, samples_written),
-                       samples2bytes(s, samples_to_copy));
+                copy_to_buf(s, buf_dest + samples2bytes(s, b->partial_off),
+                            bufs, num_bufs, samples_written, samples_to_copy);
 
                 b->partial_off += samples_to_copy;
                 samples_written += samples_to_copy;
@@ -1186,8 +2792,12 @@ int sync_tx(struct bladerf_sync *s,
                              * zero-fill the message to fulfil this "three zero
                              * sample" requirement, and set the timestamp
                              * appropriately at the following message.
+                             *
+                             * An FPGA that zeroes the DAC itself once samples
+                             * stop lifts this requirement.
                              */
-                            if (to_zero < 3 && left_in_msg(s) == 0) {
+                            if (to_zero < 3 && left_in_msg(s) == 0 &&
+                                !s->stream_config.tx_idle_zero) {
                                 s->meta.curr_timestamp += to_zero;
                                 log_verbose("Ended msg with < 3 zero samples. "
                                             "Padding into next message.\n");
@@ -1203,11 +2813,11 @@ int sync_tx(struct bladerf_sync *s,
                         if (samples_to_copy != 0) {
                             /* We have user data to copy into the current
                              * message within the buffer */
-                            memcpy(s->meta.curr_msg + METADATA_HEADER_SIZE +
-                                       samples2bytes(s, s->meta.curr_msg_off),
-                                   samples_src +
-                                       samples2bytes(s, samples_written),
-                                   samples2bytes(s, samples_to_copy));
+                            copy_to_buf(s, s->meta.curr_msg +
+                                        METADATA_HEADER_SIZE +
+                                        samples2bytes(s, s->meta.curr_msg_off),
+                                   bufs, num_bufs, samples_written,
+                                   samples_to_copy);
 
                             s->meta.curr_msg_off += samples_to_copy;
                             if (s->stream_config.layout == BLADERF_TX_X2)
@@ -1216,6 +2826,7 @@ int sync_tx(struct bladerf_sync *s,
                                s->meta.curr_timestamp += samples_to_copy;
 
                             samples_written += samples_to_copy;
+                            tail_zeroed = false;
 
                             log_verbose("%s: Copied %u samples. "
                                         "Current message offset is now: %u\n",
@@ -1247,6 +2858,18 @@ int sync_tx(struct bladerf_sync *s,
 
                             s->meta.curr_msg_off += to_zero;
                             s->meta.curr_timestamp += to_zero;
+
+                            /* The DAC requires the burst to end with at
+                             * least three zero samples (see above). */
+                            tail_zeroed = (to_zero >= 3);
+                        }
+
+                        /* An FPGA that zeroes the DAC itself lets the
+                         * burst end on its last sample. */
+                        if (op.flush && s->stream_config.tx_idle_zero &&
+                            samples_written == num_samples &&
+                            left_in_msg(s) == 0) {
+                            tail_zeroed = true;
                         }
 
                         if (left_in_msg(s) == 0) {
@@ -1257,9 +2880,37 @@ int sync_tx(struct bladerf_sync *s,
                                         __FUNCTION__, s->meta.msg_num);
                         }
 
-                        if (s->meta.msg_num >= s->meta.msg_per_buf) {
+                        /* When the firmware supports short transfers, end
+                         * the burst with the messages filled so far, rather
+                         * than zero-filling the remainder of the buffer. If
+                         * the burst didn't end with enough zeros, or the
+                         * length isn't suitably aligned, keep on flushing
+                         * whole messages until it is. */
+                        if (op.flush && tail_zeroed &&
+                            s->stream_config.tx_short_bursts &&
+                            s->meta.state == SYNC_META_STATE_HEADER &&
+                            s->meta.msg_num < s->meta.msg_per_buf &&
+                            (s->meta.msg_num * s->meta.msg_size) %
+                                    SYNC_TX_SHORT_ALIGN == 0) {
+                            b->actual_lengths[b->prod_i] =
+                                s->meta.msg_num * s->meta.msg_size;
+
+                            log_verbose("%s: Submitting %u of %u messages\n",
+                                        __FUNCTION__, s->meta.msg_num,
+                                        s->meta.msg_per_buf);
+
+                            status = advance_tx_buffer(s, b);
+
+                            s->meta.msg_num = 0;
+                            s->state        = SYNC_STATE_WAIT_FOR_BUFFER;
+                            op.flush        = false;
+                            tail_zeroed     = false;
+                        } else if (s->meta.msg_num >= s->meta.msg_per_buf) {
                             assert(s->meta.msg_num == s->meta.msg_per_buf);
 
+                            b->actual_lengths[b->prod_i] =
+                                async_stream_buf_bytes(s->worker->stream);
+
                             /* Submit buffer of samples for transmission */
                             status = advance_tx_buffer(s, b);
 
@@ -1308,7 +2959,8 @@ int sync_tx(struct bladerf_sync *s,
     }
 
     if (status == 0 &&
-        s->stream_config.format == BLADERF_FORMAT_SC16_Q11_META &&
+        (s->stream_config.format == BLADERF_FORMAT_SC16_Q11_META ||
+         s->stream_config.format == BLADERF_FORMAT_SC12_PACKED_META) &&
         (user_meta->flags & BLADERF_META_FLAG_TX_BURST_END)) {
         s->meta.in_burst = false;
         s->meta.now      = false;
@@ -1317,23 +2969,1331 @@ int sync_tx(struct bladerf_sync *s,
 out:
     MUTEX_UNLOCK(&s->lock);
 
+    TRACE_POINT3(sync_tx_return, (uintptr_t)s, status, samples_written);
+
     return status;
 }
 
-unsigned int sync_buf2idx(struct buffer_mgmt *b, void *addr)
+int sync_tx(struct bladerf_sync *s,
+            void const *samples,
+            unsigned int num_samples,
+            struct bladerf_metadata *user_meta,
+            unsigned int timeout_ms)
+{
+    if (s == NULL || samples == NULL || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_tx_bufs(s, &samples, 1, num_samples, user_meta, timeout_ms,
+                        false);
+}
+
+int sync_rx_nb(struct bladerf_sync *s,
+               void *samples,
+               unsigned int num_samples,
+               struct bladerf_metadata *user_meta)
+{
+    if (s == NULL || samples == NULL) {
+        log_debug("NULL pointer passed to %s\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (!s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_rx_bufs(s, &samples, 1, num_samples, user_meta, 0, true);
+}
+
+int sync_tx_nb(struct bladerf_sync *s,
+               void const *samples,
+               unsigned int num_samples,
+               struct bladerf_metadata *user_meta)
+{
+    if (s == NULL || samples == NULL || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    return sync_tx_bufs(s, &samples, 1, num_samples, user_meta, 0, true);
+}
+
+int sync_get_ready_fd(struct bladerf_sync *s, bladerf_ready_fd *fd)
+{
+    int status;
+
+    if (s == NULL || fd == NULL || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&s->buf_mgmt.lock);
+
+    status = sync_ready_open(&s->buf_mgmt.notify);
+    if (status == 0) {
+        *fd = s->buf_mgmt.notify.fd;
+    }
+
+    MUTEX_UNLOCK(&s->buf_mgmt.lock);
+
+    return status;
+}
+
+int sync_tx_multi(struct bladerf_sync *s,
+                  const void *const *bufs,
+                  unsigned int num_samples,
+                  struct bladerf_metadata *user_meta,
+                  unsigned int timeout_ms)
+{
+    unsigned int total;
+    int status;
+
+    if (s == NULL || bufs == NULL || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = check_multi_bufs(s, bufs, num_samples, &total);
+    if (status != 0) {
+        return status;
+    }
+
+    return sync_tx_bufs(s, bufs, s->meta.samples_per_ts, total, user_meta,
+                        timeout_ms, false);
+}
+
+/* Largest packet payload, in DWORDs, that fits in a stream buffer along with
+ * its header */
+static inline unsigned int packet_max_len(struct bladerf_sync *s)
+{
+    const unsigned int max =
+        s->stream_config.samples_per_buffer - METADATA_HEADER_SIZE / 4;
+
+    return uint_min(max, UINT16_MAX);
+}
+
+static int check_packet_stream(struct bladerf_sync *s)
+{
+    if (s == NULL || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (s->stream_config.format != BLADERF_FORMAT_PACKET_META) {
+        log_debug("Packet transfers require the packet meta format\n");
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (s->buf_mgmt.pool) {
+        log_debug("Packet transfers are not supported in RX buffer pool "
+                  "mode\n");
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return 0;
+}
+
+/* Copy out the packet in RX buffer cons_i, and mark the buffer empty.
+ * Assumes the buffer lock is held.
+ *
+ * Returns false for an empty packet, which is skipped, carrying any
+ * discontinuity over to the next buffer. */
+static bool rx_take_packet(struct bladerf_sync *s, struct bladerf_packet *pkt)
+{
+    struct buffer_mgmt *b    = &s->buf_mgmt;
+    const unsigned int idx   = b->cons_i;
+    const uint8_t *buf       = (const uint8_t *)b->buffers[idx];
+    const unsigned int len   = metadata_get_packet_len(buf);
+    const bool discontinuity = b->discontinuity[idx];
+    const bool rate_change   = rx_take_rate_change(b, idx);
+
+    if (len > 0) {
+        pkt->len       = len;
+        pkt->core      = metadata_get_packet_core(buf);
+        pkt->flags     = metadata_get_packet_flags(buf);
+        pkt->timestamp = metadata_get_timestamp(buf);
+        pkt->status    = (discontinuity ? BLADERF_META_STATUS_OVERRUN : 0) |
+                         (rate_change ? BLADERF_META_STATUS_RATE_CHANGE : 0);
+
+        memcpy(pkt->data, buf + METADATA_HEADER_SIZE,
+               samples2bytes(s, uint_min(len, uint_min(pkt->capacity,
+                                                       packet_max_len(s)))));
+    }
+
+    b->discontinuity[idx] = false;
+    advance_rx_buffer(b);
+
+    if (len == 0 && discontinuity) {
+        b->discontinuity[b->cons_i] = true;
+    }
+
+    if (len == 0 && rate_change) {
+        b->rate_change[b->cons_i] = true;
+    }
+
+    return len > 0;
+}
+
+int sync_rx_packets(struct bladerf_sync *s,
+                    struct bladerf_packet *pkts,
+                    unsigned int num_pkts,
+                    unsigned int *num_received,
+                    unsigned int timeout_ms)
 {
+    struct buffer_mgmt *b;
+    unsigned int count = 0;
     unsigned int i;
+    int status;
+
+    if (pkts == NULL || num_received == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    *num_received = 0;
+
+    status = check_packet_stream(s);
+    if (status != 0) {
+        return status;
+    }
 
-    for (i = 0; i < b->num_buffers; i++) {
-        if (b->buffers[i] == addr) {
-            return i;
+    for (i = 0; i < num_pkts; i++) {
+        if (pkts[i].data == NULL && pkts[i].capacity != 0) {
+            log_debug("NULL buffer provided for packet %u\n", i);
+            return BLADERF_ERR_INVAL;
         }
     }
 
-    assert(!"Bug: Buffer not found.");
+    b = &s->buf_mgmt;
 
-    /* Assertions are intended to always remain on. If someone turned them
-     * off, do the best we can...complain loudly and clobber a buffer */
-    log_critical("Bug: Buffer not found.");
-    return 0;
+    MUTEX_LOCK(&s->lock);
+
+    while (status == 0 && count < num_pkts) {
+        switch (s->state) {
+            case SYNC_STATE_CHECK_WORKER:
+            case SYNC_STATE_RESET_BUF_MGMT:
+            case SYNC_STATE_START_WORKER:
+            case SYNC_STATE_WAIT_FOR_BUFFER:
+                /* Only the first packet is waited for. The rest are those
+                 * that have already arrived. */
+                status = rx_wait_step(s, timeout_ms, count != 0);
+
+                if (status == BLADERF_ERR_WOULD_BLOCK && count != 0) {
+                    status = 0;
+                    goto out;
+                }
+                break;
+
+            case SYNC_STATE_BUFFER_READY:
+                MUTEX_LOCK(&b->lock);
+
+                /* Drain every full buffer under a single lock */
+                do {
+                    if (rx_take_packet(s, &pkts[count])) {
+                        count++;
+                    }
+                } while (count < num_pkts &&
+                         sync_buf_status(b, b->cons_i) == SYNC_BUFFER_FULL);
+
+                s->state = SYNC_STATE_WAIT_FOR_BUFFER;
+                MUTEX_UNLOCK(&b->lock);
+                break;
+
+            default:
+                assert(!"Invalid RX state");
+                status = BLADERF_ERR_UNEXPECTED;
+                break;
+        }
+    }
+
+out:
+    MUTEX_UNLOCK(&s->lock);
+
+    *num_received = count;
+
+    log_verbose("%s: Received %u packets\n", __FUNCTION__, count);
+
+    return status;
+}
+
+/* Format a packet into TX buffer prod_i. Assumes the buffer lock is held. */
+static void tx_put_packet(struct bladerf_sync *s,
+                          const struct bladerf_packet *pkt)
+{
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    uint8_t *buf          = (uint8_t *)b->buffers[b->prod_i];
+
+    sync_set_buf_status(b, b->prod_i, SYNC_BUFFER_PARTIAL);
+
+    metadata_set_packet(buf, pkt->timestamp, 0, (uint16_t)pkt->len,
+                        pkt->core, pkt->flags);
+    memcpy(buf + METADATA_HEADER_SIZE, pkt->data, samples2bytes(s, pkt->len));
+
+    b->actual_lengths[b->prod_i] =
+        samples2bytes(s, pkt->len) + METADATA_HEADER_SIZE;
+}
+
+int sync_tx_packets(struct bladerf_sync *s,
+                    const struct bladerf_packet *pkts,
+                    unsigned int num_pkts,
+                    unsigned int *num_sent,
+                    unsigned int timeout_ms)
+{
+    struct buffer_mgmt *b;
+    unsigned int count = 0;
+    unsigned int max_len;
+    unsigned int i;
+    int status;
+
+    if (pkts == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (num_sent != NULL) {
+        *num_sent = 0;
+    }
+
+    status = check_packet_stream(s);
+    if (status != 0) {
+        return status;
+    }
+
+    /* Reject bad descriptors before anything is sent */
+    max_len = packet_max_len(s);
+    for (i = 0; i < num_pkts; i++) {
+        if (pkts[i].data == NULL || pkts[i].len == 0 ||
+            pkts[i].len > max_len) {
+            log_debug("Invalid packet %u: %u DWORDs (max %u)\n", i,
+                      pkts[i].len, max_len);
+            return BLADERF_ERR_INVAL;
+        }
+    }
+
+    b = &s->buf_mgmt;
+
+    MUTEX_LOCK(&s->lock);
+
+    while (status == 0 && count < num_pkts) {
+        switch (s->state) {
+            case SYNC_STATE_CHECK_WORKER:
+            case SYNC_STATE_RESET_BUF_MGMT:
+            case SYNC_STATE_START_WORKER:
+            case SYNC_STATE_WAIT_FOR_BUFFER:
+                status = tx_wait_step(s, timeout_ms, false);
+                break;
+
+            case SYNC_STATE_USING_LEASE:
+                log_debug("%s: TX buffer is currently lent out. Call "
+                          "sync_tx_submit() first.\n", __FUNCTION__);
+                status = BLADERF_ERR_INVAL;
+                break;
+
+            case SYNC_STATE_BUFFER_READY:
+                MUTEX_LOCK(&b->lock);
+
+                /* Fill and submit empty buffers back to back, leaving the
+                 * state machine only to wait for one. Each packet remains a
+                 * transfer of its own, as the FPGA takes a single header per
+                 * DMA transaction. */
+                do {
+                    tx_put_packet(s, &pkts[count]);
+
+                    status = advance_tx_buffer(s, b);
+                    if (status == 0) {
+                        count++;
+                    }
+                } while (status == 0 && count < num_pkts &&
+                         s->state == SYNC_STATE_BUFFER_READY);
+
+                MUTEX_UNLOCK(&b->lock);
+                break;
+
+            default:
+                assert(!"Invalid TX state");
+                status = BLADERF_ERR_UNEXPECTED;
+                break;
+        }
+    }
+
+    MUTEX_UNLOCK(&s->lock);
+
+    if (num_sent != NULL) {
+        *num_sent = count;
+    }
+
+    log_verbose("%s: Sent %u packets\n", __FUNCTION__, count);
+
+    return status;
+}
+
+int sync_prearm(struct bladerf_sync *s)
+{
+    bool rx;
+    int status = 0;
+
+    if (s == NULL || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    rx = (s->stream_config.layout & BLADERF_DIRECTION_MASK) == BLADERF_RX;
+
+    MUTEX_LOCK(&s->lock);
+
+    switch (s->state) {
+        case SYNC_STATE_CHECK_WORKER:
+        case SYNC_STATE_RESET_BUF_MGMT:
+        case SYNC_STATE_START_WORKER:
+        case SYNC_STATE_WAIT_FOR_BUFFER:
+            /* Run the state machine up to, but not including, the wait for
+             * the first buffer. None of the preceding steps use the
+             * timeout. */
+            s->state = SYNC_STATE_CHECK_WORKER;
+            while (status == 0 && s->state != SYNC_STATE_WAIT_FOR_BUFFER) {
+                status = rx ? rx_wait_step(s, 0, false)
+                            : tx_wait_step(s, 0, false);
+            }
+            break;
+
+        default:
+            /* Part way through a buffer, so the worker is already running */
+            break;
+    }
+
+    MUTEX_UNLOCK(&s->lock);
+
+    return status;
+}
+
+/* Populate the outputs of sync_rx_acquire() for lent buffer idx. Assumes
+ * the buffer lock is held. */
+static void describe_lent_buf(struct bladerf_sync *s, unsigned int idx,
+                              void **buffer, unsigned int *num_samples,
+                              struct bladerf_metadata *user_meta)
+{
+    struct buffer_mgmt *b = &s->buf_mgmt;
+
+    *buffer = b->buffers[idx];
+
+    if (is_meta_format(s->stream_config.format)) {
+        const uint8_t *msg = b->buffers[idx];
+        unsigned int i;
+
+        *num_samples = s->meta.samples_per_msg * s->meta.msg_per_buf;
+
+        if (user_meta != NULL) {
+            user_meta->timestamp    = metadata_get_timestamp(msg);
+            user_meta->status       = 0;
+            user_meta->actual_count = *num_samples;
+
+            for (i = 0; i < s->meta.msg_per_buf; i++) {
+                user_meta->status |= metadata_get_flags(msg) &
+                                     (BLADERF_META_FLAG_RX_HW_UNDERFLOW |
+                                      BLADERF_META_FLAG_RX_HW_MINIEXP1 |
+                                      BLADERF_META_FLAG_RX_HW_MINIEXP2);
+                msg += s->meta.msg_size;
+            }
+        }
+    } else {
+        *num_samples = (unsigned int)b->actual_lengths[idx];
+
+        /* Without hardware timestamps, report the buffer's position in the
+         * stream, such that buffers can still be put back in order */
+        if (user_meta != NULL) {
+            user_meta->timestamp    = b->position[idx];
+            user_meta->status       = 0;
+            user_meta->actual_count = *num_samples;
+        }
+    }
+
+    if (user_meta != NULL) {
+        user_meta->host_timestamp = b->host_arrival[idx];
+    }
+
+    if (b->discontinuity[idx]) {
+        b->discontinuity[idx] = false;
+
+        if (user_meta != NULL) {
+            user_meta->status |= BLADERF_META_STATUS_OVERRUN;
+        }
+    }
+
+    if (rx_take_rate_change(b, idx) && user_meta != NULL) {
+        user_meta->status |= BLADERF_META_STATUS_RATE_CHANGE;
+    }
+}
+
+/* Ensure the RX worker is running, (re)starting it if needed. This is the
+ * only part of the sync state machine used in buffer pool mode. */
+static int rx_pool_check_worker(struct bladerf_sync *s, unsigned int timeout_ms)
+{
+    int status = 0;
+
+    MUTEX_LOCK(&s->lock);
+
+    s->state = SYNC_STATE_CHECK_WORKER;
+    while (status == 0 && s->state != SYNC_STATE_WAIT_FOR_BUFFER) {
+        status = rx_wait_step(s, timeout_ms, false);
+    }
+
+    MUTEX_UNLOCK(&s->lock);
+
+    return status;
+}
+
+/* sync_rx_acquire() implementation for buffer pool mode. The sync handle
+ * lock is not held while waiting, so that multiple threads may wait for (and
+ * be handed) buffers concurrently. */
+static int rx_pool_acquire(struct bladerf_sync *s,
+                           void **buffer,
+                           unsigned int *num_samples,
+                           struct bladerf_metadata *user_meta,
+                           unsigned int timeout_ms)
+{
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    unsigned int idx;
+    int status = 0;
+
+    MUTEX_LOCK(&b->lock);
+
+    while (status == 0 && b->ready_count == 0) {
+        MUTEX_UNLOCK(&b->lock);
+        status = rx_pool_check_worker(s, timeout_ms);
+        MUTEX_LOCK(&b->lock);
+
+        if (status == 0 && b->ready_count == 0) {
+            ATOMIC_INC(&b->waiters);
+            status = wait_for_buffer(b, timeout_ms, __FUNCTION__, b->prod_i);
+            ATOMIC_DEC(&b->waiters);
+        }
+    }
+
+    if (status == 0) {
+        idx           = b->ready[b->ready_head];
+        b->ready_head = (b->ready_head + 1) % b->num_buffers;
+        b->ready_count--;
+
+        sync_set_buf_status(b, idx, SYNC_BUFFER_LEASED);
+        sync_stats_consumed(&b->stats);
+
+        describe_lent_buf(s, idx, buffer, num_samples, user_meta);
+
+        log_verbose("%s: Lent buf[%u] to caller\n", __FUNCTION__, idx);
+    }
+
+    MUTEX_UNLOCK(&b->lock);
+
+    return status;
+}
+
+int sync_rx_acquire(struct bladerf_sync *s,
+                    void **buffer,
+                    unsigned int *num_samples,
+                    struct bladerf_metadata *user_meta,
+                    unsigned int timeout_ms)
+{
+    struct buffer_mgmt *b;
+    unsigned int idx;
+    int status = 0;
+
+    if (s == NULL || buffer == NULL || num_samples == NULL) {
+        log_debug("NULL pointer passed to %s\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (!s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (s->stream_config.format == BLADERF_FORMAT_PACKET_META) {
+        log_debug("%s: Not supported with the packet meta format\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (!user_format_is_native(s)) {
+        log_debug("%s: Not supported with host-converted formats\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (s->buf_mgmt.pool) {
+        return rx_pool_acquire(s, buffer, num_samples, user_meta, timeout_ms);
+    }
+
+    MUTEX_LOCK(&s->lock);
+
+    b = &s->buf_mgmt;
+
+    switch (s->state) {
+        case SYNC_STATE_CHECK_WORKER:
+        case SYNC_STATE_RESET_BUF_MGMT:
+        case SYNC_STATE_START_WORKER:
+        case SYNC_STATE_WAIT_FOR_BUFFER:
+        case SYNC_STATE_BUFFER_READY:
+            break;
+
+        default:
+            /* sync_rx() is part way through a buffer */
+            log_debug("%s: Cannot lend a partially consumed buffer\n",
+                      __FUNCTION__);
+            status = BLADERF_ERR_INVAL;
+            goto out;
+    }
+
+    while (status == 0 && s->state != SYNC_STATE_BUFFER_READY) {
+        dump_buf_states(s);
+        status = rx_wait_step(s, timeout_ms, false);
+    }
+
+    if (status != 0) {
+        goto out;
+    }
+
+    MUTEX_LOCK(&b->lock);
+
+    idx            = b->cons_i;
+    sync_set_buf_status(b, idx, SYNC_BUFFER_LEASED);
+    b->cons_i      = (idx + 1) % b->num_buffers;
+    s->state       = SYNC_STATE_WAIT_FOR_BUFFER;
+    sync_stats_consumed(&b->stats);
+
+    describe_lent_buf(s, idx, buffer, num_samples, user_meta);
+
+    log_verbose("%s: Lent buf[%u] to caller\n", __FUNCTION__, idx);
+
+    MUTEX_UNLOCK(&b->lock);
+
+out:
+    MUTEX_UNLOCK(&s->lock);
+
+    return status;
+}
+
+int sync_rx_release(struct bladerf_sync *s, void *buffer)
+{
+    struct buffer_mgmt *b;
+    unsigned int idx;
+    int status = 0;
+
+    if (s == NULL || buffer == NULL || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    b = &s->buf_mgmt;
+
+    MUTEX_LOCK(&b->lock);
+
+    idx = sync_buf2idx(b, buffer);
+    if (sync_buf_status(b, idx) == SYNC_BUFFER_LEASED &&
+        b->buffers[idx] == buffer) {
+        sync_set_buf_status(b, idx, SYNC_BUFFER_EMPTY);
+        log_verbose("%s: Caller released buf[%u]\n", __FUNCTION__, idx);
+    } else {
+        log_debug("%s: Buffer %p is not currently lent out\n", __FUNCTION__,
+                  buffer);
+        status = BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_UNLOCK(&b->lock);
+
+    return status;
+}
+
+/* sync_tx_acquire() and sync_tx_reserve() implementation for buffer pool
+ * mode. Buffers are reserved in ring order under the sync handle lock.
+ * Committing them requires only the buffer lock, so that a reservation
+ * waiting on a full ring does not hold up the commits that would drain it. */
+static int tx_pool_reserve(struct bladerf_sync *s,
+                           void **buffer,
+                           unsigned int *num_samples,
+                           uint64_t *position,
+                           unsigned int timeout_ms)
+{
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    unsigned int idx;
+    int status = 0;
+
+    MUTEX_LOCK(&s->lock);
+
+    while (status == 0 && s->state != SYNC_STATE_BUFFER_READY) {
+        status = tx_wait_step(s, timeout_ms, false);
+    }
+
+    if (status == 0) {
+        MUTEX_LOCK(&b->lock);
+
+        idx = b->prod_i;
+        sync_set_buf_status(b, idx, SYNC_BUFFER_LEASED);
+        b->position[idx] = b->tx_position;
+        b->tx_position  += s->stream_config.samples_per_buffer /
+                           s->meta.samples_per_ts;
+        b->prod_i        = (idx + 1) % b->num_buffers;
+
+        if (sync_buf_status(b, b->prod_i) == SYNC_BUFFER_EMPTY) {
+            s->state = SYNC_STATE_BUFFER_READY;
+        } else {
+            s->state = SYNC_STATE_CHECK_WORKER;
+        }
+
+        *buffer      = b->buffers[idx];
+        *num_samples = s->stream_config.samples_per_buffer;
+        if (position != NULL) {
+            *position = b->position[idx];
+        }
+
+        log_verbose("%s: Reserved buf[%u] for caller\n", __FUNCTION__, idx);
+
+        MUTEX_UNLOCK(&b->lock);
+    }
+
+    MUTEX_UNLOCK(&s->lock);
+
+    return status;
+}
+
+/* sync_tx_submit() implementation for buffer pool mode */
+static int tx_pool_commit(struct bladerf_sync *s,
+                          void *buffer,
+                          unsigned int num_samples)
+{
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    unsigned int idx;
+    int status = 0;
+
+    if (num_samples > s->stream_config.samples_per_buffer) {
+        log_debug("%s: %u samples exceeds buffer size of %u\n", __FUNCTION__,
+                  num_samples, s->stream_config.samples_per_buffer);
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&b->lock);
+
+    if (!sync_buf_in_ring(b, buffer) ||
+        b->buffers[sync_buf2idx(b, buffer)] != buffer ||
+        sync_buf_status(b, sync_buf2idx(b, buffer)) != SYNC_BUFFER_LEASED) {
+        log_debug("%s: Buffer %p is not currently reserved\n", __FUNCTION__,
+                  buffer);
+        MUTEX_UNLOCK(&b->lock);
+        return BLADERF_ERR_INVAL;
+    }
+
+    idx = sync_buf2idx(b, buffer);
+
+    /* Only whole buffers go out over the wire */
+    memset((uint8_t *)buffer + samples2bytes(s, num_samples), 0,
+           samples2bytes(s, s->stream_config.samples_per_buffer - num_samples));
+
+    sync_set_buf_status(b, idx, SYNC_BUFFER_COMMITTED);
+    log_verbose("%s: Caller committed buf[%u]\n", __FUNCTION__, idx);
+
+    /* Buffers go out in the order they were reserved. Whichever thread finds
+     * none being submitted submits every committed buffer from the oldest
+     * reserved one on, picking up those committed while it had the buffer
+     * lock dropped to submit. Other threads leave theirs to it. */
+    if (!b->committing) {
+        b->committing = true;
+
+        while (status == 0 &&
+               sync_buf_status(b, b->commit_i) == SYNC_BUFFER_COMMITTED) {
+            status = submit_tx_buffer(s, b, b->commit_i);
+
+            if (status == 0) {
+                b->commit_i = (b->commit_i + 1) % b->num_buffers;
+            } else {
+                /* Retried at the next commit */
+                sync_set_buf_status(b, b->commit_i, SYNC_BUFFER_COMMITTED);
+            }
+        }
+
+        b->committing = false;
+    }
+
+    MUTEX_UNLOCK(&b->lock);
+
+    return status;
+}
+
+/* Checks common to sync_tx_acquire() and sync_tx_reserve() */
+static int tx_lease_check(struct bladerf_sync *s,
+                          void **buffer,
+                          unsigned int *num_samples)
+{
+    if (s == NULL || buffer == NULL || num_samples == NULL) {
+        log_debug("NULL pointer passed to %s\n", __FUNCTION__);
+        return BLADERF_ERR_INVAL;
+    } else if (!s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!user_format_is_native(s) ||
+        (s->stream_config.format != BLADERF_FORMAT_SC16_Q11 &&
+         s->stream_config.format != BLADERF_FORMAT_SC8_Q7)) {
+        log_debug("%s: Only supported with non-metadata formats\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return 0;
+}
+
+int sync_tx_reserve(struct bladerf_sync *s,
+                    void **buffer,
+                    unsigned int *num_samples,
+                    uint64_t *position,
+                    unsigned int timeout_ms)
+{
+    int status = tx_lease_check(s, buffer, num_samples);
+
+    if (status != 0) {
+        return status;
+    }
+
+    if (!s->buf_mgmt.tx_pool) {
+        log_debug("%s: Only supported in TX buffer pool mode\n",
+                  __FUNCTION__);
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    return tx_pool_reserve(s, buffer, num_samples, position, timeout_ms);
+}
+
+int sync_tx_acquire(struct bladerf_sync *s,
+                    void **buffer,
+                    unsigned int *num_samples,
+                    unsigned int timeout_ms)
+{
+    struct buffer_mgmt *b;
+    int status = tx_lease_check(s, buffer, num_samples);
+
+    if (status != 0) {
+        return status;
+    }
+
+    if (s->buf_mgmt.tx_pool) {
+        return tx_pool_reserve(s, buffer, num_samples, NULL, timeout_ms);
+    }
+
+    MUTEX_LOCK(&s->lock);
+
+    b = &s->buf_mgmt;
+
+    switch (s->state) {
+        case SYNC_STATE_CHECK_WORKER:
+        case SYNC_STATE_START_WORKER:
+        case SYNC_STATE_WAIT_FOR_BUFFER:
+        case SYNC_STATE_BUFFER_READY:
+            break;
+
+        default:
+            /* Either sync_tx() is part way through filling a buffer, or
+             * the caller already holds one */
+            log_debug("%s: TX buffer is already in use\n", __FUNCTION__);
+            status = BLADERF_ERR_INVAL;
+            goto out;
+    }
+
+    while (status == 0 && s->state != SYNC_STATE_BUFFER_READY) {
+        status = tx_wait_step(s, timeout_ms, false);
+    }
+
+    if (status != 0) {
+        goto out;
+    }
+
+    MUTEX_LOCK(&b->lock);
+    sync_set_buf_status(b, b->prod_i, SYNC_BUFFER_LEASED);
+    s->state             = SYNC_STATE_USING_LEASE;
+    *buffer              = b->buffers[b->prod_i];
+    *num_samples         = s->stream_config.samples_per_buffer;
+    log_verbose("%s: Lent buf[%u] to caller\n", __FUNCTION__, b->prod_i);
+    MUTEX_UNLOCK(&b->lock);
+
+out:
+    MUTEX_UNLOCK(&s->lock);
+
+    return status;
+}
+
+int sync_tx_submit(struct bladerf_sync *s,
+                   void *buffer,
+                   unsigned int num_samples)
+{
+    struct buffer_mgmt *b;
+    int status = 0;
+
+    if (s == NULL || buffer == NULL || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (s->buf_mgmt.tx_pool) {
+        return tx_pool_commit(s, buffer, num_samples);
+    }
+
+    MUTEX_LOCK(&s->lock);
+
+    b = &s->buf_mgmt;
+
+    if (s->state != SYNC_STATE_USING_LEASE ||
+        buffer != b->buffers[b->prod_i]) {
+        log_debug("%s: Buffer %p is not currently lent out\n", __FUNCTION__,
+                  buffer);
+        status = BLADERF_ERR_INVAL;
+        goto out;
+    }
+
+    if (num_samples > s->stream_config.samples_per_buffer) {
+        log_debug("%s: %u samples exceeds buffer size of %u\n", __FUNCTION__,
+                  num_samples, s->stream_config.samples_per_buffer);
+        status = BLADERF_ERR_INVAL;
+        goto out;
+    }
+
+    MUTEX_LOCK(&b->lock);
+
+    /* Only whole buffers go out over the wire */
+    memset((uint8_t *)buffer + samples2bytes(s, num_samples), 0,
+           samples2bytes(s, s->stream_config.samples_per_buffer - num_samples));
+
+    sync_set_buf_status(b, b->prod_i, SYNC_BUFFER_PARTIAL);
+    b->partial_off       = s->stream_config.samples_per_buffer;
+
+    status = advance_tx_buffer(s, b);
+
+    MUTEX_UNLOCK(&b->lock);
+
+out:
+    MUTEX_UNLOCK(&s->lock);
+
+    return status;
+}
+
+/* Test whether the worker of an initialized handle is streaming */
+static bool sync_is_running(struct bladerf_sync *s)
+{
+    return s->initialized && s->worker != NULL &&
+           sync_worker_get_state(s->worker, NULL) ==
+               SYNC_WORKER_STATE_RUNNING;
+}
+
+void sync_rx_rate_change(struct bladerf_sync *s, bool begin)
+{
+    struct buffer_mgmt *b = &s->buf_mgmt;
+
+    if (begin) {
+        if (sync_is_running(s)) {
+            ATOMIC_STORE(&b->rate_change_req, SYNC_RATE_CHANGE_FLUSH);
+        }
+    } else {
+        /* The worker resets the request if the stream has since restarted */
+        ATOMIC_CAS(&b->rate_change_req, SYNC_RATE_CHANGE_FLUSH,
+                   SYNC_RATE_CHANGE_DONE);
+    }
+}
+
+int sync_tx_drain(struct bladerf_sync *s, unsigned int timeout_ms)
+{
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    uint64_t produced;
+    int status = 0;
+
+    if (!sync_is_running(s)) {
+        return 0;
+    }
+
+    MUTEX_LOCK(&b->lock);
+
+    /* Buffers submitted from here on need not be waited for. Those dropped
+     * by a stream restart are no longer counted in num_full. */
+    produced = b->stats.produced;
+
+    while (status == 0 && b->stats.consumed < produced &&
+           ATOMIC_LOAD(&b->stats.num_full) != 0) {
+        ATOMIC_INC(&b->waiters);
+        status = wait_for_buffer(b, timeout_ms, __FUNCTION__, b->prod_i);
+        ATOMIC_DEC(&b->waiters);
+    }
+
+    MUTEX_UNLOCK(&b->lock);
+
+    return status;
+}
+
+int sync_get_stats(struct bladerf_sync *s, struct bladerf_stream_stats *stats)
+{
+    struct buffer_mgmt *b;
+    struct async_xfer_stats xfer;
+
+    if (s == NULL || stats == NULL || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    b = &s->buf_mgmt;
+
+    MUTEX_LOCK(&b->lock);
+    stats->buffers_produced = b->stats.produced;
+    stats->buffers_consumed = b->stats.consumed;
+    stats->buffers_dropped  = b->stats.dropped;
+    stats->overruns         = b->stats.overruns;
+    stats->underruns        = b->stats.underruns;
+    stats->high_water       = b->stats.high_water;
+    MUTEX_UNLOCK(&b->lock);
+
+    stats->num_buffers   = b->num_buffers;
+    stats->buffer_size   = s->stream_config.samples_per_buffer;
+    stats->num_transfers = s->stream_config.num_xfers;
+
+    MUTEX_LOCK(&s->worker->stream->lock);
+    xfer = s->worker->stream->xfer_stats;
+    MUTEX_UNLOCK(&s->worker->stream->lock);
+
+    stats->transfers_completed = xfer.completed;
+    stats->short_transfers     = xfer.short_xfers;
+    stats->xfer_latency_avg_us = (unsigned int)u64_min(
+        UINT_MAX, xfer.completed ? xfer.latency_sum_us / xfer.completed : 0);
+    stats->xfer_latency_max_us =
+        (unsigned int)u64_min(UINT_MAX, xfer.latency_max_us);
+
+    stats->tap_buffers_written = 0;
+    stats->tap_buffers_dropped = 0;
+
+    if (s->tap != NULL) {
+        sync_tap_get_stats(s->tap, &stats->tap_buffers_written,
+                           &stats->tap_buffers_dropped);
+    }
+
+    stats->fpga_xruns     = 0;
+    stats->fpga_last_xrun = 0;
+
+    if (s->fpga_xruns_active) {
+        uint64_t count;
+        uint64_t last;
+        int status;
+
+        status = stream_stats_read(s->dev,
+                                   s->stream_config.layout &
+                                       BLADERF_DIRECTION_MASK,
+                                   &count, &last);
+        if (status != 0) {
+            return status;
+        }
+
+        if (count > s->fpga_xruns_base) {
+            stats->fpga_xruns     = count - s->fpga_xruns_base;
+            stats->fpga_last_xrun = last;
+        }
+    }
+
+    return 0;
+}
+
+unsigned int sync_buf2idx(struct buffer_mgmt *b, void *addr)
+{
+    const uint8_t *base = (const uint8_t *)b->buffers[0];
+    const uint8_t *buf  = (const uint8_t *)addr;
+
+    /* Buffers are allocated contiguously, so the index is just arithmetic */
+    if (buf >= base && b->buffer_bytes != 0) {
+        const size_t offset = (size_t)(buf - base);
+        const size_t idx    = offset / b->buffer_bytes;
+
+        if (idx < b->num_buffers && (offset % b->buffer_bytes) == 0) {
+            return (unsigned int)idx;
+        }
+    }
+
+    assert(!"Bug: Buffer not found.");
+
+    /* Assertions are intended to always remain on. If someone turned them
+     * off, do the best we can...complain loudly and clobber a buffer */
+    log_critical("Bug: Buffer not found.");
+    return 0;
+}
+
+bool sync_buf_in_ring(struct buffer_mgmt *b, void *addr)
+{
+    const uint8_t *base = (const uint8_t *)b->buffers[0];
+    const uint8_t *buf  = (const uint8_t *)addr;
+
+    return buf >= base && buf < base + b->num_buffers * b->buffer_bytes;
+}
+
+/* Address of message `n` of a template, counted from its first buffer */
+static inline uint8_t *template_msg(struct bladerf_sync *s,
+                                    struct bladerf_tx_template *t,
+                                    unsigned int n)
+{
+    return t->slab + (n / s->meta.msg_per_buf) * s->buf_mgmt.buffer_bytes +
+           (n % s->meta.msg_per_buf) * s->meta.msg_size;
+}
+
+static bool template_format_supported(struct bladerf_sync *s)
+{
+    if ((s->stream_config.layout & BLADERF_DIRECTION_MASK) != BLADERF_TX) {
+        log_debug("%s: TX templates require a TX stream\n", __FUNCTION__);
+        return false;
+    }
+
+    switch (s->stream_config.format) {
+        case BLADERF_FORMAT_SC16_Q11_META:
+        case BLADERF_FORMAT_SC8_Q7_META:
+        case BLADERF_FORMAT_SC12_PACKED_META:
+            return true;
+
+        default:
+            log_debug("%s: TX templates require a *_META format\n",
+                      __FUNCTION__);
+            return false;
+    }
+}
+
+int sync_tx_template_create(struct bladerf_sync *s,
+                            const void *samples,
+                            unsigned int num_samples,
+                            struct bladerf_tx_template **tmpl)
+{
+    struct bladerf_tx_template *t;
+    unsigned int samples_per_buf, num_msgs, n;
+    size_t copied, to_copy;
+
+    if (s == NULL || samples == NULL || tmpl == NULL || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (!template_format_supported(s)) {
+        return BLADERF_ERR_UNSUPPORTED;
+    }
+
+    if (num_samples == 0 || (num_samples % s->meta.samples_per_ts) != 0) {
+        log_debug("%s: Invalid number of samples: %u\n", __FUNCTION__,
+                  num_samples);
+        return BLADERF_ERR_INVAL;
+    }
+
+    t = calloc(1, sizeof(*t));
+    if (t == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    samples_per_buf = s->meta.samples_per_msg * s->meta.msg_per_buf;
+    t->num_buffers  = (num_samples + samples_per_buf - 1) / samples_per_buf;
+    t->duration     = (uint64_t)t->num_buffers * samples_per_buf /
+                      s->meta.samples_per_ts;
+
+    /* Padding is zero-filled by calloc() */
+    t->slab = calloc(t->num_buffers, s->buf_mgmt.buffer_bytes);
+    if (t->slab == NULL) {
+        free(t);
+        return BLADERF_ERR_MEM;
+    }
+
+    num_msgs = t->num_buffers * s->meta.msg_per_buf;
+
+    for (n = 0, copied = 0; n < num_msgs; n++) {
+        uint8_t *msg = template_msg(s, t, n);
+
+        metadata_set(msg, 0, 0);
+
+        to_copy = min_sz(num_samples - copied, s->meta.samples_per_msg);
+        if (to_copy != 0) {
+            copy_to_buf(s, msg + METADATA_HEADER_SIZE, &samples, 1, copied,
+                        to_copy);
+            copied += to_copy;
+        }
+    }
+
+    MUTEX_LOCK(&s->buf_mgmt.lock);
+    t->next      = s->templates;
+    s->templates = t;
+    MUTEX_UNLOCK(&s->buf_mgmt.lock);
+
+    log_debug("%s: Created %u-buffer template of %u samples\n", __FUNCTION__,
+              t->num_buffers, num_samples);
+
+    *tmpl = t;
+    return 0;
+}
+
+static bool template_registered(struct bladerf_sync *s,
+                                struct bladerf_tx_template *tmpl)
+{
+    struct bladerf_tx_template *t;
+
+    for (t = s->templates; t != NULL; t = t->next) {
+        if (t == tmpl) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Wait for `tmpl` to no longer be in flight and, if `drain` is set, for all
+ * deferred ring buffers to have been submitted. Assumes the buffer lock is
+ * held. */
+static int wait_for_template(struct bladerf_sync *s,
+                             struct bladerf_tx_template *tmpl,
+                             bool drain,
+                             unsigned int timeout_ms)
+{
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    int status            = 0;
+
+    while (status == 0 &&
+           (tmpl->in_flight != 0 ||
+            (drain && b->submitter != SYNC_TX_SUBMITTER_FN))) {
+        ATOMIC_INC(&b->waiters);
+        status = wait_for_buffer(b, timeout_ms, __FUNCTION__, b->prod_i);
+        ATOMIC_DEC(&b->waiters);
+    }
+
+    return status;
+}
+
+int sync_tx_template(struct bladerf_sync *s,
+                     struct bladerf_tx_template *tmpl,
+                     uint64_t timestamp,
+                     unsigned int timeout_ms)
+{
+    struct buffer_mgmt *b = &s->buf_mgmt;
+    const uint64_t ts_per_msg = s->meta.samples_per_msg / s->meta.samples_per_ts;
+    unsigned int i, n;
+    size_t len;
+    int status = 0;
+
+    if (tmpl == NULL || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&s->lock);
+
+    switch (s->state) {
+        case SYNC_STATE_USING_BUFFER_META:
+        case SYNC_STATE_USING_LEASE:
+            log_debug("%s: A partially filled buffer is pending\n",
+                      __FUNCTION__);
+            status = BLADERF_ERR_INVAL;
+            goto out;
+
+        default:
+            break;
+    }
+
+    if (s->meta.in_burst) {
+        log_debug("%s: The current burst must be ended first\n",
+                  __FUNCTION__);
+        status = BLADERF_ERR_INVAL;
+        goto out;
+    }
+
+    if (timestamp < s->meta.curr_timestamp) {
+        log_debug("Provided timestamp=%" PRIu64 " is in past: current=%" PRIu64
+                  "\n", timestamp, s->meta.curr_timestamp);
+        status = BLADERF_ERR_TIME_PAST;
+        goto out;
+    }
+
+    /* Get the worker running, if it is not already */
+    while (status == 0 && (s->state == SYNC_STATE_CHECK_WORKER ||
+                           s->state == SYNC_STATE_START_WORKER)) {
+        status = tx_wait_step(s, timeout_ms, false);
+    }
+
+    if (status != 0) {
+        goto out;
+    }
+
+    MUTEX_LOCK(&b->lock);
+
+    if (!template_registered(s, tmpl)) {
+        MUTEX_UNLOCK(&b->lock);
+        status = BLADERF_ERR_INVAL;
+        goto out;
+    }
+
+    /* The template's buffers cannot be rewritten while in flight, and must
+     * not overtake ring buffers that are still awaiting submission */
+    status = wait_for_template(s, tmpl, true, timeout_ms);
+    if (status != 0) {
+        MUTEX_UNLOCK(&b->lock);
+        goto out;
+    }
+
+    for (n = 0; n < tmpl->num_buffers * s->meta.msg_per_buf; n++) {
+        metadata_set(template_msg(s, tmpl, n), timestamp + n * ts_per_msg, 0);
+    }
+
+    for (i = 0; i < tmpl->num_buffers && status == 0; i++) {
+        tmpl->in_flight++;
+        sync_stats_produced(&b->stats);
+
+        /* As in advance_tx_buffer(), the buffer lock must be dropped while
+         * submitting. The callback may complete this buffer meanwhile. */
+        MUTEX_UNLOCK(&b->lock);
+        len    = async_stream_buf_bytes(s->worker->stream);
+        status = async_submit_stream_buffer(
+            s->worker->stream, tmpl->slab + i * b->buffer_bytes, &len,
+            s->stream_config.timeout_ms, false);
+        MUTEX_LOCK(&b->lock);
+
+        if (status != 0) {
+            log_debug("%s: Failed to submit template buf[%u]: %s\n",
+                      __FUNCTION__, i, bladerf_strerror(status));
+            tmpl->in_flight--;
+            sync_stats_consumed(&b->stats);
+        }
+    }
+
+    MUTEX_UNLOCK(&b->lock);
+
+    if (status == 0) {
+        s->meta.curr_timestamp = timestamp + tmpl->duration;
+    }
+
+out:
+    MUTEX_UNLOCK(&s->lock);
+
+    return status;
+}
+
+int sync_tx_template_free(struct bladerf_sync *s,
+                          struct bladerf_tx_template *tmpl)
+{
+    struct bladerf_tx_template **t;
+    int status = BLADERF_ERR_INVAL;
+
+    if (tmpl == NULL || !s->initialized) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    MUTEX_LOCK(&s->lock);
+    MUTEX_LOCK(&s->buf_mgmt.lock);
+
+    for (t = &s->templates; *t != NULL; t = &(*t)->next) {
+        if (*t == tmpl) {
+            status = wait_for_template(s, tmpl, false,
+                                       s->stream_config.timeout_ms);
+            if (status == 0) {
+                *t = tmpl->next;
+            }
+            break;
+        }
+    }
+
+    MUTEX_UNLOCK(&s->buf_mgmt.lock);
+    MUTEX_UNLOCK(&s->lock);
+
+    if (status == 0) {
+        free(tmpl->slab);
+        free(tmpl);
+    }
+
+    return status;
+}
+
+bool sync_tx_template_complete(struct bladerf_sync *s, void *buf)
+{
+    struct bladerf_tx_template *t;
+    const uint8_t *addr = (const uint8_t *)buf;
+
+    for (t = s->templates; t != NULL; t = t->next) {
+        if (addr >= t->slab &&
+            addr < t->slab + t->num_buffers * s->buf_mgmt.buffer_bytes) {
+            assert(t->in_flight != 0);
+            t->in_flight--;
+            return true;
+        }
+    }
+
+    return false;
 }
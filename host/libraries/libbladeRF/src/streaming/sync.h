@@ -29,9 +29,19 @@
 
 #include "thread.h"
 
+#include "helpers/trace.h"
+
+#include "correction.h"
+#include "ready.h"
+#include "sample_stats.h"
+#include "tap.h"
+
 /* These parameters are only written during sync_init */
 struct stream_config {
-    bladerf_format format;
+    bladerf_format format;      /* Format of the stream buffers */
+    bladerf_format user_format; /* Format of the caller's samples. This
+                                 * differs from `format` for the formats
+                                 * converted on the host (e.g., CF32). */
     bladerf_channel_layout layout;
 
     unsigned int samples_per_buffer;
@@ -39,6 +49,15 @@ struct stream_config {
     unsigned int timeout_ms;
 
     size_t bytes_per_sample;
+    size_t user_bytes_per_sample;
+
+    /* TX metadata formats only: a burst end may be submitted as a short
+     * transfer of the messages used so far, rather than a full buffer */
+    bool tx_short_bursts;
+
+    /* TX metadata formats only: the FPGA zeroes the DAC once samples stop,
+     * so a burst need not end with zero samples */
+    bool tx_idle_zero;
 };
 
 typedef enum {
@@ -46,6 +65,10 @@ typedef enum {
     SYNC_BUFFER_PARTIAL,   /**< sync_rx/tx is currently emptying/filling */
     SYNC_BUFFER_FULL,      /**< Buffer is full of data */
     SYNC_BUFFER_IN_FLIGHT, /**< Currently being transferred */
+    SYNC_BUFFER_LEASED,    /**< Lent out to the API caller via
+                            *   sync_rx_acquire() or sync_tx_acquire() */
+    SYNC_BUFFER_COMMITTED, /**< TX pool mode only: filled by the caller and
+                            *   awaiting the submission of those before it */
 } sync_buffer_status;
 
 typedef enum {
@@ -66,12 +89,55 @@ typedef enum {
 
 #define BUFFER_MGMT_INVALID_INDEX (UINT_MAX)
 
+/* Requests of sync_rx_rate_change() to the RX worker callback */
+#define SYNC_RATE_CHANGE_NONE  0 /* Stream as usual */
+#define SYNC_RATE_CHANGE_FLUSH 1 /* Discard every transfer */
+#define SYNC_RATE_CHANGE_DONE  2 /* Discard the transfers then in flight, and
+                                  * mark the next buffer */
+
+/* Stream statistics. Each counter has a single writer: RX produced, dropped
+ * and overrun counts are written by the worker callback, TX produced counts
+ * by sync_tx(), and so on. */
+struct sync_stats {
+    uint64_t produced;
+    uint64_t consumed;
+    uint64_t dropped;
+    uint64_t overruns;
+    uint64_t underruns;
+
+    unsigned int num_full;   /**< Buffers produced but not yet consumed.
+                              *   Accessed atomically. */
+    unsigned int high_water; /**< Max observed value of num_full */
+};
+
 struct buffer_mgmt {
     sync_buffer_status *status;
     size_t *actual_lengths;
+    bool *discontinuity;  /**< RX only: samples were dropped immediately
+                           *   before this buffer. Written by the worker
+                           *   callback prior to marking the buffer full. */
+    uint64_t *position;   /**< Per-channel sample count since sync_init()
+                           *   at the start of this buffer. RX: includes
+                           *   dropped samples, and is written by the
+                           *   worker callback prior to marking the buffer
+                           *   full. TX: pool mode only, written when the
+                           *   buffer is reserved. */
+    uint64_t *host_arrival; /**< RX only: host time, per
+                             *   bladerf_get_host_time_ns(), at which the
+                             *   transfer carrying this buffer completed.
+                             *   Written by the worker callback prior to
+                             *   marking the buffer full. */
+    bool *rate_change;    /**< RX only: this is the first buffer received
+                           *   after a sample rate change. Written by the
+                           *   worker callback prior to marking the buffer
+                           *   full. */
+    uint64_t rx_position; /**< RX only: position of the next buffer */
 
     void **buffers;
     unsigned int num_buffers;
+    size_t buffer_bytes; /**< Size of each buffer. Buffers are allocated
+                          *   contiguously, in order, such that
+                          *   buffers[i] == buffers[0] + i * buffer_bytes */
 
     unsigned int prod_i;      /**< Producer index - next buffer to fill */
     unsigned int cons_i;      /**< Consumer index - next buffer to empty */
@@ -81,15 +147,70 @@ struct buffer_mgmt {
      * how many more transfers should be considered invalid and require
      * resubmission */
     unsigned int resubmit_count;
+    bool overrun_pending; /**< RX overrun is awaiting the next full buffer */
+
+    /* RX only: SYNC_RATE_CHANGE_* request of sync_rx_rate_change(), to which
+     * the worker callback responds. Accessed atomically. */
+    unsigned int rate_change_req;
+    bool rate_change_pending; /**< RX rate change is awaiting the next full
+                               *   buffer */
+
+    /* RX buffer pool consumer mode. Buffers may be held by several threads
+     * and released in any order, so the worker refills whichever buffer is
+     * free next rather than strictly following prod_i, and full buffers are
+     * handed out in the order they were received via the `ready` FIFO
+     * rather than at cons_i. */
+    bool pool;
+    unsigned int *ready;      /**< Indices of full buffers, oldest first */
+    unsigned int ready_head;  /**< Index into `ready` of the oldest entry */
+    unsigned int ready_count; /**< Number of entries in `ready` */
+
+    /* TX buffer pool producer mode. Buffers are reserved in ring order by
+     * any number of threads at once, and may be committed in any order. They
+     * are submitted in the order they were reserved, from commit_i on, as
+     * soon as every buffer before them has been committed. */
+    bool tx_pool;
+    unsigned int commit_i;  /**< Oldest buffer reserved but not submitted */
+    bool committing;        /**< A thread is submitting committed buffers */
+    uint64_t tx_position;   /**< Position of the next buffer reserved */
+
+    struct sync_stats stats;
 
     /* Applicable to TX only. Denotes which context is responsible for
      * submitting full buffers to the underlying async system */
     sync_tx_submitter submitter;
 
+    /* Latched from the sync handle by sync_init(). With
+     * BLADERF_SYNC_WAIT_SPIN, buffer status updates that hand a buffer off
+     * between the worker callback and the API caller are made atomically,
+     * and the RX callback does not take `lock`. */
+    bladerf_sync_wait_policy wait_policy;
+    unsigned int spin_us;     /**< Max time to busy-poll before blocking */
+    unsigned int waiters;     /**< # of threads blocked (or about to block)
+                               *   on buf_ready. Accessed atomically. */
 
     MUTEX lock;
     pthread_cond_t buf_ready; /**< Buffer produced by RX callback, or
                                *   buffer emptied by TX callback */
+
+    /* Opened on request by sync_get_ready_fd(), and signalled alongside
+     * buf_ready. Closed by sync_deinit(). */
+    struct sync_ready notify;
+};
+
+/* A burst pre-formatted into stream buffers, metadata headers included, by
+ * sync_tx_template_create(). Sending it only requires patching the message
+ * timestamps and submitting its buffers directly to the underlying stream. */
+struct bladerf_tx_template {
+    struct bladerf_tx_template *next; /**< Next template of the sync handle */
+
+    uint8_t *slab;            /**< num_buffers stream buffers, in order */
+    unsigned int num_buffers;
+    uint64_t duration;        /**< Length in timestamp ticks, including the
+                               *   zero padding of the final buffer */
+
+    unsigned int in_flight;   /**< Buffers submitted but not yet completed.
+                               *   Protected by buffer_mgmt.lock. */
 };
 
 /* State of API-side sync interface */
@@ -101,7 +222,8 @@ typedef enum {
     SYNC_STATE_BUFFER_READY,
     SYNC_STATE_USING_BUFFER,
     SYNC_STATE_USING_PACKET_META,
-    SYNC_STATE_USING_BUFFER_META
+    SYNC_STATE_USING_BUFFER_META,
+    SYNC_STATE_USING_LEASE /* TX only: caller holds the producer buffer */
 } sync_state;
 
 struct sync_meta {
@@ -140,6 +262,73 @@ struct bladerf_sync {
     MUTEX lock;
     struct bladerf *dev;
     bool initialized;
+
+    /* Wait policy requested via sync_set_wait_policy(), applied at the
+     * next sync_init() */
+    bladerf_sync_wait_policy wait_policy;
+    unsigned int spin_us;
+
+    /* Worker thread attributes requested via sync_set_thread_attrs(),
+     * applied by the worker thread created at the next sync_init() */
+    bool use_thread_attrs;
+    struct bladerf_thread_attrs thread_attrs;
+
+    /* RX buffer pool mode requested via sync_set_rx_pool(), applied at the
+     * next sync_init() */
+    bool rx_pool;
+
+    /* TX buffer pool mode requested via sync_set_tx_pool(), applied at the
+     * next sync_init() */
+    bool tx_pool;
+
+    /* Buffer allocator requested via sync_set_buffer_allocator(), applied at
+     * the next sync_init(). Unused when `alloc` is NULL. */
+    struct bladerf_buffer_allocator allocator;
+
+    /* Set when a setting applied at the next sync_init() requires the stream
+     * to be rebuilt, rather than reconfigured in place */
+    bool rebuild;
+
+    /* Set by sync_init() when the FPGA counts FIFO overflows (RX) or
+     * underflows (TX), in which case `fpga_xruns_base` holds the count at
+     * that time, so that sync_get_stats() reports those since */
+    bool fpga_xruns_active;
+    uint64_t fpga_xruns_base;
+
+    /* Sample statistics requested via sync_set_rx_stats(), applied at the
+     * next sync_init() */
+    bool rx_stats;
+    uint16_t rx_stats_clip;
+
+    /* Set by sync_init() when statistics are computed for the stream, in
+     * which case `stats` holds those of the most recent sync_rx*() call.
+     * Protected by `lock`. */
+    bool stats_active;
+    struct sample_stats stats;
+
+    /* Host-side corrections of each stream channel, recomputed from the
+     * device's when its host_corr_gen differs from `corr_gen`. `corr_active`
+     * is false when no channel of an SC16 Q11 RX stream has them enabled.
+     * Protected by `lock`. */
+    unsigned int corr_gen;
+    bool corr_active;
+    struct corr_coeffs corr[2];
+
+    /* Capture tap requested via sync_set_rx_tap(), opened by the next
+     * sync_init() for an RX layout unless `tap_path` is empty */
+    char tap_path[PATH_MAX];
+    unsigned int tap_depth;
+
+    /* Tap recording the stream's buffers, or NULL. Opened by sync_init(), and
+     * closed, completing its recording, at the next sync_init() or by
+     * sync_deinit(). */
+    struct sync_tap *tap;
+
+    /* TX templates registered with this handle. The list is protected by
+     * buf_mgmt.lock, as the worker callback searches it for completed
+     * template buffers. Templates are freed by sync_deinit(). */
+    struct bladerf_tx_template *templates;
+
     sync_state state;
     struct buffer_mgmt buf_mgmt;
     struct stream_config stream_config;
@@ -150,7 +339,10 @@ struct bladerf_sync {
 /**
  * Create and initialize as synchronous interface handle for the specified
  * device and direction. If the synchronous handle is already initialized, this
- * call will first deinitialize it.
+ * call will first deinitialize it, unless its stream, buffers and worker fit
+ * the new configuration. In that case, the stream is stopped and they are
+ * kept, along with any file descriptor from sync_get_ready_fd(), while TX
+ * templates are freed as they would be by sync_deinit().
  *
  * The associated stream will be started at the first RX or TX call
  *
@@ -166,6 +358,144 @@ int sync_init(struct bladerf_sync *sync,
               unsigned int num_transfers,
               unsigned int stream_timeout);
 
+/**
+ * Select the format a sync stream is configured with on a USB 2.0 link. If
+ * the stream's throughput in `format` exceeds what such a link sustains, a
+ * narrower format permitted by `allowed` that delivers the same caller-side
+ * samples is chosen instead, if the FPGA supports it.
+ *
+ * @param       dev             Device handle
+ * @param[in]   layout          Stream direction and layout
+ * @param[in]   format          Format requested by the caller
+ * @param[in]   buffer_size     Requested buffer size in samples, or 0 if
+ *                              it is to be selected automatically
+ * @param[in]   allowed         BLADERF_LINK_ADAPT_* flags
+ *
+ * @return format to configure the stream with
+ */
+bladerf_format sync_adapt_format(struct bladerf *dev,
+                                 bladerf_channel_layout layout,
+                                 bladerf_format format,
+                                 unsigned int buffer_size,
+                                 uint32_t allowed);
+
+/**
+ * Select the policy used to wait for buffers. This takes effect at the next
+ * sync_init() call.
+ *
+ * @param[inout]    sync        Sync handle
+ * @param[in]       policy      Wait policy
+ * @param[in]       spin_us     Max time to busy-poll for BLADERF_SYNC_WAIT_SPIN
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL on an invalid policy
+ */
+int sync_set_wait_policy(struct bladerf_sync *sync,
+                         bladerf_sync_wait_policy policy,
+                         unsigned int spin_us);
+
+/**
+ * Set the scheduling attributes of the worker thread. This takes effect at the
+ * next sync_init() call.
+ *
+ * @param[inout]    sync        Sync handle
+ * @param[in]       attrs       Thread attributes, or NULL for the defaults
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL on invalid attributes
+ */
+int sync_set_thread_attrs(struct bladerf_sync *sync,
+                          const struct bladerf_thread_attrs *attrs);
+
+/**
+ * Enable or disable the RX buffer pool consumer mode. This takes effect at
+ * the next sync_init() call for an RX layout.
+ *
+ * In this mode, sync_rx_acquire() may be called concurrently from multiple
+ * threads and buffers may be passed to sync_rx_release() in any order.
+ * Buffers are lent in the order they were received. sync_rx() and
+ * sync_rx_multi() are not available.
+ *
+ * @param[inout]    sync        Sync handle
+ * @param[in]       enable      Enable pool mode
+ */
+void sync_set_rx_pool(struct bladerf_sync *sync, bool enable);
+
+/**
+ * Enable or disable the TX buffer pool producer mode. This takes effect at
+ * the next sync_init() call for a TX layout.
+ *
+ * In this mode, sync_tx_acquire() and sync_tx_reserve() may be called
+ * concurrently from multiple threads, each reserving the next buffer of the
+ * ring, and buffers may be passed to sync_tx_submit() in any order. Buffers
+ * are transmitted in the order they were reserved. sync_tx() and
+ * sync_tx_multi() are not available.
+ *
+ * @param[inout]    sync        Sync handle
+ * @param[in]       enable      Enable pool mode
+ */
+void sync_set_tx_pool(struct bladerf_sync *sync, bool enable);
+
+/**
+ * Enable or disable the computation of sample statistics by sync_rx(),
+ * sync_rx_multi() and sync_rx_nb(). This takes effect at the next sync_init()
+ * call for an RX layout.
+ *
+ * @param[inout]    sync        Sync handle
+ * @param[in]       enable      Compute statistics
+ * @param[in]       clip        Clip threshold, or 0 for the default
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL on an invalid clip threshold
+ */
+int sync_set_rx_stats(struct bladerf_sync *sync,
+                      bool enable,
+                      unsigned int clip);
+
+/**
+ * Get the sample statistics of the most recent sync_rx(), sync_rx_multi() or
+ * sync_rx_nb() call
+ *
+ * @param[in]       sync        Sync handle
+ * @param[out]      stats       Statistics
+ *
+ * @return 0 on success, BLADERF_ERR_UNSUPPORTED if statistics are not being
+ *         computed
+ */
+int sync_get_rx_stats(struct bladerf_sync *sync,
+                      struct bladerf_rx_stats *stats);
+
+/**
+ * Set or clear the capture tap of the RX stream. This takes effect at the
+ * next sync_init() call for an RX layout.
+ *
+ * @param[inout]    sync        Sync handle
+ * @param[in]       tap         Tap configuration, or NULL to disable the tap
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL on an empty or overlong path
+ */
+int sync_set_rx_tap(struct bladerf_sync *sync,
+                    const struct bladerf_sync_rx_tap *tap);
+
+/**
+ * Get the number of samples per channel in each RX metadata message
+ *
+ * @param[in]       sync        Sync handle
+ *
+ * @return Samples per channel in a message, or 0 if the handle is not
+ *         configured for a metadata format
+ */
+unsigned int sync_rx_msg_samples(struct bladerf_sync *sync);
+
+/**
+ * Set the allocator for the stream buffers. This takes effect at the next
+ * sync_init() call.
+ *
+ * @param[inout]    sync        Sync handle
+ * @param[in]       allocator   Buffer allocator, or NULL for the default
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if `alloc` is NULL
+ */
+int sync_set_buffer_allocator(struct bladerf_sync *sync,
+                              const struct bladerf_buffer_allocator *allocator);
+
 /**
  * Deinitialize the sync handle. This tears down and deallocates the underlying
  * asynchronous stream.
@@ -186,8 +516,363 @@ int sync_tx(struct bladerf_sync *sync,
             struct bladerf_metadata *metadata,
             unsigned int timeout_ms);
 
+/**
+ * Non-blocking variants of sync_rx() and sync_tx(). See bladerf_sync_rx_nb()
+ * and bladerf_sync_tx_nb() for the conditions under which these return
+ * BLADERF_ERR_WOULD_BLOCK.
+ *
+ * @return 0 on success, BLADERF_ERR_WOULD_BLOCK if the call would have to
+ *         wait for a buffer, or another BLADERF_ERR_* value on failure
+ */
+int sync_rx_nb(struct bladerf_sync *sync,
+               void *samples,
+               unsigned int num_samples,
+               struct bladerf_metadata *metadata);
+
+int sync_tx_nb(struct bladerf_sync *sync,
+               void const *samples,
+               unsigned int num_samples,
+               struct bladerf_metadata *metadata);
+
+/**
+ * Get the handle's readiness notification object, creating it if needed.
+ * It remains valid until sync_deinit().
+ *
+ * @param[inout]    sync    Sync handle
+ * @param[out]      fd      Notification object
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if the handle is not initialized,
+ *         BLADERF_ERR_IO if the object could not be created
+ */
+int sync_get_ready_fd(struct bladerf_sync *sync, bladerf_ready_fd *fd);
+
+/**
+ * Start the worker and its underlying stream, if they are not already
+ * running, without waiting for a buffer.
+ *
+ * @param[inout]    sync    Sync handle
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int sync_prearm(struct bladerf_sync *sync);
+
+/**
+ * Receive samples into one buffer per channel. The samples of multi-channel
+ * layouts are deinterleaved while being copied out of the stream buffers.
+ *
+ * @param[inout]    sync        Sync handle
+ * @param[out]      bufs        One buffer per channel in the stream layout
+ * @param[in]       num_samples Number of samples to receive per channel
+ * @param[inout]    metadata    Metadata, as with sync_rx(). actual_count is
+ *                              reported per channel.
+ * @param[in]       timeout_ms  Timeout, in ms. 0 implies "wait forever."
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int sync_rx_multi(struct bladerf_sync *sync,
+                  void *const *bufs,
+                  unsigned int num_samples,
+                  struct bladerf_metadata *metadata,
+                  unsigned int timeout_ms);
+
+/**
+ * Transmit samples from one buffer per channel. The samples of multi-channel
+ * layouts are interleaved while being copied into the stream buffers.
+ *
+ * @param[inout]    sync        Sync handle
+ * @param[in]       bufs        One buffer per channel in the stream layout
+ * @param[in]       num_samples Number of samples to transmit per channel
+ * @param[inout]    metadata    Metadata, as with sync_tx()
+ * @param[in]       timeout_ms  Timeout, in ms. 0 implies "wait forever."
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int sync_tx_multi(struct bladerf_sync *sync,
+                  const void *const *bufs,
+                  unsigned int num_samples,
+                  struct bladerf_metadata *metadata,
+                  unsigned int timeout_ms);
+
+/**
+ * Receive up to `num_pkts` packets in the BLADERF_FORMAT_PACKET_META format,
+ * waiting only for the first. See bladerf_sync_rx_packets().
+ *
+ * @param[inout]    sync            Sync handle
+ * @param[inout]    pkts            Packet descriptors
+ * @param[in]       num_pkts        Number of descriptors
+ * @param[out]      num_received    Number of packets received
+ * @param[in]       timeout_ms      Timeout, in ms. 0 implies "wait forever."
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int sync_rx_packets(struct bladerf_sync *sync,
+                    struct bladerf_packet *pkts,
+                    unsigned int num_pkts,
+                    unsigned int *num_received,
+                    unsigned int timeout_ms);
+
+/**
+ * Send `num_pkts` packets in the BLADERF_FORMAT_PACKET_META format. See
+ * bladerf_sync_tx_packets().
+ *
+ * @param[inout]    sync        Sync handle
+ * @param[in]       pkts        Packet descriptors
+ * @param[in]       num_pkts    Number of descriptors
+ * @param[out]      num_sent    Number of packets sent. May be NULL.
+ * @param[in]       timeout_ms  Timeout, in ms. 0 implies "wait forever."
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int sync_tx_packets(struct bladerf_sync *sync,
+                    const struct bladerf_packet *pkts,
+                    unsigned int num_pkts,
+                    unsigned int *num_sent,
+                    unsigned int timeout_ms);
+
+/**
+ * Wait for the next full RX buffer and lend it to the caller, without copying
+ * it. The buffer is not reused by the stream until it is passed back to
+ * sync_rx_release(). Multiple buffers may be held at once.
+ *
+ * For *_META formats, the buffer contains the raw messages (headers
+ * included). `metadata`, if non-NULL, is populated with the timestamp of the
+ * first message and the status flags accumulated over all messages.
+ *
+ * @param[inout]    sync        Sync handle
+ * @param[out]      buffer      Set to the address of the lent buffer
+ * @param[out]      num_samples Number of samples in the buffer, excluding
+ *                              metadata headers
+ * @param[out]      metadata    Optional metadata for the buffer
+ * @param[in]       timeout_ms  Timeout, in ms. 0 implies "wait forever."
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int sync_rx_acquire(struct bladerf_sync *sync,
+                    void **buffer,
+                    unsigned int *num_samples,
+                    struct bladerf_metadata *metadata,
+                    unsigned int timeout_ms);
+
+/**
+ * Return a buffer obtained via sync_rx_acquire() to the stream
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if `buffer` is not currently lent
+ */
+int sync_rx_release(struct bladerf_sync *sync, void *buffer);
+
+/**
+ * Wait for the next empty TX buffer and lend it to the caller to fill in
+ * place. Only one TX buffer may be held at a time, and it must be passed
+ * to sync_tx_submit() before sync_tx() or sync_tx_acquire() may be used
+ * again, unless TX pool mode is enabled. Only the non-metadata formats are
+ * supported.
+ *
+ * @param[inout]    sync        Sync handle
+ * @param[out]      buffer      Set to the address of the lent buffer
+ * @param[out]      num_samples Capacity of the buffer, in samples
+ * @param[in]       timeout_ms  Timeout, in ms. 0 implies "wait forever."
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int sync_tx_acquire(struct bladerf_sync *sync,
+                    void **buffer,
+                    unsigned int *num_samples,
+                    unsigned int timeout_ms);
+
+/**
+ * As sync_tx_acquire() in TX pool mode, additionally providing the
+ * per-channel sample position of the reserved buffer, relative to the start
+ * of the stream.
+ *
+ * @param[inout]    sync        Sync handle
+ * @param[out]      buffer      Set to the address of the reserved buffer
+ * @param[out]      num_samples Capacity of the buffer, in samples
+ * @param[out]      position    Position of the buffer's first sample
+ * @param[in]       timeout_ms  Timeout, in ms. 0 implies "wait forever."
+ *
+ * @return 0 on success, BLADERF_ERR_UNSUPPORTED outside of TX pool mode,
+ *         BLADERF_ERR_* value on failure
+ */
+int sync_tx_reserve(struct bladerf_sync *sync,
+                    void **buffer,
+                    unsigned int *num_samples,
+                    uint64_t *position,
+                    unsigned int timeout_ms);
+
+/**
+ * Submit a buffer obtained via sync_tx_acquire() or sync_tx_reserve() for
+ * transmission. If fewer than a full buffer's worth of samples are provided,
+ * the remainder of the buffer is zero-filled.
+ *
+ * In TX pool mode, the buffer is transmitted once every buffer reserved
+ * before it has been submitted. If passing a buffer to the stream fails, it
+ * is attempted again by the next sync_tx_submit() call.
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int sync_tx_submit(struct bladerf_sync *sync,
+                   void *buffer,
+                   unsigned int num_samples);
+
+/**
+ * Pre-format a burst of samples into TX stream buffers for repeated
+ * transmission via sync_tx_template(). Only the *_META formats (excluding
+ * BLADERF_FORMAT_PACKET_META) are supported. The final buffer is
+ * zero-padded.
+ *
+ * The template is valid until it is passed to sync_tx_template_free() or the
+ * handle is deinitialized.
+ *
+ * @param[inout]    sync        Sync handle
+ * @param[in]       samples     Samples, in the format given to sync_init()
+ * @param[in]       num_samples Number of samples, as with sync_tx()
+ * @param[out]      tmpl        Set to the created template
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int sync_tx_template_create(struct bladerf_sync *sync,
+                            const void *samples,
+                            unsigned int num_samples,
+                            struct bladerf_tx_template **tmpl);
+
+/**
+ * Schedule a template for transmission at the specified timestamp. The
+ * template's buffers are submitted as-is, following any buffers already
+ * queued by sync_tx(). A template may not be resent until its previous
+ * transmission has completed; this call waits for that as needed.
+ *
+ * @param[inout]    sync        Sync handle
+ * @param[in]       tmpl        Template from sync_tx_template_create()
+ * @param[in]       timestamp   Timestamp of the first sample of the template
+ * @param[in]       timeout_ms  Timeout, in ms. 0 implies "wait forever."
+ *
+ * @return 0 on success, BLADERF_ERR_* value on failure
+ */
+int sync_tx_template(struct bladerf_sync *sync,
+                     struct bladerf_tx_template *tmpl,
+                     uint64_t timestamp,
+                     unsigned int timeout_ms);
+
+/**
+ * Free a template, waiting for any transmission of it to complete.
+ *
+ * @return 0 on success, BLADERF_ERR_TIMEOUT if the template is still in flight
+ *         after the stream timeout, BLADERF_ERR_INVAL if the template does not
+ *         belong to the handle
+ */
+int sync_tx_template_free(struct bladerf_sync *sync,
+                          struct bladerf_tx_template *tmpl);
+
+/**
+ * Account for the completion of a TX buffer that does not belong to the ring,
+ * i.e., one belonging to a template. Called by the TX worker callback with
+ * the buffer lock held.
+ *
+ * @return true if `buf` belongs to a template, false otherwise
+ */
+bool sync_tx_template_complete(struct bladerf_sync *sync, void *buf);
+
+/* Buffer status accessors. These must be used wherever a status may be
+ * accessed concurrently by the worker callback and the API caller. */
+static inline sync_buffer_status sync_buf_status(struct buffer_mgmt *b,
+                                                 unsigned int idx)
+{
+    return (sync_buffer_status)ATOMIC_LOAD(&b->status[idx]);
+}
+
+static inline void sync_set_buf_status(struct buffer_mgmt *b,
+                                       unsigned int idx,
+                                       sync_buffer_status status)
+{
+    TRACE_POINT3(buf_status, (uintptr_t)b, idx, status);
+    ATOMIC_STORE(&b->status[idx], status);
+}
+
+/**
+ * Wake a thread waiting on buf_ready, if there is one, and signal the
+ * readiness notification object, if it has been opened. `locked` denotes
+ * whether b->lock is already held by the caller.
+ */
+static inline void sync_signal_buf_ready(struct buffer_mgmt *b, bool locked)
+{
+    sync_ready_notify(&b->notify);
+
+    if (b->wait_policy == BLADERF_SYNC_WAIT_BLOCK) {
+        assert(locked);
+        pthread_cond_signal(&b->buf_ready);
+    } else if (ATOMIC_LOAD(&b->waiters) != 0) {
+        if (!locked) {
+            MUTEX_LOCK(&b->lock);
+        }
+
+        pthread_cond_signal(&b->buf_ready);
+
+        if (!locked) {
+            MUTEX_UNLOCK(&b->lock);
+        }
+    }
+}
+
+/**
+ * Bracket a change of the sample rate on a running RX stream. Transfers
+ * received after the call made before the change are discarded. The call
+ * made after the change also discards those then in flight, which may hold
+ * samples taken during the change, and marks the next buffer received with
+ * BLADERF_META_STATUS_RATE_CHANGE.
+ *
+ * Only the worker callback is signalled, so this may be called while another
+ * thread is in sync_rx(). It does nothing if the stream is not running.
+ *
+ * @param[inout]    sync    Sync handle
+ * @param[in]       begin   true before the change, false after it
+ */
+void sync_rx_rate_change(struct bladerf_sync *sync, bool begin);
+
+/**
+ * Wait for the TX buffers submitted before this call to be transmitted. A
+ * buffer still being filled by sync_tx() has not been submitted. This does
+ * not take the handle's lock, so may be called while another thread is in
+ * sync_tx().
+ *
+ * @param[inout]    sync        Sync handle
+ * @param[in]       timeout_ms  Timeout, in ms. 0 implies "wait forever."
+ *
+ * @return 0 on success, BLADERF_ERR_TIMEOUT if buffers remain in flight
+ */
+int sync_tx_drain(struct bladerf_sync *sync, unsigned int timeout_ms);
+
+/**
+ * Retrieve stream statistics accumulated since sync_init()
+ *
+ * @return 0 on success, BLADERF_ERR_INVAL if the handle is not initialized
+ */
+int sync_get_stats(struct bladerf_sync *sync,
+                   struct bladerf_stream_stats *stats);
+
+/* Account for a buffer being produced. Must only be called by the producer. */
+static inline void sync_stats_produced(struct sync_stats *st)
+{
+    const unsigned int num_full = (unsigned int)ATOMIC_INC(&st->num_full);
+
+    st->produced++;
+    if (num_full > st->high_water) {
+        st->high_water = num_full;
+    }
+}
+
+/* Account for a buffer being consumed. Must only be called by the consumer.
+ * Returns the number of buffers that remain produced but unconsumed. */
+static inline unsigned int sync_stats_consumed(struct sync_stats *st)
+{
+    st->consumed++;
+    return (unsigned int)ATOMIC_DEC(&st->num_full);
+}
+
 unsigned int sync_buf2idx(struct buffer_mgmt *b, void *addr);
 
+/* Test whether `addr` is one of the buffers of the ring */
+bool sync_buf_in_ring(struct buffer_mgmt *b, void *addr);
+
 void *sync_idx2buf(struct buffer_mgmt *b, unsigned int idx);
 
 #endif
@@ -38,11 +38,38 @@
 
 #include "board/board.h"
 #include "backend/usb/usb.h"
+#include "helpers/numa.h"
+#include "helpers/thread_attrs.h"
+#include "helpers/trace.h"
 
 #define worker2str(s) (direction2str(s->stream_config.layout & BLADERF_DIRECTION_MASK))
 
 void *sync_worker_task(void *arg);
 
+/* Select the next buffer to submit for reception, or return
+ * BUFFER_MGMT_INVALID_INDEX if none is available. Buffers are normally filled
+ * strictly in order. In pool mode, any buffer the caller has released may be
+ * used, so that one long-held buffer does not stall the stream. */
+static unsigned int next_free_buf(struct buffer_mgmt *b)
+{
+    unsigned int i, idx;
+
+    if (sync_buf_status(b, b->prod_i) == SYNC_BUFFER_EMPTY) {
+        return b->prod_i;
+    }
+
+    if (b->pool) {
+        for (i = 1; i < b->num_buffers; i++) {
+            idx = (b->prod_i + i) % b->num_buffers;
+            if (sync_buf_status(b, idx) == SYNC_BUFFER_EMPTY) {
+                return idx;
+            }
+        }
+    }
+
+    return BUFFER_MGMT_INVALID_INDEX;
+}
+
 static void *rx_callback(struct bladerf *dev,
                          struct bladerf_stream *stream,
                          struct bladerf_metadata *meta,
@@ -51,14 +78,21 @@ static void *rx_callback(struct bladerf *dev,
                          void *user_data)
 {
     unsigned int requests;      /* Pending requests */
+    unsigned int rate_change;   /* Request of sync_rx_rate_change() */
     unsigned int next_idx;
     unsigned int samples_idx;
+    uint64_t position;
     void *next_buf = NULL;      /* Next buffer to submit for reception */
 
     struct bladerf_sync *s = (struct bladerf_sync *)user_data;
     struct sync_worker  *w = s->worker;
     struct buffer_mgmt  *b = &s->buf_mgmt;
 
+    /* Pool mode searches for free buffers and maintains the ready FIFO,
+     * which requires the lock */
+    const bool lockless = (b->wait_policy == BLADERF_SYNC_WAIT_SPIN) &&
+                          !b->pool;
+
     /* Check if the caller has requested us to shut down. We'll keep the
      * SHUTDOWN bit set through our transition into the IDLE state so we
      * can act on it there. */
@@ -66,28 +100,79 @@ static void *rx_callback(struct bladerf *dev,
     requests = w->requests;
     MUTEX_UNLOCK(&w->request_lock);
 
-    if (requests & SYNC_WORKER_STOP) {
-        log_verbose("%s worker: Got STOP request upon entering callback. "
-                    "Ending stream.\n", worker2str(s));
+    if (requests & (SYNC_WORKER_STOP | SYNC_WORKER_PAUSE)) {
+        log_verbose("%s worker: Got STOP or PAUSE request upon entering "
+                    "callback. Ending stream.\n", worker2str(s));
         return NULL;
     }
 
-    MUTEX_LOCK(&b->lock);
+    /* With the spin wait policy, this callback is the sole producer and only
+     * touches the producer-owned fields of the buffer management, so it need
+     * not take the lock. Buffer statuses are handed off atomically. */
+    if (!lockless) {
+        MUTEX_LOCK(&b->lock);
+    }
 
     /* Get the index of the buffer that was just filled */
     samples_idx = sync_buf2idx(b, samples);
 
-    if (b->resubmit_count == 0) {
-        if (b->status[b->prod_i] == SYNC_BUFFER_EMPTY) {
+    /* Position of this buffer within the stream, in samples per channel */
+    position = b->rx_position;
+    b->rx_position += num_samples / s->meta.samples_per_ts;
+
+    /* Once a sample rate change is done, the transfers still in flight,
+     * including this one, may hold samples taken during the change */
+    rate_change = ATOMIC_LOAD(&b->rate_change_req);
+    if (rate_change == SYNC_RATE_CHANGE_DONE) {
+        b->resubmit_count      = s->stream_config.num_xfers;
+        b->rate_change_pending = true;
+        ATOMIC_CAS(&b->rate_change_req, SYNC_RATE_CHANGE_DONE,
+                   SYNC_RATE_CHANGE_NONE);
+    }
+
+    if (rate_change == SYNC_RATE_CHANGE_FLUSH) {
+        /* The sample rate is being changed */
+        next_buf = samples;
+        b->stats.dropped++;
+        log_verbose("Discarding buffer %u during rate change\r\n",
+                    samples_idx);
+    } else if (b->resubmit_count == 0) {
+        next_idx = next_free_buf(b);
+
+        if (next_idx != BUFFER_MGMT_INVALID_INDEX) {
 
-            /* This buffer is now ready for the consumer */
-            b->status[samples_idx] = SYNC_BUFFER_FULL;
+            /* This buffer is now ready for the consumer. Its length,
+             * position, and discontinuity flag must be written before the
+             * status is published. */
             b->actual_lengths[samples_idx] = num_samples;
-            pthread_cond_signal(&b->buf_ready);
+            b->position[samples_idx]       = position;
+            b->host_arrival[samples_idx]   = meta->host_timestamp;
+            b->discontinuity[samples_idx]  = b->overrun_pending;
+            b->rate_change[samples_idx]    = b->rate_change_pending;
+            b->overrun_pending             = false;
+            b->rate_change_pending         = false;
+            sync_stats_produced(&b->stats);
+
+            if (b->pool) {
+                const unsigned int tail =
+                    (b->ready_head + b->ready_count) % b->num_buffers;
+
+                b->ready[tail] = samples_idx;
+                b->ready_count++;
+            }
+
+            sync_set_buf_status(b, samples_idx, SYNC_BUFFER_FULL);
+            sync_signal_buf_ready(b, !lockless);
+
+            if (s->tap != NULL) {
+                /* Queued by reference, after the consumer has been woken.
+                 * The tap gives up any buffer we need back below. */
+                sync_tap_push(s->tap, samples_idx, position, num_samples);
+                sync_tap_reclaim(s->tap, next_idx);
+            }
 
             /* Update the state of the buffer being submitted next */
-            next_idx = b->prod_i;
-            b->status[next_idx] = SYNC_BUFFER_IN_FLIGHT;
+            sync_set_buf_status(b, next_idx, SYNC_BUFFER_IN_FLIGHT);
             next_buf = b->buffers[next_idx];
 
             /* Advance to the next buffer for the next callback */
@@ -97,23 +182,31 @@ static void *rx_callback(struct bladerf *dev,
                         worker2str(s), samples_idx, next_idx);
 
         } else {
-            /* TODO propagate back the RX Overrun to the sync_rx() caller */
+            /* The caller is notified of the discontinuity via the next
+             * buffer that makes it into the ring */
             log_debug("RX overrun @ buffer %u\r\n", samples_idx);
+            TRACE_POINT2(rx_overrun, (uintptr_t)s, samples_idx);
 
             next_buf = samples;
             b->resubmit_count = s->stream_config.num_xfers - 1;
+            b->overrun_pending = true;
+            b->stats.overruns++;
+            b->stats.dropped++;
         }
     } else {
         /* We're still recovering from an overrun at this point. Just
          * turn around and resubmit this buffer */
         next_buf = samples;
         b->resubmit_count--;
+        b->stats.dropped++;
         log_verbose("Resubmitting buffer %u (%u resubmissions left)\r\n",
                     samples_idx, b->resubmit_count);
     }
 
+    if (!lockless) {
+        MUTEX_UNLOCK(&b->lock);
+    }
 
-    MUTEX_UNLOCK(&b->lock);
     return next_buf;
 }
 
@@ -140,9 +233,9 @@ static void *tx_callback(struct bladerf *dev,
     requests = w->requests;
     MUTEX_UNLOCK(&w->request_lock);
 
-    if (requests & SYNC_WORKER_STOP) {
-        log_verbose("%s worker: Got STOP request upon entering callback. "
-                    "Ending stream.\r\n", worker2str(s));
+    if (requests & (SYNC_WORKER_STOP | SYNC_WORKER_PAUSE)) {
+        log_verbose("%s worker: Got STOP or PAUSE request upon entering "
+                    "callback. Ending stream.\r\n", worker2str(s));
         return NULL;
     }
 
@@ -151,11 +244,25 @@ static void *tx_callback(struct bladerf *dev,
     if (samples != NULL) {
         MUTEX_LOCK(&b->lock);
 
-        /* Mark the completed buffer as being empty */
-        completed_idx = sync_buf2idx(b, samples);
-        assert(b->status[completed_idx] == SYNC_BUFFER_IN_FLIGHT);
-        b->status[completed_idx] = SYNC_BUFFER_EMPTY;
-        pthread_cond_signal(&b->buf_ready);
+        if (sync_buf_in_ring(b, samples)) {
+            /* Mark the completed buffer as being empty */
+            completed_idx = sync_buf2idx(b, samples);
+            assert(b->status[completed_idx] == SYNC_BUFFER_IN_FLIGHT);
+            sync_set_buf_status(b, completed_idx, SYNC_BUFFER_EMPTY);
+        } else {
+            /* Buffers submitted directly by sync_tx_template() */
+            const bool is_template = sync_tx_template_complete(s, samples);
+            assert(is_template);
+            (void)is_template;
+            completed_idx = BUFFER_MGMT_INVALID_INDEX;
+        }
+
+        sync_signal_buf_ready(b, true);
+
+        /* Nothing left queued or in flight; the device is being starved */
+        if (sync_stats_consumed(&b->stats) == 0) {
+            b->stats.underruns++;
+        }
 
         /* If the callback is assigned to be the submitter, there are
          * buffers pending submission */
@@ -169,7 +276,7 @@ static void *tx_callback(struct bladerf *dev,
                 ret = b->buffers[b->cons_i];
                 /* This is actually # of 32bit DWORDs for PACKET_META */
                 meta->actual_count = b->actual_lengths[b->cons_i];
-                b->status[b->cons_i] = SYNC_BUFFER_IN_FLIGHT;
+                sync_set_buf_status(b, b->cons_i, SYNC_BUFFER_IN_FLIGHT);
                 b->cons_i = (b->cons_i + 1) % b->num_buffers;
             } else {
                 log_verbose("%s: No deferred buffer available. "
@@ -210,7 +317,8 @@ int sync_worker_init(struct bladerf_sync *s)
     status = async_init_stream(
         &s->worker->stream, s->dev, s->worker->cb, &s->buf_mgmt.buffers,
         s->buf_mgmt.num_buffers, s->stream_config.format,
-        s->stream_config.samples_per_buffer, s->stream_config.num_xfers, s);
+        s->stream_config.samples_per_buffer, s->stream_config.num_xfers, s,
+        s->allocator.alloc != NULL ? &s->allocator : NULL);
 
     if (status != 0) {
         log_debug("%s worker: Failed to init stream: %s\n", worker2str(s),
@@ -218,6 +326,9 @@ int sync_worker_init(struct bladerf_sync *s)
         goto worker_init_out;
     }
 
+    s->buf_mgmt.buffer_bytes = s->worker->stream->buffer_bytes;
+    s->worker->stream->tx_variable_length = s->stream_config.tx_short_bursts;
+
     status = async_set_transfer_timeout(
         s->worker->stream,
         uint_max(s->stream_config.timeout_ms, BULK_TIMEOUT_MS));
@@ -308,6 +419,55 @@ void sync_worker_deinit(struct sync_worker *w,
     free(w);
 }
 
+int sync_worker_pause(struct bladerf_sync *s)
+{
+    struct sync_worker *w = s->worker;
+    sync_worker_state state;
+
+    state = sync_worker_get_state(w, NULL);
+    if (state == SYNC_WORKER_STATE_IDLE) {
+        return 0;
+    } else if (state != SYNC_WORKER_STATE_RUNNING) {
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    sync_worker_submit_request(w, SYNC_WORKER_PAUSE);
+
+    /* A TX stream with no transfers in flight has no callback to act on the
+     * request */
+    if ((s->stream_config.layout & BLADERF_DIRECTION_MASK) == BLADERF_TX) {
+        async_submit_stream_buffer(w->stream, BLADERF_STREAM_SHUTDOWN, NULL,
+                                   0, false);
+    }
+
+    MUTEX_LOCK(&s->buf_mgmt.lock);
+    pthread_cond_signal(&s->buf_mgmt.buf_ready);
+    MUTEX_UNLOCK(&s->buf_mgmt.lock);
+
+    return sync_worker_wait_for_state(w, SYNC_WORKER_STATE_IDLE, 3000);
+}
+
+int sync_worker_update(struct bladerf_sync *s)
+{
+    struct sync_worker *w = s->worker;
+    int status;
+
+    w->stream->tx_variable_length = s->stream_config.tx_short_bursts;
+
+    status = async_set_transfer_timeout(
+        w->stream, uint_max(s->stream_config.timeout_ms, BULK_TIMEOUT_MS));
+    if (status != 0) {
+        return status;
+    }
+
+    /* The pause is not an error to report to the next caller */
+    MUTEX_LOCK(&w->state_lock);
+    w->err_code = 0;
+    MUTEX_UNLOCK(&w->state_lock);
+
+    return 0;
+}
+
 void sync_worker_submit_request(struct sync_worker *w, unsigned int request)
 {
     MUTEX_LOCK(&w->request_lock);
@@ -390,6 +550,8 @@ sync_worker_state sync_worker_get_state(struct sync_worker *w,
 
 static void set_state(struct sync_worker *w, sync_worker_state state)
 {
+    TRACE_POINT2(worker_state, (uintptr_t)w, state);
+
     MUTEX_LOCK(&w->state_lock);
     w->state = state;
     pthread_cond_signal(&w->state_changed);
@@ -401,7 +563,7 @@ static sync_worker_state exec_idle_state(struct bladerf_sync *s)
 {
     sync_worker_state next_state = SYNC_WORKER_STATE_IDLE;
     unsigned int requests;
-    unsigned int i;
+    unsigned int i, full;
 
     MUTEX_LOCK(&s->worker->request_lock);
 
@@ -430,26 +592,62 @@ static sync_worker_state exec_idle_state(struct bladerf_sync *s)
             * stale buffers marked "in-flight" that have since been cancelled. */
             for (i = 0; i < s->buf_mgmt.num_buffers; i++) {
                 if (s->buf_mgmt.status[i] == SYNC_BUFFER_IN_FLIGHT) {
-                    s->buf_mgmt.status[i] = SYNC_BUFFER_EMPTY;
+                    sync_set_buf_status(&s->buf_mgmt, i, SYNC_BUFFER_EMPTY);
+                    s->buf_mgmt.stats.dropped++;
                 }
             }
 
             pthread_cond_signal(&s->buf_mgmt.buf_ready);
+            sync_ready_notify(&s->buf_mgmt.notify);
         } else {
             s->buf_mgmt.prod_i = s->stream_config.num_xfers;
 
             for (i = 0; i < s->buf_mgmt.num_buffers; i++) {
                 if (i < s->stream_config.num_xfers) {
                     s->buf_mgmt.status[i] = SYNC_BUFFER_IN_FLIGHT;
+                    if (s->tap != NULL) {
+                        sync_tap_reclaim(s->tap, i);
+                    }
                 } else if (s->buf_mgmt.status[i] == SYNC_BUFFER_IN_FLIGHT) {
                     s->buf_mgmt.status[i] = SYNC_BUFFER_EMPTY;
                 }
             }
+
+            s->buf_mgmt.resubmit_count      = 0;
+            s->buf_mgmt.overrun_pending     = false;
+            s->buf_mgmt.rate_change_pending = false;
+            ATOMIC_STORE(&s->buf_mgmt.rate_change_req, SYNC_RATE_CHANGE_NONE);
+
+            /* Pool mode hands out buffers via the ready FIFO alone. Those
+             * received before the restart are stale. */
+            if (s->buf_mgmt.pool) {
+                for (i = 0; i < s->buf_mgmt.num_buffers; i++) {
+                    if (s->buf_mgmt.status[i] == SYNC_BUFFER_FULL) {
+                        s->buf_mgmt.status[i] = SYNC_BUFFER_EMPTY;
+                        s->buf_mgmt.stats.dropped++;
+                    }
+                }
+
+                s->buf_mgmt.ready_head  = 0;
+                s->buf_mgmt.ready_count = 0;
+            }
         }
 
+        /* Only buffers still marked full survive the restart */
+        full = 0;
+        for (i = 0; i < s->buf_mgmt.num_buffers; i++) {
+            if (s->buf_mgmt.status[i] == SYNC_BUFFER_FULL) {
+                full++;
+            }
+        }
+        ATOMIC_STORE(&s->buf_mgmt.stats.num_full, full);
+
         MUTEX_UNLOCK(&s->buf_mgmt.lock);
 
         next_state = SYNC_WORKER_STATE_RUNNING;
+    } else if (requests & SYNC_WORKER_PAUSE) {
+        /* The stream has already ended */
+        log_verbose("%s worker: Paused\n", worker2str(s));
     } else {
         log_warning("Invalid request value encountered: 0x%08X\n",
                     s->worker->requests);
@@ -479,6 +677,7 @@ static void exec_running_state(struct bladerf_sync *s)
         MUTEX_LOCK(&s->buf_mgmt.lock);
         pthread_cond_signal(&s->buf_mgmt.buf_ready);
         MUTEX_UNLOCK(&s->buf_mgmt.lock);
+        sync_ready_notify(&s->buf_mgmt.notify);
     }
 }
 
@@ -488,6 +687,21 @@ void *sync_worker_task(void *arg)
     struct bladerf_sync *s = (struct bladerf_sync *)arg;
 
     log_verbose("%s worker: task started\n", worker2str(s));
+
+    /* USB transfers for this stream complete on this thread, so apply any
+     * requested affinity and scheduling attributes before the first run */
+    if (s->use_thread_attrs) {
+        if (thread_attrs_apply(&s->thread_attrs) != 0) {
+            log_warning("%s worker: Not all requested thread attributes "
+                        "could be applied.\n", worker2str(s));
+        }
+    }
+
+    /* Absent an explicit CPU, keep to the USB controller's NUMA node */
+    if (!s->use_thread_attrs || s->thread_attrs.cpu < 0) {
+        numa_bind_thread(numa_device_node(s->dev));
+    }
+
     set_state(s->worker, state);
     log_verbose("%s worker: task state set\n", worker2str(s));
 
@@ -39,6 +39,7 @@
 /* Request flags */
 #define SYNC_WORKER_START (1 << 0)
 #define SYNC_WORKER_STOP (1 << 1)
+#define SYNC_WORKER_PAUSE (1 << 2) /* End the stream, but remain IDLE */
 
 typedef enum {
     SYNC_WORKER_STATE_STARTUP,
@@ -93,6 +94,27 @@ void sync_worker_deinit(struct sync_worker *w,
                         pthread_mutex_t *lock,
                         pthread_cond_t *cond);
 
+/**
+ * End a running stream, leaving the worker IDLE so that the stream may be
+ * reconfigured and restarted
+ *
+ * @param       s       Sync handle containing the worker
+ *
+ * @return 0 on success, BLADERF_ERR_* on failure
+ */
+int sync_worker_pause(struct bladerf_sync *s);
+
+/**
+ * Apply the stream configuration of a sync_init() call that kept the paused
+ * worker, its stream and buffers. The stream's format and buffer size must
+ * already have been changed via async_reconfigure_stream().
+ *
+ * @param       s       Sync handle containing the worker
+ *
+ * @return 0 on success, BLADERF_ERR_* on failure
+ */
+int sync_worker_update(struct bladerf_sync *s);
+
 /**
  * Wait for state change with optional timeout
  *
@@ -0,0 +1,726 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "host_config.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if !BLADERF_OS_WINDOWS
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
+
+#include <libbladeRF.h>
+
+#include "log.h"
+#include "conversions.h"
+#include "rel_assert.h"
+#include "thread.h"
+
+#include "metadata.h"
+#include "tap.h"
+
+#define TAP_DATA_EXT ".sigmf-data"
+#define TAP_META_EXT ".sigmf-meta"
+
+/* Alignment of the staging buffer, and of the size of each write to a file
+ * opened with O_DIRECT */
+#define TAP_ALIGN 4096
+
+/* Size of the staging buffer. Writes are batched up to this size while the
+ * writer is behind. */
+#define TAP_STAGING_BYTES (4 * 1024 * 1024)
+
+/* Claim of the tap on each stream buffer */
+#define TAP_SLOT_FREE    0 /* Not held by the tap */
+#define TAP_SLOT_QUEUED  1 /* Queued for the writer */
+#define TAP_SLOT_COPYING 2 /* Being copied out by the writer */
+#define TAP_SLOT_REVOKED 3 /* Reclaimed by the stream while queued or being
+                            * copied. Only the writer moves it on from here. */
+
+struct tap_entry {
+    unsigned int idx;
+    uint64_t position;
+    size_t num_samples;
+};
+
+/* Start of a run of contiguous samples in the recording */
+struct tap_segment {
+    uint64_t sample_start; /* Sample index, counting multi-channel samples
+                            * (one I/Q pair per channel) as one */
+    uint64_t position;     /* Timestamp or stream position of the sample */
+};
+
+struct sync_tap {
+    struct sync_tap_config config; /* `path` and `hw` are not retained */
+
+    unsigned int *claim;       /* TAP_SLOT_* of each buffer. Accessed
+                                * atomically. */
+
+    /* Single-producer, single-consumer queue of the buffers to write. `head`
+     * is advanced by the worker callback and `tail` by the writer; both run
+     * freely, and are accessed atomically. */
+    struct tap_entry *queue;
+    unsigned int depth;
+    unsigned int head;
+    unsigned int tail;
+
+    unsigned int waiting;      /* Writer is waiting on `cond`. Accessed
+                                * atomically. */
+    bool stop;                 /* Protected by `lock` */
+    MUTEX lock;
+    pthread_cond_t cond;
+    pthread_t thread;
+
+    /* Buffers the worker callback refused to queue. Written only by it. */
+    uint64_t refused;
+
+    /* Written only by the writer, under `lock` */
+    uint64_t written;
+    uint64_t dropped;
+
+    /* Remaining fields are only accessed by the writer, and by
+     * sync_tap_close() once it has stopped */
+#if BLADERF_OS_WINDOWS
+    FILE *file;
+#else
+    int fd;
+    bool direct;               /* File is opened with O_DIRECT */
+#endif
+    bool failed;               /* A write has failed; nothing more is
+                                * written */
+    char *data_path;
+    char *meta_path;
+    char *hw;
+
+    uint8_t *staging;
+    size_t staging_size;
+    size_t staging_len;
+
+    uint64_t samples;          /* Samples recorded so far */
+    uint64_t next_position;    /* Position expected of the next sample */
+    struct tap_segment *segments;
+    size_t num_segments;
+    size_t alloc_segments;
+    char datetime[32];         /* ISO 8601 time of the first sample */
+};
+
+static void *alloc_staging(size_t size)
+{
+    void *p = NULL;
+
+#if BLADERF_OS_WINDOWS
+    p = _aligned_malloc(size, TAP_ALIGN);
+#else
+    if (posix_memalign(&p, TAP_ALIGN, size) != 0) {
+        p = NULL;
+    }
+#endif
+
+    return p;
+}
+
+static void free_staging(void *p)
+{
+#if BLADERF_OS_WINDOWS
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+static char *concat(const char *a, size_t a_len, const char *b)
+{
+    char *s = malloc(a_len + strlen(b) + 1);
+
+    if (s != NULL) {
+        memcpy(s, a, a_len);
+        strcpy(s + a_len, b);
+    }
+
+    return s;
+}
+
+#if BLADERF_OS_WINDOWS
+static int tap_file_open(struct sync_tap *t)
+{
+    t->file = fopen(t->data_path, "wb");
+    if (t->file == NULL) {
+        log_error("Failed to open tap file %s: %s\n", t->data_path,
+                  strerror(errno));
+        return BLADERF_ERR_IO;
+    }
+
+    return 0;
+}
+
+static int tap_file_write(struct sync_tap *t, const uint8_t *data, size_t len)
+{
+    if (fwrite(data, 1, len, t->file) != len) {
+        log_error("Failed to write tap file %s\n", t->data_path);
+        return BLADERF_ERR_IO;
+    }
+
+    return 0;
+}
+
+static void tap_file_close(struct sync_tap *t)
+{
+    if (t->file != NULL) {
+        fclose(t->file);
+        t->file = NULL;
+    }
+}
+
+/* A write of `len` staged bytes must be a whole number of blocks */
+static size_t tap_file_block(struct sync_tap *t, size_t len, bool final)
+{
+    (void)t;
+    (void)final;
+    return len;
+}
+#else
+static int tap_file_open(struct sync_tap *t)
+{
+    const int flags = O_WRONLY | O_CREAT | O_TRUNC;
+
+    /* Bypass the page cache, such that a long recording neither evicts the
+     * application's pages nor stalls it when dirty pages are flushed. Not all
+     * filesystems support this (e.g., tmpfs), in which case the file is
+     * written normally. */
+    t->fd     = -1;
+    t->direct = false;
+
+#ifdef O_DIRECT
+    t->fd = open(t->data_path, flags | O_DIRECT, 0644);
+    t->direct = t->fd >= 0;
+#endif
+
+    if (t->fd < 0) {
+        t->fd = open(t->data_path, flags, 0644);
+    }
+
+    if (t->fd < 0) {
+        log_error("Failed to open tap file %s: %s\n", t->data_path,
+                  strerror(errno));
+        return BLADERF_ERR_IO;
+    }
+
+    log_verbose("%s: Writing %s%s\n", __FUNCTION__, t->data_path,
+                t->direct ? " with O_DIRECT" : "");
+    return 0;
+}
+
+static void tap_file_undirect(struct sync_tap *t)
+{
+#ifdef O_DIRECT
+    const int flags = fcntl(t->fd, F_GETFL);
+
+    if (flags >= 0) {
+        fcntl(t->fd, F_SETFL, flags & ~O_DIRECT);
+    }
+#endif
+    t->direct = false;
+}
+
+static int tap_file_write(struct sync_tap *t, const uint8_t *data, size_t len)
+{
+    while (len > 0) {
+        const ssize_t n = write(t->fd, data, len);
+
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            } else if (errno == EINVAL && t->direct) {
+                /* Some filesystems accept O_DIRECT at open(), but not the
+                 * writes that follow */
+                tap_file_undirect(t);
+                continue;
+            }
+
+            log_error("Failed to write tap file %s: %s\n", t->data_path,
+                      strerror(errno));
+            return BLADERF_ERR_IO;
+        }
+
+        data += n;
+        len -= (size_t)n;
+    }
+
+    return 0;
+}
+
+static void tap_file_close(struct sync_tap *t)
+{
+    if (t->fd >= 0) {
+        close(t->fd);
+        t->fd = -1;
+    }
+}
+
+/* Number of the `len` staged bytes that may be written now. With O_DIRECT,
+ * this is a whole number of blocks, and the remainder is held back until the
+ * final write, which is made without it. */
+static size_t tap_file_block(struct sync_tap *t, size_t len, bool final)
+{
+    if (!t->direct) {
+        return len;
+    } else if (final && len % TAP_ALIGN != 0) {
+        tap_file_undirect(t);
+        return len;
+    }
+
+    return len - len % TAP_ALIGN;
+}
+#endif
+
+/* Write out the staging buffer. Unless this is the final flush, part of a
+ * block may be held back for O_DIRECT. */
+static void tap_flush(struct sync_tap *t, bool final)
+{
+    const size_t len = tap_file_block(t, t->staging_len, final);
+
+    if (len == 0) {
+        return;
+    }
+
+    if (!t->failed && tap_file_write(t, t->staging, len) != 0) {
+        t->failed = true;
+    }
+
+    t->staging_len -= len;
+    memmove(t->staging, t->staging + len, t->staging_len);
+}
+
+/* Account for `count` samples at `position` appended to the recording,
+ * starting a segment at a discontinuity */
+static void tap_mark(struct sync_tap *t, uint64_t position, uint64_t count)
+{
+    if (t->num_segments == 0 || position != t->next_position) {
+        if (t->num_segments == t->alloc_segments) {
+            const size_t n = t->alloc_segments ? 2 * t->alloc_segments : 64;
+            struct tap_segment *segments;
+
+            segments = realloc(t->segments, n * sizeof(segments[0]));
+            if (segments == NULL) {
+                /* The samples are still recorded, just not the gap */
+                log_warning("Failed to record a tap discontinuity\n");
+                goto out;
+            }
+
+            t->segments       = segments;
+            t->alloc_segments = n;
+        }
+
+        t->segments[t->num_segments].sample_start = t->samples;
+        t->segments[t->num_segments].position     = position;
+        t->num_segments++;
+    }
+
+out:
+    t->samples += count;
+    t->next_position = position + count;
+}
+
+/* Copy the samples of a buffer into the staging buffer, leaving out any
+ * metadata headers */
+static void tap_copy(struct sync_tap *t, const struct tap_entry *e)
+{
+    const struct sync_tap_config *c = &t->config;
+    const uint8_t *buf = c->buffers[e->idx];
+
+    if (c->msg_size == 0) {
+        const size_t len = e->num_samples * c->bytes_per_sample;
+
+        tap_mark(t, e->position, e->num_samples / c->num_channels);
+        memcpy(t->staging + t->staging_len, buf, len);
+        t->staging_len += len;
+    } else {
+        const size_t len = c->msg_size - METADATA_HEADER_SIZE;
+        size_t off;
+
+        for (off = 0; off + c->msg_size <= c->buffer_bytes;
+             off += c->msg_size) {
+            tap_mark(t, metadata_get_timestamp(buf + off),
+                     len / c->bytes_per_sample / c->num_channels);
+            memcpy(t->staging + t->staging_len,
+                   buf + off + METADATA_HEADER_SIZE, len);
+            t->staging_len += len;
+        }
+    }
+}
+
+static void tap_dropped(struct sync_tap *t, unsigned int idx)
+{
+    ATOMIC_STORE(&t->claim[idx], TAP_SLOT_FREE);
+
+    MUTEX_LOCK(&t->lock);
+    t->dropped++;
+    MUTEX_UNLOCK(&t->lock);
+}
+
+static void tap_take(struct sync_tap *t, const struct tap_entry *e)
+{
+    size_t staging_len;
+    uint64_t samples, next_position;
+    size_t num_segments;
+
+    if (!ATOMIC_CAS(&t->claim[e->idx], TAP_SLOT_QUEUED, TAP_SLOT_COPYING)) {
+        /* Reclaimed by the stream before we got to it */
+        tap_dropped(t, e->idx);
+        return;
+    }
+
+    if (t->failed) {
+        tap_dropped(t, e->idx);
+        return;
+    }
+
+    if (t->staging_size - t->staging_len < t->config.buffer_bytes) {
+        tap_flush(t, false);
+    }
+
+    staging_len   = t->staging_len;
+    samples       = t->samples;
+    next_position = t->next_position;
+    num_segments  = t->num_segments;
+
+    tap_copy(t, e);
+
+    if (!ATOMIC_CAS(&t->claim[e->idx], TAP_SLOT_COPYING, TAP_SLOT_FREE)) {
+        /* The buffer was resubmitted while it was being copied, so the copy
+         * may be torn. Discard it. */
+        t->staging_len   = staging_len;
+        t->samples       = samples;
+        t->next_position = next_position;
+        t->num_segments  = num_segments;
+        tap_dropped(t, e->idx);
+        return;
+    }
+
+    if (t->datetime[0] == '\0') {
+        const time_t now = time(NULL);
+        struct tm tm;
+
+#if BLADERF_OS_WINDOWS
+        gmtime_s(&tm, &now);
+#else
+        gmtime_r(&now, &tm);
+#endif
+        strftime(t->datetime, sizeof(t->datetime), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    }
+
+    MUTEX_LOCK(&t->lock);
+    t->written++;
+    MUTEX_UNLOCK(&t->lock);
+}
+
+static void *tap_task(void *arg)
+{
+    struct sync_tap *t = (struct sync_tap *)arg;
+    bool stop = false;
+
+    while (true) {
+        const unsigned int tail = t->tail;
+
+        if (tail != ATOMIC_LOAD(&t->head)) {
+            tap_take(t, &t->queue[tail % t->depth]);
+            ATOMIC_STORE(&t->tail, tail + 1);
+            continue;
+        } else if (stop) {
+            break;
+        }
+
+        /* Caught up. Write out what is staged, such that writes are only
+         * batched while the disk is behind, then wait for more. */
+        tap_flush(t, false);
+
+        MUTEX_LOCK(&t->lock);
+        ATOMIC_STORE(&t->waiting, 1);
+        while (ATOMIC_LOAD(&t->head) == tail && !t->stop) {
+            pthread_cond_wait(&t->cond, &t->lock);
+        }
+        ATOMIC_STORE(&t->waiting, 0);
+        stop = t->stop;
+        MUTEX_UNLOCK(&t->lock);
+    }
+
+    tap_flush(t, true);
+    return NULL;
+}
+
+/* Write `str` as a JSON string literal */
+static void write_json_string(FILE *f, const char *str)
+{
+    fputc('"', f);
+
+    for (; *str != '\0'; str++) {
+        if (*str == '"' || *str == '\\') {
+            fprintf(f, "\\%c", *str);
+        } else if ((unsigned char)*str < 0x20) {
+            fprintf(f, "\\u%04x", (unsigned char)*str);
+        } else {
+            fputc(*str, f);
+        }
+    }
+
+    fputc('"', f);
+}
+
+/* Write the SigMF metadata of the recording. Segments of formats with
+ * metadata are located by device timestamp, as bladeRF-cli does, and those of
+ * other formats by their position within the stream. */
+static void tap_write_meta(struct sync_tap *t)
+{
+    const char *key = t->config.msg_size ? "bladerf:timestamp"
+                                         : "bladerf:position";
+    FILE *f;
+    size_t i;
+
+    f = fopen(t->meta_path, "w");
+    if (f == NULL) {
+        log_error("Failed to open tap file %s: %s\n", t->meta_path,
+                  strerror(errno));
+        return;
+    }
+
+    fprintf(f, "{\n");
+    fprintf(f, "    \"global\": {\n");
+    fprintf(f, "        \"core:datatype\": \"%s\",\n",
+            t->config.sc8 ? "ci8" : "ci16_le");
+    fprintf(f, "        \"core:sample_rate\": %" PRIu64 ",\n",
+            t->config.sample_rate);
+    fprintf(f, "        \"core:num_channels\": %u,\n",
+            t->config.num_channels);
+    fprintf(f, "        \"core:version\": \"1.0.0\",\n");
+    fprintf(f, "        \"core:recorder\": \"libbladeRF\",\n");
+    if (t->hw != NULL) {
+        fprintf(f, "        \"core:hw\": ");
+        write_json_string(f, t->hw);
+        fprintf(f, ",\n");
+    }
+    fprintf(f, "        \"core:extensions\": [\n");
+    fprintf(f, "            { \"name\": \"bladerf\", \"version\": \"1.0.0\", "
+               "\"optional\": true }\n");
+    fprintf(f, "        ]\n");
+    fprintf(f, "    },\n");
+
+    fprintf(f, "    \"captures\": [\n");
+    for (i = 0; i < t->num_segments; i++) {
+        fprintf(f, "        { \"core:sample_start\": %" PRIu64 ", "
+                   "\"%s\": %" PRIu64,
+                t->segments[i].sample_start, key, t->segments[i].position);
+
+        if (i == 0) {
+            fprintf(f, ", \"core:frequency\": %" PRIu64, t->config.frequency);
+            if (t->datetime[0] != '\0') {
+                fprintf(f, ", \"core:datetime\": \"%s\"", t->datetime);
+            }
+        }
+
+        fprintf(f, " }%s\n", (i + 1 < t->num_segments) ? "," : "");
+    }
+    fprintf(f, "    ],\n");
+
+    fprintf(f, "    \"annotations\": []\n");
+    fprintf(f, "}\n");
+
+    if (ferror(f) || fclose(f) != 0) {
+        log_error("Failed to write tap file %s\n", t->meta_path);
+    }
+}
+
+static void tap_free(struct sync_tap *t)
+{
+    free(t->claim);
+    free(t->queue);
+    free(t->data_path);
+    free(t->meta_path);
+    free(t->hw);
+    free(t->segments);
+    if (t->staging != NULL) {
+        free_staging(t->staging);
+    }
+    free(t);
+}
+
+int sync_tap_open(struct sync_tap **tap, const struct sync_tap_config *config)
+{
+    const size_t ext_len = strlen(TAP_DATA_EXT);
+    size_t path_len      = strlen(config->path);
+    struct sync_tap *t;
+    int status;
+
+    *tap = NULL;
+
+    t = calloc(1, sizeof(*t));
+    if (t == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    t->config       = *config;
+    t->config.path  = NULL;
+    t->config.hw    = NULL;
+    t->depth        = (config->depth == 0 || config->depth > config->num_buffers)
+                          ? config->num_buffers
+                          : config->depth;
+#if !BLADERF_OS_WINDOWS
+    t->fd           = -1;
+#endif
+
+    /* Room for a buffer beyond a partial block held back for O_DIRECT */
+    t->staging_size = TAP_STAGING_BYTES;
+    while (t->staging_size < config->buffer_bytes + TAP_ALIGN) {
+        t->staging_size *= 2;
+    }
+
+    if (path_len >= ext_len &&
+        !strcmp(config->path + path_len - ext_len, TAP_DATA_EXT)) {
+        path_len -= ext_len;
+    }
+
+    t->claim     = calloc(config->num_buffers, sizeof(t->claim[0]));
+    t->queue     = calloc(t->depth, sizeof(t->queue[0]));
+    t->data_path = concat(config->path, path_len, TAP_DATA_EXT);
+    t->meta_path = concat(config->path, path_len, TAP_META_EXT);
+    t->hw        = config->hw ? strdup(config->hw) : NULL;
+    t->staging   = alloc_staging(t->staging_size);
+
+    if (t->claim == NULL || t->queue == NULL || t->data_path == NULL ||
+        t->meta_path == NULL || (config->hw && t->hw == NULL) ||
+        t->staging == NULL) {
+        tap_free(t);
+        return BLADERF_ERR_MEM;
+    }
+
+    status = tap_file_open(t);
+    if (status != 0) {
+        tap_free(t);
+        return status;
+    }
+
+    MUTEX_INIT(&t->lock);
+
+    status = pthread_cond_init(&t->cond, NULL);
+    if (status != 0) {
+        log_debug("%s: pthread_cond_init failed: %d\n", __FUNCTION__, status);
+        status = BLADERF_ERR_UNEXPECTED;
+        goto error;
+    }
+
+    status = pthread_create(&t->thread, NULL, tap_task, t);
+    if (status != 0) {
+        log_debug("%s: pthread_create failed: %d\n", __FUNCTION__, status);
+        pthread_cond_destroy(&t->cond);
+        status = BLADERF_ERR_UNEXPECTED;
+        goto error;
+    }
+
+    *tap = t;
+    return 0;
+
+error:
+    MUTEX_DESTROY(&t->lock);
+    tap_file_close(t);
+    tap_free(t);
+    return status;
+}
+
+void sync_tap_close(struct sync_tap *tap)
+{
+    if (tap == NULL) {
+        return;
+    }
+
+    MUTEX_LOCK(&tap->lock);
+    tap->stop = true;
+    pthread_cond_signal(&tap->cond);
+    MUTEX_UNLOCK(&tap->lock);
+
+    pthread_join(tap->thread, NULL);
+
+    tap_file_close(tap);
+    tap_write_meta(tap);
+
+    if (tap->dropped + tap->refused > 0) {
+        log_info("Capture tap %s dropped %" PRIu64 " of %" PRIu64
+                 " buffers\n", tap->data_path, tap->dropped + tap->refused,
+                 tap->written + tap->dropped + tap->refused);
+    }
+
+    pthread_cond_destroy(&tap->cond);
+    MUTEX_DESTROY(&tap->lock);
+    tap_free(tap);
+}
+
+void sync_tap_push(struct sync_tap *tap,
+                   unsigned int idx,
+                   uint64_t position,
+                   size_t num_samples)
+{
+    const unsigned int head = ATOMIC_LOAD(&tap->head);
+    struct tap_entry *e;
+
+    if (head - ATOMIC_LOAD(&tap->tail) >= tap->depth ||
+        !ATOMIC_CAS(&tap->claim[idx], TAP_SLOT_FREE, TAP_SLOT_QUEUED)) {
+        tap->refused++;
+        return;
+    }
+
+    e              = &tap->queue[head % tap->depth];
+    e->idx         = idx;
+    e->position    = position;
+    e->num_samples = num_samples;
+
+    ATOMIC_STORE(&tap->head, head + 1);
+
+    if (ATOMIC_LOAD(&tap->waiting)) {
+        MUTEX_LOCK(&tap->lock);
+        pthread_cond_signal(&tap->cond);
+        MUTEX_UNLOCK(&tap->lock);
+    }
+}
+
+void sync_tap_reclaim(struct sync_tap *tap, unsigned int idx)
+{
+    /* The writer may move a queued claim to COPYING between these, but
+     * nothing else may make it QUEUED again */
+    if (!ATOMIC_CAS(&tap->claim[idx], TAP_SLOT_QUEUED, TAP_SLOT_REVOKED)) {
+        ATOMIC_CAS(&tap->claim[idx], TAP_SLOT_COPYING, TAP_SLOT_REVOKED);
+    }
+}
+
+void sync_tap_get_stats(struct sync_tap *tap,
+                        uint64_t *written,
+                        uint64_t *dropped)
+{
+    MUTEX_LOCK(&tap->lock);
+    *written = tap->written;
+    *dropped = tap->dropped;
+    MUTEX_UNLOCK(&tap->lock);
+
+    *dropped += tap->refused;
+}
@@ -0,0 +1,119 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Capture tap of a synchronous RX stream, which records the buffers the
+ * stream receives to a SigMF recording from a thread of its own. See
+ * bladerf_set_sync_rx_tap().
+ *
+ * The worker callback queues each full buffer by its index, without copying
+ * it, and the tap holds a claim on that buffer until the writer has copied it
+ * out. The worker never waits on the tap: when it needs to resubmit a buffer
+ * the tap still claims, it revokes the claim, and the tap drops the buffer. */
+
+#ifndef STREAMING_TAP_H_
+#define STREAMING_TAP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct sync_tap;
+
+/* Description of the stream to record */
+struct sync_tap_config {
+    const char *path;           /**< Recording path, see sync_tap_open() */
+    unsigned int depth;         /**< Max buffers queued, or 0 for all */
+
+    void **buffers;             /**< Stream buffers */
+    unsigned int num_buffers;
+    size_t buffer_bytes;        /**< Size of each buffer */
+
+    bool sc8;                   /**< SC8 Q7 rather than SC16 Q11 samples */
+    size_t bytes_per_sample;
+    size_t msg_size;            /**< Size of a metadata message, or 0 for a
+                                 *   format without metadata */
+    unsigned int num_channels;  /**< # of interleaved channels */
+
+    uint64_t sample_rate;       /**< Samples per second, per channel */
+    uint64_t frequency;         /**< Center frequency, in Hz */
+    const char *hw;             /**< Description of the device, or NULL */
+};
+
+/**
+ * Create a tap and start its writer thread.
+ *
+ * Samples are written to `<path>.sigmf-data`, and the SigMF metadata to
+ * `<path>.sigmf-meta` once the tap is closed. A `.sigmf-data` extension of
+ * `path` is replaced. Existing files are overwritten.
+ *
+ * @param[out]  tap         Created tap
+ * @param[in]   config      Stream description
+ *
+ * @return 0 on success, BLADERF_ERR_MEM or BLADERF_ERR_IO on failure
+ */
+int sync_tap_open(struct sync_tap **tap, const struct sync_tap_config *config);
+
+/**
+ * Write out everything queued, stop the writer thread, write the metadata
+ * file and free the tap. The stream must not be running.
+ *
+ * @param[in]   tap         Tap to close. May be NULL.
+ */
+void sync_tap_close(struct sync_tap *tap);
+
+/**
+ * Queue a buffer the stream has just filled. This is only to be called by the
+ * worker callback. If the queue is full, or the tap still holds the buffer from
+ * the last time it was filled, the buffer is dropped.
+ *
+ * @param[in]   tap         Tap
+ * @param[in]   idx         Index of the buffer
+ * @param[in]   position    Per-channel sample position of the buffer within
+ *                          the stream, including dropped samples
+ * @param[in]   num_samples Number of samples in the buffer, over all channels
+ */
+void sync_tap_push(struct sync_tap *tap,
+                   unsigned int idx,
+                   uint64_t position,
+                   size_t num_samples);
+
+/**
+ * Revoke any claim of the tap on a buffer that the stream is about to
+ * resubmit. This is only to be called by the worker callback, or while the
+ * stream is not running. It does not wait on the writer.
+ *
+ * @param[in]   tap         Tap
+ * @param[in]   idx         Index of the buffer
+ */
+void sync_tap_reclaim(struct sync_tap *tap, unsigned int idx);
+
+/**
+ * Get the number of buffers written and dropped so far
+ *
+ * @param[in]   tap         Tap
+ * @param[out]  written     Buffers written
+ * @param[out]  dropped     Buffers dropped
+ */
+void sync_tap_get_stats(struct sync_tap *tap,
+                        uint64_t *written,
+                        uint64_t *dropped);
+
+#endif
@@ -0,0 +1,248 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libbladeRF.h>
+
+#include "log.h"
+
+#define SWEEP_CHANNEL           BLADERF_CHANNEL_RX(0)
+
+#define SWEEP_BUFFERS           32
+#define SWEEP_BUFFER_SIZE       16384
+#define SWEEP_TRANSFERS         16
+#define SWEEP_TIMEOUT_MS        1000
+
+/* Time between reading the current timestamp and the first step, which
+ * gives the hop thread time to fill the Nios retune queue */
+#define SWEEP_START_LEAD_MS     50
+
+/* Number of steps queued in the hop schedule ahead of the one being
+ * received. This must not exceed the hop schedule's capacity. */
+#define SWEEP_QUEUE_AHEAD       512
+
+struct sweep {
+    struct bladerf *dev;
+    const struct bladerf_sweep_config *config;
+
+    uint64_t num_steps;     /* Total # of steps, or UINT64_MAX if unbounded */
+    uint64_t queued;        /* # of steps handed to the hop schedule */
+    unsigned int indices[SWEEP_QUEUE_AHEAD];
+};
+
+/* Queue up to `max` more steps in the hop schedule */
+static int sweep_enqueue(struct sweep *s, unsigned int max)
+{
+    const unsigned int n = s->config->num_frequencies;
+    unsigned int count = 0;
+    int status;
+
+    while (count < max && s->queued + count < s->num_steps) {
+        s->indices[count] = (unsigned int)((s->queued + count) % n);
+        count++;
+    }
+
+    if (count == 0) {
+        return 0;
+    }
+
+    status = bladerf_enqueue_hops(s->dev, SWEEP_CHANNEL, s->indices, count);
+    if (status == 0) {
+        s->queued += count;
+    }
+
+    return status;
+}
+
+/* Receive and deliver each step. Returns once all have been delivered, the
+ * callback ends the sweep, or RX fails. */
+static int sweep_run(struct sweep *s,
+                     int16_t *buf,
+                     bladerf_timestamp start,
+                     unsigned int settled)
+{
+    const struct bladerf_sweep_config *cfg = s->config;
+    const unsigned int timeout_ms =
+        (cfg->timeout_ms == 0) ? SWEEP_TIMEOUT_MS : cfg->timeout_ms;
+    struct bladerf_sweep_block block;
+    struct bladerf_metadata meta;
+    uint64_t step;
+    int status;
+
+    for (step = 0; step < s->num_steps; step++) {
+        memset(&meta, 0, sizeof(meta));
+        meta.timestamp = start + step * cfg->dwell;
+
+        status = bladerf_sync_rx(s->dev, buf, cfg->dwell, &meta, timeout_ms);
+        if (status != 0) {
+            log_debug("%s: RX failed at step %" PRIu64 ": %s\n", __FUNCTION__,
+                      step, bladerf_strerror(status));
+            return status;
+        }
+
+        /* Stop if the hop thread failed to schedule a retune */
+        status = bladerf_get_hop_status(s->dev, SWEEP_CHANNEL, NULL, NULL);
+        if (status != 0) {
+            return status;
+        }
+
+        block.index       = (unsigned int)(step % cfg->num_frequencies);
+        block.pass        = step / cfg->num_frequencies;
+        block.frequency   = cfg->frequencies[block.index];
+        block.timestamp   = meta.timestamp;
+        block.samples     = buf;
+        block.num_samples = meta.actual_count;
+        block.settled     = settled;
+        block.status      = meta.status;
+
+        if (cfg->callback(s->dev, &block, cfg->user_data) != 0) {
+            return 0;
+        }
+
+        /* Keep the schedule topped up to SWEEP_QUEUE_AHEAD steps ahead */
+        status = sweep_enqueue(s, 1);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    return 0;
+}
+
+int bladerf_sweep(struct bladerf *dev,
+                  const struct bladerf_sweep_config *config)
+{
+    struct sweep *s = NULL;
+    bladerf_sample_rate rate;
+    bladerf_frequency orig_freq;
+    bladerf_timestamp now;
+    unsigned int settle_us;
+    uint64_t settled;
+    int16_t *buf = NULL;
+    int status;
+    int restore_status;
+
+    if (config == NULL || config->frequencies == NULL ||
+        config->num_frequencies == 0 || config->dwell == 0 ||
+        config->callback == NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    status = bladerf_get_sample_rate(dev, SWEEP_CHANNEL, &rate);
+    if (status != 0) {
+        return status;
+    }
+
+    /* Round the settling time up to a whole number of samples */
+    settle_us = (config->settle_us == 0) ? BLADERF_SWEEP_DEFAULT_SETTLE_US
+                                         : config->settle_us;
+    settled   = ((uint64_t)settle_us * rate + 999999) / 1000000;
+
+    if (settled >= config->dwell) {
+        log_debug("%s: Settling time of %u us is not shorter than the "
+                  "dwell\n", __FUNCTION__, settle_us);
+        return BLADERF_ERR_INVAL;
+    }
+
+    s   = calloc(1, sizeof(*s));
+    buf = malloc(2 * sizeof(buf[0]) * config->dwell);
+    if (s == NULL || buf == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto out;
+    }
+
+    s->dev    = dev;
+    s->config = config;
+
+    if (config->num_passes == 0 ||
+        config->num_passes > UINT64_MAX / config->num_frequencies) {
+        s->num_steps = UINT64_MAX;
+    } else {
+        s->num_steps = config->num_passes * config->num_frequencies;
+    }
+
+    status = bladerf_get_frequency(dev, SWEEP_CHANNEL, &orig_freq);
+    if (status != 0) {
+        goto out;
+    }
+
+    /* The quick tune parameters of each frequency are gathered up front,
+     * so that each step costs only the retune itself */
+    status = bladerf_load_hop_table(dev, SWEEP_CHANNEL, config->frequencies,
+                                    config->num_frequencies);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = bladerf_sync_config(dev, BLADERF_RX_X1,
+                                 BLADERF_FORMAT_SC16_Q11_META, SWEEP_BUFFERS,
+                                 SWEEP_BUFFER_SIZE, SWEEP_TRANSFERS,
+                                 SWEEP_TIMEOUT_MS);
+    if (status != 0) {
+        goto out_hop_table;
+    }
+
+    status = bladerf_enable_module(dev, SWEEP_CHANNEL, true);
+    if (status != 0) {
+        goto out_hop_table;
+    }
+
+    status = bladerf_get_timestamp(dev, BLADERF_RX, &now);
+    if (status != 0) {
+        goto out_module;
+    }
+
+    now += (uint64_t)rate * SWEEP_START_LEAD_MS / 1000;
+
+    status = sweep_enqueue(s, SWEEP_QUEUE_AHEAD);
+    if (status == 0) {
+        status = bladerf_start_hopping(dev, SWEEP_CHANNEL, now, config->dwell);
+    }
+
+    if (status == 0) {
+        status = sweep_run(s, buf, now, (unsigned int)settled);
+    }
+
+out_module:
+    restore_status = bladerf_enable_module(dev, SWEEP_CHANNEL, false);
+    if (status == 0) {
+        status = restore_status;
+    }
+
+out_hop_table:
+    /* This also cancels the retunes that were scheduled ahead */
+    bladerf_free_hop_table(dev, SWEEP_CHANNEL);
+
+    restore_status = bladerf_set_frequency(dev, SWEEP_CHANNEL, orig_freq);
+    if (status == 0) {
+        status = restore_status;
+    }
+
+out:
+    free(buf);
+    free(s);
+    return status;
+}
@@ -0,0 +1,187 @@
+% bladeRF background RX capture
+%
+% This object receives samples on a C-side thread into a ring, from which
+% receive() returns complex single samples with no per-call marshalling. Use
+% this in place of bladeRF.receive() to sustain higher sample rates.
+%
+% It requires the bladeRF_stream library and bladeRF_stream_mex MEX function,
+% which are built from the stream/ directory with CMake:
+%
+%   cmake -S stream -B stream/build && cmake --build stream/build
+%
+% The build directory, containing these and bladeRF_stream.h, must then be
+% on the MATLAB path.
+%
+% Example usage:
+%
+%   b = bladeRF();
+%   b.rx.samplerate = 30e6;
+%   b.rx.start();
+%
+%   s = bladeRF_Stream(b);
+%   s.start();
+%   [samples, timestamp, overrun] = s.receive(1e6);
+%   s.stop();
+%
+%   b.rx.stop();
+%
+% See also: bladeRF, bladeRF_XCVR
+
+%
+% Copyright (c) 2026 Nuand LLC
+%
+% Permission is hereby granted, free of charge, to any person obtaining a copy
+% of this software and associated documentation files (the "Software"), to deal
+% in the Software without restriction, including without limitation the rights
+% to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+% copies of the Software, and to permit persons to whom the Software is
+% furnished to do so, subject to the following conditions:
+%
+% The above copyright notice and this permission notice shall be included in
+% all copies or substantial portions of the Software.
+%
+% THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+% IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+% FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+% AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+% LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+% OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+% THE SOFTWARE.
+%
+
+classdef bladeRF_Stream < handle
+    properties(SetAccess = private)
+        bladerf             % Associated bladeRF object
+        running             % Denotes whether the capture thread is active
+    end
+
+    properties
+        chunk_samples       % Samples received per libbladeRF call. Default = rx.config.buffer_size
+        num_chunks          % Number of chunks in the ring. Default = 64
+        timeout_ms          % Timeout of the capture thread's receive calls. Default = rx.config.timeout_ms
+    end
+
+    properties(Dependent = true)
+        available           % Number of samples waiting in the ring
+        overruns            % Number of chunks dropped due to a full ring
+    end
+
+    methods
+        function obj = bladeRF_Stream(dev)
+        % Create a capture object for the specified bladeRF device
+        %
+        %   s = bladeRF_Stream(b);
+        %
+            obj.bladerf       = dev;
+            obj.running       = false;
+            obj.chunk_samples = dev.rx.config.buffer_size;
+            obj.num_chunks    = 64;
+            obj.timeout_ms    = dev.rx.config.timeout_ms;
+
+            if libisloaded('bladeRF_stream') == false
+                loadlibrary('bladeRF_stream', 'bladeRF_stream.h');
+            end
+        end
+
+        function delete(obj)
+            obj.stop();
+        end
+
+        function start(obj)
+        % Start the capture thread. The RX module is started via
+        % bladeRF.rx.start() if it is not already running.
+        %
+        %   s.start();
+        %
+            if obj.running
+                return;
+            end
+
+            if obj.bladerf.rx.running == false
+                obj.bladerf.rx.start();
+            end
+
+            status = calllib('bladeRF_stream', 'bladeRF_stream_start', ...
+                             obj.bladerf.device, ...
+                             obj.num_chunks, ...
+                             obj.chunk_samples, ...
+                             obj.timeout_ms);
+
+            bladeRF.check_status('bladeRF_stream_start', status);
+            obj.running = true;
+        end
+
+        function stop(obj)
+        % Stop the capture thread and discard any samples left in the ring.
+        % The RX module is left running.
+        %
+        %   s.stop();
+        %
+            if isempty(obj.running) || obj.running == false
+                return;
+            end
+
+            obj.running = false;
+            status = calllib('bladeRF_stream', 'bladeRF_stream_stop');
+            bladeRF.check_status('bladeRF_stream_stop', status);
+        end
+
+        function [samples, timestamp, overrun] = receive(obj, num_samples, timeout_ms)
+        % Take samples from the ring.
+        %
+        %  [samples, timestamp, overrun] = s.receive(num_samples, timeout_ms)
+        %
+        % Inputs:
+        %   num_samples     Number of samples to receive. This may not exceed
+        %                   num_chunks * chunk_samples.
+        %
+        %   timeout_ms      Time to wait for the samples, in ms. 0 implies no
+        %                   timeout. Default = 2 * timeout_ms
+        %
+        % Outputs:
+        %   samples         Column of complex single samples, with real and
+        %                   imaginary component amplitudes within [-1.0, 1.0).
+        %
+        %   timestamp       Timestamp of the first sample in `samples`.
+        %
+        %   overrun         Set to `true` if samples were dropped before or
+        %                   within `samples`, and `false` otherwise.
+        %
+            if nargin < 3
+                timeout_ms = 2 * obj.timeout_ms;
+            end
+
+            if obj.running == false
+                error('bladeRF_Stream: start() has not been called');
+            end
+
+            [samples, timestamp, overrun] = bladeRF_stream_mex(num_samples, timeout_ms);
+        end
+
+        function val = get.available(obj)
+            val = bladeRF_Stream.query_status(obj, 1);
+        end
+
+        function val = get.overruns(obj)
+            val = bladeRF_Stream.query_status(obj, 2);
+        end
+    end
+
+    methods(Static, Access = private)
+        function val = query_status(obj, which)
+            val = 0;
+            if obj.running
+                [status, avail, overruns] = calllib('bladeRF_stream', ...
+                                                    'bladeRF_stream_status', ...
+                                                    0, 0);
+                bladeRF.check_status('bladeRF_stream_status', status);
+
+                if which == 1
+                    val = avail;
+                else
+                    val = overruns;
+                end
+            end
+        end
+    end
+end
@@ -0,0 +1,345 @@
+/*
+ * Background RX capture for the bladeRF MATLAB bindings
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <libbladeRF.h>
+
+#include "bladeRF_stream.h"
+
+/* The ring is divided into chunks, each filled by one bladerf_sync_rx()
+ * call. Only the capture thread writes to the chunk at the tail, and only the
+ * reader reads from those between head and tail, so the samples themselves
+ * are accessed without holding the lock. */
+struct capture {
+    pthread_mutex_t lock;
+    pthread_cond_t filled;
+    pthread_t thread;
+
+    struct bladerf *dev;
+    unsigned int timeout_ms;
+    bool running;       /* Cleared to stop the capture thread */
+    int status;         /* Error that stopped the capture thread */
+
+    float *samples;     /* num_chunks * chunk_samples interleaved pairs */
+    uint64_t *timestamps;
+    bool *discont;      /* Samples were dropped before this chunk */
+    int16_t *raw;       /* Received SC16 Q11 samples of one chunk */
+
+    unsigned int num_chunks;
+    unsigned int chunk_samples;
+
+    unsigned int head;  /* Chunk being read */
+    unsigned int count; /* Number of filled chunks */
+    unsigned int off;   /* Samples already read from the head chunk */
+
+    uint64_t overruns;
+};
+
+static struct capture *active = NULL;
+
+static void *capture_thread(void *arg)
+{
+    struct capture *c = arg;
+    struct bladerf_metadata meta;
+    uint64_t expected = 0;
+    bool have_expected = false;
+    bool dropped = false;
+    unsigned int tail;
+    unsigned int i;
+    int status = 0;
+
+    while (true) {
+        memset(&meta, 0, sizeof(meta));
+        meta.flags = BLADERF_META_FLAG_RX_NOW;
+
+        status = bladerf_sync_rx(c->dev, c->raw, c->chunk_samples, &meta,
+                                 c->timeout_ms);
+
+        pthread_mutex_lock(&c->lock);
+
+        if (status != 0 || !c->running) {
+            break;
+        }
+
+        /* For the metadata formats, dropped samples show up as a jump in
+         * the timestamps */
+        if ((meta.status & BLADERF_META_STATUS_OVERRUN) ||
+            (have_expected && meta.timestamp != expected)) {
+            dropped = true;
+        }
+
+        expected      = meta.timestamp + c->chunk_samples;
+        have_expected = true;
+
+        if (c->count == c->num_chunks) {
+            c->overruns++;
+            dropped = true;
+            pthread_mutex_unlock(&c->lock);
+            continue;
+        }
+
+        tail = (c->head + c->count) % c->num_chunks;
+        pthread_mutex_unlock(&c->lock);
+
+        {
+            float *dst = &c->samples[2 * (size_t)tail * c->chunk_samples];
+
+            for (i = 0; i < 2 * c->chunk_samples; i++) {
+                dst[i] = c->raw[i] * (1.0f / 2048.0f);
+            }
+        }
+
+        c->timestamps[tail] = meta.timestamp;
+        c->discont[tail]    = dropped;
+        dropped             = false;
+
+        pthread_mutex_lock(&c->lock);
+        c->count++;
+        pthread_cond_signal(&c->filled);
+        pthread_mutex_unlock(&c->lock);
+    }
+
+    c->running = false;
+    c->status  = status;
+    pthread_cond_signal(&c->filled);
+    pthread_mutex_unlock(&c->lock);
+
+    return NULL;
+}
+
+static void capture_free(struct capture *c)
+{
+    free(c->samples);
+    free(c->timestamps);
+    free(c->discont);
+    free(c->raw);
+    free(c);
+}
+
+int bladeRF_stream_start(struct bladerf *dev,
+                         unsigned int num_chunks,
+                         unsigned int chunk_samples,
+                         unsigned int timeout_ms)
+{
+    struct capture *c;
+    int status;
+
+    if (active != NULL) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (dev == NULL || num_chunks == 0 || chunk_samples == 0) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    c = calloc(1, sizeof(*c));
+    if (c == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    c->dev           = dev;
+    c->timeout_ms    = timeout_ms;
+    c->num_chunks    = num_chunks;
+    c->chunk_samples = chunk_samples;
+    c->running       = true;
+
+    c->samples =
+        malloc(2 * sizeof(float) * (size_t)num_chunks * chunk_samples);
+    c->timestamps = calloc(num_chunks, sizeof(uint64_t));
+    c->discont    = calloc(num_chunks, sizeof(bool));
+    c->raw        = malloc(2 * sizeof(int16_t) * (size_t)chunk_samples);
+
+    if (c->samples == NULL || c->timestamps == NULL || c->discont == NULL ||
+        c->raw == NULL) {
+        capture_free(c);
+        return BLADERF_ERR_MEM;
+    }
+
+    pthread_mutex_init(&c->lock, NULL);
+    pthread_cond_init(&c->filled, NULL);
+
+    status = pthread_create(&c->thread, NULL, capture_thread, c);
+    if (status != 0) {
+        pthread_mutex_destroy(&c->lock);
+        pthread_cond_destroy(&c->filled);
+        capture_free(c);
+        return BLADERF_ERR_UNEXPECTED;
+    }
+
+    active = c;
+    return 0;
+}
+
+int bladeRF_stream_stop(void)
+{
+    struct capture *c = active;
+    int status;
+
+    if (c == NULL) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&c->lock);
+    c->running = false;
+    pthread_mutex_unlock(&c->lock);
+
+    /* This returns within the stream timeout */
+    pthread_join(c->thread, NULL);
+
+    status = c->status;
+    active = NULL;
+
+    pthread_mutex_destroy(&c->lock);
+    pthread_cond_destroy(&c->filled);
+    capture_free(c);
+
+    return status;
+}
+
+static unsigned long long available_samples(const struct capture *c)
+{
+    return (unsigned long long)c->count * c->chunk_samples - c->off;
+}
+
+int bladeRF_stream_read(float *samples,
+                        unsigned int num_samples,
+                        unsigned int timeout_ms,
+                        unsigned long long *timestamp,
+                        int *overrun)
+{
+    struct capture *c = active;
+    struct timespec deadline;
+    unsigned int done = 0;
+    int status        = 0;
+    bool dropped      = false;
+
+    if (c == NULL) {
+        return BLADERF_ERR_NOT_INIT;
+    }
+
+    if (num_samples > (unsigned long long)c->num_chunks * c->chunk_samples) {
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (timeout_ms != 0) {
+        timespec_get(&deadline, TIME_UTC);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+    }
+
+    pthread_mutex_lock(&c->lock);
+
+    while (available_samples(c) < num_samples && status == 0) {
+        if (!c->running) {
+            status = c->status != 0 ? c->status : BLADERF_ERR_UNEXPECTED;
+        } else if (timeout_ms == 0) {
+            pthread_cond_wait(&c->filled, &c->lock);
+        } else if (pthread_cond_timedwait(&c->filled, &c->lock, &deadline)) {
+            if (available_samples(c) < num_samples) {
+                status = BLADERF_ERR_TIMEOUT;
+            }
+        }
+    }
+
+    if (status != 0) {
+        pthread_mutex_unlock(&c->lock);
+        return status;
+    }
+
+    if (timestamp != NULL) {
+        *timestamp = c->timestamps[c->head] + c->off;
+    }
+
+    pthread_mutex_unlock(&c->lock);
+
+    /* The filled chunks are not touched by the capture thread, so they are
+     * copied out without holding the lock */
+    while (done < num_samples) {
+        const unsigned int n = c->chunk_samples - c->off < num_samples - done
+                                   ? c->chunk_samples - c->off
+                                   : num_samples - done;
+
+        if (c->off == 0 && c->discont[c->head]) {
+            dropped = true;
+        }
+
+        if (samples != NULL) {
+            memcpy(&samples[2 * (size_t)done],
+                   &c->samples[2 * ((size_t)c->head * c->chunk_samples +
+                                    c->off)],
+                   2 * sizeof(float) * n);
+        }
+
+        done += n;
+
+        pthread_mutex_lock(&c->lock);
+        c->off += n;
+        if (c->off == c->chunk_samples) {
+            c->head = (c->head + 1) % c->num_chunks;
+            c->count--;
+            c->off = 0;
+        }
+        pthread_mutex_unlock(&c->lock);
+    }
+
+    if (overrun != NULL) {
+        *overrun = dropped;
+    }
+
+    return 0;
+}
+
+int bladeRF_stream_status(unsigned long long *available,
+                          unsigned long long *overruns)
+{
+    struct capture *c = active;
+
+    if (c == NULL) {
+        return BLADERF_ERR_NOT_INIT;
+    }
+
+    pthread_mutex_lock(&c->lock);
+
+    if (available != NULL) {
+        *available = available_samples(c);
+    }
+
+    if (overruns != NULL) {
+        *overruns = c->overruns;
+    }
+
+    pthread_mutex_unlock(&c->lock);
+
+    return 0;
+}
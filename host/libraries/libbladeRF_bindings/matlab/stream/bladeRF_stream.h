@@ -0,0 +1,107 @@
+/*
+ * Background RX capture for the bladeRF MATLAB bindings
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BLADERF_STREAM_H_
+#define BLADERF_STREAM_H_
+
+/* This header is parsed by MATLAB's loadlibrary(), so it is kept free of
+ * other includes. A capture is started and stopped via calllib(), such that
+ * the device handle of a bladeRF object may be passed in, while samples are
+ * retrieved through the bladeRF_stream_mex MEX function. */
+
+#ifdef _WIN32
+#   ifdef BLADERF_STREAM_EXPORTS
+#       define BLADERF_STREAM_API __declspec(dllexport)
+#   else
+#       define BLADERF_STREAM_API __declspec(dllimport)
+#   endif
+#else
+#   define BLADERF_STREAM_API __attribute__((visibility("default")))
+#endif
+
+struct bladerf;
+
+/**
+ * Start a background thread that receives samples into a ring of
+ * `num_chunks` chunks of `chunk_samples` samples, as complex single values
+ * scaled to [-1.0, 1.0).
+ *
+ * The RX stream must have been configured for the SC16 Q11 metadata format
+ * and enabled, as done by bladeRF.rx.start(). Only one capture may be active
+ * at a time.
+ *
+ * When the ring is full, received chunks are discarded and the next chunk
+ * that is kept is marked as following a discontinuity.
+ *
+ * @return 0 on success, or a libbladeRF error code
+ */
+BLADERF_STREAM_API
+int bladeRF_stream_start(struct bladerf *dev,
+                         unsigned int num_chunks,
+                         unsigned int chunk_samples,
+                         unsigned int timeout_ms);
+
+/**
+ * Stop the capture thread and free the ring
+ *
+ * @return The error that stopped the capture thread, if any, otherwise 0
+ */
+BLADERF_STREAM_API
+int bladeRF_stream_stop(void);
+
+/**
+ * Take `num_samples` samples from the ring, waiting up to `timeout_ms`
+ * milliseconds (0 waits forever) for them to become available.
+ *
+ * @param[out]  samples     Interleaved (I, Q) values. May be NULL to
+ *                          discard samples.
+ * @param[in]   num_samples Number of complex samples
+ * @param[in]   timeout_ms  Timeout, in milliseconds
+ * @param[out]  timestamp   Timestamp of the first sample
+ * @param[out]  overrun     Set nonzero if samples were dropped within
+ *                          the returned samples, or preceding them
+ *
+ * @return 0 on success, BLADERF_ERR_TIMEOUT (-6) if the samples did not
+ *         become available in time, or the error that stopped the capture
+ */
+BLADERF_STREAM_API
+int bladeRF_stream_read(float *samples,
+                        unsigned int num_samples,
+                        unsigned int timeout_ms,
+                        unsigned long long *timestamp,
+                        int *overrun);
+
+/**
+ * Query the capture's progress
+ *
+ * @param[out]  available   Number of samples waiting in the ring
+ * @param[out]  overruns    Number of chunks dropped since the capture began
+ *
+ * @return 0 on success, or BLADERF_ERR_NOT_INIT (-19) if no capture is active
+ */
+BLADERF_STREAM_API
+int bladeRF_stream_status(unsigned long long *available,
+                          unsigned long long *overruns);
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * MEX interface to the bladeRF MATLAB bindings' background RX capture
+ *
+ *   [samples, timestamp, overrun] = bladeRF_stream_mex(num_samples, timeout_ms)
+ *
+ * Returns num_samples complex single samples from the capture started via
+ * bladeRF_stream_start(). These are copied from the capture ring directly
+ * into the returned array.
+ *
+ * Copyright (c) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+
+#include "mex.h"
+
+#include "bladeRF_stream.h"
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    unsigned long long timestamp = 0;
+    unsigned int num_samples;
+    unsigned int timeout_ms = 0;
+    int overrun             = 0;
+    float *samples;
+    int status;
+
+    if (nrhs < 1 || nrhs > 2 || nlhs > 3) {
+        mexErrMsgIdAndTxt("bladeRF:stream:nargs",
+                          "Usage: [samples, timestamp, overrun] = "
+                          "bladeRF_stream_mex(num_samples, timeout_ms)");
+    }
+
+    num_samples = (unsigned int)mxGetScalar(prhs[0]);
+    if (nrhs > 1) {
+        timeout_ms = (unsigned int)mxGetScalar(prhs[1]);
+    }
+
+    plhs[0] = mxCreateNumericMatrix(num_samples, 1, mxSINGLE_CLASS, mxCOMPLEX);
+
+#if MX_HAS_INTERLEAVED_COMPLEX
+    /* With the R2018a API, the (I, Q) pairs go straight into the array */
+    samples = (float *)mxGetComplexSingles(plhs[0]);
+#else
+    samples = mxMalloc(2 * sizeof(float) * (size_t)num_samples);
+#endif
+
+    status = bladeRF_stream_read(samples, num_samples, timeout_ms, &timestamp,
+                                 &overrun);
+
+#if !MX_HAS_INTERLEAVED_COMPLEX
+    if (status == 0) {
+        float *re = (float *)mxGetData(plhs[0]);
+        float *im = (float *)mxGetImagData(plhs[0]);
+        unsigned int i;
+
+        for (i = 0; i < num_samples; i++) {
+            re[i] = samples[2 * i];
+            im[i] = samples[2 * i + 1];
+        }
+    }
+
+    mxFree(samples);
+#endif
+
+    if (status != 0) {
+        mexErrMsgIdAndTxt("bladeRF:stream:read",
+                          "libbladeRF error (%d) in bladeRF_stream_read()",
+                          status);
+    }
+
+    if (nlhs > 1) {
+        plhs[1] = mxCreateNumericMatrix(1, 1, mxUINT64_CLASS, mxREAL);
+        *(unsigned long long *)mxGetData(plhs[1]) = timestamp;
+    }
+
+    if (nlhs > 2) {
+        plhs[2] = mxCreateLogicalScalar(overrun != 0);
+    }
+}
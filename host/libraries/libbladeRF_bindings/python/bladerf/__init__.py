@@ -47,9 +47,10 @@ RX = _bladerf.RX
 TX = _bladerf.TX
 CHANNEL_RX = _bladerf.CHANNEL_RX
 CHANNEL_TX = _bladerf.CHANNEL_TX
+Setting = _bladerf.Setting
 
 main = _tool.main
 
 __all__ = ['BladeRF', 'get_bootloader_list', 'get_device_list',
            'load_fw_from_bootloader', 'set_verbosity', 'version', 'RX', 'TX',
-           'CHANNEL_RX', 'CHANNEL_TX', 'main']
+           'CHANNEL_RX', 'CHANNEL_TX', 'Setting', 'main']
@@ -28,16 +28,25 @@ from sys import platform
 
 from ._cdef import header
 
-ffi = cffi.FFI()
+# Prefer the compiled API-mode module built by _build.py, which calls
+# libbladeRF directly instead of through libffi, and provides the batched
+# helpers. CFFI releases the GIL around every call in either mode.
+try:
+    from ._libbladeRF import ffi, lib as libbladeRF
+    _have_helpers = True
+except ImportError:
+    _have_helpers = False
 
-ffi.cdef(header)
+    ffi = cffi.FFI()
 
-if platform == "win32":
-      libbladeRF = ffi.dlopen("bladerf.dll")
-elif platform == "darwin":
-    libbladeRF = ffi.dlopen("libbladeRF.dylib")
-else:
-    libbladeRF = ffi.dlopen("libbladeRF.so")
+    ffi.cdef(header)
+
+    if platform == "win32":
+          libbladeRF = ffi.dlopen("bladerf.dll")
+    elif platform == "darwin":
+        libbladeRF = ffi.dlopen("libbladeRF.dylib")
+    else:
+        libbladeRF = ffi.dlopen("libbladeRF.so")
 
 
 ###############################################################################
@@ -101,6 +110,7 @@ class Backend(enum.Enum):
     LibUSB = libbladeRF.BLADERF_BACKEND_LIBUSB
     Cypress = libbladeRF.BLADERF_BACKEND_CYPRESS
     Dummy = libbladeRF.BLADERF_BACKEND_DUMMY
+    Net = libbladeRF.BLADERF_BACKEND_NET
 
     def __str__(self):
         return ffi.string(libbladeRF.bladerf_backend_str(self.value)).decode()
@@ -169,6 +179,23 @@ class DeviceSpeed(enum.Enum):
     Super = libbladeRF.BLADERF_DEVICE_SPEED_SUPER
 
 
+class Setting(enum.Enum):
+    """Parameters that BladeRF.apply_settings() can set. These must match
+    the PYBLADERF_SET_* values in _build.py."""
+    Frequency = 0
+    SampleRate = 1
+    Bandwidth = 2
+    Gain = 3
+    GainMode = 4
+    Enable = 5
+
+    def __str__(self):
+        return self.name
+
+    def __int__(self):
+        return self.value
+
+
 class GainMode(enum.Enum):
     Default = libbladeRF.BLADERF_GAIN_DEFAULT
     Manual = libbladeRF.BLADERF_GAIN_MGC
@@ -208,6 +235,14 @@ class Format(enum.Enum):
     PACKET_META = libbladeRF.BLADERF_FORMAT_PACKET_META
     SC8_Q7 = libbladeRF.BLADERF_FORMAT_SC8_Q7
     SC8_Q7_META = libbladeRF.BLADERF_FORMAT_SC8_Q7_META
+    CF32 = libbladeRF.BLADERF_FORMAT_CF32
+    CF32_META = libbladeRF.BLADERF_FORMAT_CF32_META
+    SC12_PACKED = libbladeRF.BLADERF_FORMAT_SC12_PACKED
+    SC12_PACKED_META = libbladeRF.BLADERF_FORMAT_SC12_PACKED_META
+    SC8_Q7_AS_SC16_Q11 = libbladeRF.BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11
+    SC8_Q7_AS_SC16_Q11_META = libbladeRF.BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META
+    SC8_Q7_AS_CF32 = libbladeRF.BLADERF_FORMAT_SC8_Q7_AS_CF32
+    SC8_Q7_AS_CF32_META = libbladeRF.BLADERF_FORMAT_SC8_Q7_AS_CF32_META
 
 
 class Loopback(enum.Enum):
@@ -746,6 +781,153 @@ class BladeRF:
         _check_error(ret)
         return Range.from_struct(_range_ptr[0])
 
+    # Batched configuration
+
+    def apply_settings(self, settings):
+        """Applies a sequence of (Setting, ch, value) tuples in order, in a
+        single call into the compiled module when it is available. Returns
+        the value the device settled on for each, which may differ from the
+        requested value for sample rates and bandwidths.
+
+        Raises the error of the first setting that fails. The settings
+        before it remain applied.
+
+        Usage:
+        >>> d.apply_settings([
+        ...     (bladerf.Setting.Frequency, bladerf.CHANNEL_RX(0), 915e6),
+        ...     (bladerf.Setting.SampleRate, bladerf.CHANNEL_RX(0), 10e6),
+        ...     (bladerf.Setting.Gain, bladerf.CHANNEL_RX(0), 30),
+        ... ])
+        """
+        settings = [(Setting(kind), ch, int(value))
+                    for kind, ch, value in settings]
+
+        if not _have_helpers:
+            setters = {
+                Setting.Frequency: self.set_frequency,
+                Setting.SampleRate: self.set_sample_rate,
+                Setting.Bandwidth: self.set_bandwidth,
+                Setting.Gain: self.set_gain,
+                Setting.GainMode: self.set_gain_mode,
+                Setting.Enable: self.enable_module,
+            }
+            actual = []
+            for kind, ch, value in settings:
+                ret = setters[kind](ch, value)
+                actual.append(value if ret is None else ret)
+            return actual
+
+        arr = ffi.new("struct pybladerf_setting[]", len(settings))
+        for i, (kind, ch, value) in enumerate(settings):
+            arr[i].type = kind.value
+            arr[i].ch = ch
+            arr[i].value = value
+        applied = ffi.new("size_t *")
+        ret = libbladeRF.pybladerf_apply_settings(self.dev[0], arr,
+                                                  len(settings), applied)
+        _check_error(ret)
+        return [arr[i].actual for i in range(len(settings))]
+
+    def get_quick_tune(self, ch):
+        quick_tune = ffi.new("struct bladerf_quick_tune *")
+        ret = libbladeRF.bladerf_get_quick_tune(self.dev[0], ch, quick_tune)
+        _check_error(ret)
+        return quick_tune
+
+    def schedule_retunes(self, ch, timestamps, frequencies, quick_tunes=None):
+        """Schedules a retune of channel ch to each frequency at the
+        corresponding timestamp, in a single call into the compiled module
+        when it is available. quick_tunes, if given, is a sequence of
+        "struct bladerf_quick_tune *" from get_quick_tune(), one per retune.
+
+        Raises the error of the first retune that fails, once the retunes
+        before it are scheduled.
+        """
+        timestamps = [int(t) for t in timestamps]
+        frequencies = [int(f) for f in frequencies]
+        if len(timestamps) != len(frequencies) or \
+                (quick_tunes is not None and
+                 len(quick_tunes) != len(timestamps)):
+            raise ValueError("Each retune needs a timestamp and frequency, "
+                             "and a quick tune if any are given")
+
+        if not _have_helpers:
+            for i in range(len(timestamps)):
+                qt = quick_tunes[i] if quick_tunes is not None else ffi.NULL
+                ret = libbladeRF.bladerf_schedule_retune(self.dev[0], ch,
+                                                         timestamps[i],
+                                                         frequencies[i], qt)
+                _check_error(ret)
+            return
+
+        qts = ffi.NULL
+        if quick_tunes is not None:
+            qts = ffi.new("struct bladerf_quick_tune[]", len(quick_tunes))
+            for i, qt in enumerate(quick_tunes):
+                qts[i] = qt[0]
+        scheduled = ffi.new("size_t *")
+        ret = libbladeRF.pybladerf_schedule_retunes(
+            self.dev[0], ch,
+            ffi.new("bladerf_timestamp[]", timestamps),
+            ffi.new("bladerf_frequency[]", frequencies),
+            qts, len(timestamps), scheduled)
+        _check_error(ret)
+
+    # Frequency hopping
+
+    def get_timestamp(self, direction):
+        """Returns the device's current sample timestamp for direction
+        bladerf.RX or bladerf.TX"""
+        timestamp = ffi.new("bladerf_timestamp *")
+        ret = libbladeRF.bladerf_get_timestamp(self.dev[0], int(direction),
+                                               timestamp)
+        _check_error(ret)
+        return timestamp[0]
+
+    def free_hop_table(self, ch):
+        ret = libbladeRF.bladerf_free_hop_table(self.dev[0], ch)
+        _check_error(ret)
+
+    def start_hopping(self, ch, start, dwell):
+        ret = libbladeRF.bladerf_start_hopping(self.dev[0], ch, int(start),
+                                               int(dwell))
+        _check_error(ret)
+
+    def get_hop_status(self, ch):
+        """Returns a (pending, next_timestamp) tuple"""
+        pending = ffi.new("unsigned int *")
+        next_ts = ffi.new("bladerf_timestamp *")
+        ret = libbladeRF.bladerf_get_hop_status(self.dev[0], ch, pending,
+                                                next_ts)
+        _check_error(ret)
+        return (pending[0], next_ts[0])
+
+    def load_hop_table(self, ch, frequencies):
+        """Builds channel ch's hop table from a NumPy array of frequencies.
+        See help(bladerf._hop.load_hop_table)."""
+        from . import _hop
+        _hop.load_hop_table(self, ch, frequencies)
+
+    def enqueue_hops(self, ch, indices):
+        """Appends a NumPy array of hop table indices to channel ch's hop
+        schedule. See help(bladerf._hop.enqueue_hops)."""
+        from . import _hop
+        _hop.enqueue_hops(self, ch, indices)
+
+    def get_quick_tunes(self, ch, frequencies):
+        """Returns a NumPy array of the quick tunes for each of a NumPy array
+        of frequencies. See help(bladerf._hop.get_quick_tunes)."""
+        from . import _hop
+        return _hop.get_quick_tunes(self, ch, frequencies)
+
+    def schedule_hops(self, ch, timestamps, frequencies, quick_tunes=None):
+        """Schedules a retune for each entry of NumPy arrays of timestamps
+        and frequencies, and returns an array of each entry's return code.
+        See help(bladerf._hop.schedule_hops)."""
+        from . import _hop
+        return _hop.schedule_hops(self, ch, timestamps, frequencies,
+                                  quick_tunes)
+
     # RF Ports
 
     def set_rf_port(self, ch, port):
@@ -826,6 +1008,54 @@ class BladeRF:
 
     rx_mux = property(get_rx_mux, set_rx_mux, doc="RX Multiplexer selection")
 
+    # RX FPGA decimation
+
+    def get_rx_decimation(self):
+        """Returns a (decimation, nco_offset) tuple"""
+        decimation = ffi.new("unsigned int *")
+        nco_offset = ffi.new("int32_t *")
+        ret = libbladeRF.bladerf_get_rx_decimation(self.dev[0], decimation,
+                                                   nco_offset)
+        _check_error(ret)
+        return (decimation[0], nco_offset[0])
+
+    def set_rx_decimation(self, decimation, nco_offset=0):
+        ret = libbladeRF.bladerf_set_rx_decimation(self.dev[0], decimation,
+                                                   nco_offset)
+        _check_error(ret)
+
+    # TX Waveform Playback
+
+    def tx_load_waveform(self, buf, num_samples):
+        ret = libbladeRF.bladerf_tx_load_waveform(
+            self.dev[0], ffi.cast("const int16_t *", ffi.from_buffer(buf)),
+            num_samples)
+        _check_error(ret)
+
+    def tx_loop_start(self, interpolation=1):
+        ret = libbladeRF.bladerf_tx_loop_start(self.dev[0], interpolation)
+        _check_error(ret)
+
+    def tx_loop_stop(self):
+        ret = libbladeRF.bladerf_tx_loop_stop(self.dev[0])
+        _check_error(ret)
+
+    # RX Power Measurement
+
+    def measure_rx_power(self, ch, num_samples):
+        """Returns a (power_sum, i_sum, q_sum, peak) tuple"""
+        power = ffi.new("struct bladerf_rx_power *")
+        ret = libbladeRF.bladerf_measure_rx_power(self.dev[0], ch,
+                                                  num_samples, power)
+        _check_error(ret)
+        return (power.power_sum, power.i_sum, power.q_sum, power.peak)
+
+    def rx_snapshot(self, ch, buf, num_samples):
+        ret = libbladeRF.bladerf_rx_snapshot(
+            self.dev[0], ch, ffi.cast("int16_t *", ffi.from_buffer(buf)),
+            num_samples)
+        _check_error(ret)
+
     # DC/Phase/Gain Correction
 
     def get_correction(self, ch, corr):
@@ -840,6 +1070,32 @@ class BladeRF:
                                                 value)
         _check_error(ret)
 
+    def enable_host_correction(self, ch, enable):
+        ret = libbladeRF.bladerf_enable_host_correction(self.dev[0], ch,
+                                                        bool(enable))
+        _check_error(ret)
+
+    def get_host_correction(self, ch):
+        enabled = ffi.new("bool *")
+        ret = libbladeRF.bladerf_get_host_correction(self.dev[0], ch, enabled)
+        _check_error(ret)
+        return bool(enabled[0])
+
+    def load_host_correction_table(self, ch, entries):
+        """Load a table of (frequency, dcoff_i, dcoff_q, phase, gain) tuples,
+        sorted by frequency, applied to the channel on retune."""
+        table = ffi.new("struct bladerf_correction_entry[]", len(entries))
+        for i, (freq, dcoff_i, dcoff_q, phase, gain) in enumerate(entries):
+            table[i].frequency = freq
+            table[i].dcoff_i = dcoff_i
+            table[i].dcoff_q = dcoff_q
+            table[i].phase = phase
+            table[i].gain = gain
+
+        ret = libbladeRF.bladerf_load_host_correction_table(
+            self.dev[0], ch, table, len(entries))
+        _check_error(ret)
+
     # Streaming format
 
     def interleave_stream_buffer(self, layout, format, buffer_size, samples):
@@ -877,6 +1133,50 @@ class BladeRF:
                                          timeout_ms or 0)
         _check_error(ret)
 
+    def sync_rx_array(self, num_samples, fmt="complex64",
+                      layout=ChannelLayout.RX_X1, out=None, timeout_ms=None):
+        """Receives num_samples samples per channel into a NumPy array,
+        which is allocated if out is None. The stream must be configured
+        via sync_config() with the matching format, given by
+        bladerf._stream.stream_format(fmt).
+
+        Returns the array, and whether samples were dropped before it.
+        """
+        from . import _stream
+
+        if out is None:
+            out = _stream.alloc_rx_array(num_samples, fmt, layout)
+
+        meta = ffi.new("struct bladerf_metadata *")
+        meta.flags = _stream.META_FLAG_RX_NOW
+
+        ret = libbladeRF.bladerf_sync_rx(self.dev[0], ffi.from_buffer(out),
+                                         out.size, meta, timeout_ms or 0)
+        _check_error(ret)
+
+        return out, bool(meta.status & _stream.META_STATUS_OVERRUN)
+
+    def rx_ring(self, num_samples, fmt="complex64",
+                layout=ChannelLayout.RX_X1, **kwargs):
+        """Configures synchronous RX and returns a bladerf._stream.RxRing
+        that receives into a pool of NumPy arrays on a background thread.
+
+        See help(bladerf._stream.RxRing) for more information.
+        """
+        from . import _stream
+        return _stream.RxRing(self, num_samples, fmt, layout, **kwargs)
+
+    def async_rx(self, fmt="complex_int16", layout=ChannelLayout.RX_X1,
+                 **kwargs):
+        """Configures synchronous RX in buffer pool mode and returns a
+        bladerf._stream.AsyncRx that lends out the stream's own buffers as
+        NumPy arrays.
+
+        See help(bladerf._stream.AsyncRx) for more information.
+        """
+        from . import _stream
+        return _stream.AsyncRx(self, fmt, layout, **kwargs)
+
     # FPGA/Firmware Loading/Flashing
 
     def load_fpga(self, image_path):
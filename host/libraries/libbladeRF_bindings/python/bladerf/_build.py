@@ -0,0 +1,245 @@
+# Copyright (c) 2026 Nuand LLC
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+__doc__ = """
+Builds bladerf._libbladeRF, an out-of-line API-mode CFFI module that is
+compiled against libbladeRF.h and linked against libbladeRF.
+
+setup.py builds it via cffi_modules. It may also be built in place with
+`python3 bladerf/_build.py`. The include and library directories may be
+given with the BLADERF_INCLUDE_DIR and BLADERF_LIB_DIR environment variables.
+
+bladerf._bladerf falls back to loading libbladeRF in ABI mode when this
+module has not been built.
+"""
+
+import os
+
+import cffi
+
+# Read the definitions without importing the bladerf package, which would
+# try to load libbladeRF
+_here = os.path.dirname(os.path.abspath(__file__))
+_defs = {}
+with open(os.path.join(_here, "_cdef.py")) as f:
+    exec(f.read(), _defs)
+
+# Batched helpers, which make many libbladeRF calls per FFI call. The setting
+# types must match bladerf._bladerf.Setting.
+helpers_cdef = """
+  struct pybladerf_setting
+  {
+    int type;
+    bladerf_channel ch;
+    int64_t value;
+    int64_t actual;
+  };
+  int pybladerf_apply_settings(struct bladerf *dev,
+    struct pybladerf_setting *settings, size_t count, size_t *applied);
+  int pybladerf_schedule_retunes(struct bladerf *dev, bladerf_channel ch,
+    const bladerf_timestamp *timestamps, const bladerf_frequency *frequencies,
+    struct bladerf_quick_tune *quick_tunes, size_t count, size_t *scheduled);
+  size_t pybladerf_schedule_hops(struct bladerf *dev, bladerf_channel ch,
+    const bladerf_timestamp *timestamps, const bladerf_frequency *frequencies,
+    const struct bladerf_quick_tune *quick_tunes, size_t count,
+    int *statuses);
+  int pybladerf_get_quick_tunes(struct bladerf *dev, bladerf_channel ch,
+    const bladerf_frequency *frequencies, size_t count,
+    struct bladerf_quick_tune *quick_tunes);
+"""
+
+helpers_source = r"""
+#include <libbladeRF.h>
+
+enum {
+    PYBLADERF_SET_FREQUENCY,
+    PYBLADERF_SET_SAMPLE_RATE,
+    PYBLADERF_SET_BANDWIDTH,
+    PYBLADERF_SET_GAIN,
+    PYBLADERF_SET_GAIN_MODE,
+    PYBLADERF_SET_ENABLE,
+};
+
+struct pybladerf_setting
+{
+    int type;
+    bladerf_channel ch;
+    int64_t value;
+    int64_t actual;
+};
+
+/* Apply settings in order, stopping at the first that fails. *applied is the
+ * number that succeeded. actual is the value the device settled on, where
+ * libbladeRF reports one, and the requested value otherwise. */
+static int pybladerf_apply_settings(struct bladerf *dev,
+                                    struct pybladerf_setting *settings,
+                                    size_t count, size_t *applied)
+{
+    size_t i;
+    int status = 0;
+
+    for (i = 0; i < count; i++) {
+        struct pybladerf_setting *s = &settings[i];
+        bladerf_sample_rate rate;
+        bladerf_bandwidth bw;
+
+        s->actual = s->value;
+
+        switch (s->type) {
+            case PYBLADERF_SET_FREQUENCY:
+                status = bladerf_set_frequency(dev, s->ch,
+                                               (bladerf_frequency) s->value);
+                break;
+
+            case PYBLADERF_SET_SAMPLE_RATE:
+                status = bladerf_set_sample_rate(dev, s->ch,
+                                                 (bladerf_sample_rate) s->value,
+                                                 &rate);
+                s->actual = rate;
+                break;
+
+            case PYBLADERF_SET_BANDWIDTH:
+                status = bladerf_set_bandwidth(dev, s->ch,
+                                               (bladerf_bandwidth) s->value,
+                                               &bw);
+                s->actual = bw;
+                break;
+
+            case PYBLADERF_SET_GAIN:
+                status = bladerf_set_gain(dev, s->ch, (bladerf_gain) s->value);
+                break;
+
+            case PYBLADERF_SET_GAIN_MODE:
+                status = bladerf_set_gain_mode(dev, s->ch,
+                                               (bladerf_gain_mode) s->value);
+                break;
+
+            case PYBLADERF_SET_ENABLE:
+                status = bladerf_enable_module(dev, s->ch, s->value != 0);
+                break;
+
+            default:
+                status = BLADERF_ERR_INVAL;
+                break;
+        }
+
+        if (status != 0) {
+            break;
+        }
+    }
+
+    *applied = i;
+    return status;
+}
+
+/* Schedule retunes in order, stopping at the first that fails. quick_tunes
+ * may be NULL to tune normally. *scheduled is the number that succeeded. */
+static int pybladerf_schedule_retunes(struct bladerf *dev, bladerf_channel ch,
+                                      const bladerf_timestamp *timestamps,
+                                      const bladerf_frequency *frequencies,
+                                      struct bladerf_quick_tune *quick_tunes,
+                                      size_t count, size_t *scheduled)
+{
+    size_t i;
+    int status = 0;
+
+    for (i = 0; i < count; i++) {
+        status = bladerf_schedule_retune(dev, ch, timestamps[i],
+                                         frequencies[i],
+                                         quick_tunes ? &quick_tunes[i] : NULL);
+        if (status != 0) {
+            break;
+        }
+    }
+
+    *scheduled = i;
+    return status;
+}
+
+/* As pybladerf_schedule_retunes(), but attempt every retune, recording each
+ * return code in statuses. Returns the number scheduled. */
+static size_t pybladerf_schedule_hops(struct bladerf *dev, bladerf_channel ch,
+                                      const bladerf_timestamp *timestamps,
+                                      const bladerf_frequency *frequencies,
+                                      const struct bladerf_quick_tune *quick_tunes,
+                                      size_t count, int *statuses)
+{
+    size_t i, scheduled = 0;
+    struct bladerf_quick_tune qt;
+
+    for (i = 0; i < count; i++) {
+        if (quick_tunes) {
+            qt = quick_tunes[i];
+        }
+        statuses[i] = bladerf_schedule_retune(dev, ch, timestamps[i],
+                                              frequencies[i],
+                                              quick_tunes ? &qt : NULL);
+        if (statuses[i] == 0) {
+            scheduled++;
+        }
+    }
+
+    return scheduled;
+}
+
+/* Tune to each frequency and record its quick tune, then return the channel
+ * to its original frequency */
+static int pybladerf_get_quick_tunes(struct bladerf *dev, bladerf_channel ch,
+                                     const bladerf_frequency *frequencies,
+                                     size_t count,
+                                     struct bladerf_quick_tune *quick_tunes)
+{
+    bladerf_frequency original;
+    size_t i;
+    int status, restore_status;
+
+    status = bladerf_get_frequency(dev, ch, &original);
+    if (status != 0) {
+        return status;
+    }
+
+    for (i = 0; i < count && status == 0; i++) {
+        status = bladerf_set_frequency(dev, ch, frequencies[i]);
+        if (status == 0) {
+            status = bladerf_get_quick_tune(dev, ch, &quick_tunes[i]);
+        }
+    }
+
+    restore_status = bladerf_set_frequency(dev, ch, original);
+    return (status != 0) ? status : restore_status;
+}
+"""
+
+
+def _env_dirs(name):
+    value = os.environ.get(name)
+    return value.split(os.pathsep) if value else []
+
+
+ffibuilder = cffi.FFI()
+ffibuilder.cdef(_defs["header"])
+ffibuilder.cdef(helpers_cdef)
+ffibuilder.set_source("bladerf._libbladeRF", helpers_source,
+                      libraries=["bladeRF"],
+                      include_dirs=_env_dirs("BLADERF_INCLUDE_DIR"),
+                      library_dirs=_env_dirs("BLADERF_LIB_DIR"))
+
+if __name__ == "__main__":
+    ffibuilder.compile(tmpdir=os.path.dirname(_here), verbose=True)
@@ -8,7 +8,8 @@ header = """
     BLADERF_BACKEND_LINUX,
     BLADERF_BACKEND_LIBUSB,
     BLADERF_BACKEND_CYPRESS,
-    BLADERF_BACKEND_DUMMY = 100
+    BLADERF_BACKEND_DUMMY = 100,
+    BLADERF_BACKEND_NET = 101
   } bladerf_backend;
   struct bladerf_devinfo
   {
@@ -19,6 +20,8 @@ header = """
     unsigned int instance;
     char manufacturer[33];
     char product[33];
+    char net_host[64];
+    uint16_t net_port;
   };
   struct bladerf_backendinfo
   {
@@ -33,7 +36,18 @@ header = """
   int bladerf_open_with_devinfo(struct bladerf **device, struct
     bladerf_devinfo *devinfo);
   int bladerf_get_device_list(struct bladerf_devinfo **devices);
+  int bladerf_get_device_list_quick(struct bladerf_devinfo **devices);
   void bladerf_free_device_list(struct bladerf_devinfo *devices);
+  typedef enum
+  {
+    BLADERF_HOTPLUG_ARRIVED,
+    BLADERF_HOTPLUG_LEFT,
+  } bladerf_hotplug_event;
+  typedef void (*bladerf_hotplug_cb)(bladerf_hotplug_event event, const
+    struct bladerf_devinfo *info, void *user_data);
+  int bladerf_register_hotplug_callback(bladerf_hotplug_cb cb, void
+    *user_data, int *handle);
+  int bladerf_deregister_hotplug_callback(int handle);
   void bladerf_init_devinfo(struct bladerf_devinfo *info);
   int bladerf_get_devinfo(struct bladerf *dev, struct bladerf_devinfo
     *info);
@@ -47,6 +61,7 @@ header = """
     bladerf_devinfo *info);
   const char *bladerf_backend_str(bladerf_backend backend);
   void bladerf_set_usb_reset_on_open(bool enabled);
+  void bladerf_set_warm_open(bool enabled);
   struct bladerf_range
   {
     int64_t min;
@@ -183,6 +198,12 @@ header = """
     bladerf_frequency frequency);
   int bladerf_set_frequency(struct bladerf *dev, bladerf_channel ch,
     bladerf_frequency frequency);
+  int bladerf_set_frequency_begin(struct bladerf *dev, bladerf_channel ch,
+    bladerf_frequency frequency);
+  int bladerf_get_pll_lock(struct bladerf *dev, bladerf_channel ch,
+    bool *locked);
+  int bladerf_wait_pll_lock(struct bladerf *dev, bladerf_channel ch,
+    unsigned int timeout_ms);
   int bladerf_get_frequency(struct bladerf *dev, bladerf_channel ch,
     bladerf_frequency *frequency);
   int bladerf_get_frequency_range(struct bladerf *dev, bladerf_channel
@@ -249,6 +270,14 @@ header = """
   int bladerf_trigger_state(struct bladerf *dev, const struct
     bladerf_trigger *trigger, bool *is_armed, bool *has_fired, bool
     *fire_requested, uint64_t *resv1, uint64_t *resv2);
+  struct bladerf_trigger_time
+  {
+    bool fired;
+    uint64_t timestamp;
+    bool second_half;
+  };
+  int bladerf_get_trigger_time(struct bladerf *dev, const struct
+    bladerf_trigger *trigger, struct bladerf_trigger_time *time);
   typedef enum
   {
     BLADERF_RX_MUX_INVALID = -1,
@@ -259,6 +288,32 @@ header = """
   } bladerf_rx_mux;
   int bladerf_set_rx_mux(struct bladerf *dev, bladerf_rx_mux mux);
   int bladerf_get_rx_mux(struct bladerf *dev, bladerf_rx_mux *mode);
+  int bladerf_set_rx_decimation(struct bladerf *dev,
+                                unsigned int decimation,
+                                int32_t nco_offset);
+  int bladerf_get_rx_decimation(struct bladerf *dev,
+                                unsigned int *decimation,
+                                int32_t *nco_offset);
+  int bladerf_tx_load_waveform(struct bladerf *dev,
+                               const int16_t *samples,
+                               unsigned int num_samples);
+  int bladerf_tx_loop_start(struct bladerf *dev, unsigned int interpolation);
+  int bladerf_tx_loop_stop(struct bladerf *dev);
+  struct bladerf_rx_power
+  {
+    unsigned int num_samples;
+    uint64_t power_sum;
+    int64_t i_sum;
+    int64_t q_sum;
+    uint16_t peak;
+    uint64_t i2_sum;
+    uint64_t q2_sum;
+    int64_t iq_sum;
+  };
+  int bladerf_measure_rx_power(struct bladerf *dev, bladerf_channel ch,
+    unsigned int num_samples, struct bladerf_rx_power *power);
+  int bladerf_rx_snapshot(struct bladerf *dev, bladerf_channel ch,
+    int16_t *samples, unsigned int num_samples);
   typedef uint64_t bladerf_timestamp;
   struct bladerf_quick_tune
   {
@@ -287,8 +342,40 @@ header = """
     bladerf_quick_tune *quick_tune);
   int bladerf_cancel_scheduled_retunes(struct bladerf *dev,
     bladerf_channel ch);
+  struct bladerf_retune_queue_status {
+    unsigned int pending;
+    unsigned int capacity;
+    bladerf_timestamp next_timestamp;
+  };
+  int bladerf_get_retune_queue_status(struct bladerf *dev,
+    bladerf_channel ch, struct bladerf_retune_queue_status *status);
+  int bladerf_cancel_scheduled_retunes_range(struct bladerf *dev,
+    bladerf_channel ch, bladerf_timestamp start, bladerf_timestamp end,
+    unsigned int *canceled);
+  typedef enum {
+    BLADERF_TIMED_WRITE_CONFIG_GPIO,
+    BLADERF_TIMED_WRITE_EXPANSION_GPIO,
+    BLADERF_TIMED_WRITE_EXPANSION_GPIO_DIR,
+    BLADERF_TIMED_WRITE_TRIM_DAC,
+    BLADERF_TIMED_WRITE_RFFE_CONTROL,
+  } bladerf_timed_write_target;
+  int bladerf_schedule_write(struct bladerf *dev, bladerf_channel ch,
+    bladerf_timestamp timestamp, bladerf_timed_write_target target,
+    uint32_t value);
   int bladerf_get_quick_tune(struct bladerf *dev, bladerf_channel ch,
     struct bladerf_quick_tune *quick_tune);
+  int bladerf_set_quick_tune_cache(struct bladerf *dev, bladerf_channel ch,
+    unsigned int capacity);
+  int bladerf_invalidate_quick_tune_cache(struct bladerf *dev);
+  int bladerf_load_hop_table(struct bladerf *dev, bladerf_channel ch,
+    const bladerf_frequency *frequencies, unsigned int num_frequencies);
+  int bladerf_free_hop_table(struct bladerf *dev, bladerf_channel ch);
+  int bladerf_start_hopping(struct bladerf *dev, bladerf_channel ch,
+    bladerf_timestamp start, uint64_t dwell);
+  int bladerf_enqueue_hops(struct bladerf *dev, bladerf_channel ch,
+    const unsigned int *indices, unsigned int count);
+  int bladerf_get_hop_status(struct bladerf *dev, bladerf_channel ch,
+    unsigned int *pending, bladerf_timestamp *next);
   typedef int16_t bladerf_correction_value;
   typedef enum
   {
@@ -301,13 +388,35 @@ header = """
     bladerf_correction corr, bladerf_correction_value value);
   int bladerf_get_correction(struct bladerf *dev, bladerf_channel ch,
     bladerf_correction corr, bladerf_correction_value *value);
+  struct bladerf_correction_entry {
+    bladerf_frequency frequency;
+    bladerf_correction_value dcoff_i;
+    bladerf_correction_value dcoff_q;
+    bladerf_correction_value phase;
+    bladerf_correction_value gain;
+  };
+  int bladerf_enable_host_correction(struct bladerf *dev, bladerf_channel ch,
+    bool enable);
+  int bladerf_get_host_correction(struct bladerf *dev, bladerf_channel ch,
+    bool *enabled);
+  int bladerf_load_host_correction_table(struct bladerf *dev,
+    bladerf_channel ch, const struct bladerf_correction_entry *entries,
+    unsigned int num_entries);
   typedef enum
   {
     BLADERF_FORMAT_SC16_Q11,
     BLADERF_FORMAT_SC16_Q11_META,
     BLADERF_FORMAT_PACKET_META,
     BLADERF_FORMAT_SC8_Q7,
-    BLADERF_FORMAT_SC8_Q7_META
+    BLADERF_FORMAT_SC8_Q7_META,
+    BLADERF_FORMAT_CF32,
+    BLADERF_FORMAT_CF32_META,
+    BLADERF_FORMAT_SC12_PACKED,
+    BLADERF_FORMAT_SC12_PACKED_META,
+    BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11,
+    BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META,
+    BLADERF_FORMAT_SC8_Q7_AS_CF32,
+    BLADERF_FORMAT_SC8_Q7_AS_CF32_META
   } bladerf_format;
   struct bladerf_metadata
   {
@@ -315,46 +424,278 @@ header = """
     uint32_t flags;
     uint32_t status;
     unsigned int actual_count;
-    uint8_t reserved[32];
+    uint64_t host_timestamp;
+    uint8_t reserved[24];
   };
   int bladerf_interleave_stream_buffer(bladerf_channel_layout layout,
     bladerf_format format, unsigned int buffer_size, void *samples);
   int bladerf_deinterleave_stream_buffer(bladerf_channel_layout layout,
     bladerf_format format, unsigned int buffer_size, void *samples);
+  int bladerf_deinterleave_stream_buffer_to(bladerf_channel_layout layout,
+    bladerf_format format, unsigned int buffer_size, const void *samples,
+    void *const *dest);
   int bladerf_enable_module(struct bladerf *dev, bladerf_channel ch,
     bool enable);
   int bladerf_get_timestamp(struct bladerf *dev, bladerf_direction dir,
     bladerf_timestamp *timestamp);
+  int bladerf_set_timestamp_correlation(struct bladerf *dev,
+    bladerf_direction dir, unsigned int interval_ms);
+  int bladerf_timestamp_to_host_ns(struct bladerf *dev, bladerf_direction
+    dir, bladerf_timestamp timestamp, uint64_t *host_ns);
+  int bladerf_host_ns_to_timestamp(struct bladerf *dev, bladerf_direction
+    dir, uint64_t host_ns, bladerf_timestamp *timestamp);
+  uint64_t bladerf_get_host_time_ns(void);
   int bladerf_sync_config(struct bladerf *dev, bladerf_channel_layout
     layout, bladerf_format format, unsigned int num_buffers, unsigned int
     buffer_size, unsigned int num_transfers, unsigned int stream_timeout);
+  int bladerf_set_sync_link_adaptation(struct bladerf *dev, uint32_t allowed);
+  int bladerf_get_sync_format(struct bladerf *dev, bladerf_direction dir,
+    bladerf_format *format);
   int bladerf_sync_tx(struct bladerf *dev, const void *samples, unsigned
     int num_samples, struct bladerf_metadata *metadata, unsigned int
     timeout_ms);
   int bladerf_sync_rx(struct bladerf *dev, void *samples, unsigned int
     num_samples, struct bladerf_metadata *metadata, unsigned int
     timeout_ms);
+  int bladerf_sync_tx_multi(struct bladerf *dev, const void *const *bufs,
+    unsigned int num_samples, struct bladerf_metadata *metadata,
+    unsigned int timeout_ms);
+  int bladerf_sync_rx_multi(struct bladerf *dev, void *const *bufs,
+    unsigned int num_samples, struct bladerf_metadata *metadata,
+    unsigned int timeout_ms);
+  struct bladerf_tx_template;
+  int bladerf_sync_create_tx_template(struct bladerf *dev, const void
+    *samples, unsigned int num_samples, struct bladerf_tx_template **tmpl);
+  int bladerf_sync_tx_template(struct bladerf *dev, struct
+    bladerf_tx_template *tmpl, bladerf_timestamp timestamp, unsigned int
+    timeout_ms);
+  int bladerf_sync_free_tx_template(struct bladerf *dev, struct
+    bladerf_tx_template *tmpl);
+  int bladerf_sync_rx_acquire(struct bladerf *dev, void **buffer,
+    unsigned int *num_samples, struct bladerf_metadata *metadata,
+    unsigned int timeout_ms);
+  int bladerf_sync_rx_release(struct bladerf *dev, void *buffer);
+  int bladerf_sync_tx_acquire(struct bladerf *dev, void **buffer,
+    unsigned int *num_samples, unsigned int timeout_ms);
+  int bladerf_sync_tx_submit(struct bladerf *dev, void *buffer,
+    unsigned int num_samples);
+  int bladerf_sync_tx_reserve(struct bladerf *dev, void **buffer,
+    unsigned int *num_samples, uint64_t *position, unsigned int timeout_ms);
+  typedef enum
+  {
+    BLADERF_SYNC_WAIT_BLOCK = 0,
+    BLADERF_SYNC_WAIT_SPIN
+  } bladerf_sync_wait_policy;
+  int bladerf_set_sync_wait_policy(struct bladerf *dev, bladerf_direction
+    dir, bladerf_sync_wait_policy policy, unsigned int spin_us);
+  struct bladerf_stream_stats
+  {
+    uint64_t buffers_produced;
+    uint64_t buffers_consumed;
+    uint64_t buffers_dropped;
+    uint64_t overruns;
+    uint64_t underruns;
+    unsigned int high_water;
+    unsigned int num_buffers;
+    unsigned int buffer_size;
+    unsigned int num_transfers;
+    uint64_t transfers_completed;
+    uint64_t short_transfers;
+    unsigned int xfer_latency_avg_us;
+    unsigned int xfer_latency_max_us;
+    uint64_t fpga_xruns;
+    bladerf_timestamp fpga_last_xrun;
+    uint64_t tap_buffers_written;
+    uint64_t tap_buffers_dropped;
+  };
+  int bladerf_get_stream_stats(struct bladerf *dev, bladerf_direction dir,
+    struct bladerf_stream_stats *stats);
+  struct bladerf_thread_attrs
+  {
+    int cpu;
+    bool realtime;
+    int priority;
+  };
+  int bladerf_set_sync_thread_attrs(struct bladerf *dev, bladerf_direction
+    dir, const struct bladerf_thread_attrs *attrs);
+  int bladerf_set_stream_memory_flags(struct bladerf *dev, uint32_t flags);
+  struct bladerf_buffer_allocator
+  {
+    void *(*alloc)(size_t size, void *user_data);
+    void (*free)(void *ptr, size_t size, void *user_data);
+    void *user_data;
+  };
+  int bladerf_set_sync_buffer_allocator(struct bladerf *dev,
+    bladerf_direction dir, const struct bladerf_buffer_allocator *allocator);
+  struct bladerf_stream_pool_config
+  {
+    size_t size;
+    size_t rx_reserve;
+    size_t tx_reserve;
+  };
+  struct bladerf_stream_pool_stats
+  {
+    size_t size;
+    size_t rx_used;
+    size_t tx_used;
+    size_t peak;
+    unsigned int failures;
+  };
+  int bladerf_set_stream_pool(struct bladerf *dev,
+    const struct bladerf_stream_pool_config *config);
+  int bladerf_get_stream_pool_stats(struct bladerf *dev,
+    struct bladerf_stream_pool_stats *stats);
+  int bladerf_set_sync_rx_pool(struct bladerf *dev, bool enable);
+  int bladerf_set_sync_tx_pool(struct bladerf *dev, bool enable);
+  struct bladerf_rx_channel_stats
+  {
+    uint64_t count;
+    uint64_t clipped;
+    uint16_t peak;
+    double mean_i;
+    double mean_q;
+    double mean_power;
+  };
+  struct bladerf_rx_stats
+  {
+    struct bladerf_rx_channel_stats channel[2];
+  };
+  int bladerf_set_sync_rx_stats(struct bladerf *dev, bool enable,
+    unsigned int clip_threshold);
+  int bladerf_get_sync_rx_stats(struct bladerf *dev,
+    struct bladerf_rx_stats *stats);
+  struct bladerf_sync_rx_tap
+  {
+    const char *path;
+    unsigned int queue_depth;
+  };
+  int bladerf_set_sync_rx_tap(struct bladerf *dev,
+    const struct bladerf_sync_rx_tap *tap);
+  struct bladerf_sync_rx_agc
+  {
+    float target_dbfs;
+    float hysteresis_db;
+    int max_step;
+    float clip_fraction;
+    unsigned int settle_samples;
+    unsigned int lead_samples;
+  };
+  int bladerf_set_sync_rx_agc(struct bladerf *dev, bladerf_channel ch,
+    const struct bladerf_sync_rx_agc *config);
+  int bladerf_sync_prearm(struct bladerf *dev, bladerf_direction dir);
+  int bladerf_sync_rx_nb(struct bladerf *dev, void *samples,
+    unsigned int num_samples, struct bladerf_metadata *metadata);
+  int bladerf_sync_tx_nb(struct bladerf *dev, const void *samples,
+    unsigned int num_samples, struct bladerf_metadata *metadata);
+  int bladerf_set_sync_rx_meta_msg_size(struct bladerf *dev,
+                                        unsigned int size);
+  int bladerf_get_sync_rx_meta_msg_size(struct bladerf *dev,
+                                        unsigned int *size);
+  int bladerf_schedule_rx(struct bladerf *dev, bladerf_timestamp timestamp,
+                          unsigned int num_samples);
+  int bladerf_schedule_rx_bursts(struct bladerf *dev,
+                                 bladerf_timestamp timestamp,
+                                 unsigned int burst_len, unsigned int period);
+  int bladerf_cancel_rx_schedule(struct bladerf *dev);
   struct bladerf_stream;
   typedef void *(*bladerf_stream_cb)(struct bladerf *dev, struct
     bladerf_stream *stream, struct bladerf_metadata *meta, void *samples,
     size_t num_samples, void *user_data);
+  struct bladerf_stream_buffer
+  {
+    void *samples;
+    size_t num_samples;
+    struct bladerf_metadata meta;
+  };
+  typedef size_t (*bladerf_stream_batch_cb)(struct bladerf *dev, struct
+    bladerf_stream *stream, const struct bladerf_stream_buffer *completed,
+    size_t num_completed, void **next, size_t max_next, void *user_data);
   int bladerf_init_stream(struct bladerf_stream **stream, struct bladerf
     *dev, bladerf_stream_cb callback, void ***buffers, size_t num_buffers,
     bladerf_format format, size_t samples_per_buffer, size_t
     num_transfers, void *user_data);
+  int bladerf_init_stream_batch(struct bladerf_stream **stream, struct
+    bladerf *dev, bladerf_stream_batch_cb callback, void ***buffers,
+    size_t num_buffers, bladerf_format format, size_t samples_per_buffer,
+    size_t num_transfers, void *user_data);
+  int bladerf_init_stream_with_allocator(struct bladerf_stream **stream,
+    struct bladerf *dev, bladerf_stream_cb callback, void ***buffers,
+    size_t num_buffers, bladerf_format format, size_t samples_per_buffer,
+    size_t num_transfers, void *user_data,
+    const struct bladerf_buffer_allocator *allocator);
   int bladerf_stream(struct bladerf_stream *stream,
     bladerf_channel_layout layout);
   int bladerf_submit_stream_buffer(struct bladerf_stream *stream, void
     *buffer, unsigned int timeout_ms);
   int bladerf_submit_stream_buffer_nb(struct bladerf_stream *stream,
     void *buffer);
+  int bladerf_stream_set_thread_attrs(struct bladerf_stream *stream, const
+    struct bladerf_thread_attrs *attrs);
   void bladerf_deinit_stream(struct bladerf_stream *stream);
   int bladerf_set_stream_timeout(struct bladerf *dev, bladerf_direction
     dir, unsigned int timeout);
   int bladerf_get_stream_timeout(struct bladerf *dev, bladerf_direction
     dir, unsigned int *timeout);
+  struct bladerf_relay;
+  typedef void (*bladerf_relay_cb)(struct bladerf *dev, void *samples,
+    size_t num_samples, bladerf_timestamp timestamp, void *user_data);
+  struct bladerf_relay_config {
+    bladerf_format format;
+    unsigned int num_channels;
+    size_t num_buffers;
+    size_t samples_per_buffer;
+    size_t num_transfers;
+    unsigned int timeout_ms;
+    uint64_t tx_delay;
+    bladerf_relay_cb process;
+    void *user_data;
+  };
+  int bladerf_relay_init(struct bladerf_relay **relay, struct bladerf *dev,
+    const struct bladerf_relay_config *config);
+  int bladerf_relay_run(struct bladerf_relay *relay);
+  void bladerf_relay_stop(struct bladerf_relay *relay);
+  void bladerf_relay_deinit(struct bladerf_relay *relay);
+  struct bladerf_group;
+  int bladerf_group_open(struct bladerf_group **group, const char *const
+    *device_ids, unsigned int num_devices);
+  void bladerf_group_close(struct bladerf_group *group);
+  struct bladerf *bladerf_group_get_device(struct bladerf_group *group,
+    unsigned int index);
+  int bladerf_group_sync_config(struct bladerf_group *group,
+    bladerf_channel_layout layout, bladerf_format format, unsigned int
+    num_buffers, unsigned int buffer_size, unsigned int num_transfers,
+    unsigned int stream_timeout, const int *cpus);
+  int bladerf_group_start(struct bladerf_group *group, unsigned int master,
+    bladerf_trigger_signal signal);
+  int bladerf_group_rx(struct bladerf_group *group, void *const *samples,
+    unsigned int num_samples, struct bladerf_metadata *metadata,
+    unsigned int timeout_ms);
+  int bladerf_group_stop(struct bladerf_group *group);
+  int bladerf_group_get_trigger_times(struct bladerf_group *group,
+    struct bladerf_trigger_time *times);
+  struct bladerf_broker;
+  struct bladerf_broker_reader;
+  int bladerf_broker_start(struct bladerf *dev, struct bladerf_broker
+    **broker, const char *name, bladerf_channel_layout layout,
+    bladerf_format format, unsigned int num_buffers, unsigned int
+    buffer_size, unsigned int timeout_ms);
+  int bladerf_broker_stop(struct bladerf_broker *broker);
+  int bladerf_broker_attach(struct bladerf_broker_reader **reader, const
+    char *name);
+  void bladerf_broker_detach(struct bladerf_broker_reader *reader);
+  int bladerf_broker_get_config(struct bladerf_broker_reader *reader,
+    bladerf_channel_layout *layout, bladerf_format *format, unsigned int
+    *buffer_size);
+  int bladerf_broker_acquire(struct bladerf_broker_reader *reader, const
+    void **samples, unsigned int *num_samples, struct bladerf_metadata
+    *metadata, unsigned int timeout_ms);
+  int bladerf_broker_release(struct bladerf_broker_reader *reader);
   int bladerf_flash_firmware(struct bladerf *dev, const char *firmware);
   int bladerf_load_fpga(struct bladerf *dev, const char *fpga);
+  typedef void (*bladerf_progress_cb)(size_t done, size_t total,
+    void *user_data);
+  int bladerf_load_fpga_with_progress(struct bladerf *dev, const char *fpga,
+    bladerf_progress_cb cb, void *user_data);
   int bladerf_flash_fpga(struct bladerf *dev, const char *fpga_image);
   int bladerf_erase_stored_fpga(struct bladerf *dev);
   int bladerf_device_reset(struct bladerf *dev);
@@ -411,6 +752,25 @@ header = """
     bladerf_vctcxo_tamer_mode mode);
   int bladerf_get_vctcxo_tamer_mode(struct bladerf *dev,
     bladerf_vctcxo_tamer_mode *mode);
+  typedef enum
+  {
+    BLADERF_VCTCXO_TAMER_STATE_DISABLED = 0,
+    BLADERF_VCTCXO_TAMER_STATE_ACQUIRING = 1,
+    BLADERF_VCTCXO_TAMER_STATE_TRACKING = 2
+  } bladerf_vctcxo_tamer_state;
+  struct bladerf_vctcxo_tamer_status
+  {
+    bladerf_vctcxo_tamer_state state;
+    bool locked;
+    unsigned int measurements;
+    uint16_t trim_dac;
+    int32_t error_1s;
+    int32_t error_10s;
+  };
+  int bladerf_get_vctcxo_tamer_status(struct bladerf *dev,
+    struct bladerf_vctcxo_tamer_status *status);
+  int bladerf_wait_vctcxo_tamer_lock(struct bladerf *dev,
+    unsigned int timeout_ms);
   int bladerf_get_vctcxo_trim(struct bladerf *dev, uint16_t *trim);
   int bladerf_trim_dac_write(struct bladerf *dev, uint16_t val);
   int bladerf_trim_dac_read(struct bladerf *dev, uint16_t *val);
@@ -434,6 +794,157 @@ header = """
     uint32_t val);
   int bladerf_config_gpio_read(struct bladerf *dev, uint32_t *val);
   int bladerf_config_gpio_write(struct bladerf *dev, uint32_t val);
+  int bladerf_batch_begin(struct bladerf *dev);
+  int bladerf_batch_commit(struct bladerf *dev);
+  int bladerf_save_profile(struct bladerf *dev, void *buf, size_t *len);
+  int bladerf_load_profile(struct bladerf *dev, const void *buf, size_t len);
+  struct bladerf_gain_stage_value
+  {
+    const char *name;
+    int gain;
+  };
+  struct bladerf_channel_state
+  {
+    bladerf_channel channel;
+    uint32_t valid;
+    bladerf_frequency frequency;
+    struct bladerf_rational_rate samplerate;
+    bladerf_bandwidth bandwidth;
+    const char *rf_port;
+    bladerf_gain_mode gain_mode;
+    int gain;
+    unsigned int num_stages;
+    struct bladerf_gain_stage_value stages[8];
+  };
+  struct bladerf_device_state
+  {
+    uint32_t valid;
+    bladerf_loopback loopback;
+    bladerf_rx_mux rx_mux;
+    bladerf_tuning_mode tuning_mode;
+    uint16_t trim_dac;
+    unsigned int num_channels;
+    struct bladerf_channel_state channels[4];
+  };
+  int bladerf_get_device_state(struct bladerf *dev,
+    struct bladerf_device_state *state);
+  int bladerf_enable_stream_recovery(struct bladerf *dev, bool enable);
+  int bladerf_get_stream_recoveries(struct bladerf *dev,
+    unsigned int *count);
+  struct bladerf_link_test_gap {
+    uint64_t sample;
+    uint32_t expected;
+    uint32_t received;
+  };
+  struct bladerf_link_test_result {
+    uint64_t samples;
+    double seconds;
+    double throughput;
+    uint64_t gaps;
+    uint64_t dropped;
+    unsigned int num_gaps;
+    struct bladerf_link_test_gap gap[16];
+  };
+  int bladerf_link_test(struct bladerf *dev, unsigned int duration_ms,
+    struct bladerf_link_test_result *result);
+  struct bladerf_latency_config {
+    unsigned int iterations;
+    unsigned int interval_ms;
+    unsigned int rx_samples;
+    int16_t threshold;
+    unsigned int timeout_ms;
+  };
+  struct bladerf_latency_dist {
+    uint64_t count;
+    uint64_t min_ns;
+    uint64_t mean_ns;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+  };
+  struct bladerf_latency_result {
+    unsigned int missed;
+    struct bladerf_latency_dist host_to_rf;
+    struct bladerf_latency_dist rf_to_host;
+  };
+  int bladerf_measure_latency(struct bladerf *dev, const struct
+    bladerf_latency_config *config, struct bladerf_latency_result *result);
+  typedef void (*bladerf_ctrl_cb)(struct bladerf *dev, int status, void
+    *user_data);
+  int bladerf_set_frequency_async(struct bladerf *dev, bladerf_channel ch,
+    bladerf_frequency frequency, bladerf_ctrl_cb cb, void *user_data);
+  int bladerf_set_gain_async(struct bladerf *dev, bladerf_channel ch,
+    bladerf_gain gain, bladerf_ctrl_cb cb, void *user_data);
+  int bladerf_schedule_retune_async(struct bladerf *dev, bladerf_channel
+    ch, bladerf_timestamp timestamp, bladerf_frequency frequency, struct
+    bladerf_quick_tune *quick_tune, bladerf_ctrl_cb cb, void *user_data);
+  int bladerf_get_timestamp_async(struct bladerf *dev, bladerf_direction
+    dir, bladerf_timestamp *timestamp, bladerf_ctrl_cb cb, void *user_data);
+  int bladerf_flush_async_ctrl(struct bladerf *dev, unsigned int
+    timeout_ms);
+  int bladerf_tx_sched_config(struct bladerf *dev, uint64_t lead,
+    unsigned int timeout_ms);
+  int bladerf_tx_sched_submit(struct bladerf *dev, const void *samples,
+    unsigned int num_samples, bladerf_timestamp timestamp);
+  int bladerf_tx_sched_flush(struct bladerf *dev, unsigned int timeout_ms);
+  int bladerf_rx_history_start(struct bladerf *dev, unsigned int num_buffers);
+  int bladerf_rx_history_stop(struct bladerf *dev);
+  int bladerf_rx_history_range(struct bladerf *dev, bladerf_timestamp *start,
+                               bladerf_timestamp *end);
+  int bladerf_rx_history_read(struct bladerf *dev, void *samples,
+                              unsigned int num_samples,
+                              bladerf_timestamp timestamp,
+                              struct bladerf_metadata *metadata,
+                              unsigned int timeout_ms);
+  typedef enum
+  {
+    BLADERF_CONTROL_PKT_8x8 = 0,
+    BLADERF_CONTROL_PKT_8x16,
+    BLADERF_CONTROL_PKT_8x32,
+    BLADERF_CONTROL_PKT_8x64,
+    BLADERF_CONTROL_PKT_16x64,
+    BLADERF_CONTROL_PKT_32x32,
+    BLADERF_CONTROL_PKT_RETUNE,
+    BLADERF_CONTROL_PKT_OTHER
+  } bladerf_control_pkt;
+  struct bladerf_control_latency
+  {
+    uint64_t count;
+    uint64_t errors;
+    uint64_t min_ns;
+    uint64_t mean_ns;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;
+  };
+  struct bladerf_control_stats
+  {
+    struct bladerf_control_latency pkt[8];
+  };
+  int bladerf_enable_control_stats(struct bladerf *dev, bool enable);
+  int bladerf_get_control_stats(struct bladerf *dev, struct
+    bladerf_control_stats *stats);
+  struct bladerf_metrics
+  {
+    uint64_t host_ns;
+    uint64_t updates;
+    unsigned int interval_ms;
+    uint32_t valid;
+    char serial[33];
+    char board[16];
+    struct bladerf_stream_stats rx;
+    struct bladerf_stream_stats tx;
+    struct bladerf_control_stats control;
+    struct bladerf_retune_queue_status retune[2];
+    float rfic_temperature;
+  };
+  int bladerf_enable_metrics(struct bladerf *dev, const char *name,
+    unsigned int interval_ms);
+  int bladerf_read_metrics(const char *name, struct bladerf_metrics
+    *metrics);
   int bladerf_erase_flash(struct bladerf *dev, uint32_t erase_block,
     uint32_t count);
   int bladerf_erase_flash_bytes(struct bladerf *dev, uint32_t address,
@@ -606,6 +1117,11 @@ header = """
   } bladerf_cal_module;
   int bladerf_calibrate_dc(struct bladerf *dev, bladerf_cal_module
     module);
+  int bladerf_calibrate_rx_dc_sweep(struct bladerf *dev,
+    const bladerf_frequency *frequencies, unsigned int count,
+    unsigned int num_samples, int16_t *dc_i, int16_t *dc_q);
+  int bladerf_characterize_vcocap(struct bladerf *dev, bool store);
+  int bladerf_clear_vcocap_table(struct bladerf *dev, bool erase);
   int bladerf_dac_write(struct bladerf *dev, uint16_t val);
   int bladerf_dac_read(struct bladerf *dev, uint16_t *val);
   int bladerf_si5338_read(struct bladerf *dev, uint8_t address, uint8_t
@@ -638,6 +1154,15 @@ header = """
     *enable);
   int bladerf_set_bias_tee(struct bladerf *dev, bladerf_channel ch, bool
     enable);
+  int bladerf_store_fastlock_profile(struct bladerf *dev, bladerf_channel ch,
+    unsigned int *index);
+  int bladerf_prefetch_fastlock_profiles(struct bladerf *dev,
+    bladerf_channel ch, const unsigned int *indices, unsigned int count);
+  int bladerf_schedule_fastlock_retune(struct bladerf *dev,
+    bladerf_channel ch, bladerf_timestamp timestamp, unsigned int index);
+  int bladerf_clear_fastlock_profiles(struct bladerf *dev, bladerf_channel ch);
+  int bladerf_schedule_gain(struct bladerf *dev, bladerf_channel ch,
+    bladerf_timestamp timestamp, int gain);
   int bladerf_get_rfic_register(struct bladerf *dev, uint16_t address,
     uint8_t *val);
   int bladerf_set_rfic_register(struct bladerf *dev, uint16_t address,
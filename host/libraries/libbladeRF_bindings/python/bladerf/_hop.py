@@ -0,0 +1,142 @@
+# Copyright (c) 2026 Nuand LLC
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+"""NumPy-native frequency hopping
+
+Hop schedules are passed to libbladeRF as NumPy arrays, which are handed to
+C without per-entry conversion. With the compiled module (see _build.py),
+each operation here is a single call into libbladeRF, however long the
+schedule. NumPy is only required when these are used.
+"""
+
+from ._bladerf import ffi, libbladeRF, _check_error, _have_helpers
+
+
+def _numpy():
+    try:
+        import numpy
+    except ImportError:
+        raise ImportError("NumPy is required for array-based hopping")
+    return numpy
+
+
+def quick_tune_dtype():
+    """Returns the NumPy dtype of one opaque quick tune, as produced by
+    get_quick_tunes()"""
+    np = _numpy()
+    return np.dtype((np.void, ffi.sizeof("struct bladerf_quick_tune")))
+
+
+def _array(values, dtype):
+    np = _numpy()
+    return np.ascontiguousarray(values, dtype=dtype)
+
+
+def _ptr(ctype, arr):
+    return ffi.cast(ctype, ffi.from_buffer(arr))
+
+
+def get_quick_tunes(dev, ch, frequencies):
+    """Tunes channel ch to each frequency in turn, and returns an array of
+    their quick tunes. The channel is returned to its original frequency
+    afterwards. This retunes the channel, and should not be done while it
+    is in use."""
+    np = _numpy()
+    frequencies = _array(frequencies, np.uint64)
+    out = np.empty(len(frequencies), dtype=quick_tune_dtype())
+
+    if _have_helpers:
+        ret = libbladeRF.pybladerf_get_quick_tunes(
+            dev.dev[0], ch, _ptr("bladerf_frequency *", frequencies),
+            len(frequencies), _ptr("struct bladerf_quick_tune *", out))
+        _check_error(ret)
+        return out
+
+    original = dev.get_frequency(ch)
+    try:
+        qts = _ptr("struct bladerf_quick_tune *", out)
+        for i, freq in enumerate(frequencies):
+            dev.set_frequency(ch, int(freq))
+            qts[i] = dev.get_quick_tune(ch)[0]
+    finally:
+        dev.set_frequency(ch, original)
+    return out
+
+
+def schedule_hops(dev, ch, timestamps, frequencies, quick_tunes=None):
+    """Schedules a retune of channel ch to frequencies[i] at timestamps[i],
+    for each i, using quick_tunes[i] from get_quick_tunes() if given.
+
+    Every entry is attempted, even once one fails. Returns an int32 array
+    of each entry's libbladeRF return code, which is 0 where the retune was
+    scheduled. No exception is raised for failed entries; RETCODES such as
+    -15 (BLADERF_ERR_QUEUE_FULL) indicate that the device's retune queue
+    must drain before the remaining entries are rescheduled.
+    """
+    np = _numpy()
+    timestamps = _array(timestamps, np.uint64)
+    frequencies = _array(frequencies, np.uint64)
+    count = len(timestamps)
+    if len(frequencies) != count:
+        raise ValueError("Each hop needs a timestamp and a frequency")
+    if quick_tunes is not None:
+        quick_tunes = _array(quick_tunes, quick_tune_dtype())
+        if len(quick_tunes) != count:
+            raise ValueError("Each hop needs a quick tune if any are given")
+    statuses = np.zeros(count, dtype=np.int32)
+
+    if _have_helpers:
+        qts = ffi.NULL
+        if quick_tunes is not None:
+            qts = _ptr("struct bladerf_quick_tune *", quick_tunes)
+        libbladeRF.pybladerf_schedule_hops(
+            dev.dev[0], ch, _ptr("bladerf_timestamp *", timestamps),
+            _ptr("bladerf_frequency *", frequencies), qts, count,
+            _ptr("int *", statuses))
+        return statuses
+
+    if quick_tunes is not None:
+        qt_ptr = _ptr("struct bladerf_quick_tune *", quick_tunes)
+    for i in range(count):
+        qt = qt_ptr + i if quick_tunes is not None else ffi.NULL
+        statuses[i] = libbladeRF.bladerf_schedule_retune(
+            dev.dev[0], ch, int(timestamps[i]), int(frequencies[i]), qt)
+    return statuses
+
+
+def load_hop_table(dev, ch, frequencies):
+    """Builds channel ch's hop table from an array of frequencies, for
+    enqueue_hops()"""
+    np = _numpy()
+    frequencies = _array(frequencies, np.uint64)
+    ret = libbladeRF.bladerf_load_hop_table(
+        dev.dev[0], ch, _ptr("bladerf_frequency *", frequencies),
+        len(frequencies))
+    _check_error(ret)
+
+
+def enqueue_hops(dev, ch, indices):
+    """Appends an array of hop table indices to channel ch's hop schedule.
+    Either all or none are queued."""
+    np = _numpy()
+    indices = _array(indices, np.uint32)
+    ret = libbladeRF.bladerf_enqueue_hops(
+        dev.dev[0], ch, _ptr("unsigned int *", indices), len(indices))
+    _check_error(ret)
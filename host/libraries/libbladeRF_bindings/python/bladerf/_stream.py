@@ -0,0 +1,432 @@
+# Copyright (c) 2026 Nuand LLC
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+"""NumPy-native sample streaming
+
+The arrays used here are filled in place by libbladeRF, such that samples
+are received directly in their final representation with no intermediate
+copies or conversions in Python. NumPy is only required when these are used.
+"""
+
+import asyncio
+import queue
+import threading
+
+from ._bladerf import ffi, libbladeRF, _check_error, Format, ChannelLayout
+
+# libbladeRF metadata flags, which are not part of the cdef
+META_STATUS_OVERRUN = 1 << 0
+META_FLAG_RX_NOW = 1 << 31
+
+# Stream formats for each of the 'fmt' options, as (format, metadata format)
+_FORMATS = {
+    "complex64": (Format.CF32, Format.CF32_META),
+    "complex_int16": (Format.SC16_Q11, Format.SC16_Q11_META),
+    "complex_int8": (Format.SC8_Q7, Format.SC8_Q7_META),
+}
+
+
+def _numpy():
+    try:
+        import numpy
+    except ImportError:
+        raise ImportError("NumPy is required for array-based streaming")
+    return numpy
+
+
+def sample_dtype(fmt):
+    """Returns the NumPy dtype of a sample in the given format.
+
+    A 'complex64' sample is a native NumPy complex value, scaled to
+    [-1.0, 1.0). The 'complex_int16' and 'complex_int8' samples are structured
+    ('re', 'im') pairs holding the raw SC16 Q11 and SC8 Q7 values.
+    """
+    np = _numpy()
+
+    if fmt == "complex64":
+        return np.dtype(np.complex64)
+    elif fmt == "complex_int16":
+        return np.dtype([("re", "<i2"), ("im", "<i2")])
+    elif fmt == "complex_int8":
+        return np.dtype([("re", "i1"), ("im", "i1")])
+    else:
+        raise ValueError("Unsupported format: {}".format(fmt))
+
+
+def stream_format(fmt, meta=False):
+    """Returns the Format with which to sync_config() for the given sample
+    format"""
+    try:
+        return _FORMATS[fmt][1 if meta else 0]
+    except KeyError:
+        raise ValueError("Unsupported format: {}".format(fmt))
+
+
+def _num_channels(layout):
+    if layout in (ChannelLayout.RX_X2, ChannelLayout.TX_X2):
+        return 2
+    return 1
+
+
+def _without_markers(q):
+    """Returns a copy of queue q without any None items"""
+    result = queue.Queue()
+    while True:
+        try:
+            item = q.get_nowait()
+        except queue.Empty:
+            return result
+        if item is not None:
+            result.put(item)
+
+
+def alloc_rx_array(num_samples, fmt="complex64",
+                   layout=ChannelLayout.RX_X1):
+    """Returns an array for num_samples samples per channel. Arrays for X2
+    layouts have a column per channel, which are views onto the interleaved
+    samples."""
+    np = _numpy()
+    channels = _num_channels(layout)
+    shape = (num_samples, channels) if channels > 1 else (num_samples,)
+    return np.empty(shape, dtype=sample_dtype(fmt))
+
+
+class RxBuffer:
+    """A pooled RX array lent out by an RxRing or AsyncRx.
+
+    The samples remain valid until release() is called, after which the
+    array is reused. This may be used as a context manager which releases
+    the buffer upon exit.
+    """
+
+    def __init__(self, ring, index):
+        self._ring = ring
+        self._index = index
+        self.samples = ring._arrays[index]
+        self.overrun = False
+        self.timestamp = 0
+        self.host_timestamp = 0
+
+    def release(self):
+        if self._ring is not None:
+            ring, self._ring = self._ring, None
+            ring._release(self._index)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.release()
+
+
+class RxRing:
+    """Receives samples into a pool of preallocated arrays on a background
+    thread.
+
+    The thread repeatedly fills the next free array via bladerf_sync_rx(),
+    during which the GIL is released, and queues it for the consumer. When
+    the consumer falls behind, such that no arrays are free, reception
+    pauses and samples are dropped on the device side. The next buffer then
+    has its 'overrun' attribute set.
+
+    Example usage:
+
+    >>> ring = d.rx_ring(num_samples=65536)
+    >>> d.Channel(bladerf.CHANNEL_RX(0)).enable = True
+    >>> ring.start()
+    >>> with ring.get() as buf:
+    ...     power = np.mean(np.abs(buf.samples) ** 2)
+    >>> ring.stop()
+    """
+
+    def __init__(self, dev, num_samples, fmt="complex64",
+                 layout=ChannelLayout.RX_X1, pool_size=8, num_buffers=32,
+                 buffer_size=16384, num_transfers=16, stream_timeout=3500,
+                 meta=False):
+        """Configures the device for synchronous RX in the given format.
+
+        num_samples is the number of samples per channel in each array.
+        pool_size arrays are shared between the reader thread and the
+        consumer. num_buffers, buffer_size, num_transfers and stream_timeout
+        are passed to sync_config(). With meta=True, the metadata variant of
+        the format is used and each buffer's 'timestamp' is the timestamp of
+        its first sample.
+        """
+        self.dev = dev
+        self.fmt = fmt
+        self.layout = layout
+        self.num_samples = num_samples
+        self.meta = meta
+        self.timeout_ms = stream_timeout
+
+        dev.sync_config(layout, stream_format(fmt, meta), num_buffers,
+                        buffer_size, num_transfers, stream_timeout)
+
+        self._total = num_samples * _num_channels(layout)
+        self._arrays = [alloc_rx_array(num_samples, fmt, layout)
+                        for _ in range(pool_size)]
+        self._ptrs = [ffi.from_buffer(a) for a in self._arrays]
+        self._metas = [ffi.new("struct bladerf_metadata *")
+                       for _ in range(pool_size)]
+
+        self._free = queue.Queue()
+        self._full = queue.Queue()
+        self._thread = None
+        self._running = False
+        self._error = None
+
+        for i in range(pool_size):
+            self._free.put(i)
+
+    def start(self):
+        """Starts the reader thread"""
+        if self._thread is not None:
+            return
+
+        # Discard the end-of-stream markers left by a previous run, keeping
+        # any buffers that were not yet consumed
+        self._free = _without_markers(self._free)
+        self._full = _without_markers(self._full)
+
+        self._running = True
+        self._error = None
+        self._thread = threading.Thread(target=self._reader, daemon=True)
+        self._thread.start()
+
+    def stop(self):
+        """Stops the reader thread. This returns once an in-progress
+        reception completes. Queued buffers remain available via get()."""
+        if self._thread is None:
+            return
+
+        self._running = False
+
+        # Unblock the reader if it is waiting for a free array
+        self._free.put(None)
+        self._thread.join()
+        self._thread = None
+
+    def get(self, timeout=None):
+        """Returns the next RxBuffer, waiting up to timeout seconds (forever
+        if None). Raises queue.Empty on timeout, or the error that stopped
+        the reader."""
+        item = self._full.get(timeout=timeout)
+
+        if item is None:
+            # Leave the marker in place for subsequent calls
+            self._full.put(None)
+            if self._error is not None:
+                raise self._error
+            raise queue.Empty()
+
+        return item
+
+    def __iter__(self):
+        """Yields RxBuffers until the reader stops. Each is released when the
+        next is requested."""
+        while True:
+            try:
+                buf = self.get()
+            except queue.Empty:
+                return
+
+            try:
+                yield buf
+            finally:
+                buf.release()
+
+    def __enter__(self):
+        self.start()
+        return self
+
+    def __exit__(self, *args):
+        self.stop()
+
+    def _release(self, index):
+        self._free.put(index)
+
+    def _reader(self):
+        dev = self.dev.dev[0]
+
+        try:
+            while self._running:
+                i = self._free.get()
+                if i is None or not self._running:
+                    if i is not None:
+                        self._free.put(i)
+                    break
+
+                meta = self._metas[i]
+                meta.flags = META_FLAG_RX_NOW
+
+                ret = libbladeRF.bladerf_sync_rx(dev, self._ptrs[i],
+                                                 self._total, meta,
+                                                 self.timeout_ms)
+                if ret < 0:
+                    self._free.put(i)
+                    _check_error(ret)
+
+                buf = RxBuffer(self, i)
+                buf.overrun = bool(meta.status & META_STATUS_OVERRUN)
+                buf.timestamp = meta.timestamp
+                buf.host_timestamp = meta.host_timestamp
+                self._full.put(buf)
+        except Exception as e:
+            self._error = e
+        finally:
+            self._running = False
+            self._full.put(None)
+
+
+class AsyncRx:
+    """Zero-copy RX via the buffers of the stream itself.
+
+    This uses the RX buffer pool mode of the synchronous interface (see
+    bladerf_set_sync_rx_pool()), in which the asynchronous stream is
+    serviced by libbladeRF's worker thread. Its transfer callbacks run
+    entirely in C and merely mark buffers as filled, so Python is not
+    involved in, and the GIL is not taken for, any USB completions.
+
+    Each stream buffer is wrapped by a NumPy array once, and acquire() lends
+    out the next filled one as an RxBuffer. It is not refilled until it is
+    released, which may be done in any order. Each buffer's 'timestamp' is
+    the position of its first sample within the stream.
+
+    Buffers may be consumed by iterating, or with asyncio:
+
+    >>> rx = d.async_rx(fmt="complex_int16")
+    >>> d.Channel(bladerf.CHANNEL_RX(0)).enable = True
+    >>> async def consume():
+    ...     async for buf in rx:
+    ...         process(buf.samples)
+    """
+
+    def __init__(self, dev, fmt="complex_int16", layout=ChannelLayout.RX_X1,
+                 num_buffers=32, buffer_size=16384, num_transfers=16,
+                 stream_timeout=3500):
+        """Configures the device for synchronous RX in buffer pool mode.
+        The arguments following fmt and layout are passed to sync_config().
+
+        Only the 'complex_int16' and 'complex_int8' formats are supported,
+        as CF32 samples are converted from the stream buffers.
+        """
+        if fmt not in ("complex_int16", "complex_int8"):
+            raise ValueError("Unsupported format for AsyncRx: {}".format(fmt))
+
+        self.dev = dev
+        self.fmt = fmt
+        self.layout = layout
+        self.timeout_ms = stream_timeout
+
+        self._dtype = sample_dtype(fmt)
+        self._channels = _num_channels(layout)
+        self._arrays = {}
+
+        ret = libbladeRF.bladerf_set_sync_rx_pool(dev.dev[0], True)
+        _check_error(ret)
+
+        dev.sync_config(layout, stream_format(fmt), num_buffers, buffer_size,
+                        num_transfers, stream_timeout)
+
+    def close(self):
+        """Returns the interface to its default mode for the next
+        sync_config(). Held buffers are invalidated once the stream is
+        reconfigured."""
+        self._arrays = {}
+        ret = libbladeRF.bladerf_set_sync_rx_pool(self.dev.dev[0], False)
+        _check_error(ret)
+
+    def _wrap(self, address, num_samples):
+        """Returns the array for the stream buffer at the given address"""
+        np = _numpy()
+        arr = self._arrays.get(address)
+
+        if arr is None or arr.size != num_samples:
+            ptr = ffi.cast("void *", address)
+            arr = np.frombuffer(ffi.buffer(ptr, num_samples *
+                                           self._dtype.itemsize),
+                                dtype=self._dtype)
+            if self._channels > 1:
+                arr = arr.reshape(-1, self._channels)
+            self._arrays[address] = arr
+
+        return arr
+
+    def acquire(self, timeout_ms=None):
+        """Returns the next filled RxBuffer, waiting up to timeout_ms
+        milliseconds (the stream timeout if None)"""
+        buf_ptr = ffi.new("void **")
+        num_samples = ffi.new("unsigned int *")
+        meta = ffi.new("struct bladerf_metadata *")
+
+        if timeout_ms is None:
+            timeout_ms = self.timeout_ms
+
+        ret = libbladeRF.bladerf_sync_rx_acquire(self.dev.dev[0], buf_ptr,
+                                                 num_samples, meta,
+                                                 timeout_ms)
+        _check_error(ret)
+
+        address = int(ffi.cast("uintptr_t", buf_ptr[0]))
+        self._wrap(address, num_samples[0])
+
+        buf = RxBuffer(self, address)
+        buf.overrun = bool(meta.status & META_STATUS_OVERRUN)
+        buf.timestamp = meta.timestamp
+        buf.host_timestamp = meta.host_timestamp
+        return buf
+
+    def _release(self, address):
+        ret = libbladeRF.bladerf_sync_rx_release(self.dev.dev[0],
+                                                 ffi.cast("void *", address))
+        _check_error(ret)
+
+    async def get(self, timeout_ms=None):
+        """As with acquire(), without blocking the event loop. The wait
+        occurs in the loop's default executor."""
+        loop = asyncio.get_event_loop()
+        return await loop.run_in_executor(None, self.acquire, timeout_ms)
+
+    def __iter__(self):
+        """Yields RxBuffers indefinitely. Each is released when the next is
+        requested."""
+        while True:
+            buf = self.acquire()
+            try:
+                yield buf
+            finally:
+                buf.release()
+
+    def __aiter__(self):
+        return self._aiter()
+
+    async def _aiter(self):
+        while True:
+            buf = await self.get()
+            try:
+                yield buf
+            finally:
+                buf.release()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
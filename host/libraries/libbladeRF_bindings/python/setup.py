@@ -9,10 +9,18 @@ https://github.com/pypa/sampleproject
 from setuptools import setup, find_packages
 # To use a consistent encoding
 from codecs import open
-from os import path
+from os import path, environ
 
 here = path.abspath(path.dirname(__file__))
 
+# Build the compiled API-mode module unless asked not to, e.g. where
+# libbladeRF's headers aren't installed. The package then loads libbladeRF
+# in ABI mode instead.
+if environ.get('BLADERF_PYTHON_ABI_ONLY'):
+    cffi_modules = []
+else:
+    cffi_modules = ['bladerf/_build.py:ffibuilder']
+
 # Get the long description from the README file
 with open(path.join(here, 'README.md'), encoding='utf-8') as f:
     long_description = f.read()
@@ -40,7 +48,12 @@ setup(
     ],
     keywords='bladerf sdr cffi radio libbladerf',
     packages=find_packages(exclude=['contrib', 'docs', 'tests']),
-    install_requires=['cffi'],
+    setup_requires=['cffi>=1.0.0'],
+    install_requires=['cffi>=1.0.0'],
+    cffi_modules=cffi_modules,
+    extras_require={
+        'numpy': ['numpy'],
+    },
     entry_points={
         'console_scripts': [
             'bladerf-tool=bladerf._tool:main',
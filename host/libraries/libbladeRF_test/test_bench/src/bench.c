@@ -0,0 +1,677 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/resource.h>
+
+#include "bench.h"
+#include "log.h"
+
+/* Every user sample format is at most this many bytes per sample */
+#define MAX_BYTES_PER_SAMPLE 8
+
+static const struct {
+    const char *name;
+    bladerf_format format;
+} formats[] = {
+    { "sc16q11",        BLADERF_FORMAT_SC16_Q11 },
+    { "sc16q11_meta",   BLADERF_FORMAT_SC16_Q11_META },
+    { "sc8q7",          BLADERF_FORMAT_SC8_Q7 },
+    { "sc8q7_meta",     BLADERF_FORMAT_SC8_Q7_META },
+    { "sc12",           BLADERF_FORMAT_SC12_PACKED },
+    { "sc12_meta",      BLADERF_FORMAT_SC12_PACKED_META },
+    { "cf32",           BLADERF_FORMAT_CF32 },
+    { "cf32_meta",      BLADERF_FORMAT_CF32_META },
+    { "sc8q7_sc16",     BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11 },
+    { "sc8q7_sc16_meta", BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META },
+    { "sc8q7_cf32",     BLADERF_FORMAT_SC8_Q7_AS_CF32 },
+    { "sc8q7_cf32_meta", BLADERF_FORMAT_SC8_Q7_AS_CF32_META },
+};
+
+static const struct {
+    const char *name;
+    bladerf_channel_layout layout;
+} layouts[] = {
+    { "rx_x1", BLADERF_RX_X1 },
+    { "rx_x2", BLADERF_RX_X2 },
+    { "tx_x1", BLADERF_TX_X1 },
+    { "tx_x2", BLADERF_TX_X2 },
+    { "duplex_x1", BLADERF_RX_X1 | BENCH_LAYOUT_DUPLEX },
+    { "duplex_x2", BLADERF_RX_X2 | BENCH_LAYOUT_DUPLEX },
+};
+
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+const char *bench_format2str(bladerf_format format)
+{
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(formats); i++) {
+        if (formats[i].format == format) {
+            return formats[i].name;
+        }
+    }
+
+    return "unknown";
+}
+
+int bench_str2format(const char *str, bladerf_format *format)
+{
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(formats); i++) {
+        if (!strcasecmp(str, formats[i].name)) {
+            *format = formats[i].format;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+const char *bench_layout2str(bladerf_channel_layout layout)
+{
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(layouts); i++) {
+        if (layouts[i].layout == layout) {
+            return layouts[i].name;
+        }
+    }
+
+    return "unknown";
+}
+
+int bench_str2layout(const char *str, bladerf_channel_layout *layout)
+{
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(layouts); i++) {
+        if (!strcasecmp(str, layouts[i].name)) {
+            *layout = layouts[i].layout;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+static inline bool layout_is_duplex(bladerf_channel_layout layout)
+{
+    return (layout & BENCH_LAYOUT_DUPLEX) != 0;
+}
+
+static inline bladerf_channel_layout layout_base(bladerf_channel_layout layout)
+{
+    return (bladerf_channel_layout)(layout & ~BENCH_LAYOUT_DUPLEX);
+}
+
+static inline bool layout_is_tx(bladerf_channel_layout layout)
+{
+    return (layout & BLADERF_DIRECTION_MASK) == BLADERF_TX;
+}
+
+static inline unsigned int layout_num_channels(bladerf_channel_layout layout)
+{
+    return (layout >> 1) + 1;
+}
+
+static inline bool format_has_meta(bladerf_format format)
+{
+    switch (format) {
+        case BLADERF_FORMAT_SC16_Q11_META:
+        case BLADERF_FORMAT_SC8_Q7_META:
+        case BLADERF_FORMAT_SC12_PACKED_META:
+        case BLADERF_FORMAT_CF32_META:
+        case BLADERF_FORMAT_SC8_Q7_AS_SC16_Q11_META:
+        case BLADERF_FORMAT_SC8_Q7_AS_CF32_META:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+static inline double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static inline double cpu_time_s(void)
+{
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0.0;
+    }
+
+    return (double)usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 +
+           (double)usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+}
+
+struct latencies {
+    double *us;
+    size_t count;
+    size_t len;
+};
+
+static void latencies_add(struct latencies *l, double us)
+{
+    if (l->count == l->len) {
+        size_t new_len;
+        double *tmp;
+
+        if (l->len >= BENCH_MAX_LATENCIES) {
+            return;
+        }
+
+        new_len = (l->len == 0) ? 4096 : 2 * l->len;
+        tmp     = realloc(l->us, new_len * sizeof(l->us[0]));
+        if (tmp == NULL) {
+            return;
+        }
+
+        l->us  = tmp;
+        l->len = new_len;
+    }
+
+    l->us[l->count++] = us;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    const double x = *(const double *)a;
+    const double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of a sorted array */
+static double percentile(const double *sorted, size_t n, double pct)
+{
+    size_t rank;
+
+    if (n == 0) {
+        return 0.0;
+    }
+
+    rank = (size_t)(pct / 100.0 * n + 0.5);
+    if (rank == 0) {
+        rank = 1;
+    } else if (rank > n) {
+        rank = n;
+    }
+
+    return sorted[rank - 1];
+}
+
+static void latencies_summarize(struct latencies *l, struct bench_result *r)
+{
+    r->latency_count = l->count;
+    if (l->count == 0) {
+        return;
+    }
+
+    qsort(l->us, l->count, sizeof(l->us[0]), cmp_double);
+
+    r->latency_p50_us  = percentile(l->us, l->count, 50.0);
+    r->latency_p90_us  = percentile(l->us, l->count, 90.0);
+    r->latency_p99_us  = percentile(l->us, l->count, 99.0);
+    r->latency_p999_us = percentile(l->us, l->count, 99.9);
+    r->latency_max_us  = l->us[l->count - 1];
+}
+
+static int enable_channels(struct bladerf *dev, bladerf_channel_layout layout,
+                           bool enable)
+{
+    unsigned int i;
+    int status = 0;
+
+    for (i = 0; i < layout_num_channels(layout); i++) {
+        bladerf_channel ch = layout_is_tx(layout) ? BLADERF_CHANNEL_TX(i)
+                                                  : BLADERF_CHANNEL_RX(i);
+        int s = bladerf_enable_module(dev, ch, enable);
+        if (s != 0 && status == 0) {
+            status = s;
+        }
+    }
+
+    return status;
+}
+
+/* One direction of a sync run */
+struct sync_job {
+    struct bladerf *dev;
+    const struct bench_params *p;
+    bladerf_channel_layout layout;
+    bladerf_format format;
+    unsigned int n;
+    void *buf;
+    double end;
+
+    struct bladerf_metadata meta;
+    struct bench_result *r;
+    struct latencies *lat;  /* NULL to skip latency collection */
+    double t_end;           /* Time of the last call */
+    int status;
+};
+
+static int sync_job_init(struct sync_job *job, struct bladerf *dev,
+                         const struct bench_params *p,
+                         const struct bench_point *point,
+                         bladerf_channel_layout layout,
+                         struct bench_result *r, struct latencies *lat)
+{
+    int status;
+
+    memset(job, 0, sizeof(*job));
+    job->dev    = dev;
+    job->p      = p;
+    job->layout = layout;
+    job->format = point->format;
+    job->n      = point->samples_per_buffer;
+    job->r      = r;
+    job->lat    = lat;
+
+    job->buf = calloc(job->n, MAX_BYTES_PER_SAMPLE);
+    if (job->buf == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    status = bladerf_sync_config(dev, layout, point->format,
+                                 point->num_buffers, job->n,
+                                 point->num_transfers, p->timeout_ms);
+    if (status != 0) {
+        log_error("Failed to configure sync %s interface: %s\n",
+                  layout_is_tx(layout) ? "TX" : "RX",
+                  bladerf_strerror(status));
+    }
+
+    return status;
+}
+
+static void *sync_job_run(void *arg)
+{
+    struct sync_job *job = arg;
+    const bool tx        = layout_is_tx(job->layout);
+    const bool meta_en   = format_has_meta(job->format);
+    struct bench_result *r = job->r;
+    double t = now_s();
+    int status = 0;
+
+    memset(&job->meta, 0, sizeof(job->meta));
+    if (tx) {
+        job->meta.flags = meta_en ? (BLADERF_META_FLAG_TX_BURST_START |
+                                     BLADERF_META_FLAG_TX_NOW)
+                                  : 0;
+    } else {
+        r->overruns = 0;
+    }
+
+    while (t < job->end) {
+        double t_next;
+
+        if (tx) {
+            status = bladerf_sync_tx(job->dev, job->buf, job->n, &job->meta,
+                                     job->p->timeout_ms);
+            job->meta.flags &= ~(BLADERF_META_FLAG_TX_BURST_START |
+                                 BLADERF_META_FLAG_TX_NOW);
+        } else {
+            job->meta.flags = meta_en ? BLADERF_META_FLAG_RX_NOW : 0;
+            job->meta.status = 0;
+            status = bladerf_sync_rx(job->dev, job->buf, job->n, &job->meta,
+                                     job->p->timeout_ms);
+        }
+
+        t_next = now_s();
+        if (job->lat != NULL) {
+            latencies_add(job->lat, (t_next - t) * 1e6);
+        }
+        t = t_next;
+
+        if (status == BLADERF_ERR_TIMEOUT) {
+            r->timeouts++;
+            continue;
+        } else if (status != 0) {
+            log_error("Sync %s failed: %s\n", tx ? "TX" : "RX",
+                      bladerf_strerror(status));
+            break;
+        }
+
+        if (tx) {
+            r->samples += job->n;
+        } else {
+            r->samples += meta_en ? job->meta.actual_count : job->n;
+            if (job->meta.status & BLADERF_META_STATUS_OVERRUN) {
+                r->overruns++;
+            }
+        }
+    }
+
+    job->t_end  = t;
+    job->status = status;
+    return NULL;
+}
+
+/* Close the burst so the next point starts from an idle TX path */
+static void sync_job_finish(struct sync_job *job)
+{
+    if (layout_is_tx(job->layout) && format_has_meta(job->format) &&
+        job->status == 0) {
+        job->meta.flags = BLADERF_META_FLAG_TX_BURST_END;
+        job->status = bladerf_sync_tx(job->dev, job->buf, job->n, &job->meta,
+                                      job->p->timeout_ms);
+    }
+}
+
+static void run_sync(struct bladerf *dev, const struct bench_params *p,
+                     const struct bench_point *point, struct bench_result *r,
+                     struct latencies *lat)
+{
+    struct sync_job job;
+    double start, cpu_start;
+    int status;
+
+    status = sync_job_init(&job, dev, p, point, point->layout, r, lat);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = enable_channels(dev, point->layout, true);
+    if (status != 0) {
+        log_error("Failed to enable channels: %s\n", bladerf_strerror(status));
+        goto out;
+    }
+
+    cpu_start = cpu_time_s();
+    start     = now_s();
+    job.end   = start + p->duration_ms / 1000.0;
+
+    sync_job_run(&job);
+
+    r->elapsed_s   = job.t_end - start;
+    r->cpu_percent = 100.0 * (cpu_time_s() - cpu_start) / r->elapsed_s;
+
+    sync_job_finish(&job);
+    status = job.status;
+
+out:
+    enable_channels(dev, point->layout, false);
+    r->status = status;
+    free(job.buf);
+}
+
+/* RX and TX at once: TX runs in its own thread, and RX in this one. Latency
+ * is collected for RX calls only. */
+static void run_duplex(struct bladerf *dev, const struct bench_params *p,
+                       const struct bench_point *point, struct bench_result *r,
+                       struct latencies *lat)
+{
+    const bladerf_channel_layout rx_layout = layout_base(point->layout);
+    const bladerf_channel_layout tx_layout = rx_layout | BLADERF_TX;
+    struct sync_job rx, tx;
+    struct bench_result tx_r;
+    pthread_t tx_thread;
+    double start, cpu_start;
+    int status;
+
+    memset(&rx, 0, sizeof(rx));
+    memset(&tx, 0, sizeof(tx));
+    memset(&tx_r, 0, sizeof(tx_r));
+
+    if (point->mode != BENCH_MODE_SYNC) {
+        log_info("Skipping async duplex: only sync is supported\n");
+        r->status = BLADERF_ERR_UNSUPPORTED;
+        return;
+    }
+
+    status = sync_job_init(&rx, dev, p, point, rx_layout, r, lat);
+    if (status == 0) {
+        status = sync_job_init(&tx, dev, p, point, tx_layout, &tx_r, NULL);
+    }
+    if (status != 0) {
+        goto out;
+    }
+
+    status = enable_channels(dev, rx_layout, true);
+    if (status == 0) {
+        status = enable_channels(dev, tx_layout, true);
+    }
+    if (status != 0) {
+        log_error("Failed to enable channels: %s\n", bladerf_strerror(status));
+        goto out;
+    }
+
+    cpu_start = cpu_time_s();
+    start     = now_s();
+    rx.end    = start + p->duration_ms / 1000.0;
+    tx.end    = rx.end;
+
+    if (pthread_create(&tx_thread, NULL, sync_job_run, &tx) != 0) {
+        log_error("Failed to start TX thread\n");
+        status = BLADERF_ERR_UNEXPECTED;
+        goto out;
+    }
+
+    sync_job_run(&rx);
+    pthread_join(tx_thread, NULL);
+
+    r->elapsed_s   = (rx.t_end > tx.t_end ? rx.t_end : tx.t_end) - start;
+    r->cpu_percent = 100.0 * (cpu_time_s() - cpu_start) / r->elapsed_s;
+
+    sync_job_finish(&tx);
+
+    r->rx_samples = r->samples;
+    r->tx_samples = tx_r.samples;
+    r->samples   += tx_r.samples;
+    r->timeouts  += tx_r.timeouts;
+
+    status = (rx.status != 0) ? rx.status : tx.status;
+
+out:
+    enable_channels(dev, tx_layout, false);
+    enable_channels(dev, rx_layout, false);
+    r->status = status;
+    free(rx.buf);
+    free(tx.buf);
+}
+
+struct async_state {
+    void **buffers;
+    size_t num_buffers;
+    size_t idx;
+
+    size_t samples_per_buffer;
+    bool tx;
+
+    double end;
+    double t_last;
+
+    struct bench_result *result;
+    struct latencies *lat;
+};
+
+static void *async_callback(struct bladerf *dev, struct bladerf_stream *stream,
+                            struct bladerf_metadata *meta, void *samples,
+                            size_t num_samples, void *user_data)
+{
+    struct async_state *s = user_data;
+    const double t        = now_s();
+    void *next;
+
+    /* TX is first called with no samples to collect its initial buffers */
+    if (samples != NULL) {
+        latencies_add(s->lat, (t - s->t_last) * 1e6);
+        s->result->samples += s->tx ? s->samples_per_buffer : num_samples;
+    }
+    s->t_last = t;
+
+    if (t >= s->end) {
+        return BLADERF_STREAM_SHUTDOWN;
+    }
+
+    next   = s->buffers[s->idx];
+    s->idx = (s->idx + 1) % s->num_buffers;
+    return next;
+}
+
+static void run_async(struct bladerf *dev, const struct bench_params *p,
+                      const struct bench_point *point, struct bench_result *r,
+                      struct latencies *lat)
+{
+    struct bladerf_stream *stream = NULL;
+    struct async_state s;
+    double start, cpu_start;
+    int status;
+
+    memset(&s, 0, sizeof(s));
+    s.num_buffers        = point->num_buffers;
+    s.samples_per_buffer = point->samples_per_buffer;
+    s.tx                 = layout_is_tx(point->layout);
+    s.result             = r;
+    s.lat                = lat;
+
+    if (s.tx && format_has_meta(point->format)) {
+        /* The async interface expects TX buffers to carry filled-in message
+         * headers, which this benchmark does not generate. */
+        log_info("Skipping async TX with %s: metadata formats are not "
+                 "supported\n", bench_format2str(point->format));
+        r->status = BLADERF_ERR_UNSUPPORTED;
+        return;
+    }
+
+    status = bladerf_init_stream(&stream, dev, async_callback, &s.buffers,
+                                 point->num_buffers, point->format,
+                                 point->samples_per_buffer,
+                                 point->num_transfers, &s);
+    if (status != 0) {
+        log_error("Failed to initialize stream: %s\n",
+                  bladerf_strerror(status));
+        goto out;
+    }
+
+    bladerf_set_stream_timeout(dev, layout_is_tx(point->layout) ? BLADERF_TX
+                                                                : BLADERF_RX,
+                               p->timeout_ms);
+
+    status = enable_channels(dev, point->layout, true);
+    if (status != 0) {
+        log_error("Failed to enable channels: %s\n", bladerf_strerror(status));
+        goto out;
+    }
+
+    cpu_start = cpu_time_s();
+    start     = now_s();
+    s.t_last  = start;
+    s.end     = start + p->duration_ms / 1000.0;
+
+    status = bladerf_stream(stream, point->layout);
+    if (status != 0) {
+        log_error("Stream failed: %s\n", bladerf_strerror(status));
+    }
+
+    r->elapsed_s   = now_s() - start;
+    r->cpu_percent = 100.0 * (cpu_time_s() - cpu_start) / r->elapsed_s;
+
+out:
+    enable_channels(dev, point->layout, false);
+    if (stream != NULL) {
+        bladerf_deinit_stream(stream);
+    }
+    r->status = status;
+}
+
+void bench_run(struct bladerf *dev, const struct bench_params *p,
+               const struct bench_point *point, struct bench_result *result)
+{
+    struct latencies lat;
+
+    memset(result, 0, sizeof(*result));
+    memset(&lat, 0, sizeof(lat));
+    result->overruns = -1;
+
+    if (layout_is_duplex(point->layout)) {
+        run_duplex(dev, p, point, result, &lat);
+    } else if (point->mode == BENCH_MODE_SYNC) {
+        run_sync(dev, p, point, result, &lat);
+    } else {
+        run_async(dev, p, point, result, &lat);
+    }
+
+    if (result->elapsed_s > 0) {
+        result->rate_sps    = result->samples / result->elapsed_s;
+        result->rx_rate_sps = result->rx_samples / result->elapsed_s;
+        result->tx_rate_sps = result->tx_samples / result->elapsed_s;
+    }
+
+    latencies_summarize(&lat, result);
+    free(lat.us);
+}
+
+void bench_print_result(FILE *out, const struct bench_point *point,
+                        const struct bench_result *r)
+{
+    fprintf(out, "    {\n");
+    fprintf(out, "      \"mode\": \"%s\",\n",
+            point->mode == BENCH_MODE_SYNC ? "sync" : "async");
+    fprintf(out, "      \"layout\": \"%s\",\n", bench_layout2str(point->layout));
+    fprintf(out, "      \"format\": \"%s\",\n", bench_format2str(point->format));
+    fprintf(out, "      \"samples_per_buffer\": %u,\n", point->samples_per_buffer);
+    fprintf(out, "      \"num_buffers\": %u,\n", point->num_buffers);
+    fprintf(out, "      \"num_transfers\": %u,\n", point->num_transfers);
+    fprintf(out, "      \"status\": \"%s\",\n",
+            r->status == 0 ? "ok" : bladerf_strerror(r->status));
+    fprintf(out, "      \"samples\": %llu,\n", (unsigned long long)r->samples);
+    fprintf(out, "      \"elapsed_s\": %.6f,\n", r->elapsed_s);
+    fprintf(out, "      \"rate_sps\": %.1f,\n", r->rate_sps);
+
+    if (layout_is_duplex(point->layout)) {
+        fprintf(out, "      \"rx_rate_sps\": %.1f,\n", r->rx_rate_sps);
+        fprintf(out, "      \"tx_rate_sps\": %.1f,\n", r->tx_rate_sps);
+    }
+
+    if (r->overruns < 0) {
+        fprintf(out, "      \"overruns\": null,\n");
+    } else {
+        fprintf(out, "      \"overruns\": %lld,\n", (long long)r->overruns);
+    }
+
+    fprintf(out, "      \"timeouts\": %llu,\n", (unsigned long long)r->timeouts);
+    fprintf(out, "      \"cpu_percent\": %.1f,\n", r->cpu_percent);
+    fprintf(out, "      \"latency_us\": {\n");
+    fprintf(out, "        \"count\": %llu,\n",
+            (unsigned long long)r->latency_count);
+    fprintf(out, "        \"p50\": %.1f,\n", r->latency_p50_us);
+    fprintf(out, "        \"p90\": %.1f,\n", r->latency_p90_us);
+    fprintf(out, "        \"p99\": %.1f,\n", r->latency_p99_us);
+    fprintf(out, "        \"p99.9\": %.1f,\n", r->latency_p999_us);
+    fprintf(out, "        \"max\": %.1f\n", r->latency_max_us);
+    fprintf(out, "      }\n");
+    fprintf(out, "    }");
+}
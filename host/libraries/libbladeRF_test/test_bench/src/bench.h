@@ -0,0 +1,125 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <libbladeRF.h>
+
+/* Sweep defaults */
+#define DEFAULT_SAMPLERATE      10000000
+#define DEFAULT_FREQUENCY       1000000000
+#define DEFAULT_DURATION_MS     2000
+#define DEFAULT_TIMEOUT_MS      1000
+
+/* Upper bound on the per-call latencies kept for percentile computation */
+#define BENCH_MAX_LATENCIES     (1 << 22)
+
+/* Set in a point's layout to run RX and TX together. The rest of the layout
+ * is the RX layout, and TX uses the same number of channels. */
+#define BENCH_LAYOUT_DUPLEX     0x100
+
+typedef enum {
+    BENCH_MODE_SYNC,
+    BENCH_MODE_ASYNC,
+} bench_mode;
+
+/* One point of the sweep */
+struct bench_point {
+    bench_mode mode;
+    bladerf_channel_layout layout;
+    bladerf_format format;
+    unsigned int samples_per_buffer;
+    unsigned int num_buffers;
+    unsigned int num_transfers;
+};
+
+struct bench_result {
+    int status;                 /* 0, or the BLADERF_ERR_* that ended the run */
+
+    uint64_t samples;           /* Samples moved, summed over channels */
+    double elapsed_s;           /* Wall-clock duration of the run */
+    double rate_sps;            /* samples / elapsed_s */
+
+    /* Split of samples and rate_sps between directions, for duplex points */
+    uint64_t rx_samples;
+    uint64_t tx_samples;
+    double rx_rate_sps;
+    double tx_rate_sps;
+
+    /* RX overruns reported through metadata, or -1 if the point's format
+     * and mode cannot report them */
+    int64_t overruns;
+    uint64_t timeouts;          /* Sync calls that returned BLADERF_ERR_TIMEOUT */
+
+    double cpu_percent;         /* Process user + system time over elapsed_s */
+
+    /* Per sync call duration, or the interval between async callbacks */
+    uint64_t latency_count;
+    double latency_p50_us;
+    double latency_p90_us;
+    double latency_p99_us;
+    double latency_p999_us;
+    double latency_max_us;
+};
+
+struct bench_params {
+    const char *device_str;
+    unsigned int samplerate;
+    uint64_t frequency;
+    unsigned int duration_ms;
+    unsigned int timeout_ms;
+};
+
+/**
+ * Run one point of the sweep on an open device.
+ *
+ * The channels used by the point's layout are enabled for the duration of the
+ * run and disabled afterwards.
+ *
+ * @param[in]   dev     Device handle
+ * @param[in]   p       Sweep parameters
+ * @param[in]   point   Stream configuration to run
+ * @param[out]  result  Measurements. result->status holds any error that
+ *                      ended the run early.
+ */
+void bench_run(struct bladerf *dev, const struct bench_params *p,
+               const struct bench_point *point, struct bench_result *result);
+
+/**
+ * Write the JSON object describing one point and its result
+ */
+void bench_print_result(FILE *out, const struct bench_point *point,
+                        const struct bench_result *result);
+
+const char *bench_format2str(bladerf_format format);
+int bench_str2format(const char *str, bladerf_format *format);
+
+const char *bench_layout2str(bladerf_channel_layout layout);
+int bench_str2layout(const char *str, bladerf_channel_layout *layout);
+
+#endif
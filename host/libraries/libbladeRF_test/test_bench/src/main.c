@@ -0,0 +1,524 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <limits.h>
+#include <getopt.h>
+#include <libbladeRF.h>
+
+#include "conversions.h"
+#include "log.h"
+#include "bench.h"
+
+#define MAX_LIST_LEN 16
+
+#define OPTSTR "hd:s:f:t:T:m:l:F:b:n:x:o:"
+static const struct option long_options[] = {
+    { "help",           no_argument,        0,  'h' },
+
+    /* Device configuration */
+    { "device",         required_argument,  0,  'd' },
+    { "samplerate",     required_argument,  0,  's' },
+    { "frequency",      required_argument,  0,  'f' },
+
+    /* Run configuration */
+    { "duration",       required_argument,  0,  't' },
+    { "timeout",        required_argument,  0,  'T' },
+    { "output",         required_argument,  0,  'o' },
+
+    /* Sweep axes */
+    { "modes",          required_argument,  0,  'm' },
+    { "layouts",        required_argument,  0,  'l' },
+    { "formats",        required_argument,  0,  'F' },
+    { "buffer-sizes",   required_argument,  0,  'b' },
+    { "buffer-counts",  required_argument,  0,  'n' },
+    { "num-xfers",      required_argument,  0,  'x' },
+
+    /* Verbosity options */
+    { "verbosity",      required_argument,  0,  1,  },
+    { "lib-verbosity",  required_argument,  0,  2,  },
+    { 0,                0,                  0,  0   },
+};
+
+static const struct numeric_suffix freq_suffixes[] = {
+    { "K",   1000 },
+    { "kHz", 1000 },
+    { "M",   1000000 },
+    { "MHz", 1000000 },
+    { "G",   1000000000 },
+    { "GHz", 1000000000 },
+};
+
+static const unsigned int num_freq_suffixes =
+    sizeof(freq_suffixes) / sizeof(freq_suffixes[0]);
+
+struct sweep {
+    bench_mode modes[MAX_LIST_LEN];
+    size_t num_modes;
+
+    bladerf_channel_layout layouts[MAX_LIST_LEN];
+    size_t num_layouts;
+
+    bladerf_format formats[MAX_LIST_LEN];
+    size_t num_formats;
+
+    unsigned int buffer_sizes[MAX_LIST_LEN];
+    size_t num_buffer_sizes;
+
+    unsigned int buffer_counts[MAX_LIST_LEN];
+    size_t num_buffer_counts;
+
+    unsigned int xfers[MAX_LIST_LEN];
+    size_t num_xfers;
+};
+
+static void print_usage(const char *argv0)
+{
+    printf("Usage: %s [options]\n", argv0);
+    printf("bladeRF-bench: Sweep stream configurations and report sustained\n");
+    printf("rate, overruns, CPU usage and latency as JSON.\n");
+    printf("\n");
+
+    printf("Device configuration options:\n");
+    printf("    -d, --device <device>       Use the specified device. By default,\n");
+    printf("                                any device found will be used.\n");
+    printf("    -s, --samplerate <value>    Sample rate. Default = %u.\n", DEFAULT_SAMPLERATE);
+    printf("    -f, --frequency <value>     Frequency. Default = %u.\n", DEFAULT_FREQUENCY);
+    printf("\n");
+
+    printf("Run configuration options:\n");
+    printf("    -t, --duration <ms>         Time to run each point. Default = %u.\n", DEFAULT_DURATION_MS);
+    printf("    -T, --timeout <ms>          Stream and sync call timeout. Default = %u.\n", DEFAULT_TIMEOUT_MS);
+    printf("    -o, --output <file>         Write JSON results to <file> rather\n");
+    printf("                                than stdout.\n");
+    printf("\n");
+
+    printf("Sweep options (comma-separated lists):\n");
+    printf("    -m, --modes <list>          sync, async. Default = sync,async.\n");
+    printf("    -l, --layouts <list>        rx_x1, rx_x2, tx_x1, tx_x2, duplex_x1,\n");
+    printf("                                duplex_x2. Default = rx_x1,tx_x1.\n");
+    printf("    -F, --formats <list>        sc16q11, sc16q11_meta, sc8q7, sc8q7_meta,\n");
+    printf("                                sc12, sc12_meta, cf32, cf32_meta,\n");
+    printf("                                sc8q7_sc16, sc8q7_sc16_meta, sc8q7_cf32,\n");
+    printf("                                sc8q7_cf32_meta.\n");
+    printf("                                Default = sc16q11,sc16q11_meta.\n");
+    printf("    -b, --buffer-sizes <list>   Samples per buffer. Default = 8192.\n");
+    printf("    -n, --buffer-counts <list>  Number of buffers. Default = 32.\n");
+    printf("    -x, --num-xfers <list>      Number of transfers. Default = 16.\n");
+    printf("\n");
+
+    printf("Misc options:\n");
+    printf("    -h, --help                  Show this help text\n");
+    printf("    --verbosity <level>         Set test verbosity (Default: warning)\n");
+    printf("    --lib-verbosity <level>     Set libbladeRF verbosity (Default: warning)\n");
+    printf("\n");
+
+    printf("Notes:\n");
+    printf("    Every combination of the sweep lists is run, skipping those with\n");
+    printf("    at least as many transfers as buffers.\n");
+    printf("\n");
+    printf("    Latency is the duration of each sync call, or the interval\n");
+    printf("    between async callbacks. Overruns are only reported for sync RX.\n");
+    printf("\n");
+    printf("    Duplex layouts run RX and TX with the same number of channels at\n");
+    printf("    once, in sync mode only. Their results add rx_rate_sps and\n");
+    printf("    tx_rate_sps, and rate_sps is the combined rate.\n");
+    printf("\n");
+}
+
+/* Split a comma-separated list, calling parse() on each entry */
+static int parse_list(const char *str, size_t *count,
+                      int (*parse)(const char *item, size_t idx, void *arg),
+                      void *arg)
+{
+    char item[64];
+    const char *end;
+    size_t len;
+
+    *count = 0;
+
+    do {
+        end = strchr(str, ',');
+        len = (end != NULL) ? (size_t)(end - str) : strlen(str);
+
+        if (len == 0 || len >= sizeof(item) || *count >= MAX_LIST_LEN) {
+            return -1;
+        }
+
+        memcpy(item, str, len);
+        item[len] = '\0';
+
+        if (parse(item, *count, arg) != 0) {
+            return -1;
+        }
+
+        (*count)++;
+        str = end + 1;
+    } while (end != NULL);
+
+    return 0;
+}
+
+static int parse_mode(const char *item, size_t idx, void *arg)
+{
+    bench_mode *modes = arg;
+
+    if (!strcasecmp(item, "sync")) {
+        modes[idx] = BENCH_MODE_SYNC;
+    } else if (!strcasecmp(item, "async")) {
+        modes[idx] = BENCH_MODE_ASYNC;
+    } else {
+        return -1;
+    }
+
+    return 0;
+}
+
+static int parse_layout(const char *item, size_t idx, void *arg)
+{
+    return bench_str2layout(item, &((bladerf_channel_layout *)arg)[idx]);
+}
+
+static int parse_format(const char *item, size_t idx, void *arg)
+{
+    return bench_str2format(item, &((bladerf_format *)arg)[idx]);
+}
+
+static int parse_uint(const char *item, size_t idx, void *arg)
+{
+    bool ok;
+
+    ((unsigned int *)arg)[idx] = str2uint(item, 1, UINT_MAX, &ok);
+    return ok ? 0 : -1;
+}
+
+static void init_sweep(struct sweep *s)
+{
+    memset(s, 0, sizeof(*s));
+
+    s->modes[s->num_modes++]     = BENCH_MODE_SYNC;
+    s->modes[s->num_modes++]     = BENCH_MODE_ASYNC;
+    s->layouts[s->num_layouts++] = BLADERF_RX_X1;
+    s->layouts[s->num_layouts++] = BLADERF_TX_X1;
+    s->formats[s->num_formats++] = BLADERF_FORMAT_SC16_Q11;
+    s->formats[s->num_formats++] = BLADERF_FORMAT_SC16_Q11_META;
+
+    s->buffer_sizes[s->num_buffer_sizes++]   = 8192;
+    s->buffer_counts[s->num_buffer_counts++] = 32;
+    s->xfers[s->num_xfers++]                 = 16;
+}
+
+static int handle_cmdline(int argc, char *argv[], struct bench_params *p,
+                          struct sweep *s, FILE **out)
+{
+    int c;
+    int status;
+    bool ok;
+    bladerf_log_level level;
+
+    memset(p, 0, sizeof(*p));
+    p->samplerate  = DEFAULT_SAMPLERATE;
+    p->frequency   = DEFAULT_FREQUENCY;
+    p->duration_ms = DEFAULT_DURATION_MS;
+    p->timeout_ms  = DEFAULT_TIMEOUT_MS;
+
+    init_sweep(s);
+
+    while ((c = getopt_long(argc, argv, OPTSTR, long_options, NULL)) >= 0) {
+        status = 0;
+
+        switch (c) {
+            case 1:
+            case 2:
+                level = str2loglevel(optarg, &ok);
+                if (!ok) {
+                    log_error("Invalid log level provided: %s\n", optarg);
+                    return -1;
+                } else if (c == 1) {
+                    log_set_verbosity(level);
+                } else {
+                    bladerf_log_set_verbosity(level);
+                }
+                break;
+
+            case 'h':
+                return 1;
+
+            case 'd':
+                p->device_str = optarg;
+                break;
+
+            case 's':
+                p->samplerate = str2uint_suffix(optarg,
+                                                BLADERF_SAMPLERATE_MIN,
+                                                UINT_MAX,
+                                                freq_suffixes,
+                                                num_freq_suffixes,
+                                                &ok);
+                if (!ok) {
+                    log_error("Invalid sample rate: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'f':
+                p->frequency = str2uint64_suffix(optarg, 0, UINT64_MAX,
+                                                 freq_suffixes,
+                                                 num_freq_suffixes,
+                                                 &ok);
+                if (!ok) {
+                    log_error("Invalid frequency: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 't':
+                p->duration_ms = str2uint(optarg, 1, UINT_MAX, &ok);
+                if (!ok) {
+                    log_error("Invalid duration: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'T':
+                p->timeout_ms = str2uint(optarg, 0, UINT_MAX, &ok);
+                if (!ok) {
+                    log_error("Invalid timeout: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'o':
+                if (*out != stdout) {
+                    log_error("Output file already provided.\n");
+                    return -1;
+                }
+
+                *out = fopen(optarg, "w");
+                if (*out == NULL) {
+                    log_error("Failed to open output file - %s\n",
+                              strerror(errno));
+                    *out = stdout;
+                    return -1;
+                }
+                break;
+
+            case 'm':
+                status = parse_list(optarg, &s->num_modes, parse_mode,
+                                    s->modes);
+                break;
+
+            case 'l':
+                status = parse_list(optarg, &s->num_layouts, parse_layout,
+                                    s->layouts);
+                break;
+
+            case 'F':
+                status = parse_list(optarg, &s->num_formats, parse_format,
+                                    s->formats);
+                break;
+
+            case 'b':
+                status = parse_list(optarg, &s->num_buffer_sizes, parse_uint,
+                                    s->buffer_sizes);
+                break;
+
+            case 'n':
+                status = parse_list(optarg, &s->num_buffer_counts, parse_uint,
+                                    s->buffer_counts);
+                break;
+
+            case 'x':
+                status = parse_list(optarg, &s->num_xfers, parse_uint,
+                                    s->xfers);
+                break;
+
+            default:
+                return -1;
+        }
+
+        if (status != 0) {
+            log_error("Invalid list for -%c: %s\n", c, optarg);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int configure_device(struct bladerf *dev, const struct bench_params *p)
+{
+    const bladerf_direction dirs[] = { BLADERF_RX, BLADERF_TX };
+    size_t d, i;
+    int status;
+
+    for (d = 0; d < 2; d++) {
+        for (i = 0; i < bladerf_get_channel_count(dev, dirs[d]); i++) {
+            bladerf_channel ch = (dirs[d] == BLADERF_RX)
+                                     ? BLADERF_CHANNEL_RX(i)
+                                     : BLADERF_CHANNEL_TX(i);
+
+            status = bladerf_set_sample_rate(dev, ch, p->samplerate, NULL);
+            if (status != 0) {
+                log_error("Failed to set %s sample rate: %s\n",
+                          channel2str(ch), bladerf_strerror(status));
+                return status;
+            }
+
+            status = bladerf_set_frequency(dev, ch, p->frequency);
+            if (status != 0) {
+                log_error("Failed to set %s frequency: %s\n",
+                          channel2str(ch), bladerf_strerror(status));
+                return status;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static void print_header(FILE *out, struct bladerf *dev,
+                         const struct bench_params *p)
+{
+    struct bladerf_version lib, fw, fpga;
+
+    bladerf_version(&lib);
+    if (bladerf_fw_version(dev, &fw) != 0) {
+        fw.describe = "unknown";
+    }
+    if (bladerf_fpga_version(dev, &fpga) != 0) {
+        fpga.describe = "unknown";
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"board\": \"%s\",\n", bladerf_get_board_name(dev));
+    fprintf(out, "  \"usb_speed\": \"%s\",\n",
+            devspeed2str(bladerf_device_speed(dev)));
+    fprintf(out, "  \"libbladerf_version\": \"%s\",\n", lib.describe);
+    fprintf(out, "  \"fw_version\": \"%s\",\n", fw.describe);
+    fprintf(out, "  \"fpga_version\": \"%s\",\n", fpga.describe);
+    fprintf(out, "  \"samplerate\": %u,\n", p->samplerate);
+    fprintf(out, "  \"frequency\": %llu,\n", (unsigned long long)p->frequency);
+    fprintf(out, "  \"duration_ms\": %u,\n", p->duration_ms);
+    fprintf(out, "  \"results\": [\n");
+}
+
+static void run_sweep(FILE *out, struct bladerf *dev,
+                      const struct bench_params *p, const struct sweep *s)
+{
+    struct bench_point point;
+    struct bench_result result;
+    size_t m, l, f, b, n, x;
+    bool first = true;
+
+    for (m = 0; m < s->num_modes; m++)
+    for (l = 0; l < s->num_layouts; l++)
+    for (f = 0; f < s->num_formats; f++)
+    for (b = 0; b < s->num_buffer_sizes; b++)
+    for (n = 0; n < s->num_buffer_counts; n++)
+    for (x = 0; x < s->num_xfers; x++) {
+        point.mode               = s->modes[m];
+        point.layout             = s->layouts[l];
+        point.format             = s->formats[f];
+        point.samples_per_buffer = s->buffer_sizes[b];
+        point.num_buffers        = s->buffer_counts[n];
+        point.num_transfers      = s->xfers[x];
+
+        if (point.num_transfers >= point.num_buffers) {
+            log_debug("Skipping %u transfers with %u buffers\n",
+                      point.num_transfers, point.num_buffers);
+            continue;
+        }
+
+        log_info("Running %s %s %s, %u samples x %u buffers, %u transfers\n",
+                 point.mode == BENCH_MODE_SYNC ? "sync" : "async",
+                 bench_layout2str(point.layout),
+                 bench_format2str(point.format), point.samples_per_buffer,
+                 point.num_buffers, point.num_transfers);
+
+        bench_run(dev, p, &point, &result);
+
+        fprintf(out, first ? "" : ",\n");
+        bench_print_result(out, &point, &result);
+        fflush(out);
+        first = false;
+    }
+
+    fprintf(out, "\n");
+}
+
+int main(int argc, char *argv[])
+{
+    int status;
+    struct bladerf *dev = NULL;
+    struct bench_params p;
+    struct sweep s;
+    FILE *out = stdout;
+
+    log_set_verbosity(BLADERF_LOG_LEVEL_WARNING);
+    bladerf_log_set_verbosity(BLADERF_LOG_LEVEL_WARNING);
+
+    status = handle_cmdline(argc, argv, &p, &s, &out);
+    if (status != 0) {
+        if (status > 0) {
+            print_usage(argv[0]);
+            status = 0;
+        } else {
+            status = EXIT_FAILURE;
+        }
+        goto out;
+    }
+
+    status = bladerf_open(&dev, p.device_str);
+    if (status != 0) {
+        log_error("Failed to open device: %s\n", bladerf_strerror(status));
+        status = EXIT_FAILURE;
+        goto out;
+    }
+
+    status = configure_device(dev, &p);
+    if (status != 0) {
+        status = EXIT_FAILURE;
+        goto out;
+    }
+
+    print_header(out, dev, &p);
+    run_sweep(out, dev, &p, &s);
+    fprintf(out, "  ]\n}\n");
+
+out:
+    if (dev != NULL) {
+        bladerf_close(dev);
+    }
+
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    return status;
+}
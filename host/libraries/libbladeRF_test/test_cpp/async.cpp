@@ -0,0 +1,86 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This program is intended to verify that libbladeRF_async.hpp builds, and
+ * that its reactor runs and propagates errors, without a device attached.
+ */
+#include <iostream>
+#include <libbladeRF_async.hpp>
+
+template class bladeRF::async_rx_stream<bladeRF::sc16q11, 1>;
+template class bladeRF::async_rx_stream<bladeRF::sc8q7, 2>;
+template class bladeRF::async_tx_stream<bladeRF::sc16q11, 2>;
+template class bladeRF::async_tx_stream<bladeRF::sc8q7, 1>;
+
+static_assert(!std::is_copy_constructible_v<bladeRF::task>);
+static_assert(std::is_nothrow_move_constructible_v<bladeRF::task>);
+
+static bladeRF::task count(int &n)
+{
+    ++n;
+    co_return;
+}
+
+static bladeRF::task count_twice(int &n)
+{
+    co_await count(n);
+    co_await count(n);
+}
+
+static bladeRF::task fail()
+{
+    throw bladeRF::error("fail", BLADERF_ERR_UNEXPECTED);
+    co_return;
+}
+
+int main()
+{
+    bladeRF::reactor r;
+    int n = 0;
+
+    r.spawn(count_twice(n));
+    r.spawn(count(n));
+    r.run();
+
+    if (n != 3) {
+        std::cout << "Expected 3 task steps, got " << n << std::endl;
+        return 1;
+    }
+
+    r.spawn(fail());
+
+    try {
+        r.run();
+        std::cout << "Task exception was not propagated" << std::endl;
+        return 1;
+    } catch (const bladeRF::error &e) {
+        if (e.code() != BLADERF_ERR_UNEXPECTED) {
+            std::cout << "Unexpected error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Reactor tests passed" << std::endl;
+    return 0;
+}
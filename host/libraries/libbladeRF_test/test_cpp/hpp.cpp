@@ -0,0 +1,61 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This program is intended to verify that libbladeRF.hpp builds, and that
+ * each of its stream types instantiates, without a device attached.
+ */
+#include <iostream>
+#include <libbladeRF.hpp>
+
+template class bladeRF::rx_stream<bladeRF::sc16q11, 1>;
+template class bladeRF::rx_stream<bladeRF::sc16q11, 2>;
+template class bladeRF::rx_stream<bladeRF::sc8q7, 1>;
+template class bladeRF::rx_stream<bladeRF::sc8q7, 2>;
+template class bladeRF::tx_stream<bladeRF::sc16q11, 1>;
+template class bladeRF::tx_stream<bladeRF::sc16q11, 2>;
+template class bladeRF::tx_stream<bladeRF::sc8q7, 1>;
+template class bladeRF::tx_stream<bladeRF::sc8q7, 2>;
+template class bladeRF::rx_buffer<bladeRF::sc16q11, 2>;
+template class bladeRF::rx_buffer<bladeRF::sc8q7, 1>;
+template class bladeRF::tx_buffer<bladeRF::sc16q11, 2>;
+template class bladeRF::tx_buffer<bladeRF::sc8q7, 1>;
+
+static_assert(!std::is_copy_constructible_v<bladeRF::device>);
+static_assert(std::is_nothrow_move_constructible_v<bladeRF::device>);
+static_assert(!std::is_copy_constructible_v<bladeRF::rx_buffer<bladeRF::sc16q11, 1>>);
+static_assert(!std::is_copy_constructible_v<bladeRF::tx_buffer<bladeRF::sc16q11, 1>>);
+
+int main(int argc, char *argv[])
+{
+    try {
+        bladeRF::device dev("nonexistent:serial=0");
+        std::cout << "Unexpectedly opened a device" << std::endl;
+        return 1;
+    } catch (const bladeRF::error &e) {
+        std::cout << "Open failed as expected (" << e.code() << "): "
+                  << e.what() << std::endl;
+    }
+
+    return 0;
+}
@@ -27,6 +27,20 @@ bool quiet   = false;
 size_t const CELL_WIDTH  = 4;
 size_t const NUM_COLUMNS = 8;
 
+#ifdef TEST_ALLOC_TRACKING
+/* The linker's --wrap option routes the malloc() calls made by this
+ * executable, including those of the interleaver built into it, here */
+static size_t alloc_count = 0;
+
+void *__real_malloc(size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    alloc_count++;
+    return __real_malloc(size);
+}
+#endif
+
 /* Creates a buffer of buflen bytes, containing a counting pattern */
 void *create_buf(size_t buflen)
 {
@@ -67,6 +81,41 @@ bool check_buf(void const *buf,
     }
 
     for (i = 0; i < buflen / samplesize; i += stride) {
+        if (samplesize == sizeof(uint16_t)) {
+            /* SC8Q7: one 16-bit word per sample */
+            uint16_t const *ptr16 = (uint16_t const *)buf + i;
+
+            expect = count++;
+
+            if (expect != *ptr16) {
+                PRINT_ERROR("%p = %04x instead of %04x\n", ptr16, *ptr16,
+                            expect);
+                retval = false;
+            } else {
+                PRINT_VERBOSE("%p = %04x ok\n", ptr16, *ptr16);
+            }
+
+            continue;
+        }
+
+        if (samplesize == 2 * sizeof(uint32_t)) {
+            /* CF32: four 16-bit words of the pattern per sample */
+            uint16_t const *ptr16 = (uint16_t const *)buf + 4 * i;
+            size_t j;
+
+            for (j = 0; j < 4; j++) {
+                expect = count++;
+
+                if (expect != ptr16[j]) {
+                    PRINT_ERROR("%p = %04x instead of %04x\n", &ptr16[j],
+                                ptr16[j], expect);
+                    retval = false;
+                }
+            }
+
+            continue;
+        }
+
         ptr = (uint32_t *)buf + i;
 
         count %= 65536;
@@ -282,6 +331,147 @@ error:
     return status;
 }
 
+/* Executes an out-of-place deinterleave test case with channel layout rxlay,
+ * expecting num_samples in format */
+int test_to(bladerf_channel_layout rxlay,
+            bladerf_format format,
+            size_t num_samples)
+{
+    void *buf;
+    void *dest[2] = { NULL, NULL };
+    int status    = 0;
+    size_t i;
+
+    size_t const samplesize = _interleave_calc_bytes_per_sample(format);
+    size_t const offset     = _interleave_calc_metadata_bytes(format);
+    size_t const num_chan   = _interleave_calc_num_channels(rxlay);
+    size_t const bytes      = samplesize * num_samples;
+    size_t const chbytes    = (bytes - offset) / num_chan;
+
+    PRINT_INFO("beginning out-of-place test: rxlay = %d, format = %d, "
+               "num_samples = %zu\n",
+               rxlay, format, num_samples);
+
+    buf = create_buf(bytes);
+    if (NULL == buf) {
+        PRINT_ERROR("failed to create_buf\n");
+        return -1;
+    }
+
+    status = _interleave_interleave_buf(rxlay == BLADERF_RX_X2 ? BLADERF_TX_X2
+                                                               : BLADERF_TX_X1,
+                                        format, (unsigned int)num_samples, buf);
+    if (status != 0) {
+        PRINT_ERROR("interleaver returned %d\n", status);
+        goto error;
+    }
+
+    for (i = 0; i < num_chan; ++i) {
+        dest[i] = calloc(1, chbytes);
+        if (NULL == dest[i]) {
+            PRINT_ERROR("failed to allocate dest[%zu]\n", i);
+            status = -1;
+            goto error;
+        }
+    }
+
+    status = _interleave_deinterleave_buf_to(rxlay, format,
+                                             (unsigned int)num_samples, buf,
+                                             dest);
+    if (status != 0) {
+        PRINT_ERROR("deinterleaver returned %d\n", status);
+        goto error;
+    }
+
+    for (i = 0; i < num_chan; ++i) {
+        uint16_t startval = ((offset + i * chbytes) / 2) % 65536;
+
+        PRINT_INFO("checking deinterleaved data for ch %zu... ", i);
+
+        if (!check_buf(dest[i], chbytes, samplesize, 1, startval)) {
+            PRINT_ERROR("check_buf returned FALSE!\n");
+            status = -1;
+            goto error;
+        } else {
+            PRINT_INFO("good!\n");
+        }
+    }
+
+error:
+    for (i = 0; i < num_chan; ++i) {
+        free(dest[i]);
+    }
+
+    free(buf);
+    return status;
+}
+
+/* Checks that repeatedly (de)interleaving buffers of num_samples in format,
+ * in place, does not allocate once the first buffer has been handled */
+int test_steady_state(bladerf_format format, size_t num_samples)
+{
+#ifdef TEST_ALLOC_TRACKING
+    size_t const samplesize = _interleave_calc_bytes_per_sample(format);
+    size_t const bytes      = samplesize * num_samples;
+    size_t const ITERATIONS = 16;
+    size_t allocs           = 0;
+    void *buf;
+    int status = 0;
+    size_t i;
+
+    PRINT_INFO("beginning steady-state allocation test: format = %d, "
+               "num_samples = %zu\n",
+               format, num_samples);
+
+    buf = create_buf(bytes);
+    if (NULL == buf) {
+        PRINT_ERROR("failed to create_buf\n");
+        return -1;
+    }
+
+    for (i = 0; i <= ITERATIONS; ++i) {
+        /* The first iteration may set up scratch space */
+        if (i == 1) {
+            allocs = alloc_count;
+        }
+
+        status = _interleave_interleave_buf(BLADERF_TX_X2, format,
+                                            (unsigned int)num_samples, buf);
+        if (status == 0) {
+            status = _interleave_deinterleave_buf(
+                BLADERF_RX_X2, format, (unsigned int)num_samples, buf);
+        }
+
+        if (status != 0) {
+            PRINT_ERROR("(de)interleaver returned %d\n", status);
+            goto error;
+        }
+    }
+
+    if (alloc_count != allocs) {
+        PRINT_ERROR("%zu allocations in %zu steady-state iterations\n",
+                    alloc_count - allocs, ITERATIONS);
+        status = -1;
+        goto error;
+    }
+
+    if (!check_buf(buf, bytes, samplesize, 1, 0)) {
+        PRINT_ERROR("check_buf returned FALSE!\n");
+        status = -1;
+    } else {
+        PRINT_INFO("good!\n");
+    }
+
+error:
+    free(buf);
+    return status;
+#else
+    PRINT_INFO("skipping steady-state allocation test: malloc() cannot be "
+               "tracked on this platform\n");
+    return 0;
+#endif
+}
+
 /* it's main */
 int main(int argc, char *argv[])
 {
@@ -316,6 +506,76 @@ int main(int argc, char *argv[])
         goto error;
     }
 
+    status = test(BLADERF_RX_X2, BLADERF_TX_X2, BLADERF_FORMAT_SC8_Q7,
+                  NUM_SAMPLES);
+    if (status < 0) {
+        goto error;
+    }
+
+    status = test(BLADERF_RX_X2, BLADERF_TX_X2, BLADERF_FORMAT_SC8_Q7_META,
+                  NUM_SAMPLES);
+    if (status < 0) {
+        goto error;
+    }
+
+    status = test(BLADERF_RX_X2, BLADERF_TX_X2, BLADERF_FORMAT_CF32,
+                  NUM_SAMPLES);
+    if (status < 0) {
+        goto error;
+    }
+
+    /* Odd-sized buffers exercise the non-vectorized tails */
+    status = test(BLADERF_RX_X2, BLADERF_TX_X2, BLADERF_FORMAT_SC16_Q11,
+                  NUM_SAMPLES + 6);
+    if (status < 0) {
+        goto error;
+    }
+
+    PRINT_INFO("*** BEGINNING OUT-OF-PLACE TESTS\n");
+
+    status = test_to(BLADERF_RX_X1, BLADERF_FORMAT_SC16_Q11, NUM_SAMPLES);
+    if (status < 0) {
+        goto error;
+    }
+
+    status = test_to(BLADERF_RX_X2, BLADERF_FORMAT_SC16_Q11, NUM_SAMPLES);
+    if (status < 0) {
+        goto error;
+    }
+
+    status = test_to(BLADERF_RX_X2, BLADERF_FORMAT_SC16_Q11_META,
+                     NUM_SAMPLES);
+    if (status < 0) {
+        goto error;
+    }
+
+    status = test_to(BLADERF_RX_X2, BLADERF_FORMAT_SC8_Q7, NUM_SAMPLES);
+    if (status < 0) {
+        goto error;
+    }
+
+    status = test_to(BLADERF_RX_X2, BLADERF_FORMAT_SC8_Q7_META, NUM_SAMPLES);
+    if (status < 0) {
+        goto error;
+    }
+
+    status = test_to(BLADERF_RX_X2, BLADERF_FORMAT_CF32, NUM_SAMPLES);
+    if (status < 0) {
+        goto error;
+    }
+
+    PRINT_INFO("*** BEGINNING STEADY-STATE ALLOCATION TESTS\n");
+
+    status = test_steady_state(BLADERF_FORMAT_SC16_Q11, NUM_SAMPLES);
+    if (status < 0) {
+        goto error;
+    }
+
+    status = test_steady_state(BLADERF_FORMAT_SC16_Q11_META, NUM_SAMPLES);
+    if (status < 0) {
+        goto error;
+    }
+
 error:
     if (status < 0) {
         PRINT_ERROR("test returned %d, failing\n", status);
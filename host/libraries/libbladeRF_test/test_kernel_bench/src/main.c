@@ -0,0 +1,681 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* Times the sample format kernels used by the sync interface: channel
+ * (de)interleaving, host-side format conversions, RX corrections and
+ * sample statistics, across buffer sizes.
+ *
+ * Those kernels select their SIMD implementation at compile time, so this
+ * program is built once per level (see CMakeLists.txt), with
+ * KERNEL_BENCH_LEVEL naming the level it was built for. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <getopt.h>
+#include <libbladeRF.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#   include <x86intrin.h>
+#   define KERNEL_BENCH_TSC
+#endif
+
+#include "conversions.h"
+#include "log.h"
+#include "test_common.h"
+
+#include "helpers/interleave.h"
+#include "streaming/convert.h"
+#include "streaming/correction.h"
+#include "streaming/sample_stats.h"
+
+#ifndef KERNEL_BENCH_LEVEL
+#   define KERNEL_BENCH_LEVEL "default"
+#endif
+
+#define MAX_SIZES           16
+#define DEFAULT_TRIAL_MS    20
+#define NUM_TRIALS          5
+
+/* Largest number of bytes per I/Q sample of any kernel's input or output */
+#define MAX_BYTES_PER_SAMPLE 8
+
+#define OPTSTR "hs:k:g:t:o:"
+static const struct option long_options[] = {
+    { "help",           no_argument,        0,  'h' },
+    { "sizes",          required_argument,  0,  's' },
+    { "kernels",        required_argument,  0,  'k' },
+    { "cpu-ghz",        required_argument,  0,  'g' },
+    { "trial-time",     required_argument,  0,  't' },
+    { "output",         required_argument,  0,  'o' },
+
+    /* Verbosity options */
+    { "verbosity",      required_argument,  0,  1,  },
+    { 0,                0,                  0,  0   },
+};
+
+/* Buffers shared by the kernels. Each input holds max_samples valid samples
+ * of its format. */
+struct buffers {
+    int16_t *sc16;
+    int8_t *sc8;
+    uint8_t *sc12;
+    float *cf32;
+    void *out;
+    void *inplace;              /* Scratch for in-place kernels */
+
+    struct corr_coeffs corr[2];
+    struct sample_stats stats;
+};
+
+struct kernel {
+    const char *name;
+    size_t in_bytes;            /* Bytes read per I/Q sample */
+    size_t out_bytes;           /* Bytes written per I/Q sample */
+    void (*run)(struct buffers *b, size_t n);
+};
+
+/* Two-channel kernels process n samples in total, n / 2 per channel */
+
+static void run_deinterleave2_sc8(struct buffers *b, size_t n)
+{
+    uint8_t *out = b->out;
+    _interleave_deinterleave2(2, b->sc8, out, out + n, n / 2);
+}
+
+static void run_interleave2_sc8(struct buffers *b, size_t n)
+{
+    const uint8_t *in = (const uint8_t *)b->sc8;
+    _interleave_interleave2(2, in, in + n, b->out, n / 2);
+}
+
+static void run_deinterleave2_sc16(struct buffers *b, size_t n)
+{
+    uint8_t *out = b->out;
+    _interleave_deinterleave2(4, b->sc16, out, out + 2 * n, n / 2);
+}
+
+static void run_interleave2_sc16(struct buffers *b, size_t n)
+{
+    const uint8_t *in = (const uint8_t *)b->sc16;
+    _interleave_interleave2(4, in, in + 2 * n, b->out, n / 2);
+}
+
+static void run_deinterleave2_cf32(struct buffers *b, size_t n)
+{
+    uint8_t *out = b->out;
+    _interleave_deinterleave2(8, b->cf32, out, out + 4 * n, n / 2);
+}
+
+static void run_interleave2_cf32(struct buffers *b, size_t n)
+{
+    const uint8_t *in = (const uint8_t *)b->cf32;
+    _interleave_interleave2(8, in, in + 4 * n, b->out, n / 2);
+}
+
+static void run_deinterleave_buf_sc16(struct buffers *b, size_t n)
+{
+    _interleave_deinterleave_buf(BLADERF_RX_X2, BLADERF_FORMAT_SC16_Q11,
+                                 (unsigned int)n, b->inplace);
+}
+
+static void run_interleave_buf_sc16(struct buffers *b, size_t n)
+{
+    _interleave_interleave_buf(BLADERF_TX_X2, BLADERF_FORMAT_SC16_Q11,
+                               (unsigned int)n, b->inplace);
+}
+
+static void run_sc16_to_cf32(struct buffers *b, size_t n)
+{
+    convert_sc16q11_to_cf32(b->sc16, b->out, n);
+}
+
+static void run_cf32_to_sc16(struct buffers *b, size_t n)
+{
+    convert_cf32_to_sc16q11(b->cf32, b->out, n);
+}
+
+static void run_sc12_to_sc16(struct buffers *b, size_t n)
+{
+    convert_sc12_to_sc16q11(b->sc12, b->out, n);
+}
+
+static void run_sc16_to_sc12(struct buffers *b, size_t n)
+{
+    convert_sc16q11_to_sc12(b->sc16, b->out, n);
+}
+
+static void run_sc8_to_sc16(struct buffers *b, size_t n)
+{
+    convert_sc8q7_to_sc16q11(b->sc8, b->out, n);
+}
+
+static void run_sc16_to_sc8(struct buffers *b, size_t n)
+{
+    convert_sc16q11_to_sc8q7(b->sc16, b->out, n);
+}
+
+static void run_sc8_to_cf32(struct buffers *b, size_t n)
+{
+    convert_sc8q7_to_cf32(b->sc8, b->out, n);
+}
+
+static void run_cf32_to_sc8(struct buffers *b, size_t n)
+{
+    convert_cf32_to_sc8q7(b->cf32, b->out, n);
+}
+
+static void run_correction_x1(struct buffers *b, size_t n)
+{
+    host_corr_sc16q11(b->sc16, b->out, n, b->corr, 1, 0);
+}
+
+static void run_correction_x2(struct buffers *b, size_t n)
+{
+    host_corr_sc16q11(b->sc16, b->out, n, b->corr, 2, 0);
+}
+
+static void run_stats_x1(struct buffers *b, size_t n)
+{
+    sample_stats_sc16(&b->stats, b->sc16, NULL, n, 1, 0, 2047);
+}
+
+static void run_stats_copy_x1(struct buffers *b, size_t n)
+{
+    sample_stats_sc16(&b->stats, b->sc16, b->out, n, 1, 0, 2047);
+}
+
+static void run_stats_copy_x2(struct buffers *b, size_t n)
+{
+    sample_stats_sc16(&b->stats, b->sc16, b->out, n, 2, 0, 2047);
+}
+
+static const struct kernel kernels[] = {
+    { "deinterleave2_sc8",      2, 2, run_deinterleave2_sc8 },
+    { "interleave2_sc8",        2, 2, run_interleave2_sc8 },
+    { "deinterleave2_sc16",     4, 4, run_deinterleave2_sc16 },
+    { "interleave2_sc16",       4, 4, run_interleave2_sc16 },
+    { "deinterleave2_cf32",     8, 8, run_deinterleave2_cf32 },
+    { "interleave2_cf32",       8, 8, run_interleave2_cf32 },
+    { "deinterleave_buf_sc16",  4, 4, run_deinterleave_buf_sc16 },
+    { "interleave_buf_sc16",    4, 4, run_interleave_buf_sc16 },
+    { "sc16_to_cf32",           4, 8, run_sc16_to_cf32 },
+    { "cf32_to_sc16",           8, 4, run_cf32_to_sc16 },
+    { "sc12_to_sc16",           3, 4, run_sc12_to_sc16 },
+    { "sc16_to_sc12",           4, 3, run_sc16_to_sc12 },
+    { "sc8_to_sc16",            2, 4, run_sc8_to_sc16 },
+    { "sc16_to_sc8",            4, 2, run_sc16_to_sc8 },
+    { "sc8_to_cf32",            2, 8, run_sc8_to_cf32 },
+    { "cf32_to_sc8",            8, 2, run_cf32_to_sc8 },
+    { "correction_x1",          4, 4, run_correction_x1 },
+    { "correction_x2",          4, 4, run_correction_x2 },
+    { "stats_x1",               4, 0, run_stats_x1 },
+    { "stats_copy_x1",          4, 4, run_stats_copy_x1 },
+    { "stats_copy_x2",          4, 4, run_stats_copy_x2 },
+};
+
+#define NUM_KERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+struct params {
+    unsigned int sizes[MAX_SIZES];
+    size_t num_sizes;
+    const char *kernels;        /* Comma-separated names, or NULL for all */
+    double cpu_ghz;             /* 0 if unknown */
+    const char *ghz_source;
+    unsigned int trial_ms;
+};
+
+static void print_usage(const char *argv0)
+{
+    printf("Usage: %s [options]\n", argv0);
+    printf("Time the sample format kernels built for the \"%s\" level, and\n",
+           KERNEL_BENCH_LEVEL);
+    printf("report their throughput as JSON.\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("    -s, --sizes <list>          Comma-separated buffer sizes, in samples.\n");
+    printf("                                Default = 256,4096,65536,1048576.\n");
+    printf("    -k, --kernels <list>        Comma-separated kernels to run.\n");
+    printf("                                Default = all.\n");
+    printf("    -g, --cpu-ghz <value>       CPU clock, for cycles per sample. By\n");
+    printf("                                default, the TSC rate is used on x86,\n");
+    printf("                                and cycles are not reported elsewhere.\n");
+    printf("    -t, --trial-time <ms>       Minimum duration of each of the %u\n", NUM_TRIALS);
+    printf("                                timed trials. Default = %u.\n", DEFAULT_TRIAL_MS);
+    printf("    -o, --output <file>         Write JSON results to <file> rather\n");
+    printf("                                than stdout.\n");
+    printf("    -h, --help                  Show this help text\n");
+    printf("    --verbosity <level>         Set test verbosity (Default: warning)\n");
+    printf("\n");
+    printf("Kernels:\n");
+    for (size_t i = 0; i < NUM_KERNELS; i++) {
+        printf("    %s\n", kernels[i].name);
+    }
+    printf("\n");
+    printf("Notes:\n");
+    printf("    Throughput is bytes read plus bytes written per second. The\n");
+    printf("    fastest trial is reported. Two-channel kernels process the\n");
+    printf("    buffer size in total, half per channel.\n");
+    printf("\n");
+    printf("    On x86, TSC cycles run at a fixed rate, which differs from the\n");
+    printf("    core clock under frequency scaling. Pass --cpu-ghz to use a\n");
+    printf("    fixed core clock instead.\n");
+    printf("\n");
+}
+
+static int parse_sizes(const char *str, struct params *p)
+{
+    char item[32];
+    const char *end;
+    size_t len;
+    bool ok;
+
+    p->num_sizes = 0;
+
+    do {
+        end = strchr(str, ',');
+        len = (end != NULL) ? (size_t)(end - str) : strlen(str);
+
+        if (len == 0 || len >= sizeof(item) || p->num_sizes >= MAX_SIZES) {
+            return -1;
+        }
+
+        memcpy(item, str, len);
+        item[len] = '\0';
+
+        /* Even, so that two-channel kernels split the buffer evenly */
+        p->sizes[p->num_sizes] = str2uint(item, 2, UINT_MAX / 2, &ok);
+        if (!ok || (p->sizes[p->num_sizes] % 2) != 0) {
+            return -1;
+        }
+
+        p->num_sizes++;
+        str = end + 1;
+    } while (end != NULL);
+
+    return 0;
+}
+
+static bool kernel_selected(const struct params *p, const char *name)
+{
+    const char *s = p->kernels;
+    const size_t len = strlen(name);
+
+    if (s == NULL) {
+        return true;
+    }
+
+    while (s != NULL) {
+        if (!strncmp(s, name, len) && (s[len] == ',' || s[len] == '\0')) {
+            return true;
+        }
+
+        s = strchr(s, ',');
+        if (s != NULL) {
+            s++;
+        }
+    }
+
+    return false;
+}
+
+static int handle_cmdline(int argc, char *argv[], struct params *p,
+                          FILE **out)
+{
+    int c;
+    bool ok;
+    bladerf_log_level level;
+    size_t i;
+
+    memset(p, 0, sizeof(*p));
+    p->sizes[p->num_sizes++] = 256;
+    p->sizes[p->num_sizes++] = 4096;
+    p->sizes[p->num_sizes++] = 65536;
+    p->sizes[p->num_sizes++] = 1048576;
+    p->trial_ms              = DEFAULT_TRIAL_MS;
+
+    while ((c = getopt_long(argc, argv, OPTSTR, long_options, NULL)) >= 0) {
+        switch (c) {
+            case 1:
+                level = str2loglevel(optarg, &ok);
+                if (!ok) {
+                    log_error("Invalid log level provided: %s\n", optarg);
+                    return -1;
+                }
+                log_set_verbosity(level);
+                break;
+
+            case 'h':
+                return 1;
+
+            case 's':
+                if (parse_sizes(optarg, p) != 0) {
+                    log_error("Invalid size list: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'k':
+                p->kernels = optarg;
+                break;
+
+            case 'g':
+                p->cpu_ghz = str2double(optarg, 0.001, 100.0, &ok);
+                if (!ok) {
+                    log_error("Invalid CPU clock: %s\n", optarg);
+                    return -1;
+                }
+                p->ghz_source = "user";
+                break;
+
+            case 't':
+                p->trial_ms = str2uint(optarg, 1, UINT_MAX, &ok);
+                if (!ok) {
+                    log_error("Invalid trial time: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'o':
+                if (*out != stdout) {
+                    log_error("Output file already provided.\n");
+                    return -1;
+                }
+
+                *out = fopen(optarg, "w");
+                if (*out == NULL) {
+                    log_error("Failed to open output file - %s\n",
+                              strerror(errno));
+                    *out = stdout;
+                    return -1;
+                }
+                break;
+
+            default:
+                return -1;
+        }
+    }
+
+    for (i = 0; i < NUM_KERNELS; i++) {
+        if (kernel_selected(p, kernels[i].name)) {
+            return 0;
+        }
+    }
+
+    log_error("No known kernels in: %s\n", p->kernels);
+    return -1;
+}
+
+static inline double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+#ifdef KERNEL_BENCH_TSC
+/* Rate of the TSC, in GHz */
+static double tsc_ghz(void)
+{
+    const double start_ns = now_ns();
+    const uint64_t start  = __rdtsc();
+    double ns;
+
+    do {
+        ns = now_ns() - start_ns;
+    } while (ns < 50e6);
+
+    return (double)(__rdtsc() - start) / ns;
+}
+#endif
+
+static void *alloc_buf(size_t bytes)
+{
+    void *buf = NULL;
+
+    /* Aligned as DMA buffers typically are, so that SIMD loads are too */
+    if (posix_memalign(&buf, 4096, bytes) != 0) {
+        return NULL;
+    }
+
+    return buf;
+}
+
+static int init_buffers(struct buffers *b, size_t max_samples)
+{
+    uint64_t state;
+    size_t i;
+
+    memset(b, 0, sizeof(*b));
+    randval_init(&state, 0x1234567887654321ULL);
+
+    b->sc16    = alloc_buf(max_samples * 4);
+    b->sc8     = alloc_buf(max_samples * 2);
+    b->sc12    = alloc_buf(max_samples * 3);
+    b->cf32    = alloc_buf(max_samples * 8);
+    b->out     = alloc_buf(max_samples * MAX_BYTES_PER_SAMPLE);
+    b->inplace = alloc_buf(max_samples * 4);
+
+    if (b->sc16 == NULL || b->sc8 == NULL || b->sc12 == NULL ||
+        b->cf32 == NULL || b->out == NULL || b->inplace == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    /* Full-scale values, so that saturation paths are taken occasionally */
+    for (i = 0; i < 2 * max_samples; i++) {
+        const uint64_t r = randval_update(&state);
+
+        b->sc16[i] = (int16_t)((int)(r & 0xfff) - 2048);
+        b->sc8[i]  = (int8_t)(r >> 16);
+        b->cf32[i] = (float)((int)((r >> 24) & 0xffff) - 32768) / 30000.0f;
+    }
+
+    for (i = 0; i < 3 * max_samples; i++) {
+        b->sc12[i] = (uint8_t)randval_update(&state);
+    }
+
+    memcpy(b->inplace, b->sc16, max_samples * 4);
+
+    for (i = 0; i < 2; i++) {
+        b->corr[i].dc_i = 12;
+        b->corr[i].dc_q = -7;
+        b->corr[i].gain = 41;
+        b->corr[i].tan  = -23;
+    }
+
+    sample_stats_reset(&b->stats);
+    return 0;
+}
+
+static void free_buffers(struct buffers *b)
+{
+    free(b->sc16);
+    free(b->sc8);
+    free(b->sc12);
+    free(b->cf32);
+    free(b->out);
+    free(b->inplace);
+}
+
+/* Time a kernel over n samples, returning the fastest ns per call */
+static double time_kernel(const struct kernel *k, struct buffers *b, size_t n,
+                          unsigned int trial_ms)
+{
+    const double trial_ns = trial_ms * 1e6;
+    double best = 0, start, elapsed;
+    uint64_t reps = 1, i;
+    unsigned int t;
+
+    /* Warm the caches, then find a repetition count that fills a trial */
+    k->run(b, n);
+
+    for (;;) {
+        start = now_ns();
+        for (i = 0; i < reps; i++) {
+            k->run(b, n);
+        }
+        elapsed = now_ns() - start;
+
+        if (elapsed >= trial_ns || reps >= (UINT64_MAX >> 1)) {
+            break;
+        }
+
+        reps *= 2;
+    }
+
+    best = elapsed / reps;
+
+    for (t = 1; t < NUM_TRIALS; t++) {
+        start = now_ns();
+        for (i = 0; i < reps; i++) {
+            k->run(b, n);
+        }
+        elapsed = (now_ns() - start) / reps;
+
+        if (elapsed < best) {
+            best = elapsed;
+        }
+    }
+
+    return best;
+}
+
+static void run(FILE *out, const struct params *p, struct buffers *b)
+{
+    bool first = true;
+    size_t i, s;
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"level\": \"%s\",\n", KERNEL_BENCH_LEVEL);
+    if (p->cpu_ghz > 0) {
+        fprintf(out, "  \"cpu_ghz\": %.3f,\n", p->cpu_ghz);
+        fprintf(out, "  \"cpu_ghz_source\": \"%s\",\n", p->ghz_source);
+    } else {
+        fprintf(out, "  \"cpu_ghz\": null,\n");
+    }
+    fprintf(out, "  \"results\": [\n");
+
+    for (i = 0; i < NUM_KERNELS; i++) {
+        const struct kernel *k = &kernels[i];
+
+        if (!kernel_selected(p, k->name)) {
+            continue;
+        }
+
+        for (s = 0; s < p->num_sizes; s++) {
+            const size_t n  = p->sizes[s];
+            const double ns = time_kernel(k, b, n, p->trial_ms);
+            const double per_sample = ns / n;
+            const double bytes = (double)(k->in_bytes + k->out_bytes) * n;
+
+            log_info("%s, %zu samples: %.3f ns/sample\n", k->name, n,
+                     per_sample);
+
+            fprintf(out, first ? "" : ",\n");
+            fprintf(out, "    {\n");
+            fprintf(out, "      \"kernel\": \"%s\",\n", k->name);
+            fprintf(out, "      \"samples\": %zu,\n", n);
+            fprintf(out, "      \"ns_per_sample\": %.4f,\n", per_sample);
+            fprintf(out, "      \"gb_per_s\": %.3f,\n", bytes / ns);
+            if (p->cpu_ghz > 0) {
+                fprintf(out, "      \"cycles_per_sample\": %.3f\n",
+                        per_sample * p->cpu_ghz);
+            } else {
+                fprintf(out, "      \"cycles_per_sample\": null\n");
+            }
+            fprintf(out, "    }");
+            fflush(out);
+            first = false;
+        }
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+}
+
+int main(int argc, char *argv[])
+{
+    int status;
+    struct params p;
+    struct buffers b;
+    FILE *out = stdout;
+    unsigned int max_samples = 0;
+    size_t i;
+
+    log_set_verbosity(BLADERF_LOG_LEVEL_WARNING);
+
+    status = handle_cmdline(argc, argv, &p, &out);
+    if (status != 0) {
+        if (status > 0) {
+            print_usage(argv[0]);
+            status = 0;
+        } else {
+            status = EXIT_FAILURE;
+        }
+        goto out;
+    }
+
+#ifdef KERNEL_BENCH_CPU_FEATURE
+    /* Building for a level does not mean this CPU supports it */
+    if (!__builtin_cpu_supports(KERNEL_BENCH_CPU_FEATURE)) {
+        log_warning("This CPU lacks %s; skipping the \"%s\" level\n",
+                    KERNEL_BENCH_CPU_FEATURE, KERNEL_BENCH_LEVEL);
+        status = 0;
+        goto out;
+    }
+#endif
+
+#ifdef KERNEL_BENCH_TSC
+    if (p.cpu_ghz == 0) {
+        p.cpu_ghz    = tsc_ghz();
+        p.ghz_source = "tsc";
+    }
+#endif
+
+    for (i = 0; i < p.num_sizes; i++) {
+        if (p.sizes[i] > max_samples) {
+            max_samples = p.sizes[i];
+        }
+    }
+
+    status = init_buffers(&b, max_samples);
+    if (status == 0) {
+        run(out, &p, &b);
+    } else {
+        log_error("Failed to allocate buffers\n");
+        status = EXIT_FAILURE;
+    }
+
+    free_buffers(&b);
+
+out:
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    return status;
+}
@@ -0,0 +1,150 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include "baseline.h"
+#include "log.h"
+
+static const struct perf_baseline *find(const struct perf_baselines *b,
+                                        const char *name)
+{
+    size_t i;
+
+    for (i = 0; i < b->count; i++) {
+        if (!strcmp(b->entries[i].name, name)) {
+            return &b->entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+int baselines_load(const char *path, struct perf_baselines *baselines)
+{
+    char line[256];
+    unsigned int lineno = 0;
+    FILE *f;
+
+    memset(baselines, 0, sizeof(*baselines));
+
+    f = fopen(path, "r");
+    if (f == NULL) {
+        if (errno == ENOENT) {
+            log_warning("No baseline file at %s\n", path);
+            return 0;
+        }
+
+        log_error("Failed to open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), f) != NULL) {
+        struct perf_baseline *e = &baselines->entries[baselines->count];
+        char *p = line;
+
+        lineno++;
+
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+
+        if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') {
+            continue;
+        }
+
+        if (baselines->count >= PERF_MAX_METRICS) {
+            log_error("%s:%u: Too many baselines\n", path, lineno);
+            fclose(f);
+            return -1;
+        }
+
+        if (sscanf(p, "%95s %lf %lf", e->name, &e->value, &e->tolerance) != 3 ||
+            e->tolerance < 0) {
+            log_error("%s:%u: Expected <metric> <value> <tolerance>\n",
+                      path, lineno);
+            fclose(f);
+            return -1;
+        }
+
+        baselines->count++;
+    }
+
+    fclose(f);
+    return 0;
+}
+
+int baselines_save(const char *path, const struct perf_baselines *old,
+                   const struct perf_metric *metrics, size_t count)
+{
+    FILE *f;
+    size_t i;
+
+    f = fopen(path, "w");
+    if (f == NULL) {
+        log_error("Failed to open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    fprintf(f, "# Written by libbladeRF_test_perf_regression --update.\n");
+    fprintf(f, "# <metric> <baseline> <tolerance>\n");
+    fprintf(f, "#\n");
+    fprintf(f, "# Tolerances are the fractional change for the worse that is\n");
+    fprintf(f, "# permitted before a metric fails, and may be edited by hand.\n");
+
+    for (i = 0; i < count; i++) {
+        const struct perf_baseline *e =
+            (old != NULL) ? find(old, metrics[i].name) : NULL;
+
+        fprintf(f, "%-48s %-14.6g %.2f\n", metrics[i].name, metrics[i].value,
+                (e != NULL) ? e->tolerance : PERF_DEFAULT_TOLERANCE);
+    }
+
+    if (fclose(f) != 0) {
+        log_error("Failed to write %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    return 0;
+}
+
+perf_verdict baselines_check(const struct perf_baselines *baselines,
+                             const struct perf_metric *metric, double *limit)
+{
+    const struct perf_baseline *e = find(baselines, metric->name);
+
+    if (e == NULL) {
+        return PERF_NEW;
+    }
+
+    if (metric->higher_is_better) {
+        *limit = e->value * (1.0 - e->tolerance);
+        return (metric->value >= *limit) ? PERF_PASS : PERF_FAIL;
+    } else {
+        *limit = e->value * (1.0 + e->tolerance);
+        return (metric->value <= *limit) ? PERF_PASS : PERF_FAIL;
+    }
+}
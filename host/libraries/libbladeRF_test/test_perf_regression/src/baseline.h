@@ -0,0 +1,107 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef BASELINE_H_
+#define BASELINE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Longest metric name, including the terminating '\0' */
+#define PERF_NAME_LEN           96
+
+/* Most metrics a baseline file or run may hold */
+#define PERF_MAX_METRICS        128
+
+/* Tolerance recorded for metrics new to a baseline file */
+#define PERF_DEFAULT_TOLERANCE  0.25
+
+/* One measurement of a run */
+struct perf_metric {
+    char name[PERF_NAME_LEN];
+    double value;
+    bool higher_is_better;      /* e.g., rates, as opposed to latencies */
+};
+
+/* One line of a baseline file */
+struct perf_baseline {
+    char name[PERF_NAME_LEN];
+    double value;
+    double tolerance;           /* Allowed fractional change for the worse */
+};
+
+struct perf_baselines {
+    struct perf_baseline entries[PERF_MAX_METRICS];
+    size_t count;
+};
+
+typedef enum {
+    PERF_PASS,
+    PERF_FAIL,
+    PERF_NEW,                   /* No baseline for the metric */
+} perf_verdict;
+
+/**
+ * Load a baseline file. Each line holds a metric name, its baseline value and
+ * its tolerance, separated by whitespace. Blank lines and lines starting with
+ * '#' are ignored.
+ *
+ * @param[in]   path        File to load
+ * @param[out]  baselines   Loaded baselines. Left empty if `path` does not
+ *                          exist.
+ *
+ * @return 0 on success, -1 if the file could not be read or parsed
+ */
+int baselines_load(const char *path, struct perf_baselines *baselines);
+
+/**
+ * Write a run's metrics as a baseline file. Tolerances of metrics already in
+ * `old` are kept. Others get PERF_DEFAULT_TOLERANCE.
+ *
+ * @param[in]   path        File to write
+ * @param[in]   old         Previous baselines, or NULL
+ * @param[in]   metrics     Metrics of the run
+ * @param[in]   count       Number of metrics
+ *
+ * @return 0 on success, -1 on failure
+ */
+int baselines_save(const char *path, const struct perf_baselines *old,
+                   const struct perf_metric *metrics, size_t count);
+
+/**
+ * Compare a metric against its baseline. A metric fails if it is more than
+ * the tolerance worse than the baseline, e.g., a rate below
+ * value * (1 - tolerance), or a latency above value * (1 + tolerance).
+ *
+ * @param[in]   baselines   Baselines to compare against
+ * @param[in]   metric      Metric to check
+ * @param[out]  limit       Set to the worst passing value, unless the
+ *                          verdict is PERF_NEW
+ *
+ * @return verdict
+ */
+perf_verdict baselines_check(const struct perf_baselines *baselines,
+                             const struct perf_metric *metric, double *limit);
+
+#endif
@@ -0,0 +1,162 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ctrl_bench.h"
+#include "log.h"
+
+/* Setting read by an operation's prepare step, and written back by each call */
+struct ctrl_state {
+    bladerf_gain gain;
+};
+
+struct ctrl_op {
+    const char *name;
+    int (*prepare)(struct bladerf *dev, struct ctrl_state *state);
+    int (*call)(struct bladerf *dev, struct ctrl_state *state);
+};
+
+static int call_config_gpio_read(struct bladerf *dev, struct ctrl_state *state)
+{
+    uint32_t val;
+    (void)state;
+    return bladerf_config_gpio_read(dev, &val);
+}
+
+static int call_get_timestamp(struct bladerf *dev, struct ctrl_state *state)
+{
+    bladerf_timestamp ts;
+    (void)state;
+    return bladerf_get_timestamp(dev, BLADERF_RX, &ts);
+}
+
+static int call_get_frequency(struct bladerf *dev, struct ctrl_state *state)
+{
+    bladerf_frequency freq;
+    (void)state;
+    return bladerf_get_frequency(dev, BLADERF_CHANNEL_RX(0), &freq);
+}
+
+static int prepare_set_gain(struct bladerf *dev, struct ctrl_state *state)
+{
+    return bladerf_get_gain(dev, BLADERF_CHANNEL_RX(0), &state->gain);
+}
+
+static int call_set_gain(struct bladerf *dev, struct ctrl_state *state)
+{
+    return bladerf_set_gain(dev, BLADERF_CHANNEL_RX(0), state->gain);
+}
+
+static const struct ctrl_op ops[] = {
+    { "config_gpio_read",   NULL,               call_config_gpio_read },
+    { "get_timestamp",      NULL,               call_get_timestamp },
+    { "get_frequency",      NULL,               call_get_frequency },
+    { "set_gain",           prepare_set_gain,   call_set_gain },
+};
+
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+size_t ctrl_bench_count(void)
+{
+    return ARRAY_SIZE(ops);
+}
+
+const char *ctrl_bench_name(size_t op)
+{
+    return ops[op].name;
+}
+
+static inline double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + ts.tv_nsec * 1e-3;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    const double x = *(const double *)a;
+    const double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of a sorted array */
+static double percentile(const double *sorted, size_t n, double pct)
+{
+    size_t rank = (size_t)(pct / 100.0 * n + 0.5);
+
+    if (rank == 0) {
+        rank = 1;
+    } else if (rank > n) {
+        rank = n;
+    }
+
+    return sorted[rank - 1];
+}
+
+void ctrl_bench_run(struct bladerf *dev, size_t op, unsigned int iterations,
+                    struct ctrl_result *result)
+{
+    struct ctrl_state state;
+    double *us;
+    double start;
+    unsigned int i;
+    int status = 0;
+
+    memset(result, 0, sizeof(*result));
+    memset(&state, 0, sizeof(state));
+
+    us = calloc(iterations, sizeof(us[0]));
+    if (us == NULL) {
+        result->status = BLADERF_ERR_MEM;
+        return;
+    }
+
+    if (ops[op].prepare != NULL) {
+        status = ops[op].prepare(dev, &state);
+    }
+
+    for (i = 0; i < iterations && status == 0; i++) {
+        start  = now_us();
+        status = ops[op].call(dev, &state);
+        us[i]  = now_us() - start;
+    }
+
+    if (status != 0) {
+        log_error("%s failed: %s\n", ops[op].name, bladerf_strerror(status));
+    } else if (iterations > 0) {
+        qsort(us, iterations, sizeof(us[0]), cmp_double);
+
+        result->count  = iterations;
+        result->p50_us = percentile(us, iterations, 50.0);
+        result->p99_us = percentile(us, iterations, 99.0);
+        result->max_us = us[iterations - 1];
+    }
+
+    result->status = status;
+    free(us);
+}
@@ -0,0 +1,63 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef CTRL_BENCH_H_
+#define CTRL_BENCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <libbladeRF.h>
+
+struct ctrl_result {
+    int status;                 /* 0, or the BLADERF_ERR_* that ended the run */
+    uint64_t count;             /* Calls timed */
+    double p50_us;
+    double p99_us;
+    double max_us;
+};
+
+/**
+ * @return the number of control operations that may be timed
+ */
+size_t ctrl_bench_count(void);
+
+/**
+ * @return the name of control operation `op`
+ */
+const char *ctrl_bench_name(size_t op);
+
+/**
+ * Time `iterations` calls of control operation `op`. Operations that change
+ * a setting write back its current value, so the device is left as it was.
+ *
+ * @param[in]   dev         Device handle
+ * @param[in]   op          Operation, from 0 to ctrl_bench_count() - 1
+ * @param[in]   iterations  Number of calls to time
+ * @param[out]  result      Per-call latencies. result->status holds any error
+ *                          that ended the run early.
+ */
+void ctrl_bench_run(struct bladerf *dev, size_t op, unsigned int iterations,
+                    struct ctrl_result *result);
+
+#endif
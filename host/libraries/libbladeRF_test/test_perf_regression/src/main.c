@@ -0,0 +1,410 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* Runs a fixed set of streaming and control-path benchmarks and compares
+ * them against a baseline file, failing if any metric has regressed beyond
+ * its tolerance. With the dummy backend ("dummy:") and BLADERF_DUMMY_RATE=0,
+ * this measures host-side overhead alone. It may equally be run against an
+ * attached device, with that device's own baseline file. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <getopt.h>
+#include <libbladeRF.h>
+
+#include "conversions.h"
+#include "log.h"
+#include "bench.h"
+#include "baseline.h"
+#include "ctrl_bench.h"
+
+#define DEFAULT_CTRL_ITERATIONS 10000
+
+#define OPTSTR "hd:b:us:t:i:"
+static const struct option long_options[] = {
+    { "help",           no_argument,        0,  'h' },
+    { "device",         required_argument,  0,  'd' },
+    { "baselines",      required_argument,  0,  'b' },
+    { "update",         no_argument,        0,  'u' },
+    { "samplerate",     required_argument,  0,  's' },
+    { "duration",       required_argument,  0,  't' },
+    { "iterations",     required_argument,  0,  'i' },
+
+    /* Verbosity options */
+    { "verbosity",      required_argument,  0,  1,  },
+    { "lib-verbosity",  required_argument,  0,  2,  },
+    { 0,                0,                  0,  0   },
+};
+
+/* Streaming points covering the sync and async paths, with and without
+ * metadata, and a host-converted format */
+static const struct bench_point stream_points[] = {
+    { BENCH_MODE_SYNC,  BLADERF_RX_X1, BLADERF_FORMAT_SC16_Q11,      8192, 32, 16 },
+    { BENCH_MODE_SYNC,  BLADERF_TX_X1, BLADERF_FORMAT_SC16_Q11,      8192, 32, 16 },
+    { BENCH_MODE_SYNC,  BLADERF_RX_X1, BLADERF_FORMAT_SC16_Q11_META, 8192, 32, 16 },
+    { BENCH_MODE_SYNC,  BLADERF_TX_X1, BLADERF_FORMAT_SC16_Q11_META, 8192, 32, 16 },
+    { BENCH_MODE_SYNC,  BLADERF_RX_X1, BLADERF_FORMAT_CF32,          8192, 32, 16 },
+    { BENCH_MODE_ASYNC, BLADERF_RX_X1, BLADERF_FORMAT_SC16_Q11,      8192, 32, 16 },
+    { BENCH_MODE_ASYNC, BLADERF_TX_X1, BLADERF_FORMAT_SC16_Q11,      8192, 32, 16 },
+};
+
+#define NUM_STREAM_POINTS (sizeof(stream_points) / sizeof(stream_points[0]))
+
+struct run {
+    struct perf_metric metrics[PERF_MAX_METRICS];
+    size_t count;
+    unsigned int errors;        /* Benchmarks that failed to run */
+};
+
+struct params {
+    struct bench_params bench;
+    const char *baselines;
+    bool update;
+    unsigned int iterations;
+};
+
+static void print_usage(const char *argv0)
+{
+    printf("Usage: %s -b <file> [options]\n", argv0);
+    printf("Run streaming and control-path benchmarks and compare them against\n");
+    printf("stored baselines, failing on regressions.\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("    -d, --device <device>       Use the specified device. By default,\n");
+    printf("                                any device found will be used.\n");
+    printf("    -b, --baselines <file>      Baseline file to compare against.\n");
+    printf("    -u, --update                Write the measurements to the baseline\n");
+    printf("                                file, rather than comparing them.\n");
+    printf("    -s, --samplerate <value>    Sample rate. Default = %u.\n", DEFAULT_SAMPLERATE);
+    printf("    -t, --duration <ms>         Time to run each streaming benchmark.\n");
+    printf("                                Default = %u.\n", DEFAULT_DURATION_MS);
+    printf("    -i, --iterations <n>        Calls per control benchmark.\n");
+    printf("                                Default = %u.\n", DEFAULT_CTRL_ITERATIONS);
+    printf("    -h, --help                  Show this help text\n");
+    printf("    --verbosity <level>         Set test verbosity (Default: warning)\n");
+    printf("    --lib-verbosity <level>     Set libbladeRF verbosity (Default: warning)\n");
+    printf("\n");
+    printf("Notes:\n");
+    printf("    Metrics without a baseline are reported but do not fail. Use\n");
+    printf("    --update on a reference setup to record them, and edit the\n");
+    printf("    tolerances in the resulting file as needed.\n");
+    printf("\n");
+    printf("    For the dummy backend (-d dummy:), set BLADERF_DUMMY_RATE=0 so\n");
+    printf("    that streams are not paced to the sample rate.\n");
+    printf("\n");
+}
+
+static int handle_cmdline(int argc, char *argv[], struct params *p)
+{
+    int c;
+    bool ok;
+    bladerf_log_level level;
+
+    memset(p, 0, sizeof(*p));
+    p->bench.samplerate  = DEFAULT_SAMPLERATE;
+    p->bench.frequency   = DEFAULT_FREQUENCY;
+    p->bench.duration_ms = DEFAULT_DURATION_MS;
+    p->bench.timeout_ms  = DEFAULT_TIMEOUT_MS;
+    p->iterations        = DEFAULT_CTRL_ITERATIONS;
+
+    while ((c = getopt_long(argc, argv, OPTSTR, long_options, NULL)) >= 0) {
+        switch (c) {
+            case 1:
+            case 2:
+                level = str2loglevel(optarg, &ok);
+                if (!ok) {
+                    log_error("Invalid log level provided: %s\n", optarg);
+                    return -1;
+                } else if (c == 1) {
+                    log_set_verbosity(level);
+                } else {
+                    bladerf_log_set_verbosity(level);
+                }
+                break;
+
+            case 'h':
+                return 1;
+
+            case 'd':
+                p->bench.device_str = optarg;
+                break;
+
+            case 'b':
+                p->baselines = optarg;
+                break;
+
+            case 'u':
+                p->update = true;
+                break;
+
+            case 's':
+                p->bench.samplerate = str2uint(optarg, BLADERF_SAMPLERATE_MIN,
+                                               UINT_MAX, &ok);
+                if (!ok) {
+                    log_error("Invalid sample rate: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 't':
+                p->bench.duration_ms = str2uint(optarg, 1, UINT_MAX, &ok);
+                if (!ok) {
+                    log_error("Invalid duration: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'i':
+                p->iterations = str2uint(optarg, 1, UINT_MAX, &ok);
+                if (!ok) {
+                    log_error("Invalid iteration count: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            default:
+                return -1;
+        }
+    }
+
+    if (p->baselines == NULL) {
+        log_error("A baseline file must be provided.\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Record metric <prefix>.<name> */
+static void add_metric(struct run *r, const char *prefix, const char *name,
+                       double value, bool higher_is_better)
+{
+    struct perf_metric *m;
+    int len;
+
+    if (r->count >= PERF_MAX_METRICS) {
+        log_error("Too many metrics\n");
+        r->errors++;
+        return;
+    }
+
+    m   = &r->metrics[r->count];
+    len = snprintf(m->name, sizeof(m->name), "%s.%s", prefix, name);
+    if (len < 0 || (size_t)len >= sizeof(m->name)) {
+        log_error("Metric name too long: %s.%s\n", prefix, name);
+        r->errors++;
+        return;
+    }
+
+    r->count++;
+    m->value            = value;
+    m->higher_is_better = higher_is_better;
+}
+
+static int configure_device(struct bladerf *dev, const struct bench_params *p)
+{
+    const bladerf_channel chans[] = { BLADERF_CHANNEL_RX(0),
+                                      BLADERF_CHANNEL_TX(0) };
+    size_t i;
+    int status;
+
+    for (i = 0; i < 2; i++) {
+        status = bladerf_set_sample_rate(dev, chans[i], p->samplerate, NULL);
+        if (status != 0) {
+            log_error("Failed to set %s sample rate: %s\n",
+                      channel2str(chans[i]), bladerf_strerror(status));
+            return status;
+        }
+
+        status = bladerf_set_frequency(dev, chans[i], p->frequency);
+        if (status != 0) {
+            log_error("Failed to set %s frequency: %s\n",
+                      channel2str(chans[i]), bladerf_strerror(status));
+            return status;
+        }
+    }
+
+    return 0;
+}
+
+static void run_streams(struct bladerf *dev, const struct bench_params *p,
+                        struct run *r)
+{
+    struct bench_result result;
+    char prefix[PERF_NAME_LEN];
+    size_t i;
+
+    for (i = 0; i < NUM_STREAM_POINTS; i++) {
+        const struct bench_point *point = &stream_points[i];
+
+        snprintf(prefix, sizeof(prefix), "stream.%s.%s.%s",
+                 (point->mode == BENCH_MODE_SYNC) ? "sync" : "async",
+                 bench_layout2str(point->layout),
+                 bench_format2str(point->format));
+
+        log_info("Running %s\n", prefix);
+
+        bench_run(dev, p, point, &result);
+        if (result.status != 0) {
+            log_error("%s failed: %s\n", prefix,
+                      bladerf_strerror(result.status));
+            r->errors++;
+            continue;
+        }
+
+        add_metric(r, prefix, "rate_sps", result.rate_sps, true);
+        add_metric(r, prefix, "latency_p99_us", result.latency_p99_us, false);
+
+        if (result.overruns >= 0) {
+            add_metric(r, prefix, "overruns", (double)result.overruns, false);
+        }
+    }
+}
+
+static void run_ctrl(struct bladerf *dev, unsigned int iterations,
+                     struct run *r)
+{
+    struct ctrl_result result;
+    char prefix[PERF_NAME_LEN];
+    size_t i;
+
+    for (i = 0; i < ctrl_bench_count(); i++) {
+        snprintf(prefix, sizeof(prefix), "ctrl.%s", ctrl_bench_name(i));
+
+        log_info("Timing %s\n", prefix);
+
+        ctrl_bench_run(dev, i, iterations, &result);
+        if (result.status != 0) {
+            r->errors++;
+            continue;
+        }
+
+        add_metric(r, prefix, "p50_us", result.p50_us, false);
+        add_metric(r, prefix, "p99_us", result.p99_us, false);
+    }
+}
+
+/* Print each metric against its baseline, returning the number that failed */
+static unsigned int report(const struct perf_baselines *baselines,
+                           const struct run *r)
+{
+    static const char *verdicts[] = { "ok", "REGRESSED", "new" };
+    unsigned int failed = 0;
+    size_t i;
+
+    printf("%-48s %14s %14s  %s\n", "metric", "measured", "limit", "result");
+
+    for (i = 0; i < r->count; i++) {
+        double limit = 0;
+        perf_verdict v = baselines_check(baselines, &r->metrics[i], &limit);
+
+        if (v == PERF_NEW) {
+            printf("%-48s %14.6g %14s  %s\n", r->metrics[i].name,
+                   r->metrics[i].value, "-", verdicts[v]);
+        } else {
+            printf("%-48s %14.6g %14.6g  %s\n", r->metrics[i].name,
+                   r->metrics[i].value, limit, verdicts[v]);
+        }
+
+        if (v == PERF_FAIL) {
+            failed++;
+        }
+    }
+
+    return failed;
+}
+
+int main(int argc, char *argv[])
+{
+    int status;
+    struct bladerf *dev = NULL;
+    struct params p;
+    static struct perf_baselines baselines;
+    static struct run run;
+    unsigned int failed;
+
+    log_set_verbosity(BLADERF_LOG_LEVEL_WARNING);
+    bladerf_log_set_verbosity(BLADERF_LOG_LEVEL_WARNING);
+
+    status = handle_cmdline(argc, argv, &p);
+    if (status != 0) {
+        if (status > 0) {
+            print_usage(argv[0]);
+            return 0;
+        }
+        return EXIT_FAILURE;
+    }
+
+    if (baselines_load(p.baselines, &baselines) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    status = bladerf_open(&dev, p.bench.device_str);
+    if (status != 0) {
+        log_error("Failed to open device: %s\n", bladerf_strerror(status));
+        return EXIT_FAILURE;
+    }
+
+    status = configure_device(dev, &p.bench);
+    if (status == 0) {
+        run_streams(dev, &p.bench, &run);
+        run_ctrl(dev, p.iterations, &run);
+    }
+
+    bladerf_close(dev);
+
+    if (status != 0) {
+        return EXIT_FAILURE;
+    }
+
+    if (p.update) {
+        if (run.errors != 0) {
+            log_error("Not updating %s: %u benchmark(s) failed to run\n",
+                      p.baselines, run.errors);
+            return EXIT_FAILURE;
+        }
+
+        if (baselines_save(p.baselines, &baselines, run.metrics,
+                           run.count) != 0) {
+            return EXIT_FAILURE;
+        }
+
+        printf("Wrote %zu baselines to %s\n", run.count, p.baselines);
+        return 0;
+    }
+
+    failed = report(&baselines, &run);
+
+    if (failed != 0 || run.errors != 0) {
+        printf("\n%u metric(s) regressed, %u benchmark(s) failed to run\n",
+               failed, run.errors);
+        return EXIT_FAILURE;
+    }
+
+    printf("\nNo regressions\n");
+    return 0;
+}
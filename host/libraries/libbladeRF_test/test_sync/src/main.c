@@ -36,7 +36,7 @@
 #include "log.h"
 #include "test.h"
 
-#define OPTSTR "hd:s:f:l:i:o:r:c:b:X:B:C:T:"
+#define OPTSTR "hd:s:f:l:i:o:r:c:b:X:B:C:T:S:A:R"
 const struct option long_options[] = {
     { "help",           no_argument,        0,  'h' },
 
@@ -58,6 +58,9 @@ const struct option long_options[] = {
     { "buffer-size",    required_argument,  0,  'B' },
     { "buffer-count",   required_argument,  0,  'C' },
     { "timeout",        required_argument,  0,  'T' },
+    { "spin",           required_argument,  0,  'S' },
+    { "affinity",       required_argument,  0,  'A' },
+    { "realtime",       no_argument,        0,  'R' },
 
     /* Verbosity options */
     { "verbosity",      required_argument,  0,  1,  },
@@ -124,6 +127,12 @@ static void print_usage(const char *argv0)
     printf("    -B, --buffer-size <n>       # samples per stream buffer. Default = %u.\n", DEFAULT_STREAM_SAMPLES);
     printf("    -C, --buffer-count <n>      # of stream buffers. Default = %u.\n", DEFAULT_STREAM_BUFFERS);
     printf("    -T, --timeout <n>           Stream timeout, in ms. Default = %u.\n", DEFAULT_STREAM_TIMEOUT);
+    printf("                                For -X, -B, and -C, 0 selects a value automatically.\n");
+    printf("    -S, --spin <n>              Busy-poll for up to <n> us when waiting for\n");
+    printf("                                a buffer, rather than blocking immediately.\n");
+    printf("    -A, --affinity <n>          Pin stream worker threads to CPU <n>.\n");
+    printf("    -R, --realtime              Run stream worker threads with real-time\n");
+    printf("                                scheduling. May require privileges.\n");
 
     printf("\n");
 
@@ -290,7 +299,7 @@ int handle_cmdline(int argc, char *argv[], struct test_params *p)
                 break;
 
             case 'X':
-                p->num_xfers = str2uint(optarg, 1, UINT_MAX, &ok);
+                p->num_xfers = str2uint(optarg, 0, UINT_MAX, &ok);
                 if (!ok) {
                     log_error("Invalid stream transfer count: %s\n", optarg);
                     return -1;
@@ -298,7 +307,7 @@ int handle_cmdline(int argc, char *argv[], struct test_params *p)
                 break;
 
             case 'B':
-                p->stream_buffer_size = str2uint(optarg, 1, UINT_MAX, &ok);
+                p->stream_buffer_size = str2uint(optarg, 0, UINT_MAX, &ok);
                 if (!ok) {
                     log_error("Invalid stream buffer size: %s\n", optarg);
                     return -1;
@@ -306,7 +315,7 @@ int handle_cmdline(int argc, char *argv[], struct test_params *p)
                 break;
 
             case 'C':
-                p->stream_buffer_count = str2uint(optarg, 1, UINT_MAX, &ok);
+                p->stream_buffer_count = str2uint(optarg, 0, UINT_MAX, &ok);
                 if (!ok) {
                     log_error("Invalid stream buffer count: %s\n", optarg);
                     return -1;
@@ -320,6 +329,26 @@ int handle_cmdline(int argc, char *argv[], struct test_params *p)
                     return -1;
                 }
                 break;
+
+            case 'S':
+                p->spin_us = str2uint(optarg, 1, UINT_MAX, &ok);
+                if (!ok) {
+                    log_error("Invalid spin time: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'A':
+                p->thread_attrs.cpu = str2int(optarg, 0, INT_MAX, &ok);
+                if (!ok) {
+                    log_error("Invalid CPU index: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'R':
+                p->thread_attrs.realtime = true;
+                break;
         }
     }
 
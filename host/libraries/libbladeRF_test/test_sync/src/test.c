@@ -97,6 +97,8 @@ void test_init_params(struct test_params *p)
     p->stream_buffer_count = DEFAULT_STREAM_BUFFERS;
     p->stream_buffer_size = DEFAULT_STREAM_SAMPLES;
     p->timeout_ms = DEFAULT_STREAM_TIMEOUT;
+
+    p->thread_attrs.cpu = -1;
 }
 
 static int init_module(struct bladerf *dev, struct test_params *p,
@@ -195,6 +197,41 @@ initialize_device_out:
     return dev;
 }
 
+static void print_stream_stats(struct bladerf *dev, bladerf_direction dir,
+                               const char *name)
+{
+    struct bladerf_stream_stats stats;
+
+    if (bladerf_get_stream_stats(dev, dir, &stats) != 0) {
+        return;
+    }
+
+    printf("%s stream: %u buffers of %u samples, %u transfers\n", name,
+           stats.num_buffers, stats.buffer_size, stats.num_transfers);
+
+    printf("%s stream: %llu produced, %llu consumed, %llu dropped, "
+           "%llu overruns, %llu underruns, high-water mark: %u buffers\n",
+           name,
+           (unsigned long long)stats.buffers_produced,
+           (unsigned long long)stats.buffers_consumed,
+           (unsigned long long)stats.buffers_dropped,
+           (unsigned long long)stats.overruns,
+           (unsigned long long)stats.underruns,
+           stats.high_water);
+
+    printf("%s stream: %llu transfers (%llu short), latency avg/max: "
+           "%u/%u us\n",
+           name,
+           (unsigned long long)stats.transfers_completed,
+           (unsigned long long)stats.short_transfers,
+           stats.xfer_latency_avg_us, stats.xfer_latency_max_us);
+
+    printf("%s stream: %llu FPGA FIFO %s, latest at %llu\n", name,
+           (unsigned long long)stats.fpga_xruns,
+           dir == BLADERF_RX ? "overflows" : "underflows",
+           (unsigned long long)stats.fpga_last_xrun);
+}
+
 void *rx_task(void *args)
 {
     int status;
@@ -211,6 +248,25 @@ void *rx_task(void *args)
         return NULL;
     }
 
+    if (p->spin_us != 0) {
+        status = bladerf_set_sync_wait_policy(task->dev, BLADERF_MODULE_RX,
+                                              BLADERF_SYNC_WAIT_SPIN,
+                                              p->spin_us);
+        if (status != 0) {
+            log_error("Failed to set RX sync wait policy: %s\n",
+                      bladerf_strerror(status));
+            goto rx_task_out;
+        }
+    }
+
+    status = bladerf_set_sync_thread_attrs(task->dev, BLADERF_MODULE_RX,
+                                           &p->thread_attrs);
+    if (status != 0) {
+        log_error("Failed to set RX thread attributes: %s\n",
+                  bladerf_strerror(status));
+        goto rx_task_out;
+    }
+
     status = bladerf_sync_config(task->dev,
                                  BLADERF_MODULE_RX,
                                  BLADERF_FORMAT_SC16_Q11,
@@ -261,6 +317,7 @@ void *rx_task(void *args)
 
 rx_task_out:
     free(samples);
+    print_stream_stats(task->dev, BLADERF_MODULE_RX, "RX");
 
     status = bladerf_enable_module(task->dev, BLADERF_MODULE_RX, false);
     if (status != 0) {
@@ -285,6 +342,25 @@ void *tx_task(void *arg)
         return NULL;
     }
 
+    if (p->spin_us != 0) {
+        status = bladerf_set_sync_wait_policy(task->dev, BLADERF_MODULE_TX,
+                                              BLADERF_SYNC_WAIT_SPIN,
+                                              p->spin_us);
+        if (status != 0) {
+            log_error("Failed to set TX sync wait policy: %s\n",
+                      bladerf_strerror(status));
+            goto tx_task_out;
+        }
+    }
+
+    status = bladerf_set_sync_thread_attrs(task->dev, BLADERF_MODULE_TX,
+                                           &p->thread_attrs);
+    if (status != 0) {
+        log_error("Failed to set TX thread attributes: %s\n",
+                  bladerf_strerror(status));
+        goto tx_task_out;
+    }
+
     status = bladerf_sync_config(task->dev,
                                  BLADERF_MODULE_TX,
                                  BLADERF_FORMAT_SC16_Q11,
@@ -334,6 +410,7 @@ void *tx_task(void *arg)
 
 tx_task_out:
     free(samples);
+    print_stream_stats(task->dev, BLADERF_MODULE_TX, "TX");
 
     status = bladerf_enable_module(task->dev, BLADERF_MODULE_TX, false);
     if (status != 0) {
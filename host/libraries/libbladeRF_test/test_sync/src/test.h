@@ -59,6 +59,8 @@ struct test_params {
     unsigned int stream_buffer_count;
     unsigned int stream_buffer_size;    /* Units of samples */
     unsigned int timeout_ms;
+    unsigned int spin_us;               /* 0 = block when waiting */
+    struct bladerf_thread_attrs thread_attrs;   /* Stream worker threads */
 };
 
 void test_init_params(struct test_params *p);
@@ -0,0 +1,84 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ATSC A/53 8-VSB channel coding: data randomizing, Reed-Solomon coding, byte
+ * interleaving, trellis coding, and segment and field sync insertion. The
+ * atsc_tx FPGA image maps the resulting symbols, inserts the pilot and
+ * shapes the spectrum, so this is all that is left to the host.
+ */
+#ifndef A53_H_
+#define A53_H_
+
+#include <stdint.h>
+
+#define A53_TS_PACKET_BYTES     188
+#define A53_TS_SYNC_BYTE        0x47
+
+/* Symbols per segment, including its 4 segment sync symbols */
+#define A53_SEGMENT_SYMBOLS     832
+
+/* Data segments per field */
+#define A53_FIELD_SEGMENTS      312
+
+/* The trellis coder's byte to encoder mapping repeats every 12 segments, so
+ * data segments are encoded in groups of that many */
+#define A53_GROUP_SEGMENTS      12
+
+/* Most segments a group may produce: its data segments, preceded by a field
+ * sync segment for the first group of each field */
+#define A53_MAX_GROUP_SEGMENTS  (A53_GROUP_SEGMENTS + 1)
+
+struct a53_encoder;
+
+/**
+ * @brief Create an encoder, starting at the first field of a frame
+ *
+ * @return 0 on success, -1 if memory could not be allocated
+ */
+int a53_init(struct a53_encoder **enc);
+
+/**
+ * @brief Encode a group of transport stream packets
+ *
+ * Each symbol is written as the index of its 8-VSB level, from 0 (-7) to
+ * 7 (+7), one per byte.
+ *
+ * @param enc       Encoder
+ * @param packets   A53_GROUP_SEGMENTS packets, each starting with its sync
+ *                  byte, which is replaced by the segment sync
+ * @param symbols   Buffer of A53_MAX_GROUP_SEGMENTS * A53_SEGMENT_SYMBOLS
+ *                  bytes that receives the segments
+ *
+ * @return The number of segments written
+ */
+unsigned int a53_encode(struct a53_encoder *enc,
+                        const uint8_t *const packets[A53_GROUP_SEGMENTS],
+                        uint8_t *symbols);
+
+/**
+ * @brief Free an encoder. Passing NULL is a no-op.
+ */
+void a53_free(struct a53_encoder *enc);
+
+#endif // A53_H_
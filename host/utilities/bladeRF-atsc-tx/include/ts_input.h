@@ -0,0 +1,79 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * Transport stream input. A reader thread reads or receives packets straight
+ * into a ring of chunks, which the packets are then used from in place.
+ */
+#ifndef TS_INPUT_H_
+#define TS_INPUT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct ts_input;
+
+struct ts_input_config {
+    const char *source;         // File, "-" for stdin, or udp://<addr>:<port>
+    unsigned int num_chunks;    // Chunks of up to 7 packets in the ring
+    bool loop;                  // Rewind a file at its end
+    bool null_fill;             // Send null packets when the ring runs dry.
+                                // This is always the case for UDP.
+};
+
+struct ts_input_stats {
+    uint64_t packets;           // Packets taken from the input
+    uint64_t null_packets;      // Null packets sent in their absence
+    uint64_t resyncs;           // Sync losses in a file or pipe
+    uint64_t dropped;           // Datagrams without whole packets
+};
+
+/**
+ * @brief Open a source and start its reader thread
+ *
+ * @return 0 on success, -1 on failure, with a message printed to stderr
+ */
+int ts_input_open(struct ts_input **in, const struct ts_input_config *cfg);
+
+/**
+ * @brief Get the next packet
+ *
+ * The packet remains valid until the next call. If the ring is empty, this
+ * returns a null packet if null filling is enabled, and otherwise waits up
+ * to 100 ms for a packet.
+ *
+ * @return 0 on success, 1 on a timeout, or -1 at the end of the input
+ */
+int ts_input_next(struct ts_input *in, const uint8_t **packet);
+
+/**
+ * @brief Get the input's counters
+ */
+void ts_input_get_stats(struct ts_input *in, struct ts_input_stats *stats);
+
+/**
+ * @brief Stop the reader thread and close the source. Passing NULL is a no-op.
+ */
+void ts_input_close(struct ts_input *in);
+
+#endif // TS_INPUT_H_
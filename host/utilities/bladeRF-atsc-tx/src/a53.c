@@ -0,0 +1,386 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "a53.h"
+
+// Bytes of a packet once its sync byte is dropped, and once RS coded
+#define DATA_BYTES          (A53_TS_PACKET_BYTES - 1)
+#define RS_PARITY_BYTES     20
+#define SEGMENT_BYTES       (DATA_BYTES + RS_PARITY_BYTES)
+
+#define DATA_SYMBOLS        (A53_SEGMENT_SYMBOLS - 4)
+
+// Byte interleaver: 52 branches, each 4 bytes longer than the last
+#define INTERLEAVER_BRANCHES    52
+#define INTERLEAVER_STEP        4
+#define INTERLEAVER_BYTES \
+    (INTERLEAVER_STEP * INTERLEAVER_BRANCHES * (INTERLEAVER_BRANCHES - 1) / 2)
+
+// Trellis coders, and how far the first coder of each segment moves
+#define NUM_CODERS          12
+#define CODER_SEGMENT_BUMP  4
+
+// Randomizer, x^16 + x^13 + x^12 + x^11 + x^7 + x^6 + x^3 + x + 1, held with
+// X1 in bit 15 and X16 in bit 0. It is preloaded with F180h (X1 to X16) at
+// the start of each field.
+#define RANDOMIZER_MASK     0xa638
+#define RANDOMIZER_PRELOAD  0x018f
+
+// GF(256) primitive polynomial, x^8 + x^4 + x^3 + x^2 + 1
+#define GF_POLY             0x11d
+
+// Levels used for binary sync symbols
+#define SYM_PLUS_5          6
+#define SYM_MINUS_5         1
+
+#define PN511_LEN           511
+#define PN63_LEN            63
+#define VSB_MODE_LEN        24
+#define RESERVED_LEN        92
+#define PRECODE_LEN         12
+
+static const uint8_t segment_sync[4] = {
+    SYM_PLUS_5, SYM_MINUS_5, SYM_MINUS_5, SYM_PLUS_5
+};
+
+// 8-VSB mode: its 12 bits, followed by their complement
+static const uint8_t vsb_mode[VSB_MODE_LEN] = {
+    0, 0, 0, 0, 1, 0, 1, 0, 0, 1, 0, 1,
+    1, 1, 1, 1, 0, 1, 0, 1, 1, 0, 1, 0,
+};
+
+struct a53_encoder {
+    unsigned int field;         // 0 or 1
+    unsigned int segment;       // Data segment within the field
+
+    uint16_t randomizer;
+
+    uint8_t gf_exp[512];
+    uint8_t gf_log[256];
+    uint8_t rs_gen[RS_PARITY_BYTES];    // Generator, less its x^20 term
+
+    uint8_t interleaver[INTERLEAVER_BYTES];
+    unsigned int branch_start[INTERLEAVER_BRANCHES];
+    unsigned int branch_pos[INTERLEAVER_BRANCHES];
+    unsigned int commutator;
+
+    uint8_t coder_state[NUM_CODERS];    // Precoder in bit 2, trellis below
+
+    // Data symbols repeated at the end of the next field sync segment
+    uint8_t last_symbols[PRECODE_LEN];
+
+    // Field sync segment, less its field-dependent and repeated symbols
+    uint8_t field_sync[A53_SEGMENT_SYMBOLS];
+
+    uint8_t bytes[A53_GROUP_SEGMENTS * SEGMENT_BYTES];
+};
+
+static uint8_t gf_mul(const struct a53_encoder *enc, uint8_t a, uint8_t b)
+{
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    return enc->gf_exp[enc->gf_log[a] + enc->gf_log[b]];
+}
+
+static void init_rs(struct a53_encoder *enc)
+{
+    uint8_t gen[RS_PARITY_BYTES + 1];
+    unsigned int x = 1;
+
+    for (unsigned int i = 0; i < 255; i++) {
+        enc->gf_exp[i] = enc->gf_exp[i + 255] = (uint8_t)x;
+        enc->gf_log[x] = (uint8_t)i;
+        x <<= 1;
+        if (x & 0x100) {
+            x ^= GF_POLY;
+        }
+    }
+
+    // g(x) = (x - a^0)(x - a^1)...(x - a^19), with gen[i] holding x^i
+    memset(gen, 0, sizeof(gen));
+    gen[0] = 1;
+    for (unsigned int r = 0; r < RS_PARITY_BYTES; r++) {
+        for (unsigned int i = r + 1; i > 0; i--) {
+            gen[i] = gen[i - 1] ^ gf_mul(enc, gen[i], enc->gf_exp[r]);
+        }
+        gen[0] = gf_mul(enc, gen[0], enc->gf_exp[r]);
+    }
+
+    memcpy(enc->rs_gen, gen, RS_PARITY_BYTES);
+}
+
+// Binary pseudo-random sequence of the given recurrence, where taps has a
+// bit set for each a[k + i] XORed to produce a[k + order]
+static void pn_sequence(uint8_t *out, unsigned int len, unsigned int order,
+                        unsigned int taps, const uint8_t *preload)
+{
+    for (unsigned int k = 0; k < len; k++) {
+        if (k < order) {
+            out[k] = preload[k];
+        } else {
+            uint8_t bit = 0;
+            for (unsigned int i = 0; i < order; i++) {
+                if (taps & (1u << i)) {
+                    bit ^= out[k - order + i];
+                }
+            }
+            out[k] = bit;
+        }
+    }
+}
+
+static void init_field_sync(struct a53_encoder *enc)
+{
+    // x^9 + x^7 + x^6 + x^4 + x^3 + x + 1, and x^6 + x + 1
+    static const uint8_t pn511_preload[9] = { 0, 0, 0, 0, 0, 0, 0, 1, 0 };
+    static const uint8_t pn63_preload[6]  = { 1, 1, 1, 0, 0, 1 };
+    uint8_t pn511[PN511_LEN], pn63[PN63_LEN];
+    uint8_t *sym = enc->field_sync;
+    unsigned int i;
+
+    pn_sequence(pn511, PN511_LEN, 9, 0xdb, pn511_preload);
+    pn_sequence(pn63, PN63_LEN, 6, 0x03, pn63_preload);
+
+    memcpy(sym, segment_sync, sizeof(segment_sync));
+    sym += sizeof(segment_sync);
+
+    for (i = 0; i < PN511_LEN; i++) {
+        *sym++ = pn511[i] ? SYM_PLUS_5 : SYM_MINUS_5;
+    }
+
+    // The second of the three PN63s is inverted in the second field
+    for (i = 0; i < 3 * PN63_LEN; i++) {
+        *sym++ = pn63[i % PN63_LEN] ? SYM_PLUS_5 : SYM_MINUS_5;
+    }
+
+    for (i = 0; i < VSB_MODE_LEN; i++) {
+        *sym++ = vsb_mode[i] ? SYM_PLUS_5 : SYM_MINUS_5;
+    }
+
+    // The reserved symbols carry nothing for 8-VSB, so alternate them to
+    // keep them free of DC
+    for (i = 0; i < RESERVED_LEN; i++) {
+        *sym++ = (i & 1) ? SYM_MINUS_5 : SYM_PLUS_5;
+    }
+}
+
+int a53_init(struct a53_encoder **enc_out)
+{
+    struct a53_encoder *enc;
+    unsigned int start = 0;
+
+    *enc_out = NULL;
+
+    enc = calloc(1, sizeof(*enc));
+    if (enc == NULL) {
+        return -1;
+    }
+
+    init_rs(enc);
+    init_field_sync(enc);
+
+    for (unsigned int b = 0; b < INTERLEAVER_BRANCHES; b++) {
+        enc->branch_start[b] = start;
+        start += b * INTERLEAVER_STEP;
+    }
+
+    *enc_out = enc;
+    return 0;
+}
+
+static void randomize(struct a53_encoder *enc, uint8_t *data, unsigned int len)
+{
+    for (unsigned int i = 0; i < len; i++) {
+        const uint16_t st = enc->randomizer;
+        uint8_t out = 0;
+
+        // One byte is taken from X1, X3, X4, X7, X11, X12, X13 and X14,
+        // into D0 to D7, then the register is clocked once
+        out |= (st & 0x8000) ? 0x01 : 0;
+        out |= (st & 0x2000) ? 0x02 : 0;
+        out |= (st & 0x1000) ? 0x04 : 0;
+        out |= (st & 0x0200) ? 0x08 : 0;
+        out |= (st & 0x0020) ? 0x10 : 0;
+        out |= (st & 0x0010) ? 0x20 : 0;
+        out |= (st & 0x0008) ? 0x40 : 0;
+        out |= (st & 0x0004) ? 0x80 : 0;
+        data[i] ^= out;
+
+        if (st & 1) {
+            enc->randomizer = ((st ^ RANDOMIZER_MASK) >> 1) | 0x8000;
+        } else {
+            enc->randomizer = st >> 1;
+        }
+    }
+}
+
+// Append the RS(207,187) parity of the first DATA_BYTES of segment
+static void rs_encode(const struct a53_encoder *enc, uint8_t *segment)
+{
+    uint8_t *parity = &segment[DATA_BYTES];
+
+    memset(parity, 0, RS_PARITY_BYTES);
+
+    for (unsigned int i = 0; i < DATA_BYTES; i++) {
+        const uint8_t fb = segment[i] ^ parity[0];
+
+        for (unsigned int j = 0; j < RS_PARITY_BYTES - 1; j++) {
+            parity[j] = parity[j + 1] ^
+                        gf_mul(enc, fb, enc->rs_gen[RS_PARITY_BYTES - 1 - j]);
+        }
+        parity[RS_PARITY_BYTES - 1] = gf_mul(enc, fb, enc->rs_gen[0]);
+    }
+}
+
+static void interleave(struct a53_encoder *enc, uint8_t *data, unsigned int len)
+{
+    for (unsigned int i = 0; i < len; i++) {
+        const unsigned int b = enc->commutator;
+
+        if (b != 0) {
+            uint8_t *slot = &enc->interleaver[enc->branch_start[b] +
+                                              enc->branch_pos[b]];
+            const uint8_t delayed = *slot;
+
+            *slot = data[i];
+            data[i] = delayed;
+
+            if (++enc->branch_pos[b] == b * INTERLEAVER_STEP) {
+                enc->branch_pos[b] = 0;
+            }
+        }
+
+        enc->commutator = (b + 1) % INTERLEAVER_BRANCHES;
+    }
+}
+
+// Precode and trellis code a dibit (X2 X1), producing Z2 Z1 Z0
+static uint8_t trellis_code(uint8_t *state, uint8_t dibit)
+{
+    const uint8_t x2 = (dibit >> 1) & 1;
+    const uint8_t x1 = dibit & 1;
+    const uint8_t y2 = x2 ^ ((*state >> 2) & 1);
+    const uint8_t s1 = (*state >> 1) & 1;
+    const uint8_t s0 = *state & 1;
+
+    *state = (uint8_t)((y2 << 2) | (s0 << 1) | (s1 ^ x1));
+    return (uint8_t)((y2 << 2) | (x1 << 1) | s0);
+}
+
+// Trellis code a group's bytes into its data segments. The symbols of each
+// segment are spread across the coders in turn, starting with a coder 4
+// further along than the last segment's. Each coder takes whole bytes, most
+// significant dibit first, taking the next byte of the group whenever it has
+// used up its last.
+static void trellis_encode(struct a53_encoder *enc, uint8_t *symbols)
+{
+    uint8_t current[NUM_CODERS];
+    unsigned int dibits[NUM_CODERS];
+    unsigned int next = 0;
+
+    memset(dibits, 0, sizeof(dibits));
+
+    for (unsigned int s = 0; s < A53_GROUP_SEGMENTS; s++) {
+        uint8_t *out = &symbols[s * A53_SEGMENT_SYMBOLS];
+        const unsigned int first = (s * CODER_SEGMENT_BUMP) % NUM_CODERS;
+
+        memcpy(out, segment_sync, sizeof(segment_sync));
+        out += sizeof(segment_sync);
+
+        for (unsigned int p = 0; p < DATA_SYMBOLS; p++) {
+            const unsigned int c = (first + p) % NUM_CODERS;
+            const unsigned int shift = 6 - 2 * (dibits[c] & 3);
+
+            if ((dibits[c] & 3) == 0) {
+                current[c] = enc->bytes[next++];
+            }
+            dibits[c]++;
+
+            out[p] = trellis_code(&enc->coder_state[c],
+                                  (current[c] >> shift) & 3);
+        }
+    }
+}
+
+unsigned int a53_encode(struct a53_encoder *enc,
+                        const uint8_t *const packets[A53_GROUP_SEGMENTS],
+                        uint8_t *symbols)
+{
+    unsigned int num_segments = 0;
+    uint8_t *data_symbols;
+
+    if (enc->segment == 0) {
+        uint8_t *sync = symbols;
+        uint8_t *pn63_mid = &sync[4 + PN511_LEN + PN63_LEN];
+
+        memcpy(sync, enc->field_sync, A53_SEGMENT_SYMBOLS - PRECODE_LEN);
+        memcpy(&sync[A53_SEGMENT_SYMBOLS - PRECODE_LEN], enc->last_symbols,
+               PRECODE_LEN);
+
+        if (enc->field == 1) {
+            for (unsigned int i = 0; i < PN63_LEN; i++) {
+                pn63_mid[i] = (pn63_mid[i] == SYM_PLUS_5) ? SYM_MINUS_5
+                                                          : SYM_PLUS_5;
+            }
+        }
+
+        enc->randomizer = RANDOMIZER_PRELOAD;
+        enc->commutator = 0;
+        num_segments++;
+    }
+
+    for (unsigned int s = 0; s < A53_GROUP_SEGMENTS; s++) {
+        uint8_t *seg = &enc->bytes[s * SEGMENT_BYTES];
+
+        memcpy(seg, &packets[s][1], DATA_BYTES);
+        randomize(enc, seg, DATA_BYTES);
+        rs_encode(enc, seg);
+        interleave(enc, seg, SEGMENT_BYTES);
+    }
+
+    data_symbols = &symbols[num_segments * A53_SEGMENT_SYMBOLS];
+    trellis_encode(enc, data_symbols);
+    num_segments += A53_GROUP_SEGMENTS;
+
+    memcpy(enc->last_symbols,
+           &symbols[num_segments * A53_SEGMENT_SYMBOLS - PRECODE_LEN],
+           PRECODE_LEN);
+
+    enc->segment += A53_GROUP_SEGMENTS;
+    if (enc->segment == A53_FIELD_SEGMENTS) {
+        enc->segment = 0;
+        enc->field ^= 1;
+    }
+
+    return num_segments;
+}
+
+void a53_free(struct a53_encoder *enc)
+{
+    free(enc);
+}
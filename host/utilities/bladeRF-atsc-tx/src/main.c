@@ -0,0 +1,411 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ATSC exciter. A transport stream is channel coded into 8-VSB symbols,
+ * which are packed into the TX stream of the atsc_tx FPGA image rather than
+ * modulated into samples. Packets are used in place from the input ring, and
+ * symbols are packed straight into the stream's buffers, so the stream is
+ * paced by the FPGA's consumption of symbols alone.
+ */
+#include <getopt.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "libbladeRF.h"
+#include "conversions.h"
+#include "host_config.h"
+#include "a53.h"
+#include "ts_input.h"
+
+#define CHECK(fn) do { \
+    status = fn; \
+    if (status != 0) { \
+        fprintf(stderr, "[Error] %s:%d: %s - %s\n", __FILE__, __LINE__, #fn, bladerf_strerror(status)); \
+        fprintf(stderr, "Exiting.\n"); \
+        goto error; \
+    } \
+} while (0)
+
+#define NUM_FREQ_SUFFIXES 6
+static const struct numeric_suffix freq_suffixes[NUM_FREQ_SUFFIXES] = {
+    { "G",      1000 * 1000 * 1000 },
+    { "GHz",    1000 * 1000 * 1000 },
+    { "M",      1000 * 1000 },
+    { "MHz",    1000 * 1000 },
+    { "k",      1000 },
+    { "kHz",    1000 }
+};
+
+#define TX_CHANNEL              BLADERF_CHANNEL_TX(0)
+
+// The atsc_tx image produces 3 samples per symbol, so the sample rate is 3
+// times the 8-VSB symbol rate of 4.5 MHz * 684 / 286
+#define ATSC_RATE_INTEGER       32286713
+#define ATSC_RATE_NUM           41
+#define ATSC_RATE_DEN           143
+
+#define ATSC_BANDWIDTH          6000000
+
+// Symbols packed into each 32-bit word of the stream
+#define SYMBOLS_PER_WORD        8
+
+// Each buffer holds 8192 words, 65536 symbols, or about 6 ms of signal
+#define DEFAULT_BUFFERS         32
+#define DEFAULT_BUFFER_SIZE     8192
+#define DEFAULT_TRANSFERS       16
+#define DEFAULT_RING_CHUNKS     256
+#define TIMEOUT_MS              1000
+
+#define OPTSTR "d:f:g:i:l:Lnr:b:v:h"
+static struct option long_options[] = {
+    { "device",      required_argument,  NULL,   'd' },
+    { "frequency",   required_argument,  NULL,   'f' },
+    { "gain",        required_argument,  NULL,   'g' },
+    { "input",       required_argument,  NULL,   'i' },
+    { "load-fpga",   required_argument,  NULL,   'l' },
+    { "loop",        no_argument,        NULL,   'L' },
+    { "null-fill",   no_argument,        NULL,   'n' },
+    { "ring",        required_argument,  NULL,   'r' },
+    { "buffers",     required_argument,  NULL,   'b' },
+    { "verbosity",   required_argument,  NULL,   'v' },
+    { "help",        no_argument,        NULL,   'h' },
+    { NULL,          0,                  NULL,   0   },
+};
+
+// A TX stream buffer being filled in place
+struct tx_out {
+    struct bladerf *dev;
+    uint32_t *buf;
+    unsigned int capacity;      // In words
+    unsigned int len;
+};
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_signal(int signo)
+{
+    (void)signo;
+    stop_requested = 1;
+}
+
+static void usage(const char *argv0)
+{
+    printf("Usage: %s [options] -f <frequency>\n", argv0);
+    printf("Transmit an MPEG transport stream as an ATSC 8-VSB signal, using\n");
+    printf("the atsc_tx FPGA image.\n");
+    printf("\n");
+    printf("  -d, --device <str>        Specify the device to open.\n");
+    printf("  -f, --frequency <freq>    Center frequency of the channel.\n");
+    printf("  -g, --gain <dB>           TX gain (default: unchanged).\n");
+    printf("  -i, --input <source>      Transport stream to send: a file, - for\n");
+    printf("                            stdin, or udp://<addr>:<port>, where\n");
+    printf("                            <addr> is joined if it is a multicast\n");
+    printf("                            group (default: -).\n");
+    printf("  -l, --load-fpga <file>    Load the atsc_tx FPGA image first.\n");
+    printf("  -L, --loop                Repeat a file until interrupted.\n");
+    printf("  -n, --null-fill           Send null packets when a file or pipe\n");
+    printf("                            falls behind. This is always done for\n");
+    printf("                            UDP.\n");
+    printf("  -r, --ring <n>            Input ring size, in chunks of 7 packets\n");
+    printf("                            (default: %u).\n", DEFAULT_RING_CHUNKS);
+    printf("  -b, --buffers <n>         # of TX stream buffers (default: %u).\n",
+           DEFAULT_BUFFERS);
+    printf("  -v, --verbosity <level>   Set the libbladeRF verbosity level (e.g., verbose, debug).\n");
+    printf("  -h, --help                Display this help text and exit.\n");
+    printf("\n");
+    printf("The stream must be sent at 19.39 Mbit/s, the 8-VSB payload rate.\n");
+    printf("Files are read only as quickly as the signal requires.\n");
+}
+
+// Pack symbols into the stream, low nibble first, as the atsc_tx image
+// takes them. Buffers are submitted as they fill.
+static int put_symbols(struct tx_out *o, const uint8_t *symbols,
+                       unsigned int num_symbols)
+{
+    int status;
+
+    for (unsigned int i = 0; i < num_symbols; i += SYMBOLS_PER_WORD) {
+        uint32_t word = 0;
+
+        if (o->buf == NULL) {
+            void *buf;
+
+            status = bladerf_sync_tx_acquire(o->dev, &buf, &o->capacity,
+                                             TIMEOUT_MS);
+            if (status != 0) {
+                return status;
+            }
+            o->buf = buf;
+            o->len = 0;
+        }
+
+        for (unsigned int k = 0; k < SYMBOLS_PER_WORD; k++) {
+            word |= (uint32_t)symbols[i + k] << (4 * k);
+        }
+        o->buf[o->len++] = HOST_TO_LE32(word);
+
+        if (o->len == o->capacity) {
+            status = bladerf_sync_tx_submit(o->dev, o->buf, o->len);
+            o->buf = NULL;
+            if (status != 0) {
+                return status;
+            }
+        }
+    }
+
+    return 0;
+}
+
+// Get a group's packets. Returns 0 on success, 1 if a stop was requested,
+// and -1 at the end of the input.
+static int next_group(struct ts_input *in,
+                      const uint8_t *packets[A53_GROUP_SEGMENTS])
+{
+    unsigned int i = 0;
+
+    while (i < A53_GROUP_SEGMENTS) {
+        const int ret = ts_input_next(in, &packets[i]);
+
+        if (ret < 0) {
+            return -1;
+        } else if (stop_requested) {
+            return 1;
+        } else if (ret == 0) {
+            i++;
+        }
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int status = 0;
+    const char *devstr = NULL;
+    const char *fpga = NULL;
+    struct bladerf *dev = NULL;
+    uint64_t frequency = 0;
+    int gain = 0;
+    bool gain_set = false;
+    unsigned int num_buffers = DEFAULT_BUFFERS;
+    bladerf_log_level log_level = BLADERF_LOG_LEVEL_INFO;
+
+    struct ts_input_config in_cfg = {
+        .source     = "-",
+        .num_chunks = DEFAULT_RING_CHUNKS,
+        .loop       = false,
+        .null_fill  = false,
+    };
+
+    struct bladerf_rational_rate rate = {
+        .integer = ATSC_RATE_INTEGER,
+        .num     = ATSC_RATE_NUM,
+        .den     = ATSC_RATE_DEN,
+    };
+
+    struct ts_input *in = NULL;
+    struct ts_input_stats stats;
+    struct a53_encoder *enc = NULL;
+    struct tx_out out;
+    struct sigaction sa;
+    struct bladerf_rational_rate actual_rate;
+    bladerf_bandwidth bandwidth;
+    const uint8_t *packets[A53_GROUP_SEGMENTS];
+    uint8_t *symbols = NULL;
+    bool enabled = false;
+    unsigned int num_segments;
+    int opt;
+    bool ok;
+
+    memset(&out, 0, sizeof(out));
+
+    while ((opt = getopt_long(argc, argv, OPTSTR, long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'd':
+                devstr = optarg;
+                break;
+
+            case 'f':
+                frequency = str2uint64_suffix(optarg, 1, UINT64_MAX,
+                    freq_suffixes, NUM_FREQ_SUFFIXES, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid frequency: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'g':
+                gain = str2int(optarg, INT32_MIN, INT32_MAX, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid gain: %s\n", optarg);
+                    return 1;
+                }
+                gain_set = true;
+                break;
+
+            case 'i':
+                in_cfg.source = optarg;
+                break;
+
+            case 'l':
+                fpga = optarg;
+                break;
+
+            case 'L':
+                in_cfg.loop = true;
+                break;
+
+            case 'n':
+                in_cfg.null_fill = true;
+                break;
+
+            case 'r':
+                in_cfg.num_chunks = str2uint(optarg, 1, 1 << 20, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid ring size: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'b':
+                num_buffers = str2uint(optarg, 2, 1024, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid # of buffers: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'v':
+                log_level = str2loglevel(optarg, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid log level: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'h':
+                usage(argv[0]);
+                return 0;
+
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (frequency == 0) {
+        fprintf(stderr, "A frequency must be given with -f.\n");
+        return 1;
+    }
+
+    bladerf_log_set_verbosity(log_level);
+
+    symbols = malloc(A53_MAX_GROUP_SEGMENTS * A53_SEGMENT_SYMBOLS);
+    if (symbols == NULL || a53_init(&enc) != 0) {
+        status = BLADERF_ERR_MEM;
+        goto error;
+    }
+
+    CHECK(bladerf_open(&dev, devstr));
+
+    // The atsc_tx image is only built for the bladeRF x40 and x115
+    if (strcmp(bladerf_get_board_name(dev), "bladerf1") != 0) {
+        fprintf(stderr, "The atsc_tx FPGA image requires a bladeRF x40 or "
+                        "x115.\n");
+        status = BLADERF_ERR_UNSUPPORTED;
+        goto error;
+    }
+
+    if (fpga != NULL) {
+        CHECK(bladerf_load_fpga(dev, fpga));
+    }
+
+    CHECK(bladerf_set_rational_sample_rate(dev, TX_CHANNEL, &rate,
+                                           &actual_rate));
+    CHECK(bladerf_set_bandwidth(dev, TX_CHANNEL, ATSC_BANDWIDTH, &bandwidth));
+    CHECK(bladerf_set_frequency(dev, TX_CHANNEL, frequency));
+    if (gain_set) {
+        CHECK(bladerf_set_gain(dev, TX_CHANNEL, gain));
+    }
+
+    if (ts_input_open(&in, &in_cfg) != 0) {
+        status = BLADERF_ERR_IO;
+        goto error;
+    }
+
+    CHECK(bladerf_sync_config(dev, BLADERF_TX_X1, BLADERF_FORMAT_SC16_Q11,
+                              num_buffers, DEFAULT_BUFFER_SIZE,
+                              DEFAULT_TRANSFERS < num_buffers
+                                  ? DEFAULT_TRANSFERS : num_buffers - 1,
+                              TIMEOUT_MS));
+    CHECK(bladerf_enable_module(dev, TX_CHANNEL, true));
+    enabled = true;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    out.dev = dev;
+    fprintf(stderr, "Transmitting at %" PRIu64 " Hz. Press Ctrl-C to stop.\n",
+            frequency);
+
+    while (next_group(in, packets) == 0) {
+        num_segments = a53_encode(enc, packets, symbols);
+        CHECK(put_symbols(&out, symbols,
+                          num_segments * A53_SEGMENT_SYMBOLS));
+    }
+
+    // Send what remains of the last buffer
+    if (out.buf != NULL) {
+        CHECK(bladerf_sync_tx_submit(dev, out.buf, out.len));
+        out.buf = NULL;
+    }
+
+error:
+    if (enabled) {
+        if (out.buf != NULL) {
+            bladerf_sync_tx_submit(dev, out.buf, out.len);
+        }
+        bladerf_enable_module(dev, TX_CHANNEL, false);
+    }
+
+    if (in != NULL) {
+        ts_input_get_stats(in, &stats);
+        fprintf(stderr, "Packets: %" PRIu64 "  Null: %" PRIu64
+                        "  Resyncs: %" PRIu64 "  Dropped datagrams: %" PRIu64
+                        "\n",
+                stats.packets, stats.null_packets, stats.resyncs,
+                stats.dropped);
+    }
+
+    ts_input_close(in);
+    a53_free(enc);
+    free(symbols);
+    if (dev) bladerf_close(dev);
+    return status == 0 ? 0 : 1;
+}
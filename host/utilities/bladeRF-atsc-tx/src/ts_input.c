@@ -0,0 +1,543 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include "a53.h"
+#include "ts_input.h"
+
+// Chunks hold as many packets as the usual datagram, 7, which keeps them
+// within a 1500 byte MTU
+#define PACKETS_PER_CHUNK   7
+#define CHUNK_BYTES         (PACKETS_PER_CHUNK * A53_TS_PACKET_BYTES)
+
+// Datagrams may carry a fixed RTP header ahead of their packets
+#define RTP_HEADER_BYTES    12
+#define RTP_VERSION         2
+
+#define POLL_MS             100
+
+// Requested socket receive buffer, to ride out bursty senders
+#define UDP_RCVBUF_BYTES    (4 * 1024 * 1024)
+
+#define NULL_PID_HI         0x1f
+#define NULL_PID_LO         0xff
+
+struct chunk {
+    uint8_t data[RTP_HEADER_BYTES + CHUNK_BYTES];
+    unsigned int offset;        // Of the first packet
+    unsigned int num_packets;
+};
+
+struct ts_input {
+    int fd;
+    bool udp;
+    bool loop;
+    bool null_fill;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    pthread_t thread;
+    bool thread_started;
+
+    // Filled chunks run from head to tail. The consumer holds the head
+    // chunk while it takes packets from it, without the lock.
+    struct chunk *chunks;
+    unsigned int num_chunks;
+    unsigned int head;
+    unsigned int tail;
+    unsigned int count;
+    bool holding;
+    unsigned int next_packet;
+
+    bool end;                   // The reader has stopped
+    bool stop;                  // The reader was asked to stop
+    struct ts_input_stats stats;
+
+    // Reader only: bytes that followed a sync loss, kept for the next chunk
+    uint8_t carry[CHUNK_BYTES];
+    unsigned int carry_len;
+
+    uint8_t null_packet[A53_TS_PACKET_BYTES];
+};
+
+static bool stopping(struct ts_input *in)
+{
+    bool stop;
+
+    pthread_mutex_lock(&in->lock);
+    stop = in->stop;
+    pthread_mutex_unlock(&in->lock);
+
+    return stop;
+}
+
+// Wait for the source to become readable. Returns 1 if it is, 0 on a
+// timeout, and -1 if the reader should stop.
+static int wait_readable(struct ts_input *in)
+{
+    struct pollfd pfd = { .fd = in->fd, .events = POLLIN };
+    int ret;
+
+    if (stopping(in)) {
+        return -1;
+    }
+
+    ret = poll(&pfd, 1, POLL_MS);
+    if (ret < 0 && errno != EINTR) {
+        perror("poll");
+        return -1;
+    }
+
+    return ret > 0 ? 1 : 0;
+}
+
+// Index of the first sync byte followed by another a packet later, or by
+// the end of the data
+static unsigned int find_sync(const uint8_t *data, unsigned int len)
+{
+    for (unsigned int i = 0; i < len; i++) {
+        if (data[i] == A53_TS_SYNC_BYTE &&
+            (i + A53_TS_PACKET_BYTES >= len ||
+             data[i + A53_TS_PACKET_BYTES] == A53_TS_SYNC_BYTE)) {
+            return i;
+        }
+    }
+
+    return len;
+}
+
+// Number of leading packets of data that start with a sync byte
+static unsigned int count_synced(const uint8_t *data, unsigned int num_packets)
+{
+    unsigned int i;
+
+    for (i = 0; i < num_packets; i++) {
+        if (data[i * A53_TS_PACKET_BYTES] != A53_TS_SYNC_BYTE) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+// Fill a chunk from a file or pipe. Returns 1 if it holds packets, 0 if it
+// does not, and -1 at the end of the input.
+static int read_chunk(struct ts_input *in, struct chunk *c,
+                      struct ts_input_stats *delta)
+{
+    uint8_t *data = c->data;
+    unsigned int len = in->carry_len;
+    bool at_end = false, read_any = false;
+    unsigned int skip;
+    ssize_t n;
+    int ret;
+
+    memcpy(data, in->carry, in->carry_len);
+    in->carry_len = 0;
+
+    while (true) {
+        while (len < CHUNK_BYTES && !at_end) {
+            ret = wait_readable(in);
+            if (ret < 0) {
+                return -1;
+            } else if (ret == 0) {
+                continue;
+            }
+
+            n = read(in->fd, &data[len], CHUNK_BYTES - len);
+            if (n < 0) {
+                if (errno == EINTR || errno == EAGAIN) {
+                    continue;
+                }
+                perror("read");
+                return -1;
+            } else if (n == 0) {
+                // Rewinding is only worthwhile if it can produce data
+                if (in->loop && read_any && lseek(in->fd, 0, SEEK_SET) == 0) {
+                    read_any = false;
+                    continue;
+                }
+                at_end = true;
+            } else {
+                len += (unsigned int)n;
+                read_any = true;
+            }
+        }
+
+        if (len == 0 || data[0] == A53_TS_SYNC_BYTE) {
+            break;
+        }
+
+        // Realign on the next packet, then top the chunk back up
+        skip = find_sync(data, len);
+        memmove(data, &data[skip], len - skip);
+        len -= skip;
+        delta->resyncs++;
+
+        if (at_end) {
+            break;
+        }
+    }
+
+    c->offset      = 0;
+    c->num_packets = count_synced(data, len / A53_TS_PACKET_BYTES);
+
+    // Anything after a sync loss is realigned at the start of the next chunk
+    if (!at_end && c->num_packets * A53_TS_PACKET_BYTES < len) {
+        const unsigned int used = c->num_packets * A53_TS_PACKET_BYTES;
+
+        in->carry_len = len - used;
+        memcpy(in->carry, &data[used], in->carry_len);
+    }
+
+    if (c->num_packets > 0) {
+        return 1;
+    }
+
+    return at_end ? -1 : 0;
+}
+
+// Receive a datagram into a chunk. Returns 1 if it holds packets, 0 if it
+// does not, and -1 on failure.
+static int receive_chunk(struct ts_input *in, struct chunk *c,
+                         struct ts_input_stats *delta)
+{
+    unsigned int len, offset = 0;
+    ssize_t n;
+    int ret;
+
+    ret = wait_readable(in);
+    if (ret <= 0) {
+        return ret;
+    }
+
+    n = recv(in->fd, c->data, sizeof(c->data), 0);
+    if (n < 0) {
+        if (errno == EINTR || errno == EAGAIN) {
+            return 0;
+        }
+        perror("recv");
+        return -1;
+    }
+
+    len = (unsigned int)n;
+    if (len % A53_TS_PACKET_BYTES != 0 || c->data[0] != A53_TS_SYNC_BYTE) {
+        if (len > RTP_HEADER_BYTES &&
+            (len - RTP_HEADER_BYTES) % A53_TS_PACKET_BYTES == 0 &&
+            (c->data[0] >> 6) == RTP_VERSION &&
+            c->data[RTP_HEADER_BYTES] == A53_TS_SYNC_BYTE) {
+            offset = RTP_HEADER_BYTES;
+        } else {
+            delta->dropped++;
+            return 0;
+        }
+    }
+
+    c->offset      = offset;
+    c->num_packets = count_synced(&c->data[offset],
+                                  (len - offset) / A53_TS_PACKET_BYTES);
+    if (c->num_packets == 0) {
+        delta->dropped++;
+        return 0;
+    }
+
+    return 1;
+}
+
+static void *reader_task(void *arg)
+{
+    struct ts_input *in = arg;
+    struct ts_input_stats delta;
+    struct chunk *c;
+    int ret = 0;
+
+    while (ret >= 0) {
+        pthread_mutex_lock(&in->lock);
+        while (in->count == in->num_chunks && !in->stop) {
+            pthread_cond_wait(&in->cond, &in->lock);
+        }
+        if (in->stop) {
+            pthread_mutex_unlock(&in->lock);
+            break;
+        }
+        c = &in->chunks[in->tail];
+        pthread_mutex_unlock(&in->lock);
+
+        memset(&delta, 0, sizeof(delta));
+        ret = in->udp ? receive_chunk(in, c, &delta)
+                      : read_chunk(in, c, &delta);
+
+        pthread_mutex_lock(&in->lock);
+        in->stats.resyncs += delta.resyncs;
+        in->stats.dropped += delta.dropped;
+        if (ret > 0) {
+            in->tail = (in->tail + 1) % in->num_chunks;
+            in->count++;
+            pthread_cond_broadcast(&in->cond);
+        }
+        pthread_mutex_unlock(&in->lock);
+    }
+
+    pthread_mutex_lock(&in->lock);
+    in->end = true;
+    pthread_cond_broadcast(&in->cond);
+    pthread_mutex_unlock(&in->lock);
+
+    return NULL;
+}
+
+// Open a socket for udp://<addr>:<port>, joining addr if it is a multicast
+// group. An empty addr receives on any address.
+static int open_udp(const char *source)
+{
+    const char *host = source + strlen("udp://");
+    const char *sep = strrchr(host, ':');
+    struct sockaddr_in sa;
+    char addr[64];
+    int rcvbuf = UDP_RCVBUF_BYTES;
+    int one = 1;
+    int fd;
+    long port;
+    char *end;
+
+    if (sep == NULL || (size_t)(sep - host) >= sizeof(addr)) {
+        fprintf(stderr, "Invalid UDP source: %s\n", source);
+        return -1;
+    }
+
+    memcpy(addr, host, sep - host);
+    addr[sep - host] = '\0';
+
+    port = strtol(sep + 1, &end, 10);
+    if (*end != '\0' || port <= 0 || port > 65535) {
+        fprintf(stderr, "Invalid UDP port: %s\n", sep + 1);
+        return -1;
+    }
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_port   = htons((uint16_t)port);
+    if (addr[0] == '\0') {
+        sa.sin_addr.s_addr = htonl(INADDR_ANY);
+    } else if (inet_pton(AF_INET, addr, &sa.sin_addr) != 1) {
+        fprintf(stderr, "Invalid UDP address: %s\n", addr);
+        return -1;
+    }
+
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    if (bind(fd, (struct sockaddr *)&sa, sizeof(sa)) != 0) {
+        perror("bind");
+        close(fd);
+        return -1;
+    }
+
+    if (IN_MULTICAST(ntohl(sa.sin_addr.s_addr))) {
+        struct ip_mreq mreq;
+
+        mreq.imr_multiaddr        = sa.sin_addr;
+        mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+        if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq,
+                       sizeof(mreq)) != 0) {
+            perror("IP_ADD_MEMBERSHIP");
+            close(fd);
+            return -1;
+        }
+    }
+
+    return fd;
+}
+
+int ts_input_open(struct ts_input **in_out, const struct ts_input_config *cfg)
+{
+    struct ts_input *in;
+
+    *in_out = NULL;
+
+    if (cfg->num_chunks == 0) {
+        fprintf(stderr, "The input ring needs at least one chunk.\n");
+        return -1;
+    }
+
+    in = calloc(1, sizeof(*in));
+    if (in == NULL) {
+        perror("calloc");
+        return -1;
+    }
+
+    in->chunks = calloc(cfg->num_chunks, sizeof(in->chunks[0]));
+    if (in->chunks == NULL) {
+        perror("calloc");
+        free(in);
+        return -1;
+    }
+
+    in->num_chunks = cfg->num_chunks;
+    in->loop       = cfg->loop;
+    in->null_fill  = cfg->null_fill;
+    pthread_mutex_init(&in->lock, NULL);
+    pthread_cond_init(&in->cond, NULL);
+
+    memset(in->null_packet, 0xff, sizeof(in->null_packet));
+    in->null_packet[0] = A53_TS_SYNC_BYTE;
+    in->null_packet[1] = NULL_PID_HI;
+    in->null_packet[2] = NULL_PID_LO;
+    in->null_packet[3] = 0x10;  // Payload only
+
+    if (strncmp(cfg->source, "udp://", strlen("udp://")) == 0) {
+        in->udp       = true;
+        in->null_fill = true;
+        in->fd        = open_udp(cfg->source);
+    } else if (strcmp(cfg->source, "-") == 0) {
+        in->fd = STDIN_FILENO;
+    } else {
+        in->fd = open(cfg->source, O_RDONLY);
+        if (in->fd < 0) {
+            perror(cfg->source);
+        }
+    }
+
+    if (in->fd < 0) {
+        ts_input_close(in);
+        return -1;
+    }
+
+    if (pthread_create(&in->thread, NULL, reader_task, in) != 0) {
+        fprintf(stderr, "Failed to start the input thread.\n");
+        ts_input_close(in);
+        return -1;
+    }
+    in->thread_started = true;
+
+    *in_out = in;
+    return 0;
+}
+
+int ts_input_next(struct ts_input *in, const uint8_t **packet)
+{
+    struct chunk *c = &in->chunks[in->head];
+    struct timespec deadline;
+
+    // Packets of the held chunk are the consumer's alone
+    if (in->holding && in->next_packet < c->num_packets) {
+        *packet = &c->data[c->offset + in->next_packet++ * A53_TS_PACKET_BYTES];
+        return 0;
+    }
+
+    pthread_mutex_lock(&in->lock);
+
+    if (in->holding) {
+        in->head    = (in->head + 1) % in->num_chunks;
+        in->count--;
+        in->holding = false;
+        pthread_cond_broadcast(&in->cond);
+    }
+
+    if (in->count == 0 && !in->end) {
+        if (in->null_fill) {
+            in->stats.null_packets++;
+            pthread_mutex_unlock(&in->lock);
+            *packet = in->null_packet;
+            return 0;
+        }
+
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += POLL_MS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        while (in->count == 0 && !in->end) {
+            if (pthread_cond_timedwait(&in->cond, &in->lock, &deadline) != 0) {
+                break;
+            }
+        }
+    }
+
+    if (in->count == 0) {
+        const bool end = in->end;
+        pthread_mutex_unlock(&in->lock);
+        return end ? -1 : 1;
+    }
+
+    c = &in->chunks[in->head];
+    in->holding      = true;
+    in->next_packet  = 1;
+    in->stats.packets += c->num_packets;
+    pthread_mutex_unlock(&in->lock);
+
+    *packet = &c->data[c->offset];
+    return 0;
+}
+
+void ts_input_get_stats(struct ts_input *in, struct ts_input_stats *stats)
+{
+    pthread_mutex_lock(&in->lock);
+    *stats = in->stats;
+    pthread_mutex_unlock(&in->lock);
+}
+
+void ts_input_close(struct ts_input *in)
+{
+    if (in == NULL) {
+        return;
+    }
+
+    if (in->thread_started) {
+        pthread_mutex_lock(&in->lock);
+        in->stop = true;
+        pthread_cond_broadcast(&in->cond);
+        pthread_mutex_unlock(&in->lock);
+
+        pthread_join(in->thread, NULL);
+    }
+
+    if (in->fd > STDIN_FILENO) {
+        close(in->fd);
+    }
+
+    pthread_cond_destroy(&in->cond);
+    pthread_mutex_destroy(&in->lock);
+    free(in->chunks);
+    free(in);
+}
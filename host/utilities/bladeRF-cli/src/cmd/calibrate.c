@@ -394,15 +394,23 @@ static struct dc_calibration_params * prepare_dc_cal_params(unsigned int f_min,
     return p;
 }
 
-static int save_table_results(const char *filename,
-                              struct bladerf *dev, bladerf_module module,
-                              const struct dc_calibration_params *params,
-                              size_t num_params)
+/* Table image being filled in as calibration results are produced */
+struct table_image {
+    struct bladerf_image *image;
+    size_t entries_off;     /* Offset of the first table entry */
+};
+
+static const size_t table_entry_size = sizeof(uint32_t) +   /* Frequency */
+                                       8 * sizeof(int16_t); /* DC I and Q */
+
+/* Allocate the table image and fill in its header */
+static int init_table_image(struct table_image *t,
+                            struct bladerf *dev, bladerf_module module,
+                            size_t num_params)
 {
     int status = 0;
     struct bladerf_lms_dc_cals lms_dc_cals;
     struct bladerf_image *image = NULL;
-    size_t i;
     size_t off = 0;
     uint32_t n_frequencies_le = 0;
 
@@ -411,11 +419,7 @@ static int save_table_results(const char *filename,
     static const uint32_t tbl_version = HOST_TO_LE32_CONST(0x00000002);
     static const size_t lms_data_size = 10; /* 10 uint8_t register values */
 
-
-    const size_t entry_size = sizeof(uint32_t) +   /* Frequency */
-                              8 * sizeof(int16_t); /* DC I and Q valus */
-
-    const size_t table_size = num_params * entry_size;
+    const size_t table_size = num_params * table_entry_size;
 
     const size_t data_size = sizeof(magic) + sizeof(reserved) +
                              sizeof(tbl_version) + sizeof(n_frequencies_le) +
@@ -467,55 +471,63 @@ static int save_table_results(const char *filename,
     image->data[off++] = (uint8_t)lms_dc_cals.rxvga2b_i;
     image->data[off++] = (uint8_t)lms_dc_cals.rxvga2b_q;
 
-    for (i = 0; i < num_params; i++) {
-        uint32_t freq;
-        int16_t corr_i, corr_q;
-        int16_t max_dc_i, max_dc_q;
-        int16_t mid_dc_i, mid_dc_q;
-        int16_t min_dc_i, min_dc_q;
+    t->image = image;
+    t->entries_off = off;
 
-        freq   = HOST_TO_LE32((uint32_t) params[i].frequency);
-        corr_i = HOST_TO_LE16(params[i].corr_i);
-        corr_q = HOST_TO_LE16(params[i].corr_q);
-        max_dc_i = HOST_TO_LE16(params[i].max_dc_i);
-        max_dc_q = HOST_TO_LE16(params[i].max_dc_q);
-        mid_dc_i = HOST_TO_LE16(params[i].mid_dc_i);
-        mid_dc_q = HOST_TO_LE16(params[i].mid_dc_q);
-        min_dc_i = HOST_TO_LE16(params[i].min_dc_i);
-        min_dc_q = HOST_TO_LE16(params[i].min_dc_q);
+    return 0;
+}
 
-        memcpy(&image->data[off], &freq, sizeof(freq));
-        off += sizeof(freq);
+/* dc_calibration_table() callback: store a completed point in the table */
+static int add_table_entry(const struct dc_calibration_params *p,
+                           size_t index, void *arg)
+{
+    struct table_image *t = (struct table_image *) arg;
+    size_t off = t->entries_off + index * table_entry_size;
+    uint32_t freq;
+    int16_t corr_i, corr_q;
+    int16_t max_dc_i, max_dc_q;
+    int16_t mid_dc_i, mid_dc_q;
+    int16_t min_dc_i, min_dc_q;
 
-        memcpy(&image->data[off], &corr_i, sizeof(corr_i));
-        off += sizeof(corr_q);
+    assert((off + table_entry_size) <= t->image->length);
 
-        memcpy(&image->data[off], &corr_q, sizeof(corr_q));
-        off += sizeof(corr_q);
+    freq   = HOST_TO_LE32((uint32_t) p->frequency);
+    corr_i = HOST_TO_LE16(p->corr_i);
+    corr_q = HOST_TO_LE16(p->corr_q);
+    max_dc_i = HOST_TO_LE16(p->max_dc_i);
+    max_dc_q = HOST_TO_LE16(p->max_dc_q);
+    mid_dc_i = HOST_TO_LE16(p->mid_dc_i);
+    mid_dc_q = HOST_TO_LE16(p->mid_dc_q);
+    min_dc_i = HOST_TO_LE16(p->min_dc_i);
+    min_dc_q = HOST_TO_LE16(p->min_dc_q);
 
-        memcpy(&image->data[off], &max_dc_i, sizeof(max_dc_i));
-        off += sizeof(max_dc_i);
+    memcpy(&t->image->data[off], &freq, sizeof(freq));
+    off += sizeof(freq);
 
-        memcpy(&image->data[off], &max_dc_q, sizeof(max_dc_q));
-        off += sizeof(max_dc_q);
+    memcpy(&t->image->data[off], &corr_i, sizeof(corr_i));
+    off += sizeof(corr_i);
 
-        memcpy(&image->data[off], &mid_dc_i, sizeof(mid_dc_i));
-        off += sizeof(mid_dc_i);
+    memcpy(&t->image->data[off], &corr_q, sizeof(corr_q));
+    off += sizeof(corr_q);
 
-        memcpy(&image->data[off], &mid_dc_q, sizeof(mid_dc_q));
-        off += sizeof(mid_dc_q);
+    memcpy(&t->image->data[off], &max_dc_i, sizeof(max_dc_i));
+    off += sizeof(max_dc_i);
 
-        memcpy(&image->data[off], &min_dc_i, sizeof(min_dc_i));
-        off += sizeof(min_dc_i);
+    memcpy(&t->image->data[off], &max_dc_q, sizeof(max_dc_q));
+    off += sizeof(max_dc_q);
 
-        memcpy(&image->data[off], &min_dc_q, sizeof(min_dc_q));
-        off += sizeof(min_dc_q);
-    }
+    memcpy(&t->image->data[off], &mid_dc_i, sizeof(mid_dc_i));
+    off += sizeof(mid_dc_i);
 
-    status = bladerf_image_write(dev, image, filename);
+    memcpy(&t->image->data[off], &mid_dc_q, sizeof(mid_dc_q));
+    off += sizeof(mid_dc_q);
 
-    bladerf_free_image(image);
-    return status;
+    memcpy(&t->image->data[off], &min_dc_i, sizeof(min_dc_i));
+    off += sizeof(min_dc_i);
+
+    memcpy(&t->image->data[off], &min_dc_q, sizeof(min_dc_q));
+
+    return 0;
 }
 
 /* See libbladeRF's dc_cal_table.c for the packed table data format */
@@ -530,6 +542,7 @@ static int cal_table(struct cli_state *s, int argc, char **argv)
 
     struct dc_calibration_params *params = NULL;
     size_t num_params = 0;
+    struct table_image table = { NULL, 0 };
 
     /* The XB-200 does not affect the minimum, as we're tuning the LMS here. */
     unsigned int f_min = BLADERF_FREQUENCY_MIN;
@@ -668,12 +681,18 @@ static int cal_table(struct cli_state *s, int argc, char **argv)
         goto out;
     }
 
-    status = dc_calibration(s->dev, module, params, num_params, true);
+    status = init_table_image(&table, s->dev, module, num_params);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = dc_calibration_table(s->dev, module, params, num_params,
+                                  add_table_entry, &table, true);
     if (status != 0) {
         goto out;
     }
 
-    status = save_table_results(filename, s->dev, module, params, num_params);
+    status = bladerf_image_write(s->dev, table.image, filename);
     if (status == 0) {
         printf("\n  Done.\n\n");
     }
@@ -684,6 +703,7 @@ out:
         status = CLI_RET_LIBBLADERF;
     }
 
+    bladerf_free_image(table.image);
     free(filename);
     free(params);
 
@@ -47,6 +47,8 @@ DECLARE_CMD(generate, "generate");
 DECLARE_CMD(help, "help", "h", "?");
 DECLARE_CMD(info, "info", "i");
 DECLARE_CMD(jump_to_bootloader, "jump_to_boot", "j");
+DECLARE_CMD(latency, "latency");
+DECLARE_CMD(linktest, "linktest");
 DECLARE_CMD(load, "load", "ld");
 DECLARE_CMD(mimo, "mimo");
 DECLARE_CMD(open, "open", "op", "o");
@@ -59,6 +61,7 @@ DECLARE_CMD(recover, "recover", "r");
 DECLARE_CMD(run, "run");
 DECLARE_CMD(rx, "rx", "receive");
 DECLARE_CMD(set, "set", "s");
+DECLARE_CMD(stats, "stats");
 DECLARE_CMD(trigger, "trigger", "tr");
 DECLARE_CMD(tx, "tx", "transmit");
 DECLARE_CMD(version, "version", "ver", "v");
@@ -200,6 +203,24 @@ static struct cmd const cmd_table[] = {
         FIELD_INIT(.requires_fpga, false),
         FIELD_INIT(.allow_while_streaming, false),
     },
+    {
+        FIELD_INIT(.names, cmd_names_latency),
+        FIELD_INIT(.exec, cmd_latency),
+        FIELD_INIT(.desc, "Measure host to RF and RF to host latency"),
+        FIELD_INIT(.help, CLI_CMD_HELPTEXT_latency),
+        FIELD_INIT(.requires_device, true),
+        FIELD_INIT(.requires_fpga, true),
+        FIELD_INIT(.allow_while_streaming, false),
+    },
+    {
+        FIELD_INIT(.names, cmd_names_linktest),
+        FIELD_INIT(.exec, cmd_linktest),
+        FIELD_INIT(.desc, "Check RX link integrity with the FPGA counter"),
+        FIELD_INIT(.help, CLI_CMD_HELPTEXT_linktest),
+        FIELD_INIT(.requires_device, true),
+        FIELD_INIT(.requires_fpga, true),
+        FIELD_INIT(.allow_while_streaming, false),
+    },
     {
         FIELD_INIT(.names, cmd_names_load),
         FIELD_INIT(.exec, cmd_load),
@@ -309,6 +330,15 @@ static struct cmd const cmd_table[] = {
         FIELD_INIT(.requires_fpga, true),
         FIELD_INIT(.allow_while_streaming, true),
     },
+    {
+        FIELD_INIT(.names, cmd_names_stats),
+        FIELD_INIT(.exec, cmd_stats),
+        FIELD_INIT(.desc, "Record and print control request latencies"),
+        FIELD_INIT(.help, CLI_CMD_HELPTEXT_stats),
+        FIELD_INIT(.requires_device, true),
+        FIELD_INIT(.requires_fpga, true),
+        FIELD_INIT(.allow_while_streaming, true),
+    },
     {
         FIELD_INIT(.names, cmd_names_trigger),
         FIELD_INIT(.exec, cmd_trigger),
@@ -0,0 +1,336 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* For fallocate() */
+#endif
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libbladeRF.h>
+
+#include "host_config.h"
+#include "minmax.h"
+#include "common.h"
+#include "fileset.h"
+
+#if BLADERF_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#define FILESET_HAVE_FALLOCATE 1
+#endif
+
+struct fileset {
+    struct fileset_config cfg;
+
+    char *stem;                 /* Configured path, up to its extension */
+    char *ext;                  /* Extension of the configured path */
+    char *name;                 /* Scratch space for file names */
+    size_t name_size;
+
+    FILE *files[FILESET_MAX_CHANNELS];
+    unsigned int num_files;     /* # of files written at once */
+    bool open;                  /* The current files are open */
+
+    size_t sample_size;         /* Size of an I/Q pair, in bytes */
+    uint64_t file_bytes;        /* # of bytes written to each current file */
+    uint64_t file_prealloc;     /* # of bytes requested for each */
+    uint64_t file_timestamp;    /* Timestamp of their first sample */
+    uint64_t written;           /* # of samples written overall */
+
+    /* Deinterleaved channels of a planar block */
+    void *planes[FILESET_MAX_CHANNELS];
+};
+
+static bool fileset_rotates(const struct fileset *set)
+{
+    return set->cfg.max_bytes != 0 || set->cfg.period != 0;
+}
+
+/* Size of each file about to be opened, if it is known, or 0 */
+static uint64_t fileset_prealloc_size(const struct fileset *set)
+{
+    const uint64_t tick_bytes =
+        set->sample_size * (set->cfg.planar ? 1 : set->cfg.num_channels);
+    uint64_t size = UINT64_MAX;
+
+    if (set->cfg.max_bytes != 0) {
+        size = set->cfg.max_bytes;
+    }
+
+    if (set->cfg.period != 0 && set->cfg.period <= UINT64_MAX / tick_bytes) {
+        size = u64_min(size, set->cfg.period * tick_bytes);
+    }
+
+    if (set->cfg.total_samples > set->written) {
+        size = u64_min(size, (set->cfg.total_samples - set->written) *
+                                 set->sample_size / set->num_files);
+    }
+
+    return (size == UINT64_MAX) ? 0 : size;
+}
+
+/* Reserve space for a newly opened file. This is only a hint to the
+ * filesystem, so a failure is not an error. */
+static void fileset_prealloc(FILE *file, uint64_t size)
+{
+#ifdef FILESET_HAVE_FALLOCATE
+    /* Unlike posix_fallocate(), this fails rather than writing zeros on
+     * filesystems that cannot allocate space up front */
+    if (size > 0 && size <= INT64_MAX) {
+        (void)fallocate(fileno(file), 0, 0, (off_t)size);
+    }
+#else
+    (void)file;
+    (void)size;
+#endif
+}
+
+/* Close the current files, dropping whatever was preallocated but not
+ * written */
+static int fileset_close_files(struct fileset *set)
+{
+    int status = 0;
+    unsigned int i;
+
+    if (!set->open) {
+        return 0;
+    }
+
+    for (i = 0; i < set->num_files; i++) {
+        if (set->files[i] == NULL) {
+            continue;
+        }
+
+#ifdef FILESET_HAVE_FALLOCATE
+        if (set->file_prealloc > set->file_bytes &&
+            (fflush(set->files[i]) != 0 ||
+             ftruncate(fileno(set->files[i]), (off_t)set->file_bytes) != 0)) {
+            status = CLI_RET_FILEOP;
+        }
+#endif
+
+        if (fclose(set->files[i]) != 0) {
+            status = CLI_RET_FILEOP;
+        }
+
+        set->files[i] = NULL;
+    }
+
+    set->open = false;
+
+    return status;
+}
+
+/* Start the next file(s), whose first sample has the given timestamp */
+static int fileset_rotate(struct fileset *set, uint64_t timestamp)
+{
+    unsigned int i;
+    int status;
+    int len;
+
+    status = fileset_close_files(set);
+    if (status != 0) {
+        return status;
+    }
+
+    set->file_bytes     = 0;
+    set->file_prealloc  = fileset_prealloc_size(set);
+    set->file_timestamp = timestamp;
+    set->open           = true;
+
+    for (i = 0; i < set->num_files; i++) {
+        len = snprintf(set->name, set->name_size, "%s", set->stem);
+
+        if (set->cfg.planar) {
+            len += snprintf(set->name + len, set->name_size - len, "_rx%u",
+                            set->cfg.channel_ids[i]);
+        }
+
+        if (fileset_rotates(set)) {
+            len += snprintf(set->name + len, set->name_size - len,
+                            "_%020" PRIu64, timestamp);
+        }
+
+        snprintf(set->name + len, set->name_size - len, "%s", set->ext);
+
+        status = expand_and_open(set->name, "wb", &set->files[i]);
+        if (status != 0) {
+            return status;
+        }
+
+        /* Blocks are large, so stdio buffering would only add a copy */
+        setvbuf(set->files[i], NULL, _IONBF, 0);
+
+        fileset_prealloc(set->files[i], set->file_prealloc);
+    }
+
+    return 0;
+}
+
+int fileset_open(struct fileset **set_out, const struct fileset_config *config)
+{
+    struct fileset *set;
+    const char *slash, *dot;
+    size_t stem_len, plane_size;
+    unsigned int i;
+
+    *set_out = NULL;
+
+    if (config->path == NULL || config->num_channels == 0 ||
+        config->num_channels > FILESET_MAX_CHANNELS ||
+        config->max_samples == 0) {
+        return CLI_RET_INVPARAM;
+    }
+
+    set = calloc(1, sizeof(*set));
+    if (set == NULL) {
+        return CLI_RET_MEM;
+    }
+
+    set->cfg         = *config;
+    set->cfg.path    = NULL;
+    set->num_files   = config->planar ? config->num_channels : 1;
+    set->sample_size = 2 * (config->sc8 ? sizeof(int8_t) : sizeof(int16_t));
+
+    /* Names are inserted before the extension, if the file name has one */
+    slash = strrchr(config->path, '/');
+    dot   = strrchr(config->path, '.');
+    if (dot == NULL || (slash != NULL && dot < slash) ||
+        dot == config->path || (slash != NULL && dot == slash + 1)) {
+        dot = config->path + strlen(config->path);
+    }
+
+    stem_len       = (size_t)(dot - config->path);
+    set->name_size = strlen(config->path) + 64;
+    set->stem      = malloc(stem_len + 1);
+    set->name      = malloc(set->name_size);
+    set->ext       = strdup(dot);
+    if (set->stem == NULL || set->name == NULL || set->ext == NULL) {
+        goto out_of_memory;
+    }
+
+    memcpy(set->stem, config->path, stem_len);
+    set->stem[stem_len] = '\0';
+
+    if (config->planar && config->num_channels > 1) {
+        plane_size = config->max_samples / config->num_channels *
+                     set->sample_size;
+
+        for (i = 0; i < config->num_channels; i++) {
+            set->planes[i] = malloc(plane_size);
+            if (set->planes[i] == NULL) {
+                goto out_of_memory;
+            }
+        }
+    }
+
+    *set_out = set;
+    return 0;
+
+out_of_memory:
+    fileset_close(set);
+    return CLI_RET_MEM;
+}
+
+int fileset_write(struct fileset *set,
+                  const void *samples,
+                  size_t n,
+                  uint64_t timestamp)
+{
+    const void *blocks[FILESET_MAX_CHANNELS];
+    size_t count, bytes;
+    unsigned int i;
+    int status;
+
+    if (n > set->cfg.max_samples || n % set->cfg.num_channels != 0) {
+        return CLI_RET_INVPARAM;
+    }
+
+    if (n == 0) {
+        return 0;
+    }
+
+    count = set->cfg.planar ? n / set->cfg.num_channels : n;
+    bytes = count * set->sample_size;
+
+    if (!set->open ||
+        (set->cfg.max_bytes != 0 && set->file_bytes != 0 &&
+         set->file_bytes + bytes > set->cfg.max_bytes) ||
+        (set->cfg.period != 0 &&
+         timestamp - set->file_timestamp >= set->cfg.period)) {
+        status = fileset_rotate(set, timestamp);
+        if (status != 0) {
+            return status;
+        }
+    }
+
+    if (set->cfg.planar && set->cfg.num_channels > 1) {
+        status = bladerf_deinterleave_stream_buffer_to(
+            BLADERF_RX_X2,
+            set->cfg.sc8 ? BLADERF_FORMAT_SC8_Q7 : BLADERF_FORMAT_SC16_Q11,
+            (unsigned int)n, samples, set->planes);
+        if (status != 0) {
+            return CLI_RET_UNKNOWN;
+        }
+
+        for (i = 0; i < set->num_files; i++) {
+            blocks[i] = set->planes[i];
+        }
+    } else {
+        blocks[0] = samples;
+    }
+
+    for (i = 0; i < set->num_files; i++) {
+        if (fwrite(blocks[i], 1, bytes, set->files[i]) != bytes) {
+            return CLI_RET_FILEOP;
+        }
+    }
+
+    set->file_bytes += bytes;
+    set->written    += n;
+
+    return 0;
+}
+
+int fileset_close(struct fileset *set)
+{
+    unsigned int i;
+    int status;
+
+    if (set == NULL) {
+        return 0;
+    }
+
+    status = fileset_close_files(set);
+
+    for (i = 0; i < FILESET_MAX_CHANNELS; i++) {
+        free(set->planes[i]);
+    }
+
+    free(set->ext);
+    free(set->name);
+    free(set->stem);
+    free(set);
+
+    return status;
+}
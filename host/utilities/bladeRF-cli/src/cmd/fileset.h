@@ -0,0 +1,108 @@
+/**
+ * @file fileset.h
+ *
+ * @brief Planar and rotated binary capture files for rx
+ *
+ * A file set writes received binary samples to one or more files,
+ * optionally:
+ *
+ *  - Planar: each channel's samples are written to a file of their own,
+ *    rather than a single file of interleaved channels. Files are named by
+ *    inserting _rx<N> before the extension of the configured file name,
+ *    e.g., capture_rx1.bin and capture_rx2.bin.
+ *
+ *  - Rotated: a new file (or set of planar files) is started once a file
+ *    reaches a size limit, or once it spans a period of time. Each is named
+ *    after the hardware timestamp of its first sample, inserting
+ *    _<timestamp> before the extension, e.g., capture_00000000000001048576.bin
+ *
+ * Files are preallocated whenever their final size is known, so that
+ * filesystems may lay them out contiguously, and are truncated to the size
+ * written when closed.
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef FILESET_H__
+#define FILESET_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Max # of channels a file set may write */
+#define FILESET_MAX_CHANNELS 2
+
+struct fileset;
+
+struct fileset_config {
+    const char *path;           /**< Configured file name */
+    bool sc8;                   /**< Samples are SC8 Q7, not SC16 Q11 */
+    unsigned int num_channels;  /**< # of interleaved channels */
+
+    /** Channel numbers used to name planar files, e.g., 1 for RX1 */
+    unsigned int channel_ids[FILESET_MAX_CHANNELS];
+
+    bool planar;                /**< Write one file per channel */
+    uint64_t max_bytes;         /**< Rotate files at this size. 0 = off. */
+    uint64_t period;            /**< Rotate files spanning this many
+                                 *   timestamp ticks. 0 = off. */
+    uint64_t total_samples;     /**< # of samples to be written in total,
+                                 *   if known, or 0 */
+    size_t max_samples;         /**< Max # of samples per fileset_write() */
+};
+
+/**
+ * Create a file set. Files are opened by the first fileset_write().
+ *
+ * @param[out]  set         Created file set
+ * @param[in]   config      Configuration, copied by this function
+ *
+ * @return 0 on success, CLI_RET_INVPARAM if the configuration is invalid,
+ *         or CLI_RET_MEM on allocation failure
+ */
+int fileset_open(struct fileset **set, const struct fileset_config *config);
+
+/**
+ * Write a block of contiguous samples, rotating files first as needed
+ *
+ * @param   set         File set to write to
+ * @param   samples     Samples, in host byte order
+ * @param   n           # of samples, counting each channel's I/Q pair
+ * @param   timestamp   Timestamp of the first sample, used to name and
+ *                      rotate files, or 0 if neither is needed
+ *
+ * @return 0 on success, or a CLI_RET_* value on failure. errno is left set
+ *         by failed file operations.
+ */
+int fileset_write(struct fileset *set,
+                  const void *samples,
+                  size_t n,
+                  uint64_t timestamp);
+
+/**
+ * Close the file set's files, truncating any preallocated space that was
+ * not written, and free it. Passing NULL is a no-op.
+ *
+ * @param   set         File set to close
+ *
+ * @return 0 on success, or CLI_RET_FILEOP if a file could not be finalized
+ */
+int fileset_close(struct fileset *set);
+
+#endif
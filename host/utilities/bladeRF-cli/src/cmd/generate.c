@@ -18,6 +18,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 #include <errno.h>
+#include <inttypes.h>
 #include <limits.h>
 #include <pthread.h>
 #include <stdbool.h>
@@ -35,36 +36,224 @@
 #include "minmax.h"
 #include "parse.h"
 #include "rel_assert.h"
+#include "rxtx.h"
 #include "rxtx_impl.h"
 #include "doc/cmd_help.h"
 
-int gen_write_fmt_sample(FILE *fp, enum rxtx_fmt fmt, int16_t s_i, int16_t s_q) {
-    int status = 0;
-    if (fmt == RXTX_FMT_CSV) {
-        status = fprintf(fp, "%d, %d\n", s_i, s_q);
-    } else if (fmt == RXTX_FMT_BIN_SC16Q11) {
-        status = fwrite(&s_i, sizeof(int16_t), 1, fp);
-        if (status > 0) {
-            status = fwrite(&s_q, sizeof(int16_t), 1, fp);
+/* I/Q pairs generated per block */
+#define GEN_BLOCK_SAMPLES 4096
+
+/* Longest CSV line, "-32768, -32768\n" */
+#define GEN_CSV_LINE_MAX 16
+
+/* Name given in place of a file to keep the waveform in memory for tx */
+#define GEN_TX_SINK "tx"
+
+enum gen_waveform {
+    GEN_CW,
+    GEN_PRN,
+};
+
+struct gen_state {
+    enum gen_waveform waveform;
+    int mag;
+
+    /* CW: e^(j*2*pi*k/period) for each offset k within a block. Each sample
+     * is the block's starting phasor rotated by one of these, so that the
+     * samples of a block are independent of each other and errors do not
+     * accumulate across blocks. */
+    unsigned int period;
+    double rot_i[GEN_BLOCK_SAMPLES];
+    double rot_q[GEN_BLOCK_SAMPLES];
+
+    /* PRN: xorshift64* state */
+    uint64_t prn;
+
+    /* Generated block, and room to convert it for output */
+    int16_t iq[2 * GEN_BLOCK_SAMPLES];
+    char out[GEN_CSV_LINE_MAX * GEN_BLOCK_SAMPLES];
+};
+
+static void gen_init(struct gen_state *g, enum gen_waveform waveform, int mag,
+                     unsigned int period)
+{
+    unsigned int k;
+
+    g->waveform = waveform;
+    g->mag      = mag;
+    g->period   = period;
+    g->prn      = 0x9e3779b97f4a7c15ull;
+
+    if (waveform == GEN_CW) {
+        for (k = 0; k < GEN_BLOCK_SAMPLES; k++) {
+            const double phase = 2 * M_PI * (k % period) / period;
+            g->rot_i[k] = cos(phase);
+            g->rot_q[k] = sin(phase);
+        }
+    }
+}
+
+static inline uint32_t gen_prn_next(uint64_t *x)
+{
+    *x ^= *x >> 12;
+    *x ^= *x << 25;
+    *x ^= *x >> 27;
+    return (uint32_t)((*x * 0x2545f4914f6cdd1dull) >> 32);
+}
+
+/* Fill g->iq with `n` I/Q pairs, starting at sample `start` */
+static void gen_block(struct gen_state *g, uint64_t start, size_t n)
+{
+    size_t k;
+
+    assert(n <= GEN_BLOCK_SAMPLES);
+
+    if (g->waveform == GEN_CW) {
+        const double phase = 2 * M_PI * (start % g->period) / g->period;
+        const double c = g->mag * cos(phase);
+        const double s = g->mag * sin(phase);
+
+        for (k = 0; k < n; k++) {
+            g->iq[2 * k]     = (int16_t)(c * g->rot_i[k] - s * g->rot_q[k]);
+            g->iq[2 * k + 1] = (int16_t)(c * g->rot_q[k] + s * g->rot_i[k]);
+        }
+    } else {
+        /* Uniform over [-mag, mag] */
+        const uint64_t range = 2 * (uint64_t)g->mag + 1;
+
+        for (k = 0; k < 2 * n; k++) {
+            g->iq[k] = (int16_t)((int64_t)((gen_prn_next(&g->prn) * range)
+                                           >> 32) - g->mag);
+        }
+    }
+}
+
+static char *gen_fmt_int(char *p, int v)
+{
+    char tmp[8];
+    unsigned int u = (v < 0) ? -(unsigned int)v : (unsigned int)v;
+    int i = 0;
+
+    if (v < 0) {
+        *p++ = '-';
+    }
+
+    do {
+        tmp[i++] = '0' + (u % 10);
+        u /= 10;
+    } while (u != 0);
+
+    while (i > 0) {
+        *p++ = tmp[--i];
+    }
+
+    return p;
+}
+
+/* Write the `n` I/Q pairs in g->iq to a file
+ *
+ * return 0 on success, non-zero on failure */
+static int gen_write_block(struct gen_state *g, FILE *fp, enum rxtx_fmt fmt,
+                           size_t n)
+{
+    char *p = g->out;
+    size_t k;
+
+    switch (fmt) {
+        case RXTX_FMT_CSV:
+            for (k = 0; k < n; k++) {
+                p    = gen_fmt_int(p, g->iq[2 * k]);
+                *p++ = ',';
+                *p++ = ' ';
+                p    = gen_fmt_int(p, g->iq[2 * k + 1]);
+                *p++ = '\n';
+            }
+            break;
+
+        case RXTX_FMT_BIN_SC16Q11:
+            return fwrite(g->iq, 2 * sizeof(int16_t), n, fp) != n;
+
+        case RXTX_FMT_BIN_SC8Q7:
+            for (k = 0; k < 2 * n; k++) {
+                *p++ = (char)(int8_t)g->iq[k];
+            }
+            break;
+
+        default:
+            return 1;
+    }
+
+    return fwrite(g->out, 1, p - g->out, fp) != (size_t)(p - g->out);
+}
+
+/* Generate `n` I/Q pairs into the file */
+static int gen_to_file(struct gen_state *g, FILE *fp, enum rxtx_fmt fmt,
+                       uint64_t n)
+{
+    uint64_t i;
+
+    for (i = 0; i < n; i += GEN_BLOCK_SAMPLES) {
+        const size_t count = (size_t)u64_min(n - i, GEN_BLOCK_SAMPLES);
+
+        gen_block(g, i, count);
+
+        if (gen_write_block(g, fp, fmt, count) != 0) {
+            return CLI_RET_FILEOP;
         }
-    } else if (fmt == RXTX_FMT_BIN_SC8Q7) {
-        status = fwrite(&s_i, sizeof(int8_t), 1, fp);
-        if (status > 0) {
-            status = fwrite(&s_q, sizeof(int8_t), 1, fp);
+    }
+
+    return 0;
+}
+
+/* Generate `n` I/Q pairs into a buffer in the TX stream's sample format */
+static int gen_to_memory(struct gen_state *g, bool sc8, uint64_t n,
+                         void **waveform)
+{
+    const size_t sample_size = 2 * (sc8 ? sizeof(int8_t) : sizeof(int16_t));
+    uint8_t *buf;
+    uint64_t i;
+    size_t k;
+
+    if (n > SIZE_MAX / sample_size) {
+        return CLI_RET_MEM;
+    }
+
+    buf = malloc((size_t)n * sample_size);
+    if (buf == NULL) {
+        return CLI_RET_MEM;
+    }
+
+    for (i = 0; i < n; i += GEN_BLOCK_SAMPLES) {
+        const size_t count = (size_t)u64_min(n - i, GEN_BLOCK_SAMPLES);
+
+        gen_block(g, i, count);
+
+        if (sc8) {
+            int8_t *dst = (int8_t *)buf + 2 * i;
+            for (k = 0; k < 2 * count; k++) {
+                dst[k] = (int8_t)g->iq[k];
+            }
+        } else {
+            memcpy((int16_t *)buf + 2 * i, g->iq, count * sample_size);
         }
     }
-    return status <= 0;
+
+    *waveform = buf;
+    return 0;
 }
 
 int cmd_generate(struct cli_state *s, int argc, char **argv)
 {
-    FILE *fp;
+    FILE *fp = NULL;
+    struct gen_state *g = NULL;
+    void *waveform = NULL;
     char *delim;
     char *val;
     int status;
-    int n_samples = 0;
+    uint64_t n_samples = 0;
     int mag = 2047;
     int i;
+    bool to_tx;
 
     if (s->bit_mode_8bit) {
         mag /= 16;
@@ -72,6 +261,8 @@ int cmd_generate(struct cli_state *s, int argc, char **argv)
     int remaining_argc;
 
     enum rxtx_fmt fmt = RXTX_FMT_CSV;
+    enum gen_waveform waveform_type;
+    unsigned int period = 0;
     unsigned int n;
     bool ok;
 
@@ -82,11 +273,15 @@ int cmd_generate(struct cli_state *s, int argc, char **argv)
         return CLI_RET_NARGS;
     }
 
-    status = expand_and_open(argv[1], "w+", &fp);
-    if (status != 0) {
-        return status;
+    /* Either way, the result replaces what tx is playing back */
+    if (rxtx_task_running(s->tx)) {
+        cli_err(s, argv[0], "Cannot replace the tx waveform while tx is "
+                "running");
+        return CLI_RET_STATE;
     }
 
+    to_tx = !strcasecmp(argv[1], GEN_TX_SINK);
+
     for (i = 2; i < argc; i++) {
         delim = strchr(argv[i], '=');
         if (!delim) {
@@ -122,7 +317,8 @@ int cmd_generate(struct cli_state *s, int argc, char **argv)
             }
         } else if (!strcasecmp("format", argv[i])) {
             fmt = rxtx_str2fmt(val, s);
-            if (fmt == RXTX_FMT_INVALID) {
+            if (fmt == RXTX_FMT_INVALID || fmt == RXTX_FMT_SIGMF ||
+                fmt == RXTX_FMT_IQZ) {
                 cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
                 status = CLI_RET_INVPARAM;
                 goto out;
@@ -149,28 +345,20 @@ int cmd_generate(struct cli_state *s, int argc, char **argv)
             goto out;
         }
 
-        n = str2uint_suffix(argv[i+1], 0, UINT_MAX, rxtx_kmg_suffixes,
+        n = str2uint_suffix(argv[i+1], 1, UINT_MAX, rxtx_kmg_suffixes,
                             (int)rxtx_kmg_suffixes_len, &ok);
         if (!ok) {
             cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], argv[i+1]));
             status = CLI_RET_INVPARAM;
             goto out;
         }
-        for (i = 0; i < (int)n; i++) {
-            if (n_samples && i > n_samples) {
-                break;
-            }
 
-            status = gen_write_fmt_sample(fp, fmt,
-                            mag * cos(i * (double)(2*M_PI/(float)n)),
-                            mag * sin(i * (double)(2*M_PI/(float)n))
-                        );
-            if (status) {
-                status = CLI_RET_FILEOP;
-                goto out;
-            }
+        /* One period is enough, as tx repeats it */
+        waveform_type = GEN_CW;
+        period        = n;
+        if (n_samples == 0 || n_samples > n) {
+            n_samples = n;
         }
-        n_samples = i;
     } else if (!strcasecmp(argv[i], "prn")) {
         if (remaining_argc != 1) {
             cli_err(s, argv[0], "Incorrect number of arguments for %s", argv[i]);
@@ -178,21 +366,59 @@ int cmd_generate(struct cli_state *s, int argc, char **argv)
             goto out;
 
         }
-#define DENOMINATOR (4096)
-#define RAND_CHAN   ((rand()/DENOMINATOR) * (2*mag) / (RAND_MAX/DENOMINATOR) - mag)
-        for (i = 0; i < n_samples; i++) {
-            if (gen_write_fmt_sample(fp, fmt, RAND_CHAN, RAND_CHAN)) {
-                status = CLI_RET_FILEOP;
-                goto out;
-            }
+
+        if (to_tx && n_samples == 0) {
+            cli_err(s, argv[0], "The number of samples must be specified");
+            status = CLI_RET_INVPARAM;
+            goto out;
         }
+
+        waveform_type = GEN_PRN;
     } else {
         cli_err(s, argv[0], "Unrecognized waveform %s", argv[i]);
         status = CLI_RET_INVPARAM;
         goto out;
     }
 
-    printf("  Wrote %d samples to %s.\n", n_samples, argv[1]);
+    g = malloc(sizeof(*g));
+    if (g == NULL) {
+        status = CLI_RET_MEM;
+        goto out;
+    }
+
+    gen_init(g, waveform_type, mag, period);
+
+    if (to_tx) {
+        status = gen_to_memory(g, s->bit_mode_8bit, n_samples, &waveform);
+        if (status != 0) {
+            goto out;
+        }
+
+        tx_set_waveform(s->tx, waveform, (size_t)n_samples, s->bit_mode_8bit);
+
+        MUTEX_LOCK(&s->tx->param_lock);
+        ((struct tx_params *)s->tx->params)->repeat = 0;
+        MUTEX_UNLOCK(&s->tx->param_lock);
+
+        printf("  Generated %" PRIu64 " samples for tx.\n\n", n_samples);
+        status = 0;
+        goto out;
+    }
+
+    status = expand_and_open(argv[1], "w+", &fp);
+    if (status != 0) {
+        goto out;
+    }
+
+    status = gen_to_file(g, fp, fmt, n_samples);
+    if (status != 0) {
+        goto out;
+    }
+
+    printf("  Wrote %" PRIu64 " samples to %s.\n", n_samples, argv[1]);
+
+    /* The file replaces any waveform generated for tx */
+    tx_set_waveform(s->tx, NULL, 0, false);
 
     /* Perform file conversion (if needed) and open input file */
     MUTEX_LOCK(&s->tx->file_mgmt.file_lock);
@@ -220,6 +446,9 @@ int cmd_generate(struct cli_state *s, int argc, char **argv)
     printf("\n");
 
 out:
-    fclose(fp);
+    if (fp != NULL) {
+        fclose(fp);
+    }
+    free(g);
     return status;
 }
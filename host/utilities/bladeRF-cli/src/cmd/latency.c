@@ -0,0 +1,140 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <inttypes.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <conversions.h>
+
+#include "cmd.h"
+#include "rxtx_impl.h"
+
+#define LATENCY_DEFAULT_ITERATIONS  100
+#define LATENCY_INTERVAL_MS         20
+
+static inline double ns_to_us(uint64_t ns)
+{
+    return ns / 1000.0;
+}
+
+static void print_dist(const char *name, const struct bladerf_latency_dist *d)
+{
+    printf("    %-12s %8" PRIu64 " %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+           name, d->count, ns_to_us(d->min_ns), ns_to_us(d->mean_ns),
+           ns_to_us(d->p50_ns), ns_to_us(d->p90_ns), ns_to_us(d->p99_ns),
+           ns_to_us(d->max_ns));
+}
+
+/* Configure a direction of the sync interface per its rx/tx config */
+static int config_sync(struct cli_state *state, struct rxtx_data *rxtx,
+                       bladerf_channel_layout layout)
+{
+    struct data_mgmt *d = &rxtx->data_mgmt;
+    int status;
+
+    MUTEX_LOCK(&d->lock);
+    status = bladerf_sync_config(state->dev, layout,
+                                 BLADERF_FORMAT_SC16_Q11_META, d->num_buffers,
+                                 d->samples_per_buffer, d->num_transfers,
+                                 d->timeout_ms);
+    MUTEX_UNLOCK(&d->lock);
+
+    return status;
+}
+
+int cmd_latency(struct cli_state *state, int argc, char **argv)
+{
+    struct bladerf_latency_config config;
+    struct bladerf_latency_result result;
+    int status, disable_status;
+    bool ok;
+
+    if (argc > 2) {
+        return CLI_RET_NARGS;
+    }
+
+    config.iterations  = LATENCY_DEFAULT_ITERATIONS;
+    config.interval_ms = LATENCY_INTERVAL_MS;
+    config.rx_samples  = 0;
+    config.threshold   = 0;
+
+    if (argc == 2) {
+        config.iterations = str2uint(argv[1], 1, UINT_MAX, &ok);
+        if (!ok) {
+            cli_err(state, argv[0], "Invalid number of iterations: %s\n",
+                    argv[1]);
+            return CLI_RET_INVPARAM;
+        }
+    }
+
+    MUTEX_LOCK(&state->rx->data_mgmt.lock);
+    config.timeout_ms = state->rx->data_mgmt.timeout_ms;
+    MUTEX_UNLOCK(&state->rx->data_mgmt.lock);
+
+    status = config_sync(state, state->rx, BLADERF_RX_X1);
+    if (status == 0) {
+        status = config_sync(state, state->tx, BLADERF_TX_X1);
+    }
+
+    if (status == 0) {
+        status = bladerf_enable_module(state->dev, BLADERF_CHANNEL_RX(0), true);
+    }
+
+    if (status == 0) {
+        status = bladerf_enable_module(state->dev, BLADERF_CHANNEL_TX(0), true);
+    }
+
+    if (status == 0) {
+        printf("\n  Measuring %u pulses...\n", config.iterations);
+        status = bladerf_measure_latency(state->dev, &config, &result);
+    }
+
+    disable_status =
+        bladerf_enable_module(state->dev, BLADERF_CHANNEL_TX(0), false);
+    if (status == 0) {
+        status = disable_status;
+    }
+
+    disable_status =
+        bladerf_enable_module(state->dev, BLADERF_CHANNEL_RX(0), false);
+    if (status == 0) {
+        status = disable_status;
+    }
+
+    if (status != 0) {
+        state->last_lib_error = status;
+        return CLI_RET_LIBBLADERF;
+    }
+
+    printf("\n  Latency (us):\n\n");
+    printf("    %-12s %8s %10s %10s %10s %10s %10s %10s\n", "Path", "Count",
+           "Min", "Mean", "p50", "p90", "p99", "Max");
+    print_dist("Host to RF", &result.host_to_rf);
+    print_dist("RF to host", &result.rf_to_host);
+
+    if (result.missed != 0) {
+        printf("\n  %u pulses were not received. Is loopback enabled?\n",
+               result.missed);
+    }
+
+    printf("\n");
+    return 0;
+}
@@ -0,0 +1,81 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <inttypes.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <conversions.h>
+
+#include "cmd.h"
+
+#define LINK_TEST_DEFAULT_MS 5000
+
+int cmd_linktest(struct cli_state *state, int argc, char **argv)
+{
+    struct bladerf_link_test_result r;
+    unsigned int duration_ms = LINK_TEST_DEFAULT_MS;
+    unsigned int i;
+    bool ok;
+    int status;
+
+    if (argc > 2) {
+        return CLI_RET_NARGS;
+    }
+
+    if (argc == 2) {
+        duration_ms = str2uint(argv[1], 1, UINT_MAX, &ok);
+        if (!ok) {
+            cli_err(state, argv[0], "Invalid duration: %s\n", argv[1]);
+            return CLI_RET_INVPARAM;
+        }
+    }
+
+    printf("\n  Running link test for %u ms...\n", duration_ms);
+
+    status = bladerf_link_test(state->dev, duration_ms, &r);
+
+    printf("\n  Checked %" PRIu64 " samples in %.3f s (%.3f Msps)\n",
+           r.samples, r.seconds, r.throughput / 1e6);
+    printf("  Gaps: %" PRIu64 ", dropped samples: %" PRIu64 "\n", r.gaps,
+           r.dropped);
+
+    if (r.num_gaps > 0) {
+        printf("\n    %-16s %-10s %-10s\n", "Sample", "Expected", "Received");
+
+        for (i = 0; i < r.num_gaps; i++) {
+            printf("    %-16" PRIu64 " 0x%08" PRIx32 " 0x%08" PRIx32 "\n",
+                   r.gap[i].sample, r.gap[i].expected, r.gap[i].received);
+        }
+
+        if (r.gaps > r.num_gaps) {
+            printf("    ... and %" PRIu64 " more\n", r.gaps - r.num_gaps);
+        }
+    }
+
+    printf("\n");
+
+    if (status != 0) {
+        state->last_lib_error = status;
+        return CLI_RET_LIBBLADERF;
+    }
+
+    return 0;
+}
@@ -214,6 +214,37 @@ bool ps_is_board(struct bladerf *dev, enum ps_board_option board)
     return false;
 }
 
+const struct bladerf_channel_state *ps_snapshot_chan(struct cli_state *state,
+                                                     bladerf_channel ch,
+                                                     uint32_t flag)
+{
+    unsigned int i;
+
+    if (NULL == state->snapshot) {
+        return NULL;
+    }
+
+    for (i = 0; i < state->snapshot->num_channels; ++i) {
+        const struct bladerf_channel_state *c = &state->snapshot->channels[i];
+
+        if (c->channel == ch) {
+            return ((c->valid & flag) == flag) ? c : NULL;
+        }
+    }
+
+    return NULL;
+}
+
+const struct bladerf_device_state *ps_snapshot_dev(struct cli_state *state,
+                                                   uint32_t flag)
+{
+    if (NULL == state->snapshot || !(state->snapshot->valid & flag)) {
+        return NULL;
+    }
+
+    return state->snapshot;
+}
+
 struct printset_entry *get_printset_entry(char *name)
 {
     struct printset_entry *entry = NULL;
@@ -233,6 +264,7 @@ int cmd_print(struct cli_state *state, int argc, char **argv)
     int rv   = CLI_RET_OK;
     int *err = &state->last_lib_error;
     struct printset_entry *entry;
+    struct bladerf_device_state snapshot;
     char *empty_argv[3];
     int empty_argc;
 
@@ -255,6 +287,13 @@ int cmd_print(struct cli_state *state, int argc, char **argv)
            supplied as argv[1]. */
         empty_argv[0] = argv[0];
 
+        /* Read back the common settings in one pass, rather than one call
+         * per setting. Entries fall back to querying the device for
+         * anything missing from the snapshot. */
+        if (bladerf_get_device_state(state->dev, &snapshot) == 0) {
+            state->snapshot = &snapshot;
+        }
+
         for (entry = &printset_table[0]; entry->print != NULL; entry++) {
             if (entry->pa_option == PRINTALL_OPTION_SKIP) {
                 continue;
@@ -276,6 +315,7 @@ int cmd_print(struct cli_state *state, int argc, char **argv)
             rv = entry->print(state, empty_argc, (char **)empty_argv);
             if (rv != CLI_RET_OK) {
                 if (cli_fatal(rv)) {
+                    state->snapshot = NULL;
                     return rv;
                 }
 
@@ -293,6 +333,8 @@ int cmd_print(struct cli_state *state, int argc, char **argv)
                 printf("\n");
             }
         }
+
+        state->snapshot = NULL;
     }
 
     printf("\n");
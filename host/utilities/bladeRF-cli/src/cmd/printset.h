@@ -61,6 +61,33 @@ int ps_foreach_chan(struct cli_state *state,
  */
 bool ps_is_board(struct bladerf *dev, enum ps_board_option board);
 
+/**
+ * @brief      look up a channel's settings in the snapshot taken by "print"
+ *
+ * @param      state  CLI state structure
+ * @param[in]  ch     channel
+ * @param[in]  flag   BLADERF_CHAN_STATE_* flag of the setting required, or
+ *                    0 for just the gain stages
+ *
+ * @return     the channel's settings, or NULL if there is no snapshot, or it
+ *             lacks that setting
+ */
+const struct bladerf_channel_state *ps_snapshot_chan(struct cli_state *state,
+                                                     bladerf_channel ch,
+                                                     uint32_t flag);
+
+/**
+ * @brief      look up device settings in the snapshot taken by "print"
+ *
+ * @param      state  CLI state structure
+ * @param[in]  flag   BLADERF_DEV_STATE_* flag of the setting required
+ *
+ * @return     the device's settings, or NULL if there is no snapshot, or it
+ *             lacks that setting
+ */
+const struct bladerf_device_state *ps_snapshot_dev(struct cli_state *state,
+                                                   uint32_t flag);
+
 /* printset_hardware.c */
 int print_hardware(struct cli_state *state, int argc, char **argv);
 int print_clock_ref(struct cli_state *state, int argc, char **argv);
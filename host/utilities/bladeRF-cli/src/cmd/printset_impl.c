@@ -30,8 +30,16 @@ static int _do_print_agc(struct cli_state *state, bladerf_channel ch, void *arg)
     int status;
 
     bladerf_gain_mode mode = BLADERF_GAIN_DEFAULT;
+    struct bladerf_channel_state const *snap =
+        ps_snapshot_chan(state, ch, BLADERF_CHAN_STATE_GAIN_MODE);
+
+    if (snap != NULL) {
+        mode   = snap->gain_mode;
+        status = 0;
+    } else {
+        status = bladerf_get_gain_mode(state->dev, ch, &mode);
+    }
 
-    status = bladerf_get_gain_mode(state->dev, ch, &mode);
     if (status < 0) {
         *err = status;
         rv   = CLI_RET_LIBBLADERF;
@@ -141,6 +149,7 @@ static int _do_print_bandwidth(struct cli_state *state,
     int status;
 
     struct bladerf_range const *range;
+    struct bladerf_channel_state const *snap;
     bladerf_bandwidth bw;
 
     status = bladerf_get_bandwidth_range(state->dev, ch, &range);
@@ -150,7 +159,13 @@ static int _do_print_bandwidth(struct cli_state *state,
         goto out;
     };
 
-    status = bladerf_get_bandwidth(state->dev, ch, &bw);
+    snap = ps_snapshot_chan(state, ch, BLADERF_CHAN_STATE_BANDWIDTH);
+    if (snap != NULL) {
+        bw = snap->bandwidth;
+    } else {
+        status = bladerf_get_bandwidth(state->dev, ch, &bw);
+    }
+
     if (status < 0) {
         *err = status;
         rv   = CLI_RET_LIBBLADERF;
@@ -483,6 +498,7 @@ static int _do_print_frequency(struct cli_state *state,
     int status;
 
     struct bladerf_range const *range;
+    struct bladerf_channel_state const *snap;
     bladerf_frequency freq;
 
     status = bladerf_get_frequency_range(state->dev, ch, &range);
@@ -492,7 +508,13 @@ static int _do_print_frequency(struct cli_state *state,
         goto out;
     };
 
-    status = bladerf_get_frequency(state->dev, ch, &freq);
+    snap = ps_snapshot_chan(state, ch, BLADERF_CHAN_STATE_FREQUENCY);
+    if (snap != NULL) {
+        freq = snap->frequency;
+    } else {
+        status = bladerf_get_frequency(state->dev, ch, &freq);
+    }
+
     if (status < 0) {
         *err = status;
         rv   = CLI_RET_LIBBLADERF;
@@ -647,11 +669,13 @@ static int _do_print_gain(struct cli_state *state,
     char **stages;
 
     struct bladerf_range const *range = NULL;
+    struct bladerf_channel_state const *snap;
 
     bool printed = false;
     int gain;
     int count;
     int i;
+    unsigned int j;
 
     stages = calloc(max_count, sizeof(char *));
     if (NULL == stages) {
@@ -668,7 +692,13 @@ static int _do_print_gain(struct cli_state *state,
             goto out;
         };
 
-        status = bladerf_get_gain(state->dev, ch, &gain);
+        snap = ps_snapshot_chan(state, ch, BLADERF_CHAN_STATE_GAIN);
+        if (snap != NULL) {
+            gain = snap->gain;
+        } else {
+            status = bladerf_get_gain(state->dev, ch, &gain);
+        }
+
         if (status < 0) {
             *err = status;
             rv   = CLI_RET_LIBBLADERF;
@@ -702,7 +732,19 @@ static int _do_print_gain(struct cli_state *state,
         };
 
         /* Get the current value of the gain stage */
-        status = bladerf_get_gain_stage(state->dev, ch, stages[i], &gain);
+        snap = ps_snapshot_chan(state, ch, 0);
+        for (j = 0; snap != NULL && j < snap->num_stages; ++j) {
+            if (0 == strcmp(snap->stages[j].name, stages[i])) {
+                break;
+            }
+        }
+
+        if (snap != NULL && j < snap->num_stages) {
+            gain = snap->stages[j].gain;
+        } else {
+            status = bladerf_get_gain_stage(state->dev, ch, stages[i], &gain);
+        }
+
         if (status < 0) {
             *err = status;
             rv   = CLI_RET_LIBBLADERF;
@@ -944,8 +986,16 @@ int print_loopback(struct cli_state *state, int argc, char **argv)
     int status;
 
     bladerf_loopback loopback;
+    struct bladerf_device_state const *snap =
+        ps_snapshot_dev(state, BLADERF_DEV_STATE_LOOPBACK);
+
+    if (snap != NULL) {
+        loopback = snap->loopback;
+        status   = 0;
+    } else {
+        status = bladerf_get_loopback(state->dev, &loopback);
+    }
 
-    status = bladerf_get_loopback(state->dev, &loopback);
     if (status != 0) {
         *err = status;
         rv   = CLI_RET_LIBBLADERF;
@@ -1088,8 +1138,16 @@ int print_rx_mux(struct cli_state *state, int argc, char **argv)
 
     const char *mux_str;
     bladerf_rx_mux mux_setting;
+    struct bladerf_device_state const *snap =
+        ps_snapshot_dev(state, BLADERF_DEV_STATE_RX_MUX);
+
+    if (snap != NULL) {
+        mux_setting = snap->rx_mux;
+        status      = 0;
+    } else {
+        status = bladerf_get_rx_mux(state->dev, &mux_setting);
+    }
 
-    status = bladerf_get_rx_mux(state->dev, &mux_setting);
     if (status < 0) {
         *err = status;
         rv   = CLI_RET_LIBBLADERF;
@@ -1172,8 +1230,16 @@ int print_tuning_mode(struct cli_state *state, int argc, char **argv)
     int status;
 
     bladerf_tuning_mode mode;
+    struct bladerf_device_state const *snap =
+        ps_snapshot_dev(state, BLADERF_DEV_STATE_TUNING_MODE);
+
+    if (snap != NULL) {
+        mode   = snap->tuning_mode;
+        status = 0;
+    } else {
+        status = bladerf_get_tuning_mode(state->dev, &mode);
+    }
 
-    status = bladerf_get_tuning_mode(state->dev, &mode);
     if (status < 0) {
         *err = status;
         rv   = CLI_RET_LIBBLADERF;
@@ -1404,6 +1470,7 @@ static int _do_print_samplerate(struct cli_state *state,
     int status;
 
     struct bladerf_range const *range;
+    struct bladerf_channel_state const *snap;
     struct bladerf_rational_rate rate;
 
     status = bladerf_get_sample_rate_range(state->dev, ch, &range);
@@ -1413,7 +1480,13 @@ static int _do_print_samplerate(struct cli_state *state,
         goto out;
     };
 
-    status = bladerf_get_rational_sample_rate(state->dev, ch, &rate);
+    snap = ps_snapshot_chan(state, ch, BLADERF_CHAN_STATE_SAMPLERATE);
+    if (snap != NULL) {
+        rate = snap->samplerate;
+    } else {
+        status = bladerf_get_rational_sample_rate(state->dev, ch, &rate);
+    }
+
     if (status < 0) {
         *err = status;
         rv   = CLI_RET_LIBBLADERF;
@@ -1853,6 +1926,8 @@ int print_trimdac(struct cli_state *state, int argc, char **argv)
     int status;
 
     uint16_t curr, cal;
+    struct bladerf_device_state const *snap =
+        ps_snapshot_dev(state, BLADERF_DEV_STATE_TRIM_DAC);
 
     status = bladerf_get_vctcxo_trim(state->dev, &cal);
     if (status != 0) {
@@ -1860,7 +1935,12 @@ int print_trimdac(struct cli_state *state, int argc, char **argv)
         return CLI_RET_LIBBLADERF;
     }
 
-    status = bladerf_dac_read(state->dev, &curr);
+    if (snap != NULL) {
+        curr = snap->trim_dac;
+    } else {
+        status = bladerf_dac_read(state->dev, &curr);
+    }
+
     if (status != 0) {
         *err = status;
         return CLI_RET_LIBBLADERF;
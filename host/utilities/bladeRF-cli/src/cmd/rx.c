@@ -17,58 +17,149 @@
  * with this program; if not, write to the Free Software Foundation, Inc.,
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* For O_DIRECT and vmsplice() */
+#endif
+
 #include <errno.h>
 #include <inttypes.h>
 #include <limits.h>
+#include <math.h>
 #include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
+#include "dsp.h"
+#include "fileset.h"
 #include "host_config.h"
+#include "iqz.h"
 #include "minmax.h"
 #include "rel_assert.h"
 #include "rxtx_impl.h"
+#include "sigmf.h"
+#include "vita49.h"
 
 #if BLADERF_OS_WINDOWS
 #define EOL "\r\n"
 #else
 #define EOL "\n"
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#endif
+
+/* Alignment of the recording buffers. This satisfies O_DIRECT's requirements
+ * for the buffer address, length, and file offset on common devices. */
+#define RX_WRITER_ALIGNMENT 4096
+
+#if !BLADERF_OS_WINDOWS && defined(O_DIRECT)
+#define RX_WRITER_HAVE_DIRECT_IO 1
+#endif
+
+#if defined(__linux__) && defined(SPLICE_F_GIFT)
+#define RX_WRITER_HAVE_SPLICE 1
 #endif
 
+/* Interval at which the writer checks how much of the spliced data a pipe's
+ * reader has consumed, when it has nothing else to do */
+#define RX_WRITER_RECLAIM_NS 1000000
+
+/* Whether a capture is written through a file set, rather than the file
+ * opened by rx_cmd_start()
+ *
+ * @pre param_lock is held */
+static bool rx_use_fileset(const struct rx_params *rx_params)
+{
+    return rx_params->planar || rx_params->file_size != 0 ||
+           rx_params->file_time_ms != 0;
+}
+
+/* Ring of sample buffers drained to the output file by a dedicated thread, so
+ * that the RX thread only ever waits on disk when the whole ring is full.
+ *
+ * For a pre-trigger capture, the RX thread instead holds up to `hold_max` of
+ * the most recent buffers in the ring, and queues them all for writing when
+ * triggered. Held buffers are always the newest in the ring, and are only
+ * ever touched by the RX thread. */
+struct rx_writer {
+    struct cli_state *s;
+    int (*write_samples)(struct cli_state *s, void *samples, size_t n,
+                         uint64_t timestamp);
+
+    pthread_t thread;
+    MUTEX lock;
+    pthread_cond_t filled;      /* A buffer was queued, or shutdown */
+    pthread_cond_t emptied;     /* A buffer was written, or writing failed */
+
+    void **bufs;                /* Ring of `depth` buffers */
+    size_t *n_samples;          /* # of samples queued in each buffer */
+    uint64_t *timestamps;       /* Timestamp of each buffer's first sample */
+    size_t buf_size;            /* Size of each buffer, in bytes */
+    size_t sample_size;         /* Size of an I/Q pair as written, in bytes */
+    unsigned int depth;
+    unsigned int head;          /* Next buffer to be filled */
+    unsigned int count;         /* # of buffers queued for writing */
+    unsigned int held;          /* # of buffers held until a trigger */
+    unsigned int hold_max;      /* Max # of buffers held */
+    bool host_order;            /* Samples are queued in host byte order */
+    bool done;                  /* No more buffers will be queued */
+    int status;                 /* First write failure, as a CLI_RET_* */
+
+    int fd;                     /* Descriptor with O_DIRECT set, or -1 */
+    int fd_flags;               /* Descriptor's original file status flags */
+
+    /* A pipe's reader may fall behind without blocking the RX thread. When
+     * the ring is full, buffers are received into `discard` and dropped. */
+    bool pipe;                  /* Output is a pipe or FIFO */
+    bool drop;                  /* Drop buffers, rather than wait for one */
+    bool dropping;              /* The last buffer acquired is `discard` */
+    void *discard;
+    uint64_t dropped;           /* # of samples dropped */
+
+    /* Spliced buffers are referenced by the pipe, not copied into it, so
+     * each stays queued until the reader has consumed it */
+    int splice_fd;              /* Pipe buffers are vmsplice()d into, or -1 */
+    uint64_t spliced;           /* # of bytes spliced */
+    uint64_t *splice_end;       /* `spliced` after each buffer was spliced */
+    unsigned int in_pipe;       /* # of oldest queued buffers in the pipe */
+};
+
 /**
- * Peform adjustments on received samples before writing them out:
- *  (1) Mask off FPGA markers
- *  (2) Convert little-endian samples to host endianness, if needed.
+ * Convert received little-endian samples to host endianness, if needed.
  *
- *  @param  buff    Sample buffer
+ * SC8 Q7 samples are single bytes and are never modified. On little-endian
+ * hosts this is a no-op, and compiles away entirely.
+ *
+ *  @param  s       CLI state, used to determine the sample format
+ *  @param  buf     Sample buffer
  *  @param  n       Number of samples
  */
-static inline void sc16q11_sample_fixup(int16_t *buf, size_t n)
+static inline void rx_sample_fixup(struct cli_state *s, void *buf, size_t n)
 {
+#if BLADERF_BIG_ENDIAN
+    uint16_t *val = buf;
     size_t i;
 
-    for (i = 0; i < n; i++) {
-        /* I - Mask off the marker and sign extend */
-        //        *buf &= (*buf) & 0x0fff;
-        //        if (*buf & 0x800) {
-        //            *buf |= 0xf000;
-        //        }
-
-        *buf = LE16_TO_HOST(*buf);
-        buf++;
-
-        /* Q - Mask off the marker and sign extend */
-        //        *buf = HOST_TO_LE16(*buf) & 0x0fff;
-        //        if (*buf & 0x800) {
-        //            *buf |= 0xf000;
-        //        }
+    if (s->bit_mode_8bit) {
+        return;
+    }
 
-        *buf = LE16_TO_HOST(*buf);
-        buf++;
+    /* This simple loop over both I and Q is vectorized into byte shuffles */
+    for (i = 0; i < 2 * n; i++) {
+        val[i] = (uint16_t)((val[i] << 8) | (val[i] >> 8));
     }
+#endif
 }
 
 /*
@@ -77,7 +168,8 @@ static inline void sc16q11_sample_fixup(int16_t *buf, size_t n)
  * returns 0 on success, CLI_RET_* on failure (and calls set_last_error()) */
 static int rx_write_bin_sc16q11(struct cli_state *s,
                                 void *samples,
-                                size_t n_samples)
+                                size_t n_samples,
+                                uint64_t timestamp)
 {
     size_t status;
     struct rxtx_data *rx = s->rx;
@@ -102,7 +194,8 @@ static int rx_write_bin_sc16q11(struct cli_state *s,
  * returns 0 on success, CLI_RET_* on failure (and calls set_last_error()) */
 static int rx_write_bin_sc8q7(struct cli_state *s,
                                 void *samples,
-                                size_t n_samples)
+                                size_t n_samples,
+                                uint64_t timestamp)
 {
     size_t status;
     struct rxtx_data *rx = s->rx;
@@ -121,15 +214,46 @@ static int rx_write_bin_sc8q7(struct cli_state *s,
     }
 }
 
+/* Format `val` in decimal at `p`, returning a pointer past the last
+ * character written */
+static inline char *rx_csv_format_int(char *p, int val)
+{
+    char digits[8];
+    unsigned int u;
+    size_t n = 0;
+
+    if (val < 0) {
+        *p++ = '-';
+        u    = 0u - (unsigned int)val;
+    } else {
+        u = (unsigned int)val;
+    }
+
+    do {
+        digits[n++] = (char)('0' + (u % 10));
+        u /= 10;
+    } while (u != 0);
+
+    while (n > 0) {
+        *p++ = digits[--n];
+    }
+
+    return p;
+}
+
+/* Longest formatted I/Q pair: "-32768, -32768, " */
+#define RX_CSV_PAIR_MAXLEN 16
+
 /* returns 0 on success, CLI_RET_* on failure (and calls set_last_error()) */
 static int rx_write_csv(struct cli_state *s,
                         void *samples,
-                        size_t n_samples)
+                        size_t n_samples,
+                        uint64_t timestamp)
 {
-    const size_t MAXLEN = 128; /* max line length (with newline and null) */
+    const size_t eol_len = strlen(EOL);
 
-    char *line = NULL;
-    char *tmp  = NULL;
+    char *text = NULL;
+    char *p;
     int8_t *samples_sc8q7;
     int16_t *samples_sc16q11;
     struct rxtx_data *rx = s->rx;
@@ -152,151 +276,1387 @@ static int rx_write_csv(struct cli_state *s,
     }
     MUTEX_UNLOCK(&rx->data_mgmt.lock);
 
-    if (status != 0) {
-        goto out;
+    if (status != 0) {
+        goto out;
+    }
+
+    /* The whole buffer is formatted into memory and written at once, rather
+     * than using stdio per sample */
+    text = malloc(n_samples * RX_CSV_PAIR_MAXLEN +
+                  (n_samples / nchans + 1) * eol_len);
+    if (NULL == text) {
+        status = errno;
+        set_last_error(&rx->last_error, ETYPE_ERRNO, status);
+        goto out;
+    }
+
+    p = text;
+
+    // Output 2 columns for each enabled channel
+    // (2 cols for BLADERF_RX_X1, 4 cols for BLADERF_RX_X2, etc)
+    if (s->bit_mode_8bit) {
+        samples_sc8q7 = (int8_t*)samples;
+
+        for (i = 0; i < 2 * n_samples; i += 2 * nchans) {
+            for (j = 0; j < 2 * nchans; j += 2) {
+                if (j > 0) {
+                    *p++ = ',';
+                    *p++ = ' ';
+                }
+
+                p    = rx_csv_format_int(p, samples_sc8q7[i + j]);
+                *p++ = ',';
+                *p++ = ' ';
+                p    = rx_csv_format_int(p, samples_sc8q7[i + j + 1]);
+            }
+
+            memcpy(p, EOL, eol_len);
+            p += eol_len;
+        }
+    } else {
+        samples_sc16q11 = (int16_t*)samples;
+
+        for (i = 0; i < 2 * n_samples; i += 2 * nchans) {
+            for (j = 0; j < 2 * nchans; j += 2) {
+                if (j > 0) {
+                    *p++ = ',';
+                    *p++ = ' ';
+                }
+
+                p    = rx_csv_format_int(p, samples_sc16q11[i + j]);
+                *p++ = ',';
+                *p++ = ' ';
+                p    = rx_csv_format_int(p, samples_sc16q11[i + j + 1]);
+            }
+
+            memcpy(p, EOL, eol_len);
+            p += eol_len;
+        }
+    }
+
+    MUTEX_LOCK(&rx->file_mgmt.file_lock);
+
+    if (fwrite(text, 1, p - text, rx->file_mgmt.file) != (size_t)(p - text)) {
+        set_last_error(&rx->last_error, ETYPE_ERRNO, errno);
+        status = CLI_RET_FILEOP;
+    }
+
+    MUTEX_UNLOCK(&rx->file_mgmt.file_lock);
+
+out:
+    free(text);
+
+    return status;
+}
+
+/* Send samples to the VITA-49 sink of the running capture. The sink is only
+ * opened and closed while no samples are being written.
+ *
+ * returns 0 on success, CLI_RET_* on failure (and calls set_last_error()) */
+/* returns 0 on success, CLI_RET_* on failure (and calls set_last_error()) */
+static int rx_write_fileset(struct cli_state *s,
+                            void *samples,
+                            size_t n_samples,
+                            uint64_t timestamp)
+{
+    struct rxtx_data *rx        = s->rx;
+    struct rx_params *rx_params = rx->params;
+    int status;
+
+    status = fileset_write(rx_params->fileset, samples, n_samples, timestamp);
+    if (status != 0) {
+        set_last_error(&rx->last_error, ETYPE_CLI, status);
+    }
+
+    return status;
+}
+
+static int rx_write_vita49(struct cli_state *s,
+                           void *samples,
+                           size_t n_samples,
+                           uint64_t timestamp)
+{
+    struct rxtx_data *rx        = s->rx;
+    struct rx_params *rx_params = rx->params;
+    int status;
+
+    status = vita49_sink_send(rx_params->vita49, samples, n_samples,
+                              timestamp);
+    if (status != 0) {
+        set_last_error(&rx->last_error, ETYPE_ERRNO, status);
+        return CLI_RET_FILEOP;
+    }
+
+    return 0;
+}
+
+/* Compress samples into the running IQZ capture
+ *
+ * returns 0 on success, CLI_RET_* on failure (and calls set_last_error()) */
+static int rx_write_iqz(struct cli_state *s,
+                        void *samples,
+                        size_t n_samples,
+                        uint64_t timestamp)
+{
+    struct rxtx_data *rx        = s->rx;
+    struct rx_params *rx_params = rx->params;
+    int status;
+
+    status = iqz_writer_write(rx_params->iqz, samples, n_samples);
+    if (status != 0) {
+        set_last_error(&rx->last_error, ETYPE_ERRNO, status);
+        return CLI_RET_FILEOP;
+    }
+
+    return 0;
+}
+
+/* State of a SigMF capture */
+struct rx_sigmf {
+    struct sigmf_capture_info info;
+    struct sigmf_index index;
+    char hw[64];
+};
+
+/* returns 0 on success, CLI_RET_* on failure (and calls set_last_error()) */
+static int rx_sigmf_begin(struct cli_state *s, struct rx_sigmf *sigmf)
+{
+    struct rxtx_data *rx = s->rx;
+    struct bladerf_serial serial;
+    bladerf_sample_rate rate = 0;
+    bladerf_frequency freq   = 0;
+    bladerf_channel_layout layout;
+    time_t now;
+    int status = 0;
+    int i;
+
+    memset(sigmf, 0, sizeof(*sigmf));
+
+    MUTEX_LOCK(&rx->data_mgmt.lock);
+    layout = rx->data_mgmt.layout;
+    MUTEX_UNLOCK(&rx->data_mgmt.lock);
+
+    sigmf->info.sc8          = s->bit_mode_8bit;
+    sigmf->info.num_channels = (layout == BLADERF_RX_X2) ? 2 : 1;
+
+    /* Describe the capture using the first enabled channel */
+    MUTEX_LOCK(&rx->param_lock);
+    for (i = 0; i < RXTX_MAX_CHANNELS; ++i) {
+        if (rx->channel_enable[i]) {
+            status = bladerf_get_sample_rate(s->dev, BLADERF_CHANNEL_RX(i),
+                                             &rate);
+            if (status == 0) {
+                status = bladerf_get_frequency(s->dev, BLADERF_CHANNEL_RX(i),
+                                               &freq);
+            }
+            break;
+        }
+    }
+    MUTEX_UNLOCK(&rx->param_lock);
+
+    if (status != 0) {
+        set_last_error(&rx->last_error, ETYPE_BLADERF, status);
+        return CLI_RET_LIBBLADERF;
+    }
+
+    sigmf->info.sample_rate = rate;
+    sigmf->info.frequency   = freq;
+
+    if (bladerf_get_serial_struct(s->dev, &serial) == 0) {
+        snprintf(sigmf->hw, sizeof(sigmf->hw), "%s (serial %s)",
+                 bladerf_get_board_name(s->dev), serial.serial);
+        sigmf->info.hw = sigmf->hw;
+    }
+
+    now = time(NULL);
+    strftime(sigmf->info.datetime, sizeof(sigmf->info.datetime),
+             "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    /* Record an index entry about once per second, at least */
+    sigmf_index_init(&sigmf->index, rate);
+
+    return 0;
+}
+
+/* Write the meta file of a SigMF capture and release its index.
+ *
+ * returns 0 on success, CLI_RET_* on failure (and calls set_last_error()) */
+static int rx_sigmf_end(struct cli_state *s, struct rx_sigmf *sigmf)
+{
+    struct rxtx_data *rx = s->rx;
+    int status;
+
+    MUTEX_LOCK(&rx->file_mgmt.file_meta_lock);
+    status = sigmf_write_meta(rx->file_mgmt.path, &sigmf->info,
+                              &sigmf->index);
+    MUTEX_UNLOCK(&rx->file_mgmt.file_meta_lock);
+
+    sigmf_index_free(&sigmf->index);
+
+    if (status != 0) {
+        set_last_error(&rx->last_error, ETYPE_CLI, status);
+    }
+
+    return status;
+}
+
+/* Index the timestamp of a buffer of `n` samples in a SigMF capture
+ *
+ * returns 0 on success, CLI_RET_* on failure (and calls set_last_error()) */
+static int rx_sigmf_index(struct cli_state *s,
+                          struct rx_sigmf *sigmf,
+                          uint64_t timestamp,
+                          size_t n)
+{
+    int status;
+
+    /* Timestamps count per-channel samples */
+    status = sigmf_index_update(&sigmf->index, timestamp,
+                                n / sigmf->info.num_channels);
+    if (status != 0) {
+        set_last_error(&s->rx->last_error, ETYPE_CLI, status);
+    }
+
+    return status;
+}
+
+/* Receive a buffer of samples. If `timestamped` is set, the stream carries
+ * metadata and *timestamp is set to that of the first sample. Otherwise, it
+ * is set to 0. The timestamps are also indexed if `sigmf` is not NULL.
+ *
+ * *n_received is set to the number of samples placed in `samples`, which is
+ * less than `n` after an overrun in a timestamped capture.
+ *
+ * returns 0 on success, or a BLADERF_ERR_* or CLI_RET_* value on failure
+ * (and calls set_last_error()) */
+static int rx_receive(struct cli_state *s,
+                      struct rx_sigmf *sigmf,
+                      bool timestamped,
+                      void *samples,
+                      unsigned int n,
+                      unsigned int timeout_ms,
+                      unsigned int *n_received,
+                      uint64_t *timestamp)
+{
+    struct rxtx_data *rx = s->rx;
+    struct bladerf_metadata meta;
+    int status;
+
+    *timestamp = 0;
+
+    if (!timestamped) {
+        status = bladerf_sync_rx(s->dev, samples, n, NULL, timeout_ms);
+        if (status != 0) {
+            set_last_error(&rx->last_error, ETYPE_BLADERF, status);
+        }
+
+        *n_received = n;
+        return status;
+    }
+
+    memset(&meta, 0, sizeof(meta));
+    meta.flags = BLADERF_META_FLAG_RX_NOW;
+
+    status = bladerf_sync_rx(s->dev, samples, n, &meta, timeout_ms);
+    if (status != 0) {
+        set_last_error(&rx->last_error, ETYPE_BLADERF, status);
+        return status;
+    }
+
+    *n_received = meta.actual_count;
+    *timestamp  = meta.timestamp;
+
+    if (sigmf == NULL) {
+        return 0;
+    }
+
+    return rx_sigmf_index(s, sigmf, meta.timestamp, meta.actual_count);
+}
+
+static void *rx_writer_alloc_buf(size_t size)
+{
+    void *buf;
+
+#if BLADERF_OS_WINDOWS
+    buf = _aligned_malloc(size, RX_WRITER_ALIGNMENT);
+#else
+    if (posix_memalign(&buf, RX_WRITER_ALIGNMENT, size) != 0) {
+        buf = NULL;
+    }
+#endif
+
+    return buf;
+}
+
+static void rx_writer_free_buf(void *buf)
+{
+#if BLADERF_OS_WINDOWS
+    _aligned_free(buf);
+#else
+    free(buf);
+#endif
+}
+
+#ifdef RX_WRITER_HAVE_DIRECT_IO
+/* Switch the output file to unbuffered I/O for binary formats. The file has
+ * just been opened and truncated, so every full buffer lands at an aligned
+ * offset. Failure is harmless; writes just go through the page cache. */
+static void rx_writer_enable_direct_io(struct rx_writer *w)
+{
+    struct rxtx_data *rx = w->s->rx;
+    int fd;
+
+    /* On a pipe, O_DIRECT selects packet mode instead */
+    if ((w->write_samples != rx_write_bin_sc16q11 &&
+         w->write_samples != rx_write_bin_sc8q7) ||
+        w->buf_size % RX_WRITER_ALIGNMENT != 0 || w->pipe) {
+        return;
+    }
+
+    MUTEX_LOCK(&rx->file_mgmt.file_lock);
+
+    if (fflush(rx->file_mgmt.file) == 0) {
+        fd          = fileno(rx->file_mgmt.file);
+        w->fd_flags = fcntl(fd, F_GETFL);
+
+        if (w->fd_flags != -1 &&
+            fcntl(fd, F_SETFL, w->fd_flags | O_DIRECT) == 0) {
+            w->fd = fd;
+        }
+    }
+
+    MUTEX_UNLOCK(&rx->file_mgmt.file_lock);
+}
+
+static void rx_writer_disable_direct_io(struct rx_writer *w)
+{
+    if (w->fd >= 0) {
+        fcntl(w->fd, F_SETFL, w->fd_flags);
+    }
+}
+
+static int rx_writer_write_fd(struct rx_writer *w, void *samples, size_t n)
+{
+    struct rxtx_data *rx = w->s->rx;
+    uint8_t *buf         = samples;
+    size_t len           = n * w->sample_size;
+    ssize_t written;
+    int status = 0;
+
+    MUTEX_LOCK(&rx->file_mgmt.file_lock);
+
+    /* A partial buffer would leave the file offset unaligned */
+    if (len % RX_WRITER_ALIGNMENT != 0) {
+        rx_writer_disable_direct_io(w);
+    }
+
+    while (len > 0) {
+        written = write(w->fd, buf, len);
+
+        if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written < 0 && errno == EINVAL &&
+                   (fcntl(w->fd, F_GETFL) & O_DIRECT)) {
+            /* The filesystem rejected direct I/O after all */
+            rx_writer_disable_direct_io(w);
+            continue;
+        } else if (written <= 0) {
+            set_last_error(&rx->last_error, ETYPE_ERRNO,
+                           written < 0 ? errno : EIO);
+            status = CLI_RET_FILEOP;
+            break;
+        }
+
+        buf += written;
+        len -= written;
+    }
+
+    MUTEX_UNLOCK(&rx->file_mgmt.file_lock);
+
+    return status;
+}
+#endif
+
+#if !BLADERF_OS_WINDOWS
+static bool rx_writer_output_is_pipe(struct rx_writer *w)
+{
+    struct rxtx_data *rx = w->s->rx;
+    struct stat st;
+    bool is_pipe = false;
+
+    MUTEX_LOCK(&rx->file_mgmt.file_lock);
+
+    if (rx->file_mgmt.file != NULL &&
+        fstat(fileno(rx->file_mgmt.file), &st) == 0) {
+        is_pipe = S_ISFIFO(st.st_mode);
+    }
+
+    MUTEX_UNLOCK(&rx->file_mgmt.file_lock);
+
+    return is_pipe;
+}
+#endif
+
+#ifdef RX_WRITER_HAVE_SPLICE
+/* Splice binary formats' buffers into a pipe output. Failure is harmless;
+ * samples are just copied into the pipe. */
+static void rx_writer_enable_splice(struct rx_writer *w)
+{
+    struct rxtx_data *rx = w->s->rx;
+    int fd, queued;
+
+    if ((w->write_samples != rx_write_bin_sc16q11 &&
+         w->write_samples != rx_write_bin_sc8q7) ||
+        !w->pipe) {
+        return;
+    }
+
+    w->splice_end = calloc(w->depth, sizeof(w->splice_end[0]));
+    if (w->splice_end == NULL) {
+        return;
+    }
+
+    MUTEX_LOCK(&rx->file_mgmt.file_lock);
+
+    /* Buffers are reclaimed by checking how much the pipe still holds */
+    if (fflush(rx->file_mgmt.file) == 0) {
+        fd = fileno(rx->file_mgmt.file);
+
+        if (ioctl(fd, FIONREAD, &queued) == 0) {
+            w->splice_fd = fd;
+        }
+    }
+
+    MUTEX_UNLOCK(&rx->file_mgmt.file_lock);
+}
+
+static int rx_writer_splice(struct rx_writer *w, void *samples, size_t n)
+{
+    struct rxtx_data *rx = w->s->rx;
+    struct iovec iov;
+    ssize_t spliced;
+    int status = 0;
+
+    iov.iov_base = samples;
+    iov.iov_len  = n * w->sample_size;
+
+    MUTEX_LOCK(&rx->file_mgmt.file_lock);
+
+    while (iov.iov_len > 0) {
+        spliced = vmsplice(w->splice_fd, &iov, 1, 0);
+
+        if (spliced < 0 && errno == EINTR) {
+            continue;
+        } else if (spliced <= 0) {
+            set_last_error(&rx->last_error, ETYPE_ERRNO,
+                           spliced < 0 ? errno : EIO);
+            status = CLI_RET_FILEOP;
+            break;
+        }
+
+        iov.iov_base = (uint8_t *)iov.iov_base + spliced;
+        iov.iov_len -= spliced;
+    }
+
+    MUTEX_UNLOCK(&rx->file_mgmt.file_lock);
+
+    return status;
+}
+
+/* Return the spliced buffers that the pipe's reader has consumed to the RX
+ * thread. If the reader has gone away, nothing more will be consumed, so
+ * they are all returned.
+ *
+ * @pre w->lock is held */
+static void rx_writer_reclaim(struct rx_writer *w)
+{
+    struct pollfd pfd;
+    uint64_t consumed = w->spliced;
+    unsigned int tail;
+    int queued;
+
+    if (w->in_pipe == 0) {
+        return;
+    }
+
+    pfd.fd      = w->splice_fd;
+    pfd.events  = POLLOUT;
+    pfd.revents = 0;
+
+    if (poll(&pfd, 1, 0) <= 0 || !(pfd.revents & POLLERR)) {
+        if (ioctl(w->splice_fd, FIONREAD, &queued) != 0) {
+            return;
+        }
+
+        /* A FIFO may also hold other writers' data */
+        consumed = ((uint64_t)queued < w->spliced) ? w->spliced - queued : 0;
+    }
+
+    while (w->in_pipe > 0) {
+        tail = (w->head + w->depth - w->count) % w->depth;
+        if (w->splice_end[tail] > consumed) {
+            break;
+        }
+
+        w->count--;
+        w->in_pipe--;
+        pthread_cond_signal(&w->emptied);
+    }
+}
+
+/* As rx_writer_task(), but splicing buffers into a pipe. Each stays queued,
+ * and is not refilled, until the reader has consumed it.
+ *
+ * @pre w->lock is held */
+static void rx_writer_task_splice(struct rx_writer *w)
+{
+    struct timespec deadline;
+    unsigned int next;
+    size_t n;
+    int status;
+
+    while (true) {
+        rx_writer_reclaim(w);
+
+        if (w->count > w->in_pipe) {
+            next = (w->head + w->depth - w->count + w->in_pipe) % w->depth;
+            n    = w->n_samples[next];
+
+            MUTEX_UNLOCK(&w->lock);
+
+            if (!w->host_order) {
+                rx_sample_fixup(w->s, w->bufs[next], n);
+            }
+
+            status = rx_writer_splice(w, w->bufs[next], n);
+
+            MUTEX_LOCK(&w->lock);
+
+            if (status != 0) {
+                w->status = status;
+                pthread_cond_signal(&w->emptied);
+                break;
+            }
+
+            w->spliced += n * w->sample_size;
+            w->splice_end[next] = w->spliced;
+            w->in_pipe++;
+        } else if (w->in_pipe > 0) {
+            /* Nothing signals that the reader has consumed data, so check
+             * again shortly, or as soon as another buffer is queued */
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += RX_WRITER_RECLAIM_NS;
+            if (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+
+            pthread_cond_timedwait(&w->filled, &w->lock, &deadline);
+        } else if (w->done) {
+            break;
+        } else {
+            pthread_cond_wait(&w->filled, &w->lock);
+        }
+    }
+}
+#endif
+
+static void *rx_writer_task(void *arg)
+{
+    struct rx_writer *w = arg;
+    unsigned int tail;
+    size_t n;
+    int status;
+
+    MUTEX_LOCK(&w->lock);
+
+#ifdef RX_WRITER_HAVE_SPLICE
+    if (w->splice_fd >= 0) {
+        rx_writer_task_splice(w);
+        MUTEX_UNLOCK(&w->lock);
+        return NULL;
+    }
+#endif
+
+    while (true) {
+        while (w->count == 0 && !w->done) {
+            pthread_cond_wait(&w->filled, &w->lock);
+        }
+
+        if (w->count == 0) {
+            break;
+        }
+
+        tail = (w->head + w->depth - w->count) % w->depth;
+        n    = w->n_samples[tail];
+
+        /* The RX thread never touches queued buffers, so the write need
+         * not block it from filling the rest of the ring */
+        MUTEX_UNLOCK(&w->lock);
+
+        if (!w->host_order) {
+            rx_sample_fixup(w->s, w->bufs[tail], n);
+        }
+
+#ifdef RX_WRITER_HAVE_DIRECT_IO
+        if (w->fd >= 0) {
+            status = rx_writer_write_fd(w, w->bufs[tail], n);
+        } else
+#endif
+        {
+            status = w->write_samples(w->s, w->bufs[tail], n,
+                                      w->timestamps[tail]);
+        }
+
+        MUTEX_LOCK(&w->lock);
+
+        w->count--;
+        if (status != 0 && w->status == 0) {
+            w->status = status;
+        }
+        pthread_cond_signal(&w->emptied);
+
+        if (w->status != 0) {
+            break;
+        }
+    }
+
+    MUTEX_UNLOCK(&w->lock);
+
+    return NULL;
+}
+
+static void rx_writer_free(struct rx_writer *w)
+{
+    unsigned int i;
+
+    if (w->bufs != NULL) {
+        for (i = 0; i < w->depth; i++) {
+            rx_writer_free_buf(w->bufs[i]);
+        }
+    }
+
+    rx_writer_free_buf(w->discard);
+
+    free(w->bufs);
+    free(w->n_samples);
+    free(w->timestamps);
+    free(w->splice_end);
+
+    MUTEX_DESTROY(&w->lock);
+    pthread_cond_destroy(&w->filled);
+    pthread_cond_destroy(&w->emptied);
+}
+
+/* `may_drop` permits dropping buffers while a pipe output's reader has
+ * fallen behind, rather than waiting for it.
+ *
+ * returns 0 on success, CLI_RET_* on failure (and calls set_last_error()) */
+static int rx_writer_start(struct rx_writer *w,
+                           struct cli_state *s,
+                           unsigned int depth,
+                           unsigned int hold_max,
+                           size_t buf_size,
+                           bool may_drop,
+                           int (*write_samples)(struct cli_state *s,
+                                                void *samples,
+                                                size_t n,
+                                                uint64_t timestamp))
+{
+    struct rxtx_data *rx = s->rx;
+    unsigned int i;
+    int status;
+
+    memset(w, 0, sizeof(*w));
+    w->s             = s;
+    w->write_samples = write_samples;
+    w->depth         = depth;
+    w->hold_max      = hold_max;
+    w->host_order    = (hold_max > 0);
+    w->buf_size      = buf_size;
+    w->sample_size   = 2 * (s->bit_mode_8bit ? sizeof(int8_t)
+                                             : sizeof(int16_t));
+    w->fd            = -1;
+    w->splice_fd     = -1;
+
+    MUTEX_INIT(&w->lock);
+    pthread_cond_init(&w->filled, NULL);
+    pthread_cond_init(&w->emptied, NULL);
+
+    w->bufs       = calloc(depth, sizeof(w->bufs[0]));
+    w->n_samples  = calloc(depth, sizeof(w->n_samples[0]));
+    w->timestamps = calloc(depth, sizeof(w->timestamps[0]));
+    if (w->bufs == NULL || w->n_samples == NULL || w->timestamps == NULL) {
+        goto out_of_memory;
+    }
+
+    /* Preallocate the ring up front, so nothing is allocated while
+     * samples are flowing */
+    for (i = 0; i < depth; i++) {
+        w->bufs[i] = rx_writer_alloc_buf(buf_size);
+        if (w->bufs[i] == NULL) {
+            goto out_of_memory;
+        }
+    }
+
+#if !BLADERF_OS_WINDOWS
+    w->pipe = rx_writer_output_is_pipe(w);
+#endif
+
+    w->drop = w->pipe && may_drop;
+    if (w->drop) {
+        w->discard = rx_writer_alloc_buf(buf_size);
+        if (w->discard == NULL) {
+            goto out_of_memory;
+        }
+    }
+
+#ifdef RX_WRITER_HAVE_DIRECT_IO
+    rx_writer_enable_direct_io(w);
+#endif
+
+#ifdef RX_WRITER_HAVE_SPLICE
+    rx_writer_enable_splice(w);
+#endif
+
+    status = pthread_create(&w->thread, NULL, rx_writer_task, w);
+    if (status != 0) {
+#ifdef RX_WRITER_HAVE_DIRECT_IO
+        rx_writer_disable_direct_io(w);
+#endif
+        set_last_error(&rx->last_error, ETYPE_ERRNO, status);
+        rx_writer_free(w);
+        return CLI_RET_UNKNOWN;
+    }
+
+    return 0;
+
+out_of_memory:
+    set_last_error(&rx->last_error, ETYPE_CLI, CLI_RET_MEM);
+    rx_writer_free(w);
+    return CLI_RET_MEM;
+}
+
+/* Wait for a free buffer to receive samples into, or, if the writer drops
+ * buffers, return the discard buffer when there is none. Returns NULL after a
+ * write has failed, in which case rx_writer_stop() reports the error. */
+static void *rx_writer_acquire(struct rx_writer *w)
+{
+    void *buf = NULL;
+
+    MUTEX_LOCK(&w->lock);
+
+    while (w->count + w->held == w->depth && w->status == 0 && !w->drop) {
+        pthread_cond_wait(&w->emptied, &w->lock);
+    }
+
+    w->dropping = (w->count + w->held == w->depth);
+
+    if (w->status != 0) {
+        buf = NULL;
+    } else if (w->dropping) {
+        buf = w->discard;
+    } else {
+        buf = w->bufs[w->head];
+    }
+
+    MUTEX_UNLOCK(&w->lock);
+
+    return buf;
+}
+
+/* Queue the buffer last returned by rx_writer_acquire() for writing, or
+ * count its samples as dropped if it was the discard buffer */
+static void rx_writer_submit(struct rx_writer *w,
+                             size_t n_samples,
+                             uint64_t timestamp)
+{
+    MUTEX_LOCK(&w->lock);
+
+    if (w->dropping) {
+        w->dropped += n_samples;
+        MUTEX_UNLOCK(&w->lock);
+        return;
+    }
+
+    w->n_samples[w->head]  = n_samples;
+    w->timestamps[w->head] = timestamp;
+    w->head               = (w->head + 1) % w->depth;
+    w->count++;
+    pthread_cond_signal(&w->filled);
+
+    MUTEX_UNLOCK(&w->lock);
+}
+
+/* Hold the buffer last returned by rx_writer_acquire() until
+ * rx_writer_release(), dropping the oldest held buffer if `hold_max` are
+ * already held. Nothing may be queued for writing. */
+static void rx_writer_hold(struct rx_writer *w,
+                           size_t n_samples,
+                           uint64_t timestamp)
+{
+    MUTEX_LOCK(&w->lock);
+
+    assert(w->count == 0);
+
+    w->n_samples[w->head]  = n_samples;
+    w->timestamps[w->head] = timestamp;
+    w->head                = (w->head + 1) % w->depth;
+
+    if (w->held < w->hold_max) {
+        w->held++;
+    }
+
+    MUTEX_UNLOCK(&w->lock);
+}
+
+/* Queue all held buffers for writing, oldest first */
+static void rx_writer_release(struct rx_writer *w)
+{
+    MUTEX_LOCK(&w->lock);
+
+    w->count += w->held;
+    w->held   = 0;
+    pthread_cond_signal(&w->filled);
+
+    MUTEX_UNLOCK(&w->lock);
+}
+
+/* Finish writing all queued buffers and release the writer.
+ *
+ * returns 0 on success, CLI_RET_* on failure */
+static int rx_writer_stop(struct rx_writer *w)
+{
+    int status;
+
+    MUTEX_LOCK(&w->lock);
+    w->done = true;
+    pthread_cond_signal(&w->filled);
+    MUTEX_UNLOCK(&w->lock);
+
+    pthread_join(w->thread, NULL);
+
+#ifdef RX_WRITER_HAVE_DIRECT_IO
+    rx_writer_disable_direct_io(w);
+#endif
+
+    status = w->status;
+    rx_writer_free(w);
+
+    return status;
+}
+
+/* Convert a trigger threshold in dBFS to a peak I^2 + Q^2, in the units of
+ * the received samples */
+static uint32_t rx_threshold_power(struct cli_state *s, double dbfs)
+{
+    const double full_scale = s->bit_mode_8bit ? 128.0 : 2048.0;
+    const double power = full_scale * full_scale * pow(10.0, dbfs / 10.0);
+
+    if (power >= (double)UINT32_MAX) {
+        return UINT32_MAX;
+    }
+
+    return (uint32_t)power;
+}
+
+/* Check whether any of `n` samples, in host byte order, exceeds the trigger
+ * threshold */
+static bool rx_threshold_exceeded(struct cli_state *s,
+                                  const void *samples,
+                                  size_t n,
+                                  uint32_t threshold)
+{
+    uint32_t peak;
+
+    if (s->bit_mode_8bit) {
+        peak = dsp_peak_power_sc8(samples, n);
+    } else {
+        peak = dsp_peak_power_sc16(samples, n);
+    }
+
+    return peak > threshold;
+}
+
+/* Receive into the writer's ring. A pre-trigger capture holds up to
+ * `pretrigger` samples in the ring until it is triggered, whereupon those
+ * samples are written, followed by the requested number of samples from the
+ * triggering buffer onwards. */
+static int rx_task_exec_recording(struct cli_state *s,
+                                  unsigned int depth,
+                                  struct rx_sigmf *sigmf,
+                                  bool timestamped)
+{
+    int status = 0;
+    int writer_status;
+    unsigned int samples_per_buffer;
+    unsigned int n_received;
+    unsigned int hold_max = 0;
+    unsigned int i;
+    uint64_t timestamp;
+    void *samples;
+    size_t num_samples;
+    size_t samples_read = 0;
+    size_t pretrigger;
+    bool threshold_enabled;
+    double threshold_dbfs;
+    uint32_t threshold = 0;
+    bool triggered;
+    struct rxtx_data *rx = s->rx;
+    struct rx_writer writer;
+    int (*write_samples)(struct cli_state *s, void *samples, size_t n,
+                         uint64_t timestamp);
+    unsigned int timeout_ms;
+
+    MUTEX_LOCK(&rx->data_mgmt.lock);
+    timeout_ms         = rx->data_mgmt.timeout_ms;
+    samples_per_buffer = rx->data_mgmt.samples_per_buffer;
+    MUTEX_UNLOCK(&rx->data_mgmt.lock);
+
+    MUTEX_LOCK(&rx->param_lock);
+    num_samples       = ((struct rx_params *)rx->params)->n_samples;
+    write_samples     = ((struct rx_params *)rx->params)->write_samples;
+    pretrigger        = ((struct rx_params *)rx->params)->pretrigger;
+    threshold_enabled = ((struct rx_params *)rx->params)->threshold_enabled;
+    threshold_dbfs    = ((struct rx_params *)rx->params)->threshold;
+    MUTEX_UNLOCK(&rx->param_lock);
+
+    if (pretrigger > 0) {
+        hold_max  = (unsigned int)((pretrigger + samples_per_buffer - 1) /
+                                   samples_per_buffer);
+        threshold = rx_threshold_power(s, threshold_dbfs);
+
+        /* Ignore any trigger requested before the capture started */
+        rxtx_get_requests(rx, RXTX_TASK_REQ_TRIGGER);
+    }
+
+    triggered = (hold_max == 0);
+
+    /* Dropped samples would not be reflected in a SigMF index */
+    status = rx_writer_start(&writer, s, hold_max + depth, hold_max,
+                             samples_per_buffer * sizeof(uint16_t) * 2,
+                             sigmf == NULL, write_samples);
+    if (status != 0) {
+        return status;
+    }
+
+    while (!triggered || num_samples == 0 || samples_read < num_samples) {
+        unsigned char requests = rxtx_get_requests(
+            rx, RXTX_TASK_REQ_STOP | RXTX_TASK_REQ_TRIGGER);
+        if (requests & (RXTX_TASK_REQ_STOP | RXTX_TASK_REQ_SHUTDOWN)) {
+            break;
+        }
+
+        samples = rx_writer_acquire(&writer);
+        if (samples == NULL) {
+            break;
+        }
+
+        /* Samples are received directly into the ring buffer. Those of a
+         * pre-trigger capture are only indexed once they are to be written. */
+        status = rx_receive(s, triggered ? sigmf : NULL, timestamped,
+                            samples, samples_per_buffer, timeout_ms,
+                            &n_received, &timestamp);
+        if (status != 0) {
+            break;
+        }
+
+        /* The threshold is checked here, before the samples are queued, so
+         * they are converted to host byte order here too */
+        if (hold_max > 0) {
+            rx_sample_fixup(s, samples, n_received);
+        }
+
+        if (!triggered) {
+            triggered = (requests & RXTX_TASK_REQ_TRIGGER) ||
+                        (threshold_enabled &&
+                         rx_threshold_exceeded(s, samples, n_received,
+                                               threshold));
+
+            if (!triggered) {
+                rx_writer_hold(&writer, n_received, timestamp);
+                continue;
+            }
+
+            /* Index the held buffers, oldest first, and then the triggering
+             * one. Only this thread modifies the held buffers. */
+            if (sigmf != NULL) {
+                for (i = writer.held; i > 0 && status == 0; i--) {
+                    unsigned int idx =
+                        (writer.head + writer.depth - i) % writer.depth;
+
+                    status = rx_sigmf_index(s, sigmf, writer.timestamps[idx],
+                                            writer.n_samples[idx]);
+                }
+
+                if (status == 0) {
+                    status = rx_sigmf_index(s, sigmf, timestamp, n_received);
+                }
+
+                if (status != 0) {
+                    break;
+                }
+            }
+
+            rx_writer_release(&writer);
+        }
+
+        rx_writer_submit(&writer,
+                         min_sz(n_received, (num_samples - samples_read)),
+                         timestamp);
+
+        samples_read += n_received;
+    }
+
+    writer_status = rx_writer_stop(&writer);
+    if (status == 0 && writer_status != 0) {
+        set_last_error(&rx->last_error, ETYPE_CLI, writer_status);
+        status = writer_status;
+    }
+
+    MUTEX_LOCK(&rx->param_lock);
+    ((struct rx_params *)rx->params)->dropped = writer.dropped;
+    MUTEX_UNLOCK(&rx->param_lock);
+
+    return status;
+}
+
+static int rx_task_exec_direct(struct cli_state *s,
+                               struct rx_sigmf *sigmf,
+                               bool timestamped)
+{
+    int status = 0;
+    unsigned int samples_per_buffer;
+    unsigned int n_received;
+    uint64_t timestamp;
+    void *samples;
+    size_t num_samples;
+    size_t samples_read = 0;
+    struct rxtx_data *rx = s->rx;
+    int (*write_samples)(struct cli_state *s, void *samples, size_t n,
+                         uint64_t timestamp);
+    unsigned int timeout_ms;
+
+    /* Read the parameters that will be used for the sync transfers */
+    MUTEX_LOCK(&rx->data_mgmt.lock);
+    timeout_ms         = rx->data_mgmt.timeout_ms;
+    samples_per_buffer = rx->data_mgmt.samples_per_buffer;
+    MUTEX_UNLOCK(&rx->data_mgmt.lock);
+
+    MUTEX_LOCK(&rx->param_lock);
+    num_samples   = ((struct rx_params *)rx->params)->n_samples;
+    write_samples = ((struct rx_params *)rx->params)->write_samples;
+    MUTEX_UNLOCK(&rx->param_lock);
+
+    /* Allocate a buffer for the block of samples */
+    samples = malloc(samples_per_buffer * sizeof(uint16_t) * 2);
+    if (samples == NULL) {
+        status = errno;
+        set_last_error(&rx->last_error, ETYPE_ERRNO, status);
+    }
+
+    /*
+     * Keep reading samples until a failure or until all requested samples
+     * have been read
+     */
+    while (status == 0 && (num_samples == 0 || samples_read < num_samples)) {
+        /*
+         * Stop stream on STOP or SHUTDOWN, but only clear STOP. This will keep
+         * the SHUTDOWN request around so we can read it when determining our
+         * state transition
+         */
+        unsigned char requests = rxtx_get_requests(rx, RXTX_TASK_REQ_STOP);
+        if (requests & (RXTX_TASK_REQ_STOP | RXTX_TASK_REQ_SHUTDOWN)) {
+            break;
+        }
+
+        /* Read the samples into the sample buffer */
+        status = rx_receive(s, sigmf, timestamped, samples,
+                            samples_per_buffer, timeout_ms, &n_received,
+                            &timestamp);
+
+        if (status == 0) {
+            size_t to_write =
+                min_sz(n_received, (num_samples - samples_read));
+
+            /* Write the samples to the output file */
+            rx_sample_fixup(s, samples, to_write);
+            status = write_samples(s, samples, to_write, timestamp);
+
+            if (status != 0) {
+                set_last_error(&rx->last_error, ETYPE_CLI, status);
+            }
+        }
+
+        samples_read += n_received;
+    }
+
+    /* Free the sample buffer */
+    if (samples != NULL) {
+        free(samples);
+    }
+
+    return status;
+}
+
+/* Open the VITA-49 sink of a capture, whose destinations are given as its
+ * file. The stream ID is the mask of enabled channels.
+ *
+ * returns 0 on success, CLI_RET_* on failure (and calls set_last_error()) */
+static int rx_vita49_begin(struct cli_state *s)
+{
+    struct rxtx_data *rx        = s->rx;
+    struct rx_params *rx_params = rx->params;
+    bladerf_channel_layout layout;
+    unsigned int samples_per_buffer;
+    uint32_t stream_id = 0;
+    int status;
+    int i;
+
+    MUTEX_LOCK(&rx->data_mgmt.lock);
+    layout             = rx->data_mgmt.layout;
+    samples_per_buffer = rx->data_mgmt.samples_per_buffer;
+    MUTEX_UNLOCK(&rx->data_mgmt.lock);
+
+    MUTEX_LOCK(&rx->param_lock);
+    for (i = 0; i < RXTX_MAX_CHANNELS; ++i) {
+        if (rx->channel_enable[i]) {
+            stream_id |= 1u << i;
+        }
+    }
+    MUTEX_UNLOCK(&rx->param_lock);
+
+    MUTEX_LOCK(&rx->file_mgmt.file_meta_lock);
+    status = vita49_sink_open(&rx_params->vita49, rx->file_mgmt.path,
+                              s->bit_mode_8bit,
+                              (layout == BLADERF_RX_X2) ? 2 : 1, stream_id,
+                              samples_per_buffer);
+    MUTEX_UNLOCK(&rx->file_mgmt.file_meta_lock);
+
+    if (status > 0) {
+        set_last_error(&rx->last_error, ETYPE_ERRNO, status);
+        status = CLI_RET_FILEOP;
+    } else if (status != 0) {
+        set_last_error(&rx->last_error, ETYPE_CLI, status);
+    }
+
+    return status;
+}
+
+/* Create the file set of a planar or rotated capture, in place of the file
+ * opened by rx_cmd_start()
+ *
+ * returns 0 on success, CLI_RET_* on failure (and calls set_last_error()) */
+static int rx_fileset_begin(struct cli_state *s)
+{
+    struct rxtx_data *rx        = s->rx;
+    struct rx_params *rx_params = rx->params;
+    struct fileset_config config;
+    bladerf_channel_layout layout;
+    bladerf_sample_rate rate = 0;
+    unsigned int file_time_ms;
+    unsigned int n = 0;
+    int status = 0;
+    int i;
+
+    memset(&config, 0, sizeof(config));
+    config.sc8 = s->bit_mode_8bit;
+
+    MUTEX_LOCK(&rx->data_mgmt.lock);
+    layout             = rx->data_mgmt.layout;
+    config.max_samples = rx->data_mgmt.samples_per_buffer;
+    MUTEX_UNLOCK(&rx->data_mgmt.lock);
+
+    config.num_channels = (layout == BLADERF_RX_X2) ? 2 : 1;
+
+    MUTEX_LOCK(&rx->param_lock);
+    for (i = 0; i < RXTX_MAX_CHANNELS && n < config.num_channels; ++i) {
+        if (rx->channel_enable[i]) {
+            config.channel_ids[n++] = (unsigned int)i + 1;
+        }
+    }
+
+    config.planar    = rx_params->planar;
+    config.max_bytes = rx_params->file_size;
+    file_time_ms     = rx_params->file_time_ms;
+
+    if (rx_params->n_samples != 0) {
+        config.total_samples = rx_params->n_samples + rx_params->pretrigger;
+    }
+    MUTEX_UNLOCK(&rx->param_lock);
+
+    /* Timestamps count samples, so the rotation period is converted to
+     * samples at the current rate */
+    if (file_time_ms != 0) {
+        status = bladerf_get_sample_rate(
+            s->dev, BLADERF_CHANNEL_RX(config.channel_ids[0] - 1), &rate);
+        if (status != 0) {
+            set_last_error(&rx->last_error, ETYPE_BLADERF, status);
+            return status;
+        }
+
+        config.period = u64_max((uint64_t)file_time_ms * rate / 1000, 1);
     }
 
-    line = calloc(MAXLEN, 1);
-    if (NULL == line) {
-        status = errno;
-        set_last_error(&rx->last_error, ETYPE_ERRNO, status);
-        goto out;
-    }
+    MUTEX_LOCK(&rx->file_mgmt.file_meta_lock);
+    config.path = rx->file_mgmt.path;
+    status      = fileset_open(&rx_params->fileset, &config);
+    MUTEX_UNLOCK(&rx->file_mgmt.file_meta_lock);
 
-    tmp = calloc(MAXLEN, 1);
-    if (NULL == tmp) {
-        status = errno;
-        set_last_error(&rx->last_error, ETYPE_ERRNO, status);
-        goto out;
+    if (status != 0) {
+        set_last_error(&rx->last_error, ETYPE_CLI, status);
     }
 
-    MUTEX_LOCK(&rx->file_mgmt.file_lock);
+    return status;
+}
 
-    if (s->bit_mode_8bit) {
-        samples_sc8q7 = (int8_t*)samples;
-        // Output 2 columns for each enabled channel
-        // (2 cols for BLADERF_RX_X1, 4 cols for BLADERF_RX_X2, etc)
-        for (i = 0; i < 2 * n_samples; i += 2 * nchans) {
-            memset(line, 0, MAXLEN);
-            memset(tmp, 0, MAXLEN);
+/* Start compressing to the file of an IQZ capture, with a compression thread
+ * per online CPU
+ *
+ * returns 0 on success, CLI_RET_* on failure (and calls set_last_error()) */
+static int rx_iqz_begin(struct cli_state *s)
+{
+    struct rxtx_data *rx        = s->rx;
+    struct rx_params *rx_params = rx->params;
+    bladerf_channel_layout layout;
+    int status;
 
-            for (j = 0; j < 2 * nchans; j += 2) {
-                snprintf(tmp, MAXLEN, "%s%d, %d", (j > 0) ? ", " : "",
-                    samples_sc8q7[i + j], samples_sc8q7[i + j + 1]);
-                strncat(line, tmp, MAXLEN - 1);
-            }
+    MUTEX_LOCK(&rx->data_mgmt.lock);
+    layout = rx->data_mgmt.layout;
+    MUTEX_UNLOCK(&rx->data_mgmt.lock);
 
-            strncat(line, EOL, MAXLEN - 1);
+    MUTEX_LOCK(&rx->file_mgmt.file_lock);
+    status = iqz_writer_open(&rx_params->iqz, rx->file_mgmt.file,
+                             s->bit_mode_8bit ? IQZ_FMT_SC8_Q7
+                                              : IQZ_FMT_SC16_Q11,
+                             (layout == BLADERF_RX_X2) ? 2 : 1, 0, 0);
+    MUTEX_UNLOCK(&rx->file_mgmt.file_lock);
 
-            if (fputs(line, rx->file_mgmt.file) < 0) {
-                set_last_error(&rx->last_error, ETYPE_ERRNO, errno);
-                status = CLI_RET_FILEOP;
-                break;
-            }
-        }
+    if (status != 0) {
+        rx_params->iqz = NULL;
+        set_last_error(&rx->last_error, ETYPE_ERRNO, status);
+        return CLI_RET_FILEOP;
     }
-    else {
-        samples_sc16q11 = (int16_t*)samples;
-        // Output 2 columns for each enabled channel
-        // (2 cols for BLADERF_RX_X1, 4 cols for BLADERF_RX_X2, etc)
-        for (i = 0; i < 2 * n_samples; i += 2 * nchans) {
-            memset(line, 0, MAXLEN);
-            memset(tmp, 0, MAXLEN);
 
-            for (j = 0; j < 2 * nchans; j += 2) {
-                snprintf(tmp, MAXLEN, "%s%d, %d", (j > 0) ? ", " : "",
-                    samples_sc16q11[i + j], samples_sc16q11[i + j + 1]);
-                strncat(line, tmp, MAXLEN - 1);
-            }
-
-            strncat(line, EOL, MAXLEN - 1);
+    return 0;
+}
 
-            if (fputs(line, rx->file_mgmt.file) < 0) {
-                set_last_error(&rx->last_error, ETYPE_ERRNO, errno);
-                status = CLI_RET_FILEOP;
-                break;
-            }
-        }
-    }
+/* Finish compressing an IQZ capture, writing its block index
+ *
+ * returns 0 on success, CLI_RET_* on failure (and calls set_last_error()) */
+static int rx_iqz_end(struct cli_state *s)
+{
+    struct rxtx_data *rx        = s->rx;
+    struct rx_params *rx_params = rx->params;
+    int status;
 
+    MUTEX_LOCK(&rx->file_mgmt.file_lock);
+    status = iqz_writer_close(rx_params->iqz);
     MUTEX_UNLOCK(&rx->file_mgmt.file_lock);
 
-out:
-    free(line);
-    free(tmp);
+    rx_params->iqz = NULL;
 
-    return status;
+    if (status != 0) {
+        set_last_error(&rx->last_error, ETYPE_ERRNO, status);
+        return CLI_RET_FILEOP;
+    }
+
+    return 0;
 }
 
 static int rx_task_exec_running(struct cli_state *s)
 {
-    int status = 0;
-    int samples_per_buffer;
-    void *samples;
-    size_t num_samples;
-    size_t samples_read = 0;
-    struct rxtx_data *rx = s->rx;
-    int (*write_samples)(struct cli_state *s, void *samples, size_t n);
-    unsigned int timeout_ms;
-
-    /* Read the parameters that will be used for the sync transfers */
-    MUTEX_LOCK(&rx->data_mgmt.lock);
-    timeout_ms         = rx->data_mgmt.timeout_ms;
-    samples_per_buffer = rx->data_mgmt.samples_per_buffer;
-    MUTEX_UNLOCK(&rx->data_mgmt.lock);
+    struct rxtx_data *rx        = s->rx;
+    struct rx_params *rx_params = rx->params;
+    struct rx_sigmf sigmf;
+    unsigned int write_depth;
+    size_t pretrigger;
+    bool use_sigmf, use_vita49, use_fileset, use_iqz;
+    int status;
+    int end_status;
 
     MUTEX_LOCK(&rx->param_lock);
-    num_samples   = ((struct rx_params *)rx->params)->n_samples;
-    write_samples = ((struct rx_params *)rx->params)->write_samples;
+    write_depth = rx_params->write_depth;
+    pretrigger  = rx_params->pretrigger;
+    use_fileset = (rx_params->write_samples == rx_write_fileset);
+    rx_params->dropped = 0;
     MUTEX_UNLOCK(&rx->param_lock);
 
-    /* Allocate a buffer for the block of samples */
-    samples = malloc(samples_per_buffer * sizeof(uint16_t) * 2);
-    if (samples == NULL) {
-        status = errno;
-        set_last_error(&rx->last_error, ETYPE_ERRNO, status);
+    MUTEX_LOCK(&rx->file_mgmt.file_meta_lock);
+    use_sigmf  = (rx->file_mgmt.format == RXTX_FMT_SIGMF);
+    use_vita49 = (rx->file_mgmt.format == RXTX_FMT_VITA49);
+    use_iqz    = (rx->file_mgmt.format == RXTX_FMT_IQZ);
+    MUTEX_UNLOCK(&rx->file_mgmt.file_meta_lock);
+
+    if (use_sigmf) {
+        status = rx_sigmf_begin(s, &sigmf);
+        if (status != 0) {
+            return status;
+        }
     }
 
-    /*
-     * Keep reading samples until a failure or until all requested samples
-     * have been read
-     */
-    while (status == 0 && (num_samples == 0 || samples_read < num_samples)) {
-        /*
-         * Stop stream on STOP or SHUTDOWN, but only clear STOP. This will keep
-         * the SHUTDOWN request around so we can read it when determining our
-         * state transition
-         */
-        unsigned char requests = rxtx_get_requests(rx, RXTX_TASK_REQ_STOP);
-        if (requests & (RXTX_TASK_REQ_STOP | RXTX_TASK_REQ_SHUTDOWN)) {
-            break;
+    if (use_vita49) {
+        status = rx_vita49_begin(s);
+        if (status != 0) {
+            return status;
         }
+    }
 
-        /* Read the samples into the sample buffer */
-        status = bladerf_sync_rx(s->dev, samples, samples_per_buffer, NULL,
-                                 timeout_ms);
+    if (use_fileset) {
+        status = rx_fileset_begin(s);
+        if (status != 0) {
+            return status;
+        }
+    }
 
+    if (use_iqz) {
+        status = rx_iqz_begin(s);
         if (status != 0) {
-            set_last_error(&rx->last_error, ETYPE_BLADERF, status);
-        } else {
-            size_t to_write =
-                min_sz(samples_per_buffer, (num_samples - samples_read));
+            return status;
+        }
+    }
 
-            /* Write the samples to the output file */
-            sc16q11_sample_fixup(samples, to_write);
-            status = write_samples(s, samples, to_write);
+    /* Pre-trigger captures hold their samples in the writer's ring */
+    if (write_depth > 0 || pretrigger > 0) {
+        status = rx_task_exec_recording(s, uint_max(write_depth, 1),
+                                        use_sigmf ? &sigmf : NULL,
+                                        use_sigmf || use_vita49);
+    } else {
+        status = rx_task_exec_direct(s, use_sigmf ? &sigmf : NULL,
+                                     use_sigmf || use_vita49);
+    }
 
-            if (status != 0) {
-                set_last_error(&rx->last_error, ETYPE_CLI, status);
-            }
+    if (use_vita49) {
+        vita49_sink_close(rx_params->vita49);
+        rx_params->vita49 = NULL;
+    }
+
+    if (use_fileset) {
+        end_status = fileset_close(rx_params->fileset);
+        rx_params->fileset = NULL;
+
+        if (status == 0 && end_status != 0) {
+            set_last_error(&rx->last_error, ETYPE_CLI, end_status);
+            status = end_status;
         }
+    }
 
-        samples_read += samples_per_buffer;
+    /* The index is written even after a failure, to cover whatever made it
+     * into the file */
+    if (use_iqz) {
+        end_status = rx_iqz_end(s);
+        if (status == 0) {
+            status = end_status;
+        }
     }
 
-    /* Free the sample buffer */
-    if (samples != NULL) {
-        free(samples);
+    /* The meta file is written even after a failure, to describe whatever
+     * made it into the dataset */
+    if (use_sigmf) {
+        end_status = rx_sigmf_end(s, &sigmf);
+        if (status == 0) {
+            status = end_status;
+        }
     }
 
     return status;
@@ -333,6 +1693,7 @@ void *rx_task(void *cli_state_arg)
                 /* This should be set to an appropriate value upon
                  * encountering an error condition */
                 enum error_type err_type = ETYPE_BUG;
+                bool timestamped         = false;
 
                 /* Clear the last error */
                 set_last_error(&rx->last_error, ETYPE_ERRNO, 0);
@@ -354,6 +1715,23 @@ void *rx_task(void *cli_state_arg)
                         rx_params->write_samples = rx_write_bin_sc8q7;
                         break;
 
+                    case RXTX_FMT_SIGMF:
+                        /* The dataset holds the samples as received */
+                        rx_params->write_samples = cli_state->bit_mode_8bit
+                                                       ? rx_write_bin_sc8q7
+                                                       : rx_write_bin_sc16q11;
+                        timestamped = true;
+                        break;
+
+                    case RXTX_FMT_VITA49:
+                        rx_params->write_samples = rx_write_vita49;
+                        timestamped = true;
+                        break;
+
+                    case RXTX_FMT_IQZ:
+                        rx_params->write_samples = rx_write_iqz;
+                        break;
+
                     default:
                         status = CLI_RET_INVPARAM;
                         set_last_error(&rx->last_error, ETYPE_CLI, status);
@@ -366,6 +1744,17 @@ void *rx_task(void *cli_state_arg)
 
                 MUTEX_UNLOCK(&rx->file_mgmt.file_meta_lock);
 
+                /* Planar and rotated captures (of the bin format, as checked
+                 * by rx_cmd_start()) go through a file set. Rotated files are
+                 * named after their first sample's timestamp. */
+                MUTEX_LOCK(&rx->param_lock);
+                if (status == 0 && rx_use_fileset(rx_params)) {
+                    rx_params->write_samples = rx_write_fileset;
+                    timestamped = timestamped || rx_params->file_size != 0 ||
+                                  rx_params->file_time_ms != 0;
+                }
+                MUTEX_UNLOCK(&rx->param_lock);
+
                 /* Set up the reception stream and buffer information */
                 if (status == 0) {
                     MUTEX_LOCK(&rx->data_mgmt.lock);
@@ -373,6 +1762,14 @@ void *rx_task(void *cli_state_arg)
                     sync_fmt = cli_state->bit_mode_8bit ?
                         BLADERF_FORMAT_SC8_Q7 : BLADERF_FORMAT_SC16_Q11;
 
+                    /* SigMF captures index the samples' timestamps, and
+                     * VITA-49 packets carry them */
+                    if (timestamped) {
+                        sync_fmt = cli_state->bit_mode_8bit
+                                       ? BLADERF_FORMAT_SC8_Q7_META
+                                       : BLADERF_FORMAT_SC16_Q11_META;
+                    }
+
                     status = bladerf_sync_config(
                         cli_state->dev, rx->data_mgmt.layout,
                         sync_fmt, rx->data_mgmt.num_buffers,
@@ -436,8 +1833,73 @@ void *rx_task(void *cli_state_arg)
     return NULL;
 }
 
+/* Open the capture's output. A `file` of "-" is standard output, which the
+ * capture then owns: the CLI's own output is sent to stderr from then on, so
+ * that it cannot corrupt the samples.
+ *
+ * @pre file_lock is held
+ *
+ * returns 0 on success, CLI_RET_* on failure */
+static int rx_open_output(struct cli_state *s, const char *mode)
+{
+    struct rxtx_data *rx = s->rx;
+
+    if (strcmp(rx->file_mgmt.path, "-") != 0) {
+        return expand_and_open(rx->file_mgmt.path, mode, &rx->file_mgmt.file);
+    }
+
+#if BLADERF_OS_WINDOWS
+    cli_err(s, "rx", "Standard output is not supported on this platform.\n");
+    return CLI_RET_INVPARAM;
+#else
+    {
+        /* Standard output, as it was before it was redirected */
+        static int stdout_fd = -1;
+        int fd;
+
+        if (stdout_fd < 0) {
+            if (isatty(STDOUT_FILENO)) {
+                cli_err(s, "rx", "Refusing to write samples to a "
+                                 "terminal.\n");
+                return CLI_RET_INVPARAM;
+            }
+
+            fflush(stdout);
+
+            stdout_fd = dup(STDOUT_FILENO);
+            if (stdout_fd < 0) {
+                return CLI_RET_FILEOP;
+            }
+
+            if (dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+                close(stdout_fd);
+                stdout_fd = -1;
+                return CLI_RET_FILEOP;
+            }
+        }
+
+        /* Successive captures share the stream, which ends on exit */
+        fd = dup(stdout_fd);
+        if (fd < 0) {
+            return CLI_RET_FILEOP;
+        }
+
+        rx->file_mgmt.file = fdopen(fd, mode);
+        if (rx->file_mgmt.file == NULL) {
+            close(fd);
+            return CLI_RET_FILEOP;
+        }
+
+        return 0;
+    }
+#endif
+}
+
 static int rx_cmd_start(struct cli_state *s)
 {
+    enum rxtx_fmt format;
+    bool use_fileset;
+    bool to_stdout;
     int status;
 
     /* Check that we can start up in our current state */
@@ -446,16 +1908,41 @@ static int rx_cmd_start(struct cli_state *s)
         return status;
     }
 
-    /* Set up output file */
-    MUTEX_LOCK(&s->rx->file_mgmt.file_lock);
-    if (s->rx->file_mgmt.format == RXTX_FMT_CSV) {
-        status =
-            expand_and_open(s->rx->file_mgmt.path, "w", &s->rx->file_mgmt.file);
+    MUTEX_LOCK(&s->rx->param_lock);
+    use_fileset = rx_use_fileset(s->rx->params);
+    MUTEX_UNLOCK(&s->rx->param_lock);
+
+    MUTEX_LOCK(&s->rx->file_mgmt.file_meta_lock);
+    format    = s->rx->file_mgmt.format;
+    to_stdout = (s->rx->file_mgmt.path != NULL &&
+                 strcmp(s->rx->file_mgmt.path, "-") == 0);
+    MUTEX_UNLOCK(&s->rx->file_mgmt.file_meta_lock);
+
+    if (use_fileset && format != RXTX_FMT_BIN_SC16Q11 &&
+        format != RXTX_FMT_BIN_SC8Q7) {
+        cli_err(s, "rx", "Planar and rotated captures require the bin "
+                         "format.\n");
+        return CLI_RET_INVPARAM;
+    }
+
+    /* These write files named after the file */
+    if (to_stdout && (use_fileset || format == RXTX_FMT_SIGMF)) {
+        cli_err(s, "rx", "Standard output can only take a single csv, bin, "
+                         "or iqz stream.\n");
+        return CLI_RET_INVPARAM;
+    }
 
+    /* Set up output file. VITA-49 packets are sent to the destinations given
+     * as the file, once the capture is running, and file sets open their own
+     * files, named after the file. */
+    MUTEX_LOCK(&s->rx->file_mgmt.file_lock);
+    if (s->rx->file_mgmt.format == RXTX_FMT_VITA49 || use_fileset) {
+        status = 0;
+    } else if (s->rx->file_mgmt.format == RXTX_FMT_CSV) {
+        status = rx_open_output(s, "w");
     } else {
-        /* RXTX_FMT_BIN_SC16Q11, open file in binary mode */
-        status = expand_and_open(s->rx->file_mgmt.path, "wb",
-                                 &s->rx->file_mgmt.file);
+        /* Binary formats (bin, sigmf, iqz), open file in binary mode */
+        status = rx_open_output(s, "wb");
     }
     MUTEX_UNLOCK(&s->rx->file_mgmt.file_lock);
 
@@ -463,6 +1950,12 @@ static int rx_cmd_start(struct cli_state *s)
         return status;
     }
 
+#if !BLADERF_OS_WINDOWS
+    /* Fail writes to a pipe whose reader has exited with EPIPE, rather than
+     * being killed by SIGPIPE */
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
     /* Request thread to start running */
     rxtx_submit_request(s->rx, RXTX_TASK_REQ_START);
     status = rxtx_wait_for_state(s->rx, RXTX_STATE_RUNNING, 3000);
@@ -480,10 +1973,26 @@ static int rx_cmd_start(struct cli_state *s)
 static void rx_print_config(struct rxtx_data *rx)
 {
     size_t n_samples;
+    unsigned int write_depth;
+    size_t pretrigger;
+    bool threshold_enabled;
+    double threshold;
+    bool planar;
+    uint64_t file_size;
+    unsigned int file_time_ms;
+    uint64_t dropped;
     struct rx_params *rx_params = rx->params;
 
     MUTEX_LOCK(&rx->param_lock);
-    n_samples = rx_params->n_samples;
+    n_samples         = rx_params->n_samples;
+    write_depth       = rx_params->write_depth;
+    pretrigger        = rx_params->pretrigger;
+    threshold_enabled = rx_params->threshold_enabled;
+    threshold         = rx_params->threshold;
+    planar            = rx_params->planar;
+    file_size         = rx_params->file_size;
+    file_time_ms      = rx_params->file_time_ms;
+    dropped           = rx_params->dropped;
     MUTEX_UNLOCK(&rx->param_lock);
 
     printf("\n");
@@ -500,6 +2009,41 @@ static void rx_print_config(struct rxtx_data *rx)
     }
     rxtx_print_stream_info(rx, "  ", "\n");
 
+    if (write_depth) {
+        printf("  # Write buffers: %u\n", write_depth);
+    } else {
+        printf("  # Write buffers: none (written from RX thread)\n");
+    }
+
+    if (pretrigger == 0) {
+        printf("  # Pre-trigger samples: none (not triggered)\n");
+    } else if (threshold_enabled) {
+        printf("  # Pre-trigger samples: %" PRIu64 " (threshold %.1f dBFS)\n",
+               (uint64_t)pretrigger, threshold);
+    } else {
+        printf("  # Pre-trigger samples: %" PRIu64 " (rx trigger only)\n",
+               (uint64_t)pretrigger);
+    }
+
+    printf("  Planar files: %s\n", planar ? "on" : "off");
+
+    if (dropped) {
+        printf("  Dropped samples: %" PRIu64 " (output fell behind)\n",
+               dropped);
+    }
+
+    if (file_size) {
+        printf("  File size limit: %" PRIu64 " bytes\n", file_size);
+    } else {
+        printf("  File size limit: none\n");
+    }
+
+    if (file_time_ms) {
+        printf("  File time limit: %u ms\n", file_time_ms);
+    } else {
+        printf("  File time limit: none\n");
+    }
+
     printf("\n");
 }
 
@@ -539,6 +2083,103 @@ static int rx_cmd_config(struct cli_state *s, int argc, char **argv)
                     cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
                     return CLI_RET_INVPARAM;
                 }
+            } else if (!strcasecmp("writebufs", argv[i])) {
+                /* Configure depth of the file writer's buffer ring */
+                unsigned int n;
+                bool ok;
+
+                n = str2uint_suffix(val, 0, UINT_MAX, rxtx_kmg_suffixes,
+                                    (int)rxtx_kmg_suffixes_len, &ok);
+
+                if (ok) {
+                    MUTEX_LOCK(&s->rx->param_lock);
+                    rx_params->write_depth = n;
+                    MUTEX_UNLOCK(&s->rx->param_lock);
+                } else {
+                    cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
+                    return CLI_RET_INVPARAM;
+                }
+            } else if (!strcasecmp("pretrigger", argv[i])) {
+                /* Configure # of samples held until a trigger */
+                uint64_t n;
+                bool ok;
+
+                n = str2uint64_suffix(val, 0, RX_PRETRIGGER_MAX,
+                                      rxtx_kmg_suffixes,
+                                      (int)rxtx_kmg_suffixes_len, &ok);
+
+                if (ok) {
+                    MUTEX_LOCK(&s->rx->param_lock);
+                    rx_params->pretrigger = (size_t)n;
+                    MUTEX_UNLOCK(&s->rx->param_lock);
+                } else {
+                    cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
+                    return CLI_RET_INVPARAM;
+                }
+            } else if (!strcasecmp("threshold", argv[i])) {
+                /* Configure the trigger's power threshold */
+                double threshold = 0.0;
+                bool enabled     = strcasecmp(val, "off") != 0;
+                bool ok          = true;
+
+                if (enabled) {
+                    threshold = str2double(val, RX_THRESHOLD_MIN,
+                                           RX_THRESHOLD_MAX, &ok);
+                }
+
+                if (ok) {
+                    MUTEX_LOCK(&s->rx->param_lock);
+                    rx_params->threshold_enabled = enabled;
+                    rx_params->threshold         = threshold;
+                    MUTEX_UNLOCK(&s->rx->param_lock);
+                } else {
+                    cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
+                    return CLI_RET_INVPARAM;
+                }
+            } else if (!strcasecmp("planar", argv[i])) {
+                /* Configure writing one file per channel */
+                bool planar;
+
+                if (str2bool(val, &planar) == 0) {
+                    MUTEX_LOCK(&s->rx->param_lock);
+                    rx_params->planar = planar;
+                    MUTEX_UNLOCK(&s->rx->param_lock);
+                } else {
+                    cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
+                    return CLI_RET_INVPARAM;
+                }
+            } else if (!strcasecmp("filesize", argv[i])) {
+                /* Configure size-based file rotation */
+                uint64_t n;
+                bool ok;
+
+                n = str2uint64_suffix(val, 0, UINT64_MAX, rxtx_kmg_suffixes,
+                                      (int)rxtx_kmg_suffixes_len, &ok);
+
+                if (ok) {
+                    MUTEX_LOCK(&s->rx->param_lock);
+                    rx_params->file_size = n;
+                    MUTEX_UNLOCK(&s->rx->param_lock);
+                } else {
+                    cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
+                    return CLI_RET_INVPARAM;
+                }
+            } else if (!strcasecmp("filetime", argv[i])) {
+                /* Configure time-based file rotation */
+                unsigned int ms;
+                bool ok;
+
+                ms = str2uint_suffix(val, 0, UINT_MAX, rxtx_time_suffixes,
+                                     (int)rxtx_time_suffixes_len, &ok);
+
+                if (ok) {
+                    MUTEX_LOCK(&s->rx->param_lock);
+                    rx_params->file_time_ms = ms;
+                    MUTEX_UNLOCK(&s->rx->param_lock);
+                } else {
+                    cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
+                    return CLI_RET_INVPARAM;
+                }
             } else if (!strcasecmp("channel", argv[i])) {
                 /* Configure RX channels */
                 status = rxtx_handle_channel_list(s, s->rx, val);
@@ -559,6 +2200,30 @@ static int rx_cmd_config(struct cli_state *s, int argc, char **argv)
     return 0;
 }
 
+/* Trigger a running pre-trigger capture */
+static int rx_cmd_trigger(struct cli_state *s)
+{
+    size_t pretrigger;
+
+    MUTEX_LOCK(&s->rx->param_lock);
+    pretrigger = ((struct rx_params *)s->rx->params)->pretrigger;
+    MUTEX_UNLOCK(&s->rx->param_lock);
+
+    if (pretrigger == 0) {
+        cli_err(s, "rx", "Not configured for a pre-trigger capture.\n");
+        return CLI_RET_STATE;
+    }
+
+    if (rxtx_get_state(s->rx) != RXTX_STATE_RUNNING) {
+        cli_err(s, "rx", "RX is not running.\n");
+        return CLI_RET_STATE;
+    }
+
+    rxtx_submit_request(s->rx, RXTX_TASK_REQ_TRIGGER);
+
+    return 0;
+}
+
 int cmd_rx(struct cli_state *s, int argc, char **argv)
 {
     int ret;
@@ -576,6 +2241,8 @@ int cmd_rx(struct cli_state *s, int argc, char **argv)
         ret = rx_cmd_config(s, argc, argv);
     } else if (!strcasecmp(argv[1], RXTX_CMD_WAIT)) {
         ret = rxtx_handle_wait(s, s->rx, argc, argv);
+    } else if (!strcasecmp(argv[1], RXTX_CMD_TRIGGER)) {
+        ret = rx_cmd_trigger(s);
     } else {
         cli_err(s, argv[0], "Invalid command: \"%s\"\n", argv[1]);
         ret = CLI_RET_INVPARAM;
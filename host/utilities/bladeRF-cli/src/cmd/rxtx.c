@@ -244,6 +244,17 @@ void rxtx_print_file_format(struct rxtx_data *rxtx,
         case RXTX_FMT_BIN_SC8Q7:
             printf("%sSC8 Q7, Binary%s", prefix, suffix);
             break;
+        case RXTX_FMT_SIGMF:
+            printf("%s%s, SigMF%s", prefix,
+                   (rxtx->direction == BLADERF_RX) ? "Timestamped" : "Binary",
+                   suffix);
+            break;
+        case RXTX_FMT_VITA49:
+            printf("%sVITA-49 over UDP%s", prefix, suffix);
+            break;
+        case RXTX_FMT_IQZ:
+            printf("%sCompressed (IQZ)%s", prefix, suffix);
+            break;
         default:
             printf("%sNot configured%s", prefix, suffix);
     }
@@ -341,6 +352,12 @@ enum rxtx_fmt rxtx_str2fmt(const char *str, struct cli_state *s)
         ret = RXTX_FMT_CSV;
     } else if (!strcasecmp("bin", str)) {
         ret = (s->bit_mode_8bit) ? RXTX_FMT_BIN_SC8Q7 : RXTX_FMT_BIN_SC16Q11;
+    } else if (!strcasecmp("sigmf", str)) {
+        ret = RXTX_FMT_SIGMF;
+    } else if (!strcasecmp("vita49", str)) {
+        ret = RXTX_FMT_VITA49;
+    } else if (!strcasecmp("iqz", str)) {
+        ret = RXTX_FMT_IQZ;
     }
 
     return ret;
@@ -372,6 +389,12 @@ struct rxtx_data *rxtx_data_alloc(bladerf_direction dir)
         } else {
             tx_params->repeat       = 1;
             tx_params->repeat_delay = 0;
+            tx_params->use_mmap     = true;
+            tx_params->start_timestamp = 0;
+            tx_params->start_offset    = 0;
+            tx_params->waveform        = NULL;
+            tx_params->waveform_samples = 0;
+            tx_params->waveform_sc8    = false;
             ret->params             = tx_params;
         }
     } else {
@@ -382,7 +405,18 @@ struct rxtx_data *rxtx_data_alloc(bladerf_direction dir)
             free(ret);
             return NULL;
         } else {
-            rx_params->n_samples = 100000;
+            rx_params->n_samples   = 100000;
+            rx_params->write_depth = RX_WRITE_DEPTH_DEFAULT;
+            rx_params->vita49      = NULL;
+            rx_params->pretrigger  = 0;
+            rx_params->threshold_enabled = false;
+            rx_params->threshold   = 0.0;
+            rx_params->planar      = false;
+            rx_params->file_size   = 0;
+            rx_params->file_time_ms = 0;
+            rx_params->fileset     = NULL;
+            rx_params->iqz         = NULL;
+            rx_params->dropped     = 0;
             ret->params          = rx_params;
         }
     }
@@ -487,6 +521,10 @@ void rxtx_shutdown(struct cli_state *s, struct rxtx_data *rxtx)
 void rxtx_data_free(struct rxtx_data *rxtx)
 {
     if (rxtx) {
+        if (rxtx_is_tx(rxtx->direction)) {
+            free(((struct tx_params *)rxtx->params)->waveform);
+        }
+
         free(rxtx->params);
         free(rxtx);
     }
@@ -529,6 +567,11 @@ int rxtx_handle_config_param(struct cli_state *s,
             if (fmt == RXTX_FMT_INVALID) {
                 cli_err(s, argv0, RXTX_ERRMSG_VALUE(param, *val));
                 status = CLI_RET_INVPARAM;
+            } else if ((fmt == RXTX_FMT_VITA49 || fmt == RXTX_FMT_IQZ) &&
+                       rxtx->direction != BLADERF_RX) {
+                cli_err(s, argv0, "The %s format is only supported by rx.\n",
+                        *val);
+                status = CLI_RET_INVPARAM;
             } else {
                 rxtx_set_file_format(rxtx, fmt);
                 status = 1;
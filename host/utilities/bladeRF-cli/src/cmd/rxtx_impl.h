@@ -42,6 +42,7 @@
 #define RXTX_TASK_REQ_START (1 << 0)    /* Request to start task */
 #define RXTX_TASK_REQ_STOP (1 << 1)     /* Request to stop task */
 #define RXTX_TASK_REQ_SHUTDOWN (1 << 2) /* Request to shutdown */
+#define RXTX_TASK_REQ_TRIGGER (1 << 3)  /* Request to trigger a capture */
 #define RXTX_TASK_REQ_ALL \
     (RXTX_TASK_REQ_START | RXTX_TASK_REQ_STOP | RXTX_TASK_REQ_SHUTDOWN)
 
@@ -49,6 +50,7 @@
 #define RXTX_CMD_STOP "stop"
 #define RXTX_CMD_CONFIG "config"
 #define RXTX_CMD_WAIT "wait"
+#define RXTX_CMD_TRIGGER "trigger"
 
 #define RXTX_MAX_CHANNELS 2 /* how many channels to support per direction */
 
@@ -58,7 +60,13 @@ enum rxtx_fmt {
     RXTX_FMT_INVALID = -1,
     RXTX_FMT_CSV,         /* CSV (Comma-separated, one entry per line) */
     RXTX_FMT_BIN_SC16Q11, /* Binary (big-endian), c16 I,Q */
-    RXTX_FMT_BIN_SC8Q7    /* Binary (big-endian), c8 I,Q */
+    RXTX_FMT_BIN_SC8Q7,   /* Binary (big-endian), c8 I,Q */
+    RXTX_FMT_SIGMF,       /* SigMF dataset of SC16 Q11 or SC8 Q7 samples,
+                           *   with a .sigmf-meta file */
+    RXTX_FMT_VITA49,      /* VITA-49 packets sent to UDP destinations.
+                           *   RX only. */
+    RXTX_FMT_IQZ          /* Losslessly compressed SC16 Q11 or SC8 Q7
+                           *   samples, as described by iqz.h. RX only. */
 };
 
 enum rxtx_state {
@@ -135,21 +143,79 @@ struct rxtx_data {
 struct tx_params {
     unsigned int repeat_delay; /* us delay between repetitions */
     unsigned int repeat;       /* # of repetitions */
+    bool use_mmap;             /* Play back from a mapping of the file */
+    uint64_t start_timestamp;  /* SigMF capture timestamp to start at.
+                                *   0 starts at the beginning. */
+    uint64_t start_offset;     /* I/Q pair at which playback starts */
+    void *waveform;            /* Waveform held in memory by `generate tx`,
+                                *   played back in place of the file.
+                                *   NULL plays back the file. */
+    size_t waveform_samples;   /* # of I/Q pairs in waveform */
+    bool waveform_sc8;         /* waveform holds SC8 Q7, not SC16 Q11 */
 };
 
+/* See vita49.h */
+struct vita49_sink;
+
+/* See fileset.h */
+struct fileset;
+
+/* Default number of buffers queued for the RX file writer thread */
+#define RX_WRITE_DEPTH_DEFAULT 32
+
+/* Max # of samples held by a pre-trigger capture (4 GiB of SC16 Q11) */
+#define RX_PRETRIGGER_MAX (1024 * 1024 * 1024)
+
+/* Range of the pre-trigger capture's power threshold, in dBFS */
+#define RX_THRESHOLD_MIN (-120.0)
+#define RX_THRESHOLD_MAX 10.0
+
 struct rx_params {
-    size_t n_samples; /* Number of samples to receive */
-    int (*write_samples)(struct cli_state *s, void *samples, size_t n);
+    size_t n_samples;         /* Number of samples to receive */
+    unsigned int write_depth; /* # of buffers queued for the file writer
+                               * thread. 0 writes from the RX thread. */
+    int (*write_samples)(struct cli_state *s, void *samples, size_t n,
+                         uint64_t timestamp);
+    struct vita49_sink *vita49; /* Sink of a running VITA-49 capture */
+    size_t pretrigger;        /* # of samples held in RAM until a trigger.
+                               * 0 writes samples as they are received. */
+    bool threshold_enabled;   /* Trigger on the power threshold */
+    double threshold;         /* Trigger power threshold, in dBFS */
+    bool planar;              /* Write one file per channel */
+    uint64_t file_size;       /* Rotate files at this size. 0 = off. */
+    unsigned int file_time_ms; /* Rotate files spanning this long. 0 = off. */
+    struct fileset *fileset;  /* Files of a running planar or rotated
+                               * capture */
+    struct iqz_writer *iqz;   /* Compressor of a running IQZ capture */
+    uint64_t dropped;         /* # of samples the last capture dropped while
+                               * a pipe's reader fell behind */
 };
 
+
 /* Multipliers in units of 1024 */
 extern const struct numeric_suffix rxtx_kmg_suffixes[];
 extern const size_t rxtx_kmg_suffixes_len;
 
+/* Time multipliers, in units of ms */
+extern const struct numeric_suffix rxtx_time_suffixes[];
+extern const size_t rxtx_time_suffixes_len;
+
 /* Forward declare thread entry points implemented by rx/tx code */
 void *rx_task(void *cli_state);
 void *tx_task(void *cli_state);
 
+/**
+ * Play back a waveform held in memory instead of the configured file, freeing
+ * any previous waveform. The caller must ensure the task is not running.
+ *
+ * @param   tx          TX data
+ * @param   waveform    Heap-allocated I/Q pairs, owned by tx afterwards. NULL
+ *                      returns to playing back the file.
+ * @param   n           Number of I/Q pairs
+ * @param   sc8         True if the pairs are SC8 Q7, false if SC16 Q11
+ */
+void tx_set_waveform(struct rxtx_data *tx, void *waveform, size_t n, bool sc8);
+
 bool rxtx_is_valid_channel(bladerf_channel ch);
 bool rxtx_is_tx(bladerf_direction dir);
 
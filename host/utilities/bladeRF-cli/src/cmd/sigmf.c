@@ -0,0 +1,332 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "sigmf.h"
+
+#define SIGMF_DATA_EXT ".sigmf-data"
+#define SIGMF_META_EXT ".sigmf-meta"
+
+#define SIGMF_KEY_SAMPLE_START "\"core:sample_start\":"
+#define SIGMF_KEY_TIMESTAMP "\"bladerf:timestamp\":"
+#define SIGMF_KEY_DATATYPE "\"core:datatype\":"
+#define SIGMF_KEY_SAMPLE_RATE "\"core:sample_rate\":"
+#define SIGMF_KEY_NUM_CHANNELS "\"core:num_channels\":"
+
+void sigmf_index_init(struct sigmf_index *idx, uint64_t interval)
+{
+    memset(idx, 0, sizeof(*idx));
+    idx->interval = interval;
+}
+
+void sigmf_index_free(struct sigmf_index *idx)
+{
+    free(idx->entries);
+    idx->entries   = NULL;
+    idx->len       = 0;
+    idx->alloc_len = 0;
+}
+
+static int sigmf_index_append(struct sigmf_index *idx,
+                              uint64_t sample_start,
+                              uint64_t timestamp)
+{
+    if (idx->len == idx->alloc_len) {
+        const size_t alloc_len = idx->alloc_len ? 2 * idx->alloc_len : 64;
+        struct sigmf_index_entry *entries;
+
+        entries = realloc(idx->entries, alloc_len * sizeof(entries[0]));
+        if (entries == NULL) {
+            return CLI_RET_MEM;
+        }
+
+        idx->entries   = entries;
+        idx->alloc_len = alloc_len;
+    }
+
+    idx->entries[idx->len].sample_start = sample_start;
+    idx->entries[idx->len].timestamp    = timestamp;
+    idx->len++;
+
+    return 0;
+}
+
+int sigmf_index_update(struct sigmf_index *idx,
+                       uint64_t timestamp,
+                       uint64_t count)
+{
+    int status = 0;
+    bool record;
+
+    if (idx->len == 0 || timestamp != idx->next_ts) {
+        /* Start of capture or a discontinuity */
+        record = true;
+    } else {
+        const struct sigmf_index_entry *last = &idx->entries[idx->len - 1];
+        record = idx->interval != 0 &&
+                 idx->next_sample - last->sample_start >= idx->interval;
+    }
+
+    if (record) {
+        status = sigmf_index_append(idx, idx->next_sample, timestamp);
+    }
+
+    idx->next_sample += count;
+    idx->next_ts = timestamp + count;
+
+    return status;
+}
+
+bool sigmf_index_lookup(const struct sigmf_index *idx,
+                        uint64_t timestamp,
+                        uint64_t *sample)
+{
+    const struct sigmf_index_entry *e;
+    size_t lo = 0, hi = idx->len;
+    uint64_t end;
+
+    if (idx->len == 0 || timestamp < idx->entries[0].timestamp) {
+        return false;
+    }
+
+    /* Find the last entry at or before the timestamp */
+    while (hi - lo > 1) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (idx->entries[mid].timestamp <= timestamp) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    e   = &idx->entries[lo];
+    end = (lo + 1 < idx->len) ? idx->entries[lo + 1].sample_start
+                              : idx->next_sample;
+
+    /* Samples are contiguous between entries */
+    if (timestamp - e->timestamp < end - e->sample_start) {
+        *sample = e->sample_start + (timestamp - e->timestamp);
+        return true;
+    } else if (lo + 1 < idx->len) {
+        *sample = end;
+        return true;
+    }
+
+    return false;
+}
+
+char *sigmf_meta_path(const char *data_path)
+{
+    const size_t ext_len = strlen(SIGMF_DATA_EXT);
+    size_t len           = strlen(data_path);
+    char *path;
+
+    if (len >= ext_len && !strcmp(data_path + len - ext_len, SIGMF_DATA_EXT)) {
+        len -= ext_len;
+    }
+
+    path = malloc(len + strlen(SIGMF_META_EXT) + 1);
+    if (path != NULL) {
+        memcpy(path, data_path, len);
+        strcpy(path + len, SIGMF_META_EXT);
+    }
+
+    return path;
+}
+
+/* Write `str` as a JSON string literal */
+static void sigmf_write_string(FILE *f, const char *str)
+{
+    fputc('"', f);
+
+    for (; *str != '\0'; str++) {
+        if (*str == '"' || *str == '\\') {
+            fprintf(f, "\\%c", *str);
+        } else if ((unsigned char)*str < 0x20) {
+            fprintf(f, "\\u%04x", (unsigned char)*str);
+        } else {
+            fputc(*str, f);
+        }
+    }
+
+    fputc('"', f);
+}
+
+int sigmf_write_meta(const char *data_path,
+                     const struct sigmf_capture_info *info,
+                     const struct sigmf_index *idx)
+{
+    char *meta_path;
+    FILE *f = NULL;
+    size_t i;
+    int status;
+
+    meta_path = sigmf_meta_path(data_path);
+    if (meta_path == NULL) {
+        return CLI_RET_MEM;
+    }
+
+    status = expand_and_open(meta_path, "w", &f);
+    free(meta_path);
+
+    if (status != 0) {
+        return status;
+    }
+
+    fprintf(f, "{\n");
+    fprintf(f, "    \"global\": {\n");
+    fprintf(f, "        " SIGMF_KEY_DATATYPE " \"%s\",\n",
+            info->sc8 ? "ci8" : "ci16_le");
+    fprintf(f, "        " SIGMF_KEY_SAMPLE_RATE " %" PRIu64 ",\n",
+            info->sample_rate);
+    fprintf(f, "        " SIGMF_KEY_NUM_CHANNELS " %u,\n",
+            info->num_channels);
+    fprintf(f, "        \"core:version\": \"1.0.0\",\n");
+    fprintf(f, "        \"core:recorder\": \"bladeRF-cli\",\n");
+    if (info->hw != NULL) {
+        fprintf(f, "        \"core:hw\": ");
+        sigmf_write_string(f, info->hw);
+        fprintf(f, ",\n");
+    }
+    fprintf(f, "        \"core:extensions\": [\n");
+    fprintf(f, "            { \"name\": \"bladerf\", \"version\": \"1.0.0\", "
+               "\"optional\": true }\n");
+    fprintf(f, "        ]\n");
+    fprintf(f, "    },\n");
+
+    /* Each capture segment is kept on its own line, which is what
+     * sigmf_read_index() expects */
+    fprintf(f, "    \"captures\": [\n");
+    for (i = 0; i < idx->len; i++) {
+        fprintf(f, "        { " SIGMF_KEY_SAMPLE_START " %" PRIu64 ", "
+                   SIGMF_KEY_TIMESTAMP " %" PRIu64,
+                idx->entries[i].sample_start, idx->entries[i].timestamp);
+
+        if (i == 0) {
+            fprintf(f, ", \"core:frequency\": %" PRIu64, info->frequency);
+            if (info->datetime[0] != '\0') {
+                fprintf(f, ", \"core:datetime\": \"%s\"", info->datetime);
+            }
+        }
+
+        fprintf(f, " }%s\n", (i + 1 < idx->len) ? "," : "");
+    }
+    fprintf(f, "    ],\n");
+
+    fprintf(f, "    \"annotations\": []\n");
+    fprintf(f, "}\n");
+
+    status = ferror(f) ? CLI_RET_FILEOP : 0;
+
+    if (fclose(f) != 0 && status == 0) {
+        status = CLI_RET_FILEOP;
+    }
+
+    return status;
+}
+
+/* Parse the unsigned integer following `key` in `line` */
+static bool sigmf_parse_u64(const char *line, const char *key, uint64_t *val)
+{
+    const char *p = strstr(line, key);
+    char *end;
+
+    if (p == NULL) {
+        return false;
+    }
+
+    p += strlen(key);
+    *val = strtoull(p, &end, 10);
+
+    return end != p;
+}
+
+int sigmf_read_index(const char *data_path,
+                     struct sigmf_capture_info *info,
+                     struct sigmf_index *idx)
+{
+    char line[256];
+    char *meta_path;
+    FILE *f = NULL;
+    uint64_t sample_start, timestamp, val;
+    int status;
+
+    sigmf_index_init(idx, 0);
+    memset(info, 0, sizeof(*info));
+    info->num_channels = 1;
+
+    meta_path = sigmf_meta_path(data_path);
+    if (meta_path == NULL) {
+        return CLI_RET_MEM;
+    }
+
+    status = expand_and_open(meta_path, "r", &f);
+    free(meta_path);
+
+    if (status != 0) {
+        return status;
+    }
+
+    while (status == 0 && fgets(line, sizeof(line), f) != NULL) {
+        if (strstr(line, SIGMF_KEY_DATATYPE) != NULL) {
+            info->sc8 = strstr(line, "\"ci8\"") != NULL;
+        } else if (sigmf_parse_u64(line, SIGMF_KEY_SAMPLE_RATE, &val)) {
+            info->sample_rate = val;
+        } else if (sigmf_parse_u64(line, SIGMF_KEY_NUM_CHANNELS, &val)) {
+            if (val == 0 || val > UINT_MAX) {
+                status = CLI_RET_INVPARAM;
+            } else {
+                info->num_channels = (unsigned int)val;
+            }
+        } else if (sigmf_parse_u64(line, SIGMF_KEY_SAMPLE_START,
+                                   &sample_start) &&
+                   sigmf_parse_u64(line, SIGMF_KEY_TIMESTAMP, &timestamp)) {
+            if (idx->len > 0 &&
+                (sample_start < idx->next_sample ||
+                 timestamp < idx->entries[idx->len - 1].timestamp)) {
+                status = CLI_RET_INVPARAM;
+            } else {
+                status = sigmf_index_append(idx, sample_start, timestamp);
+                idx->next_sample = sample_start;
+            }
+        }
+    }
+
+    if (status == 0 && ferror(f)) {
+        status = CLI_RET_FILEOP;
+    }
+
+    /* The dataset's length is not recorded, so the last segment is taken to
+     * extend to its end */
+    idx->next_sample = UINT64_MAX;
+
+    fclose(f);
+
+    if (status != 0) {
+        sigmf_index_free(idx);
+    }
+
+    return status;
+}
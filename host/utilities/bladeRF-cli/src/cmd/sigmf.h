@@ -0,0 +1,152 @@
+/**
+ * @file sigmf.h
+ *
+ * @brief SigMF metadata support for rx captures and tx playback
+ *
+ * Captures are stored as a SigMF Recording: the samples are written unchanged
+ * to the dataset file, and a .sigmf-meta file beside it describes them. The
+ * meta file's captures list doubles as an index of hardware timestamps. An
+ * entry is recorded at the start of the capture, at every discontinuity (e.g.,
+ * an overrun), and periodically in between, so that any timestamp may be
+ * located without scanning the dataset.
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef SIGMF_H__
+#define SIGMF_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Maps a position in the dataset to the device timestamp of that sample */
+struct sigmf_index_entry {
+    uint64_t sample_start; /* Sample index, counting multi-channel samples
+                            * (one I/Q pair per channel) as one */
+    uint64_t timestamp;    /* Device timestamp of the sample */
+};
+
+struct sigmf_index {
+    struct sigmf_index_entry *entries;
+    size_t len;
+    size_t alloc_len;
+
+    uint64_t interval;    /* Max # of samples between entries */
+    uint64_t next_sample; /* Expected next sample index */
+    uint64_t next_ts;     /* Expected timestamp of next_sample */
+};
+
+/* Description of the dataset, stored in the meta file */
+struct sigmf_capture_info {
+    bool sc8;                  /* SC8 Q7 rather than SC16 Q11 samples */
+    unsigned int num_channels; /* # of interleaved channels */
+    uint64_t sample_rate;      /* Samples per second, per channel */
+    uint64_t frequency;        /* Center frequency, in Hz */
+    const char *hw;            /* Description of the device, or NULL */
+    char datetime[32];         /* ISO 8601 time of the first sample */
+};
+
+/**
+ * Initialize an empty index
+ *
+ * @param   idx         Index to initialize
+ * @param   interval    Max number of samples between index entries. 0
+ *                      only records discontinuities.
+ */
+void sigmf_index_init(struct sigmf_index *idx, uint64_t interval);
+
+/**
+ * Free the entries of an index
+ *
+ * @param   idx         Index to free
+ */
+void sigmf_index_free(struct sigmf_index *idx);
+
+/**
+ * Account for a block of contiguous samples appended to the dataset,
+ * recording an index entry where required.
+ *
+ * @param   idx         Index to update
+ * @param   timestamp   Device timestamp of the block's first sample
+ * @param   count       Number of samples in the block
+ *
+ * @return 0 on success, CLI_RET_MEM on allocation failure
+ */
+int sigmf_index_update(struct sigmf_index *idx,
+                       uint64_t timestamp,
+                       uint64_t count);
+
+/**
+ * Look up the position of the sample with the specified timestamp
+ *
+ * @param[in]   idx         Index to search
+ * @param[in]   timestamp   Timestamp to locate
+ * @param[out]  sample      Index of the sample. If `timestamp` lies in a gap
+ *                          in the capture, this is the first sample after it.
+ *
+ * @return true if found, false if `timestamp` lies outside the capture
+ */
+bool sigmf_index_lookup(const struct sigmf_index *idx,
+                        uint64_t timestamp,
+                        uint64_t *sample);
+
+/**
+ * Get the path of the meta file associated with a dataset. A ".sigmf-data"
+ * extension is replaced, otherwise ".sigmf-meta" is appended.
+ *
+ * @param   data_path   Path of the dataset file
+ *
+ * @return heap-allocated path, or NULL on allocation failure
+ */
+char *sigmf_meta_path(const char *data_path);
+
+/**
+ * Write the meta file for a capture
+ *
+ * @param   data_path   Path of the dataset file
+ * @param   info        Dataset description
+ * @param   idx         Timestamp index
+ *
+ * @return 0 on success, CLI_RET_* on failure
+ */
+int sigmf_write_meta(const char *data_path,
+                     const struct sigmf_capture_info *info,
+                     const struct sigmf_index *idx);
+
+/**
+ * Read the timestamp index from the meta file of a capture written by
+ * sigmf_write_meta()
+ *
+ * As the length of the dataset is not recorded, its last segment is treated
+ * as unbounded. Positions returned by sigmf_index_lookup() should therefore be
+ * checked against the size of the dataset.
+ *
+ * @param[in]   data_path   Path of the dataset file
+ * @param[out]  info        Filled with the sample format, number of channels,
+ *                          and sample rate of the dataset. Other fields are
+ *                          zeroed.
+ * @param[out]  idx         Initialized and filled with the index entries
+ *
+ * @return 0 on success, CLI_RET_* on failure
+ */
+int sigmf_read_index(const char *data_path,
+                     struct sigmf_capture_info *info,
+                     struct sigmf_index *idx);
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cmd.h"
+
+static const char *pkt_names[BLADERF_CONTROL_PKT_COUNT] = {
+    "8x8", "8x16", "8x32", "8x64", "16x64", "32x32", "retune", "other",
+};
+
+static inline double ns_to_us(uint64_t ns)
+{
+    return ns / 1000.0;
+}
+
+static int print_stats(struct cli_state *state)
+{
+    struct bladerf_control_stats stats;
+    bool header = false;
+    int status;
+    size_t i;
+
+    status = bladerf_get_control_stats(state->dev, &stats);
+    if (status == BLADERF_ERR_INVAL) {
+        printf("\n  Control request statistics are not enabled. "
+               "Run \"stats enable\".\n\n");
+        return 0;
+    } else if (status != 0) {
+        state->last_lib_error = status;
+        return CLI_RET_LIBBLADERF;
+    }
+
+    printf("\n");
+
+    for (i = 0; i < BLADERF_CONTROL_PKT_COUNT; i++) {
+        const struct bladerf_control_latency *l = &stats.pkt[i];
+
+        if (l->count == 0 && l->errors == 0) {
+            continue;
+        }
+
+        if (!header) {
+            printf("  Control request round-trip times (us):\n\n");
+            printf("    %-8s %10s %7s %8s %8s %8s %8s %8s %8s %8s\n", "Type",
+                   "Count", "Errors", "Min", "Mean", "p50", "p90", "p99",
+                   "p99.9", "Max");
+            header = true;
+        }
+
+        printf("    %-8s %10" PRIu64 " %7" PRIu64
+               " %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f\n",
+               pkt_names[i], l->count, l->errors, ns_to_us(l->min_ns),
+               ns_to_us(l->mean_ns), ns_to_us(l->p50_ns), ns_to_us(l->p90_ns),
+               ns_to_us(l->p99_ns), ns_to_us(l->p999_ns), ns_to_us(l->max_ns));
+    }
+
+    if (!header) {
+        printf("  No control requests have been recorded.\n");
+    }
+
+    printf("\n");
+    return 0;
+}
+
+int cmd_stats(struct cli_state *state, int argc, char **argv)
+{
+    int status;
+
+    if (argc == 1) {
+        return print_stats(state);
+    } else if (argc != 2) {
+        return CLI_RET_NARGS;
+    }
+
+    if (!strcasecmp(argv[1], "enable") || !strcasecmp(argv[1], "on") ||
+        !strcasecmp(argv[1], "reset")) {
+        status = bladerf_enable_control_stats(state->dev, true);
+    } else if (!strcasecmp(argv[1], "disable") ||
+               !strcasecmp(argv[1], "off")) {
+        status = bladerf_enable_control_stats(state->dev, false);
+    } else {
+        cli_err(state, argv[0], "Invalid option: %s\n", argv[1]);
+        return CLI_RET_INVPARAM;
+    }
+
+    if (status != 0) {
+        state->last_lib_error = status;
+        return CLI_RET_LIBBLADERF;
+    }
+
+    return 0;
+}
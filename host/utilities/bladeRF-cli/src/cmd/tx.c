@@ -18,6 +18,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 #include <errno.h>
+#include <inttypes.h>
 #include <limits.h>
 #include <pthread.h>
 #include <stdbool.h>
@@ -31,7 +32,17 @@
 #include "minmax.h"
 #include "parse.h"
 #include "rel_assert.h"
+#include "rxtx.h"
 #include "rxtx_impl.h"
+#include "sigmf.h"
+
+#if BLADERF_OS_WINDOWS
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 /* The DAC range is [-2048, 2047] */
 #define SC16Q11_IQ_MIN (-2048)
@@ -40,21 +51,118 @@
 #define SC8Q7_IQ_MIN (-128)
 #define SC8Q7_IQ_MAX (127)
 
+/* Input file, mapped into memory for playback */
+struct tx_mapping {
+    const uint8_t *data;
+    size_t size;
+#if BLADERF_OS_WINDOWS
+    HANDLE handle;
+#endif
+};
+
+#if BLADERF_OS_WINDOWS
+static bool tx_map_file(FILE *file, struct tx_mapping *map)
+{
+    HANDLE fh = (HANDLE)_get_osfhandle(_fileno(file));
+    LARGE_INTEGER len;
+
+    if (fh == INVALID_HANDLE_VALUE || !GetFileSizeEx(fh, &len) ||
+        len.QuadPart == 0 || (uint64_t)len.QuadPart > SIZE_MAX) {
+        return false;
+    }
+
+    map->handle = CreateFileMappingA(fh, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (map->handle == NULL) {
+        return false;
+    }
+
+    map->data = MapViewOfFile(map->handle, FILE_MAP_READ, 0, 0, 0);
+    if (map->data == NULL) {
+        CloseHandle(map->handle);
+        return false;
+    }
+
+    map->size = (size_t)len.QuadPart;
+    return true;
+}
+
+static void tx_unmap_file(struct tx_mapping *map)
+{
+    UnmapViewOfFile(map->data);
+    CloseHandle(map->handle);
+}
+#else
+static bool tx_map_file(FILE *file, struct tx_mapping *map)
+{
+    struct stat st;
+    void *addr;
+    int fd = fileno(file);
+
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 ||
+        (uint64_t)st.st_size > SIZE_MAX) {
+        return false;
+    }
+
+    addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+
+    /* These are only hints. Fault the waveform in up front so that it stays
+     * resident across repetitions, and let the kernel back it with huge pages
+     * where the filesystem supports it. */
+#   ifdef MADV_HUGEPAGE
+    madvise(addr, (size_t)st.st_size, MADV_HUGEPAGE);
+#   endif
+    madvise(addr, (size_t)st.st_size, MADV_WILLNEED);
+
+    map->data = addr;
+    map->size = (size_t)st.st_size;
+    return true;
+}
+
+static void tx_unmap_file(struct tx_mapping *map)
+{
+    munmap((void *)map->data, map->size);
+}
+#endif
+
+/* Position the input file at the `offset`th sample, for stream playback */
+static int tx_seek_file(FILE *file, uint64_t offset, size_t sample_size)
+{
+    const uint64_t pos = offset * sample_size;
+
+#if BLADERF_OS_WINDOWS
+    return _fseeki64(file, (__int64)pos, SEEK_SET);
+#else
+    return fseeko(file, (off_t)pos, SEEK_SET);
+#endif
+}
+
 static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
 {
     int status = 0;
-    unsigned int samples_per_buffer;
-    int16_t *tx_buffer;
     struct tx_params *tx_params = tx->params;
     unsigned int repeats_remaining;
     unsigned int delay_us;
     unsigned int delay_samples;
     unsigned int delay_samples_remaining;
     bool repeat_infinite;
+    bool use_mmap;
     unsigned int timeout_ms;
     bladerf_sample_rate sample_rate = 0;
+    struct tx_mapping map = { 0 };
+    bool mapped = false;
+    bool generated;
+    size_t map_samples = 0;
+    size_t map_offset  = 0;
+    uint64_t start_offset;
     int i;
 
+    /* An I/Q pair, as stored in the file and in the stream's buffers */
+    const size_t sample_size =
+        2 * (s->bit_mode_8bit ? sizeof(int8_t) : sizeof(int16_t));
+
     enum state { INIT, READ_FILE, DELAY, PAD_TRAILING, DONE };
     enum state state = INIT;
 
@@ -62,13 +170,19 @@ static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
     MUTEX_LOCK(&tx->param_lock);
     repeats_remaining = tx_params->repeat;
     delay_us          = tx_params->repeat_delay;
+    use_mmap          = tx_params->use_mmap;
+    start_offset      = tx_params->start_offset;
+    generated         = (tx_params->waveform != NULL);
+    if (generated) {
+        map.data = tx_params->waveform;
+        map.size = tx_params->waveform_samples * sample_size;
+    }
     MUTEX_UNLOCK(&tx->param_lock);
 
     repeat_infinite = (repeats_remaining == 0);
 
     MUTEX_LOCK(&tx->data_mgmt.lock);
-    samples_per_buffer = (unsigned int)tx->data_mgmt.samples_per_buffer;
-    timeout_ms         = tx->data_mgmt.timeout_ms;
+    timeout_ms = tx->data_mgmt.timeout_ms;
     MUTEX_UNLOCK(&tx->data_mgmt.lock);
 
     for (i = 0; i < RXTX_MAX_CHANNELS; ++i) {
@@ -92,20 +206,54 @@ static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
     delay_samples = (unsigned int)((uint64_t)sample_rate * delay_us / 1000000);
     delay_samples_remaining = delay_samples;
 
-    /* Allocate a buffer to hold each block of samples to transmit */
-    tx_buffer = (int16_t *)malloc(samples_per_buffer * 2 * sizeof(int16_t));
-    if (tx_buffer == NULL) {
-        status = CLI_RET_MEM;
-        set_last_error(&tx->last_error, ETYPE_ERRNO,
-                       errno == 0 ? ENOMEM : errno);
+    /* Play back from a mapping of the input file, if possible. This keeps the
+     * waveform in memory, rather than re-reading it on each repetition. Files
+     * that cannot be mapped (e.g., pipes) are read as before. A generated
+     * waveform is played back from memory in the same way. */
+    if (generated) {
+        mapped = true;
+    } else if (use_mmap) {
+        MUTEX_LOCK(&tx->file_mgmt.file_lock);
+        mapped = tx_map_file(tx->file_mgmt.file, &map);
+        MUTEX_UNLOCK(&tx->file_mgmt.file_lock);
+    }
+
+    if (mapped) {
+        map_samples = map.size / sample_size;
+    }
+
+    /* Each repetition begins at the start offset */
+    if (mapped) {
+        if (start_offset >= map_samples) {
+            cli_err(s, "tx", "Failed to seek to the start offset.\n");
+            if (!generated) {
+                tx_unmap_file(&map);
+            }
+            return CLI_RET_INVPARAM;
+        }
+
+        map_offset = (size_t)start_offset;
+    } else if (start_offset != 0) {
+        MUTEX_LOCK(&tx->file_mgmt.file_lock);
+        if (tx_seek_file(tx->file_mgmt.file, start_offset, sample_size) != 0) {
+            status = CLI_RET_FILEOP;
+        }
+        MUTEX_UNLOCK(&tx->file_mgmt.file_lock);
+
+        if (status != 0) {
+            cli_err(s, "tx", "Failed to seek to the start offset.\n");
+            return status;
+        }
     }
 
     /* Keep writing samples while there is more data to send and no failures
      * have occurred */
     while (state != DONE && status == 0) {
         unsigned char requests;
-        unsigned int buffer_samples_remaining = samples_per_buffer;
-        int16_t *tx_buffer_current            = tx_buffer;
+        unsigned int buffer_samples;
+        unsigned int buffer_samples_remaining;
+        uint8_t *tx_buffer_current;
+        void *buffer;
 
         /* Stop stream on STOP or SHUTDOWN, but only clear STOP. This will keep
          * the SHUTDOWN request around so we can read it when determining
@@ -115,27 +263,81 @@ static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
             break;
         }
 
+        /* Samples are placed directly into the stream's next buffer */
+        status = bladerf_sync_tx_acquire(s->dev, &buffer, &buffer_samples,
+                                         timeout_ms);
+        if (status != 0) {
+            break;
+        }
+
+        tx_buffer_current        = buffer;
+        buffer_samples_remaining = buffer_samples;
+
         /* Keep adding to the buffer until it is full or a failure occurs */
         while (buffer_samples_remaining > 0 && status == 0 && state != DONE) {
             size_t samples_populated = 0;
+            bool end_of_file;
 
             switch (state) {
                 case INIT:
                 case READ_FILE:
 
-                    MUTEX_LOCK(&tx->file_mgmt.file_lock);
+                    if (mapped) {
+                        samples_populated =
+                            min_sz(buffer_samples_remaining,
+                                   map_samples - map_offset);
+
+                        memcpy(tx_buffer_current,
+                               map.data + map_offset * sample_size,
+                               samples_populated * sample_size);
+
+                        map_offset += samples_populated;
+                        end_of_file = (map_offset == map_samples);
+
+                        if (end_of_file) {
+                            map_offset = (size_t)start_offset;
+                        }
+                    } else {
+                        MUTEX_LOCK(&tx->file_mgmt.file_lock);
+
+                        /* Read from the input file */
+                        samples_populated =
+                            fread(tx_buffer_current, sample_size,
+                                  buffer_samples_remaining,
+                                  tx->file_mgmt.file);
+
+                        assert(samples_populated <= UINT_MAX);
+
+                        end_of_file = feof(tx->file_mgmt.file);
+
+                        if (end_of_file) {
+                            /* Clear the EOF condition and rewind the file */
+                            clearerr(tx->file_mgmt.file);
+                            rewind(tx->file_mgmt.file);
+
+                            if (start_offset != 0 &&
+                                tx_seek_file(tx->file_mgmt.file, start_offset,
+                                             sample_size) != 0) {
+                                status = errno;
+                                set_last_error(&tx->last_error, ETYPE_ERRNO,
+                                               status);
+                            }
+                        }
 
-                    /* Read from the input file */
-                    samples_populated =
-                        fread(tx_buffer_current, 2 * sizeof(int16_t),
-                              buffer_samples_remaining, tx->file_mgmt.file);
+                        /* Check for errors */
+                        else if (ferror(tx->file_mgmt.file)) {
+                            status = errno;
+                            set_last_error(&tx->last_error, ETYPE_ERRNO,
+                                           status);
+                        }
 
-                    assert(samples_populated <= UINT_MAX);
+                        MUTEX_UNLOCK(&tx->file_mgmt.file_lock);
+                    }
 
                     /* If the end of the file was reached, determine whether
                      * to delay, re-read from the file, or pad the rest of the
                      * buffer and finish */
-                    if (feof(tx->file_mgmt.file)) {
+                    if (end_of_file) {
                         repeats_remaining--;
 
                         if ((repeats_remaining > 0) || repeat_infinite) {
@@ -146,19 +348,7 @@ static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
                         } else {
                             state = PAD_TRAILING;
                         }
-
-                        /* Clear the EOF condition and rewind the file */
-                        clearerr(tx->file_mgmt.file);
-                        rewind(tx->file_mgmt.file);
-                    }
-
-                    /* Check for errors */
-                    else if (ferror(tx->file_mgmt.file)) {
-                        status = errno;
-                        set_last_error(&tx->last_error, ETYPE_ERRNO, status);
                     }
-
-                    MUTEX_UNLOCK(&tx->file_mgmt.file_lock);
                     break;
 
                 case DELAY:
@@ -168,7 +358,7 @@ static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
                                                  delay_samples_remaining);
 
                     memset(tx_buffer_current, 0,
-                           samples_populated * 2 * sizeof(uint16_t));
+                           samples_populated * sample_size);
 
                     delay_samples_remaining -= (unsigned int)samples_populated;
 
@@ -178,10 +368,8 @@ static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
                     break;
 
                 case PAD_TRAILING:
-                    /* Populate the remainder of the buffer with zeros */
-                    memset(tx_buffer_current, 0,
-                           buffer_samples_remaining * 2 * sizeof(uint16_t));
-
+                    /* The remainder of the buffer is zero-filled when it
+                     * is submitted */
                     state = DONE;
                     break;
 
@@ -190,19 +378,25 @@ static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
                     break;
             }
 
-            /* Advance the buffer pointer.
-             * Remember, two int16_t's make up 1 sample in the SC16Q11 format */
+            /* Advance the buffer pointer */
             buffer_samples_remaining -= (unsigned int)samples_populated;
-            tx_buffer_current += (2 * samples_populated);
+            tx_buffer_current += samples_populated * sample_size;
         }
 
-        /* If there were no errors, transmit the data buffer */
+        /* Transmit the data buffer. It must be handed back to the stream
+         * even on failure. */
         if (status == 0) {
-            status = bladerf_sync_tx(s->dev, tx_buffer, samples_per_buffer, NULL,
-                            timeout_ms);
+            status = bladerf_sync_tx_submit(
+                s->dev, buffer, buffer_samples - buffer_samples_remaining);
+        } else {
+            bladerf_sync_tx_submit(s->dev, buffer, 0);
         }
     }
 
+    if (mapped && !generated) {
+        tx_unmap_file(&map);
+    }
+
     /* Flush zero samples through the device to ensure samples reach the RFFE
      * before we exit and then disable the TX channel.
      *
@@ -210,21 +404,150 @@ static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
     if (status == 0) {
         const unsigned int num_buffers = tx->data_mgmt.num_buffers;
         unsigned int i;
+        unsigned int n;
+        void *buffer;
 
-        memset(tx_buffer, 0, samples_per_buffer * 2 * sizeof(int16_t));
         for (i = 0; i < (num_buffers + 1) && status == 0; i++) {
-            status = bladerf_sync_tx(s->dev, tx_buffer, samples_per_buffer,
-                                     NULL, timeout_ms);
+            status = bladerf_sync_tx_acquire(s->dev, &buffer, &n, timeout_ms);
+            if (status == 0) {
+                status = bladerf_sync_tx_submit(s->dev, buffer, 0);
+            }
         }
     }
 
-    free(tx_buffer);
     return status;
 }
 
+/* CSV input is read in blocks of this many bytes and converted a line at a
+ * time. This also bounds the length of a line. */
+#define TX_CSV_BLOCK_SIZE (1024 * 1024)
+
+static inline bool tx_csv_is_delim(char c)
+{
+    /* Matches the delimiters accepted by csv2int() */
+    switch (c) {
+        case ' ':
+        case '\t':
+        case '\r':
+        case ',':
+        case '.':
+        case ':':
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/* Parse the token [start, end) as an integer.
+ *
+ * Plain decimal values are converted directly. Anything else (e.g., hex or
+ * octal values) is handed to str2int(), so that the accepted syntax matches
+ * that of csv2int().
+ */
+static bool tx_csv_parse_int(const char *start, const char *end, int *val)
+{
+    const char *p = start;
+    bool negative = false;
+    char token[32];
+    int v = 0;
+    bool ok;
+
+    if (*p == '-' || *p == '+') {
+        negative = (*p == '-');
+        p++;
+    }
+
+    /* Up to 9 digits cannot overflow an int, and a leading 0 may denote
+     * another base */
+    if (p < end && end - p <= 9 && (*p != '0' || end - p == 1)) {
+        while (p < end && *p >= '0' && *p <= '9') {
+            v = 10 * v + (*p++ - '0');
+        }
+
+        if (p == end) {
+            *val = negative ? -v : v;
+            return true;
+        }
+    }
+
+    if ((size_t)(end - start) >= sizeof(token)) {
+        return false;
+    }
+
+    memcpy(token, start, end - start);
+    token[end - start] = '\0';
+
+    *val = str2int(token, INT32_MIN, INT32_MAX, &ok);
+    return ok;
+}
+
+/* Convert the values on one line of CSV input to samples, appending them to
+ * `out`, which must have room for (end - p + 1) / 2 values.
+ *
+ * returns the number of values on the line, or -1 on a parse failure
+ */
+static int tx_csv_parse_line(const char *p,
+                             const char *end,
+                             bool sc8,
+                             void *out,
+                             size_t *n_clamped)
+{
+    const int min_val = sc8 ? SC8Q7_IQ_MIN : SC16Q11_IQ_MIN;
+    const int max_val = sc8 ? SC8Q7_IQ_MAX : SC16Q11_IQ_MAX;
+    int8_t *out_sc8q7     = (int8_t *)out;
+    int16_t *out_sc16q11  = (int16_t *)out;
+    int cols = 0;
+
+    while (p < end) {
+        const char *token;
+        int val;
+
+        while (p < end && tx_csv_is_delim(*p)) {
+            p++;
+        }
+
+        if (p == end) {
+            break;
+        }
+
+        token = p;
+        while (p < end && !tx_csv_is_delim(*p)) {
+            p++;
+        }
+
+        if (!tx_csv_parse_int(token, p, &val)) {
+            return -1;
+        }
+
+        if (val < min_val) {
+            val = min_val;
+            (*n_clamped)++;
+        } else if (val > max_val) {
+            val = max_val;
+            (*n_clamped)++;
+        }
+
+        if (sc8) {
+            out_sc8q7[cols] = (int8_t)val;
+        } else {
+            out_sc16q11[cols] = (int16_t)val;
+        }
+
+        cols++;
+    }
+
+    return cols;
+}
+
 /* Create a temp (binary) file from a CSV so we don't have to waste time
  * parsing it in between sending samples.
  *
+ * The CSV is read and written in large blocks and parsed in place, rather
+ * than allocating per line. The samples are staged to a file, rather than
+ * parsed while streaming, as repeats, memory-mapped playback and SigMF start
+ * offsets all require a seekable binary file.
+ *
  * Postconditions: TX cfg's file descriptor, filename, and format will be
  *                 changed. (On success they'll be set to the binary file,
  *                 and on failure the csv will be closed.)
@@ -233,20 +556,19 @@ static int tx_task_exec_running(struct rxtx_data *tx, struct cli_state *s)
  */
 static int tx_csv_to_bladerf_format(struct cli_state *s)
 {
-    struct rxtx_data *tx = s->tx;
-    char buf[81]         = { 0 };
-    FILE *bin            = NULL;
-    FILE *csv            = NULL;
-    char *bin_name       = NULL;
-    int8_t *tmp_iq       = NULL;
-    int line             = 1;
-    size_t n_clamped     = 0;
-
-    int min_val          = SC16Q11_IQ_MIN;
-    int max_val          = SC16Q11_IQ_MAX;
-
-    // 16 bit samples are 2*int8_t samples wide
-    int sample_size      = s->bit_mode_8bit ? 1 : 2;
+    struct rxtx_data *tx   = s->tx;
+    const bool sc8         = s->bit_mode_8bit;
+    const size_t val_size  = sc8 ? sizeof(int8_t) : sizeof(int16_t);
+    FILE *bin              = NULL;
+    FILE *csv              = NULL;
+    char *bin_name         = NULL;
+    char *in               = NULL;
+    uint8_t *out           = NULL;
+    size_t in_len          = 0;
+    size_t out_len         = 0;
+    size_t line            = 1;
+    size_t n_clamped       = 0;
+    bool eof               = false;
     int status;
 
     assert(tx->file_mgmt.path != NULL);
@@ -267,85 +589,112 @@ static int tx_csv_to_bladerf_format(struct cli_state *s)
         goto tx_csv_to_bladerf_format_out;
     }
 
-
-    if (s->bit_mode_8bit) {
-        min_val = SC8Q7_IQ_MIN;
-        max_val = SC8Q7_IQ_MAX;
+    /* A line of n characters holds at most (n + 1) / 2 values, so an output
+     * block of TX_CSV_BLOCK_SIZE values always has room for a whole line */
+    in  = malloc(TX_CSV_BLOCK_SIZE);
+    out = malloc(TX_CSV_BLOCK_SIZE * val_size);
+    if (in == NULL || out == NULL) {
+        status = CLI_RET_MEM;
+        goto tx_csv_to_bladerf_format_out;
     }
 
-    while (fgets(buf, sizeof(buf), csv)) {
-        int i, cols, tmp_int;
-        int **args = NULL;
+    while (status == 0 && !(eof && in_len == 0)) {
+        const char *p, *end;
 
-        cols = csv2int(buf, &args);
+        if (!eof) {
+            in_len += fread(in + in_len, 1, TX_CSV_BLOCK_SIZE - in_len, csv);
+            if (ferror(csv)) {
+                status = CLI_RET_FILEOP;
+                break;
+            }
 
-        if (cols < 0) {
-            cli_err(s, "tx", "Line (%d): Parsing failed.\n", line);
-            status = CLI_RET_INVPARAM;
-            break;
+            eof = feof(csv) != 0;
         }
 
-        if (cols == 0) {
-            // empty line...?
-            continue;
-        }
+        p   = in;
+        end = in + in_len;
 
-        tmp_iq = realloc(tmp_iq, cols * sample_size);
+        while (p < end) {
+            const char *eol = memchr(p, '\n', end - p);
+            int cols;
 
-        for (i = 0; i < cols; ++i) {
-            tmp_int = *args[i];
+            if (eol == NULL) {
+                if (!eof) {
+                    /* Wait for the rest of the line */
+                    break;
+                }
 
-            if (tmp_int < min_val) {
-                tmp_int = min_val;
-                n_clamped++;
-            } else if (tmp_int > max_val) {
-                tmp_int = max_val;
-                n_clamped++;
+                /* Last line, without a newline */
+                eol = end;
             }
 
-            memcpy(tmp_iq + i * sample_size, &tmp_int, sample_size);
-        }
+            if (out_len + (eol - p + 1) / 2 > TX_CSV_BLOCK_SIZE) {
+                if (fwrite(out, val_size, out_len, bin) != out_len) {
+                    status = CLI_RET_FILEOP;
+                    break;
+                }
 
-        free_csv2int(cols, args);
+                out_len = 0;
+            }
+
+            cols = tx_csv_parse_line(p, eol, sc8, out + out_len * val_size,
+                                     &n_clamped);
+
+            if (cols < 0) {
+                cli_err(s, "tx", "Line (%zu): Parsing failed.\n", line);
+                status = CLI_RET_INVPARAM;
+                break;
+            }
+
+            if (cols % 2 != 0) {
+                cli_err(
+                    s, "tx",
+                    "Line (%zu): Encountered %d value%s (values must be in "
+                    "pairs)\n",
+                    line, cols, 1 == cols ? "" : "s");
+                status = CLI_RET_INVPARAM;
+                break;
+            }
+
+            out_len += cols;
+            line++;
+
+            p = (eol < end) ? eol + 1 : end;
+        }
 
-        if (cols % 2 != 0) {
-            cli_err(
-                s, "tx",
-                "Line (%d): Encountered %d value%s (values must be in pairs)\n",
-                line, cols, 1 == cols ? "" : "s");
+        if (status == 0 && p == in && in_len == TX_CSV_BLOCK_SIZE) {
+            cli_err(s, "tx", "Line (%zu): Line is too long.\n", line);
             status = CLI_RET_INVPARAM;
-            break;
         }
 
-        if ((int)fwrite(tmp_iq, sample_size, cols, bin) != cols) {
+        /* Carry any partial line over to the next block */
+        in_len = end - p;
+        memmove(in, p, in_len);
+    }
+
+    if (status == 0 && out_len > 0) {
+        if (fwrite(out, val_size, out_len, bin) != out_len) {
             status = CLI_RET_FILEOP;
-            break;
         }
-
-        line++;
     }
 
     if (status == 0) {
-        if (feof(csv)) {
-            free(tx->file_mgmt.path);
-            tx->file_mgmt.path = bin_name;
-            tx->file_mgmt.format = RXTX_FMT_BIN_SC16Q11;
-
-            if (n_clamped != 0) {
-               if (s->bit_mode_8bit) {
-                   printf("  Warning: %zu value%s clamped within DAC SC8 Q7 "
-                          "range of [%d, %d].\n",
-                          n_clamped, 1 == n_clamped ? "" : "s", SC8Q7_IQ_MIN,
-                          SC8Q7_IQ_MAX);
-               } else {
-                  printf("  Warning: %zu value%s clamped within DAC SC16 Q11 "
-                         "range of [%d, %d].\n",
-                         n_clamped, 1 == n_clamped ? "" : "s", SC16Q11_IQ_MIN,
-                         SC16Q11_IQ_MAX);
-               }
-            }
-        } else {
-            status = CLI_RET_FILEOP;
+        free(tx->file_mgmt.path);
+        tx->file_mgmt.path = bin_name;
+        tx->file_mgmt.format = RXTX_FMT_BIN_SC16Q11;
+
+        if (n_clamped != 0) {
+           if (s->bit_mode_8bit) {
+               printf("  Warning: %zu value%s clamped within DAC SC8 Q7 "
+                      "range of [%d, %d].\n",
+                      n_clamped, 1 == n_clamped ? "" : "s", SC8Q7_IQ_MIN,
+                      SC8Q7_IQ_MAX);
+           } else {
+              printf("  Warning: %zu value%s clamped within DAC SC16 Q11 "
+                     "range of [%d, %d].\n",
+                     n_clamped, 1 == n_clamped ? "" : "s", SC16Q11_IQ_MIN,
+                     SC16Q11_IQ_MAX);
+           }
         }
     }
 
@@ -354,7 +703,8 @@ tx_csv_to_bladerf_format_out:
         free(bin_name);
     }
 
-    free(tmp_iq);
+    free(in);
+    free(out);
 
     if (csv) {
         fclose(csv);
@@ -404,9 +754,12 @@ void *tx_task(void *cli_state_arg)
                 set_last_error(&tx->last_error, ETYPE_ERRNO, 0);
 
                 /* Bug catcher */
+                MUTEX_LOCK(&tx->param_lock);
                 MUTEX_LOCK(&tx->file_mgmt.file_meta_lock);
-                assert(tx->file_mgmt.file != NULL);
+                assert(tx->file_mgmt.file != NULL ||
+                       ((struct tx_params *)tx->params)->waveform != NULL);
                 MUTEX_UNLOCK(&tx->file_mgmt.file_meta_lock);
+                MUTEX_UNLOCK(&tx->param_lock);
 
                 sync_fmt = cli_state->bit_mode_8bit ?
                     BLADERF_FORMAT_SC8_Q7 : BLADERF_FORMAT_SC16_Q11;
@@ -470,9 +823,114 @@ void *tx_task(void *cli_state_arg)
     return NULL;
 }
 
+/* Determine the sample offset at which to begin playback, from the `start`
+ * timestamp and the index of a SigMF capture.
+ *
+ * @pre file_meta_lock is held
+ *
+ * return 0 on success, CLI_RET_* on failure */
+static int tx_resolve_start_offset(struct cli_state *s)
+{
+    struct rxtx_data *tx        = s->tx;
+    struct tx_params *tx_params = tx->params;
+    struct sigmf_capture_info info;
+    struct sigmf_index index;
+    uint64_t start_ts;
+    uint64_t sample = 0;
+    int status;
+
+    MUTEX_LOCK(&tx->param_lock);
+    start_ts = tx_params->start_timestamp;
+    MUTEX_UNLOCK(&tx->param_lock);
+
+    if (tx->file_mgmt.format != RXTX_FMT_SIGMF) {
+        if (start_ts != 0) {
+            cli_err(s, "tx", "The 'start' parameter requires a SigMF file.\n");
+            return CLI_RET_INVPARAM;
+        }
+
+        sample = 0;
+        goto out;
+    }
+
+    status = sigmf_read_index(tx->file_mgmt.path, &info, &index);
+    if (status != 0) {
+        cli_err(s, "tx", "Failed to read the SigMF meta file.\n");
+        return status;
+    }
+
+    if (info.sc8 != s->bit_mode_8bit) {
+        cli_err(s, "tx", "The SigMF dataset holds %s samples, which does not "
+                "match the current bitmode.\n", info.sc8 ? "SC8 Q7"
+                                                         : "SC16 Q11");
+        status = CLI_RET_INVPARAM;
+    } else if (start_ts != 0) {
+        if (sigmf_index_lookup(&index, start_ts, &sample)) {
+            /* Offsets are counted in I/Q pairs */
+            sample *= info.num_channels;
+        } else {
+            cli_err(s, "tx", "Timestamp %" PRIu64 " is not in the capture.\n",
+                    start_ts);
+            status = CLI_RET_INVPARAM;
+        }
+    }
+
+    sigmf_index_free(&index);
+
+    if (status != 0) {
+        return status;
+    }
+
+out:
+    MUTEX_LOCK(&tx->param_lock);
+    tx_params->start_offset = sample;
+    MUTEX_UNLOCK(&tx->param_lock);
+
+    return 0;
+}
+
+void tx_set_waveform(struct rxtx_data *tx, void *waveform, size_t n, bool sc8)
+{
+    struct tx_params *tx_params = tx->params;
+
+    MUTEX_LOCK(&tx->param_lock);
+    free(tx_params->waveform);
+    tx_params->waveform         = waveform;
+    tx_params->waveform_samples = (waveform != NULL) ? n : 0;
+    tx_params->waveform_sc8     = sc8;
+    MUTEX_UNLOCK(&tx->param_lock);
+}
+
+/* Check that a generated waveform can be played back as configured
+ *
+ * return 0 on success, CLI_RET_* on failure */
+static int tx_check_waveform(struct cli_state *s)
+{
+    struct tx_params *tx_params = s->tx->params;
+    int status = 0;
+
+    MUTEX_LOCK(&s->tx->param_lock);
+
+    if (tx_params->waveform_sc8 != s->bit_mode_8bit) {
+        cli_err(s, "tx", "The generated waveform does not match the current "
+                "bitmode. Run generate again.\n");
+        status = CLI_RET_INVPARAM;
+    } else if (tx_params->start_timestamp != 0) {
+        cli_err(s, "tx", "The 'start' parameter requires a SigMF file.\n");
+        status = CLI_RET_INVPARAM;
+    } else {
+        tx_params->start_offset = 0;
+    }
+
+    MUTEX_UNLOCK(&s->tx->param_lock);
+
+    return status;
+}
+
 static int tx_cmd_start(struct cli_state *s)
 {
     int status = 0;
+    bool generated;
 
     /* Check that we're able to start up in our current state */
     status = rxtx_cmd_start_check(s, s->tx, "tx");
@@ -480,6 +938,19 @@ static int tx_cmd_start(struct cli_state *s)
         return status;
     }
 
+    MUTEX_LOCK(&s->tx->param_lock);
+    generated = (((struct tx_params *)s->tx->params)->waveform != NULL);
+    MUTEX_UNLOCK(&s->tx->param_lock);
+
+    if (generated) {
+        status = tx_check_waveform(s);
+        if (status != 0) {
+            return status;
+        }
+
+        goto start;
+    }
+
     /* Perform file conversion (if needed) and open input file */
     MUTEX_LOCK(&s->tx->file_mgmt.file_meta_lock);
 
@@ -498,11 +969,16 @@ static int tx_cmd_start(struct cli_state *s)
         }
     }
 
+    if (status == 0) {
+        status = tx_resolve_start_offset(s);
+    }
+
     if (status == 0) {
         MUTEX_LOCK(&s->tx->file_mgmt.file_lock);
 
         assert(s->tx->file_mgmt.format == RXTX_FMT_BIN_SC16Q11 ||
-               s->tx->file_mgmt.format == RXTX_FMT_BIN_SC8Q7);
+               s->tx->file_mgmt.format == RXTX_FMT_BIN_SC8Q7 ||
+               s->tx->file_mgmt.format == RXTX_FMT_SIGMF);
         status = expand_and_open(s->tx->file_mgmt.path, "rb",
                                  &s->tx->file_mgmt.file);
         MUTEX_UNLOCK(&s->tx->file_mgmt.file_lock);
@@ -514,6 +990,7 @@ static int tx_cmd_start(struct cli_state *s)
         return status;
     }
 
+start:
     /* Request thread to start running */
     rxtx_submit_request(s->tx, RXTX_TASK_REQ_START);
     status = rxtx_wait_for_state(s->tx, RXTX_STATE_RUNNING, 3000);
@@ -531,19 +1008,30 @@ static int tx_cmd_start(struct cli_state *s)
 static void tx_print_config(struct rxtx_data *tx)
 {
     unsigned int repetitions, repeat_delay;
+    bool use_mmap;
+    uint64_t start_ts;
+    size_t waveform_samples;
     struct tx_params *tx_params = tx->params;
 
     MUTEX_LOCK(&tx->param_lock);
     repetitions  = tx_params->repeat;
     repeat_delay = tx_params->repeat_delay;
+    use_mmap     = tx_params->use_mmap;
+    start_ts     = tx_params->start_timestamp;
+    waveform_samples = tx_params->waveform_samples;
     MUTEX_UNLOCK(&tx->param_lock);
 
     printf("\n");
     rxtx_print_state(tx, "  State: ", "\n");
     rxtx_print_channel(tx, "  Channels: ", "\n");
     rxtx_print_error(tx, "  Last error: ", "\n");
-    rxtx_print_file(tx, "  File: ", "\n");
-    rxtx_print_file_format(tx, "  File format: ", "\n");
+
+    if (waveform_samples) {
+        printf("  Waveform: generated, %zu samples\n", waveform_samples);
+    } else {
+        rxtx_print_file(tx, "  File: ", "\n");
+        rxtx_print_file_format(tx, "  File format: ", "\n");
+    }
 
     if (repetitions) {
         printf("  Repetitions: %u\n", repetitions);
@@ -557,6 +1045,14 @@ static void tx_print_config(struct rxtx_data *tx)
         printf("  Repetition delay: none\n");
     }
 
+    if (start_ts) {
+        printf("  Start timestamp: %" PRIu64 "\n", start_ts);
+    } else {
+        printf("  Start timestamp: beginning of file\n");
+    }
+
+    printf("  Memory-mapped playback: %s\n", use_mmap ? "on" : "off");
+
     rxtx_print_stream_info(tx, "  ", "\n");
 
     printf("\n");
@@ -581,7 +1077,18 @@ static int tx_config(struct cli_state *s, int argc, char **argv)
 
         if (status < 0) {
             return status;
-        } else if (status == 0) {
+        } else if (status > 0) {
+            /* A file replaces any generated waveform */
+            if (!strcasecmp("file", argv[i])) {
+                if (rxtx_task_running(s->tx)) {
+                    cli_err(s, argv[0], "Cannot update parameter while task "
+                            "is running");
+                    return CLI_RET_STATE;
+                }
+
+                tx_set_waveform(s->tx, NULL, 0, false);
+            }
+        } else {
             if (!strcasecmp("repeat", argv[i])) {
                 /* Configure the number of transmission repetitions to use */
                 unsigned int tmp;
@@ -611,6 +1118,32 @@ static int tx_config(struct cli_state *s, int argc, char **argv)
                     cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
                     return CLI_RET_INVPARAM;
                 }
+            } else if (!strcasecmp("start", argv[i])) {
+                /* Configure the timestamp of a SigMF capture to start at */
+                uint64_t tmp;
+                bool ok;
+
+                tmp = str2uint64(val, 0, UINT64_MAX, &ok);
+                if (ok) {
+                    MUTEX_LOCK(&s->tx->param_lock);
+                    tx_params->start_timestamp = tmp;
+                    MUTEX_UNLOCK(&s->tx->param_lock);
+                } else {
+                    cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
+                    return CLI_RET_INVPARAM;
+                }
+            } else if (!strcasecmp("mmap", argv[i])) {
+                /* Configure whether to play back from a file mapping */
+                bool tmp;
+
+                if (str2bool(val, &tmp) == 0) {
+                    MUTEX_LOCK(&s->tx->param_lock);
+                    tx_params->use_mmap = tmp;
+                    MUTEX_UNLOCK(&s->tx->param_lock);
+                } else {
+                    cli_err(s, argv[0], RXTX_ERRMSG_VALUE(argv[i], val));
+                    return CLI_RET_INVPARAM;
+                }
             } else if (!strcasecmp("channel", argv[i])) {
                 /* Configure TX channels */
                 status = rxtx_handle_channel_list(s, s->tx, val);
@@ -0,0 +1,378 @@
+/*
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* For sendmmsg() */
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_config.h"
+#include "minmax.h"
+#include "common.h"
+#include "vita49.h"
+
+#if BLADERF_OS_WINDOWS
+
+int vita49_sink_open(struct vita49_sink **sink,
+                     const char *dests,
+                     bool sc8,
+                     unsigned int num_channels,
+                     uint32_t stream_id,
+                     size_t max_samples)
+{
+    *sink = NULL;
+    return CLI_RET_UNSUPPORTED;
+}
+
+int vita49_sink_send(struct vita49_sink *sink,
+                     void *samples,
+                     size_t n,
+                     uint64_t timestamp)
+{
+    return EINVAL;
+}
+
+void vita49_sink_close(struct vita49_sink *sink)
+{
+}
+
+#else
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if BLADERF_OS_LINUX || BLADERF_OS_FREEBSD
+#define VITA49_HAVE_SENDMMSG 1
+#endif
+
+/* Header words preceding each payload */
+#define VITA49_HDR_WORDS 4
+
+/* Packet type 1: IF Data with a Stream ID, and no Class ID or trailer */
+#define VITA49_HDR_IF_DATA (0x1u << 28)
+
+/* No integer timestamp, and a sample-count fractional timestamp */
+#define VITA49_HDR_TSF_SAMPLE_COUNT (0x1u << 20)
+
+/* Room for a few buffers' worth of packets, so brief stalls in the network
+ * stack do not hold up the writer */
+#define VITA49_SNDBUF_SIZE (4 * 1024 * 1024)
+
+/* Max # of packets per sendmmsg() call (Linux's UIO_MAXIOV) */
+#define VITA49_BATCH 1024
+
+#ifdef VITA49_HAVE_SENDMMSG
+typedef struct mmsghdr vita49_msg;
+#define VITA49_MSGHDR(m) (&(m)->msg_hdr)
+#else
+typedef struct msghdr vita49_msg;
+#define VITA49_MSGHDR(m) (m)
+#endif
+
+struct vita49_sink {
+    int fd;
+    struct sockaddr_storage dests[VITA49_MAX_DESTS];
+    socklen_t dest_lens[VITA49_MAX_DESTS];
+    unsigned int num_dests;
+
+    bool sc8;
+    unsigned int num_channels;
+    uint32_t stream_id;
+    unsigned int packet_count;  /* # of packets sent, modulo 16 */
+
+    size_t sample_size;         /* Size of an I/Q pair, in bytes */
+    size_t packet_samples;      /* Max # of samples per packet */
+    size_t max_packets;         /* Max # of packets per block */
+
+    /* Preallocated for the packets of a single block */
+    uint32_t *hdrs;             /* VITA49_HDR_WORDS per packet */
+    struct iovec *iov;          /* Header, payload, and padding per packet */
+    vita49_msg *msgs;           /* One per packet and destination */
+};
+
+/* Payloads are a whole number of words. Only an odd # of SC8 Q7 samples
+ * in the last packet of a block needs padding. */
+static const uint8_t vita49_pad[4] = { 0 };
+
+/* Resolve a single "host:port" destination, modifying `dest` */
+static int vita49_add_dest(struct vita49_sink *sink, char *dest)
+{
+    struct addrinfo hints, *res;
+    char *host = dest;
+    char *port;
+    size_t len;
+    int status;
+
+    port = strrchr(dest, ':');
+    if (port == NULL || port[1] == '\0' || port == dest) {
+        return CLI_RET_INVPARAM;
+    }
+
+    *port++ = '\0';
+
+    /* Brackets enclose an IPv6 address, which has colons of its own */
+    len = strlen(host);
+    if (host[0] == '[') {
+        if (len < 3 || host[len - 1] != ']') {
+            return CLI_RET_INVPARAM;
+        }
+
+        host[len - 1] = '\0';
+        host++;
+    }
+
+    if (sink->num_dests == VITA49_MAX_DESTS) {
+        return CLI_RET_INVPARAM;
+    }
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    status = getaddrinfo(host, port, &hints, &res);
+    if (status != 0) {
+        return CLI_RET_INVPARAM;
+    }
+
+    /* All destinations are sent to from a single socket */
+    if ((sink->num_dests > 0 &&
+         res->ai_family != sink->dests[0].ss_family) ||
+        res->ai_addrlen > sizeof(sink->dests[0])) {
+        freeaddrinfo(res);
+        return CLI_RET_INVPARAM;
+    }
+
+    memcpy(&sink->dests[sink->num_dests], res->ai_addr, res->ai_addrlen);
+    sink->dest_lens[sink->num_dests] = res->ai_addrlen;
+    sink->num_dests++;
+
+    freeaddrinfo(res);
+    return 0;
+}
+
+static int vita49_parse_dests(struct vita49_sink *sink, const char *dests)
+{
+    char *list, *dest, *saveptr;
+    int status = 0;
+
+    list = strdup(dests);
+    if (list == NULL) {
+        return CLI_RET_MEM;
+    }
+
+    for (dest = strtok_r(list, ",", &saveptr); dest != NULL && status == 0;
+         dest = strtok_r(NULL, ",", &saveptr)) {
+        status = vita49_add_dest(sink, dest);
+    }
+
+    if (status == 0 && sink->num_dests == 0) {
+        status = CLI_RET_INVPARAM;
+    }
+
+    free(list);
+    return status;
+}
+
+int vita49_sink_open(struct vita49_sink **sink_out,
+                     const char *dests,
+                     bool sc8,
+                     unsigned int num_channels,
+                     uint32_t stream_id,
+                     size_t max_samples)
+{
+    struct vita49_sink *sink;
+    int sndbuf = VITA49_SNDBUF_SIZE;
+    int status;
+
+    *sink_out = NULL;
+
+    if (num_channels == 0 || max_samples == 0) {
+        return CLI_RET_INVPARAM;
+    }
+
+    sink = calloc(1, sizeof(*sink));
+    if (sink == NULL) {
+        return CLI_RET_MEM;
+    }
+
+    sink->fd           = -1;
+    sink->sc8          = sc8;
+    sink->num_channels = num_channels;
+    sink->stream_id    = stream_id;
+    sink->sample_size  = 2 * (sc8 ? sizeof(int8_t) : sizeof(int16_t));
+
+    /* Packets never split a multi-channel sample */
+    sink->packet_samples = VITA49_PAYLOAD_BYTES / sink->sample_size;
+    sink->packet_samples -= sink->packet_samples % num_channels;
+    sink->max_packets =
+        (max_samples + sink->packet_samples - 1) / sink->packet_samples;
+
+    status = vita49_parse_dests(sink, dests);
+    if (status != 0) {
+        goto error;
+    }
+
+    sink->hdrs = calloc(sink->max_packets * VITA49_HDR_WORDS,
+                        sizeof(sink->hdrs[0]));
+    sink->iov  = calloc(sink->max_packets * 3, sizeof(sink->iov[0]));
+    sink->msgs = calloc(sink->max_packets * sink->num_dests,
+                        sizeof(sink->msgs[0]));
+    if (sink->hdrs == NULL || sink->iov == NULL || sink->msgs == NULL) {
+        status = CLI_RET_MEM;
+        goto error;
+    }
+
+    sink->fd = socket(sink->dests[0].ss_family, SOCK_DGRAM, 0);
+    if (sink->fd < 0) {
+        status = errno;
+        goto error;
+    }
+
+    /* Best effort; the default is used if this is not permitted */
+    setsockopt(sink->fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+
+    *sink_out = sink;
+    return 0;
+
+error:
+    vita49_sink_close(sink);
+    return status;
+}
+
+static int vita49_send_msgs(struct vita49_sink *sink, size_t count)
+{
+    size_t sent = 0;
+    int ret;
+
+    while (sent < count) {
+#ifdef VITA49_HAVE_SENDMMSG
+        ret = sendmmsg(sink->fd, &sink->msgs[sent],
+                       (unsigned int)min_sz(count - sent, VITA49_BATCH), 0);
+#else
+        ret = sendmsg(sink->fd, &sink->msgs[sent], 0) < 0 ? -1 : 1;
+#endif
+
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return errno;
+        }
+
+        sent += (size_t)ret;
+    }
+
+    return 0;
+}
+
+int vita49_sink_send(struct vita49_sink *sink,
+                     void *samples,
+                     size_t n,
+                     uint64_t timestamp)
+{
+    uint8_t *payload = samples;
+    size_t num_packets = 0;
+    size_t offset, count, bytes, pad;
+    unsigned int d;
+
+    if ((n + sink->packet_samples - 1) / sink->packet_samples >
+        sink->max_packets) {
+        return EINVAL;
+    }
+
+#if !BLADERF_BIG_ENDIAN
+    if (!sink->sc8) {
+        uint16_t *val = samples;
+        size_t i;
+
+        for (i = 0; i < 2 * n; i++) {
+            val[i] = (uint16_t)((val[i] << 8) | (val[i] >> 8));
+        }
+    }
+#endif
+
+    for (offset = 0; offset < n; offset += count) {
+        uint32_t *hdr      = &sink->hdrs[num_packets * VITA49_HDR_WORDS];
+        struct iovec *iov  = &sink->iov[num_packets * 3];
+        uint64_t packet_ts = timestamp + offset / sink->num_channels;
+        uint32_t words;
+
+        count = min_sz(n - offset, sink->packet_samples);
+        bytes = count * sink->sample_size;
+        pad   = (4 - bytes % 4) % 4;
+        words = (uint32_t)(VITA49_HDR_WORDS + (bytes + pad) / 4);
+
+        hdr[0] = htonl(VITA49_HDR_IF_DATA | VITA49_HDR_TSF_SAMPLE_COUNT |
+                       ((sink->packet_count & 0xf) << 16) | words);
+        hdr[1] = htonl(sink->stream_id);
+        hdr[2] = htonl((uint32_t)(packet_ts >> 32));
+        hdr[3] = htonl((uint32_t)packet_ts);
+
+        sink->packet_count++;
+
+        iov[0].iov_base = hdr;
+        iov[0].iov_len  = VITA49_HDR_WORDS * sizeof(hdr[0]);
+        iov[1].iov_base = payload + offset * sink->sample_size;
+        iov[1].iov_len  = bytes;
+        iov[2].iov_base = (void *)vita49_pad;
+        iov[2].iov_len  = pad;
+
+        /* Each destination is sent the packet straight from the buffer */
+        for (d = 0; d < sink->num_dests; d++) {
+            struct msghdr *msg = VITA49_MSGHDR(
+                &sink->msgs[num_packets * sink->num_dests + d]);
+
+            memset(msg, 0, sizeof(*msg));
+            msg->msg_name    = &sink->dests[d];
+            msg->msg_namelen = sink->dest_lens[d];
+            msg->msg_iov     = iov;
+            msg->msg_iovlen  = (pad != 0) ? 3 : 2;
+        }
+
+        num_packets++;
+    }
+
+    return vita49_send_msgs(sink, num_packets * sink->num_dests);
+}
+
+void vita49_sink_close(struct vita49_sink *sink)
+{
+    if (sink == NULL) {
+        return;
+    }
+
+    if (sink->fd >= 0) {
+        close(sink->fd);
+    }
+
+    free(sink->msgs);
+    free(sink->iov);
+    free(sink->hdrs);
+    free(sink);
+}
+
+#endif
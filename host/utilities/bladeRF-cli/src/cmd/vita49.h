@@ -0,0 +1,103 @@
+/**
+ * @file vita49.h
+ *
+ * @brief VITA-49 UDP output for rx
+ *
+ * Received buffers are split into VITA-49 (VRT) IF Data packets and sent to
+ * one or more UDP destinations, so that samples may be processed live
+ * elsewhere. Each packet carries:
+ *
+ *  - A header word, with a 4-bit packet count and the packet size in words
+ *  - A stream ID: a bitmask of the RX channels whose samples it carries
+ *  - A 64-bit sample-count (fractional) timestamp of its first sample,
+ *    taken from the device's RX timestamp counter
+ *  - Interleaved I/Q samples (and channels, for MIMO captures), as big-endian
+ *    16-bit SC16 Q11 or 8-bit SC8 Q7 values
+ *
+ * Packets hold at most VITA49_PAYLOAD_BYTES of samples, so that they fit a
+ * standard 1500 byte Ethernet MTU. A gap in the timestamps of consecutive
+ * packets indicates dropped samples (e.g., an RX overrun).
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef VITA49_H__
+#define VITA49_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Max bytes of samples per packet */
+#define VITA49_PAYLOAD_BYTES 1440
+
+/* Max # of destinations a sink may send to */
+#define VITA49_MAX_DESTS 8
+
+struct vita49_sink;
+
+/**
+ * Open a sink sending to a list of UDP destinations
+ *
+ * @param[out]  sink            Opened sink
+ * @param[in]   dests           Comma-delimited list of destinations, each
+ *                              given as host:port. IPv6 hosts are enclosed
+ *                              in brackets, e.g., [::1]:5000. Multicast
+ *                              addresses may be used.
+ * @param[in]   sc8             Samples are SC8 Q7, rather than SC16 Q11
+ * @param[in]   num_channels    # of interleaved channels in the samples
+ * @param[in]   stream_id       Stream ID to place in each packet
+ * @param[in]   max_samples     Max # of samples passed to vita49_sink_send()
+ *
+ * @return 0 on success, CLI_RET_INVPARAM if `dests` is invalid or cannot be
+ *         resolved, CLI_RET_MEM on allocation failure, CLI_RET_UNSUPPORTED
+ *         on platforms without UDP socket support, or an errno value if the
+ *         socket could not be created.
+ */
+int vita49_sink_open(struct vita49_sink **sink,
+                     const char *dests,
+                     bool sc8,
+                     unsigned int num_channels,
+                     uint32_t stream_id,
+                     size_t max_samples);
+
+/**
+ * Send a block of contiguous samples to every destination
+ *
+ * The samples are converted to big-endian in place.
+ *
+ * @param   sink        Sink to send to
+ * @param   samples     Samples, in host byte order
+ * @param   n           # of samples, counting each channel's I/Q pair
+ * @param   timestamp   Device timestamp of the first sample
+ *
+ * @return 0 on success, or an errno value if sending failed
+ */
+int vita49_sink_send(struct vita49_sink *sink,
+                     void *samples,
+                     size_t n,
+                     uint64_t timestamp);
+
+/**
+ * Close a sink. Passing NULL is a no-op.
+ *
+ * @param   sink        Sink to close
+ */
+void vita49_sink_close(struct vita49_sink *sink);
+
+#endif
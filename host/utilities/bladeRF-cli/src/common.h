@@ -119,6 +119,10 @@ struct cli_state {
     struct rxtx_data *tx; /**< Data for sample transmission */
 
     bool bit_mode_8bit; /**< Bit mode is set to 16 bits */
+
+    /** Settings gathered up front by an argumentless "print", while it
+     *  runs. NULL otherwise. */
+    const struct bladerf_device_state *snapshot;
 };
 
 /**
@@ -0,0 +1,901 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * Converts recorded samples between formats, using libbladeRF's sample
+ * conversions. Inputs are memory mapped, and split into chunks that are
+ * converted by a pool of threads and written in place in the output files.
+ *
+ * Compressed (IQZ) inputs are split into their blocks, which are decoded by
+ * the same pool. Compressed outputs are converted in order, and compressed
+ * by the IQZ writer's own threads.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "libbladeRF.h"
+#include "conversions.h"
+#include "host_config.h"
+#include "iqz.h"
+
+/* Max # of interleaved or planar channels */
+#define MAX_CHANNELS 2
+
+/* # of samples per channel converted at a time */
+#define CHUNK_SAMPLES (256 * 1024)
+
+#define OPTSTR "f:t:o:c:pj:mr:F:h"
+static struct option long_options[] = {
+    { "from",       required_argument,  NULL,   'f' },
+    { "to",         required_argument,  NULL,   't' },
+    { "output",     required_argument,  NULL,   'o' },
+    { "channels",   required_argument,  NULL,   'c' },
+    { "planar",     no_argument,        NULL,   'p' },
+    { "jobs",       required_argument,  NULL,   'j' },
+    { "sigmf",      no_argument,        NULL,   'm' },
+    { "rate",       required_argument,  NULL,   'r' },
+    { "frequency",  required_argument,  NULL,   'F' },
+    { "help",       no_argument,        NULL,   'h' },
+    { NULL,         0,                  NULL,   0   },
+};
+
+struct sample_fmt {
+    const char *name;
+    bladerf_format format;
+    size_t size;            /* Size of an I/Q pair, in bytes */
+    const char *datatype;   /* SigMF datatype, or NULL */
+};
+
+static const struct sample_fmt formats[] = {
+    { "sc16", BLADERF_FORMAT_SC16_Q11, 4, "ci16_le" },
+    { "sc8", BLADERF_FORMAT_SC8_Q7, 2, "ci8" },
+    { "cf32", BLADERF_FORMAT_CF32, 8, "cf32_le" },
+    { "sc12", BLADERF_FORMAT_SC12_PACKED, 3, NULL },
+};
+
+#define NUM_FORMATS (sizeof(formats) / sizeof(formats[0]))
+
+struct convert {
+    const struct sample_fmt *in_fmt;
+    const struct sample_fmt *out_fmt;   /* NULL for CSV */
+    unsigned int num_channels;
+    bool planar_in;
+    bool planar_out;
+
+    const uint8_t *in[MAX_CHANNELS];    /* Mapped input files */
+    size_t in_len[MAX_CHANNELS];
+    unsigned int num_in;
+
+    int out[MAX_CHANNELS];              /* Output files */
+    FILE *csv;
+    unsigned int num_out;
+
+    struct iqz_reader *iqz_in;          /* Compressed input, or NULL */
+    struct iqz_writer *iqz_out;         /* Compressed output, or NULL */
+    FILE *iqz_file;                     /* File of iqz_out */
+
+    uint64_t count;                     /* # of samples per channel */
+    size_t chunk_samples;               /* # of samples per channel of each
+                                         * chunk */
+    uint64_t num_chunks;
+
+    pthread_mutex_t lock;
+    uint64_t next_chunk;                /* Next chunk to be converted */
+    int status;                         /* First failure */
+};
+
+static void usage(const char *argv0)
+{
+    printf("Usage: %s [options] -o <output> <input> [<input>]\n", argv0);
+    printf("Convert recorded samples between formats. Two inputs are two\n");
+    printf("channels' planar files, and are interleaved unless -p is given.\n");
+    printf("\n");
+    printf("  -f, --from <fmt>          Input format (default: sc16), or iqz.\n");
+    printf("  -t, --to <fmt>            Output format (default: cf32), csv, or\n");
+    printf("                            iqz.\n");
+    printf("  -o, --output <file>       Output file. Planar outputs are named by\n");
+    printf("                            inserting _rx<N> before the extension.\n");
+    printf("  -c, --channels <n>        # of channels interleaved in a single\n");
+    printf("                            input (default: 1).\n");
+    printf("  -p, --planar              Write one output file per channel.\n");
+    printf("  -j, --jobs <n>            # of conversion or compression threads\n");
+    printf("                            (default: one per online CPU).\n");
+    printf("  -m, --sigmf               Write a SigMF .sigmf-meta file for each\n");
+    printf("                            output.\n");
+    printf("  -r, --rate <sps>          Sample rate to record in SigMF metadata.\n");
+    printf("  -F, --frequency <Hz>      Frequency to record in SigMF metadata.\n");
+    printf("  -h, --help                Display this help text and exit.\n");
+    printf("\n");
+    printf("Formats are sc16 (SC16 Q11), sc8 (SC8 Q7), cf32 (32-bit float I/Q,\n");
+    printf("with full scale at 1.0), and sc12 (12-bit packed, to or from sc16\n");
+    printf("only), all little-endian. CSV output holds one line per sample,\n");
+    printf("with the I and Q values of each channel in turn, and is written\n");
+    printf("by a single thread.\n");
+    printf("\n");
+    printf("iqz files hold losslessly compressed sc16 or sc8 samples, such as\n");
+    printf("bladeRF-cli's iqz captures, and describe their own format and # of\n");
+    printf("channels. Samples are compressed to iqz as sc16, or as sc8 from an\n");
+    printf("sc8 input.\n");
+}
+
+static const struct sample_fmt *str2fmt(const char *str)
+{
+    size_t i;
+
+    for (i = 0; i < NUM_FORMATS; i++) {
+        if (!strcasecmp(str, formats[i].name)) {
+            return &formats[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* Name channel `ch`'s file of a planar output, inserting _rx<N> before the
+ * extension of `path`. Returns a heap-allocated path, or NULL. */
+static char *planar_path(const char *path, unsigned int ch)
+{
+    const char *slash = strrchr(path, '/');
+    const char *dot   = strrchr(path, '.');
+    size_t len        = strlen(path) + 16;
+    char *ret;
+
+    if (dot == NULL || (slash != NULL && dot < slash + 2) || dot == path) {
+        dot = path + strlen(path);
+    }
+
+    ret = malloc(len);
+    if (ret != NULL) {
+        snprintf(ret, len, "%.*s_rx%u%s", (int)(dot - path), path, ch + 1,
+                 dot);
+    }
+
+    return ret;
+}
+
+static int write_all(int fd, const void *buf, size_t len, uint64_t offset)
+{
+    const uint8_t *p = buf;
+    ssize_t written;
+
+    while (len > 0) {
+        written = pwrite(fd, p, len, (off_t)offset);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written <= 0) {
+            return written < 0 ? errno : EIO;
+        }
+
+        p      += written;
+        len    -= (size_t)written;
+        offset += (uint64_t)written;
+    }
+
+    return 0;
+}
+
+/* Write converted samples at `offset` of output `ch`, or if compressing,
+ * append them to the output, as chunks are then converted in order.
+ *
+ * returns 0 on success, or a positive errno value on failure */
+static int write_out(struct convert *c,
+                     unsigned int ch,
+                     const void *buf,
+                     size_t len,
+                     uint64_t offset)
+{
+    if (c->iqz_out != NULL) {
+        return iqz_writer_write(c->iqz_out, buf, len / c->out_fmt->size);
+    }
+
+    return write_all(c->out[ch], buf, len, offset);
+}
+
+/* Convert and write `k` samples per channel, starting at sample `first`.
+ * `in` holds the chunk's samples of each input, or of the single
+ * interleaved input. `scratch` holds two areas of chunk_samples *
+ * num_channels output samples.
+ *
+ * returns 0 on success, or a negative BLADERF_ERR_* or positive errno value
+ * on failure */
+static int convert_chunk(struct convert *c,
+                         uint64_t first,
+                         size_t k,
+                         const uint8_t *in[MAX_CHANNELS],
+                         uint8_t *scratch[2])
+{
+    const size_t out_size  = c->out_fmt->size;
+    const unsigned int nch = c->num_channels;
+    void *dest[MAX_CHANNELS];
+    unsigned int ch;
+    int status = 0;
+
+    if (!c->planar_in) {
+        status = bladerf_convert_samples(c->in_fmt->format, in[0],
+                                         c->out_fmt->format, scratch[0],
+                                         k * nch);
+
+        if (status != 0) {
+            return status;
+        }
+
+        if (!c->planar_out || nch == 1) {
+            return write_out(c, 0, scratch[0], k * nch * out_size,
+                             first * nch * out_size);
+        }
+
+        for (ch = 0; ch < nch; ch++) {
+            dest[ch] = scratch[1] + ch * k * out_size;
+        }
+
+        status = bladerf_deinterleave_stream_buffer_to(
+            BLADERF_RX_X2, c->out_fmt->format, (unsigned int)(k * nch),
+            scratch[0], dest);
+
+        for (ch = 0; ch < nch && status == 0; ch++) {
+            status = write_out(c, ch, dest[ch], k * out_size,
+                               first * out_size);
+        }
+
+        return status;
+    }
+
+    for (ch = 0; ch < nch && status == 0; ch++) {
+        status = bladerf_convert_samples(
+            c->in_fmt->format, in[ch], c->out_fmt->format,
+            scratch[0] + ch * k * out_size, k);
+    }
+
+    if (status != 0) {
+        return status;
+    }
+
+    if (c->planar_out) {
+        for (ch = 0; ch < nch && status == 0; ch++) {
+            status = write_out(c, ch, scratch[0] + ch * k * out_size,
+                               k * out_size, first * out_size);
+        }
+
+        return status;
+    }
+
+    /* The channels' blocks are concatenated, as this expects */
+    status = bladerf_interleave_stream_buffer(
+        BLADERF_RX_X2, c->out_fmt->format, (unsigned int)(k * nch),
+        scratch[0]);
+
+    if (status == 0) {
+        status = write_out(c, 0, scratch[0], k * nch * out_size,
+                           first * nch * out_size);
+    }
+
+    return status;
+}
+
+static void *convert_task(void *arg)
+{
+    struct convert *c = arg;
+    const size_t in_size = c->in_fmt->size;
+    const unsigned int nch = c->num_channels;
+    const size_t area = c->chunk_samples * nch *
+                        (c->in_fmt->size > c->out_fmt->size
+                             ? c->in_fmt->size
+                             : c->out_fmt->size);
+    const uint8_t *in[MAX_CHANNELS];
+    uint8_t *scratch[2];
+    uint8_t *decoded = NULL;
+    uint64_t chunk, first;
+    unsigned int ch;
+    size_t k, n;
+    int status = 0;
+
+    scratch[0] = malloc(area);
+    scratch[1] = malloc(area);
+    if (c->iqz_in != NULL) {
+        decoded = malloc(area);
+    }
+
+    if (scratch[0] == NULL || scratch[1] == NULL ||
+        (c->iqz_in != NULL && decoded == NULL)) {
+        status = ENOMEM;
+    }
+
+    while (status == 0) {
+        pthread_mutex_lock(&c->lock);
+        if (c->status != 0 || c->next_chunk == c->num_chunks) {
+            pthread_mutex_unlock(&c->lock);
+            break;
+        }
+        chunk = c->next_chunk++;
+        pthread_mutex_unlock(&c->lock);
+
+        first = chunk * c->chunk_samples;
+        k     = (size_t)((c->count - first < c->chunk_samples)
+                             ? c->count - first
+                             : c->chunk_samples);
+
+        /* Chunks of a compressed input are its blocks */
+        if (c->iqz_in != NULL) {
+            status = iqz_reader_decode(c->iqz_in, chunk, decoded, &n);
+            if (status != 0) {
+                fprintf(stderr, "Block %" PRIu64 " of the input is corrupt.\n",
+                        chunk);
+                break;
+            }
+
+            in[0] = decoded;
+            k     = n / nch;
+        } else if (c->planar_in) {
+            for (ch = 0; ch < nch; ch++) {
+                in[ch] = c->in[ch] + first * in_size;
+            }
+        } else {
+            in[0] = c->in[0] + first * nch * in_size;
+        }
+
+        status = convert_chunk(c, first, k, in, scratch);
+    }
+
+    if (status != 0) {
+        pthread_mutex_lock(&c->lock);
+        if (c->status == 0) {
+            c->status = status;
+        }
+        pthread_mutex_unlock(&c->lock);
+    }
+
+    free(decoded);
+    free(scratch[1]);
+    free(scratch[0]);
+
+    return NULL;
+}
+
+/* Print a CSV field of sample value `i` of a (non-packed) input */
+static void csv_value(FILE *f, const struct sample_fmt *fmt,
+                      const uint8_t *samples, uint64_t i)
+{
+    switch (fmt->format) {
+        case BLADERF_FORMAT_SC8_Q7:
+            fprintf(f, "%d", ((const int8_t *)samples)[i]);
+            break;
+
+        case BLADERF_FORMAT_CF32:
+            fprintf(f, "%.9g", ((const float *)samples)[i]);
+            break;
+
+        default:
+            fprintf(f, "%d", ((const int16_t *)samples)[i]);
+            break;
+    }
+}
+
+/* CSV is meant for small test vectors, so it is written by a single thread,
+ * in order. The values are those of the input format. */
+static int convert_csv(struct convert *c)
+{
+    const unsigned int nch = c->num_channels;
+    uint64_t n, ch;
+
+    for (n = 0; n < c->count; n++) {
+        for (ch = 0; ch < nch; ch++) {
+            const uint8_t *samples = c->planar_in ? c->in[ch] : c->in[0];
+            uint64_t i = c->planar_in ? 2 * n : 2 * (n * nch + ch);
+
+            csv_value(c->csv, c->in_fmt, samples, i);
+            fputc(',', c->csv);
+            csv_value(c->csv, c->in_fmt, samples, i + 1);
+            fputc(ch + 1 < nch ? ',' : '\n', c->csv);
+        }
+    }
+
+    return ferror(c->csv) ? EIO : 0;
+}
+
+/* Write the SigMF meta file describing a dataset. A .sigmf-data extension is
+ * replaced, otherwise .sigmf-meta is appended. */
+static int write_sigmf_meta(const char *data_path,
+                            const struct sample_fmt *fmt,
+                            unsigned int num_channels,
+                            uint64_t rate,
+                            uint64_t frequency)
+{
+    static const char data_ext[] = ".sigmf-data";
+    size_t len = strlen(data_path);
+    size_t stem_len = len;
+    char *path;
+    FILE *f;
+
+    if (len > strlen(data_ext) &&
+        !strcmp(data_path + len - strlen(data_ext), data_ext)) {
+        stem_len -= strlen(data_ext);
+    }
+
+    path = malloc(stem_len + sizeof(".sigmf-meta"));
+    if (path == NULL) {
+        return ENOMEM;
+    }
+
+    memcpy(path, data_path, stem_len);
+    strcpy(path + stem_len, ".sigmf-meta");
+
+    f = fopen(path, "w");
+    free(path);
+    if (f == NULL) {
+        return errno;
+    }
+
+    fprintf(f, "{\n");
+    fprintf(f, "    \"global\": {\n");
+    fprintf(f, "        \"core:datatype\": \"%s\",\n", fmt->datatype);
+    if (rate != 0) {
+        fprintf(f, "        \"core:sample_rate\": %" PRIu64 ",\n", rate);
+    }
+    fprintf(f, "        \"core:num_channels\": %u,\n", num_channels);
+    fprintf(f, "        \"core:version\": \"1.0.0\",\n");
+    fprintf(f, "        \"core:recorder\": \"bladeRF-convert\"\n");
+    fprintf(f, "    },\n");
+    fprintf(f, "    \"captures\": [\n");
+    fprintf(f, "        { \"core:sample_start\": 0");
+    if (frequency != 0) {
+        fprintf(f, ", \"core:frequency\": %" PRIu64, frequency);
+    }
+    fprintf(f, " }\n");
+    fprintf(f, "    ],\n");
+    fprintf(f, "    \"annotations\": []\n");
+    fprintf(f, "}\n");
+
+    return fclose(f) == 0 ? 0 : errno;
+}
+
+static int map_input(struct convert *c, const char *path)
+{
+    struct stat st;
+    void *addr;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Failed to open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    if (fstat(fd, &st) != 0) {
+        fprintf(stderr, "Failed to stat %s: %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    addr = NULL;
+    if (st.st_size > 0) {
+        addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            fprintf(stderr, "Failed to map %s: %s\n", path, strerror(errno));
+            close(fd);
+            return -1;
+        }
+
+        /* Chunks are claimed in order, so the file is read mostly
+         * sequentially */
+        madvise(addr, (size_t)st.st_size, MADV_SEQUENTIAL);
+    }
+
+    close(fd);
+
+    c->in[c->num_in]     = addr;
+    c->in_len[c->num_in] = (size_t)st.st_size;
+    c->num_in++;
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    struct convert c;
+    const char *output = NULL;
+    char *paths[MAX_CHANNELS] = { NULL };
+    bool sigmf   = false;
+    bool csv     = false;
+    bool iqz_in  = false;
+    bool iqz_out = false;
+    bool channels_given = false;
+    const struct iqz_info *info;
+    uint64_t rate = 0, frequency = 0;
+    unsigned int jobs = 0;
+    unsigned int ch, i;
+    pthread_t *threads = NULL;
+    int ret = 1;
+    int status;
+    int close_status;
+    int opt;
+    bool ok;
+
+    memset(&c, 0, sizeof(c));
+    c.in_fmt       = &formats[0];
+    c.out_fmt      = &formats[2];
+    c.num_channels = 1;
+    for (ch = 0; ch < MAX_CHANNELS; ch++) {
+        c.out[ch] = -1;
+    }
+
+    while ((opt = getopt_long(argc, argv, OPTSTR, long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'f':
+                /* A compressed input's format is read from its header */
+                iqz_in   = !strcasecmp(optarg, "iqz");
+                c.in_fmt = iqz_in ? &formats[0] : str2fmt(optarg);
+                if (c.in_fmt == NULL) {
+                    fprintf(stderr, "Invalid input format: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 't':
+                csv       = !strcasecmp(optarg, "csv");
+                iqz_out   = !strcasecmp(optarg, "iqz");
+                c.out_fmt = (csv || iqz_out) ? NULL : str2fmt(optarg);
+                if (!csv && !iqz_out && c.out_fmt == NULL) {
+                    fprintf(stderr, "Invalid output format: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'o':
+                output = optarg;
+                break;
+
+            case 'c':
+                c.num_channels = str2uint(optarg, 1, MAX_CHANNELS, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid # of channels: %s\n", optarg);
+                    return 1;
+                }
+                channels_given = true;
+                break;
+
+            case 'p':
+                c.planar_out = true;
+                break;
+
+            case 'j':
+                jobs = str2uint(optarg, 1, 1024, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid # of jobs: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'm':
+                sigmf = true;
+                break;
+
+            case 'r':
+                rate = str2uint64(optarg, 1, UINT64_MAX, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid sample rate: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'F':
+                frequency = str2uint64(optarg, 1, UINT64_MAX, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid frequency: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'h':
+                usage(argv[0]);
+                return 0;
+
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+#if BLADERF_BIG_ENDIAN
+    fprintf(stderr, "Big-endian hosts are not supported.\n");
+    return 1;
+#endif
+
+    if (output == NULL || optind >= argc || argc - optind > MAX_CHANNELS) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (argc - optind > 1) {
+        if (c.num_channels > 1) {
+            fprintf(stderr, "Planar inputs hold a single channel each.\n");
+            return 1;
+        }
+
+        c.planar_in    = true;
+        c.num_channels = (unsigned int)(argc - optind);
+    }
+
+    if (iqz_in && c.planar_in) {
+        fprintf(stderr, "Compressed inputs hold all of their channels.\n");
+        return 1;
+    }
+
+    if (iqz_out && (c.planar_out || sigmf)) {
+        fprintf(stderr, "Compressed outputs hold all channels in a single "
+                        "file, without SigMF metadata.\n");
+        return 1;
+    }
+
+    if (csv && (c.planar_out || sigmf || iqz_in ||
+                c.in_fmt->format == BLADERF_FORMAT_SC12_PACKED)) {
+        fprintf(stderr, "CSV output holds all channels of a sc16, sc8, or "
+                        "cf32 input, without SigMF metadata.\n");
+        return 1;
+    }
+
+    if (sigmf && c.out_fmt->datatype == NULL) {
+        fprintf(stderr, "SigMF does not describe %s samples.\n",
+                c.out_fmt->name);
+        return 1;
+    }
+
+    for (i = 0; i < (unsigned int)(argc - optind); i++) {
+        if (map_input(&c, argv[optind + i]) != 0) {
+            goto out;
+        }
+    }
+
+    if (iqz_in) {
+        status = iqz_reader_open(&c.iqz_in, c.in[0], c.in_len[0]);
+        if (status != 0) {
+            fprintf(stderr, "Failed to open %s: %s\n", argv[optind],
+                    (status == EINVAL) ? "Not an iqz file"
+                                       : strerror(status));
+            goto out;
+        }
+
+        info = iqz_reader_info(c.iqz_in);
+        if (info->num_channels > MAX_CHANNELS ||
+            (channels_given && info->num_channels != c.num_channels)) {
+            fprintf(stderr, "%s holds %u channels.\n", argv[optind],
+                    info->num_channels);
+            goto out;
+        }
+
+        c.in_fmt        = (info->format == IQZ_FMT_SC8_Q7) ? &formats[1]
+                                                           : &formats[0];
+        c.num_channels  = info->num_channels;
+        c.count         = info->num_samples / c.num_channels;
+        c.chunk_samples = info->block_samples / c.num_channels;
+        c.num_chunks    = info->num_blocks;
+    }
+
+    /* Compressed outputs hold the samples of the same width, if possible */
+    if (iqz_out) {
+        c.out_fmt = (c.in_fmt->format == BLADERF_FORMAT_SC8_Q7)
+                        ? &formats[1]
+                        : &formats[0];
+    }
+
+    if (c.num_channels == 1) {
+        c.planar_out = false;
+    }
+
+    /* Every input must hold a whole number of (multi-channel) samples */
+    for (i = 0; !iqz_in && i < c.num_in; i++) {
+        size_t sample_bytes = c.in_fmt->size * (c.planar_in ? 1
+                                                            : c.num_channels);
+        uint64_t count      = c.in_len[i] / sample_bytes;
+
+        if (c.in_len[i] % sample_bytes != 0 || (i > 0 && count != c.count)) {
+            fprintf(stderr, "%s does not hold the same whole number of "
+                            "samples as the other input(s).\n",
+                    argv[optind + i]);
+            goto out;
+        }
+
+        c.count = count;
+    }
+
+    if (!iqz_in) {
+        c.chunk_samples = CHUNK_SAMPLES;
+        c.num_chunks    = (c.count + CHUNK_SAMPLES - 1) / CHUNK_SAMPLES;
+    }
+
+    c.num_out = c.planar_out ? c.num_channels : 1;
+
+    for (ch = 0; ch < c.num_out; ch++) {
+        paths[ch] = c.planar_out ? planar_path(output, ch) : strdup(output);
+        if (paths[ch] == NULL) {
+            fprintf(stderr, "Failed to allocate memory.\n");
+            goto out;
+        }
+
+        if (csv) {
+            c.csv = fopen(paths[ch], "w");
+            if (c.csv == NULL) {
+                fprintf(stderr, "Failed to open %s: %s\n", paths[ch],
+                        strerror(errno));
+                goto out;
+            }
+            continue;
+        }
+
+        if (iqz_out) {
+            c.iqz_file = fopen(paths[ch], "wb");
+            if (c.iqz_file == NULL) {
+                fprintf(stderr, "Failed to open %s: %s\n", paths[ch],
+                        strerror(errno));
+                goto out;
+            }
+
+            status = iqz_writer_open(
+                &c.iqz_out, c.iqz_file,
+                (c.out_fmt->format == BLADERF_FORMAT_SC8_Q7)
+                    ? IQZ_FMT_SC8_Q7
+                    : IQZ_FMT_SC16_Q11,
+                c.num_channels, 0,
+                (jobs > IQZ_MAX_THREADS) ? IQZ_MAX_THREADS : jobs);
+            if (status != 0) {
+                fprintf(stderr, "Failed to write %s: %s\n", paths[ch],
+                        strerror(status));
+                goto out;
+            }
+            continue;
+        }
+
+        c.out[ch] = open(paths[ch], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (c.out[ch] < 0) {
+            fprintf(stderr, "Failed to open %s: %s\n", paths[ch],
+                    strerror(errno));
+            goto out;
+        }
+
+        /* Sizing the file up front lets chunks be written in any order, and
+         * the filesystem allocate it in one go */
+        if (ftruncate(c.out[ch], (off_t)(c.count * c.out_fmt->size *
+                                         (c.planar_out ? 1
+                                                       : c.num_channels))) !=
+            0) {
+            fprintf(stderr, "Failed to size %s: %s\n", paths[ch],
+                    strerror(errno));
+            goto out;
+        }
+    }
+
+    if (csv) {
+        status = convert_csv(&c);
+    } else if (iqz_out) {
+        /* Samples are compressed in order, so they are converted in order by
+         * this thread. The writer has its own threads. */
+        pthread_mutex_init(&c.lock, NULL);
+        convert_task(&c);
+        pthread_mutex_destroy(&c.lock);
+
+        close_status = iqz_writer_close(c.iqz_out);
+        c.iqz_out    = NULL;
+        status       = (c.status != 0) ? c.status : close_status;
+    } else {
+        if (jobs == 0) {
+            long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+            jobs      = (cpus > 0) ? (unsigned int)cpus : 1;
+        }
+
+        if ((uint64_t)jobs > c.num_chunks) {
+            jobs = (c.num_chunks > 0) ? (unsigned int)c.num_chunks : 1;
+        }
+
+        threads = calloc(jobs, sizeof(threads[0]));
+        if (threads == NULL) {
+            fprintf(stderr, "Failed to allocate memory.\n");
+            goto out;
+        }
+
+        pthread_mutex_init(&c.lock, NULL);
+
+        for (i = 0; i < jobs; i++) {
+            status = pthread_create(&threads[i], NULL, convert_task, &c);
+            if (status != 0) {
+                pthread_mutex_lock(&c.lock);
+                c.status = status;
+                pthread_mutex_unlock(&c.lock);
+                break;
+            }
+        }
+
+        while (i > 0) {
+            pthread_join(threads[--i], NULL);
+        }
+
+        pthread_mutex_destroy(&c.lock);
+        status = c.status;
+    }
+
+    if (status < 0) {
+        fprintf(stderr, "Failed to convert samples: %s\n",
+                bladerf_strerror(status));
+        goto out;
+    } else if (status > 0) {
+        fprintf(stderr, "Failed to write samples: %s\n", strerror(status));
+        goto out;
+    }
+
+    for (ch = 0; sigmf && ch < c.num_out; ch++) {
+        status = write_sigmf_meta(paths[ch], c.out_fmt,
+                                  c.planar_out ? 1 : c.num_channels, rate,
+                                  frequency);
+        if (status != 0) {
+            fprintf(stderr, "Failed to write SigMF metadata: %s\n",
+                    strerror(status));
+            goto out;
+        }
+    }
+
+    printf("Converted %" PRIu64 " samples per channel.\n", c.count);
+    ret = 0;
+
+out:
+    free(threads);
+
+    for (ch = 0; ch < MAX_CHANNELS; ch++) {
+        if (c.out[ch] >= 0 && close(c.out[ch]) != 0 && ret == 0) {
+            fprintf(stderr, "Failed to close %s: %s\n", paths[ch],
+                    strerror(errno));
+            ret = 1;
+        }
+
+        free(paths[ch]);
+    }
+
+    if (c.csv != NULL && fclose(c.csv) != 0 && ret == 0) {
+        fprintf(stderr, "Failed to close output: %s\n", strerror(errno));
+        ret = 1;
+    }
+
+    /* Only left open after a failure */
+    iqz_writer_close(c.iqz_out);
+
+    if (c.iqz_file != NULL && fclose(c.iqz_file) != 0 && ret == 0) {
+        fprintf(stderr, "Failed to close output: %s\n", strerror(errno));
+        ret = 1;
+    }
+
+    iqz_reader_close(c.iqz_in);
+
+    for (i = 0; i < c.num_in; i++) {
+        if (c.in[i] != NULL) {
+            munmap((void *)c.in[i], c.in_len[i]);
+        }
+    }
+
+    return ret;
+}
@@ -0,0 +1,637 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * Serves the metrics published by bladerf_enable_metrics() to Prometheus.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <getopt.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include "libbladeRF.h"
+#include "conversions.h"
+
+#define DEFAULT_PORT 9477
+
+/* Prefix of the shared memory objects, as they appear in /dev/shm */
+#define SHM_DIR     "/dev/shm"
+#define SHM_PREFIX  "bladerf-metrics-"
+
+#define MAX_DEVICES 32
+#define REQUEST_MAX 4096
+
+/* Time allowed for a client to send its request */
+#define REQUEST_TIMEOUT_S 5
+
+#define OPTSTR "a:p:v:h"
+static struct option long_options[] = {
+    { "address",    required_argument,  NULL,   'a' },
+    { "port",       required_argument,  NULL,   'p' },
+    { "verbosity",  required_argument,  NULL,   'v' },
+    { "help",       no_argument,        NULL,   'h' },
+    { NULL,         0,                  NULL,   0   },
+};
+
+struct snapshot {
+    char name[64];
+    struct bladerf_metrics m;
+};
+
+/* A stream statistic exported as-is */
+struct stream_field {
+    const char *name;
+    const char *type;
+    const char *help;
+    size_t offset;
+    bool is_u64;
+};
+
+#define STREAM_FIELD(n, t, h, f)                                            \
+    { n, t, h, offsetof(struct bladerf_stream_stats, f),                    \
+      sizeof(((struct bladerf_stream_stats *)0)->f) == sizeof(uint64_t) }
+
+static const struct stream_field stream_fields[] = {
+    STREAM_FIELD("bladerf_stream_buffers_produced_total", "counter",
+                 "Buffers filled by the stream", buffers_produced),
+    STREAM_FIELD("bladerf_stream_buffers_consumed_total", "counter",
+                 "Buffers emptied by the stream", buffers_consumed),
+    STREAM_FIELD("bladerf_stream_buffers_dropped_total", "counter",
+                 "Buffers discarded by the stream", buffers_dropped),
+    STREAM_FIELD("bladerf_stream_overruns_total", "counter",
+                 "Host RX overruns", overruns),
+    STREAM_FIELD("bladerf_stream_underruns_total", "counter",
+                 "Host TX underruns", underruns),
+    STREAM_FIELD("bladerf_stream_fpga_xruns_total", "counter",
+                 "FPGA FIFO overflows (RX) or underflows (TX)", fpga_xruns),
+    STREAM_FIELD("bladerf_stream_buffers_high_water", "gauge",
+                 "Most buffers ever occupied", high_water),
+    STREAM_FIELD("bladerf_stream_buffers", "gauge",
+                 "Buffers in the stream", num_buffers),
+    STREAM_FIELD("bladerf_stream_buffer_size_samples", "gauge",
+                 "Samples per buffer", buffer_size),
+    STREAM_FIELD("bladerf_stream_transfers", "gauge",
+                 "USB transfers in flight", num_transfers),
+    STREAM_FIELD("bladerf_stream_transfers_completed_total", "counter",
+                 "USB transfers completed", transfers_completed),
+    STREAM_FIELD("bladerf_stream_short_transfers_total", "counter",
+                 "USB transfers completed short", short_transfers),
+    STREAM_FIELD("bladerf_stream_tap_buffers_written_total", "counter",
+                 "Buffers recorded by the capture tap", tap_buffers_written),
+    STREAM_FIELD("bladerf_stream_tap_buffers_dropped_total", "counter",
+                 "Buffers dropped by the capture tap", tap_buffers_dropped),
+};
+
+static const char *pkt_names[BLADERF_CONTROL_PKT_COUNT] = {
+    "8x8", "8x16", "8x32", "8x64", "16x64", "32x32", "retune", "other",
+};
+
+static volatile sig_atomic_t done = 0;
+
+static void handle_signal(int signo)
+{
+    (void)signo;
+    done = 1;
+}
+
+static void usage(const char *argv0)
+{
+    printf("Usage: %s [options] [name ...]\n", argv0);
+    printf("Serve the metrics of bladeRFs, as published by\n");
+    printf("bladerf_enable_metrics(), to Prometheus at /metrics.\n");
+    printf("\n");
+    printf("  -a, --address <addr>      Local address to listen on (default: all).\n");
+    printf("  -p, --port <port>         Port to listen on (default: %u).\n",
+           DEFAULT_PORT);
+    printf("  -v, --verbosity <level>   Set the libbladeRF verbosity level (e.g., verbose, debug).\n");
+    printf("  -h, --help                Display this help text and exit.\n");
+    printf("\n");
+    printf("Without names, every device publishing metrics is served.\n");
+}
+
+static size_t find_names(char names[][64], size_t max)
+{
+    const size_t prefix_len = strlen(SHM_PREFIX);
+    struct dirent *ent;
+    size_t n = 0;
+    DIR *dir;
+
+    dir = opendir(SHM_DIR);
+    if (dir == NULL) {
+        return 0;
+    }
+
+    while (n < max && (ent = readdir(dir)) != NULL) {
+        if (strncmp(ent->d_name, SHM_PREFIX, prefix_len) == 0 &&
+            strlen(ent->d_name + prefix_len) < sizeof(names[0])) {
+            strcpy(names[n++], ent->d_name + prefix_len);
+        }
+    }
+
+    closedir(dir);
+    return n;
+}
+
+static size_t read_snapshots(struct snapshot *s, size_t max,
+                             char **argv, int argc)
+{
+    char names[MAX_DEVICES][64];
+    size_t num_names, i, n = 0;
+    int status;
+
+    if (argc > 0) {
+        num_names = 0;
+        for (i = 0; i < (size_t)argc && num_names < MAX_DEVICES; i++) {
+            snprintf(names[num_names++], sizeof(names[0]), "%s", argv[i]);
+        }
+    } else {
+        num_names = find_names(names, MAX_DEVICES);
+    }
+
+    for (i = 0; i < num_names && n < max; i++) {
+        status = bladerf_read_metrics(names[i], &s[n].m);
+        if (status == 0) {
+            strcpy(s[n].name, names[i]);
+            n++;
+        } else if (status != BLADERF_ERR_WOULD_BLOCK) {
+            fprintf(stderr, "Failed to read metrics %s: %s\n", names[i],
+                    bladerf_strerror(status));
+        }
+    }
+
+    return n;
+}
+
+static void family(FILE *out, const char *name, const char *type,
+                   const char *help)
+{
+    fprintf(out, "# HELP %s %s\n", name, help);
+    fprintf(out, "# TYPE %s %s\n", name, type);
+}
+
+static void label(FILE *out, const char *name, const char *value)
+{
+    fprintf(out, "%s=\"", name);
+
+    for (; *value != '\0'; value++) {
+        if (*value == '\\' || *value == '"') {
+            fputc('\\', out);
+        } else if (*value == '\n') {
+            fputs("\\n", out);
+            continue;
+        }
+        fputc(*value, out);
+    }
+
+    fputc('"', out);
+}
+
+static void labels(FILE *out, const struct snapshot *s)
+{
+    label(out, "name", s->name);
+    fputc(',', out);
+    label(out, "serial", s->m.serial);
+    fputc(',', out);
+    label(out, "board", s->m.board);
+}
+
+static const struct bladerf_stream_stats *stream(const struct snapshot *s,
+                                                 bladerf_direction dir)
+{
+    const uint32_t flag = (dir == BLADERF_RX) ? BLADERF_METRICS_RX_STREAM
+                                              : BLADERF_METRICS_TX_STREAM;
+
+    if (!(s->m.valid & flag)) {
+        return NULL;
+    }
+
+    return (dir == BLADERF_RX) ? &s->m.rx : &s->m.tx;
+}
+
+static void write_metrics(FILE *out, const struct snapshot *s, size_t n)
+{
+    const uint64_t now = bladerf_get_host_time_ns();
+    const struct bladerf_stream_stats *st;
+    const struct bladerf_control_latency *lat;
+    const char *dir_names[2] = { "rx", "tx" };
+    size_t i, f;
+    int d, p;
+
+    family(out, "bladerf_metrics_updates_total", "counter",
+           "Snapshots published by libbladeRF");
+    for (i = 0; i < n; i++) {
+        fprintf(out, "bladerf_metrics_updates_total{");
+        labels(out, &s[i]);
+        fprintf(out, "} %llu\n", (unsigned long long)s[i].m.updates);
+    }
+
+    family(out, "bladerf_metrics_age_seconds", "gauge",
+           "Time since the latest snapshot was published");
+    for (i = 0; i < n; i++) {
+        fprintf(out, "bladerf_metrics_age_seconds{");
+        labels(out, &s[i]);
+        fprintf(out, "} %.6f\n",
+                now > s[i].m.host_ns ? (now - s[i].m.host_ns) * 1e-9 : 0.0);
+    }
+
+    for (f = 0; f < sizeof(stream_fields) / sizeof(stream_fields[0]); f++) {
+        const struct stream_field *sf = &stream_fields[f];
+
+        family(out, sf->name, sf->type, sf->help);
+        for (i = 0; i < n; i++) {
+            for (d = BLADERF_RX; d <= BLADERF_TX; d++) {
+                const uint8_t *base;
+                unsigned long long value;
+
+                st = stream(&s[i], (bladerf_direction)d);
+                if (st == NULL) {
+                    continue;
+                }
+
+                base = (const uint8_t *)st + sf->offset;
+                if (sf->is_u64) {
+                    value = *(const uint64_t *)base;
+                } else {
+                    value = *(const unsigned int *)base;
+                }
+
+                fprintf(out, "%s{", sf->name);
+                labels(out, &s[i]);
+                fprintf(out, ",direction=\"%s\"} %llu\n", dir_names[d], value);
+            }
+        }
+    }
+
+    /* The rate of this is the stream's throughput */
+    family(out, "bladerf_stream_samples_total", "counter",
+           "Samples received (RX) or transmitted (TX)");
+    for (i = 0; i < n; i++) {
+        for (d = BLADERF_RX; d <= BLADERF_TX; d++) {
+            uint64_t buffers;
+
+            st = stream(&s[i], (bladerf_direction)d);
+            if (st == NULL) {
+                continue;
+            }
+
+            buffers = (d == BLADERF_RX) ? st->buffers_produced
+                                        : st->buffers_consumed;
+
+            fprintf(out, "bladerf_stream_samples_total{");
+            labels(out, &s[i]);
+            fprintf(out, ",direction=\"%s\"} %llu\n", dir_names[d],
+                    (unsigned long long)(buffers * st->buffer_size));
+        }
+    }
+
+    family(out, "bladerf_control_latency_seconds", "summary",
+           "Control request latency, by packet format");
+    for (i = 0; i < n; i++) {
+        static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+
+        if (!(s[i].m.valid & BLADERF_METRICS_CONTROL)) {
+            continue;
+        }
+
+        for (p = 0; p < BLADERF_CONTROL_PKT_COUNT; p++) {
+            uint64_t values[4];
+            size_t q;
+
+            lat = &s[i].m.control.pkt[p];
+            if (lat->count == 0) {
+                continue;
+            }
+
+            values[0] = lat->p50_ns;
+            values[1] = lat->p90_ns;
+            values[2] = lat->p99_ns;
+            values[3] = lat->p999_ns;
+
+            for (q = 0; q < 4; q++) {
+                fprintf(out, "bladerf_control_latency_seconds{");
+                labels(out, &s[i]);
+                fprintf(out, ",type=\"%s\",quantile=\"%g\"} %.9f\n",
+                        pkt_names[p], quantiles[q], values[q] * 1e-9);
+            }
+
+            fprintf(out, "bladerf_control_latency_seconds_sum{");
+            labels(out, &s[i]);
+            fprintf(out, ",type=\"%s\"} %.9f\n", pkt_names[p],
+                    (double)lat->mean_ns * lat->count * 1e-9);
+
+            fprintf(out, "bladerf_control_latency_seconds_count{");
+            labels(out, &s[i]);
+            fprintf(out, ",type=\"%s\"} %llu\n", pkt_names[p],
+                    (unsigned long long)lat->count);
+        }
+    }
+
+    family(out, "bladerf_control_errors_total", "counter",
+           "Failed control requests, by packet format");
+    for (i = 0; i < n; i++) {
+        if (!(s[i].m.valid & BLADERF_METRICS_CONTROL)) {
+            continue;
+        }
+
+        for (p = 0; p < BLADERF_CONTROL_PKT_COUNT; p++) {
+            fprintf(out, "bladerf_control_errors_total{");
+            labels(out, &s[i]);
+            fprintf(out, ",type=\"%s\"} %llu\n", pkt_names[p],
+                    (unsigned long long)s[i].m.control.pkt[p].errors);
+        }
+    }
+
+    family(out, "bladerf_retune_queue_pending", "gauge",
+           "Scheduled retunes yet to be performed on channel 0");
+    for (i = 0; i < n; i++) {
+        for (d = BLADERF_RX; d <= BLADERF_TX; d++) {
+            const uint32_t flag = (d == BLADERF_RX)
+                                      ? BLADERF_METRICS_RX_RETUNE
+                                      : BLADERF_METRICS_TX_RETUNE;
+
+            if (!(s[i].m.valid & flag)) {
+                continue;
+            }
+
+            fprintf(out, "bladerf_retune_queue_pending{");
+            labels(out, &s[i]);
+            fprintf(out, ",direction=\"%s\"} %u\n", dir_names[d],
+                    s[i].m.retune[d].pending);
+        }
+    }
+
+    family(out, "bladerf_retune_queue_capacity", "gauge",
+           "Maximum number of pending retunes on channel 0");
+    for (i = 0; i < n; i++) {
+        for (d = BLADERF_RX; d <= BLADERF_TX; d++) {
+            const uint32_t flag = (d == BLADERF_RX)
+                                      ? BLADERF_METRICS_RX_RETUNE
+                                      : BLADERF_METRICS_TX_RETUNE;
+
+            if (!(s[i].m.valid & flag)) {
+                continue;
+            }
+
+            fprintf(out, "bladerf_retune_queue_capacity{");
+            labels(out, &s[i]);
+            fprintf(out, ",direction=\"%s\"} %u\n", dir_names[d],
+                    s[i].m.retune[d].capacity);
+        }
+    }
+
+    family(out, "bladerf_rfic_temperature_celsius", "gauge",
+           "RFIC temperature");
+    for (i = 0; i < n; i++) {
+        if (!(s[i].m.valid & BLADERF_METRICS_TEMPERATURE)) {
+            continue;
+        }
+
+        fprintf(out, "bladerf_rfic_temperature_celsius{");
+        labels(out, &s[i]);
+        fprintf(out, "} %.2f\n", s[i].m.rfic_temperature);
+    }
+}
+
+static int send_all(int fd, const char *buf, size_t len)
+{
+    ssize_t sent;
+
+    while (len > 0) {
+        sent = send(fd, buf, len, 0);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+
+        buf += sent;
+        len -= (size_t)sent;
+    }
+
+    return 0;
+}
+
+static void send_response(int fd, const char *status, const char *body,
+                          size_t len)
+{
+    char header[256];
+    int n;
+
+    n = snprintf(header, sizeof(header),
+                 "HTTP/1.1 %s\r\n"
+                 "Content-Type: text/plain; version=0.0.4\r\n"
+                 "Content-Length: %zu\r\n"
+                 "Connection: close\r\n"
+                 "\r\n",
+                 status, len);
+
+    if (send_all(fd, header, (size_t)n) == 0) {
+        send_all(fd, body, len);
+    }
+}
+
+/* Serve one request. Scrapes are infrequent, so clients are served one at a
+ * time, and each connection carries a single request. */
+static void serve(int fd, char **names, int num_names)
+{
+    static struct snapshot snapshots[MAX_DEVICES];
+    char request[REQUEST_MAX];
+    size_t len = 0;
+    ssize_t n;
+    struct timeval tv;
+    char *body = NULL;
+    size_t body_len = 0;
+    size_t num;
+    FILE *out;
+
+    tv.tv_sec  = REQUEST_TIMEOUT_S;
+    tv.tv_usec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    /* Only the request line matters, but read the whole header so that the
+     * client does not see a reset */
+    while (len < sizeof(request) - 1) {
+        n = recv(fd, request + len, sizeof(request) - 1 - len, 0);
+        if (n <= 0) {
+            return;
+        }
+
+        len += (size_t)n;
+        request[len] = '\0';
+
+        if (strstr(request, "\r\n\r\n") != NULL) {
+            break;
+        }
+    }
+
+    if (strncmp(request, "GET /metrics ", 13) != 0 &&
+        strncmp(request, "GET /metrics?", 13) != 0) {
+        static const char not_found[] = "Not found\n";
+        send_response(fd, "404 Not Found", not_found, sizeof(not_found) - 1);
+        return;
+    }
+
+    out = open_memstream(&body, &body_len);
+    if (out == NULL) {
+        return;
+    }
+
+    num = read_snapshots(snapshots, MAX_DEVICES, names, num_names);
+    write_metrics(out, snapshots, num);
+    fclose(out);
+
+    send_response(fd, "200 OK", body, body_len);
+    free(body);
+}
+
+static int listen_on(const char *address, unsigned int port)
+{
+    struct addrinfo hints, *res, *ai;
+    char port_str[8];
+    int fd = -1;
+    int one = 1;
+    int status;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags    = AI_PASSIVE;
+
+    snprintf(port_str, sizeof(port_str), "%u", port);
+
+    status = getaddrinfo(address, port_str, &hints, &res);
+    if (status != 0) {
+        fprintf(stderr, "Failed to resolve %s: %s\n",
+                address != NULL ? address : "(any)", gai_strerror(status));
+        return -1;
+    }
+
+    for (ai = res; ai != NULL; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        if (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 && listen(fd, 8) == 0) {
+            break;
+        }
+
+        close(fd);
+        fd = -1;
+    }
+
+    freeaddrinfo(res);
+
+    if (fd < 0) {
+        fprintf(stderr, "Failed to listen on port %u: %s\n", port,
+                strerror(errno));
+    }
+
+    return fd;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *address = NULL;
+    unsigned int port   = DEFAULT_PORT;
+    bladerf_log_level log_level = BLADERF_LOG_LEVEL_INFO;
+    struct sigaction sa;
+    int listen_fd, fd;
+    int opt;
+    bool ok;
+
+    while ((opt = getopt_long(argc, argv, OPTSTR, long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'a':
+                address = optarg;
+                break;
+
+            case 'p':
+                port = str2uint(optarg, 1, UINT16_MAX, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid port: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'v':
+                log_level = str2loglevel(optarg, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid log level: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'h':
+                usage(argv[0]);
+                return 0;
+
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    bladerf_log_set_verbosity(log_level);
+
+    listen_fd = listen_on(address, port);
+    if (listen_fd < 0) {
+        return 1;
+    }
+
+    /* No SA_RESTART, so that accept() returns on a signal */
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    sa.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &sa, NULL);
+
+    while (!done) {
+        fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno != EINTR) {
+                fprintf(stderr, "Failed to accept: %s\n", strerror(errno));
+            }
+            continue;
+        }
+
+        serve(fd, argv + optind, argc - optind);
+        close(fd);
+    }
+
+    close(listen_fd);
+    return 0;
+}
@@ -50,13 +50,25 @@ struct bladerf_fsk_handle {
         pthread_t thread;
         bool stop;
         bool on;
+        int channel;    //Channel printed with the data, or -1 for none
     } rx;
 };
 
+//Receive-only handle for --rx-channels: one link and receiver per channel
+struct bladerf_fsk_monitor {
+    struct channelizer *chan;
+    unsigned int num_channels;
+    struct bladerf_fsk_handle *channels[CHAN_MAX_CHANNELS];
+};
+
 void *sender(void *arg);
 void *receiver(void *arg);
+int check_fpga(struct bladerf *dev);
 struct bladerf_fsk_handle *start(struct config *config);
 void stop(struct bladerf_fsk_handle *handle);
+struct bladerf_fsk_monitor *monitor_start(struct config *config);
+void monitor_stop(struct bladerf_fsk_monitor *monitor);
+int run_monitor(struct config *config);
 
 /**
  * Thread function which gets bytes from the user via either stdin or a file and sends
@@ -135,7 +147,10 @@ void *receiver(void *arg)
             continue;
         }
         //Write the received bytes
-        if (handle->rx.out == stdout){
+        if (handle->rx.channel >= 0){
+            printf("[ch %d] %.*s", handle->rx.channel, bytes_received, rx_data);
+            fflush(stdout);
+        }else if (handle->rx.out == stdout){
             //Doing this because on windows null characters print as spaces
             printf("%s", rx_data);
             fflush(stdout);
@@ -150,6 +165,30 @@ void *receiver(void *arg)
     return NULL;
 }
 
+/**
+ * Check that the FPGA is loaded
+ *
+ * @param[in]   dev     bladeRF device handle
+ *
+ * @return      0 if loaded, -1 if not or on error
+ */
+int check_fpga(struct bladerf *dev)
+{
+    int status;
+
+    status = bladerf_is_fpga_configured(dev);
+    if (status < 0){
+        fprintf(stderr, "Couldn't query FPGA configuration: %s\n",
+                bladerf_strerror(status));
+        return -1;
+    }else if (status == 0){
+        fprintf(stderr, "FPGA is not loaded on bladeRF device. "
+                        "Load the FPGA or configure autoloading.\n");
+        return -1;
+    }
+    return 0;
+}
+
 /*
  * Initializes the link and starts the sender/receiver threads
  * @param[in]   config      pointer to config struct specifying configuration info
@@ -162,14 +201,7 @@ struct bladerf_fsk_handle *start(struct config *config)
     struct bladerf_fsk_handle *handle;
 
     //Check to see if FPGA is loaded
-    status = bladerf_is_fpga_configured(config->bladerf_dev);
-    if (status < 0){
-        fprintf(stderr, "Couldn't query FPGA configuration: %s\n",
-                bladerf_strerror(status));
-        return NULL;
-    }else if (status == 0){
-        fprintf(stderr, "FPGA is not loaded on bladeRF device. "
-                        "Load the FPGA or configure autoloading.\n");
+    if (check_fpga(config->bladerf_dev) != 0){
         return NULL;
     }
 
@@ -184,6 +216,7 @@ struct bladerf_fsk_handle *start(struct config *config)
     handle->tx.in = config->tx_input;
     handle->tx.filesize = config->tx_filesize;
     handle->rx.out = config->rx_output;
+    handle->rx.channel = -1;
 
     //Init the link
     handle->link = link_init(config->bladerf_dev, &config->params);
@@ -246,6 +279,141 @@ void stop(struct bladerf_fsk_handle *handle)
     free(handle);
 }
 
+/*
+ * Configures the device for config->params.rx_channels channels, and starts a
+ * receive-only link and receiver thread on each
+ * @param[in]   config      pointer to config struct specifying configuration info
+ *
+ * @return      pointer to bladerf_fsk_monitor on success, NULL on failure
+ */
+struct bladerf_fsk_monitor *monitor_start(struct config *config)
+{
+    int status;
+    unsigned int i;
+    struct bladerf_fsk_monitor *monitor;
+    struct bladerf_fsk_handle *handle;
+
+    if (config->rx_output != stdout){
+        fprintf(stderr, "Received data from several channels "
+                        "can only be written to stdout\n");
+        config_deinit(config);
+        return NULL;
+    }
+
+    //Check to see if FPGA is loaded
+    if (check_fpga(config->bladerf_dev) != 0){
+        return NULL;
+    }
+
+    monitor = calloc(1, sizeof(monitor[0]));
+    if (monitor == NULL){
+        perror("calloc");
+        goto error;
+    }
+
+    //Configure the device and the channelizer
+    monitor->chan = chan_init(config->bladerf_dev, &config->params);
+    if (monitor->chan == NULL){
+        goto error;
+    }
+
+    //Init a link and receiver thread for each channel
+    for (i = 0; i < config->params.rx_channels; i++){
+        handle = calloc(1, sizeof(handle[0]));
+        if (handle == NULL){
+            perror("calloc");
+            goto error;
+        }
+        monitor->channels[i] = handle;
+        monitor->num_channels++;
+
+        handle->rx.out = stdout;
+        handle->rx.channel = (int) i;
+        handle->link = link_init_channel(monitor->chan, i, &config->params);
+        if (handle->link == NULL){
+            goto error;
+        }
+        status = pthread_create(&(handle->rx.thread), NULL, receiver, handle);
+        if (status != 0){
+            fprintf(stderr, "Couldn't create rx thread: %s\n", strerror(status));
+            goto error;
+        }
+        handle->rx.on = true;
+    }
+
+    //Start receiving now that every channel is being read
+    status = chan_start(monitor->chan);
+    if (status != 0){
+        goto error;
+    }
+
+    return monitor;
+
+    error:
+        monitor_stop(monitor);
+        config_deinit(config);
+        return NULL;
+}
+
+/**
+ * Stop each channel's receiver, and close/free all resources
+ *
+ * @param[in]   monitor     pointer to bladerf_fsk_monitor to stop
+ */
+void monitor_stop(struct bladerf_fsk_monitor *monitor)
+{
+    unsigned int i;
+
+    if (monitor != NULL){
+        //The links read from the channelizer, so close them first
+        for (i = 0; i < monitor->num_channels; i++){
+            stop(monitor->channels[i]);
+        }
+        chan_close(monitor->chan);
+    }
+    free(monitor);
+}
+
+/**
+ * Run bladeRF-fsk with --rx-channels: print what is received on every channel
+ * until EOF on stdin
+ *
+ * @param[in]   config      pointer to config struct specifying configuration info
+ *
+ * @return      0 on success, 1 on failure
+ */
+int run_monitor(struct config *config)
+{
+    struct bladerf_fsk_monitor *monitor;
+    char line[PAYLOAD_LENGTH];
+
+    monitor = monitor_start(config);
+    if (monitor == NULL){
+        fprintf(stderr, "ERROR: Couldn't start bladeRF-fsk\n");
+        return 1;
+    }
+    if (config->quiet == false){
+        printf("Receiving %u channels from %u Hz\n",
+               config->params.rx_channels, config->params.rx_freq);
+        #if BLADERF_OS_WINDOWS
+            printf("----  Press CTRL-Z then ENTER to quit   ----\n");
+        #else
+            printf("----        Press CTRL-D to quit        ----\n");
+        #endif
+        printf("\n");
+    }
+
+    //Nothing is sent, so stdin only tells us when to quit
+    while (fgets(line, sizeof(line), stdin) != NULL);
+
+    if (config->quiet == false){
+        printf("\nQuitting...\n");
+    }
+    monitor_stop(monitor);
+    config_deinit(config);
+    return 0;
+}
+
 /**
  * Run bladeRF-fsk
  */
@@ -278,7 +446,9 @@ int main(int argc, char *argv[])
             "  Device 2> bladeRF-fsk -d *:serial=f0 -r 924M -t 904M --tx-vga2 5\n"
             "Example: File transfer between two devices at 904MHz/924MHz.\n"
             "  Receiver   > bladeRF-fsk -d *:serial=4a -r 904M -t 924M -o rx.jpg\n"
-            "  Transmitter> bladeRF-fsk -d *:serial=f0 -r 924M -t 904M -i puppy.jpg\n\n"
+            "  Transmitter> bladeRF-fsk -d *:serial=f0 -r 924M -t 904M -i puppy.jpg\n"
+            "Example: Watch the traffic on 904MHz, 906MHz, 908MHz and 910MHz at once.\n"
+            "  Monitor    > bladeRF-fsk -d *:serial=4a -r 904M --rx-channels 4\n\n"
         );
         return 0;
     } else if (status > 0) {
@@ -289,6 +459,9 @@ int main(int argc, char *argv[])
     if (config->quiet == false){
         printf("=============== bladeRF-fsk ================\n");
     }
+    if (config->params.rx_channels > 1){
+        return run_monitor(config);
+    }
     //Initialize the bladeRF-fsk handle
     handle = start(config);
     if (handle == NULL){
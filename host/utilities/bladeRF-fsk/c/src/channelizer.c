@@ -0,0 +1,424 @@
+/**
+ * @brief   Splits one wideband RX capture into several FSK channels
+ *
+ * The device is tuned to the middle of N adjacent channels, spaced
+ * CHAN_SPACING (= BLADERF_SAMPLE_RATE) apart, and sampled N times faster than
+ * a single link's receiver would sample it. One thread receives the wideband
+ * samples into a ring of blocks. Every channel has its own reader, which
+ * mixes its channel down to baseband, low-pass filters it, and keeps every
+ * Nth sample. Only the kept samples are computed, so this is a polyphase
+ * decimator per channel. A reader runs on the thread of the PHY receiver it
+ * feeds, so the channels are processed in parallel, and each PHY receives the
+ * same BLADERF_SAMPLE_RATE stream it would get from the device.
+ *
+ * Channel k's offset from the center frequency, (2k - N + 1) / 2N of the
+ * wideband sample rate, repeats every 2N samples. Every block is a multiple of
+ * 2N samples long, so each channel's mixer is a table of 2N samples that
+ * starts over at each block.
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include "host_config.h"
+#include "thread.h"
+#include "dsp.h"
+
+#include "channelizer.h"
+#include "phy.h"
+#include "radio_config.h"
+
+#ifdef DEBUG_MODE
+    #define DEBUG_MSG(...) fprintf(stderr, __VA_ARGS__)
+    #ifndef ENABLE_NOTES
+        #define ENABLE_NOTES
+    #endif
+#else
+    #define DEBUG_MSG(...)
+#endif
+
+#ifdef ENABLE_NOTES
+    #define NOTE(...) fprintf(stderr, __VA_ARGS__)
+#else
+    #define NOTE(...)
+#endif
+
+//Number of wideband blocks in flight between the receiving thread and the
+//channels' readers. Must be a power of two.
+#define CHAN_RING_DEPTH 8
+//Length of the low-pass filter, in taps per channel. The filter passes
+//+/- CHAN_SPACING / 4 and has to reject the next channel over from
+//3 * CHAN_SPACING / 4, a transition band of 1/4N of the wideband rate.
+#define CHAN_TAPS_PER_CHANNEL 14
+//Number of times a reader polls for a block before sleeping
+#define CHAN_WAIT_SPINS 1000
+
+//A block of wideband samples
+struct chan_block {
+    int16_t *samples;           //Interleaved SC16 Q11 samples
+    bool discontinuity;         //Samples were lost before this block
+};
+
+//A channel's reader
+struct chan_reader {
+    //The last (num_taps - 1) mixed samples of the previous block, followed by
+    //the mixed samples of the current one
+    struct dsp_complexf *window;
+    unsigned int num_read;      //Blocks this reader is done with
+};
+
+/* Block n lives in blocks[n % CHAN_RING_DEPTH]. The receiving thread only
+ * reuses a block once every reader is done with it. */
+struct channelizer {
+    struct bladerf *dev;
+    unsigned int num_channels;
+    size_t block_len;               //Wideband samples per block
+    struct chan_block blocks[CHAN_RING_DEPTH];
+    unsigned int num_acquired;      //Blocks received from the device
+    int16_t *drop_samples;          //Samples received while the ring is full
+    float *taps;                    //Low-pass filter taps
+    size_t num_taps;
+    struct dsp_complexf *mixers;    //Channel k's mixer is at [k * 2N]
+    struct chan_reader readers[CHAN_MAX_CHANNELS];
+    bool stop;                      //Stop, or stopped, receiving
+    bool running;                   //Is the receiving thread running
+    pthread_t thread;
+};
+
+/**
+ * Fills in a windowed-sinc (Hamming) low-pass filter with a cutoff of half
+ * the decimated sample rate, and unity gain at DC
+ */
+static void design_taps(float *taps, size_t num_taps, unsigned int decimation)
+{
+    const double center = (num_taps - 1) / 2.0;
+    double sum = 0;
+    double x;
+    size_t j;
+
+    for (j = 0; j < num_taps; j++){
+        x = (j - center) / decimation;
+        taps[j] = (float) ((x == 0 ? 1.0 : sin(M_PI * x) / (M_PI * x)) *
+                    (0.54 - 0.46 * cos(2 * M_PI * j / (num_taps - 1))));
+        sum += taps[j];
+    }
+    for (j = 0; j < num_taps; j++){
+        taps[j] = (float) (taps[j] / sum);
+    }
+}
+
+/**
+ * Thread function which receives wideband blocks from the device. As with the
+ * PHY's receiver, this never waits on the readers: if no block is free, the
+ * samples are received and dropped so that the device itself does not
+ * overrun.
+ *
+ * @param[in]   arg     pointer to channelizer
+ */
+static void *chan_acquire(void *arg)
+{
+    struct channelizer *chan = (struct channelizer *) arg;
+    struct chan_block *block;
+    struct bladerf_metadata metadata;
+    int16_t *buf;
+    unsigned int seq = 0;
+    unsigned int lag, max_lag;
+    unsigned int k;
+    bool discontinuity = false;
+    uint64_t timestamp = UINT64_MAX;
+    int status;
+
+    memset(&metadata, 0, sizeof(metadata));
+    metadata.flags = BLADERF_META_FLAG_RX_NOW;
+
+    while (!chan->stop){
+        //A block is free once the slowest reader is done with it
+        max_lag = 0;
+        for (k = 0; k < chan->num_channels; k++){
+            lag = seq - ATOMIC_LOAD(&chan->readers[k].num_read);
+            if (lag > max_lag){
+                max_lag = lag;
+            }
+        }
+        if (max_lag < CHAN_RING_DEPTH){
+            block = &chan->blocks[seq % CHAN_RING_DEPTH];
+            buf = block->samples;
+        }else{
+            block = NULL;
+            buf = chan->drop_samples;
+        }
+
+        status = bladerf_sync_rx(chan->dev, buf, (unsigned int) chan->block_len,
+                                &metadata, 5000);
+        if (status != 0){
+            fprintf(stderr, "[CHAN] %s: Couldn't receive samples from bladeRF: %s\n",
+                    __FUNCTION__, bladerf_strerror(status));
+            break;
+        }
+        if (metadata.status & BLADERF_META_STATUS_OVERRUN){
+            NOTE("[CHAN] %s: Got an overrun. Skipping these samples.\n",
+                    __FUNCTION__);
+            discontinuity = true;
+            continue;
+        }
+        if (timestamp != UINT64_MAX && metadata.timestamp != timestamp+chan->block_len){
+            NOTE("[CHAN] %s: Unexpected timestamp. Expected %lu, got %lu.\n",
+                    __FUNCTION__, timestamp+chan->block_len, metadata.timestamp);
+            discontinuity = true;
+        }
+        timestamp = metadata.timestamp;
+
+        if (block == NULL){
+            NOTE("[CHAN] %s: A channel fell behind. Dropping %zu samples.\n",
+                    __FUNCTION__, chan->block_len);
+            discontinuity = true;
+            continue;
+        }
+
+        //Pass the block on to the readers
+        block->discontinuity = discontinuity;
+        discontinuity = false;
+        seq++;
+        ATOMIC_STORE(&chan->num_acquired, seq);
+    }
+
+    //Let the readers know no more blocks are coming
+    chan->stop = true;
+    return NULL;
+}
+
+struct channelizer *chan_init(struct bladerf *dev, struct radio_params *params)
+{
+    struct channelizer *chan;
+    const unsigned int n = params->rx_channels;
+    unsigned int i, k;
+    double phase;
+    int status;
+
+    if (n < 2 || n > CHAN_MAX_CHANNELS){
+        fprintf(stderr, "[CHAN] %s: Invalid number of channels %u (2 to %u)\n",
+                __FUNCTION__, n, CHAN_MAX_CHANNELS);
+        return NULL;
+    }
+    if (params->fpga_modem){
+        fprintf(stderr, "[CHAN] %s: The FPGA modem can't be channelized\n",
+                __FUNCTION__);
+        return NULL;
+    }
+
+    //Calloc so all pointers are initialized to NULL
+    chan = calloc(1, sizeof(chan[0]));
+    if (chan == NULL){
+        perror("[CHAN] calloc");
+        return NULL;
+    }
+    chan->num_channels = n;
+    chan->block_len = (size_t) NUM_SAMPLES_RX * n;
+    chan->num_taps = CHAN_TAPS_PER_CHANNEL * n + 1;
+
+    //Allocate the ring
+    for (i = 0; i < CHAN_RING_DEPTH; i++){
+        chan->blocks[i].samples = malloc(chan->block_len * 2 * sizeof(int16_t));
+        if (chan->blocks[i].samples == NULL){
+            perror("[CHAN] malloc");
+            goto error;
+        }
+    }
+    chan->drop_samples = malloc(chan->block_len * 2 * sizeof(int16_t));
+    if (chan->drop_samples == NULL){
+        perror("[CHAN] malloc");
+        goto error;
+    }
+
+    //Design the low-pass filter
+    chan->taps = malloc(chan->num_taps * sizeof(chan->taps[0]));
+    if (chan->taps == NULL){
+        perror("[CHAN] malloc");
+        goto error;
+    }
+    design_taps(chan->taps, chan->num_taps, n);
+
+    //Build each channel's mixer, which shifts it down to baseband
+    chan->mixers = malloc(n * 2 * n * sizeof(chan->mixers[0]));
+    if (chan->mixers == NULL){
+        perror("[CHAN] malloc");
+        goto error;
+    }
+    for (k = 0; k < n; k++){
+        for (i = 0; i < 2 * n; i++){
+            phase = -M_PI * (2.0 * k - n + 1) * i / n;
+            chan->mixers[k * 2 * n + i].i = (float) cos(phase);
+            chan->mixers[k * 2 * n + i].q = (float) sin(phase);
+        }
+    }
+
+    //Allocate each reader's filter window, starting with the history zeroed
+    for (k = 0; k < n; k++){
+        chan->readers[k].window = calloc(chan->num_taps - 1 + chan->block_len,
+                                        sizeof(chan->readers[k].window[0]));
+        if (chan->readers[k].window == NULL){
+            perror("[CHAN] calloc");
+            goto error;
+        }
+    }
+
+    //Configure the device last, so that chan_close() stops it
+    status = radio_init_and_configure(dev, params);
+    if (status != 0){
+        fprintf(stderr, "[CHAN] %s: Couldn't configure bladeRF\n", __FUNCTION__);
+        goto error;
+    }
+    chan->dev = dev;
+
+    DEBUG_MSG("[CHAN] %u channels, %zu taps\n", n, chan->num_taps);
+    return chan;
+
+    error:
+        chan_close(chan);
+        return NULL;
+}
+
+int chan_start(struct channelizer *chan)
+{
+    int status;
+
+    chan->stop = false;
+    status = pthread_create(&chan->thread, NULL, chan_acquire, chan);
+    if (status != 0){
+        fprintf(stderr, "[CHAN] %s: Error creating thread: %s\n", __FUNCTION__,
+                strerror(status));
+        return -1;
+    }
+    chan->running = true;
+    return 0;
+}
+
+void chan_close(struct channelizer *chan)
+{
+    unsigned int i;
+    int status;
+
+    if (chan == NULL){
+        return;
+    }
+
+    if (chan->running){
+        chan->stop = true;
+        status = pthread_join(chan->thread, NULL);
+        if (status != 0){
+            fprintf(stderr, "[CHAN] %s: Error joining thread: %s\n",
+                    __FUNCTION__, strerror(status));
+        }
+    }
+    //Stop bladeRF (handle closed elsewhere)
+    radio_stop(chan->dev);
+
+    for (i = 0; i < CHAN_RING_DEPTH; i++){
+        free(chan->blocks[i].samples);
+    }
+    for (i = 0; i < CHAN_MAX_CHANNELS; i++){
+        free(chan->readers[i].window);
+    }
+    free(chan->drop_samples);
+    free(chan->taps);
+    free(chan->mixers);
+    free(chan);
+}
+
+/* Rounds a filtered sample to SC16 Q11. Filtering with unity gain keeps it in
+ * range, short of a pathological input. */
+static inline int16_t to_sc16(float x)
+{
+    long r = lrintf(x);
+
+    if (r > INT16_MAX){
+        r = INT16_MAX;
+    }else if (r < INT16_MIN){
+        r = INT16_MIN;
+    }
+    return (int16_t) r;
+}
+
+int chan_read(struct channelizer *chan, unsigned int channel, int16_t *samples,
+              bool *discontinuity, const bool *stop)
+{
+    struct chan_reader *reader = &chan->readers[channel];
+    const unsigned int n = chan->num_channels;
+    const unsigned int period = 2 * n;
+    const struct dsp_complexf *mixer = &chan->mixers[channel * period];
+    const size_t history = chan->num_taps - 1;
+    struct dsp_complexf *mixed = &reader->window[history];
+    const int16_t *in;
+    unsigned int seq = reader->num_read;
+    unsigned int spins = 0;
+    unsigned int p;
+    size_t j, m;
+    float acc_i, acc_q;
+
+    //Wait for the next block
+    while (ATOMIC_LOAD(&chan->num_acquired) == seq){
+        if (*stop || chan->stop){
+            return -1;
+        }
+        if (spins < CHAN_WAIT_SPINS){
+            CPU_RELAX();
+            spins++;
+        }else{
+            usleep(50);
+        }
+    }
+    in = chan->blocks[seq % CHAN_RING_DEPTH].samples;
+    *discontinuity = chan->blocks[seq % CHAN_RING_DEPTH].discontinuity;
+
+    //Mix the channel down to baseband
+    for (j = 0, p = 0; j < chan->block_len; j++){
+        const float x_i = in[2 * j];
+        const float x_q = in[2 * j + 1];
+
+        mixed[j].i = x_i * mixer[p].i - x_q * mixer[p].q;
+        mixed[j].q = x_i * mixer[p].q + x_q * mixer[p].i;
+        p = (p + 1 == period) ? 0 : p + 1;
+    }
+
+    //The raw block is no longer needed
+    ATOMIC_STORE(&reader->num_read, seq + 1);
+
+    //Filter, computing only the samples kept. The taps are symmetric, so they
+    //need not be reversed.
+    for (m = 0; m < NUM_SAMPLES_RX; m++){
+        const struct dsp_complexf *x = &reader->window[m * n];
+
+        acc_i = 0;
+        acc_q = 0;
+        for (j = 0; j < chan->num_taps; j++){
+            acc_i += chan->taps[j] * x[j].i;
+            acc_q += chan->taps[j] * x[j].q;
+        }
+        samples[2 * m] = to_sc16(acc_i);
+        samples[2 * m + 1] = to_sc16(acc_q);
+    }
+
+    //Keep the end of this block as the history for the next
+    memmove(reader->window, &reader->window[chan->block_len],
+            history * sizeof(reader->window[0]));
+
+    return 0;
+}
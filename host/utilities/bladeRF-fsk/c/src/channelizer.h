@@ -0,0 +1,88 @@
+/**
+ * @file
+ * @brief   Splits one wideband RX capture into several FSK channels
+ *
+ * This file is part of the bladeRF project
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef CHANNELIZER_H_
+#define CHANNELIZER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <libbladeRF.h>
+#include "common.h"
+
+//Maximum number of channels received at once
+#define CHAN_MAX_CHANNELS 8
+
+struct channelizer;
+
+/**
+ * Configure the device to receive params->rx_channels adjacent channels, the
+ * first at params->rx_freq and the rest CHAN_SPACING apart above it, and
+ * allocate the channelizer. The device is sampled at
+ * params->rx_channels * BLADERF_SAMPLE_RATE.
+ *
+ * @param[in]   dev     pointer to bladeRF device handle
+ * @param[in]   params  radio parameters. rx_channels must be 2 to
+ *                      CHAN_MAX_CHANNELS, and fpga_modem must be false.
+ *
+ * @return      pointer to channelizer on success, NULL on failure
+ */
+struct channelizer *chan_init(struct bladerf *dev, struct radio_params *params);
+
+/**
+ * Start receiving wideband samples from the device. Each channel's reader
+ * should be running by now: samples are dropped while any reader falls
+ * behind.
+ *
+ * @param[in]   chan    pointer to channelizer
+ *
+ * @return      0 on success, -1 on failure
+ */
+int chan_start(struct channelizer *chan);
+
+/**
+ * Stop receiving, stop the device, and free the channelizer. Does nothing if
+ * chan is NULL. Every channel's reader must have stopped first.
+ *
+ * @param[in]   chan    pointer to channelizer
+ */
+void chan_close(struct channelizer *chan);
+
+/**
+ * Get the next NUM_SAMPLES_RX samples of a channel, mixed down to baseband and
+ * decimated to BLADERF_SAMPLE_RATE. Each channel may be read by one thread at
+ * a time, and channels may be read in parallel.
+ *
+ * @param[in]   chan            pointer to channelizer
+ * @param[in]   channel         channel to read, from 0
+ * @param[out]  samples         NUM_SAMPLES_RX interleaved SC16 Q11 samples
+ * @param[out]  discontinuity   set true if samples were lost just before
+ *                              these
+ * @param[in]   stop            the wait for samples is abandoned if this
+ *                              becomes true
+ *
+ * @return      0 on success, -1 if stopped, or if the channelizer stopped
+ *              receiving
+ */
+int chan_read(struct channelizer *chan, unsigned int channel, int16_t *samples,
+              bool *discontinuity, const bool *stop);
+
+#endif
@@ -24,6 +24,7 @@
 #ifndef COMMON_H
 #define COMMON_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <libbladeRF.h>
 
@@ -42,6 +43,12 @@ struct radio_params {
     bladerf_lna_gain rx_lna_gain;    //Range: 0 to 6 dB
     int rx_vga1_gain;    //Range: 5 to 30 dB
     int rx_vga2_gain;    //Range: 0 to 30 dB
+    unsigned int rx_channels;    //Channels received at once, from rx_freq up, or
+                                 //0 for a single link. See channelizer.h.
+    //Link
+    unsigned int link_window;    //ARQ window, in frames. Range: 1 to LINK_MAX_WINDOW
+    //PHY
+    bool fpga_modem;    //Modulate/demodulate with the FPGA's FSK modem instead of the host
 };
 
 #endif
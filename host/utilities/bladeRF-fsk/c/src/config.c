@@ -29,6 +29,8 @@
 
 #include "config.h"
 #include "conversions.h"
+#include "link.h"
+#include "radio_config.h"
 
 #ifdef DEBUG_CONFIG
 #   define pr_dbg(...) fprintf(stderr, "[CONFIG] " __VA_ARGS__)
@@ -47,12 +49,17 @@
 #define OPTION_RXLNA    0x80
 #define OPTION_RXVGA1   0x81
 #define OPTION_RXVGA2   0x82
+#define OPTION_RXCHANS  0x83
 
 #define OPTION_TXFREQ   't'
 #define OPTION_OUTPUT   'o'
 #define OPTION_TXVGA1   0x90
 #define OPTION_TXVGA2   0x91
 
+#define OPTION_WINDOW   0xa0
+
+#define OPTION_FPGA_MODEM 0xb0
+
 #define RX_FREQ_DEFAULT 904000000
 #define RX_LNA_DEFAULT  BLADERF_LNA_GAIN_MAX
 #define RX_VGA1_DEFAULT BLADERF_RXVGA1_GAIN_MAX
@@ -72,12 +79,17 @@ static struct option long_options[] = {
     { "rx-vga1",  required_argument,  NULL,   OPTION_RXVGA1   },
     { "rx-vga2",  required_argument,  NULL,   OPTION_RXVGA2   },
     { "rx-freq",  required_argument,  NULL,   OPTION_RXFREQ   },
+    { "rx-channels", required_argument, NULL, OPTION_RXCHANS  },
 
     { "input",    required_argument,  NULL,   OPTION_INPUT    },
     { "tx-vga1",  required_argument,  NULL,   OPTION_TXVGA1   },
     { "tx-vga2",  required_argument,  NULL,   OPTION_TXVGA2   },
     { "tx-freq",  required_argument,  NULL,   OPTION_TXFREQ   },
 
+    { "window",   required_argument,  NULL,   OPTION_WINDOW   },
+
+    { "fpga-modem", no_argument,      NULL,   OPTION_FPGA_MODEM },
+
     { NULL,       0,                  NULL,   0               },
 };
 
@@ -113,6 +125,7 @@ static struct config *alloc_config_with_defaults()
     config->params.rx_lna_gain    = RX_LNA_DEFAULT;
     config->params.rx_vga1_gain    = RX_VGA1_DEFAULT;
     config->params.rx_vga2_gain    = RX_VGA2_DEFAULT;
+    config->params.rx_channels     = 0;
 
 
     /* TX defaults */
@@ -123,6 +136,12 @@ static struct config *alloc_config_with_defaults()
     config->params.tx_vga1_gain    = TX_VGA1_DEFAULT;
     config->params.tx_vga2_gain    = TX_VGA2_DEFAULT;
 
+    /* Link defaults */
+    config->params.link_window    = LINK_WINDOW_DEFAULT;
+
+    /* PHY defaults */
+    config->params.fpga_modem    = false;
+
     return config;
 }
 
@@ -236,6 +255,16 @@ int config_init_from_cmdline(int argc, char * const argv[],
                 }
                 break;
 
+            case OPTION_RXCHANS:
+                config->params.rx_channels =
+                    str2uint(optarg, 2, CHAN_MAX_CHANNELS, &valid);
+                if (!valid) {
+                    status = -1;
+                    fprintf(stderr, "Invalid number of RX channels: %s\n", optarg);
+                    goto out;
+                }
+                break;
+
             case OPTION_RXFREQ:
                 config->params.rx_freq =
                     str2uint_suffix(optarg,
@@ -318,6 +347,20 @@ int config_init_from_cmdline(int argc, char * const argv[],
                 }
                 break;
 
+            case OPTION_WINDOW:
+                config->params.link_window =
+                    str2uint(optarg, 1, LINK_MAX_WINDOW, &valid);
+                if (!valid) {
+                    status = -1;
+                    fprintf(stderr, "Invalid window size: %s\n", optarg);
+                    goto out;
+                }
+                break;
+
+            case OPTION_FPGA_MODEM:
+                config->params.fpga_modem = true;
+                break;
+
             case OPTION_QUIET:
                 config->quiet = true;
                 break;
@@ -379,19 +422,30 @@ void config_print_options()
 "   --rx-lna <value>        RX LNA gain. Values: bypass, mid, max (default)\n"
 "   --rx-vga1 <value>       RX VGA1 gain. Range: %d to %d. Default = %d.\n"
 "   --rx-vga2 <value>       RX VGA2 gain. Range: %d to %d. Default = %d.\n"
+"   --rx-channels <n>       Only receive, on n adjacent channels starting at the\n"
+"                            RX frequency and spaced %d Hz apart. Range: 2 to %d.\n"
 "\n"
 "   -t, --tx-freq <freq>    TX frequency. Default: %d\n"
 "   -i, --input <file>      TX data input. stdin is used if not specified.\n"
 "   --tx-vga1 <value>       TX VGA1 gain. Range: %d to %d. Default = %d.\n"
-"   --tx-vga2 <value>       TX VGA2 gain. Range: %d to %d. Default = %d.\n",
+"   --tx-vga2 <value>       TX VGA2 gain. Range: %d to %d. Default = %d.\n"
+"\n"
+"   --window <frames>       Max number of unacknowledged frames in flight.\n"
+"                            Range: 1 to %d. Default = %d.\n"
+"\n"
+"   --fpga-modem            Modulate/demodulate with the FPGA's FSK modem,\n"
+"                            exchanging packets instead of samples.\n",
 
     RX_FREQ_DEFAULT,
     BLADERF_RXVGA1_GAIN_MIN, BLADERF_RXVGA1_GAIN_MAX, RX_VGA1_DEFAULT,
     BLADERF_RXVGA2_GAIN_MIN, BLADERF_RXVGA2_GAIN_MAX, RX_VGA2_DEFAULT,
+    CHAN_SPACING, CHAN_MAX_CHANNELS,
 
     TX_FREQ_DEFAULT,
     BLADERF_TXVGA1_GAIN_MIN, BLADERF_TXVGA1_GAIN_MAX, TX_VGA1_DEFAULT,
-    BLADERF_TXVGA2_GAIN_MIN, BLADERF_TXVGA2_GAIN_MAX, TX_VGA2_DEFAULT
+    BLADERF_TXVGA2_GAIN_MIN, BLADERF_TXVGA2_GAIN_MAX, TX_VGA2_DEFAULT,
+
+    LINK_MAX_WINDOW, LINK_WINDOW_DEFAULT
 
     );
 }
@@ -416,6 +470,7 @@ void print_config(const struct config *config)
     printf("    LNA gain:       %d\n", config->params.rx_lna_gain);
     printf("    VGA1 gain:      %d\n", config->params.rx_vga1_gain);
     printf("    VGA2 gain:      %d\n", config->params.rx_vga2_gain);
+    printf("    Channels:       %u\n", config->params.rx_channels);
     printf("\n");
     printf("TX Parameters:\n");
     printf("    Input handle:   %p\n", config->tx_input);
@@ -423,6 +478,12 @@ void print_config(const struct config *config)
     printf("    VGA1 gain:      %d\n", config->params.tx_vga1_gain);
     printf("    VGA2 gain:      %d\n", config->params.tx_vga2_gain);
     printf("\n");
+    printf("Link Parameters:\n");
+    printf("    Window size:    %u\n", config->params.link_window);
+    printf("\n");
+    printf("PHY Parameters:\n");
+    printf("    FPGA modem:     %s\n", config->params.fpga_modem ? "yes" : "no");
+    printf("\n");
 }
 
 int main(int argc, char *argv[])
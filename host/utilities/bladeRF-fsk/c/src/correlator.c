@@ -28,6 +28,7 @@
 #include <string.h>
 #include <limits.h>
 #include <inttypes.h>
+#include <math.h>
 
 #include "correlator.h"
 #include "host_config.h"
@@ -42,15 +43,31 @@
 
 #define LOG_FILE_SUFFIX  "_correlator_log.csv"
 
+/* With CORR_MODE_EARLY_EXIT, the bound on the correlation power is checked
+ * after each chunk of this many reference samples */
+#define EARLY_EXIT_CHUNK 16
+
+/* Relative slack allowed in the early exit bound, to absorb rounding error
+ * in the running window energy */
+#define EARLY_EXIT_MARGIN 1e-3f
+
 struct complexf {
     float real;
     float imag;
 };
 
 struct correlator {
+    enum corr_mode mode;
+
     struct complexf *ref;       /* Reference signal to correlate against */
     size_t len;                 /* Length of reference sig, insamples */
 
+    float *ref_energy_rest;     /* ref_energy_rest[j] is the energy of the
+                                 * reference samples from the jth step of
+                                 * the correlation loop onward */
+
+    double window_energy;       /* Energy of the samples in the window */
+
     float threshold_pwr;        /* Correlation power threshold */
 
     float max;                  /* Max correlation value we've seen so far */
@@ -95,7 +112,8 @@ static void save_reference_sig(struct complexf *ref, size_t len)
 }
 #endif
 
-struct correlator *corr_init(uint8_t *syms, size_t n, unsigned int sps)
+struct correlator *corr_init(uint8_t *syms, size_t n, unsigned int sps,
+                             enum corr_mode mode)
 {
     int status = -1;
     size_t i;
@@ -120,6 +138,8 @@ struct correlator *corr_init(uint8_t *syms, size_t n, unsigned int sps)
         goto out;
     }
 
+    ret->mode = mode;
+
 #   ifdef LOG_CORRELATOR_OUTPUT
     ret->out = fopen(log_name, "w");
     if (ret->out == NULL) {
@@ -145,6 +165,12 @@ struct correlator *corr_init(uint8_t *syms, size_t n, unsigned int sps)
         goto out;
     }
 
+    ret->ref_energy_rest = malloc(ret->len * sizeof(ret->ref_energy_rest[0]));
+    if (ret->ref_energy_rest == NULL) {
+        perror("malloc");
+        goto out;
+    }
+
     raw_samples = malloc(sps * n * sizeof(raw_samples[0]));
     if (raw_samples == NULL) {
         perror("malloc");
@@ -171,6 +197,17 @@ struct correlator *corr_init(uint8_t *syms, size_t n, unsigned int sps)
         ret->ref[i].imag = -ret->ref[i].imag;
     }
 
+    /* The correlation loop walks the reference from its last sample to its
+     * first */
+    {
+        float rest = 0.0f;
+        for (i = 0; i < ret->len; i++) {
+            const struct complexf *r = &ret->ref[i];
+            rest += r->real * r->real + r->imag * r->imag;
+            ret->ref_energy_rest[ret->len - 1 - i] = rest;
+        }
+    }
+
     ret->end = &ret->buf[2 * ret->len];
     //Maximum power is ret->len/DECIMATION_FACTOR * ret->len/DECIMATION_FACTOR
     ret->threshold_pwr = ret->len * ret->len * 0.5625f;
@@ -208,6 +245,7 @@ void corr_deinit(struct correlator *corr)
 {
     if (corr) {
         free(corr->ref);
+        free(corr->ref_energy_rest);
         free(corr->buf);
 
 #       ifdef LOG_CORRELATOR_OUTPUT
@@ -239,21 +277,112 @@ void corr_reset(struct correlator *corr)
         for (i = 0; i < (2 * corr->len); i++) {
             corr->buf[i].real = corr->buf[i].imag = 0.0f;
         }
+
+        corr->window_energy = 0.0;
+    }
+}
+
+/* Compute the energy of the samples in the window exactly, discarding any
+ * rounding error accumulated by the running sum */
+static void update_window_energy(struct correlator *corr)
+{
+    const struct complexf *buf = corr->ins1;
+    double energy = 0.0;
+    size_t j;
+
+    for (j = 0; j < corr->len; j++) {
+        energy += buf[j].real * buf[j].real + buf[j].imag * buf[j].imag;
     }
+
+    corr->window_energy = energy;
+}
+
+/* Cross correlate the window ending at `buf` with the reference. */
+static inline float correlate_full(const struct correlator *corr,
+                                   const struct complexf *buf)
+{
+    const struct complexf *ref = corr->ref + corr->len - 1;
+    struct complexf result;
+    size_t j;
+
+    result.real = result.imag = 0;
+
+    for (j = 0; j < corr->len; j ++) {
+        result.real += ref->real * buf->real - ref->imag * buf->imag;
+        result.imag += ref->real * buf->imag + ref->imag * buf->real;
+
+        ref--;
+        buf--;
+    }
+
+    return result.real * result.real + result.imag * result.imag;
+}
+
+/* As correlate_full(), but stop once the correlation power provably cannot
+ * exceed `limit`, and return 0 in that case.
+ *
+ * By the Cauchy-Schwarz inequality, the magnitude of the terms not yet summed
+ * is at most sqrt(E_ref * E_buf), the energies of the remaining reference and
+ * window samples. If the partial result plus this is within `limit`, the
+ * final result is too. Noise and unrelated data fail this test well before
+ * the end of the reference, so most positions cost a fraction of a full
+ * correlation, without changing which positions are detected.
+ */
+static inline float correlate_early_exit(const struct correlator *corr,
+                                         const struct complexf *buf,
+                                         float limit)
+{
+    const struct complexf *ref = corr->ref + corr->len - 1;
+    struct complexf result;
+    float buf_energy = 0.0f;
+    size_t j = 0;
+
+    result.real = result.imag = 0;
+
+    while (j < corr->len) {
+        const size_t chunk_end = (corr->len - j > EARLY_EXIT_CHUNK) ?
+                                 j + EARLY_EXIT_CHUNK : corr->len;
+        float buf_rest, bound;
+
+        for (; j < chunk_end; j++) {
+            result.real += ref->real * buf->real - ref->imag * buf->imag;
+            result.imag += ref->real * buf->imag + ref->imag * buf->real;
+            buf_energy  += buf->real * buf->real + buf->imag * buf->imag;
+
+            ref--;
+            buf--;
+        }
+
+        if (j == corr->len) {
+            break;
+        }
+
+        buf_rest = (float)corr->window_energy - buf_energy;
+        if (buf_rest < 0.0f) {
+            buf_rest = 0.0f;
+        }
+
+        bound = sqrtf(result.real * result.real + result.imag * result.imag) +
+                sqrtf(corr->ref_energy_rest[j] * buf_rest);
+
+        if (bound * bound * (1.0f + EARLY_EXIT_MARGIN) <= limit) {
+            return 0.0f;
+        }
+    }
+
+    return result.real * result.real + result.imag * result.imag;
 }
 
 uint64_t corr_process(struct correlator *corr,
                       const struct complex_sample *samples, size_t n,
                       uint64_t timestamp)
 {
-    size_t i, j;
+    size_t i;
 
     uint64_t detected = CORRELATOR_NO_RESULT;
 
     for (i = 0; i < n; i += DECIMATION_FACTOR) {
-        struct complexf *ref = corr->ref + corr->len - 1;
-        struct complexf *buf = corr->ins2;
-        struct complexf result;
+        const struct complexf oldest = *corr->ins2;
         float result_pwr;
 
         /* Insert sample */
@@ -261,19 +390,19 @@ uint64_t corr_process(struct correlator *corr,
         corr->ins1->real = corr->ins2->real = samples[i].i/2048.0f;
         corr->ins1->imag = corr->ins2->imag = samples[i].q/2048.0f;
 
-        result.real = result.imag = 0;
+        /* The oldest sample in the window is replaced */
+        corr->window_energy +=
+            (corr->ins2->real * corr->ins2->real +
+             corr->ins2->imag * corr->ins2->imag) -
+            (oldest.real * oldest.real + oldest.imag * oldest.imag);
 
         /* Cross correlate */
-        for (j = 0; j < corr->len; j ++) {
-            result.real += ref->real * buf->real - ref->imag * buf->imag;
-            result.imag += ref->real * buf->imag + ref->imag * buf->real;
-
-            ref--;
-            buf--;
+        if (corr->mode == CORR_MODE_EARLY_EXIT) {
+            result_pwr = correlate_early_exit(corr, corr->ins2, corr->max);
+        } else {
+            result_pwr = correlate_full(corr, corr->ins2);
         }
 
-        result_pwr = result.real * result.real + result.imag * result.imag;
-
 #       ifdef LOG_CORRELATOR_OUTPUT
         fprintf(corr->out, "%f, %"PRIu64"\n", result_pwr, timestamp);
 #       endif
@@ -306,6 +435,7 @@ uint64_t corr_process(struct correlator *corr,
         corr->ins2++;
         if (corr->ins2 == corr->end) {
             reset_insertion_points(corr);
+            update_window_energy(corr);
         } else {
             corr->ins1++;
         }
@@ -358,7 +488,7 @@ int main(int argc, char *argv[])
         goto out;
     }
 
-    corr = corr_init(code_a, 8 * sizeof(code_a), sps);
+    corr = corr_init(code_a, 8 * sizeof(code_a), sps, CORR_MODE_EARLY_EXIT);
     if (corr == NULL) {
         fprintf(stderr, "Failed to initialize correlator.\n");
         goto out;
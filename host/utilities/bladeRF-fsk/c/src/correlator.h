@@ -35,6 +35,20 @@ struct correlator;
 //use every other sample. If 3 the correlator will use every third sample. And so on.
 #define DECIMATION_FACTOR 2
 
+/**
+ * Correlation strategies
+ */
+enum corr_mode {
+    /* Compute the full cross-correlation at every position */
+    CORR_MODE_FULL,
+
+    /* Abandon the correlation at a position as soon as it is known that it
+     * cannot exceed the detection threshold (or current peak). Detections
+     * are the same as with CORR_MODE_FULL, save for floating point rounding,
+     * at a fraction of the cost when no preamble is present. */
+    CORR_MODE_EARLY_EXIT,
+};
+
 /**
  * Create a correlator. This is currently limited to symbol lengths that are
  * a multiple of 8 (a byte).
@@ -42,10 +56,12 @@ struct correlator;
  * @param   syms                Symbols to correlate against
  * @param   n                   Number of symbols in `syms`. Must be a multiple of 8.
  * @param   sps                 Samples per symbol for modulation.
+ * @param   mode                Correlation strategy
  *
  * @return correlator handle on success, NULL on failure
  */
-struct correlator *corr_init(uint8_t *syms, size_t n, unsigned int sps);
+struct correlator *corr_init(uint8_t *syms, size_t n, unsigned int sps,
+                             enum corr_mode mode);
 
 /**
  * Deinitialize and deallocate the provided correlator
@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <math.h>
 #include "host_config.h"
+#include "dsp.h"
 
 #include "fir_filter.h"
 
@@ -34,6 +35,9 @@
 #   define DBG(...)
 #endif
 
+/* Samples are filtered in blocks of up to this many samples */
+#define FIR_BLOCK_LEN 4096
+
 struct fir_filter {
 
     float *taps;        /* Filter taps */
@@ -42,35 +46,26 @@ struct fir_filter {
     /* Interpolation or decimation factor */
     unsigned int factor;
 
-    /* Insertion points into "shift register" implementation that utilizes
-     * two copies of data to achieve a contiguious shifting window. */
-    size_t ins1;
-    size_t ins2;
+    /* Input window: the last (length - 1) samples of the previous block,
+     * followed by up to FIR_BLOCK_LEN new samples. Filtering the whole window
+     * with dsp_fir_complexf() carries the filter state across blocks. */
+    struct dsp_complexf *window;
 
-    /* Filter state buffers */
-    int32_t *i;
-    int32_t *q;
+    /* Filter output over the window. The first (length - 1) entries are
+     * discarded. */
+    struct dsp_complexf *result;
 };
 
 static void fir_reset(struct fir_filter *filt)
 {
-    size_t n;
-
-    for (n = 0; n < (2 * filt->length); n++) {
-        filt->i[n] = 0;
-        filt->q[n] = 0;
-    }
-
-    /* Remember, state is 2 copies: array len is 2 * filt->length elts */
-    filt->ins1  = 0;
-    filt->ins2  = filt->length;
+    memset(filt->window, 0, (filt->length - 1) * sizeof(filt->window[0]));
 }
 
 void fir_deinit(struct fir_filter *filt)
 {
     if (filt) {
-        free(filt->q);
-        free(filt->i);
+        free(filt->result);
+        free(filt->window);
         free(filt->taps);
         free(filt);
     }
@@ -80,22 +75,25 @@ struct fir_filter * fir_init(const float *taps, size_t length)
 {
     struct fir_filter *filt;
 
+    if (length == 0) {
+        return NULL;
+    }
+
     filt = calloc(1, sizeof(filt[0]));
     if (!filt) {
         perror("calloc");
         return NULL;
     }
 
-    /* Filter state is a sliding window implemented with 2 copies of data */
-    filt->i = calloc(2 * length, sizeof(filt->i[0]));
-    if (!filt->i) {
+    filt->window = calloc(length - 1 + FIR_BLOCK_LEN, sizeof(filt->window[0]));
+    if (!filt->window) {
         perror("calloc");
         fir_deinit(filt);
         return NULL;
     }
 
-    filt->q = calloc(2 * length, sizeof(filt->q[0]));
-    if (!filt->i) {
+    filt->result = calloc(length - 1 + FIR_BLOCK_LEN, sizeof(filt->result[0]));
+    if (!filt->result) {
         perror("calloc");
         fir_deinit(filt);
         return NULL;
@@ -118,48 +116,35 @@ struct fir_filter * fir_init(const float *taps, size_t length)
 void fir_process(struct fir_filter *f, int16_t *input,
                     struct complex_sample *output, size_t count)
 {
-    /* Index into input/output buffers */
-    size_t inout_idx;
+    const size_t history = f->length - 1;
 
-    /* Index into f->taps array */
-    size_t t;
+    while (count > 0) {
+        const size_t block = (count < FIR_BLOCK_LEN) ? count : FIR_BLOCK_LEN;
+        struct dsp_complexf *in = &f->window[history];
+        size_t n;
 
-    /* Index into f->i and f->q state arrays */
-    size_t s;
-
-    for (inout_idx = 0; inout_idx < (2*count); inout_idx += 2) {
-        int32_t i = input[inout_idx];
-        int32_t q = input[inout_idx+1];
-        float result_i = 0;
-        float result_q = 0;
-
-        /* Insert samples */
-        f->i[f->ins1] = f->i[f->ins2] = i;
-        f->q[f->ins1] = f->q[f->ins2] = q;
-
-        /* Convolve */
-        for (t = 0, s = f->ins2; t < f->length; t++, s--) {
-            float tmp_i, tmp_q;
+        for (n = 0; n < block; n++) {
+            in[n].i = input[2*n];
+            in[n].q = input[2*n + 1];
+        }
 
-            tmp_i = f->taps[t] * f->i[s];
-            tmp_q = f->taps[t] * f->q[s];
+        /* Outputs over the history portion of the window are incomplete
+         * (the samples preceding it are treated as 0), and are skipped */
+        dsp_fir_complexf(f->taps, f->length, f->window, f->result,
+                         history + block);
 
-            result_i += tmp_i;
-            result_q += tmp_q;
+        for (n = 0; n < block; n++) {
+            output[n].i = (int16_t) roundf(f->result[history + n].i);
+            output[n].q = (int16_t) roundf(f->result[history + n].q);
         }
 
-        /* Update output sample */
-        output[inout_idx/2].i = (int16_t) roundf(result_i);
-        output[inout_idx/2].q = (int16_t) roundf(result_q);
-
-        /* Advance insertion points */
-        f->ins2++;
-        if (f->ins2 == (2 * f->length)) {
-            f->ins1 = 0;
-            f->ins2 = f->length;
-        } else {
-            f->ins1++;
-        }
+        /* Retain the end of this block as history for the next */
+        memmove(f->window, &f->window[block],
+                history * sizeof(f->window[0]));
+
+        input  += 2 * block;
+        output += block;
+        count  -= block;
     }
 }
 
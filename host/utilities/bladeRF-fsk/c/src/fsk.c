@@ -33,6 +33,27 @@
     #define DEBUG_MSG(...)
 #endif
 
+/* Phases are represented as fixed-point fractions of a revolution, with a
+ * full revolution equal to 2^32. Differences between phases therefore wrap
+ * to (-pi, pi] with ordinary two's complement arithmetic, which does the
+ * work of unwrapping the angle. */
+#define PHASE_PI                    ((uint32_t)1 << 31)
+
+/* Number of CORDIC iterations. The error after n iterations is at most
+ * atan(2^-(n-1)) radians. */
+#define CORDIC_ITERATIONS           16
+
+/* Inputs are scaled up before the CORDIC iterations to preserve precision.
+ * 2^15 << 12, times the CORDIC gain of ~1.65 and sqrt(2), fits in 31 bits. */
+#define CORDIC_INPUT_SHIFT          12
+
+/* atan(2^-k) for k = 0 .. CORDIC_ITERATIONS-1, as a fraction of 2^32 */
+static const uint32_t cordic_atan_table[CORDIC_ITERATIONS] = {
+    536870912, 316933406, 167458907, 85004756, 42667331, 21354465,
+    10679838, 5340245, 2670163, 1335087, 667544, 333772, 166886, 83443,
+    41722, 20861
+};
+
 //internal structs
 struct fsk_handle {
     struct complex_sample *sample_table;
@@ -44,16 +65,18 @@ struct fsk_handle {
     bool last_byte_demod_complete;  //False if the last byte was partially demodulated
                                     //in a call to fsk_demod()
     uint8_t last_byte;
-    double last_phase;
-    double curr_dphase_tot;
+    uint32_t last_phase;
+    int64_t curr_dphase_tot;
     int curr_samp_index;            //Current samples index (0 - SAMP_PER_SYMB-1)
     int curr_bit_index;
+    uint32_t *phases;               //Phases of a symbol's samples, SAMP_PER_SYMB long
 };
 
 //internal functions
 static struct complex_sample *fsk_gen_samples_table(int points_per_rev);
-static double angle(int i, int q);
-static void angle_unwrap(double angle_prev, double *angle);
+static inline uint32_t phase(int32_t i, int32_t q);
+static void phase_block(const struct complex_sample *samples, int n,
+                        uint32_t *phases);
 
 /**
  * Generate 16bit two's complement IQ samples (SC16 Q11 format) corresponding to angles
@@ -155,42 +178,56 @@ unsigned int fsk_mod(struct fsk_handle *fsk, uint8_t *data_buf, int num_bytes,
 }
 
 /**
- * Unwrap a single angle so it is not wrapped to [-pi, pi]. Example: If angle_prev is 0.9*pi,
- * and (*angle) is -0.9*pi, then (*angle) will be changed to 1.1*pi, so the large
- * (discontinuous) phase jump is not seen.
- *
- * @param[in]       angle_prev      pointer to initial angle in radians
- * @param[inout]    angle           pointer to final angle. If an angle jump greater than pi
- *                                  or less than pi is found, this angle will be modified.
+ * Returns the phase of I+jQ, computed with a CORDIC in vectoring mode, as
+ * the hardware demodulator does. The result is a fraction of a revolution,
+ * where 2^32 is a full revolution (see PHASE_PI).
  */
-static void angle_unwrap(double angle_prev, double *angle)
+static inline uint32_t phase(int32_t i, int32_t q)
 {
-    double diff = *angle - angle_prev;
-    if (diff > M_PI){
-        //Subtract a multiple of 2*pi from the angle
-        *angle -= 2*M_PI * (int)( (diff+M_PI)/(2*M_PI) );
-    }else if (diff < -M_PI){
-        //Add a multiple of 2*pi to the angle
-        *angle += 2*M_PI * (int)( (diff-M_PI)/(-2*M_PI) );
+    uint32_t result = 0;
+    int k;
+
+    i *= 1 << CORDIC_INPUT_SHIFT;
+    q *= 1 << CORDIC_INPUT_SHIFT;
+
+    //Rotate by pi into the right half plane. The CORDIC converges for
+    //angles in [-pi/2, pi/2].
+    if (i < 0) {
+        result = PHASE_PI;
+        i = -i;
+        q = -q;
+    }
+
+    //Rotate the vector onto the I axis, accumulating the rotation applied
+    for (k = 0; k < CORDIC_ITERATIONS; k++) {
+        const int32_t di = q >> k;
+        const int32_t dq = i >> k;
+
+        if (q > 0) {
+            i += di;
+            q -= dq;
+            result += cordic_atan_table[k];
+        } else {
+            i -= di;
+            q += dq;
+            result -= cordic_atan_table[k];
+        }
     }
+
+    return result;
 }
 
 /**
- * Returns the angle of I+jQ, using the interval (-pi, pi)
+ * Compute the phases of a block of samples. The loop has no dependencies
+ * between samples, so that it may be vectorized.
  */
-static double angle(int i, int q)
+static void phase_block(const struct complex_sample *samples, int n,
+                        uint32_t *phases)
 {
-    double ratio = (double)q / (double)i;
-    if (i == 0 && q == 0){
-        return 0;    //Angle is undefined here. Just return 0.
-    }else if (i >= 0 && q >= 0){
-        return atan(ratio);
-    }else if (i < 0 && q >= 0){
-        return atan(ratio) + M_PI;
-    }else if (i < 0 && q < 0){
-        return atan(ratio) - M_PI;
-    }else{    //if (i >= 0 && q < 0)
-        return atan(ratio);
+    int k;
+
+    for (k = 0; k < n; k++) {
+        phases[k] = phase(samples[k].i, samples[k].q);
     }
 }
 
@@ -201,7 +238,8 @@ unsigned int fsk_demod(struct fsk_handle *fsk, struct complex_sample *samples,
     int byte = 0;
     int bit;
     int samp;
-    double phase, phase_prev, dphase_tot;
+    uint32_t last_phase;
+    int64_t dphase_tot;
 
     i = 0;
     if (new_signal){
@@ -209,10 +247,10 @@ unsigned int fsk_demod(struct fsk_handle *fsk, struct complex_sample *samples,
         fsk->curr_samp_index = 0;
         fsk->curr_dphase_tot = 0;
         fsk->curr_bit_index = 0;
-        fsk->last_phase = angle(samples[0].i, samples[0].q);
+        fsk->last_phase = phase(samples[0].i, samples[0].q);
         i++;
     }
-    phase = fsk->last_phase;
+    last_phase = fsk->last_phase;
     //Initialize byte appropriately if last demod was not fully completed
     //(i.e. last byte was partially demodulated)
     if (!fsk->last_byte_demod_complete){
@@ -224,23 +262,27 @@ unsigned int fsk_demod(struct fsk_handle *fsk, struct complex_sample *samples,
         for (bit = fsk->curr_bit_index; bit < 8; bit++){
             //Loop through SAMP_PER_SYMB samples and their corresponding changes in phase
             //Stop if we reach the end of the samples buffer
+            int n = fsk->samp_per_symb - fsk->curr_samp_index;
+            int k;
+            if (n > num_samples - i){
+                n = num_samples - i;
+            }
+            phase_block(&samples[i], n, fsk->phases);
             dphase_tot = fsk->curr_dphase_tot;
-            for (samp = fsk->curr_samp_index; (samp < fsk->samp_per_symb) && i < num_samples;
-                    samp++){
-                phase_prev = phase;
-                phase = angle(samples[i].i, samples[i].q);
-                //Unwrap angle
-                angle_unwrap(phase_prev, &phase);
-                //Add this angle change to the total angle change
-                dphase_tot += phase - phase_prev;
-                i++;
+            for (k = 0; k < n; k++){
+                //Add this angle change to the total angle change. The
+                //subtraction wraps, which unwraps the angle.
+                dphase_tot += (int32_t)(fsk->phases[k] - last_phase);
+                last_phase = fsk->phases[k];
             }
+            samp = fsk->curr_samp_index + n;
+            i += n;
             //Check to see if we broke out of the loop before demodulating the full bit
             if (samp != fsk->samp_per_symb){
                 //Set demod state information
                 fsk->last_byte_demod_complete = false;
                 fsk->last_byte = data_buf[byte];
-                fsk->last_phase = phase;
+                fsk->last_phase = last_phase;
                 fsk->curr_dphase_tot = dphase_tot;
                 fsk->curr_samp_index = samp;
                 fsk->curr_bit_index = bit;
@@ -257,7 +299,7 @@ unsigned int fsk_demod(struct fsk_handle *fsk, struct complex_sample *samples,
             fsk->curr_samp_index = 0;
             fsk->curr_dphase_tot = 0;
         }
-        fsk->last_phase = phase;
+        fsk->last_phase = last_phase;
         fsk->curr_bit_index = 0;
         fsk->last_byte_demod_complete = true;
     }
@@ -286,6 +328,13 @@ struct fsk_handle *fsk_init(void)
         free(fsk);
         return NULL;
     }
+    fsk->phases = malloc(SAMP_PER_SYMB * sizeof(fsk->phases[0]));
+    if (fsk->phases == NULL){
+        perror("malloc");
+        free(fsk->sample_table);
+        free(fsk);
+        return NULL;
+    }
     //Initialize demod state variables
     fsk->last_byte_demod_complete = true;
     fsk->last_byte = 0x00;
@@ -300,6 +349,7 @@ void fsk_close(struct fsk_handle *fsk)
 {
     if (fsk != NULL){
         free(fsk->sample_table);
+        free(fsk->phases);
     }
     free(fsk);
 }
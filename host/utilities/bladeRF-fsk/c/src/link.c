@@ -50,50 +50,72 @@
  ********************************************/
 
 struct data_frame {
-    //Total frame length = 1009 bytes (8072 bits)
+    //Total frame length = 1011 bytes (8088 bits)
     uint8_t type;               //0x00 = data frame, 0xFF = ack frame
     uint16_t seq_num;           //Sequence number
+    uint16_t window_base;       //Oldest sequence number the sender may still send.
+                                //Earlier frames that weren't acked were given up on.
     uint16_t payload_length;    //Length of used payload data in bytes
     uint8_t payload[PAYLOAD_LENGTH];    //payload data
     uint32_t crc32;             //32-bit CRC
 };
 
 struct ack_frame {
-    //Total frame length = 7 bytes (56 bits)
+    //Total frame length = 11 bytes (88 bits)
     uint8_t type;               //0x00 = data frame, 0xFF = ack frame
-    uint16_t ack_num;           //Acknowledgement number
+    uint16_t ack_num;           //Cumulative ack: all frames before this sequence
+                                //number have been received
+    uint32_t sack;              //Selective ack: bit i is set if frame ack_num+1+i
+                                //has been received
     uint32_t crc32;             //32-bit CRC
 };
 
+//A data frame in the transmit window
+struct tx_frame {
+    struct data_frame frame;
+    unsigned int tries;             //Number of times the frame has been sent
+    struct timespec resend_time;    //When to resend the frame if it isn't acked
+    bool acked;                     //Has the frame been acknowledged
+};
+
+/* The transmit and receive windows are indexed by sequence number modulo
+ * LINK_MAX_WINDOW. Sequence number arithmetic is done in uint16_t so that it
+ * wraps along with the sequence numbers themselves. */
 struct tx {
-    struct data_frame data_frame_buf;   //Input data frame buffer
-    struct ack_frame ack_frame_buf;     //Input ack frame buffer
+    //Frames [base_seq, send_seq) have been sent and are awaiting acks. Frames
+    //[send_seq, next_seq) are queued but have not been sent yet.
+    struct tx_frame window[LINK_MAX_WINDOW];
+    unsigned int window_size;           //Max number of frames in the window
+    uint16_t base_seq;                  //Oldest unacknowledged frame
+    uint16_t send_seq;                  //Next frame to send for the first time
+    uint16_t next_seq;                  //Sequence number of the next queued frame
+    bool failed;                        //Was a frame given up on
     bool stop;                          //Signal to stop tx thread
-    bool data_buf_filled;               //Is the data frame buffer filled
     pthread_t thread;                   //Transmitter thread
-    pthread_cond_t data_buf_filled_cond;    //pthread condition corresponding to
-                                            //data_buf_filled
-    pthread_mutex_t data_buf_status_lock;   //Mutex for data_buf_filled_cond
+    pthread_mutex_t window_lock;        //Mutex for the window
+    pthread_cond_t work_cond;           //Signaled when frames are queued
+    pthread_cond_t window_cond;         //Signaled when frames leave the window
     bool link_on;   //Is the transmitter on
-    bool done;      //Has the transmitter finished a transmission
-    bool success;   //Was the transmitter transmission successful
 };
 
 struct rx {
-    struct data_frame data_frame_buf;   //Output data frame buffer
-    struct ack_frame ack_frame_buf;     //Output ack frame buffer
+    //Frames [deliver_seq, deliver_seq + window_size) are held here until they
+    //are returned to the user in order
+    struct data_frame window[LINK_MAX_WINDOW];
+    bool received[LINK_MAX_WINDOW];     //Is the window slot filled
+    unsigned int window_size;           //Max number of frames in the window
+    uint16_t deliver_seq;               //Next frame to return to the user
+    uint16_t sender_base;               //Latest window_base received
+    bool synced;                        //Has a data frame been received yet
     //Leftover bytes received but not returned to the user after a call to
     //link_receive_data()
     uint8_t extra_bytes[PAYLOAD_LENGTH];
     unsigned int num_extra_bytes;       //Number of bytes in 'extra_bytes' buffer
     pthread_t thread;                   //Receiver thread
     bool stop;                          //Signal to stop rx thread
-    bool data_buf_filled;               //Is the data frame buffer filled
-    pthread_cond_t data_buf_filled_cond;    //pthread condition for data_buf_filled
-    pthread_mutex_t data_buf_status_lock;   //mutex for data_buf_filled_cond
-    bool ack_buf_filled;                    //Is the ack frame buffer filled
-    pthread_cond_t ack_buf_filled_cond;     //pthread condition for ack_buf_filled
-    pthread_mutex_t ack_buf_status_lock;    //mutex for ack_buf_filled_cond
+    pthread_cond_t data_buf_filled_cond;    //pthread condition signaled when a
+                                            //frame is added to the window
+    pthread_mutex_t data_buf_status_lock;   //mutex for the window
     bool link_on;                           //Is the receiver on
 };
 
@@ -110,14 +132,15 @@ struct link_handle {
 static int start_transmitter(struct link_handle *link);
 static int stop_transmitter(struct link_handle *link);
 void *transmit_data_frames(void *arg);
-static int send_payload(struct link_handle *link, uint8_t *payload,
+static int queue_payload(struct link_handle *link, uint8_t *payload,
                         uint16_t used_payload_length);
+static int process_ack(struct link_handle *link, struct ack_frame *ack);
 //rx:
 static int start_receiver(struct link_handle *link);
 static int stop_receiver(struct link_handle *link);
 void *receive_frames(void *arg);
-static int receive_ack(struct link_handle *link, uint16_t ack_num,
-                        unsigned int timeout_ms);
+static int store_data_frame(struct link_handle *link, struct data_frame *frame,
+                            struct ack_frame *ack);
 static int receive_payload(struct link_handle *link, uint8_t *payload,
                             unsigned int timeout_ms);
 //utility:
@@ -125,6 +148,9 @@ static void convert_data_frame_struct_to_buf(struct data_frame *frame, uint8_t *
 static void convert_ack_frame_struct_to_buf(struct ack_frame *frame, uint8_t *buf);
 static void convert_buf_to_data_frame_struct(uint8_t *buf, struct data_frame *frame);
 static void convert_buf_to_ack_frame_struct(uint8_t *buf, struct ack_frame *frame);
+//init:
+static struct link_handle *link_open(struct bladerf *dev, struct radio_params *params,
+                                    struct channelizer *chan, unsigned int channel);
 
 /****************************************
  *                                      *
@@ -133,6 +159,29 @@ static void convert_buf_to_ack_frame_struct(uint8_t *buf, struct ack_frame *fram
  ****************************************/
 
 struct link_handle *link_init(struct bladerf *dev, struct radio_params *params)
+{
+    return link_open(dev, params, NULL, 0);
+}
+
+struct link_handle *link_init_channel(struct channelizer *chan, unsigned int channel,
+                                        struct radio_params *params)
+{
+    return link_open(NULL, params, chan, channel);
+}
+
+/**
+ * Allocates a link handle and starts its threads, for link_init() or
+ * link_init_channel()
+ *
+ * @param[in]   dev         bladeRF device handle, or NULL if chan is used
+ * @param[in]   params      radio parameters
+ * @param[in]   chan        channelizer for a receive-only link, or NULL
+ * @param[in]   channel     channel of chan to receive
+ *
+ * @return      pointer to allocated link_handle struct on success, NULL on error
+ */
+static struct link_handle *link_open(struct bladerf *dev, struct radio_params *params,
+                                    struct channelizer *chan, unsigned int channel)
 {
     int status;
     struct link_handle *link;
@@ -147,8 +196,18 @@ struct link_handle *link_init(struct bladerf *dev, struct radio_params *params)
         return NULL;
     }
 
+    if (params->link_window < 1 || params->link_window > LINK_MAX_WINDOW){
+        fprintf(stderr, "[LINK] Invalid window size %u (max %u)\n",
+                params->link_window, LINK_MAX_WINDOW);
+        goto error;
+    }
+
     //---------------Open/Initialize phy handle--------------------------
-    link->phy = phy_init(dev, params);
+    if (chan != NULL){
+        link->phy = phy_init_channel(chan, channel);
+    }else{
+        link->phy = phy_init(dev, params);
+    }
     if (link->phy == NULL){
         fprintf(stderr, "[LINK] Couldn't initialize phy handle\n");
         goto error;
@@ -160,42 +219,52 @@ struct link_handle *link_init(struct bladerf *dev, struct radio_params *params)
         goto error;
     }
     link->phy_rx_on = true;
-    //Start phy transmitter
-    status = phy_start_transmitter(link->phy);
-    if (status != 0){
-        fprintf(stderr, "[LINK] Couldn't start phy transmitter\n");
-        goto error;
-    }
-    link->phy_tx_on = true;
-
-    //------------------Allocate memory for tx struct and initialize-----
-    link->tx = malloc(sizeof(struct tx));
-    if (link->tx == NULL){
-        perror("malloc");
-        goto error;
-    }
-    //Initialize control/state variables
-    link->tx->stop = false;
-    link->tx->data_buf_filled = false;
-    link->tx->done = false;
-    link->tx->success = false;
-    link->tx->link_on = false;
-    //Initialize pthread condition variable
-    status = pthread_cond_init(&(link->tx->data_buf_filled_cond), NULL);
-    if (status != 0){
-        fprintf(stderr, "[LINK] Error initializing pthread_cond: %s\n",
-                    strerror(status));
-        goto error;
-    }
-    //Initialize pthread mutex variable
-    status = pthread_mutex_init(&(link->tx->data_buf_status_lock), NULL);
-    if (status != 0){
-        fprintf(stderr, "[LINK] Error initializing pthread_mutex: %s\n",
-                    strerror(status));
-        goto error;
+    //A receive-only link has no transmitter, and sends no acks
+    if (chan == NULL){
+        //Start phy transmitter
+        status = phy_start_transmitter(link->phy);
+        if (status != 0){
+            fprintf(stderr, "[LINK] Couldn't start phy transmitter\n");
+            goto error;
+        }
+        link->phy_tx_on = true;
+
+        //------------------Allocate memory for tx struct and initialize-----
+        //Calloc so the window starts out empty
+        link->tx = calloc(1, sizeof(struct tx));
+        if (link->tx == NULL){
+            perror("malloc");
+            goto error;
+        }
+        //Initialize control/state variables
+        link->tx->window_size = params->link_window;
+        link->tx->stop = false;
+        link->tx->failed = false;
+        link->tx->link_on = false;
+        //Initialize pthread condition variables
+        status = pthread_cond_init(&(link->tx->work_cond), NULL);
+        if (status != 0){
+            fprintf(stderr, "[LINK] Error initializing pthread_cond: %s\n",
+                        strerror(status));
+            goto error;
+        }
+        status = pthread_cond_init(&(link->tx->window_cond), NULL);
+        if (status != 0){
+            fprintf(stderr, "[LINK] Error initializing pthread_cond: %s\n",
+                        strerror(status));
+            goto error;
+        }
+        //Initialize pthread mutex variable
+        status = pthread_mutex_init(&(link->tx->window_lock), NULL);
+        if (status != 0){
+            fprintf(stderr, "[LINK] Error initializing pthread_mutex: %s\n",
+                        strerror(status));
+            goto error;
+        }
     }
     //------------------Allocate memory for rx struct and initialize-----
-    link->rx = malloc(sizeof(struct rx));
+    //Calloc so the window starts out empty
+    link->rx = calloc(1, sizeof(struct rx));
     if (link->rx == NULL){
         perror("malloc");
         goto error;
@@ -214,24 +283,10 @@ struct link_handle *link_init(struct bladerf *dev, struct radio_params *params)
                     strerror(status));
         goto error;
     }
-    //Initialize pthread condition variable for ack
-    status = pthread_cond_init(&(link->rx->ack_buf_filled_cond), NULL);
-    if (status != 0){
-        fprintf(stderr, "[LINK] Error initializing pthread_cond: %s\n",
-                    strerror(status));
-        goto error;
-    }
-    //Initialize pthread mutex variable for ack
-    status = pthread_mutex_init(&(link->rx->ack_buf_status_lock), NULL);
-    if (status != 0){
-        fprintf(stderr, "[LINK] Error initializing pthread_mutex: %s\n",
-                    strerror(status));
-        goto error;
-    }
     //Initialize control/state variables
+    link->rx->window_size = params->link_window;
+    link->rx->synced = false;
     link->rx->stop = false;
-    link->rx->data_buf_filled = false;
-    link->rx->ack_buf_filled = false;
     link->rx->num_extra_bytes = 0;
     link->rx->link_on = false;
 
@@ -243,12 +298,14 @@ struct link_handle *link_init(struct bladerf *dev, struct radio_params *params)
     }
     link->rx->link_on = true;
     //-------------------Start the link transmitter-------------------------
-    status = start_transmitter(link);
-    if (status != 0){
-        fprintf(stderr, "[LINK] Couldn't start receiver\n");
-        goto error;
+    if (link->tx != NULL){
+        status = start_transmitter(link);
+        if (status != 0){
+            fprintf(stderr, "[LINK] Couldn't start receiver\n");
+            goto error;
+        }
+        link->tx->link_on = true;
     }
-    link->tx->link_on = true;
 
     DEBUG_MSG("[LINK] Initialization done\n");
     return link;
@@ -275,11 +332,15 @@ void link_close(struct link_handle *link)
                     fprintf(stderr, "[LINK] Error stopping link transmitter\n");
                 }
             }
-            status = pthread_mutex_destroy(&(link->tx->data_buf_status_lock));
+            status = pthread_mutex_destroy(&(link->tx->window_lock));
             if (status != 0){
                 fprintf(stderr, "[LINK] Error destroying pthread_mutex\n");
             }
-            status = pthread_cond_destroy(&(link->tx->data_buf_filled_cond));
+            status = pthread_cond_destroy(&(link->tx->work_cond));
+            if (status != 0){
+                fprintf(stderr, "[LINK] Error destroying pthread_cond\n");
+            }
+            status = pthread_cond_destroy(&(link->tx->window_cond));
             if (status != 0){
                 fprintf(stderr, "[LINK] Error destroying pthread_cond\n");
             }
@@ -302,14 +363,6 @@ void link_close(struct link_handle *link)
             if (status != 0){
                 fprintf(stderr, "[LINK] Error destroying pthread_cond\n");
             }
-            status = pthread_mutex_destroy(&(link->rx->ack_buf_status_lock));
-            if (status != 0){
-                fprintf(stderr, "[LINK] Error destroying pthread_mutex\n");
-            }
-            status = pthread_cond_destroy(&(link->rx->ack_buf_filled_cond));
-            if (status != 0){
-                fprintf(stderr, "[LINK] Error destroying pthread_cond\n");
-            }
         }
         free(link->rx);
         //Close the phy
@@ -350,6 +403,9 @@ static void convert_data_frame_struct_to_buf(struct data_frame *frame, uint8_t *
     //Seq num
     memcpy(&buf[i], &(frame->seq_num), sizeof(frame->seq_num));
     i += sizeof(frame->seq_num);
+    //Window base
+    memcpy(&buf[i], &(frame->window_base), sizeof(frame->window_base));
+    i += sizeof(frame->window_base);
     //payload length
     memcpy(&buf[i], &(frame->payload_length), sizeof(frame->payload_length));
     i += sizeof(frame->payload_length);
@@ -383,6 +439,9 @@ static void convert_ack_frame_struct_to_buf(struct ack_frame *frame, uint8_t *bu
     //ack num
     memcpy(&buf[i], &(frame->ack_num), sizeof(frame->ack_num));
     i += sizeof(frame->ack_num);
+    //selective acks
+    memcpy(&buf[i], &(frame->sack), sizeof(frame->sack));
+    i += sizeof(frame->sack);
     //crc
     memcpy(&buf[i], &(frame->crc32), sizeof(frame->crc32));
     i += sizeof(frame->crc32);
@@ -411,6 +470,9 @@ static void convert_buf_to_data_frame_struct(uint8_t *buf, struct data_frame *fr
     //Seq num
     memcpy(&(frame->seq_num), &buf[i], sizeof(frame->seq_num));
     i += sizeof(frame->seq_num);
+    //Window base
+    memcpy(&(frame->window_base), &buf[i], sizeof(frame->window_base));
+    i += sizeof(frame->window_base);
     //payload length
     memcpy(&(frame->payload_length), &buf[i], sizeof(frame->payload_length));
     i += sizeof(frame->payload_length);
@@ -445,6 +507,9 @@ static void convert_buf_to_ack_frame_struct(uint8_t *buf, struct ack_frame *fram
     //ack num
     memcpy(&(frame->ack_num), &buf[i], sizeof(frame->ack_num));
     i += sizeof(frame->ack_num);
+    //selective acks
+    memcpy(&(frame->sack), &buf[i], sizeof(frame->sack));
+    i += sizeof(frame->sack);
     //crc
     memcpy(&(frame->crc32), &buf[i], sizeof(frame->crc32));
     i += sizeof(frame->crc32);
@@ -474,8 +539,13 @@ static int start_transmitter(struct link_handle *link)
 {
     int status;
 
-    link->tx->done = false;
-    link->tx->success = false;
+    //Set initial sequence number to random value
+    srand((unsigned int)time(NULL));
+    link->tx->next_seq = rand() % 65536;
+    link->tx->base_seq = link->tx->next_seq;
+    link->tx->send_seq = link->tx->next_seq;
+    DEBUG_MSG("[LINK] TX: Initial seq num = %hu\n", link->tx->next_seq);
+    link->tx->failed = false;
     //be sure stop signal is off
     link->tx->stop = false;
     //Kick off transmitter thread
@@ -500,19 +570,23 @@ static int stop_transmitter(struct link_handle *link)
     int status;
 
     DEBUG_MSG("[LINK] TX: Stopping transmitter...\n");
+    status = pthread_mutex_lock(&(link->tx->window_lock));
+    if (status != 0){
+        fprintf(stderr, "[LINK] Error locking pthread_mutex\n");
+    }
     //signal stop
     link->tx->stop = true;
-    //Signal the buffer filled condition so the thread will stop waiting
-    //for a filled buffer
-    status = pthread_mutex_lock(&(link->tx->data_buf_status_lock));
+    //Wake the thread so it will stop waiting for work, along with
+    //link_send_data() callers waiting on the window
+    status = pthread_cond_signal(&(link->tx->work_cond));
     if (status != 0){
-        fprintf(stderr, "[LINK] Error locking pthread_mutex\n");
+        fprintf(stderr, "[LINK] Error signaling pthread_cond\n");
     }
-    status = pthread_cond_signal(&(link->tx->data_buf_filled_cond));
+    status = pthread_cond_broadcast(&(link->tx->window_cond));
     if (status != 0){
         fprintf(stderr, "[LINK] Error signaling pthread_cond\n");
     }
-    status = pthread_mutex_unlock(&(link->tx->data_buf_status_lock));
+    status = pthread_mutex_unlock(&(link->tx->window_lock));
     if (status != 0){
         fprintf(stderr, "[LINK] Error unlocking pthread_mutex\n");
     }
@@ -529,61 +603,79 @@ static int stop_transmitter(struct link_handle *link)
 
 int link_send_data(struct link_handle *link, uint8_t *data, unsigned int data_length)
 {
-    unsigned int num_full_payloads;
     unsigned int i;
-    unsigned int last_payload_length;
-    int status;
+    uint16_t payload_length;
+    int status, ret = 0;
 
-    num_full_payloads = data_length/PAYLOAD_LENGTH;
+    if (link->tx == NULL){
+        fprintf(stderr, "[LINK] TX: This link only receives\n");
+        return -1;
+    }
 
-    //Loop through each full payload
-    for(i = 0; i < num_full_payloads; i++){
-        //Send the frame
-        status = send_payload(link, &data[i*PAYLOAD_LENGTH], PAYLOAD_LENGTH);
-        if (status != 0){
-            if (status == -2){
-                DEBUG_MSG("[LINK] TX: Send data failed: "
-                            "No response for payload #%d\n", i+1);
-            }else{
-                fprintf(stderr, "[LINK] TX: Send data failed: "
-                            "Unexpected error sending payload #%d\n", i+1);
-            }
-            return status;
+    status = pthread_mutex_lock(&(link->tx->window_lock));
+    if (status != 0){
+        fprintf(stderr, "[LINK] Error locking pthread_mutex: %s\n",
+                    strerror(status));
+        return -1;
+    }
+    link->tx->failed = false;
+
+    //Queue each payload as room opens up in the window
+    for (i = 0; i < data_length && ret == 0; i += payload_length){
+        if (data_length - i < PAYLOAD_LENGTH){
+            payload_length = (uint16_t) (data_length - i);
+        }else{
+            payload_length = PAYLOAD_LENGTH;
         }
+        ret = queue_payload(link, &data[i], payload_length);
     }
 
-    //Send the last payload for the remaining bytes
-    last_payload_length = data_length % PAYLOAD_LENGTH;
-    if (last_payload_length != 0){
-        status = send_payload(link, &data[i*PAYLOAD_LENGTH],
-                                (uint16_t) last_payload_length);
+    //Wait for all of the frames to be acknowledged
+    while (ret == 0 && link->tx->base_seq != link->tx->next_seq &&
+            !link->tx->failed && !link->tx->stop){
+        status = pthread_cond_wait(&(link->tx->window_cond), &(link->tx->window_lock));
         if (status != 0){
-            if (status == -2){
-                DEBUG_MSG("[LINK] TX: Send data failed: "
-                            "No response for payload #%d\n", i+1);
-            }else{
-                fprintf(stderr, "[LINK] TX: Send data failed: "
-                            "Unexpected error sending payload #%d\n", i+1);
-            }
-            return status;
+            fprintf(stderr, "[LINK] Condition wait failed: %s\n", strerror(status));
+            ret = -1;
         }
     }
-    return 0;
+    if (ret == 0 && link->tx->stop){
+        ret = -1;
+    }else if (ret == 0 && link->tx->failed){
+        ret = -2;
+    }
+
+    status = pthread_mutex_unlock(&(link->tx->window_lock));
+    if (status != 0){
+        fprintf(stderr, "[LINK] Error unlocking pthread_mutex: %s\n",
+                    strerror(status));
+        ret = -1;
+    }
+
+    if (ret == -2){
+        DEBUG_MSG("[LINK] TX: Send data failed: No response\n");
+    }else if (ret != 0){
+        fprintf(stderr, "[LINK] TX: Send data failed: Unexpected error\n");
+    }
+    return ret;
 }
 
 /**
- * Sends a payload. Blocks until either the transmission was successful (with an
- * acknowledgement) or there was no response (exceeded max number of retransmissions)
+ * Queues a payload in the transmit window. Blocks while the window is full.
+ * Must be called with the window lock held.
  *
  * @param[in]   link                    pointer to link handle
  * @param[in]   payload                 buffer of bytes to send
  * @param[in]   used_payload_length     number of bytes to send in 'payload'. If less
  *                                      than PAYLOAD_LENGTH, zeros will be padded.
- * @return      0 on success, -1 on error, -2 on timeout/no response
+ * @return      0 on success, -1 on error, -2 if the transmitter gave up on a frame
+ *              (exceeded max number of retransmissions) while waiting
  */
-static int send_payload(struct link_handle *link, uint8_t *payload,
+static int queue_payload(struct link_handle *link, uint8_t *payload,
                     uint16_t used_payload_length)
 {
+    struct tx *tx = link->tx;
+    struct tx_frame *f;
     int status;
 
     if (used_payload_length > PAYLOAD_LENGTH){
@@ -592,55 +684,114 @@ static int send_payload(struct link_handle *link, uint8_t *payload,
         return -1;
     }
 
-    //Wait for tx buf to be empty
-    while(link->tx->data_buf_filled){
-        usleep(50);
+    //Wait for room in the window
+    while ((uint16_t) (tx->next_seq - tx->base_seq) >= tx->window_size &&
+            !tx->failed && !tx->stop){
+        status = pthread_cond_wait(&(tx->window_cond), &(tx->window_lock));
+        if (status != 0){
+            fprintf(stderr, "[LINK] Condition wait failed: %s\n", strerror(status));
+            return -1;
+        }
+    }
+    if (tx->stop){
+        return -1;
+    }else if (tx->failed){
+        return -2;
     }
+
+    f = &(tx->window[tx->next_seq % LINK_MAX_WINDOW]);
+    f->frame.type = DATA_FRAME_CODE;
+    f->frame.seq_num = tx->next_seq;
     //Copy payload data into frame buffer
-    memcpy(link->tx->data_frame_buf.payload, payload, used_payload_length);
+    memcpy(f->frame.payload, payload, used_payload_length);
     //Pad zeros to unused portion of the payload
-    memset(&(link->tx->data_frame_buf.payload[used_payload_length]), 0,
+    memset(&(f->frame.payload[used_payload_length]), 0,
             PAYLOAD_LENGTH - used_payload_length);
     //Set payload length
-    link->tx->data_frame_buf.payload_length = used_payload_length;
-    //Mark tx not done
-    link->tx->done = false;
-    //Mark buffer filled
-    link->tx->data_buf_filled = true;
-    //Signal the buffer filled condition
-    status = pthread_mutex_lock(&(link->tx->data_buf_status_lock));
-    if (status != 0){
-        fprintf(stderr, "[LINK] Error locking pthread_mutex: %s\n",
-                    strerror(status));
-        return -1;
-    }
-    status = pthread_cond_signal(&(link->tx->data_buf_filled_cond));
+    f->frame.payload_length = used_payload_length;
+    f->tries = 0;
+    f->acked = false;
+    tx->next_seq++;
+
+    //Wake the transmitter
+    status = pthread_cond_signal(&(tx->work_cond));
     if (status != 0){
         fprintf(stderr, "[LINK] Error signaling pthread_cond: %s\n",
                     strerror(status));
         return -1;
     }
-    status = pthread_mutex_unlock(&(link->tx->data_buf_status_lock));
+    return 0;
+}
+
+/**
+ * Marks the frames acknowledged by an ACK frame, and slides the transmit window
+ * past the oldest run of acknowledged frames
+ *
+ * @param[in]   link    pointer to link handle
+ * @param[in]   ack     received ACK frame
+ *
+ * @return      0 on success, -1 on pthread error
+ */
+static int process_ack(struct link_handle *link, struct ack_frame *ack)
+{
+    struct tx *tx = link->tx;
+    uint16_t num_sent, seq;
+    unsigned int i;
+    int status;
+
+    status = pthread_mutex_lock(&(tx->window_lock));
     if (status != 0){
-        fprintf(stderr, "[LINK] Error unlocking pthread_mutex: %s\n",
-                    strerror(status));
+        fprintf(stderr, "[LINK] Mutex lock failed: %s\n", strerror(status));
         return -1;
     }
-    //Wait for the transmission to complete
-    //TODO: Change this to a pthread condition signal
-    while (!link->tx->done){
-        usleep(100);
+
+    num_sent = tx->send_seq - tx->base_seq;
+    //Cumulative ack. Ignore stale ones behind the window.
+    if ((uint16_t) (ack->ack_num - tx->base_seq) <= num_sent){
+        for (seq = tx->base_seq; seq != ack->ack_num; seq++){
+            tx->window[seq % LINK_MAX_WINDOW].acked = true;
+        }
     }
-    //Check the status of the transmission
-    if (!link->tx->success){
-        return -2;
+    //Selective acks
+    for (i = 0; i < 32; i++){
+        seq = ack->ack_num + 1 + i;
+        if ((ack->sack & (1u << i)) && (uint16_t) (seq - tx->base_seq) < num_sent){
+            tx->window[seq % LINK_MAX_WINDOW].acked = true;
+        }
     }
 
-    return 0;
+    //Slide the window
+    seq = tx->base_seq;
+    while (tx->base_seq != tx->send_seq &&
+            tx->window[tx->base_seq % LINK_MAX_WINDOW].acked){
+        tx->base_seq++;
+    }
+    if (tx->base_seq != seq){
+        DEBUG_MSG("[LINK] TX: Got an ACK. %hu frame(s) acknowledged\n",
+                    (uint16_t) (tx->base_seq - seq));
+        status = pthread_cond_broadcast(&(tx->window_cond));
+        if (status != 0){
+            fprintf(stderr, "[LINK] Error signaling pthread_cond: %s\n",
+                        strerror(status));
+        }
+    }
+
+    pthread_mutex_unlock(&(tx->window_lock));
+    return status == 0 ? 0 : -1;
+}
+
+//Is time a before time b?
+static bool timespec_before(const struct timespec *a, const struct timespec *b)
+{
+    return a->tv_sec < b->tv_sec ||
+            (a->tv_sec == b->tv_sec && a->tv_nsec < b->tv_nsec);
 }
 
 /**
- * Thread function that transmits data frames and waits for acks.
+ * Thread function that transmits the data frames in the transmit window. Frames
+ * are sent as soon as they are queued, and are resent if they have not been
+ * acknowledged after ACK_TIMEOUT_MS. If a frame goes unacknowledged after
+ * LINK_MAX_TRIES tries, the whole window is given up on.
  * Does not directly receive acks - the receive_frames() function does this.
  * Does not transmit acks - the receive_frames function does this.
  *
@@ -649,109 +800,121 @@ static int send_payload(struct link_handle *link, uint8_t *payload,
 void *transmit_data_frames(void *arg)
 {
     int status;
-    uint16_t seq_num;
+    uint16_t seq;
     uint32_t crc_32;
-    unsigned int tries;
     uint8_t data_send_buf[DATA_FRAME_LENGTH];
-    bool failed;
+    struct tx_frame *f, *w;
+    struct timespec now, wake;
+    bool wake_set;
 
     //cast arg
     struct link_handle *link = (struct link_handle *) arg;
-    //Set initial sequence number to random value
-    srand((unsigned int)time(NULL));
-    seq_num = rand() % 65536;
-    DEBUG_MSG("[LINK] TX: Initial seq num = %hu\n", seq_num);
-    tries = 1;
-
-    while (!link->tx->stop){
-        if (tries > LINK_MAX_TRIES){
-            DEBUG_MSG("[LINK] TX: Exceeded max tries (%u) without an ACK."
-                            " Skipping frame\n", tries-1);
-            link->tx->success = false;
-            link->tx->done = true;
-            tries = 1;
+    struct tx *tx = link->tx;
+
+    status = pthread_mutex_lock(&(tx->window_lock));
+    if (status != 0){
+        fprintf(stderr, "[LINK] Mutex lock failed: %s\n", strerror(status));
+        return NULL;
+    }
+
+    while (!tx->stop){
+        status = create_timeout_abs(0, &now);
+        if (status != 0){
+            fprintf(stderr, "[LINK] transmit_frames(): Error getting time\n");
+            goto out;
         }
-        if (tries == 1){
-            //---------Wait for data buffer to be filled-----------
-            //Lock mutex
-            status = pthread_mutex_lock(&(link->tx->data_buf_status_lock));
-            if (status != 0){
-                fprintf(stderr, "[LINK] Mutex lock failed: %s\n",
-                        strerror(status));
-                goto out;
+
+        //Resend the oldest frame with an expired ack timeout
+        f = NULL;
+        wake_set = false;
+        for (seq = tx->base_seq; seq != tx->send_seq; seq++){
+            w = &(tx->window[seq % LINK_MAX_WINDOW]);
+            if (w->acked){
+                continue;
             }
-            //Wait for condition signal - meaning buffer is full
-            failed = false;
-            while (!link->tx->data_buf_filled && !link->tx->stop){
-                DEBUG_MSG("[LINK] TX: Waiting for buffer to be filled\n");
-                status = pthread_cond_wait(&(link->tx->data_buf_filled_cond),
-                                            &(link->tx->data_buf_status_lock));
-                if (status != 0){
-                    fprintf(stderr, "[LINK] transmit_frames(): "
-                            "Condition wait failed: %s\n", strerror(status));
-                    failed = true;
-                    break;
+            if (!timespec_before(&now, &(w->resend_time))){
+                f = w;
+                break;
+            }
+            if (!wake_set || timespec_before(&(w->resend_time), &wake)){
+                wake = w->resend_time;
+                wake_set = true;
+            }
+        }
+        //Otherwise send the next queued frame
+        if (f == NULL && tx->send_seq != tx->next_seq){
+            f = &(tx->window[tx->send_seq % LINK_MAX_WINDOW]);
+            tx->send_seq++;
+        }
+
+        if (f == NULL){
+            //Wait for a frame to be queued, or for the next ack timeout
+            if (wake_set){
+                status = pthread_cond_timedwait(&(tx->work_cond), &(tx->window_lock),
+                                                &wake);
+                if (status == ETIMEDOUT){
+                    status = 0;
                 }
+            }else{
+                DEBUG_MSG("[LINK] TX: Waiting for frames to be queued\n");
+                status = pthread_cond_wait(&(tx->work_cond), &(tx->window_lock));
             }
-            //Unlock mutex
-            status = pthread_mutex_unlock(&(link->tx->data_buf_status_lock));
             if (status != 0){
-                fprintf(stderr, "[LINK] transmit_frames(): Mutex unlock failed: %s\n",
-                        strerror(status));
-                failed = true;
-            }
-            //Stop thread if stop variable is true, or something with pthreads went wrong
-            if (link->tx->stop || failed){
-                link->tx->data_buf_filled = false;
+                fprintf(stderr, "[LINK] transmit_frames(): "
+                        "Condition wait failed: %s\n", strerror(status));
                 goto out;
             }
-            DEBUG_MSG("[LINK] TX: Frame buffer filled. Sending...\n");
-            //Set frame type
-            link->tx->data_frame_buf.type = DATA_FRAME_CODE;
-            //Set sequence number
-            link->tx->data_frame_buf.seq_num = seq_num;
-            //Copy frame into send buf
-            convert_data_frame_struct_to_buf(&(link->tx->data_frame_buf), data_send_buf);
-            //Calculate the CRC
-            crc_32 = crc32(data_send_buf, DATA_FRAME_LENGTH - sizeof(crc_32));
-            //Copy this CRC to the send buf
-            memcpy(&data_send_buf[DATA_FRAME_LENGTH - sizeof(crc_32)],
-                    &crc_32, sizeof(crc_32));
-            //Mark tx data buffer empty
-            link->tx->data_buf_filled = false;
+            continue;
         }
-        //Transmit the frame
-        status = phy_fill_tx_buf(link->phy, data_send_buf, DATA_FRAME_LENGTH);
+
+        if (f->tries >= LINK_MAX_TRIES){
+            DEBUG_MSG("[LINK] TX: Exceeded max tries (%u) without an ACK for frame"
+                        " %hu. Skipping the window\n", f->tries, f->frame.seq_num);
+            //Give up on everything queued. The receiver learns of this from
+            //the window base of the next frame.
+            tx->base_seq = tx->next_seq;
+            tx->send_seq = tx->next_seq;
+            tx->failed = true;
+            pthread_cond_broadcast(&(tx->window_cond));
+            continue;
+        }
+
+        if (f->tries > 0){
+            DEBUG_MSG("[LINK] TX: Didn't get an ACK for frame %hu (timed out). "
+                        "Resending\n", f->frame.seq_num);
+        }
+        f->frame.window_base = tx->base_seq;
+        //Copy frame into send buf
+        convert_data_frame_struct_to_buf(&(f->frame), data_send_buf);
+        //Calculate the CRC
+        crc_32 = crc32(data_send_buf, DATA_FRAME_LENGTH - sizeof(crc_32));
+        //Copy this CRC to the send buf
+        memcpy(&data_send_buf[DATA_FRAME_LENGTH - sizeof(crc_32)],
+                &crc_32, sizeof(crc_32));
+        f->tries++;
+        status = create_timeout_abs(ACK_TIMEOUT_MS, &(f->resend_time));
         if (status != 0){
-            fprintf(stderr, "[LINK] Couldn't fill phy tx buffer\n");
+            fprintf(stderr, "[LINK] transmit_frames(): Error creating timeout\n");
             goto out;
         }
-        DEBUG_MSG("[LINK] TX: Frame sent to PHY. Waiting for ACK...\n");
-        //Wait for an ack
-        status = receive_ack(link, seq_num, ACK_TIMEOUT_MS);
-        if (status == -2){
-            DEBUG_MSG("[LINK] TX: Didn't get an ACK (timed out). Resending\n");
-            tries++;
-            continue;
-        }else if (status == -3){
-            DEBUG_MSG("[LINK] TX: Received wrong ACK number. Resending\n");
-            tries++;
-            continue;
-        }else if (status < 0){
-            fprintf(stderr, "[LINK] TX: Error receiving ACK. "
-                            "Stopping transmitter\n");
+
+        //Transmit the frame. The window may change while it is unlocked, so 'f'
+        //is not used again below.
+        pthread_mutex_unlock(&(tx->window_lock));
+        status = phy_fill_tx_buf(link->phy, data_send_buf, DATA_FRAME_LENGTH);
+        pthread_mutex_lock(&(tx->window_lock));
+        if (status != 0){
+            fprintf(stderr, "[LINK] Couldn't fill phy tx buffer\n");
             goto out;
         }
-        //Success!
-        DEBUG_MSG("[LINK] TX: Got an ACK\n");
-        link->tx->success = true;
-        link->tx->done = true;
-        tries = 1;
-        seq_num++;
+        DEBUG_MSG("[LINK] TX: Frame sent to PHY\n");
     }
 
     out:
-        link->tx->done = true;
+        //Fail any pending link_send_data() call
+        tx->stop = true;
+        pthread_cond_broadcast(&(tx->window_cond));
+        pthread_mutex_unlock(&(tx->window_lock));
         return NULL;
 }
 
@@ -885,7 +1048,8 @@ int link_receive_data(struct link_handle *link, int size, int max_timeouts,
 }
 
 /**
- * Receives a payload and copies it into the given buffer
+ * Receives a payload and copies it into the given buffer. Payloads are returned
+ * in sequence number order.
  * @param[in]   link            pointer to link handle
  * @param[in]   timeout_ms      Amount of time to wait for a received payload
  * @param[out]  payload         pointer to buffer to place payload in
@@ -895,8 +1059,11 @@ int link_receive_data(struct link_handle *link, int size, int max_timeouts,
  */
 static int receive_payload(struct link_handle *link, uint8_t *payload, unsigned int timeout_ms)
 {
+    struct rx *rx = link->rx;
+    struct data_frame *frame;
     int payload_length = 10;    //must be initialized above 0
     struct timespec timeout_abs;
+    uint16_t skip;
     int status;
 
     //Create absolute time format timeout
@@ -907,16 +1074,28 @@ static int receive_payload(struct link_handle *link, uint8_t *payload, unsigned
     }
 
     //Prepare to wait with pthread_cond_timedwait()
-    status = pthread_mutex_lock(&(link->rx->data_buf_status_lock));
+    status = pthread_mutex_lock(&(rx->data_buf_status_lock));
     if (status != 0){
         fprintf(stderr, "[LINK] RX: receive_payload(): Error locking mutex: %s\n",
                     strerror(status));
         return -1;
     }
-    //Wait for condition signal - meaning rx data buffer is full
-    while (!link->rx->data_buf_filled){
-        status = pthread_cond_timedwait(&(link->rx->data_buf_filled_cond),
-                                    &(link->rx->data_buf_status_lock), &timeout_abs);
+    //Wait for condition signal - meaning the next frame is in the window
+    while (true){
+        //Skip over missing frames which the sender has given up on
+        skip = rx->sender_base - rx->deliver_seq;
+        while (skip > 0 && skip < 0x8000 &&
+                !rx->received[rx->deliver_seq % LINK_MAX_WINDOW]){
+            NOTE("[LINK] RX: Frame %hu was never received. Skipping it.\n",
+                    rx->deliver_seq);
+            rx->deliver_seq++;
+            skip--;
+        }
+        if (rx->synced && rx->received[rx->deliver_seq % LINK_MAX_WINDOW]){
+            break;
+        }
+        status = pthread_cond_timedwait(&(rx->data_buf_filled_cond),
+                                    &(rx->data_buf_status_lock), &timeout_abs);
         if (status != 0){
             if (status == ETIMEDOUT){
                 payload_length = -2;
@@ -928,100 +1107,108 @@ static int receive_payload(struct link_handle *link, uint8_t *payload, unsigned
             break;
         }
     }
+    if (payload_length >= 0){
+        frame = &(rx->window[rx->deliver_seq % LINK_MAX_WINDOW]);
+        //Get the length of the used portion of the payload
+        payload_length = frame->payload_length;
+        //Copy the used portion of the payload
+        memcpy(payload, frame->payload, payload_length);
+        //Free the window slot
+        rx->received[rx->deliver_seq % LINK_MAX_WINDOW] = false;
+        rx->deliver_seq++;
+    }
     //Waiting is done. Unlock mutex.
-    status = pthread_mutex_unlock(&(link->rx->data_buf_status_lock));
+    status = pthread_mutex_unlock(&(rx->data_buf_status_lock));
     if (status != 0){
         fprintf(stderr, "[LINK] RX: receive_payload(): Mutex unlock failed: %s\n",
                 strerror(status));
         payload_length = -1;
     }
-    //Did we error or timeout? Return
-    if (payload_length < 0){
-        return payload_length;
-    }
-
-    //Get the length of the used portion of the payload
-    payload_length = link->rx->data_frame_buf.payload_length;
-    //Copy the used portion of the payload
-    memcpy(payload, link->rx->data_frame_buf.payload, payload_length);
-    //Mark the rx data buffer empty
-    link->rx->data_buf_filled = false;
 
     return payload_length;
 }
 
 /**
- * Attempts to receive an ACK with the given ACK number
- * Waits until it either receives an ack or times out.
+ * Stores a received data frame in the receive window, unless it is a duplicate
+ * or lies beyond the window, and builds the acknowledgement for it. The ack
+ * describes everything held in the window, not just this frame.
  *
  * @param[in]   link        pointer to link handle
- * @param[in]   ack_num     acknowledgement number to look for
- * @param[in]   timeout_ms  amount of time to wait for an ACK, in milliseconds
+ * @param[in]   frame       received data frame
+ * @param[out]  ack         ack frame to send in response
  *
- * @return      0 if successfully received ack, -1 if pthread error or wrong ack number,
- *              -2 if timed out, -3 if wrong ack number
+ * @return      0 on success, -1 on pthread error
  */
-static int receive_ack(struct link_handle *link, uint16_t ack_num, unsigned int timeout_ms)
+static int store_data_frame(struct link_handle *link, struct data_frame *frame,
+                            struct ack_frame *ack)
 {
-    struct timespec timeout_abs;
-    int status, ret = 0;
+    struct rx *rx = link->rx;
+    uint16_t offset, seq;
+    unsigned int i;
+    int status;
 
-    //Create absolute time format timeout
-    status = create_timeout_abs(timeout_ms, &timeout_abs);
+    status = pthread_mutex_lock(&(rx->data_buf_status_lock));
     if (status != 0){
-        fprintf(stderr, "[LINK] RX: receive_ack(): Error creating timeout\n");
+        fprintf(stderr, "[LINK] RX: receive_frames(): Error locking pthread_mutex\n");
         return -1;
     }
 
-    //Prepare to wait with pthread_cond_timedwait()
-    status = pthread_mutex_lock(&(link->rx->ack_buf_status_lock));
-    if (status != 0){
-        fprintf(stderr, "[LINK] RX: receive_ack(): Error locking mutex: %s\n",
-                    strerror(status));
-        return -1;
+    //The first frame received tells us where the sender's window starts
+    if (!rx->synced){
+        rx->deliver_seq = frame->window_base;
+        rx->sender_base = frame->window_base;
+        rx->synced = true;
+    }else if ((uint16_t) (frame->window_base - rx->sender_base) < 0x8000){
+        rx->sender_base = frame->window_base;
     }
-    //Wait for condition signal - meaning buffer is full
-    while (!link->rx->ack_buf_filled){
-        status = pthread_cond_timedwait(&(link->rx->ack_buf_filled_cond),
-                                    &(link->rx->ack_buf_status_lock), &timeout_abs);
+
+    offset = frame->seq_num - rx->deliver_seq;
+    if (offset >= rx->window_size){
+        //Either already returned to the user, or too far ahead to hold
+        DEBUG_MSG("[LINK] RX: Frame %hu is outside the window. Not storing it.\n",
+                    frame->seq_num);
+    }else if (rx->received[frame->seq_num % LINK_MAX_WINDOW]){
+        DEBUG_MSG("[LINK] RX: Received a duplicate frame.\n");
+    }else{
+        rx->window[frame->seq_num % LINK_MAX_WINDOW] = *frame;
+        rx->received[frame->seq_num % LINK_MAX_WINDOW] = true;
+        //Signal that a frame was added to the window
+        status = pthread_cond_signal(&(rx->data_buf_filled_cond));
         if (status != 0){
-            if (status == ETIMEDOUT){
-                ret = -2;
-            }else{
-                fprintf(stderr, "[LINK] RX: receive_ack(): Condition wait failed: %s\n",
-                    strerror(status));
-                ret = -1;
-            }
-            break;
+            fprintf(stderr, "[LINK] RX: receive_frames(): "
+                            "Error signaling pthread_cond\n");
         }
     }
-    //Waiting is done. Unlock mutex.
-    status = pthread_mutex_unlock(&(link->rx->ack_buf_status_lock));
-    if (status != 0){
-        fprintf(stderr, "[LINK] RX: receive_ack(): Mutex unlock failed: %s\n",
-                strerror(status));
-        ret = -1;
+
+    //Acknowledge the in-order run of frames held in the window...
+    memset(ack, 0, sizeof(*ack));
+    ack->type = ACK_FRAME_CODE;
+    ack->ack_num = rx->deliver_seq;
+    while ((uint16_t) (ack->ack_num - rx->deliver_seq) < rx->window_size &&
+            rx->received[ack->ack_num % LINK_MAX_WINDOW]){
+        ack->ack_num++;
     }
-    //Check the sequence number if nothing failed
-    if (ret == 0 && link->rx->ack_frame_buf.ack_num != ack_num){
-        fprintf(stderr, "[LINK] RX: receive_ack(): Incorrect ack number %hu "
-                    "(expected %hu)\n", link->rx->ack_frame_buf.ack_num, ack_num);
-        ret = -3;
+    //...and any frames after the first missing one
+    for (i = 0; i < 32; i++){
+        seq = ack->ack_num + 1 + i;
+        if ((uint16_t) (seq - rx->deliver_seq) < rx->window_size &&
+                rx->received[seq % LINK_MAX_WINDOW]){
+            ack->sack |= 1u << i;
+        }
     }
-    //mark the rx ack buffer empty
-    link->rx->ack_buf_filled = false;
 
-    return ret;
+    pthread_mutex_unlock(&(rx->data_buf_status_lock));
+    return status == 0 ? 0 : -1;
 }
 
 /**
  * Thread function which receives data and ACK frames from the PHY, and transmits ACKs.
  * Checks CRC on all received frames before copying them to a buffer which other
  * functions can use. If the CRC is incorrect, it disregards the frame and does not
- * copy it. If a data frame is received, it checks sequence number for duplicate.
- * If not a duplicate, it copies the frame to rx data_frame_buf and marks the buffer
- * full. An acknowledgement is always sent, regardless of whether or not the received
- * data frame is a duplicate. This is the only function that sends acks.
+ * copy it. If a data frame is received, it is stored in the receive window unless
+ * it is a duplicate. An acknowledgement is always sent, regardless of whether or
+ * not the received data frame is a duplicate. This is the only function that sends
+ * acks. Received acks are applied to the transmit window.
  *
  * @param[in]   arg     pointer to link handle
  */
@@ -1033,9 +1220,8 @@ void *receive_frames(void *arg)
     bool is_data_frame = false;
     int status;
     uint8_t ack_send_buf[ACK_FRAME_LENGTH];
-    uint16_t seq_num = 0;
-    bool first_frame = true;
-    bool duplicate;
+    struct data_frame data_frame;
+    struct ack_frame ack_frame = {0};
 
     //cast arg
     struct link_handle *link = (struct link_handle *) arg;
@@ -1088,87 +1274,33 @@ void *receive_frames(void *arg)
                 }
                 break;
             case COPY:
-                //--CRC passed. Now copy the frame to link layer buffer
-                //--if it is not a duplicate frame
+                //--CRC passed. Now copy the frame into the receive window, or
+                //--apply the ack to the transmit window
                 DEBUG_MSG("[LINK] RX: State = COPY\n");
                 if (is_data_frame){
-                    //Is the previous data frame still being worked with?
-                    if (link->rx->data_buf_filled){
-                        //Instead of causing a disruption, drop the current frame
-                        fprintf(stderr, "[LINK] RX: Data frame dropped!\n");
-                        phy_release_rx_buf(link->phy);
-                        break;
-                    }
                     //Copy/convert to data frame struct
-                    convert_buf_to_data_frame_struct(rx_buf,
-                                                &(link->rx->data_frame_buf));
+                    convert_buf_to_data_frame_struct(rx_buf, &data_frame);
                     //Release buffer from the phy
                     phy_release_rx_buf(link->phy);
-                    //Is this frame a duplicate of the last frame?
-                    if (link->rx->data_frame_buf.seq_num == seq_num && !first_frame){
-                        DEBUG_MSG("[LINK] RX: Received a duplicate frame.\n");
-                        duplicate = true;
-                    }else{
-                        duplicate = false;
-                    }
-                    seq_num = link->rx->data_frame_buf.seq_num;
-                    first_frame = false;
-                    //Mark buffer filled if not a duplicate data frame
-                    if (!duplicate){
-                        //Signal that the link data buffer is filled
-                        link->rx->data_buf_filled = true;
-                        status = pthread_mutex_lock(&(link->rx->data_buf_status_lock));
-                        if (status != 0){
-                            fprintf(stderr, "[LINK] RX: receive_frames(): "
-                                            "Error locking pthread_mutex\n");
-                            return NULL;
-                        }
-                        status = pthread_cond_signal(&(link->rx->data_buf_filled_cond));
-                        if (status != 0){
-                            fprintf(stderr, "[LINK] RX: receive_frames(): "
-                                            "Error signaling pthread_cond\n");
-                            return NULL;
-                        }
-                        status = pthread_mutex_unlock(&(link->rx->data_buf_status_lock));
-                        if (status != 0){
-                            fprintf(stderr, "[LINK] RX: receive_frames(): "
-                                            "Error unlocking pthread_mutex\n");
-                            return NULL;
-                        }
+                    //Store it, and build the ack in response
+                    status = store_data_frame(link, &data_frame, &ack_frame);
+                    if (status != 0){
+                        return NULL;
                     }
-                    //Transition to send acknowledgement
-                    state = SEND_ACK;
+                    //Transition to send acknowledgement, unless the link
+                    //only receives
+                    state = (link->tx != NULL) ? SEND_ACK : WAIT;
                 }else{
-                    //Is the previous ack frame still being worked with?
-                    if (link->rx->ack_buf_filled){
-                        //Instead of causing a disruption, drop the current frame
-                        fprintf(stderr, "[LINK] RX: ACK frame dropped!\n");
-                        phy_release_rx_buf(link->phy);
-                        break;
-                    }
-                    //Copy/convert to ack frame struct and mark ack buffer filled
-                    convert_buf_to_ack_frame_struct(rx_buf, &(link->rx->ack_frame_buf));
+                    //Copy/convert to ack frame struct
+                    convert_buf_to_ack_frame_struct(rx_buf, &ack_frame);
                     //Release buffer from the phy
                     phy_release_rx_buf(link->phy);
-                    //Signal that the link ack buffer is filled
-                    link->rx->ack_buf_filled = true;
-                    status = pthread_mutex_lock(&(link->rx->ack_buf_status_lock));
-                    if (status != 0){
-                        fprintf(stderr, "[LINK] RX: receive_frames(): "
-                                        "Error locking pthread_mutex\n");
-                        return NULL;
-                    }
-                    status = pthread_cond_signal(&(link->rx->ack_buf_filled_cond));
-                    if (status != 0){
-                        fprintf(stderr, "[LINK] RX: receive_frames(): "
-                                        "Error signaling pthread_cond\n");
-                        return NULL;
-                    }
-                    status = pthread_mutex_unlock(&(link->rx->ack_buf_status_lock));
-                    if (status != 0){
-                        fprintf(stderr, "[LINK] RX: receive_frames(): "
-                                        "Error unlocking pthread_mutex\n");
-                        return NULL;
+                    //A receive-only link overhears acks meant for others
+                    if (link->tx != NULL){
+                        status = process_ack(link, &ack_frame);
+                        if (status != 0){
+                            return NULL;
+                        }
                     }
                     //Done with the frame. Go back to WAIT state
                     state = WAIT;
@@ -1176,14 +1308,11 @@ void *receive_frames(void *arg)
                 break;
             case SEND_ACK:
                 //--We received a data frame, now it's time to send the ack
-                DEBUG_MSG("[LINK] RX: State = SEND_ACK (ack# = %hu)\n", seq_num);
-
-                link->tx->ack_frame_buf.type = 0xFF;
-                link->tx->ack_frame_buf.ack_num = seq_num;
+                DEBUG_MSG("[LINK] RX: State = SEND_ACK (ack# = %hu, sack = 0x%.8X)\n",
+                            ack_frame.ack_num, ack_frame.sack);
 
                 //Copy frame into send buf
-                convert_ack_frame_struct_to_buf(&(link->tx->ack_frame_buf),
-                                                ack_send_buf);
+                convert_ack_frame_struct_to_buf(&ack_frame, ack_send_buf);
                 //Calculate the CRC
                 crc_32 = crc32(ack_send_buf, ACK_FRAME_LENGTH - sizeof(crc_32));
                 //Copy this CRC to the send buf
@@ -40,19 +40,25 @@
 #include "host_config.h"
 
 #include "common.h"
+#include "channelizer.h"
 
 #define PAYLOAD_LENGTH 1000     //If you change this, DATA_FRAME_LENGTH
                                 //ACK_FRAME_LENGTH must also be changed in phy.h
 #define ACK_TIMEOUT_MS 500      //Timeout to wait for an acknowledgement
 #define LINK_MAX_TRIES 3        //Maximum number of frame retransmissions before the
                                 //transmitter gives up
+#define LINK_WINDOW_DEFAULT 8   //Default number of unacknowledged frames in flight
+#define LINK_MAX_WINDOW 32      //Maximum window size. Must be a power of two no
+                                //larger than the 32 bits of selective acks.
 
 /** Opaque handle to link data structure */
 struct link_handle;
 
 /**
- * Send data of arbitrary length. Breaks data up into packets (if needed) and sends each
- * packet one-by-one.
+ * Send data of arbitrary length. Breaks data up into packets (if needed) and sends
+ * them with a selective-repeat sliding window: up to radio_params.link_window packets
+ * may be awaiting acknowledgement at once, and only packets which go unacknowledged
+ * are resent. Blocks until every packet has been acknowledged.
  *
  * @param[in]   link            pointer to link handle
  * @param[in]   data            Data to send
@@ -89,6 +95,22 @@ int link_receive_data(struct link_handle *link, int size, int max_timeouts,
  */
 struct link_handle *link_init(struct bladerf *dev, struct radio_params *params);
 
+/**
+ * Initializes/allocates a receive-only link handle for one of a channelizer's
+ * channels, and starts its threads. The link delivers the data frames it
+ * overhears on the channel with link_receive_data(), but sends nothing,
+ * including acknowledgements. Frames the channel's own receiver acknowledged,
+ * but this link missed, are skipped once the sender moves past them.
+ *
+ * @param[in]   chan        pointer to channelizer, which must outlive the link
+ * @param[in]   channel     channel to receive, from 0
+ * @param[in]   params      radio parameters. Only link_window is used.
+ *
+ * @return      pointer to allocated link_handle struct on success, NULL on error
+ */
+struct link_handle *link_init_channel(struct channelizer *chan, unsigned int channel,
+                                        struct radio_params *params);
+
 /**
  * Deinitializes/closes/frees a link_handle struct. Does nothing if link is NULL
  *
@@ -40,6 +40,7 @@
 #include "correlator.h"
 #include "fsk.h"            //modulator/demodulator
 #include "radio_config.h"    //bladeRF configuration
+#include "thread.h"
 
 #ifdef DEBUG_MODE
     #define DEBUG_MSG(...) fprintf(stderr, __VA_ARGS__)
@@ -56,35 +57,95 @@
     #define NOTE(...)
 #endif
 
+//Number of times a receiver thread polls for a block before sleeping
+#define RX_WAIT_SPINS 1000
+//How far ahead of the device's TX timestamp a burst is scheduled when the
+//transmitter is idle: long enough for its first samples to reach the FPGA
+//(5 ms)
+#define TX_SCHEDULE_LEAD (BLADERF_SAMPLE_RATE / 200)
+//Samples left between consecutive bursts. libbladeRF zero pads a burst to the
+//end of its last metadata message, so this must be at least a message long.
+#define TX_BURST_GAP 512
+
+/* With the FPGA modem, packet payloads follow the 16-byte metadata header,
+ * and begin with a little-endian uint32_t count:
+ *  TX: the number of frame bytes that follow. The modulator sends them MSB
+ *      first, ramping up before the first and down after the last.
+ *  RX: the number of symbols that follow, as the demodulator's hard
+ *      decisions packed MSB first.
+ * libbladeRF addresses all of its packets to core 0, the FSK modem. */
+#define PACKET_COUNT_SIZE 4
+#define PACKET_PAYLOAD_SIZE (PACKET_BUFFER_SIZE * 4 - 16)
+//Timeout for packets from the modem, which only sends them while it has
+//symbols to report. This bounds how long the receiver takes to stop.
+#define PACKET_RX_TIMEOUT_MS 250
+//Number of preamble bits that may be in error when searching the
+//demodulated symbols for the start of a frame
+#define PREAMBLE_MAX_BIT_ERRORS 2
+
 //Internal structs
+
+//A block of NUM_SAMPLES_RX samples passed along the receive pipeline
+struct rx_block {
+    int16_t *in_samples;                //Raw input samples from device
+    struct complex_sample *samples;     //Filtered, power normalized samples
+    bool discontinuity;                 //Samples were lost before this block
+};
+
+/* The receiver is a pipeline of three threads: acquisition, filtering, and
+ * demodulation. Each owns its own stage of the blocks[] ring, and counts the
+ * blocks it has passed on to the next stage. A counter is only ever written
+ * by its own stage, so the ring needs no lock. Block n lives in
+ * blocks[n % RX_PIPELINE_DEPTH]. */
 struct rx {
-    int16_t *in_samples;        //Raw input samples from device
+    struct rx_block blocks[RX_PIPELINE_DEPTH];
+    unsigned int num_acquired;  //Blocks received from the device
+    unsigned int num_filtered;  //Blocks filtered and power normalized
+    unsigned int num_consumed;  //Blocks the demodulator is done with
+    int16_t *drop_samples;      //Samples received while the pipeline is full
     struct fir_filter *ch_filt;             //Channel filter
     struct pnorm_state_t *pnorm;            //Power normalizer
     struct correlator *corr;                //Correlator
     struct complex_sample *filt_samples;    //Filtered input samples
-    struct complex_sample *pnorm_samples;    //power normalized samples
     uint8_t *data_buf;            //received data output buffer (no training seq/preamble)
     bool buf_filled;            //is the rx data buffer filled
     bool stop;                    //control variable to stop the receiver
-    pthread_t thread;            //pthread for the receiver
+    pthread_t acquire_thread;    //pthread receiving samples from the device
+    pthread_t filter_thread;     //pthread filtering/power normalizing samples
+    pthread_t thread;            //pthread for the receiver (demodulation)
     pthread_cond_t buf_filled_cond;        //condition variable for buf_filled
     pthread_mutex_t buf_status_lock;    //mutex variable for accessing buf_filled
 };
+//A modulated frame, ready to be sent
+struct tx_burst {
+    int16_t *samples;                   //Samples, or a packet for the FPGA modem
+    unsigned int num_samples;           //Samples (or packet DWORDs) to send
+};
+
+/* The transmitter is a pipeline of two threads: the modulator, and the sender.
+ * As with the receiver, each stage counts the bursts it has passed on, and
+ * burst n lives in bursts[n % TX_PIPELINE_DEPTH]. */
 struct tx {
     uint8_t *data_buf;            //input data to transmit (including training seq/preamble)
     unsigned int data_length;    //length of data to transmit (not including preamble)
     bool buf_filled;
     bool stop;
-    pthread_t thread;
+    pthread_t thread;            //pthread modulating frames
+    pthread_t send_thread;       //pthread sending modulated bursts to the device
     pthread_cond_t buf_filled_cond;
     pthread_mutex_t buf_status_lock;
     unsigned int max_num_samples;        //Maximum number of tx samples to transmit
-    struct complex_sample *samples;        //output samples to transmit
+    struct complex_sample *samples;        //modulator output, before conversion
+    struct tx_burst bursts[TX_PIPELINE_DEPTH];
+    unsigned int num_modulated;  //Bursts modulated
+    unsigned int num_sent;       //Bursts sent to the device
 };
 
 struct phy_handle {
     struct bladerf *dev;        //bladeRF device handle
+    struct channelizer *chan;   //channelizer feeding a receive-only handle, or NULL
+    unsigned int chan_index;    //channel of chan received
+    bool fpga_modem;            //the FPGA's FSK modem is used instead of fsk
     struct fsk_handle *fsk;        //fsk handle
     struct tx *tx;                //tx data structure
     struct rx *rx;                //rx data structure
@@ -93,11 +154,22 @@ struct phy_handle {
 
 //Internal functions
 void *phy_receive_frames(void *arg);
+static void *phy_acquire_samples(void *arg);
+static void *phy_acquire_channel(void *arg);
+static void *phy_filter_samples(void *arg);
+static void *phy_receive_packets(void *arg);
 void *phy_transmit_frames(void *arg);
+static void *phy_send_bursts(void *arg);
+static unsigned int fill_tx_packet(const uint8_t *data, unsigned int length,
+                                    uint8_t *payload);
+static int frame_type_length(struct phy_handle *phy, uint8_t first_byte);
+static int deliver_rx_frame(struct phy_handle *phy, uint8_t *frame, int frame_length);
 static void scramble_frame(uint8_t *frame, int frame_length, uint8_t *scrambling_sequence);
 static void unscramble_frame(uint8_t *frame, int frame_length, uint8_t *scrambling_sequence);
 static void create_ramps(unsigned int ramp_length, struct complex_sample ramp_down_init,
                     struct complex_sample *ramp_up, struct complex_sample *ramp_down);
+static struct phy_handle *phy_open(struct bladerf *dev, struct radio_params *params,
+                    struct channelizer *chan, unsigned int channel);
 
 /****************************************
  *                                      *
@@ -106,8 +178,34 @@ static void create_ramps(unsigned int ramp_length, struct complex_sample ramp_do
  ****************************************/
 
 struct phy_handle *phy_init(struct bladerf *dev, struct radio_params *params)
+{
+    return phy_open(dev, params, NULL, 0);
+}
+
+struct phy_handle *phy_init_channel(struct channelizer *chan, unsigned int channel)
+{
+    //Channels are demodulated by the host, and have no transmitter to set up
+    struct radio_params params;
+
+    memset(&params, 0, sizeof(params));
+    return phy_open(NULL, &params, chan, channel);
+}
+
+/**
+ * Allocates and initializes a phy_handle for phy_init() or phy_init_channel()
+ *
+ * @param[in]   dev         bladeRF device handle, or NULL if chan is used
+ * @param[in]   params      radio parameters
+ * @param[in]   chan        channelizer to receive from, or NULL to use dev
+ * @param[in]   channel     channel of chan to receive
+ *
+ * @return      allocated phy_handle on success, NULL on failure
+ */
+static struct phy_handle *phy_open(struct bladerf *dev, struct radio_params *params,
+                    struct channelizer *chan, unsigned int channel)
 {
     int status;
+    unsigned int i;
     struct phy_handle *phy;
     uint64_t prng_seed;
     uint8_t preamble[PREAMBLE_LENGTH] = PREAMBLE;
@@ -122,64 +220,93 @@ struct phy_handle *phy_init(struct bladerf *dev, struct radio_params *params)
 
     DEBUG_MSG("[PHY] Initializing...\n");
 
-    if (dev == NULL){
-        fprintf(stderr, "[PHY] %s: BladeRF device uninitialized", __FUNCTION__);
-    }
     phy->dev = dev;
+    phy->chan = chan;
+    phy->chan_index = channel;
+    phy->fpga_modem = params->fpga_modem;
 
     //--------Initialize and configure bladeRF device-------------
-    status = radio_init_and_configure(phy->dev, params);
-    if (status != 0){
-        fprintf(stderr, "[PHY] %s: Couldn't configure bladeRF\n", __FUNCTION__);
-        goto error;
+    //The channelizer owns the device when one is used
+    if (chan == NULL){
+        if (dev == NULL){
+            fprintf(stderr, "[PHY] %s: BladeRF device uninitialized", __FUNCTION__);
+        }
+        status = radio_init_and_configure(phy->dev, params);
+        if (status != 0){
+            fprintf(stderr, "[PHY] %s: Couldn't configure bladeRF\n", __FUNCTION__);
+            goto error;
+        }
+        DEBUG_MSG("[PHY] BladeRF initialized and configured successfully\n");
     }
-    DEBUG_MSG("[PHY] BladeRF initialized and configured successfully\n");
 
     //-------------------Open fsk handle------------------------
-    phy->fsk = fsk_init();
-    if(phy->fsk == NULL){
-        fprintf(stderr, "[PHY] %s: Couldn't open fsk handle\n", __FUNCTION__);
-        goto error;
+    //Not needed when the FPGA modulates and demodulates
+    if (!phy->fpga_modem){
+        phy->fsk = fsk_init();
+        if(phy->fsk == NULL){
+            fprintf(stderr, "[PHY] %s: Couldn't open fsk handle\n", __FUNCTION__);
+            goto error;
+        }
+        DEBUG_MSG("[PHY] FSK Initialized\n");
+    }else{
+        DEBUG_MSG("[PHY] Using the FPGA FSK modem\n");
     }
-    DEBUG_MSG("[PHY] FSK Initialized\n");
 
     //------------------Initialize TX struct--------------------
-    phy->tx = calloc(1, sizeof(struct tx));
-    if (phy->tx == NULL){
-        perror("[PHY] malloc");
-        goto error;
-    }
-    //Allocate memory for tx data buffer
-    phy->tx->data_buf = malloc(TRAINING_SEQ_LENGTH + PREAMBLE_LENGTH +
-                                MAX_LINK_FRAME_SIZE);
-    if (phy->tx->data_buf == NULL){
-        perror("[PHY] malloc");
-        goto error;
-    }
-    //Allocate memory for tx samples buffer
-    //2*RAMP_LENGTH for the ramp up/ramp down
-    phy->tx->max_num_samples = 2*RAMP_LENGTH + (TRAINING_SEQ_LENGTH + PREAMBLE_LENGTH +
-                    MAX_LINK_FRAME_SIZE) * 8 * SAMP_PER_SYMB;
-    phy->tx->samples = malloc(phy->tx->max_num_samples * sizeof(struct complex_sample));
-    if (phy->tx->samples == NULL){
-        perror("[PHY] malloc");
-        goto error;
-    }
-    //Initialize control variables
-    phy->tx->data_length = 0;
-    phy->tx->buf_filled = false;
-    phy->tx->stop = false;
-    //Initialize pthread condition variable for buf_filled
-    status = pthread_cond_init(&(phy->tx->buf_filled_cond), NULL);
-    if (status != 0){
-        fprintf(stderr, "[PHY] %s: Error initializing pthread_cond\n", __FUNCTION__);
-        goto error;
-    }
-    //Initialize pthread mutex variable for buf_filled
-    status = pthread_mutex_init(&(phy->tx->buf_status_lock), NULL);
-    if (status != 0){
-        fprintf(stderr, "[PHY] %s: Error initializing pthread_mutex\n", __FUNCTION__);
-        goto error;
+    //A channel's handle only receives
+    if (chan == NULL){
+        phy->tx = calloc(1, sizeof(struct tx));
+        if (phy->tx == NULL){
+            perror("[PHY] malloc");
+            goto error;
+        }
+        //Allocate memory for tx data buffer
+        phy->tx->data_buf = malloc(TRAINING_SEQ_LENGTH + PREAMBLE_LENGTH +
+                                    MAX_LINK_FRAME_SIZE);
+        if (phy->tx->data_buf == NULL){
+            perror("[PHY] malloc");
+            goto error;
+        }
+        //Allocate memory for tx samples buffer
+        //2*RAMP_LENGTH for the ramp up/ramp down
+        phy->tx->max_num_samples = 2*RAMP_LENGTH + (TRAINING_SEQ_LENGTH + PREAMBLE_LENGTH +
+                        MAX_LINK_FRAME_SIZE) * 8 * SAMP_PER_SYMB;
+        if (!phy->fpga_modem){
+            phy->tx->samples = malloc(phy->tx->max_num_samples * sizeof(struct complex_sample));
+            if (phy->tx->samples == NULL){
+                perror("[PHY] malloc");
+                goto error;
+            }
+        }
+        //Allocate memory for the modulated bursts
+        for (i = 0; i < TX_PIPELINE_DEPTH; i++){
+            if (phy->fpga_modem){
+                phy->tx->bursts[i].samples = malloc(PACKET_PAYLOAD_SIZE);
+            }else{
+                phy->tx->bursts[i].samples = malloc(phy->tx->max_num_samples * 2 *
+                                                    sizeof(int16_t));
+            }
+            if (phy->tx->bursts[i].samples == NULL){
+                perror("[PHY] malloc");
+                goto error;
+            }
+        }
+        //Initialize control variables
+        phy->tx->data_length = 0;
+        phy->tx->buf_filled = false;
+        phy->tx->stop = false;
+        //Initialize pthread condition variable for buf_filled
+        status = pthread_cond_init(&(phy->tx->buf_filled_cond), NULL);
+        if (status != 0){
+            fprintf(stderr, "[PHY] %s: Error initializing pthread_cond\n", __FUNCTION__);
+            goto error;
+        }
+        //Initialize pthread mutex variable for buf_filled
+        status = pthread_mutex_init(&(phy->tx->buf_status_lock), NULL);
+        if (status != 0){
+            fprintf(stderr, "[PHY] %s: Error initializing pthread_mutex\n", __FUNCTION__);
+            goto error;
+        }
     }
 
     //------------------Initialize RX struct------------------
@@ -194,47 +321,54 @@ struct phy_handle *phy_init(struct bladerf *dev, struct radio_params *params)
         perror("[PHY] malloc");
         goto error;
     }
-    //Allocate memory for rx samples buffer
-    phy->rx->in_samples = malloc(NUM_SAMPLES_RX * 2 * sizeof(phy->rx->in_samples[0]));
-    if (phy->rx->in_samples == NULL){
-        perror("[PHY] malloc");
-        goto error;
-    }
-
-    // Allocate memory for filtered RX samples
-    phy->rx->filt_samples = malloc(NUM_SAMPLES_RX * sizeof(struct complex_sample));
-    if (phy->rx->filt_samples == NULL){
-        perror("[PHY] malloc");
-        goto error;
-    }
+    //Allocate the receive pipeline and its DSP, unless the FPGA demodulates
+    if (!phy->fpga_modem){
+        //Allocate memory for the receive pipeline's sample blocks
+        for (i = 0; i < RX_PIPELINE_DEPTH; i++){
+            struct rx_block *block = &phy->rx->blocks[i];
+
+            block->in_samples = malloc(NUM_SAMPLES_RX * 2 * sizeof(block->in_samples[0]));
+            block->samples = malloc(NUM_SAMPLES_RX * sizeof(struct complex_sample));
+            if (block->in_samples == NULL || block->samples == NULL){
+                perror("[PHY] malloc");
+                goto error;
+            }
+        }
+        phy->rx->drop_samples = malloc(NUM_SAMPLES_RX * 2 * sizeof(phy->rx->drop_samples[0]));
+        if (phy->rx->drop_samples == NULL){
+            perror("[PHY] malloc");
+            goto error;
+        }
 
-    //Allocate memory for power normalized samples
-    phy->rx->pnorm_samples = malloc(NUM_SAMPLES_RX * sizeof(struct complex_sample));
-    if (phy->rx->pnorm_samples == NULL){
-        perror("[PHY] malloc");
-        goto error;
-    }
+        // Allocate memory for filtered RX samples
+        phy->rx->filt_samples = malloc(NUM_SAMPLES_RX * sizeof(struct complex_sample));
+        if (phy->rx->filt_samples == NULL){
+            perror("[PHY] malloc");
+            goto error;
+        }
 
-    // Create RX Channel Filter
-    phy->rx->ch_filt = fir_init(rx_ch_filter, rx_ch_filter_len);
-    if (phy->rx->ch_filt == NULL) {
-        fprintf(stderr, "[PHY] %s: Failed to create channel filter.\n", __FUNCTION__);
-        goto error;
-    }
+        // Create RX Channel Filter
+        phy->rx->ch_filt = fir_init(rx_ch_filter, rx_ch_filter_len);
+        if (phy->rx->ch_filt == NULL) {
+            fprintf(stderr, "[PHY] %s: Failed to create channel filter.\n", __FUNCTION__);
+            goto error;
+        }
 
-    // Create power normalizer
-    phy->rx->pnorm = pnorm_init(0.95f, 0.1f, 20.0f);
-    if (phy->rx->pnorm == NULL){
-        fprintf(stderr, "[PHY] %s: Couldn't initialize power normalizer\n",
-                __FUNCTION__);
-        goto error;
-    }
+        // Create power normalizer
+        phy->rx->pnorm = pnorm_init(0.95f, 0.1f, 20.0f);
+        if (phy->rx->pnorm == NULL){
+            fprintf(stderr, "[PHY] %s: Couldn't initialize power normalizer\n",
+                    __FUNCTION__);
+            goto error;
+        }
 
-    //Create RX correlator
-    phy->rx->corr = corr_init(preamble, 8*PREAMBLE_LENGTH, SAMP_PER_SYMB);
-    if (phy->rx->corr == NULL){
-        fprintf(stderr, "[PHY] %s: Couldn't initialize correlator\n", __FUNCTION__);
-        goto error;
+        //Create RX correlator
+        phy->rx->corr = corr_init(preamble, 8*PREAMBLE_LENGTH, SAMP_PER_SYMB,
+                                  CORR_MODE_EARLY_EXIT);
+        if (phy->rx->corr == NULL){
+            fprintf(stderr, "[PHY] %s: Couldn't initialize correlator\n", __FUNCTION__);
+            goto error;
+        }
     }
 
     //Initialize control variables
@@ -283,6 +417,7 @@ struct phy_handle *phy_init(struct bladerf *dev, struct radio_params *params)
 void phy_close(struct phy_handle *phy)
 {
     int status;
+    unsigned int i;
 
     DEBUG_MSG("[PHY] Closing\n");
     if (phy != NULL){
@@ -296,6 +431,9 @@ void phy_close(struct phy_handle *phy)
         if (phy->tx != NULL){
             free(phy->tx->data_buf);
             free(phy->tx->samples);
+            for (i = 0; i < TX_PIPELINE_DEPTH; i++){
+                free(phy->tx->bursts[i].samples);
+            }
             status = pthread_mutex_destroy(&(phy->tx->buf_status_lock));
             if (status != 0){
                 fprintf(stderr, "[PHY] %s: Error destroying pthread_mutex\n",
@@ -314,9 +452,12 @@ void phy_close(struct phy_handle *phy)
             fir_deinit(phy->rx->ch_filt);
             corr_deinit(phy->rx->corr);
             pnorm_deinit(phy->rx->pnorm);
-            free(phy->rx->in_samples);
+            for (i = 0; i < RX_PIPELINE_DEPTH; i++){
+                free(phy->rx->blocks[i].in_samples);
+                free(phy->rx->blocks[i].samples);
+            }
+            free(phy->rx->drop_samples);
             free(phy->rx->filt_samples);
-            free(phy->rx->pnorm_samples);
             status = pthread_mutex_destroy(&(phy->rx->buf_status_lock));
             if (status != 0){
                 fprintf(stderr, "[PHY] %s: Error destroying pthread_mutex\n",
@@ -345,13 +486,30 @@ int phy_start_transmitter(struct phy_handle *phy)
 {
     int status;
 
+    if (phy->tx == NULL){
+        fprintf(stderr, "[PHY] %s: This PHY only receives\n", __FUNCTION__);
+        return -1;
+    }
+
     //turn off stop signal
     phy->tx->stop = false;
-    //Kick off frame transmitter thread
+    //Empty the pipeline
+    phy->tx->num_modulated = 0;
+    phy->tx->num_sent = 0;
+
+    //Kick off the sender thread, then the modulator feeding it
+    status = pthread_create(&(phy->tx->send_thread), NULL, phy_send_bursts, phy);
+    if (status != 0){
+        fprintf(stderr, "[PHY] %s: Error creating tx send thread: %s\n",
+                __FUNCTION__, strerror(status));
+        return -1;
+    }
     status = pthread_create(&(phy->tx->thread), NULL, phy_transmit_frames, phy);
     if (status != 0){
         fprintf(stderr, "[PHY] %s: Error creating tx thread: %s\n", __FUNCTION__,
                 strerror(status));
+        phy->tx->stop = true;
+        pthread_join(phy->tx->send_thread, NULL);
         return -1;
     }
     return 0;
@@ -360,6 +518,7 @@ int phy_start_transmitter(struct phy_handle *phy)
 int phy_stop_transmitter(struct phy_handle *phy)
 {
     int status;
+    int ret = 0;
 
     DEBUG_MSG("[PHY] TX: Stopping transmitter...\n");
     //signal stop
@@ -378,15 +537,21 @@ int phy_stop_transmitter(struct phy_handle *phy)
     if (status != 0){
         fprintf(stderr, "[PHY] %s: Error unlocking pthread_mutex\n", __FUNCTION__);
     }
-    //Wait for tx thread to finish
+    //Wait for tx threads to finish, starting at the head of the pipeline
     status = pthread_join(phy->tx->thread, NULL);
     if (status != 0){
         fprintf(stderr, "[PHY] %s: Error joining tx thread: %s\n", __FUNCTION__,
                 strerror(status));
-        return -1;
+        ret = -1;
+    }
+    status = pthread_join(phy->tx->send_thread, NULL);
+    if (status != 0){
+        fprintf(stderr, "[PHY] %s: Error joining tx send thread: %s\n",
+                __FUNCTION__, strerror(status));
+        ret = -1;
     }
     DEBUG_MSG("[PHY] TX: Transmitter stopped\n");
-    return 0;
+    return ret;
 }
 
 int phy_fill_tx_buf(struct phy_handle *phy, uint8_t *data_buf, unsigned int length)
@@ -437,7 +602,31 @@ int phy_fill_tx_buf(struct phy_handle *phy, uint8_t *data_buf, unsigned int leng
 }
 
 /**
- * Thread function which transmits data frames
+ * Waits for a pipeline counter to reach the given value
+ *
+ * @param[in]   tx          pointer to tx struct
+ * @param[in]   count       counter of the other stage of the pipeline
+ * @param[in]   target      value to wait for
+ *
+ * @return      true once the counter reaches target, false if the transmitter
+ *              was stopped first
+ */
+static bool tx_wait_for_count(struct tx *tx, unsigned int *count, unsigned int target)
+{
+    //Compare as a difference, so that the counters may wrap
+    while ((int) (target - ATOMIC_LOAD(count)) > 0){
+        if (tx->stop){
+            return false;
+        }
+        usleep(50);
+    }
+    return true;
+}
+
+/**
+ * Thread function for the first stage of the transmit pipeline. Modulates each
+ * frame handed over by phy_fill_tx_buf() into a free burst, while the sender
+ * transmits the previous one.
  *
  * @param[in]   arg     pointer to phy handle struct
  */
@@ -446,39 +635,34 @@ void *phy_transmit_frames(void *arg)
     int status;
     //Cast arg
     struct phy_handle *phy = (struct phy_handle *) arg;
+    struct tx *tx = phy->tx;
+    struct tx_burst *burst;
     uint8_t preamble[PREAMBLE_LENGTH] = PREAMBLE;
     uint8_t training_seq[TRAINING_SEQ_LENGTH] = TRAINING_SEQ;
     int ramp_down_index;
     int num_mod_samples, num_samples;
+    unsigned int seq = 0;
     bool failed = false;
-    struct bladerf_metadata metadata;
-    int16_t *out_samples_raw = NULL;
-
-    out_samples_raw = malloc(phy->tx->max_num_samples * 2 * sizeof(int16_t));
-    if (out_samples_raw == NULL){
-        perror("[PHY] malloc");
-        return NULL;
-    }
 
-    //Set field(s) in bladerf metadata struct
-    memset(&metadata, 0, sizeof(metadata));
-    metadata.flags =     BLADERF_META_FLAG_TX_BURST_START |
-                        BLADERF_META_FLAG_TX_NOW |
-                        BLADERF_META_FLAG_TX_BURST_END;
+    while (!tx->stop){
+        //--------Wait for a free burst---------
+        if (!tx_wait_for_count(tx, &tx->num_sent, seq + 1 - TX_PIPELINE_DEPTH)){
+            break;
+        }
+        burst = &tx->bursts[seq % TX_PIPELINE_DEPTH];
 
-    while (!phy->tx->stop){
         //--------Wait for buffer to be filled---------
         //Lock mutex
-        status = pthread_mutex_lock(&(phy->tx->buf_status_lock));
+        status = pthread_mutex_lock(&(tx->buf_status_lock));
         if (status != 0){
             fprintf(stderr, "[PHY] %s: Mutex lock failed: %s\n", __FUNCTION__,
                     strerror(status));
             return NULL;
         }
         //Wait for condition signal - meaning buffer is full
-        while (!phy->tx->buf_filled && !phy->tx->stop){
+        while (!tx->buf_filled && !tx->stop){
             DEBUG_MSG("[PHY] TX: Waiting for buffer to be filled\n");
-            status = pthread_cond_wait(&(phy->tx->buf_filled_cond), &(phy->tx->buf_status_lock));
+            status = pthread_cond_wait(&(tx->buf_filled_cond), &(tx->buf_status_lock));
             if (status != 0){
                 fprintf(stderr, "[PHY] %s: Condition wait failed: %s\n", __FUNCTION__,
                         strerror(status));
@@ -487,58 +671,126 @@ void *phy_transmit_frames(void *arg)
             }
         }
         //Unlock mutex
-        status = pthread_mutex_unlock(&(phy->tx->buf_status_lock));
+        status = pthread_mutex_unlock(&(tx->buf_status_lock));
         if (status != 0){
             fprintf(stderr, "[PHY] %s: Mutex unlock failed: %s\n", __FUNCTION__,
                     strerror(status));
             failed = true;
         }
         //Stop thread if stop variable is true, or something with pthreads went wrong
-        if (phy->tx->stop || failed){
-            phy->tx->buf_filled = false;
+        if (tx->stop || failed){
+            tx->buf_filled = false;
             return NULL;
         }
-        //------------Transmit the frame-------------
-        DEBUG_MSG("[PHY] TX: Buffer filled. Transmitting.\n");
+        //------------Modulate the frame-------------
+        DEBUG_MSG("[PHY] TX: Buffer filled. Modulating.\n");
         //Calculate the number of samples to transmit.
         num_samples = 2*RAMP_LENGTH + (TRAINING_SEQ_LENGTH + PREAMBLE_LENGTH +
-                    phy->tx->data_length) * 8 * SAMP_PER_SYMB;
+                    tx->data_length) * 8 * SAMP_PER_SYMB;
         //Add training sequence to tx data buffer
-        memcpy(phy->tx->data_buf, &training_seq, TRAINING_SEQ_LENGTH);
+        memcpy(tx->data_buf, &training_seq, TRAINING_SEQ_LENGTH);
         //Add preamble to tx data buffer
-        memcpy(&(phy->tx->data_buf[TRAINING_SEQ_LENGTH]), &preamble, PREAMBLE_LENGTH);
+        memcpy(&(tx->data_buf[TRAINING_SEQ_LENGTH]), &preamble, PREAMBLE_LENGTH);
         #ifndef BYPASS_PHY_SCRAMBLING
             //Scramble the frame data (not including the training sequence or preamble)
-            scramble_frame(&(phy->tx->data_buf[TRAINING_SEQ_LENGTH + PREAMBLE_LENGTH]),
-                            phy->tx->data_length, phy->scrambling_sequence);
+            scramble_frame(&(tx->data_buf[TRAINING_SEQ_LENGTH + PREAMBLE_LENGTH]),
+                            tx->data_length, phy->scrambling_sequence);
         #endif
-        //zero the tx samples buffer
-        memset(phy->tx->samples, 0, sizeof(int16_t) * 2 * num_samples);
-        //modulate samples - leave space for ramp up/ramp down in the samples buffer
-        num_mod_samples = fsk_mod(phy->fsk, phy->tx->data_buf,
-                            TRAINING_SEQ_LENGTH + PREAMBLE_LENGTH + phy->tx->data_length,
-                            &(phy->tx->samples[RAMP_LENGTH]));
-        //Mark the buffer empty
-        phy->tx->buf_filled = false;
+        if (phy->fpga_modem){
+            //The FPGA modulates the frame and adds its ramps. The packet
+            //length is in DWORDs rather than samples.
+            num_samples = fill_tx_packet(tx->data_buf,
+                            TRAINING_SEQ_LENGTH + PREAMBLE_LENGTH + tx->data_length,
+                            (uint8_t *) burst->samples);
+            //Mark the buffer empty
+            tx->buf_filled = false;
+        }else{
+            //zero the tx samples buffer
+            memset(tx->samples, 0, sizeof(int16_t) * 2 * num_samples);
+            //modulate samples - leave space for ramp up/ramp down in the samples buffer
+            num_mod_samples = fsk_mod(phy->fsk, tx->data_buf,
+                                TRAINING_SEQ_LENGTH + PREAMBLE_LENGTH + tx->data_length,
+                                &(tx->samples[RAMP_LENGTH]));
+            //Mark the buffer empty
+            tx->buf_filled = false;
+
+            //Add the ramp up/ ramp down of samples
+            ramp_down_index = RAMP_LENGTH+num_mod_samples;
+            create_ramps(RAMP_LENGTH, tx->samples[ramp_down_index-1], tx->samples,
+                            &(tx->samples[ramp_down_index]));
+            //Convert samples
+            conv_struct_to_samples(tx->samples, num_samples, burst->samples);
+        }
+        burst->num_samples = num_samples;
 
-        //Add the ramp up/ ramp down of samples
-        ramp_down_index = RAMP_LENGTH+num_mod_samples;
-        create_ramps(RAMP_LENGTH, phy->tx->samples[ramp_down_index-1], phy->tx->samples,
-                        &(phy->tx->samples[ramp_down_index]));
-        //Convert samples
-        conv_struct_to_samples(phy->tx->samples, num_samples, out_samples_raw);
+        //Pass the burst on to the sender
+        seq++;
+        ATOMIC_STORE(&tx->num_modulated, seq);
+    }
+
+    return NULL;
+}
 
-        //transmit all samples. TX_NOW
-        status = bladerf_sync_tx(phy->dev, out_samples_raw, num_samples,
+/**
+ * Thread function for the second stage of the transmit pipeline. Sends each
+ * modulated burst to the device.
+ *
+ * Bursts of samples are scheduled by timestamp. A burst that is ready while
+ * the previous one is still queued or on the air follows it TX_BURST_GAP
+ * samples after it ends, rather than waiting for it to finish. Otherwise it is
+ * scheduled TX_SCHEDULE_LEAD samples ahead of the device's current time.
+ * Packets for the FPGA modem carry no timestamps, and are sent straight away.
+ *
+ * @param[in]   arg     pointer to phy handle struct
+ */
+static void *phy_send_bursts(void *arg)
+{
+    struct phy_handle *phy = (struct phy_handle *) arg;
+    struct tx *tx = phy->tx;
+    struct tx_burst *burst;
+    struct bladerf_metadata metadata;
+    unsigned int seq = 0;
+    uint64_t next_timestamp = 0;    //Earliest start of the next burst
+    uint64_t now;
+    int status;
+
+    while (tx_wait_for_count(tx, &tx->num_modulated, seq + 1)){
+        burst = &tx->bursts[seq % TX_PIPELINE_DEPTH];
+
+        //Set field(s) in bladerf metadata struct
+        memset(&metadata, 0, sizeof(metadata));
+        metadata.flags = BLADERF_META_FLAG_TX_BURST_START |
+                         BLADERF_META_FLAG_TX_BURST_END;
+
+        if (phy->fpga_modem){
+            metadata.flags |= BLADERF_META_FLAG_TX_NOW;
+        }else{
+            status = bladerf_get_timestamp(phy->dev, BLADERF_TX, &now);
+            if (status != 0){
+                fprintf(stderr, "[PHY] %s: Couldn't read TX timestamp: %s\n",
+                        __FUNCTION__, bladerf_strerror(status));
+                break;
+            }
+            metadata.timestamp = now + TX_SCHEDULE_LEAD;
+            if (next_timestamp > metadata.timestamp){
+                metadata.timestamp = next_timestamp;
+            }
+            next_timestamp = metadata.timestamp + burst->num_samples + TX_BURST_GAP;
+        }
+
+        status = bladerf_sync_tx(phy->dev, burst->samples, burst->num_samples,
                                 &metadata, 5000);
         if (status != 0){
             fprintf(stderr, "[PHY] %s: Couldn't transmit samples with bladeRF: %s\n",
                     __FUNCTION__, bladerf_strerror(status));
-            return NULL;
+            break;
         }
+
+        //Hand the burst back to the modulator
+        seq++;
+        ATOMIC_STORE(&tx->num_sent, seq);
     }
 
-    free(out_samples_raw);
     return NULL;
 }
 
@@ -592,6 +844,32 @@ static void create_ramps(unsigned int ramp_length, struct complex_sample ramp_do
     ramp_down[ramp_length-1].q = 0;        //Q
 }
 
+/**
+ * Fills the payload of a packet for the FPGA modem with a frame to transmit
+ *
+ * @param[in]   data        frame to transmit, including training seq/preamble
+ * @param[in]   length      length of the frame in bytes
+ * @param[out]  payload     packet payload, PACKET_PAYLOAD_SIZE bytes long
+ *
+ * @return      length of the payload in 32-bit DWORDs
+ */
+static unsigned int fill_tx_packet(const uint8_t *data, unsigned int length,
+                                    uint8_t *payload)
+{
+    unsigned int num_bytes = PACKET_COUNT_SIZE + length;
+
+    //Little-endian byte count
+    payload[0] = length & 0xff;
+    payload[1] = (length >> 8) & 0xff;
+    payload[2] = (length >> 16) & 0xff;
+    payload[3] = (length >> 24) & 0xff;
+    memcpy(&payload[PACKET_COUNT_SIZE], data, length);
+    //Zero pad to a whole DWORD
+    memset(&payload[num_bytes], 0, (4 - num_bytes % 4) % 4);
+
+    return (num_bytes + 3) / 4;
+}
+
 /**
  * Scrambles the given data with the given scrambling sequence. The size of the
  * scrambling sequence array must be at least as large as the frame.
@@ -600,7 +878,16 @@ static void scramble_frame(uint8_t *frame, int frame_length,
                             uint8_t *scrambling_sequence)
 {
     int i;
-    for (i = 0; i < frame_length; i++){
+    uint64_t word, seq;
+
+    //XOR 8 bytes at a time with the scrambling sequence
+    for (i = 0; i + 8 <= frame_length; i += 8){
+        memcpy(&word, &frame[i], sizeof(word));
+        memcpy(&seq, &scrambling_sequence[i], sizeof(seq));
+        word ^= seq;
+        memcpy(&frame[i], &word, sizeof(word));
+    }
+    for (; i < frame_length; i++){
         //XOR byte with byte from scrambling sequence
         frame[i] ^= scrambling_sequence[i];
     }
@@ -618,32 +905,82 @@ int phy_start_receiver(struct phy_handle *phy)
 
     //turn off stop signal
     phy->rx->stop = false;
-    //Kick off frame receiver thread
+    //Empty the pipeline
+    phy->rx->num_acquired = 0;
+    phy->rx->num_filtered = 0;
+    phy->rx->num_consumed = 0;
+
+    //The FPGA modem's symbols need no pipeline
+    if (phy->fpga_modem){
+        status = pthread_create(&(phy->rx->thread), NULL, phy_receive_packets, phy);
+        if (status != 0){
+            fprintf(stderr, "[PHY] %s: Error creating rx thread: %s\n", __FUNCTION__,
+                    strerror(status));
+            return -1;
+        }
+        return 0;
+    }
+
+    //Kick off frame receiver thread, then the stages feeding it
     status = pthread_create(&(phy->rx->thread), NULL, phy_receive_frames, phy);
     if (status != 0){
         fprintf(stderr, "[PHY] %s: Error creating rx thread: %s\n", __FUNCTION__,
                 strerror(status));
         return -1;
     }
+    status = pthread_create(&(phy->rx->filter_thread), NULL, phy_filter_samples, phy);
+    if (status != 0){
+        fprintf(stderr, "[PHY] %s: Error creating rx filter thread: %s\n",
+                __FUNCTION__, strerror(status));
+        phy->rx->stop = true;
+        pthread_join(phy->rx->thread, NULL);
+        return -1;
+    }
+    status = pthread_create(&(phy->rx->acquire_thread), NULL,
+                            phy->chan != NULL ? phy_acquire_channel : phy_acquire_samples,
+                            phy);
+    if (status != 0){
+        fprintf(stderr, "[PHY] %s: Error creating rx acquisition thread: %s\n",
+                __FUNCTION__, strerror(status));
+        phy->rx->stop = true;
+        pthread_join(phy->rx->filter_thread, NULL);
+        pthread_join(phy->rx->thread, NULL);
+        return -1;
+    }
     return 0;
 }
 
 int phy_stop_receiver(struct phy_handle *phy)
 {
     int status;
+    int ret = 0;
 
     DEBUG_MSG("[PHY] RX: Stopping receiver...\n");
     //signal stop
     phy->rx->stop = true;
-    //Wait for rx thread to finish
+    //Wait for rx threads to finish, starting at the head of the pipeline
+    if (!phy->fpga_modem){
+        status = pthread_join(phy->rx->acquire_thread, NULL);
+        if (status != 0){
+            fprintf(stderr, "[PHY] %s: Error joining rx acquisition thread: %s\n",
+                    __FUNCTION__, strerror(status));
+            ret = -1;
+        }
+        status = pthread_join(phy->rx->filter_thread, NULL);
+        if (status != 0){
+            fprintf(stderr, "[PHY] %s: Error joining rx filter thread: %s\n",
+                    __FUNCTION__, strerror(status));
+            ret = -1;
+        }
+    }
     status = pthread_join(phy->rx->thread, NULL);
     if (status != 0){
         fprintf(stderr, "[PHY] %s: Error joining rx thread: %s\n", __FUNCTION__,
                 strerror(status));
-        return -1;
+        ret = -1;
     }
     DEBUG_MSG("[PHY] RX: Receiver stopped\n");
-    return 0;
+    return ret;
 }
 
 uint8_t *phy_request_rx_buf(struct phy_handle *phy, unsigned int timeout_ms)
@@ -701,10 +1038,207 @@ void phy_release_rx_buf(struct phy_handle *phy)
 }
 
 /**
- * Thread function which listens for and receives frames. The steps are:
- * 1) Receive samples with libbladeRF
- * 2) Low pass filter the samples
- * 3) Power normalize the samples
+ * Wait for a pipeline stage to pass on block `seq`, i.e., for the stage's
+ * block counter to move past it
+ *
+ * @param[in]   rx          pointer to rx struct
+ * @param[in]   count       block counter of the stage feeding the caller
+ * @param[in]   seq         block the caller is waiting for
+ *
+ * @return      true once the block is available, false if the receiver was
+ *              stopped first
+ */
+static bool rx_wait_for_block(struct rx *rx, unsigned int *count, unsigned int seq)
+{
+    unsigned int spins = 0;
+
+    while (ATOMIC_LOAD(count) == seq){
+        if (rx->stop){
+            return false;
+        }
+        //Blocks arrive every NUM_SAMPLES_RX sample periods, so don't
+        //spin for long
+        if (spins < RX_WAIT_SPINS){
+            CPU_RELAX();
+            spins++;
+        }else{
+            usleep(50);
+        }
+    }
+    return true;
+}
+
+/**
+ * Thread function at the head of the receive pipeline. Receives blocks of
+ * samples with libbladeRF into free pipeline blocks. This thread never waits
+ * on the rest of the pipeline: if no block is free, the samples are received
+ * and dropped so that the device itself does not overrun.
+ *
+ * @param    arg        pointer to phy_handle struct
+ */
+static void *phy_acquire_samples(void *arg)
+{
+    struct phy_handle *phy = (struct phy_handle *) arg;
+    struct rx *rx = phy->rx;
+    struct rx_block *block;
+    struct bladerf_metadata metadata;            //bladerf metadata for sync_rx()
+    int16_t *buf;
+    unsigned int seq = 0;
+    bool discontinuity = false;
+    uint64_t timestamp = UINT64_MAX;
+    int status;
+
+    //Set bladeRF metadata
+    memset(&metadata, 0, sizeof(metadata));
+    metadata.flags = BLADERF_META_FLAG_RX_NOW;
+
+    while (!rx->stop){
+        if (seq - ATOMIC_LOAD(&rx->num_consumed) < RX_PIPELINE_DEPTH){
+            block = &rx->blocks[seq % RX_PIPELINE_DEPTH];
+            buf = block->in_samples;
+        }else{
+            block = NULL;
+            buf = rx->drop_samples;
+        }
+
+        status = bladerf_sync_rx(phy->dev, buf, NUM_SAMPLES_RX, &metadata, 5000);
+        if (status != 0){
+            fprintf(stderr, "[PHY] %s: Couldn't receive samples from bladeRF\n",
+                    __FUNCTION__);
+            rx->stop = true;
+            break;
+        }
+        //Check metadata
+        if (metadata.status & BLADERF_META_STATUS_OVERRUN){
+            NOTE("[PHY] %s: Got an overrun. Expected count = %u;"
+                        " actual count = %u. Skipping these samples.\n",
+                        __FUNCTION__, NUM_SAMPLES_RX, metadata.actual_count);
+            discontinuity = true;
+            continue;
+        }
+        if (timestamp != UINT64_MAX && metadata.timestamp != timestamp+NUM_SAMPLES_RX){
+            NOTE("[PHY] %s: Unexpected timestamp. Expected %lu, got %lu.\n",
+                    __FUNCTION__, timestamp+NUM_SAMPLES_RX, metadata.timestamp);
+            discontinuity = true;
+        }
+        timestamp = metadata.timestamp;
+
+        if (block == NULL){
+            NOTE("[PHY] %s: RX pipeline is full. Dropping %u samples.\n",
+                    __FUNCTION__, NUM_SAMPLES_RX);
+            discontinuity = true;
+            continue;
+        }
+
+        //Pass the block on to the filter stage
+        block->discontinuity = discontinuity;
+        discontinuity = false;
+        seq++;
+        ATOMIC_STORE(&rx->num_acquired, seq);
+    }
+    return NULL;
+}
+
+/**
+ * Thread function at the head of the receive pipeline of a channel's PHY.
+ * Reads blocks of the channel from the channelizer into free pipeline blocks.
+ * As with phy_acquire_samples(), this never waits on the rest of the pipeline:
+ * if no block is free, the channel's samples are read and dropped, so that a
+ * channel which falls behind does not hold up the others.
+ *
+ * @param    arg        pointer to phy_handle struct
+ */
+static void *phy_acquire_channel(void *arg)
+{
+    struct phy_handle *phy = (struct phy_handle *) arg;
+    struct rx *rx = phy->rx;
+    struct rx_block *block;
+    int16_t *buf;
+    unsigned int seq = 0;
+    bool discontinuity = false;
+    bool lost;
+    int status;
+
+    while (!rx->stop){
+        if (seq - ATOMIC_LOAD(&rx->num_consumed) < RX_PIPELINE_DEPTH){
+            block = &rx->blocks[seq % RX_PIPELINE_DEPTH];
+            buf = block->in_samples;
+        }else{
+            block = NULL;
+            buf = rx->drop_samples;
+        }
+
+        status = chan_read(phy->chan, phy->chan_index, buf, &lost, &rx->stop);
+        if (status != 0){
+            //Stopped, by the receiver or by the channelizer
+            rx->stop = true;
+            break;
+        }
+        discontinuity |= lost;
+
+        if (block == NULL){
+            NOTE("[PHY] %s: RX pipeline is full. Dropping %u samples.\n",
+                    __FUNCTION__, NUM_SAMPLES_RX);
+            discontinuity = true;
+            continue;
+        }
+
+        //Pass the block on to the filter stage
+        block->discontinuity = discontinuity;
+        discontinuity = false;
+        seq++;
+        ATOMIC_STORE(&rx->num_acquired, seq);
+    }
+    return NULL;
+}
+
+/**
+ * Thread function for the second stage of the receive pipeline. Low pass
+ * filters and power normalizes each acquired block.
+ *
+ * @param    arg        pointer to phy_handle struct
+ */
+static void *phy_filter_samples(void *arg)
+{
+    struct phy_handle *phy = (struct phy_handle *) arg;
+    struct rx *rx = phy->rx;
+    struct rx_block *block;
+    unsigned int seq = 0;
+
+    while (rx_wait_for_block(rx, &rx->num_acquired, seq)){
+        block = &rx->blocks[seq % RX_PIPELINE_DEPTH];
+
+        #ifndef BYPASS_RX_CHANNEL_FILTER
+            // Apply channel filter
+            fir_process(rx->ch_filt, block->in_samples,
+                        rx->filt_samples, NUM_SAMPLES_RX);
+        #else
+            conv_samples_to_struct(block->in_samples, NUM_SAMPLES_RX,
+                                    rx->filt_samples);
+        #endif
+        //Power normalize
+        #ifndef BYPASS_RX_PNORM
+            pnorm(rx->pnorm, NUM_SAMPLES_RX, rx->filt_samples,
+                    block->samples, NULL, NULL);
+        #else
+            memcpy(block->samples, rx->filt_samples,
+                    NUM_SAMPLES_RX * sizeof(struct complex_sample));
+        #endif
+
+        //Pass the block on to the demodulator
+        seq++;
+        ATOMIC_STORE(&rx->num_filtered, seq);
+    }
+    return NULL;
+}
+
+/**
+ * Thread function which listens for and receives frames. This is the last
+ * stage of the receive pipeline, fed by phy_acquire_samples() and
+ * phy_filter_samples(). The steps are:
+ * 1) Receive samples with libbladeRF (phy_acquire_samples())
+ * 2) Low pass filter the samples (phy_filter_samples())
+ * 3) Power normalize the samples (phy_filter_samples())
  * 4) Correlate the samples with the preamble waveform
  * 5) If a match is found, demodulate the samples into data bytes
  * 6) Unscramble the data
@@ -726,10 +1260,10 @@ void *phy_receive_frames(void *arg)
     bool new_frame = false;
     int frame_length = 0;            //link layer frame length
     uint8_t *rx_buffer = NULL;    //local rx data buffer
-    uint8_t frame_type;
-    struct bladerf_metadata metadata;            //bladerf metadata for sync_rx()
+    struct rx_block *block = NULL;    //pipeline block being demodulated
+    struct complex_sample *samples = NULL;    //filtered samples of the block
+    unsigned int seq = 0;            //pipeline sequence number of the block
     unsigned int num_bytes_to_demod = 0;
-    uint64_t timestamp = UINT64_MAX;
 
     enum states {RECEIVE, PREAMBLE_CORRELATE, DEMOD,
                     CHECK_FRAME_TYPE, DECODE, COPY};
@@ -746,10 +1280,6 @@ void *phy_receive_frames(void *arg)
         goto out;
     }
 
-    //Set bladeRF metadata
-    memset(&metadata, 0, sizeof(metadata));
-    metadata.flags = BLADERF_META_FLAG_RX_NOW;
-
     preamble_detected = false;
     data_index = 0;
     state = RECEIVE;
@@ -757,45 +1287,29 @@ void *phy_receive_frames(void *arg)
     while(!phy->rx->stop){
         switch(state){
             case RECEIVE:
-                //--Receive samples, filter, and power normalize
+                //--Get the next filtered, power normalized block
                 //DEBUG_MSG("[PHY] RX: State = RECEIVE\n");
-                samples_index = 0;
-                status = bladerf_sync_rx(phy->dev, phy->rx->in_samples, NUM_SAMPLES_RX,
-                                            &metadata, 5000);
-                if (status != 0){
-                    fprintf(stderr, "[PHY] %s: Couldn't receive samples from bladeRF\n",
-                            __FUNCTION__);
-                    goto out;
+                if (block != NULL){
+                    //Hand the previous block back to the acquisition stage
+                    seq++;
+                    ATOMIC_STORE(&(phy->rx->num_consumed), seq);
+                    block = NULL;
                 }
-                //Check metadata
-                if (metadata.status & BLADERF_META_STATUS_OVERRUN){
-                    NOTE("[PHY] %s: Got an overrun. Expected count = %u;"
-                                " actual count = %u. Skipping these samples.\n",
-                                __FUNCTION__, NUM_SAMPLES_RX, metadata.actual_count);
+                if (!rx_wait_for_block(phy->rx, &(phy->rx->num_filtered), seq)){
+                    //Stopped
                     break;
                 }
-                if (timestamp != UINT64_MAX && metadata.timestamp != timestamp+NUM_SAMPLES_RX){
-                    NOTE("[PHY] %s: Unexpected timestamp. Expected %lu, got %lu.\n",
-                            __FUNCTION__, timestamp+NUM_SAMPLES_RX, metadata.timestamp);
+                block = &(phy->rx->blocks[seq % RX_PIPELINE_DEPTH]);
+                samples = block->samples;
+                samples_index = 0;
+
+                //The rest of a frame cut by lost samples can't be demodulated
+                if (block->discontinuity && preamble_detected){
+                    NOTE("[PHY] %s: Samples lost mid-frame. Dropping frame.\n",
+                            __FUNCTION__);
+                    data_index = 0;
+                    preamble_detected = false;
                 }
-                timestamp = metadata.timestamp;
-
-                #ifndef BYPASS_RX_CHANNEL_FILTER
-                    // Apply channel filter
-                    fir_process(phy->rx->ch_filt, phy->rx->in_samples,
-                                phy->rx->filt_samples, NUM_SAMPLES_RX);
-                #else
-                    conv_samples_to_struct(phy->rx->in_samples, NUM_SAMPLES_RX,
-                                            phy->rx->filt_samples);
-                #endif
-                //Power normalize
-                #ifndef BYPASS_RX_PNORM
-                    pnorm(phy->rx->pnorm, NUM_SAMPLES_RX, phy->rx->filt_samples,
-                            phy->rx->pnorm_samples, NULL, NULL);
-                #else
-                    memcpy(phy->rx->pnorm_samples, phy->rx->filt_samples,
-                            NUM_SAMPLES_RX * sizeof(struct complex_sample));
-                #endif
                 if (preamble_detected){
                     state = DEMOD;
                 }else{
@@ -807,7 +1321,7 @@ void *phy_receive_frames(void *arg)
                 //--of the data frame
                 //DEBUG_MSG("[PHY] RX: State = PREAMBLE_CORRELATE\n");
                 samples_index = corr_process(phy->rx->corr,
-                                            &(phy->rx->pnorm_samples[samples_index]),
+                                            &(samples[samples_index]),
                                             (size_t) (NUM_SAMPLES_RX-samples_index), 0);
                 if (samples_index != CORRELATOR_NO_RESULT){
                     DEBUG_MSG("[PHY] RX: Preamble matched @ index %lu\n", samples_index);
@@ -825,7 +1339,7 @@ void *phy_receive_frames(void *arg)
             case DEMOD:
                 //--Demod samples
                 DEBUG_MSG("[PHY] RX: State = DEMOD\n");
-                num_bytes_rx = fsk_demod(phy->fsk, &(phy->rx->pnorm_samples[samples_index]),
+                num_bytes_rx = fsk_demod(phy->fsk, &(samples[samples_index]),
                                         NUM_SAMPLES_RX-(int)samples_index, new_frame,
                                         num_bytes_to_demod, &rx_buffer[data_index]);
                 if (num_bytes_rx < num_bytes_to_demod){
@@ -849,21 +1363,9 @@ void *phy_receive_frames(void *arg)
             case CHECK_FRAME_TYPE:
                 //--Check the frame type byte
                 DEBUG_MSG("[PHY] RX: State = CHECK_FRAME_TYPE\n");
-                #ifndef BYPASS_PHY_SCRAMBLING
-                    frame_type = rx_buffer[0] ^ phy->scrambling_sequence[0];
-                #else
-                    frame_type = rx_buffer[0];
-                #endif
                 //Set frame length according to what type of frame it is
-                if (frame_type == ACK_FRAME_CODE){
-                    DEBUG_MSG("[PHY] RX: Getting an ACK frame...\n");
-                    frame_length = ACK_FRAME_LENGTH;
-                }else if(frame_type == DATA_FRAME_CODE){
-                    DEBUG_MSG("[PHY] RX: Getting a data frame...\n");
-                    frame_length = DATA_FRAME_LENGTH;
-                }else{
-                    NOTE("[PHY] %s: rx'ed unknown frame type 0x%.2X\n",
-                            __FUNCTION__, frame_type);
+                frame_length = frame_type_length(phy, rx_buffer[0]);
+                if (frame_length == 0){
                     data_index = 0;
                     preamble_detected = false;
                     state = RECEIVE;
@@ -885,35 +1387,9 @@ void *phy_receive_frames(void *arg)
             case COPY:
                 //--Copy frame into buffer which can be accessed by the link layer
                 DEBUG_MSG("[PHY] RX: State = COPY\n");
-                //Is the link layer still working with the previous frame?
-                if (phy->rx->buf_filled){
-                    //Instead of disrupting the link layer, drop this frame
-                    NOTE("[PHY] RX: Frame dropped!\n");
-                }else{
-                    //Copy frame into rx_data_buf
-                    memcpy(phy->rx->data_buf, rx_buffer,
-                            frame_length);
-                    phy->rx->buf_filled = true;
-                    //Signal that the buffer is filled
-                    status = pthread_mutex_lock(&(phy->rx->buf_status_lock));
-                    if (status != 0){
-                        fprintf(stderr, "[PHY] %s: Error locking pthread_mutex\n",
-                                __FUNCTION__);
-                        goto out;
-                    }
-                    status = pthread_cond_signal(&(phy->rx->buf_filled_cond));
-                    if (status != 0){
-                        fprintf(stderr, "[PHY] %s: Error signaling pthread_cond\n",
-                                __FUNCTION__);
-                        goto out;
-                    }
-                    status = pthread_mutex_unlock(&(phy->rx->buf_status_lock));
-                    if (status != 0){
-                        fprintf(stderr, "[PHY] %s: Error unlocking pthread_mutex\n",
-                                __FUNCTION__);
-                        goto out;
-                    }
-                    DEBUG_MSG("[PHY] RX: Frame ready\n");
+                status = deliver_rx_frame(phy, rx_buffer, frame_length);
+                if (status != 0){
+                    goto out;
                 }
                 preamble_detected = false;
 
@@ -929,6 +1405,223 @@ void *phy_receive_frames(void *arg)
         }
     }
     out:
+        //Take the rest of the pipeline down with this thread
+        phy->rx->stop = true;
+        free(rx_buffer);
+        return NULL;
+}
+
+/**
+ * Determines the length of a received frame from its first byte, the frame type
+ *
+ * @param[in]   phy         pointer to phy_handle struct
+ * @param[in]   first_byte  first byte of the frame, still scrambled
+ *
+ * @return      frame length in bytes, or 0 if the frame type is unknown
+ */
+static int frame_type_length(struct phy_handle *phy, uint8_t first_byte)
+{
+    uint8_t frame_type;
+
+    #ifndef BYPASS_PHY_SCRAMBLING
+        frame_type = first_byte ^ phy->scrambling_sequence[0];
+    #else
+        (void) phy;
+        frame_type = first_byte;
+    #endif
+
+    if (frame_type == ACK_FRAME_CODE){
+        DEBUG_MSG("[PHY] RX: Getting an ACK frame...\n");
+        return ACK_FRAME_LENGTH;
+    }else if(frame_type == DATA_FRAME_CODE){
+        DEBUG_MSG("[PHY] RX: Getting a data frame...\n");
+        return DATA_FRAME_LENGTH;
+    }
+    NOTE("[PHY] %s: rx'ed unknown frame type 0x%.2X\n", __FUNCTION__, frame_type);
+    return 0;
+}
+
+/**
+ * Copies an unscrambled frame into the buffer which can be acquired with
+ * phy_request_rx_buf(), or drops the frame if the buffer is still in use
+ *
+ * @return      0 on success, -1 if signaling the buffer failed
+ */
+static int deliver_rx_frame(struct phy_handle *phy, uint8_t *frame, int frame_length)
+{
+    int status;
+
+    //Is the link layer still working with the previous frame?
+    if (phy->rx->buf_filled){
+        //Instead of disrupting the link layer, drop this frame
+        NOTE("[PHY] RX: Frame dropped!\n");
+        return 0;
+    }
+    //Copy frame into rx_data_buf
+    memcpy(phy->rx->data_buf, frame, frame_length);
+    phy->rx->buf_filled = true;
+    //Signal that the buffer is filled
+    status = pthread_mutex_lock(&(phy->rx->buf_status_lock));
+    if (status != 0){
+        fprintf(stderr, "[PHY] %s: Error locking pthread_mutex\n", __FUNCTION__);
+        return -1;
+    }
+    status = pthread_cond_signal(&(phy->rx->buf_filled_cond));
+    if (status != 0){
+        fprintf(stderr, "[PHY] %s: Error signaling pthread_cond\n", __FUNCTION__);
+        return -1;
+    }
+    status = pthread_mutex_unlock(&(phy->rx->buf_status_lock));
+    if (status != 0){
+        fprintf(stderr, "[PHY] %s: Error unlocking pthread_mutex\n", __FUNCTION__);
+        return -1;
+    }
+    DEBUG_MSG("[PHY] RX: Frame ready\n");
+    return 0;
+}
+
+//Number of bits set in x
+static unsigned int count_bits(uint32_t x)
+{
+    unsigned int count = 0;
+
+    while (x != 0){
+        x &= x - 1;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * Thread function which receives frames from the FPGA FSK modem, used in
+ * place of the receive pipeline. The FPGA filters and demodulates, so only
+ * the framing is left to the host:
+ * 1) Receive packets of symbols with libbladeRF
+ * 2) Search the symbols for the preamble, tolerating PREAMBLE_MAX_BIT_ERRORS
+ * 3) Pack the symbols that follow into bytes, until the frame type's length
+ * 4) Unscramble the data
+ * 5) Copy the frame to a buffer which can be acquired with phy_request_rx_buf(), or
+ *    drop the frame if the buffer is still in use
+ *
+ * @param    arg        pointer to phy_handle struct
+ */
+static void *phy_receive_packets(void *arg)
+{
+    struct phy_handle *phy = (struct phy_handle *) arg;
+    struct bladerf_metadata metadata;
+    uint8_t preamble[PREAMBLE_LENGTH] = PREAMBLE;
+    uint8_t *payload = NULL;        //received packet payload
+    uint8_t *rx_buffer = NULL;      //local rx data buffer
+    uint32_t preamble_bits = 0;
+    uint32_t shift = 0;             //most recent symbols, while searching
+    uint32_t num_symbols, max_symbols, i;
+    unsigned int data_index = 0;    //current received frame length
+    unsigned int bit_index = 0;     //bits of the current byte received
+    int frame_length = 0;
+    bool preamble_detected = false;
+    uint8_t byte = 0;
+    uint8_t bit;
+    int status;
+
+    //The search shifts the preamble through a single word
+    assert(PREAMBLE_LENGTH <= sizeof(preamble_bits));
+    for (i = 0; i < PREAMBLE_LENGTH; i++){
+        preamble_bits = (preamble_bits << 8) | preamble[i];
+    }
+
+    payload = malloc(PACKET_PAYLOAD_SIZE);
+    rx_buffer = malloc(MAX_LINK_FRAME_SIZE);
+    if (payload == NULL || rx_buffer == NULL){
+        perror("[PHY] malloc");
+        goto out;
+    }
+
+    memset(&metadata, 0, sizeof(metadata));
+    metadata.flags = BLADERF_META_FLAG_RX_NOW;
+
+    while (!phy->rx->stop){
+        metadata.actual_count = 0;
+        status = bladerf_sync_rx(phy->dev, payload, PACKET_BUFFER_SIZE, &metadata,
+                                 PACKET_RX_TIMEOUT_MS);
+        if (status == BLADERF_ERR_TIMEOUT){
+            //The modem has nothing to report
+            continue;
+        }else if (status != 0){
+            fprintf(stderr, "[PHY] %s: Couldn't receive packets from bladeRF: %s\n",
+                    __FUNCTION__, bladerf_strerror(status));
+            break;
+        }
+        //The rest of a frame cut by lost symbols can't be recovered
+        if (metadata.status & BLADERF_META_STATUS_OVERRUN){
+            NOTE("[PHY] %s: Got an overrun.\n", __FUNCTION__);
+            if (preamble_detected){
+                NOTE("[PHY] %s: Symbols lost mid-frame. Dropping frame.\n",
+                        __FUNCTION__);
+                preamble_detected = false;
+            }
+            shift = 0;
+        }
+        if (metadata.actual_count * 4 < PACKET_COUNT_SIZE){
+            continue;
+        }
+
+        //Don't trust the count beyond the end of the packet
+        num_symbols = payload[0] | (payload[1] << 8) | (payload[2] << 16) |
+                        ((uint32_t) payload[3] << 24);
+        max_symbols = (metadata.actual_count * 4 - PACKET_COUNT_SIZE) * 8;
+        if (num_symbols > max_symbols){
+            NOTE("[PHY] %s: Packet claims %u symbols, but holds %u.\n",
+                    __FUNCTION__, num_symbols, max_symbols);
+            num_symbols = max_symbols;
+        }
+
+        for (i = 0; i < num_symbols; i++){
+            bit = (payload[PACKET_COUNT_SIZE + i/8] >> (7 - i%8)) & 1;
+
+            if (!preamble_detected){
+                shift = (shift << 1) | bit;
+                if (count_bits(shift ^ preamble_bits) <= PREAMBLE_MAX_BIT_ERRORS){
+                    DEBUG_MSG("[PHY] RX: Preamble matched\n");
+                    preamble_detected = true;
+                    data_index = 0;
+                    bit_index = 0;
+                    byte = 0;
+                }
+                continue;
+            }
+
+            byte = (byte << 1) | bit;
+            if (++bit_index < 8){
+                continue;
+            }
+            rx_buffer[data_index++] = byte;
+            bit_index = 0;
+            byte = 0;
+
+            if (data_index == 1){
+                frame_length = frame_type_length(phy, rx_buffer[0]);
+                if (frame_length == 0){
+                    preamble_detected = false;
+                    shift = 0;
+                    continue;
+                }
+            }
+            if (data_index == (unsigned int) frame_length){
+                #ifndef BYPASS_PHY_SCRAMBLING
+                    unscramble_frame(rx_buffer, frame_length, phy->scrambling_sequence);
+                #endif
+                status = deliver_rx_frame(phy, rx_buffer, frame_length);
+                if (status != 0){
+                    goto out;
+                }
+                preamble_detected = false;
+                shift = 0;
+            }
+        }
+    }
+    out:
+        phy->rx->stop = true;
+        free(payload);
         free(rx_buffer);
         return NULL;
 }
@@ -940,9 +1633,6 @@ void *phy_receive_frames(void *arg)
 static void unscramble_frame(uint8_t *frame, int frame_length,
                                 uint8_t *scrambling_sequence)
 {
-    int i;
-    for (i = 0; i < frame_length; i++){
-        //XOR byte with byte from scrambling sequence
-        frame[i] ^= scrambling_sequence[i];
-    }
+    //XORing with the same sequence again undoes the scrambling
+    scramble_frame(frame, frame_length, scrambling_sequence);
 }
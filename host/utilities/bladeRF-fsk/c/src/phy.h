@@ -48,6 +48,7 @@
 #include "host_config.h"
 #include "common.h"
 #include "utils.h"
+#include "channelizer.h"
 
 //Training sequence which goes at the start of every frame
 //Note: In order for the preamble waveform not to be messed up, the last
@@ -63,8 +64,8 @@
 #define DATA_FRAME_CODE 0x00
 #define ACK_FRAME_CODE 0xFF
 //Frame lengths
-#define DATA_FRAME_LENGTH 1009
-#define ACK_FRAME_LENGTH 7
+#define DATA_FRAME_LENGTH 1011
+#define ACK_FRAME_LENGTH 11
 //Maximum frame size in bytes
 #define MAX_LINK_FRAME_SIZE DATA_FRAME_LENGTH
 //Seed for pseudorandom number sequence generator
@@ -73,6 +74,12 @@
 #define RAMP_LENGTH SAMP_PER_SYMB
 //Number of samples to receive at a time from bladeRF
 #define NUM_SAMPLES_RX SYNC_BUFFER_SIZE
+//Number of NUM_SAMPLES_RX blocks in flight between the receiver's threads.
+//Must be a power of two.
+#define RX_PIPELINE_DEPTH 8
+//Number of modulated bursts the transmitter may hold, including the one being
+//sent. Must be a power of two.
+#define TX_PIPELINE_DEPTH 2
 //Correlator countdown size
 #define CORR_COUNTDOWN SAMP_PER_SYMB
 
@@ -80,7 +87,9 @@ struct phy_handle;
 
 //----------------------Transmitter functions---------------------------
 /**
- * Start the PHY transmitter thread
+ * Start the PHY transmitter threads. Frames are modulated on one thread, and
+ * sent on another, so that the next frame is modulated while the current
+ * burst is on the air.
  * 
  * @param[in]   phy     pointer to phy_handle struct
  *
@@ -89,7 +98,7 @@ struct phy_handle;
 int phy_start_transmitter(struct phy_handle *phy);
 
 /**
- * Stop the PHY transmitter thread
+ * Stop the PHY transmitter threads
  * 
  * @param[in]   phy     pointer to phy_handle struct
  *
@@ -110,7 +119,9 @@ int phy_fill_tx_buf(struct phy_handle *phy, uint8_t *data_buf, unsigned int leng
 
 //------------------------Receiver functions---------------------------
 /**
- * Start the PHY receiver  thread
+ * Start the PHY receiver threads. Samples are acquired, filtered, and
+ * demodulated on separate threads, which pass blocks of samples along a
+ * pipeline RX_PIPELINE_DEPTH blocks deep.
  * 
  * @param[in]   phy     pointer to phy_handle struct
  *
@@ -119,7 +130,7 @@ int phy_fill_tx_buf(struct phy_handle *phy, uint8_t *data_buf, unsigned int leng
 int phy_start_receiver(struct phy_handle *phy);
 
 /**
- * Stop the PHY receiver thread
+ * Stop the PHY receiver threads
  * 
  * @param[in]   phy     pointer to phy_handle struct
  *
@@ -157,6 +168,18 @@ void phy_release_rx_buf(struct phy_handle *phy);
  */
 struct phy_handle *phy_init(struct bladerf *dev, struct radio_params *params);
 
+/**
+ * Open/Initialize a receive-only phy_handle, which demodulates one of a
+ * channelizer's channels rather than samples from the device. Its transmitter
+ * can't be started.
+ *
+ * @param[in]   chan    pointer to channelizer, which must outlive the handle
+ * @param[in]   channel channel to receive, from 0
+ *
+ * @return      allocated phy_handle on success, NULL on failure
+ */
+struct phy_handle *phy_init_channel(struct channelizer *chan, unsigned int channel);
+
 /**
  * Close a phy handle. Does nothing if handle is NULL
  *
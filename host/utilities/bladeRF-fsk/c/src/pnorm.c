@@ -74,68 +74,81 @@ void pnorm_hold(struct pnorm_state_t *state, bool val) {
     return ;
 }
 
+/* Samples whose gains are worked out per pass over the block. The power
+ * estimate is a recursion from sample to sample, so it has to be run serially,
+ * but once the gains are known, applying them is independent per sample. */
+#define PNORM_CHUNK 256
+
+/* Scale a sample, rounding half away from zero as round() does, and clamp it
+ * to +/- CLAMP_VAL_ABS. This is written without branches or libm calls, so the
+ * apply loop below vectorizes. Scaled samples are well within float's 24-bit
+ * integer range, so the truncation and fraction are exact. */
+static inline int32_t scale_sample(int16_t x, float gain) {
+    float y = x * gain ;
+    int32_t r = (int32_t) y ;
+    float frac = y - (float) r ;
+
+    r += (frac >= 0.5f) - (frac <= -0.5f) ;
+    r = (r > CLAMP_VAL_ABS) ? CLAMP_VAL_ABS : r ;
+    r = (r < -CLAMP_VAL_ABS) ? -CLAMP_VAL_ABS : r ;
+    return r ;
+}
+
 void pnorm(struct pnorm_state_t *state, uint16_t length, struct complex_sample *in,
             struct complex_sample *out, float *ests, float *gains) {
-    int i ;
-    float power;
-    int32_t temp;
-    float gain, est;
-
-    for( i = 0 ; i < length ; i++ ) {
-        /* Power IIR filter */
-        if( state->hold == false ) {
-            //New estimate of power (normalized)
-            est = state->est = state->alpha*state->est +
-                state->invalpha*(in[i].i*in[i].i + in[i].q*in[i].q)/(SAMP_MAX_ABS*SAMP_MAX_ABS);
-        } else {
-            est = state->est ;
+    float chunk_gain[PNORM_CHUNK] ;
+    /* Division by the full-scale power is exact (a power of two), so folding
+     * it into the IIR coefficient changes no estimates */
+    const float scale = state->invalpha / (float)(SAMP_MAX_ABS*SAMP_MAX_ABS) ;
+    const int32_t blank_power = 10 * SAMP_MAX_ABS*SAMP_MAX_ABS ;
+    unsigned int base, n, i ;
+    float gain, est ;
+
+    for( base = 0 ; base < length ; base += n ) {
+        n = length - base ;
+        if( n > PNORM_CHUNK ) {
+            n = PNORM_CHUNK ;
         }
 
-        /* Ideal power is 1.0, so to get x to 1.0, we need to multiply by 1/est */
-        gain = 1.0f/sqrtf(state->est) ;
+        /* Power IIR filter, and the gain it calls for */
+        est = state->est ;
+        for( i = 0 ; i < n ; i++ ) {
+            const struct complex_sample *x = &in[base + i] ;
 
-        /* Check below min gain */
-        if( gain < state->min_gain ) {
-            gain = state->min_gain ;
-        }
+            if( state->hold == false ) {
+                //New estimate of power (normalized)
+                est = state->alpha*est + scale*(float)(x->i*x->i + x->q*x->q) ;
+            }
 
-        /* Check above max gain */
-        if( gain > state->max_gain ) {
-            gain = state->max_gain ;
-        }
+            /* Ideal power is 1.0, so to get x to 1.0, we need to multiply by 1/est */
+            gain = 1.0f/sqrtf(est) ;
 
-        /* Apply gain */
-        //Use temp int32_t in case this number goes outside 16bit range
-        temp = (int32_t) round(in[i].i * gain);
-        //Clamp
-        if (temp > CLAMP_VAL_ABS){
-            temp = CLAMP_VAL_ABS;
-        }else if (temp < -CLAMP_VAL_ABS){
-            temp = -CLAMP_VAL_ABS;
-        }
-        out[i].i = (int16_t) temp;
-
-        temp = (int32_t) round(in[i].q * gain);
-        //Clamp
-        if (temp > CLAMP_VAL_ABS){
-            temp = CLAMP_VAL_ABS;
-        }else if (temp < -CLAMP_VAL_ABS){
-            temp = -CLAMP_VAL_ABS;
-        }
-        out[i].q = (int16_t) temp;
+            /* Limit to [min gain, max gain] */
+            gain = (gain < state->min_gain) ? state->min_gain : gain ;
+            gain = (gain > state->max_gain) ? state->max_gain : gain ;
+            chunk_gain[i] = gain ;
 
-        /* Blank impulse power */
-        power = (out[i].i * out[i].i + out[i].q * out[i].q)/(float)(SAMP_MAX_ABS*SAMP_MAX_ABS);
-        if (power >= 10.0f) {
-            out[i].i = out[i].q = 0;
+            //Write to debug buffers
+            if (ests != NULL){
+                ests[base + i] = est ;
+            }
         }
+        state->est = est ;
 
-        //Write to debug buffers
-        if (ests != NULL){
-            ests[i] = est;
-        }
         if (gains != NULL){
-            gains[i] = gain;
+            memcpy(&gains[base], chunk_gain, n * sizeof(chunk_gain[0])) ;
+        }
+
+        /* Apply gain. This pass has no dependencies between samples. */
+        for( i = 0 ; i < n ; i++ ) {
+            //Use int32_t in case this number goes outside 16bit range
+            int32_t si = scale_sample(in[base + i].i, chunk_gain[i]) ;
+            int32_t sq = scale_sample(in[base + i].q, chunk_gain[i]) ;
+
+            /* Blank impulse power (normalized power >= 10.0) */
+            int32_t blank = (si*si + sq*sq >= blank_power) ;
+            out[base + i].i = (int16_t) (blank ? 0 : si) ;
+            out[base + i].q = (int16_t) (blank ? 0 : sq) ;
         }
     }
     return ;
@@ -41,7 +41,7 @@ struct module_config{
 };
 //internal functinos
 static int radio_configure_module(struct bladerf *dev, struct module_config *c);
-static int radio_init_sync(struct bladerf *dev);
+static int radio_init_sync(struct bladerf *dev, bool fpga_modem);
 
 /**
  * Configure RX/TX module
@@ -115,18 +115,29 @@ static int radio_configure_module(struct bladerf *dev, struct module_config *c)
 /** 
  * Initialize synchronous interface
  */
-static int radio_init_sync(struct bladerf *dev)
+static int radio_init_sync(struct bladerf *dev, bool fpga_modem)
 {
     int status;
     const unsigned int num_buffers   = 64;
-    const unsigned int buffer_size   = SYNC_BUFFER_SIZE;  /* Must be a multiple of 1024 */
     const unsigned int num_transfers = 16;
     const unsigned int timeout_ms    = 3500;
+    bladerf_format format;
+    unsigned int buffer_size;   /* Must be a multiple of 1024 */
+
     /* Configure both the device's RX and TX modules for use with the synchronous
-     * interface. SC16 Q11 samples with metadata are used. */
+     * interface. SC16 Q11 samples with metadata are used, or packets to and from
+     * the FPGA's FSK modem. */
+    if (fpga_modem) {
+        format      = BLADERF_FORMAT_PACKET_META;
+        buffer_size = PACKET_BUFFER_SIZE;
+    } else {
+        format      = BLADERF_FORMAT_SC16_Q11_META;
+        buffer_size = SYNC_BUFFER_SIZE;
+    }
+
     status = bladerf_sync_config(dev,
                                  BLADERF_MODULE_RX,
-                                 BLADERF_FORMAT_SC16_Q11_META,
+                                 format,
                                  num_buffers,
                                  buffer_size,
                                  num_transfers,
@@ -138,7 +149,7 @@ static int radio_init_sync(struct bladerf *dev)
     }
     status = bladerf_sync_config(dev,
                                  BLADERF_MODULE_TX,
-                                 BLADERF_FORMAT_SC16_Q11_META,
+                                 format,
                                  num_buffers,
                                  buffer_size,
                                  num_transfers,
@@ -180,6 +191,13 @@ int radio_init_and_configure(struct bladerf *dev, struct radio_params *params)
     config.rx_lna       = params->rx_lna_gain;
     config.vga1         = params->rx_vga1_gain;
     config.vga2         = params->rx_vga2_gain;
+    //The channelizer samples all of its channels at once, tuned between them
+    if (params->rx_channels > 1){
+        config.frequency    = params->rx_freq +
+                                (params->rx_channels - 1) * (CHAN_SPACING / 2);
+        config.bandwidth    = params->rx_channels * CHAN_SPACING;
+        config.samplerate   = params->rx_channels * BLADERF_SAMPLE_RATE;
+    }
     status = radio_configure_module(dev, &config);
     if (status != 0){
         fprintf(stderr, "Couldn't configure RX module: %s\n", bladerf_strerror(status));
@@ -194,7 +212,7 @@ int radio_init_and_configure(struct bladerf *dev, struct radio_params *params)
     }
 
     //Initialize synchronous interface
-    status = radio_init_sync(dev);
+    status = radio_init_sync(dev, params->fpga_modem);
     if (status != 0){
         fprintf(stderr, "Couldn't initialize synchronous interface: %s\n",
                 bladerf_strerror(status));
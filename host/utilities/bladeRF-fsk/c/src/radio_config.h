@@ -30,13 +30,22 @@
 #include "common.h"
 
 #define SYNC_BUFFER_SIZE 16384
+//Buffer size, in 32-bit DWORDs, of the FPGA modem's packets. Each packet
+//occupies one buffer, including its 16-byte metadata header.
+#define PACKET_BUFFER_SIZE 1024
 //1.5MHz
 #define BLADERF_BANDWIDTH 1500000
 //2Msps
 #define BLADERF_SAMPLE_RATE 2000000
+//Spacing of the channels received with the channelizer. Each is decimated to
+//BLADERF_SAMPLE_RATE, which this must equal.
+#define CHAN_SPACING BLADERF_SAMPLE_RATE
 
 /**
- * Configure bladeRF device
+ * Configure bladeRF device. If params->fpga_modem is set, the synchronous
+ * interface is configured for the FPGA FSK modem's packets
+ * (BLADERF_FORMAT_PACKET_META) instead of SC16 Q11 samples. If
+ * params->rx_channels is above 1, RX is configured for the channelizer.
  *
  * @param[in]   dev     pointer to bladeRF device handle
  * @param[in]   params  pointer to radio_params struct specifying frequencies/gains
@@ -87,6 +87,8 @@ int link_test(char *dev_id1, char *dev_id2, unsigned int tx_freq1, unsigned int
     params.rx_lna_gain    = BLADERF_LNA_GAIN_MAX;
     params.rx_vga1_gain = 23;
     params.rx_vga2_gain = 0;
+    params.link_window  = LINK_WINDOW_DEFAULT;
+    params.fpga_modem   = false;
     link1 = link_init(dev1, &params);
     if (link1 == NULL){
         fprintf(stderr, "Couldn't initialize link1\n");
@@ -64,9 +64,54 @@
  * specific frequency ranges and may not be suitable for all signal processing
  * needs.
  */
-int flatten_noise_figure(struct bladerf *dev,
+#include <stdint.h>
+#include "libbladeRF.h"
+
+/** Streaming FIR filter state */
+struct fir_filter;
+
+/**
+ * Create the noise figure flattening filter for a device
+ *
+ * @param       dev           Device handle
+ * @param       max_samples   Max number of samples per block
+ * @param[out]  filter        Newly allocated filter
+ *
+ * @return 0 on success, BLADERF_ERR_* on failure
+ */
+int fir_filter_create(struct bladerf *dev,
+                      size_t max_samples,
+                      struct fir_filter **filter);
+
+/**
+ * Free a filter created by fir_filter_create()
+ *
+ * @param       filter        Filter to free. May be NULL.
+ */
+void fir_filter_destroy(struct fir_filter *filter);
+
+/**
+ * Clear a filter's history, so that the next block is filtered as if it
+ * were the first
+ *
+ * @param       filter        Filter state
+ */
+void fir_filter_reset(struct fir_filter *filter);
+
+/**
+ * Filter a block of SC16 Q11 samples, continuing from the previous block,
+ * and accumulate the power of the filtered samples
+ *
+ * @param       filter        Filter state
+ * @param       samples       Interleaved I/Q samples
+ * @param       num_samples   Number of samples (I/Q pairs)
+ * @param[in,out] power_sum   Incremented by the sum of I^2 + Q^2
+ *
+ * @return 0 on success, BLADERF_ERR_* on failure
+ */
+int flatten_noise_figure(struct fir_filter *filter,
                          const int16_t *samples,
                          size_t num_samples,
-                         int16_t *convolved_samples);
+                         double *power_sum);
 
 #endif // FILTER_H_
\ No newline at end of file
@@ -46,4 +46,14 @@ bladerf_direction ask_direction();
 
 int start_streaming(struct bladerf *dev, struct test_params *test);
 
+/**
+ * @brief  Convert accumulated sample power to average power
+ *
+ * @param power_sum    Sum of I^2 + Q^2 over the samples
+ * @param num_samples  Number of samples summed
+ *
+ * @return Average power, in dBFS
+ */
+double calculate_power(double power_sum, size_t num_samples);
+
 #endif // HELPERS_H_
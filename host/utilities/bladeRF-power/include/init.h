@@ -30,8 +30,12 @@
 
 #include "libbladeRF.h"
 
+// Max # of RX channels measured at once, with --mimo
+#define MAX_POWER_CHANNELS 2
+
 struct test_params {
-    bladerf_channel channel;
+    bladerf_channel channel;        // First channel measured
+    size_t num_channels;            // # of channels measured at once
     bladerf_frequency frequency;
     bladerf_frequency frequency_actual;
     bladerf_frequency freq_min;
@@ -44,7 +48,7 @@ struct test_params {
     bladerf_sample_rate samp_rate;
     bladerf_sample_rate bandwidth;
     bladerf_direction direction;
-    double rx_power;
+    double rx_power[MAX_POWER_CHANNELS];
     bool gain_cal_enabled;
     char *gain_cal_file;
     bool show_messages;
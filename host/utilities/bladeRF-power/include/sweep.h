@@ -0,0 +1,101 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This program is intended to verify that C programs build against
+ * libbladeRF without any unintended dependencies.
+ */
+#ifndef SWEEP_H_
+#define SWEEP_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "libbladeRF.h"
+#include "init.h"
+
+typedef enum {
+    SWEEP_OUTPUT_CSV,
+    SWEEP_OUTPUT_JSON,
+} sweep_output_format;
+
+struct sweep_params {
+    bool enabled;
+
+    bladerf_frequency freq_start;
+    bladerf_frequency freq_stop;
+    bladerf_frequency freq_step;
+
+    bladerf_gain gain_start;
+    bladerf_gain gain_stop;
+    bladerf_gain gain_step;
+    bool gain_set;              // Otherwise, only the current gain is used
+
+    size_t dwell_samples;       // Samples measured at each point
+    unsigned int settle_us;     // Time allowed for each retune to settle
+
+    const char *output_file;    // NULL writes to stdout
+    sweep_output_format format;
+};
+
+/**
+ * @brief Initialize sweep parameters to their defaults (sweep disabled)
+ *
+ * @param sweep The sweep parameters to initialize
+ */
+void init_sweep_params(struct sweep_params *sweep);
+
+/**
+ * @brief Parse a "start:stop[:step]" frequency range
+ *
+ * @return true on success, false if `str` is invalid
+ */
+bool parse_freq_range(const char *str, struct sweep_params *sweep);
+
+/**
+ * @brief Parse a "start:stop[:step]" gain range, in dB
+ *
+ * @return true on success, false if `str` is invalid
+ */
+bool parse_gain_range(const char *str, struct sweep_params *sweep);
+
+/**
+ * @brief Measure RX power over a frequency x gain grid without a UI
+ *
+ * For each gain, the channel hops through every frequency using scheduled
+ * quick retunes. After each retune has settled, a block of samples is
+ * received at a known timestamp and its power is measured. One result per
+ * point is written in the requested format.
+ *
+ * @pre dev_init() has configured the RX channel
+ *
+ * @param dev   Device handle
+ * @param test  Test parameters (channel, sample rate)
+ * @param sweep Sweep parameters
+ *
+ * @return 0 on success, BLADERF_ERR_* on failure
+ */
+int run_sweep(struct bladerf *dev,
+              struct test_params *test,
+              const struct sweep_params *sweep);
+
+#endif // SWEEP_H_
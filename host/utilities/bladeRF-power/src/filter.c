@@ -33,6 +33,7 @@
 #include <string.h>
 #include "log.h"
 #include "libbladeRF.h"
+#include "filter.h"
 
 #define CHECK_NULL(...) do { \
     const void* _args[] = { __VA_ARGS__, NULL }; \
@@ -91,6 +92,15 @@ static device_fir_filter_t filters[] = {
     {"bladerf2",        bladerf2_filter_taps,       BLADERF2_TAPS_NUM},
 };
 
+struct fir_filter {
+    float *taps;          /* Taps, in reverse order */
+    size_t tap_num;
+    size_t max_samples;   /* Max # of samples per block */
+    float *work;          /* The last tap_num - 1 samples of the previous
+                           * block, followed by the current block, as
+                           * interleaved I/Q */
+};
+
 static device_fir_filter_t* get_device_filter(struct bladerf *dev) {
     const char* board_name = bladerf_get_board_name(dev);
     for (size_t i = 0; i < sizeof(filters) / sizeof(filters[0]); i++) {
@@ -103,33 +113,95 @@ static device_fir_filter_t* get_device_filter(struct bladerf *dev) {
     return &filters[0]; // Default filter
 }
 
-int flatten_noise_figure(struct bladerf *dev,
+int fir_filter_create(struct bladerf *dev,
+                      size_t max_samples,
+                      struct fir_filter **filter_out)
+{
+    CHECK_NULL(dev, filter_out);
+
+    const device_fir_filter_t *dev_filter = get_device_filter(dev);
+    const size_t history = dev_filter->tap_num - 1;
+    struct fir_filter *filter = calloc(1, sizeof(*filter));
+    if (filter == NULL) {
+        return BLADERF_ERR_MEM;
+    }
+
+    filter->tap_num     = dev_filter->tap_num;
+    filter->max_samples = max_samples;
+    filter->taps        = malloc(filter->tap_num * sizeof(float));
+    filter->work        = calloc(2 * (history + max_samples), sizeof(float));
+    if (filter->taps == NULL || filter->work == NULL) {
+        fir_filter_destroy(filter);
+        return BLADERF_ERR_MEM;
+    }
+
+    for (size_t j = 0; j < filter->tap_num; j++) {
+        filter->taps[j] = (float)dev_filter->filter_taps[filter->tap_num - 1 - j];
+    }
+
+    *filter_out = filter;
+    return 0;
+}
+
+void fir_filter_destroy(struct fir_filter *filter)
+{
+    if (filter != NULL) {
+        free(filter->taps);
+        free(filter->work);
+        free(filter);
+    }
+}
+
+void fir_filter_reset(struct fir_filter *filter)
+{
+    memset(filter->work, 0, 2 * (filter->tap_num - 1) * sizeof(float));
+}
+
+int flatten_noise_figure(struct fir_filter *filter,
                          const int16_t *samples,
                          size_t num_samples,
-                         int16_t *convolved_samples)
+                         double *power_sum)
 {
-    int status = 0;
-    double acc_i, acc_q;
-    CHECK_NULL(dev, samples, convolved_samples);
+    CHECK_NULL(filter, samples, power_sum);
 
-    device_fir_filter_t* filter = get_device_filter(dev);
+    if (num_samples > filter->max_samples) {
+        log_error("%s: %zu samples exceeds the block size of %zu\n",
+                  __FUNCTION__, num_samples, filter->max_samples);
+        return BLADERF_ERR_INVAL;
+    }
+
+    const size_t history = filter->tap_num - 1;
+    const float *taps = filter->taps;
+    float *in = filter->work + 2 * history;
+    double sum = 0.0;
+
+    for (size_t i = 0; i < 2 * num_samples; i++) {
+        in[i] = (float)samples[i];
+    }
 
+    /* The history in front of the block lets every output sample use all of
+     * the taps, so the inner loop needs no bounds check. */
     for (size_t i = 0; i < num_samples; i++) {
-        acc_i = 0.0;
-        acc_q = 0.0;
+        const float *x = filter->work + 2 * i;
+        float acc_i = 0.0f;
+        float acc_q = 0.0f;
 
-        // Convolve filter with input samples
         for (size_t j = 0; j < filter->tap_num; j++) {
-            if (i >= j) {
-                acc_i += filter->filter_taps[j] * (double)samples[2*(i-j)];
-                acc_q += filter->filter_taps[j] * (double)samples[2*(i-j) + 1];
-            }
+            acc_i += taps[j] * x[2*j];
+            acc_q += taps[j] * x[2*j + 1];
         }
 
         // Clamping to the to int16_t
-        convolved_samples[2*i] = (int16_t)(fmax(fmin(acc_i, INT16_MAX), INT16_MIN));
-        convolved_samples[2*i + 1] = (int16_t)(fmax(fmin(acc_q, INT16_MAX), INT16_MIN));
+        const int32_t out_i = (int16_t)fmaxf(fminf(acc_i, INT16_MAX), INT16_MIN);
+        const int32_t out_q = (int16_t)fmaxf(fminf(acc_q, INT16_MAX), INT16_MIN);
+
+        sum += (double)(out_i * out_i + out_q * out_q);
     }
 
-    return status;
+    /* Carry the end of this block over as the history of the next */
+    memmove(filter->work, filter->work + 2 * num_samples,
+            2 * history * sizeof(float));
+
+    *power_sum += sum;
+    return 0;
 }
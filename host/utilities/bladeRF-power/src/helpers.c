@@ -29,6 +29,7 @@
 #include <ncurses.h>
 #include <math.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include "window.h"
 #include "helpers.h"
 #include "libbladeRF.h"
@@ -37,6 +38,13 @@
 
 #define INT12_MAX 2047
 
+#define UPDATE_RATE_HZ 30
+#define STREAM_BLOCK_SAMPLES (16 * 1024)
+
+// # of received blocks in flight between the streaming thread and the power
+// workers
+#define STREAM_NUM_BLOCKS 4
+
 #define CHECK(fn) do { \
     status = fn; \
     if (status != 0) { \
@@ -78,42 +86,225 @@ bladerf_direction ask_direction() {
     }
 }
 
-static int calculate_power(struct bladerf *dev, const int16_t *samples, size_t num_samples, double *power) {
-    CHECK_NULL(dev, samples, power);
+double calculate_power(double power_sum, size_t num_samples) {
+    const double avg_power = power_sum / num_samples;
+    const double max_power = INT12_MAX * INT12_MAX;
+    return 10 * log10(avg_power / max_power);
+}
+
+struct stream_state;
+
+/* Measures the power of one RX channel's blocks, so that each channel is
+ * filtered concurrently with the others and with reception */
+struct power_worker {
+    struct stream_state *state;
+    size_t index;               // Channel, among those measured
+    struct fir_filter *filter;
+    pthread_t thread;
+    bool running;
+};
+
+/* Shared between the UI, the streaming thread, and the power workers */
+struct stream_state {
+    struct bladerf *dev;
+    bladerf_direction direction;
+    size_t num_channels;
+    size_t window_samples;  // Samples per power measurement
+    int16_t *samples;       // TX block
+    pthread_t thread;
+
+    // Ring of received blocks, one buffer per channel each
+    int16_t *blocks[STREAM_NUM_BLOCKS][MAX_POWER_CHANNELS];
+    struct power_worker workers[MAX_POWER_CHANNELS];
+
+    pthread_mutex_t lock;
+    pthread_cond_t received;    // A block was received, or streaming ended
+    pthread_cond_t measured;    // A worker finished a block, or stop
+    uint64_t num_received;      // # of blocks received
+    uint64_t num_measured[MAX_POWER_CHANNELS];
+    bool stop;
+    int status;
+    double rx_power[MAX_POWER_CHANNELS];
+};
+
+/* Record the first failure, at which point the UI stops streaming
+ *
+ * Must be called with state->lock held */
+static void stream_fail(struct stream_state *state, const char *what, int status) {
+    if (state->status == 0) {
+        fprintf(stderr, "[Error] %s failed - %s\n", what,
+                bladerf_strerror(status));
+        state->status = status;
+    }
+    pthread_cond_broadcast(&state->received);
+    pthread_cond_broadcast(&state->measured);
+}
+
+/*
+ * Streams continuously at the full sample rate, so that the UI thread never
+ * blocks on (or drops samples due to) bladerf_sync_tx().
+ */
+static void *tx_stream_task(void *arg) {
+    struct stream_state *state = arg;
+    int status = 0;
+    bool stop = false;
+
+    while (status == 0 && !stop) {
+        status = bladerf_sync_tx(state->dev, state->samples,
+                                 STREAM_BLOCK_SAMPLES, NULL, 1000);
+
+        pthread_mutex_lock(&state->lock);
+        if (status != 0) {
+            stream_fail(state, "Streaming", status);
+        }
+        stop = state->stop;
+        pthread_mutex_unlock(&state->lock);
+    }
+
+    return NULL;
+}
+
+/*
+ * Receives continuously at the full sample rate, deinterleaving each block
+ * into per-channel buffers as it is copied out of the stream, and hands the
+ * blocks to the power workers. Up to STREAM_NUM_BLOCKS blocks are in flight
+ * at once, so that reception only waits if a worker falls that far behind.
+ */
+static void *rx_stream_task(void *arg) {
+    struct stream_state *state = arg;
     int status = 0;
-    double sum = 0;
-    int16_t *samples_filtered = NULL;
 
-    samples_filtered = malloc(2 * num_samples * sizeof(int16_t));
-    CHECK_NULL(samples_filtered);
+    for (uint64_t k = 0; status == 0; k++) {
+        int16_t **block = state->blocks[k % STREAM_NUM_BLOCKS];
+        bool stop = false;
+
+        // Wait for every worker to finish with this buffer's last block
+        pthread_mutex_lock(&state->lock);
+        for (size_t i = 0; i < state->num_channels; i++) {
+            while (!state->stop && state->status == 0 &&
+                   state->num_measured[i] + STREAM_NUM_BLOCKS <= k) {
+                pthread_cond_wait(&state->measured, &state->lock);
+            }
+        }
+        stop = state->stop || state->status != 0;
+        pthread_mutex_unlock(&state->lock);
+
+        if (stop) {
+            break;
+        }
 
-    CHECK(flatten_noise_figure(dev, samples, num_samples, samples_filtered));
+        status = bladerf_sync_rx_multi(state->dev, (void *const *)block,
+                                       STREAM_BLOCK_SAMPLES, NULL, 1000);
 
-    for (size_t i = 0; i < num_samples; i++) {
-        sum += (samples_filtered[2*i] * samples_filtered[2*i]) + (samples_filtered[2*i+1] * samples_filtered[2*i+1]);
+        pthread_mutex_lock(&state->lock);
+        if (status == 0) {
+            state->num_received++;
+            pthread_cond_broadcast(&state->received);
+        } else {
+            stream_fail(state, "Streaming", status);
+        }
+        pthread_mutex_unlock(&state->lock);
     }
 
-    const double avg_power = sum / num_samples;
-    const double max_power = INT12_MAX * INT12_MAX;
-    const double avg_power_dbfs = 10 * log10(avg_power / max_power);
-    *power = avg_power_dbfs;
+    return NULL;
+}
 
-error:
-    if (samples_filtered != NULL)
-        free(samples_filtered);
+/*
+ * Accumulates the power of every sample of one channel, and publishes the
+ * average once per measurement window. Every channel's windows span the same
+ * blocks, so their powers are measured over the same instants.
+ */
+static void *power_task(void *arg) {
+    struct power_worker *worker = arg;
+    struct stream_state *state = worker->state;
+    const size_t index = worker->index;
+    double power_sum = 0.0;
+    size_t window_count = 0;
+
+    for (uint64_t k = 0; ; k++) {
+        pthread_mutex_lock(&state->lock);
+        while (!state->stop && state->status == 0 && state->num_received <= k) {
+            pthread_cond_wait(&state->received, &state->lock);
+        }
+        const bool stop = state->stop || state->status != 0;
+        pthread_mutex_unlock(&state->lock);
 
-    return status;
+        if (stop) {
+            break;
+        }
+
+        int status = flatten_noise_figure(worker->filter,
+                                          state->blocks[k % STREAM_NUM_BLOCKS][index],
+                                          STREAM_BLOCK_SAMPLES, &power_sum);
+        window_count += STREAM_BLOCK_SAMPLES;
+
+        pthread_mutex_lock(&state->lock);
+        if (status != 0) {
+            stream_fail(state, "Power measurement", status);
+        } else if (window_count >= state->window_samples) {
+            state->rx_power[index] = calculate_power(power_sum, window_count);
+            power_sum              = 0.0;
+            window_count           = 0;
+        }
+
+        state->num_measured[index]++;
+        pthread_cond_broadcast(&state->measured);
+        pthread_mutex_unlock(&state->lock);
+    }
+
+    return NULL;
+}
+
+/* Stop the streaming thread and power workers, and free their buffers */
+static void stop_streaming(struct stream_state *stream, bool stream_running) {
+    pthread_mutex_lock(&stream->lock);
+    stream->stop = true;
+    pthread_cond_broadcast(&stream->received);
+    pthread_cond_broadcast(&stream->measured);
+    pthread_mutex_unlock(&stream->lock);
+
+    if (stream_running) {
+        pthread_join(stream->thread, NULL);
+    }
+
+    for (size_t i = 0; i < MAX_POWER_CHANNELS; i++) {
+        struct power_worker *worker = &stream->workers[i];
+
+        if (worker->running) {
+            pthread_join(worker->thread, NULL);
+        }
+        fir_filter_destroy(worker->filter);
+    }
+
+    for (size_t b = 0; b < STREAM_NUM_BLOCKS; b++) {
+        for (size_t i = 0; i < MAX_POWER_CHANNELS; i++) {
+            free(stream->blocks[b][i]);
+        }
+    }
+
+    free(stream->samples);
+    pthread_cond_destroy(&stream->received);
+    pthread_cond_destroy(&stream->measured);
+    pthread_mutex_destroy(&stream->lock);
 }
 
 int start_streaming(struct bladerf *dev, struct test_params *test) {
     int status = 0;
     WINDOW *main_win = NULL;
-    const size_t num_samples = test->samp_rate / 30; // 30Hz
     const struct bladerf_gain_cal_tbl *gain_tbl = NULL;
-
-    bladerf_channel ch = (test->direction == BLADERF_TX)
-        ? BLADERF_CHANNEL_TX(test->channel)
-        : BLADERF_CHANNEL_RX(test->channel);
+    struct stream_state stream = { 0 };
+    bool stream_running = false;
+    const size_t num_channels = (test->direction == BLADERF_TX) ? 1 : test->num_channels;
+    bladerf_channel chs[MAX_POWER_CHANNELS] = { 0 };
+
+    // Settings are applied to every channel measured, and read back from
+    // the first
+    for (size_t i = 0; i < num_channels; i++) {
+        chs[i] = (test->direction == BLADERF_TX)
+            ? BLADERF_CHANNEL_TX(test->channel + i)
+            : BLADERF_CHANNEL_RX(test->channel + i);
+    }
+    const bladerf_channel ch = chs[0];
 
     if (test->direction == BLADERF_TX)
         test->gain_mode = BLADERF_GAIN_MGC;
@@ -129,26 +320,75 @@ int start_streaming(struct bladerf *dev, struct test_params *test) {
     close(pipefd[1]);
     fcntl(pipefd[0], F_SETFL, O_NONBLOCK);
 
-    int16_t *samples = malloc(2 * num_samples * sizeof(int16_t));
-    if (samples == NULL) {
-        fprintf(stderr, "Error allocating memory for samples. Exiting...\n");
-        return BLADERF_ERR_INVAL;
+    stream.dev            = dev;
+    stream.direction      = test->direction;
+    stream.num_channels   = num_channels;
+    stream.window_samples = test->samp_rate / UPDATE_RATE_HZ;
+    for (size_t i = 0; i < num_channels; i++) {
+        stream.rx_power[i] = test->rx_power[i];
     }
+    pthread_mutex_init(&stream.lock, NULL);
+    pthread_cond_init(&stream.received, NULL);
+    pthread_cond_init(&stream.measured, NULL);
 
     if (test->direction == BLADERF_TX) {
-        for (size_t i = 0; i < num_samples; i++) {
-            samples[2*i]   = INT12_MAX;
-            samples[2*i+1] = INT12_MAX;
+        stream.samples = malloc(2 * STREAM_BLOCK_SAMPLES * sizeof(int16_t));
+        if (stream.samples == NULL) {
+            fprintf(stderr, "Error allocating memory for samples. Exiting...\n");
+            status = BLADERF_ERR_MEM;
+            goto error;
+        }
+
+        for (size_t i = 0; i < STREAM_BLOCK_SAMPLES; i++) {
+            stream.samples[2*i]   = INT12_MAX;
+            stream.samples[2*i+1] = INT12_MAX;
+        }
+    } else {
+        for (size_t b = 0; b < STREAM_NUM_BLOCKS; b++) {
+            for (size_t i = 0; i < num_channels; i++) {
+                stream.blocks[b][i] = malloc(2 * STREAM_BLOCK_SAMPLES * sizeof(int16_t));
+                if (stream.blocks[b][i] == NULL) {
+                    fprintf(stderr, "Error allocating memory for samples. Exiting...\n");
+                    status = BLADERF_ERR_MEM;
+                    goto error;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < num_channels; i++) {
+            struct power_worker *worker = &stream.workers[i];
+
+            worker->state = &stream;
+            worker->index = i;
+            CHECK(fir_filter_create(dev, STREAM_BLOCK_SAMPLES, &worker->filter));
+
+            if (pthread_create(&worker->thread, NULL, power_task, worker) != 0) {
+                fprintf(stderr, "Error starting a power worker. Exiting...\n");
+                status = BLADERF_ERR_UNEXPECTED;
+                goto error;
+            }
+            worker->running = true;
         }
     }
 
     CHECK(bladerf_get_gain_calibration(dev, ch, &gain_tbl));
     test->gain_cal_enabled = gain_tbl->enabled;
 
-    CHECK(bladerf_enable_module(dev, ch, true));
+    for (size_t i = 0; i < num_channels; i++) {
+        CHECK(bladerf_enable_module(dev, chs[i], true));
+    }
     CHECK(bladerf_get_gain(dev, ch, &test->gain_actual));
     CHECK(bladerf_get_frequency(dev, ch, &test->frequency_actual));
 
+    if (pthread_create(&stream.thread, NULL,
+                       (test->direction == BLADERF_TX) ? tx_stream_task : rx_stream_task,
+                       &stream) != 0) {
+        fprintf(stderr, "Error starting the streaming thread. Exiting...\n");
+        status = BLADERF_ERR_UNEXPECTED;
+        goto error;
+    }
+    stream_running = true;
+
     int cmd = 0;
     init_curses(&main_win);
     bool show_calibration_info = false;
@@ -160,7 +400,9 @@ int start_streaming(struct bladerf *dev, struct test_params *test) {
         if (cmd == 'l' || cmd == KEY_RIGHT) {
             bladerf_frequency next_freq = test->frequency + 5e6;
             test->frequency = (next_freq > test->freq_max) ? test->freq_max : next_freq;
-            CHECK(bladerf_set_frequency(dev, ch, test->frequency));
+            for (size_t i = 0; i < num_channels; i++) {
+                CHECK(bladerf_set_frequency(dev, chs[i], test->frequency));
+            }
             CHECK(bladerf_get_frequency(dev, ch, &test->frequency_actual));
         }
 
@@ -185,23 +427,32 @@ int start_streaming(struct bladerf *dev, struct test_params *test) {
         if (cmd == 'h' || cmd == KEY_LEFT) {
             bladerf_frequency next_freq = test->frequency - 5e6;
             test->frequency = (next_freq < test->freq_min) ? test->freq_min : next_freq;
-            CHECK(bladerf_set_frequency(dev, ch, test->frequency));
+            for (size_t i = 0; i < num_channels; i++) {
+                CHECK(bladerf_set_frequency(dev, chs[i], test->frequency));
+            }
             CHECK(bladerf_get_frequency(dev, ch, &test->frequency_actual));
         }
 
         if ((cmd == 'k' || cmd == KEY_UP) && test->gain + 1 <= test->gain_max) {
-            CHECK(bladerf_set_gain(dev, ch, test->gain + 1));
+            for (size_t i = 0; i < num_channels; i++) {
+                CHECK(bladerf_set_gain(dev, chs[i], test->gain + 1));
+            }
             CHECK(bladerf_get_gain(dev, ch, &test->gain_actual));
         }
 
         if ((cmd == 'j' || cmd == KEY_DOWN) && test->gain - 1 >= test->gain_min) {
-            CHECK(bladerf_set_gain(dev, ch, test->gain - 1));
+            for (size_t i = 0; i < num_channels; i++) {
+                CHECK(bladerf_set_gain(dev, chs[i], test->gain - 1));
+            }
             CHECK(bladerf_get_gain(dev, ch, &test->gain_actual));
         }
 
         if (cmd == 'c') {
             CHECK(bladerf_get_gain_calibration(dev, ch, &gain_tbl));
-            CHECK(bladerf_enable_gain_calibration(dev, ch, !gain_tbl->enabled));
+            const bool enable = !gain_tbl->enabled;
+            for (size_t i = 0; i < num_channels; i++) {
+                CHECK(bladerf_enable_gain_calibration(dev, chs[i], enable));
+            }
             CHECK(bladerf_get_gain_calibration(dev, ch, &gain_tbl));
             test->gain_cal_enabled = gain_tbl->enabled;
         }
@@ -213,7 +464,9 @@ int start_streaming(struct bladerf *dev, struct test_params *test) {
                             ? BLADERF_GAIN_DEFAULT
                             : BLADERF_GAIN_MGC;
 
-            CHECK(bladerf_set_gain_mode(dev, ch, next_mode));
+            for (size_t i = 0; i < num_channels; i++) {
+                CHECK(bladerf_set_gain_mode(dev, chs[i], next_mode));
+            }
             CHECK(bladerf_get_gain_mode(dev, ch, &test->gain_mode));
         }
 
@@ -236,16 +489,18 @@ int start_streaming(struct bladerf *dev, struct test_params *test) {
             display_overlay(main_win, cal_tbl);
         }
 
-        if (test->direction == BLADERF_RX) {
-            CHECK(bladerf_sync_rx(dev, samples, num_samples, NULL, 1000));
-            CHECK(calculate_power(dev, samples, num_samples, &test->rx_power));
-        } else {
-            CHECK(bladerf_sync_tx(dev, samples, num_samples, NULL, 1000));
+        pthread_mutex_lock(&stream.lock);
+        for (size_t i = 0; i < num_channels; i++) {
+            test->rx_power[i] = stream.rx_power[i];
         }
+        status = stream.status;
+        pthread_mutex_unlock(&stream.lock);
+
+        napms(1000 / UPDATE_RATE_HZ);
     }
 
 error:
-    free(samples);
+    stop_streaming(&stream, stream_running);
     delwin(main_win);
     endwin();
 
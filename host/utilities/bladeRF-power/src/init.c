@@ -41,6 +41,7 @@
 
 void init_params(struct test_params *test) {
     test->channel          = 0;
+    test->num_channels     = 1;
     test->frequency        = 1e9;
     test->frequency_actual = test->frequency;
     test->freq_min         = 65e6;
@@ -56,7 +57,9 @@ void init_params(struct test_params *test) {
     test->bandwidth = test->samp_rate;
     test->direction = DIRECTION_UNSET;
 
-    test->rx_power = 0.0;
+    for (size_t i = 0; i < MAX_POWER_CHANNELS; i++) {
+        test->rx_power[i] = 0.0;
+    }
     test->gain_cal_enabled = false;
     test->gain_cal_file = NULL;
 }
@@ -65,7 +68,10 @@ int dev_init(struct bladerf *dev, bladerf_direction dir, struct test_params *tes
     int status = 0;
     const struct bladerf_range *freq_range;
     const struct bladerf_range *gain_range;
-    bladerf_channel_layout layout = (dir == BLADERF_TX) ? BLADERF_TX_X1 : BLADERF_RX_X1;
+    const size_t num_channels = (dir == BLADERF_TX) ? 1 : test->num_channels;
+    bladerf_channel_layout layout = (dir == BLADERF_TX) ? BLADERF_TX_X1
+                                  : (num_channels == 2) ? BLADERF_RX_X2
+                                                        : BLADERF_RX_X1;
     bladerf_format format = BLADERF_FORMAT_SC16_Q11;
     size_t num_buffers = 512;
     size_t buffer_size = 16*1024;
@@ -76,15 +82,27 @@ int dev_init(struct bladerf *dev, bladerf_direction dir, struct test_params *tes
         ? BLADERF_CHANNEL_TX(test->channel)
         : BLADERF_CHANNEL_RX(test->channel);
 
-    CHECK(bladerf_set_gain(dev, ch, test->gain));
-    CHECK(bladerf_set_sample_rate(dev, ch, test->samp_rate, NULL));
-    CHECK(bladerf_set_bandwidth(dev, ch, test->bandwidth, &test->bandwidth));
-    CHECK(bladerf_set_frequency(dev, ch, test->frequency));
+    // Every channel measured is set up alike, and the first one's ranges
+    // are used for all of them
+    for (size_t i = 0; i < num_channels; i++) {
+        const bladerf_channel ch_i = (dir == BLADERF_TX)
+            ? BLADERF_CHANNEL_TX(test->channel + i)
+            : BLADERF_CHANNEL_RX(test->channel + i);
+
+        CHECK(bladerf_set_gain(dev, ch_i, test->gain));
+        CHECK(bladerf_set_sample_rate(dev, ch_i, test->samp_rate, NULL));
+        CHECK(bladerf_set_bandwidth(dev, ch_i, test->bandwidth, &test->bandwidth));
+        CHECK(bladerf_set_frequency(dev, ch_i, test->frequency));
+
+        if (dir == BLADERF_RX) {
+            CHECK(bladerf_set_gain_mode(dev, ch_i, test->gain_mode));
+        }
+    }
+
     CHECK(bladerf_sync_config(dev, layout, format, num_buffers, buffer_size,
                               num_transfers, stream_timeout));
 
     if (dir == BLADERF_RX) {
-        CHECK(bladerf_set_gain_mode(dev, ch, test->gain_mode));
         CHECK(bladerf_get_gain_mode(dev, ch, &test->gain_mode));
     }
 
@@ -96,7 +114,16 @@ int dev_init(struct bladerf *dev, bladerf_direction dir, struct test_params *tes
     test->gain_min = gain_range->min * gain_range->scale;
     test->gain_max = gain_range->max * gain_range->scale;
 
-    CHECK(bladerf_load_gain_calibration(dev, ch, test->gain_cal_file));
+    // A given file holds a single channel's calibration, so the other
+    // channels load their own
+    for (size_t i = 0; i < num_channels; i++) {
+        const bladerf_channel ch_i = (dir == BLADERF_TX)
+            ? BLADERF_CHANNEL_TX(test->channel + i)
+            : BLADERF_CHANNEL_RX(test->channel + i);
+
+        CHECK(bladerf_load_gain_calibration(dev, ch_i,
+                                            (i == 0) ? test->gain_cal_file : NULL));
+    }
 
 error:
     return status;
@@ -27,10 +27,12 @@
  */
 #include <stdio.h>
 #include <getopt.h>
+#include <strings.h>
 #include "libbladeRF.h"
 #include "init.h"
 #include "helpers.h"
 #include "conversions.h"
+#include "sweep.h"
 
 #define CHECK(fn) do { \
     status = fn; \
@@ -41,17 +43,24 @@
     } \
 } while (0)
 
-#define OPTSTR "d:c:l:trf:s:v:h"
+#define OPTSTR "d:c:l:trmf:s:v:hS:g:w:T:o:F:"
 struct option long_options[] = {
     { "device",     required_argument,  NULL,   'd' },
     { "channel",    required_argument,  NULL,   'c' },
     { "load",       required_argument,  NULL,   'l' },
     { "tx",         no_argument,        NULL,   't' },
     { "rx",         no_argument,        NULL,   'r' },
+    { "mimo",       no_argument,        NULL,   'm' },
     { "frequency",  required_argument,  NULL,   'f' },
     { "sample-rate",required_argument,  NULL,   's' },
     { "verbosity",  optional_argument,  NULL,   'v' },
     { "help",       no_argument,        NULL,   'h' },
+    { "sweep",      required_argument,  NULL,   'S' },
+    { "gain",       required_argument,  NULL,   'g' },
+    { "dwell",      required_argument,  NULL,   'w' },
+    { "settle",     required_argument,  NULL,   'T' },
+    { "output",     required_argument,  NULL,   'o' },
+    { "format",     required_argument,  NULL,   'F' },
     { NULL,         0,                  NULL,   0   },
 };
 
@@ -70,6 +79,9 @@ int main(int argc, char *argv[])
     struct test_params test;
     init_params(&test);
 
+    struct sweep_params sweep;
+    init_sweep_params(&sweep);
+
     while (opt != -1) {
         opt = getopt_long(argc, argv, OPTSTR, long_options, &opt_ind);
 
@@ -102,6 +114,10 @@ int main(int argc, char *argv[])
                 test.direction = (opt == 't') ? BLADERF_TX : BLADERF_RX;
                 break;
 
+            case 'm':
+                test.num_channels = 2;
+                break;
+
             case 'l':
                 test.gain_cal_file = optarg;
                 break;
@@ -120,6 +136,53 @@ int main(int argc, char *argv[])
                 }
                 break;
 
+            case 'S':
+                if (!parse_freq_range(optarg, &sweep)) {
+                    fprintf(stderr, "Invalid frequency sweep: %s\n", optarg);
+                    return -1;
+                }
+                sweep.enabled = true;
+                break;
+
+            case 'g':
+                if (!parse_gain_range(optarg, &sweep)) {
+                    fprintf(stderr, "Invalid gain sweep: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'w':
+                sweep.dwell_samples = str2uint_suffix(optarg, 1, UINT32_MAX,
+                    NULL, 0, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid dwell: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'T':
+                sweep.settle_us = str2uint(optarg, 0, UINT32_MAX, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid settling time: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
+            case 'o':
+                sweep.output_file = optarg;
+                break;
+
+            case 'F':
+                if (strcasecmp(optarg, "csv") == 0) {
+                    sweep.format = SWEEP_OUTPUT_CSV;
+                } else if (strcasecmp(optarg, "json") == 0) {
+                    sweep.format = SWEEP_OUTPUT_JSON;
+                } else {
+                    fprintf(stderr, "Invalid output format: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
             case 'h':
                 printf("Usage: %s [options]\n", argv[0]);
                 printf("  -d, --device <str>        Specify the device to open.\n");
@@ -127,11 +190,20 @@ int main(int argc, char *argv[])
                 printf("  -l, --load <file>         Load a specified gain cal file (.csv or .tbl).\n");
                 printf("  -t, --tx                  Transmit mode. Can't be combined with --rx.\n");
                 printf("  -r, --rx                  Receive mode. Can't be combined with --tx.\n");
+                printf("  -m, --mimo                Measure RX channels 0 and 1 at once (RX only).\n");
                 printf("  -f, --frequency <freq>    Set the initial frequency (in Hz).\n");
                 printf("  -s, --sample-rate <rate>  Set the initial sample rate (in Hz).\n");
                 printf("  -v, --verbosity <level>   Set the libbladeRF verbosity level (e.g., verbose, debug).\n");
                 printf("  -h, --help                Display this help text and exit.\n");
                 printf("\n");
+                printf("Sweep options (RX only, no interactive display):\n");
+                printf("  -S, --sweep <start:stop:step>  Measure power at each frequency.\n");
+                printf("  -g, --gain <min:max:step>      Repeat the sweep at each gain (in dB).\n");
+                printf("  -w, --dwell <samples>          Samples measured per point (default: 16K).\n");
+                printf("  -T, --settle <us>              Settling time after each retune (default: 500).\n");
+                printf("  -o, --output <file>            Write results to a file (default: stdout).\n");
+                printf("  -F, --format <csv|json>        Result format (default: csv).\n");
+                printf("\n");
                 return 0;
 
             default:
@@ -145,12 +217,34 @@ int main(int argc, char *argv[])
     CHECK(bladerf_get_devinfo(dev, &devinfo));
     printf("Device: %s\n", devinfo.serial);
 
-    if (test.direction == DIRECTION_UNSET) {
+    if (test.num_channels > 1) {
+        if (sweep.enabled || test.direction == BLADERF_TX || test.channel != 0) {
+            fprintf(stderr, "--mimo measures RX channels 0 and 1, and can't be "
+                            "combined with --tx, --channel, or --sweep.\n");
+            status = BLADERF_ERR_INVAL;
+            goto error;
+        }
+        test.direction = BLADERF_RX;
+    }
+
+    if (sweep.enabled) {
+        if (test.direction == BLADERF_TX) {
+            fprintf(stderr, "Sweeps are only supported for RX.\n");
+            status = BLADERF_ERR_INVAL;
+            goto error;
+        }
+        test.direction = BLADERF_RX;
+    } else if (test.direction == DIRECTION_UNSET) {
         test.direction = ask_direction();
     }
 
     CHECK(dev_init(dev, test.direction, &test));
-    CHECK(start_streaming(dev, &test));
+
+    if (sweep.enabled) {
+        CHECK(run_sweep(dev, &test, &sweep));
+    } else {
+        CHECK(start_streaming(dev, &test));
+    }
 
 error:
     if (dev) bladerf_close(dev);
@@ -0,0 +1,305 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This program is intended to verify that C programs build against
+ * libbladeRF without any unintended dependencies.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "sweep.h"
+#include "filter.h"
+#include "helpers.h"
+#include "log.h"
+#include "conversions.h"
+
+#define CHECK(fn) do { \
+    status = fn; \
+    if (status != 0) { \
+        fprintf(stderr, "[Error] %s:%d: %s - %s\n", __FILE__, __LINE__, #fn, bladerf_strerror(status)); \
+        fprintf(stderr, "Exiting.\n"); \
+        goto error; \
+    } \
+} while (0)
+
+// Small buffers keep the latency between the device and host short, so that
+// retunes can be scheduled only a short time ahead
+#define SWEEP_NUM_BUFFERS   16
+#define SWEEP_BUFFER_SIZE   8192
+#define SWEEP_NUM_TRANSFERS 8
+#define SWEEP_TIMEOUT_MS    1000
+
+// How far ahead of the device's current time each pass begins
+#define SWEEP_LEAD_MS       50
+
+#define SWEEP_RANGE_MAXLEN  64
+
+void init_sweep_params(struct sweep_params *sweep) {
+    memset(sweep, 0, sizeof(*sweep));
+    sweep->enabled       = false;
+    sweep->gain_set      = false;
+    sweep->dwell_samples = 16 * 1024;
+    sweep->settle_us     = 500;
+    sweep->output_file   = NULL;
+    sweep->format        = SWEEP_OUTPUT_CSV;
+}
+
+/* Split "a:b:c" or "a" into fields. Returns the number of fields, or 0 if
+ * there are neither 1 nor 3. */
+static int split_range(const char *str, char *buf, char *fields[3]) {
+    char *saveptr = NULL;
+    int count = 0;
+
+    if (strlen(str) >= SWEEP_RANGE_MAXLEN) {
+        return 0;
+    }
+
+    strcpy(buf, str);
+    for (char *tok = strtok_r(buf, ":", &saveptr); tok != NULL;
+         tok = strtok_r(NULL, ":", &saveptr)) {
+        if (count == 3) {
+            return 0;
+        }
+        fields[count++] = tok;
+    }
+
+    return (count == 1 || count == 3) ? count : 0;
+}
+
+bool parse_freq_range(const char *str, struct sweep_params *sweep) {
+    char buf[SWEEP_RANGE_MAXLEN];
+    char *fields[3];
+    bool ok = true;
+    int count = split_range(str, buf, fields);
+
+    if (count == 0) {
+        return false;
+    }
+
+    sweep->freq_start = str2uint64_suffix(fields[0], 0, UINT64_MAX,
+        freq_suffixes, NUM_FREQ_SUFFIXES, &ok);
+    sweep->freq_stop = sweep->freq_start;
+    sweep->freq_step = 1;
+
+    if (ok && count == 3) {
+        sweep->freq_stop = str2uint64_suffix(fields[1], 0, UINT64_MAX,
+            freq_suffixes, NUM_FREQ_SUFFIXES, &ok);
+        if (ok) {
+            sweep->freq_step = str2uint64_suffix(fields[2], 1, UINT64_MAX,
+                freq_suffixes, NUM_FREQ_SUFFIXES, &ok);
+        }
+    }
+
+    return ok && sweep->freq_stop >= sweep->freq_start;
+}
+
+bool parse_gain_range(const char *str, struct sweep_params *sweep) {
+    char buf[SWEEP_RANGE_MAXLEN];
+    char *fields[3];
+    bool ok = true;
+    int count = split_range(str, buf, fields);
+
+    if (count == 0) {
+        return false;
+    }
+
+    sweep->gain_start = str2int(fields[0], INT32_MIN, INT32_MAX, &ok);
+    sweep->gain_stop  = sweep->gain_start;
+    sweep->gain_step  = 1;
+
+    if (ok && count == 3) {
+        sweep->gain_stop = str2int(fields[1], INT32_MIN, INT32_MAX, &ok);
+        if (ok) {
+            sweep->gain_step = str2int(fields[2], 1, INT32_MAX, &ok);
+        }
+    }
+
+    sweep->gain_set = ok;
+    return ok && sweep->gain_stop >= sweep->gain_start;
+}
+
+static void write_header(FILE *out, sweep_output_format format) {
+    if (format == SWEEP_OUTPUT_JSON) {
+        fprintf(out, "[\n");
+    } else {
+        fprintf(out, "frequency_hz,gain_db,power_dbfs,timestamp,overrun\n");
+    }
+}
+
+static void write_point(FILE *out, sweep_output_format format, bool first,
+                        bladerf_frequency frequency, bladerf_gain gain,
+                        double power_dbfs, bladerf_timestamp timestamp,
+                        bool overrun) {
+    if (format == SWEEP_OUTPUT_JSON) {
+        fprintf(out, "%s  { \"frequency_hz\": %" PRIu64 ", \"gain_db\": %" PRIi32
+                ", \"power_dbfs\": %.2f, \"timestamp\": %" PRIu64
+                ", \"overrun\": %s }",
+                first ? "" : ",\n", frequency, gain, power_dbfs, timestamp,
+                overrun ? "true" : "false");
+    } else {
+        fprintf(out, "%" PRIu64 ",%" PRIi32 ",%.2f,%" PRIu64 ",%d\n",
+                frequency, gain, power_dbfs, timestamp, overrun ? 1 : 0);
+    }
+}
+
+static void write_footer(FILE *out, sweep_output_format format, bool empty) {
+    if (format == SWEEP_OUTPUT_JSON) {
+        fprintf(out, "%s]\n", empty ? "" : "\n");
+    }
+}
+
+int run_sweep(struct bladerf *dev,
+              struct test_params *test,
+              const struct sweep_params *sweep) {
+    int status = 0;
+    const bladerf_channel ch = BLADERF_CHANNEL_RX(test->channel);
+    const uint64_t settle = (uint64_t)test->samp_rate * sweep->settle_us / 1000000;
+    const uint64_t hop_interval = settle + sweep->dwell_samples;
+    const size_t num_freqs =
+        (sweep->freq_stop - sweep->freq_start) / sweep->freq_step + 1;
+    const bladerf_gain gain_start = sweep->gain_set ? sweep->gain_start : test->gain;
+    const bladerf_gain gain_stop  = sweep->gain_set ? sweep->gain_stop  : test->gain;
+    const bladerf_gain gain_step  = sweep->gain_set ? sweep->gain_step  : 1;
+
+    bladerf_frequency *freqs = NULL;
+    struct bladerf_quick_tune *quick_tunes = NULL;
+    int16_t *samples = NULL;
+    struct fir_filter *filter = NULL;
+    FILE *out = stdout;
+    bool first = true;
+
+    if (test->direction != BLADERF_RX) {
+        fprintf(stderr, "Sweeps are only supported for RX.\n");
+        return BLADERF_ERR_INVAL;
+    }
+
+    if (sweep->output_file != NULL) {
+        out = fopen(sweep->output_file, "w");
+        if (out == NULL) {
+            perror(sweep->output_file);
+            return BLADERF_ERR_IO;
+        }
+    }
+
+    freqs       = calloc(num_freqs, sizeof(freqs[0]));
+    quick_tunes = calloc(num_freqs, sizeof(quick_tunes[0]));
+    samples     = malloc(2 * sweep->dwell_samples * sizeof(int16_t));
+    if (freqs == NULL || quick_tunes == NULL || samples == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto error;
+    }
+
+    CHECK(fir_filter_create(dev, sweep->dwell_samples, &filter));
+
+    // Tune to each point once, up front, so the sweep itself only needs
+    // quick retunes
+    for (size_t i = 0; i < num_freqs; i++) {
+        freqs[i] = sweep->freq_start + i * sweep->freq_step;
+        CHECK(bladerf_set_frequency(dev, ch, freqs[i]));
+        CHECK(bladerf_get_quick_tune(dev, ch, &quick_tunes[i]));
+    }
+
+    CHECK(bladerf_sync_config(dev, BLADERF_RX_X1, BLADERF_FORMAT_SC16_Q11_META,
+                              SWEEP_NUM_BUFFERS, SWEEP_BUFFER_SIZE,
+                              SWEEP_NUM_TRANSFERS, SWEEP_TIMEOUT_MS));
+    CHECK(bladerf_set_gain_mode(dev, ch, BLADERF_GAIN_MGC));
+    CHECK(bladerf_enable_module(dev, ch, true));
+
+    write_header(out, sweep->format);
+
+    for (bladerf_gain gain = gain_start; gain <= gain_stop; gain += gain_step) {
+        bladerf_gain gain_actual;
+        bladerf_timestamp start;
+        size_t scheduled = 0;
+
+        CHECK(bladerf_set_gain(dev, ch, gain));
+        CHECK(bladerf_get_gain(dev, ch, &gain_actual));
+
+        CHECK(bladerf_get_timestamp(dev, BLADERF_RX, &start));
+        start += (uint64_t)test->samp_rate * SWEEP_LEAD_MS / 1000;
+
+        for (size_t i = 0; i < num_freqs; i++) {
+            const bladerf_timestamp hop_ts = start + i * hop_interval;
+            struct bladerf_metadata meta;
+            double power_sum = 0.0;
+
+            // Keep the device's retune queue topped up ahead of the samples
+            // being received
+            while (scheduled < num_freqs) {
+                status = bladerf_schedule_retune(dev, ch,
+                    start + scheduled * hop_interval, 0, &quick_tunes[scheduled]);
+                if (status == BLADERF_ERR_QUEUE_FULL && scheduled > i) {
+                    status = 0;
+                    break;
+                }
+                CHECK(status);
+                scheduled++;
+            }
+
+            // Measure from the end of the settling time up to the next hop
+            memset(&meta, 0, sizeof(meta));
+            meta.timestamp = hop_ts + settle;
+            CHECK(bladerf_sync_rx(dev, samples, sweep->dwell_samples, &meta,
+                                  SWEEP_TIMEOUT_MS));
+
+            if (meta.actual_count == 0) {
+                log_error("No samples received at %" PRIu64 " Hz\n", freqs[i]);
+                status = BLADERF_ERR_UNEXPECTED;
+                goto error;
+            }
+
+            fir_filter_reset(filter);
+            CHECK(flatten_noise_figure(filter, samples, meta.actual_count,
+                                       &power_sum));
+
+            write_point(out, sweep->format, first, freqs[i], gain_actual,
+                        calculate_power(power_sum, meta.actual_count),
+                        meta.timestamp,
+                        (meta.status & BLADERF_META_STATUS_OVERRUN) != 0);
+            first = false;
+        }
+    }
+
+    write_footer(out, sweep->format, first);
+
+error:
+    bladerf_cancel_scheduled_retunes(dev, ch);
+    bladerf_enable_module(dev, ch, false);
+
+    fir_filter_destroy(filter);
+    free(samples);
+    free(quick_tunes);
+    free(freqs);
+
+    if (out != stdout) {
+        if (fclose(out) != 0 && status == 0) {
+            status = BLADERF_ERR_IO;
+        }
+    } else {
+        fflush(out);
+    }
+
+    return status;
+}
@@ -92,8 +92,13 @@ void update_window(WINDOW *win, struct test_params *test) {
 
     werase(win);
 
-    mvwprintw(win, start_y++, 1, "Channel:    %s(%i)\n",
-        test->direction == BLADERF_TX ? "TX" : "RX", test->channel);
+    if (test->direction == BLADERF_RX && test->num_channels > 1) {
+        mvwprintw(win, start_y++, 1, "Channels:   RX(%i), RX(%i)\n",
+            test->channel, test->channel + 1);
+    } else {
+        mvwprintw(win, start_y++, 1, "Channel:    %s(%i)\n",
+            test->direction == BLADERF_TX ? "TX" : "RX", test->channel);
+    }
     mvwprintw(win, start_y++, 1, "Gain Calibration: %s\n", test->gain_cal_enabled ? "enabled" : "disabled");
     mvwprintw(win, start_y++, 1, "Automatic Gain Control: %s\n", test->gain_mode == BLADERF_GAIN_MGC ? "disabled" : "enabled");
     mvwprintw(win, start_y++, 1, "Sample Rate:  %7.3f %sHz\n",
@@ -109,14 +114,30 @@ void update_window(WINDOW *win, struct test_params *test) {
         mvwprintw(win, start_y++, 1, "Output Pwr:  %" PRIi32 "dBm, range: [%" PRIi32 ", %" PRIi32 "]\n",
             test->gain-60, test->gain_min-60, test->gain_max-60);
         display_double(win, test->gain-60, start_y+=2, 1, POWER_SUFFIX_DBM);
+    } else if (test->direction == BLADERF_RX && test->num_channels > 1) {
+        // Each channel's power, measured over the same samples, in place of
+        // the large display
+        for (size_t i = 0; i < test->num_channels; i++) {
+            if (test->gain_cal_enabled) {
+                mvwprintw(win, start_y++, 1, "RX(%zu) Power: %0.2fdBFS, %0.2fdBm\n",
+                    test->channel + i, test->rx_power[i],
+                    rx_power_dbfs_to_dbm(test->rx_power[i], test->gain));
+            } else {
+                mvwprintw(win, start_y++, 1, "RX(%zu) Power: %0.2fdBFS\n",
+                    test->channel + i, test->rx_power[i]);
+            }
+        }
+        mvwprintw(win, start_y++, 1, "Mismatch:    %0.2fdB (RX(%i) - RX(%i))\n",
+            test->rx_power[1] - test->rx_power[0],
+            test->channel + 1, test->channel);
     } else if (test->gain_cal_enabled && test->direction == BLADERF_RX) {
         mvwprintw(win, start_y++, 1, "Avg Power:   %0.2fdBFS, %0.2fdBm",
-            test->rx_power, rx_power_dbfs_to_dbm(test->rx_power, test->gain));
-        display_double(win, rx_power_dbfs_to_dbm(test->rx_power, test->gain),
+            test->rx_power[0], rx_power_dbfs_to_dbm(test->rx_power[0], test->gain));
+        display_double(win, rx_power_dbfs_to_dbm(test->rx_power[0], test->gain),
             start_y+=2, 1, POWER_SUFFIX_DBM);
     } else if (test->direction == BLADERF_RX) {
-        mvwprintw(win, start_y++, 1, "Avg Power:   %0.2fdBFS", test->rx_power);
-        display_double(win, test->rx_power, start_y+=2, 1, POWER_SUFFIX_DBFS);
+        mvwprintw(win, start_y++, 1, "Avg Power:   %0.2fdBFS", test->rx_power[0]);
+        display_double(win, test->rx_power[0], start_y+=2, 1, POWER_SUFFIX_DBFS);
     }
 
     if (test->show_messages) {
@@ -0,0 +1,139 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * Serves a local bladeRF to clients of libbladeRF's network backend.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <getopt.h>
+#include "libbladeRF.h"
+#include "conversions.h"
+
+#define OPTSTR "d:a:p:v:h"
+static struct option long_options[] = {
+    { "device",     required_argument,  NULL,   'd' },
+    { "address",    required_argument,  NULL,   'a' },
+    { "port",       required_argument,  NULL,   'p' },
+    { "verbosity",  required_argument,  NULL,   'v' },
+    { "help",       no_argument,        NULL,   'h' },
+    { NULL,         0,                  NULL,   0   },
+};
+
+static struct bladerf *dev = NULL;
+
+static void handle_signal(int signo)
+{
+    (void)signo;
+    bladerf_net_serve_stop(dev);
+}
+
+static void usage(const char *argv0)
+{
+    printf("Usage: %s [options]\n", argv0);
+    printf("Serve a local bladeRF to remote clients, which open it with the\n");
+    printf("device string \"net:host=<server> [port=<port>]\".\n");
+    printf("\n");
+    printf("  -d, --device <str>        Specify the device to serve.\n");
+    printf("  -a, --address <addr>      Local address to listen on (default: all).\n");
+    printf("  -p, --port <port>         Port to listen on (default: %u).\n",
+           BLADERF_NET_DEFAULT_PORT);
+    printf("  -v, --verbosity <level>   Set the libbladeRF verbosity level (e.g., verbose, debug).\n");
+    printf("  -h, --help                Display this help text and exit.\n");
+    printf("\n");
+    printf("The protocol is not authenticated or encrypted. Only serve devices\n");
+    printf("on trusted networks.\n");
+}
+
+int main(int argc, char *argv[])
+{
+    int status;
+    const char *devstr  = NULL;
+    const char *address = NULL;
+    unsigned int port   = BLADERF_NET_DEFAULT_PORT;
+    bladerf_log_level log_level = BLADERF_LOG_LEVEL_INFO;
+    struct sigaction sa;
+    int opt;
+    bool ok;
+
+    while ((opt = getopt_long(argc, argv, OPTSTR, long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'd':
+                devstr = optarg;
+                break;
+
+            case 'a':
+                address = optarg;
+                break;
+
+            case 'p':
+                port = str2uint(optarg, 1, UINT16_MAX, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid port: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'v':
+                log_level = str2loglevel(optarg, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid log level: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'h':
+                usage(argv[0]);
+                return 0;
+
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    bladerf_log_set_verbosity(log_level);
+
+    status = bladerf_open(&dev, devstr);
+    if (status != 0) {
+        fprintf(stderr, "Failed to open device: %s\n",
+                bladerf_strerror(status));
+        return 1;
+    }
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    status = bladerf_net_serve(dev, address, (uint16_t)port);
+    if (status != 0) {
+        fprintf(stderr, "Failed to serve device: %s\n",
+                bladerf_strerror(status));
+    }
+
+    bladerf_close(dev);
+    return status == 0 ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * Radix-2 complex FFT. A plan holds the bit reversal permutation and
+ * twiddle factors for one size, and may be shared by any number of threads.
+ */
+#ifndef FFT_H_
+#define FFT_H_
+
+#include <stdbool.h>
+
+struct fft_cplx {
+    float re;
+    float im;
+};
+
+struct fft_plan;
+
+/**
+ * @brief Create a plan for transforms of `n` points
+ *
+ * @param plan  Created plan
+ * @param n     Transform size, a power of two of at least 2
+ *
+ * @return 0 on success, -1 if `n` is invalid or memory could not be allocated
+ */
+int fft_plan_create(struct fft_plan **plan, unsigned int n);
+
+/**
+ * @brief Compute a forward transform in place
+ *
+ * @param plan  Plan for the size of `data`
+ * @param data  Samples, replaced by their transform
+ */
+void fft_execute(const struct fft_plan *plan, struct fft_cplx *data);
+
+/**
+ * @brief Free a plan. Passing NULL is a no-op.
+ */
+void fft_plan_free(struct fft_plan *plan);
+
+/**
+ * @brief Check whether `n` is a supported transform size
+ */
+bool fft_size_valid(unsigned int n);
+
+#endif // FFT_H_
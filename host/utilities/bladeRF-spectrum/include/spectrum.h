@@ -0,0 +1,109 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * Averaged power spectra of sweep steps, computed on a pool of worker
+ * threads and stitched into one panorama row per pass.
+ */
+#ifndef SPECTRUM_H_
+#define SPECTRUM_H_
+
+#include <stdint.h>
+#include "libbladeRF.h"
+
+struct spectrum;
+
+struct spectrum_config {
+    unsigned int fft_size;      // Points per FFT, a power of two
+    unsigned int averages;      // FFT frames averaged per step
+    unsigned int num_steps;     // Sweep steps per pass
+    unsigned int step_bins;     // Center bins of each step kept in a row
+    unsigned int num_workers;   // FFT threads
+};
+
+/**
+ * @brief Create a spectrum and start its worker threads
+ *
+ * @param s     Created spectrum
+ * @param cfg   Configuration
+ *
+ * @return 0 on success, -1 if the configuration is invalid or resources
+ *         could not be allocated
+ */
+int spectrum_init(struct spectrum **s, const struct spectrum_config *cfg);
+
+/**
+ * @brief Queue a sweep block's settled samples for processing
+ *
+ * The samples are copied, so the block may be reused on return. This blocks
+ * while every buffer is in use, or while the block's pass is too far ahead
+ * of the rows consumed via spectrum_next_row().
+ *
+ * Blocks with fewer than one FFT frame of settled samples, which an overrun
+ * can leave, produce NAN levels for their step.
+ *
+ * @return 0 on success, -1 if the spectrum was stopped, or the block's index
+ *         is out of range
+ */
+int spectrum_submit(struct spectrum *s,
+                    const struct bladerf_sweep_block *block);
+
+/**
+ * @brief Indicate that no more blocks will be submitted
+ *
+ * spectrum_next_row() returns the rows completed by the blocks already
+ * queued, and then NULL.
+ */
+void spectrum_finish(struct spectrum *s);
+
+/**
+ * @brief Wait for the next pass's row to be complete
+ *
+ * Each row holds num_steps * step_bins power levels, in dBFS, in order of
+ * increasing frequency provided the swept frequencies increase.
+ *
+ * @param s     Spectrum
+ * @param pass  Set to the row's pass number
+ *
+ * @return The row, valid until spectrum_release_row(), or NULL once the
+ *         spectrum is finished or stopped
+ */
+const float *spectrum_next_row(struct spectrum *s, uint64_t *pass);
+
+/**
+ * @brief Release the row returned by spectrum_next_row()
+ */
+void spectrum_release_row(struct spectrum *s);
+
+/**
+ * @brief Stop processing, and wake any thread waiting on the spectrum
+ */
+void spectrum_stop(struct spectrum *s);
+
+/**
+ * @brief Stop the worker threads and free the spectrum. Passing NULL is a
+ *        no-op.
+ */
+void spectrum_free(struct spectrum *s);
+
+#endif // SPECTRUM_H_
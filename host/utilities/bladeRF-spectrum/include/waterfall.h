@@ -0,0 +1,85 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * ncurses waterfall of panorama rows. Rows added between draws are max-held
+ * into a single line, so the display scrolls at its own pace regardless of
+ * how quickly passes complete.
+ */
+#ifndef WATERFALL_H_
+#define WATERFALL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct waterfall;
+
+/**
+ * @brief Start ncurses mode and create a waterfall
+ *
+ * @param wf        Created waterfall
+ * @param start_hz  Center frequency of the first bin of each row
+ * @param bin_hz    Width of each bin
+ * @param num_bins  Bins per row
+ * @param floor_db  Level drawn as the bottom of the scale, in dBFS
+ * @param range_db  Span of the scale, in dB
+ *
+ * @return 0 on success, -1 if memory could not be allocated
+ */
+int waterfall_init(struct waterfall **wf,
+                   double start_hz,
+                   double bin_hz,
+                   unsigned int num_bins,
+                   float floor_db,
+                   float range_db);
+
+/**
+ * @brief Max-hold a row into the next line to be drawn
+ */
+void waterfall_add(struct waterfall *wf, const float *row);
+
+/**
+ * @brief Scroll the waterfall, drawing the rows added since the last draw
+ *        as its newest line. This is a no-op if no rows have been added.
+ *
+ * @param wf    Waterfall
+ * @param pass  Pass number of the most recently added row
+ */
+void waterfall_draw(struct waterfall *wf, uint64_t pass);
+
+/**
+ * @brief Handle pending key presses, without blocking
+ *
+ * Up and down raise and lower the scale by 5 dB, + and - widen and narrow
+ * it by 5 dB, and q quits.
+ *
+ * @return false if q was pressed, true otherwise
+ */
+bool waterfall_poll(struct waterfall *wf);
+
+/**
+ * @brief End ncurses mode and free the waterfall. Passing NULL is a no-op.
+ */
+void waterfall_close(struct waterfall *wf);
+
+#endif // WATERFALL_H_
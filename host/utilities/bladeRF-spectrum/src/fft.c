@@ -0,0 +1,132 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <math.h>
+#include <stdlib.h>
+#include "fft.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+struct fft_plan {
+    unsigned int n;
+    unsigned int *rev;          // Bit reversed index of each point
+    struct fft_cplx *twiddle;   // exp(-2 pi i k / n), for k < n / 2
+};
+
+bool fft_size_valid(unsigned int n) {
+    return n >= 2 && (n & (n - 1)) == 0;
+}
+
+int fft_plan_create(struct fft_plan **plan_out, unsigned int n) {
+    struct fft_plan *plan;
+    unsigned int bits = 0;
+
+    *plan_out = NULL;
+
+    if (!fft_size_valid(n)) {
+        return -1;
+    }
+
+    while ((1u << bits) < n) {
+        bits++;
+    }
+
+    plan = calloc(1, sizeof(*plan));
+    if (plan == NULL) {
+        return -1;
+    }
+
+    plan->n       = n;
+    plan->rev     = malloc(n * sizeof(plan->rev[0]));
+    plan->twiddle = malloc(n / 2 * sizeof(plan->twiddle[0]));
+    if (plan->rev == NULL || plan->twiddle == NULL) {
+        fft_plan_free(plan);
+        return -1;
+    }
+
+    for (unsigned int i = 0; i < n; i++) {
+        unsigned int r = 0;
+        for (unsigned int b = 0; b < bits; b++) {
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        plan->rev[i] = r;
+    }
+
+    // Computed in double precision, so errors do not accumulate across
+    // stages as they would with a recurrence
+    for (unsigned int k = 0; k < n / 2; k++) {
+        const double a = -2.0 * M_PI * k / n;
+        plan->twiddle[k].re = (float)cos(a);
+        plan->twiddle[k].im = (float)sin(a);
+    }
+
+    *plan_out = plan;
+    return 0;
+}
+
+void fft_execute(const struct fft_plan *plan, struct fft_cplx *data) {
+    const unsigned int n = plan->n;
+
+    for (unsigned int i = 0; i < n; i++) {
+        const unsigned int r = plan->rev[i];
+        if (r > i) {
+            struct fft_cplx tmp = data[i];
+            data[i] = data[r];
+            data[r] = tmp;
+        }
+    }
+
+    // Iterative decimation in time. At each stage, butterflies of span
+    // `half` use every `stride`th twiddle factor.
+    for (unsigned int half = 1, stride = n / 2; half < n;
+         half *= 2, stride /= 2) {
+        for (unsigned int start = 0; start < n; start += 2 * half) {
+            struct fft_cplx *a = &data[start];
+            struct fft_cplx *b = &data[start + half];
+
+            for (unsigned int k = 0; k < half; k++) {
+                const struct fft_cplx w = plan->twiddle[k * stride];
+                const float t_re = b[k].re * w.re - b[k].im * w.im;
+                const float t_im = b[k].re * w.im + b[k].im * w.re;
+
+                b[k].re = a[k].re - t_re;
+                b[k].im = a[k].im - t_im;
+                a[k].re += t_re;
+                a[k].im += t_im;
+            }
+        }
+    }
+}
+
+void fft_plan_free(struct fft_plan *plan) {
+    if (plan == NULL) {
+        return;
+    }
+
+    free(plan->twiddle);
+    free(plan->rev);
+    free(plan);
+}
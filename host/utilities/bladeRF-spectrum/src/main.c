@@ -0,0 +1,501 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * Spectrum monitor. RX channel 0 sweeps across a range of frequencies with
+ * bladerf_sweep(), while a pool of threads computes each step's averaged
+ * spectrum. The steps of each pass are stitched into one panorama row, which
+ * is drawn as a waterfall or written to a binary stream.
+ */
+#include <getopt.h>
+#include <inttypes.h>
+#include <math.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "libbladeRF.h"
+#include "conversions.h"
+#include "spectrum.h"
+#include "waterfall.h"
+
+#define CHECK(fn) do { \
+    status = fn; \
+    if (status != 0) { \
+        fprintf(stderr, "[Error] %s:%d: %s - %s\n", __FILE__, __LINE__, #fn, bladerf_strerror(status)); \
+        fprintf(stderr, "Exiting.\n"); \
+        goto error; \
+    } \
+} while (0)
+
+#define NUM_FREQ_SUFFIXES 6
+static const struct numeric_suffix freq_suffixes[NUM_FREQ_SUFFIXES] = {
+    { "G",      1000 * 1000 * 1000 },
+    { "GHz",    1000 * 1000 * 1000 },
+    { "M",      1000 * 1000 },
+    { "MHz",    1000 * 1000 },
+    { "k",      1000 },
+    { "kHz",    1000 }
+};
+
+#define DEFAULT_SAMPLE_RATE     20000000
+#define DEFAULT_FFT_SIZE        1024
+#define DEFAULT_AVERAGES        8
+#define DEFAULT_INTERVAL_MS     100
+#define DEFAULT_FLOOR_DB        -110.0f
+#define DEFAULT_RANGE_DB        80.0f
+
+// Fraction of each step's bins kept in a row. The edges of each step, where
+// the anti-aliasing filter rolls off, are covered by its neighbors instead.
+#define STEP_KEEP_NUM           3
+#define STEP_KEEP_DEN           4
+
+#define OPTSTR "d:S:s:g:n:a:j:T:N:i:o:v:h"
+static struct option long_options[] = {
+    { "device",      required_argument,  NULL,   'd' },
+    { "sweep",       required_argument,  NULL,   'S' },
+    { "sample-rate", required_argument,  NULL,   's' },
+    { "gain",        required_argument,  NULL,   'g' },
+    { "fft-size",    required_argument,  NULL,   'n' },
+    { "averages",    required_argument,  NULL,   'a' },
+    { "jobs",        required_argument,  NULL,   'j' },
+    { "settle",      required_argument,  NULL,   'T' },
+    { "passes",      required_argument,  NULL,   'N' },
+    { "interval",    required_argument,  NULL,   'i' },
+    { "output",      required_argument,  NULL,   'o' },
+    { "verbosity",   required_argument,  NULL,   'v' },
+    { "help",        no_argument,        NULL,   'h' },
+    { NULL,          0,                  NULL,   0   },
+};
+
+/* Header preceding each row of the binary output, in host byte order */
+struct row_header {
+    char magic[4];          /* "BRSP" */
+    uint32_t num_bins;      /* # of float32 dBFS levels that follow */
+    uint64_t pass;
+    double start_hz;        /* Center frequency of the first bin */
+    double bin_hz;
+};
+
+struct monitor {
+    struct bladerf *dev;
+    struct spectrum *spectrum;
+    struct bladerf_sweep_config config;
+    int status;             /* bladerf_sweep() result */
+};
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_signal(int signo)
+{
+    (void)signo;
+    stop_requested = 1;
+}
+
+static void usage(const char *argv0)
+{
+    printf("Usage: %s [options] -S <start:stop>\n", argv0);
+    printf("Monitor the spectrum across a range of frequencies, drawing a\n");
+    printf("waterfall unless an output is given.\n");
+    printf("\n");
+    printf("  -d, --device <str>        Specify the device to open.\n");
+    printf("  -S, --sweep <start:stop>  Frequency range to monitor (in Hz).\n");
+    printf("  -s, --sample-rate <rate>  Sample rate (default: %u).\n",
+           DEFAULT_SAMPLE_RATE);
+    printf("  -g, --gain <dB>           RX gain (default: automatic).\n");
+    printf("  -n, --fft-size <n>        Points per FFT, a power of two\n");
+    printf("                            (default: %u).\n", DEFAULT_FFT_SIZE);
+    printf("  -a, --averages <n>        FFTs averaged per step (default: %u).\n",
+           DEFAULT_AVERAGES);
+    printf("  -j, --jobs <n>            # of FFT threads (default: one per\n");
+    printf("                            online CPU).\n");
+    printf("  -T, --settle <us>         Settling time after each retune\n");
+    printf("                            (default: %u).\n",
+           BLADERF_SWEEP_DEFAULT_SETTLE_US);
+    printf("  -N, --passes <n>          Stop after <n> passes (default: run\n");
+    printf("                            until interrupted).\n");
+    printf("  -i, --interval <ms>       Waterfall line interval (default: %u).\n",
+           DEFAULT_INTERVAL_MS);
+    printf("  -o, --output <file>       Write rows to a binary file, or - for\n");
+    printf("                            stdout.\n");
+    printf("  -v, --verbosity <level>   Set the libbladeRF verbosity level (e.g., verbose, debug).\n");
+    printf("  -h, --help                Display this help text and exit.\n");
+    printf("\n");
+    printf("Each output row is a 32-byte header (\"BRSP\", uint32 # of bins,\n");
+    printf("uint64 pass, double first bin frequency, double bin width), then\n");
+    printf("float32 levels in dBFS, all in host byte order. Levels are NaN\n");
+    printf("where an overrun cut a step short.\n");
+}
+
+static bool parse_range(const char *str, uint64_t *start, uint64_t *stop)
+{
+    char buf[64];
+    char *sep;
+    bool ok;
+
+    if (strlen(str) >= sizeof(buf)) {
+        return false;
+    }
+
+    strcpy(buf, str);
+    sep = strchr(buf, ':');
+    if (sep == NULL) {
+        return false;
+    }
+    *sep = '\0';
+
+    *start = str2uint64_suffix(buf, 0, UINT64_MAX, freq_suffixes,
+                               NUM_FREQ_SUFFIXES, &ok);
+    if (ok) {
+        *stop = str2uint64_suffix(sep + 1, 0, UINT64_MAX, freq_suffixes,
+                                  NUM_FREQ_SUFFIXES, &ok);
+    }
+
+    return ok && *stop > *start;
+}
+
+static int on_block(struct bladerf *dev,
+                    const struct bladerf_sweep_block *block,
+                    void *user_data)
+{
+    struct monitor *m = user_data;
+    (void)dev;
+
+    if (stop_requested) {
+        return 1;
+    }
+
+    return spectrum_submit(m->spectrum, block) == 0 ? 0 : 1;
+}
+
+static void *sweep_task(void *arg)
+{
+    struct monitor *m = arg;
+
+    m->status = bladerf_sweep(m->dev, &m->config);
+    spectrum_finish(m->spectrum);
+
+    return NULL;
+}
+
+static uint64_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+int main(int argc, char *argv[])
+{
+    int status = 0;
+    const char *devstr = NULL;
+    const char *output = NULL;
+    uint64_t start = 0, stop = 0;
+    unsigned int samp_rate   = DEFAULT_SAMPLE_RATE;
+    unsigned int settle_us   = BLADERF_SWEEP_DEFAULT_SETTLE_US;
+    unsigned int interval_ms = DEFAULT_INTERVAL_MS;
+    uint64_t passes = 0;
+    int gain = 0;
+    bool gain_set = false;
+    bladerf_log_level log_level = BLADERF_LOG_LEVEL_INFO;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    struct spectrum_config cfg = {
+        .fft_size    = DEFAULT_FFT_SIZE,
+        .averages    = DEFAULT_AVERAGES,
+        .num_workers = cpus > 0 ? (unsigned int)cpus : 1,
+    };
+
+    struct monitor m;
+    struct sigaction sa;
+    bladerf_frequency *freqs = NULL;
+    bladerf_sample_rate actual_rate;
+    bladerf_bandwidth bandwidth;
+    struct waterfall *wf = NULL;
+    FILE *out = NULL;
+    pthread_t thread;
+    bool thread_started = false;
+    double bin_hz, step_hz, start_hz;
+    uint64_t settled, last_draw = 0, pass = 0;
+    const float *row;
+    int opt;
+    bool ok;
+
+    memset(&m, 0, sizeof(m));
+
+    while ((opt = getopt_long(argc, argv, OPTSTR, long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'd':
+                devstr = optarg;
+                break;
+
+            case 'S':
+                if (!parse_range(optarg, &start, &stop)) {
+                    fprintf(stderr, "Invalid frequency range: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 's':
+                samp_rate = str2uint_suffix(optarg, 1, UINT32_MAX,
+                    freq_suffixes, NUM_FREQ_SUFFIXES, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid sample rate: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'g':
+                gain = str2int(optarg, INT32_MIN, INT32_MAX, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid gain: %s\n", optarg);
+                    return 1;
+                }
+                gain_set = true;
+                break;
+
+            case 'n':
+                cfg.fft_size = str2uint(optarg, 2, 1 << 20, &ok);
+                if (!ok || (cfg.fft_size & (cfg.fft_size - 1)) != 0) {
+                    fprintf(stderr, "Invalid FFT size: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'a':
+                cfg.averages = str2uint(optarg, 1, 1 << 16, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid # of averages: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'j':
+                cfg.num_workers = str2uint(optarg, 1, 256, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid # of jobs: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'T':
+                settle_us = str2uint(optarg, 1, UINT32_MAX, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid settling time: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'N':
+                passes = str2uint64(optarg, 1, UINT64_MAX, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid # of passes: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'i':
+                interval_ms = str2uint(optarg, 0, 60000, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid interval: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'o':
+                output = optarg;
+                break;
+
+            case 'v':
+                log_level = str2loglevel(optarg, &ok);
+                if (!ok) {
+                    fprintf(stderr, "Invalid log level: %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'h':
+                usage(argv[0]);
+                return 0;
+
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (stop == 0) {
+        fprintf(stderr, "A frequency range must be given with -S.\n");
+        return 1;
+    }
+
+    bladerf_log_set_verbosity(log_level);
+
+    CHECK(bladerf_open(&m.dev, devstr));
+    CHECK(bladerf_set_sample_rate(m.dev, BLADERF_CHANNEL_RX(0), samp_rate,
+                                  &actual_rate));
+    CHECK(bladerf_set_bandwidth(m.dev, BLADERF_CHANNEL_RX(0), actual_rate,
+                                &bandwidth));
+    if (gain_set) {
+        CHECK(bladerf_set_gain_mode(m.dev, BLADERF_CHANNEL_RX(0),
+                                    BLADERF_GAIN_MGC));
+        CHECK(bladerf_set_gain(m.dev, BLADERF_CHANNEL_RX(0), gain));
+    }
+
+    // Steps are spaced by the width of the bins kept from each, so that the
+    // kept bins of consecutive steps abut
+    cfg.step_bins = cfg.fft_size / STEP_KEEP_DEN * STEP_KEEP_NUM;
+    if (cfg.step_bins == 0) {
+        cfg.step_bins = cfg.fft_size;
+    }
+    bin_hz  = (double)actual_rate / cfg.fft_size;
+    step_hz = bin_hz * cfg.step_bins;
+    cfg.num_steps = (unsigned int)ceil((stop - start) / step_hz);
+    if (cfg.num_steps == 0) {
+        cfg.num_steps = 1;
+    }
+
+    freqs = calloc(cfg.num_steps, sizeof(freqs[0]));
+    if (freqs == NULL) {
+        status = BLADERF_ERR_MEM;
+        goto error;
+    }
+
+    for (unsigned int i = 0; i < cfg.num_steps; i++) {
+        freqs[i] = start + (bladerf_frequency)(step_hz * i + step_hz / 2);
+    }
+    start_hz = (double)freqs[0] - bin_hz * (cfg.step_bins / 2);
+
+    if (spectrum_init(&m.spectrum, &cfg) != 0) {
+        fprintf(stderr, "Failed to initialize the spectrum.\n");
+        status = BLADERF_ERR_MEM;
+        goto error;
+    }
+
+    // The dwell holds the settling time, as bladerf_sweep() rounds it, and
+    // then exactly the samples averaged
+    settled = ((uint64_t)settle_us * actual_rate + 999999) / 1000000;
+
+    m.config.frequencies     = freqs;
+    m.config.num_frequencies = cfg.num_steps;
+    m.config.dwell     = (unsigned int)(settled +
+                                        (uint64_t)cfg.averages * cfg.fft_size);
+    m.config.settle_us  = settle_us;
+    m.config.num_passes = passes;
+    m.config.callback   = on_block;
+    m.config.user_data  = &m;
+
+    if (output != NULL) {
+        out = strcmp(output, "-") == 0 ? stdout : fopen(output, "wb");
+        if (out == NULL) {
+            perror(output);
+            status = BLADERF_ERR_IO;
+            goto error;
+        }
+    } else if (waterfall_init(&wf, start_hz, bin_hz,
+                              cfg.num_steps * cfg.step_bins,
+                              DEFAULT_FLOOR_DB, DEFAULT_RANGE_DB) != 0) {
+        fprintf(stderr, "Failed to initialize the display.\n");
+        status = BLADERF_ERR_MEM;
+        goto error;
+    }
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    if (pthread_create(&thread, NULL, sweep_task, &m) != 0) {
+        status = BLADERF_ERR_UNEXPECTED;
+        goto error;
+    }
+    thread_started = true;
+
+    while (!stop_requested &&
+           (row = spectrum_next_row(m.spectrum, &pass)) != NULL) {
+        if (out != NULL) {
+            const struct row_header hdr = {
+                .magic    = { 'B', 'R', 'S', 'P' },
+                .num_bins = cfg.num_steps * cfg.step_bins,
+                .pass     = pass,
+                .start_hz = start_hz,
+                .bin_hz   = bin_hz,
+            };
+
+            if (fwrite(&hdr, sizeof(hdr), 1, out) != 1 ||
+                fwrite(row, sizeof(row[0]), hdr.num_bins, out) != hdr.num_bins) {
+                perror(output);
+                status = BLADERF_ERR_IO;
+                stop_requested = 1;
+            }
+        } else {
+            waterfall_add(wf, row);
+            if (now_ms() - last_draw >= interval_ms) {
+                waterfall_draw(wf, pass);
+                last_draw = now_ms();
+            }
+
+            if (!waterfall_poll(wf)) {
+                stop_requested = 1;
+            }
+        }
+
+        spectrum_release_row(m.spectrum);
+    }
+
+    // Unblock the sweep callback, should it be waiting on a row
+    spectrum_stop(m.spectrum);
+    pthread_join(thread, NULL);
+    thread_started = false;
+
+    if (status == 0) {
+        status = m.status;
+    }
+
+error:
+    if (thread_started) {
+        spectrum_stop(m.spectrum);
+        pthread_join(thread, NULL);
+    }
+
+    waterfall_close(wf);
+
+    if (status != 0 && m.status != 0) {
+        fprintf(stderr, "Sweep failed: %s\n", bladerf_strerror(m.status));
+    }
+
+    if (out != NULL && out != stdout) {
+        fclose(out);
+    } else if (out != NULL) {
+        fflush(out);
+    }
+
+    spectrum_free(m.spectrum);
+    free(freqs);
+    if (m.dev) bladerf_close(m.dev);
+    return status == 0 ? 0 : 1;
+}
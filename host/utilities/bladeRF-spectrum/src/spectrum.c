@@ -0,0 +1,394 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fft.h"
+#include "spectrum.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Number of passes that may be in progress at once. Blocks of a pass this
+// far ahead of the oldest unconsumed row wait for it to be consumed.
+#define SPECTRUM_ROWS 4
+
+// Sample buffers per worker, so that the sweep callback rarely waits
+#define SPECTRUM_JOBS_PER_WORKER 4
+
+struct job {
+    int16_t *samples;       // `frames` FFT frames of SC16 Q11 samples
+    unsigned int frames;
+    unsigned int index;     // Step index, as in bladerf_sweep_block
+    uint64_t pass;
+};
+
+struct spectrum {
+    struct spectrum_config cfg;
+    struct fft_plan *plan;
+    float *window;
+    double window_power;    // Squared sum of the window, for normalization
+
+    pthread_t *workers;
+    unsigned int num_workers;
+
+    pthread_mutex_t lock;   // Protects all of the following
+    pthread_cond_t work;    // Signaled when a job is queued, or on exit
+    pthread_cond_t space;   // Signaled when a job or row is freed
+    pthread_cond_t done;    // Signaled when a row is complete, or finished
+
+    struct job *jobs;
+    unsigned int num_jobs;
+    unsigned int *queue;    // Indices of queued jobs, oldest first
+    unsigned int head;
+    unsigned int queued;
+    unsigned int *free_jobs;
+    unsigned int num_free;
+    unsigned int busy;      // # of jobs being processed by workers
+
+    float *rows[SPECTRUM_ROWS];
+    unsigned int row_steps[SPECTRUM_ROWS];  // # of steps processed
+    uint64_t next_pass;     // Pass of the oldest unconsumed row
+
+    bool finished;
+    bool stopped;
+    bool exiting;
+};
+
+static bool idle(const struct spectrum *s) {
+    return s->queued == 0 && s->busy == 0;
+}
+
+// Compute a job's averaged spectrum, writing its center bins into its row
+static void process_job(struct spectrum *s,
+                        const struct job *job,
+                        struct fft_cplx *buf,
+                        double *acc) {
+    const unsigned int n     = s->cfg.fft_size;
+    const unsigned int first = (n - s->cfg.step_bins) / 2;
+    float *out = s->rows[job->pass % SPECTRUM_ROWS] +
+                 (size_t)job->index * s->cfg.step_bins;
+
+    if (job->frames == 0) {
+        // An overrun left no settled samples for this step
+        for (unsigned int i = 0; i < s->cfg.step_bins; i++) {
+            out[i] = NAN;
+        }
+        return;
+    }
+
+    memset(acc, 0, n * sizeof(acc[0]));
+
+    for (unsigned int f = 0; f < job->frames; f++) {
+        const int16_t *x = job->samples + (size_t)f * n * 2;
+
+        for (unsigned int i = 0; i < n; i++) {
+            buf[i].re = x[2 * i] * (1.0f / 2048.0f) * s->window[i];
+            buf[i].im = x[2 * i + 1] * (1.0f / 2048.0f) * s->window[i];
+        }
+
+        fft_execute(s->plan, buf);
+
+        for (unsigned int i = 0; i < n; i++) {
+            acc[i] += (double)buf[i].re * buf[i].re +
+                      (double)buf[i].im * buf[i].im;
+        }
+    }
+
+    // Bins are reordered from [0, fs) to [-fs/2, fs/2), keeping the center
+    for (unsigned int i = 0; i < s->cfg.step_bins; i++) {
+        const unsigned int bin = (first + i + n / 2) % n;
+        const double power = acc[bin] / (job->frames * s->window_power);
+        out[i] = (float)(10.0 * log10(power + 1e-20));
+    }
+}
+
+static void *worker_task(void *arg) {
+    struct spectrum *s = arg;
+    const unsigned int n = s->cfg.fft_size;
+    struct fft_cplx *buf = malloc(n * sizeof(buf[0]));
+    double *acc = malloc(n * sizeof(acc[0]));
+    unsigned int j;
+
+    pthread_mutex_lock(&s->lock);
+
+    if (buf == NULL || acc == NULL) {
+        // Without this worker, rows could never be completed
+        s->stopped = true;
+        pthread_cond_broadcast(&s->space);
+        pthread_cond_broadcast(&s->done);
+    }
+
+    while (!s->stopped) {
+        if (s->queued == 0) {
+            if (s->exiting) {
+                break;
+            }
+            pthread_cond_wait(&s->work, &s->lock);
+            continue;
+        }
+
+        j = s->queue[s->head];
+        s->head = (s->head + 1) % s->num_jobs;
+        s->queued--;
+        s->busy++;
+        pthread_mutex_unlock(&s->lock);
+
+        process_job(s, &s->jobs[j], buf, acc);
+
+        pthread_mutex_lock(&s->lock);
+        s->busy--;
+        s->free_jobs[s->num_free++] = j;
+        pthread_cond_signal(&s->space);
+
+        if (++s->row_steps[s->jobs[j].pass % SPECTRUM_ROWS] ==
+                s->cfg.num_steps ||
+            (s->finished && idle(s))) {
+            pthread_cond_broadcast(&s->done);
+        }
+    }
+
+    pthread_mutex_unlock(&s->lock);
+
+    free(acc);
+    free(buf);
+    return NULL;
+}
+
+int spectrum_init(struct spectrum **s_out, const struct spectrum_config *cfg) {
+    const double a[4] = { 0.35875, 0.48829, 0.14128, 0.01168 };
+    const size_t frame = (size_t)cfg->fft_size * 2;
+    struct spectrum *s;
+    double sum = 0.0;
+
+    *s_out = NULL;
+
+    if (!fft_size_valid(cfg->fft_size) || cfg->averages == 0 ||
+        cfg->num_steps == 0 || cfg->step_bins == 0 ||
+        cfg->step_bins > cfg->fft_size || cfg->num_workers == 0) {
+        return -1;
+    }
+
+    s = calloc(1, sizeof(*s));
+    if (s == NULL) {
+        return -1;
+    }
+
+    s->cfg      = *cfg;
+    s->num_jobs = cfg->num_workers * SPECTRUM_JOBS_PER_WORKER;
+
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_cond_init(&s->work, NULL);
+    pthread_cond_init(&s->space, NULL);
+    pthread_cond_init(&s->done, NULL);
+
+    s->window    = malloc(cfg->fft_size * sizeof(s->window[0]));
+    s->jobs      = calloc(s->num_jobs, sizeof(s->jobs[0]));
+    s->queue     = calloc(s->num_jobs, sizeof(s->queue[0]));
+    s->free_jobs = calloc(s->num_jobs, sizeof(s->free_jobs[0]));
+    s->workers   = calloc(cfg->num_workers, sizeof(s->workers[0]));
+    if (s->window == NULL || s->jobs == NULL || s->queue == NULL ||
+        s->free_jobs == NULL || s->workers == NULL ||
+        fft_plan_create(&s->plan, cfg->fft_size) != 0) {
+        goto error;
+    }
+
+    for (unsigned int j = 0; j < s->num_jobs; j++) {
+        s->jobs[j].samples =
+            malloc(frame * cfg->averages * sizeof(s->jobs[j].samples[0]));
+        if (s->jobs[j].samples == NULL) {
+            goto error;
+        }
+        s->free_jobs[s->num_free++] = j;
+    }
+
+    for (unsigned int r = 0; r < SPECTRUM_ROWS; r++) {
+        s->rows[r] = malloc((size_t)cfg->num_steps * cfg->step_bins *
+                            sizeof(s->rows[r][0]));
+        if (s->rows[r] == NULL) {
+            goto error;
+        }
+    }
+
+    // 4-term Blackman-Harris, whose sidelobes sit below the 12-bit ADC's
+    // dynamic range
+    for (unsigned int i = 0; i < cfg->fft_size; i++) {
+        const double x = 2.0 * M_PI * i / cfg->fft_size;
+        s->window[i] = (float)(a[0] - a[1] * cos(x) + a[2] * cos(2 * x) -
+                               a[3] * cos(3 * x));
+        sum += s->window[i];
+    }
+    s->window_power = sum * sum;
+
+    for (s->num_workers = 0; s->num_workers < cfg->num_workers;
+         s->num_workers++) {
+        if (pthread_create(&s->workers[s->num_workers], NULL, worker_task,
+                           s) != 0) {
+            goto error;
+        }
+    }
+
+    *s_out = s;
+    return 0;
+
+error:
+    spectrum_free(s);
+    return -1;
+}
+
+int spectrum_submit(struct spectrum *s,
+                    const struct bladerf_sweep_block *block) {
+    const unsigned int n = s->cfg.fft_size;
+    unsigned int frames = 0;
+    struct job *job;
+    unsigned int j;
+
+    if (block->index >= s->cfg.num_steps) {
+        return -1;
+    }
+
+    if (block->num_samples > block->settled) {
+        frames = (block->num_samples - block->settled) / n;
+        if (frames > s->cfg.averages) {
+            frames = s->cfg.averages;
+        }
+    }
+
+    pthread_mutex_lock(&s->lock);
+
+    while (!s->stopped &&
+           (s->num_free == 0 ||
+            block->pass >= s->next_pass + SPECTRUM_ROWS)) {
+        pthread_cond_wait(&s->space, &s->lock);
+    }
+
+    if (s->stopped) {
+        pthread_mutex_unlock(&s->lock);
+        return -1;
+    }
+
+    j = s->free_jobs[--s->num_free];
+    pthread_mutex_unlock(&s->lock);
+
+    job         = &s->jobs[j];
+    job->frames = frames;
+    job->index  = block->index;
+    job->pass   = block->pass;
+    memcpy(job->samples, block->samples + 2 * (size_t)block->settled,
+           (size_t)frames * n * 2 * sizeof(job->samples[0]));
+
+    pthread_mutex_lock(&s->lock);
+    s->queue[(s->head + s->queued) % s->num_jobs] = j;
+    s->queued++;
+    pthread_cond_signal(&s->work);
+    pthread_mutex_unlock(&s->lock);
+
+    return 0;
+}
+
+void spectrum_finish(struct spectrum *s) {
+    pthread_mutex_lock(&s->lock);
+    s->finished = true;
+    pthread_cond_broadcast(&s->done);
+    pthread_mutex_unlock(&s->lock);
+}
+
+const float *spectrum_next_row(struct spectrum *s, uint64_t *pass) {
+    const unsigned int r = s->next_pass % SPECTRUM_ROWS;
+    const float *row = NULL;
+
+    pthread_mutex_lock(&s->lock);
+
+    while (!s->stopped && s->row_steps[r] < s->cfg.num_steps &&
+           !(s->finished && idle(s))) {
+        pthread_cond_wait(&s->done, &s->lock);
+    }
+
+    if (!s->stopped && s->row_steps[r] == s->cfg.num_steps) {
+        row   = s->rows[r];
+        *pass = s->next_pass;
+    }
+
+    pthread_mutex_unlock(&s->lock);
+
+    return row;
+}
+
+void spectrum_release_row(struct spectrum *s) {
+    pthread_mutex_lock(&s->lock);
+    s->row_steps[s->next_pass % SPECTRUM_ROWS] = 0;
+    s->next_pass++;
+    pthread_cond_broadcast(&s->space);
+    pthread_mutex_unlock(&s->lock);
+}
+
+void spectrum_stop(struct spectrum *s) {
+    pthread_mutex_lock(&s->lock);
+    s->stopped = true;
+    pthread_cond_broadcast(&s->work);
+    pthread_cond_broadcast(&s->space);
+    pthread_cond_broadcast(&s->done);
+    pthread_mutex_unlock(&s->lock);
+}
+
+void spectrum_free(struct spectrum *s) {
+    if (s == NULL) {
+        return;
+    }
+
+    // Workers finish the jobs already queued, unless stopped
+    pthread_mutex_lock(&s->lock);
+    s->exiting = true;
+    pthread_cond_broadcast(&s->work);
+    pthread_mutex_unlock(&s->lock);
+
+    for (unsigned int i = 0; i < s->num_workers; i++) {
+        pthread_join(s->workers[i], NULL);
+    }
+
+    for (unsigned int r = 0; r < SPECTRUM_ROWS; r++) {
+        free(s->rows[r]);
+    }
+
+    for (unsigned int j = 0; s->jobs != NULL && j < s->num_jobs; j++) {
+        free(s->jobs[j].samples);
+    }
+
+    fft_plan_free(s->plan);
+    free(s->workers);
+    free(s->free_jobs);
+    free(s->queue);
+    free(s->jobs);
+    free(s->window);
+
+    pthread_cond_destroy(&s->done);
+    pthread_cond_destroy(&s->space);
+    pthread_cond_destroy(&s->work);
+    pthread_mutex_destroy(&s->lock);
+    free(s);
+}
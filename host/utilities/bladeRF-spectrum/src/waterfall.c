@@ -0,0 +1,307 @@
+/*
+ * This file is part of the bladeRF project:
+ *   http://www.github.com/nuand/bladeRF
+ *
+ * Copyright (C) 2026 Nuand LLC
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <inttypes.h>
+#include <locale.h>
+#include <math.h>
+#include <stdlib.h>
+#include <ncurses.h>
+#include "text.h"
+#include "waterfall.h"
+
+// Lines above the waterfall: a status line, a peak line, and the frequency
+// axis, plus the peak level in ASCII art when the terminal is large enough
+#define HEADER_LINES    3
+#define ART_MIN_COLS    96
+#define ART_MIN_LINES   (HEADER_LINES + DIGIT_HEIGHT + 8)
+
+// Shades used when the terminal has no colors, from lowest to highest level
+static const char shades[] = " .:-=+*#%@";
+#define NUM_SHADES      ((int)sizeof(shades) - 1)
+
+// Background colors used as shades, from lowest to highest level
+static const short colors[] = {
+    COLOR_BLACK, COLOR_BLUE, COLOR_CYAN, COLOR_GREEN,
+    COLOR_YELLOW, COLOR_RED, COLOR_MAGENTA, COLOR_WHITE,
+};
+#define NUM_COLORS      ((int)(sizeof(colors) / sizeof(colors[0])))
+
+struct waterfall {
+    double start_hz;
+    double bin_hz;
+    unsigned int num_bins;
+    float floor_db;
+    float range_db;
+
+    float *pending;     // Max-held rows, to be drawn as the next line
+    bool have_pending;
+
+    bool color;
+    bool art;           // Whether the ASCII art peak level is shown
+    WINDOW *header;
+    WINDOW *lines;      // The waterfall itself, scrolled a line per draw
+};
+
+static void reset_pending(struct waterfall *wf) {
+    for (unsigned int i = 0; i < wf->num_bins; i++) {
+        wf->pending[i] = -INFINITY;
+    }
+    wf->have_pending = false;
+}
+
+// (Re)create the windows to fit the terminal
+static void layout(struct waterfall *wf) {
+    int header_lines = HEADER_LINES;
+
+    if (wf->header != NULL) {
+        delwin(wf->header);
+    }
+    if (wf->lines != NULL) {
+        delwin(wf->lines);
+    }
+
+    wf->art = COLS >= ART_MIN_COLS && LINES >= ART_MIN_LINES;
+    if (wf->art) {
+        header_lines += DIGIT_HEIGHT;
+    }
+
+    wf->header = newwin(header_lines, COLS, 0, 0);
+    wf->lines  = newwin(LINES - header_lines, COLS, header_lines, 0);
+    scrollok(wf->lines, TRUE);
+
+    clear();
+    refresh();
+}
+
+static void draw_axis(struct waterfall *wf, int y) {
+    const int width = getmaxx(wf->header);
+    const double span = wf->bin_hz * wf->num_bins;
+
+    wmove(wf->header, y, 0);
+    wclrtoeol(wf->header);
+
+    // A tick with its frequency, in MHz, every 16 columns
+    for (int x = 0; x + 12 <= width; x += 16) {
+        const double hz = wf->start_hz + span * x / width;
+        mvwprintw(wf->header, y, x, "|%-.3f", hz / 1e6);
+    }
+}
+
+static void draw_header(struct waterfall *wf, uint64_t pass,
+                        float peak_db, double peak_hz) {
+    int y = 0;
+
+    werase(wf->header);
+
+    mvwprintw(wf->header, y++, 0,
+              "%.3f - %.3f MHz  RBW: %.2f kHz  Pass: %" PRIu64
+              "  Scale: %.0f to %.0f dBFS",
+              wf->start_hz / 1e6, (wf->start_hz + wf->bin_hz * wf->num_bins) / 1e6,
+              wf->bin_hz / 1e3, pass, wf->floor_db, wf->floor_db + wf->range_db);
+
+    if (isfinite(peak_db)) {
+        mvwprintw(wf->header, y++, 0, "Peak: %.2f dBFS at %.3f MHz", peak_db,
+                  peak_hz / 1e6);
+    } else {
+        mvwprintw(wf->header, y++, 0, "Peak: -");
+    }
+    if (getmaxx(wf->header) >= 90) {
+        mvwprintw(wf->header, y - 1, getmaxx(wf->header) - 40,
+                  "[q] Quit [Up/Down] Level [+/-] Range");
+    }
+
+    if (wf->art) {
+        if (isfinite(peak_db)) {
+            display_double(wf->header, peak_db, y, 1, POWER_SUFFIX_DBFS);
+        }
+        y += DIGIT_HEIGHT;
+    }
+
+    draw_axis(wf, y);
+    wnoutrefresh(wf->header);
+}
+
+int waterfall_init(struct waterfall **wf_out,
+                   double start_hz,
+                   double bin_hz,
+                   unsigned int num_bins,
+                   float floor_db,
+                   float range_db) {
+    struct waterfall *wf;
+
+    *wf_out = NULL;
+
+    wf = calloc(1, sizeof(*wf));
+    if (wf == NULL) {
+        return -1;
+    }
+
+    wf->pending = malloc(num_bins * sizeof(wf->pending[0]));
+    if (wf->pending == NULL) {
+        free(wf);
+        return -1;
+    }
+
+    wf->start_hz = start_hz;
+    wf->bin_hz   = bin_hz;
+    wf->num_bins = num_bins;
+    wf->floor_db = floor_db;
+    wf->range_db = range_db;
+    reset_pending(wf);
+
+    setlocale(LC_ALL, "");  // Set locale for wide character support
+    initscr();    // Start curses mode
+    noecho();     // Don't echo input characters
+    curs_set(0);  // Hide the cursor
+    keypad(stdscr, TRUE);   // Enable keyboard mapping, such as arrow keys
+    nodelay(stdscr, TRUE);  // Make getch() non-blocking
+
+    if (has_colors()) {
+        start_color();
+        for (int i = 0; i < NUM_COLORS; i++) {
+            init_pair(i + 1, COLOR_BLACK, colors[i]);
+        }
+        wf->color = true;
+    }
+
+    layout(wf);
+
+    *wf_out = wf;
+    return 0;
+}
+
+void waterfall_add(struct waterfall *wf, const float *row) {
+    for (unsigned int i = 0; i < wf->num_bins; i++) {
+        // NAN, from a step cut short by an overrun, is ignored
+        wf->pending[i] = fmaxf(wf->pending[i], row[i]);
+    }
+    wf->have_pending = true;
+}
+
+void waterfall_draw(struct waterfall *wf, uint64_t pass) {
+    const int width  = getmaxx(wf->lines);
+    const int levels = wf->color ? NUM_COLORS : NUM_SHADES;
+    float peak_db  = -INFINITY;
+    double peak_hz = 0.0;
+
+    if (!wf->have_pending) {
+        return;
+    }
+
+    wscrl(wf->lines, -1);
+    wmove(wf->lines, 0, 0);
+
+    for (int x = 0; x < width; x++) {
+        const unsigned int first = (unsigned int)((uint64_t)x * wf->num_bins / width);
+        unsigned int last = (unsigned int)((uint64_t)(x + 1) * wf->num_bins / width);
+        float level = -INFINITY;
+        int shade;
+
+        if (last <= first) {
+            last = first + 1;
+        }
+
+        for (unsigned int i = first; i < last && i < wf->num_bins; i++) {
+            if (wf->pending[i] > level) {
+                level = wf->pending[i];
+            }
+            if (wf->pending[i] > peak_db) {
+                peak_db = wf->pending[i];
+                peak_hz = wf->start_hz + wf->bin_hz * i;
+            }
+        }
+
+        if (isfinite(level)) {
+            shade = (int)floorf((level - wf->floor_db) / wf->range_db * levels);
+            shade = shade < 0 ? 0 : shade >= levels ? levels - 1 : shade;
+        } else {
+            shade = 0;
+        }
+
+        if (wf->color) {
+            waddch(wf->lines, ' ' | COLOR_PAIR(shade + 1));
+        } else {
+            waddch(wf->lines, shades[shade]);
+        }
+    }
+
+    draw_header(wf, pass, peak_db, peak_hz);
+    wnoutrefresh(wf->lines);
+    doupdate();
+
+    reset_pending(wf);
+}
+
+bool waterfall_poll(struct waterfall *wf) {
+    int key;
+
+    while ((key = getch()) != ERR) {
+        switch (key) {
+            case 'q':
+            case 'Q':
+                return false;
+
+            case KEY_UP:
+                wf->floor_db += 5.0f;
+                break;
+
+            case KEY_DOWN:
+                wf->floor_db -= 5.0f;
+                break;
+
+            case '+':
+                wf->range_db += 5.0f;
+                break;
+
+            case '-':
+                if (wf->range_db > 10.0f) {
+                    wf->range_db -= 5.0f;
+                }
+                break;
+
+            case KEY_RESIZE:
+                // History is lost, as the waterfall window is recreated
+                layout(wf);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return true;
+}
+
+void waterfall_close(struct waterfall *wf) {
+    if (wf == NULL) {
+        return;
+    }
+
+    delwin(wf->lines);
+    delwin(wf->header);
+    endwin();
+
+    free(wf->pending);
+    free(wf);
+}
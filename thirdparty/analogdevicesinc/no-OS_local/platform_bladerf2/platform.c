@@ -7,6 +7,108 @@
 #include "adc_core.h"
 #include "dac_core.h"
 
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+/* Device whose SPI writes are currently being batched by this thread, and
+ * the nesting depth of platform_spi_batch_begin() calls on it. The delay
+ * functions below carry no device, so this is how they find the writes that
+ * must reach the AD9361 before they begin waiting. */
+static THREAD_LOCAL struct bladerf *spi_batch_dev;
+static THREAD_LOCAL unsigned int spi_batch_depth;
+
+/***************************************************************************//**
+ * @brief platform_spi_batch_begin
+*******************************************************************************/
+
+int platform_spi_batch_begin(struct bladerf *dev)
+{
+    int status;
+
+    /* Batching one device at a time per thread keeps the delays simple */
+    if (spi_batch_depth > 0 && spi_batch_dev != dev) {
+        return 0;
+    }
+
+    status = dev->backend->batch_begin(dev);
+    if (status < 0) {
+        return status;
+    }
+
+    spi_batch_dev = dev;
+    spi_batch_depth++;
+
+    return 0;
+}
+
+/***************************************************************************//**
+ * @brief platform_spi_batch_commit
+*******************************************************************************/
+
+int platform_spi_batch_commit(struct bladerf *dev)
+{
+    if (spi_batch_depth == 0 || spi_batch_dev != dev) {
+        return 0;
+    }
+
+    if (--spi_batch_depth == 0) {
+        spi_batch_dev = NULL;
+    }
+
+    return dev->backend->batch_commit(dev);
+}
+
+/* Calibrations to skip on this thread's device, per
+ * platform_spi_cal_skip_begin(), or NULL */
+static THREAD_LOCAL struct bladerf *spi_cal_skip_dev;
+static THREAD_LOCAL const struct platform_cal_skip *spi_cal_skip;
+
+/***************************************************************************//**
+ * @brief platform_spi_cal_skip_begin
+*******************************************************************************/
+
+void platform_spi_cal_skip_begin(struct bladerf *dev,
+                                 const struct platform_cal_skip *skip)
+{
+    spi_cal_skip_dev = dev;
+    spi_cal_skip     = skip;
+}
+
+/***************************************************************************//**
+ * @brief platform_spi_cal_skip_end
+*******************************************************************************/
+
+void platform_spi_cal_skip_end(struct bladerf *dev)
+{
+    if (spi_cal_skip_dev == dev) {
+        spi_cal_skip_dev = NULL;
+        spi_cal_skip     = NULL;
+    }
+}
+
+/* Returns the calibrations being skipped, if an access of len bytes to dev
+ * is subject to them, or NULL */
+static const struct platform_cal_skip *cal_skip_for(struct bladerf *dev,
+                                                    unsigned int len)
+{
+    if (spi_cal_skip == NULL || spi_cal_skip_dev != dev || len != 1) {
+        return NULL;
+    }
+
+    return spi_cal_skip;
+}
+
+/* Issue this thread's queued SPI writes ahead of a delay */
+static void spi_batch_flush(void)
+{
+    if (spi_batch_dev != NULL) {
+        spi_batch_dev->backend->batch_flush(spi_batch_dev);
+    }
+}
+
 /***************************************************************************//**
  * @brief spi_init
 *******************************************************************************/
@@ -25,6 +127,7 @@ int spi_write(struct spi_device *spi, uint16_t cmd, const uint8_t *buf,
               unsigned int len)
 {
     struct bladerf *dev = spi->userdata;
+    const struct platform_cal_skip *skip;
     int status;
     uint64_t data;
     unsigned int i;
@@ -35,6 +138,12 @@ int spi_write(struct spi_device *spi, uint16_t cmd, const uint8_t *buf,
         data |= (((uint64_t)buf[i]) << 8*(7-i));
     }
 
+    /* Keep a skipped calibration from being started */
+    skip = cal_skip_for(dev, len);
+    if (skip != NULL && AD_ADDR(cmd) == skip->ctrl_reg) {
+        data &= ~((uint64_t)skip->ctrl_mask << 56);
+    }
+
     /* SPI transaction */
     status = dev->backend->ad9361_spi_write(dev, cmd, data);
     if (status < 0) {
@@ -54,10 +163,22 @@ int spi_read(struct spi_device *spi, uint16_t cmd, uint8_t *buf,
              unsigned int len)
 {
     struct bladerf *dev = spi->userdata;
+    const struct platform_cal_skip *skip;
     int status;
     uint64_t data = 0;
     unsigned int i;
 
+    /* Report the recorded results of a skipped calibration */
+    skip = cal_skip_for(dev, len);
+    if (skip != NULL) {
+        for (i = 0; i < skip->num_status; i++) {
+            if (AD_ADDR(cmd) == skip->status_reg[i]) {
+                buf[0] = skip->status_val[i];
+                return 0;
+            }
+        }
+    }
+
     /* SPI transaction */
     status = dev->backend->ad9361_spi_read(dev, cmd, &data);
     if (status < 0) {
@@ -135,6 +256,7 @@ int gpio_set_value(struct gpio_device *gpio, int32_t number, bool value)
 
 void udelay(unsigned long usecs)
 {
+    spi_batch_flush();
     usleep(usecs);
 }
 
@@ -144,6 +266,7 @@ void udelay(unsigned long usecs)
 
 void mdelay(unsigned long msecs)
 {
+    spi_batch_flush();
     usleep(msecs * 1000);
 }
 
@@ -153,6 +276,7 @@ void mdelay(unsigned long msecs)
 
 unsigned long msleep_interruptible(unsigned int msecs)
 {
+    spi_batch_flush();
     usleep(msecs * 1000);
     return 0;
 }
@@ -157,6 +157,25 @@ void udelay(unsigned long usecs);
 void mdelay(unsigned long msecs);
 unsigned long msleep_interruptible(unsigned int msecs);
 
+struct bladerf;
+
+int platform_spi_batch_begin(struct bladerf *dev);
+int platform_spi_batch_commit(struct bladerf *dev);
+
+#define PLATFORM_CAL_SKIP_MAX_STATUS 4
+
+struct platform_cal_skip {
+	uint16_t ctrl_reg;
+	uint8_t ctrl_mask;
+	unsigned int num_status;
+	uint16_t status_reg[PLATFORM_CAL_SKIP_MAX_STATUS];
+	uint8_t status_val[PLATFORM_CAL_SKIP_MAX_STATUS];
+};
+
+void platform_spi_cal_skip_begin(struct bladerf *dev,
+				 const struct platform_cal_skip *skip);
+void platform_spi_cal_skip_end(struct bladerf *dev);
+
 #ifndef AXI_ADC_NOT_PRESENT
 int axiadc_init(struct ad9361_rf_phy *phy, void *userdata);
 int axiadc_post_setup(struct ad9361_rf_phy *phy);